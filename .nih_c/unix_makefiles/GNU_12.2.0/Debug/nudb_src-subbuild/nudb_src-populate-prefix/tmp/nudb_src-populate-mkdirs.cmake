@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-src"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-build"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/tmp"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/src/nudb_src-populate-stamp"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/src"
+  "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/src/nudb_src-populate-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/src/nudb_src-populate-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/.nih_c/unix_makefiles/GNU_12.2.0/Debug/nudb_src-subbuild/nudb_src-populate-prefix/src/nudb_src-populate-stamp${cfgdir}") # cfgdir has leading slash
+endif()
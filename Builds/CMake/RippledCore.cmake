@@ -49,6 +49,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/basics/impl/FileUtilities.cpp
   src/ripple/basics/impl/IOUAmount.cpp
   src/ripple/basics/impl/Log.cpp
+  src/ripple/basics/impl/MemoryUsage.cpp
   src/ripple/basics/impl/strHex.cpp
   src/ripple/basics/impl/StringUtilities.cpp
   #[===============================[
@@ -156,6 +157,7 @@ install (
     src/ripple/basics/LocalValue.h
     src/ripple/basics/Log.h
     src/ripple/basics/MathUtilities.h
+    src/ripple/basics/MemoryUsage.h
     src/ripple/basics/safe_cast.h
     src/ripple/basics/Slice.h
     src/ripple/basics/StringUtilities.h
@@ -338,6 +340,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/consensus/RCLConsensus.cpp
   src/ripple/app/consensus/RCLCxPeerPos.cpp
   src/ripple/app/consensus/RCLValidations.cpp
+  src/ripple/app/consensus/TxSetSketch.cpp
   src/ripple/app/ledger/AcceptedLedger.cpp
   src/ripple/app/ledger/AcceptedLedgerTx.cpp
   src/ripple/app/ledger/AccountStateSF.cpp
@@ -347,16 +350,20 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/LedgerHistory.cpp
   src/ripple/app/ledger/OrderBookDB.cpp
   src/ripple/app/ledger/TransactionStateSF.cpp
+  src/ripple/app/ledger/impl/BookSnapshot.cpp
   src/ripple/app/ledger/impl/BuildLedger.cpp
   src/ripple/app/ledger/impl/InboundLedger.cpp
   src/ripple/app/ledger/impl/InboundLedgers.cpp
   src/ripple/app/ledger/impl/InboundTransactions.cpp
   src/ripple/app/ledger/impl/LedgerCleaner.cpp
+  src/ripple/app/ledger/impl/LedgerHashIndex.cpp
   src/ripple/app/ledger/impl/LedgerMaster.cpp
   src/ripple/app/ledger/impl/LedgerReplay.cpp
   src/ripple/app/ledger/impl/LedgerToJson.cpp
   src/ripple/app/ledger/impl/LocalTxs.cpp
   src/ripple/app/ledger/impl/OpenLedger.cpp
+  src/ripple/app/ledger/impl/RecoveryCheckpoint.cpp
+  src/ripple/app/ledger/impl/ReplayBenchmark.cpp
   src/ripple/app/ledger/impl/TransactionAcquire.cpp
   src/ripple/app/ledger/impl/TransactionMaster.cpp
   src/ripple/app/main/Application.cpp
@@ -379,12 +386,15 @@ target_sources (rippled PRIVATE
   src/ripple/app/misc/impl/LoadFeeTrack.cpp
   src/ripple/app/misc/impl/Manifest.cpp
   src/ripple/app/misc/impl/Transaction.cpp
+  src/ripple/app/misc/impl/TxIndex.cpp
   src/ripple/app/misc/impl/TxQ.cpp
   src/ripple/app/misc/impl/ValidatorKeys.cpp
   src/ripple/app/misc/impl/ValidatorList.cpp
   src/ripple/app/misc/impl/ValidatorSite.cpp
+  src/ripple/app/misc/impl/WarmStart.cpp
   src/ripple/app/paths/AccountCurrencies.cpp
   src/ripple/app/paths/Credit.cpp
+  src/ripple/app/paths/DeadOffers.cpp
   src/ripple/app/paths/Flow.cpp
   src/ripple/app/paths/PathRequest.cpp
   src/ripple/app/paths/PathRequests.cpp
@@ -396,6 +406,8 @@ target_sources (rippled PRIVATE
   src/ripple/app/paths/impl/DirectStep.cpp
   src/ripple/app/paths/impl/PaySteps.cpp
   src/ripple/app/paths/impl/XRPEndpointStep.cpp
+  src/ripple/app/rdb/impl/RelationalDBInterfaceSqlite.cpp
+  src/ripple/app/reporting/ReportingETL.cpp
   src/ripple/app/tx/impl/ApplyContext.cpp
   src/ripple/app/tx/impl/BookTip.cpp
   src/ripple/app/tx/impl/CancelCheck.cpp
@@ -417,6 +429,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/tx/impl/SetSignerList.cpp
   src/ripple/app/tx/impl/SetTrust.cpp
   src/ripple/app/tx/impl/SignerEntries.cpp
+  src/ripple/app/tx/impl/SignerListCache.cpp
   src/ripple/app/tx/impl/Taker.cpp
   src/ripple/app/tx/impl/Transactor.cpp
   src/ripple/app/tx/impl/apply.cpp
@@ -427,8 +440,14 @@ target_sources (rippled PRIVATE
   #]===============================]
   src/ripple/basics/impl/Archive.cpp
   src/ripple/basics/impl/BasicConfig.cpp
+  src/ripple/basics/impl/CacheBudget.cpp
+  src/ripple/basics/impl/CpuProfile.cpp
+  src/ripple/basics/impl/HugePages.cpp
   src/ripple/basics/impl/PerfLogImp.cpp
   src/ripple/basics/impl/ResolverAsio.cpp
+  src/ripple/basics/impl/SystemMemory.cpp
+  src/ripple/basics/impl/ThreadAffinity.cpp
+  src/ripple/basics/impl/Tracer.cpp
   src/ripple/basics/impl/UptimeClock.cpp
   src/ripple/basics/impl/make_SSLContext.cpp
   src/ripple/basics/impl/mulDiv.cpp
@@ -444,6 +463,7 @@ target_sources (rippled PRIVATE
        subdir: core
   #]===============================]
   src/ripple/core/impl/Config.cpp
+  src/ripple/core/impl/CoroStack.cpp
   src/ripple/core/impl/DatabaseCon.cpp
   src/ripple/core/impl/Job.cpp
   src/ripple/core/impl/JobQueue.cpp
@@ -478,6 +498,7 @@ target_sources (rippled PRIVATE
   src/ripple/ledger/impl/ReadView.cpp
   src/ripple/ledger/impl/TxMeta.cpp
   src/ripple/ledger/impl/View.cpp
+  src/ripple/ledger/impl/ViewResource.cpp
   #[===============================[
      main sources:
        subdir: net
@@ -499,7 +520,9 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/backend/NuDBFactory.cpp
   src/ripple/nodestore/backend/NullFactory.cpp
   src/ripple/nodestore/backend/RocksDBFactory.cpp
+  src/ripple/nodestore/impl/AccessTrace.cpp
   src/ripple/nodestore/impl/BatchWriter.cpp
+  src/ripple/nodestore/impl/CompressionDictionary.cpp
   src/ripple/nodestore/impl/Database.cpp
   src/ripple/nodestore/impl/DatabaseNodeImp.cpp
   src/ripple/nodestore/impl/DatabaseRotatingImp.cpp
@@ -507,6 +530,8 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/impl/DecodedBlob.cpp
   src/ripple/nodestore/impl/DummyScheduler.cpp
   src/ripple/nodestore/impl/EncodedBlob.cpp
+  src/ripple/nodestore/impl/IoUring.cpp
+  src/ripple/nodestore/impl/KeyFilter.cpp
   src/ripple/nodestore/impl/ManagerImp.cpp
   src/ripple/nodestore/impl/NodeObject.cpp
   src/ripple/nodestore/impl/Shard.cpp
@@ -561,9 +586,11 @@ target_sources (rippled PRIVATE
   src/ripple/rpc/handlers/CanDelete.cpp
   src/ripple/rpc/handlers/Connect.cpp
   src/ripple/rpc/handlers/ConsensusInfo.cpp
+  src/ripple/rpc/handlers/CpuProfile.cpp
   src/ripple/rpc/handlers/CrawlShards.cpp
   src/ripple/rpc/handlers/DepositAuthorized.cpp
   src/ripple/rpc/handlers/DownloadShard.cpp
+  src/ripple/rpc/handlers/ExportShard.cpp
   src/ripple/rpc/handlers/Feature1.cpp
   src/ripple/rpc/handlers/Fee1.cpp
   src/ripple/rpc/handlers/FetchInfo.cpp
@@ -574,6 +601,7 @@ target_sources (rippled PRIVATE
   src/ripple/rpc/handlers/LedgerClosed.cpp
   src/ripple/rpc/handlers/LedgerCurrent.cpp
   src/ripple/rpc/handlers/LedgerData.cpp
+  src/ripple/rpc/handlers/LedgerDiff.cpp
   src/ripple/rpc/handlers/LedgerEntry.cpp
   src/ripple/rpc/handlers/LedgerHandler.cpp
   src/ripple/rpc/handlers/LedgerHeader.cpp
@@ -581,6 +609,7 @@ target_sources (rippled PRIVATE
   src/ripple/rpc/handlers/LogLevel.cpp
   src/ripple/rpc/handlers/LogRotate.cpp
   src/ripple/rpc/handlers/Manifest.cpp
+  src/ripple/rpc/handlers/NodeStoreTrace.cpp
   src/ripple/rpc/handlers/NoRippleCheck.cpp
   src/ripple/rpc/handlers/OwnerInfo.cpp
   src/ripple/rpc/handlers/PathFind.cpp
@@ -612,14 +641,17 @@ target_sources (rippled PRIVATE
   src/ripple/rpc/impl/DeliveredAmount.cpp
   src/ripple/rpc/impl/Handler.cpp
   src/ripple/rpc/impl/GRPCHelpers.cpp
+  src/ripple/rpc/impl/IssuerBalances.cpp
   src/ripple/rpc/impl/LegacyPathFind.cpp
   src/ripple/rpc/impl/RPCHandler.cpp
   src/ripple/rpc/impl/RPCHelpers.cpp
+  src/ripple/rpc/impl/ResponseCache.cpp
   src/ripple/rpc/impl/Role.cpp
   src/ripple/rpc/impl/ServerHandlerImp.cpp
   src/ripple/rpc/impl/ShardArchiveHandler.cpp
   src/ripple/rpc/impl/ShardVerificationScheduler.cpp
   src/ripple/rpc/impl/Status.cpp
+  src/ripple/rpc/impl/StreamedReply.cpp
   src/ripple/rpc/impl/TransactionSign.cpp
 
   #[===============================[
@@ -632,6 +664,7 @@ target_sources (rippled PRIVATE
      main sources:
        subdir: shamap
   #]===============================]
+  src/ripple/shamap/impl/HistoryFamily.cpp
   src/ripple/shamap/impl/NodeFamily.cpp
   src/ripple/shamap/impl/SHAMap.cpp
   src/ripple/shamap/impl/SHAMapDelta.cpp
@@ -651,6 +684,7 @@ target_sources (rippled PRIVATE
   src/test/app/AmendmentTable_test.cpp
   src/test/app/Check_test.cpp
   src/test/app/CrossingLimits_test.cpp
+  src/test/app/DeadOffers_test.cpp
   src/test/app/DeliverMin_test.cpp
   src/test/app/DepositAuth_test.cpp
   src/test/app/Discrepancy_test.cpp
@@ -660,6 +694,7 @@ target_sources (rippled PRIVATE
   src/test/app/Flow_test.cpp
   src/test/app/Freeze_test.cpp
   src/test/app/HashRouter_test.cpp
+  src/test/app/LedgerHashIndex_test.cpp
   src/test/app/LedgerHistory_test.cpp
   src/test/app/LedgerLoad_test.cpp
   src/test/app/LedgerReplay_test.cpp
@@ -668,6 +703,7 @@ target_sources (rippled PRIVATE
   src/test/app/MultiSign_test.cpp
   src/test/app/OfferStream_test.cpp
   src/test/app/Offer_test.cpp
+  src/test/app/OrderBookDB_test.cpp
   src/test/app/OversizeMeta_test.cpp
   src/test/app/Path_test.cpp
   src/test/app/PayChan_test.cpp
@@ -675,42 +711,61 @@ target_sources (rippled PRIVATE
   src/test/app/PseudoTx_test.cpp
   src/test/app/RCLCensorshipDetector_test.cpp
   src/test/app/RCLValidations_test.cpp
+  src/test/app/RecoveryCheckpoint_test.cpp
   src/test/app/Regression_test.cpp
+  src/test/app/ReportingETL_test.cpp
+  src/test/app/RippleLineCache_test.cpp
   src/test/app/SHAMapStore_test.cpp
   src/test/app/SetAuth_test.cpp
   src/test/app/SetRegularKey_test.cpp
   src/test/app/SetTrust_test.cpp
+  src/test/app/SignerListCache_test.cpp
   src/test/app/Taker_test.cpp
   src/test/app/TheoreticalQuality_test.cpp
   src/test/app/Ticket_test.cpp
   src/test/app/Transaction_ordering_test.cpp
   src/test/app/TrustAndBalance_test.cpp
+  src/test/app/TxIndex_test.cpp
   src/test/app/TxQ_test.cpp
+  src/test/app/TxSetSketch_test.cpp
+  src/test/app/TxThroughput_test.cpp
   src/test/app/ValidatorKeys_test.cpp
   src/test/app/ValidatorList_test.cpp
   src/test/app/ValidatorSite_test.cpp
+  src/test/app/WarmStart_test.cpp
   src/test/app/tx/apply_test.cpp
   #[===============================[
      test sources:
        subdir: basics
   #]===============================]
   src/test/basics/Buffer_test.cpp
+  src/test/basics/CacheBudget_test.cpp
+  src/test/basics/CpuProfile_test.cpp
   src/test/basics/DetectCrash_test.cpp
   src/test/basics/FileUtilities_test.cpp
+  src/test/basics/HugePages_test.cpp
   src/test/basics/IOUAmount_test.cpp
   src/test/basics/KeyCache_test.cpp
+  src/test/basics/Log_test.cpp
+  src/test/basics/MemoryUsage_test.cpp
+  src/test/basics/PartitionedTaggedCache_test.cpp
   src/test/basics/PerfLog_test.cpp
   src/test/basics/RangeSet_test.cpp
   src/test/basics/Slice_test.cpp
   src/test/basics/StringUtilities_test.cpp
   src/test/basics/TaggedCache_test.cpp
+  src/test/basics/ThreadAffinity_test.cpp
+  src/test/basics/Tracer_test.cpp
   src/test/basics/XRPAmount_test.cpp
   src/test/basics/base64_test.cpp
   src/test/basics/base_uint_test.cpp
   src/test/basics/contract_test.cpp
   src/test/basics/FeeUnits_test.cpp
+  src/test/basics/flat_hash_map_test.cpp
   src/test/basics/hardened_hash_test.cpp
+  src/test/basics/make_SSLContext_test.cpp
   src/test/basics/mulDiv_test.cpp
+  src/test/basics/strHex_test.cpp
   src/test/basics/tagged_integer_test.cpp
   #[===============================[
      test sources:
@@ -721,6 +776,7 @@ target_sources (rippled PRIVATE
   src/test/beast/SemanticVersion_test.cpp
   src/test/beast/aged_associative_container_test.cpp
   src/test/beast/beast_CurrentThreadName_test.cpp
+  src/test/beast/beast_HistogramBuckets_test.cpp
   src/test/beast/beast_Journal_test.cpp
   src/test/beast/beast_PropertyStream_test.cpp
   src/test/beast/beast_Zero_test.cpp
@@ -738,6 +794,7 @@ target_sources (rippled PRIVATE
        subdir: consensus
   #]===============================]
   src/test/consensus/ByzantineFailureSim_test.cpp
+  src/test/consensus/ConsensusBenchmark_test.cpp
   src/test/consensus/Consensus_test.cpp
   src/test/consensus/DistributedValidatorsSim_test.cpp
   src/test/consensus/LedgerTiming_test.cpp
@@ -830,6 +887,7 @@ target_sources (rippled PRIVATE
   src/test/ledger/CashDiff_test.cpp
   src/test/ledger/Directory_test.cpp
   src/test/ledger/Invariants_test.cpp
+  src/test/ledger/InvariantsPerf_test.cpp
   src/test/ledger/PaymentSandbox_test.cpp
   src/test/ledger/PendingSaves_test.cpp
   src/test/ledger/SkipList_test.cpp
@@ -839,15 +897,19 @@ target_sources (rippled PRIVATE
        subdir: net
   #]===============================]
   src/test/net/DatabaseDownloader_test.cpp
+  src/test/net/PublishedJson_test.cpp
   #[===============================[
      test sources:
        subdir: nodestore
   #]===============================]
   src/test/nodestore/Backend_test.cpp
   src/test/nodestore/Basics_test.cpp
+  src/test/nodestore/CompressionDictionary_test.cpp
   src/test/nodestore/DatabaseShard_test.cpp
   src/test/nodestore/Database_test.cpp
+  src/test/nodestore/KeyFilter_test.cpp
   src/test/nodestore/Timing_test.cpp
+  src/test/nodestore/Workload_test.cpp
   src/test/nodestore/import_test.cpp
   src/test/nodestore/varint_test.cpp
   #[===============================[
@@ -855,6 +917,7 @@ target_sources (rippled PRIVATE
        subdir: overlay
   #]===============================]
   src/test/overlay/ProtocolVersion_test.cpp
+  src/test/overlay/TrafficCount_test.cpp
   src/test/overlay/cluster_test.cpp
   src/test/overlay/short_read_test.cpp
   src/test/overlay/compression_test.cpp
@@ -870,12 +933,14 @@ target_sources (rippled PRIVATE
        subdir: protocol
   #]===============================]
   src/test/protocol/BuildInfo_test.cpp
+  src/test/protocol/Indexes_test.cpp
   src/test/protocol/InnerObjectFormats_test.cpp
   src/test/protocol/Issue_test.cpp
   src/test/protocol/KnownFormatToGRPC_test.cpp
   src/test/protocol/PublicKey_test.cpp
   src/test/protocol/Quality_test.cpp
   src/test/protocol/STAccount_test.cpp
+  src/test/protocol/STAmountPerf_test.cpp
   src/test/protocol/STAmount_test.cpp
   src/test/protocol/STObject_test.cpp
   src/test/protocol/STTx_test.cpp
@@ -884,6 +949,7 @@ target_sources (rippled PRIVATE
   src/test/protocol/Seed_test.cpp
   src/test/protocol/SeqProxy_test.cpp
   src/test/protocol/TER_test.cpp
+  src/test/protocol/digest_test.cpp
   src/test/protocol/types_test.cpp
   #[===============================[
      test sources:
@@ -913,6 +979,7 @@ target_sources (rippled PRIVATE
   src/test/rpc/KeyGeneration_test.cpp
   src/test/rpc/LedgerClosed_test.cpp
   src/test/rpc/LedgerData_test.cpp
+  src/test/rpc/LedgerDiff_test.cpp
   src/test/rpc/LedgerRPC_test.cpp
   src/test/rpc/LedgerRequestRPC_test.cpp
   src/test/rpc/ManifestRPC_test.cpp
@@ -923,6 +990,7 @@ target_sources (rippled PRIVATE
   src/test/rpc/Roles_test.cpp
   src/test/rpc/RPCCall_test.cpp
   src/test/rpc/RPCOverload_test.cpp
+  src/test/rpc/ResponseCache_test.cpp
   src/test/rpc/RobustTransaction_test.cpp
   src/test/rpc/ServerInfo_test.cpp
   src/test/rpc/ShardArchiveHandler_test.cpp
@@ -940,6 +1008,7 @@ target_sources (rippled PRIVATE
      test sources:
        subdir: server
   #]===============================]
+  src/test/server/ServerLoad_test.cpp
   src/test/server/ServerStatus_test.cpp
   src/test/server/Server_test.cpp
   #[===============================[
@@ -947,6 +1016,7 @@ target_sources (rippled PRIVATE
        subdir: shamap
   #]===============================]
   src/test/shamap/FetchPack_test.cpp
+  src/test/shamap/FullBelowCache_test.cpp
   src/test/shamap/SHAMapSync_test.cpp
   src/test/shamap/SHAMap_test.cpp
   #[===============================[
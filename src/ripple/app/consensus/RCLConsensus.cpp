@@ -96,6 +96,8 @@ RCLConsensus::Adaptor::Adaptor(
 {
     assert(valCookie_ != 0);
 
+    parms_.ledgerEARLY_CONSENSUS_PCT = app_.config().EARLY_CONSENSUS_PCT;
+
     JLOG(j_.info()) << "Consensus engine started"
                     << " (Node: " << to_string(nodeID_)
                     << ", Cookie: " << valCookie_ << ")";
@@ -173,8 +175,7 @@ RCLConsensus::Adaptor::share(RCLCxTx const& tx)
         msg.set_status(protocol::tsNEW);
         msg.set_receivetimestamp(
             app_.timeKeeper().now().time_since_epoch().count());
-        app_.overlay().foreach(send_always(
-            std::make_shared<Message>(msg, protocol::mtTRANSACTION)));
+        app_.overlay().relay(msg, tx.id(), {}, {});
     }
     else
     {
@@ -211,6 +212,18 @@ RCLConsensus::Adaptor::propose(RCLCxPeerPos::Proposal const& proposal)
 
     prop.set_signature(sig.data(), sig.size());
 
+    // Peers lacking a large set may be able to rebuild it from one of
+    // their own rather than acquiring it.
+    if (!proposal.isBowOut())
+    {
+        if (auto const sketch =
+                inboundTransactions_.getSketch(proposal.position()))
+        {
+            auto const wire = sketch->toWire();
+            prop.set_txsetsketch(wire.data(), wire.size());
+        }
+    }
+
     auto const suppression = proposalUniqueId(
         proposal.position(),
         proposal.prevLedger(),
@@ -92,7 +92,7 @@ public:
         {
             return map_->addItem(
                 SHAMapNodeType::tnTRANSACTION_NM,
-                SHAMapItem{t.id(), t.tx_.peekData()});
+                SHAMapItem{t.id(), t.tx_.slice()});
         }
 
         /** Remove a transaction from the set.
@@ -31,12 +31,74 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/TimeKeeper.h>
+#include <ripple/json/to_string.h>
 #include <memory>
 #include <mutex>
 #include <thread>
 
 namespace ripple {
 
+RCLValidation::RCLValidation(std::shared_ptr<STValidation> const& v)
+    : ledgerID_{v->getLedgerHash()}
+    , key_{v->getSignerPublic()}
+    , nodeID_{v->getNodeID()}
+    , signTime_{v->getSignTime()}
+    , seenTime_{v->getSeenTime()}
+    , cookie_{(*v)[sfCookie]}
+    , loadFee_{~(*v)[~sfLoadFee]}
+    , seq_{v->getFieldU32(sfLedgerSequence)}
+    , trusted_{v->isTrusted()}
+    , full_{v->isFull()}
+{
+    if (trusted_)
+        val_ = v;
+    else
+        raw_ = std::make_shared<Blob const>(v->getSerialized());
+}
+
+std::shared_ptr<STValidation>
+RCLValidation::rebuild() const
+{
+    assert(raw_);
+    SerialIter sit(makeSlice(*raw_));
+    auto v = std::make_shared<STValidation>(
+        sit, [this](PublicKey const&) { return nodeID_; }, false);
+    v->setSeen(seenTime_);
+    if (trusted_)
+        v->setTrusted();
+    return v;
+}
+
+void
+RCLValidation::setTrusted()
+{
+    if (!val_)
+    {
+        trusted_ = true;
+        val_ = rebuild();
+        raw_.reset();
+    }
+    else
+    {
+        // Copies of this validation may share the STValidation
+        trusted_ = true;
+        val_->setTrusted();
+    }
+}
+
+void
+RCLValidation::setUntrusted()
+{
+    trusted_ = false;
+    if (val_)
+    {
+        // Copies of this validation may share the STValidation
+        val_->setUntrusted();
+        raw_ = std::make_shared<Blob const>(val_->getSerialized());
+        val_.reset();
+    }
+}
+
 RCLValidatedLedger::RCLValidatedLedger(MakeGenesis)
     : ledgerID_{0}, ledgerSeq_{0}, j_{beast::Journal::getNullSink()}
 {
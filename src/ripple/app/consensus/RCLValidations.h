@@ -34,11 +34,17 @@ class Application;
 /** Wrapper over STValidation for generic Validation code
 
     Wraps an STValidation for compatibility with the generic validation code.
+
+    Validations are retained for a while after they are processed, and on a
+    server seeing many validators most of them are untrusted. So only the
+    fields the generic code reads are kept. An untrusted validation also
+    keeps its serialized form, which is much smaller than the STValidation,
+    from which the STValidation is rebuilt if the validator becomes trusted.
+    Trusted validations, which are few and are read back by the voting and
+    ledger acceptance code, keep the STValidation itself.
 */
 class RCLValidation
 {
-    std::shared_ptr<STValidation> val_;
-
 public:
     using NodeKey = ripple::PublicKey;
     using NodeID = ripple::NodeID;
@@ -47,98 +53,112 @@ public:
 
         @param v The validation to wrap.
     */
-    RCLValidation(std::shared_ptr<STValidation> const& v) : val_{v}
-    {
-    }
+    RCLValidation(std::shared_ptr<STValidation> const& v);
 
     /// Validated ledger's hash
     uint256
     ledgerID() const
     {
-        return val_->getLedgerHash();
+        return ledgerID_;
     }
 
     /// Validated ledger's sequence number (0 if none)
     std::uint32_t
     seq() const
     {
-        return val_->getFieldU32(sfLedgerSequence);
+        return seq_;
     }
 
     /// Validation's signing time
     NetClock::time_point
     signTime() const
     {
-        return val_->getSignTime();
+        return signTime_;
     }
 
     /// Validated ledger's first seen time
     NetClock::time_point
     seenTime() const
     {
-        return val_->getSeenTime();
+        return seenTime_;
     }
 
     /// Public key of validator that published the validation
     PublicKey
     key() const
     {
-        return val_->getSignerPublic();
+        return key_;
     }
 
     /// NodeID of validator that published the validation
     NodeID
     nodeID() const
     {
-        return val_->getNodeID();
+        return nodeID_;
     }
 
     /// Whether the validation is considered trusted.
     bool
     trusted() const
     {
-        return val_->isTrusted();
+        return trusted_;
     }
 
     void
-    setTrusted()
-    {
-        val_->setTrusted();
-    }
+    setTrusted();
 
     void
-    setUntrusted()
-    {
-        val_->setUntrusted();
-    }
+    setUntrusted();
 
     /// Whether the validation is full (not-partial)
     bool
     full() const
     {
-        return val_->isFull();
+        return full_;
     }
 
     /// Get the load fee of the validation if it exists
     boost::optional<std::uint32_t>
     loadFee() const
     {
-        return ~(*val_)[~sfLoadFee];
+        return loadFee_;
     }
 
     /// Get the cookie specified in the validation (0 if not set)
     std::uint64_t
     cookie() const
     {
-        return (*val_)[sfCookie];
+        return cookie_;
     }
 
     /// Extract the underlying STValidation being wrapped
     std::shared_ptr<STValidation>
     unwrap() const
     {
-        return val_;
+        return val_ ? val_ : rebuild();
     }
+
+private:
+    // The validation, kept only while it is trusted
+    std::shared_ptr<STValidation> val_;
+
+    // The serialized validation, kept only while it is untrusted
+    std::shared_ptr<Blob const> raw_;
+
+    uint256 ledgerID_;
+    PublicKey key_;
+    NodeID nodeID_;
+    NetClock::time_point signTime_;
+    NetClock::time_point seenTime_;
+    std::uint64_t cookie_;
+    boost::optional<std::uint32_t> loadFee_;
+    std::uint32_t seq_;
+    bool trusted_;
+    bool full_;
+
+    // Rebuild the STValidation from the serialized form
+    std::shared_ptr<STValidation>
+    rebuild() const;
 };
 
 /** Wraps a ledger instance for use in generic Validations LedgerTrie.
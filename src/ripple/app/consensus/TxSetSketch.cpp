@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/consensus/TxSetSketch.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/SHAMap.h>
+#include <cstring>
+
+namespace ripple {
+
+TxSetSketch::TxSetSketch() = default;
+
+TxSetSketch::TxSetSketch(SHAMap const& set)
+{
+    for (auto const& item : set)
+        insert(item.key());
+}
+
+std::optional<TxSetSketch>
+TxSetSketch::fromWire(Slice data)
+{
+    if (data.size() != wireSize)
+        return {};
+
+    TxSetSketch sketch;
+    SerialIter sit(data);
+    for (auto& cell : sketch.cells_)
+    {
+        cell.count = static_cast<std::int32_t>(sit.get32());
+        cell.ids = sit.get256();
+        cell.check = sit.get64();
+    }
+    return sketch;
+}
+
+Blob
+TxSetSketch::toWire() const
+{
+    Serializer s(wireSize);
+    for (auto const& cell : cells_)
+    {
+        s.add32(static_cast<std::uint32_t>(cell.count));
+        s.addBitString(cell.ids);
+        s.add64(cell.check);
+    }
+    return s.getData();
+}
+
+auto
+TxSetSketch::locate(uint256 const& id)
+    -> std::pair<std::array<std::size_t, hashCount>, std::uint64_t>
+{
+    // Transaction IDs are chosen by whoever signs the transaction, so hash
+    // them again rather than using their bits directly.
+    auto const digest = sha512Half(id);
+    std::array<std::uint64_t, 4> words;
+    static_assert(sizeof(words) == uint256::bytes);
+    std::memcpy(words.data(), digest.data(), sizeof(words));
+
+    std::pair<std::array<std::size_t, hashCount>, std::uint64_t> result;
+    for (std::size_t i = 0; i < hashCount; ++i)
+        result.first[i] = i * partSize + words[i] % partSize;
+    result.second = words[hashCount];
+    return result;
+}
+
+void
+TxSetSketch::toggle(uint256 const& id, std::int32_t count)
+{
+    auto const [indexes, check] = locate(id);
+    for (auto const i : indexes)
+    {
+        auto& cell = cells_[i];
+        cell.count += count;
+        cell.ids ^= id;
+        cell.check ^= check;
+    }
+}
+
+void
+TxSetSketch::insert(uint256 const& id)
+{
+    toggle(id, 1);
+}
+
+std::size_t
+TxSetSketch::size() const
+{
+    // Every ID is counted once in each part of the table
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < partSize; ++i)
+        total += cells_[i].count;
+    return total < 0 ? 0 : static_cast<std::size_t>(total);
+}
+
+auto
+TxSetSketch::difference(TxSetSketch const& other) const
+    -> std::optional<Difference>
+{
+    TxSetSketch diff;
+    for (std::size_t i = 0; i < cellCount; ++i)
+    {
+        auto& cell = diff.cells_[i];
+        cell.count = cells_[i].count - other.cells_[i].count;
+        cell.ids = cells_[i].ids ^ other.cells_[i].ids;
+        cell.check = cells_[i].check ^ other.cells_[i].check;
+    }
+
+    // Repeatedly take out an ID from a cell which holds only that ID, until
+    // no such cell is left. Taking one out may leave others holding one ID.
+    Difference result;
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (auto const& cell : diff.cells_)
+        {
+            if (cell.count != 1 && cell.count != -1)
+                continue;
+            auto const id = cell.ids;
+            if (locate(id).second != cell.check)
+                continue;
+
+            auto const count = cell.count;
+            if (count == 1)
+                result.added.push_back(id);
+            else
+                result.removed.push_back(id);
+            diff.toggle(id, -count);
+            progress = true;
+        }
+    }
+
+    for (auto const& cell : diff.cells_)
+    {
+        if (!cell.empty())
+            return {};
+    }
+    return result;
+}
+
+}  // namespace ripple
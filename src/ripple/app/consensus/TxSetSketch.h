@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_CONSENSUS_TXSETSKETCH_H_INCLUDED
+#define RIPPLE_APP_CONSENSUS_TXSETSKETCH_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ripple {
+
+class SHAMap;
+
+/** A fixed size summary of a set of transaction IDs.
+
+    This is an invertible Bloom lookup table. Each ID is added to one cell
+    in each of three equal parts of the table, and each cell keeps a count,
+    the exclusive-or of its IDs and the exclusive-or of a checksum of each
+    ID. Subtracting the sketch of one set from the sketch of another leaves
+    only the IDs in one set but not the other, and as long as there are not
+    too many of them they can be recovered.
+
+    A node proposing a large transaction set sends its sketch along with
+    the proposal. A node which lacks that set can compare the sketch with
+    one of its own sets, learn exactly which transactions differ, and
+    rebuild the proposed set without acquiring it from a peer.
+*/
+class TxSetSketch
+{
+public:
+    /** The number of cells. About half as many differences as this can
+        usually be recovered. */
+    static constexpr std::size_t cellCount = 60;
+
+    /** The size of a serialized sketch in bytes. */
+    static constexpr std::size_t wireSize = cellCount * (4 + 32 + 8);
+
+    /** The smallest set a sketch is sent for. Smaller sets are cheap to
+        acquire, so the sketch would cost more bandwidth than it saves. */
+    static constexpr std::size_t minSetSize = 256;
+
+    TxSetSketch();
+
+    /** Sketch the transactions in a transaction set. */
+    explicit TxSetSketch(SHAMap const& set);
+
+    /** Parse a serialized sketch. Returns nothing if it is malformed. */
+    static std::optional<TxSetSketch>
+    fromWire(Slice data);
+
+    Blob
+    toWire() const;
+
+    void
+    insert(uint256 const& id);
+
+    /** The number of IDs in the sketched set. */
+    std::size_t
+    size() const;
+
+    /** The differences between two sets. */
+    struct Difference
+    {
+        /** IDs in the sketched set but not in the other. */
+        std::vector<uint256> added;
+        /** IDs in the other set but not in the sketched one. */
+        std::vector<uint256> removed;
+    };
+
+    /** Recover the IDs in exactly one of this set and `other`.
+
+        @return The difference, or nothing if there are too many
+            differences to recover.
+    */
+    std::optional<Difference>
+    difference(TxSetSketch const& other) const;
+
+private:
+    struct Cell
+    {
+        std::int32_t count = 0;
+        uint256 ids;
+        std::uint64_t check = 0;
+
+        bool
+        empty() const
+        {
+            return count == 0 && check == 0 && ids.isZero();
+        }
+    };
+
+    static constexpr std::size_t hashCount = 3;
+    static constexpr std::size_t partSize = cellCount / hashCount;
+    static_assert(cellCount % hashCount == 0);
+
+    // The cells an ID is added to and its checksum
+    static std::pair<std::array<std::size_t, hashCount>, std::uint64_t>
+    locate(uint256 const& id);
+
+    void
+    toggle(uint256 const& id, std::int32_t count);
+
+    std::array<Cell, cellCount> cells_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -18,22 +18,93 @@
 //==============================================================================
 
 #include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/ledger/Ledger.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/chrono.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 
+namespace {
+
+// Most ledgers hold fewer transactions than this, and deserializing them
+// takes less time than starting the threads would
+constexpr std::size_t parallelLoadMinimum = 64;
+
+// The most threads used to load the transactions of a ledger
+constexpr unsigned int parallelLoadThreads = 4;
+
+}  // namespace
+
 AcceptedLedger::AcceptedLedger(
     std::shared_ptr<ReadView const> const& ledger,
     AccountIDCache const& accountCache,
     Logs& logs)
     : mLedger(ledger)
 {
-    for (auto const& item : ledger->txs)
+    // The transactions of a closed ledger can be taken from its map and
+    // deserialized, checked and rendered on several threads. Each lands in
+    // the map by its index, so the order is the same either way.
+    std::vector<SHAMapItem const*> items;
+    if (auto const closed = std::dynamic_pointer_cast<Ledger const>(ledger))
+    {
+        for (auto const& item : closed->txMap())
+            items.push_back(&item);
+    }
+
+    if (items.size() < parallelLoadMinimum)
     {
-        insert(std::make_shared<AcceptedLedgerTx>(
-            ledger, item.first, item.second, accountCache, logs));
+        for (auto const& item : ledger->txs)
+        {
+            insert(std::make_shared<AcceptedLedgerTx>(
+                ledger, item.first, item.second, accountCache, logs));
+        }
+        return;
     }
+
+    std::vector<AcceptedLedgerTx::pointer> txns(items.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto worker = [&]() {
+        for (auto i = next++; i < items.size(); i = next++)
+        {
+            try
+            {
+                auto const [txn, meta] = deserializeTxPlusMeta(*items[i]);
+                txns[i] = std::make_shared<AcceptedLedgerTx>(
+                    ledger, txn, meta, accountCache, logs);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+
+    auto const threads = std::clamp(
+        std::thread::hardware_concurrency(), 1u, parallelLoadThreads);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    for (auto const& txn : txns)
+        insert(txn);
 }
 
 void
@@ -117,6 +117,11 @@ public:
     }
     std::string
     getEscMeta() const;
+    Blob const&
+    getRawMeta() const
+    {
+        return mRawMeta;
+    }
     Json::Value
     getJson() const
     {
@@ -38,9 +38,9 @@ BookListeners::removeSubscriber(std::uint64_t seq)
 }
 
 void
-BookListeners::publish(
-    Json::Value const& jvObj,
-    hash_set<std::uint64_t>& havePublished)
+BookListeners::getListeners(
+    hash_set<std::uint64_t>& havePublished,
+    std::vector<InfoSub::pointer>& listeners)
 {
     std::lock_guard sl(mLock);
     auto it = mListeners.cbegin();
@@ -51,11 +51,9 @@ BookListeners::publish(
 
         if (p)
         {
-            // Only publish jvObj if this is the first occurence
+            // Only publish msg if this is the first occurence
             if (havePublished.emplace(p->getSeq()).second)
-            {
-                p->send(jvObj, true);
-            }
+                listeners.push_back(std::move(p));
             ++it;
         }
         else
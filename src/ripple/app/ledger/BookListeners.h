@@ -23,6 +23,7 @@
 #include <ripple/net/InfoSub.h>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -46,19 +47,20 @@ public:
     void
     removeSubscriber(std::uint64_t sub);
 
-    /** Publish a transaction to subscribers
+    /** Gather the subscribers to publish a transaction to
 
-        Publish a transaction to clients subscribed to changes on this book.
+        Adds the clients subscribed to changes on this book to listeners.
         Uses havePublished to prevent sending duplicate transactions to clients
         that have subscribed to multiple books.
 
-        @param jvObj JSON transaction data to publish
-        @param havePublished InfoSub sequence numbers that have already
-                             published this transaction.
-
+        @param havePublished InfoSub sequence numbers that already have
+                             the transaction.
+        @param listeners The subscribers to send the transaction to.
     */
     void
-    publish(Json::Value const& jvObj, hash_set<std::uint64_t>& havePublished);
+    getListeners(
+        hash_set<std::uint64_t>& havePublished,
+        std::vector<InfoSub::pointer>& listeners);
 
 private:
     std::recursive_mutex mLock;
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_BOOKSNAPSHOT_H_INCLUDED
+#define RIPPLE_APP_LEDGER_BOOKSNAPSHOT_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** The offers at the front of an order book, in quality order.
+
+    Reading a book means stepping through its directory pages and reading
+    each offer and the funds of each owner from the ledger. A snapshot
+    does that once, so that a book in a closed ledger, which can't change,
+    can be read again from memory.
+*/
+class BookSnapshot
+{
+public:
+    struct Offer
+    {
+        std::shared_ptr<SLE const> sle;
+        AccountID owner;
+        STAmount takerGets;
+        STAmount takerPays;
+
+        // The quality of the directory holding the offer
+        STAmount quality;
+
+        // What the owner has to fund the offer with, before any of it is
+        // used by the owner's earlier offers
+        STAmount ownerFunds;
+    };
+
+    /** Read up to `limit` offers of a book. */
+    BookSnapshot(
+        ReadView const& view,
+        Book const& book,
+        std::size_t limit,
+        beast::Journal j);
+
+    std::vector<Offer> const&
+    offers() const
+    {
+        return offers_;
+    }
+
+    /** Whether the snapshot holds every offer in the book. */
+    bool
+    complete() const
+    {
+        return complete_;
+    }
+
+    /** Whether either side of the book is globally frozen. */
+    bool
+    frozen() const
+    {
+        return frozen_;
+    }
+
+private:
+    std::vector<Offer> offers_;
+    bool complete_ = true;
+    bool frozen_;
+};
+
+/** Snapshots of the order books requested in recent closed ledgers. */
+class BookSnapshots
+{
+public:
+    /** @param limit The most offers a snapshot holds. */
+    explicit BookSnapshots(std::size_t limit);
+
+    /** Get a snapshot with at least `limit` offers of a book, or every
+        offer if there are fewer.
+
+        @return The snapshot, or nullptr if the ledger is open or more
+            offers are wanted than a snapshot holds.
+    */
+    std::shared_ptr<BookSnapshot const>
+    get(std::shared_ptr<ReadView const> const& ledger,
+        Book const& book,
+        std::size_t limit,
+        beast::Journal j);
+
+private:
+    // How many ledgers, and how many books in each, snapshots are kept for
+    static constexpr std::size_t maxLedgers = 4;
+    static constexpr std::size_t maxBooks = 256;
+
+    std::size_t const limit_;
+
+    std::mutex mutex_;
+    std::map<
+        std::pair<LedgerIndex, uint256>,
+        hash_map<uint256, std::shared_ptr<BookSnapshot const>>>
+        ledgers_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -24,6 +24,7 @@
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/ledger/ApplyView.h>
 #include <chrono>
+#include <functional>
 #include <memory>
 
 namespace ripple {
@@ -33,6 +34,7 @@ class CanonicalTXSet;
 class Ledger;
 class LedgerReplay;
 class SHAMap;
+class STTx;
 
 /** Build a new ledger by applying consensus transactions
 
@@ -69,6 +71,8 @@ buildLedger(
     @param applyFlags Flags to use when applying transactions
     @param app Handle to application instance
     @param j Journal to use for logging
+    @param onApply If set, called after each transaction is applied with
+                   the time it took to apply
     @return The newly built ledger
  */
 std::shared_ptr<Ledger>
@@ -76,7 +80,9 @@ buildLedger(
     LedgerReplay const& replayData,
     ApplyFlags applyFlags,
     Application& app,
-    beast::Journal j);
+    beast::Journal j,
+    std::function<void(STTx const&, std::chrono::steady_clock::duration)> const&
+        onApply = nullptr);
 
 }  // namespace ripple
 #endif
@@ -23,7 +23,10 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/core/Job.h>
 #include <ripple/overlay/PeerSet.h>
+#include <atomic>
 #include <mutex>
 #include <set>
 #include <utility>
@@ -88,6 +91,29 @@ public:
         return mSeq;
     }
 
+    Reason
+    getReason() const
+    {
+        return mReason;
+    }
+
+    /** The job type for work on this acquisition.
+
+        Past ledgers and shards are processed at a lower priority than
+        ledgers which are needed to follow the network.
+    */
+    JobType
+    jobType() const
+    {
+        return mReason == Reason::HISTORY || mReason == Reason::SHARD
+            ? jtLEDGER_HISTORY
+            : jtLEDGER_DATA;
+    }
+
+    /** An estimate of the memory held by the nodes acquired so far. */
+    std::size_t
+    getMemoryUse() const;
+
     bool
     checkLocal();
     void
@@ -126,11 +152,65 @@ private:
     void
     filterNodes(
         std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-        TriggerReason reason);
+        TriggerReason reason,
+        std::size_t peers);
 
     void
     trigger(std::shared_ptr<Peer> const&, TriggerReason);
 
+    /** Return the peers to split requests for nodes between.
+
+        This is empty unless striping is configured and at least two peers
+        are available. The peers which have delivered the most come first.
+    */
+    std::vector<std::shared_ptr<Peer>>
+    stripePeers(TriggerReason reason) const;
+
+    /** Request nodes of the ledger.
+
+        Without striping the request goes to `peer`, or to every peer in the
+        set if that's null. Otherwise each of the striped peers is asked for
+        its own share of the nodes.
+    */
+    void
+    sendNodeRequest(
+        protocol::TMGetLedger& tmGL,
+        std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+        std::shared_ptr<Peer> const& peer,
+        std::vector<std::shared_ptr<Peer>> const& stripe);
+
+    /** Ask a peer for the state nodes which differ from an adjacent ledger.
+
+        When we have the parent or the child of this ledger, the state tree
+        is mostly shared with it, so one request for the changed nodes
+        replaces descending the tree a level at a time. Done at most once,
+        before the first request for state nodes.
+
+        @return `true` if the request was sent
+    */
+    bool
+    requestDelta(std::shared_ptr<Peer> const& peer);
+
+    /** Whether the state tree may be rebuilt by replaying transactions.
+
+        When we hold the parent of this ledger, its transactions are
+        acquired first and applied to the parent, which produces the state
+        tree without asking peers for any of it. Tried at most once.
+    */
+    bool
+    canReplay() const;
+
+    /** Build the ledger from its parent and its transactions.
+
+        Releases the lock while the transactions are applied. If the
+        result does not match the ledger's hash, the state tree is
+        acquired from peers as usual.
+
+        @return `true` if the replayed ledger was taken
+    */
+    bool
+    tryReplay(ScopedLockType& sl);
+
     std::vector<neededHash_t>
     getNeededHashes();
 
@@ -185,6 +265,11 @@ private:
     std::vector<uint256>
     neededStateHashes(int max, SHAMapSyncFilter* filter) const;
 
+    // Ledgers needed to keep up with the network read from the node store
+    // ahead of those being acquired for history.
+    NodeStore::FetchPriority
+    fetchPriority() const;
+
     clock_type& m_clock;
     clock_type::time_point mLastAction;
 
@@ -194,13 +279,28 @@ private:
     bool mHaveTransactions;
     bool mSignaled;
     bool mByHash;
+    bool mDeltaRequested;
+    bool mReplayTried;
     std::uint32_t mSeq;
     Reason const mReason;
 
     std::set<uint256> mRecentNodes;
 
+    // The useful nodes each peer has delivered, which weights its share of
+    // striped requests
+    hash_map<Peer::id_t, std::uint32_t> mPeerNodes;
+
+    // The peer each node was last asked of when striping, in this timer
+    // interval and in the one before. A node that is still missing a whole
+    // interval after it was requested is asked of a different peer.
+    hash_map<uint256, Peer::id_t> mRequested;
+    hash_map<uint256, Peer::id_t> mStragglers;
+
     SHAMapAddNode mStats;
 
+    // The nodes added to the ledger's maps, which it holds until complete
+    std::atomic<std::size_t> mNodes{0};
+
     // Data we have received from peers
     std::mutex mReceivedDataLock;
     std::vector<PeerDataPairType> mReceivedData;
@@ -46,6 +46,14 @@ public:
     virtual std::shared_ptr<InboundLedger>
     find(LedgerHash const& hash) = 0;
 
+    /** Returns true if acquisitions for `reason` should hold back.
+
+        Past ledgers and shards wait while a ledger the consensus round
+        needs is being acquired, so that its requests and data come first.
+    */
+    virtual bool
+    isPreempted(InboundLedger::Reason reason) = 0;
+
     // VFALCO TODO Remove the dependency on the Peer object.
     //
     virtual bool
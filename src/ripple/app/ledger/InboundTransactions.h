@@ -20,11 +20,13 @@
 #ifndef RIPPLE_APP_LEDGER_INBOUNDTRANSACTIONS_H_INCLUDED
 #define RIPPLE_APP_LEDGER_INBOUNDTRANSACTIONS_H_INCLUDED
 
+#include <ripple/app/consensus/TxSetSketch.h>
 #include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/overlay/Peer.h>
 #include <ripple/shamap/SHAMap.h>
 #include <memory>
+#include <optional>
 
 namespace ripple {
 
@@ -81,6 +83,26 @@ public:
         std::shared_ptr<SHAMap> const& set,
         bool acquired) = 0;
 
+    /** Return a sketch of a transaction set we have.
+     *
+     * @param setHash The transaction set ID (digest of the SHAMap root node).
+     * @return The sketch, or nothing if the set is missing or too small
+     * to be worth sketching.
+     */
+    virtual std::optional<TxSetSketch>
+    getSketch(uint256 const& setHash) = 0;
+
+    /** Add a sketch of a transaction set from a trusted proposal.
+     *
+     * If the set is later needed, the sketch may allow it to be rebuilt
+     * from a set we already have and transactions we already know.
+     *
+     * @param setHash The transaction set ID (digest of the SHAMap root node).
+     * @param sketch The serialized TxSetSketch.
+     */
+    virtual void
+    gotSketch(uint256 const& setHash, Slice sketch) = 0;
+
     /** Informs the container if a new consensus round
      */
     virtual void
@@ -29,6 +29,9 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/TxIndex.h>
+#include <ripple/app/rdb/RelationalDBInterface.h>
+#include <ripple/basics/HugePages.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/basics/contract.h>
@@ -49,8 +52,11 @@
 #include <ripple/protocol/digest.h>
 #include <ripple/protocol/jss.h>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <cassert>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -275,6 +281,7 @@ Ledger::Ledger(Ledger const& prevLedger, NetClock::time_point closeTime)
         prevLedger.info_.closeTimeResolution,
         getCloseAgree(prevLedger.info()),
         info_.seq);
+    changes_ = std::make_unique<hash_map<uint256, StateChange>>();
 
     if (prevLedger.info_.closeTime == NetClock::time_point{})
     {
@@ -334,6 +341,51 @@ Ledger::setImmutable(Config const& config)
     txMap_->setImmutable();
     stateMap_->setImmutable();
     setup(config);
+
+    if (changes_)
+    {
+        auto delta =
+            std::make_shared<StateDelta>(changes_->begin(), changes_->end());
+        std::sort(delta->begin(), delta->end());
+        setStateDelta(std::move(delta));
+        changes_.reset();
+    }
+}
+
+std::shared_ptr<StateDelta const>
+Ledger::stateDelta() const
+{
+    std::lock_guard lock(deltaMutex_);
+    return delta_;
+}
+
+void
+Ledger::setStateDelta(std::shared_ptr<StateDelta const> delta) const
+{
+    std::lock_guard lock(deltaMutex_);
+    delta_ = std::move(delta);
+}
+
+void
+Ledger::recordChange(uint256 const& key, StateChange change)
+{
+    auto const [iter, inserted] = changes_->emplace(key, change);
+    if (inserted)
+        return;
+
+    // Combine this change with the earlier one to the same entry
+    auto& earlier = iter->second;
+    if (change == StateChange::deleted)
+    {
+        if (earlier == StateChange::created)
+            changes_->erase(iter);
+        else
+            earlier = StateChange::deleted;
+    }
+    else if (earlier == StateChange::deleted)
+    {
+        earlier = StateChange::modified;
+    }
 }
 
 void
@@ -397,12 +449,40 @@ Ledger::exists(Keylet const& k) const
 boost::optional<uint256>
 Ledger::succ(uint256 const& key, boost::optional<uint256> const& last) const
 {
-    auto item = stateMap_->upper_bound(key);
+    if (!mImmutable)
+    {
+        auto item = stateMap_->upper_bound(key);
+        if (item == stateMap_->end())
+            return boost::none;
+        if (last && item->key() >= last)
+            return boost::none;
+        return item->key();
+    }
+
+    // Walks through directories and order books call succ with the result
+    // of the previous call, so starting from where that one ended saves
+    // walking down from the root. Another thread using the hint just means
+    // this search starts from the root.
+    boost::optional<SHAMap::const_iterator> hint;
+    {
+        std::unique_lock lock(succMutex_, std::try_to_lock);
+        if (lock)
+            hint.swap(succHint_);
+    }
+
+    auto item = hint ? stateMap_->upper_bound(key, std::move(*hint))
+                     : stateMap_->upper_bound(key);
     if (item == stateMap_->end())
         return boost::none;
-    if (last && item->key() >= last)
-        return boost::none;
-    return item->key();
+
+    boost::optional<uint256> result;
+    if (!last || item->key() < *last)
+        result = item->key();
+
+    std::unique_lock lock(succMutex_, std::try_to_lock);
+    if (lock)
+        succHint_.emplace(std::move(item));
+    return result;
 }
 
 std::shared_ptr<SLE const>
@@ -416,8 +496,9 @@ Ledger::read(Keylet const& k) const
     auto const& item = stateMap_->peekItem(k.key);
     if (!item)
         return nullptr;
-    auto sle = std::make_shared<SLE>(
-        SerialIter{item->data(), item->size()}, item->key());
+    // The item is immutable, so the entry can leave its fields in the item
+    // until they are read.
+    auto sle = std::make_shared<SLE>(item->slice(), item, item->key());
     if (!k.check(*sle))
         return nullptr;
     return sle;
@@ -494,6 +575,8 @@ Ledger::rawErase(std::shared_ptr<SLE> const& sle)
 {
     if (!stateMap_->delItem(sle->key()))
         LogicError("Ledger::rawErase: key not found");
+    if (changes_)
+        recordChange(sle->key(), StateChange::deleted);
 }
 
 void
@@ -503,8 +586,10 @@ Ledger::rawInsert(std::shared_ptr<SLE> const& sle)
     sle->add(ss);
     if (!stateMap_->addGiveItem(
             SHAMapNodeType::tnACCOUNT_STATE,
-            std::make_shared<SHAMapItem const>(sle->key(), std::move(ss))))
+            make_pooled<SHAMapItem const>(sle->key(), std::move(ss))))
         LogicError("Ledger::rawInsert: key already exists");
+    if (changes_)
+        recordChange(sle->key(), StateChange::created);
 }
 
 void
@@ -514,8 +599,57 @@ Ledger::rawReplace(std::shared_ptr<SLE> const& sle)
     sle->add(ss);
     if (!stateMap_->updateGiveItem(
             SHAMapNodeType::tnACCOUNT_STATE,
-            std::make_shared<SHAMapItem const>(sle->key(), std::move(ss))))
+            make_pooled<SHAMapItem const>(sle->key(), std::move(ss))))
         LogicError("Ledger::rawReplace: key not found");
+    if (changes_)
+        recordChange(sle->key(), StateChange::modified);
+}
+
+void
+Ledger::rawApply(std::vector<RawChange> const& changes)
+{
+    // Make the changes in one pass over the state map, which copies each
+    // inner node on the way to a changed entry only once
+    std::vector<SHAMap::Change> items;
+    items.reserve(changes.size());
+    for (auto const& change : changes)
+    {
+        auto const& key = change.sle->key();
+        if (change.action == RawChange::Action::erase)
+        {
+            items.push_back({key, nullptr});
+            continue;
+        }
+
+        Serializer ss;
+        change.sle->add(ss);
+        items.push_back(
+            {key,
+             make_pooled<SHAMapItem const>(key, std::move(ss)),
+             change.action == RawChange::Action::insert});
+    }
+
+    if (!stateMap_->applyChanges(SHAMapNodeType::tnACCOUNT_STATE, items))
+        LogicError("Ledger::rawApply: inconsistent changes");
+
+    if (changes_)
+    {
+        for (auto const& change : changes)
+        {
+            switch (change.action)
+            {
+                case RawChange::Action::erase:
+                    recordChange(change.sle->key(), StateChange::deleted);
+                    break;
+                case RawChange::Action::insert:
+                    recordChange(change.sle->key(), StateChange::created);
+                    break;
+                case RawChange::Action::replace:
+                    recordChange(change.sle->key(), StateChange::modified);
+                    break;
+            }
+        }
+    }
 }
 
 void
@@ -532,7 +666,7 @@ Ledger::rawTxInsert(
     s.addVL(metaData->peekData());
     if (!txMap().addGiveItem(
             SHAMapNodeType::tnTRANSACTION_MD,
-            std::make_shared<SHAMapItem const>(key, std::move(s))))
+            make_pooled<SHAMapItem const>(key, std::move(s))))
         LogicError("duplicate_tx: " + to_string(key));
 }
 
@@ -711,17 +845,25 @@ Ledger::updateNegativeUNL()
 
 //------------------------------------------------------------------------------
 bool
-Ledger::walkLedger(beast::Journal j) const
+Ledger::walkLedger(beast::Journal j, bool parallel) const
 {
     std::vector<SHAMapMissingNode> missingNodes1;
     std::vector<SHAMapMissingNode> missingNodes2;
 
+    // The most threads used to walk each map
+    auto const walkThreads =
+        std::clamp(std::thread::hardware_concurrency(), 1u, 4u);
+
     if (stateMap_->getHash().isZero() && !info_.accountHash.isZero() &&
         !stateMap_->fetchRoot(SHAMapHash{info_.accountHash}, nullptr))
     {
         missingNodes1.emplace_back(
             SHAMapType::STATE, SHAMapHash{info_.accountHash});
     }
+    else if (parallel)
+    {
+        stateMap_->walkMapParallel(missingNodes1, 32, walkThreads);
+    }
     else
     {
         stateMap_->walkMap(missingNodes1, 32);
@@ -742,6 +884,10 @@ Ledger::walkLedger(beast::Journal j) const
         missingNodes2.emplace_back(
             SHAMapType::TRANSACTION, SHAMapHash{info_.txHash});
     }
+    else if (parallel)
+    {
+        txMap_->walkMapParallel(missingNodes2, 32, walkThreads);
+    }
     else
     {
         txMap_->walkMap(missingNodes2, 32);
@@ -863,166 +1009,239 @@ isFlagLedger(LedgerIndex seq)
     return seq % FLAG_LEDGER_INTERVAL == 0;
 }
 
-static bool
-saveValidatedLedger(
-    Application& app,
-    std::shared_ptr<Ledger const> const& ledger,
-    bool current)
+// The node store key of the changes a ledger made
+static uint256
+stateDeltaKey(uint256 const& ledgerHash)
 {
-    auto j = app.journal("Ledger");
-    auto seq = ledger->info().seq;
-    if (!app.pendingSaves().startWork(seq))
+    return sha512Half(HashPrefix::stateDelta, ledgerHash);
+}
+
+static void
+saveStateDelta(Application& app, Ledger const& ledger, StateDelta const& delta)
+{
+    Serializer s(4 + delta.size() * (uint256::bytes + 1));
+    s.add32(HashPrefix::stateDelta);
+    for (auto const& [key, change] : delta)
     {
-        // The save was completed synchronously
-        JLOG(j.debug()) << "Save aborted";
-        return true;
+        s.addBitString(key);
+        s.add8(static_cast<std::uint8_t>(change));
     }
+    app.getNodeStore().store(
+        hotUNKNOWN,
+        std::move(s.modData()),
+        stateDeltaKey(ledger.info().hash),
+        ledger.info().seq);
+}
 
-    // TODO(tom): Fix this hard-coded SQL!
-    JLOG(j.trace()) << "saveValidatedLedger " << (current ? "" : "fromAcquire ")
-                    << seq;
-    static boost::format deleteLedger(
-        "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1(
-        "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2(
-        "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans(
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
+static std::shared_ptr<StateDelta const>
+loadStateDelta(Application& app, Ledger const& ledger)
+{
+    auto const object = app.getNodeStore().fetchNodeObject(
+        stateDeltaKey(ledger.info().hash), ledger.info().seq);
+    if (!object)
+        return nullptr;
 
-    if (!ledger->info().accountHash.isNonZero())
-    {
-        JLOG(j.fatal()) << "AH is zero: " << getJson(*ledger);
-        assert(false);
-    }
+    auto const& data = object->getData();
+    constexpr std::size_t entrySize = uint256::bytes + 1;
+    if (data.size() < 4 || (data.size() - 4) % entrySize != 0)
+        return nullptr;
+
+    SerialIter sit(data);
+    if (safe_cast<HashPrefix>(sit.get32()) != HashPrefix::stateDelta)
+        return nullptr;
 
-    if (ledger->info().accountHash != ledger->stateMap().getHash().as_uint256())
+    auto delta = std::make_shared<StateDelta>();
+    delta->reserve((data.size() - 4) / entrySize);
+    while (!sit.empty())
     {
-        JLOG(j.fatal()) << "sAL: " << ledger->info().accountHash
-                        << " != " << ledger->stateMap().getHash();
-        JLOG(j.fatal()) << "saveAcceptedLedger: seq=" << seq
-                        << ", current=" << current;
-        assert(false);
+        auto const key = sit.get256();
+        auto const change = sit.get8();
+        if (change > static_cast<std::uint8_t>(StateChange::deleted))
+            return nullptr;
+        delta->emplace_back(key, static_cast<StateChange>(change));
     }
+    return delta;
+}
 
-    assert(ledger->info().txHash == ledger->txMap().getHash().as_uint256());
+std::shared_ptr<StateDelta const>
+getStateDelta(Application& app, std::shared_ptr<Ledger const> const& ledger)
+{
+    if (auto delta = ledger->stateDelta())
+        return delta;
 
-    // Save the ledger header in the hashed object store
+    if (auto delta = loadStateDelta(app, *ledger))
     {
-        Serializer s(128);
-        s.add32(HashPrefix::ledgerMaster);
-        addRaw(ledger->info(), s);
-        app.getNodeStore().store(
-            hotLEDGER, std::move(s.modData()), ledger->info().hash, seq);
+        ledger->setStateDelta(delta);
+        return delta;
     }
 
-    AcceptedLedger::pointer aLedger;
+    auto const parent =
+        app.getLedgerMaster().getLedgerByHash(ledger->info().parentHash);
+    if (!parent)
+        return nullptr;
+
+    // Comparing the state maps costs time in proportion to the changes, but
+    // the parent and all the nodes which differ must be available.
+    constexpr int maxChanges = 1000000;
+    SHAMap::Delta differences;
     try
     {
-        aLedger = app.getAcceptedLedgerCache().fetch(ledger->info().hash);
-        if (!aLedger)
-        {
-            aLedger = std::make_shared<AcceptedLedger>(
-                ledger, app.accountIDCache(), app.logs());
-            app.getAcceptedLedgerCache().canonicalize_replace_client(
-                ledger->info().hash, aLedger);
-        }
+        if (!ledger->stateMap().compare(
+                parent->stateMap(), differences, maxChanges))
+            return nullptr;
     }
-    catch (std::exception const&)
+    catch (SHAMapMissingNode const& e)
     {
-        JLOG(j.warn()) << "An accepted ledger was missing nodes";
-        app.getLedgerMaster().failedSave(seq, ledger->info().hash);
-        // Clients can now trust the database for information about this
-        // ledger sequence.
-        app.pendingSaves().finishWork(seq);
-        return false;
+        JLOG(app.journal("Ledger").info())
+            << "Changes of ledger " << ledger->info().seq
+            << " unknown: " << e.what();
+        return nullptr;
     }
 
+    auto delta = std::make_shared<StateDelta>();
+    delta->reserve(differences.size());
+    for (auto const& [key, items] : differences)
     {
-        auto db = app.getLedgerDB().checkoutDb();
-        *db << boost::str(deleteLedger % seq);
+        if (!items.second)
+            delta->emplace_back(key, StateChange::created);
+        else if (!items.first)
+            delta->emplace_back(key, StateChange::deleted);
+        else
+            delta->emplace_back(key, StateChange::modified);
     }
 
+    saveStateDelta(app, *ledger, *delta);
+    ledger->setStateDelta(delta);
+    return delta;
+}
+
+// Save validated ledgers, writing all of them in one transaction on each
+// database so that a batch costs one commit rather than one per ledger.
+static bool
+saveValidatedLedgers(
+    Application& app,
+    std::vector<std::shared_ptr<Ledger const>> const& ledgers,
+    bool current)
+{
+    auto j = app.journal("Ledger");
+    bool result = true;
+
+    std::vector<AcceptedLedger::pointer> accepted;
+    accepted.reserve(ledgers.size());
+
+    for (auto const& ledger : ledgers)
     {
-        auto db = app.getTxnDB().checkoutDb();
+        auto seq = ledger->info().seq;
+        if (!app.pendingSaves().startWork(seq))
+        {
+            // The save was completed synchronously
+            JLOG(j.debug()) << "Save aborted";
+            continue;
+        }
 
-        soci::transaction tr(*db);
+        JLOG(j.trace()) << "saveValidatedLedger "
+                        << (current ? "" : "fromAcquire ") << seq;
 
-        *db << boost::str(deleteTrans1 % seq);
-        *db << boost::str(deleteTrans2 % seq);
+        // A ledger we built may not have all its nodes written yet. They
+        // must be in the node store before the ledger is in the database.
+        ledger->storePendingNodes();
 
-        std::string const ledgerSeq(std::to_string(seq));
+        if (!ledger->info().accountHash.isNonZero())
+        {
+            JLOG(j.fatal()) << "AH is zero: " << getJson(*ledger);
+            assert(false);
+        }
 
-        for (auto const& [_, acceptedLedgerTx] : aLedger->getMap())
+        if (ledger->info().accountHash !=
+            ledger->stateMap().getHash().as_uint256())
         {
-            (void)_;
-            uint256 transactionID = acceptedLedgerTx->getTransactionID();
+            JLOG(j.fatal()) << "sAL: " << ledger->info().accountHash
+                            << " != " << ledger->stateMap().getHash();
+            JLOG(j.fatal()) << "saveAcceptedLedger: seq=" << seq
+                            << ", current=" << current;
+            assert(false);
+        }
 
-            std::string const txnId(to_string(transactionID));
-            std::string const txnSeq(
-                std::to_string(acceptedLedgerTx->getTxnSeq()));
+        assert(
+            ledger->info().txHash == ledger->txMap().getHash().as_uint256());
 
-            *db << boost::str(deleteAcctTrans % transactionID);
+        // Save the ledger header in the hashed object store
+        {
+            Serializer s(128);
+            s.add32(HashPrefix::ledgerMaster);
+            addRaw(ledger->info(), s);
+            app.getNodeStore().store(
+                hotLEDGER, std::move(s.modData()), ledger->info().hash, seq);
+        }
 
-            auto const& accts = acceptedLedgerTx->getAffected();
+        // And the changes it made, so they can be served later
+        if (auto const delta = ledger->stateDelta())
+            saveStateDelta(app, *ledger, *delta);
 
-            if (!accts.empty())
+        AcceptedLedger::pointer aLedger;
+        try
+        {
+            aLedger = app.getAcceptedLedgerCache().fetch(ledger->info().hash);
+            if (!aLedger)
             {
-                std::string sql(
-                    "INSERT INTO AccountTransactions "
-                    "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+                aLedger = std::make_shared<AcceptedLedger>(
+                    ledger, app.accountIDCache(), app.logs());
+                app.getAcceptedLedgerCache().canonicalize_replace_client(
+                    ledger->info().hash, aLedger);
+            }
+        }
+        catch (std::exception const&)
+        {
+            JLOG(j.warn()) << "An accepted ledger was missing nodes";
+            app.getLedgerMaster().failedSave(seq, ledger->info().hash);
+            // Clients can now trust the database for information about this
+            // ledger sequence.
+            app.pendingSaves().finishWork(seq);
+            result = false;
+            continue;
+        }
 
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve(sql.length() + (accts.size() * 128));
+        accepted.push_back(std::move(aLedger));
+    }
 
-                bool first = true;
-                for (auto const& account : accts)
-                {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += app.accountIDCache().toBase58(account);
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
-                }
-                sql += ";";
-                JLOG(j.trace()) << "ActTx: " << sql;
-                *db << sql;
-            }
-            else
-            {
-                JLOG(j.warn()) << "Transaction in ledger " << seq
-                               << " affects no accounts";
-                JLOG(j.warn())
-                    << acceptedLedgerTx->getTxn()->getJson(JsonOptions::none);
-            }
+    if (accepted.empty())
+        return result;
 
-            *db
-                << (STTx::getMetaSQLInsertReplaceHeader() +
-                    acceptedLedgerTx->getTxn()->getMetaSQL(
-                        seq, acceptedLedgerTx->getEscMeta()) +
-                    ";");
+    app.getRelationalDBInterface().saveTransactions(accepted, current);
 
-            app.getMasterTransaction().inLedger(transactionID, seq);
+    if (auto const txIndex = app.getTxIndex())
+    {
+        std::vector<std::pair<uint256, std::uint32_t>> txns;
+        for (auto const& aLedger : accepted)
+        {
+            txns.clear();
+            for (auto const& [_, acceptedLedgerTx] : aLedger->getMap())
+            {
+                (void)_;
+                txns.emplace_back(
+                    acceptedLedgerTx->getTransactionID(),
+                    acceptedLedgerTx->getTxnSeq());
+            }
+            txIndex->insert(aLedger->getLedger()->info().seq, txns);
         }
+    }
 
-        tr.commit();
+    for (auto const& aLedger : accepted)
+    {
+        for (auto const& [_, acceptedLedgerTx] : aLedger->getMap())
+        {
+            (void)_;
+            app.getMasterTransaction().inLedger(
+                acceptedLedgerTx->getTransactionID(),
+                aLedger->getLedger()->info().seq);
+        }
     }
 
     {
-        static std::string addLedger(
+        // TODO(tom): Fix this hard-coded SQL!
+        static std::string const deleteLedger(
+            "DELETE FROM Ledgers WHERE LedgerSeq = :ledgerSeq;");
+        static std::string const addLedger(
             R"sql(INSERT OR REPLACE INTO Ledgers
                 (LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,
                 CloseTimeRes,CloseFlags,AccountSetHash,TransSetHash)
@@ -1034,31 +1253,59 @@ saveValidatedLedger(
 
         soci::transaction tr(*db);
 
-        auto const hash = to_string(ledger->info().hash);
-        auto const parentHash = to_string(ledger->info().parentHash);
-        auto const drops = to_string(ledger->info().drops);
-        auto const closeTime =
-            ledger->info().closeTime.time_since_epoch().count();
-        auto const parentCloseTime =
-            ledger->info().parentCloseTime.time_since_epoch().count();
-        auto const closeTimeResolution =
-            ledger->info().closeTimeResolution.count();
-        auto const closeFlags = ledger->info().closeFlags;
-        auto const accountHash = to_string(ledger->info().accountHash);
-        auto const txHash = to_string(ledger->info().txHash);
-
-        *db << addLedger, soci::use(hash), soci::use(seq),
-            soci::use(parentHash), soci::use(drops), soci::use(closeTime),
-            soci::use(parentCloseTime), soci::use(closeTimeResolution),
-            soci::use(closeFlags), soci::use(accountHash), soci::use(txHash);
+        for (auto const& aLedger : accepted)
+        {
+            auto const& info = aLedger->getLedger()->info();
+            auto const hash = to_string(info.hash);
+            auto const seq = info.seq;
+            auto const parentHash = to_string(info.parentHash);
+            auto const drops = to_string(info.drops);
+            auto const closeTime = info.closeTime.time_since_epoch().count();
+            auto const parentCloseTime =
+                info.parentCloseTime.time_since_epoch().count();
+            auto const closeTimeResolution = info.closeTimeResolution.count();
+            auto const closeFlags = info.closeFlags;
+            auto const accountHash = to_string(info.accountHash);
+            auto const txHash = to_string(info.txHash);
+
+            *db << deleteLedger, soci::use(seq);
+            *db << addLedger, soci::use(hash), soci::use(seq),
+                soci::use(parentHash), soci::use(drops), soci::use(closeTime),
+                soci::use(parentCloseTime), soci::use(closeTimeResolution),
+                soci::use(closeFlags), soci::use(accountHash),
+                soci::use(txHash);
+        }
 
         tr.commit();
     }
 
     // Clients can now trust the database for
-    // information about this ledger sequence.
-    app.pendingSaves().finishWork(seq);
-    return true;
+    // information about these ledger sequences.
+    for (auto const& aLedger : accepted)
+        app.pendingSaves().finishWork(aLedger->getLedger()->info().seq);
+    return result;
+}
+
+static bool
+saveValidatedLedger(
+    Application& app,
+    std::shared_ptr<Ledger const> const& ledger,
+    bool current)
+{
+    return saveValidatedLedgers(app, {ledger}, current);
+}
+
+// Save the ledgers queued to be written in batches, until none are left
+static void
+saveQueuedLedgers(Application& app)
+{
+    for (;;)
+    {
+        auto const batch = app.pendingSaves().dequeue();
+        if (batch.empty())
+            return;
+        saveValidatedLedgers(app, batch, false);
+    }
 }
 
 /** Save, or arrange to save, a fully-validated ledger
@@ -1096,6 +1343,29 @@ pendSaveValidated(
         return true;
     }
 
+    // Ledgers acquired to fill in history tend to arrive many at a time,
+    // so they are written in batches. When the queue is full the save is
+    // done right here, which slows down whoever is producing them.
+    if (!isSynchronous && !isCurrent)
+    {
+        switch (app.pendingSaves().enqueue(ledger))
+        {
+            case PendingSaves::Queued::added:
+                return true;
+            case PendingSaves::Queued::start:
+                if (!app.getJobQueue().addJob(
+                        jtPUBOLDLEDGER, "Ledger::pendOldSave", [&app](Job&) {
+                            saveQueuedLedgers(app);
+                        }))
+                {
+                    saveQueuedLedgers(app);
+                }
+                return true;
+            case PendingSaves::Queued::full:
+                return saveValidatedLedger(app, ledger, isCurrent);
+        }
+    }
+
     JobType const jobType{isCurrent ? jtPUBLEDGER : jtPUBOLDLEDGER};
     char const* const jobName{
         isCurrent ? "Ledger::pendSave" : "Ledger::pendOldSave"};
@@ -1121,6 +1391,23 @@ Ledger::unshare() const
     txMap_->unshare();
 }
 
+void
+Ledger::setPendingNodes(SHAMap::PendingNodes&& pending)
+{
+    std::lock_guard lock(pendingMutex_);
+    pendingNodes_ = std::move(pending);
+}
+
+void
+Ledger::storePendingNodes() const
+{
+    std::lock_guard lock(pendingMutex_);
+    if (pendingNodes_.empty())
+        return;
+    stateMap_->storePending(std::move(pendingNodes_));
+    pendingNodes_.clear();
+}
+
 void
 Ledger::invariants() const
 {
@@ -1144,7 +1431,7 @@ loadLedgerHelper(std::string const& sqlSuffix, Application& app, bool acquire)
     uint256 ledgerHash{};
     std::uint32_t ledgerSeq{0};
 
-    auto db = app.getLedgerDB().checkoutDb();
+    auto db = app.getLedgerDB().checkoutReadDb();
 
     boost::optional<std::string> sLedgerHash, sPrevHash, sAccountHash,
         sTransHash;
@@ -1275,7 +1562,7 @@ getHashByIndex(std::uint32_t ledgerIndex, Application& app)
 
     std::string hash;
     {
-        auto db = app.getLedgerDB().checkoutDb();
+        auto db = app.getLedgerDB().checkoutReadDb();
 
         boost::optional<std::string> lh;
         *db << sql, soci::into(lh);
@@ -1299,7 +1586,7 @@ getHashesByIndex(
     uint256& parentHash,
     Application& app)
 {
-    auto db = app.getLedgerDB().checkoutDb();
+    auto db = app.getLedgerDB().checkoutReadDb();
 
     boost::optional<std::string> lhO, phO;
 
@@ -1329,7 +1616,7 @@ getHashesByIndex(std::uint32_t minSeq, std::uint32_t maxSeq, Application& app)
     sql.append(std::to_string(maxSeq));
     sql.append(";");
 
-    auto db = app.getLedgerDB().checkoutDb();
+    auto db = app.getLedgerDB().checkoutReadDb();
 
     std::uint64_t ls;
     std::string lh;
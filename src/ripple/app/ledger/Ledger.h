@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_LEDGER_H_INCLUDED
 
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/core/TimeKeeper.h>
 #include <ripple/ledger/CachedView.h>
@@ -33,6 +34,7 @@
 #include <ripple/shamap/SHAMap.h>
 #include <boost/optional.hpp>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -48,6 +50,12 @@ struct create_genesis_t
 };
 extern create_genesis_t const create_genesis;
 
+/** How a ledger changed an entry in the state map of its parent. */
+enum class StateChange : std::uint8_t { created, modified, deleted };
+
+/** The entries of the state map a ledger changed, sorted by key. */
+using StateDelta = std::vector<std::pair<uint256, StateChange>>;
+
 /** Holds a ledger.
 
     The ledger is composed of two SHAMaps. The state map holds all of the
@@ -214,6 +222,9 @@ public:
     void
     rawReplace(std::shared_ptr<SLE> const& sle) override;
 
+    void
+    rawApply(std::vector<RawChange> const& changes) override;
+
     void
     rawDestroyXRP(XRPAmount const& fee) override
     {
@@ -254,6 +265,17 @@ public:
         return mImmutable;
     }
 
+    /** The entries of the state map this ledger changed, if known.
+
+        They are known for a ledger built here from its parent, and for
+        others once getStateDelta has found them.
+    */
+    std::shared_ptr<StateDelta const>
+    stateDelta() const;
+
+    void
+    setStateDelta(std::shared_ptr<StateDelta const> delta) const;
+
     /*  Mark this ledger as "should be full".
 
         "Full" is metadata property of the ledger, it indicates
@@ -279,6 +301,14 @@ public:
         info_.drops = totDrops;
     }
 
+    /** Replace the header of a ledger being built from another server's
+        report of it. The hashes are recalculated by setImmutable. */
+    void
+    setLedgerInfo(LedgerInfo const& info)
+    {
+        info_ = info;
+    }
+
     SHAMap const&
     stateMap() const
     {
@@ -312,8 +342,14 @@ public:
     void
     updateSkipList();
 
+    /** Check that every node of the ledger is available.
+
+        @param parallel Walk the state map on several threads, skipping
+            subtrees already known to be complete.
+        @return `true` if no node is missing.
+    */
     bool
-    walkLedger(beast::Journal j) const;
+    walkLedger(beast::Journal j, bool parallel = false) const;
 
     bool
     assertSensible(beast::Journal ledgerJ) const;
@@ -323,6 +359,17 @@ public:
     void
     unshare() const;
 
+    /** Hold nodes hashed by SHAMap::flushDirty until storePendingNodes. */
+    void
+    setPendingNodes(SHAMap::PendingNodes&& pending);
+
+    /** Write the held nodes to the nodestore, if that is not done yet.
+
+        Returns once they are written, by this call or by another thread.
+    */
+    void
+    storePendingNodes() const;
+
     /**
      * get Negative UNL validators' master public keys
      *
@@ -373,6 +420,9 @@ private:
     std::shared_ptr<SLE>
     peek(Keylet const& k) const;
 
+    void
+    recordChange(uint256 const& key, StateChange change);
+
     bool mImmutable;
 
     std::shared_ptr<SHAMap> txMap_;
@@ -384,6 +434,22 @@ private:
     Fees fees_;
     Rules rules_;
     LedgerInfo info_;
+
+    // The entries changed while a ledger built from its parent is mutable
+    std::unique_ptr<hash_map<uint256, StateChange>> changes_;
+
+    std::mutex mutable deltaMutex_;
+    std::shared_ptr<StateDelta const> mutable delta_;
+
+    // Where the last call to succ ended, to start the next one from. Only
+    // kept once the ledger is immutable.
+    std::mutex mutable succMutex_;
+    boost::optional<SHAMap::const_iterator> mutable succHint_;
+
+    // The nodes of a newly built ledger which are yet to be written. The
+    // mutex is held while they are written.
+    std::mutex mutable pendingMutex_;
+    SHAMap::PendingNodes mutable pendingNodes_;
 };
 
 /** A ledger wrapped in a CachedView. */
@@ -432,6 +498,17 @@ getHashesByIndex(
 extern std::map<std::uint32_t, std::pair<uint256, uint256>>
 getHashesByIndex(std::uint32_t minSeq, std::uint32_t maxSeq, Application& app);
 
+/** Return the entries of the state map a ledger changed.
+
+    They are kept with a ledger built here, saved in the node store when
+    the ledger is saved, and otherwise found by comparing the state map
+    with that of the parent ledger, if it is available.
+
+    @return The changes, or nullptr if they could not be found.
+*/
+std::shared_ptr<StateDelta const>
+getStateDelta(Application& app, std::shared_ptr<Ledger const> const& ledger);
+
 /** Deserialize a SHAMapItem containing a single STTx
 
     Throw:
@@ -25,6 +25,7 @@
 #include <ripple/beast/utility/PropertyStream.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/json/json_value.h>
+#include <ripple/ledger/ReadView.h>
 #include <memory>
 
 namespace ripple {
@@ -52,6 +53,25 @@ public:
     */
     virtual void
     doClean(Json::Value const& parameters) = 0;
+
+    /** Start checking the nodes of a ledger whose hash is already known.
+
+        doClean finds the hashes of the ledgers it checks from the
+        validated ledger. This needs none, so it also works on a server
+        which hasn't synced with the network, such as one just started
+        from a saved ledger.
+
+        Thread safety:
+            Safe to call from any thread at any time.
+
+        @param ledger The ledger to check.
+    */
+    virtual void
+    checkLedger(std::shared_ptr<ReadView const> const& ledger) = 0;
+
+    /** Return `true` if the cleaner has no range left to clean. */
+    virtual bool
+    isIdle() const = 0;
 };
 
 std::unique_ptr<LedgerCleaner>
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+#include <array>
+#include <deque>
+#include <memory>
+
+namespace ripple {
+
+/** The hashes of validated ledgers, indexed by sequence.
+
+    The hashes are kept in arrays of chunkSize consecutive sequences, so
+    finding one takes a couple of memory reads and each costs little more
+    than its 32 bytes. Only the newest maxChunks chunks are kept. Older
+    hashes are dropped, to be found the slower way through the ledgers and
+    the ledger database.
+
+    This class is not thread safe.
+*/
+class LedgerHashIndex
+{
+public:
+    static constexpr LedgerIndex chunkSize = 65536;
+
+    explicit LedgerHashIndex(std::size_t maxChunks);
+
+    /** Record the hash of a ledger, replacing any hash already held. */
+    void
+    insert(LedgerIndex seq, uint256 const& hash);
+
+    /** Return the hash of a ledger, if it is held. */
+    boost::optional<uint256>
+    get(LedgerIndex seq) const;
+
+    /** The number of hashes held. */
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+private:
+    struct Chunk
+    {
+        std::array<uint256, chunkSize> hashes;
+        LedgerIndex count = 0;
+    };
+
+    std::size_t const maxChunks_;
+
+    // The chunk for sequence s is chunks_[s / chunkSize - firstChunk_]. A
+    // chunk holding no hashes may be null.
+    std::deque<std::unique_ptr<Chunk>> chunks_;
+    LedgerIndex firstChunk_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
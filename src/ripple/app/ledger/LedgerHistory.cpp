@@ -34,6 +34,45 @@ namespace ripple {
 
 std::chrono::seconds constexpr CachedLedgerAge = std::chrono::minutes{2};
 
+// Recent validated ledgers are kept as long as the state nodes they do not
+// share add up to no more than recentNodesBudget, but there are always at
+// least recentLedgersMin and never more than recentLedgersMax of them.
+std::size_t constexpr recentLedgersMin = 16;
+std::size_t constexpr recentLedgersMax = 256;
+std::size_t constexpr recentNodesBudget = 256 * 1024;
+
+// One validated ledger in every checkpointInterval is kept until there are
+// checkpointCount newer ones.
+LedgerIndex constexpr checkpointInterval = 256;
+std::size_t constexpr checkpointCount = 16;
+
+// The hashes of over eight million validated ledgers, about a year's worth,
+// are kept in memory.
+std::size_t constexpr ledgerHashChunks = 128;
+
+namespace {
+
+// The state nodes of a ledger which its parent does not have, counting no
+// further than `limit`
+std::size_t
+uniqueNodes(Ledger const& ledger, Ledger const& parent, std::size_t limit)
+{
+    std::size_t count = 0;
+    try
+    {
+        ledger.stateMap().visitDifferences(
+            &parent.stateMap(),
+            [&count, limit](SHAMapTreeNode const&) { return ++count < limit; });
+    }
+    catch (SHAMapMissingNode const&)
+    {
+        return limit;
+    }
+    return count;
+}
+
+}  // namespace
+
 // FIXME: Need to clean up ledgers by index at some point
 
 LedgerHistory::LedgerHistory(
@@ -54,6 +93,7 @@ LedgerHistory::LedgerHistory(
           std::chrono::minutes{5},
           stopwatch(),
           app_.journal("TaggedCache"))
+    , mLedgersByIndex(ledgerHashChunks)
     , j_(app.journal("LedgerHistory"))
 {
 }
@@ -71,21 +111,74 @@ LedgerHistory::insert(std::shared_ptr<Ledger const> ledger, bool validated)
     const bool alreadyHad = m_ledgers_by_hash.canonicalize_replace_cache(
         ledger->info().hash, ledger);
     if (validated)
-        mLedgersByIndex[ledger->info().seq] = ledger->info().hash;
+        mLedgersByIndex.insert(ledger->info().seq, ledger->info().hash);
+    sl.unlock();
+
+    if (validated)
+        retain(ledger);
 
     return alreadyHad;
 }
 
+void
+LedgerHistory::retain(std::shared_ptr<Ledger const> const& ledger)
+{
+    std::shared_ptr<Ledger const> parent;
+    {
+        std::unique_lock sl(m_ledgers_by_hash.peekMutex());
+        if (!recentLedgers_.empty() &&
+            recentLedgers_.back().first->info().hash ==
+                ledger->info().parentHash)
+            parent = recentLedgers_.back().first;
+    }
+
+    // Without the parent there is nothing to compare with. Such a ledger
+    // follows a gap, and what it holds is held by the ledgers after it.
+    auto const nodes = parent
+        ? uniqueNodes(*ledger, *parent, recentNodesBudget)
+        : std::size_t{0};
+
+    std::unique_lock sl(m_ledgers_by_hash.peekMutex());
+    auto const seq = ledger->info().seq;
+    if (!recentLedgers_.empty() &&
+        recentLedgers_.back().first->info().seq >= seq)
+        return;
+
+    recentLedgers_.emplace_back(ledger, nodes);
+    recentNodes_ += nodes;
+    while (recentLedgers_.size() > recentLedgersMax ||
+           (recentLedgers_.size() > recentLedgersMin &&
+            recentNodes_ > recentNodesBudget))
+    {
+        recentNodes_ -= recentLedgers_.front().second;
+        recentLedgers_.pop_front();
+    }
+
+    if (seq % checkpointInterval == 0)
+    {
+        checkpoints_.emplace(seq, ledger);
+        if (checkpoints_.size() > checkpointCount)
+            checkpoints_.erase(checkpoints_.begin());
+    }
+
+    JLOG(j_.debug()) << "Keeping " << recentLedgers_.size()
+                     << " recent ledgers with " << recentNodes_
+                     << " unshared nodes and " << checkpoints_.size()
+                     << " checkpoints";
+}
+
 LedgerHash
 LedgerHistory::getLedgerHash(LedgerIndex index)
 {
     std::unique_lock sl(m_ledgers_by_hash.peekMutex());
-    auto it = mLedgersByIndex.find(index);
-
-    if (it != mLedgersByIndex.end())
-        return it->second;
+    return mLedgersByIndex.get(index).value_or(uint256());
+}
 
-    return uint256();
+void
+LedgerHistory::setLedgerHash(LedgerIndex index, LedgerHash const& hash)
+{
+    std::unique_lock sl(m_ledgers_by_hash.peekMutex());
+    mLedgersByIndex.insert(index, hash);
 }
 
 std::shared_ptr<Ledger const>
@@ -93,13 +186,10 @@ LedgerHistory::getLedgerBySeq(LedgerIndex index)
 {
     {
         std::unique_lock sl(m_ledgers_by_hash.peekMutex());
-        auto it = mLedgersByIndex.find(index);
-
-        if (it != mLedgersByIndex.end())
+        if (auto const hash = mLedgersByIndex.get(index))
         {
-            uint256 hash = it->second;
             sl.unlock();
-            return getLedgerByHash(hash);
+            return getLedgerByHash(*hash);
         }
     }
 
@@ -116,7 +206,7 @@ LedgerHistory::getLedgerBySeq(LedgerIndex index)
 
         assert(ret->isImmutable());
         m_ledgers_by_hash.canonicalize_replace_client(ret->info().hash, ret);
-        mLedgersByIndex[ret->info().seq] = ret->info().hash;
+        mLedgersByIndex.insert(ret->info().seq, ret->info().hash);
         return (ret->info().seq == index) ? ret : nullptr;
     }
 }
@@ -411,7 +501,7 @@ LedgerHistory::handleMismatch(
         }
         else
         {
-            if ((*b)->peekData() != (*v)->peekData())
+            if ((*b)->slice() != (*v)->slice())
             {
                 // Same transaction with different metadata
                 log_metadata_difference(
@@ -513,11 +603,11 @@ bool
 LedgerHistory::fixIndex(LedgerIndex ledgerIndex, LedgerHash const& ledgerHash)
 {
     std::unique_lock sl(m_ledgers_by_hash.peekMutex());
-    auto it = mLedgersByIndex.find(ledgerIndex);
+    auto const hash = mLedgersByIndex.get(ledgerIndex);
 
-    if ((it != mLedgersByIndex.end()) && (it->second != ledgerHash))
+    if (hash && *hash != ledgerHash)
     {
-        it->second = ledgerHash;
+        mLedgersByIndex.insert(ledgerIndex, ledgerHash);
         return false;
     }
     return true;
@@ -533,6 +623,18 @@ LedgerHistory::tune(int size, std::chrono::seconds age)
 void
 LedgerHistory::clearLedgerCachePrior(LedgerIndex seq)
 {
+    {
+        std::unique_lock sl(m_ledgers_by_hash.peekMutex());
+        while (!recentLedgers_.empty() &&
+               recentLedgers_.front().first->info().seq < seq)
+        {
+            recentNodes_ -= recentLedgers_.front().second;
+            recentLedgers_.pop_front();
+        }
+        checkpoints_.erase(
+            checkpoints_.begin(), checkpoints_.lower_bound(seq));
+    }
+
     for (LedgerHash it : m_ledgers_by_hash.getKeys())
     {
         auto const ledger = getLedgerByHash(it);
@@ -21,16 +21,27 @@
 #define RIPPLE_APP_LEDGER_LEDGERHISTORY_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/beast/insight/Collector.h>
 #include <ripple/beast/insight/Event.h>
 #include <ripple/protocol/RippleLedgerHash.h>
+#include <deque>
+#include <map>
 
 namespace ripple {
 
 // VFALCO TODO Rename to OldLedgers ?
 
-/** Retains historical ledgers. */
+/** Retains historical ledgers.
+
+    Besides the cache, which holds any ledger for a short time, the most
+    recent validated ledgers and a checkpoint every so many ledgers are
+    kept, so that requests for recent history seldom load ledgers from
+    the database. Adjacent ledgers share most of their state nodes, so
+    the recent ledgers are limited by the nodes each does not share with
+    its parent rather than by their number.
+*/
 class LedgerHistory
 {
 public:
@@ -68,6 +79,13 @@ public:
     LedgerHash
     getLedgerHash(LedgerIndex ledgerIndex);
 
+    /** Record the hash of a validated ledger found some other way
+        @param ledgerIndex The sequence number of the ledger
+        @param ledgerHash The hash of the ledger
+    */
+    void
+    setLedgerHash(LedgerIndex ledgerIndex, LedgerHash const& ledgerHash);
+
     /** Set the history cache's parameters
         @param size The target size of the cache
         @param age The target age of the cache, in seconds
@@ -84,6 +102,13 @@ public:
         m_consensus_validated.sweep();
     }
 
+    /** Leak the cached ledgers rather than free them, when exiting */
+    void
+    abandon()
+    {
+        m_ledgers_by_hash.abandon();
+    }
+
     /** Report that we have locally built a particular ledger */
     void
     builtLedger(
@@ -109,6 +134,12 @@ public:
     clearLedgerCachePrior(LedgerIndex seq);
 
 private:
+    /** Keep a newly validated ledger, dropping the recent ledgers and
+        checkpoints that are no longer needed.
+    */
+    void
+    retain(std::shared_ptr<Ledger const> const& ledger);
+
     /** Log details in the case where we build one ledger but
         validate a different one.
         @param built The hash of the ledger we built
@@ -154,7 +185,16 @@ private:
     ConsensusValidated m_consensus_validated;
 
     // Maps ledger indexes to the corresponding hash.
-    std::map<LedgerIndex, LedgerHash> mLedgersByIndex;  // validated ledgers
+    LedgerHashIndex mLedgersByIndex;  // validated ledgers
+
+    // The most recent validated ledgers, oldest first, each with the count
+    // of its state nodes which its parent does not have
+    std::deque<std::pair<std::shared_ptr<Ledger const>, std::size_t>>
+        recentLedgers_;
+    std::size_t recentNodes_ = 0;
+
+    // Validated ledgers at regular intervals further back
+    std::map<LedgerIndex, std::shared_ptr<Ledger const>> checkpoints_;
 
     beast::Journal j_;
 };
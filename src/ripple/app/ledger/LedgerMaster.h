@@ -27,6 +27,7 @@
 #include <ripple/app/ledger/LedgerHistory.h>
 #include <ripple/app/ledger/LedgerHolder.h>
 #include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/ledger/RecoveryCheckpoint.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/basics/RangeSet.h>
@@ -211,6 +212,8 @@ public:
     tune(int size, std::chrono::seconds age);
     void
     sweep();
+    void
+    abandonCaches();
     float
     getCacheHitRate();
 
@@ -243,6 +246,15 @@ public:
     void
     doLedgerCleaner(Json::Value const& parameters);
 
+    /** Have the ledger cleaner check the nodes of a ledger in the
+        background, without needing a validated ledger. */
+    void
+    checkLedgerInBackground(std::shared_ptr<Ledger const> const& ledger);
+
+    /** Return `true` if the ledger cleaner has nothing left to check. */
+    bool
+    isLedgerCleanerIdle() const;
+
     beast::PropertyStream::Source&
     getPropertySource();
 
@@ -278,6 +290,10 @@ public:
     std::size_t
     getFetchPackCacheSize() const;
 
+    /** The progress of filling in missing history, for server_info. */
+    Json::Value
+    getHistoryFillJson();
+
     //! Whether we have ever fully validated a ledger.
     bool
     haveValidated()
@@ -289,6 +305,18 @@ public:
     boost::optional<LedgerIndex>
     minSqlSeq();
 
+    /** Read the recovery checkpoint left by the previous run.
+
+        From then on, checkpoints are recorded as history builds up, and
+        the stored one is marked as not clean until saveCleanShutdown().
+    */
+    void
+    loadRecoveryCheckpoint();
+
+    /** Record the history we have, once everything has been stopped. */
+    void
+    saveCleanShutdown();
+
 private:
     void
     setValidLedger(std::shared_ptr<Ledger const> const& l);
@@ -298,6 +326,11 @@ private:
     void
     tryFill(Job& job, std::shared_ptr<Ledger const> ledger);
 
+    // The checkpoint for the complete range holding seq, which must be
+    // no later than ledger.
+    boost::optional<RecoveryCheckpoint>
+    makeRecoveryCheckpoint(ReadView const& ledger, LedgerIndex seq);
+
     void
     getFetchPack(LedgerIndex missing, InboundLedger::Reason reason);
 
@@ -314,6 +347,10 @@ private:
         bool& progress,
         InboundLedger::Reason reason,
         std::unique_lock<std::recursive_mutex>&);
+    // Keep acquisitions of history in flight in other ranges than the one
+    // walked back from `missing`. Returns true if any ledger arrived.
+    bool
+    fillHistory(std::uint32_t missing);
     // Try to publish ledgers, acquire missing ledgers.  Always called with
     // m_mutex locked.  The passed lock is a reminder to callers.
     void
@@ -387,7 +424,8 @@ private:
     std::atomic<LedgerIndex> mValidLedgerSeq{0};
     std::atomic<LedgerIndex> mBuildingLedgerSeq{0};
 
-    // The server is in standalone mode
+    // The server is in standalone or reporting mode, so ledgers are
+    // accepted without validations
     bool const standalone_;
 
     // How many ledgers before the current ledger do we allow peers to request?
@@ -400,8 +438,36 @@ private:
 
     TaggedCache<uint256, Blob> fetch_packs_;
 
+    // The bytes put in the fetch packs being built
+    std::atomic<std::size_t> fetchPackBytes_{0};
+
     std::uint32_t fetch_seq_{0};
 
+    // How many ranges of history to acquire at once
+    std::size_t const history_ranges_;
+
+    // The write load at which only one range of history is acquired
+    std::size_t const history_write_load_;
+
+    // The ledgers acquired to start ranges of history, by sequence.
+    // Protected by m_mutex.
+    std::map<std::uint32_t, uint256> historySeeds_;
+
+    // History ledgers acquired from peers
+    std::atomic<std::uint64_t> historyAcquired_{0};
+
+    // Whether recovery checkpoints are being recorded
+    std::atomic<bool> recoveryEnabled_{false};
+
+    // The ledgers written after the previous run's last checkpoint are
+    // being checked by the ledger cleaner, so no checkpoint may cover
+    // them yet.
+    std::atomic<bool> recoveryTailPending_{false};
+
+    // The checkpoint found on startup, until tryFill reaches it.
+    // Protected by m_mutex.
+    boost::optional<RecoveryCheckpoint> recoveryStart_;
+
     // Try to keep a validator from switching from test to live network
     // without first wiping the database.
     LedgerIndex const max_ledger_difference_{1000000};
@@ -52,7 +52,9 @@ private:
     beast::Journal const j_;
     CachedSLEs& cache_;
     std::mutex mutable modify_mutex_;
-    std::mutex mutable current_mutex_;
+    // Written only while holding modify_mutex_, and always with
+    // std::atomic_store, so readers take a snapshot with std::atomic_load
+    // instead of waiting for a lock.
     std::shared_ptr<OpenView const> current_;
 
 public:
@@ -103,6 +105,9 @@ public:
 
         Thread safety:
             Can be called concurrently from any thread.
+            Does not wait for modify() or accept() to
+            finish, even while they are applying
+            transactions.
 
         Effects:
             The caller is given ownership of a
@@ -24,6 +24,7 @@
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Indexes.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -45,31 +46,44 @@ OrderBookDB::invalidate()
 void
 OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
 {
+    auto const seq = ledger->info().seq;
+    bool incremental = false;
     {
         std::lock_guard sl(mLock);
-        auto seq = ledger->info().seq;
 
-        // Do a full update every 256 ledgers
         if (mSeq != 0)
         {
             if (seq == mSeq)
                 return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
-                return;
             if ((seq < mSeq) && ((mSeq - seq) < 16))
                 return;
+            incremental = (seq == mSeq + 1);
         }
 
-        JLOG(j_.debug()) << "Advancing from " << mSeq << " to " << seq;
-
-        mSeq = seq;
+        if (!incremental)
+        {
+            JLOG(j_.debug()) << "Rebuilding from " << seq << ", was at "
+                             << mSeq;
+            mSeq = seq;
+            mRebuildSeq = seq;
+            mPending.clear();
+        }
     }
 
     if (app_.config().PATH_SEARCH_MAX == 0)
     {
         // nothing to do
     }
-    else if (app_.config().standalone())
+    else if (incremental)
+        apply(ledger);
+    else
+        rebuild(ledger);
+}
+
+void
+OrderBookDB::rebuild(std::shared_ptr<ReadView const> const& ledger)
+{
+    if (app_.config().standalone())
         update(ledger);
     else
         app_.getJobQueue().addJob(
@@ -78,6 +92,103 @@ OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
             });
 }
 
+void
+OrderBookDB::apply(std::shared_ptr<ReadView const> const& ledger)
+{
+    auto const seq = ledger->info().seq;
+    auto const get160 = [](STObject const& fields, SField const& field) {
+        // Fields with default values are left out of a created node
+        return fields.isFieldPresent(field) ? fields.getFieldH160(field)
+                                            : uint160{};
+    };
+
+    // Find the books which gained their first directory or lost their
+    // last one. A book is kept as long as any of its qualities remain.
+    std::vector<std::pair<Book, bool>> changes;
+    try
+    {
+        hash_map<uint256, Book> touched;
+        for (auto const& item : ledger->txs)
+        {
+            auto const& meta = item.second;
+            if (!meta)
+                continue;
+            for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+            {
+                SField const* field = nullptr;
+                if (node.getFName() == sfCreatedNode)
+                    field = &sfNewFields;
+                else if (node.getFName() == sfDeletedNode)
+                    field = &sfFinalFields;
+                if (!field ||
+                    node.getFieldU16(sfLedgerEntryType) != ltDIR_NODE)
+                    continue;
+
+                auto const data =
+                    dynamic_cast<STObject const*>(node.peekAtPField(*field));
+                if (!data || !data->isFieldPresent(sfExchangeRate) ||
+                    !data->isFieldPresent(sfRootIndex) ||
+                    data->getFieldH256(sfRootIndex) !=
+                        node.getFieldH256(sfLedgerIndex))
+                    continue;
+
+                Book book;
+                book.in.currency = get160(*data, sfTakerPaysCurrency);
+                book.in.account = get160(*data, sfTakerPaysIssuer);
+                book.out.account = get160(*data, sfTakerGetsIssuer);
+                book.out.currency = get160(*data, sfTakerGetsCurrency);
+                touched.emplace(getBookBase(book), book);
+            }
+        }
+
+        changes.reserve(touched.size());
+        for (auto const& [base, book] : touched)
+        {
+            auto const next = ledger->succ(base, getQualityNext(base));
+            changes.emplace_back(book, static_cast<bool>(next));
+        }
+    }
+    catch (std::exception const& e)
+    {
+        // Scanning the whole ledger takes longer, but gets there
+        JLOG(j_.info()) << "OrderBookDB::apply: " << e.what();
+        {
+            std::lock_guard sl(mLock);
+            if (mSeq != seq - 1)
+                return;
+            mSeq = seq;
+            mRebuildSeq = seq;
+            mPending.clear();
+        }
+        rebuild(ledger);
+        return;
+    }
+
+    {
+        std::lock_guard sl(mLock);
+
+        // Another ledger got here first
+        if (mSeq != seq - 1)
+            return;
+        mSeq = seq;
+
+        for (auto const& [book, exists] : changes)
+        {
+            if (exists)
+                addOrderBook(book);
+            else
+                removeOrderBook(book);
+            if (mRebuildSeq != 0)
+                mPending.emplace_back(book, exists);
+        }
+    }
+
+    JLOG(j_.debug()) << "OrderBookDB::apply " << seq << ": " << changes.size()
+                     << " books changed";
+    if (!changes.empty())
+        app_.getLedgerMaster().newOrderBookDB();
+}
+
 void
 OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
 {
@@ -94,6 +205,16 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
+    auto const fail = [this, seq = ledger->info().seq]() {
+        std::lock_guard sl(mLock);
+        if (mRebuildSeq == seq)
+        {
+            mSeq = 0;
+            mRebuildSeq = 0;
+            mPending.clear();
+        }
+    };
+
     // walk through the entire ledger looking for orderbook entries
     int books = 0;
 
@@ -105,8 +226,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
             {
                 JLOG(j_.info())
                     << "OrderBookDB::update exiting due to isStopping";
-                std::lock_guard sl(mLock);
-                mSeq = 0;
+                fail();
                 return;
             }
 
@@ -136,8 +256,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     catch (SHAMapMissingNode const& mn)
     {
         JLOG(j_.info()) << "OrderBookDB::update: " << mn.what();
-        std::lock_guard sl(mLock);
-        mSeq = 0;
+        fail();
         return;
     }
 
@@ -145,9 +264,24 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         std::lock_guard sl(mLock);
 
+        // A later rebuild, or a failure, makes this one useless
+        if (mRebuildSeq != ledger->info().seq)
+            return;
+
         mXRPBooks.swap(XRPBooks);
         mSourceMap.swap(sourceMap);
         mDestMap.swap(destMap);
+
+        // Catch up with the ledgers applied while the rebuild ran
+        for (auto const& [book, exists] : mPending)
+        {
+            if (exists)
+                addOrderBook(book);
+            else
+                removeOrderBook(book);
+        }
+        mPending.clear();
+        mRebuildSeq = 0;
     }
     app_.getLedgerMaster().newOrderBookDB();
 }
@@ -188,6 +322,34 @@ OrderBookDB::addOrderBook(Book const& book)
         mXRPBooks.insert(book.in);
 }
 
+void
+OrderBookDB::removeOrderBook(Book const& book)
+{
+    std::lock_guard sl(mLock);
+    auto const index = getBookBase(book);
+    auto const erase = [&index](IssueToOrderBook& map, Issue const& issue) {
+        auto it = map.find(issue);
+        if (it == map.end())
+            return;
+        auto& list = it->second;
+        list.erase(
+            std::remove_if(
+                list.begin(),
+                list.end(),
+                [&index](auto const& ob) {
+                    return ob->getBookBase() == index;
+                }),
+            list.end());
+        if (list.empty())
+            map.erase(it);
+    };
+
+    erase(mSourceMap, book.in);
+    erase(mDestMap, book.out);
+    if (isXRP(book.out))
+        mXRPBooks.erase(book.in);
+}
+
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List
 OrderBookDB::getBooksByTakerPays(Issue const& issue)
@@ -242,23 +404,19 @@ OrderBookDB::getBookListeners(Book const& book)
     return ret;
 }
 
-// Based on the meta, send the meta to the streams that are listening.
+// Based on the meta, find the streams that are listening. The caller
+// sends the meta to them, in order with its other messages.
 // We need to determine which streams a given meta effects.
-void
-OrderBookDB::processTxn(
-    std::shared_ptr<ReadView const> const& ledger,
-    const AcceptedLedgerTx& alTx,
-    Json::Value const& jvObj)
+std::vector<InfoSub::pointer>
+OrderBookDB::getBookSubscribers(AcceptedLedgerTx const& alTx)
 {
+    std::vector<InfoSub::pointer> listeners;
     std::lock_guard sl(mLock);
     if (alTx.getResult() == tesSUCCESS)
     {
-        // For this particular transaction, maintain the set of unique
-        // subscriptions that have already published it.  This prevents sending
-        // the transaction multiple times if it touches multiple ltOFFER
-        // entries for the same book, or if it touches multiple books and a
-        // single client has subscribed to those books.
-        hash_set<std::uint64_t> havePublished;
+        // Each book is looked up once, however many of its offers the
+        // transaction touches.
+        hash_set<Book> books;
 
         // Check if this is an offer or an offer cancel or a payment that
         // consumes an offer.
@@ -289,15 +447,9 @@ OrderBookDB::processTxn(
                             data->isFieldPresent(sfTakerGets))
                         {
                             // determine the OrderBook
-                            Book b{
+                            books.insert(Book{
                                 data->getFieldAmount(sfTakerGets).issue(),
-                                data->getFieldAmount(sfTakerPays).issue()};
-
-                            auto listeners = getBookListeners(b);
-                            if (listeners)
-                            {
-                                listeners->publish(jvObj, havePublished);
-                            }
+                                data->getFieldAmount(sfTakerPays).issue()});
                         }
                     }
                 }
@@ -305,10 +457,25 @@ OrderBookDB::processTxn(
             catch (std::exception const&)
             {
                 JLOG(j_.info())
-                    << "Fields not found in OrderBookDB::processTxn";
+                    << "Fields not found in OrderBookDB::getBookSubscribers";
             }
         }
+
+        if (books.empty())
+            return listeners;
+
+        // For this particular transaction, maintain the set of unique
+        // subscriptions that have already published it.  This prevents sending
+        // the transaction multiple times if it touches multiple books and a
+        // single client has subscribed to those books.
+        hash_set<std::uint64_t> havePublished;
+        for (auto const& book : books)
+        {
+            if (auto bookListeners = getBookListeners(book))
+                bookListeners->getListeners(havePublished, listeners);
+        }
     }
+    return listeners;
 }
 
 }  // namespace ripple
@@ -25,6 +25,8 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/OrderBook.h>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -33,11 +35,15 @@ class OrderBookDB : public Stoppable
 public:
     OrderBookDB(Application& app, Stoppable& parent);
 
+    /** Bring the books up to date with a newly published ledger.
+
+        If the books reflect the ledger's parent, the order book
+        directories created and deleted by its transactions are applied.
+        Otherwise the books are rebuilt from the whole ledger.
+    */
     void
     setup(std::shared_ptr<ReadView const> const& ledger);
     void
-    update(std::shared_ptr<ReadView const> const& ledger);
-    void
     invalidate();
 
     void
@@ -61,18 +67,27 @@ public:
     BookListeners::pointer
     makeBookListeners(Book const&);
 
-    // see if this txn effects any orderbook
-    void
-    processTxn(
-        std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+    // The subscribers of the order books a txn effects, each once
+    std::vector<InfoSub::pointer>
+    getBookSubscribers(AcceptedLedgerTx const& alTx);
 
     using IssueToOrderBook = hash_map<Issue, OrderBook::List>;
 
 private:
+    // Apply the books created and removed by a ledger's transactions
+    void
+    apply(std::shared_ptr<ReadView const> const& ledger);
+
+    // Run update, on the job queue unless standalone
     void
-    rawAddBook(Book const&);
+    rebuild(std::shared_ptr<ReadView const> const& ledger);
+
+    // Rebuild the books from every entry in a ledger
+    void
+    update(std::shared_ptr<ReadView const> const& ledger);
+
+    void
+    removeOrderBook(Book const&);
 
     Application& app_;
 
@@ -91,8 +106,14 @@ private:
 
     BookToListenersMap mListeners;
 
+    // The ledger the books reflect, or will once a rebuild finishes
     std::uint32_t mSeq;
 
+    // The ledger being rebuilt from, and the books added (true) or
+    // removed (false) by the ledgers applied since
+    std::uint32_t mRebuildSeq = 0;
+    std::vector<std::pair<Book, bool>> mPending;
+
     beast::Journal const j_;
 };
 
@@ -21,12 +21,19 @@
 #define RIPPLE_APP_PENDINGSAVES_H_INCLUDED
 
 #include <ripple/protocol/Protocol.h>
+#include <algorithm>
 #include <condition_variable>
+#include <deque>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
+class Ledger;
+
 /** Keeps track of which ledgers haven't been fully saved.
 
     During the ledger building process this collection will keep
@@ -39,8 +46,66 @@ private:
     std::mutex mutable mutex_;
     std::map<LedgerIndex, bool> map_;
     std::condition_variable await_;
+    std::deque<std::shared_ptr<Ledger const>> queue_;
+    bool draining_ = false;
 
 public:
+    /** The most ledgers which may wait to be written in a batch. */
+    static constexpr std::size_t maxQueued = 256;
+
+    /** The most ledgers written in one database transaction. */
+    static constexpr std::size_t maxBatch = 32;
+
+    enum class Queued {
+        /** The queue is full, so the ledger was not added. */
+        full,
+        /** The ledger was added, and the queue is being drained. */
+        added,
+        /** The ledger was added, and the caller must drain the queue. */
+        start
+    };
+
+    /** Queue a ledger to be written along with others
+
+        The ledger must already have been dispatched by shouldWork.
+    */
+    Queued
+    enqueue(std::shared_ptr<Ledger const> ledger)
+    {
+        std::lock_guard lock(mutex_);
+
+        if (queue_.size() >= maxQueued)
+            return Queued::full;
+
+        queue_.push_back(std::move(ledger));
+        if (draining_)
+            return Queued::added;
+        draining_ = true;
+        return Queued::start;
+    }
+
+    /** Take the next batch of queued ledgers to write
+
+        Whoever started draining the queue calls this until it returns
+        an empty batch, at which point the next ledger queued starts
+        draining again.
+    */
+    std::vector<std::shared_ptr<Ledger const>>
+    dequeue()
+    {
+        std::lock_guard lock(mutex_);
+
+        auto const end =
+            queue_.begin() + std::min<std::size_t>(queue_.size(), maxBatch);
+        std::vector<std::shared_ptr<Ledger const>> batch(
+            std::make_move_iterator(queue_.begin()),
+            std::make_move_iterator(end));
+        queue_.erase(queue_.begin(), end);
+        if (batch.empty())
+            draining_ = false;
+        return batch;
+    }
+
     /** Start working on a ledger
 
         This is called prior to updating the SQLite indexes.
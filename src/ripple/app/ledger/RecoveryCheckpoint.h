@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_RECOVERYCHECKPOINT_H_INCLUDED
+#define RIPPLE_APP_LEDGER_RECOVERYCHECKPOINT_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+
+namespace ripple {
+
+class DatabaseCon;
+
+/** A range of history which was known to be complete.
+
+    The server records one of these in the wallet database from time to
+    time, and once more when it stops in an orderly way. On the next start,
+    the ledgers in the range are trusted once the chain of hashes from the
+    newest ledger reaches the end of the range, instead of walking the rest
+    of the ledger database. Only the ledgers after the range need checking,
+    and only if the server did not stop cleanly.
+*/
+struct RecoveryCheckpoint
+{
+    LedgerIndex minSeq = 0;
+    LedgerIndex maxSeq = 0;
+
+    // The hash of the ledger at maxSeq
+    uint256 maxHash;
+
+    // Whether the server stopped cleanly after this was recorded
+    bool clean = false;
+};
+
+/** Return the checkpoint stored in the wallet database, if any. */
+boost::optional<RecoveryCheckpoint>
+getRecoveryCheckpoint(DatabaseCon& walletDB);
+
+/** Replace the checkpoint stored in the wallet database. */
+void
+setRecoveryCheckpoint(DatabaseCon& walletDB, RecoveryCheckpoint const& cp);
+
+}  // namespace ripple
+
+#endif
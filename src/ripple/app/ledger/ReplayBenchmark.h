@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_REPLAYBENCHMARK_H_INCLUDED
+#define RIPPLE_APP_LEDGER_REPLAYBENCHMARK_H_INCLUDED
+
+#include <ripple/protocol/Protocol.h>
+#include <boost/optional.hpp>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace ripple {
+
+class Application;
+
+/** Parse a range of ledgers given as "first-last".
+
+    @return The first and last ledger, or nothing if the range is
+            malformed or empty.
+*/
+boost::optional<std::pair<LedgerIndex, LedgerIndex>>
+parseLedgerRange(std::string const& range);
+
+/** Replay stored ledgers and report how long they took to build.
+
+    Each ledger from first to last is built again from its parent and the
+    transactions it holds, and the hash of the result is checked against
+    the stored ledger. The report gives the time taken to build each
+    ledger, the time taken to apply each type of transaction, and how the
+    memory held by each subsystem changed over the run.
+
+    @param app The application holding the ledgers
+    @param first The first ledger to replay. Its parent must be stored.
+    @param last The last ledger to replay
+    @param out Where to write the report
+    @return true if every ledger was found and built to its stored hash
+*/
+bool
+replayBenchmark(
+    Application& app,
+    LedgerIndex first,
+    LedgerIndex last,
+    std::ostream& out);
+
+}  // namespace ripple
+
+#endif
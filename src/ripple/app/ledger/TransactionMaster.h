@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_TRANSACTIONMASTER_H_INCLUDED
 
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/basics/PartitionedTaggedCache.h>
 #include <ripple/basics/RangeSet.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/shamap/SHAMapItem.h>
@@ -82,12 +83,12 @@ public:
     void
     sweep(void);
 
-    TaggedCache<uint256, Transaction>&
+    PartitionedTaggedCache<uint256, Transaction>&
     getCache();
 
 private:
     Application& mApp;
-    TaggedCache<uint256, Transaction> mCache;
+    PartitionedTaggedCache<uint256, Transaction> mCache;
 };
 
 }  // namespace ripple
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BookSnapshot.h>
+#include <ripple/basics/Log.h>
+#include <ripple/ledger/View.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/Quality.h>
+
+namespace ripple {
+
+BookSnapshot::BookSnapshot(
+    ReadView const& view,
+    Book const& book,
+    std::size_t limit,
+    beast::Journal j)
+    : frozen_(
+          isGlobalFrozen(view, book.out.account) ||
+          isGlobalFrozen(view, book.in.account))
+{
+    hash_map<AccountID, STAmount> funds;
+    auto const bookEnd = getQualityNext(getBookBase(book));
+    auto tip = getBookBase(book);
+
+    while (auto const page = view.succ(tip, bookEnd))
+    {
+        auto dir = view.read(keylet::page(*page));
+        if (!dir)
+            break;
+        tip = dir->key();
+        auto const quality = amountFromQuality(getQuality(tip));
+
+        unsigned int entry;
+        uint256 offerIndex;
+        if (!cdirFirst(view, tip, dir, entry, offerIndex, j))
+            continue;
+        do
+        {
+            auto sle = view.read(keylet::offer(offerIndex));
+            if (!sle)
+            {
+                JLOG(j.warn()) << "Missing offer";
+                continue;
+            }
+            if (offers_.size() == limit)
+            {
+                complete_ = false;
+                return;
+            }
+
+            Offer offer;
+            offer.owner = sle->getAccountID(sfAccount);
+            offer.takerGets = sle->getFieldAmount(sfTakerGets);
+            offer.takerPays = sle->getFieldAmount(sfTakerPays);
+            offer.quality = quality;
+
+            if (book.out.account == offer.owner)
+            {
+                // An offer selling the issuer's own IOUs is fully funded
+                offer.ownerFunds = offer.takerGets;
+            }
+            else if (frozen_)
+            {
+                // If either asset is globally frozen, offers that aren't the
+                // issuer's are totally unfunded
+                offer.ownerFunds.clear(book.out);
+            }
+            else
+            {
+                auto [it, inserted] = funds.emplace(offer.owner, STAmount{});
+                if (inserted)
+                {
+                    it->second = accountHolds(
+                        view,
+                        offer.owner,
+                        book.out.currency,
+                        book.out.account,
+                        fhZERO_IF_FROZEN,
+                        j);
+
+                    // Treat negative funds as zero
+                    if (it->second < beast::zero)
+                        it->second.clear();
+                }
+                offer.ownerFunds = it->second;
+            }
+
+            offer.sle = std::move(sle);
+            offers_.push_back(std::move(offer));
+        } while (cdirNext(view, tip, dir, entry, offerIndex, j));
+    }
+}
+
+BookSnapshots::BookSnapshots(std::size_t limit) : limit_(limit)
+{
+}
+
+std::shared_ptr<BookSnapshot const>
+BookSnapshots::get(
+    std::shared_ptr<ReadView const> const& ledger,
+    Book const& book,
+    std::size_t limit,
+    beast::Journal j)
+{
+    if (ledger->open() || limit > limit_)
+        return nullptr;
+
+    std::pair<LedgerIndex, uint256> const key{
+        ledger->info().seq, ledger->info().hash};
+    auto const base = getBookBase(book);
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = ledgers_.find(key); it != ledgers_.end())
+        {
+            if (auto const found = it->second.find(base);
+                found != it->second.end())
+                return found->second;
+        }
+    }
+
+    // Read the book without holding the lock. If two requests read the
+    // same book at once, the first snapshot is kept.
+    auto snapshot =
+        std::make_shared<BookSnapshot const>(*ledger, book, limit_, j);
+
+    std::lock_guard lock(mutex_);
+    auto& books = ledgers_[key];
+    if (books.size() < maxBooks)
+        snapshot = books.emplace(base, std::move(snapshot)).first->second;
+    while (ledgers_.size() > maxLedgers)
+        ledgers_.erase(ledgers_.begin());
+    return snapshot;
+}
+
+}  // namespace ripple
@@ -24,10 +24,47 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Feature.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace ripple {
 
+namespace {
+
+/*  Write the nodes of a newly built ledger to the nodestore.
+
+    The nodes are already hashed and held in memory by the ledger, so
+    nothing needs them on disk before the next open ledger is built. The
+    write is done on the job queue so that the disk is not on the path
+    from consensus to accepting new transactions. Saving the ledger to the
+    database writes them first if the job has not yet.
+*/
+void
+storeNodes(
+    Application& app,
+    std::shared_ptr<Ledger> const& built,
+    SHAMap::PendingNodes&& pending)
+{
+    if (pending.empty())
+        return;
+
+    built->setPendingNodes(std::move(pending));
+    if (!app.getJobQueue().addJob(
+            jtWRITE, "Ledger::storeNodes", [built](Job&) {
+                built->storePendingNodes();
+            }))
+    {
+        // The job queue is stopping: write them now
+        built->storePendingNodes();
+    }
+}
+
+}  // namespace
+
 /* Generic buildLedgerImpl that dispatches to ApplyTxs invocable with signature
     void(OpenView&, std::shared_ptr<Ledger> const&)
    It is responsible for adding transactions to the open view to generate the
@@ -63,12 +100,13 @@ buildLedgerImpl(
     }
 
     built->updateSkipList();
-    {
-        // Write the final version of all modified SHAMap
-        // nodes to the node store to preserve the new LCL
 
-        int const asf = built->stateMap().flushDirty(hotACCOUNT_NODE);
-        int const tmf = built->txMap().flushDirty(hotTRANSACTION_NODE);
+    // Hash the final version of all modified SHAMap nodes now, but write
+    // them to the node store to preserve the new LCL in the background.
+    SHAMap::PendingNodes pending;
+    {
+        int const asf = built->stateMap().flushDirty(hotACCOUNT_NODE, pending);
+        int const tmf = built->txMap().flushDirty(hotTRANSACTION_NODE, pending);
         JLOG(j.debug()) << "Flushed " << asf << " accounts and " << tmf
                         << " transaction nodes";
     }
@@ -78,9 +116,107 @@ buildLedgerImpl(
     built->setAccepted(
         closeTime, closeResolution, closeTimeCorrect, app.config());
 
+    storeNodes(app, built, std::move(pending));
+
     return built;
 }
 
+namespace {
+
+// Handing out fewer signature checks than this to other jobs would take
+// longer than checking them all on the consensus thread
+constexpr std::size_t parallelCheckMinimum = 32;
+
+// The most jobs, counting the caller, which check a transaction set
+constexpr std::size_t parallelCheckJobs = 4;
+
+/*  Check the signatures of a set of consensus transactions on several
+    job queue threads before the set is applied.
+
+    Checking signatures is most of the cost of applying a typical
+    transaction. The result depends only on the transaction and the rules
+    and is remembered by the HashRouter, so the serial passes which follow
+    find it already known. Nothing that changes the ledger is decided
+    here: the transactions are still applied one at a time in canonical
+    order, so the ledger built is the same as without this step.
+
+    The calling thread takes part, and if the jobs are slow to start it
+    checks their share instead of waiting for them.
+*/
+void
+checkTransactions(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet const& txns,
+    Rules const& rules)
+{
+    if (txns.size() < parallelCheckMinimum)
+        return;
+
+    // Jobs can start after every transaction is taken and the caller has
+    // returned, so they share this state rather than using the stack.
+    struct State
+    {
+        State(Application& app, Rules const& rules)
+            : router(app.getHashRouter()), config(app.config()), rules(rules)
+        {
+        }
+
+        HashRouter& router;
+        Config const& config;
+        Rules const rules;
+        std::vector<STTx const*> pending;
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t finished = 0;
+
+        void
+        work()
+        {
+            for (auto i = next++; i < pending.size(); i = next++)
+            {
+                try
+                {
+                    checkValidity(router, *pending[i], rules, config);
+                }
+                catch (std::exception const&)
+                {
+                    // The serial pass checks it again and handles the
+                    // failure
+                }
+
+                std::lock_guard lock(mutex);
+                if (++finished == pending.size())
+                    done.notify_all();
+            }
+        }
+    };
+
+    auto const state = std::make_shared<State>(app, rules);
+    state->pending.reserve(txns.size());
+    for (auto const& [key, tx] : txns)
+    {
+        if (!built->txExists(key.getTXID()))
+            state->pending.push_back(tx.get());
+    }
+
+    auto const count = state->pending.size();
+    for (std::size_t i = 1; i < std::min(parallelCheckJobs, count); ++i)
+    {
+        app.getJobQueue().addJob(
+            jtACCEPT, "BuildLedger::checkTransactions", [state](Job&) {
+                state->work();
+            });
+    }
+    state->work();
+
+    std::unique_lock lock(state->mutex);
+    state->done.wait(lock, [&] { return state->finished == count; });
+}
+
+}  // namespace
+
 /** Apply a set of consensus transactions to a ledger.
 
   @param app Handle to application
@@ -103,6 +239,8 @@ applyTransactions(
     bool certainRetry = true;
     std::size_t count = 0;
 
+    checkTransactions(app, built, txns, view.rules());
+
     // Attempt to apply all of the retriable transactions
     for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
     {
@@ -215,7 +353,9 @@ buildLedger(
     LedgerReplay const& replayData,
     ApplyFlags applyFlags,
     Application& app,
-    beast::Journal j)
+    beast::Journal j,
+    std::function<void(STTx const&, std::chrono::steady_clock::duration)> const&
+        onApply)
 {
     auto const& replayLedger = replayData.replay();
 
@@ -230,7 +370,18 @@ buildLedger(
         j,
         [&](OpenView& accum, std::shared_ptr<Ledger> const& built) {
             for (auto& tx : replayData.orderedTxns())
+            {
+                if (!onApply)
+                {
+                    applyTransaction(
+                        app, accum, *tx.second, false, applyFlags, j);
+                    continue;
+                }
+
+                auto const start = std::chrono::steady_clock::now();
                 applyTransaction(app, accum, *tx.second, false, applyFlags, j);
+                onApply(*tx.second, std::chrono::steady_clock::now() - start);
+            }
         });
 }
 
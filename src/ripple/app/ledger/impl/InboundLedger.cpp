@@ -18,9 +18,11 @@
 //==============================================================================
 
 #include <ripple/app/ledger/AccountStateSF.h>
+#include <ripple/app/ledger/BuildLedger.h>
 #include <ripple/app/ledger/InboundLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/TransactionStateSF.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -66,11 +68,19 @@ enum {
     // Number of nodes to request blindly
     ,
     reqNodes = 8
+
+    // Node store write load above which fewer nodes are requested
+    ,
+    writeLoadBackoff = 8192
 };
 
 // millisecond for each ledger timeout
 auto constexpr ledgerAcquireTimeout = 2500ms;
 
+// The memory held for each node of a partly acquired ledger: the node and
+// its share of the child arrays of the inner nodes above it
+std::size_t constexpr acquiredNodeBytes = 256;
+
 InboundLedger::InboundLedger(
     Application& app,
     uint256 const& hash,
@@ -84,6 +94,8 @@ InboundLedger::InboundLedger(
     , mHaveTransactions(false)
     , mSignaled(false)
     , mByHash(true)
+    , mDeltaRequested(false)
+    , mReplayTried(false)
     , mSeq(seq)
     , mReason(reason)
     , mReceiveDispatched(false)
@@ -168,19 +180,37 @@ InboundLedger::getPeerCount() const
 void
 InboundLedger::queueJob()
 {
-    if (app_.getJobQueue().getJobCountTotal(jtLEDGER_DATA) > 4)
+    if (app_.getJobQueue().getJobCountTotal(jobType()) > 4 ||
+        app_.getJobQueue().isBehind(jobType()))
     {
         JLOG(m_journal.debug()) << "Deferring InboundLedger timer due to load";
         setTimer();
         return;
     }
 
+    if (app_.getInboundLedgers().isPreempted(mReason))
+    {
+        JLOG(m_journal.debug())
+            << "Deferring InboundLedger timer for a consensus ledger";
+        setTimer();
+        return;
+    }
+
     app_.getJobQueue().addJob(
-        jtLEDGER_DATA, "InboundLedger", [ptr = shared_from_this()](Job&) {
+        jobType(), "InboundLedger", [ptr = shared_from_this()](Job&) {
             ptr->invokeOnTimer();
         });
 }
 
+std::size_t
+InboundLedger::getMemoryUse() const
+{
+    // A complete ledger has been handed on and is accounted for elsewhere
+    if (mComplete || mFailed)
+        return 0;
+    return mNodes.load(std::memory_order_relaxed) * acquiredNodeBytes;
+}
+
 void
 InboundLedger::update(std::uint32_t seq)
 {
@@ -240,7 +270,8 @@ neededHashes(
     uint256 const& root,
     SHAMap& map,
     int max,
-    SHAMapSyncFilter* filter)
+    SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority)
 {
     std::vector<uint256> ret;
 
@@ -250,7 +281,7 @@ neededHashes(
             ret.push_back(root);
         else
         {
-            auto mn = map.getMissingNodes(max, filter);
+            auto mn = map.getMissingNodes(max, filter, priority);
             ret.reserve(mn.size());
             for (auto const& n : mn)
                 ret.push_back(n.second);
@@ -263,14 +294,31 @@ neededHashes(
 std::vector<uint256>
 InboundLedger::neededTxHashes(int max, SHAMapSyncFilter* filter) const
 {
-    return neededHashes(mLedger->info().txHash, mLedger->txMap(), max, filter);
+    return neededHashes(
+        mLedger->info().txHash,
+        mLedger->txMap(),
+        max,
+        filter,
+        fetchPriority());
 }
 
 std::vector<uint256>
 InboundLedger::neededStateHashes(int max, SHAMapSyncFilter* filter) const
 {
     return neededHashes(
-        mLedger->info().accountHash, mLedger->stateMap(), max, filter);
+        mLedger->info().accountHash,
+        mLedger->stateMap(),
+        max,
+        filter,
+        fetchPriority());
+}
+
+NodeStore::FetchPriority
+InboundLedger::fetchPriority() const
+{
+    if (mReason == Reason::HISTORY || mReason == Reason::SHARD)
+        return NodeStore::FetchPriority::low;
+    return NodeStore::FetchPriority::high;
 }
 
 LedgerInfo
@@ -307,10 +355,10 @@ InboundLedger::tryDB(NodeStore::Database& srcDB)
 {
     if (!mHaveHeader)
     {
-        auto makeLedger = [&, this](Blob const& data) {
+        auto makeLedger = [&, this](Slice data) {
             JLOG(m_journal.trace()) << "Ledger header found in fetch pack";
             mLedger = std::make_shared<Ledger>(
-                deserializePrefixedHeader(makeSlice(data)),
+                deserializePrefixedHeader(data),
                 app_.config(),
                 mReason == Reason::SHARD ? *app_.getShardFamily()
                                          : app_.getNodeFamily());
@@ -339,7 +387,8 @@ InboundLedger::tryDB(NodeStore::Database& srcDB)
             auto& dstDB{mLedger->stateMap().family().db()};
             if (std::addressof(dstDB) != std::addressof(srcDB))
             {
-                Blob blob{nodeObject->getData()};
+                auto const data = nodeObject->getData();
+                Blob blob{data.begin(), data.end()};
                 dstDB.store(
                     hotLEDGER, std::move(blob), mHash, mLedger->info().seq);
             }
@@ -353,7 +402,7 @@ InboundLedger::tryDB(NodeStore::Database& srcDB)
 
             JLOG(m_journal.trace()) << "Ledger header found in fetch pack";
 
-            makeLedger(*data);
+            makeLedger(makeSlice(*data));
             if (mFailed)
                 return;
 
@@ -428,6 +477,8 @@ void
 InboundLedger::onTimer(bool wasProgress, ScopedLockType&)
 {
     mRecentNodes.clear();
+    mStragglers.swap(mRequested);
+    mRequested.clear();
 
     if (isDone())
     {
@@ -478,8 +529,10 @@ InboundLedger::onTimer(bool wasProgress, ScopedLockType&)
 void
 InboundLedger::addPeers()
 {
+    std::size_t const start = std::max<std::size_t>(
+        peerCountStart, app_.config().LEDGER_FETCH_STRIPED_PEERS);
     PeerSet::addPeers(
-        (getPeerCount() == 0) ? peerCountStart : peerCountAdd,
+        (getPeerCount() == 0) ? start : peerCountAdd,
         [this](auto peer) { return peer->hasLedger(mHash, mSeq); });
 }
 
@@ -526,7 +579,7 @@ InboundLedger::done()
 
     // We hold the PeerSet lock, so must dispatch
     app_.getJobQueue().addJob(
-        jtLEDGER_DATA, "AcquisitionDone", [self = shared_from_this()](Job&) {
+        jobType(), "AcquisitionDone", [self = shared_from_this()](Job&) {
             if (self->mComplete && !self->mFailed)
             {
                 self->app_.getLedgerMaster().checkAccept(self->getLedger());
@@ -670,9 +723,20 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
     else
         tmGL.set_querydepth(1);
 
+    auto const stripe = stripePeers(reason);
+
+    // A ledger we can replay needs only its transactions, so they are
+    // acquired first. The state tree is acquired only if that fails.
+    bool replay = mHaveHeader && !mHaveState && !mFailed && canReplay();
+    if (replay && mHaveTransactions)
+    {
+        tryReplay(sl);
+        replay = false;
+    }
+
     // Get the state data first because it's the most likely to be useful
     // if we wind up abandoning this fetch.
-    if (mHaveHeader && !mHaveState && !mFailed)
+    if (mHaveHeader && !mHaveState && !mFailed && !replay)
     {
         assert(mLedger);
 
@@ -680,6 +744,10 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
         {
             mFailed = true;
         }
+        else if (requestDelta(peer))
+        {
+            return;
+        }
         else if (mLedger->stateMap().getHash().isZero())
         {
             // we need the root node
@@ -697,8 +765,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
 
             // Release the lock while we process the large state map
             sl.unlock();
-            auto nodes =
-                mLedger->stateMap().getMissingNodes(missingNodesFind, &filter);
+            auto nodes = mLedger->stateMap().getMissingNodes(
+                missingNodesFind, &filter, fetchPriority());
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -718,21 +786,18 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                 }
                 else
                 {
-                    filterNodes(nodes, reason);
+                    filterNodes(nodes, reason, stripe.size());
 
                     if (!nodes.empty())
                     {
                         tmGL.set_itype(protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            *(tmGL.add_nodeids()) = id.first.getRawString();
-                        }
-
                         JLOG(m_journal.trace())
                             << "Sending AS node request (" << nodes.size()
                             << ") to "
-                            << (peer ? "selected peer" : "all peers");
-                        sendRequest(tmGL, peer);
+                            << (stripe.empty()
+                                    ? (peer ? "selected peer" : "all peers")
+                                    : "striped peers");
+                        sendNodeRequest(tmGL, nodes, peer, stripe);
                         return;
                     }
                     else
@@ -767,8 +832,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
             TransactionStateSF filter(
                 mLedger->txMap().family().db(), app_.getLedgerMaster());
 
-            auto nodes =
-                mLedger->txMap().getMissingNodes(missingNodesFind, &filter);
+            auto nodes = mLedger->txMap().getMissingNodes(
+                missingNodesFind, &filter, fetchPriority());
 
             if (nodes.empty())
             {
@@ -784,19 +849,18 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
             }
             else
             {
-                filterNodes(nodes, reason);
+                filterNodes(nodes, reason, stripe.size());
 
                 if (!nodes.empty())
                 {
                     tmGL.set_itype(protocol::liTX_NODE);
-                    for (auto const& n : nodes)
-                    {
-                        *(tmGL.add_nodeids()) = n.first.getRawString();
-                    }
                     JLOG(m_journal.trace())
                         << "Sending TX node request (" << nodes.size()
-                        << ") to " << (peer ? "selected peer" : "all peers");
-                    sendRequest(tmGL, peer);
+                        << ") to "
+                        << (stripe.empty()
+                                ? (peer ? "selected peer" : "all peers")
+                                : "striped peers");
+                    sendNodeRequest(tmGL, nodes, peer, stripe);
                     return;
                 }
                 else
@@ -807,6 +871,14 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
         }
     }
 
+    if (replay && mHaveTransactions && !mFailed && !tryReplay(sl))
+    {
+        // Ask for the state tree now rather than on the next timeout
+        sl.unlock();
+        trigger(peer, reason);
+        return;
+    }
+
     if (mComplete || mFailed)
     {
         JLOG(m_journal.debug())
@@ -820,7 +892,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
 void
 InboundLedger::filterNodes(
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-    TriggerReason reason)
+    TriggerReason reason,
+    std::size_t peers)
 {
     // Sort nodes so that the ones we haven't recently
     // requested come before the ones we have.
@@ -849,8 +922,21 @@ InboundLedger::filterNodes(
         nodes.erase(dup, nodes.end());
     }
 
-    std::size_t const limit =
-        (reason == TriggerReason::reply) ? reqNodesReply : reqNodes;
+    // Striped requests ask each peer for as many nodes as one would be
+    std::size_t limit =
+        ((reason == TriggerReason::reply) ? reqNodesReply : reqNodes) *
+        std::max<std::size_t>(peers, 1);
+
+    // Ask for less while the node store is behind on writing, so that
+    // acquiring slows down along with the disk instead of piling up
+    auto const load = app_.getNodeStore().getWriteLoad();
+    if (load > writeLoadBackoff && reason != TriggerReason::timeout)
+    {
+        limit = std::max<std::size_t>(
+            1, limit * static_cast<std::size_t>(writeLoadBackoff) / load);
+        JLOG(m_journal.debug())
+            << "filterNodes: write load " << load << ", asking for " << limit;
+    }
 
     if (nodes.size() > limit)
         nodes.resize(limit);
@@ -859,6 +945,215 @@ InboundLedger::filterNodes(
         mRecentNodes.insert(n.second);
 }
 
+std::vector<std::shared_ptr<Peer>>
+InboundLedger::stripePeers(TriggerReason reason) const
+{
+    std::vector<std::shared_ptr<Peer>> peers;
+
+    // A peer which was just added is asked on its own
+    auto const limit = app_.config().LEDGER_FETCH_STRIPED_PEERS;
+    if (limit == 0 || reason == TriggerReason::added)
+        return peers;
+
+    for (auto id : mPeers)
+    {
+        if (auto p = app_.overlay().findPeerByShortID(id))
+            peers.push_back(std::move(p));
+    }
+
+    auto const delivered = [this](std::shared_ptr<Peer> const& p) {
+        auto const it = mPeerNodes.find(p->id());
+        return it == mPeerNodes.end() ? 0 : it->second;
+    };
+    std::stable_sort(
+        peers.begin(), peers.end(), [&](auto const& lhs, auto const& rhs) {
+            return delivered(lhs) > delivered(rhs);
+        });
+
+    if (peers.size() > limit)
+        peers.resize(limit);
+    if (peers.size() < 2)
+        peers.clear();
+    return peers;
+}
+
+void
+InboundLedger::sendNodeRequest(
+    protocol::TMGetLedger& tmGL,
+    std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+    std::shared_ptr<Peer> const& peer,
+    std::vector<std::shared_ptr<Peer>> const& stripe)
+{
+    if (stripe.empty())
+    {
+        for (auto const& n : nodes)
+            *(tmGL.add_nodeids()) = n.first.getRawString();
+        sendRequest(tmGL, peer);
+        return;
+    }
+
+    // Each peer's share is in proportion to the nodes it has delivered,
+    // so the peers that have proven fastest are asked for the most. Every
+    // peer gets at least one node, which measures peers new to the set.
+    std::vector<std::uint64_t> weights;
+    weights.reserve(stripe.size());
+    std::uint64_t total = 0;
+    for (auto const& p : stripe)
+    {
+        auto const it = mPeerNodes.find(p->id());
+        weights.push_back(1 + (it == mPeerNodes.end() ? 0 : it->second));
+        total += weights.back();
+    }
+
+    std::vector<std::size_t> shares;
+    shares.reserve(stripe.size());
+    for (auto const w : weights)
+        shares.push_back(std::max<std::size_t>(1, nodes.size() * w / total));
+
+    // Consecutive nodes are often siblings, so each share is kept together
+    std::vector<protocol::TMGetLedger> requests(stripe.size(), tmGL);
+    for (auto const& [nodeID, hash] : nodes)
+    {
+        // A node the last peer asked has not returned goes to another
+        auto const straggler = mStragglers.find(hash);
+        auto const skip = [&](std::size_t i) {
+            return straggler != mStragglers.end() &&
+                straggler->second == stripe[i]->id();
+        };
+
+        std::size_t chosen = stripe.size();
+        for (std::size_t i = 0; i < stripe.size(); ++i)
+        {
+            if (shares[i] != 0 && !skip(i))
+            {
+                chosen = i;
+                --shares[i];
+                break;
+            }
+        }
+
+        // Rounding leaves a few nodes over; the fastest peer gets them
+        if (chosen == stripe.size())
+            chosen = skip(0) ? 1 : 0;
+
+        *(requests[chosen].add_nodeids()) = nodeID.getRawString();
+        mRequested[hash] = stripe[chosen]->id();
+    }
+
+    for (std::size_t i = 0; i < stripe.size(); ++i)
+    {
+        if (requests[i].nodeids_size() != 0)
+            stripe[i]->send(std::make_shared<Message>(
+                requests[i], protocol::mtGET_LEDGER));
+    }
+}
+
+bool
+InboundLedger::requestDelta(std::shared_ptr<Peer> const& peer)
+{
+    // Shards are stored apart from the ledgers we would compare with
+    if (mDeltaRequested || mReason == Reason::SHARD)
+        return false;
+
+    std::shared_ptr<Peer> target;
+    if (peer && peer->supportsFeature(ProtocolFeature::LedgerDelta))
+        target = peer;
+    for (auto it = mPeers.begin(); !target && it != mPeers.end(); ++it)
+    {
+        auto p = app_.overlay().findPeerByShortID(*it);
+        if (p && p->supportsFeature(ProtocolFeature::LedgerDelta))
+            target = std::move(p);
+    }
+    if (!target)
+        return false;
+
+    auto& ledgerMaster = app_.getLedgerMaster();
+    auto base = ledgerMaster.getLedgerByHash(mLedger->info().parentHash);
+    if (!base)
+    {
+        // Acquiring history, we usually have the ledger after this one
+        base = ledgerMaster.getLedgerBySeq(mLedger->info().seq + 1);
+        if (base && base->info().parentHash != mHash)
+            base.reset();
+    }
+    if (!base)
+        return false;
+
+    mDeltaRequested = true;
+
+    protocol::TMGetLedgerDelta tmGLD;
+    tmGLD.set_ledgerhash(mHash.begin(), mHash.size());
+    tmGLD.set_ledgerseq(mLedger->info().seq);
+    tmGLD.set_basehash(base->info().hash.begin(), base->info().hash.size());
+
+    JLOG(m_journal.debug()) << "Requesting state delta of " << mHash
+                            << " from ledger " << base->info().seq;
+    target->send(
+        std::make_shared<Message>(tmGLD, protocol::mtGET_LEDGER_DELTA));
+    return true;
+}
+
+bool
+InboundLedger::canReplay() const
+{
+    // Shards are stored apart from the ledgers we would replay on
+    if (mReplayTried || mReason == Reason::SHARD ||
+        !app_.config().LEDGER_FETCH_REPLAY)
+        return false;
+
+    return app_.getLedgerMaster().getLedgerByHash(
+               mLedger->info().parentHash) != nullptr;
+}
+
+bool
+InboundLedger::tryReplay(ScopedLockType& sl)
+{
+    mReplayTried = true;
+
+    auto parent =
+        app_.getLedgerMaster().getLedgerByHash(mLedger->info().parentHash);
+    if (!parent)
+        return false;
+
+    std::shared_ptr<Ledger const> const ledger = mLedger;
+    JLOG(m_journal.debug())
+        << "Replaying the transactions of " << mHash << " on its parent";
+
+    // Release the lock while the transactions are applied
+    sl.unlock();
+    std::shared_ptr<Ledger> built;
+    try
+    {
+        built = buildLedger(
+            LedgerReplay(std::move(parent), ledger),
+            tapNONE,
+            app_,
+            m_journal);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) << "Replaying " << mHash << ": " << e.what();
+    }
+    sl.lock();
+
+    if (!built || built->info().hash != mHash)
+    {
+        JLOG(m_journal.info()) << "Replay of " << mHash
+                               << " did not match, acquiring its state";
+        return false;
+    }
+
+    // Make sure nothing happened while we released the lock
+    if (mFailed || mComplete || mHaveState)
+        return false;
+
+    JLOG(m_journal.debug()) << "Replayed " << mHash;
+    mLedger = std::move(built);
+    mHaveState = true;
+    mComplete = true;
+    return true;
+}
+
 /** Take ledger header data
     Call with a lock
 */
@@ -1170,6 +1465,7 @@ InboundLedger::processData(
             mProgress = true;
 
         mStats += san;
+        mNodes += san.getGood();
         return san.getGood();
     }
 
@@ -1197,6 +1493,9 @@ InboundLedger::processData(
         SHAMapAddNode san;
         receiveNode(packet, san);
 
+        if (san.getGood() > 0)
+            mPeerNodes[peer->id()] += san.getGood();
+
         if (packet.type() == protocol::liTX_NODE)
         {
             JLOG(m_journal.debug()) << "Ledger TX node stats: " << san.get();
@@ -1210,6 +1509,7 @@ InboundLedger::processData(
             mProgress = true;
 
         mStats += san;
+        mNodes += san.getGood();
         return san.getGood();
     }
 
@@ -1258,7 +1558,8 @@ InboundLedger::runData()
         }
     }
 
-    if (chosenPeer)
+    // A preempted acquisition asks for more on its next timer instead
+    if (chosenPeer && !app_.getInboundLedgers().isPreempted(mReason))
         trigger(chosenPeer, TriggerReason::reply);
 }
 
@@ -21,13 +21,16 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/DecayingSample.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/beast/container/aged_map.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/protocol/jss.h>
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
@@ -46,6 +49,10 @@ public:
     // How long before we try again to acquire the same ledger
     static constexpr std::chrono::minutes const kReacquireInterval{5};
 
+    // The memory unfinished acquisitions may hold before no more are
+    // started for past ledgers or shards
+    static constexpr std::size_t kMemoryBudget = megabytes(256);
+
     InboundLedgersImp(
         Application& app,
         clock_type& clock,
@@ -85,6 +92,12 @@ public:
                 isNew = false;
                 inbound = it->second;
             }
+            else if (isLowPriority(reason) && overBudget())
+            {
+                JLOG(j_.debug())
+                    << "Not acquiring " << hash << ": over memory budget";
+                return {};
+            }
             else
             {
                 inbound = std::make_shared<InboundLedger>(
@@ -146,6 +159,22 @@ public:
         return ret;
     }
 
+    bool
+    isPreempted(InboundLedger::Reason reason) override
+    {
+        if (!isLowPriority(reason))
+            return false;
+
+        ScopedLockType sl(mLock);
+        return std::any_of(
+            mLedgers.begin(), mLedgers.end(), [](auto const& entry) {
+                auto const& inbound = entry.second;
+                return inbound->getReason() ==
+                    InboundLedger::Reason::CONSENSUS &&
+                    !inbound->isComplete() && !inbound->isFailed();
+            });
+    }
+
     /*
     This gets called when
         "We got some data from an inbound ledger"
@@ -175,7 +204,7 @@ public:
             // dispatch
             if (ledger->gotData(std::weak_ptr<Peer>(peer), packet))
                 app_.getJobQueue().addJob(
-                    jtLEDGER_DATA, "processLedgerData", [ledger](Job&) {
+                    ledger->jobType(), "processLedgerData", [ledger](Job&) {
                         ledger->runData();
                     });
 
@@ -190,7 +219,7 @@ public:
         if (packet->type() == protocol::liAS_NODE)
         {
             app_.getJobQueue().addJob(
-                jtLEDGER_DATA, "gotStaleData", [this, packet](Job&) {
+                jtLEDGER_HISTORY, "gotStaleData", [this, packet](Job&) {
                     gotStaleData(packet);
                 });
         }
@@ -393,12 +422,33 @@ public:
     }
 
 private:
+    static bool
+    isLowPriority(InboundLedger::Reason reason)
+    {
+        return reason == InboundLedger::Reason::HISTORY ||
+            reason == InboundLedger::Reason::SHARD;
+    }
+
+    // Call with the lock held
+    bool
+    overBudget() const
+    {
+        std::size_t total = 0;
+        for (auto const& entry : mLedgers)
+        {
+            total += entry.second->getMemoryUse();
+            if (total > kMemoryBudget)
+                return true;
+        }
+        return false;
+    }
+
     clock_type& m_clock;
 
     using ScopedLockType = std::unique_lock<std::recursive_mutex>;
     std::recursive_mutex mLock;
 
-    using MapType = hash_map<uint256, std::shared_ptr<InboundLedger>>;
+    using MapType = flat_hash_map<uint256, std::shared_ptr<InboundLedger>>;
     MapType mLedgers;
 
     beast::aged_map<uint256, std::uint32_t> mRecentFailures;
@@ -19,9 +19,11 @@
 
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/InboundTransactions.h>
+#include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/ledger/impl/TransactionAcquire.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/Transaction.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/RippleLedgerHash.h>
@@ -47,6 +49,9 @@ public:
     TransactionAcquire::pointer mAcquire;
     std::shared_ptr<SHAMap> mSet;
 
+    // A sketch of mSet, computed when first needed
+    std::optional<TxSetSketch> mSketch;
+
     InboundTransactionSet(std::uint32_t seq, std::shared_ptr<SHAMap> const& set)
         : mSeq(seq), mSet(set)
     {
@@ -58,6 +63,19 @@ public:
     }
 };
 
+class InboundSketch
+{
+    // A sketch of a transaction set a trusted validator proposed
+public:
+    std::uint32_t mSeq;
+    TxSetSketch mSketch;
+
+    InboundSketch(std::uint32_t seq, TxSetSketch const& sketch)
+        : mSeq(seq), mSketch(sketch)
+    {
+    }
+};
+
 class InboundTransactionsImp : public InboundTransactions, public Stoppable
 {
 public:
@@ -118,6 +136,29 @@ public:
 
             if (!acquire || isStopping())
                 return std::shared_ptr<SHAMap>();
+        }
+
+        if (auto set = rebuild(hash))
+        {
+            // The caller receives the set directly, so there is no need to
+            // notify consensus as if it had been acquired.
+            giveSet(hash, set, false);
+            return set;
+        }
+
+        {
+            std::lock_guard sl(mLock);
+
+            // Another thread may have started acquiring the set, or given
+            // it to us, while the lock was released.
+            if (auto it = m_map.find(hash); it != m_map.end())
+            {
+                it->second.mSeq = m_seq;
+                return it->second.mSet;
+            }
+
+            if (isStopping())
+                return std::shared_ptr<SHAMap>();
 
             ta = std::make_shared<TransactionAcquire>(app_, hash);
 
@@ -210,6 +251,58 @@ public:
             m_gotSet(set, fromAcquire);
     }
 
+    std::optional<TxSetSketch>
+    getSketch(uint256 const& hash) override
+    {
+        std::shared_ptr<SHAMap> set;
+
+        {
+            std::lock_guard sl(mLock);
+
+            auto it = m_map.find(hash);
+            if (it == m_map.end() || !it->second.mSet)
+                return std::nullopt;
+
+            if (!it->second.mSketch)
+                set = it->second.mSet;
+            else if (it->second.mSketch->size() < TxSetSketch::minSetSize)
+                return std::nullopt;
+            else
+                return it->second.mSketch;
+        }
+
+        TxSetSketch sketch(*set);
+
+        {
+            std::lock_guard sl(mLock);
+
+            if (auto it = m_map.find(hash); it != m_map.end())
+                it->second.mSketch = sketch;
+        }
+
+        if (sketch.size() < TxSetSketch::minSetSize)
+            return std::nullopt;
+        return sketch;
+    }
+
+    void
+    gotSketch(uint256 const& hash, Slice data) override
+    {
+        auto sketch = TxSetSketch::fromWire(data);
+
+        if (!sketch || sketch->size() < TxSetSketch::minSetSize)
+        {
+            JLOG(app_.journal("InboundTransactions").debug())
+                << "Ignoring sketch of " << hash;
+            return;
+        }
+
+        std::lock_guard sl(mLock);
+
+        if (m_map.find(hash) == m_map.end())
+            m_sketches.try_emplace(hash, m_seq, *sketch);
+    }
+
     void
     newRound(std::uint32_t seq) override
     {
@@ -235,6 +328,14 @@ public:
                 else
                     ++it;
             }
+
+            for (auto sit = m_sketches.begin(); sit != m_sketches.end();)
+            {
+                if (sit->second.mSeq < minSeq || sit->second.mSeq > maxSeq)
+                    sit = m_sketches.erase(sit);
+                else
+                    ++sit;
+            }
         }
     }
 
@@ -244,11 +345,103 @@ public:
         std::lock_guard lock(mLock);
 
         m_map.clear();
+        m_sketches.clear();
 
         stopped();
     }
 
 private:
+    /** Try to build a missing set from one we have.
+
+        If a trusted validator sent a sketch of the missing set, compare it
+        with the sketches of the sets we have. When the differences can be
+        recovered and we know every transaction that is missing from one of
+        our sets, apply the differences to a copy of that set.
+
+        @return The rebuilt set, or nullptr if it could not be built.
+    */
+    std::shared_ptr<SHAMap>
+    rebuild(uint256 const& hash)
+    {
+        std::optional<TxSetSketch> sketch;
+        std::vector<std::pair<uint256, std::shared_ptr<SHAMap>>> candidates;
+
+        {
+            std::lock_guard sl(mLock);
+
+            // Only try each sketch once
+            auto it = m_sketches.find(hash);
+            if (it == m_sketches.end())
+                return {};
+            sketch = it->second.mSketch;
+            m_sketches.erase(it);
+
+            for (auto const& [setHash, inboundSet] : m_map)
+            {
+                if (inboundSet.mSet && setHash != uint256())
+                    candidates.emplace_back(setHash, inboundSet.mSet);
+            }
+        }
+
+        auto const j = app_.journal("InboundTransactions");
+
+        for (auto const& [setHash, base] : candidates)
+        {
+            auto const ours = getSketch(setHash);
+            if (!ours)
+                continue;
+
+            auto const diff = sketch->difference(*ours);
+            if (!diff)
+                continue;
+
+            auto set = base->snapShot(true);
+            bool ok = true;
+
+            for (auto const& id : diff->removed)
+            {
+                if (!set->delItem(id))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+
+            for (auto const& id : diff->added)
+            {
+                if (!ok)
+                    break;
+
+                auto const txn =
+                    app_.getMasterTransaction().fetch_from_cache(id);
+                if (!txn)
+                {
+                    ok = false;
+                    break;
+                }
+
+                Serializer s;
+                txn->getSTransaction()->add(s);
+                ok = set->addItem(
+                    SHAMapNodeType::tnTRANSACTION_NM,
+                    SHAMapItem(id, std::move(s)));
+            }
+
+            if (!ok || set->getHash().as_uint256() != hash)
+                continue;
+
+            JLOG(j.debug()) << "Rebuilt transaction set " << hash << " from "
+                            << setHash << " with " << diff->added.size()
+                            << " added and " << diff->removed.size()
+                            << " removed";
+            set->setImmutable();
+            return set;
+        }
+
+        JLOG(j.debug()) << "Unable to rebuild transaction set " << hash;
+        return {};
+    }
+
     using MapType = hash_map<uint256, InboundTransactionSet>;
 
     std::recursive_mutex mLock;
@@ -256,6 +449,9 @@ private:
     MapType m_map;
     std::uint32_t m_seq;
 
+    // Sketches of sets we do not have, from trusted proposals
+    hash_map<uint256, InboundSketch> m_sketches;
+
     // The empty transaction set whose hash is zero
     InboundTransactionSet& m_zeroSet;
 
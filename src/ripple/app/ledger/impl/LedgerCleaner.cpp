@@ -70,6 +70,10 @@ class LedgerCleanerImp : public LedgerCleaner
     // Number of errors encountered since last success
     int failures_ = 0;
 
+    // A ledger to find the hashes of the range from, if not the validated
+    // ledger
+    std::shared_ptr<ReadView const> reference_;
+
     //--------------------------------------------------------------------------
 public:
     LedgerCleanerImp(
@@ -146,6 +150,13 @@ public:
     //
     //--------------------------------------------------------------------------
 
+    bool
+    isIdle() const override
+    {
+        std::lock_guard lock(mutex_);
+        return state_ == State::readyToClean && maxRange_ == 0;
+    }
+
     void
     doClean(Json::Value const& params) override
     {
@@ -161,6 +172,7 @@ public:
             checkNodes_ = false;
             fixTxns_ = false;
             failures_ = 0;
+            reference_.reset();
 
             /*
             JSON Parameters:
@@ -227,6 +239,24 @@ public:
         }
     }
 
+    void
+    checkLedger(std::shared_ptr<ReadView const> const& ledger) override
+    {
+        std::lock_guard lock(mutex_);
+
+        maxRange_ = minRange_ = ledger->info().seq;
+        checkNodes_ = true;
+        fixTxns_ = false;
+        failures_ = 0;
+        reference_ = ledger;
+
+        if (state_ == State::readyToClean)
+        {
+            state_ = State::startCleaning;
+            wakeup_.notify_one();
+        }
+    }
+
     //--------------------------------------------------------------------------
     //
     // LedgerCleanerImp
@@ -328,7 +358,7 @@ private:
             doTxns = true;
         }
 
-        if (doNodes && !nodeLedger->walkLedger(app_.journal("Ledger")))
+        if (doNodes && !nodeLedger->walkLedger(app_.journal("Ledger"), true))
         {
             JLOG(j_.debug()) << "Ledger " << ledgerIndex << " is missing nodes";
             app_.getLedgerMaster().clearLedger(ledgerIndex);
@@ -438,6 +468,8 @@ private:
                 ledgerIndex = maxRange_;
                 doNodes = checkNodes_;
                 doTxns = fixTxns_;
+                if (reference_)
+                    goodLedger = std::move(reference_);
             }
 
             ledgerHash = getHash(ledgerIndex, goodLedger);
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <cassert>
+
+namespace ripple {
+
+LedgerHashIndex::LedgerHashIndex(std::size_t maxChunks) : maxChunks_(maxChunks)
+{
+    assert(maxChunks_ != 0);
+}
+
+void
+LedgerHashIndex::insert(LedgerIndex seq, uint256 const& hash)
+{
+    assert(hash.isNonZero());
+    LedgerIndex const chunk = seq / chunkSize;
+
+    if (chunks_.empty())
+    {
+        firstChunk_ = chunk;
+        chunks_.emplace_back();
+    }
+    else if (chunk < firstChunk_)
+    {
+        // Only the newest chunks are kept
+        if (firstChunk_ + chunks_.size() - chunk > maxChunks_)
+            return;
+        for (; firstChunk_ != chunk; --firstChunk_)
+            chunks_.emplace_front();
+    }
+    else if (chunk - firstChunk_ >= chunks_.size())
+    {
+        chunks_.resize(chunk - firstChunk_ + 1);
+        while (chunks_.size() > maxChunks_)
+        {
+            if (chunks_.front())
+                size_ -= chunks_.front()->count;
+            chunks_.pop_front();
+            ++firstChunk_;
+        }
+    }
+
+    auto& c = chunks_[chunk - firstChunk_];
+    if (!c)
+        c = std::make_unique<Chunk>();
+
+    auto& slot = c->hashes[seq % chunkSize];
+    if (slot.isZero())
+    {
+        ++c->count;
+        ++size_;
+    }
+    slot = hash;
+}
+
+boost::optional<uint256>
+LedgerHashIndex::get(LedgerIndex seq) const
+{
+    LedgerIndex const chunk = seq / chunkSize;
+    if (chunk < firstChunk_ || chunk - firstChunk_ >= chunks_.size())
+        return boost::none;
+
+    auto const& c = chunks_[chunk - firstChunk_];
+    if (!c)
+        return boost::none;
+
+    auto const& hash = c->hashes[seq % chunkSize];
+    if (hash.isZero())
+        return boost::none;
+    return hash;
+}
+
+}  // namespace ripple
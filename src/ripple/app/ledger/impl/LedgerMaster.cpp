@@ -34,6 +34,7 @@
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/MathUtilities.h>
 #include <ripple/basics/TaggedCache.h>
@@ -48,6 +49,7 @@
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/digest.h>
+#include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
 #include <algorithm>
 #include <cassert>
@@ -146,6 +148,19 @@ static constexpr std::chrono::minutes MAX_LEDGER_AGE_ACQUIRE{1};
 // Don't acquire history if write load is too high
 static constexpr int MAX_WRITE_LOAD_ACQUIRE{8192};
 
+// Send a fetch pack in messages of this many objects
+static constexpr int FETCH_PACK_MESSAGE_OBJECTS{512};
+
+// Don't put more than this many bytes in one fetch pack
+static constexpr std::size_t FETCH_PACK_MAX_BYTES{megabytes(4)};
+
+// Don't hold more than this many bytes in all the fetch packs being built
+static constexpr std::size_t FETCH_PACK_BUDGET{megabytes(16)};
+
+// How far a recovery checkpoint lags the validated ledger, so that the
+// ledgers it covers are sure to have reached the disk (cannot exceed 256)
+static constexpr LedgerIndex RECOVERY_CHECKPOINT_LAG{256};
+
 // Helper function for LedgerMaster::doAdvance()
 // Return true if candidateLedger should be fetched from the network.
 static bool
@@ -187,7 +202,7 @@ LedgerMaster::LedgerMaster(
     , mLedgerHistory(collector, app)
     , mLedgerCleaner(
           detail::make_LedgerCleaner(app, *this, app_.journal("LedgerCleaner")))
-    , standalone_(app_.config().standalone())
+    , standalone_(app_.config().standalone() || app_.config().reporting())
     , fetch_depth_(
           app_.getSHAMapStore().clampFetchDepth(app_.config().FETCH_DEPTH))
     , ledger_history_(app_.config().LEDGER_HISTORY)
@@ -198,6 +213,8 @@ LedgerMaster::LedgerMaster(
           std::chrono::seconds{45},
           stopwatch,
           app_.journal("TaggedCache"))
+    , history_ranges_(app_.config().LEDGER_FETCH_HISTORY_RANGES)
+    , history_write_load_(app_.config().LEDGER_FETCH_HISTORY_WRITE_LOAD)
     , m_stats(std::bind(&LedgerMaster::collect_metrics, this), collector)
 {
 }
@@ -352,6 +369,19 @@ LedgerMaster::setValidLedger(std::shared_ptr<Ledger const> const& l)
     app_.getSHAMapStore().onLedgerClosed(getValidatedLedger());
     mLedgerHistory.validatedLedger(l, consensusHash);
     app_.getAmendmentTable().doValidatedLedger(l);
+
+    if (recoveryEnabled_ && l->isFlagLedger() &&
+        l->info().seq > RECOVERY_CHECKPOINT_LAG)
+    {
+        if (auto const cp = makeRecoveryCheckpoint(
+                *l, l->info().seq - RECOVERY_CHECKPOINT_LAG))
+        {
+            app_.getJobQueue().addJob(
+                jtADVANCE, "recoveryCheckpoint", [this, cp = *cp](Job&) {
+                    setRecoveryCheckpoint(app_.getWalletDB(), cp);
+                });
+        }
+    }
     if (!app_.getOPs().isAmendmentBlocked())
     {
         if (app_.getAmendmentTable().hasUnsupportedEnabled())
@@ -672,6 +702,31 @@ LedgerMaster::tryFill(Job& job, std::shared_ptr<Ledger const> ledger)
     std::uint32_t minHas = seq;
     std::uint32_t maxHas = seq;
 
+    boost::optional<RecoveryCheckpoint> checkpoint;
+    {
+        std::lock_guard ml(m_mutex);
+        checkpoint = recoveryStart_;
+    }
+    bool reachedCheckpoint = false;
+
+    if (checkpoint && !checkpoint->clean && !recoveryTailPending_ &&
+        checkpoint->maxSeq + 1 < seq)
+    {
+        // The ledgers written after the checkpoint may not all have
+        // reached the disk. Check them while we run. They are marked
+        // before any of them is published as complete, so a checkpoint
+        // written meanwhile can't cover them.
+        JLOG(m_journal.warn())
+            << "Unclean shutdown: checking ledgers " << checkpoint->maxSeq + 1
+            << " to " << seq - 1 << " in the background";
+        recoveryTailPending_ = true;
+        Json::Value params(Json::objectValue);
+        params[jss::min_ledger] = checkpoint->maxSeq + 1;
+        params[jss::max_ledger] = seq - 1;
+        params[jss::check_nodes] = true;
+        doLedgerCleaner(params);
+    }
+
     NodeStore::Database& nodeStore{app_.getNodeStore()};
     while (!job.shouldCancel() && seq > 0)
     {
@@ -717,6 +772,17 @@ LedgerMaster::tryFill(Job& job, std::shared_ptr<Ledger const> ledger)
         if (it->second.first != prevHash)
             break;
 
+        if (checkpoint && seq == checkpoint->maxSeq &&
+            prevHash == checkpoint->maxHash)
+        {
+            // Everything before this was already checked when the
+            // checkpoint was recorded, so there is no need to walk it
+            // again. Some of it may have been deleted since.
+            minHas = std::max(checkpoint->minSeq, minSqlSeq().value_or(seq));
+            reachedCheckpoint = true;
+            break;
+        }
+
         prevHash = it->second.second;
     }
 
@@ -724,13 +790,107 @@ LedgerMaster::tryFill(Job& job, std::shared_ptr<Ledger const> ledger)
         std::lock_guard ml(mCompleteLock);
         mCompleteLedgers.insert(range(minHas, maxHas));
     }
+
+    if (reachedCheckpoint)
+    {
+        JLOG(m_journal.info()) << "History from " << minHas << " to "
+                               << checkpoint->maxSeq
+                               << " taken from the recovery checkpoint";
+    }
+
     {
         std::lock_guard ml(m_mutex);
+        if (reachedCheckpoint)
+            recoveryStart_ = boost::none;
         mFillInProgress = 0;
         tryAdvance();
     }
 }
 
+boost::optional<RecoveryCheckpoint>
+LedgerMaster::makeRecoveryCheckpoint(ReadView const& ledger, LedgerIndex seq)
+{
+    // Don't cover ledgers the ledger cleaner has yet to check
+    if (recoveryTailPending_)
+    {
+        if (!mLedgerCleaner->isIdle())
+            return boost::none;
+        recoveryTailPending_ = false;
+    }
+
+    auto const hash = hashOfSeq(ledger, seq, m_journal);
+    if (!hash)
+        return boost::none;
+
+    RecoveryCheckpoint cp;
+    {
+        std::lock_guard sl(mCompleteLock);
+        auto const it = mCompleteLedgers.find(seq);
+        if (it == mCompleteLedgers.end())
+            return boost::none;
+        cp.minSeq = it->lower();
+    }
+    cp.maxSeq = seq;
+    cp.maxHash = *hash;
+    return cp;
+}
+
+void
+LedgerMaster::loadRecoveryCheckpoint()
+{
+    auto cp = getRecoveryCheckpoint(app_.getWalletDB());
+    if (cp)
+    {
+        JLOG(m_journal.info())
+            << "Recovery checkpoint covers ledgers " << cp->minSeq << " to "
+            << cp->maxSeq << (cp->clean ? "" : " (unclean shutdown)");
+
+        // Until we stop cleanly, assume we did not
+        auto unclean = *cp;
+        unclean.clean = false;
+        setRecoveryCheckpoint(app_.getWalletDB(), unclean);
+    }
+
+    std::lock_guard ml(m_mutex);
+    recoveryStart_ = cp;
+    recoveryEnabled_ = true;
+}
+
+void
+LedgerMaster::saveCleanShutdown()
+{
+    if (!recoveryEnabled_)
+        return;
+
+    // If the ledgers after the last checkpoint are still being checked,
+    // leave the checkpoint marked unclean so they are checked next time
+    if (recoveryTailPending_ && !mLedgerCleaner->isIdle())
+        return;
+
+    boost::optional<RecoveryCheckpoint> cp;
+    if (auto const ledger = getValidatedLedger();
+        ledger && !app_.pendingSaves().pending(ledger->info().seq))
+    {
+        cp = makeRecoveryCheckpoint(*ledger, ledger->info().seq);
+    }
+
+    if (!cp)
+    {
+        // Keep the stored checkpoint, unless its tail was never checked
+        std::lock_guard ml(m_mutex);
+        if (recoveryStart_ && !recoveryStart_->clean)
+            return;
+        cp = getRecoveryCheckpoint(app_.getWalletDB());
+        if (!cp)
+            return;
+    }
+
+    cp->clean = true;
+    setRecoveryCheckpoint(app_.getWalletDB(), *cp);
+    JLOG(m_journal.info())
+        << "Saved recovery checkpoint to ledger " << cp->maxSeq;
+}
+
 /** Request a fetch pack to get to the specified ledger
  */
 void
@@ -1606,8 +1766,23 @@ LedgerMaster::walkHashBySeq(std::uint32_t index, InboundLedger::Reason reason)
     boost::optional<LedgerHash> ledgerHash;
 
     if (auto referenceLedger = mValidLedger.get())
+    {
+        if (referenceLedger->info().seq < index)
+            return ledgerHash;
+
+        // The hashes of validated ledgers are kept by sequence
+        if (auto const hash = mLedgerHistory.getLedgerHash(index);
+            hash.isNonZero())
+            return hash;
+
         ledgerHash = walkHashBySeq(index, referenceLedger, reason);
 
+        // Walking back from the validated ledger can take reading more
+        // ledgers, so keep what was found
+        if (ledgerHash)
+            mLedgerHistory.setLedgerHash(index, *ledgerHash);
+    }
+
     return ledgerHash;
 }
 
@@ -1675,6 +1850,11 @@ LedgerMaster::getLedgerBySeq(std::uint32_t index)
             if (valid->info().seq == index)
                 return valid;
 
+            // Finding the hash in the index saves reading skip lists
+            if (auto const hash = mLedgerHistory.getLedgerHash(index);
+                hash.isNonZero())
+                return mLedgerHistory.getLedgerByHash(hash);
+
             try
             {
                 auto const hash = hashOfSeq(*valid, index, m_journal);
@@ -1719,6 +1899,19 @@ LedgerMaster::doLedgerCleaner(Json::Value const& parameters)
     mLedgerCleaner->doClean(parameters);
 }
 
+void
+LedgerMaster::checkLedgerInBackground(
+    std::shared_ptr<Ledger const> const& ledger)
+{
+    mLedgerCleaner->checkLedger(ledger);
+}
+
+bool
+LedgerMaster::isLedgerCleanerIdle() const
+{
+    return mLedgerCleaner->isIdle();
+}
+
 void
 LedgerMaster::setLedgerRangePresent(std::uint32_t minV, std::uint32_t maxV)
 {
@@ -1739,6 +1932,12 @@ LedgerMaster::sweep()
     fetch_packs_.sweep();
 }
 
+void
+LedgerMaster::abandonCaches()
+{
+    mLedgerHistory.abandon();
+}
+
 float
 LedgerMaster::getCacheHitRate()
 {
@@ -1829,6 +2028,7 @@ LedgerMaster::fetchForHistory(
             else
             {
                 setFullLedger(ledger, false, false);
+                ++historyAcquired_;
                 int fillInProgress;
                 {
                     std::lock_guard lock(m_mutex);
@@ -1883,6 +2083,9 @@ LedgerMaster::fetchForHistory(
                 JLOG(m_journal.warn()) << "Threw while prefetching";
             }
         }
+
+        if (reason == InboundLedger::Reason::HISTORY && fillHistory(missing))
+            progress = true;
     }
     else
     {
@@ -1900,6 +2103,145 @@ LedgerMaster::fetchForHistory(
     }
 }
 
+bool
+LedgerMaster::fillHistory(std::uint32_t missing)
+{
+    auto constexpr reason = InboundLedger::Reason::HISTORY;
+    auto& inbound = app_.getInboundLedgers();
+    bool arrived = false;
+
+    try
+    {
+        // Take in the ledgers which have arrived and forget the ones which
+        // could not be acquired
+        std::map<std::uint32_t, uint256> seeds;
+        {
+            std::lock_guard lock(m_mutex);
+            seeds = historySeeds_;
+        }
+        for (auto const& [seq, hash] : seeds)
+        {
+            auto ledger = getLedgerByHash(hash);
+            if (!ledger && !inbound.isFailure(hash))
+            {
+                ledger = inbound.acquire(hash, seq, reason);
+                if (!ledger)
+                    continue;
+            }
+            if (ledger)
+            {
+                JLOG(m_journal.trace()) << "fillHistory acquired " << seq;
+                setFullLedger(ledger, false, false);
+                ++historyAcquired_;
+                arrived = true;
+            }
+            std::lock_guard lock(m_mutex);
+            historySeeds_.erase(seq);
+        }
+
+        // Start fewer ranges as the write load grows
+        auto const load = static_cast<std::size_t>(
+            std::max(app_.getNodeStore().getWriteLoad(), 0));
+        std::size_t wanted = 0;
+        if (load < history_write_load_)
+            wanted = (history_ranges_ - 1) * (history_write_load_ - load) /
+                history_write_load_;
+
+        std::size_t inFlight;
+        RangeSet<std::uint32_t> gaps;
+        {
+            std::lock_guard lock(m_mutex);
+            inFlight = historySeeds_.size();
+            if (inFlight >= wanted)
+                return arrived;
+
+            // The walk back from `missing` prefetches the ledgers just below
+            auto const earliest = app_.getNodeStore().earliestLedgerSeq();
+            if (missing < earliest + ledger_fetch_size_)
+                return arrived;
+            gaps.insert(range(earliest, missing - ledger_fetch_size_));
+            for (auto const& seed : historySeeds_)
+                gaps.erase(seed.first);
+        }
+        {
+            std::lock_guard lock(mCompleteLock);
+            gaps -= mCompleteLedgers;
+        }
+
+        // Start in the longest gaps, so each range is far from the others
+        std::vector<ClosedInterval<std::uint32_t>> longest(
+            gaps.begin(), gaps.end());
+        std::sort(
+            longest.begin(), longest.end(), [](auto const& a, auto const& b) {
+                return boost::icl::length(a) > boost::icl::length(b);
+            });
+
+        for (auto const& gap : longest)
+        {
+            if (inFlight >= wanted)
+                break;
+
+            // A long gap is split at a flag ledger, whose hash is in the
+            // skip list of every later ledger. A short one is walked back
+            // from its top.
+            auto seq = gap.upper();
+            if (boost::icl::length(gap) > 512)
+                seq = (gap.lower() + boost::icl::length(gap) / 2) & ~0xffu;
+
+            auto const hash = getLedgerHashForHistory(seq, reason);
+            if (!hash || inbound.isFailure(*hash))
+                continue;
+
+            JLOG(m_journal.debug()) << "fillHistory starting at " << seq;
+            {
+                std::lock_guard lock(m_mutex);
+                historySeeds_.emplace(seq, *hash);
+            }
+            ++inFlight;
+            inbound.acquire(*hash, seq, reason);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) << "Threw while filling history: " << e.what();
+    }
+
+    return arrived;
+}
+
+Json::Value
+LedgerMaster::getHistoryFillJson()
+{
+    Json::Value ret(Json::objectValue);
+    ret[jss::ranges] = static_cast<Json::UInt>(history_ranges_);
+    ret[jss::acquired] = std::to_string(historyAcquired_.load());
+
+    Json::Value& inFlight = (ret[jss::in_flight] = Json::arrayValue);
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto const& seed : historySeeds_)
+            inFlight.append(seed.first);
+    }
+
+    // The ledgers still missing from the history we want to keep
+    LedgerIndex const valid = mValidLedgerSeq;
+    auto const earliest = app_.getNodeStore().earliestLedgerSeq();
+    if (valid >= earliest && ledger_history_ != 0)
+    {
+        auto first = earliest;
+        if (valid - earliest >= ledger_history_)
+            first = valid - ledger_history_ + 1;
+        RangeSet<std::uint32_t> wanted{range(first, valid)};
+        {
+            std::lock_guard lock(mCompleteLock);
+            wanted -= mCompleteLedgers;
+        }
+        ret[jss::missing] = static_cast<Json::UInt>(boost::icl::length(wanted));
+    }
+
+    return ret;
+}
+
 // Try to publish ledgers, acquire missing ledgers
 void
 LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
@@ -1990,6 +2332,7 @@ LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
 
                 {
                     ScopedUnlock sul{sl};
+                    app_.getOrderBookDB().setup(ledger);
                     app_.getOPs().pubLedger(ledger);
                 }
             }
@@ -2033,15 +2376,120 @@ LedgerMaster::gotFetchPack(bool progress, std::uint32_t seq)
     }
 }
 
+namespace {
+
+/** Sends the objects of a fetch pack to a peer as they are added.
+
+    Each message holds up to FETCH_PACK_MESSAGE_OBJECTS objects and is sent
+    once it is full, so a pack covering several ledgers doesn't have to be
+    built in one piece. The bytes added count against both this pack's
+    limit and a budget shared by all the packs being built.
+*/
+class FetchPackStream
+{
+public:
+    FetchPackStream(
+        std::shared_ptr<Peer> peer,
+        protocol::TMGetObjectByHash const& request,
+        std::atomic<std::size_t>& budget)
+        : peer_(std::move(peer)), budget_(budget)
+    {
+        reply_.set_query(false);
+        if (request.has_seq())
+            reply_.set_seq(request.seq());
+        reply_.set_ledgerhash(request.ledgerhash());
+        reply_.set_type(protocol::TMGetObjectByHash::otFETCH_PACK);
+    }
+
+    ~FetchPackStream()
+    {
+        budget_ -= bytes_;
+    }
+
+    FetchPackStream(FetchPackStream const&) = delete;
+    FetchPackStream&
+    operator=(FetchPackStream const&) = delete;
+
+    void
+    add(uint256 const& hash,
+        void const* data,
+        std::size_t size,
+        LedgerIndex seq)
+    {
+        protocol::TMIndexedObject* obj = reply_.add_objects();
+        obj->set_hash(hash.data(), hash.size());
+        obj->set_data(data, size);
+        obj->set_ledgerseq(seq);
+
+        ++objects_;
+        bytes_ += size;
+        budget_ += size;
+
+        if (reply_.objects_size() >= FETCH_PACK_MESSAGE_OBJECTS)
+            flush();
+    }
+
+    /** Send the objects added since the last message. */
+    void
+    flush()
+    {
+        if (reply_.objects_size() == 0)
+            return;
+
+        peer_->send(std::make_shared<Message>(reply_, protocol::mtGET_OBJECTS));
+        ++messages_;
+        reply_.clear_objects();
+    }
+
+    /** Whether no more should be added to this pack. */
+    bool
+    full() const
+    {
+        return bytes_ >= FETCH_PACK_MAX_BYTES ||
+            budget_.load() >= FETCH_PACK_BUDGET;
+    }
+
+    std::size_t
+    objects() const
+    {
+        return objects_;
+    }
+
+    std::size_t
+    bytes() const
+    {
+        return bytes_;
+    }
+
+    std::size_t
+    messages() const
+    {
+        return messages_;
+    }
+
+private:
+    std::shared_ptr<Peer> const peer_;
+    std::atomic<std::size_t>& budget_;
+    protocol::TMGetObjectByHash reply_;
+    std::size_t objects_ = 0;
+    std::size_t bytes_ = 0;
+    std::size_t messages_ = 0;
+};
+
+}  // namespace
+
 /** Populate a fetch pack with data from the map the recipient wants.
 
     A recipient may or may not have the map that they are asking for. If
     they do, we can optimize the transfer by not including parts of the
     map that they are already have.
 
+    Only the nodes which differ from `have` are visited, so shared subtrees
+    are skipped without being walked.
+
     @param have The map that the recipient already has (if any).
     @param cnt The maximum number of nodes to return.
-    @param into The protocol object into which we add information.
+    @param into The stream to which we add information.
     @param seq The sequence number of the ledger the map is a part of.
     @param withLeaves True if leaf nodes should be included.
 
@@ -2063,7 +2511,7 @@ populateFetchPack(
     SHAMap const& want,
     SHAMap const* have,
     std::uint32_t cnt,
-    protocol::TMGetObjectByHash* into,
+    FetchPackStream& into,
     std::uint32_t seq,
     bool withLeaves = true)
 {
@@ -2073,21 +2521,17 @@ populateFetchPack(
 
     want.visitDifferences(
         have,
-        [&s, withLeaves, &cnt, into, seq](SHAMapTreeNode const& n) -> bool {
+        [&s, withLeaves, &cnt, &into, seq](SHAMapTreeNode const& n) -> bool {
             if (!withLeaves && n.isLeaf())
                 return true;
 
             s.erase();
             n.serializeWithPrefix(s);
 
-            auto const& hash = n.getHash().as_uint256();
-
-            protocol::TMIndexedObject* obj = into->add_objects();
-            obj->set_ledgerseq(seq);
-            obj->set_hash(hash.data(), hash.size());
-            obj->set_data(s.getDataPtr(), s.getLength());
+            into.add(
+                n.getHash().as_uint256(), s.getDataPtr(), s.getLength(), seq);
 
-            return --cnt != 0;
+            return --cnt != 0 && !into.full();
         });
 }
 
@@ -2155,65 +2599,53 @@ LedgerMaster::makeFetchPack(
     try
     {
         Serializer hdr(128);
-
-        protocol::TMGetObjectByHash reply;
-        reply.set_query(false);
-
-        if (request->has_seq())
-            reply.set_seq(request->seq());
-
-        reply.set_ledgerhash(request->ledgerhash());
-        reply.set_type(protocol::TMGetObjectByHash::otFETCH_PACK);
+        FetchPackStream stream(peer, *request, fetchPackBytes_);
 
         // Building a fetch pack:
         //  1. Add the header for the requested ledger.
-        //  2. Add the nodes for the AccountStateMap of that ledger.
+        //  2. Add the nodes for the AccountStateMap of that ledger which
+        //     differ from the ledger after it.
         //  3. If there are transactions, add the nodes for the
         //     transactions of the ledger.
-        //  4. If the FetchPack now contains at least 512 entries then stop.
+        //  4. If the pack or all the packs being built hold too many bytes
+        //     then stop.
         //  5. If not very much time has elapsed, then loop back and repeat
         //     the same process adding the previous ledger to the FetchPack.
+        // Objects are sent as they are added, several messages per pack.
+        std::size_t ledgers = 0;
         do
         {
             std::uint32_t lSeq = want->info().seq;
 
-            {
-                // Serialize the ledger header:
-                hdr.erase();
-
-                hdr.add32(HashPrefix::ledgerMaster);
-                addRaw(want->info(), hdr);
-
-                // Add the data
-                protocol::TMIndexedObject* obj = reply.add_objects();
-                obj->set_hash(
-                    want->info().hash.data(), want->info().hash.size());
-                obj->set_data(hdr.getDataPtr(), hdr.getLength());
-                obj->set_ledgerseq(lSeq);
-            }
+            // Serialize the ledger header:
+            hdr.erase();
+            hdr.add32(HashPrefix::ledgerMaster);
+            addRaw(want->info(), hdr);
+            stream.add(
+                want->info().hash, hdr.getDataPtr(), hdr.getLength(), lSeq);
 
             populateFetchPack(
-                want->stateMap(), &have->stateMap(), 16384, &reply, lSeq);
+                want->stateMap(), &have->stateMap(), 16384, stream, lSeq);
 
             // We use nullptr here because transaction maps are per ledger
             // and so the requestor is unlikely to already have it.
             if (want->info().txHash.isNonZero())
-                populateFetchPack(want->txMap(), nullptr, 512, &reply, lSeq);
+                populateFetchPack(want->txMap(), nullptr, 512, stream, lSeq);
 
-            if (reply.objects().size() >= 512)
+            ++ledgers;
+            if (stream.full())
                 break;
 
             have = std::move(want);
             want = getLedgerByHash(have->info().parentHash);
         } while (want && UptimeClock::now() <= uptime + 1s);
 
-        auto msg = std::make_shared<Message>(reply, protocol::mtGET_OBJECTS);
+        stream.flush();
 
         JLOG(m_journal.info())
-            << "Built fetch pack with " << reply.objects().size() << " nodes ("
-            << msg->getBufferSize() << " bytes)";
-
-        peer->send(msg);
+            << "Built fetch pack for " << ledgers << " ledgers with "
+            << stream.objects() << " nodes (" << stream.bytes() << " bytes in "
+            << stream.messages() << " messages)";
     }
     catch (std::exception const&)
     {
@@ -2232,7 +2664,7 @@ boost::optional<LedgerIndex>
 LedgerMaster::minSqlSeq()
 {
     boost::optional<LedgerIndex> seq;
-    auto db = app_.getLedgerDB().checkoutDb();
+    auto db = app_.getLedgerDB().checkoutReadDb();
     *db << "SELECT MIN(LedgerSeq) FROM Ledgers", soci::into(seq);
     return seq;
 }
@@ -24,11 +24,22 @@
 #include <ripple/rpc/DeliveredAmount.h>
 
 #include <date/date.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 
 namespace {
 
+// Below this many expanded transactions the threads cost more than they save
+constexpr std::size_t parallelRenderMinimum = 64;
+
+// The most threads used to render the transactions of a ledger
+constexpr unsigned int parallelRenderThreads = 4;
+
 bool
 isFull(LedgerFill const& fill)
 {
@@ -165,6 +176,60 @@ fillJsonTx(
     return txJson;
 }
 
+// Render the transactions of a closed ledger on several threads, each into
+// its own slot so the order is kept. Returns false if the ledger is too
+// small to be worth it.
+template <class Array>
+bool
+fillJsonTxParallel(Array& txns, LedgerFill const& fill, bool bBinary)
+{
+    auto const closed = dynamic_cast<Ledger const*>(&fill.ledger);
+    if (!closed)
+        return false;
+
+    std::vector<SHAMapItem const*> items;
+    for (auto const& item : closed->txMap())
+        items.push_back(&item);
+    if (items.size() < parallelRenderMinimum)
+        return false;
+
+    std::vector<Json::Value> rendered(items.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    // Like the serial loop, stop at the first transaction which fails
+    std::size_t failed = items.size();
+    auto worker = [&]() {
+        for (auto i = next++; i < items.size(); i = next++)
+        {
+            try
+            {
+                auto const [txn, meta] = deserializeTxPlusMeta(*items[i]);
+                rendered[i] = fillJsonTx(fill, bBinary, true, txn, meta);
+            }
+            catch (std::exception const&)
+            {
+                std::lock_guard lock(mutex);
+                failed = std::min(failed, i);
+            }
+        }
+    };
+
+    auto const threads = std::clamp(
+        std::thread::hardware_concurrency(), 1u, parallelRenderThreads);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+
+    for (std::size_t i = 0; i < failed; ++i)
+        txns.append(std::move(rendered[i]));
+    return true;
+}
+
 template <class Object>
 void
 fillJsonTx(Object& json, LedgerFill const& fill)
@@ -173,6 +238,9 @@ fillJsonTx(Object& json, LedgerFill const& fill)
     auto bBinary = isBinary(fill);
     auto bExpanded = isExpanded(fill);
 
+    if (bExpanded && fillJsonTxParallel(txns, fill, bBinary))
+        return;
+
     try
     {
         for (auto& i : fill.ledger.txs)
@@ -276,6 +344,18 @@ addJson(Json::Value& json, LedgerFill const& fill)
         fillJsonQueue(json, fill);
 }
 
+void
+addJson(Json::Object& json, LedgerFill const& fill)
+{
+    {
+        auto&& object = Json::addObject(json, jss::ledger);
+        fillJson(object, fill);
+    }
+
+    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
+        fillJsonQueue(json, fill);
+}
+
 Json::Value
 getJson(LedgerFill const& fill)
 {
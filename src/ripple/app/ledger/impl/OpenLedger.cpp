@@ -23,9 +23,8 @@
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/ledger/CachedView.h>
-#include <ripple/overlay/Message.h>
 #include <ripple/overlay/Overlay.h>
-#include <ripple/overlay/predicates.h>
+#include <ripple/overlay/Squelch.h>
 #include <ripple/protocol/Feature.h>
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -49,8 +48,7 @@ OpenLedger::empty() const
 std::shared_ptr<OpenView const>
 OpenLedger::current() const
 {
-    std::lock_guard lock(current_mutex_);
-    return current_;
+    return std::atomic_load(&current_);
 }
 
 bool
@@ -60,10 +58,8 @@ OpenLedger::modify(modify_type const& f)
     auto next = std::make_shared<OpenView>(*current_);
     auto const changed = f(*next, j_);
     if (changed)
-    {
-        std::lock_guard lock2(current_mutex_);
-        current_ = std::move(next);
-    }
+        std::atomic_store(
+            &current_, std::shared_ptr<OpenView const>{std::move(next)});
     return changed;
 }
 
@@ -150,15 +146,14 @@ OpenLedger::accept(
             msg.set_status(protocol::tsNEW);
             msg.set_receivetimestamp(
                 app.timeKeeper().now().time_since_epoch().count());
-            app.overlay().foreach(send_if_not(
-                std::make_shared<Message>(msg, protocol::mtTRANSACTION),
-                peer_in_set(*toSkip)));
+            app.overlay().relay(
+                msg, txId, *toSkip, squelch::transactionSource(*tx));
         }
     }
 
     // Switch to the new open view
-    std::lock_guard lock2(current_mutex_);
-    current_ = std::move(next);
+    std::atomic_store(
+        &current_, std::shared_ptr<OpenView const>{std::move(next)});
 }
 
 //------------------------------------------------------------------------------
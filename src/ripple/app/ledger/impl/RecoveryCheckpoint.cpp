@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/RecoveryCheckpoint.h>
+#include <ripple/core/DatabaseCon.h>
+
+namespace ripple {
+
+boost::optional<RecoveryCheckpoint>
+getRecoveryCheckpoint(DatabaseCon& walletDB)
+{
+    auto db = walletDB.checkoutDb();
+
+    boost::optional<std::uint64_t> minSeq;
+    boost::optional<std::uint64_t> maxSeq;
+    boost::optional<std::string> maxHash;
+    boost::optional<int> clean;
+    *db << "SELECT MinLedgerSeq, MaxLedgerSeq, MaxLedgerHash, CleanShutdown "
+           "FROM RecoveryCheckpoint;",
+        soci::into(minSeq), soci::into(maxSeq), soci::into(maxHash),
+        soci::into(clean);
+
+    if (!minSeq || !maxSeq || !maxHash || *minSeq > *maxSeq)
+        return boost::none;
+
+    RecoveryCheckpoint cp;
+    if (!cp.maxHash.parseHex(*maxHash))
+        return boost::none;
+    cp.minSeq = rangeCheckedCast<LedgerIndex>(*minSeq);
+    cp.maxSeq = rangeCheckedCast<LedgerIndex>(*maxSeq);
+    cp.clean = clean.value_or(0) != 0;
+    return cp;
+}
+
+void
+setRecoveryCheckpoint(DatabaseCon& walletDB, RecoveryCheckpoint const& cp)
+{
+    auto db = walletDB.checkoutDb();
+
+    soci::transaction tr(*db);
+    *db << "DELETE FROM RecoveryCheckpoint;";
+    *db << "INSERT INTO RecoveryCheckpoint "
+           "(MinLedgerSeq, MaxLedgerSeq, MaxLedgerHash, CleanShutdown) "
+           "VALUES (:min, :max, :hash, :clean);",
+        soci::use(cp.minSeq), soci::use(cp.maxSeq),
+        soci::use(to_string(cp.maxHash)), soci::use(cp.clean ? 1 : 0);
+    tr.commit();
+}
+
+}  // namespace ripple
@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/ledger/ReplayBenchmark.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/basics/MemoryUsage.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/TxFormats.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+
+namespace ripple {
+
+namespace {
+
+struct TxTimes
+{
+    std::size_t count = 0;
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration max{};
+};
+
+double
+toMicroseconds(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+std::shared_ptr<Ledger const>
+findLedger(Application& app, LedgerIndex seq)
+{
+    if (auto ledger = app.getLedgerMaster().getLedgerBySeq(seq))
+        return ledger;
+    return loadByIndex(seq, app, false);
+}
+
+}  // namespace
+
+boost::optional<std::pair<LedgerIndex, LedgerIndex>>
+parseLedgerRange(std::string const& range)
+{
+    auto const dash = range.find('-');
+    if (dash == std::string::npos)
+        return boost::none;
+
+    LedgerIndex first;
+    LedgerIndex last;
+    if (!beast::lexicalCastChecked(first, range.substr(0, dash)) ||
+        !beast::lexicalCastChecked(last, range.substr(dash + 1)))
+        return boost::none;
+
+    // The first ledger has no parent to replay it from
+    if (first < 2 || last < first)
+        return boost::none;
+    return std::make_pair(first, last);
+}
+
+bool
+replayBenchmark(
+    Application& app,
+    LedgerIndex first,
+    LedgerIndex last,
+    std::ostream& out)
+{
+    auto const j = app.journal("ReplayBenchmark");
+    auto const memoryBefore = MemoryUsage::report();
+
+    std::map<std::string, TxTimes> txTimes;
+    auto const onApply = [&txTimes](
+                             STTx const& tx,
+                             std::chrono::steady_clock::duration elapsed) {
+        auto const format =
+            TxFormats::getInstance().findByType(tx.getTxnType());
+        auto& times = txTimes[format ? format->getName() : "Unknown"];
+        ++times.count;
+        times.total += elapsed;
+        times.max = std::max(times.max, elapsed);
+    };
+
+    bool ok = true;
+    std::size_t built = 0;
+    std::chrono::steady_clock::duration totalTime{};
+
+    out << std::fixed << std::setprecision(3);
+    auto parent = findLedger(app, first - 1);
+    for (auto seq = first; seq <= last; ++seq)
+    {
+        auto const replay = findLedger(app, seq);
+        if (!parent || !replay)
+        {
+            out << "ledger " << (parent ? seq : seq - 1) << ": not found\n";
+            ok = false;
+            break;
+        }
+
+        try
+        {
+            LedgerReplay const replayData(parent, replay);
+            auto const start = std::chrono::steady_clock::now();
+            auto const ledger =
+                buildLedger(replayData, tapNONE, app, j, onApply);
+            auto const elapsed = std::chrono::steady_clock::now() - start;
+
+            auto const match = ledger->info().hash == replay->info().hash;
+            out << "ledger " << seq << ": "
+                << replayData.orderedTxns().size() << " txs in "
+                << toMicroseconds(elapsed) / 1000 << " ms, "
+                << (match ? "hash matches" : "HASH MISMATCH") << "\n";
+
+            if (!match)
+            {
+                JLOG(j.warn()) << "Replay of " << seq << " built "
+                               << ledger->info().hash << " not "
+                               << replay->info().hash;
+                ok = false;
+            }
+            ++built;
+            totalTime += elapsed;
+        }
+        catch (std::exception const& e)
+        {
+            out << "ledger " << seq << ": replay failed: " << e.what()
+                << "\n";
+            ok = false;
+        }
+
+        // Each ledger is the parent of the next one
+        parent = replay;
+    }
+
+    if (built != 0)
+    {
+        out << "\n"
+            << built << " ledgers in " << toMicroseconds(totalTime) / 1000
+            << " ms, " << toMicroseconds(totalTime) / built / 1000
+            << " ms each\n";
+    }
+
+    if (!txTimes.empty())
+    {
+        out << "\n"
+            << std::left << std::setw(24) << "transaction" << std::right
+            << std::setw(10) << "count" << std::setw(14) << "total us"
+            << std::setw(12) << "mean us" << std::setw(12) << "max us"
+            << "\n";
+        for (auto const& [name, times] : txTimes)
+        {
+            out << std::left << std::setw(24) << name << std::right
+                << std::setw(10) << times.count << std::setw(14)
+                << toMicroseconds(times.total) << std::setw(12)
+                << toMicroseconds(times.total) / times.count
+                << std::setw(12) << toMicroseconds(times.max) << "\n";
+        }
+    }
+
+    auto const memoryAfter = MemoryUsage::report();
+    out << "\n"
+        << std::left << std::setw(24) << "memory" << std::right
+        << std::setw(16) << "bytes" << std::setw(16) << "change"
+        << std::setw(16) << "allocations"
+        << "\n";
+    for (std::size_t i = 0;
+         i < std::min(memoryBefore.size(), memoryAfter.size());
+         ++i)
+    {
+        auto const& before = memoryBefore[i];
+        auto const& after = memoryAfter[i];
+        out << std::left << std::setw(24) << after.name << std::right
+            << std::setw(16) << after.bytes << std::setw(16)
+            << after.bytes - before.bytes << std::setw(16)
+            << after.allocations - before.allocations << "\n";
+    }
+
+    return ok;
+}
+
+}  // namespace ripple
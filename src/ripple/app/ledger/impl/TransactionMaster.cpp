@@ -158,7 +158,7 @@ TransactionMaster::sweep(void)
     mCache.sweep();
 }
 
-TaggedCache<uint256, Transaction>&
+PartitionedTaggedCache<uint256, Transaction>&
 TransactionMaster::getCache()
 {
     return mCache;
@@ -38,14 +38,23 @@
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/SHAMapStore.h>
+#include <ripple/app/misc/TxIndex.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorSite.h>
+#include <ripple/app/misc/WarmStart.h>
 #include <ripple/app/paths/PathRequests.h>
+#include <ripple/app/rdb/RelationalDBInterface.h>
+#include <ripple/app/reporting/ReportingETL.h>
+#include <ripple/app/tx/SignerListCache.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/CacheBudget.h>
+#include <ripple/basics/HugePages.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/ResolverAsio.h>
+#include <ripple/basics/SystemMemory.h>
 #include <ripple/basics/safe_cast.h>
 #include <ripple/beast/asio/io_latency_probe.h>
 #include <ripple/beast/core/LexicalCast.h>
@@ -62,8 +71,12 @@
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/IssuerBalances.h>
+#include <ripple/rpc/ResponseCache.h>
 #include <ripple/rpc/ShardArchiveHandler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <ripple/shamap/HistoryFamily.h>
 #include <ripple/shamap/NodeFamily.h>
 #include <ripple/shamap/ShardFamily.h>
 
@@ -146,6 +159,50 @@ private:
         }
     };
 
+    // Reports the bytes held under each memory tag and the rate at which
+    // they are allocated.
+    class memory_stats
+    {
+    private:
+        struct Tag
+        {
+            beast::insight::Gauge bytes;
+            beast::insight::Meter allocations;
+            std::uint64_t lastAllocations;
+        };
+
+        std::vector<Tag> tags_;
+        beast::insight::Hook hook_;
+
+    public:
+        explicit memory_stats(beast::insight::Collector::ptr const& collector)
+        {
+            for (auto const& entry : MemoryUsage::report())
+            {
+                std::string const name(entry.name);
+                tags_.push_back(
+                    {collector->make_gauge("memory", name + "_bytes"),
+                     collector->make_meter("memory", name + "_allocations"),
+                     entry.allocations});
+            }
+            hook_ = collector->make_hook([this] { sample(); });
+        }
+
+    private:
+        void
+        sample()
+        {
+            auto const usage = MemoryUsage::report();
+            for (std::size_t i = 0; i < tags_.size(); ++i)
+            {
+                auto& tag = tags_[i];
+                tag.bytes = std::max<std::int64_t>(usage[i].bytes, 0);
+                tag.allocations += usage[i].allocations - tag.lastAllocations;
+                tag.lastAllocations = usage[i].allocations;
+            }
+        }
+    };
+
 public:
     std::unique_ptr<Config> config_;
     std::unique_ptr<Logs> logs_;
@@ -168,6 +225,9 @@ public:
     NodeCache m_tempNodeCache;
     std::unique_ptr<CollectorManager> m_collectorManager;
     CachedSLEs cachedSLEs_;
+    SignerListCache signerListCache_;
+    RPC::ResponseCache responseCache_;
+    RPC::IssuerBalances issuerBalances_;
     std::pair<PublicKey, SecretKey> nodeIdentity_;
     ValidatorKeys const validatorKeys_;
 
@@ -179,6 +239,7 @@ public:
     NodeFamily nodeFamily_;
     std::unique_ptr<NodeStore::DatabaseShard> shardStore_;
     std::unique_ptr<ShardFamily> shardFamily_;
+    std::unique_ptr<HistoryFamily> historyFamily_;
     std::unique_ptr<RPC::ShardArchiveHandler> shardArchiveHandler_;
     // VFALCO TODO Make OrderBookDB abstract
     OrderBookDB m_orderBookDB;
@@ -187,6 +248,7 @@ public:
     std::unique_ptr<InboundLedgers> m_inboundLedgers;
     std::unique_ptr<InboundTransactions> m_inboundTransactions;
     TaggedCache<uint256, AcceptedLedger> m_acceptedLedgerCache;
+    std::unique_ptr<CacheBudget> cacheBudget_;
     std::unique_ptr<NetworkOPs> m_networkOPs;
     std::unique_ptr<Cluster> cluster_;
     std::unique_ptr<PeerReservationTable> peerReservations_;
@@ -205,10 +267,13 @@ public:
     boost::asio::steady_timer sweepTimer_;
     boost::asio::steady_timer entropyTimer_;
     bool startTimers_;
+    std::chrono::steady_clock::time_point nextWarmStartSave_;
 
     std::unique_ptr<DatabaseCon> mTxnDB;
     std::unique_ptr<DatabaseCon> mLedgerDB;
     std::unique_ptr<DatabaseCon> mWalletDB;
+    std::unique_ptr<RelationalDBInterface> relationalDB_;
+    std::unique_ptr<TxIndex> txIndex_;
     std::unique_ptr<Overlay> overlay_;
     std::vector<std::unique_ptr<Stoppable>> websocketServers_;
 
@@ -224,13 +289,23 @@ public:
 
     io_latency_sampler m_io_latency_sampler;
 
+    // Only for the io_services which have threads of their own
+    std::unique_ptr<io_latency_sampler> m_overlay_latency_sampler;
+    std::unique_ptr<io_latency_sampler> m_server_latency_sampler;
+
+    memory_stats m_memoryStats;
+
     std::unique_ptr<GRPCServer> grpcServer_;
+    std::unique_ptr<ReportingETL> reportingETL_;
 
     //--------------------------------------------------------------------------
 
     static std::size_t
     numberOfThreads(Config const& config)
     {
+        if (config.IO_THREADS_INTERNAL != 0)
+            return config.IO_THREADS_INTERNAL;
+
 #if RIPPLE_SINGLE_IO_SERVICE_THREAD
         return 1;
 #else
@@ -246,6 +321,28 @@ public:
 #endif
     }
 
+    std::unique_ptr<io_latency_sampler>
+    makeLatencySampler(std::string const& name, boost::asio::io_service& ios)
+    {
+        return std::make_unique<io_latency_sampler>(
+            m_collectorManager->collector()->make_event(name),
+            logs_->journal("Application"),
+            std::chrono::milliseconds(100),
+            ios);
+    }
+
+    // Calls f for each latency sampler
+    template <class F>
+    void
+    forEachLatencySampler(F&& f)
+    {
+        f(m_io_latency_sampler);
+        if (m_overlay_latency_sampler)
+            f(*m_overlay_latency_sampler);
+        if (m_server_latency_sampler)
+            f(*m_server_latency_sampler);
+    }
+
     //--------------------------------------------------------------------------
 
     ApplicationImp(
@@ -253,7 +350,11 @@ public:
         std::unique_ptr<Logs> logs,
         std::unique_ptr<TimeKeeper> timeKeeper)
         : RootStoppable("Application")
-        , BasicApp(numberOfThreads(*config))
+        , BasicApp(
+              numberOfThreads(*config),
+              config->IO_AFFINITY,
+              config->IO_THREADS_OVERLAY,
+              config->IO_THREADS_SERVER)
         , config_(std::move(config))
         , logs_(std::move(logs))
         , timeKeeper_(std::move(timeKeeper))
@@ -291,6 +392,9 @@ public:
               config_->section(SECTION_INSIGHT),
               logs_->journal("Collector")))
         , cachedSLEs_(std::chrono::minutes(1), stopwatch())
+        , signerListCache_(stopwatch(), logs_->journal("TaggedCache"))
+        , responseCache_(config_->RPC_CACHE_SIZE)
+        , issuerBalances_(RPC::Tuning::maxIssuerBalances)
         , validatorKeys_(*config_, m_journal)
 
         , m_resourceManager(Resource::make_Manager(
@@ -395,7 +499,8 @@ public:
         , serverHandler_(make_ServerHandler(
               *this,
               *m_networkOPs,
-              get_io_service(),
+              get_server_io_service(),
+              get_overlay_io_service(),
               *m_jobQueue,
               *m_networkOPs,
               *m_resourceManager,
@@ -439,6 +544,17 @@ public:
               logs_->journal("Application"),
               std::chrono::milliseconds(100),
               get_io_service())
+        , m_overlay_latency_sampler(
+              has_overlay_io_service() ? makeLatencySampler(
+                                             "ios_latency_overlay",
+                                             get_overlay_io_service())
+                                       : nullptr)
+        , m_server_latency_sampler(
+              has_server_io_service() ? makeLatencySampler(
+                                            "ios_latency_server",
+                                            get_server_io_service())
+                                      : nullptr)
+        , m_memoryStats(m_collectorManager->collector())
         , grpcServer_(std::make_unique<GRPCServer>(*this, *m_jobQueue))
     {
         add(m_resourceManager.get());
@@ -458,8 +574,12 @@ public:
         //  started in this constructor.
         //
 
+        perfLog_->setCollector(m_collectorManager->group("rpc"));
+
         // VFALCO HACK
         m_nodeStoreScheduler.setJobQueue(*m_jobQueue);
+        m_nodeStoreScheduler.setCollector(
+            m_collectorManager->group("nodestore"));
 
         add(m_ledgerMaster->getPropertySource());
     }
@@ -517,6 +637,13 @@ public:
         return shardFamily_.get();
     }
 
+    // Only when RPC requests may read old ledgers through from peers
+    HistoryFamily*
+    getHistoryFamily() override
+    {
+        return historyFamily_.get();
+    }
+
     TimeKeeper&
     timeKeeper() override
     {
@@ -556,7 +683,13 @@ public:
     std::chrono::milliseconds
     getIOLatency() override
     {
-        return m_io_latency_sampler.get();
+        // The worst of the io_services, since any of them falling behind
+        // means the server is overloaded
+        std::chrono::milliseconds latency{0};
+        forEachLatencySampler([&latency](io_latency_sampler const& s) {
+            latency = std::max(latency, s.get());
+        });
+        return latency;
     }
 
     LedgerMaster&
@@ -583,6 +716,12 @@ public:
         return m_acceptedLedgerCache;
     }
 
+    CacheBudget*
+    getCacheBudget() override
+    {
+        return cacheBudget_.get();
+    }
+
     void
     gotTXSet(std::shared_ptr<SHAMap> const& set, bool fromAcquire)
     {
@@ -716,6 +855,24 @@ public:
         return cachedSLEs_;
     }
 
+    SignerListCache&
+    getSignerListCache() override
+    {
+        return signerListCache_;
+    }
+
+    RPC::ResponseCache&
+    getResponseCache() override
+    {
+        return responseCache_;
+    }
+
+    RPC::IssuerBalances&
+    getIssuerBalances() override
+    {
+        return issuerBalances_;
+    }
+
     AmendmentTable&
     getAmendmentTable() override
     {
@@ -832,6 +989,18 @@ public:
         assert(mLedgerDB.get() != nullptr);
         return *mLedgerDB;
     }
+    RelationalDBInterface&
+    getRelationalDBInterface() override
+    {
+        assert(relationalDB_.get() != nullptr);
+        return *relationalDB_;
+    }
+
+    TxIndex*
+    getTxIndex() override
+    {
+        return txIndex_.get();
+    }
     DatabaseCon&
     getWalletDB() override
     {
@@ -900,6 +1069,9 @@ public:
                 }
             }
 
+            relationalDB_ = makeRelationalDBInterfaceSqlite(
+                *mTxnDB, accountIDCache(), logs_->journal("RelationalDB"));
+
             // ledger database
             mLedgerDB = std::make_unique<DatabaseCon>(
                 setup,
@@ -913,6 +1085,7 @@ public:
 
             // wallet database
             setup.useGlobalPragma = false;
+            setup.readSessions = 0;
             mWalletDB = std::make_unique<DatabaseCon>(
                 setup,
                 WalletDBName,
@@ -972,9 +1145,41 @@ public:
             config_->getValueFor(SizedItem::ledgerSize),
             seconds{config_->getValueFor(SizedItem::ledgerAge)});
 
+        if (config_->CACHE_BUDGET_MB != 0)
+        {
+            cacheBudget_ = std::make_unique<CacheBudget>(
+                config_->CACHE_BUDGET_MB * 1024 * 1024,
+                logs_->journal("CacheBudget"));
+            cacheBudget_->add("treenode", *nodeFamily_.getTreeNodeCache(0));
+            if (auto const cache = m_nodeStore->getObjectCache())
+                cacheBudget_->add("node", *cache);
+            if (shardStore_)
+            {
+                if (auto const cache = shardStore_->getObjectCache())
+                    cacheBudget_->add("shard_node", *cache);
+            }
+            cacheBudget_->add("transaction", getMasterTransaction().getCache());
+        }
+
+        if (auto const file = warmStartFile())
+        {
+            loadWarmStart(*this, *file);
+            nextWarmStartSave_ = steady_clock::now() + warmStartSaveInterval;
+        }
+
         return true;
     }
 
+    // The file the hot keys are kept in, if warm starts are enabled
+    boost::optional<boost::filesystem::path>
+    warmStartFile() const
+    {
+        auto const dir = config_->legacy("database_path");
+        if (config_->WARM_START_KEYS == 0 || dir.empty())
+            return boost::none;
+        return boost::filesystem::path(dir) / "warm_start";
+    }
+
     //--------------------------------------------------------------------------
     //
     // Stoppable
@@ -998,7 +1203,7 @@ public:
             setEntropyTimer();
         }
 
-        m_io_latency_sampler.start();
+        forEachLatencySampler([](io_latency_sampler& s) { s.start(); });
 
         m_resolver->start();
     }
@@ -1009,7 +1214,8 @@ public:
     {
         JLOG(m_journal.debug()) << "Application stopping";
 
-        m_io_latency_sampler.cancel_async();
+        forEachLatencySampler(
+            [](io_latency_sampler& s) { s.cancel_async(); });
 
         // VFALCO Enormous hack, we have to force the probe to cancel
         //        before we stop the io_service queue or else it never
@@ -1017,7 +1223,7 @@ public:
         //        io_objects gracefully handle exit so that we can
         //        naturally return from io_service::run() instead of
         //        forcing a call to io_service::stop()
-        m_io_latency_sampler.cancel();
+        forEachLatencySampler([](io_latency_sampler& s) { s.cancel(); });
 
         m_resolver->stop_async();
 
@@ -1051,6 +1257,9 @@ public:
 
         mValidations.flush();
 
+        if (auto const file = warmStartFile())
+            saveWarmStart(*this, *file, config_->WARM_START_KEYS);
+
         validatorSites_->stop();
 
         // TODO Store manifests in manifests.sqlite instead of wallet.db
@@ -1212,9 +1421,35 @@ public:
         // VFALCO TODO fix the dependency inversion using an observer,
         //         have listeners register for "onSweep ()" notification.
 
+        if (auto const file = warmStartFile();
+            file && std::chrono::steady_clock::now() >= nextWarmStartSave_)
+        {
+            saveWarmStart(*this, *file, config_->WARM_START_KEYS);
+            nextWarmStartSave_ =
+                std::chrono::steady_clock::now() + warmStartSaveInterval;
+        }
+
+        if (cacheBudget_ && config_->NODE_SIZE_AUTO)
+        {
+            // Give memory back before the system starts swapping, and
+            // take it again once there is plenty to spare
+            if (auto const memory = getSystemMemory())
+            {
+                if (memory->available < memory->total / 10)
+                    cacheBudget_->adjust(true);
+                else if (memory->available > memory->total / 5)
+                    cacheBudget_->adjust(false);
+            }
+        }
+
+        if (cacheBudget_)
+            cacheBudget_->rebalance();
+
         nodeFamily_.sweep();
         if (shardFamily_)
             shardFamily_->sweep();
+        if (historyFamily_)
+            historyFamily_->sweep();
         getMasterTransaction().sweep();
         getNodeStore().sweep();
         if (shardStore_)
@@ -1225,6 +1460,7 @@ public:
         getInboundLedgers().sweep();
         m_acceptedLedgerCache.sweep();
         cachedSLEs_.expire();
+        signerListCache_.sweep();
 
         // Set timer to do another sweep later.
         setSweepTimer();
@@ -1247,6 +1483,9 @@ private:
     void
     startGenesisLedger();
 
+    void
+    startReportingLedger();
+
     std::shared_ptr<Ledger>
     getLastFullLedger();
 
@@ -1316,7 +1555,15 @@ ApplicationImp::setup()
     // Optionally turn off logging to console.
     logs_->silent(config_->silent());
 
+    if (config_->LOG_QUEUE != 0)
+        logs_->async(config_->LOG_QUEUE);
+
+    setHugePageMode(config_->HUGE_PAGES);
+    m_jobQueue->setThreadAffinity(config_->JOB_QUEUE_AFFINITY);
+    m_jobQueue->setDeadlines(config_->JOB_DEADLINES);
     m_jobQueue->setThreadCount(config_->WORKERS, config_->standalone());
+    if (!config_->standalone())
+        m_jobQueue->setConsensusThreadCount(config_->CONSENSUS_THREADS);
 
     if (!config_->standalone())
         timeKeeper_->run(config_->SNTP_SERVERS);
@@ -1324,6 +1571,25 @@ ApplicationImp::setup()
     if (!initSQLiteDBs() || !initNodeStore())
         return false;
 
+    if (config_->exists(SECTION_TX_INDEX))
+    {
+        try
+        {
+            txIndex_ = std::make_unique<TxIndex>(
+                config_->section(SECTION_TX_INDEX),
+                megabytes(
+                    config_->getValueFor(SizedItem::burstSize, boost::none)),
+                m_nodeStoreScheduler,
+                logs_->journal("TxIndex"));
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(m_journal.fatal())
+                << "Unable to open the transaction index: " << e.what();
+            return false;
+        }
+    }
+
     if (shardStore_)
     {
         shardFamily_ =
@@ -1333,12 +1599,21 @@ ApplicationImp::setup()
             return false;
     }
 
+    if (config_->LEDGER_FETCH_RPC_HISTORY && !config_->standalone())
+    {
+        historyFamily_ =
+            std::make_unique<HistoryFamily>(*this, *m_collectorManager);
+    }
+
     if (!peerReservations_->load(getWalletDB()))
     {
         JLOG(m_journal.fatal()) << "Cannot find peer reservations!";
         return false;
     }
 
+    if (!config_->standalone() && !config_->reporting())
+        m_ledgerMaster->loadRecoveryCheckpoint();
+
     if (validatorKeys_.publicKey.size())
         setMaxDisallowedLedger();
 
@@ -1370,7 +1645,12 @@ ApplicationImp::setup()
     Pathfinder::initPathTable();
 
     auto const startUp = config_->START_UP;
-    if (startUp == Config::FRESH)
+    if (config_->reporting())
+    {
+        // The ledgers come from the source
+        startReportingLedger();
+    }
+    else if (startUp == Config::FRESH)
     {
         JLOG(m_journal.info()) << "Starting new Ledger";
 
@@ -1470,7 +1750,7 @@ ApplicationImp::setup()
         *serverHandler_,
         *m_resourceManager,
         *m_resolver,
-        get_io_service(),
+        get_overlay_io_service(),
         *config_,
         m_collectorManager->collector());
     add(*overlay_);  // add to PropertyStream
@@ -1485,7 +1765,8 @@ ApplicationImp::setup()
     validatorSites_->start();
 
     // start first consensus round
-    if (!m_networkOPs->beginConsensus(
+    if (!config_->reporting() &&
+        !m_networkOPs->beginConsensus(
             m_ledgerMaster->getClosedLedger()->info().hash))
     {
         JLOG(m_journal.fatal()) << "Unable to start consensus";
@@ -1512,8 +1793,23 @@ ApplicationImp::setup()
         }
     }
 
+    if (config_->reporting())
+    {
+        try
+        {
+            reportingETL_ = std::make_unique<ReportingETL>(*this, *m_jobQueue);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(m_journal.fatal())
+                << "Unable to start reporting: " << e.what();
+            return false;
+        }
+
+        JLOG(m_journal.warn()) << "Running in reporting mode";
+    }
     // Begin connecting to network.
-    if (!config_->standalone())
+    else if (!config_->standalone())
     {
         // Should this message be here, conceptually? In theory this sort
         // of message, if displayed, should be displayed from PeerFinder.
@@ -1643,7 +1939,8 @@ ApplicationImp::doStart(bool withTimers)
 void
 ApplicationImp::run()
 {
-    if (!config_->standalone())
+    // Nothing resets the deadlock detector without the state timer
+    if (!config_->standalone() && !config_->reporting())
     {
         // VFALCO NOTE This seems unnecessary. If we properly refactor the load
         //             manager then the deadlock detector can just always be
@@ -1661,6 +1958,23 @@ ApplicationImp::run()
     // Stoppable objects should be stopped.
     JLOG(m_journal.info()) << "Received shutdown request";
     stop(m_journal);
+
+    // The node store has been flushed, so all the history we have is on
+    // disk and need not be checked on the next start
+    m_ledgerMaster->saveCleanShutdown();
+
+    if (config_->FAST_SHUTDOWN)
+    {
+        // Everything has stopped, so nothing will look at the caches
+        // again. Most of the memory they hold is ledger trees, which take
+        // far longer to free node by node than the process takes to exit.
+        JLOG(m_journal.info()) << "Abandoning caches";
+        nodeFamily_.getTreeNodeCache(0)->abandon();
+        if (auto const cache = m_nodeStore->getObjectCache())
+            cache->abandon();
+        getMasterTransaction().getCache().abandon();
+        m_ledgerMaster->abandonCaches();
+    }
     JLOG(m_journal.info()) << "Done.";
 }
 
@@ -1744,6 +2058,27 @@ ApplicationImp::startGenesisLedger()
     m_ledgerMaster->switchLCL(next);
 }
 
+void
+ApplicationImp::startReportingLedger()
+{
+    // Resume from the newest ledger saved by a previous run
+    if (auto const ledger = getLastFullLedger())
+    {
+        JLOG(m_journal.info())
+            << "Resuming from ledger " << ledger->info().seq;
+        m_ledgerMaster->storeLedger(ledger);
+        openLedger_.emplace(ledger, cachedSLEs_, logs_->journal("OpenLedger"));
+        m_ledgerMaster->switchLCL(ledger);
+        return;
+    }
+
+    // Until the first ledger is downloaded the open ledger is built on the
+    // genesis ledger, which is not accepted as validated
+    auto const genesis = std::make_shared<Ledger>(
+        create_genesis, *config_, std::vector<uint256>{}, nodeFamily_);
+    openLedger_.emplace(genesis, cachedSLEs_, logs_->journal("OpenLedger"));
+}
+
 std::shared_ptr<Ledger>
 ApplicationImp::getLastFullLedger()
 {
@@ -2035,7 +2370,11 @@ ApplicationImp::loadOldLedger(
             return false;
         }
 
-        if (!loadLedger->walkLedger(journal("Ledger")))
+        // Reading every node of a large ledger takes a long time. When
+        // asked to, trust the saved ledger and let the ledger cleaner check
+        // it once we are running, fetching any nodes it finds missing.
+        if (!config_->LAZY_LEDGER_LOAD &&
+            !loadLedger->walkLedger(journal("Ledger")))
         {
             JLOG(m_journal.fatal()) << "Ledger is missing nodes.";
             assert(false);
@@ -2058,6 +2397,16 @@ ApplicationImp::loadOldLedger(
         openLedger_.emplace(
             loadLedger, cachedSLEs_, logs_->journal("OpenLedger"));
 
+        if (config_->LAZY_LEDGER_LOAD)
+        {
+            JLOG(m_journal.info()) << "Checking ledger "
+                                   << loadLedger->info().seq
+                                   << " in the background";
+            // The server may never sync with the network, so the check
+            // can't wait for a validated ledger to find the hash from
+            m_ledgerMaster->checkLedgerInBackground(loadLedger);
+        }
+
         if (replay)
         {
             // inject transaction(s) from the replayLedger into our open ledger
@@ -47,14 +47,18 @@ namespace perf {
 class PerfLog;
 }
 namespace RPC {
+class IssuerBalances;
+class ResponseCache;
 class ShardArchiveHandler;
-}
+}  // namespace RPC
 
 // VFALCO TODO Fix forward declares required for header dependency loops
 class AmendmentTable;
+class CacheBudget;
 class CachedSLEs;
 class CollectorManager;
 class Family;
+class HistoryFamily;
 class HashRouter;
 class Logs;
 class LoadFeeTrack;
@@ -73,11 +77,14 @@ class Overlay;
 class PathRequests;
 class PendingSaves;
 class PublicKey;
+class RelationalDBInterface;
 class SecretKey;
+class SignerListCache;
 class AccountIDCache;
 class STLedgerEntry;
 class TimeKeeper;
 class TransactionMaster;
+class TxIndex;
 class TxQ;
 
 class ValidatorList;
@@ -150,6 +157,8 @@ public:
     getNodeFamily() = 0;
     virtual Family*
     getShardFamily() = 0;
+    virtual HistoryFamily*
+    getHistoryFamily() = 0;
     virtual TimeKeeper&
     timeKeeper() = 0;
     virtual JobQueue&
@@ -158,6 +167,8 @@ public:
     getTempNodeCache() = 0;
     virtual CachedSLEs&
     cachedSLEs() = 0;
+    virtual SignerListCache&
+    getSignerListCache() = 0;
     virtual AmendmentTable&
     getAmendmentTable() = 0;
     virtual HashRouter&
@@ -198,6 +209,11 @@ public:
     virtual TaggedCache<uint256, AcceptedLedger>&
     getAcceptedLedgerCache() = 0;
 
+    /** The memory budget shared by the largest caches, or nullptr if the
+        caches are sized by entries alone. */
+    virtual CacheBudget*
+    getCacheBudget() = 0;
+
     virtual LedgerMaster&
     getLedgerMaster() = 0;
     virtual NetworkOPs&
@@ -208,6 +224,10 @@ public:
     getMasterTransaction() = 0;
     virtual perf::PerfLog&
     getPerfLog() = 0;
+    virtual RPC::ResponseCache&
+    getResponseCache() = 0;
+    virtual RPC::IssuerBalances&
+    getIssuerBalances() = 0;
 
     virtual std::pair<PublicKey, SecretKey> const&
     nodeIdentity() = 0;
@@ -233,6 +253,11 @@ public:
     getTxnDB() = 0;
     virtual DatabaseCon&
     getLedgerDB() = 0;
+    virtual RelationalDBInterface&
+    getRelationalDBInterface() = 0;
+    /** The index of validated transactions, if one is configured */
+    virtual TxIndex*
+    getTxIndex() = 0;
 
     virtual std::chrono::milliseconds
     getIOLatency() = 0;
@@ -20,25 +20,49 @@
 #include <ripple/app/main/BasicApp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 
-BasicApp::BasicApp(std::size_t numberOfThreads)
+BasicApp::Pool::Pool(
+    std::size_t numberOfThreads,
+    std::string const& name,
+    ripple::CpuSet const& affinity)
 {
-    work_.emplace(io_service_);
-    threads_.reserve(numberOfThreads);
+    work.emplace(io_service);
+    threads.reserve(numberOfThreads);
 
     while (numberOfThreads--)
     {
-        threads_.emplace_back([this, numberOfThreads]() {
+        threads.emplace_back([this, numberOfThreads, name, affinity]() {
             beast::setCurrentThreadName(
-                "io svc #" + std::to_string(numberOfThreads));
-            this->io_service_.run();
+                name + " #" + std::to_string(numberOfThreads));
+            ripple::setCurrentThreadAffinity(affinity);
+            this->io_service.run();
         });
     }
 }
 
-BasicApp::~BasicApp()
+BasicApp::Pool::~Pool()
 {
-    work_ = boost::none;
+    work = boost::none;
 
-    for (auto& t : threads_)
+    for (auto& t : threads)
         t.join();
 }
+
+BasicApp::BasicApp(
+    std::size_t numberOfThreads,
+    ripple::CpuSet const& affinity,
+    std::size_t overlayThreads,
+    std::size_t serverThreads)
+    : internal_(std::make_unique<Pool>(numberOfThreads, "io svc", affinity))
+{
+    if (overlayThreads != 0)
+        overlay_ = std::make_unique<Pool>(overlayThreads, "io peer", affinity);
+    if (serverThreads != 0)
+        server_ = std::make_unique<Pool>(serverThreads, "io rpc", affinity);
+}
+
+BasicApp::~BasicApp()
+{
+    server_.reset();
+    overlay_.reset();
+    internal_.reset();
+}
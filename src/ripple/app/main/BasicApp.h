@@ -20,8 +20,11 @@
 #ifndef RIPPLE_APP_BASICAPP_H_INCLUDED
 #define RIPPLE_APP_BASICAPP_H_INCLUDED
 
+#include <ripple/basics/ThreadAffinity.h>
 #include <boost/asio/io_service.hpp>
 #include <boost/optional.hpp>
+#include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -29,18 +32,71 @@
 class BasicApp
 {
 private:
-    boost::optional<boost::asio::io_service::work> work_;
-    std::vector<std::thread> threads_;
-    boost::asio::io_service io_service_;
+    // An io_service and the threads which run it
+    struct Pool
+    {
+        boost::asio::io_service io_service;
+        boost::optional<boost::asio::io_service::work> work;
+        std::vector<std::thread> threads;
+
+        Pool(
+            std::size_t numberOfThreads,
+            std::string const& name,
+            ripple::CpuSet const& affinity);
+        ~Pool();
+    };
+
+    // Destroyed in reverse order, so the dedicated pools are stopped
+    // before the internal one which the others may still post to.
+    std::unique_ptr<Pool> internal_;
+    std::unique_ptr<Pool> overlay_;
+    std::unique_ptr<Pool> server_;
 
 public:
-    BasicApp(std::size_t numberOfThreads);
+    /** Start the I/O threads.
+
+        The overlay and the client server each get their own io_service
+        when given a number of threads, so that a flood of work for one
+        cannot hold up the other. Otherwise they share the internal one.
+    */
+    BasicApp(
+        std::size_t numberOfThreads,
+        ripple::CpuSet const& affinity = {},
+        std::size_t overlayThreads = 0,
+        std::size_t serverThreads = 0);
     ~BasicApp();
 
+    /** The io_service for timers and everything without a pool of its own */
     boost::asio::io_service&
     get_io_service()
     {
-        return io_service_;
+        return internal_->io_service;
+    }
+
+    /** The io_service for connections to peers */
+    boost::asio::io_service&
+    get_overlay_io_service()
+    {
+        return overlay_ ? overlay_->io_service : get_io_service();
+    }
+
+    /** The io_service for client connections */
+    boost::asio::io_service&
+    get_server_io_service()
+    {
+        return server_ ? server_->io_service : get_io_service();
+    }
+
+    bool
+    has_overlay_io_service() const
+    {
+        return overlay_ != nullptr;
+    }
+
+    bool
+    has_server_io_service() const
+    {
+        return server_ != nullptr;
     }
 };
 
@@ -81,7 +81,7 @@ inline constexpr std::array TxDBPragma
 #endif
 };
 
-inline constexpr std::array<char const*, 8> TxDBInit{
+inline constexpr std::array<char const*, 12> TxDBInit{
     {"BEGIN TRANSACTION;",
 
      "CREATE TABLE IF NOT EXISTS Transactions (          \
@@ -110,6 +110,26 @@ inline constexpr std::array<char const*, 8> TxDBInit{
      "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON         \
         AccountTransactions(LedgerSeq, Account, TransID);",
 
+     // The same rows keyed by binary account and by ledger and transaction
+     // sequence packed into one integer (LedgerSeq << 32 | TxnSeq). The
+     // table is its own index, and is complete for ledgers from the one
+     // in AccountTxIndexStart, which is where it began to be written.
+     "CREATE TABLE IF NOT EXISTS AccountTxIndex (        \
+        Account     BLOB,                               \
+        SeqKey      BIGINT UNSIGNED,                    \
+        TransID     BLOB,                               \
+        PRIMARY KEY (Account, SeqKey, TransID)          \
+    ) WITHOUT ROWID;",
+     "CREATE INDEX IF NOT EXISTS AcctTxSeqIndex ON       \
+        AccountTxIndex(SeqKey);",
+     "CREATE TABLE IF NOT EXISTS AccountTxIndexStart (   \
+        LedgerSeq   BIGINT UNSIGNED                     \
+    );",
+     "INSERT INTO AccountTxIndexStart SELECT Seq FROM    \
+        (SELECT IFNULL(MAX(LedgerSeq) + 1, 0) AS Seq    \
+            FROM AccountTransactions)                   \
+        WHERE NOT EXISTS (SELECT * FROM AccountTxIndexStart);",
+
      "END TRANSACTION;"}};
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,7 +158,7 @@ inline constexpr std::array<char const*, 2> CompleteShardDBPragma{
 
 inline constexpr auto WalletDBName{"wallet.db"};
 
-inline constexpr std::array<char const*, 6> WalletDBInit{
+inline constexpr std::array<char const*, 7> WalletDBInit{
     {"BEGIN TRANSACTION;",
 
      // A node's identity must be persisted, including
@@ -167,6 +187,15 @@ inline constexpr std::array<char const*, 6> WalletDBInit{
         RawData          BLOB NOT NULL					\
     );",
 
+     // The range of history last known to be complete, so that it need
+     // not be walked again on startup. This table holds one entry.
+     "CREATE TABLE IF NOT EXISTS RecoveryCheckpoint (	\
+        MinLedgerSeq    BIGINT UNSIGNED,				\
+        MaxLedgerSeq    BIGINT UNSIGNED,				\
+        MaxLedgerHash   CHARACTER(64),					\
+        CleanShutdown   INTEGER							\
+    );",
+
      "END TRANSACTION;"}};
 
 ////////////////////////////////////////////////////////////////////////////////
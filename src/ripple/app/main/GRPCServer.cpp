@@ -48,7 +48,8 @@ GRPCServerImpl::CallData<Request, Response>::CallData(
     BindListener<Request, Response> bindListener,
     Handler<Request, Response> handler,
     RPC::Condition requiredCondition,
-    Resource::Charge loadType)
+    Resource::Charge loadType,
+    bool runInline)
     : service_(service)
     , cq_(cq)
     , finished_(false)
@@ -58,6 +59,7 @@ GRPCServerImpl::CallData<Request, Response>::CallData(
     , handler_(std::move(handler))
     , requiredCondition_(std::move(requiredCondition))
     , loadType_(std::move(loadType))
+    , runInline_(runInline)
 {
     // Bind a listener. When a request is received, "this" will be returned
     // from CompletionQueue::Next
@@ -75,7 +77,8 @@ GRPCServerImpl::CallData<Request, Response>::clone()
         bindListener_,
         handler_,
         requiredCondition_,
-        loadType_);
+        loadType_,
+        runInline_);
 }
 
 template <class Request, class Response>
@@ -97,6 +100,14 @@ GRPCServerImpl::CallData<Request, Response>::process()
     // ensures that finished is always true when this CallData object
     // is returned as a tag in handleRpcs(), after sending the response
     finished_ = true;
+
+    // Cheap requests take less time to answer than to hand to the JobQueue
+    if (runInline_)
+    {
+        process(nullptr);
+        return;
+    }
+
     auto coro = app_.getJobQueue().postCoro(
         JobType::jtRPC,
         "gRPC-Client",
@@ -204,6 +215,197 @@ GRPCServerImpl::CallData<Request, Response>::getUsage()
     return app_.getResourceManager().newInboundEndpoint(endpoint.get());
 }
 
+template <class Request, class Response>
+GRPCServerImpl::StreamingCallData<Request, Response>::StreamingCallData(
+    org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService& service,
+    grpc::ServerCompletionQueue& cq,
+    std::atomic_bool const& stopping,
+    Application& app,
+    BindStreamListener<Request, Response> bindListener,
+    StreamHandler<Request, Response> handler,
+    RPC::Condition requiredCondition,
+    Resource::Charge loadType)
+    : service_(service)
+    , cq_(cq)
+    , finished_(false)
+    , streaming_(false)
+    , stopping_(stopping)
+    , app_(app)
+    , responder_(&ctx_)
+    , bindListener_(std::move(bindListener))
+    , handler_(std::move(handler))
+    , requiredCondition_(std::move(requiredCondition))
+    , loadType_(std::move(loadType))
+{
+    bindListener_(service_, &ctx_, &request_, &responder_, &cq_, &cq_, this);
+}
+
+template <class Request, class Response>
+std::shared_ptr<Processor>
+GRPCServerImpl::StreamingCallData<Request, Response>::clone()
+{
+    return std::make_shared<StreamingCallData<Request, Response>>(
+        service_,
+        cq_,
+        stopping_,
+        app_,
+        bindListener_,
+        handler_,
+        requiredCondition_,
+        loadType_);
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamingCallData<Request, Response>::process()
+{
+    // sanity check
+    BOOST_ASSERT(!finished_);
+
+    std::shared_ptr<StreamingCallData<Request, Response>> thisShared =
+        this->shared_from_this();
+
+    // Until the final status is sent, every event handleRpcs() gets for
+    // this object is a completed write
+    finished_ = true;
+    streaming_ = true;
+    auto coro = app_.getJobQueue().postCoro(
+        JobType::jtRPC,
+        "gRPC-Stream",
+        [thisShared](std::shared_ptr<JobQueue::Coro> coro) {
+            thisShared->process(coro);
+        });
+
+    // If coro is null, then the JobQueue has already been shutdown
+    if (!coro)
+        finish({grpc::StatusCode::INTERNAL, "Job Queue is already stopped"});
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamingCallData<Request, Response>::process(
+    std::shared_ptr<JobQueue::Coro> coro)
+{
+    coro_ = std::move(coro);
+
+    grpc::Status status;
+    try
+    {
+        auto usage = getUsage();
+        if (usage.disconnect())
+        {
+            status = {
+                grpc::StatusCode::RESOURCE_EXHAUSTED,
+                "usage balance exceeds threshhold"};
+        }
+        else
+        {
+            usage.charge(loadType_);
+
+            RPC::GRPCContext<Request> context{
+                {app_.journal("gRPCServer"),
+                 app_,
+                 loadType_,
+                 app_.getOPs(),
+                 app_.getLedgerMaster(),
+                 usage,
+                 Role::USER,
+                 coro_,
+                 InfoSub::pointer(),
+                 apiVersion},
+                request_};
+
+            error_code_i conditionMetRes =
+                RPC::conditionMet(requiredCondition_, context);
+
+            if (conditionMetRes != rpcSUCCESS)
+            {
+                RPC::ErrorInfo errorInfo = RPC::get_error_info(conditionMetRes);
+                status = {
+                    grpc::StatusCode::FAILED_PRECONDITION,
+                    errorInfo.message.c_str()};
+            }
+            else
+            {
+                status = handler_(context, [this](Response const& response) {
+                    return write(response);
+                });
+            }
+        }
+    }
+    catch (std::exception const& ex)
+    {
+        status = {grpc::StatusCode::INTERNAL, ex.what()};
+    }
+
+    finish(status);
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamingCallData<Request, Response>::write(
+    Response const& response)
+{
+    if (stopping_)
+        return false;
+
+    // The response must stay alive until the write completes, which is
+    // why the coroutine waits here for onWrite()
+    responder_.Write(response, this);
+    coro_->yield();
+    return writeOk_;
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamingCallData<Request, Response>::onWrite(bool ok)
+{
+    writeOk_ = ok;
+    if (!coro_->post())
+    {
+        // The job queue is stopping, so nothing else will run the
+        // coroutine. Let it finish the call here.
+        writeOk_ = false;
+        coro_->resume();
+    }
+}
+
+template <class Request, class Response>
+void
+GRPCServerImpl::StreamingCallData<Request, Response>::finish(
+    grpc::Status const& status)
+{
+    // As with CallData, the state must be updated before the status is
+    // posted, since the next event for this object may arrive at once
+    coro_.reset();
+    streaming_ = false;
+    responder_.Finish(status, this);
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamingCallData<Request, Response>::isFinished()
+{
+    return finished_;
+}
+
+template <class Request, class Response>
+bool
+GRPCServerImpl::StreamingCallData<Request, Response>::isStreaming()
+{
+    return streaming_;
+}
+
+template <class Request, class Response>
+Resource::Consumer
+GRPCServerImpl::StreamingCallData<Request, Response>::getUsage()
+{
+    std::string peer = getEndpoint(ctx_.peer());
+    boost::optional<beast::IP::Endpoint> endpoint =
+        beast::IP::Endpoint::from_string_checked(peer);
+    return app_.getResourceManager().newInboundEndpoint(endpoint.get());
+}
+
 GRPCServerImpl::GRPCServerImpl(Application& app)
     : app_(app), journal_(app_.journal("gRPC Server"))
 {
@@ -219,6 +421,17 @@ GRPCServerImpl::GRPCServerImpl(Application& app)
         std::pair<std::string, bool> portPair = section.find("port");
         if (!portPair.second)
             return;
+
+        // More threads than a handful only contend for the JobQueue
+        if (set(threads_, "threads", section) &&
+            (threads_ == 0 || threads_ > 32))
+        {
+            JLOG(journal_.error()) << "Invalid [port_grpc] threads value: "
+                                   << threads_ << ". Using one thread";
+            threads_ = 1;
+        }
+        set(inline_, "inline", section);
+
         try
         {
             beast::IP::Endpoint endpoint(
@@ -238,6 +451,9 @@ GRPCServerImpl::shutdown()
 {
     JLOG(journal_.debug()) << "Shutting down";
 
+    // Streaming calls check this before each write, so they finish soon
+    stopping_ = true;
+
     // The below call cancels all "listeners" (CallData objects that are waiting
     // for a request, as opposed to processing a request), and blocks until all
     // requests being processed are completed. CallData objects in the midst of
@@ -248,20 +464,24 @@ GRPCServerImpl::shutdown()
     server_->Shutdown();
     JLOG(journal_.debug()) << "Server has been shutdown";
 
-    // Always shutdown the completion queue after the server. This call allows
+    // Always shutdown the completion queues after the server. This call allows
     // cq_.Next() to return false, once all events posted to the completion
     // queue have been processed. See handleRpcs() for more details.
-    cq_->Shutdown();
-    JLOG(journal_.debug()) << "Completion Queue has been shutdown";
+    for (auto& cq : cqs_)
+        cq->Shutdown();
+    JLOG(journal_.debug()) << "Completion Queues have been shutdown";
 }
 
 void
-GRPCServerImpl::handleRpcs()
+GRPCServerImpl::handleRpcs(std::size_t queue)
 {
+    auto& cq = *cqs_[queue];
+
     // This collection should really be an unordered_set. However, to delete
     // from the unordered_set, we need a shared_ptr, but cq_.Next() (see below
-    // while loop) sets the tag to a raw pointer.
-    std::vector<std::shared_ptr<Processor>> requests = setupListeners();
+    // while loop) sets the tag to a raw pointer. Every object in it belongs
+    // to this queue, and so is only touched by this thread.
+    std::vector<std::shared_ptr<Processor>> requests = setupListeners(cq);
 
     auto erase = [&requests](Processor* ptr) {
         auto it = std::find_if(
@@ -291,13 +511,18 @@ GRPCServerImpl::handleRpcs()
     // cancelled listeners and all CallData objects processing requests are
     // returned via cq_->Next(), cq_->Next() will return false, causing the
     // loop to exit.
-    while (cq_->Next(&tag, &ok))
+    while (cq.Next(&tag, &ok))
     {
         auto ptr = static_cast<Processor*>(tag);
         JLOG(journal_.trace()) << "Processing CallData object."
                                << " ptr = " << ptr << " ok = " << ok;
 
-        if (!ok)
+        if (ptr->isStreaming())
+        {
+            JLOG(journal_.trace()) << "Write completed. ok = " << ok;
+            ptr->onWrite(ok);
+        }
+        else if (!ok)
         {
             JLOG(journal_.debug()) << "Request listener cancelled. "
                                    << "Destroying object";
@@ -327,7 +552,7 @@ GRPCServerImpl::handleRpcs()
 
 // create a CallData instance for each RPC
 std::vector<std::shared_ptr<Processor>>
-GRPCServerImpl::setupListeners()
+GRPCServerImpl::setupListeners(grpc::ServerCompletionQueue& cq)
 {
     std::vector<std::shared_ptr<Processor>> requests;
 
@@ -342,13 +567,14 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetFee,
             doFeeGrpc,
             RPC::NEEDS_CURRENT_LEDGER,
-            Resource::feeReferenceRPC));
+            Resource::feeReferenceRPC,
+            inline_));
     }
     {
         using cd = CallData<
@@ -357,13 +583,14 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetAccountInfo,
             doAccountInfoGrpc,
             RPC::NO_CONDITION,
-            Resource::feeReferenceRPC));
+            Resource::feeReferenceRPC,
+            inline_));
     }
     {
         using cd = CallData<
@@ -372,7 +599,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetTransaction,
@@ -387,7 +614,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestSubmitTransaction,
@@ -395,6 +622,21 @@ GRPCServerImpl::setupListeners()
             RPC::NEEDS_CURRENT_LEDGER,
             Resource::feeMediumBurdenRPC));
     }
+    {
+        using cd = CallData<
+            org::xrpl::rpc::v1::SubmitTransactionsRequest,
+            org::xrpl::rpc::v1::SubmitTransactionsResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            cq,
+            app_,
+            &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
+                RequestSubmitTransactions,
+            doSubmitMultipleGrpc,
+            RPC::NEEDS_CURRENT_LEDGER,
+            Resource::feeHighBurdenRPC));
+    }
 
     {
         using cd = CallData<
@@ -403,7 +645,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetAccountTransactionHistory,
@@ -411,6 +653,37 @@ GRPCServerImpl::setupListeners()
             RPC::NO_CONDITION,
             Resource::feeMediumBurdenRPC));
     }
+    {
+        using cd = StreamingCallData<
+            org::xrpl::rpc::v1::GetLedgerDataRequest,
+            org::xrpl::rpc::v1::GetLedgerDataResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            cq,
+            stopping_,
+            app_,
+            &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
+                RequestGetLedgerData,
+            doLedgerDataGrpc,
+            RPC::NO_CONDITION,
+            Resource::feeHighBurdenRPC));
+    }
+    {
+        using cd = CallData<
+            org::xrpl::rpc::v1::GetLedgerRequest,
+            org::xrpl::rpc::v1::GetLedgerResponse>;
+
+        addToRequests(std::make_shared<cd>(
+            service_,
+            cq,
+            app_,
+            &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
+                RequestGetLedger,
+            doLedgerGrpc,
+            RPC::NO_CONDITION,
+            Resource::feeMediumBurdenRPC));
+    }
     return requests;
 };
 
@@ -429,9 +702,10 @@ GRPCServerImpl::start()
     // Register "service_" as the instance through which we'll communicate with
     // clients. In this case it corresponds to an *asynchronous* service.
     builder.RegisterService(&service_);
-    // Get hold of the completion queue used for the asynchronous communication
-    // with the gRPC runtime.
-    cq_ = builder.AddCompletionQueue();
+    // Get hold of the completion queues used for the asynchronous
+    // communication with the gRPC runtime.
+    for (std::size_t i = 0; i < threads_; ++i)
+        cqs_.push_back(builder.AddCompletionQueue());
     // Finally assemble the server.
     server_ = builder.BuildAndStart();
 
@@ -444,11 +718,15 @@ GRPCServer::onStart()
     // Start the server and setup listeners
     if (running_ = impl_.start(); running_)
     {
-        thread_ = std::thread([this]() {
-            // Start the event loop and begin handling requests
-            beast::setCurrentThreadName("rippled: grpc");
-            this->impl_.handleRpcs();
-        });
+        for (std::size_t i = 0; i < impl_.queueCount(); ++i)
+        {
+            threads_.emplace_back([this, i]() {
+                // Start the event loop and begin handling requests
+                beast::setCurrentThreadName(
+                    "rippled: grpc #" + std::to_string(i));
+                this->impl_.handleRpcs(i);
+            });
+        }
     }
 }
 
@@ -458,7 +736,9 @@ GRPCServer::onStop()
     if (running_)
     {
         impl_.shutdown();
-        thread_.join();
+        for (auto& thread : threads_)
+            thread.join();
+        threads_.clear();
         running_ = false;
     }
 
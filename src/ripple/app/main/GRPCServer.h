@@ -66,16 +66,36 @@ public:
     // deleted once this function returns true
     virtual bool
     isFinished() = 0;
+
+    // true while this object is streaming a response. Events returned from
+    // the completion queue for it are then the results of its writes
+    virtual bool
+    isStreaming()
+    {
+        return false;
+    }
+
+    // called with the result of each write while streaming
+    virtual void
+    onWrite(bool ok)
+    {
+    }
 };
 
 class GRPCServerImpl final
 {
 private:
     // CompletionQueue returns events that have occurred, or events that have
-    // been cancelled
-    std::unique_ptr<grpc::ServerCompletionQueue> cq_;
+    // been cancelled. Each queue is drained by its own thread, and calls are
+    // spread across them by listening for every RPC on every queue.
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+
+    // The number of completion queues and threads to use
+    std::size_t threads_ = 1;
 
-    std::vector<std::shared_ptr<Processor>> requests_;
+    // Whether cheap calls are answered on the completion queue's thread
+    // rather than posted to the JobQueue
+    bool inline_ = false;
 
     // The gRPC service defined by the .proto files
     org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService service_;
@@ -88,6 +108,10 @@ private:
 
     beast::Journal journal_;
 
+    // Set once the server starts shutting down, so streaming calls stop
+    // rather than holding up the shutdown
+    std::atomic_bool stopping_{false};
+
     // typedef for function to bind a listener
     // This is always of the form:
     // org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::Request[RPC NAME]
@@ -106,6 +130,26 @@ private:
     template <class Request, class Response>
     using Handler = std::function<std::pair<Response, grpc::Status>(
         RPC::GRPCContext<Request>&)>;
+
+    // typedef for function to bind a listener for an RPC which streams its
+    // response
+    template <class Request, class Response>
+    using BindStreamListener = std::function<void(
+        org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService&,
+        grpc::ServerContext*,
+        Request*,
+        grpc::ServerAsyncWriter<Response>*,
+        grpc::CompletionQueue*,
+        grpc::ServerCompletionQueue*,
+        void*)>;
+
+    // typedef for a handler which streams its response. It is given a
+    // function which writes one response and returns false if the client has
+    // gone away, and returns the status to finish the call with
+    template <class Request, class Response>
+    using StreamHandler = std::function<grpc::Status(
+        RPC::GRPCContext<Request>&,
+        std::function<bool(Response const&)> const&)>;
     // This implementation is currently limited to v1 of the API
     static unsigned constexpr apiVersion = 1;
 
@@ -125,13 +169,21 @@ public:
     bool
     start();
 
-    // the main event loop
+    // the number of completion queues, each needing a thread to run
+    // handleRpcs()
+    std::size_t
+    queueCount() const
+    {
+        return cqs_.size();
+    }
+
+    // the main event loop for one completion queue
     void
-    handleRpcs();
+    handleRpcs(std::size_t queue);
 
     // Create a CallData object for each RPC. Return created objects in vector
     std::vector<std::shared_ptr<Processor>>
-    setupListeners();
+    setupListeners(grpc::ServerCompletionQueue& cq);
 
 private:
     // Class encompasing the state and logic needed to serve a request.
@@ -183,6 +235,9 @@ private:
         // Load type for this RPC
         Resource::Charge loadType_;
 
+        // true to answer the request on the completion queue's thread
+        bool runInline_;
+
     public:
         virtual ~CallData() = default;
 
@@ -196,7 +251,8 @@ private:
             BindListener<Request, Response> bindListener,
             Handler<Request, Response> handler,
             RPC::Condition requiredCondition,
-            Resource::Charge loadType);
+            Resource::Charge loadType,
+            bool runInline = false);
 
         CallData(const CallData&) = delete;
 
@@ -213,7 +269,8 @@ private:
         clone() override;
 
     private:
-        // process the request. Called inside the coroutine passed to JobQueue
+        // process the request. Called inside the coroutine passed to
+        // JobQueue, or with no coroutine when run inline
         void
         process(std::shared_ptr<JobQueue::Coro> coro);
 
@@ -233,6 +290,103 @@ private:
 
     };  // CallData
 
+    // Class encompasing the state and logic needed to serve a request whose
+    // response is a stream of messages. The handler runs in a coroutine
+    // which is suspended while each message is written, so a slow client
+    // slows the handler down instead of messages piling up in memory.
+    template <class Request, class Response>
+    class StreamingCallData
+        : public Processor,
+          public std::enable_shared_from_this<
+              StreamingCallData<Request, Response>>
+    {
+    private:
+        org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService& service_;
+
+        grpc::ServerCompletionQueue& cq_;
+
+        grpc::ServerContext ctx_;
+
+        // true once processing of the request has started
+        std::atomic_bool finished_;
+
+        // true from when processing starts until the final status is sent
+        std::atomic_bool streaming_;
+
+        std::atomic_bool const& stopping_;
+
+        Application& app_;
+
+        Request request_;
+
+        grpc::ServerAsyncWriter<Response> responder_;
+
+        BindStreamListener<Request, Response> bindListener_;
+
+        StreamHandler<Request, Response> handler_;
+
+        RPC::Condition requiredCondition_;
+
+        Resource::Charge loadType_;
+
+        // The coroutine running the handler, while it is running
+        std::shared_ptr<JobQueue::Coro> coro_;
+
+        // The result of the last write
+        bool writeOk_ = false;
+
+    public:
+        virtual ~StreamingCallData() = default;
+
+        explicit StreamingCallData(
+            org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService& service,
+            grpc::ServerCompletionQueue& cq,
+            std::atomic_bool const& stopping,
+            Application& app,
+            BindStreamListener<Request, Response> bindListener,
+            StreamHandler<Request, Response> handler,
+            RPC::Condition requiredCondition,
+            Resource::Charge loadType);
+
+        StreamingCallData(const StreamingCallData&) = delete;
+
+        StreamingCallData&
+        operator=(const StreamingCallData&) = delete;
+
+        virtual void
+        process() override;
+
+        virtual bool
+        isFinished() override;
+
+        std::shared_ptr<Processor>
+        clone() override;
+
+        bool
+        isStreaming() override;
+
+        void
+        onWrite(bool ok) override;
+
+    private:
+        // process the request. Called inside the coroutine passed to JobQueue
+        void
+        process(std::shared_ptr<JobQueue::Coro> coro);
+
+        // write one response, suspending the coroutine until it completes
+        bool
+        write(Response const& response);
+
+        // send the final status
+        void
+        finish(grpc::Status const& status);
+
+        // register endpoint with ResourceManager and return usage
+        Resource::Consumer
+        getUsage();
+
+    };  // StreamingCallData
+
 };  // GRPCServerImpl
 
 class GRPCServer : public Stoppable
@@ -258,7 +412,7 @@ public:
 
 private:
     GRPCServerImpl impl_;
-    std::thread thread_;
+    std::vector<std::thread> threads_;
     bool running_ = false;
 };
 }  // namespace ripple
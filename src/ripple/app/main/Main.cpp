@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/ReplayBenchmark.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/main/DBInit.h>
 #include <ripple/basics/Log.h>
@@ -140,9 +141,11 @@ printHelp(const po::options_description& desc)
            "     channel_verify <public_key> <channel_id> <drops> <signature>\n"
            "     connect <ip> [<port>]\n"
            "     consensus_info\n"
+           "     cpu_profile [<seconds>] [<frequency>]\n"
            "     deposit_authorized <source_account> <destination_account> "
            "[<ledger>]\n"
            "     download_shard [[<index> <url>]]\n"
+           "     export_shard <index> <path>\n"
            "     feature [<feature> [accept|reject]]\n"
            "     fetch_info [clear]\n"
            "     gateway_balances [<ledger>] <issuer_account> [ <hotwallet> [ "
@@ -382,6 +385,10 @@ run(int argc, char** argv)
         "net", "Get the initial ledger from the network.")(
         "nodetoshard", "Import node store into shards")(
         "replay", "Replay a ledger close.")(
+        "replay_benchmark",
+        po::value<std::string>(),
+        "Replay the stored ledgers in the range first-last and report how "
+        "long they take to build. Requires --standalone.")(
         "start", "Start from a fresh Ledger.")(
         "vacuum", "VACUUM the transaction db.")(
         "valid", "Consider the initial ledger a valid network ledger.");
@@ -699,6 +706,24 @@ run(int argc, char** argv)
         }
     }
 
+    boost::optional<std::pair<LedgerIndex, LedgerIndex>> replayRange;
+    if (vm.count("replay_benchmark"))
+    {
+        replayRange =
+            parseLedgerRange(vm["replay_benchmark"].as<std::string>());
+        if (!replayRange)
+        {
+            std::cerr << "Invalid value specified for --replay_benchmark ("
+                      << vm["replay_benchmark"].as<std::string>() << ")\n";
+            return -1;
+        }
+        if (!config->standalone())
+        {
+            std::cerr << "replay_benchmark requires standalone mode.\n";
+            return -1;
+        }
+    }
+
     // Construct the logs object at the configured severity
     using namespace beast::severities;
     Severity thresh = kInfo;
@@ -748,6 +773,17 @@ run(int argc, char** argv)
                 app->fdRequired(), app->logs().journal("Application")))
             return -1;
 
+        if (replayRange)
+        {
+            // Replay the ledgers, report, and shut down again
+            app->doStart(false /*don't start timers*/);
+            auto const ok = replayBenchmark(
+                *app, replayRange->first, replayRange->second, std::cout);
+            app->signalStop();
+            app->run();
+            return ok ? 0 : -1;
+        }
+
         // Start the server
         app->doStart(true /*start timers*/);
 
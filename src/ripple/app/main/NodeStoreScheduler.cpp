@@ -33,6 +33,16 @@ NodeStoreScheduler::setJobQueue(JobQueue& jobQueue)
     m_jobQueue = &jobQueue;
 }
 
+void
+NodeStoreScheduler::setCollector(
+    beast::insight::Collector::ptr const& collector)
+{
+    readSyncLatency_ = collector->make_histogram("read_sync");
+    readAsyncLatency_ = collector->make_histogram("read_async");
+    writeLatency_ = collector->make_histogram("write");
+    writeStall_ = collector->make_histogram("write_stall");
+}
+
 void
 NodeStoreScheduler::onStop()
 {
@@ -78,18 +88,24 @@ NodeStoreScheduler::doTask(NodeStore::Task& task)
 void
 NodeStoreScheduler::onFetch(NodeStore::FetchReport const& report)
 {
-    if (report.wentToDisk)
-        m_jobQueue->addLoadEvents(
-            report.fetchType == NodeStore::FetchType::async ? jtNS_ASYNC_READ
-                                                            : jtNS_SYNC_READ,
-            1,
-            report.elapsed);
+    if (!report.wentToDisk)
+        return;
+
+    auto const async = report.fetchType == NodeStore::FetchType::async;
+    m_jobQueue->addLoadEvents(
+        async ? jtNS_ASYNC_READ : jtNS_SYNC_READ,
+        1,
+        std::chrono::duration_cast<std::chrono::milliseconds>(report.elapsed));
+    (async ? readAsyncLatency_ : readSyncLatency_).notify(report.elapsed);
 }
 
 void
 NodeStoreScheduler::onBatchWrite(NodeStore::BatchWriteReport const& report)
 {
     m_jobQueue->addLoadEvents(jtNS_WRITE, report.writeCount, report.elapsed);
+    writeLatency_.notify(report.elapsed);
+    if (report.stalled.count() != 0)
+        writeStall_.notify(report.stalled);
 }
 
 }  // namespace ripple
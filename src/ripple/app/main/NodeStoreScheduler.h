@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_MAIN_NODESTORESCHEDULER_H_INCLUDED
 #define RIPPLE_APP_MAIN_NODESTORESCHEDULER_H_INCLUDED
 
+#include <ripple/beast/insight/Collector.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/nodestore/Scheduler.h>
@@ -40,6 +41,11 @@ public:
     void
     setJobQueue(JobQueue& jobQueue);
 
+    /** Report the latency of each read and batch write, and how long
+        writers waited for a batch writer to make room. */
+    void
+    setCollector(beast::insight::Collector::ptr const& collector);
+
     void
     onStop() override;
     void
@@ -57,6 +63,11 @@ private:
 
     JobQueue* m_jobQueue{nullptr};
     std::atomic<int> m_taskCount{0};
+
+    beast::insight::Histogram readSyncLatency_;
+    beast::insight::Histogram readAsyncLatency_;
+    beast::insight::Histogram writeLatency_;
+    beast::insight::Histogram writeStall_;
 };
 
 }  // namespace ripple
@@ -25,6 +25,13 @@ namespace ripple {
 constexpr std::size_t fullBelowTargetSize = 524288;
 constexpr std::chrono::seconds fullBelowExpiration = std::chrono::minutes{10};
 
+// Reading old ledgers through from peers
+constexpr std::size_t historyFetchPeers = 2;
+constexpr std::chrono::seconds historyFetchTimeout{3};
+constexpr std::size_t historyMaxActive = 4;
+constexpr int historyLedgerCacheSize = 32;
+constexpr std::chrono::seconds historyCacheAge = std::chrono::minutes{5};
+
 }  // namespace ripple
 
 #endif
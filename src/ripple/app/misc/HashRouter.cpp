@@ -22,29 +22,32 @@
 namespace ripple {
 
 auto
-HashRouter::emplace(uint256 const& key) -> std::pair<Entry&, bool>
+HashRouter::emplace(Shard& shard, uint256 const& key)
+    -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find(key);
+    auto& map = shard.suppressionMap;
+    auto iter = map.find(key);
 
-    if (iter != suppressionMap_.end())
+    if (iter != map.end())
     {
-        suppressionMap_.touch(iter);
+        map.touch(iter);
         return std::make_pair(std::ref(iter->second), false);
     }
 
     // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    beast::expire(map, holdTime_, expireBatch);
 
     return std::make_pair(
-        std::ref(suppressionMap_.emplace(key, Entry()).first->second), true);
+        std::ref(map.emplace(key, Entry()).first->second), true);
 }
 
 void
 HashRouter::addSuppression(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    emplace(key);
+    emplace(shard, key);
 }
 
 bool
@@ -56,9 +59,10 @@ HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer)
 std::pair<bool, std::optional<Stopwatch::time_point>>
 HashRouter::addSuppressionPeerWithStatus(const uint256& key, PeerShortID peer)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key);
     result.first.addPeer(peer);
     return {result.second, result.first.relayed()};
 }
@@ -66,14 +70,27 @@ HashRouter::addSuppressionPeerWithStatus(const uint256& key, PeerShortID peer)
 bool
 HashRouter::addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto [s, created] = emplace(key);
+    auto [s, created] = emplace(shard, key);
     s.addPeer(peer);
     flags = s.getFlags();
     return created;
 }
 
+std::optional<Stopwatch::time_point>
+HashRouter::relayed(uint256 const& key) const
+{
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
+
+    auto const iter = shard.suppressionMap.find(key);
+    if (iter == shard.suppressionMap.end())
+        return {};
+    return iter->second.relayed();
+}
+
 bool
 HashRouter::shouldProcess(
     uint256 const& key,
@@ -81,21 +98,23 @@ HashRouter::shouldProcess(
     int& flags,
     std::chrono::seconds tx_interval)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key);
     auto& s = result.first;
     s.addPeer(peer);
     flags = s.getFlags();
-    return s.shouldProcess(suppressionMap_.clock().now(), tx_interval);
+    return s.shouldProcess(shard.suppressionMap.clock().now(), tx_interval);
 }
 
 int
 HashRouter::getFlags(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    return emplace(key).first.getFlags();
+    return emplace(shard, key).first.getFlags();
 }
 
 bool
@@ -103,9 +122,10 @@ HashRouter::setFlags(uint256 const& key, int flags)
 {
     assert(flags != 0);
 
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
     if ((s.getFlags() & flags) == flags)
         return false;
@@ -118,11 +138,12 @@ auto
 HashRouter::shouldRelay(uint256 const& key)
     -> std::optional<std::set<PeerShortID>>
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(shard.suppressionMap.clock().now(), holdTime_))
         return {};
 
     return s.releasePeerSet();
@@ -131,11 +152,40 @@ HashRouter::shouldRelay(uint256 const& key)
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard lock(mutex_);
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
     return s.shouldRecover(recoverLimit_);
 }
 
+auto
+HashRouter::getPreflight(
+    uint256 const& key,
+    Rules const& rules,
+    ApplyFlags flags) const -> std::optional<std::pair<NotTEC, TxConsequences>>
+{
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
+
+    auto const iter = shard.suppressionMap.find(key);
+    if (iter == shard.suppressionMap.end())
+        return {};
+    return iter->second.preflight(rules, flags);
+}
+
+void
+HashRouter::setPreflight(
+    uint256 const& key,
+    Rules const& rules,
+    ApplyFlags flags,
+    std::pair<NotTEC, TxConsequences> const& result)
+{
+    auto& shard = shardFor(key);
+    std::lock_guard lock(shard.mutex);
+
+    emplace(shard, key).first.setPreflight(rules, flags, result);
+}
+
 }  // namespace ripple
@@ -20,12 +20,21 @@
 #ifndef RIPPLE_APP_MISC_HASHROUTER_H_INCLUDED
 #define RIPPLE_APP_MISC_HASHROUTER_H_INCLUDED
 
+#include <ripple/app/tx/applySteps.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/container/aged_unordered_map.h>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -33,6 +42,7 @@ namespace ripple {
 #define SF_BAD 0x02  // Temporarily bad
 #define SF_SAVED 0x04
 #define SF_TRUSTED 0x10  // comes from trusted source
+#define SF_CLUSTER 0x20  // validity shared with or by our cluster
 
 // Private flags, used internally in apply.cpp.
 // Do not attempt to read, set, or reuse.
@@ -68,8 +78,12 @@ private:
         void
         addPeer(PeerShortID peer)
         {
-            if (peer != 0)
-                peers_.insert(peer);
+            if (peer == 0)
+                return;
+            auto const iter =
+                std::lower_bound(peers_.begin(), peers_.end(), peer);
+            if (iter == peers_.end() || *iter != peer)
+                peers_.insert(iter, peer);
         }
 
         int
@@ -88,7 +102,10 @@ private:
         std::set<PeerShortID>
         releasePeerSet()
         {
-            return std::move(peers_);
+            std::set<PeerShortID> result(peers_.begin(), peers_.end());
+            peers_.clear();
+            peers_.shrink_to_fit();
+            return result;
         }
 
         /** Return seated relay time point if the message has been relayed */
@@ -138,14 +155,65 @@ private:
             return true;
         }
 
+        /** Return the remembered result of preflight with these rules
+            and flags, if there is one.
+        */
+        std::optional<std::pair<NotTEC, TxConsequences>>
+        preflight(Rules const& rules, ApplyFlags flags) const
+        {
+            for (auto const& p : preflights_)
+            {
+                if (p.flags == flags && p.rules == rules)
+                    return std::make_pair(p.ter, p.consequences);
+            }
+            return {};
+        }
+
+        /** Remember the result of preflight with these rules and flags.
+
+            Only the most recent few are kept. The stages a transaction
+            passes through use only a handful of different flags.
+        */
+        void
+        setPreflight(
+            Rules const& rules,
+            ApplyFlags flags,
+            std::pair<NotTEC, TxConsequences> const& result)
+        {
+            auto iter = std::find_if(
+                preflights_.begin(), preflights_.end(), [&](auto const& p) {
+                    return p.flags == flags;
+                });
+            if (iter != preflights_.end())
+                preflights_.erase(iter);
+            else if (preflights_.size() >= maxPreflights)
+                preflights_.erase(preflights_.begin());
+            preflights_.push_back(
+                {rules, flags, result.first, result.second});
+        }
+
     private:
+        struct Preflight
+        {
+            Rules rules;
+            ApplyFlags flags;
+            NotTEC ter;
+            TxConsequences consequences;
+        };
+
+        static constexpr std::size_t maxPreflights = 4;
+
         int flags_ = 0;
-        std::set<PeerShortID> peers_;
+        // The peers which sent the item, in order. Most items come from
+        // just a few peers, so keep those inline rather than allocate a node
+        // for each one.
+        boost::container::small_vector<PeerShortID, 6> peers_;
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         std::optional<Stopwatch::time_point> relayed_;
         std::optional<Stopwatch::time_point> processed_;
         std::uint32_t recoveries_ = 0;
+        std::vector<Preflight> preflights_;
     };
 
 public:
@@ -167,10 +235,10 @@ public:
         Stopwatch& clock,
         std::chrono::seconds entryHoldTimeInSeconds,
         std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
-        , holdTime_(entryHoldTimeInSeconds)
-        , recoverLimit_(recoverLimit + 1u)
+        : holdTime_(entryHoldTimeInSeconds), recoverLimit_(recoverLimit + 1u)
     {
+        for (auto& shard : shards_)
+            shard = std::make_unique<Shard>(clock);
     }
 
     HashRouter&
@@ -197,6 +265,12 @@ public:
     bool
     addSuppressionPeer(uint256 const& key, PeerShortID peer, int& flags);
 
+    /** Return the time the item was last relayed, or unseated if
+        it has not been relayed.
+    */
+    std::optional<Stopwatch::time_point>
+    relayed(uint256 const& key) const;
+
     // Add a peer suppression and return whether the entry should be processed
     bool
     shouldProcess(
@@ -239,20 +313,70 @@ public:
     bool
     shouldRecover(uint256 const& key);
 
+    /** Return the result of an earlier `preflight` of a transaction.
+
+        Preflight depends only on the transaction, the rules and the
+        apply flags, so its result is remembered for as long as the
+        transaction's entry, and a transaction checked when it arrives
+        from a peer is not checked again when it is submitted, applied
+        to the open ledger or built into a closed one.
+
+        @return The result, if the transaction was preflighted with the
+            same rules and flags.
+    */
+    std::optional<std::pair<NotTEC, TxConsequences>>
+    getPreflight(uint256 const& key, Rules const& rules, ApplyFlags flags)
+        const;
+
+    /** Remember the result of a `preflight` of a transaction. */
+    void
+    setPreflight(
+        uint256 const& key,
+        Rules const& rules,
+        ApplyFlags flags,
+        std::pair<NotTEC, TxConsequences> const& result);
+
 private:
+    // Every peer thread consults the table for each message it relays, so
+    // it is split into shards with a lock each. The keys are hashes, so
+    // their leading bits spread them evenly between the shards.
+    static constexpr std::size_t shardCount = 16;
+
+    // The most entries expired while adding one, so that a shard which was
+    // quiet for a while is not swept all at once under its lock. Entries
+    // are added one at a time, so expiry still keeps up.
+    static constexpr std::size_t expireBatch = 8;
+
+    struct Shard
+    {
+        explicit Shard(Stopwatch& clock) : suppressionMap(clock)
+        {
+        }
+
+        std::mutex mutable mutex;
+
+        // Stores the suppressed hashes and their expiration time
+        beast::aged_unordered_map<
+            uint256,
+            Entry,
+            Stopwatch::clock_type,
+            hardened_hash<strong_hash>>
+            suppressionMap;
+    };
+
+    Shard&
+    shardFor(uint256 const& key) const
+    {
+        return *shards_[*key.data() % shardCount];
+    }
+
+    // Entries expire from a shard, a few at a time, as new entries are
+    // added to it.
     // pair.second indicates whether the entry was created
     std::pair<Entry&, bool>
-    emplace(uint256 const&);
-
-    std::mutex mutable mutex_;
+    emplace(Shard& shard, uint256 const&);
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<
-        uint256,
-        Entry,
-        Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        suppressionMap_;
+    std::array<std::unique_ptr<Shard>, shardCount> shards_;
 
     std::chrono::seconds const holdTime_;
 
@@ -25,6 +25,7 @@
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
 
 namespace ripple {
@@ -216,15 +217,31 @@ private:
     /** Active manifests stored by master public key. */
     hash_map<PublicKey, Manifest> map_;
 
-    /** Master public keys stored by current ephemeral public key. */
-    hash_map<PublicKey, PublicKey> signingToMasterKeys_;
+    /** The keys of the active manifests, looked up for every validation
+        and proposal. A new set is made each time a manifest is applied,
+        so they are read without a lock.
+    */
+    struct Keys
+    {
+        /** Current ephemeral public keys stored by master public key. */
+        hash_map<PublicKey, PublicKey> signingKeys;
+
+        /** Master public keys stored by current ephemeral public key. */
+        hash_map<PublicKey, PublicKey> masterKeys;
+
+        /** Revoked master public keys. */
+        hash_set<PublicKey> revoked;
+    };
+
+    // Read with std::atomic_load and replaced with std::atomic_store
+    std::shared_ptr<Keys const> keys_;
 
     std::atomic<std::uint32_t> seq_{0};
 
 public:
     explicit ManifestCache(
         beast::Journal j = beast::Journal(beast::Journal::getNullSink()))
-        : j_(j)
+        : j_(j), keys_(std::make_shared<Keys const>())
     {
     }
 
@@ -20,6 +20,7 @@
 #include <ripple/app/consensus/RCLConsensus.h>
 #include <ripple/app/consensus/RCLValidations.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/ledger/BookSnapshot.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerToJson.h>
@@ -37,10 +38,13 @@
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/app/rdb/RelationalDBInterface.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/PerfLog.h>
+#include <ripple/basics/Tracer.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/basics/base64.h>
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/basics/mulDiv.h>
 #include <ripple/basics/safe_cast.h>
 #include <ripple/beast/core/LexicalCast.h>
@@ -52,16 +56,20 @@
 #include <ripple/crypto/RFC1751.h>
 #include <ripple/crypto/csprng.h>
 #include <ripple/json/to_string.h>
+#include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/overlay/Cluster.h>
 #include <ripple/overlay/Overlay.h>
+#include <ripple/overlay/Squelch.h>
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/resource/ResourceManager.h>
 #include <ripple/rpc/DeliveredAmount.h>
+#include <ripple/rpc/impl/Tuning.h>
 #include <boost/asio/ip/host_name.hpp>
 #include <boost/asio/steady_timer.hpp>
 
+#include <deque>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -232,6 +240,7 @@ public:
         , mMode(start_valid ? OperatingMode::FULL : OperatingMode::DISCONNECTED)
         , heartbeatTimer_(io_svc)
         , clusterTimer_(io_svc)
+        , batchTimer_(io_svc)
         , mConsensus(
               app,
               make_FeeVote(
@@ -249,6 +258,8 @@ public:
         , minPeerCount_(start_valid ? 0 : minPeerCount)
         , m_stats(std::bind(&NetworkOPsImp::collect_metrics, this), collector)
     {
+        for (auto& map : mStreamMaps)
+            map = std::make_shared<SubMapType const>();
     }
 
     ~NetworkOPsImp() override
@@ -257,6 +268,7 @@ public:
         // destroyed NOW because the objects in this map invoke methods on this
         // class when they are destroyed
         mRpcSubMap.clear();
+        publications_.clear();
     }
 
 public:
@@ -290,6 +302,22 @@ public:
         bool bLocal,
         FailHard failType) override;
 
+    void
+    processTransactionSet(
+        std::vector<std::shared_ptr<Transaction>>& transactions,
+        bool bUnlimited,
+        FailHard failType) override;
+
+    /**
+     * Check a transaction before it is applied.
+     *
+     * @param transaction Transaction object. It may be replaced by the
+     *        canonical copy.
+     * @return false if the transaction was rejected.
+     */
+    bool
+    preprocessTransaction(std::shared_ptr<Transaction>& transaction);
+
     /**
      * For transactions submitted directly by a client, apply batch of
      * transactions and wait for this transaction to complete.
@@ -304,6 +332,15 @@ public:
         bool bUnlimited,
         FailHard failType);
 
+    /**
+     * Like doTransactionSync, for several transactions.
+     */
+    void
+    doTransactionSetSync(
+        std::vector<std::shared_ptr<Transaction>> const& transactions,
+        bool bUnlimited,
+        FailHard failType);
+
     /**
      * For transactions not submitted by a locally connected client, fire and
      * forget. Add to batch and trigger it to be processed if there's no batch
@@ -320,11 +357,21 @@ public:
         FailHard failtype);
 
     /**
-     * Apply transactions in batches. Continue until none are queued.
+     * Apply a batch of transactions. If more are queued, schedule another
+     * batch, so that the master lock is released in between.
      */
     void
     transactionBatch();
 
+    /**
+     * Schedule a job to apply the queued transactions, after collecting
+     * more of them for the configured interval.
+     *
+     * @param Lock that protects the transaction batching
+     */
+    void
+    scheduleTransactionBatch(std::lock_guard<std::mutex> const& batchLock);
+
     /**
      * Attempt to apply transactions and post-process based on the results.
      *
@@ -480,20 +527,6 @@ public:
         return m_localTX->size();
     }
 
-    // Helper function to generate SQL query to get transactions.
-    std::string
-    transactionsSQL(
-        std::string selection,
-        AccountID const& account,
-        std::int32_t minLedger,
-        std::int32_t maxLedger,
-        bool descending,
-        std::uint32_t offset,
-        int limit,
-        bool binary,
-        bool count,
-        bool bUnlimited);
-
     // Client information retrieval functions.
     using NetworkOPs::AccountTxMarker;
     using NetworkOPs::AccountTxs;
@@ -659,6 +692,14 @@ public:
                     << "NetworkOPs: clusterTimer cancel error: "
                     << ec.message();
             }
+
+            ec.clear();
+            batchTimer_.cancel(ec);
+            if (ec)
+            {
+                JLOG(m_journal.error())
+                    << "NetworkOPs: batchTimer cancel error: " << ec.message();
+            }
         }
         // Make sure that any waitHandlers pending in our timers are done
         // before we declare ourselves stopped.
@@ -702,9 +743,20 @@ private:
     std::string
     getHostId(bool forAdmin);
 
+    // Find a page of an account's transactions in the node's database,
+    // continuing in the shard store for ledgers older than it holds
+    void
+    getAccountTxsPage(
+        RelationalDBInterface::AccountTxOptions const& options,
+        bool forward,
+        std::optional<AccountTxMarker>& marker,
+        std::uint32_t pageLength,
+        RelationalDBInterface::TxCallback const& onTransaction);
+
 private:
     using SubMapType = hash_map<std::uint64_t, InfoSub::wptr>;
-    using SubInfoMapType = hash_map<AccountID, SubMapType>;
+    using SubMapPtr = std::shared_ptr<SubMapType const>;
+    using SubInfoMapType = flat_hash_map<AccountID, SubMapType>;
     using subRpcMapType = hash_map<std::string, InfoSub::pointer>;
 
     Application& app_;
@@ -724,6 +776,7 @@ private:
     ClosureCounter<void, boost::system::error_code const&> waitHandlerCounter_;
     boost::asio::steady_timer heartbeatTimer_;
     boost::asio::steady_timer clusterTimer_;
+    boost::asio::steady_timer batchTimer_;
 
     RCLConsensus mConsensus;
 
@@ -750,7 +803,50 @@ private:
         sLastEntry = sConsensusPhase  // as this name implies, any new entry
                                       // must be ADDED ABOVE this one
     };
-    std::array<SubMapType, SubTypes::sLastEntry + 1> mStreamMaps;
+
+    // Each stream's subscribers. A map is never changed once published:
+    // subscribing or unsubscribing copies it under mSubLock and swaps in
+    // the copy, so publishing never has to take the lock.
+    std::array<SubMapPtr, SubTypes::sLastEntry + 1> mStreamMaps;
+
+    SubMapPtr
+    streamSubscribers(SubTypes stream) const;
+
+    bool
+    subStream(SubTypes stream, InfoSub::ref isrListener);
+
+    bool
+    unsubStream(SubTypes stream, std::uint64_t uSeq);
+
+    // A message waiting to be sent to subscribers.
+    struct Publication
+    {
+        std::vector<SubMapPtr> streams;
+        std::vector<InfoSub::pointer> listeners;
+        Json::Value message;
+    };
+
+    // Messages are sent by a single job in the order they were published,
+    // so a slow subscriber never holds up the thread which published.
+    std::mutex publishMutex_;
+    std::deque<Publication> publications_;
+    bool publishing_ = false;
+
+    // Order books in closed ledgers read for book_offers and subscribers
+    BookSnapshots bookSnapshots_{RPC::Tuning::bookOffers.rmax};
+
+    /** Send a message to the subscribers of some streams and to some other
+        listeners. A listener subscribed to several of the streams gets the
+        message once for each.
+    */
+    void
+    publish(
+        std::vector<SubMapPtr> streams,
+        std::vector<InfoSub::pointer> listeners,
+        Json::Value message);
+
+    void
+    sendPublications();
 
     ServerFeeSummary mLastFeeSummary;
 
@@ -805,6 +901,8 @@ private:
                   "Tracking_transitions"))
             , full_transitions(
                   collector->make_gauge("State_Accounting", "Full_transitions"))
+            , transaction_batch_size(
+                  collector->make_event("NetworkOPs", "Transaction_Batch_Size"))
         {
         }
 
@@ -820,6 +918,8 @@ private:
         beast::insight::Gauge syncing_transitions;
         beast::insight::Gauge tracking_transitions;
         beast::insight::Gauge full_transitions;
+
+        beast::insight::Event transaction_batch_size;
     };
 
     std::mutex m_statsMutex;  // Mutex to lock m_stats
@@ -1158,6 +1258,40 @@ NetworkOPsImp::processTransaction(
     FailHard failType)
 {
     auto ev = m_job_queue.makeLoadEvent(jtTXN_PROC, "ProcessTXN");
+    perf::trace::Span span("ops.process", transaction->getID());
+
+    if (!preprocessTransaction(transaction))
+        return;
+
+    if (bLocal)
+        doTransactionSync(transaction, bUnlimited, failType);
+    else
+        doTransactionAsync(transaction, bUnlimited, failType);
+}
+
+void
+NetworkOPsImp::processTransactionSet(
+    std::vector<std::shared_ptr<Transaction>>& transactions,
+    bool bUnlimited,
+    FailHard failType)
+{
+    auto ev = m_job_queue.makeLoadEvent(jtTXN_PROC, "ProcessTXNSet");
+
+    std::vector<std::shared_ptr<Transaction>> accepted;
+    accepted.reserve(transactions.size());
+    for (auto& transaction : transactions)
+    {
+        if (preprocessTransaction(transaction))
+            accepted.push_back(transaction);
+    }
+
+    if (!accepted.empty())
+        doTransactionSetSync(accepted, bUnlimited, failType);
+}
+
+bool
+NetworkOPsImp::preprocessTransaction(std::shared_ptr<Transaction>& transaction)
+{
     auto const newFlags = app_.getHashRouter().getFlags(transaction->getID());
 
     if ((newFlags & SF_BAD) != 0)
@@ -1165,7 +1299,7 @@ NetworkOPsImp::processTransaction(
         // cached bad
         transaction->setStatus(INVALID);
         transaction->setResult(temBAD_SIGNATURE);
-        return;
+        return false;
     }
 
     // NOTE eahennis - I think this check is redundant,
@@ -1186,16 +1320,12 @@ NetworkOPsImp::processTransaction(
         transaction->setStatus(INVALID);
         transaction->setResult(temBAD_SIGNATURE);
         app_.getHashRouter().setFlags(transaction->getID(), SF_BAD);
-        return;
+        return false;
     }
 
     // canonicalize can change our pointer
     app_.getMasterTransaction().canonicalize(&transaction);
-
-    if (bLocal)
-        doTransactionSync(transaction, bUnlimited, failType);
-    else
-        doTransactionAsync(transaction, bUnlimited, failType);
+    return true;
 }
 
 void
@@ -1214,6 +1344,15 @@ NetworkOPsImp::doTransactionAsync(
     transaction->setApplying();
 
     if (mDispatchState == DispatchState::none)
+        scheduleTransactionBatch(lock);
+}
+
+void
+NetworkOPsImp::scheduleTransactionBatch(
+    std::lock_guard<std::mutex> const& batchLock)
+{
+    auto const interval = app_.config().TX_BATCH_INTERVAL;
+    if (interval == std::chrono::milliseconds::zero())
     {
         if (m_job_queue.addJob(jtBATCH, "transactionBatch", [this](Job&) {
                 transactionBatch();
@@ -1221,6 +1360,30 @@ NetworkOPsImp::doTransactionAsync(
         {
             mDispatchState = DispatchState::scheduled;
         }
+        return;
+    }
+
+    // Only start the timer if waitHandlerCounter_ is not yet joined.
+    if (auto optionalCountedHandler = waitHandlerCounter_.wrap(
+            [this](boost::system::error_code const& e) {
+                // Cancelled because we are stopping
+                if (e == boost::asio::error::operation_aborted)
+                    return;
+                if (!e && !m_job_queue.isStopped() &&
+                    m_job_queue.addJob(
+                        jtBATCH, "transactionBatch", [this](Job&) {
+                            transactionBatch();
+                        }))
+                    return;
+                // Let the next transaction schedule a batch
+                std::lock_guard lock(mMutex);
+                if (mDispatchState == DispatchState::scheduled)
+                    mDispatchState = DispatchState::none;
+            }))
+    {
+        batchTimer_.expires_from_now(interval);
+        batchTimer_.async_wait(std::move(*optionalCountedHandler));
+        mDispatchState = DispatchState::scheduled;
     }
 }
 
@@ -1229,16 +1392,35 @@ NetworkOPsImp::doTransactionSync(
     std::shared_ptr<Transaction> transaction,
     bool bUnlimited,
     FailHard failType)
+{
+    doTransactionSetSync({std::move(transaction)}, bUnlimited, failType);
+}
+
+void
+NetworkOPsImp::doTransactionSetSync(
+    std::vector<std::shared_ptr<Transaction>> const& transactions,
+    bool bUnlimited,
+    FailHard failType)
 {
     std::unique_lock<std::mutex> lock(mMutex);
 
-    if (!transaction->getApplying())
+    for (auto const& transaction : transactions)
     {
-        mTransactions.push_back(
-            TransactionStatus(transaction, bUnlimited, true, failType));
-        transaction->setApplying();
+        if (!transaction->getApplying())
+        {
+            mTransactions.push_back(
+                TransactionStatus(transaction, bUnlimited, true, failType));
+            transaction->setApplying();
+        }
     }
 
+    auto const applying = [&transactions]() {
+        return std::any_of(
+            transactions.begin(), transactions.end(), [](auto const& t) {
+                return t->getApplying();
+            });
+    };
+
     do
     {
         if (mDispatchState == DispatchState::running)
@@ -1262,7 +1444,7 @@ NetworkOPsImp::doTransactionSync(
                 }
             }
         }
-    } while (transaction->getApplying());
+    } while (applying());
 }
 
 void
@@ -1273,9 +1455,18 @@ NetworkOPsImp::transactionBatch()
     if (mDispatchState == DispatchState::running)
         return;
 
-    while (mTransactions.size())
-    {
+    if (mTransactions.size())
         apply(lock);
+
+    // Leave the master lock free for others before the next batch
+    if (mTransactions.size() && mDispatchState == DispatchState::none)
+    {
+        if (m_job_queue.addJob(jtBATCH, "transactionBatch", [this](Job&) {
+                transactionBatch();
+            }))
+        {
+            mDispatchState = DispatchState::scheduled;
+        }
     }
 }
 
@@ -1284,8 +1475,27 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 {
     std::vector<TransactionStatus> submit_held;
     std::vector<TransactionStatus> transactions;
-    mTransactions.swap(transactions);
+    if (auto const limit = app_.config().TX_BATCH_MAX_SIZE;
+        limit == 0 || mTransactions.size() <= limit)
+    {
+        mTransactions.swap(transactions);
+    }
+    else
+    {
+        // Leave the rest queued for the next batch
+        auto const middle = mTransactions.begin() + limit;
+        std::vector<TransactionStatus> batch(
+            std::make_move_iterator(mTransactions.begin()),
+            std::make_move_iterator(middle));
+        std::vector<TransactionStatus> rest(
+            std::make_move_iterator(middle),
+            std::make_move_iterator(mTransactions.end()));
+        transactions.swap(batch);
+        mTransactions.swap(rest);
+    }
     assert(!transactions.empty());
+    m_stats.transaction_batch_size.notify(
+        beast::insight::Event::value_type{transactions.size()});
 
     assert(mDispatchState != DispatchState::running);
     mDispatchState = DispatchState::running;
@@ -1311,6 +1521,7 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                     if (e.failType == FailHard::yes)
                         flags |= tapFAIL_HARD;
 
+                    perf::trace::Span span("ops.apply", e.transaction->getID());
                     auto const result = app_.getTxQ().apply(
                         app_, view, e.transaction->getSTransaction(), flags, j);
                     e.result = result.first;
@@ -1334,6 +1545,7 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
             if (e.applied)
             {
+                perf::trace::Span span("ops.publish", e.transaction->getID());
                 pubProposedTransaction(
                     newOL, e.transaction->getSTransaction(), e.result);
                 e.transaction->setApplied();
@@ -1437,6 +1649,7 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
                 if (toSkip)
                 {
+                    perf::trace::Span span("ops.relay", e.transaction->getID());
                     protocol::TMTransaction tx;
                     Serializer s;
 
@@ -1447,9 +1660,12 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
                         app_.timeKeeper().now().time_since_epoch().count());
                     tx.set_deferred(e.result == terQUEUED);
                     // FIXME: This should be when we received it
-                    app_.overlay().foreach(send_if_not(
-                        std::make_shared<Message>(tx, protocol::mtTRANSACTION),
-                        peer_in_set(*toSkip)));
+                    app_.overlay().relay(
+                        tx,
+                        e.transaction->getID(),
+                        *toSkip,
+                        squelch::transactionSource(
+                            *e.transaction->getSTransaction()));
                     e.transaction->setBroadcast();
                 }
             }
@@ -1874,10 +2090,8 @@ NetworkOPsImp::consensusViewChange()
 void
 NetworkOPsImp::pubManifest(Manifest const& mo)
 {
-    // VFALCO consider std::shared_mutex
-    std::lock_guard sl(mSubLock);
-
-    if (!mStreamMaps[sManifests].empty())
+    auto subscribers = streamSubscribers(sManifests);
+    if (!subscribers->empty())
     {
         Json::Value jvObj(Json::objectValue);
 
@@ -1891,19 +2105,7 @@ NetworkOPsImp::pubManifest(Manifest const& mo)
             jvObj[jss::signature] = strHex(*sig);
         jvObj[jss::master_signature] = strHex(mo.getMasterSignature());
 
-        for (auto i = mStreamMaps[sManifests].begin();
-             i != mStreamMaps[sManifests].end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sManifests].erase(i);
-            }
-        }
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 }
 
@@ -1950,13 +2152,8 @@ trunc32(std::uint64_t v)
 void
 NetworkOPsImp::pubServer()
 {
-    // VFALCO TODO Don't hold the lock across calls to send...make a copy of the
-    //             list into a local array while holding the lock then release
-    //             the lock and call send on everyone.
-    //
-    std::lock_guard sl(mSubLock);
-
-    if (!mStreamMaps[sServer].empty())
+    auto subscribers = streamSubscribers(sServer);
+    if (!subscribers->empty())
     {
         Json::Value jvObj(Json::objectValue);
 
@@ -1992,63 +2189,34 @@ NetworkOPsImp::pubServer()
         else
             jvObj[jss::load_factor] = f.loadFactorServer;
 
-        mLastFeeSummary = f;
-
-        for (auto i = mStreamMaps[sServer].begin();
-             i != mStreamMaps[sServer].end();)
         {
-            InfoSub::pointer p = i->second.lock();
-
-            // VFALCO TODO research the possibility of using thread queues and
-            //             linearizing the deletion of subscribers with the
-            //             sending of JSON data.
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sServer].erase(i);
-            }
+            std::lock_guard sl(mSubLock);
+            mLastFeeSummary = f;
         }
+
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 }
 
 void
 NetworkOPsImp::pubConsensus(ConsensusPhase phase)
 {
-    std::lock_guard sl(mSubLock);
-
-    auto& streamMap = mStreamMaps[sConsensusPhase];
-    if (!streamMap.empty())
+    auto subscribers = streamSubscribers(sConsensusPhase);
+    if (!subscribers->empty())
     {
         Json::Value jvObj(Json::objectValue);
         jvObj[jss::type] = "consensusPhase";
         jvObj[jss::consensus] = to_string(phase);
 
-        for (auto i = streamMap.begin(); i != streamMap.end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = streamMap.erase(i);
-            }
-        }
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 }
 
 void
 NetworkOPsImp::pubValidation(std::shared_ptr<STValidation> const& val)
 {
-    // VFALCO consider std::shared_mutex
-    std::lock_guard sl(mSubLock);
-
-    if (!mStreamMaps[sValidations].empty())
+    auto subscribers = streamSubscribers(sValidations);
+    if (!subscribers->empty())
     {
         Json::Value jvObj(Json::objectValue);
 
@@ -2094,48 +2262,21 @@ NetworkOPsImp::pubValidation(std::shared_ptr<STValidation> const& val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj[jss::reserve_inc] = *reserveInc;
 
-        for (auto i = mStreamMaps[sValidations].begin();
-             i != mStreamMaps[sValidations].end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sValidations].erase(i);
-            }
-        }
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 }
 
 void
 NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 {
-    std::lock_guard sl(mSubLock);
-
-    if (!mStreamMaps[sPeerStatus].empty())
+    auto subscribers = streamSubscribers(sPeerStatus);
+    if (!subscribers->empty())
     {
         Json::Value jvObj(func());
 
         jvObj[jss::type] = "peerStatusChange";
 
-        for (auto i = mStreamMaps[sPeerStatus].begin();
-             i != mStreamMaps[sPeerStatus].end();)
-        {
-            InfoSub::pointer p = i->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sPeerStatus].erase(i);
-            }
-        }
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 }
 
@@ -2168,86 +2309,6 @@ NetworkOPsImp::setMode(OperatingMode om)
     pubServer();
 }
 
-std::string
-NetworkOPsImp::transactionsSQL(
-    std::string selection,
-    AccountID const& account,
-    std::int32_t minLedger,
-    std::int32_t maxLedger,
-    bool descending,
-    std::uint32_t offset,
-    int limit,
-    bool binary,
-    bool count,
-    bool bUnlimited)
-{
-    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    std::uint32_t BINARY_PAGE_LENGTH = 500;
-
-    std::uint32_t numberOfResults;
-
-    if (count)
-    {
-        numberOfResults = 1000000000;
-    }
-    else if (limit < 0)
-    {
-        numberOfResults = binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
-    }
-    else if (!bUnlimited)
-    {
-        numberOfResults = std::min(
-            binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH,
-            static_cast<std::uint32_t>(limit));
-    }
-    else
-    {
-        numberOfResults = limit;
-    }
-
-    std::string maxClause = "";
-    std::string minClause = "";
-
-    if (maxLedger != -1)
-    {
-        maxClause = boost::str(
-            boost::format("AND AccountTransactions.LedgerSeq <= '%u'") %
-            maxLedger);
-    }
-
-    if (minLedger != -1)
-    {
-        minClause = boost::str(
-            boost::format("AND AccountTransactions.LedgerSeq >= '%u'") %
-            minLedger);
-    }
-
-    std::string sql;
-
-    if (count)
-        sql = boost::str(
-            boost::format("SELECT %s FROM AccountTransactions "
-                          "WHERE Account = '%s' %s %s LIMIT %u, %u;") %
-            selection % app_.accountIDCache().toBase58(account) % maxClause %
-            minClause % offset % numberOfResults);
-    else
-        sql = boost::str(
-            boost::format(
-                "SELECT %s FROM "
-                "AccountTransactions INNER JOIN Transactions "
-                "ON Transactions.TransID = AccountTransactions.TransID "
-                "WHERE Account = '%s' %s %s "
-                "ORDER BY AccountTransactions.LedgerSeq %s, "
-                "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-                "LIMIT %u, %u;") %
-            selection % app_.accountIDCache().toBase58(account) % maxClause %
-            minClause % (descending ? "DESC" : "ASC") %
-            (descending ? "DESC" : "ASC") % (descending ? "DESC" : "ASC") %
-            offset % numberOfResults);
-    JLOG(m_journal.trace()) << "txSQL query: " << sql;
-    return sql;
-}
-
 NetworkOPs::AccountTxs
 NetworkOPsImp::getAccountTxs(
     AccountID const& account,
@@ -2261,55 +2322,26 @@ NetworkOPsImp::getAccountTxs(
     // can be called with no locks
     AccountTxs ret;
 
-    std::string sql = transactionsSQL(
-        "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta",
-        account,
-        minLedger,
-        maxLedger,
+    RelationalDBInterface::AccountTxOptions const options{
+        account, minLedger, maxLedger, limit, false, bUnlimited};
+
+    app_.getRelationalDBInterface().getAccountTxs(
+        options,
         descending,
         offset,
-        limit,
-        false,
-        false,
-        bUnlimited);
-
-    {
-        auto db = app_.getTxnDB().checkoutDb();
-
-        boost::optional<std::uint64_t> ledgerSeq;
-        boost::optional<std::string> status;
-        soci::blob sociTxnBlob(*db), sociTxnMetaBlob(*db);
-        soci::indicator rti, tmi;
-        Blob rawTxn, txnMeta;
-
-        soci::statement st =
-            (db->prepare << sql,
-             soci::into(ledgerSeq),
-             soci::into(status),
-             soci::into(sociTxnBlob, rti),
-             soci::into(sociTxnMetaBlob, tmi));
-
-        st.execute();
-        while (st.fetch())
-        {
-            if (soci::i_ok == rti)
-                convert(sociTxnBlob, rawTxn);
-            else
-                rawTxn.clear();
-
-            if (soci::i_ok == tmi)
-                convert(sociTxnMetaBlob, txnMeta);
-            else
-                txnMeta.clear();
-
+        [&](std::uint32_t seq,
+            std::string const& status,
+            Blob&& rawTxn,
+            Blob&& txnMeta) {
             auto txn = Transaction::transactionFromSQL(
-                ledgerSeq, status, rawTxn, app_);
+                seq ? boost::optional<std::uint64_t>(seq) : boost::none,
+                status.empty() ? boost::none
+                               : boost::optional<std::string>(status),
+                rawTxn,
+                app_);
 
             if (txnMeta.empty())
             {  // Work around a bug that could leave the metadata missing
-                auto const seq =
-                    rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0));
-
                 JLOG(m_journal.warn())
                     << "Recovering ledger " << seq << ", txn " << txn->getID();
 
@@ -2322,8 +2354,7 @@ NetworkOPsImp::getAccountTxs(
                     txn,
                     std::make_shared<TxMeta>(
                         txn->getID(), txn->getLedger(), txnMeta));
-        }
-    }
+        });
 
     return ret;
 }
@@ -2341,49 +2372,20 @@ NetworkOPsImp::getAccountTxsB(
     // can be called with no locks
     std::vector<txnMetaLedgerType> ret;
 
-    std::string sql = transactionsSQL(
-        "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta",
-        account,
-        minLedger,
-        maxLedger,
+    RelationalDBInterface::AccountTxOptions const options{
+        account, minLedger, maxLedger, limit, true, bUnlimited};
+
+    app_.getRelationalDBInterface().getAccountTxs(
+        options,
         descending,
         offset,
-        limit,
-        true /*binary*/,
-        false,
-        bUnlimited);
-
-    {
-        auto db = app_.getTxnDB().checkoutDb();
-
-        boost::optional<std::uint64_t> ledgerSeq;
-        boost::optional<std::string> status;
-        soci::blob sociTxnBlob(*db), sociTxnMetaBlob(*db);
-        soci::indicator rti, tmi;
-
-        soci::statement st =
-            (db->prepare << sql,
-             soci::into(ledgerSeq),
-             soci::into(status),
-             soci::into(sociTxnBlob, rti),
-             soci::into(sociTxnMetaBlob, tmi));
-
-        st.execute();
-        while (st.fetch())
-        {
-            Blob rawTxn;
-            if (soci::i_ok == rti)
-                convert(sociTxnBlob, rawTxn);
-            Blob txnMeta;
-            if (soci::i_ok == tmi)
-                convert(sociTxnMetaBlob, txnMeta);
-
-            auto const seq =
-                rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0));
-
+        [&ret](
+            std::uint32_t seq,
+            std::string const&,
+            Blob&& rawTxn,
+            Blob&& txnMeta) {
             ret.emplace_back(std::move(rawTxn), std::move(txnMeta), seq);
-        }
-    }
+        });
 
     return ret;
 }
@@ -2411,19 +2413,10 @@ NetworkOPsImp::getTxsAccount(
         convertBlobsToTxResult(ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
-    accountTxPage(
-        app_.getTxnDB(),
-        app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1),
-        bound,
-        account,
-        minLedger,
-        maxLedger,
-        forward,
-        marker,
-        limit,
-        bUnlimited,
-        page_length);
+    RelationalDBInterface::AccountTxOptions const options{
+        account, minLedger, maxLedger, limit, false, bUnlimited};
+
+    getAccountTxsPage(options, forward, marker, page_length, bound);
 
     return ret;
 }
@@ -2450,22 +2443,151 @@ NetworkOPsImp::getTxsAccountB(
         ret.emplace_back(std::move(rawTxn), std::move(rawMeta), ledgerIndex);
     };
 
-    accountTxPage(
-        app_.getTxnDB(),
-        app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1),
-        bound,
-        account,
-        minLedger,
-        maxLedger,
-        forward,
-        marker,
-        limit,
-        bUnlimited,
-        page_length);
+    RelationalDBInterface::AccountTxOptions const options{
+        account, minLedger, maxLedger, limit, true, bUnlimited};
+
+    getAccountTxsPage(options, forward, marker, page_length, bound);
     return ret;
 }
 
+void
+NetworkOPsImp::getAccountTxsPage(
+    RelationalDBInterface::AccountTxOptions const& options,
+    bool forward,
+    std::optional<AccountTxMarker>& marker,
+    std::uint32_t pageLength,
+    RelationalDBInterface::TxCallback const& onTransaction)
+{
+    auto& db = app_.getRelationalDBInterface();
+    auto const onUnsavedLedger =
+        std::bind(saveLedgerAsync, std::ref(app_), std::placeholders::_1);
+
+    // The ledgers before the node's validated range are only found in
+    // the shard store
+    std::uint32_t validMin = 0;
+    std::uint32_t validMax = 0;
+    auto const shardStore = app_.getShardStore();
+    if (!shardStore || options.minLedger < 0 || options.maxLedger < 0 ||
+        !m_ledgerMaster.getValidatedRange(validMin, validMax) ||
+        static_cast<std::uint32_t>(options.minLedger) >= validMin)
+    {
+        db.getAccountTxsPage(
+            options,
+            forward,
+            marker,
+            pageLength,
+            onUnsavedLedger,
+            onTransaction);
+        return;
+    }
+
+    std::size_t const pageLimit =
+        (options.limit <= 0 ||
+         (static_cast<std::uint32_t>(options.limit) > pageLength &&
+          !options.unlimited))
+        ? pageLength
+        : options.limit;
+    std::size_t found = 0;
+    RelationalDBInterface::TxCallback const counted =
+        [&](std::uint32_t ledgerSeq,
+            std::string const& status,
+            Blob&& rawTxn,
+            Blob&& rawMeta) {
+            ++found;
+            onTransaction(
+                ledgerSeq, status, std::move(rawTxn), std::move(rawMeta));
+        };
+
+    std::uint32_t const shardMin = options.minLedger;
+    std::uint32_t const shardMax =
+        std::min<std::uint32_t>(options.maxLedger, validMin - 1);
+    bool const hasNodePart =
+        static_cast<std::uint32_t>(options.maxLedger) >= validMin;
+
+    // Each shard is searched separately, skipping those that hold nothing
+    // for the account. If the page fills at the end of a shard, the
+    // marker resumes from the start of the next one.
+    auto searchShards = [&]() {
+        shardStore->forEachAccountShard(
+            options.account,
+            shardMin,
+            shardMax,
+            forward,
+            [&](DatabaseCon& con, std::uint32_t first, std::uint32_t last) {
+                auto const from = std::max(shardMin, first);
+                auto const to = std::min(shardMax, last);
+                if (marker &&
+                    (forward ? marker->ledgerSeq > to
+                             : marker->ledgerSeq < from))
+                {
+                    return true;
+                }
+
+                accountTxPage(
+                    con,
+                    app_.accountIDCache(),
+                    [](std::uint32_t) {},
+                    counted,
+                    options.account,
+                    from,
+                    to,
+                    forward,
+                    marker,
+                    pageLimit - found,
+                    options.unlimited,
+                    pageLength);
+                if (marker)
+                    return false;
+                if (found < pageLimit)
+                    return true;
+
+                if (forward ? to < shardMax || hasNodePart : from > shardMin)
+                {
+                    marker = forward
+                        ? AccountTxMarker{to + 1, 0}
+                        : AccountTxMarker{
+                              from - 1,
+                              std::numeric_limits<std::uint32_t>::max()};
+                }
+                return false;
+            });
+    };
+
+    auto nodeOptions = options;
+    nodeOptions.minLedger = validMin;
+    auto searchNode = [&]() {
+        nodeOptions.limit = pageLimit - found;
+        db.getAccountTxsPage(
+            nodeOptions,
+            forward,
+            marker,
+            pageLength,
+            onUnsavedLedger,
+            counted);
+    };
+
+    if (forward)
+    {
+        if (!marker || marker->ledgerSeq < validMin)
+            searchShards();
+        if (hasNodePart && !marker && found < pageLimit)
+            searchNode();
+    }
+    else
+    {
+        bool const inShards = marker && marker->ledgerSeq < validMin;
+        if (hasNodePart && !inShards)
+            searchNode();
+        if (marker && !inShards)
+            return;
+        if (found < pageLimit)
+            searchShards();
+        else
+            marker = AccountTxMarker{
+                validMin - 1, std::numeric_limits<std::uint32_t>::max()};
+    }
+}
+
 bool
 NetworkOPsImp::recvValidation(
     std::shared_ptr<STValidation> const& val,
@@ -2627,6 +2749,9 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
     if (fp != 0)
         info[jss::fetch_pack] = Json::UInt(fp);
 
+    if (admin)
+        info[jss::history_fill] = m_ledgerMaster.getHistoryFillJson();
+
     info[jss::peers] = Json::UInt(app_.overlay().size());
 
     Json::Value lastClose = Json::objectValue;
@@ -2826,27 +2951,11 @@ NetworkOPsImp::pubProposedTransaction(
     std::shared_ptr<STTx const> const& stTxn,
     TER terResult)
 {
-    Json::Value jvObj = transJson(*stTxn, terResult, false, lpCurrent);
-
-    {
-        std::lock_guard sl(mSubLock);
-
-        auto it = mStreamMaps[sRTTransactions].begin();
-        while (it != mStreamMaps[sRTTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
+    publish(
+        {streamSubscribers(sRTTransactions)},
+        {},
+        transJson(*stTxn, terResult, false, lpCurrent));
 
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mStreamMaps[sRTTransactions].erase(it);
-            }
-        }
-    }
     AcceptedLedgerTx alt(
         lpCurrent, stTxn, terResult, app_.accountIDCache(), app_.logs());
     JLOG(m_journal.trace()) << "pubProposed: " << alt.getJson();
@@ -2869,50 +2978,34 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
             lpAccepted->info().hash, alpAccepted);
     }
 
+    auto subscribers = streamSubscribers(sLedger);
+    if (!subscribers->empty())
     {
-        std::lock_guard sl(mSubLock);
-
-        if (!mStreamMaps[sLedger].empty())
-        {
-            Json::Value jvObj(Json::objectValue);
-
-            jvObj[jss::type] = "ledgerClosed";
-            jvObj[jss::ledger_index] = lpAccepted->info().seq;
-            jvObj[jss::ledger_hash] = to_string(lpAccepted->info().hash);
-            jvObj[jss::ledger_time] = Json::Value::UInt(
-                lpAccepted->info().closeTime.time_since_epoch().count());
+        Json::Value jvObj(Json::objectValue);
 
-            jvObj[jss::fee_ref] = lpAccepted->fees().units.jsonClipped();
-            jvObj[jss::fee_base] = lpAccepted->fees().base.jsonClipped();
-            jvObj[jss::reserve_base] =
-                lpAccepted->fees().accountReserve(0).jsonClipped();
-            jvObj[jss::reserve_inc] =
-                lpAccepted->fees().increment.jsonClipped();
+        jvObj[jss::type] = "ledgerClosed";
+        jvObj[jss::ledger_index] = lpAccepted->info().seq;
+        jvObj[jss::ledger_hash] = to_string(lpAccepted->info().hash);
+        jvObj[jss::ledger_time] = Json::Value::UInt(
+            lpAccepted->info().closeTime.time_since_epoch().count());
 
-            jvObj[jss::txn_count] = Json::UInt(alpAccepted->getTxnCount());
+        jvObj[jss::fee_ref] = lpAccepted->fees().units.jsonClipped();
+        jvObj[jss::fee_base] = lpAccepted->fees().base.jsonClipped();
+        jvObj[jss::reserve_base] =
+            lpAccepted->fees().accountReserve(0).jsonClipped();
+        jvObj[jss::reserve_inc] = lpAccepted->fees().increment.jsonClipped();
 
-            if (mMode >= OperatingMode::SYNCING)
-            {
-                jvObj[jss::validated_ledgers] =
-                    app_.getLedgerMaster().getCompleteLedgers();
-            }
+        jvObj[jss::txn_count] = Json::UInt(alpAccepted->getTxnCount());
 
-            auto it = mStreamMaps[sLedger].begin();
-            while (it != mStreamMaps[sLedger].end())
-            {
-                InfoSub::pointer p = it->second.lock();
-                if (p)
-                {
-                    p->send(jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mStreamMaps[sLedger].erase(it);
-            }
+        if (mMode >= OperatingMode::SYNCING)
+        {
+            jvObj[jss::validated_ledgers] =
+                app_.getLedgerMaster().getCompleteLedgers();
         }
+
+        publish({std::move(subscribers)}, {}, std::move(jvObj));
     }
 
-    // Don't lock since pubAcceptedTransaction is locking.
     for (auto const& [_, accTx] : alpAccepted->getMap())
     {
         (void)_;
@@ -3023,39 +3116,17 @@ NetworkOPsImp::pubValidatedTransaction(
             jvObj[jss::meta], *alAccepted, stTxn, *txMeta);
     }
 
-    {
-        std::lock_guard sl(mSubLock);
-
-        auto it = mStreamMaps[sTransactions].begin();
-        while (it != mStreamMaps[sTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sTransactions].erase(it);
-        }
-
-        it = mStreamMaps[sRTTransactions].begin();
+    publish(
+        {streamSubscribers(sTransactions), streamSubscribers(sRTTransactions)},
+        {},
+        jvObj);
 
-        while (it != mStreamMaps[sRTTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
+    // Book subscribers get the transaction through the same queue, so it
+    // reaches them in order with the other streams
+    if (auto listeners = app_.getOrderBookDB().getBookSubscribers(alTx);
+        !listeners.empty())
+        publish({}, std::move(listeners), jvObj);
 
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sRTTransactions].erase(it);
-        }
-    }
-    app_.getOrderBookDB().processTxn(alAccepted, alTx, jvObj);
     pubAccountTransaction(alAccepted, alTx, true);
 }
 
@@ -3144,8 +3215,7 @@ NetworkOPsImp::pubAccountTransaction(
             }
         }
 
-        for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+        publish({}, {notify.begin(), notify.end()}, std::move(jvObj));
     }
 }
 
@@ -3179,8 +3249,7 @@ NetworkOPsImp::subAccount(
             // Not found, note that account has a new single listner.
             SubMapType usisElement;
             usisElement[isrListener->getSeq()] = isrListener;
-            // VFALCO NOTE This is making a needless copy of naAccountID
-            subMap.insert(simIterator, make_pair(naAccountID, usisElement));
+            subMap.emplace(naAccountID, std::move(usisElement));
         }
         else
         {
@@ -3295,36 +3364,28 @@ NetworkOPsImp::subLedger(InfoSub::ref isrListener, Json::Value& jvResult)
             app_.getLedgerMaster().getCompleteLedgers();
     }
 
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sLedger]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sLedger, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubLedger(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sLedger].erase(uSeq);
+    return unsubStream(sLedger, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subManifests(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sManifests]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sManifests, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubManifests(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sManifests].erase(uSeq);
+    return unsubStream(sManifests, uSeq);
 }
 
 // <-- bool: true=added, false=already there
@@ -3351,108 +3412,169 @@ NetworkOPsImp::subServer(
     jvResult[jss::pubkey_node] =
         toBase58(TokenType::NodePublic, app_.nodeIdentity().first);
 
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sServer]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sServer, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubServer(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sServer].erase(uSeq);
+    return unsubStream(sServer, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subTransactions(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sTransactions]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sTransactions, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubTransactions(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sTransactions].erase(uSeq);
+    return unsubStream(sTransactions, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subRTTransactions(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sRTTransactions]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sRTTransactions, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubRTTransactions(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sRTTransactions].erase(uSeq);
+    return unsubStream(sRTTransactions, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subValidations(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sValidations]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sValidations, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubValidations(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sValidations].erase(uSeq);
+    return unsubStream(sValidations, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subPeerStatus(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sPeerStatus]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sPeerStatus, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubPeerStatus(std::uint64_t uSeq)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sPeerStatus].erase(uSeq);
+    return unsubStream(sPeerStatus, uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool
 NetworkOPsImp::subConsensus(InfoSub::ref isrListener)
 {
-    std::lock_guard sl(mSubLock);
-    return mStreamMaps[sConsensusPhase]
-        .emplace(isrListener->getSeq(), isrListener)
-        .second;
+    return subStream(sConsensusPhase, isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubConsensus(std::uint64_t uSeq)
+{
+    return unsubStream(sConsensusPhase, uSeq);
+}
+
+NetworkOPsImp::SubMapPtr
+NetworkOPsImp::streamSubscribers(SubTypes stream) const
+{
+    return std::atomic_load(&mStreamMaps[stream]);
+}
+
+bool
+NetworkOPsImp::subStream(SubTypes stream, InfoSub::ref isrListener)
+{
+    std::lock_guard sl(mSubLock);
+    auto map = std::make_shared<SubMapType>(*mStreamMaps[stream]);
+    if (!map->emplace(isrListener->getSeq(), isrListener).second)
+        return false;
+    std::atomic_store(&mStreamMaps[stream], SubMapPtr(std::move(map)));
+    return true;
+}
+
+bool
+NetworkOPsImp::unsubStream(SubTypes stream, std::uint64_t uSeq)
 {
     std::lock_guard sl(mSubLock);
-    return mStreamMaps[sConsensusPhase].erase(uSeq);
+    if (!mStreamMaps[stream]->count(uSeq))
+        return false;
+    auto map = std::make_shared<SubMapType>(*mStreamMaps[stream]);
+    map->erase(uSeq);
+    std::atomic_store(&mStreamMaps[stream], SubMapPtr(std::move(map)));
+    return true;
+}
+
+void
+NetworkOPsImp::publish(
+    std::vector<SubMapPtr> streams,
+    std::vector<InfoSub::pointer> listeners,
+    Json::Value message)
+{
+    {
+        std::lock_guard lock(publishMutex_);
+        publications_.push_back(
+            {std::move(streams), std::move(listeners), std::move(message)});
+        if (publishing_)
+            return;
+        publishing_ = true;
+    }
+
+    if (!m_job_queue.addJob(jtCLIENT, "NetworkOPs::publish", [this](Job&) {
+            sendPublications();
+        }))
+    {
+        // The job queue is stopping, so send from here instead.
+        sendPublications();
+    }
+}
+
+void
+NetworkOPsImp::sendPublications()
+{
+    for (;;)
+    {
+        Publication pub;
+        {
+            std::lock_guard lock(publishMutex_);
+            if (publications_.empty())
+            {
+                publishing_ = false;
+                return;
+            }
+            pub = std::move(publications_.front());
+            publications_.pop_front();
+        }
+
+        PublishedJson const msg(pub.message);
+        for (auto const& map : pub.streams)
+        {
+            for (auto const& [_, wp] : *map)
+            {
+                (void)_;
+                if (auto p = wp.lock())
+                    p->send(msg, true);
+            }
+        }
+        for (auto const& p : pub.listeners)
+            p->send(msg, true);
+    }
 }
 
 InfoSub::pointer
@@ -3489,9 +3611,9 @@ NetworkOPsImp::tryRemoveRpcSub(std::string const& strUrl)
 
     // check to see if any of the stream maps still hold a weak reference to
     // this entry before removing
-    for (SubMapType const& map : mStreamMaps)
+    for (auto const& map : mStreamMaps)
     {
-        if (map.find(pInfo->getSeq()) != map.end())
+        if (std::atomic_load(&map)->count(pInfo->getSeq()))
             return false;
     }
     mRpcSubMap.erase(strUrl);
@@ -3516,201 +3638,93 @@ NetworkOPsImp::getBookPage(
     Json::Value& jvOffers =
         (jvResult[jss::offers] = Json::Value(Json::arrayValue));
 
-    std::map<AccountID, STAmount> umBalance;
-    const uint256 uBookBase = getBookBase(book);
-    const uint256 uBookEnd = getQualityNext(uBookBase);
-    uint256 uTipIndex = uBookBase;
-
     if (auto stream = m_journal.trace())
-    {
         stream << "getBookPage:" << book;
-        stream << "getBookPage: uBookBase=" << uBookBase;
-        stream << "getBookPage: uBookEnd=" << uBookEnd;
-        stream << "getBookPage: uTipIndex=" << uTipIndex;
-    }
-
-    ReadView const& view = *lpLedger;
-
-    bool const bGlobalFreeze = isGlobalFrozen(view, book.out.account) ||
-        isGlobalFrozen(view, book.in.account);
 
-    bool bDone = false;
-    bool bDirectAdvance = true;
-
-    std::shared_ptr<SLE const> sleOfferDir;
-    uint256 offerIndex;
-    unsigned int uBookEntry;
-    STAmount saDirRate;
+    // Books in closed ledgers are read once and shared between requests
+    auto const viewJ = app_.journal("View");
+    auto snapshot = bookSnapshots_.get(lpLedger, book, iLimit, viewJ);
+    if (!snapshot)
+    {
+        snapshot = std::make_shared<BookSnapshot const>(
+            *lpLedger, book, iLimit, viewJ);
+    }
 
-    auto const rate = transferRate(view, book.out.account);
-    auto viewJ = app_.journal("View");
+    std::map<AccountID, STAmount> umBalance;
+    auto const rate = transferRate(*lpLedger, book.out.account);
 
-    while (!bDone && iLimit-- > 0)
+    for (auto const& offer : snapshot->offers())
     {
-        if (bDirectAdvance)
-        {
-            bDirectAdvance = false;
-
-            JLOG(m_journal.trace()) << "getBookPage: bDirectAdvance";
+        if (iLimit-- == 0)
+            break;
 
-            auto const ledgerIndex = view.succ(uTipIndex, uBookEnd);
-            if (ledgerIndex)
-                sleOfferDir = view.read(keylet::page(*ledgerIndex));
-            else
-                sleOfferDir.reset();
+        auto const& uOfferOwnerID = offer.owner;
+        auto const& saTakerGets = offer.takerGets;
+        auto const& saTakerPays = offer.takerPays;
+        auto const& saDirRate = offer.quality;
+        STAmount saOwnerFunds = offer.ownerFunds;
+        bool firstOwnerOffer(true);
 
-            if (!sleOfferDir)
-            {
-                JLOG(m_journal.trace()) << "getBookPage: bDone";
-                bDone = true;
-            }
-            else
-            {
-                uTipIndex = sleOfferDir->key();
-                saDirRate = amountFromQuality(getQuality(uTipIndex));
-
-                cdirFirst(
-                    view,
-                    uTipIndex,
-                    sleOfferDir,
-                    uBookEntry,
-                    offerIndex,
-                    viewJ);
-
-                JLOG(m_journal.trace())
-                    << "getBookPage:   uTipIndex=" << uTipIndex;
-                JLOG(m_journal.trace())
-                    << "getBookPage: offerIndex=" << offerIndex;
-            }
-        }
-
-        if (!bDone)
+        if (book.out.account != uOfferOwnerID && !snapshot->frozen())
         {
-            auto sleOffer = view.read(keylet::offer(offerIndex));
-
-            if (sleOffer)
+            auto umBalanceEntry = umBalance.find(uOfferOwnerID);
+            if (umBalanceEntry != umBalance.end())
             {
-                auto const uOfferOwnerID = sleOffer->getAccountID(sfAccount);
-                auto const& saTakerGets = sleOffer->getFieldAmount(sfTakerGets);
-                auto const& saTakerPays = sleOffer->getFieldAmount(sfTakerPays);
-                STAmount saOwnerFunds;
-                bool firstOwnerOffer(true);
-
-                if (book.out.account == uOfferOwnerID)
-                {
-                    // If an offer is selling issuer's own IOUs, it is fully
-                    // funded.
-                    saOwnerFunds = saTakerGets;
-                }
-                else if (bGlobalFreeze)
-                {
-                    // If either asset is globally frozen, consider all offers
-                    // that aren't ours to be totally unfunded
-                    saOwnerFunds.clear(book.out);
-                }
-                else
-                {
-                    auto umBalanceEntry = umBalance.find(uOfferOwnerID);
-                    if (umBalanceEntry != umBalance.end())
-                    {
-                        // Found in running balance table.
+                // Found in running balance table.
 
-                        saOwnerFunds = umBalanceEntry->second;
-                        firstOwnerOffer = false;
-                    }
-                    else
-                    {
-                        // Did not find balance in table.
-
-                        saOwnerFunds = accountHolds(
-                            view,
-                            uOfferOwnerID,
-                            book.out.currency,
-                            book.out.account,
-                            fhZERO_IF_FROZEN,
-                            viewJ);
-
-                        if (saOwnerFunds < beast::zero)
-                        {
-                            // Treat negative funds as zero.
-
-                            saOwnerFunds.clear();
-                        }
-                    }
-                }
+                saOwnerFunds = umBalanceEntry->second;
+                firstOwnerOffer = false;
+            }
+        }
 
-                Json::Value jvOffer = sleOffer->getJson(JsonOptions::none);
+        Json::Value jvOffer = offer.sle->getJson(JsonOptions::none);
 
-                STAmount saTakerGetsFunded;
-                STAmount saOwnerFundsLimit = saOwnerFunds;
-                Rate offerRate = parityRate;
+        STAmount saTakerGetsFunded;
+        STAmount saOwnerFundsLimit = saOwnerFunds;
+        Rate offerRate = parityRate;
 
-                if (rate != parityRate
-                    // Have a tranfer fee.
-                    && uTakerID != book.out.account
-                    // Not taking offers of own IOUs.
-                    && book.out.account != uOfferOwnerID)
-                // Offer owner not issuing ownfunds
-                {
-                    // Need to charge a transfer fee to offer owner.
-                    offerRate = rate;
-                    saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
-                }
-
-                if (saOwnerFundsLimit >= saTakerGets)
-                {
-                    // Sufficient funds no shenanigans.
-                    saTakerGetsFunded = saTakerGets;
-                }
-                else
-                {
-                    // Only provide, if not fully funded.
+        if (rate != parityRate
+            // Have a tranfer fee.
+            && uTakerID != book.out.account
+            // Not taking offers of own IOUs.
+            && book.out.account != uOfferOwnerID)
+        // Offer owner not issuing ownfunds
+        {
+            // Need to charge a transfer fee to offer owner.
+            offerRate = rate;
+            saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
+        }
 
-                    saTakerGetsFunded = saOwnerFundsLimit;
+        if (saOwnerFundsLimit >= saTakerGets)
+        {
+            // Sufficient funds no shenanigans.
+            saTakerGetsFunded = saTakerGets;
+        }
+        else
+        {
+            // Only provide, if not fully funded.
 
-                    saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
-                    std::min(
-                        saTakerPays,
-                        multiply(
-                            saTakerGetsFunded, saDirRate, saTakerPays.issue()))
-                        .setJson(jvOffer[jss::taker_pays_funded]);
-                }
+            saTakerGetsFunded = saOwnerFundsLimit;
 
-                STAmount saOwnerPays = (parityRate == offerRate)
-                    ? saTakerGetsFunded
-                    : std::min(
-                          saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
+            saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
+            std::min(
+                saTakerPays,
+                multiply(saTakerGetsFunded, saDirRate, saTakerPays.issue()))
+                .setJson(jvOffer[jss::taker_pays_funded]);
+        }
 
-                umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
+        STAmount saOwnerPays = (parityRate == offerRate)
+            ? saTakerGetsFunded
+            : std::min(saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
 
-                // Include all offers funded and unfunded
-                Json::Value& jvOf = jvOffers.append(jvOffer);
-                jvOf[jss::quality] = saDirRate.getText();
+        umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
 
-                if (firstOwnerOffer)
-                    jvOf[jss::owner_funds] = saOwnerFunds.getText();
-            }
-            else
-            {
-                JLOG(m_journal.warn()) << "Missing offer";
-            }
+        // Include all offers funded and unfunded
+        Json::Value& jvOf = jvOffers.append(jvOffer);
+        jvOf[jss::quality] = saDirRate.getText();
 
-            if (!cdirNext(
-                    view,
-                    uTipIndex,
-                    sleOfferDir,
-                    uBookEntry,
-                    offerIndex,
-                    viewJ))
-            {
-                bDirectAdvance = true;
-            }
-            else
-            {
-                JLOG(m_journal.trace())
-                    << "getBookPage: offerIndex=" << offerIndex;
-            }
-        }
+        if (firstOwnerOffer)
+            jvOf[jss::owner_funds] = saOwnerFunds.getText();
     }
 
     //  jvResult[jss::marker]  = Json::Value(Json::arrayValue);
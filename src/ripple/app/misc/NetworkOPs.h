@@ -141,6 +141,22 @@ public:
         bool bLocal,
         FailHard failType) = 0;
 
+    /**
+     * Process transactions submitted together by a client. They are added
+     * to the pending batch at once and applied with as few acquisitions of
+     * the master lock as possible. Returns once every one has a result.
+     *
+     * @param transactions Transaction objects. An entry may be replaced by
+     *        the server's existing copy of the same transaction.
+     * @param bUnlimited Whether a privileged client connection submitted them.
+     * @param failType fail_hard setting from transaction submission.
+     */
+    virtual void
+    processTransactionSet(
+        std::vector<std::shared_ptr<Transaction>>& transactions,
+        bool bUnlimited,
+        FailHard failType) = 0;
+
     //--------------------------------------------------------------------------
     //
     // Owner functions
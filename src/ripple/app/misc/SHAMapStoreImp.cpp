@@ -197,6 +197,9 @@ SHAMapStoreImp::SHAMapStoreImp(
             ageThreshold_ = std::chrono::seconds{temp};
         if (get_if_exists(section, "recovery_wait_seconds", temp))
             recoveryWaitTime_.emplace(std::chrono::seconds{temp});
+        if (get_if_exists(section, "copy_threads", temp))
+            copyThreads_ = std::max<std::uint32_t>(temp, 1);
+        get_if_exists(section, "copy_rate", copyRate_);
 
         get_if_exists(section, "advisory_delete", advisoryDelete_);
 
@@ -221,6 +224,22 @@ SHAMapStoreImp::SHAMapStoreImp(
         state_db_.init(config, dbName_);
         dbPaths();
     }
+
+    if (section.exists("cold_type"))
+    {
+        if (!deleteInterval_)
+        {
+            Throw<std::runtime_error>(
+                "cold_type requires online_delete, which moves nodes to it");
+        }
+
+        auto const coldPath = get<std::string>(section, "cold_path");
+        if (coldPath.empty() || coldPath == get<std::string>(section, "path"))
+        {
+            Throw<std::runtime_error>(
+                "cold_type requires a cold_path different from path");
+        }
+    }
 }
 
 std::unique_ptr<NodeStore::Database>
@@ -250,7 +269,8 @@ SHAMapStoreImp::makeNodeStore(std::string const& name, std::int32_t readThreads)
             std::move(writableBackend),
             std::move(archiveBackend),
             app_.config().section(ConfigSection::nodeDatabase()),
-            app_.logs().journal(nodeStoreName_));
+            app_.logs().journal(nodeStoreName_),
+            makeBackendCold());
         fdRequired_ += dbr->fdRequired();
         dbRotating_ = dbr.get();
         db.reset(dynamic_cast<NodeStore::Database*>(dbr.release()));
@@ -299,13 +319,41 @@ SHAMapStoreImp::fdRequired() const
 }
 
 bool
-SHAMapStoreImp::copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node)
+SHAMapStoreImp::copyNode(
+    std::atomic<std::uint64_t>& nodeCount,
+    SHAMapTreeNode const& node)
 {
     // Copy a single record from node to dbRotating_
     dbRotating_->fetchNodeObject(node.getHash().as_uint256());
+
+    // Each thread copies its share of the budget, so the total rate is
+    // never more than copyRate_ however long each fetch takes.
+    if (copyRate_)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(
+            std::uint64_t{copyThreads_} * 1'000'000 / copyRate_));
+    }
+
     if (!(++nodeCount % checkHealthInterval_))
     {
-        if (health())
+        // Nodes are copied on several threads, but health() may sleep
+        // and must only be called from run(). The other copying threads
+        // pick up its verdict.
+        if (std::this_thread::get_id() == thread_.get_id())
+        {
+            if (copyRate_ && health() == Health::unhealthy)
+                waitHealthy();
+            if (health())
+                return false;
+        }
+        else if (copyRate_)
+        {
+            while (!healthy_ && !isStopping())
+                std::this_thread::sleep_for(backOff_);
+            if (isStopping())
+                return false;
+        }
+        else if (!healthy_ || isStopping())
             return false;
     }
 
@@ -381,12 +429,18 @@ SHAMapStoreImp::run()
             }
 
             JLOG(journal_.debug()) << "copying ledger " << validatedSeq;
-            std::uint64_t nodeCount = 0;
-            validatedLedger->stateMap().snapShot(false)->visitNodes(std::bind(
-                &SHAMapStoreImp::copyNode,
-                this,
-                std::ref(nodeCount),
-                std::placeholders::_1));
+            std::atomic<std::uint64_t> nodeCount{0};
+            validatedLedger->stateMap().snapShot(false)->visitNodesParallel(
+                std::bind(
+                    &SHAMapStoreImp::copyNode,
+                    this,
+                    std::ref(nodeCount),
+                    std::placeholders::_1),
+                copyThreads_);
+            // A paced copy has taken long enough that starting over would
+            // likely meet the same fate
+            if (copyRate_ && health() == Health::unhealthy)
+                waitHealthy();
             switch (health())
             {
                 case Health::stopping:
@@ -569,6 +623,25 @@ SHAMapStoreImp::makeBackendRotating(std::string path)
     return backend;
 }
 
+std::unique_ptr<NodeStore::Backend>
+SHAMapStoreImp::makeBackendCold()
+{
+    Section section{app_.config().section(ConfigSection::nodeDatabase())};
+    if (!section.exists("cold_type"))
+        return {};
+
+    section.set("type", get<std::string>(section, "cold_type"));
+    section.set("path", get<std::string>(section, "cold_path"));
+
+    auto backend{NodeStore::Manager::instance().make_Backend(
+        section,
+        megabytes(app_.config().getValueFor(SizedItem::burstSize, boost::none)),
+        scheduler_,
+        app_.logs().journal(nodeStoreName_))};
+    backend->open();
+    return backend;
+}
+
 void
 SHAMapStoreImp::clearSql(
     DatabaseCon& database,
@@ -684,6 +757,14 @@ SHAMapStoreImp::clearPrior(LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    clearSql(
+        *transactionDb_,
+        lastRotated,
+        "SELECT MIN(SeqKey) >> 32 FROM AccountTxIndex;",
+        "DELETE FROM AccountTxIndex WHERE SeqKey < %u << 32;");
+    if (health())
+        return;
 }
 
 SHAMapStoreImp::Health
@@ -730,6 +811,18 @@ SHAMapStoreImp::health()
         return Health::unhealthy;
 }
 
+void
+SHAMapStoreImp::waitHealthy()
+{
+    using namespace std::chrono_literals;
+
+    while (health() == Health::unhealthy)
+    {
+        std::this_thread::sleep_for(1s);
+        healthy_ = true;
+    }
+}
+
 void
 SHAMapStoreImp::onStop()
 {
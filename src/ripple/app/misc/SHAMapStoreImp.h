@@ -95,7 +95,7 @@ private:
     SavedStateDB state_db_;
     std::thread thread_;
     bool stop_ = false;
-    bool healthy_ = true;
+    std::atomic<bool> healthy_{true};
     mutable std::condition_variable cond_;
     mutable std::condition_variable rendezvous_;
     mutable std::mutex mutex_;
@@ -109,6 +109,11 @@ private:
     std::uint32_t deleteBatch_ = 100;
     std::chrono::milliseconds backOff_{100};
     std::chrono::seconds ageThreshold_{60};
+    // threads used to copy the validated ledger's state during rotation
+    std::uint32_t copyThreads_ = 4;
+    // if set, the most nodes per second copied during rotation. A paced
+    // copy waits for the server to recover rather than being abandoned.
+    std::uint32_t copyRate_ = 0;
     /// If set, and the node is out of sync during an
     /// online_delete health check, sleep the thread
     /// for this time and check again so the node can
@@ -194,7 +199,9 @@ public:
 private:
     // callback for visitNodes
     bool
-    copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node);
+    copyNode(
+        std::atomic<std::uint64_t>& nodeCount,
+        SHAMapTreeNode const& node);
     void
     run();
     void
@@ -203,6 +210,10 @@ private:
     std::unique_ptr<NodeStore::Backend>
     makeBackendRotating(std::string path = std::string());
 
+    // The backend configured by cold_type and cold_path, if any
+    std::unique_ptr<NodeStore::Backend>
+    makeBackendCold();
+
     template <class CacheInstance>
     bool
     freshenCache(CacheInstance& cache)
@@ -246,6 +257,11 @@ private:
     // the main "run()".
     Health
     health();
+
+    // Wait until rippled is healthy again, or is stopping. Only call
+    // from the main "run()" thread.
+    void
+    waitHealthy();
     //
     // Stoppable
     //
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_MISC_TRANSACTION_H_INCLUDED
 #define RIPPLE_APP_MISC_TRANSACTION_H_INCLUDED
 
+#include <ripple/basics/CacheBudget.h>
 #include <ripple/basics/RangeSet.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/ledger/TxMeta.h>
@@ -85,6 +86,12 @@ public:
         return mTransaction;
     }
 
+    std::shared_ptr<STTx const> const&
+    getSTransaction() const
+    {
+        return mTransaction;
+    }
+
     uint256 const&
     getID() const
     {
@@ -344,6 +351,20 @@ private:
     beast::Journal j_;
 };
 
+template <>
+struct CacheFootprint<Transaction>
+{
+    // Fields too large to be stored inline hold more, which is not counted
+    static std::size_t
+    bytes(Transaction const& txn)
+    {
+        std::size_t bytes = sizeof(txn);
+        if (auto const& stx = txn.getSTransaction())
+            bytes += sizeof(*stx) + stx->getCount() * sizeof(detail::STVar);
+        return bytes;
+    }
+};
+
 }  // namespace ripple
 
 #endif
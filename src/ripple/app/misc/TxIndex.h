@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_TXINDEX_H_INCLUDED
+#define RIPPLE_APP_MISC_TXINDEX_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/nodestore/Backend.h>
+#include <ripple/nodestore/Scheduler.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Where each validated transaction is, by its ID.
+
+    Each entry maps a transaction ID to the sequence of the ledger holding
+    it and its index in that ledger. The entries live in a node store
+    backend of their own, NuDB or RocksDB, so finding a transaction costs
+    one key lookup rather than a search of the SQLite transaction table.
+    The transaction and its metadata are then read from the ledger's
+    transaction tree.
+
+    Entries are never removed. One pointing to a ledger which has since
+    been deleted simply fails to resolve.
+*/
+class TxIndex
+{
+public:
+    struct Location
+    {
+        std::uint32_t ledgerSeq;
+        std::uint32_t txnIndex;
+    };
+
+    /** Open the index.
+
+        @param section The backend parameters, in the form of [node_db].
+    */
+    TxIndex(
+        Section const& section,
+        std::size_t burstSize,
+        NodeStore::Scheduler& scheduler,
+        beast::Journal journal);
+
+    ~TxIndex();
+
+    /** Record the transactions of a validated ledger.
+
+        @param txns The ID and index of each transaction in the ledger.
+    */
+    void
+    insert(
+        std::uint32_t ledgerSeq,
+        std::vector<std::pair<uint256, std::uint32_t>> const& txns);
+
+    /** Find a transaction. */
+    boost::optional<Location>
+    fetch(uint256 const& txID) const;
+
+private:
+    std::unique_ptr<NodeStore::Backend> backend_;
+    beast::Journal const j_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -28,6 +28,7 @@
 #include <ripple/protocol/TER.h>
 #include <boost/circular_buffer.hpp>
 #include <boost/intrusive/set.hpp>
+#include <boost/pool/pool_alloc.hpp>
 
 namespace ripple {
 
@@ -633,7 +634,17 @@ private:
     class TxQAccount
     {
     public:
-        using TxMap = std::map<SeqProxy, MaybeTx>;
+        /* The nodes come from a pool rather than the heap. The queue
+            inserts and removes entries constantly, and the pool hands
+            back the nodes of removed entries without a call into the
+            allocator. The byFee_ links are intrusive, so a node is the
+            only allocation a queued transaction needs.
+        */
+        using TxMap = std::map<
+            SeqProxy,
+            MaybeTx,
+            std::less<SeqProxy>,
+            boost::fast_pool_allocator<std::pair<SeqProxy const, MaybeTx>>>;
 
         /// The account
         AccountID const account;
@@ -706,7 +717,7 @@ private:
         Application& app,
         OpenView& view,
         std::shared_ptr<STTx const> const& tx,
-        ApplyFlags flags,
+        PreflightResult const& pfresult,
         beast::Journal j);
 
     // Helper function that removes a replaced entry in _byFee.
@@ -723,7 +734,11 @@ private:
     using FeeMultiSet = boost::intrusive::
         multiset<MaybeTx, FeeHook, boost::intrusive::compare<GreaterFee>>;
 
-    using AccountMap = std::map<AccountID, TxQAccount>;
+    using AccountMap = std::map<
+        AccountID,
+        TxQAccount,
+        std::less<AccountID>,
+        boost::fast_pool_allocator<std::pair<AccountID const, TxQAccount>>>;
 
     /// Setup parameters used to control the behavior of the queue
     Setup const setup_;
@@ -150,9 +150,27 @@ class ValidatorList
     // Published lists stored by publisher master public key
     hash_map<PublicKey, PublisherList> publisherLists_;
 
+    // A list which was verified, so need not be again when sent again by
+    // another peer or site
+    struct VerifiedList
+    {
+        PublicKey publisherKey;
+        PublicKey signingKey;
+        std::size_t sequence;
+        TimeKeeper::time_point expiration;
+    };
+
+    // Verified lists stored by the hash of their data parameters
+    hash_map<uint256, VerifiedList> verifiedLists_;
+    static constexpr std::size_t maxVerifiedLists = 256;
+
     // Listed master public keys with the number of lists they appear on
     hash_map<PublicKey, std::size_t> keyListings_;
 
+    // Master public keys which were not listed when the trusted keys were
+    // last updated, but are now
+    hash_set<PublicKey> newlyListed_;
+
     // The current list of trusted master keys
     hash_set<PublicKey> trustedMasterKeys_;
 
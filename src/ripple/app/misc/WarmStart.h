@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_WARMSTART_H_INCLUDED
+#define RIPPLE_APP_MISC_WARMSTART_H_INCLUDED
+
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstddef>
+
+namespace ripple {
+
+class Application;
+
+/** How often the hot keys are saved while the server runs, so that a
+    server which did not shut down cleanly can still start warm. */
+constexpr std::chrono::hours warmStartSaveInterval{1};
+
+/** Save the keys of the most recently used tree nodes.
+
+    The file holds only node hashes, 32 bytes each. It is replaced
+    atomically, so a crash while saving leaves the previous file intact.
+
+    @param count The most keys to save.
+    @return `true` if the file was written.
+*/
+bool
+saveWarmStart(
+    Application& app,
+    boost::filesystem::path const& file,
+    std::size_t count);
+
+/** Read back the nodes saved by saveWarmStart in the background.
+
+    Each key is queued as a low priority read of the node store, which
+    puts the node in its cache. Keys of nodes which are no longer stored
+    simply miss. A missing or malformed file is ignored.
+
+    @return The number of reads queued.
+*/
+std::size_t
+loadWarmStart(Application& app, boost::filesystem::path const& file);
+
+}  // namespace ripple
+
+#endif
@@ -22,9 +22,11 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/format.hpp>
+#include <limits>
 #include <memory>
 
 namespace ripple {
@@ -60,6 +62,24 @@ saveLedgerAsync(Application& app, std::uint32_t seq)
         pendSaveValidated(app, l, false, false);
 }
 
+// Whether the AccountTxIndex table holds every transaction in the range
+static bool
+compactIndexCovers(
+    DatabaseCon& connection,
+    std::int32_t minLedger,
+    std::int32_t maxLedger)
+{
+    if (minLedger < 0 || maxLedger < 0)
+        return false;
+
+    boost::optional<std::uint64_t> start;
+    {
+        auto db(connection.checkoutReadDb());
+        *db << "SELECT LedgerSeq FROM AccountTxIndexStart;", soci::into(start);
+    }
+    return start && static_cast<std::uint64_t>(minLedger) >= *start;
+}
+
 void
 accountTxPage(
     DatabaseCon& connection,
@@ -115,7 +135,32 @@ accountTxPage(
 
     // SQL's BETWEEN uses a closed interval ([a,b])
 
-    if (forward && (findLedger == 0))
+    if (compactIndexCovers(connection, minLedger, maxLedger))
+    {
+        // Every case is a single range of keys, starting or ending at the
+        // marker if there is one
+        static std::string const compact(
+            R"(SELECT AccountTxIndex.SeqKey >> 32,
+            AccountTxIndex.SeqKey & 4294967295,
+            Status,RawTxn,TxnMeta
+            FROM AccountTxIndex INNER JOIN Transactions
+            ON Transactions.TransID = hex(AccountTxIndex.TransID)
+            WHERE AccountTxIndex.Account = X'%s' AND
+            AccountTxIndex.SeqKey BETWEEN %d AND %d
+            ORDER BY AccountTxIndex.SeqKey %s
+            LIMIT %u;)");
+
+        auto const last = std::numeric_limits<std::uint32_t>::max();
+        auto lo = accountTxSeqKey(minLedger, 0);
+        auto hi = accountTxSeqKey(maxLedger, last);
+        if (findLedger != 0)
+            (forward ? lo : hi) = accountTxSeqKey(findLedger, findSeq);
+
+        sql = boost::str(
+            boost::format(compact) % strHex(account) % lo % hi %
+            (forward ? "ASC" : "DESC") % queryLimit);
+    }
+    else if (forward && (findLedger == 0))
     {
         sql = boost::str(
             boost::format(
@@ -189,7 +234,7 @@ accountTxPage(
     }
 
     {
-        auto db(connection.checkoutDb());
+        auto db(connection.checkoutReadDb());
 
         Blob rawData;
         Blob rawMeta;
@@ -215,11 +260,14 @@ accountTxPage(
         {
             if (lookingForMarker)
             {
-                if (findLedger == ledgerSeq.value_or(0) &&
-                    findSeq == txnSeq.value_or(0))
-                {
+                // The marker is the first transaction to return, or a
+                // point between transactions to resume from
+                auto const key = accountTxSeqKey(
+                    rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0)),
+                    txnSeq.value_or(0));
+                auto const markerKey = accountTxSeqKey(findLedger, findSeq);
+                if (forward ? key >= markerKey : key <= markerKey)
                     lookingForMarker = false;
-                }
             }
             else if (numberOfResults == 0)
             {
@@ -30,6 +30,13 @@
 
 namespace ripple {
 
+/** The key of a row in the AccountTxIndex table. */
+inline std::int64_t
+accountTxSeqKey(std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+{
+    return static_cast<std::int64_t>(ledgerSeq) << 32 | txnSeq;
+}
+
 void
 convertBlobsToTxResult(
     NetworkOPs::AccountTxs& to,
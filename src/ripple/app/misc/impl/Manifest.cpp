@@ -267,11 +267,11 @@ loadValidatorToken(std::vector<std::string> const& blob)
 PublicKey
 ManifestCache::getSigningKey(PublicKey const& pk) const
 {
-    std::lock_guard lock{read_mutex_};
-    auto const iter = map_.find(pk);
+    auto const keys = std::atomic_load(&keys_);
+    auto const iter = keys->signingKeys.find(pk);
 
-    if (iter != map_.end() && !iter->second.revoked())
-        return iter->second.signingKey;
+    if (iter != keys->signingKeys.end())
+        return iter->second;
 
     return pk;
 }
@@ -279,10 +279,10 @@ ManifestCache::getSigningKey(PublicKey const& pk) const
 PublicKey
 ManifestCache::getMasterKey(PublicKey const& pk) const
 {
-    std::lock_guard lock{read_mutex_};
-    auto const iter = signingToMasterKeys_.find(pk);
+    auto const keys = std::atomic_load(&keys_);
+    auto const iter = keys->masterKeys.find(pk);
 
-    if (iter != signingToMasterKeys_.end())
+    if (iter != keys->masterKeys.end())
         return iter->second;
 
     return pk;
@@ -327,13 +327,7 @@ ManifestCache::getManifest(PublicKey const& pk) const
 bool
 ManifestCache::revoked(PublicKey const& pk) const
 {
-    std::lock_guard lock{read_mutex_};
-    auto const iter = map_.find(pk);
-
-    if (iter != map_.end())
-        return iter->second.revoked();
-
-    return false;
+    return std::atomic_load(&keys_)->revoked.count(pk) != 0;
 }
 
 ManifestDisposition
@@ -380,6 +374,9 @@ ManifestCache::applyManifest(Manifest m)
 
     bool const revoked = m.revoked();
 
+    // Readers keep using the current keys until the new ones are stored
+    auto keys = std::make_shared<Keys>(*std::atomic_load(&keys_));
+
     if (revoked)
     {
         /*
@@ -403,8 +400,13 @@ ManifestCache::applyManifest(Manifest m)
         if (auto stream = j_.info())
             logMftAct(stream, "AcceptedNew", m.masterKey, m.sequence);
 
-        if (!revoked)
-            signingToMasterKeys_[m.signingKey] = m.masterKey;
+        if (revoked)
+            keys->revoked.insert(m.masterKey);
+        else
+        {
+            keys->signingKeys[m.masterKey] = m.signingKey;
+            keys->masterKeys[m.signingKey] = m.masterKey;
+        }
 
         auto masterKey = m.masterKey;
         map_.emplace(std::move(masterKey), std::move(m));
@@ -423,14 +425,24 @@ ManifestCache::applyManifest(Manifest m)
                 m.sequence,
                 iter->second.sequence);
 
-        signingToMasterKeys_.erase(iter->second.signingKey);
+        keys->masterKeys.erase(iter->second.signingKey);
 
-        if (!revoked)
-            signingToMasterKeys_[m.signingKey] = m.masterKey;
+        if (revoked)
+        {
+            keys->signingKeys.erase(m.masterKey);
+            keys->revoked.insert(m.masterKey);
+        }
+        else
+        {
+            keys->signingKeys[m.masterKey] = m.signingKey;
+            keys->masterKeys[m.signingKey] = m.masterKey;
+        }
 
         iter->second = std::move(m);
     }
 
+    std::atomic_store(&keys_, std::shared_ptr<Keys const>(std::move(keys)));
+
     // Something has changed. Keep track of it.
     seq_++;
 
@@ -21,6 +21,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/app/misc/TxIndex.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/safe_cast.h>
@@ -105,6 +106,50 @@ Transaction::transactionFromSQL(
     return tr;
 }
 
+// Find a validated transaction through the transaction index, and read it
+// from the transaction tree of the ledger holding it
+static boost::optional<
+    std::pair<std::shared_ptr<Transaction>, std::shared_ptr<TxMeta>>>
+loadFromIndex(uint256 const& id, Application& app)
+{
+    auto const txIndex = app.getTxIndex();
+    if (!txIndex)
+        return boost::none;
+
+    auto const location = txIndex->fetch(id);
+    if (!location)
+        return boost::none;
+
+    try
+    {
+        auto const ledger =
+            app.getLedgerMaster().getLedgerBySeq(location->ledgerSeq);
+        if (!ledger)
+            return boost::none;
+
+        auto const [stx, meta] = ledger->txRead(id);
+        if (!stx || !meta)
+            return boost::none;
+
+        std::string reason;
+        auto txn = std::make_shared<Transaction>(stx, reason, app);
+        txn->setStatus(COMMITTED);
+        txn->setLedger(location->ledgerSeq);
+        return std::pair{
+            std::move(txn),
+            std::make_shared<TxMeta>(id, location->ledgerSeq, *meta)};
+    }
+    catch (std::exception const& e)
+    {
+        // Fall back to the SQL database
+        JLOG(app.journal("Ledger").debug())
+            << "Unable to read indexed transaction " << id << ": "
+            << e.what();
+    }
+
+    return boost::none;
+}
+
 std::variant<
     std::pair<std::shared_ptr<Transaction>, std::shared_ptr<TxMeta>>,
     TxSearched>
@@ -136,6 +181,9 @@ Transaction::load(
     boost::optional<ClosedInterval<uint32_t>> const& range,
     error_code_i& ec)
 {
+    if (auto found = loadFromIndex(id, app))
+        return std::move(*found);
+
     std::string sql =
         "SELECT LedgerSeq,Status,RawTxn,TxnMeta "
         "FROM Transactions WHERE TransID='";
@@ -147,7 +195,7 @@ Transaction::load(
     boost::optional<std::string> status;
     Blob rawTxn, rawMeta;
     {
-        auto db = app.getTxnDB().checkoutDb();
+        auto db = app.getTxnDB().checkoutReadDb();
         soci::blob sociRawTxnBlob(*db), sociRawMetaBlob(*db);
         soci::indicator txn, meta;
 
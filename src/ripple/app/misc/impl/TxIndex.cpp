@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TxIndex.h>
+#include <ripple/basics/Log.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/protocol/Serializer.h>
+
+namespace ripple {
+
+TxIndex::TxIndex(
+    Section const& section,
+    std::size_t burstSize,
+    NodeStore::Scheduler& scheduler,
+    beast::Journal journal)
+    : backend_(NodeStore::Manager::instance().make_Backend(
+          section,
+          burstSize,
+          scheduler,
+          journal))
+    , j_(journal)
+{
+    backend_->open();
+}
+
+TxIndex::~TxIndex()
+{
+    backend_->close();
+}
+
+void
+TxIndex::insert(
+    std::uint32_t ledgerSeq,
+    std::vector<std::pair<uint256, std::uint32_t>> const& txns)
+{
+    if (txns.empty())
+        return;
+
+    NodeStore::Batch batch;
+    batch.reserve(txns.size());
+    for (auto const& [id, index] : txns)
+    {
+        Serializer s(8);
+        s.add32(ledgerSeq);
+        s.add32(index);
+        batch.push_back(
+            NodeObject::createObject(hotUNKNOWN, std::move(s.modData()), id));
+    }
+    backend_->storeBatch(batch);
+}
+
+auto
+TxIndex::fetch(uint256 const& txID) const -> boost::optional<Location>
+{
+    std::shared_ptr<NodeObject> object;
+    auto const status = backend_->fetch(txID.data(), &object);
+    if (status != NodeStore::ok || !object)
+    {
+        if (status != NodeStore::notFound)
+        {
+            JLOG(j_.warn()) << "Transaction index lookup of " << txID
+                            << " failed: " << status;
+        }
+        return boost::none;
+    }
+
+    auto const& data = object->getData();
+    if (data.size() != 8)
+    {
+        JLOG(j_.warn()) << "Malformed transaction index entry for " << txID;
+        return boost::none;
+    }
+
+    SerialIter sit(data);
+    Location location;
+    location.ledgerSeq = sit.get32();
+    location.txnIndex = sit.get32();
+    return location;
+}
+
+}  // namespace ripple
@@ -728,9 +728,15 @@ TxQ::apply(
     ApplyFlags flags,
     beast::Journal j)
 {
+    // See if the transaction is valid, properly formed,
+    // etc. before doing potentially expensive queue
+    // replace and multi-transaction operations. The same
+    // result is used to try applying it straight away.
+    auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
+
     // See if the transaction paid a high enough fee that it can go straight
     // into the ledger.
-    if (auto directApplied = tryDirectApply(app, view, tx, flags, j))
+    if (auto directApplied = tryDirectApply(app, view, tx, pfresult, j))
         return *directApplied;
 
     // If we get past tryDirectApply() without returning then we expect
@@ -740,10 +746,6 @@ TxQ::apply(
     //  o The transaction paid a high enough fee that fee averaging will apply.
     //  o The transaction will be queued.
 
-    // See if the transaction is valid, properly formed,
-    // etc. before doing potentially expensive queue
-    // replace and multi-transaction operations.
-    auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
     if (pfresult.ter != tesSUCCESS)
         return {pfresult.ter, false};
 
@@ -1623,9 +1625,10 @@ TxQ::tryDirectApply(
     Application& app,
     OpenView& view,
     std::shared_ptr<STTx const> const& tx,
-    ApplyFlags flags,
+    PreflightResult const& pfresult,
     beast::Journal j)
 {
+    auto const flags = pfresult.flags;
     auto const account = (*tx)[sfAccount];
     auto const sleAccount = view.read(keylet::account(account));
 
@@ -1659,7 +1662,7 @@ TxQ::tryDirectApply(
                          << " to open ledger.";
 
         auto const [txnResult, didApply] =
-            ripple::apply(app, view, *tx, flags, j);
+            doApply(preclaim(pfresult, app, view), app, view);
 
         JLOG(j_.trace()) << "New transaction " << transactionID
                          << (didApply ? " applied successfully with "
@@ -26,6 +26,7 @@
 #include <ripple/json/json_reader.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/protocol/STValidation.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/messages.h>
 #include <boost/regex.hpp>
@@ -141,7 +142,10 @@ ValidatorList::load(
 
     // Treat local validator key as though it was listed in the config
     if (localPubKey_.size())
+    {
         keyListings_.insert({localPubKey_, 1});
+        newlyListed_.insert(localPubKey_);
+    }
 
     JLOG(j_.debug()) << "Loading configured validator keys";
 
@@ -177,6 +181,7 @@ ValidatorList::load(
             JLOG(j_.warn()) << "Duplicate node identity: " << match[1];
             continue;
         }
+        newlyListed_.insert(*id);
         auto it = publisherLists_.emplace(
             std::piecewise_construct,
             std::forward_as_tuple(local),
@@ -309,11 +314,54 @@ ValidatorList::applyList(
     if (version != requiredListVersion)
         return PublisherListStats{ListDisposition::unsupported_version};
 
+    auto const listHash =
+        hash ? *hash : sha512Half(manifest, blob, signature, version);
+
     std::unique_lock lock{mutex_};
 
+    // Every peer relays a list and sites are polled again and again, so
+    // one already verified is more often than not sent again. As long as
+    // its publisher still signs with the same key, the same answer holds.
+    if (auto const iVerified = verifiedLists_.find(listHash);
+        iVerified != verifiedLists_.end())
+    {
+        auto const& verified = iVerified->second;
+        auto const iPublisher = publisherLists_.find(verified.publisherKey);
+        if (iPublisher != publisherLists_.end() &&
+            !publisherManifests_.revoked(verified.publisherKey) &&
+            publisherManifests_.getSigningKey(verified.publisherKey) ==
+                verified.signingKey)
+        {
+            auto const& publisher = iPublisher->second;
+            if (verified.sequence < publisher.sequence ||
+                verified.expiration <= timeKeeper_.now())
+                return PublisherListStats{ListDisposition::stale};
+            if (verified.sequence == publisher.sequence)
+            {
+                return PublisherListStats{
+                    ListDisposition::same_sequence,
+                    verified.publisherKey,
+                    publisher.available,
+                    publisher.sequence};
+            }
+        }
+    }
+
     Json::Value list;
     PublicKey pubKey;
     auto const result = verify(lock, list, pubKey, manifest, blob, signature);
+    if (result == ListDisposition::accepted ||
+        result == ListDisposition::same_sequence)
+    {
+        if (verifiedLists_.size() >= maxVerifiedLists)
+            verifiedLists_.clear();
+        verifiedLists_[listHash] = {
+            pubKey,
+            publisherManifests_.getSigningKey(pubKey),
+            list["sequence"].asUInt(),
+            TimeKeeper::time_point{
+                TimeKeeper::duration{list["expiration"].asUInt()}}};
+    }
     if (result != ListDisposition::accepted)
     {
         if (result == ListDisposition::same_sequence &&
@@ -386,7 +434,8 @@ ValidatorList::applyList(
             (iNew != publisherList.end() && *iNew < *iOld))
         {
             // Increment list count for added keys
-            ++keyListings_[*iNew];
+            if (++keyListings_[*iNew] == 1)
+                newlyListed_.insert(*iNew);
             ++iNew;
         }
         else if (
@@ -955,12 +1004,14 @@ ValidatorList::updateTrusted(hash_set<NodeID> const& seenValidators)
         }
     }
 
-    for (auto const& val : keyListings_)
+    // Only keys which weren't listed the last time can be added
+    for (auto const& key : newlyListed_)
     {
-        if (!validatorManifests_.revoked(val.first) &&
-            trustedMasterKeys_.emplace(val.first).second)
-            trustChanges.added.insert(calcNodeID(val.first));
+        if (keyListings_.count(key) && !validatorManifests_.revoked(key) &&
+            trustedMasterKeys_.emplace(key).second)
+            trustChanges.added.insert(calcNodeID(key));
     }
+    newlyListed_.clear();
 
     // If there were any changes, we need to update the ephemeral signing keys:
     if (!trustChanges.added.empty() || !trustChanges.removed.empty())
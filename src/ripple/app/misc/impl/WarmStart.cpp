@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/WarmStart.h>
+#include <ripple/basics/FileUtilities.h>
+#include <ripple/basics/Log.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/shamap/Family.h>
+#include <ripple/shamap/TreeNodeCache.h>
+
+namespace ripple {
+
+bool
+saveWarmStart(
+    Application& app,
+    boost::filesystem::path const& file,
+    std::size_t count)
+{
+    auto const j = app.journal("WarmStart");
+    auto const keys =
+        app.getNodeFamily().getTreeNodeCache(0)->getRecentKeys(count);
+
+    std::string contents;
+    contents.reserve(keys.size() * uint256::bytes);
+    for (auto const& key : keys)
+        contents.append(reinterpret_cast<char const*>(key.data()), key.size());
+
+    auto temp = file;
+    temp += ".tmp";
+
+    boost::system::error_code ec;
+    writeFileContents(ec, temp, contents);
+    if (!ec)
+        boost::filesystem::rename(temp, file, ec);
+    if (ec)
+    {
+        JLOG(j.warn()) << "Unable to save " << file.string() << ": "
+                       << ec.message();
+        return false;
+    }
+
+    JLOG(j.debug()) << "Saved " << keys.size() << " keys to "
+                    << file.string();
+    return true;
+}
+
+std::size_t
+loadWarmStart(Application& app, boost::filesystem::path const& file)
+{
+    auto const j = app.journal("WarmStart");
+
+    boost::system::error_code ec;
+    if (!boost::filesystem::exists(file, ec))
+        return 0;
+
+    auto const contents = getFileContents(ec, file);
+    if (ec || contents.size() % uint256::bytes != 0)
+    {
+        JLOG(j.warn()) << "Ignoring unreadable " << file.string();
+        return 0;
+    }
+
+    auto& db = app.getNodeStore();
+    std::size_t queued = 0;
+    for (std::size_t i = 0; i < contents.size(); i += uint256::bytes)
+    {
+        auto const key = uint256::fromVoid(contents.data() + i);
+        std::shared_ptr<NodeObject> nodeObject;
+        if (!db.asyncFetch(key, 0, nodeObject, NodeStore::FetchPriority::low))
+            ++queued;
+    }
+
+    JLOG(j.info()) << "Warming the node store cache with " << queued
+                   << " of " << contents.size() / uint256::bytes << " nodes";
+    return queued;
+}
+
+}  // namespace ripple
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/DeadOffers.h>
+#include <ripple/ledger/View.h>
+
+namespace ripple {
+
+DeadOffers::DeadOffers(
+    std::shared_ptr<ReadView const> ledger,
+    beast::Journal j)
+    : ledger_(std::move(ledger)), j_(j)
+{
+}
+
+bool
+DeadOffers::dead(SLE const& offer)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = offers_.find(offer.key()); it != offers_.end())
+            return it->second;
+    }
+
+    // Read the ledger without holding the lock. Two threads may evaluate
+    // the same offer at once, with the same result.
+    auto const result = evaluate(offer);
+
+    std::lock_guard lock(mutex_);
+    offers_.emplace(offer.key(), result);
+    return result;
+}
+
+bool
+DeadOffers::evaluate(SLE const& offer)
+{
+    using d = NetClock::duration;
+    using tp = NetClock::time_point;
+    if (offer.isFieldPresent(sfExpiration) &&
+        tp{d{offer[sfExpiration]}} <= ledger_->parentCloseTime())
+        return true;
+
+    auto const takerGets = offer[sfTakerGets];
+    if (takerGets <= beast::zero || offer[sfTakerPays] <= beast::zero)
+        return true;
+
+    // An issuer always has its own IOUs to sell
+    auto const owner = offer.getAccountID(sfAccount);
+    auto const issue = takerGets.issue();
+    if (owner == issue.account)
+        return false;
+
+    std::pair<AccountID, Issue> const key{owner, issue};
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = funded_.find(key); it != funded_.end())
+            return !it->second;
+    }
+
+    bool const funded = accountHolds(
+                            *ledger_,
+                            owner,
+                            issue.currency,
+                            issue.account,
+                            fhZERO_IF_FROZEN,
+                            j_) > beast::zero;
+
+    std::lock_guard lock(mutex_);
+    funded_.emplace(key, funded);
+    return !funded;
+}
+
+}  // namespace ripple
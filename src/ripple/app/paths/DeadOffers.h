@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_PATHS_DEADOFFERS_H_INCLUDED
+#define RIPPLE_APP_PATHS_DEADOFFERS_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/Issue.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+/** The offers in a ledger which path finding can pass over.
+
+    An offer is dead if it has expired, if either of its amounts is zero,
+    or if its owner has no funds to pay it with. Each offer and each
+    owner's funds are evaluated against the ledger once, the first time
+    they are asked about, so that path finding, which walks the same books
+    many times for each ledger, only pays for a dead offer once.
+
+    Transactions still meet and remove dead offers one at a time: which
+    offers a payment removes is part of the protocol. Path finding only
+    estimates the liquidity of a path, so this doesn't change its results
+    unless an earlier step of a path funds an owner, which the payment
+    itself will find out.
+*/
+class DeadOffers
+{
+public:
+    DeadOffers(std::shared_ptr<ReadView const> ledger, beast::Journal j);
+
+    /** Whether an offer in the ledger can't be taken. */
+    bool
+    dead(SLE const& offer);
+
+private:
+    bool
+    evaluate(SLE const& offer);
+
+    std::shared_ptr<ReadView const> const ledger_;
+    beast::Journal const j_;
+
+    std::mutex mutex_;
+    hash_map<uint256, bool> offers_;
+    // Whether an owner has any of an issue to sell
+    std::map<std::pair<AccountID, Issue>, bool> funded_;
+};
+
+}  // namespace ripple
+
+#endif
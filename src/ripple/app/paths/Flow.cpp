@@ -68,7 +68,8 @@ flow(
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMax,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo)
+    path::detail::FlowDebugInfo* flowDebugInfo,
+    DeadOffers* deadOffers)
 {
     Issue const srcIssue = [&] {
         if (sendMax)
@@ -98,7 +99,8 @@ flow(
         defaultPaths,
         ownerPaysTransferFee,
         offerCrossing,
-        j);
+        j,
+        deadOffers);
 
     if (toStrandsTer != tesSUCCESS)
     {
@@ -50,6 +50,7 @@ struct FlowDebugInfo;
   @param sendMax Do not spend more than this amount
   @param j Journal to write journal messages to
   @param flowDebugInfo If non-null a pointer to FlowDebugInfo for debugging
+  @param deadOffers If non-null, offers to pass over when path finding
   @return Actual amount in and out, and the result code
 */
 path::RippleCalc::Output
@@ -66,7 +67,8 @@ flow(
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMax,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo = nullptr);
+    path::detail::FlowDebugInfo* flowDebugInfo = nullptr,
+    DeadOffers* deadOffers = nullptr);
 
 }  // namespace ripple
 
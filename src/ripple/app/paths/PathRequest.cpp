@@ -27,12 +27,20 @@
 #include <ripple/basics/Log.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/core/Config.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <boost/algorithm/clamp.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <tuple>
 
 namespace ripple {
@@ -455,10 +463,10 @@ PathRequest::doStatus(Json::Value const&)
     return jvStatus;
 }
 
-std::unique_ptr<Pathfinder> const&
+std::shared_ptr<Pathfinder> const&
 PathRequest::getPathFinder(
     std::shared_ptr<RippleLineCache> const& cache,
-    hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
+    hash_map<Currency, std::shared_ptr<Pathfinder>>& currency_map,
     Currency const& currency,
     STAmount const& dst_amount,
     int const level)
@@ -466,85 +474,180 @@ PathRequest::getPathFinder(
     auto i = currency_map.find(currency);
     if (i != currency_map.end())
         return i->second;
-    auto pathfinder = std::make_unique<Pathfinder>(
-        cache,
-        *raSrcAccount,
-        *raDstAccount,
-        currency,
-        boost::none,
-        dst_amount,
-        saSendMax,
-        app_);
-    if (pathfinder->findPaths(level))
-        pathfinder->computePathRanks(max_paths_);
-    else
-        pathfinder.reset();  // It's a bad request - clear it.
+    // Requests for the same payment run the same search, so share it
+    Serializer s;
+    s.addBitString(*raSrcAccount);
+    s.addBitString(*raDstAccount);
+    s.addBitString(currency);
+    dst_amount.add(s);
+    s.add8(saSendMax ? 1 : 0);
+    if (saSendMax)
+        saSendMax->add(s);
+    s.add32(level);
+
+    auto pathfinder = mOwner.getPathfinder(cache, s.getSHA512Half(), [&]() {
+        auto result = std::make_shared<Pathfinder>(
+            cache,
+            *raSrcAccount,
+            *raDstAccount,
+            currency,
+            boost::none,
+            dst_amount,
+            saSendMax,
+            app_);
+        if (result->findPaths(level))
+            result->computePathRanks(max_paths_);
+        else
+            result.reset();  // It's a bad request - clear it.
+        return result;
+    });
     return currency_map[currency] = std::move(pathfinder);
 }
 
-bool
-PathRequest::findPaths(
-    std::shared_ptr<RippleLineCache> const& cache,
-    int const level,
-    Json::Value& jvArray)
+namespace {
+
+/** Calls f with each index less than count, using up to `threads` threads.
+
+    The calling thread takes part, and the other threads are job queue
+    threads. If they are slow to start, the calling thread does their share
+    instead of waiting for them. Any exception thrown by f is passed on to
+    the caller once every call has finished.
+*/
+void
+searchInParallel(
+    JobQueue& jobQueue,
+    std::size_t threads,
+    std::size_t count,
+    std::function<void(std::size_t)> const& f)
 {
-    auto sourceCurrencies = sciSourceCurrencies;
-    if (sourceCurrencies.empty())
+    if (std::min(threads, count) <= 1)
     {
-        auto currencies = accountSourceCurrencies(*raSrcAccount, cache, true);
-        bool const sameAccount = *raSrcAccount == *raDstAccount;
-        for (auto const& c : currencies)
+        for (std::size_t i = 0; i < count; ++i)
+            f(i);
+        return;
+    }
+
+    // Jobs can start after every index is taken and the caller has
+    // returned, so they share this state rather than using the stack.
+    struct State
+    {
+        State(std::function<void(std::size_t)> const& f, std::size_t count)
+            : f(f), count(count)
         {
-            if (!sameAccount || c != saDstAmount.getCurrency())
+        }
+
+        std::function<void(std::size_t)> const& f;
+        std::size_t const count;
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t finished = 0;
+        std::exception_ptr error;
+
+        void
+        work()
+        {
+            for (auto i = next++; i < count; i = next++)
             {
-                if (sourceCurrencies.size() >= RPC::Tuning::max_auto_src_cur)
-                    return false;
-                sourceCurrencies.insert(
-                    {c, c.isZero() ? xrpAccount() : *raSrcAccount});
+                std::exception_ptr e;
+                try
+                {
+                    f(i);
+                }
+                catch (...)
+                {
+                    e = std::current_exception();
+                }
+
+                std::lock_guard lock(mutex);
+                if (e && !error)
+                    error = e;
+                if (++finished == count)
+                    done.notify_all();
             }
         }
-    }
+    };
 
-    auto const dst_amount = convert_all_
-        ? STAmount(
-              saDstAmount.issue(), STAmount::cMaxValue, STAmount::cMaxOffset)
-        : saDstAmount;
-    hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
-    for (auto const& issue : sourceCurrencies)
+    auto const state = std::make_shared<State>(f, count);
+    for (std::size_t i = 1; i < std::min(threads, count); ++i)
     {
-        JLOG(m_journal.debug())
-            << iIdentifier
-            << " Trying to find paths: " << STAmount(issue, 1).getFullText();
+        jobQueue.addJob(jtUPDATE_PF, "PathRequest::search", [state](Job&) {
+            state->work();
+        });
+    }
+    state->work();
 
-        auto& pathfinder = getPathFinder(
-            cache, currency_map, issue.currency, dst_amount, level);
-        if (!pathfinder)
-        {
-            assert(false);
-            JLOG(m_journal.debug()) << iIdentifier << " No paths found";
-            continue;
-        }
+    std::unique_lock lock(state->mutex);
+    state->done.wait(lock, [&] { return state->finished == count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+}  // namespace
+
+boost::optional<Json::Value>
+PathRequest::findPaths(
+    std::shared_ptr<RippleLineCache> const& cache,
+    hash_map<Currency, std::shared_ptr<Pathfinder>>& currency_map,
+    Issue const& issue,
+    STAmount const& dst_amount,
+    int const level,
+    STPathSet& context)
+{
+    JLOG(m_journal.debug())
+        << iIdentifier
+        << " Trying to find paths: " << STAmount(issue, 1).getFullText();
+
+    auto& pathfinder = getPathFinder(
+        cache, currency_map, issue.currency, dst_amount, level);
+    if (!pathfinder)
+    {
+        assert(false);
+        JLOG(m_journal.debug()) << iIdentifier << " No paths found";
+        return boost::none;
+    }
 
-        STPath fullLiquidityPath;
-        auto ps = pathfinder->getBestPaths(
-            max_paths_, fullLiquidityPath, mContext[issue], issue.account);
-        mContext[issue] = ps;
+    STPath fullLiquidityPath;
+    auto ps = pathfinder->getBestPaths(
+        max_paths_, fullLiquidityPath, context, issue.account);
+    context = ps;
 
-        auto& sourceAccount = !isXRP(issue.account)
-            ? issue.account
-            : isXRP(issue.currency) ? xrpAccount() : *raSrcAccount;
-        STAmount saMaxAmount = saSendMax.value_or(
-            STAmount({issue.currency, sourceAccount}, 1u, 0, true));
+    auto& sourceAccount = !isXRP(issue.account)
+        ? issue.account
+        : isXRP(issue.currency) ? xrpAccount() : *raSrcAccount;
+    STAmount saMaxAmount = saSendMax.value_or(
+        STAmount({issue.currency, sourceAccount}, 1u, 0, true));
 
+    JLOG(m_journal.debug())
+        << iIdentifier << " Paths found, calling rippleCalc";
+
+    path::RippleCalc::Input rcInput;
+    if (convert_all_)
+        rcInput.partialPaymentAllowed = true;
+    rcInput.deadOffers = &cache->deadOffers();
+    auto sandbox =
+        std::make_unique<PaymentSandbox>(&*cache->getLedger(), tapNONE);
+    auto rc = path::RippleCalc::rippleCalculate(
+        *sandbox,
+        saMaxAmount,    // --> Amount to send is unlimited
+                        //     to get an estimate.
+        dst_amount,     // --> Amount to deliver.
+        *raDstAccount,  // --> Account to deliver to.
+        *raSrcAccount,  // --> Account sending from.
+        ps,             // --> Path set.
+        app_.logs(),
+        &rcInput);
+
+    if (!convert_all_ && !fullLiquidityPath.empty() &&
+        (rc.result() == terNO_LINE || rc.result() == tecPATH_PARTIAL))
+    {
         JLOG(m_journal.debug())
-            << iIdentifier << " Paths found, calling rippleCalc";
+            << iIdentifier << " Trying with an extra path element";
 
-        path::RippleCalc::Input rcInput;
-        if (convert_all_)
-            rcInput.partialPaymentAllowed = true;
-        auto sandbox =
+        ps.push_back(fullLiquidityPath);
+        sandbox =
             std::make_unique<PaymentSandbox>(&*cache->getLedger(), tapNONE);
-        auto rc = path::RippleCalc::rippleCalculate(
+        rc = path::RippleCalc::rippleCalculate(
             *sandbox,
             saMaxAmount,    // --> Amount to send is unlimited
                             //     to get an estimate.
@@ -552,81 +655,142 @@ PathRequest::findPaths(
             *raDstAccount,  // --> Account to deliver to.
             *raSrcAccount,  // --> Account sending from.
             ps,             // --> Path set.
-            app_.logs(),
-            &rcInput);
+            app_.logs());
 
-        if (!convert_all_ && !fullLiquidityPath.empty() &&
-            (rc.result() == terNO_LINE || rc.result() == tecPATH_PARTIAL))
+        if (rc.result() != tesSUCCESS)
+        {
+            JLOG(m_journal.warn())
+                << iIdentifier << " Failed with covering path "
+                << transHuman(rc.result());
+        }
+        else
         {
             JLOG(m_journal.debug())
-                << iIdentifier << " Trying with an extra path element";
-
-            ps.push_back(fullLiquidityPath);
-            sandbox =
-                std::make_unique<PaymentSandbox>(&*cache->getLedger(), tapNONE);
-            rc = path::RippleCalc::rippleCalculate(
-                *sandbox,
-                saMaxAmount,    // --> Amount to send is unlimited
-                                //     to get an estimate.
-                dst_amount,     // --> Amount to deliver.
-                *raDstAccount,  // --> Account to deliver to.
-                *raSrcAccount,  // --> Account sending from.
-                ps,             // --> Path set.
-                app_.logs());
-
-            if (rc.result() != tesSUCCESS)
-            {
-                JLOG(m_journal.warn())
-                    << iIdentifier << " Failed with covering path "
-                    << transHuman(rc.result());
-            }
-            else
-            {
-                JLOG(m_journal.debug())
-                    << iIdentifier << " Extra path element gives "
-                    << transHuman(rc.result());
-            }
+                << iIdentifier << " Extra path element gives "
+                << transHuman(rc.result());
         }
+    }
+
+    if (rc.result() == tesSUCCESS)
+    {
+        Json::Value jvEntry(Json::objectValue);
+        rc.actualAmountIn.setIssuer(sourceAccount);
+        jvEntry[jss::source_amount] =
+            rc.actualAmountIn.getJson(JsonOptions::none);
+        jvEntry[jss::paths_computed] = ps.getJson(JsonOptions::none);
+
+        if (convert_all_)
+            jvEntry[jss::destination_amount] =
+                rc.actualAmountOut.getJson(JsonOptions::none);
 
-        if (rc.result() == tesSUCCESS)
+        if (hasCompletion())
         {
-            Json::Value jvEntry(Json::objectValue);
-            rc.actualAmountIn.setIssuer(sourceAccount);
-            jvEntry[jss::source_amount] =
-                rc.actualAmountIn.getJson(JsonOptions::none);
-            jvEntry[jss::paths_computed] = ps.getJson(JsonOptions::none);
+            // Old ripple_path_find API requires this
+            jvEntry[jss::paths_canonical] = Json::arrayValue;
+        }
 
-            if (convert_all_)
-                jvEntry[jss::destination_amount] =
-                    rc.actualAmountOut.getJson(JsonOptions::none);
+        return jvEntry;
+    }
 
-            if (hasCompletion())
-            {
-                // Old ripple_path_find API requires this
-                jvEntry[jss::paths_canonical] = Json::arrayValue;
-            }
+    JLOG(m_journal.debug())
+        << iIdentifier << " rippleCalc returns " << transHuman(rc.result());
+    return boost::none;
+}
 
-            jvArray.append(jvEntry);
-        }
-        else
+bool
+PathRequest::findPaths(
+    std::shared_ptr<RippleLineCache> const& cache,
+    int const level,
+    Json::Value& jvArray,
+    bool charge)
+{
+    auto sourceCurrencies = sciSourceCurrencies;
+    if (sourceCurrencies.empty())
+    {
+        auto currencies = accountSourceCurrencies(*raSrcAccount, cache, true);
+        bool const sameAccount = *raSrcAccount == *raDstAccount;
+        for (auto const& c : currencies)
         {
-            JLOG(m_journal.debug()) << iIdentifier << " rippleCalc returns "
-                                    << transHuman(rc.result());
+            if (!sameAccount || c != saDstAmount.getCurrency())
+            {
+                if (sourceCurrencies.size() >= RPC::Tuning::max_auto_src_cur)
+                    return false;
+                sourceCurrencies.insert(
+                    {c, c.isZero() ? xrpAccount() : *raSrcAccount});
+            }
         }
     }
 
+    auto const dst_amount = convert_all_
+        ? STAmount(
+              saDstAmount.issue(), STAmount::cMaxValue, STAmount::cMaxOffset)
+        : saDstAmount;
+
+    // Issues are ordered by currency, and the issues of a currency share a
+    // Pathfinder, so each run of issues with the same currency is searched
+    // as a unit. The results are kept in the order of the issues, so the
+    // reply is the same however many searches run at once.
+    std::vector<Issue> const issues(
+        sourceCurrencies.begin(), sourceCurrencies.end());
+    std::vector<std::size_t> groups;
+    for (std::size_t i = 0; i < issues.size(); ++i)
+    {
+        if (i == 0 || issues[i].currency != issues[i - 1].currency)
+            groups.push_back(i);
+    }
+
+    std::vector<STPathSet> contexts;
+    contexts.reserve(issues.size());
+    for (auto const& issue : issues)
+        contexts.push_back(mContext[issue]);
+    std::vector<boost::optional<Json::Value>> entries(issues.size());
+
+    searchInParallel(
+        app_.getJobQueue(),
+        app_.config().PATH_SEARCH_THREADS,
+        groups.size(),
+        [&](std::size_t group) {
+            auto const last =
+                group + 1 < groups.size() ? groups[group + 1] : issues.size();
+            hash_map<Currency, std::shared_ptr<Pathfinder>> currency_map;
+            for (auto i = groups[group]; i < last; ++i)
+            {
+                entries[i] = findPaths(
+                    cache,
+                    currency_map,
+                    issues[i],
+                    dst_amount,
+                    level,
+                    contexts[i]);
+            }
+        });
+
+    for (std::size_t i = 0; i < issues.size(); ++i)
+    {
+        mContext[issues[i]] = std::move(contexts[i]);
+        if (entries[i])
+            jvArray.append(std::move(*entries[i]));
+    }
+
     /*  The resource fee is based on the number of source currencies used.
         The minimum cost is 50 and the maximum is 400. The cost increases
         after four source currencies, 50 - (4 * 4) = 34.
     */
-    int const size = sourceCurrencies.size();
-    consumer_.charge(
-        {boost::algorithm::clamp(size * size + 34, 50, 400), "path update"});
+    if (charge)
+    {
+        int const size = sourceCurrencies.size();
+        consumer_.charge(
+            {boost::algorithm::clamp(size * size + 34, 50, 400),
+             "path update"});
+    }
     return true;
 }
 
 Json::Value
-PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
+PathRequest::doUpdate(
+    std::shared_ptr<RippleLineCache> const& cache,
+    bool fast,
+    std::function<bool(Json::Value const&)> const& partial)
 {
     using namespace std::chrono;
     JLOG(m_journal.debug())
@@ -696,8 +860,44 @@ PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
 
     JLOG(m_journal.debug()) << iIdentifier << " processing at level " << iLevel;
 
+    // With a deadline, start shallow and deepen while there is time, so
+    // the client has an answer quickly even when the full search is slow
+    auto const deadline = app_.config().PATH_SEARCH_DEADLINE;
+    auto const start = steady_clock::now();
+    int level = iLevel;
+    if (partial && !fast && deadline.count() > 0)
+        level = std::min(level, app_.config().PATH_SEARCH_FAST);
+
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray))
+    bool valid = findPaths(cache, level, jvArray, true);
+    while (valid && level < iLevel)
+    {
+        if (steady_clock::now() - start >= deadline ||
+            app_.getFeeTrack().isLoadedLocal())
+        {
+            JLOG(m_journal.debug())
+                << iIdentifier << " stopped deepening at level " << level;
+            break;
+        }
+
+        Json::Value progress = newStatus;
+        progress[jss::alternatives] = jvArray;
+        progress[jss::full_reply] = false;
+        {
+            std::lock_guard sl(mLock);
+            jvStatus = progress;
+        }
+        if (!partial(progress))
+            break;
+
+        ++level;
+        Json::Value deeper = Json::arrayValue;
+        valid = findPaths(cache, level, deeper, false);
+        if (valid)
+            jvArray = std::move(deeper);
+    }
+
+    if (valid)
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move(jvArray);
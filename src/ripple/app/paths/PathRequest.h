@@ -27,6 +27,7 @@
 #include <ripple/net/InfoSub.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/optional.hpp>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <set>
@@ -95,9 +96,19 @@ public:
     Json::Value
     doStatus(Json::Value const&);
 
-    // update jvStatus
+    /** Update jvStatus.
+
+        When `partial` is set and [path_search_deadline] is configured, the
+        search starts at the fast level and deepens one level at a time
+        until the deadline passes or the server is loaded. The best paths
+        found so far are passed to `partial` before each deeper search,
+        which returns false to stop deepening.
+    */
     Json::Value
-    doUpdate(std::shared_ptr<RippleLineCache> const&, bool fast);
+    doUpdate(
+        std::shared_ptr<RippleLineCache> const&,
+        bool fast,
+        std::function<bool(Json::Value const&)> const& partial = {});
     InfoSub::pointer
     getSubscriber();
     bool
@@ -107,19 +118,38 @@ private:
     bool
     isValid(std::shared_ptr<RippleLineCache> const& crCache);
 
-    std::unique_ptr<Pathfinder> const&
+    std::shared_ptr<Pathfinder> const&
     getPathFinder(
         std::shared_ptr<RippleLineCache> const&,
-        hash_map<Currency, std::unique_ptr<Pathfinder>>&,
+        hash_map<Currency, std::shared_ptr<Pathfinder>>&,
         Currency const&,
         STAmount const&,
         int const);
 
     /** Finds and sets a PathSet in the JSON argument.
         Returns false if the source currencies are inavlid.
+        Charges the client for the search if `charge` is set.
     */
     bool
-    findPaths(std::shared_ptr<RippleLineCache> const&, int const, Json::Value&);
+    findPaths(
+        std::shared_ptr<RippleLineCache> const&,
+        int const,
+        Json::Value&,
+        bool charge);
+
+    /** Finds the best paths from one source issue and checks them.
+        Returns the alternative to add to the reply, if one was found.
+        Only touches state passed to it, so it may run in parallel
+        with searches for other currencies.
+    */
+    boost::optional<Json::Value>
+    findPaths(
+        std::shared_ptr<RippleLineCache> const&,
+        hash_map<Currency, std::shared_ptr<Pathfinder>>&,
+        Issue const&,
+        STAmount const&,
+        int const,
+        STPathSet&);
 
     int
     parseJson(Json::Value const&);
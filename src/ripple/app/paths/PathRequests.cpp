@@ -49,11 +49,37 @@ PathRequests::getLineCache(
          ((lgrSeq + 8) < lineSeq)) ||  // we jumped way back for some reason
         (lgrSeq > (lineSeq + 8)))      // we jumped way forward for some reason
     {
-        mLineCache = std::make_shared<RippleLineCache>(ledger);
+        // Lines for accounts the new ledger didn't touch are carried over
+        mLineCache = std::make_shared<RippleLineCache>(ledger, mLineCache);
+        mPathfinders.clear();
     }
     return mLineCache;
 }
 
+std::shared_ptr<Pathfinder>
+PathRequests::getPathfinder(
+    std::shared_ptr<RippleLineCache> const& cache,
+    uint256 const& key,
+    std::function<std::shared_ptr<Pathfinder>()> const& make)
+{
+    {
+        std::lock_guard sl(mLock);
+        if (cache != mLineCache)
+            return make();
+        auto const it = mPathfinders.find(key);
+        if (it != mPathfinders.end())
+            return it->second;
+    }
+
+    // Two requests may search at once; the first to finish is kept
+    auto pathfinder = make();
+
+    std::lock_guard sl(mLock);
+    if (cache != mLineCache)
+        return pathfinder;
+    return mPathfinders.emplace(key, std::move(pathfinder)).first->second;
+}
+
 void
 PathRequests::updateAll(
     std::shared_ptr<ReadView const> const& inLedger,
@@ -101,8 +127,16 @@ PathRequests::updateAll(
                     {
                         if (!ipSub->getConsumer().warn())
                         {
+                            // Send the best paths so far while the
+                            // search deepens
+                            auto partial = [&](Json::Value const& status) {
+                                Json::Value update = status;
+                                update[jss::type] = "path_find";
+                                ipSub->send(update, false);
+                                return !shouldCancel();
+                            };
                             Json::Value update =
-                                request->doUpdate(cache, false);
+                                request->doUpdate(cache, false, partial);
                             request->updateComplete();
                             update[jss::type] = "path_find";
                             ipSub->send(update, false);
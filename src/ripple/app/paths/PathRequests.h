@@ -25,6 +25,7 @@
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/core/Job.h>
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <vector>
 
@@ -59,6 +60,22 @@ public:
         std::shared_ptr<ReadView const> const& ledger,
         bool authoritative);
 
+    /** Return the search for a payment, sharing it between requests.
+
+        Searches on the current line cache are kept until the cache is
+        replaced, so requests for the same payment only search once.
+        Searches on any other cache are not shared.
+
+        @param cache The line cache to search.
+        @param key Identifies the payment and search level.
+        @param make Runs the search. Called without holding the lock.
+    */
+    std::shared_ptr<Pathfinder>
+    getPathfinder(
+        std::shared_ptr<RippleLineCache> const& cache,
+        uint256 const& key,
+        std::function<std::shared_ptr<Pathfinder>()> const& make);
+
     // Create a new-style path request that pushes
     // updates to a subscriber
     Json::Value
@@ -114,6 +131,9 @@ private:
     // Use a RippleLineCache
     std::shared_ptr<RippleLineCache> mLineCache;
 
+    // Searches on mLineCache
+    hash_map<uint256, std::shared_ptr<Pathfinder>> mPathfinders;
+
     std::atomic<int> mLastIdentifier;
 
     std::recursive_mutex mLock;
@@ -341,6 +341,7 @@ Pathfinder::getPathLiquidity(
 
     path::RippleCalc::Input rcInput;
     rcInput.defaultPathsAllowed = false;
+    rcInput.deadOffers = &mRLCache->deadOffers();
 
     PaymentSandbox sandbox(&*mLedger, tapNONE);
 
@@ -422,6 +423,7 @@ Pathfinder::computePathRanks(int maxPaths)
 
         path::RippleCalc::Input rcInput;
         rcInput.partialPaymentAllowed = true;
+        rcInput.deadOffers = &mRLCache->deadOffers();
         auto rc = path::RippleCalc::rippleCalculate(
             sandbox,
             mSrcAmount,
@@ -715,12 +717,12 @@ Pathfinder::getPathsOut(
     if (!inserted)
         return it->second;
 
-    auto sleAccount = mLedger->read(keylet::account(account));
+    auto const& links = mRLCache->getAccountLinks(account);
 
-    if (!sleAccount)
+    if (!links.exists())
         return 0;
 
-    int aFlags = sleAccount->getFieldU32(sfFlags);
+    int aFlags = links.accountFlags();
     bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
     bool const bFrozen = ((aFlags & lsfGlobalFreeze) != 0);
 
@@ -730,30 +732,20 @@ Pathfinder::getPathsOut(
     {
         count = app_.getOrderBookDB().getBookSize(issue);
 
-        for (auto const& item : mRLCache->getRippleLines(account))
+        for (auto const& link : links.links(currency))
         {
-            RippleState* rspEntry = (RippleState*)item.get();
-
-            if (currency != rspEntry->getLimit().getCurrency())
-            {
-            }
-            else if (
-                rspEntry->getBalance() <= beast::zero &&
-                (!rspEntry->getLimitPeer() ||
-                 -rspEntry->getBalance() >= rspEntry->getLimitPeer() ||
-                 (bAuthRequired && !rspEntry->getAuth())))
+            if (!link.hasCredit(bAuthRequired))
             {
             }
-            else if (
-                isDstCurrency && dstAccount == rspEntry->getAccountIDPeer())
+            else if (isDstCurrency && dstAccount == link.peer)
             {
                 count += 10000;  // count a path to the destination extra
             }
-            else if (rspEntry->getNoRipplePeer())
+            else if (link.flags & AccountLinks::noRipplePeer)
             {
                 // This probably isn't a useful path out
             }
-            else if (rspEntry->getFreezePeer())
+            else if (link.flags & AccountLinks::freezePeer)
             {
                 // Not a useful path out
             }
@@ -856,13 +848,11 @@ Pathfinder::isNoRipple(
     AccountID const& toAccount,
     Currency const& currency)
 {
-    auto sleRipple =
-        mLedger->read(keylet::line(toAccount, fromAccount, currency));
-
-    auto const flag(
-        (toAccount > fromAccount) ? lsfHighNoRipple : lsfLowNoRipple);
+    // The path goes on to explore the lines of toAccount anyway
+    auto const link =
+        mRLCache->getAccountLinks(toAccount).find(fromAccount, currency);
 
-    return sleRipple && (sleRipple->getFieldU32(sfFlags) & flag);
+    return link && (link->flags & AccountLinks::noRipple);
 }
 
 // Does this path end on an account-to-account link whose last account has
@@ -937,31 +927,25 @@ Pathfinder::addLink(
         else
         {
             // search for accounts to add
-            auto const sleEnd = mLedger->read(keylet::account(uEndAccount));
+            auto const& endLinks = mRLCache->getAccountLinks(uEndAccount);
 
-            if (sleEnd)
+            if (endLinks.exists())
             {
                 bool const bRequireAuth(
-                    sleEnd->getFieldU32(sfFlags) & lsfRequireAuth);
+                    endLinks.accountFlags() & lsfRequireAuth);
                 bool const bIsEndCurrency(
                     uEndCurrency == mDstAmount.getCurrency());
                 bool const bIsNoRippleOut(isNoRippleOut(currentPath));
                 bool const bDestOnly(addFlags & afAC_LAST);
 
-                auto& rippleLines(mRLCache->getRippleLines(uEndAccount));
+                auto const links = endLinks.links(uEndCurrency);
 
                 AccountCandidates candidates;
-                candidates.reserve(rippleLines.size());
+                candidates.reserve(links.size());
 
-                for (auto const& item : rippleLines)
+                for (auto const& link : links)
                 {
-                    auto* rs = dynamic_cast<RippleState const*>(item.get());
-                    if (!rs)
-                    {
-                        JLOG(j_.error()) << "Couldn't decipher RippleState";
-                        continue;
-                    }
-                    auto const& acct = rs->getAccountIDPeer();
+                    auto const& acct = link.peer;
 
                     if (hasEffectiveDestination && (acct == mDstAccount))
                     {
@@ -976,18 +960,16 @@ Pathfinder::addLink(
                         continue;
                     }
 
-                    if ((uEndCurrency == rs->getLimit().getCurrency()) &&
-                        !currentPath.hasSeen(acct, uEndCurrency, acct))
+                    if (!currentPath.hasSeen(acct, uEndCurrency, acct))
                     {
-                        // path is for correct currency and has not been seen
-                        if (rs->getBalance() <= beast::zero &&
-                            (!rs->getLimitPeer() ||
-                             -rs->getBalance() >= rs->getLimitPeer() ||
-                             (bRequireAuth && !rs->getAuth())))
+                        // path has not been seen
+                        if (!link.hasCredit(bRequireAuth))
                         {
                             // path has no credit
                         }
-                        else if (bIsNoRippleOut && rs->getNoRipple())
+                        else if (
+                            bIsNoRippleOut &&
+                            (link.flags & AccountLinks::noRipple))
                         {
                             // Can't leave on this path
                         }
@@ -111,7 +111,8 @@ RippleCalc::rippleCalculate(
                 limitQuality,
                 sendMax,
                 j,
-                nullptr);
+                nullptr,
+                pInputs ? pInputs->deadOffers : nullptr);
         }
         catch (std::exception& e)
         {
@@ -29,6 +29,7 @@
 
 namespace ripple {
 class Config;
+class DeadOffers;
 namespace path {
 
 namespace detail {
@@ -51,6 +52,8 @@ public:
         bool defaultPathsAllowed = true;
         bool limitQuality = false;
         bool isLedgerOpen = true;
+        // Offers path finding can pass over. Never set for transactions.
+        DeadOffers* deadOffers = nullptr;
     };
     struct Output
     {
@@ -19,15 +19,196 @@
 
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <algorithm>
 
 namespace ripple {
 
+AccountLinks::AccountLinks(
+    ReadView const& view,
+    AccountID const& account,
+    std::vector<RippleState::pointer> const& lines)
+{
+    if (auto const sle = view.read(keylet::account(account)))
+    {
+        exists_ = true;
+        accountFlags_ = sle->getFieldU32(sfFlags);
+    }
+
+    links_.reserve(lines.size());
+    for (auto const& line : lines)
+    {
+        std::uint8_t flags = 0;
+        if (line->getBalance() > beast::zero)
+            flags |= positive;
+        if (line->getLimitPeer() != beast::zero &&
+            -line->getBalance() < line->getLimitPeer())
+            flags |= peerCredit;
+        if (line->getAuth())
+            flags |= auth;
+        if (line->getNoRipple())
+            flags |= noRipple;
+        if (line->getNoRipplePeer())
+            flags |= noRipplePeer;
+        if (line->getFreezePeer())
+            flags |= freezePeer;
+        links_.push_back(
+            {line->getAccountIDPeer(), line->getLimit().getCurrency(), flags});
+    }
+
+    std::stable_sort(
+        links_.begin(), links_.end(), [](Link const& a, Link const& b) {
+            return a.currency < b.currency;
+        });
+}
+
+boost::iterator_range<AccountLinks::const_iterator>
+AccountLinks::links(Currency const& currency) const
+{
+    auto const first = std::lower_bound(
+        links_.begin(),
+        links_.end(),
+        currency,
+        [](Link const& link, Currency const& c) { return link.currency < c; });
+    auto const last = std::upper_bound(
+        first,
+        links_.end(),
+        currency,
+        [](Currency const& c, Link const& link) { return c < link.currency; });
+    return boost::make_iterator_range(first, last);
+}
+
+AccountLinks::Link const*
+AccountLinks::find(AccountID const& peer, Currency const& currency) const
+{
+    for (auto const& link : links(currency))
+    {
+        if (link.peer == peer)
+            return &link;
+    }
+    return nullptr;
+}
+
 RippleLineCache::RippleLineCache(std::shared_ptr<ReadView const> const& ledger)
 {
     // We want the caching that OpenView provides
     // And we need to own a shared_ptr to the input view
     // VFALCO TODO This should be a CachedLedger
     mLedger = std::make_shared<OpenView>(&*ledger, ledger);
+    deadOffers_ = std::make_unique<DeadOffers>(
+        mLedger, beast::Journal{beast::Journal::getNullSink()});
+}
+
+RippleLineCache::RippleLineCache(
+    std::shared_ptr<ReadView const> const& ledger,
+    std::shared_ptr<RippleLineCache> const& previous)
+    : RippleLineCache(ledger)
+{
+    if (previous)
+        carryOver(*ledger, *previous);
+}
+
+void
+RippleLineCache::carryOver(
+    ReadView const& ledger,
+    RippleLineCache const& previous)
+{
+    if (previous.mLedger->info().seq + 1 != ledger.info().seq ||
+        previous.mLedger->info().hash != ledger.info().parentHash)
+        return;
+
+    // The trust lines of each account the ledger's transactions touched,
+    // the accounts they changed and the accounts they deleted
+    hash_map<AccountID, hash_set<uint256>> changed;
+    hash_set<AccountID> accounts;
+    hash_set<AccountID> deleted;
+    try
+    {
+        for (auto const& item : ledger.txs)
+        {
+            auto const& meta = item.second;
+            if (!meta)
+                return;
+            for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+            {
+                auto const type = node.getFieldU16(sfLedgerEntryType);
+                if (type != ltRIPPLE_STATE && type != ltACCOUNT_ROOT)
+                    continue;
+
+                auto const data = dynamic_cast<STObject const*>(
+                    node.peekAtPField(
+                        node.getFName() == sfCreatedNode ? sfNewFields
+                                                         : sfFinalFields));
+                if (type == ltACCOUNT_ROOT)
+                {
+                    if (!data || !data->isFieldPresent(sfAccount))
+                        return;
+                    auto const account = data->getAccountID(sfAccount);
+                    accounts.insert(account);
+                    if (node.getFName() == sfDeletedNode)
+                        deleted.insert(account);
+                    continue;
+                }
+
+                if (!data || !data->isFieldPresent(sfLowLimit) ||
+                    !data->isFieldPresent(sfHighLimit))
+                    return;
+                auto const key = node.getFieldH256(sfLedgerIndex);
+                changed[data->getFieldAmount(sfLowLimit).getIssuer()].insert(
+                    key);
+                changed[data->getFieldAmount(sfHighLimit).getIssuer()].insert(
+                    key);
+            }
+        }
+    }
+    catch (std::exception const&)
+    {
+        // Without a full account of the changes nothing can be kept
+        return;
+    }
+
+    std::lock_guard sl(previous.mLock);
+    lines_.reserve(previous.lines_.size());
+    for (auto const& [key, entry] : previous.lines_)
+    {
+        auto const& account = key.account_;
+        if (!entry.used || deleted.count(account))
+            continue;
+
+        auto lines = entry.lines;
+        auto links = accounts.count(account) ? nullptr : entry.links;
+        if (auto const it = changed.find(account); it != changed.end())
+        {
+            // Replace the lines which changed in place, so the lines keep
+            // the order of the owner directory, and add the new ones last.
+            auto keys = it->second;
+            auto updated =
+                std::make_shared<std::vector<RippleState::pointer>>();
+            updated->reserve(lines->size() + keys.size());
+            auto const add = [&](uint256 const& index) {
+                auto item = RippleState::makeItem(
+                    account, mLedger->read(Keylet(ltRIPPLE_STATE, index)));
+                if (item)
+                    updated->push_back(std::move(item));
+            };
+            for (auto const& line : *lines)
+            {
+                if (keys.erase(line->key()) != 0)
+                    add(line->key());
+                else
+                    updated->push_back(line);
+            }
+            for (auto const& index : keys)
+                add(index);
+            lines = std::move(updated);
+            links = nullptr;
+        }
+
+        lines_.emplace(
+            AccountKey(account, hasher_(account)),
+            Entry{std::move(lines), std::move(links)});
+    }
 }
 
 std::vector<RippleState::pointer> const&
@@ -35,15 +216,58 @@ RippleLineCache::getRippleLines(AccountID const& accountID)
 {
     AccountKey key(accountID, hasher_(accountID));
 
+    {
+        std::lock_guard sl(mLock);
+        if (auto const it = lines_.find(key); it != lines_.end())
+        {
+            it->second.used = true;
+            return *it->second.lines;
+        }
+    }
+
+    // Read the lines without holding the lock, so path searches running in
+    // parallel don't wait on each other. If two of them read the same
+    // account at once, the first result is kept.
+    auto lines = std::make_shared<std::vector<RippleState::pointer> const>(
+        getRippleStateItems(accountID, *mLedger));
+
     std::lock_guard sl(mLock);
+    auto& entry = lines_.emplace(key, Entry{std::move(lines), nullptr, true})
+                      .first->second;
+    entry.used = true;
+    return *entry.lines;
+}
 
-    auto [it, inserted] =
-        lines_.emplace(key, std::vector<RippleState::pointer>());
+AccountLinks const&
+RippleLineCache::getAccountLinks(AccountID const& accountID)
+{
+    AccountKey key(accountID, hasher_(accountID));
+
+    {
+        std::lock_guard sl(mLock);
+        if (auto const it = lines_.find(key);
+            it != lines_.end() && it->second.links)
+        {
+            it->second.used = true;
+            return *it->second.links;
+        }
+    }
+
+    auto links = std::make_shared<AccountLinks const>(
+        *mLedger, accountID, getRippleLines(accountID));
 
-    if (inserted)
-        it->second = getRippleStateItems(accountID, *mLedger);
+    std::lock_guard sl(mLock);
+    auto& entry = lines_.find(key)->second;
+    if (!entry.links)
+        entry.links = std::move(links);
+    return *entry.links;
+}
 
-    return it->second;
+std::size_t
+RippleLineCache::size() const
+{
+    std::lock_guard sl(mLock);
+    return lines_.size();
 }
 
 }  // namespace ripple
@@ -21,21 +21,115 @@
 #define RIPPLE_APP_PATHS_RIPPLELINECACHE_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/paths/DeadOffers.h>
 #include <ripple/app/paths/RippleState.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/basics/hardened_hash.h>
+#include <boost/range/iterator_range.hpp>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
 
 namespace ripple {
 
+/** An account's trust lines, reduced to what path finding looks at.
+
+    The links are sorted by currency, keeping the order of the owner
+    directory within a currency, so that the lines of one currency can be
+    visited without reading the others.
+*/
+class AccountLinks
+{
+public:
+    enum Flags : std::uint8_t {
+        // The peer owes the account
+        positive = 0x01,
+        // The account hasn't used up the credit the peer extends to it
+        peerCredit = 0x02,
+        auth = 0x04,
+        noRipple = 0x08,
+        noRipplePeer = 0x10,
+        freezePeer = 0x20,
+    };
+
+    struct Link
+    {
+        AccountID peer;
+        Currency currency;
+        std::uint8_t flags;
+
+        /** Whether the account can send value to the peer on this line.
+            @param requireAuth Whether the account requires authorization.
+        */
+        bool
+        hasCredit(bool requireAuth) const
+        {
+            return (flags & positive) ||
+                ((flags & peerCredit) && (!requireAuth || (flags & auth)));
+        }
+    };
+
+    using const_iterator = std::vector<Link>::const_iterator;
+
+    AccountLinks(
+        ReadView const& view,
+        AccountID const& account,
+        std::vector<RippleState::pointer> const& lines);
+
+    /** Whether the account exists. */
+    bool
+    exists() const
+    {
+        return exists_;
+    }
+
+    /** The flags of the account's root entry. */
+    std::uint32_t
+    accountFlags() const
+    {
+        return accountFlags_;
+    }
+
+    /** The links in a currency. */
+    boost::iterator_range<const_iterator>
+    links(Currency const& currency) const;
+
+    /** The link with a peer in a currency, or nullptr if there is none. */
+    Link const*
+    find(AccountID const& peer, Currency const& currency) const;
+
+private:
+    bool exists_ = false;
+    std::uint32_t accountFlags_ = 0;
+    std::vector<Link> links_;
+};
+
 // Used by Pathfinder
 class RippleLineCache
 {
 public:
     explicit RippleLineCache(std::shared_ptr<ReadView const> const& l);
 
+    /** Create a cache for a ledger, starting from the cache of the ledger
+        before it.
+
+        The lines of accounts looked up through `previous` are carried
+        over, with the trust lines the ledger's transactions created,
+        changed or deleted updated from the ledger. Their links are
+        carried over too, unless their lines or account changed. Accounts
+        which were carried over but not looked up are dropped, so the
+        cache only keeps the accounts path finding keeps asking for.
+
+        If `previous` is not for the parent of `l`, or the ledger has no
+        metadata, this is the same as starting with an empty cache.
+    */
+    RippleLineCache(
+        std::shared_ptr<ReadView const> const& l,
+        std::shared_ptr<RippleLineCache> const& previous);
+
     std::shared_ptr<ReadView const> const&
     getLedger() const
     {
@@ -45,11 +139,33 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines(AccountID const& accountID);
 
+    /** The lines of an account as path finding searches them. */
+    AccountLinks const&
+    getAccountLinks(AccountID const& accountID);
+
+    /** The number of accounts whose lines are cached. */
+    std::size_t
+    size() const;
+
+    /** The offers in the ledger which path finding can pass over. */
+    DeadOffers&
+    deadOffers()
+    {
+        return *deadOffers_;
+    }
+
 private:
-    std::mutex mLock;
+    using Lines = std::shared_ptr<std::vector<RippleState::pointer> const>;
+
+    // Take the lines of the previous ledger's cache which are still valid
+    void
+    carryOver(ReadView const& ledger, RippleLineCache const& previous);
 
-    ripple::hardened_hash<> hasher_;
+    mutable std::mutex mLock;
+
+    uniform_hash hasher_;
     std::shared_ptr<ReadView const> mLedger;
+    std::unique_ptr<DeadOffers> deadOffers_;
 
     struct AccountKey
     {
@@ -90,8 +206,17 @@ private:
         };
     };
 
-    hash_map<AccountKey, std::vector<RippleState::pointer>, AccountKey::Hash>
-        lines_;
+    struct Entry
+    {
+        Lines lines;
+        std::shared_ptr<AccountLinks const> links;
+        // Whether getRippleLines asked for the account. Entries carried
+        // over from an earlier ledger aren't until they're asked for again.
+        bool used = false;
+    };
+
+    // Lines are shared with the caches of later ledgers until they change
+    flat_hash_map<AccountKey, Entry, AccountKey::Hash> lines_;
 };
 
 }  // namespace ripple
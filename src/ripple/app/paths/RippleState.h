@@ -60,6 +60,13 @@ public:
         return sle_->key();
     }
 
+    /** Returns the ledger entry. */
+    SLE const&
+    sle() const
+    {
+        return *sle_;
+    }
+
     // VFALCO Take off the "get" from each function name
 
     AccountID const&
@@ -52,6 +52,8 @@ protected:
     bool const ownerPaysTransferFee_;
     // Mark as inactive (dry) if too many offers are consumed
     bool inactive_ = false;
+    // Offers path finding can pass over, if this is path finding
+    DeadOffers* const deadOffers_;
     beast::Journal const j_;
 
     struct Cache
@@ -82,6 +84,7 @@ public:
         , strandDst_(ctx.strandDst)
         , prevStep_(ctx.prevStep)
         , ownerPaysTransferFee_(ctx.ownerPaysTransferFee)
+        , deadOffers_(ctx.deadOffers)
         , j_(ctx.j)
     {
     }
@@ -558,6 +561,7 @@ BookStep<TIn, TOut, TDerived>::forEachOffer(
 
     FlowOfferStream<TIn, TOut> offers(
         sb, afView, book_, sb.parentCloseTime(), counter, j_);
+    offers.setDeadOffers(deadOffers_);
 
     bool const flowCross = afView.rules().enabled(featureFlowCross);
     bool offerAttempted = false;
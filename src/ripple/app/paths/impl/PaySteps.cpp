@@ -142,7 +142,8 @@ toStrand(
     STPath const& path,
     bool ownerPaysTransferFee,
     bool offerCrossing,
-    beast::Journal j)
+    beast::Journal j,
+    DeadOffers* deadOffers)
 {
     if (isXRP(src) || isXRP(dst) || !isConsistent(deliver) ||
         (sendMaxIssue && !isConsistent(*sendMaxIssue)))
@@ -278,7 +279,8 @@ toStrand(
             isDefaultPath,
             seenDirectIssues,
             seenBookOuts,
-            j};
+            j,
+            deadOffers};
     };
 
     for (std::size_t i = 0; i < normPath.size() - 1; ++i)
@@ -474,7 +476,8 @@ toStrands(
     bool addDefaultPath,
     bool ownerPaysTransferFee,
     bool offerCrossing,
-    beast::Journal j)
+    beast::Journal j,
+    DeadOffers* deadOffers)
 {
     std::vector<Strand> result;
     result.reserve(1 + paths.size());
@@ -499,7 +502,8 @@ toStrands(
             STPath(),
             ownerPaysTransferFee,
             offerCrossing,
-            j);
+            j,
+            deadOffers);
         auto const ter = sp.first;
         auto& strand = sp.second;
 
@@ -542,7 +546,8 @@ toStrands(
             p,
             ownerPaysTransferFee,
             offerCrossing,
-            j);
+            j,
+            deadOffers);
         auto ter = sp.first;
         auto& strand = sp.second;
 
@@ -587,7 +592,8 @@ StrandContext::StrandContext(
     bool isDefaultPath_,
     std::array<boost::container::flat_set<Issue>, 2>& seenDirectIssues_,
     boost::container::flat_set<Issue>& seenBookOuts_,
-    beast::Journal j_)
+    beast::Journal j_,
+    DeadOffers* deadOffers_)
     : view(view_)
     , strandSrc(strandSrc_)
     , strandDst(strandDst_)
@@ -602,6 +608,7 @@ StrandContext::StrandContext(
     , prevStep(!strand_.empty() ? strand_.back().get() : nullptr)
     , seenDirectIssues(seenDirectIssues_)
     , seenBookOuts(seenBookOuts_)
+    , deadOffers(deadOffers_)
     , j(j_)
 {
 }
@@ -33,6 +33,7 @@ namespace ripple {
 class PaymentSandbox;
 class ReadView;
 class ApplyView;
+class DeadOffers;
 
 enum class DebtDirection { issues, redeems };
 enum class QualityDirection { in, out };
@@ -337,6 +338,7 @@ normalizePath(
    owner
    @param offerCrossing false -> payment; true -> offer crossing
    @param j Journal for logging messages
+   @param deadOffers Offers BookSteps may pass over, when path finding
    @return Error code and constructed Strand
 */
 std::pair<TER, Strand>
@@ -350,7 +352,8 @@ toStrand(
     STPath const& path,
     bool ownerPaysTransferFee,
     bool offerCrossing,
-    beast::Journal j);
+    beast::Journal j,
+    DeadOffers* deadOffers = nullptr);
 
 /**
    Create a Strand for each specified path (including the default path, if
@@ -374,6 +377,7 @@ toStrand(
    owner
    @param offerCrossing false -> payment; true -> offer crossing
    @param j Journal for logging messages
+   @param deadOffers Offers BookSteps may pass over, when path finding
    @return error code and collection of strands
 */
 std::pair<TER, std::vector<Strand>>
@@ -388,7 +392,8 @@ toStrands(
     bool addDefaultPath,
     bool ownerPaysTransferFee,
     bool offerCrossing,
-    beast::Journal j);
+    beast::Journal j,
+    DeadOffers* deadOffers = nullptr);
 
 /// @cond INTERNAL
 template <class TIn, class TOut, class TDerived>
@@ -496,6 +501,8 @@ struct StrandContext
         than once
     */
     boost::container::flat_set<Issue>& seenBookOuts;
+    /** Offers which can be passed over, only set when path finding */
+    DeadOffers* const deadOffers;
     beast::Journal const j;
 
     /** StrandContext constructor. */
@@ -515,8 +522,9 @@ struct StrandContext
         std::array<boost::container::flat_set<Issue>, 2>&
             seenDirectIssues_,  ///< For detecting currency loops
         boost::container::flat_set<Issue>&
-            seenBookOuts_,   ///< For detecting book loops
-        beast::Journal j_);  ///< Journal for logging
+            seenBookOuts_,  ///< For detecting book loops
+        beast::Journal j_,  ///< Journal for logging
+        DeadOffers* deadOffers_ = nullptr);
 };
 
 /// @cond INTERNAL
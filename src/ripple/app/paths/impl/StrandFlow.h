@@ -29,6 +29,7 @@
 #include <ripple/basics/IOUAmount.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/XRPAmount.h>
+#include <ripple/protocol/Feature.h>
 
 #include <boost/container/flat_set.hpp>
 
@@ -366,19 +367,70 @@ public:
     // Start a new iteration in the search for liquidity
     // Set the current strands to the strands in `next_`
     void
-    activateNext()
+    activateNext(
+        ReadView const& v,
+        boost::optional<Quality> const& limitQuality)
     {
+        // With FlowSortStrands the strands are searched best theoretical
+        // quality first, so that the search can stop at the first strand
+        // with liquidity. Strands which can't meet limitQuality are dropped.
+        if (v.rules().enabled(featureFlowSortStrands) && next_.size() > 1)
+        {
+            std::vector<std::pair<Quality, Strand const*>> strandQuals;
+            strandQuals.reserve(next_.size());
+            for (Strand const* strand : next_)
+            {
+                if (auto const qual = qualityUpperBound(v, *strand))
+                {
+                    // A strand's quality can only improve in the unusual
+                    // case of an account going from redeeming to issuing
+                    // when transfer fees are charged.
+                    if (limitQuality && *qual < *limitQuality)
+                        continue;
+                    strandQuals.push_back({*qual, strand});
+                }
+            }
+
+            // Stable sort, so the order is the same with any standard
+            // library implementation
+            std::stable_sort(
+                strandQuals.begin(),
+                strandQuals.end(),
+                [](auto const& lhs, auto const& rhs) {
+                    // higher qualities first
+                    return lhs.first > rhs.first;
+                });
+            next_.clear();
+            for (auto const& sq : strandQuals)
+                next_.push_back(sq.second);
+        }
+
         // Swap, don't move, so we keep the reserve in next_
         cur_.clear();
         std::swap(cur_, next_);
     }
 
+    Strand const*
+    get(std::size_t i) const
+    {
+        return cur_[i];
+    }
+
     void
     push(Strand const* s)
     {
         next_.push_back(s);
     }
 
+    // Push the current strands from index `i` on to next_
+    void
+    pushRemainingCurToNext(std::size_t i)
+    {
+        if (i >= cur_.size())
+            return;
+        next_.insert(next_.end(), std::next(cur_.begin(), i), cur_.end());
+    }
+
     auto
     begin()
     {
@@ -497,6 +549,7 @@ flow(
 
     // non-dry strands
     ActiveStrands activeStrands(strands);
+    bool const sortStrands = baseView.rules().enabled(featureFlowSortStrands);
 
     // Keeping a running sum of the amount in the order they are processed
     // will not give the best precision. Keep a collection so they may be summed
@@ -526,7 +579,7 @@ flow(
             return {telFAILED_PROCESSING, std::move(ofrsToRmOnFail)};
         }
 
-        activeStrands.activateNext();
+        activeStrands.activateNext(sb, limitQuality);
 
         boost::container::flat_set<uint256> ofrsToRm;
         boost::optional<BestStrand> best;
@@ -537,8 +590,11 @@ flow(
         // offers Constructed as `false,0` to workaround a gcc warning about
         // uninitialized variables
         boost::optional<std::size_t> markInactiveOnUse{false, 0};
-        for (auto strand : activeStrands)
+        for (std::size_t strandIndex = 0, sie = activeStrands.size();
+             strandIndex != sie;
+             ++strandIndex)
         {
+            Strand const* strand = activeStrands.get(strandIndex);
             if (offerCrossing && limitQuality)
             {
                 auto const strandQ = qualityUpperBound(sb, *strand);
@@ -576,6 +632,19 @@ flow(
                 continue;
             }
 
+            if (sortStrands)
+            {
+                // The strands are in order of their best possible quality,
+                // so take the first with liquidity and leave the rest for
+                // the next iteration.
+                assert(!best);
+                if (!f.inactive)
+                    activeStrands.push(strand);
+                best.emplace(f.in, f.out, std::move(*f.sandbox), *strand, q);
+                activeStrands.pushRemainingCurToNext(strandIndex + 1);
+                break;
+            }
+
             activeStrands.push(strand);
 
             if (!best || best->quality < q ||
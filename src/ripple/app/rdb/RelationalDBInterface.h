@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_RDB_RELATIONALDBINTERFACE_H_INCLUDED
+#define RIPPLE_APP_RDB_RELATIONALDBINTERFACE_H_INCLUDED
+
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/AccountID.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class AcceptedLedger;
+class DatabaseCon;
+
+/** The record of which transactions each validated ledger holds.
+
+    The server writes every validated ledger's transactions, and the
+    accounts each affects, to this record, and answers account_tx queries
+    from it. Going through this interface rather than issuing SQL lets the
+    record be kept by some other store than the SQLite transaction
+    database.
+*/
+class RelationalDBInterface
+{
+public:
+    /** Called with the ledger sequence, status, raw transaction and raw
+        metadata of each transaction found, in the order requested.
+    */
+    using TxCallback = std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)>;
+
+    /** Which of an account's transactions to look for. */
+    struct AccountTxOptions
+    {
+        AccountID account;
+        /** The oldest and newest ledger to look in, or -1 for no bound. */
+        std::int32_t minLedger = -1;
+        std::int32_t maxLedger = -1;
+        /** The most transactions to return, or -1 for the default. */
+        int limit = -1;
+        /** Whether the caller wants binary results, which are smaller and
+            so are returned in larger pages. */
+        bool binary = false;
+        /** Whether the limit may exceed the normal page length. */
+        bool unlimited = false;
+    };
+
+    virtual ~RelationalDBInterface() = default;
+
+    /** Record the transactions of validated ledgers.
+
+        All of the ledgers are written together, so that a batch costs no
+        more commits than a single ledger. Whatever was recorded for the
+        same ledger sequences before is replaced.
+
+        @param current `true` if the ledgers were just validated by this
+            server, `false` if they were acquired.
+    */
+    virtual void
+    saveTransactions(
+        std::vector<std::shared_ptr<AcceptedLedger>> const& ledgers,
+        bool current) = 0;
+
+    /** Find an account's transactions, skipping the first `offset`. */
+    virtual void
+    getAccountTxs(
+        AccountTxOptions const& options,
+        bool descending,
+        std::uint32_t offset,
+        TxCallback const& onTransaction) = 0;
+
+    /** Find one page of an account's transactions.
+
+        @param marker Where to resume a previous search. On return, where
+            to resume this one, or unseated if there is nothing more.
+        @param onUnsavedLedger Called with the sequence of any ledger
+            whose transactions were found to be incompletely recorded.
+    */
+    virtual void
+    getAccountTxsPage(
+        AccountTxOptions const& options,
+        bool forward,
+        std::optional<NetworkOPs::AccountTxMarker>& marker,
+        std::uint32_t pageLength,
+        std::function<void(std::uint32_t)> const& onUnsavedLedger,
+        TxCallback const& onTransaction) = 0;
+};
+
+/** Keep the record in the SQLite transaction database. */
+std::unique_ptr<RelationalDBInterface>
+makeRelationalDBInterfaceSqlite(
+    DatabaseCon& txnDB,
+    AccountIDCache const& idCache,
+    beast::Journal journal);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,397 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/app/rdb/RelationalDBInterface.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/TxFormats.h>
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+namespace ripple {
+
+class RelationalDBInterfaceSqlite : public RelationalDBInterface
+{
+    DatabaseCon& txnDB_;
+    AccountIDCache const& idCache_;
+    beast::Journal const j_;
+
+public:
+    RelationalDBInterfaceSqlite(
+        DatabaseCon& txnDB,
+        AccountIDCache const& idCache,
+        beast::Journal journal)
+        : txnDB_(txnDB), idCache_(idCache), j_(journal)
+    {
+    }
+
+    void
+    saveTransactions(
+        std::vector<std::shared_ptr<AcceptedLedger>> const& ledgers,
+        bool current) override;
+
+    void
+    getAccountTxs(
+        AccountTxOptions const& options,
+        bool descending,
+        std::uint32_t offset,
+        TxCallback const& onTransaction) override;
+
+    void
+    getAccountTxsPage(
+        AccountTxOptions const& options,
+        bool forward,
+        std::optional<NetworkOPs::AccountTxMarker>& marker,
+        std::uint32_t pageLength,
+        std::function<void(std::uint32_t)> const& onUnsavedLedger,
+        TxCallback const& onTransaction) override;
+
+private:
+    std::string
+    transactionsSQL(
+        AccountTxOptions const& options,
+        bool descending,
+        std::uint32_t offset) const;
+};
+
+void
+RelationalDBInterfaceSqlite::saveTransactions(
+    std::vector<std::shared_ptr<AcceptedLedger>> const& ledgers,
+    bool current)
+{
+    // The rows for every transaction in the ledgers are gathered first
+    // and written with one statement per table, each prepared once.
+    std::vector<long long> ledgerSeqs;
+    std::vector<long long> firstSeqKeys;
+    std::vector<long long> lastSeqKeys;
+    std::vector<std::string> txnIds;
+    std::vector<std::string> acctTxnIds;
+    std::vector<std::string> acctAccounts;
+    std::vector<long long> acctLedgerSeqs;
+    std::vector<int> acctTxnSeqs;
+    std::vector<AccountID> acctIDs;
+    std::vector<uint256> acctTxnHashes;
+    ledgerSeqs.reserve(ledgers.size());
+
+    for (auto const& ledger : ledgers)
+    {
+        auto const seq = ledger->getLedger()->info().seq;
+        ledgerSeqs.push_back(seq);
+        firstSeqKeys.push_back(accountTxSeqKey(seq, 0));
+        lastSeqKeys.push_back(
+            accountTxSeqKey(seq, std::numeric_limits<std::uint32_t>::max()));
+
+        for (auto const& [_, acceptedLedgerTx] : ledger->getMap())
+        {
+            (void)_;
+            txnIds.push_back(to_string(acceptedLedgerTx->getTransactionID()));
+
+            auto const& accts = acceptedLedgerTx->getAffected();
+            if (accts.empty())
+            {
+                JLOG(j_.warn()) << "Transaction in ledger " << seq
+                                << " affects no accounts";
+                JLOG(j_.warn()) << acceptedLedgerTx->getTxn()->getJson(
+                    JsonOptions::none);
+                continue;
+            }
+
+            for (auto const& account : accts)
+            {
+                acctTxnIds.push_back(txnIds.back());
+                acctAccounts.push_back(idCache_.toBase58(account));
+                acctLedgerSeqs.push_back(seq);
+                acctTxnSeqs.push_back(acceptedLedgerTx->getTxnSeq());
+                acctIDs.push_back(account);
+                acctTxnHashes.push_back(acceptedLedgerTx->getTransactionID());
+            }
+        }
+    }
+
+    if (ledgerSeqs.empty())
+        return;
+
+    auto db = txnDB_.checkoutDb();
+
+    soci::transaction tr(*db);
+
+    *db << "DELETE FROM Transactions WHERE LedgerSeq = :seq;",
+        soci::use(ledgerSeqs);
+    *db << "DELETE FROM AccountTransactions WHERE LedgerSeq = :seq;",
+        soci::use(ledgerSeqs);
+    *db << "DELETE FROM AccountTxIndex WHERE SeqKey BETWEEN :first AND :last;",
+        soci::use(firstSeqKeys), soci::use(lastSeqKeys);
+
+    // A ledger which was just validated cannot have been saved under
+    // another sequence, so deleting by sequence above was enough. One
+    // that was acquired may replace rows saved from a different ledger.
+    if (!current && !txnIds.empty())
+    {
+        *db << "DELETE FROM AccountTransactions WHERE TransID = :id;",
+            soci::use(txnIds);
+        // Find where the transaction was recorded before it is replaced
+        *db << "DELETE FROM AccountTxIndex WHERE hex(TransID) = :id AND "
+               "SeqKey BETWEEN "
+               "(SELECT LedgerSeq << 32 FROM Transactions "
+               "WHERE TransID = :id) AND "
+               "(SELECT LedgerSeq << 32 | 4294967295 FROM Transactions "
+               "WHERE TransID = :id);",
+            soci::use(txnIds);
+    }
+
+    if (!acctTxnIds.empty())
+    {
+        *db << "INSERT INTO AccountTransactions "
+               "(TransID, Account, LedgerSeq, TxnSeq) VALUES "
+               "(:id, :account, :seq, :txnSeq);",
+            soci::use(acctTxnIds), soci::use(acctAccounts),
+            soci::use(acctLedgerSeqs), soci::use(acctTxnSeqs);
+
+        soci::blob account(*db);
+        soci::blob id(*db);
+        long long seqKey = 0;
+        soci::statement st =
+            (db->prepare << "INSERT OR REPLACE INTO AccountTxIndex "
+                            "(Account, SeqKey, TransID) VALUES "
+                            "(:account, :seqKey, :id);",
+             soci::use(account),
+             soci::use(seqKey),
+             soci::use(id));
+
+        for (std::size_t i = 0; i < acctIDs.size(); ++i)
+        {
+            // Both are always the same size, so nothing is left over
+            account.write(
+                0,
+                reinterpret_cast<char const*>(acctIDs[i].data()),
+                acctIDs[i].size());
+            id.write(
+                0,
+                reinterpret_cast<char const*>(acctTxnHashes[i].data()),
+                acctTxnHashes[i].size());
+            seqKey = accountTxSeqKey(acctLedgerSeqs[i], acctTxnSeqs[i]);
+            st.execute(true);
+        }
+    }
+
+    // soci cannot bind a vector of blobs, so this statement is executed
+    // once per transaction with the same bound variables.
+    std::string txnId;
+    std::string txnType;
+    std::string fromAcct;
+    long long fromSeq = 0;
+    long long ledgerSeq = 0;
+    std::string const status(1, txnSqlValidated);
+    soci::blob rawTxn(*db);
+    soci::blob txnMeta(*db);
+
+    soci::statement st =
+        (db->prepare << "INSERT OR REPLACE INTO Transactions "
+                        "(TransID, TransType, FromAcct, FromSeq, "
+                        "LedgerSeq, Status, RawTxn, TxnMeta) VALUES "
+                        "(:id, :type, :acct, :seq, :ledgerSeq, "
+                        ":status, :raw, :meta);",
+         soci::use(txnId),
+         soci::use(txnType),
+         soci::use(fromAcct),
+         soci::use(fromSeq),
+         soci::use(ledgerSeq),
+         soci::use(status),
+         soci::use(rawTxn),
+         soci::use(txnMeta));
+
+    auto ids = txnIds.begin();
+    for (auto const& ledger : ledgers)
+    {
+        ledgerSeq = ledger->getLedger()->info().seq;
+
+        for (auto const& [_, acceptedLedgerTx] : ledger->getMap())
+        {
+            (void)_;
+            auto const& txn = *acceptedLedgerTx->getTxn();
+            auto const format =
+                TxFormats::getInstance().findByType(txn.getTxnType());
+            assert(format != nullptr);
+
+            Serializer s;
+            txn.add(s);
+
+            txnId = *ids++;
+            txnType = format->getName();
+            fromAcct = toBase58(txn.getAccountID(sfAccount));
+            fromSeq = txn.getFieldU32(sfSequence);
+
+            // A blob keeps whatever lies past the end of a shorter write
+            rawTxn.trim(0);
+            convert(s.peekData(), rawTxn);
+            txnMeta.trim(0);
+            convert(acceptedLedgerTx->getRawMeta(), txnMeta);
+
+            st.execute(true);
+        }
+    }
+
+    tr.commit();
+}
+
+std::string
+RelationalDBInterfaceSqlite::transactionsSQL(
+    AccountTxOptions const& options,
+    bool descending,
+    std::uint32_t offset) const
+{
+    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
+    std::uint32_t BINARY_PAGE_LENGTH = 500;
+
+    std::uint32_t numberOfResults;
+
+    if (options.limit < 0)
+    {
+        numberOfResults =
+            options.binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
+    }
+    else if (!options.unlimited)
+    {
+        numberOfResults = std::min(
+            options.binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH,
+            static_cast<std::uint32_t>(options.limit));
+    }
+    else
+    {
+        numberOfResults = options.limit;
+    }
+
+    std::string maxClause = "";
+    std::string minClause = "";
+
+    if (options.maxLedger != -1)
+    {
+        maxClause = boost::str(
+            boost::format("AND AccountTransactions.LedgerSeq <= '%u'") %
+            options.maxLedger);
+    }
+
+    if (options.minLedger != -1)
+    {
+        minClause = boost::str(
+            boost::format("AND AccountTransactions.LedgerSeq >= '%u'") %
+            options.minLedger);
+    }
+
+    std::string const sql = boost::str(
+        boost::format(
+            "SELECT AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta FROM "
+            "AccountTransactions INNER JOIN Transactions "
+            "ON Transactions.TransID = AccountTransactions.TransID "
+            "WHERE Account = '%s' %s %s "
+            "ORDER BY AccountTransactions.LedgerSeq %s, "
+            "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
+            "LIMIT %u, %u;") %
+        idCache_.toBase58(options.account) % maxClause % minClause %
+        (descending ? "DESC" : "ASC") % (descending ? "DESC" : "ASC") %
+        (descending ? "DESC" : "ASC") % offset % numberOfResults);
+    JLOG(j_.trace()) << "txSQL query: " << sql;
+    return sql;
+}
+
+void
+RelationalDBInterfaceSqlite::getAccountTxs(
+    AccountTxOptions const& options,
+    bool descending,
+    std::uint32_t offset,
+    TxCallback const& onTransaction)
+{
+    std::string const sql = transactionsSQL(options, descending, offset);
+
+    auto db = txnDB_.checkoutReadDb();
+
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::string> status;
+    soci::blob sociTxnBlob(*db), sociTxnMetaBlob(*db);
+    soci::indicator rti, tmi;
+
+    soci::statement st =
+        (db->prepare << sql,
+         soci::into(ledgerSeq),
+         soci::into(status),
+         soci::into(sociTxnBlob, rti),
+         soci::into(sociTxnMetaBlob, tmi));
+
+    st.execute();
+    while (st.fetch())
+    {
+        Blob rawTxn;
+        if (soci::i_ok == rti)
+            convert(sociTxnBlob, rawTxn);
+        Blob txnMeta;
+        if (soci::i_ok == tmi)
+            convert(sociTxnMetaBlob, txnMeta);
+
+        onTransaction(
+            rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0)),
+            status.value_or(""),
+            std::move(rawTxn),
+            std::move(txnMeta));
+    }
+}
+
+void
+RelationalDBInterfaceSqlite::getAccountTxsPage(
+    AccountTxOptions const& options,
+    bool forward,
+    std::optional<NetworkOPs::AccountTxMarker>& marker,
+    std::uint32_t pageLength,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    TxCallback const& onTransaction)
+{
+    accountTxPage(
+        txnDB_,
+        idCache_,
+        onUnsavedLedger,
+        onTransaction,
+        options.account,
+        options.minLedger,
+        options.maxLedger,
+        forward,
+        marker,
+        options.limit,
+        options.unlimited,
+        pageLength);
+}
+
+std::unique_ptr<RelationalDBInterface>
+makeRelationalDBInterfaceSqlite(
+    DatabaseCon& txnDB,
+    AccountIDCache const& idCache,
+    beast::Journal journal)
+{
+    return std::make_unique<RelationalDBInterfaceSqlite>(
+        txnDB, idCache, journal);
+}
+
+}  // namespace ripple
@@ -0,0 +1,380 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/reporting/ReportingETL.h>
+#include <ripple/basics/Log.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/net/IPEndpoint.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STTx.h>
+#include <grpcpp/grpcpp.h>
+
+namespace ripple {
+
+namespace {
+
+// How long to wait for the source to validate another ledger, or to come
+// back after an error
+constexpr std::chrono::milliseconds retryInterval{500};
+
+// How long one GetLedger call may take
+constexpr std::chrono::seconds callTimeout{30};
+
+LedgerInfo
+reportedHeader(org::xrpl::rpc::v1::GetLedgerResponse const& response)
+{
+    auto const& hash = response.ledger_hash();
+    if (hash.size() != uint256::bytes)
+        Throw<std::runtime_error>("malformed ledger hash");
+
+    auto info = deserializeHeader(makeSlice(response.ledger_header()));
+    info.hash = uint256::fromVoid(hash.data());
+    return info;
+}
+
+void
+addTransactions(
+    Ledger& ledger,
+    org::xrpl::rpc::v1::GetLedgerResponse const& response)
+{
+    for (auto const& entry : response.transactions())
+    {
+        auto const& blob = entry.transaction_blob();
+        auto const& meta = entry.metadata_blob();
+
+        SerialIter sit(makeSlice(blob));
+        STTx const tx(sit);
+        auto const id = tx.getTransactionID();
+        if (ledger.txExists(id))
+            Throw<std::runtime_error>("duplicate transaction " + to_string(id));
+
+        ledger.rawTxInsert(
+            id,
+            std::make_shared<Serializer const>(blob.data(), blob.size()),
+            std::make_shared<Serializer const>(meta.data(), meta.size()));
+    }
+}
+
+// Set the reported header, write the ledger's new nodes and check that the
+// ledger built is the one reported
+void
+finishLedger(Ledger& ledger, LedgerInfo const& info, Config const& config)
+{
+    ledger.setLedgerInfo(info);
+    ledger.stateMap().flushDirty(hotACCOUNT_NODE);
+    ledger.txMap().flushDirty(hotTRANSACTION_NODE);
+    ledger.unshare();
+    ledger.setImmutable(config);
+
+    if (ledger.info().hash != info.hash)
+        Throw<std::runtime_error>(
+            "ledger " + std::to_string(info.seq) + " built as " +
+            to_string(ledger.info().hash) + " rather than " +
+            to_string(info.hash));
+}
+
+}  // namespace
+
+std::shared_ptr<Ledger>
+buildReportedLedger(
+    std::shared_ptr<Ledger const> const& parent,
+    org::xrpl::rpc::v1::GetLedgerResponse const& response,
+    Config const& config)
+{
+    auto const info = reportedHeader(response);
+    if (info.seq != parent->info().seq + 1 ||
+        info.parentHash != parent->info().hash)
+        Throw<std::runtime_error>(
+            "ledger " + std::to_string(info.seq) + " does not follow " +
+            std::to_string(parent->info().seq));
+
+    auto ledger = std::make_shared<Ledger>(*parent, info.closeTime);
+
+    // The objects come in key order, which is how they are applied
+    std::vector<RawChange> changes;
+    changes.reserve(response.ledger_objects_size());
+    for (auto const& object : response.ledger_objects())
+    {
+        if (object.key().size() != uint256::bytes)
+            Throw<std::runtime_error>("malformed object key");
+        auto const key = uint256::fromVoid(object.key().data());
+        if (!changes.empty() && key <= changes.back().sle->key())
+            Throw<std::runtime_error>("objects out of order");
+
+        auto const existing = parent->read(keylet::unchecked(key));
+        if (object.data().empty())
+        {
+            if (!existing)
+                Throw<std::runtime_error>(
+                    "deleted object " + to_string(key) + " missing");
+            changes.push_back(
+                {RawChange::Action::erase, std::make_shared<SLE>(*existing)});
+            continue;
+        }
+
+        SerialIter sit(makeSlice(object.data()));
+        changes.push_back(
+            {existing ? RawChange::Action::replace : RawChange::Action::insert,
+             std::make_shared<SLE>(sit, key)});
+    }
+    ledger->rawApply(changes);
+
+    addTransactions(*ledger, response);
+    finishLedger(*ledger, info, config);
+    return ledger;
+}
+
+//------------------------------------------------------------------------------
+
+ReportingETL::ReportingETL(Application& app, Stoppable& parent)
+    : Stoppable("ReportingETL", parent)
+    , app_(app)
+    , j_(app.journal("ReportingETL"))
+{
+    auto const& section = app_.config().section(SECTION_REPORTING);
+    auto const ip = get<std::string>(section, "source_ip");
+    auto const port = get<std::uint16_t>(section, "source_grpc_port", 0);
+    if (ip.empty() || port == 0)
+        Throw<std::runtime_error>(
+            "[" SECTION_REPORTING "] needs source_ip and source_grpc_port");
+
+    beast::IP::Endpoint const source(boost::asio::ip::make_address(ip), port);
+    stub_ = org::xrpl::rpc::v1::XRPLedgerAPIService::NewStub(
+        grpc::CreateChannel(
+            source.to_string(), grpc::InsecureChannelCredentials()));
+
+    JLOG(j_.info()) << "Following " << source;
+}
+
+ReportingETL::~ReportingETL()
+{
+    assert(!thread_.joinable());
+}
+
+void
+ReportingETL::onStart()
+{
+    thread_ = std::thread(&ReportingETL::run, this);
+}
+
+void
+ReportingETL::onStop()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+    stopped();
+}
+
+bool
+ReportingETL::wait(std::chrono::milliseconds duration)
+{
+    std::unique_lock lock(mutex_);
+    return !cv_.wait_for(lock, duration, [this] { return stopping_; });
+}
+
+void
+ReportingETL::run()
+{
+    beast::setCurrentThreadName("rippled: ETL");
+
+    // Resume from the ledger of a previous run, if it was loaded
+    std::shared_ptr<Ledger const> ledger =
+        app_.getLedgerMaster().getValidatedLedger();
+
+    do
+    {
+        std::shared_ptr<Ledger const> next;
+        try
+        {
+            next = ledger ? extractLedger(ledger) : loadInitialLedger();
+        }
+        catch (std::exception const& e)
+        {
+            // The source reported something which is not the next ledger,
+            // so start again from its latest one
+            JLOG(j_.error()) << "Unable to build ledger: " << e.what();
+            ledger.reset();
+        }
+
+        if (next)
+        {
+            publish(next);
+            ledger = std::move(next);
+        }
+        else if (!wait(retryInterval))
+            break;
+    } while (!isStopping());
+}
+
+std::shared_ptr<Ledger const>
+ReportingETL::loadInitialLedger()
+{
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+    {
+        org::xrpl::rpc::v1::GetLedgerRequest request;
+        request.mutable_ledger()->set_shortcut(
+            org::xrpl::rpc::v1::LedgerSpecifier::SHORTCUT_VALIDATED);
+        request.set_transactions(true);
+
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + callTimeout);
+        auto const status = stub_->GetLedger(&context, request, &response);
+        if (!status.ok())
+        {
+            JLOG(j_.warn()) << "Unable to get the latest validated ledger: "
+                            << status.error_message();
+            return nullptr;
+        }
+    }
+    auto const info = reportedHeader(response);
+
+    JLOG(j_.info()) << "Downloading ledger " << info.seq;
+
+    auto ledger = std::make_shared<Ledger>(
+        info.seq, info.closeTime, app_.config(), app_.getNodeFamily());
+
+    // The state is streamed in key order, however large it is
+    org::xrpl::rpc::v1::GetLedgerDataRequest request;
+    request.mutable_ledger()->set_sequence(info.seq);
+
+    grpc::ClientContext context;
+    auto reader = stub_->GetLedgerData(&context, request);
+    org::xrpl::rpc::v1::GetLedgerDataResponse data;
+    std::size_t objects = 0;
+    while (reader->Read(&data))
+    {
+        if (isStopping())
+        {
+            context.TryCancel();
+            reader->Finish();
+            return nullptr;
+        }
+
+        if (data.ledger_index() != info.seq)
+            Throw<std::runtime_error>("ledger data of the wrong ledger");
+
+        for (auto const& object : data.ledger_objects())
+        {
+            if (object.key().size() != uint256::bytes)
+                Throw<std::runtime_error>("malformed object key");
+            SerialIter sit(makeSlice(object.data()));
+            if (!ledger->addSLE(
+                    SLE(sit, uint256::fromVoid(object.key().data()))))
+                Throw<std::runtime_error>("duplicate object");
+        }
+        objects += data.ledger_objects_size();
+    }
+
+    if (auto const status = reader->Finish(); !status.ok())
+    {
+        JLOG(j_.warn()) << "Unable to download ledger " << info.seq << ": "
+                        << status.error_message();
+        return nullptr;
+    }
+
+    addTransactions(*ledger, response);
+    finishLedger(*ledger, info, app_.config());
+
+    JLOG(j_.info()) << "Downloaded ledger " << info.seq << " with " << objects
+                    << " objects";
+    return ledger;
+}
+
+std::shared_ptr<Ledger const>
+ReportingETL::extractLedger(std::shared_ptr<Ledger const> const& parent)
+{
+    auto const seq = parent->info().seq + 1;
+
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(seq);
+    request.set_transactions(true);
+    request.set_get_objects(true);
+
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + callTimeout);
+    auto const status = stub_->GetLedger(&context, request, &response);
+
+    // Until the source validates the ledger it has not closed it, or it
+    // reports the ledger as not validated
+    if (status.error_code() == grpc::StatusCode::NOT_FOUND ||
+        (status.ok() && !response.validated()))
+    {
+        JLOG(j_.trace()) << "Ledger " << seq << " not validated yet";
+        return nullptr;
+    }
+
+    if (!status.ok())
+    {
+        JLOG(j_.warn()) << "Unable to get ledger " << seq << ": "
+                        << status.error_message();
+        return nullptr;
+    }
+
+    auto ledger = buildReportedLedger(parent, response, app_.config());
+    JLOG(j_.debug()) << "Extracted ledger " << seq << " with "
+                     << response.transactions_size() << " transactions and "
+                     << response.ledger_objects_size() << " changes";
+    return ledger;
+}
+
+void
+ReportingETL::publish(std::shared_ptr<Ledger const> const& ledger)
+{
+    auto& ledgerMaster = app_.getLedgerMaster();
+    ledgerMaster.storeLedger(ledger);
+
+    {
+        std::lock_guard lock(app_.getMasterMutex());
+
+        // Commands reading the open ledger see the newest state
+        CanonicalTXSet retries(ledger->info().hash);
+        app_.openLedger().accept(
+            app_,
+            ledger->rules(),
+            ledger,
+            OrderedTxs({}),
+            false,
+            retries,
+            tapNONE,
+            "reporting");
+
+        // In reporting mode this accepts the ledger as validated, saves it
+        // and publishes it
+        ledgerMaster.switchLCL(ledger);
+    }
+
+    // There is no network to synchronize with, so the server is as current
+    // as the ledgers it extracts
+    if (app_.getOPs().getOperatingMode() != OperatingMode::FULL)
+        app_.getOPs().setStandAlone();
+}
+
+}  // namespace ripple
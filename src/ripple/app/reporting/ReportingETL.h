@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_REPORTING_REPORTINGETL_H_INCLUDED
+#define RIPPLE_APP_REPORTING_REPORTINGETL_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/core/Stoppable.h>
+#include <org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+
+/** Build a ledger from its parent and another server's report of it.
+
+    @param response The ledger's header, transactions and changed objects,
+        as returned by GetLedger with `transactions` and `get_objects`.
+
+    @return The ledger, which is immutable and whose nodes have been
+        written to the node store.
+
+    @throw std::runtime_error if the report is malformed or the ledger
+        built does not have the reported hash.
+*/
+std::shared_ptr<Ledger>
+buildReportedLedger(
+    std::shared_ptr<Ledger const> const& parent,
+    org::xrpl::rpc::v1::GetLedgerResponse const& response,
+    Config const& config);
+
+/** Follows a validating server, copying each ledger it validates.
+
+    In reporting mode the server joins no overlay and takes no part in
+    consensus. This downloads the latest validated ledger of the server
+    named in [reporting] over gRPC, unless a ledger of a previous run can
+    be resumed from, and then extracts each following ledger once the
+    source has validated it and builds it on its parent. Each ledger is
+    accepted like a validated ledger: it is saved and published, and the
+    open ledger is built on it, so this server can serve RPC commands.
+*/
+class ReportingETL : public Stoppable
+{
+public:
+    ReportingETL(Application& app, Stoppable& parent);
+
+    ~ReportingETL() override;
+
+private:
+    void
+    onStart() override;
+
+    void
+    onStop() override;
+
+    void
+    run();
+
+    // Download the state of the source's latest validated ledger
+    std::shared_ptr<Ledger const>
+    loadInitialLedger();
+
+    // Extract the ledger following `parent`. Returns nullptr if the
+    // source has not validated it yet or could not be reached.
+    std::shared_ptr<Ledger const>
+    extractLedger(std::shared_ptr<Ledger const> const& parent);
+
+    void
+    publish(std::shared_ptr<Ledger const> const& ledger);
+
+    // Wait for a while. Returns false if the server is stopping.
+    bool
+    wait(std::chrono::milliseconds duration);
+
+    Application& app_;
+    beast::Journal const j_;
+    std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub> stub_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+}  // namespace ripple
+
+#endif
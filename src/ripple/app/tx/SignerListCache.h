@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_SIGNERLISTCACHE_H_INCLUDED
+#define RIPPLE_TX_SIGNERLISTCACHE_H_INCLUDED
+
+#include <ripple/app/tx/impl/SignerEntries.h>
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** Caches the parsed signer lists of multi-signing accounts.
+
+    A multi-signed transaction is checked against its account's SignerList
+    each time it is applied: to the open ledger, again whenever the open
+    ledger is rebuilt, and again when the next ledger is built. Parsing
+    the list each time is costly for long lists, so the result is kept.
+
+    An entry is only used while the view returns the very same SLE the
+    entry was made from. Changing the list gives a new SLE, so a stale
+    entry is never used. Views which share SLEs through CachedSLEs share
+    entries too.
+*/
+class SignerListCache
+{
+public:
+    struct SignerList
+    {
+        // Sorted by account
+        std::vector<SignerEntries::SignerEntry> signers;
+        std::uint32_t quorum;
+    };
+
+    SignerListCache(Stopwatch& clock, beast::Journal journal);
+
+    /** Return the parsed contents of a SignerList entry.
+
+        @return The signer list, or the error found parsing it.
+    */
+    std::pair<std::shared_ptr<SignerList const>, NotTEC>
+    fetch(std::shared_ptr<SLE const> const& sle, beast::Journal j);
+
+    /** Discard entries not used recently. */
+    void
+    sweep()
+    {
+        cache_.sweep();
+    }
+
+private:
+    struct Entry
+    {
+        // Held so the SLE can't be freed and another take its address
+        std::shared_ptr<SLE const> sle;
+        std::shared_ptr<SignerList const> list;
+    };
+
+    TaggedCache<uint256, Entry> cache_;
+};
+
+}  // namespace ripple
+
+#endif
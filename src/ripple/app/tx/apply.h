@@ -78,6 +78,16 @@ checkValidity(
 void
 forceValidity(HashRouter& router, uint256 const& txid, Validity validity);
 
+/** Marks the signature of a given transaction bad in the cache.
+
+    @warning Only for the verdicts of servers we trust, such as the other
+             members of our cluster.
+
+    @see forceValidity
+*/
+void
+forceSigBad(HashRouter& router, uint256 const& txid);
+
 /** Apply a transaction to an `OpenView`.
 
     This function is the canonical way to apply a transaction
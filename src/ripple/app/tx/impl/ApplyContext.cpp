@@ -99,13 +99,24 @@ ApplyContext::checkInvariantsHelper(
     {
         auto checkers = getInvariantChecks();
 
-        // call each check's per-entry method
+        // call the per-entry method of each check which looks at entries of
+        // this type, in one pass over the modified entries
         visit([&checkers](
                   uint256 const& index,
                   bool isDelete,
                   std::shared_ptr<SLE const> const& before,
                   std::shared_ptr<SLE const> const& after) {
-            (..., std::get<Is>(checkers).visitEntry(isDelete, before, after));
+            auto const afterType = after ? after->getType() : ltANY;
+            auto const beforeType = before ? before->getType() : afterType;
+            auto const wanted = [&](auto const& check) {
+                using Check = std::decay_t<decltype(check)>;
+                return Check::visits(beforeType) ||
+                    (afterType != beforeType && Check::visits(afterType));
+            };
+            (...,
+             (wanted(std::get<Is>(checkers))
+                  ? std::get<Is>(checkers).visitEntry(isDelete, before, after)
+                  : void()));
         });
 
         // Note: do not replace this logic with a `...&&` fold expression.
@@ -677,6 +677,49 @@ CreateOffer::takerCross(
     }
 }
 
+bool
+CreateOffer::mayFlowCross(
+    ReadView const& view,
+    Amounts const& takerAmount,
+    Quality const& threshold) const
+{
+    // flow() skips any strand whose quality upper bound is below the
+    // threshold, and when it skips them all it neither crosses nor removes
+    // any offers. A strand's bound is the composition of its steps' bounds.
+    // Book steps are bounded by the quality of the book's best offer and,
+    // since fixQualityUpperBound, no other offer crossing step can improve
+    // on a quality of one. So the best offers alone decide it.
+    if (!view.rules().enabled(fixQualityUpperBound))
+        return true;
+
+    auto tipQuality = [&](Issue const& in, Issue const& out) {
+        // Step on a sandbox, as BookStep does, so nothing is changed
+        Sandbox sb(&view, tapNONE);
+        BookTip bt(sb, {in, out});
+        return bt.step(j_) ? boost::make_optional(bt.quality()) : boost::none;
+    };
+
+    auto const in = takerAmount.in.issue();
+    auto const out = takerAmount.out.issue();
+    if (auto const q = tipQuality(in, out); q && *q >= threshold)
+        return true;
+
+    // The autobridged strand through XRP
+    if (!isXRP(in) && !isXRP(out))
+    {
+        auto const q1 = tipQuality(in, xrpIssue());
+        if (!q1)
+            return false;
+        auto const q2 = tipQuality(xrpIssue(), out);
+        if (!q2)
+            return false;
+        // Composing rounds down, the same as it does for the strand
+        if (composed_quality(*q1, *q2) >= threshold)
+            return true;
+    }
+    return false;
+}
+
 std::pair<TER, Amounts>
 CreateOffer::flowCross(
     PaymentSandbox& psb,
@@ -732,6 +775,14 @@ CreateOffer::flowCross(
         if (sendMax > inStartBalance)
             sendMax = inStartBalance;
 
+        // Most offers cross nothing. When that is certain, flow() would
+        // fail without changing any state, so skip building its strands.
+        if (!mayFlowCross(psb, takerAmount, threshold))
+        {
+            JLOG(j_.trace()) << "Not crossing: no offer meets the threshold.";
+            return {tesSUCCESS, takerAmount};
+        }
+
         // Always invoke flow() with the default path.  However if neither
         // of the takerAmount currencies are XRP then we cross through an
         // additional path with XRP as the intermediate between two books.
@@ -117,6 +117,14 @@ private:
     std::pair<TER, Amounts>
     takerCross(Sandbox& sb, Sandbox& sbCancel, Amounts const& takerAmount);
 
+    // Returns false if no offer in the books is good enough for flowCross
+    // to cross, so that crossing can be skipped. Returns true if one may be.
+    bool
+    mayFlowCross(
+        ReadView const& view,
+        Amounts const& takerAmount,
+        Quality const& threshold) const;
+
     // Use the payment flow code to perform offer crossing.
     std::pair<TER, Amounts>
     flowCross(
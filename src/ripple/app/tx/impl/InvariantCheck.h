@@ -48,6 +48,17 @@ class InvariantChecker_PROTOTYPE
 public:
     explicit InvariantChecker_PROTOTYPE() = default;
 
+    /**
+     * @brief whether visitEntry needs to see ledger entries of a type.
+     *
+     * Entries of other types are not passed to visitEntry at all. An entry
+     * whose type changed is passed if either type is wanted.
+     *
+     * @param type the type of the ledger entry
+     */
+    static constexpr bool
+    visits(LedgerEntryType type);
+
     /**
      * @brief called for each ledger entry in the current transaction.
      *
@@ -92,6 +103,12 @@ public:
 class TransactionFeeCheck
 {
 public:
+    static constexpr bool
+    visits(LedgerEntryType)
+    {
+        return false;
+    }
+
     void
     visitEntry(
         bool,
@@ -120,6 +137,12 @@ class XRPNotCreated
     std::int64_t drops_ = 0;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltACCOUNT_ROOT || type == ltPAYCHAN || type == ltESCROW;
+    }
+
     void
     visitEntry(
         bool,
@@ -148,6 +171,12 @@ class AccountRootsNotDeleted
     std::uint32_t accountsDeleted_ = 0;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltACCOUNT_ROOT;
+    }
+
     void
     visitEntry(
         bool,
@@ -175,6 +204,12 @@ class XRPBalanceChecks
     bool bad_ = false;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltACCOUNT_ROOT;
+    }
+
     void
     visitEntry(
         bool,
@@ -200,6 +235,12 @@ class LedgerEntryTypesMatch
     bool invalidTypeAdded_ = false;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType)
+    {
+        return true;
+    }
+
     void
     visitEntry(
         bool,
@@ -226,6 +267,12 @@ class NoXRPTrustLines
     bool xrpTrustLine_ = false;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltRIPPLE_STATE;
+    }
+
     void
     visitEntry(
         bool,
@@ -253,6 +300,12 @@ class NoBadOffers
     bool bad_ = false;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltOFFER;
+    }
+
     void
     visitEntry(
         bool,
@@ -277,6 +330,12 @@ class NoZeroEscrow
     bool bad_ = false;
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltESCROW;
+    }
+
     void
     visitEntry(
         bool,
@@ -303,6 +362,12 @@ class ValidNewAccountRoot
     std::uint32_t accountSeq_ = 0;  // Only meaningful if accountsCreated_ > 0
 
 public:
+    static constexpr bool
+    visits(LedgerEntryType type)
+    {
+        return type == ltACCOUNT_ROOT;
+    }
+
     void
     visitEntry(
         bool,
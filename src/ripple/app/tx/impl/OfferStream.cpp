@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/paths/DeadOffers.h>
 #include <ripple/app/tx/impl/OfferStream.h>
 #include <ripple/basics/Log.h>
 
@@ -164,6 +165,10 @@ TOfferStreamBase<TIn, TOut>::step()
             continue;
         }
 
+        // Skip offers already known to be dead, when path finding
+        if (deadOffers_ && deadOffers_->dead(*entry))
+            continue;
+
         // Remove if expired
         using d = NetClock::duration;
         using tp = NetClock::time_point;
@@ -32,6 +32,8 @@
 
 namespace ripple {
 
+class DeadOffers;
+
 template <class TIn, class TOut>
 class TOfferStreamBase
 {
@@ -78,6 +80,7 @@ protected:
     TOffer<TIn, TOut> offer_;
     boost::optional<TOut> ownerFunds_;
     StepCounter& counter_;
+    DeadOffers* deadOffers_ = nullptr;
 
     void
     erase(ApplyView& view);
@@ -116,6 +119,17 @@ public:
     bool
     step();
 
+    /** Pass over the offers `deadOffers` knows can't be taken.
+
+        Those offers are neither consumed nor removed. Only path finding,
+        which doesn't keep its changes, may use this.
+    */
+    void
+    setDeadOffers(DeadOffers* deadOffers)
+    {
+        deadOffers_ = deadOffers;
+    }
+
     TOut
     ownerFunds() const
     {
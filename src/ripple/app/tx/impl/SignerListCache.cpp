@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/SignerListCache.h>
+
+namespace ripple {
+
+SignerListCache::SignerListCache(Stopwatch& clock, beast::Journal journal)
+    : cache_("SignerLists", 4096, std::chrono::minutes{2}, clock, journal)
+{
+}
+
+auto
+SignerListCache::fetch(std::shared_ptr<SLE const> const& sle, beast::Journal j)
+    -> std::pair<std::shared_ptr<SignerList const>, NotTEC>
+{
+    if (auto const entry = cache_.fetch(sle->key()); entry && entry->sle == sle)
+        return {entry->list, tesSUCCESS};
+
+    auto parsed = SignerEntries::deserialize(*sle, j, "ledger");
+    if (parsed.second != tesSUCCESS)
+        return {nullptr, parsed.second};
+
+    auto list = std::make_shared<SignerList>();
+    list->signers = std::move(parsed.first);
+    list->quorum = sle->getFieldU32(sfSignerQuorum);
+
+    auto entry = std::make_shared<Entry>(Entry{sle, list});
+    cache_.canonicalize_replace_cache(sle->key(), entry);
+    return {std::move(list), tesSUCCESS};
+}
+
+}  // namespace ripple
@@ -19,6 +19,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/tx/SignerListCache.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/app/tx/impl/SignerEntries.h>
 #include <ripple/app/tx/impl/Transactor.h>
@@ -541,10 +542,10 @@ Transactor::checkMultiSign(PreclaimContext const& ctx)
     assert(sleAccountSigners->isFieldPresent(sfSignerListID));
     assert(sleAccountSigners->getFieldU32(sfSignerListID) == 0);
 
-    auto accountSigners =
-        SignerEntries::deserialize(*sleAccountSigners, ctx.j, "ledger");
-    if (accountSigners.second != tesSUCCESS)
-        return accountSigners.second;
+    auto const [accountSigners, ter] =
+        ctx.app.getSignerListCache().fetch(sleAccountSigners, ctx.j);
+    if (ter != tesSUCCESS)
+        return ter;
 
     // Get the array of transaction signers.
     STArray const& txSigners(ctx.tx.getFieldArray(sfSigners));
@@ -556,7 +557,7 @@ Transactor::checkMultiSign(PreclaimContext const& ctx)
     // matching multi-signers to account signers should be a simple
     // linear walk.  *All* signers must be valid or the transaction fails.
     std::uint32_t weightSum = 0;
-    auto iter = accountSigners.first.begin();
+    auto iter = accountSigners->signers.begin();
     for (auto const& txSigner : txSigners)
     {
         AccountID const txSignerAcctID = txSigner.getAccountID(sfAccount);
@@ -564,7 +565,7 @@ Transactor::checkMultiSign(PreclaimContext const& ctx)
         // Attempt to match the SignerEntry with a Signer;
         while (iter->account < txSignerAcctID)
         {
-            if (++iter == accountSigners.first.end())
+            if (++iter == accountSigners->signers.end())
             {
                 JLOG(ctx.j.trace())
                     << "applyTransaction: Invalid SigningAccount.Account.";
@@ -668,7 +669,7 @@ Transactor::checkMultiSign(PreclaimContext const& ctx)
     }
 
     // Cannot perform transaction if quorum is not met.
-    if (weightSum < sleAccountSigners->getFieldU32(sfSignerQuorum))
+    if (weightSum < accountSigners->quorum)
     {
         JLOG(ctx.j.trace())
             << "applyTransaction: Signers failed to meet quorum.";
@@ -105,6 +105,12 @@ forceValidity(HashRouter& router, uint256 const& txid, Validity validity)
         router.setFlags(txid, flags);
 }
 
+void
+forceSigBad(HashRouter& router, uint256 const& txid)
+{
+    router.setFlags(txid, SF_SIGBAD);
+}
+
 std::pair<TER, bool>
 apply(
     Application& app,
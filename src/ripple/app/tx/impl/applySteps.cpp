@@ -17,6 +17,8 @@
 */
 //==============================================================================
 
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/tx/applySteps.h>
 #include <ripple/app/tx/impl/ApplyContext.h>
 #include <ripple/app/tx/impl/CancelCheck.h>
@@ -423,9 +425,15 @@ preflight(
     beast::Journal j)
 {
     PreflightContext const pfctx(app, tx, rules, flags, j);
+    auto& router = app.getHashRouter();
+    auto const id = tx.getTransactionID();
+    if (auto const result = router.getPreflight(id, rules, flags))
+        return {pfctx, *result};
     try
     {
-        return {pfctx, invoke_preflight(pfctx)};
+        auto const result = invoke_preflight(pfctx);
+        router.setPreflight(id, rules, flags, result);
+        return {pfctx, result};
     }
     catch (std::exception const& e)
     {
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_CACHEBUDGET_H_INCLUDED
+#define RIPPLE_BASICS_CACHEBUDGET_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/utility/Journal.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** The memory held by a cached object, in bytes.
+
+    The default counts only the object itself. Types which own memory
+    elsewhere specialize this next to their definition, so that every
+    cache of them sees the same estimate.
+*/
+template <class T>
+struct CacheFootprint
+{
+    static std::size_t
+    bytes(T const&)
+    {
+        return sizeof(T);
+    }
+};
+
+template <>
+struct CacheFootprint<Blob>
+{
+    static std::size_t
+    bytes(Blob const& blob)
+    {
+        return sizeof(blob) + blob.capacity();
+    }
+};
+
+/** A memory budget shared by several caches.
+
+    Each cache is given a target number of bytes, and the targets add up
+    to the budget. Every time the budget is rebalanced, a slice of it is
+    moved to the cache where more memory would save the most misses, from
+    the one where less memory would cost the fewest.
+
+    The benefit of more memory is estimated as the misses per byte of
+    target since the last rebalance, for a cache which is using all of its
+    target; a cache which is not would gain nothing. Every cache keeps a
+    share of the budget however little it is used, so that a change in the
+    load can be noticed.
+*/
+class CacheBudget
+{
+public:
+    /** Fraction of the budget moved by one rebalance. */
+    static constexpr std::size_t stepDivisor = 20;
+
+    /** The smallest share of the budget a cache keeps, as a fraction of an
+        even share. */
+    static constexpr std::size_t floorDivisor = 4;
+
+    /** A cache may be given more of the budget once it holds all but this
+        fraction of its share. */
+    static constexpr std::size_t fullDivisor = 10;
+
+    struct Report
+    {
+        std::string name;
+        std::size_t bytes;
+        std::size_t targetBytes;
+        std::uint64_t hits;
+        std::uint64_t misses;
+    };
+
+    CacheBudget(std::size_t bytes, beast::Journal journal);
+
+    CacheBudget(CacheBudget const&) = delete;
+    CacheBudget&
+    operator=(CacheBudget const&) = delete;
+
+    /** Add a cache to the budget and share the budget evenly again.
+
+        The cache must outlive the budget.
+    */
+    template <class Cache>
+    void
+    add(std::string name, Cache& cache)
+    {
+        Member member;
+        member.name = std::move(name);
+        member.cacheBytes = [&cache] { return cache.getCacheBytes(); };
+        member.hitCounts = [&cache] { return cache.getHitCounts(); };
+        member.setTargetBytes = [&cache](std::size_t bytes) {
+            cache.setTargetBytes(bytes);
+        };
+        add(std::move(member));
+    }
+
+    /** The total of the targets of all the caches. */
+    std::size_t
+    bytes() const
+    {
+        std::lock_guard lock(mutex_);
+        return bytes_;
+    }
+
+    /** Shrink or regrow the budget as the memory of the machine allows.
+
+        When memory is short the budget loses a quarter, but never goes
+        below a quarter of the budget it was created with. Otherwise it
+        grows back by a step, up to the budget it was created with. The
+        share of each cache is kept.
+    */
+    void
+    adjust(bool memoryShort);
+
+    /** Move part of the budget to the cache which needs it most.
+
+        Called periodically, before the caches are swept.
+    */
+    void
+    rebalance();
+
+    std::vector<Report>
+    report() const;
+
+private:
+    struct Member
+    {
+        std::string name;
+        std::function<std::size_t()> cacheBytes;
+        std::function<std::pair<std::uint64_t, std::uint64_t>()> hitCounts;
+        std::function<void(std::size_t)> setTargetBytes;
+        std::size_t targetBytes = 0;
+
+        // Misses counted at the last rebalance
+        std::uint64_t misses = 0;
+    };
+
+    void
+    add(Member member);
+
+    std::size_t const limit_;
+    beast::Journal const j_;
+
+    mutable std::mutex mutex_;
+    std::size_t bytes_;
+    std::vector<Member> members_;
+};
+
+}  // namespace ripple
+
+#endif
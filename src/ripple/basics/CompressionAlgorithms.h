@@ -95,23 +95,20 @@ lz4Decompress(
     return decompressedSize;
 }
 
-/** LZ4 block decompression.
+/** Read bytes from a stream into contiguous memory.
  * @tparam InputStream ZeroCopyInputStream
  * @param in Input source stream
- * @param inSize Size of compressed data
- * @param decompressed Buffer to hold decompressed data
- * @param decompressedSize Size of the decompressed buffer
- * @return size of the decompressed data
+ * @param inSize Number of bytes to read
+ * @param compressed Holds the bytes if they span more than one chunk
+ * @return Pointer to the bytes, valid until the stream or buffer change
  */
 template <typename InputStream>
-std::size_t
-lz4Decompress(
+std::uint8_t const*
+readContiguous(
     InputStream& in,
     std::size_t inSize,
-    std::uint8_t* decompressed,
-    std::size_t decompressedSize)
+    std::vector<std::uint8_t>& compressed)
 {
-    std::vector<std::uint8_t> compressed;
     std::uint8_t const* chunk = nullptr;
     int chunkSize = 0;
     int copiedInSize = 0;
@@ -155,6 +152,27 @@ lz4Decompress(
         (copiedInSize > 0 && copiedInSize != inSize))
         doThrow("lz4 decompress: insufficient input size");
 
+    return chunk;
+}
+
+/** LZ4 block decompression.
+ * @tparam InputStream ZeroCopyInputStream
+ * @param in Input source stream
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @return size of the decompressed data
+ */
+template <typename InputStream>
+std::size_t
+lz4Decompress(
+    InputStream& in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize)
+{
+    std::vector<std::uint8_t> compressed;
+    auto const chunk = readContiguous(in, inSize, compressed);
     return lz4Decompress(chunk, inSize, decompressed, decompressedSize);
 }
 
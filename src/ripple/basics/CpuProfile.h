@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_CPUPROFILE_H_INCLUDED
+#define RIPPLE_BASICS_CPUPROFILE_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Where the process spent its processor time while it was profiled. */
+struct CpuProfile
+{
+    struct Stack
+    {
+        // The thread's role, what it was tagged with and the frames from
+        // the outermost in, separated by semicolons: the "folded" format
+        // read by flame graph tools
+        std::string frames;
+        std::uint64_t count;
+    };
+
+    // Most frequent first
+    std::vector<Stack> stacks;
+    std::uint64_t samples = 0;
+
+    // Samples lost because the buffer was full
+    std::uint64_t dropped = 0;
+};
+
+/** Profile the whole process by sampling the stacks of running threads.
+
+    A timer counting the processor time used by the process raises a
+    signal `frequency` times a second of that time, and the thread which
+    was running records its stack. Threads which are waiting cost nothing
+    and are not sampled. The calling thread blocks for `duration`.
+
+    Frames are named by their symbol where one is exported, and otherwise
+    as the offset within their binary, for addr2line.
+
+    @return Nothing if another profile is running, or on platforms other
+        than Linux.
+*/
+std::optional<CpuProfile>
+runCpuProfile(std::chrono::milliseconds duration, unsigned frequency);
+
+/** Say what the calling thread is doing, for the samples taken of it.
+
+    @param tag A string which outlives every profile, or `nullptr` to
+        clear the tag.
+*/
+void
+setCpuProfileTag(char const* tag);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_DECIMALDIGITS_H_INCLUDED
+#define RIPPLE_BASICS_DECIMALDIGITS_H_INCLUDED
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace ripple {
+
+/** Ten raised to each power which fits in 64 bits. */
+inline constexpr std::array<std::uint64_t, 20> powersOfTen = [] {
+    std::array<std::uint64_t, 20> result{};
+    std::uint64_t power = 1;
+    for (auto& p : result)
+    {
+        p = power;
+        power *= 10;
+    }
+    return result;
+}();
+
+/** Return the number of decimal digits in a value, which must not be zero.
+
+    Amounts are normalized by scaling their mantissa by a power of ten,
+    and knowing the number of digits gives the power without a loop.
+*/
+inline int
+decimalDigits(std::uint64_t value)
+{
+    assert(value != 0);
+#if defined(__GNUC__)
+    int const bits = 64 - __builtin_clzll(value);
+#else
+    int bits = 0;
+    for (auto v = value; v != 0; v >>= 1)
+        ++bits;
+#endif
+    // 1233 / 4096 is just over log10(2), so this is either the number of
+    // digits or one less
+    int const digits = (bits * 1233) >> 12;
+    return digits + (value >= powersOfTen[digits] ? 1 : 0);
+}
+
+}  // namespace ripple
+
+#endif
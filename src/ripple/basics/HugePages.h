@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_HUGEPAGES_H_INCLUDED
+#define RIPPLE_BASICS_HUGEPAGES_H_INCLUDED
+
+#include <boost/pool/pool_alloc.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace ripple {
+
+/** Where long lived, frequently walked objects get their memory.
+
+    SHAMap nodes are small and very numerous, and walking a tree touches
+    nodes spread all over the heap, so with normal pages much of the time
+    goes to missing in the TLB. When huge pages are used, memory for these
+    objects is carved out of large regions of 2MB pages, which the TLB
+    covers with far fewer entries.
+*/
+enum class HugePageMode {
+    // Use the normal heap
+    none,
+    // Regions of normal memory which the kernel is asked to back with
+    // transparent huge pages
+    transparent,
+    // Regions of pages reserved through /proc/sys/vm/nr_hugepages, using
+    // transparent huge pages if none are free
+    hugetlb,
+};
+
+/** Parse "none", "transparent" or "hugetlb". */
+std::optional<HugePageMode>
+parseHugePageMode(std::string const& s);
+
+/** Choose where later allocations get their memory.
+
+    Memory already handed out is still freed correctly after the mode
+    changes. Huge pages are only supported on Linux; elsewhere the mode
+    is always `none`.
+*/
+void
+setHugePageMode(HugePageMode mode);
+
+HugePageMode
+hugePageMode();
+
+/** Allocate from the huge page regions, or the heap if they are not used.
+
+    This is meant for blocks which are carved up by a pool, not for
+    individual objects. Freed blocks are kept for reuse by later requests
+    of the same size rather than returned to the operating system.
+*/
+void*
+allocateHugePages(std::size_t bytes);
+
+void
+deallocateHugePages(void* p);
+
+/** A boost.pool UserAllocator taking its blocks from allocateHugePages. */
+struct HugePageUserAllocator
+{
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static char*
+    malloc(size_type bytes)
+    {
+        return static_cast<char*>(allocateHugePages(bytes));
+    }
+
+    static void
+    free(char* block)
+    {
+        deallocateHugePages(block);
+    }
+};
+
+#if __has_include(<memory_resource>)
+/** A memory resource taking its memory from allocateHugePages.
+
+    Suitable as the upstream resource of a pool resource.
+*/
+std::pmr::memory_resource*
+hugePageResource();
+#endif
+
+/** Create a shared object, from a pool of huge pages if they are used.
+
+    The object and its control block come from a pool shared by all
+    objects of the same type. Otherwise this is std::make_shared.
+*/
+template <class T, class... Args>
+std::shared_ptr<T>
+make_pooled(Args&&... args)
+{
+    if (hugePageMode() == HugePageMode::none)
+        return std::make_shared<T>(std::forward<Args>(args)...);
+
+    // Blocks of 8192 objects, so each is several 4KB pages at least
+    using type = std::remove_const_t<T>;
+    using allocator = boost::fast_pool_allocator<
+        type,
+        HugePageUserAllocator,
+        std::mutex,
+        8192,
+        8192>;
+    return std::allocate_shared<type>(
+        allocator{}, std::forward<Args>(args)...);
+}
+
+}  // namespace ripple
+
+#endif
@@ -24,10 +24,14 @@
 #include <ripple/beast/utility/Journal.h>
 #include <boost/beast/core/string.hpp>
 #include <boost/filesystem.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -146,6 +150,10 @@ private:
         }
         /** @} */
 
+        /** Write anything buffered to the log file. */
+        void
+        flush();
+
     private:
         std::unique_ptr<std::ofstream> m_stream;
         boost::filesystem::path m_path;
@@ -161,6 +169,15 @@ private:
     File file_;
     bool silent_ = false;
 
+    // Messages waiting for the writer thread, when writing asynchronously
+    std::mutex queueMutex_;
+    std::condition_variable queueCond_;
+    std::vector<std::string> queue_;
+    std::atomic<std::size_t> capacity_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    bool stopping_ = false;
+    std::thread writer_;
+
 public:
     Logs(beast::severities::Severity level);
 
@@ -168,7 +185,7 @@ public:
     Logs&
     operator=(Logs const&) = delete;
 
-    virtual ~Logs() = default;
+    virtual ~Logs();
 
     bool
     open(boost::filesystem::path const& pathToLogFile);
@@ -201,6 +218,23 @@ public:
     std::string
     rotate();
 
+    /** Write messages from a background thread.
+
+        Each message is formatted by the thread logging it and queued, and
+        the queue is written out in batches, so logging never waits for the
+        file. While `capacity` messages are waiting new ones are dropped.
+        Whatever is queued is written when the Logs is destroyed.
+    */
+    void
+    async(std::size_t capacity);
+
+    /** The number of messages dropped because the queue was full. */
+    std::uint64_t
+    dropped() const
+    {
+        return dropped_;
+    }
+
     /**
      * Set flag to write logs to stderr (false) or not (true).
      *
@@ -243,6 +277,9 @@ private:
         std::string const& message,
         beast::severities::Severity severity,
         std::string const& partition);
+
+    void
+    drain();
 };
 
 // Wraps a Journal::Stream to skip evaluation of
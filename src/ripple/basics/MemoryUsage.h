@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_MEMORYUSAGE_H_INCLUDED
+#define RIPPLE_BASICS_MEMORYUSAGE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** The subsystems whose memory is accounted for. */
+enum class MemoryTag : std::uint8_t {
+    shamap,
+    stobject,
+    json,
+    message,
+    cache,
+};
+
+/** Counts the bytes held by each subsystem.
+
+    Unlike CountedObject, which counts instances, this counts the bytes
+    allocated through a tag and the number of allocations, so cache sizes
+    can be chosen and memory regressions found. The counters are spread
+    over several cache lines picked per thread and are only combined when
+    read, so they are cheap enough to leave on.
+*/
+class MemoryUsage
+{
+public:
+    static constexpr std::size_t tagCount =
+        static_cast<std::size_t>(MemoryTag::cache) + 1;
+
+    struct Entry
+    {
+        char const* name;
+        // Bytes currently held
+        std::int64_t bytes;
+        // Allocations made since startup
+        std::uint64_t allocations;
+    };
+
+    static void
+    allocate(MemoryTag tag, std::size_t bytes) noexcept;
+
+    static void
+    deallocate(MemoryTag tag, std::size_t bytes) noexcept;
+
+    static char const*
+    name(MemoryTag tag) noexcept;
+
+    /** The usage of every tag. Concurrent changes may be partly seen. */
+    static std::vector<Entry>
+    report();
+};
+
+//------------------------------------------------------------------------------
+
+/** An allocator which accounts for what it allocates under a tag. */
+template <class T, MemoryTag Tag>
+class TaggedAllocator
+{
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind
+    {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() = default;
+
+    template <class U>
+    TaggedAllocator(TaggedAllocator<U, Tag> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        auto p = std::allocator<T>{}.allocate(n);
+        MemoryUsage::allocate(Tag, n * sizeof(T));
+        return p;
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        MemoryUsage::deallocate(Tag, n * sizeof(T));
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <class U>
+    bool
+    operator==(TaggedAllocator<U, Tag> const&) const noexcept
+    {
+        return true;
+    }
+
+    template <class U>
+    bool
+    operator!=(TaggedAllocator<U, Tag> const&) const noexcept
+    {
+        return false;
+    }
+};
+
+}  // namespace ripple
+
+#endif
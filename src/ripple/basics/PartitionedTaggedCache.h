@@ -0,0 +1,389 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+#define RIPPLE_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+
+#include <ripple/basics/TaggedCache.h>
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** A TaggedCache split into independently locked partitions.
+
+    Each key is assigned to one of a fixed number of partitions by hashing
+    it, and every partition is a complete TaggedCache with its own mutex,
+    so operations on keys in different partitions never contend. Sweeping
+    visits the partitions one at a time, holding only that partition's
+    lock.
+
+    The target size is divided evenly among the partitions. Since the keys
+    are spread uniformly, the combined behavior closely matches a single
+    TaggedCache with the same settings.
+
+    Unlike TaggedCache there is no single mutex covering the whole cache,
+    so callers which need to lock it across several operations must use a
+    TaggedCache instead.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = hardened_hash<>,
+    class KeyEqual = std::equal_to<Key>,
+    class Mutex = std::recursive_mutex>
+class PartitionedTaggedCache
+{
+public:
+    using partition_type = TaggedCache<Key, T, Hash, KeyEqual, Mutex>;
+    using key_type = Key;
+    using mapped_type = T;
+    using clock_type = beast::abstract_clock<std::chrono::steady_clock>;
+
+    static constexpr std::size_t defaultPartitions = 16;
+
+public:
+    PartitionedTaggedCache(
+        std::string const& name,
+        int size,
+        clock_type::duration expiration,
+        clock_type& clock,
+        beast::Journal journal,
+        beast::insight::Collector::ptr const& collector =
+            beast::insight::NullCollector::New(),
+        std::size_t partitions = defaultPartitions)
+        : m_clock(clock)
+        , m_stats(
+              name,
+              std::bind(&PartitionedTaggedCache::collect_metrics, this),
+              collector)
+    {
+        assert(partitions > 0);
+        partitions = std::max<std::size_t>(partitions, 1);
+        m_partitions.reserve(partitions);
+        for (std::size_t i = 0; i < partitions; ++i)
+        {
+            m_partitions.push_back(std::make_unique<partition_type>(
+                name + " partition " + std::to_string(i),
+                partitionSize(size, partitions),
+                expiration,
+                clock,
+                journal));
+        }
+    }
+
+public:
+    /** Return the clock associated with the cache. */
+    clock_type&
+    clock()
+    {
+        return m_clock;
+    }
+
+    /** Return the number of partitions. */
+    std::size_t
+    partitions() const
+    {
+        return m_partitions.size();
+    }
+
+    int
+    getTargetSize() const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getTargetSize();
+        return size;
+    }
+
+    void
+    setTargetSize(int s)
+    {
+        auto const size = partitionSize(s, m_partitions.size());
+        for (auto& p : m_partitions)
+            p->setTargetSize(size);
+    }
+
+    std::size_t
+    getTargetBytes() const
+    {
+        std::size_t bytes = 0;
+        for (auto const& p : m_partitions)
+            bytes += p->getTargetBytes();
+        return bytes;
+    }
+
+    void
+    setTargetBytes(std::size_t bytes)
+    {
+        auto const share = bytes / m_partitions.size();
+        for (auto& p : m_partitions)
+            p->setTargetBytes(share);
+    }
+
+    clock_type::duration
+    getTargetAge() const
+    {
+        return m_partitions.front()->getTargetAge();
+    }
+
+    void
+    setTargetAge(clock_type::duration s)
+    {
+        for (auto& p : m_partitions)
+            p->setTargetAge(s);
+    }
+
+    int
+    getCacheSize() const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getCacheSize();
+        return size;
+    }
+
+    int
+    getTrackSize() const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getTrackSize();
+        return size;
+    }
+
+    std::size_t
+    getCacheBytes() const
+    {
+        std::size_t bytes = 0;
+        for (auto const& p : m_partitions)
+            bytes += p->getCacheBytes();
+        return bytes;
+    }
+
+    std::pair<std::uint64_t, std::uint64_t>
+    getHitCounts() const
+    {
+        std::pair<std::uint64_t, std::uint64_t> counts;
+        for (auto const& p : m_partitions)
+        {
+            auto const [hits, misses] = p->getHitCounts();
+            counts.first += hits;
+            counts.second += misses;
+        }
+        return counts;
+    }
+
+    /** Return the hit rate of the whole cache, as a percentage.
+        Keys are spread uniformly so every partition sees about the same
+        traffic; the rate is the mean of the partitions' rates.
+    */
+    float
+    getHitRate()
+    {
+        float rate = 0;
+        for (auto& p : m_partitions)
+            rate += p->getHitRate();
+        return rate / m_partitions.size();
+    }
+
+    /** Return the hit rate of each partition, as a percentage. */
+    std::vector<float>
+    getPartitionHitRates()
+    {
+        std::vector<float> rates;
+        rates.reserve(m_partitions.size());
+        for (auto& p : m_partitions)
+            rates.push_back(p->getHitRate());
+        return rates;
+    }
+
+    void
+    clear()
+    {
+        for (auto& p : m_partitions)
+            p->clear();
+    }
+
+    void
+    reset()
+    {
+        for (auto& p : m_partitions)
+            p->reset();
+    }
+
+    /** @see TaggedCache::abandon */
+    void
+    abandon()
+    {
+        for (auto& p : m_partitions)
+            p->abandon();
+    }
+
+    void
+    sweep()
+    {
+        for (auto& p : m_partitions)
+            p->sweep();
+    }
+
+    bool
+    del(const key_type& key, bool valid)
+    {
+        return partition(key).del(key, valid);
+    }
+
+    bool
+    canonicalize_replace_cache(
+        const key_type& key,
+        std::shared_ptr<T> const& data)
+    {
+        return partition(key).canonicalize_replace_cache(key, data);
+    }
+
+    bool
+    canonicalize_replace_client(const key_type& key, std::shared_ptr<T>& data)
+    {
+        return partition(key).canonicalize_replace_client(key, data);
+    }
+
+    std::shared_ptr<T>
+    fetch(const key_type& key)
+    {
+        return partition(key).fetch(key);
+    }
+
+    /** Insert the element into the container.
+        If the key already exists, nothing happens.
+        @return `true` If the element was inserted
+    */
+    bool
+    insert(key_type const& key, T const& value)
+    {
+        return partition(key).insert(key, value);
+    }
+
+    bool
+    retrieve(const key_type& key, T& data)
+    {
+        return partition(key).retrieve(key, data);
+    }
+
+    /** Refresh the expiration time on a key.
+
+        @param key The key to refresh.
+        @return `true` if the key was found and the object is cached.
+    */
+    bool
+    refreshIfPresent(const key_type& key)
+    {
+        return partition(key).refreshIfPresent(key);
+    }
+
+    std::vector<key_type>
+    getKeys() const
+    {
+        std::vector<key_type> v;
+        for (auto const& p : m_partitions)
+        {
+            auto keys = p->getKeys();
+            v.insert(v.end(), keys.begin(), keys.end());
+        }
+        return v;
+    }
+
+    /** Return the keys of up to `count` cached objects.
+
+        Each partition contributes an even share of its most recently used
+        keys, so the result is ordered by recency within each share only.
+    */
+    std::vector<key_type>
+    getRecentKeys(std::size_t count) const
+    {
+        auto const share =
+            (count + m_partitions.size() - 1) / m_partitions.size();
+        std::vector<key_type> v;
+        v.reserve(count);
+        for (auto const& p : m_partitions)
+        {
+            auto keys = p->getRecentKeys(std::min(share, count - v.size()));
+            v.insert(v.end(), keys.begin(), keys.end());
+        }
+        return v;
+    }
+
+private:
+    static int
+    partitionSize(int size, std::size_t partitions)
+    {
+        // Zero means no target; otherwise round up so that a small target
+        // does not leave a partition with none.
+        if (size <= 0)
+            return size;
+        return static_cast<int>((size + partitions - 1) / partitions);
+    }
+
+    partition_type&
+    partition(key_type const& key)
+    {
+        return *m_partitions[m_hash(key) % m_partitions.size()];
+    }
+
+    void
+    collect_metrics()
+    {
+        m_stats.size.set(getCacheSize());
+        m_stats.hit_rate.set(
+            static_cast<beast::insight::Gauge::value_type>(getHitRate()));
+    }
+
+private:
+    struct Stats
+    {
+        template <class Handler>
+        Stats(
+            std::string const& prefix,
+            Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook(collector->make_hook(handler))
+            , size(collector->make_gauge(prefix, "size"))
+            , hit_rate(collector->make_gauge(prefix, "hit_rate"))
+        {
+        }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+    };
+
+    clock_type& m_clock;
+    Stats m_stats;
+
+    // Selects the partition. Independently seeded from the partitions' own
+    // hash functions so that keys within a partition stay well spread.
+    Hash const m_hash;
+
+    std::vector<std::unique_ptr<partition_type>> m_partitions;
+};
+
+}  // namespace ripple
+
+#endif
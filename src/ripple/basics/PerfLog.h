@@ -31,7 +31,10 @@
 
 namespace beast {
 class Journal;
+namespace insight {
+class Collector;
 }
+}  // namespace beast
 
 namespace ripple {
 namespace perf {
@@ -62,6 +65,10 @@ public:
         boost::filesystem::path perfLog;
         // log_interval is in milliseconds to support faster testing.
         milliseconds logInterval{seconds(1)};
+        // Where sampled transaction traces are written, if anywhere.
+        boost::filesystem::path traceLog;
+        // Trace one transaction in this many.
+        std::uint32_t traceSampleRate{1000};
     };
 
     virtual ~PerfLog() = default;
@@ -93,6 +100,16 @@ public:
     virtual void
     rpcError(std::string const& method, std::uint64_t requestId) = 0;
 
+    /**
+     * Log the size of an RPC request and of its reply
+     *
+     * @param method RPC command
+     * @param in Bytes received
+     * @param out Bytes sent
+     */
+    virtual void
+    rpcBytes(std::string const& method, std::size_t in, std::size_t out) = 0;
+
     /**
      * Log queued job
      *
@@ -126,6 +143,19 @@ public:
     virtual void
     jobFinish(JobType const type, microseconds dur, int instance) = 0;
 
+    /**
+     * Log signatures verified for jobs of a type
+     *
+     * @param type Job type
+     * @param count Number of signatures verified
+     * @param dur Duration of the verification in microseconds
+     */
+    virtual void
+    signaturesVerified(
+        JobType const type,
+        std::size_t count,
+        microseconds dur) = 0;
+
     /**
      * Render performance counters in Json
      *
@@ -155,6 +185,17 @@ public:
      */
     virtual void
     rotate() = 0;
+
+    /**
+     * Report the duration and reply size of each RPC method to a collector
+     *
+     * Must be called before any RPC call is logged.
+     *
+     * @param collector Where the metrics are sent
+     */
+    virtual void
+    setCollector(
+        std::shared_ptr<beast::insight::Collector> const& collector) = 0;
 };
 
 }  // namespace perf
@@ -85,16 +85,13 @@ strUnHex(std::size_t strSize, Iterator begin, Iterator end)
     return {std::move(out)};
 }
 
-inline boost::optional<Blob>
-strUnHex(std::string const& strSrc)
-{
-    return strUnHex(strSrc.size(), strSrc.cbegin(), strSrc.cend());
-}
+boost::optional<Blob>
+strViewUnHex(boost::string_view const& strSrc);
 
 inline boost::optional<Blob>
-strViewUnHex(boost::string_view const& strSrc)
+strUnHex(std::string const& strSrc)
 {
-    return strUnHex(strSrc.size(), strSrc.cbegin(), strSrc.cend());
+    return strViewUnHex(strSrc);
 }
 
 struct parsedURL
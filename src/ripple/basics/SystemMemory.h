@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SYSTEMMEMORY_H_INCLUDED
+#define RIPPLE_BASICS_SYSTEMMEMORY_H_INCLUDED
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace ripple {
+
+/** The physical memory of the machine, in bytes. */
+struct SystemMemory
+{
+    std::uint64_t total = 0;
+
+    // Memory which could be given to applications without swapping,
+    // including what the kernel uses as file cache
+    std::uint64_t available = 0;
+};
+
+/** Parse the contents of /proc/meminfo.
+
+    @return Nothing if either figure is missing.
+*/
+std::optional<SystemMemory>
+parseMeminfo(std::string const& text);
+
+/** Measure the memory of this machine.
+
+    @return Nothing on platforms where this is not supported.
+*/
+std::optional<SystemMemory>
+getSystemMemory();
+
+}  // namespace ripple
+
+#endif
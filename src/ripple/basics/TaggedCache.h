@@ -20,11 +20,14 @@
 #ifndef RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 #define RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 
+#include <ripple/basics/CacheBudget.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/beast/insight/Insight.h>
+#include <algorithm>
 #include <functional>
 #include <mutex>
 #include <vector>
@@ -40,6 +43,10 @@ namespace ripple {
     If it stays in memory even after it is ejected from the cache,
     the map will track it.
 
+    The cache may be bounded by a number of entries, by the bytes its
+    objects hold as estimated by CacheFootprint, or both. Objects age out
+    faster the further the cache is over either bound.
+
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
 */
@@ -74,8 +81,10 @@ public:
               collector)
         , m_name(name)
         , m_target_size(size)
+        , m_target_bytes(0)
         , m_target_age(expiration)
         , m_cache_count(0)
+        , m_cache_bytes(0)
         , m_hits(0)
         , m_misses(0)
     {
@@ -109,6 +118,23 @@ public:
         JLOG(m_journal.debug()) << m_name << " target size set to " << s;
     }
 
+    std::size_t
+    getTargetBytes() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_target_bytes;
+    }
+
+    /** Set the most bytes the cached objects should hold (0 = ignore). */
+    void
+    setTargetBytes(std::size_t bytes)
+    {
+        std::lock_guard lock(m_mutex);
+        m_target_bytes = bytes;
+        JLOG(m_journal.debug())
+            << m_name << " target bytes set to " << bytes;
+    }
+
     clock_type::duration
     getTargetAge() const
     {
@@ -139,6 +165,22 @@ public:
         return m_cache.size();
     }
 
+    /** Return the estimated bytes held by the cached objects. */
+    std::size_t
+    getCacheBytes() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_cache_bytes;
+    }
+
+    /** Return the number of hits and misses since the last reset. */
+    std::pair<std::uint64_t, std::uint64_t>
+    getHitCounts() const
+    {
+        std::lock_guard lock(m_mutex);
+        return {m_hits, m_misses};
+    }
+
     float
     getHitRate()
     {
@@ -153,6 +195,7 @@ public:
         std::lock_guard lock(m_mutex);
         m_cache.clear();
         m_cache_count = 0;
+        m_cache_bytes = 0;
     }
 
     void
@@ -161,10 +204,27 @@ public:
         std::lock_guard lock(m_mutex);
         m_cache.clear();
         m_cache_count = 0;
+        m_cache_bytes = 0;
         m_hits = 0;
         m_misses = 0;
     }
 
+    /** Empty the cache without destroying the objects it holds.
+
+        The strong references are leaked, so the objects live until the
+        process exits. When exiting, freeing millions of cached objects one
+        at a time can take longer than the rest of the shutdown.
+    */
+    void
+    abandon()
+    {
+        std::lock_guard lock(m_mutex);
+        new cache_type(std::move(m_cache));
+        m_cache.clear();
+        m_cache_count = 0;
+        m_cache_bytes = 0;
+    }
+
     void
     sweep()
     {
@@ -183,15 +243,29 @@ public:
 
             std::lock_guard lock(m_mutex);
 
-            if (m_target_size == 0 ||
-                (static_cast<int>(m_cache.size()) <= m_target_size))
+            bool const overSize = m_target_size != 0 &&
+                static_cast<int>(m_cache.size()) > m_target_size;
+            bool const overBytes =
+                m_target_bytes != 0 && m_cache_bytes > m_target_bytes;
+
+            if (!overSize && !overBytes)
             {
                 when_expire = now - m_target_age;
             }
             else
             {
-                when_expire =
-                    now - m_target_age * m_target_size / m_cache.size();
+                // The fraction of the target age to keep objects for
+                double fraction = 1;
+                if (overSize)
+                    fraction = static_cast<double>(m_target_size) /
+                        m_cache.size();
+                if (overBytes)
+                    fraction = std::min(
+                        fraction,
+                        static_cast<double>(m_target_bytes) / m_cache_bytes);
+                when_expire = now -
+                    std::chrono::duration_cast<clock_type::duration>(
+                                  m_target_age * fraction);
 
                 clock_type::duration const minimumAge(std::chrono::seconds(1));
                 if (when_expire > (now - minimumAge))
@@ -199,7 +273,8 @@ public:
 
                 JLOG(m_journal.trace())
                     << m_name << " is growing fast " << m_cache.size() << " of "
-                    << m_target_size << " aging at "
+                    << m_target_size << ", " << m_cache_bytes << " of "
+                    << m_target_bytes << " bytes, aging at "
                     << (now - when_expire).count() << " of "
                     << m_target_age.count();
             }
@@ -227,6 +302,7 @@ public:
                 {
                     // strong, expired
                     --m_cache_count;
+                    m_cache_bytes -= cit->second.bytes;
                     ++cacheRemovals;
                     if (cit->second.ptr.unique())
                     {
@@ -280,6 +356,7 @@ public:
         if (entry.isCached())
         {
             --m_cache_count;
+            m_cache_bytes -= entry.bytes;
             entry.ptr.reset();
             ret = true;
         }
@@ -321,11 +398,13 @@ private:
 
         if (cit == m_cache.end())
         {
+            auto const bytes = footprint(*data);
             m_cache.emplace(
                 std::piecewise_construct,
                 std::forward_as_tuple(key),
-                std::forward_as_tuple(m_clock.now(), data));
+                std::forward_as_tuple(m_clock.now(), data, bytes));
             ++m_cache_count;
+            m_cache_bytes += bytes;
             return false;
         }
 
@@ -336,8 +415,11 @@ private:
         {
             if constexpr (replace)
             {
+                m_cache_bytes -= entry.bytes;
                 entry.ptr = data;
                 entry.weak_ptr = data;
+                entry.bytes = footprint(*data);
+                m_cache_bytes += entry.bytes;
             }
             else
             {
@@ -355,6 +437,7 @@ private:
             {
                 entry.ptr = data;
                 entry.weak_ptr = data;
+                entry.bytes = footprint(*data);
             }
             else
             {
@@ -363,12 +446,15 @@ private:
             }
 
             ++m_cache_count;
+            m_cache_bytes += entry.bytes;
             return true;
         }
 
         entry.ptr = data;
         entry.weak_ptr = data;
+        entry.bytes = footprint(*data);
         ++m_cache_count;
+        m_cache_bytes += entry.bytes;
 
         return false;
     }
@@ -417,6 +503,7 @@ public:
         {
             // independent of cache size, so not counted as a hit
             ++m_cache_count;
+            m_cache_bytes += entry.bytes;
             return entry.ptr;
         }
 
@@ -480,6 +567,7 @@ public:
                 {
                     // We just put the object back in cache
                     ++m_cache_count;
+                    m_cache_bytes += entry.bytes;
                     entry.touch(m_clock.now());
                     found = true;
                 }
@@ -522,6 +610,37 @@ public:
         return v;
     }
 
+    /** Return the keys of up to `count` cached objects, the most recently
+        used first. Objects which are only tracked are left out. */
+    std::vector<key_type>
+    getRecentKeys(std::size_t count) const
+    {
+        std::vector<std::pair<clock_type::time_point, key_type>> recent;
+
+        {
+            std::lock_guard lock(m_mutex);
+            recent.reserve(m_cache_count);
+            for (auto const& [key, entry] : m_cache)
+            {
+                if (entry.isCached())
+                    recent.emplace_back(entry.last_access, key);
+            }
+        }
+
+        count = std::min(count, recent.size());
+        std::partial_sort(
+            recent.begin(),
+            recent.begin() + count,
+            recent.end(),
+            [](auto const& a, auto const& b) { return a.first > b.first; });
+
+        std::vector<key_type> v;
+        v.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            v.push_back(recent[i].second);
+        return v;
+    }
+
 private:
     void
     collect_metrics()
@@ -566,10 +685,17 @@ private:
         std::weak_ptr<mapped_type> weak_ptr;
         clock_type::time_point last_access;
 
+        // The footprint of the object, counted while it is cached
+        std::size_t bytes;
+
         Entry(
             clock_type::time_point const& last_access_,
-            std::shared_ptr<mapped_type> const& ptr_)
-            : ptr(ptr_), weak_ptr(ptr_), last_access(last_access_)
+            std::shared_ptr<mapped_type> const& ptr_,
+            std::size_t bytes_)
+            : ptr(ptr_)
+            , weak_ptr(ptr_)
+            , last_access(last_access_)
+            , bytes(bytes_)
         {
         }
 
@@ -600,7 +726,19 @@ private:
         }
     };
 
-    using cache_type = hardened_hash_map<key_type, Entry, Hash, KeyEqual>;
+    using cache_type = hardened_hash_map<
+        key_type,
+        Entry,
+        Hash,
+        KeyEqual,
+        TaggedAllocator<std::pair<key_type const, Entry>, MemoryTag::cache>>;
+
+    static std::size_t
+    footprint(mapped_type const& data)
+    {
+        return CacheFootprint<std::remove_const_t<mapped_type>>::bytes(data) +
+            sizeof(typename cache_type::value_type);
+    }
 
     beast::Journal m_journal;
     clock_type& m_clock;
@@ -614,11 +752,17 @@ private:
     // Desired number of cache entries (0 = ignore)
     int m_target_size;
 
+    // Desired bytes held by cached objects (0 = ignore)
+    std::size_t m_target_bytes;
+
     // Desired maximum cache age
     clock_type::duration m_target_age;
 
     // Number of items cached
     int m_cache_count;
+
+    // Bytes held by cached items
+    std::size_t m_cache_bytes;
     cache_type m_cache;  // Hold strong reference to recent objects
     std::uint64_t m_hits;
     std::uint64_t m_misses;
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_THREADAFFINITY_H_INCLUDED
+#define RIPPLE_BASICS_THREADAFFINITY_H_INCLUDED
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class Section;
+
+/** The processors a thread may run on. Empty means any of them. */
+using CpuSet = std::vector<unsigned>;
+
+/** Parse a list of processors such as "0-7,16-23".
+
+    @return The processors in increasing order, or nothing if the list
+        is malformed.
+*/
+std::optional<CpuSet>
+parseCpuSet(std::string const& list);
+
+/** Read a list of processors from a configuration section.
+
+    @return The processors, or an empty set if `name` is not present.
+    @throws std::runtime_error if the list is malformed.
+*/
+CpuSet
+getCpuSet(Section const& section, std::string const& name);
+
+/** Restrict the calling thread to the given processors.
+
+    Memory which a thread touches first is normally placed on its own NUMA
+    node, so keeping a pool's threads on one socket also keeps the memory
+    they allocate there. Does nothing if `cpus` is empty, and on platforms
+    where this is not supported.
+
+    @return `false` if the operating system refused the request.
+*/
+bool
+setCurrentThreadAffinity(CpuSet const& cpus);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_TRACER_H_INCLUDED
+#define RIPPLE_BASICS_TRACER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace ripple {
+namespace perf {
+
+/** Sampled tracing of the stages a transaction passes through.
+
+    A span records how long one stage took for one transaction. Spans are
+    identified by a trace ID taken from the transaction ID, so whether a
+    transaction is traced is decided the same way at every stage and on
+    every thread without passing anything between them: one transaction in
+    every `sampleRate` is traced from relay to publication, and the gaps
+    between its spans are the time it spent waiting between stages.
+
+    A span which is not sampled costs a relaxed load and a branch. One which
+    is sampled is written to a fixed size ring buffer owned by the current
+    thread, so apart from creating that buffer the first time a thread
+    traces anything, tracing never allocates. If spans are not collected
+    quickly enough the oldest are overwritten.
+*/
+namespace trace {
+
+using clock_type = std::chrono::steady_clock;
+
+/** A finished span. */
+struct Record
+{
+    // A string literal naming the stage
+    char const* name;
+    std::uint64_t id;
+    clock_type::time_point start;
+    clock_type::duration duration;
+    // A small number identifying the thread which recorded the span
+    std::uint32_t thread;
+};
+
+namespace detail {
+
+extern std::atomic<std::uint32_t> sampleRate;
+
+void
+record(
+    char const* name,
+    std::uint64_t id,
+    clock_type::time_point start,
+    clock_type::time_point end) noexcept;
+
+}  // namespace detail
+
+/** The trace ID of a transaction. */
+inline std::uint64_t
+traceID(uint256 const& txID)
+{
+    // Transaction IDs are hashes, so any of their bits will do
+    std::uint64_t id;
+    std::memcpy(&id, txID.data(), sizeof(id));
+    return id;
+}
+
+/** Trace one transaction in every `rate`, or none if `rate` is zero. */
+inline void
+setSampleRate(std::uint32_t rate)
+{
+    detail::sampleRate.store(rate, std::memory_order_relaxed);
+}
+
+/** Whether spans with a trace ID are recorded. */
+inline bool
+sampled(std::uint64_t id)
+{
+    auto const rate = detail::sampleRate.load(std::memory_order_relaxed);
+    return rate != 0 && id % rate == 0;
+}
+
+/** Records the time from its construction to its destruction. */
+class Span
+{
+public:
+    /** Start a span.
+
+        @param name A string literal naming the stage. Only the pointer is
+            kept.
+        @param txID The transaction being worked on.
+    */
+    Span(char const* name, uint256 const& txID) noexcept
+        : name_(name), id_(traceID(txID)), sampled_(sampled(id_))
+    {
+        if (sampled_)
+            start_ = clock_type::now();
+    }
+
+    ~Span()
+    {
+        if (sampled_)
+            detail::record(name_, id_, start_, clock_type::now());
+    }
+
+    Span(Span const&) = delete;
+    Span&
+    operator=(Span const&) = delete;
+
+private:
+    char const* const name_;
+    std::uint64_t const id_;
+    bool const sampled_;
+    clock_type::time_point start_;
+};
+
+/** Remove and return the spans recorded since the last call. */
+std::vector<Record>
+collect();
+
+/** Write spans as events in the Chrome trace event format.
+
+    Each event is followed by a comma and a newline, so the output of
+    successive calls can be appended to a file which starts with `[`.
+    Tools which read the format accept a file left unterminated like this,
+    and show each traced transaction as a track of its own.
+*/
+void
+writeEvents(std::ostream& os, std::vector<Record> const& records);
+
+}  // namespace trace
+}  // namespace perf
+}  // namespace ripple
+
+#endif
@@ -37,6 +37,10 @@
  * The cryptographic security of containers where a hash function is used as a
  * template parameter depends entirely on that hash function and not at all on
  * what container it is.
+ *
+ * For keys which are already the output of a cryptographic hash, like
+ * uint256 and AccountID, which are looked up often, see flat_hash_map and
+ * uniform_hash.
  */
 
 namespace ripple {
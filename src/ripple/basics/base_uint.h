@@ -392,22 +392,7 @@ public:
         if (sv.size() != bytes * 2)
             return false;
 
-        auto out = data();
-
-        auto in = sv.begin();
-
-        while (in != sv.end())
-        {
-            auto const hi = charUnHex(*in++);
-            auto const lo = charUnHex(*in++);
-
-            if (hi == -1 || lo == -1)
-                return false;
-
-            *out++ = static_cast<std::uint8_t>((hi << 4) + lo);
-        }
-
-        return true;
+        return hexDecode(sv.data(), bytes, data());
     }
 
     [[nodiscard]] bool
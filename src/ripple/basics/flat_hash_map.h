@@ -0,0 +1,755 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_FLAT_HASH_MAP_H_INCLUDED
+#define RIPPLE_BASICS_FLAT_HASH_MAP_H_INCLUDED
+
+#include <ripple/basics/contract.h>
+#include <ripple/basics/hardened_hash.h>
+#include <boost/endian/conversion.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ripple {
+
+namespace detail {
+
+/** The control bytes of eight consecutive slots of a flat_hash_map.
+
+    Each byte says whether its slot is empty, deleted or full, and for a
+    full slot holds 7 bits of the hash of its key. That lets a lookup
+    compare a key with eight slots at once, touching the slots themselves
+    only when the hash bits match.
+*/
+class flat_group
+{
+public:
+    using ctrl_t = std::int8_t;
+
+    static constexpr ctrl_t empty = -128;
+    static constexpr ctrl_t deleted = -2;
+    static constexpr std::size_t width = 8;
+
+    /** A set of slots of a group, one bit per slot. */
+    class mask
+    {
+    public:
+        explicit mask(std::uint64_t bits) : bits_(bits)
+        {
+        }
+
+        explicit operator bool() const
+        {
+            return bits_ != 0;
+        }
+
+        /** The lowest slot of the set, which must not be empty. */
+        std::size_t
+        lowest() const
+        {
+            // Each slot is the high bit of its byte. Isolate the lowest
+            // one and multiply to move its byte number to the top byte.
+            auto const bit = bits_ & (~bits_ + 1);
+            return static_cast<std::size_t>(
+                ((bit >> 7) * 0x0001020304050607ull) >> 56);
+        }
+
+        void
+        pop()
+        {
+            bits_ &= bits_ - 1;
+        }
+
+    private:
+        std::uint64_t bits_;
+    };
+
+    explicit flat_group(ctrl_t const* ctrl)
+    {
+        std::memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+        boost::endian::little_to_native_inplace(ctrl_);
+    }
+
+    /** The full slots whose hash bits are `h2`.
+
+        There may be false positives, right after a true match, but the
+        keys are compared anyway.
+    */
+    mask
+    match(std::uint8_t h2) const
+    {
+        auto const x = ctrl_ ^ (lsbs * h2);
+        return mask((x - lsbs) & ~x & msbs);
+    }
+
+    mask
+    matchEmpty() const
+    {
+        return mask((ctrl_ & (~ctrl_ << 6)) & msbs);
+    }
+
+    mask
+    matchEmptyOrDeleted() const
+    {
+        return mask((ctrl_ & (~ctrl_ << 7)) & msbs);
+    }
+
+    mask
+    matchFull() const
+    {
+        return mask(~ctrl_ & msbs);
+    }
+
+private:
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+    std::uint64_t ctrl_;
+};
+
+}  // namespace detail
+
+/** An unordered map which stores its elements in one flat array.
+
+    Lookups probe the array directly, rather than following the linked
+    nodes of a std::unordered_map, so they miss the cache far less often.
+    This suits maps keyed by hashes and account IDs which are looked up
+    often. Use it with uniform_hash for such keys.
+
+    The interface is the subset of std::unordered_map used in the code,
+    with these differences:
+
+    - Inserting may move the elements, invalidating every iterator,
+      pointer and reference to them. Erasing invalidates only those to
+      the erased element, so the `it = m.erase(it)` idiom works.
+    - The mapped type must be move constructible.
+    - emplace takes the key and the arguments of the mapped value, like
+      try_emplace.
+*/
+template <
+    class Key,
+    class Value,
+    class Hash = uniform_hash,
+    class Pred = std::equal_to<Key>>
+class flat_hash_map
+{
+private:
+    using group = detail::flat_group;
+    using ctrl_t = group::ctrl_t;
+
+    template <bool IsConst>
+    class iterator_type;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key const, Value>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Pred;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+    using iterator = iterator_type<false>;
+    using const_iterator = iterator_type<true>;
+
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(Hash const& hash, Pred const& pred = Pred())
+        : hash_(hash), pred_(pred)
+    {
+    }
+
+    flat_hash_map(flat_hash_map const& other)
+        : hash_(other.hash_), pred_(other.pred_)
+    {
+        reserve(other.size());
+        for (auto const& v : other)
+            insertUnique(hashOf(v.first), v.first, v.second);
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept
+        : hash_(other.hash_), pred_(other.pred_)
+    {
+        steal(other);
+    }
+
+    flat_hash_map&
+    operator=(flat_hash_map const& other)
+    {
+        if (this != &other)
+        {
+            flat_hash_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    flat_hash_map&
+    operator=(flat_hash_map&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            hash_ = other.hash_;
+            pred_ = other.pred_;
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~flat_hash_map()
+    {
+        release();
+    }
+
+    iterator
+    begin() noexcept
+    {
+        return iterator(ctrl_, slots_, ctrl_ + capacity_, true);
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return const_iterator(ctrl_, slots_, ctrl_ + capacity_, true);
+    }
+
+    const_iterator
+    cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    iterator
+    end() noexcept
+    {
+        return iterator(ctrl_ + capacity_, nullptr, ctrl_ + capacity_, false);
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return const_iterator(
+            ctrl_ + capacity_, nullptr, ctrl_ + capacity_, false);
+    }
+
+    const_iterator
+    cend() const noexcept
+    {
+        return end();
+    }
+
+    bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_type
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /** The number of slots, full or not. */
+    size_type
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    void
+    clear() noexcept
+    {
+        if (size_ != 0)
+        {
+            for (size_type i = 0; i < capacity_; ++i)
+            {
+                if (ctrl_[i] >= 0)
+                    slots_[i].value.~value_type();
+            }
+        }
+        if (capacity_ != 0)
+        {
+            std::memset(ctrl_, group::empty, capacity_ + group::width);
+            growthLeft_ = maxSize(capacity_);
+        }
+        size_ = 0;
+    }
+
+    /** Make room for `count` elements without moving them again. */
+    void
+    reserve(size_type count)
+    {
+        size_type capacity = group::width;
+        while (maxSize(capacity) < count)
+            capacity *= 2;
+        if (capacity > capacity_)
+            resize(capacity);
+    }
+
+    iterator
+    find(Key const& key)
+    {
+        auto const i = findIndex(key, hashOf(key));
+        if (i == capacity_)
+            return end();
+        return iterator(ctrl_ + i, slots_ + i, ctrl_ + capacity_, false);
+    }
+
+    const_iterator
+    find(Key const& key) const
+    {
+        auto const i = findIndex(key, hashOf(key));
+        if (i == capacity_)
+            return end();
+        return const_iterator(
+            ctrl_ + i, slots_ + i, ctrl_ + capacity_, false);
+    }
+
+    size_type
+    count(Key const& key) const
+    {
+        return findIndex(key, hashOf(key)) == capacity_ ? 0 : 1;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool>
+    try_emplace(Key const& key, Args&&... args)
+    {
+        return emplaceImpl(key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool>
+    try_emplace(Key&& key, Args&&... args)
+    {
+        return emplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <class K, class... Args>
+    std::pair<iterator, bool>
+    emplace(K&& key, Args&&... args)
+    {
+        return emplaceImpl(
+            Key(std::forward<K>(key)), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool>
+    insert(value_type const& value)
+    {
+        return emplaceImpl(value.first, value.second);
+    }
+
+    template <class P>
+    std::pair<iterator, bool>
+    insert(P&& value)
+    {
+        return emplaceImpl(
+            std::forward<P>(value).first, std::forward<P>(value).second);
+    }
+
+    Value&
+    operator[](Key const& key)
+    {
+        return emplaceImpl(key).first->second;
+    }
+
+    Value&
+    at(Key const& key)
+    {
+        auto const it = find(key);
+        if (it == end())
+            Throw<std::out_of_range>("flat_hash_map::at");
+        return it->second;
+    }
+
+    Value const&
+    at(Key const& key) const
+    {
+        auto const it = find(key);
+        if (it == end())
+            Throw<std::out_of_range>("flat_hash_map::at");
+        return it->second;
+    }
+
+    /** Erase an element.
+
+        @return An iterator to the element after it.
+    */
+    iterator
+    erase(const_iterator pos)
+    {
+        auto const i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+        eraseIndex(i);
+        return iterator(ctrl_ + i, slots_ + i, ctrl_ + capacity_, true);
+    }
+
+    iterator
+    erase(iterator pos)
+    {
+        return erase(const_iterator(pos));
+    }
+
+    size_type
+    erase(Key const& key)
+    {
+        auto const i = findIndex(key, hashOf(key));
+        if (i == capacity_)
+            return 0;
+        eraseIndex(i);
+        return 1;
+    }
+
+    void
+    swap(flat_hash_map& other) noexcept
+    {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(pred_, other.pred_);
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growthLeft_, other.growthLeft_);
+    }
+
+private:
+    union slot
+    {
+        slot()
+        {
+        }
+
+        ~slot()
+        {
+        }
+
+        value_type value;
+    };
+
+    // Up to 7/8 of the slots may be used
+    static size_type
+    maxSize(size_type capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    std::size_t
+    hashOf(Key const& key) const
+    {
+        return static_cast<std::size_t>(hash_(key));
+    }
+
+    static std::uint8_t
+    h2(std::size_t hash)
+    {
+        return static_cast<std::uint8_t>(hash & 0x7f);
+    }
+
+    void
+    setCtrl(size_type i, ctrl_t c)
+    {
+        ctrl_[i] = c;
+        // The first group is repeated after the last slot, so a group can
+        // be read starting at any slot.
+        if (i < group::width)
+            ctrl_[capacity_ + i] = c;
+    }
+
+    // The slot holding `key`, or capacity_ if there is none
+    size_type
+    findIndex(Key const& key, std::size_t hash) const
+    {
+        if (capacity_ == 0)
+            return capacity_;
+
+        auto const mask = capacity_ - 1;
+        auto pos = (hash >> 7) & mask;
+        for (size_type step = group::width;; step += group::width)
+        {
+            group const g(ctrl_ + pos);
+            for (auto m = g.match(h2(hash)); m; m.pop())
+            {
+                auto const i = (pos + m.lowest()) & mask;
+                if (pred_(slots_[i].value.first, key))
+                    return i;
+            }
+            if (g.matchEmpty())
+                return capacity_;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // The first slot not in use on the path of `hash`
+    size_type
+    findFree(std::size_t hash) const
+    {
+        auto const mask = capacity_ - 1;
+        auto pos = (hash >> 7) & mask;
+        for (size_type step = group::width;; step += group::width)
+        {
+            group const g(ctrl_ + pos);
+            if (auto const m = g.matchEmptyOrDeleted())
+                return (pos + m.lowest()) & mask;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // Insert an element whose key isn't in the map yet
+    template <class K, class... Args>
+    size_type
+    insertUnique(std::size_t hash, K&& key, Args&&... args)
+    {
+        auto i = capacity_ == 0 ? 0 : findFree(hash);
+        if (growthLeft_ == 0 && (capacity_ == 0 || ctrl_[i] != group::deleted))
+        {
+            // Reclaim the deleted slots if they make up much of the map,
+            // rather than growing it.
+            if (capacity_ != 0 && size_ <= maxSize(capacity_) / 2)
+                resize(capacity_);
+            else
+                resize(capacity_ == 0 ? group::width : capacity_ * 2);
+            i = findFree(hash);
+        }
+
+        new (&slots_[i].value) value_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        if (ctrl_[i] == group::empty)
+            --growthLeft_;
+        setCtrl(i, static_cast<ctrl_t>(h2(hash)));
+        ++size_;
+        return i;
+    }
+
+    template <class K, class... Args>
+    std::pair<iterator, bool>
+    emplaceImpl(K&& key, Args&&... args)
+    {
+        auto const hash = hashOf(key);
+        auto i = findIndex(key, hash);
+        bool const inserted = i == capacity_;
+        if (inserted)
+        {
+            i = insertUnique(
+                hash, std::forward<K>(key), std::forward<Args>(args)...);
+        }
+        return {
+            iterator(ctrl_ + i, slots_ + i, ctrl_ + capacity_, false),
+            inserted};
+    }
+
+    void
+    eraseIndex(size_type i)
+    {
+        assert(i < capacity_ && ctrl_[i] >= 0);
+        slots_[i].value.~value_type();
+        // Lookups must carry on past the slot, so it can't be made empty
+        setCtrl(i, group::deleted);
+        --size_;
+    }
+
+    // Move the elements into `capacity` new slots
+    void
+    resize(size_type capacity)
+    {
+        assert(capacity >= group::width && (capacity & (capacity - 1)) == 0);
+
+        auto const oldCtrl = ctrl_;
+        auto const oldSlots = slots_;
+        auto const oldCapacity = capacity_;
+
+        ctrl_ = new ctrl_t[capacity + group::width];
+        try
+        {
+            slots_ = std::allocator<slot>().allocate(capacity);
+        }
+        catch (...)
+        {
+            delete[] ctrl_;
+            ctrl_ = oldCtrl;
+            throw;
+        }
+        std::memset(ctrl_, group::empty, capacity + group::width);
+        capacity_ = capacity;
+        growthLeft_ = maxSize(capacity) - size_;
+
+        for (size_type i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                auto& v = oldSlots[i].value;
+                auto const hash = hashOf(v.first);
+                auto const j = findFree(hash);
+                new (&slots_[j].value) value_type(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(v.first),
+                    std::forward_as_tuple(std::move(v.second)));
+                setCtrl(j, static_cast<ctrl_t>(h2(hash)));
+                v.~value_type();
+            }
+        }
+
+        if (oldCapacity != 0)
+        {
+            delete[] oldCtrl;
+            std::allocator<slot>().deallocate(oldSlots, oldCapacity);
+        }
+    }
+
+    void
+    release() noexcept
+    {
+        clear();
+        if (capacity_ != 0)
+        {
+            delete[] ctrl_;
+            std::allocator<slot>().deallocate(slots_, capacity_);
+        }
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        growthLeft_ = 0;
+    }
+
+    void
+    steal(flat_hash_map& other) noexcept
+    {
+        ctrl_ = std::exchange(other.ctrl_, nullptr);
+        slots_ = std::exchange(other.slots_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        size_ = std::exchange(other.size_, 0);
+        growthLeft_ = std::exchange(other.growthLeft_, 0);
+    }
+
+    Hash hash_;
+    Pred pred_;
+    ctrl_t* ctrl_ = nullptr;
+    slot* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growthLeft_ = 0;
+};
+
+template <class Key, class Value, class Hash, class Pred>
+template <bool IsConst>
+class flat_hash_map<Key, Value, Hash, Pred>::iterator_type
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename flat_hash_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<IsConst, value_type const*, value_type*>;
+    using reference =
+        std::conditional_t<IsConst, value_type const&, value_type&>;
+
+    iterator_type() = default;
+
+    template <bool OtherConst, class = std::enable_if_t<IsConst && !OtherConst>>
+    iterator_type(iterator_type<OtherConst> const& other)
+        : ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_)
+    {
+    }
+
+    reference
+    operator*() const
+    {
+        return slot_->value;
+    }
+
+    pointer
+    operator->() const
+    {
+        return &slot_->value;
+    }
+
+    iterator_type&
+    operator++()
+    {
+        ++ctrl_;
+        ++slot_;
+        skip();
+        return *this;
+    }
+
+    iterator_type
+    operator++(int)
+    {
+        auto result = *this;
+        ++(*this);
+        return result;
+    }
+
+    friend bool
+    operator==(iterator_type const& lhs, iterator_type const& rhs)
+    {
+        return lhs.ctrl_ == rhs.ctrl_;
+    }
+
+    friend bool
+    operator!=(iterator_type const& lhs, iterator_type const& rhs)
+    {
+        return lhs.ctrl_ != rhs.ctrl_;
+    }
+
+private:
+    friend class flat_hash_map;
+
+    template <bool>
+    friend class iterator_type;
+
+    iterator_type(ctrl_t* ctrl, slot* s, ctrl_t* end, bool skipFree)
+        : ctrl_(ctrl), slot_(s), end_(end)
+    {
+        if (skipFree)
+            skip();
+    }
+
+    // Move on to the next full slot, or the end
+    void
+    skip()
+    {
+        while (ctrl_ != end_ && *ctrl_ < 0)
+        {
+            ++ctrl_;
+            ++slot_;
+        }
+    }
+
+    ctrl_t* ctrl_ = nullptr;
+    slot* slot_ = nullptr;
+    ctrl_t* end_ = nullptr;
+};
+
+}  // namespace ripple
+
+#endif
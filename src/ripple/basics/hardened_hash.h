@@ -23,7 +23,9 @@
 #include <ripple/beast/hash/hash_append.h>
 #include <ripple/beast/hash/xxhasher.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <mutex>
 #include <random>
@@ -115,6 +117,83 @@ public:
     }
 };
 
+/** A seeded hash for keys whose bits are already uniformly distributed.
+
+    Keys like ledger and transaction hashes or account IDs are the output
+    of a cryptographic hash, so there is no need to run them through
+    another one. The bytes of the key are folded with a multiply, after
+    being mixed with a random seed chosen once per construction, which
+    keeps someone who picks the keys from knowing which of them collide.
+
+    T must be trivially copyable and at least 8 bytes long, and every byte
+    of its representation must take part in comparing keys.
+*/
+class uniform_hash
+{
+private:
+    detail::seed_pair m_seeds;
+
+    static std::uint64_t
+    mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        auto const m = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(m) ^
+            static_cast<std::uint64_t>(m >> 64);
+#else
+        std::uint64_t const lo = (a & 0xffffffff) * (b & 0xffffffff);
+        std::uint64_t const t = (a >> 32) * (b & 0xffffffff) + (lo >> 32);
+        std::uint64_t const u = (a & 0xffffffff) * (b >> 32) + (t & 0xffffffff);
+        std::uint64_t const hi = (a >> 32) * (b >> 32) + (t >> 32) + (u >> 32);
+        return (a * b) ^ hi;
+#endif
+    }
+
+    static std::uint64_t
+    load(std::uint8_t const* p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+public:
+    using result_type = std::size_t;
+
+    uniform_hash() : m_seeds(detail::make_seed_pair<>())
+    {
+    }
+
+    template <class T>
+    result_type
+    operator()(T const& t) const noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) >= 8);
+
+        auto const p = reinterpret_cast<std::uint8_t const*>(&t);
+        if constexpr (sizeof(T) < 16)
+        {
+            return static_cast<result_type>(mix(
+                load(p) ^ m_seeds.first,
+                load(p + sizeof(T) - 8) ^ m_seeds.second));
+        }
+        else
+        {
+            // Fold 16 bytes at a time, the last block overlapping the one
+            // before it if the size isn't a multiple of 16.
+            std::uint64_t h = 0;
+            for (std::size_t i = 0; i < sizeof(T); i += 16)
+            {
+                auto const q = p + std::min(i, sizeof(T) - 16);
+                h = mix(
+                    load(q) ^ m_seeds.first ^ h,
+                    load(q + 8) ^ m_seeds.second);
+            }
+            return static_cast<result_type>(h);
+        }
+    }
+};
+
 }  // namespace ripple
 
 #endif
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/CacheBudget.h>
+#include <ripple/basics/Log.h>
+#include <algorithm>
+
+namespace ripple {
+
+CacheBudget::CacheBudget(std::size_t bytes, beast::Journal journal)
+    : limit_(bytes), j_(journal), bytes_(bytes)
+{
+}
+
+void
+CacheBudget::add(Member member)
+{
+    std::lock_guard lock(mutex_);
+    member.misses = member.hitCounts().second;
+    members_.push_back(std::move(member));
+
+    auto const share = bytes_ / members_.size();
+    for (auto& m : members_)
+    {
+        m.targetBytes = share;
+        m.setTargetBytes(share);
+    }
+}
+
+void
+CacheBudget::rebalance()
+{
+    std::lock_guard lock(mutex_);
+    if (members_.size() < 2)
+        return;
+
+    // Misses per megabyte of target, if the cache is nearly full
+    std::vector<double> benefit;
+    benefit.reserve(members_.size());
+    for (auto& m : members_)
+    {
+        auto const misses = m.hitCounts().second;
+        auto const recent = misses >= m.misses ? misses - m.misses : misses;
+        m.misses = misses;
+
+        auto const full =
+            m.cacheBytes() >= m.targetBytes - m.targetBytes / fullDivisor;
+        auto const megabytes =
+            std::max<double>(m.targetBytes, 1) / (1024 * 1024);
+        benefit.push_back(full ? recent / megabytes : 0);
+    }
+
+    auto const floor = bytes_ / members_.size() / floorDivisor;
+    auto const to = static_cast<std::size_t>(std::distance(
+        benefit.begin(), std::max_element(benefit.begin(), benefit.end())));
+
+    std::size_t from = members_.size();
+    for (std::size_t i = 0; i < members_.size(); ++i)
+    {
+        if (i == to || members_[i].targetBytes <= floor)
+            continue;
+        if (from == members_.size() || benefit[i] < benefit[from])
+            from = i;
+    }
+
+    // Only move memory where it is clearly worth more, or the shares
+    // would swing back and forth with the noise in the load
+    if (from == members_.size() || benefit[to] <= benefit[from] * 1.25)
+        return;
+
+    auto const step =
+        std::min(bytes_ / stepDivisor, members_[from].targetBytes - floor);
+    if (step == 0)
+        return;
+
+    auto& giver = members_[from];
+    auto& taker = members_[to];
+    giver.targetBytes -= step;
+    taker.targetBytes += step;
+    giver.setTargetBytes(giver.targetBytes);
+    taker.setTargetBytes(taker.targetBytes);
+
+    JLOG(j_.debug()) << "Moved " << step << " bytes of cache from "
+                     << giver.name << " to " << taker.name;
+}
+
+void
+CacheBudget::adjust(bool memoryShort)
+{
+    std::lock_guard lock(mutex_);
+    auto const bytes = memoryShort
+        ? std::max(bytes_ - bytes_ / 4, limit_ / 4)
+        : std::min(bytes_ + limit_ / stepDivisor, limit_);
+    if (bytes == bytes_)
+        return;
+
+    auto const scale = static_cast<double>(bytes) / bytes_;
+    for (auto& m : members_)
+    {
+        m.targetBytes = static_cast<std::size_t>(m.targetBytes * scale);
+        m.setTargetBytes(m.targetBytes);
+    }
+
+    JLOG(j_.info()) << (memoryShort ? "Memory is short, shrank" : "Grew")
+                    << " the cache budget from " << bytes_ << " to " << bytes
+                    << " bytes";
+    bytes_ = bytes;
+}
+
+auto
+CacheBudget::report() const -> std::vector<Report>
+{
+    std::lock_guard lock(mutex_);
+    std::vector<Report> result;
+    result.reserve(members_.size());
+    for (auto const& m : members_)
+    {
+        auto const [hits, misses] = m.hitCounts();
+        result.push_back({m.name, m.cacheBytes(), m.targetBytes, hits, misses});
+    }
+    return result;
+}
+
+}  // namespace ripple
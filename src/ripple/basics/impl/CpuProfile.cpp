@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/CpuProfile.h>
+#include <boost/predef.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <thread>
+
+#if BOOST_OS_LINUX && __has_include(<execinfo.h>)
+#define RIPPLE_CPU_PROFILE 1
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#else
+#define RIPPLE_CPU_PROFILE 0
+#endif
+
+namespace ripple {
+
+namespace {
+
+thread_local char const* currentTag = nullptr;
+
+}  // namespace
+
+void
+setCpuProfileTag(char const* tag)
+{
+    currentTag = tag;
+}
+
+#if RIPPLE_CPU_PROFILE
+
+namespace {
+
+// The deepest stack recorded, counting the frames of the signal handler
+constexpr int maxDepth = 32;
+
+// The handler and the kernel's signal trampoline
+constexpr int skippedFrames = 2;
+
+// Enough for 20 seconds at 100 samples a second on 32 busy threads
+constexpr std::size_t maxSamples = 65536;
+
+struct Sample
+{
+    char const* tag;
+    char thread[16];
+    int depth;
+    void* frames[maxDepth];
+};
+
+struct Buffer
+{
+    std::unique_ptr<Sample[]> samples{new Sample[maxSamples]};
+    std::atomic<std::size_t> next{0};
+};
+
+// Everything the signal handler touches is lock free, so it may run at
+// any point in any thread.
+std::atomic<Buffer*> activeBuffer{nullptr};
+std::atomic<int> activeHandlers{0};
+std::atomic<bool> running{false};
+
+void
+onProfileSignal(int)
+{
+    auto const savedErrno = errno;
+    ++activeHandlers;
+    if (auto const buffer = activeBuffer.load())
+    {
+        auto const i = buffer->next++;
+        if (i < maxSamples)
+        {
+            auto& sample = buffer->samples[i];
+            sample.tag = currentTag;
+            std::memset(sample.thread, 0, sizeof(sample.thread));
+            prctl(PR_GET_NAME, sample.thread, 0, 0, 0);
+            sample.depth = backtrace(sample.frames, maxDepth);
+        }
+    }
+    --activeHandlers;
+    errno = savedErrno;
+}
+
+// The thread's role is its name without the number distinguishing the
+// threads of one pool
+std::string
+threadRole(char const* name)
+{
+    std::string role(name, strnlen(name, 16));
+    auto const end = role.find_last_not_of("0123456789 #");
+    role.resize(end == std::string::npos ? 0 : end + 1);
+    return role.empty() ? "unnamed" : role;
+}
+
+std::string
+frameName(void* address, std::map<void*, std::string>& names)
+{
+    if (auto const it = names.find(address); it != names.end())
+        return it->second;
+
+    std::string name;
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname)
+    {
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled(
+            abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status),
+            std::free);
+        name = status == 0 ? demangled.get() : info.dli_sname;
+    }
+    else if (info.dli_fname)
+    {
+        // The return address is one past the call; step back into it
+        auto const offset = static_cast<char*>(address) -
+            static_cast<char*>(info.dli_fbase) - 1;
+        char const* base = std::strrchr(info.dli_fname, '/');
+        char hex[20];
+        std::snprintf(hex, sizeof(hex), "+0x%tx", offset);
+        name = std::string(base ? base + 1 : info.dli_fname) + hex;
+    }
+    else
+    {
+        name = "??";
+    }
+
+    // Semicolons separate the frames of a folded stack
+    std::replace(name.begin(), name.end(), ';', ':');
+    return names.emplace(address, name).first->second;
+}
+
+}  // namespace
+
+std::optional<CpuProfile>
+runCpuProfile(std::chrono::milliseconds duration, unsigned frequency)
+{
+    if (running.exchange(true))
+        return {};
+
+    static bool const installed = [] {
+        // The first call of backtrace loads the unwinder, which must not
+        // happen inside the signal handler
+        void* frames[1];
+        backtrace(frames, 1);
+
+        // The handler stays, so a signal still on its way when a profile
+        // ends does no harm
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = onProfileSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        return sigaction(SIGPROF, &action, nullptr) == 0;
+    }();
+    if (!installed)
+    {
+        running = false;
+        return {};
+    }
+
+    frequency = std::clamp(frequency, 1u, 1000u);
+    auto buffer = std::make_unique<Buffer>();
+    activeBuffer = buffer.get();
+
+    itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / frequency;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    std::this_thread::sleep_for(duration);
+
+    std::memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    activeBuffer = nullptr;
+    while (activeHandlers != 0)
+        std::this_thread::yield();
+
+    CpuProfile result;
+    auto const taken = buffer->next.load();
+    result.samples = std::min(taken, maxSamples);
+    result.dropped = taken - result.samples;
+
+    std::map<void*, std::string> names;
+    std::map<std::string, std::uint64_t> folded;
+    for (std::size_t i = 0; i < result.samples; ++i)
+    {
+        auto const& sample = buffer->samples[i];
+        std::string frames = threadRole(sample.thread);
+        frames += ';';
+        frames += sample.tag ? sample.tag : "-";
+        for (int f = sample.depth - 1; f >= skippedFrames; --f)
+        {
+            frames += ';';
+            frames += frameName(sample.frames[f], names);
+        }
+        ++folded[frames];
+    }
+
+    result.stacks.reserve(folded.size());
+    for (auto& [frames, count] : folded)
+        result.stacks.push_back({frames, count});
+    std::sort(
+        result.stacks.begin(),
+        result.stacks.end(),
+        [](auto const& a, auto const& b) { return a.count > b.count; });
+
+    running = false;
+    return result;
+}
+
+#else
+
+std::optional<CpuProfile>
+runCpuProfile(std::chrono::milliseconds, unsigned)
+{
+    return {};
+}
+
+#endif
+
+}  // namespace ripple
@@ -0,0 +1,270 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/HugePages.h>
+#include <boost/predef.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#if BOOST_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace ripple {
+
+namespace {
+
+constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+// Memory is mapped in regions this large, or larger for a bigger block
+constexpr std::size_t regionSize = 32 * hugePageSize;
+
+// Each block is preceded by its size, keeping the block aligned
+constexpr std::size_t headerSize = alignof(std::max_align_t);
+
+constexpr std::size_t
+roundUp(std::size_t n, std::size_t to)
+{
+    return (n + to - 1) / to * to;
+}
+
+struct Region
+{
+    char* begin;
+    char* end;
+    char* next;
+};
+
+struct State
+{
+    std::atomic<HugePageMode> mode{HugePageMode::none};
+
+    std::mutex mutex;
+    std::vector<Region> regions;
+    std::unordered_map<std::size_t, std::vector<char*>> freeLists;
+};
+
+State&
+state()
+{
+    // Never destroyed: memory pools with static storage duration can free
+    // their blocks after any other static would have been destroyed.
+    static State& s = *new State;
+    return s;
+}
+
+#if BOOST_OS_LINUX
+char*
+mapRegion(std::size_t size, HugePageMode mode)
+{
+    if (mode == HugePageMode::hugetlb)
+    {
+        auto const p = mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0);
+        if (p != MAP_FAILED)
+            return static_cast<char*>(p);
+    }
+
+    // Over-allocate so the region can start on a huge page boundary
+    auto const mapped = size + hugePageSize;
+    auto const p = mmap(
+        nullptr,
+        mapped,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (p == MAP_FAILED)
+        return nullptr;
+
+    auto const first = static_cast<char*>(p);
+    auto const begin = reinterpret_cast<char*>(
+        roundUp(reinterpret_cast<std::uintptr_t>(first), hugePageSize));
+    if (begin != first)
+        munmap(first, begin - first);
+    if (auto const tail = (first + mapped) - (begin + size); tail != 0)
+        munmap(begin + size, tail);
+
+    // Only a hint; the kernel may have transparent huge pages turned off
+    madvise(begin, size, MADV_HUGEPAGE);
+    return begin;
+}
+#else
+char*
+mapRegion(std::size_t, HugePageMode)
+{
+    return nullptr;
+}
+#endif
+
+}  // namespace
+
+std::optional<HugePageMode>
+parseHugePageMode(std::string const& s)
+{
+    if (s == "none")
+        return HugePageMode::none;
+    if (s == "transparent")
+        return HugePageMode::transparent;
+    if (s == "hugetlb")
+        return HugePageMode::hugetlb;
+    return {};
+}
+
+void
+setHugePageMode(HugePageMode mode)
+{
+#if !BOOST_OS_LINUX
+    mode = HugePageMode::none;
+#endif
+    state().mode.store(mode, std::memory_order_relaxed);
+}
+
+HugePageMode
+hugePageMode()
+{
+    return state().mode.load(std::memory_order_relaxed);
+}
+
+void*
+allocateHugePages(std::size_t bytes)
+{
+    auto& s = state();
+    auto const mode = s.mode.load(std::memory_order_relaxed);
+    if (mode != HugePageMode::none)
+    {
+        auto const size = roundUp(bytes + headerSize, headerSize);
+
+        std::lock_guard lock(s.mutex);
+        char* block = nullptr;
+        if (auto it = s.freeLists.find(size);
+            it != s.freeLists.end() && !it->second.empty())
+        {
+            block = it->second.back();
+            it->second.pop_back();
+        }
+        else
+        {
+            if (s.regions.empty() ||
+                s.regions.back().end - s.regions.back().next <
+                    static_cast<std::ptrdiff_t>(size))
+            {
+                auto const length =
+                    std::max(regionSize, roundUp(size, hugePageSize));
+                if (auto const p = mapRegion(length, mode))
+                    s.regions.push_back({p, p + length, p});
+            }
+
+            // If no region could be mapped the heap is used instead
+            if (!s.regions.empty() &&
+                s.regions.back().end - s.regions.back().next >=
+                    static_cast<std::ptrdiff_t>(size))
+            {
+                block = s.regions.back().next;
+                s.regions.back().next += size;
+            }
+        }
+
+        if (block)
+        {
+            *reinterpret_cast<std::size_t*>(block) = size;
+            return block + headerSize;
+        }
+    }
+
+    return ::operator new(bytes);
+}
+
+void
+deallocateHugePages(void* p)
+{
+    if (!p)
+        return;
+
+    auto& s = state();
+    auto const block = static_cast<char*>(p) - headerSize;
+    {
+        std::lock_guard lock(s.mutex);
+        for (auto const& region : s.regions)
+        {
+            if (block >= region.begin && block < region.end)
+            {
+                auto const size = *reinterpret_cast<std::size_t*>(block);
+                s.freeLists[size].push_back(block);
+                return;
+            }
+        }
+    }
+
+    ::operator delete(p);
+}
+
+#if __has_include(<memory_resource>)
+namespace {
+
+class HugePageResource : public std::pmr::memory_resource
+{
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        // The pools ask for chunks aligned to their block size. Blocks in
+        // the regions are only aligned to their header, so those come
+        // from the heap.
+        if (alignment > headerSize)
+            return ::operator new(bytes, std::align_val_t{alignment});
+        return allocateHugePages(bytes);
+    }
+
+    void
+    do_deallocate(void* p, std::size_t, std::size_t alignment) override
+    {
+        if (alignment > headerSize)
+            return ::operator delete(p, std::align_val_t{alignment});
+        deallocateHugePages(p);
+    }
+
+    bool
+    do_is_equal(std::pmr::memory_resource const& other) const
+        noexcept override
+    {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+std::pmr::memory_resource*
+hugePageResource()
+{
+    // Never destroyed, for the same reason as the state
+    static auto const resource = new HugePageResource;
+    return resource;
+}
+#endif
+
+}  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/DecimalDigits.h>
 #include <ripple/basics/IOUAmount.h>
 #include <ripple/basics/contract.h>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -33,6 +34,8 @@ static std::int64_t const maxMantissa = 9999999999999999ull;
 /* The range for the exponent when normalized */
 static int const minExponent = -96;
 static int const maxExponent = 80;
+/* The largest power of ten in powersOfTen which fits in a mantissa */
+static int const maxShift = 18;
 
 void
 IOUAmount::normalize()
@@ -48,19 +51,23 @@ IOUAmount::normalize()
     if (negative)
         mantissa_ = -mantissa_;
 
-    while ((mantissa_ < minMantissa) && (exponent_ > minExponent))
+    // Scale the mantissa to 16 digits in one step
+    if ((mantissa_ < minMantissa) && (exponent_ > minExponent))
     {
-        mantissa_ *= 10;
-        --exponent_;
+        auto const shift = std::min(
+            16 - decimalDigits(mantissa_), exponent_ - minExponent);
+        mantissa_ *= static_cast<std::int64_t>(powersOfTen[shift]);
+        exponent_ -= shift;
     }
 
-    while (mantissa_ > maxMantissa)
+    if (mantissa_ > maxMantissa)
     {
-        if (exponent_ >= maxExponent)
+        auto const shift = decimalDigits(mantissa_) - 16;
+        if (exponent_ > maxExponent - shift)
             Throw<std::overflow_error>("IOUAmount::normalize");
 
-        mantissa_ /= 10;
-        ++exponent_;
+        mantissa_ /= static_cast<std::int64_t>(powersOfTen[shift]);
+        exponent_ += shift;
     }
 
     if ((exponent_ < minExponent) || (mantissa_ < minMantissa))
@@ -91,16 +98,20 @@ IOUAmount::operator+=(IOUAmount const& other)
     auto m = other.mantissa_;
     auto e = other.exponent_;
 
+    // Dividing once by a power of ten truncates the same way as dividing
+    // by ten that many times
     while (exponent_ < e)
     {
-        mantissa_ /= 10;
-        ++exponent_;
+        auto const shift = std::min(e - exponent_, maxShift);
+        mantissa_ /= static_cast<std::int64_t>(powersOfTen[shift]);
+        exponent_ += shift;
     }
 
     while (e < exponent_)
     {
-        m /= 10;
-        ++e;
+        auto const shift = std::min(exponent_ - e, maxShift);
+        m /= static_cast<std::int64_t>(powersOfTen[shift]);
+        e += shift;
     }
 
     // This addition cannot overflow an std::int64_t but we may throw from
@@ -20,6 +20,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/contract.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <boost/algorithm/string.hpp>
 #include <cassert>
 #include <fstream>
@@ -113,6 +114,13 @@ Logs::File::writeln(char const* text)
     }
 }
 
+void
+Logs::File::flush()
+{
+    if (m_stream != nullptr)
+        m_stream->flush();
+}
+
 //------------------------------------------------------------------------------
 
 Logs::Logs(beast::severities::Severity thresh)
@@ -120,6 +128,19 @@ Logs::Logs(beast::severities::Severity thresh)
 {
 }
 
+Logs::~Logs()
+{
+    if (writer_.joinable())
+    {
+        {
+            std::lock_guard lock(queueMutex_);
+            stopping_ = true;
+        }
+        queueCond_.notify_one();
+        writer_.join();
+    }
+}
+
 bool
 Logs::open(boost::filesystem::path const& pathToLogFile)
 {
@@ -181,6 +202,24 @@ Logs::write(
 {
     std::string s;
     format(s, text, level, partition);
+
+    if (auto const capacity = capacity_.load())
+    {
+        std::lock_guard lock(queueMutex_);
+        if (!stopping_)
+        {
+            if (queue_.size() >= capacity)
+            {
+                ++dropped_;
+                return;
+            }
+            queue_.push_back(std::move(s));
+            if (queue_.size() == 1)
+                queueCond_.notify_one();
+            return;
+        }
+    }
+
     std::lock_guard lock(mutex_);
     file_.writeln(s);
     if (!silent_)
@@ -200,6 +239,69 @@ Logs::rotate()
     return "The log file could not be closed and reopened.";
 }
 
+void
+Logs::async(std::size_t capacity)
+{
+    assert(capacity != 0);
+    std::lock_guard lock(queueMutex_);
+    if (!writer_.joinable())
+    {
+        queue_.reserve(capacity);
+        writer_ = std::thread(&Logs::drain, this);
+    }
+    capacity_ = capacity;
+}
+
+void
+Logs::drain()
+{
+    beast::setCurrentThreadName("rippled: log");
+
+    std::vector<std::string> batch;
+    std::uint64_t reported = 0;
+    std::unique_lock queueLock(queueMutex_);
+    while (true)
+    {
+        queueCond_.wait(
+            queueLock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+            return;
+
+        // The two vectors trade places, so neither needs to grow again
+        batch.swap(queue_);
+        queueLock.unlock();
+
+        // Say how many messages were lost since the last batch
+        if (auto const dropped = dropped_.load(); dropped != reported)
+        {
+            std::string s;
+            format(
+                s,
+                std::to_string(dropped - reported) +
+                    " messages dropped because the log queue was full",
+                beast::severities::kWarning,
+                "Logs");
+            batch.push_back(std::move(s));
+            reported = dropped;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            for (auto const& s : batch)
+            {
+                file_.write(s);
+                file_.write("\n");
+                if (!silent_)
+                    std::cerr << s << '\n';
+            }
+            file_.flush();
+        }
+        batch.clear();
+
+        queueLock.lock();
+    }
+}
+
 std::unique_ptr<beast::Journal::Sink>
 Logs::makeSink(std::string const& name, beast::severities::Severity threshold)
 {
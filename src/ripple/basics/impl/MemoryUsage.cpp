@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/MemoryUsage.h>
+#include <array>
+#include <atomic>
+
+namespace ripple {
+
+namespace {
+
+// More stripes than this would make reports slower without making
+// contention noticeably rarer.
+constexpr std::size_t stripeCount = 16;
+
+struct alignas(64) Stripe
+{
+    std::array<std::atomic<std::int64_t>, MemoryUsage::tagCount> bytes{};
+    std::array<std::atomic<std::uint64_t>, MemoryUsage::tagCount>
+        allocations{};
+};
+
+std::array<Stripe, stripeCount> stripes;
+
+Stripe&
+stripe() noexcept
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t const index = next++ % stripeCount;
+    return stripes[index];
+}
+
+}  // namespace
+
+void
+MemoryUsage::allocate(MemoryTag tag, std::size_t bytes) noexcept
+{
+    auto& s = stripe();
+    auto const i = static_cast<std::size_t>(tag);
+    s.bytes[i].fetch_add(bytes, std::memory_order_relaxed);
+    s.allocations[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+MemoryUsage::deallocate(MemoryTag tag, std::size_t bytes) noexcept
+{
+    // Memory may be freed on another thread than it was allocated on, so
+    // only the sum over all stripes is meaningful.
+    stripe().bytes[static_cast<std::size_t>(tag)].fetch_sub(
+        bytes, std::memory_order_relaxed);
+}
+
+char const*
+MemoryUsage::name(MemoryTag tag) noexcept
+{
+    switch (tag)
+    {
+        case MemoryTag::shamap:
+            return "shamap";
+        case MemoryTag::stobject:
+            return "stobject";
+        case MemoryTag::json:
+            return "json";
+        case MemoryTag::message:
+            return "message";
+        case MemoryTag::cache:
+            return "cache";
+    }
+    return "unknown";
+}
+
+std::vector<MemoryUsage::Entry>
+MemoryUsage::report()
+{
+    std::vector<Entry> result;
+    result.reserve(tagCount);
+    for (std::size_t i = 0; i < tagCount; ++i)
+    {
+        Entry e{name(static_cast<MemoryTag>(i)), 0, 0};
+        for (auto const& s : stripes)
+        {
+            e.bytes += s.bytes[i].load(std::memory_order_relaxed);
+            e.allocations += s.allocations[i].load(std::memory_order_relaxed);
+        }
+        result.push_back(e);
+    }
+    return result;
+}
+
+}  // namespace ripple
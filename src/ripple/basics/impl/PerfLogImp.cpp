@@ -18,13 +18,17 @@
 //==============================================================================
 
 #include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/Tracer.h>
 #include <ripple/basics/impl/PerfLogImp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/insight/Collector.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -38,6 +42,67 @@
 namespace ripple {
 namespace perf {
 
+std::size_t
+LatencyHistogram::bucket(std::uint64_t us)
+{
+    if (us < subBuckets)
+        return us;
+    // The position of the highest bit picks the power of two, and the two
+    // bits below it pick the bucket within it.
+    std::size_t exp = 0;
+    for (auto v = us; v > 1; v >>= 1)
+        ++exp;
+    auto const sub = (us >> (exp - 2)) & (subBuckets - 1);
+    return std::min((exp - 1) * subBuckets + sub, bucketCount - 1);
+}
+
+std::uint64_t
+LatencyHistogram::lowerBound(std::size_t bucket)
+{
+    if (bucket < subBuckets)
+        return bucket;
+    auto const exp = bucket / subBuckets + 1;
+    auto const sub = bucket % subBuckets;
+    return (subBuckets + sub) << (exp - 2);
+}
+
+void
+LatencyHistogram::add(std::chrono::microseconds dur)
+{
+    auto const us = dur.count() > 0 ? dur.count() : 0;
+    ++counts_[bucket(static_cast<std::uint64_t>(us))];
+    ++total_;
+}
+
+LatencyHistogram&
+LatencyHistogram::operator+=(LatencyHistogram const& other)
+{
+    for (std::size_t i = 0; i < bucketCount; ++i)
+        counts_[i] += other.counts_[i];
+    total_ += other.total_;
+    return *this;
+}
+
+std::chrono::microseconds
+LatencyHistogram::quantile(double q) const
+{
+    if (total_ == 0)
+        return std::chrono::microseconds{0};
+
+    auto const rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(q * total_)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount - 1; ++i)
+    {
+        seen += counts_[i];
+        if (seen >= rank)
+            return std::chrono::microseconds(lowerBound(i + 1) - 1);
+    }
+    return std::chrono::microseconds(lowerBound(bucketCount - 1));
+}
+
+//-----------------------------------------------------------------------------
+
 PerfLogImp::Counters::Counters(
     std::vector<char const*> const& labels,
     JobTypes const& jobTypes)
@@ -102,6 +167,23 @@ PerfLogImp::Counters::countersJson() const
             totalRpc.sync.errored += sync->errored;
             p[jss::duration_us] = std::to_string(sync->duration.count());
             totalRpc.sync.duration += sync->duration;
+            if (sync->latency.size())
+            {
+                p[jss::p50_us] =
+                    std::to_string(sync->latency.quantile(0.5).count());
+                p[jss::p99_us] =
+                    std::to_string(sync->latency.quantile(0.99).count());
+                p[jss::p999_us] =
+                    std::to_string(sync->latency.quantile(0.999).count());
+            }
+            totalRpc.sync.latency += sync->latency;
+            if (sync->bytesIn || sync->bytesOut)
+            {
+                p[jss::bytes_in] = std::to_string(sync->bytesIn);
+                p[jss::bytes_out] = std::to_string(sync->bytesOut);
+            }
+            totalRpc.sync.bytesIn += sync->bytesIn;
+            totalRpc.sync.bytesOut += sync->bytesOut;
         }
         rpcobj[proc.first] = p;
     }
@@ -114,6 +196,22 @@ PerfLogImp::Counters::countersJson() const
         totalRpcJson[jss::errored] = std::to_string(totalRpc.sync.errored);
         totalRpcJson[jss::duration_us] =
             std::to_string(totalRpc.sync.duration.count());
+        if (auto const& latency = totalRpc.sync.latency; latency.size())
+        {
+            totalRpcJson[jss::p50_us] =
+                std::to_string(latency.quantile(0.5).count());
+            totalRpcJson[jss::p99_us] =
+                std::to_string(latency.quantile(0.99).count());
+            totalRpcJson[jss::p999_us] =
+                std::to_string(latency.quantile(0.999).count());
+        }
+        if (totalRpc.sync.bytesIn || totalRpc.sync.bytesOut)
+        {
+            totalRpcJson[jss::bytes_in] =
+                std::to_string(totalRpc.sync.bytesIn);
+            totalRpcJson[jss::bytes_out] =
+                std::to_string(totalRpc.sync.bytesOut);
+        }
         rpcobj[jss::total] = totalRpcJson;
     }
 
@@ -127,7 +225,7 @@ PerfLogImp::Counters::countersJson() const
             auto const sync = [&proc]() -> boost::optional<Counters::Jq::Sync> {
                 std::lock_guard lock(proc.second.mut);
                 if (!proc.second.sync.queued && !proc.second.sync.started &&
-                    !proc.second.sync.finished)
+                    !proc.second.sync.finished && !proc.second.sync.verified)
                 {
                     return boost::none;
                 }
@@ -148,6 +246,14 @@ PerfLogImp::Counters::countersJson() const
             j[jss::running_duration_us] =
                 std::to_string(sync->runningDuration.count());
             totalJq.sync.runningDuration += sync->runningDuration;
+            if (sync->verified)
+            {
+                j[jss::verified] = std::to_string(sync->verified);
+                j[jss::verify_duration_us] =
+                    std::to_string(sync->verifyDuration.count());
+            }
+            totalJq.sync.verified += sync->verified;
+            totalJq.sync.verifyDuration += sync->verifyDuration;
         }
         jqobj[proc.second.label] = j;
     }
@@ -162,6 +268,12 @@ PerfLogImp::Counters::countersJson() const
             std::to_string(totalJq.sync.queuedDuration.count());
         totalJqJson[jss::running_duration_us] =
             std::to_string(totalJq.sync.runningDuration.count());
+        if (totalJq.sync.verified)
+        {
+            totalJqJson[jss::verified] = std::to_string(totalJq.sync.verified);
+            totalJqJson[jss::verify_duration_us] =
+                std::to_string(totalJq.sync.verifyDuration.count());
+        }
         jqobj[jss::total] = totalJqJson;
     }
 
@@ -229,38 +341,53 @@ PerfLogImp::Counters::currentJson() const
 
 //-----------------------------------------------------------------------------
 
-void
-PerfLogImp::openLog()
+bool
+PerfLogImp::openFile(std::ofstream& file, boost::filesystem::path const& path)
 {
-    if (!setup_.perfLog.empty())
-    {
-        if (logFile_.is_open())
-            logFile_.close();
+    if (path.empty())
+        return false;
 
-        auto logDir = setup_.perfLog.parent_path();
-        if (!boost::filesystem::is_directory(logDir))
-        {
-            boost::system::error_code ec;
-            boost::filesystem::create_directories(logDir, ec);
-            if (ec)
-            {
-                JLOG(j_.fatal()) << "Unable to create performance log "
-                                    "directory "
-                                 << logDir << ": " << ec.message();
-                signalStop_();
-                return;
-            }
-        }
-
-        logFile_.open(setup_.perfLog.c_str(), std::ios::out | std::ios::app);
+    if (file.is_open())
+        file.close();
 
-        if (!logFile_)
+    auto logDir = path.parent_path();
+    if (!boost::filesystem::is_directory(logDir))
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(logDir, ec);
+        if (ec)
         {
-            JLOG(j_.fatal())
-                << "Unable to open performance log " << setup_.perfLog << ".";
+            JLOG(j_.fatal()) << "Unable to create performance log "
+                                "directory "
+                             << logDir << ": " << ec.message();
             signalStop_();
+            return false;
         }
     }
+
+    file.open(path.c_str(), std::ios::out | std::ios::app);
+
+    if (!file)
+    {
+        JLOG(j_.fatal()) << "Unable to open performance log " << path << ".";
+        signalStop_();
+        return false;
+    }
+    return true;
+}
+
+void
+PerfLogImp::openLog()
+{
+    openFile(logFile_, setup_.perfLog);
+
+    // A new trace file starts the array of events which is appended to
+    boost::system::error_code ec;
+    auto const fresh = setup_.traceLog.empty() ||
+        !boost::filesystem::exists(setup_.traceLog, ec) ||
+        boost::filesystem::file_size(setup_.traceLog, ec) == 0;
+    if (openFile(traceFile_, setup_.traceLog) && fresh)
+        traceFile_ << "[\n";
 }
 
 void
@@ -291,15 +418,21 @@ PerfLogImp::run()
 void
 PerfLogImp::report()
 {
-    if (!logFile_)
-        // If logFile_ is not writable do no further work.
-        return;
-
     auto const present = system_clock::now();
     if (present < lastLog_ + setup_.logInterval)
         return;
     lastLog_ = present;
 
+    if (traceFile_.is_open() && traceFile_)
+    {
+        trace::writeEvents(traceFile_, trace::collect());
+        traceFile_.flush();
+    }
+
+    if (!logFile_.is_open() || !logFile_)
+        // If logFile_ is not writable do no further work.
+        return;
+
     Json::Value report(Json::objectValue);
     report[jss::time] = to_string(date::floor<microseconds>(present));
     report[jss::workers] = counters_.workers_;
@@ -322,6 +455,8 @@ PerfLogImp::PerfLogImp(
     , signalStop_(std::move(signalStop))
 {
     openLog();
+    if (!setup_.traceLog.empty())
+        trace::setSampleRate(setup_.traceSampleRate);
 }
 
 PerfLogImp::~PerfLogImp()
@@ -374,13 +509,36 @@ PerfLogImp::rpcEnd(
             assert(false);
         }
     }
-    std::lock_guard lock(counter->second.mut);
-    if (finish)
-        ++counter->second.sync.finished;
-    else
-        ++counter->second.sync.errored;
-    counter->second.sync.duration += std::chrono::duration_cast<microseconds>(
+    auto const duration = std::chrono::duration_cast<microseconds>(
         steady_clock::now() - startTime);
+    {
+        std::lock_guard lock(counter->second.mut);
+        if (finish)
+            ++counter->second.sync.finished;
+        else
+            ++counter->second.sync.errored;
+        counter->second.sync.duration += duration;
+        counter->second.sync.latency.add(duration);
+    }
+    counter->second.time.notify(duration);
+}
+
+void
+PerfLogImp::rpcBytes(
+    std::string const& method,
+    std::size_t in,
+    std::size_t out)
+{
+    auto counter = counters_.rpc_.find(method);
+    if (counter == counters_.rpc_.end())
+        return;
+
+    {
+        std::lock_guard lock(counter->second.mut);
+        counter->second.sync.bytesIn += in;
+        counter->second.sync.bytesOut += out;
+    }
+    counter->second.size.notify(beast::insight::Event::value_type{out});
 }
 
 void
@@ -438,6 +596,23 @@ PerfLogImp::jobFinish(JobType const type, microseconds dur, int instance)
         counters_.jobs_[instance] = {jtINVALID, steady_time_point()};
 }
 
+void
+PerfLogImp::signaturesVerified(
+    JobType const type,
+    std::size_t count,
+    microseconds dur)
+{
+    auto counter = counters_.jq_.find(type);
+    if (counter == counters_.jq_.end())
+    {
+        assert(false);
+        return;
+    }
+    std::lock_guard lock(counter->second.mut);
+    counter->second.sync.verified += count;
+    counter->second.sync.verifyDuration += dur;
+}
+
 void
 PerfLogImp::resizeJobs(int const resize)
 {
@@ -450,7 +625,7 @@ PerfLogImp::resizeJobs(int const resize)
 void
 PerfLogImp::rotate()
 {
-    if (setup_.perfLog.empty())
+    if (setup_.perfLog.empty() && setup_.traceLog.empty())
         return;
 
     std::lock_guard lock(mutex_);
@@ -458,10 +633,21 @@ PerfLogImp::rotate()
     cond_.notify_one();
 }
 
+void
+PerfLogImp::setCollector(
+    std::shared_ptr<beast::insight::Collector> const& collector)
+{
+    for (auto& [method, rpc] : counters_.rpc_)
+    {
+        rpc.time = collector->make_event(method + ".time");
+        rpc.size = collector->make_event(method + ".size");
+    }
+}
+
 void
 PerfLogImp::onStart()
 {
-    if (setup_.perfLog.size())
+    if (setup_.perfLog.size() || setup_.traceLog.size())
         thread_ = std::thread(&PerfLogImp::run, this);
 }
 
@@ -508,6 +694,19 @@ setup_PerfLog(Section const& section, boost::filesystem::path const& configDir)
     std::uint64_t logInterval;
     if (get_if_exists(section, "log_interval", logInterval))
         setup.logInterval = std::chrono::seconds(logInterval);
+
+    std::string traceLog;
+    set(traceLog, "trace_log", section);
+    if (traceLog.size())
+    {
+        setup.traceLog = boost::filesystem::path(traceLog);
+        if (setup.traceLog.is_relative())
+        {
+            setup.traceLog =
+                boost::filesystem::absolute(setup.traceLog, configDir);
+        }
+    }
+    set(setup.traceSampleRate, "trace_sample_rate", section);
     return setup;
 }
 
@@ -22,11 +22,13 @@
 
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/beast/insight/Event.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <boost/asio/ip/host_name.hpp>
+#include <array>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -42,6 +44,52 @@
 namespace ripple {
 namespace perf {
 
+/**
+ * Counts of durations in buckets which grow exponentially.
+ *
+ * Each power of two microseconds is split into four equal buckets, so a
+ * quantile is known to within 25% whatever the scale, and the histogram
+ * stays small enough to copy while a lock is held.
+ */
+class LatencyHistogram
+{
+    static constexpr std::size_t subBuckets = 4;
+    // The last bucket holds every duration from about 36 minutes up.
+    static constexpr std::size_t bucketCount = 124;
+
+    std::array<std::uint64_t, bucketCount> counts_{};
+    std::uint64_t total_{0};
+
+    static std::size_t
+    bucket(std::uint64_t us);
+
+    static std::uint64_t
+    lowerBound(std::size_t bucket);
+
+public:
+    void
+    add(std::chrono::microseconds dur);
+
+    LatencyHistogram&
+    operator+=(LatencyHistogram const& other);
+
+    std::uint64_t
+    size() const
+    {
+        return total_;
+    }
+
+    /**
+     * The duration that a fraction of the samples do not exceed.
+     *
+     * @param q Fraction between 0 and 1
+     * @return The upper bound of the bucket holding the quantile, or zero
+     *         if there are no samples
+     */
+    std::chrono::microseconds
+    quantile(double q) const;
+};
+
 /**
  * Implementation class for PerfLog.
  */
@@ -70,10 +118,18 @@ class PerfLogImp : public PerfLog, Stoppable
                 std::uint64_t errored{0};
                 // Cumulative duration of all finished and errored method calls.
                 microseconds duration{0};
+                // Distribution of the durations of those calls.
+                LatencyHistogram latency;
+                // Cumulative sizes of requests and replies.
+                std::uint64_t bytesIn{0};
+                std::uint64_t bytesOut{0};
             };
 
             Sync sync;
             mutable std::mutex mut;
+            // Set before any call is logged, so reading them needs no lock.
+            beast::insight::Event time;
+            beast::insight::Event size;
 
             Rpc() = default;
 
@@ -99,6 +155,9 @@ class PerfLogImp : public PerfLog, Stoppable
                 // Cumulative duration of all jobs' queued and running times.
                 microseconds queuedDuration{0};
                 microseconds runningDuration{0};
+                // Signatures verified by the jobs and the time taken.
+                std::uint64_t verified{0};
+                microseconds verifyDuration{0};
             };
 
             Sync sync;
@@ -138,6 +197,7 @@ class PerfLogImp : public PerfLog, Stoppable
     std::function<void()> const signalStop_;
     Counters counters_{ripple::RPC::getHandlerNames(), JobTypes::instance()};
     std::ofstream logFile_;
+    std::ofstream traceFile_;
     std::thread thread_;
     std::mutex mutex_;
     std::condition_variable cond_;
@@ -146,6 +206,8 @@ class PerfLogImp : public PerfLog, Stoppable
     bool stop_{false};
     bool rotate_{false};
 
+    bool
+    openFile(std::ofstream& file, boost::filesystem::path const& path);
     void
     openLog();
     void
@@ -182,6 +244,10 @@ public:
         rpcEnd(method, requestId, false);
     }
 
+    void
+    rpcBytes(std::string const& method, std::size_t in, std::size_t out)
+        override;
+
     void
     jobQueue(JobType const type) override;
     void
@@ -192,6 +258,11 @@ public:
         int instance) override;
     void
     jobFinish(JobType const type, microseconds dur, int instance) override;
+    void
+    signaturesVerified(
+        JobType const type,
+        std::size_t count,
+        microseconds dur) override;
 
     Json::Value
     countersJson() const override
@@ -209,6 +280,9 @@ public:
     resizeJobs(int const resize) override;
     void
     rotate() override;
+    void
+    setCollector(
+        std::shared_ptr<beast::insight::Collector> const& collector) override;
 
     // Stoppable
     void
@@ -34,15 +34,36 @@ sqlBlobLiteral(Blob const& blob)
 {
     std::string j;
 
-    j.reserve(blob.size() * 2 + 3);
-    j.push_back('X');
-    j.push_back('\'');
-    boost::algorithm::hex(blob.begin(), blob.end(), std::back_inserter(j));
-    j.push_back('\'');
+    j.resize(blob.size() * 2 + 3);
+    j.front() = 'X';
+    j[1] = '\'';
+    hexEncode(blob.data(), blob.size(), &j[2]);
+    j.back() = '\'';
 
     return j;
 }
 
+boost::optional<Blob>
+strViewUnHex(boost::string_view const& strSrc)
+{
+    auto const odd = strSrc.size() & 1;
+    Blob out((strSrc.size() + 1) / 2);
+
+    // An odd digit at the start stands for a byte on its own
+    if (odd)
+    {
+        int const c = charUnHex(strSrc.front());
+        if (c < 0)
+            return {};
+        out.front() = static_cast<unsigned char>(c);
+    }
+
+    if (!hexDecode(strSrc.data() + odd, out.size() - odd, out.data() + odd))
+        return {};
+
+    return {std::move(out)};
+}
+
 bool
 parseUrl(parsedURL& pUrl, std::string const& strUrl)
 {
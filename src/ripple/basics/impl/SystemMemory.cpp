@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SystemMemory.h>
+#include <boost/predef.h>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace ripple {
+
+namespace {
+
+// Find a line such as "MemAvailable:   12345678 kB" and return the bytes
+std::optional<std::uint64_t>
+meminfoField(std::string const& text, std::string const& name)
+{
+    auto const key = "\n" + name + ":";
+    auto pos = ("\n" + text).find(key);
+    if (pos == std::string::npos)
+        return {};
+
+    // Skip the key, less the newline which is not really in the text
+    pos = text.find_first_not_of(' ', pos + key.size() - 1);
+    if (pos == std::string::npos)
+        return {};
+
+    std::uint64_t kb = 0;
+    auto const end = text.data() + text.size();
+    if (std::from_chars(text.data() + pos, end, kb).ec != std::errc())
+        return {};
+    return kb * 1024;
+}
+
+}  // namespace
+
+std::optional<SystemMemory>
+parseMeminfo(std::string const& text)
+{
+    auto const total = meminfoField(text, "MemTotal");
+    auto const available = meminfoField(text, "MemAvailable");
+    if (!total || !available)
+        return {};
+    return SystemMemory{*total, *available};
+}
+
+std::optional<SystemMemory>
+getSystemMemory()
+{
+#if BOOST_OS_LINUX
+    std::ifstream file("/proc/meminfo");
+    if (!file)
+        return {};
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return parseMeminfo(ss.str());
+#else
+    return {};
+#endif
+}
+
+}  // namespace ripple
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/ThreadAffinity.h>
+#include <ripple/basics/contract.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/predef.h>
+#include <algorithm>
+#include <charconv>
+
+#if BOOST_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ripple {
+
+namespace {
+
+std::optional<unsigned>
+parseCpu(std::string const& s)
+{
+    unsigned cpu = 0;
+    auto const end = s.data() + s.size();
+    auto const [ptr, ec] = std::from_chars(s.data(), end, cpu);
+    if (s.empty() || ec != std::errc() || ptr != end)
+        return {};
+    return cpu;
+}
+
+}  // namespace
+
+std::optional<CpuSet>
+parseCpuSet(std::string const& list)
+{
+    // An arbitrary limit, to catch typos before they allocate a huge set
+    static constexpr unsigned maxCpu = 4096;
+
+    std::vector<std::string> ranges;
+    boost::split(ranges, list, boost::is_any_of(","));
+
+    CpuSet result;
+    for (auto const& range : ranges)
+    {
+        auto const dash = range.find('-');
+        auto const first = parseCpu(boost::trim_copy(range.substr(0, dash)));
+        auto const last = dash == std::string::npos
+            ? first
+            : parseCpu(boost::trim_copy(range.substr(dash + 1)));
+        if (!first || !last || *first > *last || *last >= maxCpu)
+            return {};
+        for (auto cpu = *first; cpu <= *last; ++cpu)
+            result.push_back(cpu);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+CpuSet
+getCpuSet(Section const& section, std::string const& name)
+{
+    auto const list = section.get<std::string>(name);
+    if (!list)
+        return {};
+
+    auto cpus = parseCpuSet(*list);
+    if (!cpus)
+        Throw<std::runtime_error>(
+            "Invalid processor list for '" + name + "' in [" +
+            section.name() + "]: " + *list);
+    return std::move(*cpus);
+}
+
+bool
+setCurrentThreadAffinity(CpuSet const& cpus)
+{
+    if (cpus.empty())
+        return true;
+
+#if BOOST_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto const cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return true;
+#endif
+}
+
+}  // namespace ripple
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Tracer.h>
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+namespace perf {
+namespace trace {
+
+namespace detail {
+
+std::atomic<std::uint32_t> sampleRate{0};
+
+}  // namespace detail
+
+namespace {
+
+// Enough for a few seconds of spans at a high sample rate
+constexpr std::size_t bufferSize = 4096;
+
+// Event times are reported from when the process started
+clock_type::time_point const epoch = clock_type::now();
+
+struct Buffer
+{
+    explicit Buffer(std::uint32_t thread_) : thread(thread_)
+    {
+    }
+
+    std::uint32_t const thread;
+
+    // Only contended while the spans are being collected
+    std::mutex mutex;
+    std::array<Record, bufferSize> records;
+    std::uint64_t written = 0;
+    std::uint64_t collected = 0;
+    // Set when the thread exits, so the buffer is discarded once empty
+    bool orphaned = false;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    std::uint32_t nextThread = 0;
+};
+
+Registry&
+registry()
+{
+    static Registry r;
+    return r;
+}
+
+// The current thread's buffer, registered on first use
+class ThreadBuffer
+{
+public:
+    ThreadBuffer()
+    {
+        auto& r = registry();
+        std::lock_guard lock(r.mutex);
+        buffer_ = std::make_shared<Buffer>(r.nextThread++);
+        r.buffers.push_back(buffer_);
+    }
+
+    ~ThreadBuffer()
+    {
+        std::lock_guard lock(buffer_->mutex);
+        buffer_->orphaned = true;
+    }
+
+    ThreadBuffer(ThreadBuffer const&) = delete;
+    ThreadBuffer&
+    operator=(ThreadBuffer const&) = delete;
+
+    Buffer&
+    get()
+    {
+        return *buffer_;
+    }
+
+private:
+    std::shared_ptr<Buffer> buffer_;
+};
+
+}  // namespace
+
+void
+detail::record(
+    char const* name,
+    std::uint64_t id,
+    clock_type::time_point start,
+    clock_type::time_point end) noexcept
+{
+    thread_local ThreadBuffer local;
+    auto& b = local.get();
+
+    std::lock_guard lock(b.mutex);
+    b.records[b.written++ % bufferSize] =
+        Record{name, id, start, end - start, b.thread};
+}
+
+std::vector<Record>
+collect()
+{
+    auto& r = registry();
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    {
+        std::lock_guard lock(r.mutex);
+        buffers = r.buffers;
+    }
+
+    std::vector<Record> result;
+    bool discard = false;
+    for (auto const& b : buffers)
+    {
+        std::lock_guard lock(b->mutex);
+        // Spans which were overwritten are lost
+        if (b->written - b->collected > bufferSize)
+            b->collected = b->written - bufferSize;
+        while (b->collected != b->written)
+            result.push_back(b->records[b->collected++ % bufferSize]);
+        discard = discard || b->orphaned;
+    }
+
+    if (discard)
+    {
+        std::lock_guard lock(r.mutex);
+        r.buffers.erase(
+            std::remove_if(
+                r.buffers.begin(),
+                r.buffers.end(),
+                [](std::shared_ptr<Buffer> const& b) {
+                    std::lock_guard lock(b->mutex);
+                    return b->orphaned && b->collected == b->written;
+                }),
+            r.buffers.end());
+    }
+
+    std::sort(
+        result.begin(), result.end(), [](Record const& a, Record const& b) {
+            return a.start < b.start;
+        });
+    return result;
+}
+
+void
+writeEvents(std::ostream& os, std::vector<Record> const& records)
+{
+    using microseconds = std::chrono::duration<double, std::micro>;
+
+    // Each span is written as an asynchronous begin and end event. Events
+    // with the same ID are drawn on one track, whichever thread they ran on.
+    auto const event = [&os](
+                           Record const& rec,
+                           char phase,
+                           clock_type::time_point when) {
+        char buf[256];
+        auto const n = std::snprintf(
+            buf,
+            sizeof(buf),
+            "{\"name\":\"%s\",\"cat\":\"tx\",\"ph\":\"%c\","
+            "\"id\":\"0x%016" PRIx64 "\",\"ts\":%.3f,\"pid\":1,"
+            "\"tid\":%" PRIu32 "},\n",
+            rec.name,
+            phase,
+            rec.id,
+            microseconds(when - epoch).count(),
+            rec.thread);
+        if (n > 0)
+            os.write(buf, std::min<std::size_t>(n, sizeof(buf) - 1));
+    };
+
+    for (auto const& rec : records)
+    {
+        event(rec, 'b', rec.start);
+        event(rec, 'e', rec.start + rec.duration);
+    }
+}
+
+}  // namespace trace
+}  // namespace perf
+}  // namespace ripple
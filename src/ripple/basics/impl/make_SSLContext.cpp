@@ -20,8 +20,12 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/make_SSLContext.h>
+#include <ripple/beast/container/aged_unordered_map.h>
 #include <ripple/beast/container/aged_unordered_set.h>
+#include <chrono>
 #include <cstdint>
+#include <ctime>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 
@@ -88,6 +92,18 @@ struct custom_delete<DH>
     }
 };
 
+template <>
+struct custom_delete<SSL_SESSION>
+{
+    explicit custom_delete() = default;
+
+    void
+    operator()(SSL_SESSION* session) const
+    {
+        SSL_SESSION_free(session);
+    }
+};
+
 template <class T>
 using custom_delete_unique_ptr = std::unique_ptr<T, custom_delete<T>>;
 
@@ -257,6 +273,102 @@ info_handler(SSL const* ssl, int event, int)
 }
 #endif
 
+//------------------------------------------------------------------------------
+
+// How long servers remember the sessions of their clients
+std::chrono::seconds constexpr sessionTimeout{3600};
+
+// Most server sessions remembered by clients
+std::size_t constexpr maxClientSessions = 4096;
+
+// The sessions clients last made with each server, by endpoint
+class ClientSessions
+{
+    using session_ptr = custom_delete_unique_ptr<SSL_SESSION>;
+
+    std::mutex lock_;
+    beast::aged_unordered_map<std::string, session_ptr> sessions_;
+
+public:
+    ClientSessions() : sessions_(ripple::stopwatch())
+    {
+    }
+
+    static ClientSessions&
+    instance()
+    {
+        static ClientSessions sessions;
+        return sessions;
+    }
+
+    // The index of the endpoint a client SSL connects to in its ex data
+    static int
+    endpointIndex()
+    {
+        static int const index = SSL_get_ex_new_index(
+            0,
+            nullptr,
+            nullptr,
+            nullptr,
+            [](void*, void* p, CRYPTO_EX_DATA*, int, long, void*) {
+                delete static_cast<std::string*>(p);
+            });
+        return index;
+    }
+
+    void
+    insert(std::string const& endpoint, SSL_SESSION* session)
+    {
+        std::lock_guard lock(lock_);
+        auto const iter = sessions_.find(endpoint);
+        if (iter != sessions_.end())
+        {
+            iter->second.reset(session);
+            sessions_.touch(iter);
+            return;
+        }
+        if (sessions_.size() >= maxClientSessions)
+            sessions_.erase(sessions_.chronological.begin());
+        sessions_.emplace(endpoint, session_ptr(session));
+    }
+
+    void
+    resume(SSL* ssl, std::string const& endpoint)
+    {
+        std::lock_guard lock(lock_);
+        auto const iter = sessions_.find(endpoint);
+        if (iter == sessions_.end())
+            return;
+
+        auto const session = iter->second.get();
+        auto const expires =
+            SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+        if (expires <= std::time(nullptr))
+        {
+            sessions_.erase(iter);
+            return;
+        }
+        SSL_set_session(ssl, session);
+    }
+};
+
+// Called by OpenSSL with each session a connection makes. Clients which
+// called resumeSSLSession keep the session for their next connection.
+static int
+onNewSession(SSL* ssl, SSL_SESSION* session)
+{
+    auto const endpoint = static_cast<std::string const*>(
+        SSL_get_ex_data(ssl, ClientSessions::endpointIndex()));
+    if (!endpoint)
+        return 0;
+
+    // Returning 1 gives the cache the reference to the session
+    ClientSessions::instance().insert(*endpoint, session);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+
 static std::string
 error_message(std::string const& what, boost::system::error_code const& ec)
 {
@@ -439,6 +551,18 @@ get_context(std::string const& cipherList)
     SSL_CTX_set_info_callback(c->native_handle(), info_handler);
 #endif
 
+    // Let clients which reconnect resume their sessions, with a ticket or
+    // from the server's cache, rather than repeat the key exchange.
+    {
+        SSL_CTX* const ctx = c->native_handle();
+        unsigned char const sessionContext[] = "rippled";
+        SSL_CTX_set_session_id_context(
+            ctx, sessionContext, sizeof(sessionContext) - 1);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH);
+        SSL_CTX_set_timeout(ctx, sessionTimeout.count());
+        SSL_CTX_sess_set_new_cb(ctx, onNewSession);
+    }
+
     return c;
 }
 
@@ -469,4 +593,13 @@ make_SSLContextAuthed(
     return context;
 }
 
+void
+resumeSSLSession(SSL* ssl, std::string const& endpoint)
+{
+    using openssl::detail::ClientSessions;
+    SSL_set_ex_data(
+        ssl, ClientSessions::endpointIndex(), new std::string(endpoint));
+    ClientSessions::instance().resume(ssl, endpoint);
+}
+
 }  // namespace ripple
@@ -28,10 +28,14 @@ namespace ripple {
 std::pair<bool, std::uint64_t>
 mulDiv(std::uint64_t value, std::uint64_t mul, std::uint64_t div)
 {
+#ifdef __SIZEOF_INT128__
+    auto result = static_cast<unsigned __int128>(value) * mul;
+#else
     using namespace boost::multiprecision;
 
     uint128_t result;
     result = multiply(result, value, mul);
+#endif
 
     result /= div;
 
@@ -20,6 +20,11 @@
 #include <ripple/basics/strHex.h>
 #include <array>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RIPPLE_HEX_SIMD 1
+#include <immintrin.h>
+#endif
+
 namespace ripple {
 
 int
@@ -46,4 +51,236 @@ charUnHex(unsigned char c)
     return xtab[c];
 }
 
+namespace {
+
+char const upperDigits[] = "0123456789ABCDEF";
+
+// Scalar versions, for the bytes left over and processors without vectors
+void
+encodeScalar(std::uint8_t const* in, std::size_t size, char* out)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        *out++ = upperDigits[in[i] >> 4];
+        *out++ = upperDigits[in[i] & 0xF];
+    }
+}
+
+bool
+decodeScalar(char const* in, std::size_t size, std::uint8_t* out)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto const hi = charUnHex(in[2 * i]);
+        auto const lo = charUnHex(in[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+            return false;
+        out[i] = static_cast<std::uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+#ifdef RIPPLE_HEX_SIMD
+
+bool
+hasSSSE3()
+{
+    static bool const ssse3 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") != 0;
+    }();
+    return ssse3;
+}
+
+bool
+hasAVX2()
+{
+    static bool const avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+}
+
+// Each nibble indexes a table of the digits with a byte shuffle. The high
+// and low digits of each byte are then interleaved.
+
+__attribute__((target("ssse3"))) std::size_t
+encodeSSSE3(std::uint8_t const* in, std::size_t size, char* out)
+{
+    auto const digits = _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(upperDigits));
+    auto const mask = _mm_set1_epi8(0x0F);
+
+    std::size_t done = 0;
+    for (; size - done >= 16; done += 16)
+    {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + done));
+        auto const hi = _mm_shuffle_epi8(
+            digits, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        auto const lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, mask));
+        auto const dst = reinterpret_cast<__m128i*>(out + 2 * done);
+        _mm_storeu_si128(dst, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(hi, lo));
+    }
+    return done;
+}
+
+__attribute__((target("avx2"))) std::size_t
+encodeAVX2(std::uint8_t const* in, std::size_t size, char* out)
+{
+    auto const digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(upperDigits)));
+    auto const mask = _mm256_set1_epi8(0x0F);
+
+    std::size_t done = 0;
+    for (; size - done >= 32; done += 32)
+    {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + done));
+        auto const hi = _mm256_shuffle_epi8(
+            digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        auto const lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, mask));
+
+        // Unpacking works within each 128 bit half, so the halves of the
+        // results are put back in order
+        auto const a = _mm256_unpacklo_epi8(hi, lo);
+        auto const b = _mm256_unpackhi_epi8(hi, lo);
+        auto const dst = reinterpret_cast<__m256i*>(out + 2 * done);
+        _mm256_storeu_si256(dst, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return done;
+}
+
+// Turn 16 hex digits into their values, clearing `valid` if any is not a
+// digit. Comparisons are unsigned, by saturating subtraction.
+__attribute__((target("ssse3"))) __m128i
+digitValues(__m128i c, __m128i& valid)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    auto const isDigit =
+        _mm_cmpeq_epi8(_mm_subs_epu8(d, _mm_set1_epi8(9)), zero);
+    auto const l = _mm_sub_epi8(
+        _mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    auto const isLetter =
+        _mm_cmpeq_epi8(_mm_subs_epu8(l, _mm_set1_epi8(5)), zero);
+    valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isLetter));
+    return _mm_or_si128(
+        _mm_and_si128(isDigit, d),
+        _mm_andnot_si128(isDigit, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3"))) std::size_t
+decodeSSSE3(char const* in, std::size_t size, std::uint8_t* out, bool& ok)
+{
+    // Each pair of values becomes 16 * high + low
+    auto const weights = _mm_set1_epi16(0x0110);
+    auto valid = _mm_set1_epi8(-1);
+
+    std::size_t done = 0;
+    for (; size - done >= 16; done += 16)
+    {
+        auto const src = reinterpret_cast<__m128i const*>(in + 2 * done);
+        auto const v0 = digitValues(_mm_loadu_si128(src), valid);
+        auto const v1 = digitValues(_mm_loadu_si128(src + 1), valid);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out + done),
+            _mm_packus_epi16(
+                _mm_maddubs_epi16(v0, weights),
+                _mm_maddubs_epi16(v1, weights)));
+    }
+    ok = _mm_movemask_epi8(valid) == 0xFFFF;
+    return done;
+}
+
+__attribute__((target("avx2"))) __m256i
+digitValues(__m256i c, __m256i& valid)
+{
+    auto const zero = _mm256_setzero_si256();
+    auto const d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    auto const isDigit =
+        _mm256_cmpeq_epi8(_mm256_subs_epu8(d, _mm256_set1_epi8(9)), zero);
+    auto const l = _mm256_sub_epi8(
+        _mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    auto const isLetter =
+        _mm256_cmpeq_epi8(_mm256_subs_epu8(l, _mm256_set1_epi8(5)), zero);
+    valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isLetter));
+    return _mm256_or_si256(
+        _mm256_and_si256(isDigit, d),
+        _mm256_andnot_si256(
+            isDigit, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2"))) std::size_t
+decodeAVX2(char const* in, std::size_t size, std::uint8_t* out, bool& ok)
+{
+    auto const weights = _mm256_set1_epi16(0x0110);
+    auto valid = _mm256_set1_epi8(-1);
+
+    std::size_t done = 0;
+    for (; size - done >= 32; done += 32)
+    {
+        auto const src = reinterpret_cast<__m256i const*>(in + 2 * done);
+        auto const v0 = digitValues(_mm256_loadu_si256(src), valid);
+        auto const v1 = digitValues(_mm256_loadu_si256(src + 1), valid);
+
+        // Packing works within each 128 bit half, as above
+        auto const packed = _mm256_packus_epi16(
+            _mm256_maddubs_epi16(v0, weights),
+            _mm256_maddubs_epi16(v1, weights));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + done),
+            _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    ok = _mm256_movemask_epi8(valid) == -1;
+    return done;
+}
+
+#endif
+
+}  // namespace
+
+void
+hexEncode(void const* data, std::size_t size, char* out)
+{
+    auto const in = static_cast<std::uint8_t const*>(data);
+    std::size_t done = 0;
+
+#ifdef RIPPLE_HEX_SIMD
+    if (hasAVX2())
+        done = encodeAVX2(in, size, out);
+    if (hasSSSE3())
+        done += encodeSSSE3(in + done, size - done, out + 2 * done);
+#endif
+
+    encodeScalar(in + done, size - done, out + 2 * done);
+}
+
+bool
+hexDecode(char const* in, std::size_t size, std::uint8_t* out)
+{
+    std::size_t done = 0;
+
+#ifdef RIPPLE_HEX_SIMD
+    bool ok = true;
+    if (hasAVX2())
+    {
+        done = decodeAVX2(in, size, out, ok);
+        if (!ok)
+            return false;
+    }
+    if (hasSSSE3())
+    {
+        done += decodeSSSE3(in + 2 * done, size - done, out + done, ok);
+        if (!ok)
+            return false;
+    }
+#endif
+
+    return decodeScalar(in + 2 * done, size - done, out + done);
+}
+
 }  // namespace ripple
@@ -37,6 +37,20 @@ make_SSLContextAuthed(
     std::string const& chainFile,
     std::string const& cipherList);
 
+/** Offer a server the TLS session last made with it, if any.
+
+    Call on a client connection before its handshake. If the server still
+    has the session, the handshake skips the key exchange. The session the
+    connection makes is remembered in turn for the next connection to the
+    same endpoint, whether or not one was resumed.
+
+    @param ssl The connection, from a context made by one of the functions
+               above.
+    @param endpoint Identifies the server, such as its address and port.
+*/
+void
+resumeSSLSession(SSL* ssl, std::string const& endpoint);
+
 }  // namespace ripple
 
 #endif
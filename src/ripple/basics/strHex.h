@@ -22,6 +22,10 @@
 
 #include <boost/algorithm/hex.hpp>
 #include <boost/endian/conversion.hpp>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <type_traits>
 
 namespace ripple {
 
@@ -40,6 +44,50 @@ charUnHex(char c)
 }
 /** @} */
 
+/** Write bytes as upper case hex digits.
+
+    Uses vector instructions where the processor has them.
+
+    @param data The bytes to write.
+    @param size The number of bytes.
+    @param out Where to write the 2 * size digits.
+*/
+void
+hexEncode(void const* data, std::size_t size, char* out);
+
+/** Read pairs of hex digits, in either case, as bytes.
+
+    @param in The 2 * size digits to read.
+    @param size The number of bytes to write.
+    @param out Where to write the bytes. If the digits are not all
+        valid, what is written is unspecified.
+    @return true if every character was a hex digit.
+*/
+[[nodiscard]] bool
+hexDecode(char const* in, std::size_t size, std::uint8_t* out);
+
+namespace detail {
+
+// Whether T holds its bytes in one block given by data() and size()
+template <class T, class = void>
+struct isContiguousBytes : std::false_type
+{
+};
+
+template <class T>
+struct isContiguousBytes<
+    T,
+    std::void_t<
+        decltype(std::declval<T const&>().data()),
+        decltype(std::declval<T const&>().size())>>
+    : std::bool_constant<
+          std::is_pointer_v<decltype(std::declval<T const&>().data())> &&
+          sizeof(*std::declval<T const&>().data()) == 1>
+{
+};
+
+}  // namespace detail
+
 template <class FwdIt>
 std::string
 strHex(FwdIt begin, FwdIt end)
@@ -50,8 +98,16 @@ strHex(FwdIt begin, FwdIt end)
             std::forward_iterator_tag>::value,
         "FwdIt must be a forward iterator");
     std::string result;
-    result.reserve(2 * std::distance(begin, end));
-    boost::algorithm::hex(begin, end, std::back_inserter(result));
+    if constexpr (std::is_pointer_v<FwdIt> && sizeof(*begin) == 1)
+    {
+        result.resize(2 * (end - begin));
+        hexEncode(begin, end - begin, result.data());
+    }
+    else
+    {
+        result.reserve(2 * std::distance(begin, end));
+        boost::algorithm::hex(begin, end, std::back_inserter(result));
+    }
     return result;
 }
 
@@ -59,7 +115,16 @@ template <class T, class = decltype(std::declval<T>().begin())>
 std::string
 strHex(T const& from)
 {
-    return strHex(from.begin(), from.end());
+    if constexpr (detail::isContiguousBytes<T>::value)
+    {
+        std::string result(2 * from.size(), '\0');
+        hexEncode(from.data(), from.size(), result.data());
+        return result;
+    }
+    else
+    {
+        return strHex(from.begin(), from.end());
+    }
 }
 
 }  // namespace ripple
@@ -2311,6 +2311,48 @@ expire(
     return n;
 }
 
+/** Expire at most `limit` of the aged container items past the specified age.
+
+    Items expire oldest first. When this is called as each item is added,
+    with a limit greater than one, expiry keeps pace with the additions
+    while the time taken by any one call stays bounded, so a container
+    which has been idle is never swept all at once.
+*/
+template <
+    bool IsMulti,
+    bool IsMap,
+    class Key,
+    class T,
+    class Clock,
+    class Compare,
+    class Allocator,
+    class Rep,
+    class Period>
+std::size_t
+expire(
+    detail::aged_ordered_container<
+        IsMulti,
+        IsMap,
+        Key,
+        T,
+        Clock,
+        Compare,
+        Allocator>& c,
+    std::chrono::duration<Rep, Period> const& age,
+    std::size_t limit)
+{
+    std::size_t n(0);
+    auto const expired(c.clock().now() - age);
+    for (auto iter(c.chronological.cbegin());
+         n < limit && iter != c.chronological.cend() &&
+         iter.when() <= expired;)
+    {
+        iter = c.erase(iter);
+        ++n;
+    }
+    return n;
+}
+
 }  // namespace beast
 
 #endif
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+
+#include <ripple/beast/insight/HistogramImpl.h>
+
+#include <date/date.h>
+
+#include <chrono>
+#include <memory>
+
+namespace beast {
+namespace insight {
+
+/** A metric for reporting the distribution of event timings.
+
+    Like an Event, a histogram is notified of the time each event took.
+    Rather than reporting every sample, it keeps a count of the samples
+    in buckets, and at each collection interval reports the number of
+    samples and their percentiles, in microseconds. Notifying is cheap
+    enough to do for every event, so the tail of the distribution is not
+    lost to sampling.
+
+    This is a lightweight reference wrapper which is cheap to copy and assign.
+    When the last reference goes away, the metric is no longer collected.
+*/
+class Histogram final
+{
+public:
+    using value_type = HistogramImpl::value_type;
+
+    /** Create a null metric.
+        A null metric reports no information.
+    */
+    Histogram()
+    {
+    }
+
+    /** Create the metric reference the specified implementation.
+        Normally this won't be called directly. Instead, call the appropriate
+        factory function in the Collector interface.
+        @see Collector.
+    */
+    explicit Histogram(std::shared_ptr<HistogramImpl> const& impl)
+        : m_impl(impl)
+    {
+    }
+
+    /** Add the time taken by an event. */
+    template <class Rep, class Period>
+    void
+    notify(std::chrono::duration<Rep, Period> const& value) const
+    {
+        if (m_impl)
+            m_impl->notify(date::ceil<value_type>(value));
+    }
+
+    std::shared_ptr<HistogramImpl> const&
+    impl() const
+    {
+        return m_impl;
+    }
+
+private:
+    std::shared_ptr<HistogramImpl> m_impl;
+};
+
+}  // namespace insight
+}  // namespace beast
+
+#endif
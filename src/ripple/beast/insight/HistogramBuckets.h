@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_HISTOGRAMBUCKETS_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAMBUCKETS_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace beast {
+namespace insight {
+
+/** Counts of values in log-linear buckets, for a Histogram.
+
+    Values below 4 each have their own bucket. Above that, each power of
+    two is split into four buckets of equal width, so a bucket is never
+    wider than a quarter of the values in it. Values of 2^40 and over,
+    which are about twelve days in microseconds, share the last bucket.
+
+    Inserting is a single relaxed atomic increment, and may be done from
+    any number of threads while another collects the counts.
+*/
+class HistogramBuckets
+{
+public:
+    static constexpr std::size_t subBuckets = 4;
+    static constexpr std::size_t maxExponent = 40;
+    static constexpr std::size_t size =
+        subBuckets + (maxExponent - 2) * subBuckets;
+
+    using Counts = std::array<std::uint64_t, size>;
+
+    /** The bucket holding a value */
+    static std::size_t
+    bucket(std::uint64_t value)
+    {
+        if (value < subBuckets)
+            return static_cast<std::size_t>(value);
+        std::size_t exponent = 63;
+        while ((value >> exponent) == 0)
+            --exponent;
+        if (exponent >= maxExponent)
+            return size - 1;
+        auto const sub = (value >> (exponent - 2)) & (subBuckets - 1);
+        return subBuckets + (exponent - 2) * subBuckets + sub;
+    }
+
+    /** The largest value held by a bucket */
+    static std::uint64_t
+    highest(std::size_t b)
+    {
+        if (b < subBuckets)
+            return b;
+        auto const exponent = (b - subBuckets) / subBuckets + 2;
+        auto const sub = (b - subBuckets) % subBuckets;
+        auto const width = std::uint64_t{1} << (exponent - 2);
+        return (subBuckets + sub) * width + width - 1;
+    }
+
+    void
+    insert(std::uint64_t value)
+    {
+        counts_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Return the counts since the last call, and reset them */
+    Counts
+    collect()
+    {
+        Counts result;
+        for (std::size_t i = 0; i < size; ++i)
+            result[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+        return result;
+    }
+
+    /** The number of values counted */
+    static std::uint64_t
+    total(Counts const& counts)
+    {
+        std::uint64_t n = 0;
+        for (auto const c : counts)
+            n += c;
+        return n;
+    }
+
+    /** The value below which a fraction `p` of the values fall
+
+        The result is the largest value of the bucket the percentile falls
+        in, so it is never less than the exact percentile.
+    */
+    static std::uint64_t
+    percentile(Counts const& counts, std::uint64_t total, double p)
+    {
+        if (total == 0)
+            return 0;
+        auto const rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(p * total)));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return highest(i);
+        }
+        return highest(size - 1);
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, size> counts_{};
+};
+
+}  // namespace insight
+}  // namespace beast
+
+#endif
@@ -29,6 +29,8 @@
 #include <ripple/beast/insight/GaugeImpl.h>
 #include <ripple/beast/insight/Group.h>
 #include <ripple/beast/insight/Groups.h>
+#include <ripple/beast/insight/Histogram.h>
+#include <ripple/beast/insight/HistogramImpl.h>
 #include <ripple/beast/insight/Hook.h>
 #include <ripple/beast/insight/HookImpl.h>
 #include <ripple/beast/insight/NullCollector.h>
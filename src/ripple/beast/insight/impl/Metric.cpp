@@ -20,6 +20,7 @@
 #include <ripple/beast/insight/CounterImpl.h>
 #include <ripple/beast/insight/EventImpl.h>
 #include <ripple/beast/insight/GaugeImpl.h>
+#include <ripple/beast/insight/HistogramImpl.h>
 #include <ripple/beast/insight/MeterImpl.h>
 
 namespace beast {
@@ -31,6 +32,8 @@ EventImpl::~EventImpl() = default;
 
 GaugeImpl::~GaugeImpl() = default;
 
+HistogramImpl::~HistogramImpl() = default;
+
 MeterImpl::~MeterImpl() = default;
 }  // namespace insight
 }  // namespace beast
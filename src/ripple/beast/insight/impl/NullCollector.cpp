@@ -69,6 +69,23 @@ private:
 
 //------------------------------------------------------------------------------
 
+class NullHistogramImpl : public HistogramImpl
+{
+public:
+    explicit NullHistogramImpl() = default;
+
+    void
+    notify(value_type const&) override
+    {
+    }
+
+private:
+    NullHistogramImpl&
+    operator=(NullHistogramImpl const&);
+};
+
+//------------------------------------------------------------------------------
+
 class NullGaugeImpl : public GaugeImpl
 {
 public:
@@ -137,6 +154,12 @@ public:
         return Gauge(std::make_shared<detail::NullGaugeImpl>());
     }
 
+    Histogram
+    make_histogram(std::string const&) override
+    {
+        return Histogram(std::make_shared<detail::NullHistogramImpl>());
+    }
+
     Meter
     make_meter(std::string const&) override
     {
@@ -21,19 +21,22 @@
 #include <ripple/beast/insight/CounterImpl.h>
 #include <ripple/beast/insight/EventImpl.h>
 #include <ripple/beast/insight/GaugeImpl.h>
+#include <ripple/beast/insight/HistogramBuckets.h>
+#include <ripple/beast/insight/HistogramImpl.h>
 #include <ripple/beast/insight/HookImpl.h>
 #include <ripple/beast/insight/MeterImpl.h>
 #include <ripple/beast/insight/StatsDCollector.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/optional.hpp>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
-#include <sstream>
 #include <thread>
 
 #ifndef BEAST_STATSDCOLLECTOR_TRACING_ENABLED
@@ -100,8 +103,6 @@ public:
     void
     flush();
     void
-    do_increment(CounterImpl::value_type amount);
-    void
     do_process() override;
 
 private:
@@ -110,8 +111,7 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
-    CounterImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<CounterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -160,10 +160,6 @@ public:
     void
     flush();
     void
-    do_set(GaugeImpl::value_type value);
-    void
-    do_increment(GaugeImpl::difference_type amount);
-    void
     do_process() override;
 
 private:
@@ -172,9 +168,37 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
+    // Only used by the collector's thread
     GaugeImpl::value_type m_last_value;
-    GaugeImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<GaugeImpl::value_type> m_value;
+};
+
+//------------------------------------------------------------------------------
+
+class StatsDHistogramImpl : public HistogramImpl, public StatsDMetricBase
+{
+public:
+    StatsDHistogramImpl(
+        std::string const& name,
+        std::shared_ptr<StatsDCollectorImp> const& impl);
+
+    ~StatsDHistogramImpl() override;
+
+    void
+    notify(HistogramImpl::value_type const& value) override;
+
+    void
+    flush();
+    void
+    do_process() override;
+
+private:
+    StatsDHistogramImpl&
+    operator=(StatsDHistogramImpl const&);
+
+    std::shared_ptr<StatsDCollectorImp> m_impl;
+    std::string m_name;
+    HistogramBuckets m_buckets;
 };
 
 //------------------------------------------------------------------------------
@@ -194,8 +218,6 @@ public:
     void
     flush();
     void
-    do_increment(MeterImpl::value_type amount);
-    void
     do_process() override;
 
 private:
@@ -204,8 +226,7 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
-    MeterImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<MeterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -228,6 +249,7 @@ private:
     boost::asio::io_service::strand m_strand;
     boost::asio::basic_waitable_timer<std::chrono::steady_clock> m_timer;
     boost::asio::ip::udp::socket m_socket;
+    // Metrics waiting to be sent, packed into datagrams
     std::deque<std::string> m_data;
     std::recursive_mutex metricsLock_;
     List<StatsDMetricBase> metrics_;
@@ -294,6 +316,13 @@ public:
             name, shared_from_this()));
     }
 
+    Histogram
+    make_histogram(std::string const& name) override
+    {
+        return Histogram(std::make_shared<detail::StatsDHistogramImpl>(
+            name, shared_from_this()));
+    }
+
     Meter
     make_meter(std::string const& name) override
     {
@@ -334,7 +363,33 @@ public:
     void
     do_post_buffer(std::string const& buffer)
     {
-        m_data.emplace_back(buffer);
+        // Append to the last datagram unless it would become too large
+        if (m_data.empty() ||
+            m_data.back().size() + buffer.size() > max_packet_size)
+        {
+            m_data.emplace_back();
+            m_data.back().reserve(max_packet_size);
+        }
+        m_data.back() += buffer;
+    }
+
+    /** Format one metric in the StatsD line protocol */
+    template <class Value>
+    std::string
+    format(std::string const& name, Value value, char const* type) const
+    {
+        auto const v = std::to_string(value);
+        std::string line;
+        line.reserve(m_prefix.size() + name.size() + v.size() + 6);
+        line += m_prefix;
+        line += '.';
+        line += name;
+        line += ':';
+        line += v;
+        line += '|';
+        line += type;
+        line += '\n';
+        return line;
     }
 
     void
@@ -379,50 +434,23 @@ public:
 #endif
     }
 
-    // Send what we have
+    // Send what we have, one datagram per packed buffer
     void
     send_buffers()
     {
         if (m_data.empty())
             return;
 
-        // Break up the array of strings into blocks
-        // that each fit into one UDP packet.
-        //
-        std::vector<boost::asio::const_buffer> buffers;
-        buffers.reserve(m_data.size());
-        std::size_t size(0);
-
         auto keepAlive =
             std::make_shared<std::deque<std::string>>(std::move(m_data));
         m_data.clear();
 
         for (auto const& s : *keepAlive)
         {
-            std::size_t const length(s.size());
             assert(!s.empty());
-            if (!buffers.empty() && (size + length) > max_packet_size)
-            {
-                log(buffers);
-                m_socket.async_send(
-                    buffers,
-                    std::bind(
-                        &StatsDCollectorImp::on_send,
-                        this,
-                        keepAlive,
-                        std::placeholders::_1,
-                        std::placeholders::_2));
-                buffers.clear();
-                size = 0;
-            }
-
-            buffers.emplace_back(&s[0], length);
-            size += length;
-        }
-
-        if (!buffers.empty())
-        {
-            log(buffers);
+            std::array<boost::asio::const_buffer, 1> const buffers{
+                {boost::asio::const_buffer(s.data(), s.size())}};
+            log({buffers.begin(), buffers.end()});
             m_socket.async_send(
                 buffers,
                 std::bind(
@@ -516,7 +544,7 @@ StatsDHookImpl::do_process()
 StatsDCounterImpl::StatsDCounterImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -529,31 +557,14 @@ StatsDCounterImpl::~StatsDCounterImpl()
 void
 StatsDCounterImpl::increment(CounterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDCounterImpl::do_increment,
-        std::static_pointer_cast<StatsDCounterImpl>(shared_from_this()),
-        amount));
+    m_value.fetch_add(amount, std::memory_order_relaxed);
 }
 
 void
 StatsDCounterImpl::flush()
 {
-    if (m_dirty)
-    {
-        m_dirty = false;
-        std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|c"
-           << "\n";
-        m_value = 0;
-        m_impl->post_buffer(ss.str());
-    }
-}
-
-void
-StatsDCounterImpl::do_increment(CounterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
+    if (auto const value = m_value.exchange(0, std::memory_order_relaxed))
+        m_impl->post_buffer(m_impl->format(m_name, value, "c"));
 }
 
 void
@@ -583,10 +594,7 @@ StatsDEventImpl::notify(EventImpl::value_type const& value)
 void
 StatsDEventImpl::do_notify(EventImpl::value_type const& value)
 {
-    std::stringstream ss;
-    ss << m_impl->prefix() << "." << m_name << ":" << value.count() << "|ms"
-       << "\n";
-    m_impl->post_buffer(ss.str());
+    m_impl->post_buffer(m_impl->format(m_name, value.count(), "ms"));
 }
 
 //------------------------------------------------------------------------------
@@ -594,7 +602,7 @@ StatsDEventImpl::do_notify(EventImpl::value_type const& value)
 StatsDGaugeImpl::StatsDGaugeImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_last_value(0), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_last_value(0), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -607,72 +615,97 @@ StatsDGaugeImpl::~StatsDGaugeImpl()
 void
 StatsDGaugeImpl::set(GaugeImpl::value_type value)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDGaugeImpl::do_set,
-        std::static_pointer_cast<StatsDGaugeImpl>(shared_from_this()),
-        value));
+    m_value.store(value, std::memory_order_relaxed);
 }
 
 void
 StatsDGaugeImpl::increment(GaugeImpl::difference_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDGaugeImpl::do_increment,
-        std::static_pointer_cast<StatsDGaugeImpl>(shared_from_this()),
-        amount));
+    GaugeImpl::value_type value = m_value.load(std::memory_order_relaxed);
+    GaugeImpl::value_type next;
+    do
+    {
+        next = value;
+        if (amount > 0)
+        {
+            GaugeImpl::value_type const d(
+                static_cast<GaugeImpl::value_type>(amount));
+            next +=
+                (d >= std::numeric_limits<GaugeImpl::value_type>::max() - value)
+                ? std::numeric_limits<GaugeImpl::value_type>::max() - value
+                : d;
+        }
+        else if (amount < 0)
+        {
+            GaugeImpl::value_type const d(
+                static_cast<GaugeImpl::value_type>(-amount));
+            next = (d >= value) ? 0 : value - d;
+        }
+    } while (!m_value.compare_exchange_weak(
+        value, next, std::memory_order_relaxed));
 }
 
 void
 StatsDGaugeImpl::flush()
 {
-    if (m_dirty)
+    auto const value = m_value.load(std::memory_order_relaxed);
+    if (value != m_last_value)
     {
-        m_dirty = false;
-        std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|g"
-           << "\n";
-        m_impl->post_buffer(ss.str());
+        m_last_value = value;
+        m_impl->post_buffer(m_impl->format(m_name, value, "g"));
     }
 }
 
 void
-StatsDGaugeImpl::do_set(GaugeImpl::value_type value)
+StatsDGaugeImpl::do_process()
 {
-    m_value = value;
+    flush();
+}
 
-    if (m_value != m_last_value)
-    {
-        m_last_value = m_value;
-        m_dirty = true;
-    }
+//------------------------------------------------------------------------------
+
+StatsDHistogramImpl::StatsDHistogramImpl(
+    std::string const& name,
+    std::shared_ptr<StatsDCollectorImp> const& impl)
+    : m_impl(impl), m_name(name)
+{
+    m_impl->add(*this);
 }
 
-void
-StatsDGaugeImpl::do_increment(GaugeImpl::difference_type amount)
+StatsDHistogramImpl::~StatsDHistogramImpl()
 {
-    GaugeImpl::value_type value(m_value);
+    m_impl->remove(*this);
+}
 
-    if (amount > 0)
-    {
-        GaugeImpl::value_type const d(
-            static_cast<GaugeImpl::value_type>(amount));
-        value +=
-            (d >= std::numeric_limits<GaugeImpl::value_type>::max() - m_value)
-            ? std::numeric_limits<GaugeImpl::value_type>::max() - m_value
-            : d;
-    }
-    else if (amount < 0)
-    {
-        GaugeImpl::value_type const d(
-            static_cast<GaugeImpl::value_type>(-amount));
-        value = (d >= value) ? 0 : value - d;
-    }
+void
+StatsDHistogramImpl::notify(HistogramImpl::value_type const& value)
+{
+    m_buckets.insert(value.count() > 0 ? value.count() : 0);
+}
 
-    do_set(value);
+void
+StatsDHistogramImpl::flush()
+{
+    auto const counts = m_buckets.collect();
+    auto const total = HistogramBuckets::total(counts);
+    if (total == 0)
+        return;
+
+    auto const gauge = [&](char const* suffix, double p) {
+        m_impl->post_buffer(m_impl->format(
+            m_name + suffix,
+            HistogramBuckets::percentile(counts, total, p),
+            "g"));
+    };
+    m_impl->post_buffer(m_impl->format(m_name + ".count", total, "c"));
+    gauge(".p50", 0.50);
+    gauge(".p90", 0.90);
+    gauge(".p99", 0.99);
+    gauge(".max", 1.0);
 }
 
 void
-StatsDGaugeImpl::do_process()
+StatsDHistogramImpl::do_process()
 {
     flush();
 }
@@ -682,7 +715,7 @@ StatsDGaugeImpl::do_process()
 StatsDMeterImpl::StatsDMeterImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -695,31 +728,14 @@ StatsDMeterImpl::~StatsDMeterImpl()
 void
 StatsDMeterImpl::increment(MeterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDMeterImpl::do_increment,
-        std::static_pointer_cast<StatsDMeterImpl>(shared_from_this()),
-        amount));
+    m_value.fetch_add(amount, std::memory_order_relaxed);
 }
 
 void
 StatsDMeterImpl::flush()
 {
-    if (m_dirty)
-    {
-        m_dirty = false;
-        std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|m"
-           << "\n";
-        m_value = 0;
-        m_impl->post_buffer(ss.str());
-    }
-}
-
-void
-StatsDMeterImpl::do_increment(MeterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
+    if (auto const value = m_value.exchange(0, std::memory_order_relaxed))
+        m_impl->post_buffer(m_impl->format(m_name, value, "m"));
 }
 
 void
@@ -19,6 +19,7 @@
 
 #include <ripple/basics/Log.h>
 #include <ripple/consensus/Consensus.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -159,4 +160,38 @@ checkConsensus(
     return ConsensusState::No;
 }
 
+bool
+checkEarlyConsensus(
+    std::size_t prevProposers,
+    std::size_t currentProposers,
+    std::size_t currentAgree,
+    ConsensusParms const& parms,
+    bool proposing,
+    beast::Journal j)
+{
+    if (parms.ledgerEARLY_CONSENSUS_PCT == 0)
+        return false;
+
+    // With no proposers last round there is nothing to tell us how many
+    // to wait for
+    if (prevProposers == 0)
+        return false;
+
+    std::size_t total = std::max(prevProposers, currentProposers);
+    if (proposing)
+    {
+        ++currentAgree;
+        ++total;
+    }
+
+    auto const needed =
+        std::max(parms.ledgerEARLY_CONSENSUS_PCT, parms.minCONSENSUS_PCT);
+    if (currentAgree * 100 < total * needed)
+        return false;
+
+    JLOG(j.debug()) << "early consensus: agree=" << currentAgree << "/"
+                    << total;
+    return true;
+}
+
 }  // namespace ripple
@@ -30,6 +30,7 @@
 #include <ripple/consensus/LedgerTiming.h>
 #include <ripple/json/json_writer.h>
 #include <boost/logic/tribool.hpp>
+#include <algorithm>
 #include <sstream>
 
 namespace ripple {
@@ -91,6 +92,28 @@ checkConsensus(
     bool proposing,
     beast::Journal j);
 
+/** Determine whether consensus may be declared before ledgerMIN_CONSENSUS.
+
+    This is only allowed if ledgerEARLY_CONSENSUS_PCT is set and at least
+    that percentage of the last round's proposers, or of this round's if
+    there are more, already agree with us.
+
+    @param prevProposers proposers in the last closing (not including us)
+    @param currentProposers proposers in this closing so far (not including us)
+    @param currentAgree proposers who agree with us
+    @param parms            Consensus constant parameters
+    @param proposing        whether we should count ourselves
+    @param j                journal for logging
+*/
+bool
+checkEarlyConsensus(
+    std::size_t prevProposers,
+    std::size_t currentProposers,
+    std::size_t currentAgree,
+    ConsensusParms const& parms,
+    bool proposing,
+    beast::Journal j);
+
 /** Generic implementation of consensus algorithm.
 
   Achieves consensus on the next ledger.
@@ -518,6 +541,11 @@ private:
     bool
     haveConsensus();
 
+    // Whether enough peers already share our position to end the round
+    // before ledgerMIN_CONSENSUS.
+    bool
+    haveEarlyConsensus() const;
+
     // Create disputes between our position and the provided one.
     void
     createDisputes(TxSet_t const& o);
@@ -1267,8 +1295,10 @@ Consensus<Adaptor>::phaseEstablish()
     convergePercent_ = result_->roundTime.read() * 100 /
         std::max<milliseconds>(prevRoundTime_, parms.avMIN_CONSENSUS_TIME);
 
-    // Give everyone a chance to take an initial position
-    if (result_->roundTime.read() < parms.ledgerMIN_CONSENSUS)
+    // Give everyone a chance to take an initial position, unless nearly
+    // everyone already has and they agree with us
+    if (result_->roundTime.read() < parms.ledgerMIN_CONSENSUS &&
+        !haveEarlyConsensus())
         return;
 
     updateOurPositions();
@@ -1578,6 +1608,19 @@ Consensus<Adaptor>::haveConsensus()
         mode_.get() == ConsensusMode::proposing,
         j_);
 
+    if (result_->state == ConsensusState::No &&
+        result_->roundTime.read() <= adaptor_.parms().ledgerMIN_CONSENSUS &&
+        checkEarlyConsensus(
+            prevProposers_,
+            agree + disagree,
+            agree,
+            adaptor_.parms(),
+            mode_.get() == ConsensusMode::proposing,
+            j_))
+    {
+        result_->state = ConsensusState::Yes;
+    }
+
     if (result_->state == ConsensusState::No)
         return false;
 
@@ -1592,6 +1635,29 @@ Consensus<Adaptor>::haveConsensus()
     return true;
 }
 
+template <class Adaptor>
+bool
+Consensus<Adaptor>::haveEarlyConsensus() const
+{
+    assert(result_);
+
+    auto const& ourPosition = result_->position.position();
+    std::size_t const agree = std::count_if(
+        currPeerPositions_.begin(),
+        currPeerPositions_.end(),
+        [&ourPosition](auto const& p) {
+            return p.second.proposal().position() == ourPosition;
+        });
+
+    return checkEarlyConsensus(
+        prevProposers_,
+        currPeerPositions_.size(),
+        agree,
+        adaptor_.parms(),
+        mode_.get() == ConsensusMode::proposing,
+        j_);
+}
+
 template <class Adaptor>
 void
 Consensus<Adaptor>::leaveConsensus()
@@ -80,6 +80,13 @@ struct ConsensusParms
     std::chrono::milliseconds ledgerMIN_CONSENSUS =
         std::chrono::milliseconds{1950};
 
+    /** The percentage of the previous round's proposers that must propose
+        our position to declare consensus before ledgerMIN_CONSENSUS.
+
+        Zero, the default, always waits for ledgerMIN_CONSENSUS.
+    */
+    std::size_t ledgerEARLY_CONSENSUS_PCT = 0;
+
     /** The maximum amount of time to spend pausing for laggards.
      *
      *  This should be sufficiently less than validationFRESHNESS so that
@@ -294,9 +294,14 @@ class Validations
     using WrappedValidationType = std::decay_t<
         std::result_of_t<decltype (&Validation::unwrap)(Validation)>>;
 
-    // Manages concurrent access to members
+    // Manages concurrent access to members other than byLedger_
     mutable Mutex mutex_;
 
+    // Manages concurrent access to byLedger_, so that looking up the
+    // validations of a ledger does not wait on trie updates. If both are
+    // needed, mutex_ must be locked first.
+    mutable Mutex byLedgerMutex_;
+
     // Validations from currently listed and trusted nodes (partial and full)
     hash_map<NodeID, Validation> current_;
 
@@ -328,6 +333,20 @@ class Validations
     // Represents the ancestry of validated ledgers
     LedgerTrie<Ledger> trie_;
 
+    // Changed whenever a ledger is inserted into or removed from the trie
+    std::uint64_t trieVersion_ = 0;
+
+    // The last preferred tip found in the trie, with the trie version and
+    // largest local validation sequence it was found for. Walking the trie
+    // is only needed again once one of those changes.
+    struct PreferredTip
+    {
+        std::uint64_t version;
+        Seq largest;
+        boost::optional<SpanTip<Ledger>> tip;
+    };
+    boost::optional<PreferredTip> preferred_;
+
     // Last (validated) ledger successfully acquired. If in this map, it is
     // accounted for in the trie.
     hash_map<NodeID, Ledger> lastLedger_;
@@ -365,6 +384,7 @@ private:
             if (it != lastLedger_.end() && it->second.id() == val.ledgerID())
             {
                 trie_.remove(it->second);
+                ++trieVersion_;
                 lastLedger_.erase(nodeID);
             }
         }
@@ -403,6 +423,7 @@ private:
             it->second = ledger;
         }
         trie_.insert(ledger);
+        ++trieVersion_;
     }
 
     /** Process a new validation
@@ -522,9 +543,27 @@ private:
         }
     }
 
+    /** Return the preferred tip of the trie
+
+        @param lock Existing lock of mutex_
+    */
+    boost::optional<SpanTip<Ledger>>
+    preferredTip(std::lock_guard<Mutex> const& lock)
+    {
+        return withTrie(lock, [this](LedgerTrie<Ledger>& trie) {
+            auto const largest = localSeqEnforcer_.largest();
+            if (!preferred_ || preferred_->version != trieVersion_ ||
+                preferred_->largest != largest)
+                preferred_.emplace(PreferredTip{
+                    trieVersion_, largest, trie.getPreferred(largest)});
+            return preferred_->tip;
+        });
+    }
+
     /** Iterate the set of validations associated with a given ledger id
 
-        @param lock Existing lock on mutex_
+        Locks byLedgerMutex_, but not mutex_.
+
         @param ledgerID The identifier of the ledger
         @param pre Invokable with signature(std::size_t)
         @param f Invokable with signature (NodeID const &, Validation const &)
@@ -532,16 +571,13 @@ private:
         @note The invokable `pre` is called prior to iterating validations. The
               argument is the number of times `f` will be called.
         @warning The invokable f is expected to be a simple transformation of
-       its arguments and will be called with mutex_ under lock.
+       its arguments and will be called with byLedgerMutex_ under lock.
     */
     template <class Pre, class F>
     void
-    byLedger(
-        std::lock_guard<Mutex> const&,
-        ID const& ledgerID,
-        Pre&& pre,
-        F&& f)
+    byLedger(ID const& ledgerID, Pre&& pre, F&& f)
     {
+        std::lock_guard lock{byLedgerMutex_};
         auto it = byLedger_.find(ledgerID);
         if (it != byLedger_.end())
         {
@@ -663,7 +699,10 @@ public:
                 return ValStatus::badSeq;
             }
 
-            byLedger_[val.ledgerID()].insert_or_assign(nodeID, val);
+            {
+                std::lock_guard byLedgerLock{byLedgerMutex_};
+                byLedger_[val.ledgerID()].insert_or_assign(nodeID, val);
+            }
 
             auto const [it, inserted] = current_.emplace(nodeID, val);
             if (!inserted)
@@ -709,6 +748,7 @@ public:
     expire()
     {
         std::lock_guard lock{mutex_};
+        std::lock_guard byLedgerLock{byLedgerMutex_};
         if (toKeep_)
         {
             for (auto i = byLedger_.begin(); i != byLedger_.end(); ++i)
@@ -762,6 +802,7 @@ public:
             }
         }
 
+        std::lock_guard byLedgerLock{byLedgerMutex_};
         for (auto& [_, validationMap] : byLedger_)
         {
             (void)_;
@@ -802,10 +843,7 @@ public:
     getPreferred(Ledger const& curr)
     {
         std::lock_guard lock{mutex_};
-        boost::optional<SpanTip<Ledger>> preferred =
-            withTrie(lock, [this](LedgerTrie<Ledger>& trie) {
-                return trie.getPreferred(localSeqEnforcer_.largest());
-            });
+        boost::optional<SpanTip<Ledger>> preferred = preferredTip(lock);
         // No trusted validations to determine branch
         if (!preferred)
         {
@@ -989,9 +1027,7 @@ public:
     numTrustedForLedger(ID const& ledgerID)
     {
         std::size_t count = 0;
-        std::lock_guard lock{mutex_};
         byLedger(
-            lock,
             ledgerID,
             [&](std::size_t) {},  // nothing to reserve
             [&](NodeID const&, Validation const& v) {
@@ -1010,9 +1046,7 @@ public:
     getTrustedForLedger(ID const& ledgerID)
     {
         std::vector<WrappedValidationType> res;
-        std::lock_guard lock{mutex_};
         byLedger(
-            lock,
             ledgerID,
             [&](std::size_t numValidations) { res.reserve(numValidations); },
             [&](NodeID const&, Validation const& v) {
@@ -1033,9 +1067,7 @@ public:
     fees(ID const& ledgerID, std::uint32_t baseFee)
     {
         std::vector<std::uint32_t> res;
-        std::lock_guard lock{mutex_};
         byLedger(
-            lock,
             ledgerID,
             [&](std::size_t numValidations) { res.reserve(numValidations); },
             [&](NodeID const&, Validation const& v) {
@@ -22,6 +22,8 @@
 
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/basics/FeeUnits.h>
+#include <ripple/basics/HugePages.h>
+#include <ripple/basics/ThreadAffinity.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/beast/net/IPEndpoint.h>
 #include <ripple/beast/utility/Journal.h>
@@ -104,6 +106,15 @@ private:
     */
     bool RUN_STANDALONE = false;
 
+    /** Operate in reporting mode.
+
+        In reporting mode the server follows the server named in the
+        [reporting] section, copying each ledger it validates, and only
+        serves RPC commands. Peer connections are not attempted or
+        accepted, and the server takes no part in consensus.
+    */
+    bool RUN_REPORTING = false;
+
     /** Determines if the server will sign a tx, given an account's secret seed.
 
         In the past, this was allowed, but this functionality can have security
@@ -117,6 +128,9 @@ public:
     bool nodeToShard = false;
     bool ELB_SUPPORT = false;
 
+    // Leak the caches rather than free them when exiting
+    bool FAST_SHUTDOWN = false;
+
     std::vector<std::string> IPS;           // Peer IPs from rippled.cfg.
     std::vector<std::string> IPS_FIXED;     // Fixed Peer IPs from rippled.cfg.
     std::vector<std::string> SNTP_SERVERS;  // SNTP servers from rippled.cfg.
@@ -128,6 +142,10 @@ public:
 
     std::string START_LEDGER;
 
+    // Check the starting ledger in the background rather than reading all
+    // of its nodes before starting
+    bool LAZY_LEDGER_LOAD = false;
+
     // Network parameters
 
     // The number of fee units a reference transaction costs
@@ -159,6 +177,11 @@ public:
     int PATH_SEARCH = 7;
     int PATH_SEARCH_FAST = 2;
     int PATH_SEARCH_MAX = 10;
+    // How many source currencies of a request are searched at once
+    std::size_t PATH_SEARCH_THREADS = 1;
+    // How long a path_find update may keep deepening its search; zero
+    // searches at a single level
+    std::chrono::milliseconds PATH_SEARCH_DEADLINE{0};
 
     // Validation
     boost::optional<std::size_t>
@@ -171,9 +194,35 @@ public:
     // Node storage configuration
     std::uint32_t LEDGER_HISTORY = 256;
     std::uint32_t FETCH_DEPTH = 1000000000;
+    // Spread the requests for a ledger's missing nodes across up to this
+    // many peers at once; zero asks one peer at a time
+    std::size_t LEDGER_FETCH_STRIPED_PEERS = 0;
+    // Ranges of missing history acquired at once, and the node store write
+    // load at which no more than one is
+    std::size_t LEDGER_FETCH_HISTORY_RANGES = 1;
+    std::size_t LEDGER_FETCH_HISTORY_WRITE_LOAD = 4096;
+    // Rebuild a ledger whose parent we hold by replaying its transactions
+    // instead of acquiring its state tree
+    bool LEDGER_FETCH_REPLAY = true;
+    // Fetch the nodes of ledgers older than the ones kept from peers when
+    // RPC requests read them, and the tree nodes cached for them
+    bool LEDGER_FETCH_RPC_HISTORY = false;
+    std::size_t LEDGER_FETCH_RPC_HISTORY_CACHE = 16384;
 
     std::size_t NODE_SIZE = 0;
 
+    // The node size and cache budget were chosen from the hardware, and
+    // the budget gives way when the machine runs short of memory
+    bool NODE_SIZE_AUTO = false;
+
+    // Megabytes shared by the tree node, node store and transaction caches;
+    // zero sizes them by entries alone
+    std::size_t CACHE_BUDGET_MB = 0;
+
+    // Most tree node keys saved to read back into the cache on the next
+    // start; zero disables warm starts
+    std::size_t WARM_START_KEYS = 0;
+
     bool SSL_VERIFY = true;
     std::string SSL_VERIFY_FILE;
     std::string SSL_VERIFY_DIR;
@@ -181,22 +230,70 @@ public:
     // Compression
     bool COMPRESSION = false;
 
+    // The processors for the I/O and job queue threads; empty means any
+    CpuSet IO_AFFINITY;
+    CpuSet JOB_QUEUE_AFFINITY;
+
+    // Where SHAMap nodes and items get their memory
+    HugePageMode HUGE_PAGES = HugePageMode::none;
+
+    // Serve job types nearing their latency targets first
+    bool JOB_DEADLINES = false;
+
     // Work queue limits
     int MAX_TRANSACTIONS = 250;
     static constexpr int MAX_JOB_QUEUE_TX = 1000;
     static constexpr int MIN_JOB_QUEUE_TX = 100;
 
+    // Largest number of relayed transactions applied to the open ledger
+    // under one hold of the master lock; zero applies them all at once
+    std::size_t TX_BATCH_MAX_SIZE = 256;
+    // How long relayed transactions are collected before a batch starts
+    std::chrono::milliseconds TX_BATCH_INTERVAL{0};
+
+    // Most results of read-only commands against the validated ledger kept
+    // to answer repeated requests; zero disables the cache
+    std::size_t RPC_CACHE_SIZE = 0;
+
     // Amendment majority time
     std::chrono::seconds AMENDMENT_MAJORITY_TIME = defaultAmendmentMajorityTime;
 
+    // Percentage of the last round's proposers which must propose our
+    // position for a round to end before the minimum consensus time; zero
+    // always waits
+    std::size_t EARLY_CONSENSUS_PCT = 0;
+
     // Thread pool configuration
     std::size_t WORKERS = 0;
 
+    // Threads serving only trusted proposals and validations; zero serves
+    // them with the other jobs
+    std::size_t CONSENSUS_THREADS = 2;
+
+    // Threads running the I/O service for everything but peer and client
+    // connections, zero picks a number from the hardware; and threads
+    // running a separate I/O service for peer and for client connections,
+    // zero shares the first one
+    std::size_t IO_THREADS_INTERNAL = 0;
+    std::size_t IO_THREADS_OVERLAY = 0;
+    std::size_t IO_THREADS_SERVER = 0;
+
+    // Most log messages waiting to be written by a background thread; zero
+    // writes them as they are logged
+    std::size_t LOG_QUEUE = 0;
+
     // Reduce-relay - these parameters are experimental.
     // Enable reduce-relay functionality
     bool REDUCE_RELAY_ENABLE = false;
     // Send squelch message to peers
     bool REDUCE_RELAY_SQUELCH = false;
+    // Announce transactions by hash to peers which support it, rather
+    // than sending every one of them the full transaction
+    bool TX_REDUCE_RELAY_ENABLE = false;
+    // Lowest number of peers sent a transaction in full
+    std::size_t TX_REDUCE_RELAY_MIN_PEERS = 20;
+    // Percentage of peers sent a transaction in full
+    std::size_t TX_RELAY_PERCENTAGE = 25;
 
     // These override the command line client settings
     boost::optional<beast::IP::Endpoint> rpc_ip;
@@ -251,6 +348,12 @@ public:
         return RUN_STANDALONE;
     }
 
+    bool
+    reporting() const
+    {
+        return RUN_REPORTING;
+    }
+
     bool
     canSign() const
     {
@@ -277,6 +380,23 @@ public:
     int
     getValueFor(SizedItem item, boost::optional<std::size_t> node = boost::none)
         const;
+
+    /** The node size suited to a machine.
+
+        Each size needs more memory than the one below it and enough
+        processors to keep its larger caches and fetches busy.
+
+        @param memory The physical memory, in bytes.
+        @param cores The number of hardware threads.
+
+        @return The node size (0: tiny, ..., 4: huge).
+    */
+    static std::size_t
+    autoNodeSize(std::uint64_t memory, unsigned cores);
+
+    /** The cache budget suited to a machine, in megabytes. */
+    static std::size_t
+    autoCacheBudget(std::uint64_t memory);
 };
 
 }  // namespace ripple
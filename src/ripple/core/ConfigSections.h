@@ -49,19 +49,29 @@ struct ConfigSection
 // VFALCO TODO Rename and replace these macros with variables.
 #define SECTION_AMENDMENTS "amendments"
 #define SECTION_AMENDMENT_MAJORITY_TIME "amendment_majority_time"
+#define SECTION_CACHE_BUDGET "cache_budget"
 #define SECTION_CLUSTER_NODES "cluster_nodes"
 #define SECTION_COMPRESSION "compression"
+#define SECTION_CONSENSUS_THREADS "consensus_threads"
 #define SECTION_DEBUG_LOGFILE "debug_logfile"
+#define SECTION_EARLY_CONSENSUS "early_consensus"
 #define SECTION_ELB_SUPPORT "elb_support"
+#define SECTION_FAST_SHUTDOWN "fast_shutdown"
 #define SECTION_FEE_DEFAULT "fee_default"
 #define SECTION_FEE_ACCOUNT_RESERVE "fee_account_reserve"
 #define SECTION_FEE_OWNER_RESERVE "fee_owner_reserve"
 #define SECTION_FETCH_DEPTH "fetch_depth"
 #define SECTION_HISTORICAL_SHARD_PATHS "historical_shard_paths"
+#define SECTION_HUGE_PAGES "huge_pages"
 #define SECTION_INSIGHT "insight"
+#define SECTION_IO_THREADS "io_threads"
 #define SECTION_IPS "ips"
 #define SECTION_IPS_FIXED "ips_fixed"
+#define SECTION_JOB_DEADLINES "job_deadlines"
+#define SECTION_LAZY_LEDGER_LOAD "lazy_ledger_load"
+#define SECTION_LEDGER_FETCH "ledger_fetch"
 #define SECTION_LEDGER_HISTORY "ledger_history"
+#define SECTION_LOG_QUEUE "log_queue"
 #define SECTION_MAX_TRANSACTIONS "max_transactions"
 #define SECTION_NETWORK_QUORUM "network_quorum"
 #define SECTION_NODE_SEED "node_seed"
@@ -71,6 +81,8 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH "path_search"
 #define SECTION_PATH_SEARCH_FAST "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX "path_search_max"
+#define SECTION_PATH_SEARCH_THREADS "path_search_threads"
+#define SECTION_PATH_SEARCH_DEADLINE "path_search_deadline"
 #define SECTION_PEER_PRIVATE "peer_private"
 #define SECTION_PEERS_MAX "peers_max"
 #define SECTION_PEERS_IN_MAX "peers_in_max"
@@ -78,13 +90,18 @@ struct ConfigSection
 #define SECTION_REDUCE_RELAY "reduce_relay"
 #define SECTION_RELAY_PROPOSALS "relay_proposals"
 #define SECTION_RELAY_VALIDATIONS "relay_validations"
+#define SECTION_RPC_CACHE "rpc_cache"
 #define SECTION_RPC_STARTUP "rpc_startup"
 #define SECTION_SIGNING_SUPPORT "signing_support"
 #define SECTION_SNTP "sntp_servers"
 #define SECTION_SSL_VERIFY "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE "ssl_verify_file"
 #define SECTION_SSL_VERIFY_DIR "ssl_verify_dir"
+#define SECTION_REPORTING "reporting"
 #define SECTION_SERVER_DOMAIN "server_domain"
+#define SECTION_THREAD_AFFINITY "thread_affinity"
+#define SECTION_TRANSACTION_BATCH "transaction_batch"
+#define SECTION_TX_INDEX "tx_index"
 #define SECTION_VALIDATORS_FILE "validators_file"
 #define SECTION_VALIDATION_SEED "validation_seed"
 #define SECTION_WEBSOCKET_PING_FREQ "websocket_ping_frequency"
@@ -95,6 +112,7 @@ struct ConfigSection
 #define SECTION_VALIDATORS "validators"
 #define SECTION_VALIDATOR_TOKEN "validator_token"
 #define SECTION_VETO_AMENDMENTS "veto_amendments"
+#define SECTION_WARM_START "warm_start"
 #define SECTION_WORKERS "workers"
 
 }  // namespace ripple
@@ -21,6 +21,7 @@
 #define RIPPLE_CORE_COROINL_H_INCLUDED
 
 #include <ripple/basics/ByteUtilities.h>
+#include <ripple/core/impl/CoroStack.h>
 
 namespace ripple {
 
@@ -46,7 +47,8 @@ JobQueue::Coro::Coro(
               finished_ = true;
 #endif
           },
-          boost::coroutines::attributes(megabytes(1)))
+          boost::coroutines::attributes(megabytes(1)),
+          CoroStackAllocator())
 {
 }
 
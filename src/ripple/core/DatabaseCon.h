@@ -25,8 +25,12 @@
 #include <ripple/core/SociDB.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace soci {
 class session;
@@ -48,6 +52,12 @@ public:
         : session_(std::move(it)), lock_(m)
     {
     }
+    LockedSociSession(
+        std::shared_ptr<soci::session> it,
+        std::unique_lock<mutex>&& lock)
+        : session_(std::move(it)), lock_(std::move(lock))
+    {
+    }
     LockedSociSession(LockedSociSession&& rhs) noexcept
         : session_(std::move(rhs.session_)), lock_(std::move(rhs.lock_))
     {
@@ -91,6 +101,9 @@ public:
         // Indicates whether or not to return the `globalPragma`
         // from commonPragma()
         bool useGlobalPragma = false;
+        // The number of read-only sessions opened alongside the session
+        // used for writing. Only databases kept in files use them.
+        std::size_t readSessions = 0;
 
         std::vector<std::string> const*
         commonPragma() const
@@ -124,7 +137,8 @@ public:
                   : (setup.dataDir / dbName),
               setup.commonPragma(),
               pragma,
-              initSQL)
+              initSQL,
+              setup.readSessions)
     {
     }
 
@@ -147,7 +161,7 @@ public:
         std::string const& dbName,
         std::array<char const*, N> const& pragma,
         std::array<char const*, M> const& initSQL)
-        : DatabaseCon(dataDir / dbName, nullptr, pragma, initSQL)
+        : DatabaseCon(dataDir / dbName, nullptr, pragma, initSQL, 0)
     {
     }
 
@@ -178,38 +192,86 @@ public:
         return LockedSociSession(session_, lock_);
     }
 
+    /** Check out a session which may only be read from.
+
+        Readers share a pool of read-only sessions, so in WAL mode they
+        wait neither for each other nor for writes. If the database has no
+        read sessions this is the same as checkoutDb().
+    */
+    LockedSociSession
+    checkoutReadDb();
+
+    struct ReadStats
+    {
+        // Read sessions checked out
+        std::uint64_t count = 0;
+        // Check outs which had to wait for a busy session
+        std::uint64_t waits = 0;
+        // Total time spent waiting
+        std::chrono::microseconds waitTime{0};
+    };
+
+    ReadStats
+    readStats() const;
+
 private:
     void
     setupCheckpointing(JobQueue*, Logs&);
 
-    template <std::size_t N, std::size_t M>
-    DatabaseCon(
-        boost::filesystem::path const& pPath,
+    template <std::size_t N>
+    static void
+    applyPragma(
+        soci::session& session,
         std::vector<std::string> const* commonPragma,
-        std::array<char const*, N> const& pragma,
-        std::array<char const*, M> const& initSQL)
-        : session_(std::make_shared<soci::session>())
+        std::array<char const*, N> const& pragma)
     {
-        open(*session_, "sqlite", pPath.string());
-
         if (commonPragma)
         {
             for (auto const& p : *commonPragma)
             {
-                soci::statement st = session_->prepare << p;
+                soci::statement st = session.prepare << p;
                 st.execute(true);
             }
         }
         for (auto const& p : pragma)
         {
-            soci::statement st = session_->prepare << p;
+            soci::statement st = session.prepare << p;
             st.execute(true);
         }
+    }
+
+    template <std::size_t N, std::size_t M>
+    DatabaseCon(
+        boost::filesystem::path const& pPath,
+        std::vector<std::string> const* commonPragma,
+        std::array<char const*, N> const& pragma,
+        std::array<char const*, M> const& initSQL,
+        std::size_t readSessions)
+        : session_(std::make_shared<soci::session>())
+    {
+        open(*session_, "sqlite", pPath.string());
+
+        applyPragma(*session_, commonPragma, pragma);
         for (auto const& sql : initSQL)
         {
             soci::statement st = session_->prepare << sql;
             st.execute(true);
         }
+
+        // An empty path opens a temporary database private to its session
+        if (pPath.empty())
+            return;
+
+        readers_.reserve(readSessions);
+        for (std::size_t i = 0; i < readSessions; ++i)
+        {
+            auto reader = std::make_unique<Reader>();
+            reader->session = std::make_shared<soci::session>();
+            open(*reader->session, "sqlite", pPath.string());
+            applyPragma(*reader->session, commonPragma, pragma);
+            *reader->session << "PRAGMA query_only=1;";
+            readers_.push_back(std::move(reader));
+        }
     }
 
     LockedSociSession::mutex lock_;
@@ -222,6 +284,18 @@ private:
     // shared_ptr in this class. session_ will never be null.
     std::shared_ptr<soci::session> const session_;
     std::shared_ptr<Checkpointer> checkpointer_;
+
+    struct Reader
+    {
+        std::shared_ptr<soci::session> session;
+        LockedSociSession::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Reader>> readers_;
+    std::atomic<std::size_t> nextReader_{0};
+    std::atomic<std::uint64_t> reads_{0};
+    std::atomic<std::uint64_t> readWaits_{0};
+    std::atomic<std::uint64_t> readWaitTime_{0};
 };
 
 // Return the checkpointer from its id. If the checkpointer no longer exists, an
@@ -44,7 +44,9 @@ enum JobType {
     jtTRANSACTION_l,  // A local transaction
     jtLEDGER_REQ,     // Peer request ledger/txnset data
     jtPROPOSAL_ut,    // A proposal from an untrusted source
+    jtLEDGER_HISTORY, // Received data for a past ledger we're acquiring
     jtLEDGER_DATA,    // Received data for a ledger we're acquiring
+    jtPEER_DECODE,    // Decode a large message received from a peer
     jtCLIENT,         // A websocket command from the client
     jtRPC,            // A websocket command from the client
     jtUPDATE_PF,      // Update pathfinding requests
@@ -201,11 +201,46 @@ public:
     int
     getJobCountGE(JobType t) const;
 
+    /** Returns `true` if work more urgent than this type is running late.
+
+        This is the case when deadlines are enabled and the oldest waiting
+        job of a higher priority type, which has a latency target, has
+        waited longer than that target. Callers adding optional work of
+        type `t` can use this to shed it before the queue backs up.
+    */
+    bool
+    isBehind(JobType t) const;
+
     /** Set the number of thread serving the job queue to precisely this number.
      */
     void
     setThreadCount(int c, bool const standaloneMode);
 
+    /** Serve trusted proposals and validations on their own threads.
+
+        Jobs of those types are then run only by these threads, and no
+        other job runs on them, so a queue full of client requests or
+        ledger fetches cannot delay consensus. Zero, the default, serves
+        them on the shared threads like any other job. Must be called
+        before jobs are added.
+    */
+    void
+    setConsensusThreadCount(int c);
+
+    /** Run the threads started from now on only on the given processors.
+     */
+    void
+    setThreadAffinity(CpuSet const& cpus);
+
+    /** Take the latency targets of the job types into account.
+
+        When enabled, a job type whose oldest waiting job has used half of
+        its average latency target is served ahead of types which are not
+        yet due, in priority order among the due types.
+    */
+    void
+    setDeadlines(bool enable);
+
     /** Return a scoped LoadEvent.
      */
     std::unique_ptr<LoadEvent>
@@ -233,13 +268,35 @@ private:
 
     using JobDataMap = std::map<JobType, JobTypeData>;
 
+    // Runs the jobs of the consensus lane on its own workers
+    struct ConsensusLane : Workers::Callback
+    {
+        JobQueue& queue;
+
+        explicit ConsensusLane(JobQueue& q) : queue(q)
+        {
+        }
+
+        void
+        processTask(int instance) override
+        {
+            queue.runTask(instance, true);
+        }
+    };
+
     beast::Journal m_journal;
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    std::set<Job> m_jobSet;
+    std::atomic<std::uint64_t> m_lastJob;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
+    // The number of jobs waiting in all of the queues
+    std::size_t m_jobCount = 0;
+
+    // Whether to serve job types which are close to their latency target
+    // first
+    bool m_deadlines = false;
+
     // The number of jobs currently in processTask()
     int m_processCount;
 
@@ -249,6 +306,16 @@ private:
     Workers m_workers;
     Job::CancelCallback m_cancelCallback;
 
+    // The threads serving trusted proposals and validations, if any
+    int m_consensusThreads = 0;
+    ConsensusLane m_consensusLane;
+    Workers m_consensusWorkers;
+
+    // How long jobs of the consensus lane waited to start
+    std::atomic<std::uint64_t> m_consensusJobs{0};
+    std::atomic<std::uint64_t> m_consensusWait{0};
+    std::atomic<std::uint64_t> m_consensusPeakWait{0};
+
     // Statistics tracking
     perf::PerfLog& perfLog_;
     beast::insight::Collector::ptr m_collector;
@@ -269,6 +336,14 @@ private:
     void
     checkStopped(std::lock_guard<std::mutex> const& lock);
 
+    // Whether jobs of this type are served by the consensus lane
+    bool
+    onConsensusLane(JobType type) const;
+
+    // Signals a worker of the pool which serves jobs of this type
+    void
+    signal(JobType type);
+
     // Adds a reference counted job to the JobQueue.
     //
     //    param type The type of job.
@@ -283,11 +358,10 @@ private:
         std::string const& name,
         JobFunction const& func);
 
-    // Signals an added Job for processing.
+    // Adds a Job to the queue for its type and signals it for processing.
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
     //  The Job must not have previously been queued.
     //
     // Post-conditions:
@@ -298,32 +372,34 @@ private:
     // Invariants:
     //  The calling thread owns the JobLock
     void
-    queueJob(Job const& job, std::lock_guard<std::mutex> const& lock);
+    queueJob(Job&& job, std::lock_guard<std::mutex> const& lock);
 
-    // Returns the next Job we should run now.
+    // Returns the next Job we should run now. This is the oldest waiting
+    // Job of the highest priority type which is below its limit, among the
+    // types served by the consensus lane or among the others.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A queued Job whose slots count for its type is greater than zero.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  At least one Job is queued.
+    //  At least one RunnableJob is queued.
     //
     // Post-conditions:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from its queue.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
     // Invariants:
     //  The calling thread owns the JobLock
     void
-    getNextJob(Job& job);
+    getNextJob(Job& job, bool consensus);
 
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not be queued.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -339,7 +415,7 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must be queued
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -349,11 +425,9 @@ private:
     void
     processTask(int instance) override;
 
-    // Returns the limit of running jobs for the given job type.
-    // For jobs with no limit, we return the largest int. Hopefully that
-    // will be enough.
-    int
-    getJobLimit(JobType type);
+    // Runs the next Job for the shared workers or the consensus lane.
+    void
+    runTask(int instance, bool consensus);
 
     void
     onChildrenStopped() override;
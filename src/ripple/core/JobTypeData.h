@@ -22,7 +22,9 @@
 
 #include <ripple/basics/Log.h>
 #include <ripple/beast/insight/Collector.h>
+#include <ripple/core/Job.h>
 #include <ripple/core/JobTypeInfo.h>
+#include <deque>
 
 namespace ripple {
 
@@ -47,10 +49,17 @@ public:
     /* And the number we deferred executing because of job limits */
     int deferred;
 
+    /* The jobs waiting to run, oldest first */
+    std::deque<Job> queue;
+
     /* Notification callbacks */
     beast::insight::Event dequeue;
     beast::insight::Event execute;
 
+    /* The distribution of every job's latency, not only the slow ones */
+    beast::insight::Histogram dequeueLatency;
+    beast::insight::Histogram executeLatency;
+
     JobTypeData(
         JobTypeInfo const& info_,
         beast::insight::Collector::ptr const& collector,
@@ -69,6 +78,10 @@ public:
         {
             dequeue = m_collector->make_event(info.name() + "_q");
             execute = m_collector->make_event(info.name());
+            dequeueLatency =
+                m_collector->make_histogram(info.name() + "_q_latency");
+            executeLatency =
+                m_collector->make_histogram(info.name() + "_latency");
         }
     }
 
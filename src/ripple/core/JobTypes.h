@@ -48,7 +48,7 @@ private:
         using namespace std::chrono_literals;
         int maxLimit = std::numeric_limits<int>::max();
 
-        add(jtPACK, "makeFetchPack", 1, false, 0ms, 0ms);
+        add(jtPACK, "makeFetchPack", 4, false, 0ms, 0ms);
         add(jtPUBOLDLEDGER, "publishAcqLedger", 2, false, 10000ms, 15000ms);
         add(jtVALIDATION_ut,
             "untrustedValidation",
@@ -59,7 +59,9 @@ private:
         add(jtTRANSACTION_l, "localTransaction", maxLimit, false, 100ms, 500ms);
         add(jtLEDGER_REQ, "ledgerRequest", 2, false, 0ms, 0ms);
         add(jtPROPOSAL_ut, "untrustedProposal", maxLimit, false, 500ms, 1250ms);
+        add(jtLEDGER_HISTORY, "ledgerHistoryData", 2, false, 0ms, 0ms);
         add(jtLEDGER_DATA, "ledgerData", 2, false, 0ms, 0ms);
+        add(jtPEER_DECODE, "decodePeerMessage", maxLimit, false, 0ms, 0ms);
         add(jtCLIENT, "clientCommand", maxLimit, false, 2000ms, 5000ms);
         add(jtRPC, "RPC", maxLimit, false, 0ms, 0ms);
         add(jtUPDATE_PF, "updatePaths", maxLimit, false, 0ms, 0ms);
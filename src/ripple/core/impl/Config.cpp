@@ -20,6 +20,7 @@
 #include <ripple/basics/FileUtilities.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/SystemMemory.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/core/Config.h>
@@ -37,6 +38,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <thread>
 
 namespace ripple {
 
@@ -351,6 +353,9 @@ Config::loadFromString(std::string const& fileContents)
     if (auto s = getIniFileSection(secConfig, SECTION_SNTP))
         SNTP_SERVERS = *s;
 
+    // A stand-alone server has no source to follow
+    RUN_REPORTING = !RUN_STANDALONE && exists(SECTION_REPORTING);
+
     {
         std::string dbPath;
         if (getSingleSection(secConfig, "database_path", dbPath, j_))
@@ -418,17 +423,49 @@ Config::loadFromString(std::string const& fileContents)
             NODE_SIZE = 3;
         else if (boost::iequals(strTemp, "huge"))
             NODE_SIZE = 4;
+        else if (boost::iequals(strTemp, "auto"))
+            NODE_SIZE_AUTO = true;
         else
             NODE_SIZE = std::min<std::size_t>(
                 4, beast::lexicalCastThrow<std::size_t>(strTemp));
     }
 
+    if (getSingleSection(secConfig, SECTION_CACHE_BUDGET, strTemp, j_))
+        CACHE_BUDGET_MB = beast::lexicalCastThrow<std::size_t>(strTemp);
+
+    if (NODE_SIZE_AUTO)
+    {
+        auto const memory = getSystemMemory();
+        auto const cores = std::thread::hardware_concurrency();
+        if (memory)
+        {
+            NODE_SIZE = autoNodeSize(memory->total, cores);
+            if (CACHE_BUDGET_MB == 0)
+                CACHE_BUDGET_MB = autoCacheBudget(memory->total);
+            JLOG(j_.info()) << "Chose node size " << NODE_SIZE
+                            << " and a cache budget of " << CACHE_BUDGET_MB
+                            << "MB for " << memory->total / (1024 * 1024)
+                            << "MB of memory and " << cores << " processors";
+        }
+        else
+        {
+            // Without knowing the memory, assume a modest machine
+            NODE_SIZE = 1;
+            NODE_SIZE_AUTO = false;
+            JLOG(j_.warn()) << "Unable to measure memory for node_size auto; "
+                               "using small";
+        }
+    }
+
     if (getSingleSection(secConfig, SECTION_SIGNING_SUPPORT, strTemp, j_))
         signingEnabled_ = beast::lexicalCastThrow<bool>(strTemp);
 
     if (getSingleSection(secConfig, SECTION_ELB_SUPPORT, strTemp, j_))
         ELB_SUPPORT = beast::lexicalCastThrow<bool>(strTemp);
 
+    if (getSingleSection(secConfig, SECTION_FAST_SHUTDOWN, strTemp, j_))
+        FAST_SHUTDOWN = beast::lexicalCastThrow<bool>(strTemp);
+
     if (getSingleSection(secConfig, SECTION_WEBSOCKET_PING_FREQ, strTemp, j_))
         WEBSOCKET_PING_FREQ =
             std::chrono::seconds{beast::lexicalCastThrow<int>(strTemp)};
@@ -504,6 +541,81 @@ Config::loadFromString(std::string const& fileContents)
             FETCH_DEPTH = 10;
     }
 
+    if (exists(SECTION_LEDGER_FETCH))
+    {
+        auto sec = section(SECTION_LEDGER_FETCH);
+        LEDGER_FETCH_STRIPED_PEERS =
+            sec.value_or<std::size_t>("striped_peers", 0);
+        if (LEDGER_FETCH_STRIPED_PEERS == 1 || LEDGER_FETCH_STRIPED_PEERS > 32)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_LEDGER_FETCH
+                "] section; striped_peers must be 0 or in range 2-32");
+        LEDGER_FETCH_HISTORY_RANGES =
+            sec.value_or<std::size_t>("history_ranges", 1);
+        if (LEDGER_FETCH_HISTORY_RANGES < 1 || LEDGER_FETCH_HISTORY_RANGES > 16)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_LEDGER_FETCH
+                "] section; history_ranges must be in range 1-16");
+        LEDGER_FETCH_HISTORY_WRITE_LOAD =
+            sec.value_or<std::size_t>("history_write_load", 4096);
+        if (LEDGER_FETCH_HISTORY_WRITE_LOAD == 0)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_LEDGER_FETCH
+                "] section; history_write_load must be positive");
+        LEDGER_FETCH_REPLAY = sec.value_or<bool>("replay", true);
+        LEDGER_FETCH_RPC_HISTORY = sec.value_or<bool>("rpc_history", false);
+        LEDGER_FETCH_RPC_HISTORY_CACHE =
+            sec.value_or<std::size_t>("rpc_history_cache", 16384);
+        if (LEDGER_FETCH_RPC_HISTORY_CACHE == 0)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_LEDGER_FETCH
+                "] section; rpc_history_cache must be positive");
+    }
+
+    if (exists(SECTION_TRANSACTION_BATCH))
+    {
+        auto sec = section(SECTION_TRANSACTION_BATCH);
+        TX_BATCH_MAX_SIZE = sec.value_or<std::size_t>("max_size", 256);
+        auto const interval = sec.value_or<std::uint32_t>("interval", 0);
+        if (interval > 1000)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_TRANSACTION_BATCH
+                "] section; interval must be at most 1000 milliseconds");
+        TX_BATCH_INTERVAL = std::chrono::milliseconds{interval};
+    }
+
+    if (exists(SECTION_WARM_START))
+    {
+        auto sec = section(SECTION_WARM_START);
+        WARM_START_KEYS = sec.value_or<std::size_t>("keys", 100000);
+    }
+
+    if (exists(SECTION_THREAD_AFFINITY))
+    {
+        auto sec = section(SECTION_THREAD_AFFINITY);
+        IO_AFFINITY = getCpuSet(sec, "io");
+        JOB_QUEUE_AFFINITY = getCpuSet(sec, "job_queue");
+    }
+
+    if (exists(SECTION_IO_THREADS))
+    {
+        auto sec = section(SECTION_IO_THREADS);
+        IO_THREADS_INTERNAL = sec.value_or<std::size_t>("internal", 0);
+        IO_THREADS_OVERLAY = sec.value_or<std::size_t>("overlay", 0);
+        IO_THREADS_SERVER = sec.value_or<std::size_t>("server", 0);
+        if (IO_THREADS_INTERNAL > 64 || IO_THREADS_OVERLAY > 64 ||
+            IO_THREADS_SERVER > 64)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_IO_THREADS
+                "] section; each value must be in range 0-64");
+    }
+
+    if (exists(SECTION_RPC_CACHE))
+    {
+        auto sec = section(SECTION_RPC_CACHE);
+        RPC_CACHE_SIZE = sec.value_or<std::size_t>("size", 0);
+    }
+
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH_OLD, strTemp, j_))
         PATH_SEARCH_OLD = beast::lexicalCastThrow<int>(strTemp);
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH, strTemp, j_))
@@ -512,21 +624,78 @@ Config::loadFromString(std::string const& fileContents)
         PATH_SEARCH_FAST = beast::lexicalCastThrow<int>(strTemp);
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX = beast::lexicalCastThrow<int>(strTemp);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_THREADS, strTemp, j_))
+        PATH_SEARCH_THREADS = std::max<std::size_t>(
+            beast::lexicalCastThrow<std::size_t>(strTemp), 1);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_DEADLINE, strTemp, j_))
+        PATH_SEARCH_DEADLINE = std::chrono::milliseconds{
+            beast::lexicalCastThrow<std::uint32_t>(strTemp)};
 
     if (getSingleSection(secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE = strTemp;
 
+    if (getSingleSection(secConfig, SECTION_LOG_QUEUE, strTemp, j_))
+        LOG_QUEUE = beast::lexicalCastThrow<std::size_t>(strTemp);
+
     if (getSingleSection(secConfig, SECTION_WORKERS, strTemp, j_))
         WORKERS = beast::lexicalCastThrow<std::size_t>(strTemp);
 
+    if (getSingleSection(secConfig, SECTION_CONSENSUS_THREADS, strTemp, j_))
+    {
+        CONSENSUS_THREADS = beast::lexicalCastThrow<std::size_t>(strTemp);
+        if (CONSENSUS_THREADS > 16)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_CONSENSUS_THREADS
+                "] section; the value must be in range 0-16");
+    }
+
+    if (getSingleSection(secConfig, SECTION_EARLY_CONSENSUS, strTemp, j_))
+    {
+        EARLY_CONSENSUS_PCT = beast::lexicalCastThrow<std::size_t>(strTemp);
+        if (EARLY_CONSENSUS_PCT != 0 &&
+            (EARLY_CONSENSUS_PCT < 80 || EARLY_CONSENSUS_PCT > 100))
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_EARLY_CONSENSUS
+                "] section; the value must be 0 or in range 80-100");
+    }
+
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
+    if (getSingleSection(secConfig, SECTION_JOB_DEADLINES, strTemp, j_))
+        JOB_DEADLINES = beast::lexicalCastThrow<bool>(strTemp);
+
+    if (getSingleSection(secConfig, SECTION_LAZY_LEDGER_LOAD, strTemp, j_))
+        LAZY_LEDGER_LOAD = beast::lexicalCastThrow<bool>(strTemp);
+
+    if (getSingleSection(secConfig, SECTION_HUGE_PAGES, strTemp, j_))
+    {
+        auto const mode = parseHugePageMode(strTemp);
+        if (!mode)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_HUGE_PAGES
+                "] section; must be none, transparent or hugetlb");
+        HUGE_PAGES = *mode;
+    }
+
     if (exists(SECTION_REDUCE_RELAY))
     {
         auto sec = section(SECTION_REDUCE_RELAY);
         REDUCE_RELAY_ENABLE = sec.value_or("enable", false);
         REDUCE_RELAY_SQUELCH = sec.value_or("squelch", false);
+        TX_REDUCE_RELAY_ENABLE = sec.value_or("tx_enable", false);
+        TX_REDUCE_RELAY_MIN_PEERS =
+            sec.value_or<std::size_t>("tx_min_peers", 20);
+        TX_RELAY_PERCENTAGE =
+            sec.value_or<std::size_t>("tx_relay_percentage", 25);
+        if (TX_REDUCE_RELAY_MIN_PEERS < 10)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_REDUCE_RELAY
+                "] section; tx_min_peers must be at least 10");
+        if (TX_RELAY_PERCENTAGE < 10 || TX_RELAY_PERCENTAGE > 100)
+            Throw<std::runtime_error>(
+                "Invalid value specified in [" SECTION_REDUCE_RELAY
+                "] section; tx_relay_percentage must be in range 10-100");
     }
 
     if (getSingleSection(secConfig, SECTION_MAX_TRANSACTIONS, strTemp, j_))
@@ -810,6 +979,33 @@ Config::getDebugLogFile() const
     return log_file;
 }
 
+std::size_t
+Config::autoNodeSize(std::uint64_t memory, unsigned cores)
+{
+    // The least memory, in GB, and hardware threads for each size above
+    // tiny. The memory is a little under round figures, since some of it
+    // is always taken by the system.
+    static constexpr std::array<std::pair<std::uint64_t, unsigned>, 4>
+        needs{{{7, 2}, {15, 4}, {30, 6}, {60, 8}}};
+
+    std::size_t size = 0;
+    for (auto const& [gigabytes, threads] : needs)
+    {
+        if (memory < gigabytes * 1024 * 1024 * 1024 || cores < threads)
+            break;
+        ++size;
+    }
+    return size;
+}
+
+std::size_t
+Config::autoCacheBudget(std::uint64_t memory)
+{
+    // An eighth of the memory, leaving the rest for ledgers, the node
+    // store's own buffers and the file cache
+    return memory / 8 / (1024 * 1024);
+}
+
 int
 Config::getValueFor(SizedItem item, boost::optional<std::size_t> node) const
 {
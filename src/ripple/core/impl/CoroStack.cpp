@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/impl/CoroStack.h>
+#include <boost/coroutine/protected_stack_allocator.hpp>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+struct FreeStacks
+{
+    std::mutex mutex;
+    std::vector<boost::coroutines::stack_context> stacks;
+};
+
+FreeStacks&
+freeStacks()
+{
+    // Never destroyed, since coroutines may finish during static destruction
+    static FreeStacks* const pool = new FreeStacks;
+    return *pool;
+}
+
+}  // namespace
+
+void
+CoroStackAllocator::allocate(
+    boost::coroutines::stack_context& ctx,
+    std::size_t size)
+{
+    {
+        auto& pool = freeStacks();
+        std::lock_guard lock(pool.mutex);
+        // Stacks are all the same size in practice, so look from the
+        // most recently freed, whose pages are most likely to be resident
+        for (auto it = pool.stacks.rbegin(); it != pool.stacks.rend(); ++it)
+        {
+            if (it->size >= size)
+            {
+                ctx = *it;
+                pool.stacks.erase(std::next(it).base());
+                return;
+            }
+        }
+    }
+
+    boost::coroutines::protected_stack_allocator{}.allocate(ctx, size);
+}
+
+void
+CoroStackAllocator::deallocate(boost::coroutines::stack_context& ctx)
+{
+    {
+        auto& pool = freeStacks();
+        std::lock_guard lock(pool.mutex);
+        if (pool.stacks.size() < maxFree)
+        {
+            pool.stacks.push_back(ctx);
+            return;
+        }
+    }
+
+    boost::coroutines::protected_stack_allocator{}.deallocate(ctx);
+}
+
+std::size_t
+CoroStackAllocator::freeCount()
+{
+    auto& pool = freeStacks();
+    std::lock_guard lock(pool.mutex);
+    return pool.stacks.size();
+}
+
+}  // namespace ripple
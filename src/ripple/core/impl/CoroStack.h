@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_COROSTACK_H_INCLUDED
+#define RIPPLE_CORE_COROSTACK_H_INCLUDED
+
+#include <boost/coroutine/stack_context.hpp>
+#include <cstddef>
+
+namespace ripple {
+
+/** Allocates coroutine stacks, reusing the stacks of finished coroutines.
+
+    Every RPC request runs in a coroutine, and nearly all of them finish
+    quickly. Mapping a fresh stack for each one, faulting in its pages as
+    they are first touched and unmapping it again costs more than many of
+    the requests themselves. Instead, a limited number of free stacks are
+    kept, and the pages a previous coroutine touched are still resident
+    when the next one uses them.
+
+    Each stack has a guard page below it, so an overflow faults rather than
+    overwriting the heap.
+
+    Meets the requirements of a Boost.Coroutine StackAllocator.
+*/
+class CoroStackAllocator
+{
+public:
+    /** The most free stacks that are kept. */
+    static constexpr std::size_t maxFree = 64;
+
+    void
+    allocate(boost::coroutines::stack_context& ctx, std::size_t size);
+
+    void
+    deallocate(boost::coroutines::stack_context& ctx);
+
+    /** The number of free stacks currently kept. */
+    static std::size_t
+    freeCount();
+};
+
+}  // namespace ripple
+
+#endif
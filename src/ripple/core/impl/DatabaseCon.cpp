@@ -102,6 +102,47 @@ DatabaseCon::~DatabaseCon()
     }
 }
 
+LockedSociSession
+DatabaseCon::checkoutReadDb()
+{
+    if (readers_.empty())
+        return checkoutDb();
+
+    ++reads_;
+
+    // Take the first idle session, starting from a different one each time
+    auto const size = readers_.size();
+    auto const first = nextReader_++ % size;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto& reader = *readers_[(first + i) % size];
+        std::unique_lock<LockedSociSession::mutex> lock(
+            reader.mutex, std::try_to_lock);
+        if (lock.owns_lock())
+            return LockedSociSession(reader.session, std::move(lock));
+    }
+
+    // All of them are busy
+    auto& reader = *readers_[first];
+    auto const start = std::chrono::steady_clock::now();
+    std::unique_lock<LockedSociSession::mutex> lock(reader.mutex);
+    ++readWaits_;
+    readWaitTime_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return LockedSociSession(reader.session, std::move(lock));
+}
+
+DatabaseCon::ReadStats
+DatabaseCon::readStats() const
+{
+    ReadStats result;
+    result.count = reads_;
+    result.waits = readWaits_;
+    result.waitTime = std::chrono::microseconds(readWaitTime_.load());
+    return result;
+}
+
 DatabaseCon::Setup
 setup_DatabaseCon(Config const& c, boost::optional<beast::Journal> j)
 {
@@ -237,6 +278,31 @@ setup_DatabaseCon(Config const& c, boost::optional<beast::Journal> j)
     }
     setup.useGlobalPragma = true;
 
+    {
+        // Readers only avoid waiting on each other and on writes in WAL
+        // mode, so other modes use the single session
+        auto const& sqlite = c.section("sqlite");
+        std::string journal_mode = "wal";
+        set(journal_mode, "journal_mode", sqlite);
+        std::string safety_level;
+        set(safety_level, "safety_level", sqlite);
+        bool const wal = boost::iequals(journal_mode, "wal") &&
+            !boost::iequals(safety_level, "low");
+
+        std::size_t readSessions = 4;
+        bool const configured = set(readSessions, "read_sessions", sqlite);
+        if (readSessions > 64)
+            Throw<std::runtime_error>(
+                "Invalid read_sessions value: " +
+                std::to_string(readSessions));
+        if (wal)
+            setup.readSessions = readSessions;
+        else if (configured && readSessions != 0)
+            Throw<std::runtime_error>(
+                "Configuration file may only define \"read_sessions\" "
+                "with \"journal_mode\" wal");
+    }
+
     return setup;
 }
 
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/CpuProfile.h>
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
@@ -36,6 +37,8 @@ JobQueue::JobQueue(
     , m_processCount(0)
     , m_workers(*this, &perfLog, "JobQueue", 0)
     , m_cancelCallback(std::bind(&Stoppable::isStopping, this))
+    , m_consensusLane(*this)
+    , m_consensusWorkers(m_consensusLane, &perfLog, "JobQueueConsensus", 0)
     , perfLog_(perfLog)
     , m_collector(collector)
 {
@@ -70,7 +73,7 @@ void
 JobQueue::collect()
 {
     std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    job_count = m_jobCount;
 }
 
 bool
@@ -92,6 +95,10 @@ JobQueue::addRefCountedJob(
     // do not add jobs to a queue with no threads
     assert(type == jtCLIENT || m_workers.getNumberOfThreads() > 0);
 
+    // Build the job before taking the lock, so that submitters don't
+    // hold up each other or the workers while allocating.
+    Job job(type, name, ++m_lastJob, data.load(), func, m_cancelCallback);
+
     {
         std::lock_guard lock(m_mutex);
 
@@ -108,11 +115,9 @@ JobQueue::addRefCountedJob(
         //
         assert(
             !isStopped() &&
-            (m_processCount > 0 || !m_jobSet.empty() || !areChildrenStopped()));
+            (m_processCount > 0 || m_jobCount != 0 || !areChildrenStopped()));
 
-        std::pair<std::set<Job>::iterator, bool> result(m_jobSet.insert(
-            Job(type, name, ++m_lastJob, data.load(), func, m_cancelCallback)));
-        queueJob(*result.first, lock);
+        queueJob(std::move(job), lock);
     }
     return true;
 }
@@ -154,6 +159,29 @@ JobQueue::getJobCountGE(JobType t) const
     return ret;
 }
 
+bool
+JobQueue::isBehind(JobType t) const
+{
+    std::lock_guard lock(m_mutex);
+
+    if (!m_deadlines)
+        return false;
+
+    auto const now = Job::clock_type::now();
+    for (auto iter = m_jobData.rbegin();
+         iter != m_jobData.rend() && iter->first > t;
+         ++iter)
+    {
+        auto const& data = iter->second;
+        auto const target = data.info.getAverageLatency();
+        if (target.count() != 0 && !data.queue.empty() &&
+            now - data.queue.front().queue_time() > target)
+            return true;
+    }
+
+    return false;
+}
+
 void
 JobQueue::setThreadCount(int c, bool const standaloneMode)
 {
@@ -177,6 +205,37 @@ JobQueue::setThreadCount(int c, bool const standaloneMode)
     m_workers.setNumberOfThreads(c);
 }
 
+void
+JobQueue::setConsensusThreadCount(int c)
+{
+    if (c != 0)
+        JLOG(m_journal.info()) << "Configured " << c
+                               << " trusted proposal/validation threads.";
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_consensusThreads = c;
+    }
+    m_consensusWorkers.setNumberOfThreads(c);
+}
+
+void
+JobQueue::setThreadAffinity(CpuSet const& cpus)
+{
+    if (!cpus.empty())
+        JLOG(m_journal.info()) << "Running job threads on " << cpus.size()
+                               << " processors";
+    m_workers.setAffinity(cpus);
+    m_consensusWorkers.setAffinity(cpus);
+}
+
+void
+JobQueue::setDeadlines(bool enable)
+{
+    std::lock_guard lock(m_mutex);
+    m_deadlines = enable;
+}
+
 std::unique_ptr<LoadEvent>
 JobQueue::makeLoadEvent(JobType t, std::string const& name)
 {
@@ -222,6 +281,15 @@ JobQueue::getJson(int c)
 
     ret["threads"] = m_workers.getNumberOfThreads();
 
+    if (auto const jobs = m_consensusJobs.load())
+    {
+        Json::Value& lane = ret["consensus"] = Json::objectValue;
+        lane["threads"] = m_consensusWorkers.getNumberOfThreads();
+        lane["jobs"] = std::to_string(jobs);
+        lane["avg_wait_us"] = std::to_string(m_consensusWait.load() / jobs);
+        lane["peak_wait_us"] = std::to_string(m_consensusPeakWait.load());
+    }
+
     Json::Value priorities = Json::arrayValue;
 
     std::lock_guard lock(m_mutex);
@@ -276,7 +344,7 @@ void
 JobQueue::rendezvous()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [&] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(lock, [&] { return m_processCount == 0 && m_jobCount == 0; });
 }
 
 JobTypeData&
@@ -312,25 +380,42 @@ JobQueue::checkStopped(std::lock_guard<std::mutex> const& lock)
     //  5. There are no suspended coroutines
     //
     if (isStopping() && areChildrenStopped() && (m_processCount == 0) &&
-        m_jobSet.empty() && nSuspend_ == 0)
+        m_jobCount == 0 && nSuspend_ == 0)
     {
         stopped();
     }
 }
 
+bool
+JobQueue::onConsensusLane(JobType type) const
+{
+    return m_consensusThreads != 0 &&
+        (type == jtPROPOSAL_t || type == jtVALIDATION_t);
+}
+
+void
+JobQueue::signal(JobType type)
+{
+    if (onConsensusLane(type))
+        m_consensusWorkers.addTask();
+    else
+        m_workers.addTask();
+}
+
 void
-JobQueue::queueJob(Job const& job, std::lock_guard<std::mutex> const& lock)
+JobQueue::queueJob(Job&& job, std::lock_guard<std::mutex> const& lock)
 {
     JobType const type(job.getType());
     assert(type != jtINVALID);
-    assert(m_jobSet.find(job) != m_jobSet.end());
     perfLog_.jobQueue(type);
 
     JobTypeData& data(getJobTypeData(type));
+    data.queue.push_back(std::move(job));
+    ++m_jobCount;
 
-    if (data.waiting + data.running < getJobLimit(type))
+    if (data.waiting + data.running < data.info.limit())
     {
-        m_workers.addTask();
+        signal(type);
     }
     else
     {
@@ -342,37 +427,53 @@ JobQueue::queueJob(Job const& job, std::lock_guard<std::mutex> const& lock)
 }
 
 void
-JobQueue::getNextJob(Job& job)
+JobQueue::getNextJob(Job& job, bool consensus)
 {
-    assert(!m_jobSet.empty());
-
-    std::set<Job>::const_iterator iter;
-    for (iter = m_jobSet.begin(); iter != m_jobSet.end(); ++iter)
+    assert(m_jobCount != 0);
+
+    auto take = [&](JobTypeData& data) {
+        assert(data.waiting > 0);
+        assert(data.type() != jtINVALID);
+
+        job = std::move(data.queue.front());
+        data.queue.pop_front();
+        --m_jobCount;
+
+        --data.waiting;
+        ++data.running;
+    };
+
+    // A job may run if its type is running below the limit, and only on
+    // the workers serving its type.
+    auto runnable = [&](JobTypeData const& data) {
+        assert(data.running <= data.info.limit());
+        return !data.queue.empty() && data.running < data.info.limit() &&
+            onConsensusLane(data.type()) == consensus;
+    };
+
+    // Types whose oldest job has used half of its latency target go first
+    if (m_deadlines)
     {
-        JobTypeData& data(getJobTypeData(iter->getType()));
-
-        assert(data.running <= getJobLimit(data.type()));
-
-        // Run this job if we're running below the limit.
-        if (data.running < getJobLimit(data.type()))
+        auto const now = Job::clock_type::now();
+        for (auto iter = m_jobData.rbegin(); iter != m_jobData.rend(); ++iter)
         {
-            assert(data.waiting > 0);
-            break;
+            JobTypeData& data(iter->second);
+            auto const target = data.info.getAverageLatency();
+            if (target.count() != 0 && runnable(data) &&
+                2 * (now - data.queue.front().queue_time()) >= target)
+                return take(data);
         }
     }
 
-    assert(iter != m_jobSet.end());
-
-    JobType const type = iter->getType();
-    JobTypeData& data(getJobTypeData(type));
-
-    assert(type != jtINVALID);
-
-    job = *iter;
-    m_jobSet.erase(iter);
+    // Later job types have higher priority, and jobs of the same type run
+    // in the order they were added.
+    for (auto iter = m_jobData.rbegin(); iter != m_jobData.rend(); ++iter)
+    {
+        if (runnable(iter->second))
+            return take(iter->second);
+    }
 
-    --data.waiting;
-    ++data.running;
+    assert(false);
 }
 
 void
@@ -385,10 +486,10 @@ JobQueue::finishJob(JobType type)
     // Queue a deferred task if possible
     if (data.deferred > 0)
     {
-        assert(data.running + data.waiting >= getJobLimit(type));
+        assert(data.running + data.waiting >= data.info.limit());
 
         --data.deferred;
-        m_workers.addTask();
+        signal(type);
     }
 
     --data.running;
@@ -396,6 +497,12 @@ JobQueue::finishJob(JobType type)
 
 void
 JobQueue::processTask(int instance)
+{
+    runTask(instance, false);
+}
+
+void
+JobQueue::runTask(int instance, bool consensus)
 {
     JobType type;
 
@@ -406,7 +513,7 @@ JobQueue::processTask(int instance)
             Job job;
             {
                 std::lock_guard lock(m_mutex);
-                getNextJob(job);
+                getNextJob(job, consensus);
                 ++m_processCount;
             }
             type = job.getType();
@@ -418,16 +525,31 @@ JobQueue::processTask(int instance)
                 date::ceil<microseconds>(start_time - job.queue_time());
             perfLog_.jobStart(type, q_time, start_time, instance);
 
+            if (consensus)
+            {
+                auto const wait = static_cast<std::uint64_t>(q_time.count());
+                ++m_consensusJobs;
+                m_consensusWait += wait;
+                auto peak = m_consensusPeakWait.load();
+                while (wait > peak &&
+                       !m_consensusPeakWait.compare_exchange_weak(peak, wait))
+                    ;
+            }
+
+            setCpuProfileTag(data.info.name().c_str());
             job.doJob();
+            setCpuProfileTag(nullptr);
 
             // The amount of time it took to execute the job
             auto const x_time =
                 date::ceil<microseconds>(Job::clock_type::now() - start_time);
 
+            data.dequeueLatency.notify(q_time);
+            data.executeLatency.notify(x_time);
             if (x_time >= 10ms || q_time >= 10ms)
             {
-                getJobTypeData(type).dequeue.notify(q_time);
-                getJobTypeData(type).execute.notify(x_time);
+                data.dequeue.notify(q_time);
+                data.execute.notify(x_time);
             }
             perfLog_.jobFinish(type, x_time, instance);
         }
@@ -439,7 +561,7 @@ JobQueue::processTask(int instance)
         // otherwise destructors with side effects can access
         // parent objects that are already destroyed.
         finishJob(type);
-        if (--m_processCount == 0 && m_jobSet.empty())
+        if (--m_processCount == 0 && m_jobCount == 0)
             cv_.notify_all();
         checkStopped(lock);
     }
@@ -448,15 +570,6 @@ JobQueue::processTask(int instance)
     // to the associated LoadEvent object (in the Job) may be destroyed.
 }
 
-int
-JobQueue::getJobLimit(JobType type)
-{
-    JobTypeInfo const& j(JobTypes::instance().get(type));
-    assert(j.type() != jtINVALID);
-
-    return j.limit();
-}
-
 void
 JobQueue::onChildrenStopped()
 {
@@ -110,6 +110,12 @@ Workers::setNumberOfThreads(int numberOfThreads)
     }
 }
 
+void
+Workers::setAffinity(CpuSet cpus)
+{
+    m_affinity = std::move(cpus);
+}
+
 void
 Workers::pauseAllThreadsAndWait()
 {
@@ -162,6 +168,7 @@ Workers::Worker::Worker(
     : m_workers{workers}
     , threadName_{threadName}
     , instance_{instance}
+    , affinity_{workers.m_affinity}
     , wakeCount_{0}
     , shouldExit_{false}
 {
@@ -191,6 +198,9 @@ Workers::Worker::notify()
 void
 Workers::Worker::run()
 {
+    // Best effort: a thread which can't be pinned still does its work
+    setCurrentThreadAffinity(affinity_);
+
     bool shouldExit = true;
     do
     {
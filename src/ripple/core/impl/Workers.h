@@ -20,6 +20,7 @@
 #ifndef RIPPLE_CORE_WORKERS_H_INCLUDED
 #define RIPPLE_CORE_WORKERS_H_INCLUDED
 
+#include <ripple/basics/ThreadAffinity.h>
 #include <ripple/beast/core/LockFreeStack.h>
 #include <ripple/core/impl/semaphore.h>
 #include <atomic>
@@ -95,6 +96,12 @@ public:
     void
     setNumberOfThreads(int numberOfThreads);
 
+    /** Restrict threads created from now on to the given processors.
+        @note This function is not thread-safe.
+    */
+    void
+    setAffinity(CpuSet cpus);
+
     /** Pause all threads and wait until they are paused.
 
         If a thread is processing a task it will pause as soon as the task
@@ -162,6 +169,7 @@ private:
         Workers& m_workers;
         std::string const threadName_;
         int const instance_;
+        CpuSet const affinity_;
 
         std::thread thread_;
         std::mutex mutex_;
@@ -178,6 +186,7 @@ private:
     Callback& m_callback;
     perf::PerfLog* perfLog_;
     std::string m_threadNames;     // The name to give each thread
+    CpuSet m_affinity;             // The processors to run new threads on
     std::condition_variable m_cv;  // signaled when all threads paused
     std::mutex m_mut;
     bool m_allPaused;
@@ -21,6 +21,7 @@
 #define RIPPLE_CRYPTO_RANDOM_H_INCLUDED
 
 #include <mutex>
+#include <openssl/opensslv.h>
 #include <string>
 #include <type_traits>
 
@@ -28,16 +29,23 @@ namespace ripple {
 
 /** A cryptographically secure random number engine
 
-    The engine is thread-safe (it uses a lock to serialize
-    access) and will, automatically, mix in some randomness
-    from std::random_device.
+    The engine is thread-safe and will, automatically, mix in
+    some randomness from std::random_device.
+
+    With OpenSSL 1.1.0 or later the engine takes no lock of its
+    own: OpenSSL is itself thread-safe, and from 1.1.1 gives each
+    thread its own DRBG, seeded and reseeded from the system, so
+    threads generating keys or nonces do not wait on each other.
+    With older versions of OpenSSL a lock serializes access.
 
     Meets the requirements of UniformRandomNumberEngine
 */
 class csprng_engine
 {
 private:
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
     std::mutex mutex_;
+#endif
 
     void
     mix(void* buffer, std::size_t count, double bitsPerByte);
@@ -35,7 +35,10 @@ csprng_engine::mix(void* data, std::size_t size, double bitsPerByte)
     assert(size != 0);
     assert(bitsPerByte != 0);
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
     std::lock_guard lock(mutex_);
+#endif
+
     RAND_add(data, size, (size * bitsPerByte) / 8.0);
 }
 
@@ -81,7 +84,9 @@ csprng_engine::operator()()
 {
     result_type ret;
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
     std::lock_guard lock(mutex_);
+#endif
 
     auto const result =
         RAND_bytes(reinterpret_cast<unsigned char*>(&ret), sizeof(ret));
@@ -95,7 +100,9 @@ csprng_engine::operator()()
 void
 csprng_engine::operator()(void* ptr, std::size_t count)
 {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
     std::lock_guard lock(mutex_);
+#endif
 
     auto const result =
         RAND_bytes(reinterpret_cast<unsigned char*>(ptr), count);
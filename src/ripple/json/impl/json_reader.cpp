@@ -21,6 +21,7 @@
 #include <ripple/json/json_reader.h>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <string>
 
 namespace Json {
@@ -396,6 +397,17 @@ Reader::readNumber()
 bool
 Reader::readString()
 {
+    // Most strings have no escapes, so look for the closing quote with
+    // memchr and only step through the string when there is a backslash
+    // before it.
+    if (auto const quote = static_cast<Location>(
+            std::memchr(current_, '"', end_ - current_));
+        quote && !std::memchr(current_, '\\', quote - current_))
+    {
+        current_ = quote + 1;
+        return true;
+    }
+
     Char c = 0;
 
     while (current_ != end_)
@@ -447,11 +459,12 @@ Reader::readObject(Token& tokenStart, unsigned depth)
                 "Missing ':' after object member name", colon, tokenObjectEnd);
         }
 
-        // Reject duplicate names
-        if (currentValue().isMember(name))
+        // Reject duplicate names, which did not add a member
+        auto const size = currentValue().size();
+        Value& value = currentValue()[name];
+        if (currentValue().size() == size)
             return addError("Key '" + name + "' appears twice.", tokenName);
 
-        Value& value = currentValue()[name];
         nodes_.push(&value);
         bool ok = readValue(depth + 1);
         nodes_.pop();
@@ -679,11 +692,20 @@ Reader::decodeString(Token& token, std::string& decoded)
 
     while (current != end)
     {
+        // Copy everything up to the next escape at once
+        auto const escape = static_cast<Location>(
+            std::memchr(current, '\\', end - current));
+        if (!escape)
+        {
+            decoded.append(current, end);
+            break;
+        }
+        decoded.append(current, escape);
+        current = escape;
+
         Char c = *current++;
 
-        if (c == '"')
-            break;
-        else if (c == '\\')
+        if (c == '\\')
         {
             if (current == end)
                 return addError(
@@ -740,10 +762,6 @@ Reader::decodeString(Token& token, std::string& decoded)
                         "Bad escape sequence in string", token, current);
             }
         }
-        else
-        {
-            decoded += c;
-        }
     }
 
     return true;
@@ -17,14 +17,119 @@
 */
 //==============================================================================
 
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/json/impl/json_assert.h>
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
+#include <array>
+#include <memory>
+#include <new>
 
 namespace Json {
 
+namespace detail {
+
+namespace {
+
+// Blocks are pooled in sizes which are multiples of the granularity, up
+// to the largest pooled size. Each thread keeps at most maxFree free
+// blocks of each size.
+std::size_t constexpr granularity = 16;
+std::size_t constexpr maxPooled = 256;
+std::size_t constexpr sizeCount = maxPooled / granularity;
+std::size_t constexpr maxFree = 1024;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct FreeLists
+{
+    std::array<FreeBlock*, sizeCount> heads{};
+    std::array<std::size_t, sizeCount> counts{};
+
+    ~FreeLists();
+};
+
+// Values may be destroyed after this thread's lists, for instance by
+// the destructors of statics, so these are kept as plain variables.
+thread_local FreeLists* threadLists = nullptr;
+thread_local bool threadListsGone = false;
+
+FreeLists*
+freeLists()
+{
+    if (!threadLists && !threadListsGone)
+    {
+        thread_local FreeLists lists;
+        threadLists = &lists;
+    }
+    return threadLists;
+}
+
+FreeLists::~FreeLists()
+{
+    threadLists = nullptr;
+    threadListsGone = true;
+    for (auto block : heads)
+    {
+        while (block)
+        {
+            auto const next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+}
+
+}  // namespace
+
+void*
+allocateBlock(std::size_t size)
+{
+    ripple::MemoryUsage::allocate(ripple::MemoryTag::json, size);
+    if (size == 0 || size > maxPooled)
+        return ::operator new(size);
+
+    auto const index = (size - 1) / granularity;
+    if (auto lists = freeLists())
+    {
+        if (auto block = lists->heads[index])
+        {
+            lists->heads[index] = block->next;
+            --lists->counts[index];
+            return block;
+        }
+    }
+    return ::operator new((index + 1) * granularity);
+}
+
+void
+releaseBlock(void* p, std::size_t size) noexcept
+{
+    if (p)
+        ripple::MemoryUsage::deallocate(ripple::MemoryTag::json, size);
+    if (p && size != 0 && size <= maxPooled)
+    {
+        auto const index = (size - 1) / granularity;
+        auto lists = freeLists();
+        if (lists && lists->counts[index] < maxFree)
+        {
+            auto block = static_cast<FreeBlock*>(p);
+            block->next = lists->heads[index];
+            lists->heads[index] = block;
+            ++lists->counts[index];
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+}  // namespace detail
+
 const Value Value::null;
 const Int Value::minInt = Int(~(UInt(-1) / 2));
 const Int Value::maxInt = Int(UInt(-1) / 2);
@@ -58,7 +163,12 @@ public:
         if (length == unknown)
             length = value ? (unsigned int)strlen(value) : 0;
 
-        char* newString = static_cast<char*>(malloc(length + 1));
+        // The size of the block is kept in front of the string
+        std::size_t const size = sizeof(std::size_t) + length + 1;
+        char* block = static_cast<char*>(detail::allocateBlock(size));
+        memcpy(block, &size, sizeof(size));
+
+        char* newString = block + sizeof(size);
         if (value)
             memcpy(newString, value, length);
         newString[length] = 0;
@@ -69,7 +179,12 @@ public:
     releaseStringValue(char* value) override
     {
         if (value)
-            free(value);
+        {
+            char* block = value - sizeof(std::size_t);
+            std::size_t size;
+            memcpy(&size, block, sizeof(size));
+            detail::releaseBlock(block, size);
+        }
     }
 };
 
@@ -165,6 +280,29 @@ Value::CZString::isStaticString() const
     return index_ == noDuplication;
 }
 
+template <class... Args>
+static Value::ObjectValues*
+newObjectValues(Args&&... args)
+{
+    void* p = detail::allocateBlock(sizeof(Value::ObjectValues));
+    try
+    {
+        return new (p) Value::ObjectValues(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        detail::releaseBlock(p, sizeof(Value::ObjectValues));
+        throw;
+    }
+}
+
+static void
+deleteObjectValues(Value::ObjectValues* map)
+{
+    std::destroy_at(map);
+    detail::releaseBlock(map, sizeof(Value::ObjectValues));
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -199,7 +337,7 @@ Value::Value(ValueType type) : type_(type), allocated_(0)
 
         case arrayValue:
         case objectValue:
-            value_.map_ = new ObjectValues();
+            value_.map_ = newObjectValues();
             break;
 
         case booleanValue:
@@ -273,7 +411,7 @@ Value::Value(const Value& other) : type_(other.type_)
 
         case arrayValue:
         case objectValue:
-            value_.map_ = new ObjectValues(*other.value_.map_);
+            value_.map_ = newObjectValues(*other.value_.map_);
             break;
 
         default:
@@ -301,7 +439,7 @@ Value::~Value()
         case arrayValue:
         case objectValue:
             if (value_.map_)
-                delete value_.map_;
+                deleteObjectValues(value_.map_);
             break;
 
         default:
@@ -138,6 +138,12 @@ ValueIteratorBase::memberName() const
     return name ? name : "";
 }
 
+bool
+ValueIteratorBase::memberNameIsStatic() const
+{
+    return (*current_).first.isStaticString();
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
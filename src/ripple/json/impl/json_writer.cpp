@@ -18,7 +18,10 @@
 //==============================================================================
 
 #include <ripple/json/json_writer.h>
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <cstdint>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -32,56 +35,128 @@ isControlCharacter(char ch)
     return ch > 0 && ch <= 0x1F;
 }
 
-static bool
-containsControlCharacter(const char* str)
+// Append `value` in quotes, with the characters JSON requires escaped
+static void
+appendQuoted(std::string& out, const char* value)
 {
-    while (*str)
+    static char const hex[] = "0123456789ABCDEF";
+
+    out += '"';
+    // Copy runs of characters which need no escape all at once
+    const char* run = value;
+    for (const char* c = value; *c != 0; ++c)
     {
-        if (isControlCharacter(*(str++)))
-            return true;
+        char const* escape = nullptr;
+        switch (*c)
+        {
+            case '\"':
+                escape = "\\\"";
+                break;
+            case '\\':
+                escape = "\\\\";
+                break;
+            case '\b':
+                escape = "\\b";
+                break;
+            case '\f':
+                escape = "\\f";
+                break;
+            case '\n':
+                escape = "\\n";
+                break;
+            case '\r':
+                escape = "\\r";
+                break;
+            case '\t':
+                escape = "\\t";
+                break;
+            default:
+                // Even though \/ is considered a legal escape in JSON, a bare
+                // slash is also legal, so it is not escaped.
+                if (!isControlCharacter(*c))
+                    continue;
+                break;
+        }
+
+        out.append(run, c - run);
+        run = c + 1;
+        if (escape)
+        {
+            out += escape;
+        }
+        else
+        {
+            out += "\\u00";
+            out += hex[(*c >> 4) & 0xF];
+            out += hex[*c & 0xF];
+        }
     }
+    out.append(run);
+    out += '"';
+}
 
-    return false;
+template <class Integer>
+static void
+appendInteger(std::string& out, Integer value)
+{
+    char buffer[24];
+    auto const result =
+        std::to_chars(buffer, buffer + sizeof(buffer), value);
+    assert(result.ec == std::errc());
+    out.append(buffer, result.ptr);
 }
+
+// Append a quoted object key followed by a colon.
+//
+// Almost every key is a StaticString, usually one of the jss constants,
+// which lives as long as the program. Their quoted forms are kept by
+// address in a small table for each thread, so that writing one is a
+// single copy.
 static void
-uintToString(unsigned int value, char*& current)
+appendKey(std::string& out, ValueConstIterator const& it)
 {
-    *--current = 0;
+    const char* const name = it.memberName();
+    if (!it.memberNameIsStatic())
+    {
+        appendQuoted(out, name);
+        out += ':';
+        return;
+    }
 
-    do
+    struct Entry
     {
-        *--current = (value % 10) + '0';
-        value /= 10;
-    } while (value != 0);
+        const char* key = nullptr;
+        std::string quoted;
+    };
+    static constexpr std::size_t tableSize = 512;
+    thread_local std::array<Entry, tableSize> table;
+
+    auto& entry =
+        table[(reinterpret_cast<std::uintptr_t>(name) >> 3) % tableSize];
+    if (entry.key != name)
+    {
+        entry.key = name;
+        entry.quoted.clear();
+        appendQuoted(entry.quoted, name);
+        entry.quoted += ':';
+    }
+    out += entry.quoted;
 }
 
 std::string
 valueToString(Int value)
 {
-    char buffer[32];
-    char* current = buffer + sizeof(buffer);
-    bool isNegative = value < 0;
-
-    if (isNegative)
-        value = -value;
-
-    uintToString(UInt(value), current);
-
-    if (isNegative)
-        *--current = '-';
-
-    assert(current >= buffer);
-    return current;
+    std::string result;
+    appendInteger(result, value);
+    return result;
 }
 
 std::string
 valueToString(UInt value)
 {
-    char buffer[32];
-    char* current = buffer + sizeof(buffer);
-    uintToString(value, current);
-    assert(current >= buffer);
-    return current;
+    std::string result;
+    appendInteger(result, value);
+    return result;
 }
 
 std::string
@@ -112,158 +187,94 @@ valueToString(bool value)
 std::string
 valueToQuotedString(const char* value)
 {
-    // Not sure how to handle unicode...
-    if (strpbrk(value, "\"\\\b\f\n\r\t") == nullptr &&
-        !containsControlCharacter(value))
-        return std::string("\"") + value + "\"";
-
-    // We have to walk value and escape any special characters.
-    // Appending to std::string is not efficient, but this should be rare.
-    // (Note: forward slashes are *not* rare, but I am not escaping them.)
-    unsigned maxsize = strlen(value) * 2 + 3;  // allescaped+quotes+NULL
     std::string result;
-    result.reserve(maxsize);  // to avoid lots of mallocs
-    result += "\"";
-
-    for (const char* c = value; *c != 0; ++c)
-    {
-        switch (*c)
-        {
-            case '\"':
-                result += "\\\"";
-                break;
-
-            case '\\':
-                result += "\\\\";
-                break;
-
-            case '\b':
-                result += "\\b";
-                break;
-
-            case '\f':
-                result += "\\f";
-                break;
-
-            case '\n':
-                result += "\\n";
-                break;
-
-            case '\r':
-                result += "\\r";
-                break;
-
-            case '\t':
-                result += "\\t";
-                break;
-
-                // case '/':
-                // Even though \/ is considered a legal escape in JSON, a bare
-                // slash is also legal, so I see no reason to escape it.
-                // (I hope I am not misunderstanding something.
-                // blep notes: actually escaping \/ may be useful in javascript
-                // to avoid </ sequence. Should add a flag to allow this
-                // compatibility mode and prevent this sequence from occurring.
-            default:
-                if (isControlCharacter(*c))
-                {
-                    std::ostringstream oss;
-                    oss << "\\u" << std::hex << std::uppercase
-                        << std::setfill('0') << std::setw(4)
-                        << static_cast<int>(*c);
-                    result += oss.str();
-                }
-                else
-                {
-                    result += *c;
-                }
-
-                break;
-        }
-    }
-
-    result += "\"";
+    appendQuoted(result, value);
     return result;
 }
 
-// Class FastWriter
-// //////////////////////////////////////////////////////////////////
-
-std::string
-FastWriter::write(const Value& root)
-{
-    document_ = "";
-    writeValue(root);
-    return std::move(document_);
-}
+namespace detail {
 
 void
-FastWriter::writeValue(const Value& value)
+writeCompact(
+    Value const& value,
+    std::string& buffer,
+    std::function<void(std::string&)> const& flush)
 {
+    // Hand off the buffer in pieces of about this many bytes
+    static constexpr std::size_t chunkSize = 4096;
+
     switch (value.type())
     {
         case nullValue:
-            document_ += "null";
+            buffer += "null";
             break;
 
         case intValue:
-            document_ += valueToString(value.asInt());
+            appendInteger(buffer, value.asInt());
             break;
 
         case uintValue:
-            document_ += valueToString(value.asUInt());
+            appendInteger(buffer, value.asUInt());
             break;
 
         case realValue:
-            document_ += valueToString(value.asDouble());
+            buffer += valueToString(value.asDouble());
             break;
 
         case stringValue:
-            document_ += valueToQuotedString(value.asCString());
+            appendQuoted(buffer, value.asCString());
             break;
 
         case booleanValue:
-            document_ += valueToString(value.asBool());
+            buffer += value.asBool() ? "true" : "false";
             break;
 
         case arrayValue: {
-            document_ += "[";
-            int size = value.size();
-
-            for (int index = 0; index < size; ++index)
+            // Walk the elements rather than looking each one up. Indexes
+            // which were never set are null.
+            buffer += '[';
+            UInt next = 0;
+            for (auto it = value.begin(); it != value.end(); ++it)
             {
-                if (index > 0)
-                    document_ += ",";
-
-                writeValue(value[index]);
+                for (; next < it.index(); ++next)
+                    buffer += next == 0 ? "null" : ",null";
+                if (next++ != 0)
+                    buffer += ',';
+                writeCompact(*it, buffer, flush);
             }
-
-            document_ += "]";
+            buffer += ']';
+            break;
         }
-        break;
 
         case objectValue: {
-            Value::Members members(value.getMemberNames());
-            document_ += "{";
-
-            for (Value::Members::iterator it = members.begin();
-                 it != members.end();
-                 ++it)
+            buffer += '{';
+            for (auto it = value.begin(); it != value.end(); ++it)
             {
-                std::string const& name = *it;
-
-                if (it != members.begin())
-                    document_ += ",";
-
-                document_ += valueToQuotedString(name.c_str());
-                document_ += ":";
-                writeValue(value[name]);
+                if (it != value.begin())
+                    buffer += ',';
+                appendKey(buffer, it);
+                writeCompact(*it, buffer, flush);
             }
-
-            document_ += "}";
+            buffer += '}';
+            break;
         }
-        break;
     }
+
+    if (flush && buffer.size() >= chunkSize)
+        flush(buffer);
+}
+
+}  // namespace detail
+
+// Class FastWriter
+// //////////////////////////////////////////////////////////////////
+
+std::string
+FastWriter::write(const Value& root)
+{
+    document_.clear();
+    detail::writeCompact(root, document_);
+    return std::move(document_);
 }
 
 // Class StyledWriter
@@ -21,7 +21,9 @@
 #define RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 
 #include <ripple/json/json_forwards.h>
+#include <cstddef>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -115,6 +117,65 @@ operator!=(StaticString x, std::string const& y)
     return !(y == x);
 }
 
+namespace detail {
+
+/** Allocate a small block of memory for a Value.
+
+    Freed blocks are kept on a list for the thread which frees them, and
+    handed out again for the next block of about the same size. Building
+    and destroying a large response, which is made of many small blocks,
+    then rarely needs the global heap.
+*/
+void*
+allocateBlock(std::size_t size);
+
+/** Free a block from allocateBlock with the same size. */
+void
+releaseBlock(void* p, std::size_t size) noexcept;
+
+/** An allocator for the containers inside a Value. */
+template <class T>
+class BlockAllocator
+{
+public:
+    using value_type = T;
+
+    BlockAllocator() = default;
+
+    template <class U>
+    BlockAllocator(BlockAllocator<U> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(allocateBlock(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        releaseBlock(p, n * sizeof(T));
+    }
+
+    template <class U>
+    bool
+    operator==(BlockAllocator<U> const&) const noexcept
+    {
+        return true;
+    }
+
+    template <class U>
+    bool
+    operator!=(BlockAllocator<U> const&) const noexcept
+    {
+        return false;
+    }
+};
+
+}  // namespace detail
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represent a:
@@ -191,7 +252,11 @@ private:
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    using ObjectValues = std::map<
+        CZString,
+        Value,
+        std::less<CZString>,
+        detail::BlockAllocator<std::pair<CZString const, Value>>>;
 
 public:
     /** \brief Create a default Value of the given type.
@@ -528,6 +593,11 @@ public:
     const char*
     memberName() const;
 
+    /// Return whether the member name is a StaticString, which outlives
+    /// every Value.
+    bool
+    memberNameIsStatic() const;
+
 protected:
     Value&
     deref() const;
@@ -22,7 +22,9 @@
 
 #include <ripple/json/json_forwards.h>
 #include <ripple/json/json_value.h>
+#include <functional>
 #include <ostream>
+#include <string>
 #include <vector>
 
 namespace Json {
@@ -62,9 +64,6 @@ public:  // overridden from Writer
     write(const Value& root) override;
 
 private:
-    void
-    writeValue(const Value& value);
-
     std::string document_;
 };
 
@@ -218,73 +217,28 @@ operator<<(std::ostream&, const Value& root);
 // Helpers for stream
 namespace detail {
 
-template <class Write>
+/** Append compact JSON for a value to a buffer.
+
+    If `flush` is set, it is called to hand off the buffer whenever it
+    holds more than about a page, and must leave the buffer empty.
+*/
 void
-write_string(Write const& write, std::string const& s)
-{
-    write(s.data(), s.size());
-}
+writeCompact(
+    Value const& value,
+    std::string& buffer,
+    std::function<void(std::string&)> const& flush = nullptr);
 
 template <class Write>
 void
 write_value(Write const& write, Value const& value)
 {
-    switch (value.type())
-    {
-        case nullValue:
-            write("null", 4);
-            break;
-
-        case intValue:
-            write_string(write, valueToString(value.asInt()));
-            break;
-
-        case uintValue:
-            write_string(write, valueToString(value.asUInt()));
-            break;
-
-        case realValue:
-            write_string(write, valueToString(value.asDouble()));
-            break;
-
-        case stringValue:
-            write_string(write, valueToQuotedString(value.asCString()));
-            break;
-
-        case booleanValue:
-            write_string(write, valueToString(value.asBool()));
-            break;
-
-        case arrayValue: {
-            write("[", 1);
-            int const size = value.size();
-            for (int index = 0; index < size; ++index)
-            {
-                if (index > 0)
-                    write(",", 1);
-                write_value(write, value[index]);
-            }
-            write("]", 1);
-            break;
-        }
-
-        case objectValue: {
-            Value::Members const members = value.getMemberNames();
-            write("{", 1);
-            for (auto it = members.begin(); it != members.end(); ++it)
-            {
-                std::string const& name = *it;
-                if (it != members.begin())
-                    write(",", 1);
-
-                write_string(write, valueToQuotedString(name.c_str()));
-                write(":", 1);
-                write_value(write, value[name]);
-            }
-            write("}", 1);
-            break;
-        }
-    }
+    std::string buffer;
+    writeCompact(value, buffer, [&write](std::string& b) {
+        write(b.data(), b.size());
+        b.clear();
+    });
+    if (!buffer.empty())
+        write(buffer.data(), buffer.size());
 }
 
 }  // namespace detail
@@ -23,12 +23,18 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/container/aged_unordered_map.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
-/** Caches SLEs by their digest. */
+/** Caches SLEs by their digest.
+
+    The cache is split into partitions by digest, each with its own lock,
+    so that threads reading different entries rarely wait for each other.
+*/
 class CachedSLEs
 {
 public:
@@ -44,8 +50,11 @@ public:
     CachedSLEs(
         std::chrono::duration<Rep, Period> const& timeToLive,
         Stopwatch& clock)
-        : timeToLive_(timeToLive), map_(clock)
+        : timeToLive_(timeToLive)
     {
+        partitions_.reserve(partitionCount);
+        for (std::size_t i = 0; i < partitionCount; ++i)
+            partitions_.push_back(std::make_unique<Partition>(clock));
     }
 
     /** Discard expired entries.
@@ -66,24 +75,25 @@ public:
     value_type
     fetch(digest_type const& digest, Handler const& h)
     {
+        auto& p = partition(digest);
         {
-            std::lock_guard lock(mutex_);
-            auto iter = map_.find(digest);
-            if (iter != map_.end())
+            std::lock_guard lock(p.mutex);
+            auto iter = p.map.find(digest);
+            if (iter != p.map.end())
             {
-                ++hit_;
-                map_.touch(iter);
+                hit_.fetch_add(1, std::memory_order_relaxed);
+                p.map.touch(iter);
                 return iter->second;
             }
         }
         auto sle = h();
         if (!sle)
             return nullptr;
-        std::lock_guard lock(mutex_);
-        ++miss_;
-        auto const [it, inserted] = map_.emplace(digest, std::move(sle));
+        miss_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(p.mutex);
+        auto const [it, inserted] = p.map.emplace(digest, std::move(sle));
         if (!inserted)
-            map_.touch(it);
+            p.map.touch(it);
         return it->second;
     }
 
@@ -92,16 +102,35 @@ public:
     rate() const;
 
 private:
-    std::size_t hit_ = 0;
-    std::size_t miss_ = 0;
-    std::mutex mutable mutex_;
+    // Digests are uniformly distributed, so any of their bytes selects a
+    // partition evenly.
+    static constexpr std::size_t partitionCount = 16;
+
+    struct Partition
+    {
+        std::mutex mutex;
+        beast::aged_unordered_map<
+            digest_type,
+            value_type,
+            Stopwatch::clock_type,
+            hardened_hash<strong_hash>>
+            map;
+
+        explicit Partition(Stopwatch& clock) : map(clock)
+        {
+        }
+    };
+
+    Partition&
+    partition(digest_type const& digest)
+    {
+        return *partitions_[*digest.begin() % partitionCount];
+    }
+
+    std::atomic<std::size_t> hit_{0};
+    std::atomic<std::size_t> miss_{0};
     Stopwatch::duration timeToLive_;
-    beast::aged_unordered_map<
-        digest_type,
-        value_type,
-        Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        map_;
+    std::vector<std::unique_ptr<Partition>> partitions_;
 };
 
 }  // namespace ripple
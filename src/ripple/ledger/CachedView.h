@@ -20,12 +20,13 @@
 #ifndef RIPPLE_LEDGER_CACHEDVIEW_H_INCLUDED
 #define RIPPLE_LEDGER_CACHEDVIEW_H_INCLUDED
 
-#include <ripple/basics/hardened_hash.h>
+#include <ripple/basics/flat_hash_map.h>
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/ReadView.h>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <type_traits>
 
 namespace ripple {
@@ -37,11 +38,9 @@ class CachedViewImpl : public DigestAwareReadView
 private:
     DigestAwareReadView const& base_;
     CachedSLEs& cache_;
-    std::mutex mutable mutex_;
-    std::unordered_map<
-        key_type,
-        std::shared_ptr<SLE const>,
-        hardened_hash<>> mutable map_;
+    // Entries are added once and then only read, by many threads at once
+    std::shared_mutex mutable mutex_;
+    flat_hash_map<key_type, std::shared_ptr<SLE const>> mutable map_;
 
 public:
     CachedViewImpl() = delete;
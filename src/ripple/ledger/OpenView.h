@@ -24,8 +24,8 @@
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/detail/RawStateTable.h>
+#include <ripple/ledger/detail/ViewResource.h>
 
-#include <boost/container/pmr/monotonic_buffer_resource.hpp>
 #include <boost/container/pmr/polymorphic_allocator.hpp>
 
 #include <functional>
@@ -55,11 +55,6 @@ extern open_ledger_t const open_ledger;
 class OpenView final : public ReadView, public TxsRawView
 {
 private:
-    // Initial size for the monotonic_buffer_resource used for allocations
-    // The size was chosen from the old `qalloc` code (which this replaces).
-    // It is unclear how the size initially chosen in qalloc.
-    static constexpr size_t initialBufferSize = kilobytes(256);
-
     class txs_iter_impl;
 
     struct txData
@@ -88,8 +83,7 @@ private:
 
     // monotonic_resource_ must outlive `items_`. Make a pointer so it may be
     // easily moved.
-    std::unique_ptr<boost::container::pmr::monotonic_buffer_resource>
-        monotonic_resource_;
+    std::unique_ptr<detail::ViewResource> monotonic_resource_;
     txs_map txs_;
     Rules rules_;
     LedgerInfo info_;
@@ -27,9 +27,19 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
+/** A change to one state item, for RawView::rawApply */
+struct RawChange
+{
+    enum class Action { erase, insert, replace };
+
+    Action action;
+    std::shared_ptr<SLE> sle;
+};
+
 /** Interface for ledger entry changes.
 
     Subclasses allow raw modification of ledger entries.
@@ -80,6 +90,37 @@ public:
     virtual void
     rawReplace(std::shared_ptr<SLE> const& sle) = 0;
 
+    /** Erase, insert or replace a number of state items.
+
+        Requirements:
+
+            The changes are sorted by key, with no key appearing twice.
+
+        Effects:
+
+            As if each change were made in turn, which is what the default
+            does. A view may instead make them all together.
+    */
+    virtual void
+    rawApply(std::vector<RawChange> const& changes)
+    {
+        for (auto const& change : changes)
+        {
+            switch (change.action)
+            {
+                case RawChange::Action::erase:
+                    rawErase(change.sle);
+                    break;
+                case RawChange::Action::insert:
+                    rawInsert(change.sle);
+                    break;
+                case RawChange::Action::replace:
+                    rawReplace(change.sle);
+                    break;
+            }
+        }
+    }
+
     /** Destroy XRP.
 
         This is used to pay for transaction fees.
@@ -27,6 +27,8 @@
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/TxMeta.h>
 #include <ripple/protocol/TER.h>
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <memory>
 
 namespace ripple {
@@ -46,7 +48,18 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
+    // Most transactions touch only a handful of entries, so the items are
+    // kept sorted in a vector whose first few elements are stored inline.
+    // This applies a simple payment without allocating any tree nodes.
+    static constexpr std::size_t inlineItems = 8;
+
+    using item_t = std::pair<Action, std::shared_ptr<SLE>>;
+    using items_t = boost::container::flat_map<
+        key_type,
+        item_t,
+        std::less<key_type>,
+        boost::container::
+            small_vector<std::pair<key_type, item_t>, inlineItems>>;
 
     items_t items_;
     XRPAmount dropsDestroyed_{0};
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGER_VIEWRESOURCE_H_INCLUDED
+#define RIPPLE_LEDGER_VIEWRESOURCE_H_INCLUDED
+
+#include <ripple/basics/ByteUtilities.h>
+#include <boost/container/pmr/monotonic_buffer_resource.hpp>
+#include <memory>
+
+namespace ripple {
+namespace detail {
+
+/** A buffer taken from a pool shared by all views. */
+class ViewBuffer
+{
+public:
+    // The size was chosen from the old `qalloc` code, which the monotonic
+    // resources of views replaced.
+    static constexpr std::size_t size = kilobytes(256);
+
+    ViewBuffer();
+    ~ViewBuffer();
+
+    ViewBuffer(ViewBuffer const&) = delete;
+    ViewBuffer&
+    operator=(ViewBuffer const&) = delete;
+
+protected:
+    std::unique_ptr<char[]> buffer_;
+};
+
+/** The memory resource for the tables of a view.
+
+    An OpenView is made for nearly every transaction applied to the open
+    ledger, and its tables would each allocate, and usually map, a large
+    first buffer and free it again soon after. Instead the first buffer
+    is taken from a pool and given back when the resource is destroyed.
+    Anything beyond it is allocated as usual.
+*/
+class ViewResource : private ViewBuffer,
+                     public boost::container::pmr::monotonic_buffer_resource
+{
+public:
+    ViewResource()
+        : boost::container::pmr::monotonic_buffer_resource(
+              buffer_.get(),
+              ViewBuffer::size)
+    {
+    }
+};
+
+}  // namespace detail
+}  // namespace ripple
+
+#endif
@@ -31,6 +31,10 @@ void
 ApplyStateTable::apply(RawView& to) const
 {
     to.rawDestroyXRP(dropsDestroyed_);
+
+    // The items are sorted by key, so they can be applied together
+    std::vector<RawChange> changes;
+    changes.reserve(items_.size());
     for (auto const& item : items_)
     {
         auto const& sle = item.second.second;
@@ -39,16 +43,17 @@ ApplyStateTable::apply(RawView& to) const
             case Action::cache:
                 break;
             case Action::erase:
-                to.rawErase(sle);
+                changes.push_back({RawChange::Action::erase, sle});
                 break;
             case Action::insert:
-                to.rawInsert(sle);
+                changes.push_back({RawChange::Action::insert, sle});
                 break;
             case Action::modify:
-                to.rawReplace(sle);
+                changes.push_back({RawChange::Action::replace, sle});
                 break;
         };
     }
+    to.rawApply(changes);
 }
 
 std::size_t
@@ -26,11 +26,12 @@ void
 CachedSLEs::expire()
 {
     std::vector<std::shared_ptr<void const>> trash;
+    for (auto const& p : partitions_)
     {
-        auto const expireTime = map_.clock().now() - timeToLive_;
-        std::lock_guard lock(mutex_);
-        for (auto iter = map_.chronological.begin();
-             iter != map_.chronological.end();
+        auto const expireTime = p->map.clock().now() - timeToLive_;
+        std::lock_guard lock(p->mutex);
+        for (auto iter = p->map.chronological.begin();
+             iter != p->map.chronological.end();
              ++iter)
         {
             if (iter.when() > expireTime)
@@ -38,7 +39,7 @@ CachedSLEs::expire()
             if (iter->second.unique())
             {
                 trash.emplace_back(std::move(iter->second));
-                iter = map_.erase(iter);
+                iter = p->map.erase(iter);
             }
         }
     }
@@ -47,11 +48,11 @@ CachedSLEs::expire()
 double
 CachedSLEs::rate() const
 {
-    std::lock_guard lock(mutex_);
-    auto const tot = hit_ + miss_;
+    auto const hit = hit_.load(std::memory_order_relaxed);
+    auto const tot = hit + miss_.load(std::memory_order_relaxed);
     if (tot == 0)
         return 0;
-    return double(hit_) / tot;
+    return double(hit) / tot;
 }
 
 }  // namespace ripple
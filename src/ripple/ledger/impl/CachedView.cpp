@@ -34,7 +34,7 @@ std::shared_ptr<SLE const>
 CachedViewImpl::read(Keylet const& k) const
 {
     {
-        std::lock_guard lock(mutex_);
+        std::shared_lock lock(mutex_);
         auto const iter = map_.find(k.key);
         if (iter != map_.end())
         {
@@ -78,8 +78,7 @@ public:
 OpenView::OpenView(OpenView const& rhs)
     : ReadView(rhs)
     , TxsRawView(rhs)
-    , monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
+    , monotonic_resource_{std::make_unique<detail::ViewResource>()}
     , txs_{rhs.txs_, monotonic_resource_.get()}
     , rules_{rhs.rules_}
     , info_{rhs.info_}
@@ -93,8 +92,7 @@ OpenView::OpenView(
     ReadView const* base,
     Rules const& rules,
     std::shared_ptr<void const> hold)
-    : monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
+    : monotonic_resource_{std::make_unique<detail::ViewResource>()}
     , txs_{monotonic_resource_.get()}
     , rules_(rules)
     , info_(base->info())
@@ -109,8 +107,7 @@ OpenView::OpenView(
 }
 
 OpenView::OpenView(ReadView const* base, std::shared_ptr<void const> hold)
-    : monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
+    : monotonic_resource_{std::make_unique<detail::ViewResource>()}
     , txs_{monotonic_resource_.get()}
     , rules_(base->rules())
     , info_(base->info())
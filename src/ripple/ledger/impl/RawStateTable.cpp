@@ -158,22 +158,27 @@ void
 RawStateTable::apply(RawView& to) const
 {
     to.rawDestroyXRP(dropsDestroyed_);
+
+    // The items are sorted by key, so they can be applied together
+    std::vector<RawChange> changes;
+    changes.reserve(items_.size());
     for (auto const& elem : items_)
     {
         auto const& item = elem.second;
         switch (item.action)
         {
             case Action::erase:
-                to.rawErase(item.sle);
+                changes.push_back({RawChange::Action::erase, item.sle});
                 break;
             case Action::insert:
-                to.rawInsert(item.sle);
+                changes.push_back({RawChange::Action::insert, item.sle});
                 break;
             case Action::replace:
-                to.rawReplace(item.sle);
+                changes.push_back({RawChange::Action::replace, item.sle});
                 break;
         }
     }
+    to.rawApply(changes);
 }
 
 bool
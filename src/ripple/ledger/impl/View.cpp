@@ -285,29 +285,34 @@ forEachItemAfter(
     // If startAfter is not zero try jumping to that page using the hint
     if (after.isNonZero())
     {
-        auto const hintIndex = keylet::page(rootIndex, hint);
-        auto hintDir = view.read(hintIndex);
-        if (hintDir)
+        bool found = false;
+        std::shared_ptr<SLE const> ownerDir;
+        std::size_t start = 0;
+
+        // The hint is the page holding startAfter, so a deep marker is
+        // resumed without walking the pages before it
+        if (auto hintDir = view.read(keylet::page(rootIndex, hint)))
         {
-            for (auto const& key : hintDir->getFieldV256(sfIndexes))
+            auto const& keys = hintDir->getFieldV256(sfIndexes);
+            auto const iter = std::find(keys.begin(), keys.end(), after);
+            if (iter != keys.end())
             {
-                if (key == after)
-                {
-                    // We found the hint, we can start here
-                    currentIndex = hintIndex;
-                    break;
-                }
+                found = true;
+                start = std::distance(keys.begin(), iter) + 1;
+                ownerDir = std::move(hintDir);
             }
         }
 
-        bool found = false;
         for (;;)
         {
-            auto const ownerDir = view.read(currentIndex);
+            if (!ownerDir)
+                ownerDir = view.read(currentIndex);
             if (!ownerDir)
                 return found;
-            for (auto const& key : ownerDir->getFieldV256(sfIndexes))
+            auto const& keys = ownerDir->getFieldV256(sfIndexes);
+            for (auto i = start; i < keys.size(); ++i)
             {
+                auto const& key = keys[i];
                 if (!found)
                 {
                     if (key == after)
@@ -318,11 +323,13 @@ forEachItemAfter(
                     return found;
                 }
             }
+            start = 0;
 
             auto const uNodeNext = ownerDir->getFieldU64(sfIndexNext);
             if (uNodeNext == 0)
                 return found;
             currentIndex = keylet::page(rootIndex, uNodeNext);
+            ownerDir.reset();
         }
     }
     else
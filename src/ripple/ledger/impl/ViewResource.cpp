@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/ledger/detail/ViewResource.h>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+namespace detail {
+
+namespace {
+
+// Enough for the views alive at once in normal operation, each holding
+// two buffers, without keeping much memory when they are not needed.
+constexpr std::size_t maxPooledBuffers = 16;
+
+std::mutex poolMutex;
+std::vector<std::unique_ptr<char[]>> pool;
+
+}  // namespace
+
+ViewBuffer::ViewBuffer()
+{
+    {
+        std::lock_guard lock(poolMutex);
+        if (!pool.empty())
+        {
+            buffer_ = std::move(pool.back());
+            pool.pop_back();
+            return;
+        }
+    }
+    // Not value initialized, so pages are only touched when used
+    buffer_.reset(new char[size]);
+}
+
+ViewBuffer::~ViewBuffer()
+{
+    std::lock_guard lock(poolMutex);
+    if (pool.size() < maxPooledBuffers)
+        pool.push_back(std::move(buffer_));
+}
+
+}  // namespace detail
+}  // namespace ripple
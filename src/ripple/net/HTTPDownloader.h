@@ -28,6 +28,7 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ssl/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/beast/core.hpp>
@@ -85,8 +86,14 @@ private:
     boost::asio::io_service::strand strand_;
     std::unique_ptr<HTTPStream> stream_;
     boost::beast::flat_buffer read_buf_;
+    boost::asio::steady_timer retryTimer_;
     std::atomic<bool> stop_;
 
+    // How many times a download interrupted by a network error is resumed,
+    // and how much longer to wait before each attempt
+    static constexpr int maxRetries = 5;
+    static constexpr std::chrono::seconds retryDelay{2};
+
     // Used to protect sessionActive_
     std::mutex m_;
     bool sessionActive_;
@@ -101,6 +108,7 @@ private:
         boost::filesystem::path dstPath,
         std::function<void(boost::filesystem::path)> complete,
         bool ssl,
+        int attempt,
         boost::asio::yield_context yield);
 
     virtual std::shared_ptr<parser>
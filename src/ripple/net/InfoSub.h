@@ -26,7 +26,9 @@
 #include <ripple/json/json_value.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/resource/Consumer.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -35,6 +37,39 @@ namespace ripple {
 
 class PathRequest;
 
+/** A message published to every subscriber of a stream.
+
+    Subscribers which send the message as text share a single copy of it,
+    serialized the first time one of them asks. The message must outlive
+    the PublishedJson, which is meant to be used by one thread while it
+    publishes the message.
+*/
+class PublishedJson
+{
+public:
+    explicit PublishedJson(Json::Value const& jv) : jv_(jv)
+    {
+    }
+
+    PublishedJson(PublishedJson const&) = delete;
+    PublishedJson&
+    operator=(PublishedJson const&) = delete;
+
+    Json::Value const&
+    json() const
+    {
+        return jv_;
+    }
+
+    /** Return the message as compact JSON text. */
+    std::shared_ptr<std::string const> const&
+    text() const;
+
+private:
+    Json::Value const& jv_;
+    std::shared_ptr<std::string const> mutable text_;
+};
+
 /** Manages a client's subscription to data feeds.
  */
 class InfoSub : public CountedObject<InfoSub>
@@ -158,6 +193,17 @@ public:
     virtual void
     send(Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message published to other subscribers too.
+
+        By default this sends the message like any other. Subscribers
+        which would serialize it can use the shared text instead.
+    */
+    virtual void
+    send(PublishedJson const& msg, bool broadcast)
+    {
+        send(msg.json(), broadcast);
+    }
+
     std::uint64_t
     getSeq();
 
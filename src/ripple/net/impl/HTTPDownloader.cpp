@@ -29,6 +29,7 @@ HTTPDownloader::HTTPDownloader(
     : j_(j)
     , config_(config)
     , strand_(io_service)
+    , retryTimer_(io_service)
     , stop_(false)
     , sessionActive_(false)
 {
@@ -79,6 +80,7 @@ HTTPDownloader::download(
                 dstPath,
                 complete,
                 ssl,
+                0,
                 std::placeholders::_1));
     return true;
 }
@@ -92,6 +94,7 @@ HTTPDownloader::do_session(
     boost::filesystem::path dstPath,
     std::function<void(boost::filesystem::path)> complete,
     bool ssl,
+    int attempt,
     boost::asio::yield_context yield)
 {
     using namespace boost::asio;
@@ -139,9 +142,42 @@ HTTPDownloader::do_session(
         fail(dstPath, ec, errMsg, p);
         exit();
     };
+
+    // After a network error, start a new session which asks for the part
+    // of the file not yet stored. The session stays active meanwhile.
+    auto retryOrFail = [&](std::string const& errMsg, auto p) {
+        if (stop_.load() || attempt >= maxRetries)
+            return failAndExit(errMsg, p);
+
+        JLOG(j_.warn()) << errMsg << ": " << ec.message()
+                        << ", resuming download of " << dstPath.string();
+        close(p);
+        read_buf_.consume(read_buf_.size());
+        boost::asio::spawn(
+            strand_,
+            std::bind(
+                &HTTPDownloader::do_session,
+                shared_from_this(),
+                host,
+                port,
+                target,
+                version,
+                dstPath,
+                complete,
+                ssl,
+                attempt + 1,
+                std::placeholders::_1));
+    };
     // end lambdas
     ////////////////////////////////////////////////////////////
 
+    if (attempt > 0 && !stop_.load())
+    {
+        retryTimer_.expires_from_now(retryDelay * attempt);
+        retryTimer_.async_wait(yield[ec]);
+        ec = {};
+    }
+
     if (stop_.load())
         return exit();
 
@@ -158,8 +194,9 @@ HTTPDownloader::do_session(
         stream_ = std::make_unique<RawStream>(strand_);
 
     std::string error;
+    // A server which can't be reached at first is not retried
     if (!stream_->connect(error, host, port, yield))
-        return failAndExit(error, p);
+        return attempt > 0 ? retryOrFail(error, p) : failAndExit(error, p);
 
     // Set up an HTTP HEAD request message to find the file size
     http::request<http::empty_body> req{http::verb::head, target, version};
@@ -178,7 +215,7 @@ HTTPDownloader::do_session(
 
     stream_->asyncWrite(req, yield, ec);
     if (ec)
-        return failAndExit("async_write", p);
+        return retryOrFail("async_write", p);
 
     {
         // Read the response
@@ -186,7 +223,7 @@ HTTPDownloader::do_session(
         connectParser.skip(true);
         stream_->asyncRead(read_buf_, connectParser, yield, ec);
         if (ec)
-            return failAndExit("async_read", p);
+            return retryOrFail("async_read", p);
 
         // Range request was rejected
         if (connectParser.get().result() == http::status::range_not_satisfiable)
@@ -253,7 +290,7 @@ HTTPDownloader::do_session(
 
     stream_->asyncWrite(req, yield, ec);
     if (ec)
-        return failAndExit("async_write", p);
+        return retryOrFail("async_write", p);
 
     // end prepare and connect
     ////////////////////////////////////////////////////////////
@@ -271,6 +308,8 @@ HTTPDownloader::do_session(
         }
 
         stream_->asyncReadSome(read_buf_, *p, yield, ec);
+        if (ec)
+            return retryOrFail("async_read_some", p);
     }
 
     JLOG(j_.trace()) << "download completed: " << dstPath.string();
@@ -284,6 +323,9 @@ HTTPDownloader::onStop()
 {
     stop_ = true;
 
+    // Don't wait out the delay before resuming a download
+    strand_.post([self = shared_from_this()] { self->retryTimer_.cancel(); });
+
     std::unique_lock lock(m_);
     if (sessionActive_)
     {
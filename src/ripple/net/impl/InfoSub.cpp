@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/json/json_writer.h>
 #include <ripple/net/InfoSub.h>
 #include <atomic>
 
@@ -71,6 +72,20 @@ InfoSub::~InfoSub()
         m_source.unsubAccountInternal(mSeq, normalSubscriptions_, false);
 }
 
+std::shared_ptr<std::string const> const&
+PublishedJson::text() const
+{
+    if (!text_)
+    {
+        std::string text;
+        Json::stream(jv_, [&text](void const* data, std::size_t n) {
+            text.append(static_cast<char const*>(data), n);
+        });
+        text_ = std::make_shared<std::string const>(std::move(text));
+    }
+    return text_;
+}
+
 Resource::Consumer&
 InfoSub::getConsumer()
 {
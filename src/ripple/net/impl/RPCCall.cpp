@@ -211,6 +211,16 @@ private:
         return jvResult;
     }
 
+    // export_shard <index> <path>
+    Json::Value
+    parseExportShard(Json::Value const& jvParams)
+    {
+        Json::Value jvResult(Json::objectValue);
+        jvResult[jss::index] = jvParams[0u].asUInt();
+        jvResult[jss::path] = jvParams[1u].asString();
+        return jvResult;
+    }
+
     Json::Value
     parseInternal(Json::Value const& jvParams)
     {
@@ -717,6 +727,7 @@ private:
         return jvRequest;
     }
 
+    // ledger_diff <id>|<index>
     // ledger_header <id>|<index>
     Json::Value
     parseLedgerId(Json::Value const& jvParams)
@@ -760,6 +771,58 @@ private:
         return jvRequest;
     }
 
+    // cpu_profile [<seconds>] [<frequency>]
+    Json::Value
+    parseCpuProfile(Json::Value const& jvParams)
+    {
+        Json::Value jvRequest(Json::objectValue);
+
+        if (jvParams.size() > 0)
+        {
+            std::uint32_t duration;
+            if (!beast::lexicalCastChecked(duration, jvParams[0u].asString()))
+                return rpcError(rpcINVALID_PARAMS);
+            jvRequest[jss::duration] = duration;
+        }
+
+        if (jvParams.size() > 1)
+        {
+            std::uint32_t frequency;
+            if (!beast::lexicalCastChecked(
+                    frequency, jvParams[1u].asString()))
+                return rpcError(rpcINVALID_PARAMS);
+            jvRequest[jss::frequency] = frequency;
+        }
+
+        return jvRequest;
+    }
+
+    // node_store_trace [on|off] [<sample_rate>]
+    Json::Value
+    parseNodeStoreTrace(Json::Value const& jvParams)
+    {
+        Json::Value jvRequest(Json::objectValue);
+
+        if (jvParams.size() > 0)
+        {
+            auto const action = jvParams[0u].asString();
+            if (action != "on" && action != "off")
+                return rpcError(rpcINVALID_PARAMS);
+            jvRequest[jss::enabled] = action == "on";
+        }
+
+        if (jvParams.size() > 1)
+        {
+            std::uint32_t sampleRate;
+            if (!beast::lexicalCastChecked(
+                    sampleRate, jvParams[1u].asString()))
+                return rpcError(rpcINVALID_PARAMS);
+            jvRequest[jss::sample_rate] = sampleRate;
+        }
+
+        return jvRequest;
+    }
+
     // owner_info <account>|<account_public_key> [strict]
     // owner_info <seed>|<pass_phrase>|<key> [<ledger>] [strict]
     // account_info <account>|<account_public_key> [strict]
@@ -1237,8 +1300,10 @@ public:
             {"channel_verify", &RPCParser::parseChannelVerify, 4, 4},
             {"connect", &RPCParser::parseConnect, 1, 2},
             {"consensus_info", &RPCParser::parseAsIs, 0, 0},
+            {"cpu_profile", &RPCParser::parseCpuProfile, 0, 2},
             {"deposit_authorized", &RPCParser::parseDepositAuthorized, 2, 3},
             {"download_shard", &RPCParser::parseDownloadShard, 2, -1},
+            {"export_shard", &RPCParser::parseExportShard, 2, 2},
             {"feature", &RPCParser::parseFeature, 0, 2},
             {"fetch_info", &RPCParser::parseFetchInfo, 0, 1},
             {"gateway_balances", &RPCParser::parseGatewayBalances, 1, -1},
@@ -1249,6 +1314,7 @@ public:
             {"ledger_accept", &RPCParser::parseAsIs, 0, 0},
             {"ledger_closed", &RPCParser::parseAsIs, 0, 0},
             {"ledger_current", &RPCParser::parseAsIs, 0, 0},
+            {"ledger_diff", &RPCParser::parseLedgerId, 1, 1},
             //      {   "ledger_entry",         &RPCParser::parseLedgerEntry,
             //      -1, -1   },
             {"ledger_header", &RPCParser::parseLedgerId, 1, 1},
@@ -1256,6 +1322,7 @@ public:
             {"log_level", &RPCParser::parseLogLevel, 0, 2},
             {"logrotate", &RPCParser::parseAsIs, 0, 0},
             {"manifest", &RPCParser::parseManifest, 1, 1},
+            {"node_store_trace", &RPCParser::parseNodeStoreTrace, 0, 2},
             {"owner_info", &RPCParser::parseAccountItems, 1, 3},
             {"peers", &RPCParser::parseAsIs, 0, 0},
             {"ping", &RPCParser::parseAsIs, 0, 0},
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_ACCESSTRACE_H_INCLUDED
+#define RIPPLE_NODESTORE_ACCESSTRACE_H_INCLUDED
+
+#include <ripple/nodestore/NodeObject.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A record of sampled fetches and stores made through a node store.
+
+    A trace captured on a production server shows its real working set:
+    how often objects are read again and how soon, and how large they
+    are, for sizing the caches, and it can be replayed against other
+    backends and settings to compare them. Fetches answered from the
+    caches are recorded too, since they are part of that pattern.
+
+    Objects are sampled by hash, so every access to a sampled object is
+    recorded and the reuse of each object is seen exactly.
+
+    The file starts with the eight bytes "NSTRACE1", followed by one
+    record of `entrySize` bytes for each access. All integers are little
+    endian:
+
+        8   time, in microseconds since the Unix epoch
+        4   latency, in microseconds
+        4   ledger sequence
+        4   object size
+        1   object type
+        1   operation: 0 for a fetch, 1 for a store
+        1   1 if a fetch found the object, otherwise 0
+        1   unused
+        32  hash
+*/
+class AccessTrace
+{
+public:
+    enum class Op : std::uint8_t { fetch = 0, store = 1 };
+
+    struct Entry
+    {
+        std::chrono::system_clock::time_point time;
+        std::chrono::microseconds latency;
+        std::uint32_t ledgerSeq;
+        std::uint32_t size;
+        NodeObjectType type;
+        Op op;
+        bool found;
+        uint256 hash;
+    };
+
+    static constexpr std::size_t entrySize = 56;
+
+    /** Open a trace for appending. Throws if the file can't be opened.
+
+        @param sampleRate Record accesses to one object in this many.
+    */
+    AccessTrace(boost::filesystem::path const& path, std::uint32_t sampleRate);
+
+    ~AccessTrace();
+
+    AccessTrace(AccessTrace const&) = delete;
+    AccessTrace&
+    operator=(AccessTrace const&) = delete;
+
+    /** Whether accesses to an object are recorded. */
+    static bool
+    sampled(uint256 const& hash, std::uint32_t sampleRate);
+
+    void
+    fetched(
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        std::shared_ptr<NodeObject> const& nodeObject,
+        std::chrono::microseconds latency);
+
+    void
+    stored(
+        NodeObject const& nodeObject,
+        std::uint32_t ledgerSeq,
+        std::chrono::microseconds latency);
+
+    std::uint32_t
+    sampleRate() const
+    {
+        return sampleRate_;
+    }
+
+    /** The number of accesses recorded. */
+    std::uint64_t
+    size() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    /** Read the start of a trace. Returns false if it isn't one. */
+    static bool
+    readHeader(std::istream& in);
+
+    /** Read the next access from a trace, or nothing at its end. */
+    static boost::optional<Entry>
+    read(std::istream& in);
+
+private:
+    void
+    write(Entry const& entry);
+
+    std::uint32_t const sampleRate_;
+    std::atomic<std::uint64_t> size_{0};
+    std::mutex mutex_;
+    std::ofstream file_;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
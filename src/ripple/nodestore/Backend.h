@@ -80,13 +80,17 @@ public:
     virtual Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pObject) = 0;
 
-    /** Return `true` if batch fetches are optimized. */
-    virtual bool
-    canFetchBatch() = 0;
-
-    /** Fetch a batch synchronously. */
-    virtual std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch(std::size_t n, void const* const* keys) = 0;
+    /** Fetch a batch synchronously.
+        Backends which can service several keys in one request should do
+        so; the others may simply call fetch once per key.
+        @note This will be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @return The objects, in the same order as the keys, with `nullptr`
+                for each object that could not be retrieved, and the
+                result of the operation.
+    */
+    virtual std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch(std::vector<uint256 const*> const& hashes) = 0;
 
     /** Store a single object.
         Depending on the implementation this may happen immediately
@@ -121,6 +125,18 @@ public:
     virtual void
     setDeletePath() = 0;
 
+    /** Promise that nothing more will be stored.
+
+        A backend may then serve fetches more cheaply, for instance from
+        memory mapped files, and may reject further stores. The setting
+        lasts until the backend is closed.
+        @note This will not be called concurrently with other methods.
+    */
+    virtual void
+    setReadOnly()
+    {
+    }
+
     /** Perform consistency checks on database. */
     virtual void
     verify() = 0;
@@ -22,14 +22,23 @@
 
 #include <ripple/basics/KeyCache.h>
 #include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/ThreadAffinity.h>
 #include <ripple/core/Stoppable.h>
+#include <ripple/json/json_value.h>
+#include <ripple/nodestore/AccessTrace.h>
 #include <ripple/nodestore/Backend.h>
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/nodestore/Scheduler.h>
 #include <ripple/nodestore/impl/Tuning.h>
 #include <ripple/protocol/SystemParameters.h>
 
+#include <array>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -60,7 +69,10 @@ public:
         @param name The Stoppable name for this Database.
         @param parent The parent Stoppable.
         @param scheduler The scheduler to use for performing asynchronous tasks.
-        @param readThreads The number of asynchronous read threads to create.
+        @param readThreads The number of asynchronous read threads to start
+                           with. More are added, up to the configured
+                           maximum, while reads queue up faster than they
+                           complete.
         @param config The configuration settings
         @param journal Destination for logging output.
     */
@@ -131,6 +143,20 @@ public:
         std::uint32_t ledgerSeq = 0,
         FetchType fetchType = FetchType::synchronous);
 
+    /** Fetch a group of node objects.
+        Objects which are known to be not in the database, aren't found in
+        the database during the fetch, or fail to load correctly are
+        returned as `nullptr`.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @param ledgerSeq The sequence of the ledger where the objects are
+                stored, used by the shard store.
+        @return The objects, in the same order as the keys.
+    */
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(std::vector<uint256> const& hashes, std::uint32_t ledgerSeq = 0);
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -142,13 +168,39 @@ public:
         @param ledgerSeq The sequence of the ledger where the
                 object is stored, used by the shard store.
         @param nodeObject The object retrieved
+        @param priority The urgency of the read, if it must be scheduled
         @return Whether the operation completed
     */
     virtual bool
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
-        std::shared_ptr<NodeObject>& nodeObject) = 0;
+        std::shared_ptr<NodeObject>& nodeObject,
+        FetchPriority priority) = 0;
+
+    /** Fetch a group of objects without waiting for them.
+        Objects in the cache are found at once and the others are read by
+        the async read threads. Once every object has been found or found
+        missing, `callback` is called with the objects in the same order as
+        the keys, or `nullptr` for those not found.
+
+        @note This can be called concurrently. The callback is called
+              exactly once, either before this function returns or later
+              on a read thread, so it should not do lengthy work. It is
+              not called if the database stops before the reads are done.
+        @param hashes The keys of the objects to retrieve.
+        @param ledgerSeq The sequence of the ledger where the objects are
+                stored, used by the shard store.
+        @param priority The urgency of the reads
+        @param callback Called with the objects
+    */
+    void
+    fetchBatchAsync(
+        std::vector<uint256> const& hashes,
+        std::uint32_t ledgerSeq,
+        FetchPriority priority,
+        std::function<void(std::vector<std::shared_ptr<NodeObject>>)>
+            callback);
 
     /** Store a ledger from a different database.
 
@@ -159,9 +211,10 @@ public:
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) = 0;
 
     /** Wait for all currently pending async reads to complete.
+        @param priority The priority of the reads to wait for.
      */
     void
-    waitReads();
+    waitReads(FetchPriority priority = FetchPriority::high);
 
     /** Get the maximum number of async reads the node store prefers.
 
@@ -184,6 +237,16 @@ public:
     virtual void
     tune(int size, std::chrono::seconds age) = 0;
 
+    /** Return the positive cache, if the database has exactly one.
+
+        A shard database returns the cache shared by its final shards.
+    */
+    virtual TaggedCache<uint256, NodeObject>*
+    getObjectCache()
+    {
+        return nullptr;
+    }
+
     /** Remove expired entries from the positive and negative caches. */
     virtual void
     sweep() = 0;
@@ -243,6 +306,25 @@ public:
         return earliestLedgerSeq_;
     }
 
+    /** Start recording sampled accesses to the access_trace file.
+
+        A trace which is running is stopped first.
+
+        @param sampleRate Record accesses to one object in this many.
+        @return false if no access_trace file is configured.
+        @throws std::runtime_error if the file can't be opened.
+    */
+    bool
+    startAccessTrace(std::uint32_t sampleRate);
+
+    /** Stop recording accesses, and close the trace file. */
+    void
+    stopAccessTrace();
+
+    /** Describe the access trace, for the node_store_trace command. */
+    Json::Value
+    getAccessTraceJson() const;
+
 protected:
     beast::Journal const j_;
     Scheduler& scheduler_;
@@ -262,53 +344,152 @@ protected:
         storeSz_ += sz;
     }
 
-    // Called by the public asyncFetch function
+    // Record an access to the trace, if one is running and samples it
+    void
+    traceFetch(
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        std::shared_ptr<NodeObject> const& nodeObject,
+        std::chrono::microseconds latency)
+    {
+        if (auto trace = sampledTrace(hash))
+            trace->fetched(hash, ledgerSeq, nodeObject, latency);
+    }
+
+    void
+    traceStore(
+        NodeObject const& nodeObject,
+        std::uint32_t ledgerSeq,
+        std::chrono::microseconds latency)
+    {
+        if (auto trace = sampledTrace(nodeObject.getHash()))
+            trace->stored(nodeObject, ledgerSeq, latency);
+    }
+
+    using ReadCallback = std::function<void(std::shared_ptr<NodeObject>)>;
+
+    // Called by the public asyncFetch function. If `callback` is set it is
+    // called with the object once it has been read.
     void
-    asyncFetch(uint256 const& hash, std::uint32_t ledgerSeq);
+    asyncFetch(
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        FetchPriority priority,
+        ReadCallback callback = nullptr);
 
     // Called by the public import function
     void
     importInternal(Backend& dstBackend, Database& srcDB);
 
-    // Called by the public storeLedger function
+    // Called by the public storeLedger function. If `onStore` is set it is
+    // called with each object before the object is written.
     bool
     storeLedger(
         Ledger const& srcLedger,
         std::shared_ptr<Backend> dstBackend,
         std::shared_ptr<TaggedCache<uint256, NodeObject>> dstPCache,
-        std::shared_ptr<KeyCache<uint256>> dstNCache);
+        std::shared_ptr<KeyCache<uint256>> dstNCache,
+        std::function<void(NodeObject const&)> const& onStore = nullptr);
 
 private:
     std::atomic<std::uint64_t> storeCount_{0};
     std::atomic<std::uint64_t> storeSz_{0};
     std::atomic<std::uint64_t> fetchTotalCount_{0};
 
+    struct PendingRead
+    {
+        std::uint32_t ledgerSeq;
+
+        // Called with the object once it has been read
+        std::vector<ReadCallback> callbacks;
+    };
+
+    // The async reads of one priority
+    struct ReadLane
+    {
+        // reads to do
+        std::map<uint256, PendingRead> read;
+
+        // last read
+        uint256 lastHash;
+
+        // current read generation
+        std::uint64_t gen{0};
+    };
+
     std::mutex readLock_;
     std::condition_variable readCondVar_;
     std::condition_variable readGenCondVar_;
 
-    // reads to do
-    std::map<uint256, std::uint32_t> read_;
+    // Wakes the threads not currently serving reads
+    std::condition_variable readParkCondVar_;
+
+    // Indexed by FetchPriority
+    std::array<ReadLane, 2> readLanes_;
 
-    // last read
-    uint256 readLastHash_;
+    // High priority reads served in a row while low priority ones waited
+    int readHighRun_{0};
 
     std::vector<std::thread> readThreads_;
     bool readShut_{false};
 
-    // current read generation
-    uint64_t readGen_{0};
+    // Only the first readActive_ threads serve reads; the others wait
+    // until they are needed. The count adapts to the length of the queue
+    // and to how quickly the backend answers.
+    std::size_t const readThreadsMax_;
+    std::size_t readActive_;
+    std::chrono::steady_clock::time_point readResized_;
+
+    // Smoothed latency of the async reads which went to the backend, and
+    // the lowest it has been recently, taken as the latency of a backend
+    // which is not saturated.
+    std::chrono::microseconds readLatency_{0};
+    std::chrono::microseconds readLatencyFloor_{0};
+
+    // How many async reads a thread takes at once. Each group is fetched
+    // with fetchBatch, which for backends reading with io_uring keeps the
+    // whole group in flight from a single thread.
+    std::size_t const readBatch_;
+
+    // The processors the read threads run on
+    CpuSet const readAffinity_;
 
     // The default is 32570 to match the XRP ledger network's earliest
     // allowed sequence. Alternate networks may set this value.
     std::uint32_t const earliestLedgerSeq_;
 
+    // The access trace. The sample rate is zero unless a trace is running,
+    // so unsampled accesses never take the lock.
+    boost::filesystem::path const accessTracePath_;
+    std::atomic<std::uint32_t> accessTraceRate_{0};
+    mutable std::mutex accessTraceMutex_;
+    std::shared_ptr<AccessTrace> accessTrace_;
+
+    std::shared_ptr<AccessTrace>
+    sampledTrace(uint256 const& hash) const
+    {
+        auto const rate = accessTraceRate_.load(std::memory_order_relaxed);
+        if (!AccessTrace::sampled(hash, rate))
+            return nullptr;
+        std::lock_guard lock(accessTraceMutex_);
+        return accessTrace_;
+    }
+
     virtual std::shared_ptr<NodeObject>
     fetchNodeObject(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
         FetchReport& fetchReport) = 0;
 
+    /** Fetch a group of objects, called by the public fetchBatch function.
+        The default implementation fetches the objects one at a time.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(
+        std::vector<uint256> const& hashes,
+        std::uint32_t ledgerSeq,
+        FetchReport& fetchReport);
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -319,8 +500,32 @@ private:
     virtual void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) = 0;
 
+    // Fetch an object, keeping statistics and reporting to the scheduler
+    std::shared_ptr<NodeObject>
+    fetchAndReport(
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        FetchReport& fetchReport);
+
+    // Fetch a group of objects, keeping statistics and reporting to the
+    // scheduler
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatchAndReport(
+        std::vector<uint256> const& hashes,
+        std::uint32_t ledgerSeq,
+        FetchReport& fetchReport);
+
+    // Choose the next async read. Called with readLock_ held.
+    std::pair<uint256, PendingRead>
+    nextRead();
+
+    // Adjust the number of threads serving async reads. Called with
+    // readLock_ held.
+    void
+    resizeReads();
+
     void
-    threadEntry();
+    threadEntry(std::size_t index);
 };
 
 }  // namespace NodeStore
@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/basics/RangeSet.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/Types.h>
 
@@ -106,12 +107,30 @@ public:
         @param srcDir The directory to import from
         @return true If the shard was successfully imported
         @implNote if successful, srcDir is moved to the database directory
+        @note A shard still missing ledgers is imported only when no other
+              shard is being acquired, and the rest are then acquired from
+              the network.
     */
     virtual bool
     importShard(
         std::uint32_t shardIndex,
         boost::filesystem::path const& srcDir) = 0;
 
+    /** Export a final shard to a directory
+
+        The copy is self-contained, holding every node object its ledgers
+        need, and may be imported by another server. It is written in the
+        background.
+
+        @param shardIndex Shard index to export
+        @param dstDir The directory to create, must not exist
+        @return true If the export was started
+    */
+    virtual bool
+    exportShard(
+        std::uint32_t shardIndex,
+        boost::filesystem::path const& dstDir) = 0;
+
     /** Fetch a ledger from the shard store
 
         @param hash The key of the ledger to retrieve
@@ -129,6 +148,41 @@ public:
     virtual void
     setStored(std::shared_ptr<Ledger const> const& ledger) = 0;
 
+    /** Invoke a callback on the transaction databases of the final shards
+        which may hold transactions affecting an account.
+
+        Each final shard keeps a filter of the accounts its transactions
+        affect, and a shard whose filter excludes the account is skipped
+        without being opened.
+
+        @param account The account.
+        @param minSeq The first ledger sequence of interest.
+        @param maxSeq The last ledger sequence of interest.
+        @param forward If true the oldest shard is visited first, otherwise
+            the newest is.
+        @param callback Called with the database and the first and last
+            ledger sequences of the shard. Returns false to stop.
+    */
+    virtual void
+    forEachAccountShard(
+        AccountID const& account,
+        std::uint32_t minSeq,
+        std::uint32_t maxSeq,
+        bool forward,
+        std::function<bool(DatabaseCon&, std::uint32_t, std::uint32_t)> const&
+            callback) = 0;
+
+    /** Find the earliest ledger from which every ledger before another is
+        held by final shards.
+
+        @param seq The ledger sequence following the ledgers sought.
+        @return The first ledger sequence of the run of final shards which
+            ends at `seq - 1`, or `seq` if that ledger is not in a final
+            shard.
+    */
+    virtual std::uint32_t
+    firstContiguousSeq(std::uint32_t seq) = 0;
+
     /** Query which complete shards are stored
 
         @return the indexes of complete shards
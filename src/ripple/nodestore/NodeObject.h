@@ -21,8 +21,11 @@
 #define RIPPLE_NODESTORE_NODEOBJECT_H_INCLUDED
 
 #include <ripple/basics/Blob.h>
+#include <ripple/basics/CacheBudget.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/Slice.h>
 #include <ripple/protocol/Protocol.h>
+#include <memory>
 
 // VFALCO NOTE Intentionally not in the NodeStore namespace
 
@@ -42,6 +45,10 @@ enum NodeObjectType : std::uint32_t {
     the blob. The blob is a variable length block of serialized data. The
     type identifies what the blob contains.
 
+    The blob is either owned by the object or is a view into a buffer the
+    object keeps alive, which lets a backend hand over the buffer it read
+    into rather than copying out of it.
+
     @note No checking is performed to make sure the hash matches the data.
     @see SHAMap
 */
@@ -67,6 +74,18 @@ public:
         uint256 const& hash,
         PrivateAccess);
 
+    // This constructor is private, use createObject instead.
+    NodeObject(
+        NodeObjectType type,
+        std::shared_ptr<void const> owner,
+        Slice data,
+        uint256 const& hash,
+        PrivateAccess);
+
+    NodeObject(NodeObject const&) = delete;
+    NodeObject&
+    operator=(NodeObject const&) = delete;
+
     /** Create an object from fields.
 
         The caller's variable is modified during this call. The
@@ -81,6 +100,23 @@ public:
     static std::shared_ptr<NodeObject>
     createObject(NodeObjectType type, Blob&& data, uint256 const& hash);
 
+    /** Create an object which refers to data held by another object.
+
+        No copy is made. The payload must remain valid and unchanged for as
+        long as `owner` exists; the NodeObject holds a reference to it.
+
+        @param type The type of object.
+        @param owner The object which owns the memory `data` refers to.
+        @param data The payload.
+        @param hash The 256-bit hash of the payload data.
+    */
+    static std::shared_ptr<NodeObject>
+    createObject(
+        NodeObjectType type,
+        std::shared_ptr<void const> owner,
+        Slice data,
+        uint256 const& hash);
+
     /** Returns the type of this object. */
     NodeObjectType
     getType() const;
@@ -90,13 +126,25 @@ public:
     getHash() const;
 
     /** Returns the underlying data. */
-    Blob const&
+    Slice
     getData() const;
 
 private:
     NodeObjectType const mType;
     uint256 const mHash;
-    Blob const mData;
+    Blob const mBlob;
+    std::shared_ptr<void const> const mOwner;
+    Slice const mData;
+};
+
+template <>
+struct CacheFootprint<NodeObject>
+{
+    static std::size_t
+    bytes(NodeObject const& object)
+    {
+        return sizeof(object) + object.getData().size();
+    }
 };
 
 }  // namespace ripple
@@ -35,10 +35,13 @@ struct FetchReport
     {
     }
 
-    std::chrono::milliseconds elapsed;
+    std::chrono::microseconds elapsed;
     FetchType const fetchType;
     bool wentToDisk = false;
     bool wasFound = false;
+
+    // The number of objects of a batch looked up on disk
+    std::size_t diskCount = 0;
 };
 
 /** Contains information about a batch write operation. */
@@ -48,6 +51,9 @@ struct BatchWriteReport
 
     std::chrono::milliseconds elapsed;
     int writeCount;
+
+    // How long writers waited for room since the previous report
+    std::chrono::microseconds stalled{0};
 };
 
 /** Scheduling for asynchronous backend activity
@@ -50,6 +50,14 @@ enum Status {
     customCode = 100
 };
 
+/** The urgency of an asynchronous fetch.
+
+    High priority reads are those needed to keep up with the network, such
+    as the ledgers consensus depends on. Low priority reads, such as those
+    for acquiring history, are served when no high priority read waits.
+*/
+enum class FetchPriority { high, low };
+
 /** A batch of NodeObjects to write at once. */
 using Batch = std::vector<std::shared_ptr<NodeObject>>;
 
@@ -147,17 +147,23 @@ public:
         return ok;
     }
 
-    bool
-    canFetchBatch() override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
-        return false;
-    }
+        assert(db_);
+        std::vector<std::shared_ptr<NodeObject>> results;
+        results.reserve(hashes.size());
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch(std::size_t n, void const* const* keys) override
-    {
-        Throw<std::runtime_error>("pure virtual called");
-        return {};
+        std::lock_guard _(db_->mutex);
+        for (auto const h : hashes)
+        {
+            auto const iter = db_->table.find(*h);
+            if (iter == db_->table.end())
+                results.push_back({});
+            else
+                results.push_back(iter->second);
+        }
+        return {results, ok};
     }
 
     void
@@ -17,24 +17,399 @@
 */
 //==============================================================================
 
+#include <ripple/basics/Buffer.h>
 #include <ripple/basics/contract.h>
 #include <ripple/nodestore/Factory.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/IoUring.h>
 #include <ripple/nodestore/impl/codec.h>
+#include <ripple/protocol/HashPrefix.h>
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/optional.hpp>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <nudb/detail/format.hpp>
 #include <nudb/nudb.hpp>
 
 namespace ripple {
 namespace NodeStore {
 
+/** Searches NuDB files directly.
+
+    Follows the layout described in nudb/detail/format.hpp, for databases
+    which will never be written again. A bucket lives in its block of the
+    key file until it fills up, when it is moved to a spill record in the
+    data file which the bucket then points to.
+*/
+struct NuDBLayout
+{
+    // Bucket Record: uint16 count, uint48 spill, and then the entries.
+    // Bucket Entry: uint48 offset, uint48 size, uint48 hash.
+    static constexpr std::size_t bucketHeaderSize = 2 + 6;
+    static constexpr std::size_t bucketEntrySize = 6 + 6 + 6;
+
+    static std::uint64_t
+    read48(std::uint8_t const* p)
+    {
+        return (std::uint64_t{p[0]} << 40) | (std::uint64_t{p[1]} << 32) |
+            (std::uint64_t{p[2]} << 24) | (std::uint64_t{p[3]} << 16) |
+            (std::uint64_t{p[4]} << 8) | std::uint64_t{p[5]};
+    }
+
+    [[noreturn]] static void
+    corrupt()
+    {
+        Throw<std::runtime_error>("nodestore: corrupt NuDB database");
+    }
+
+    /** Parse and check the headers of the key and data files. */
+    static nudb::detail::key_file_header
+    readHeaders(
+        std::uint8_t const* key,
+        std::uint64_t keyFileSize,
+        std::uint8_t const* dat)
+    {
+        using namespace nudb::detail;
+        key_file_header kh;
+        istream kis(key, key_file_header::size);
+        nudb::detail::read(kis, keyFileSize, kh);
+        dat_file_header dh;
+        istream dis(dat, dat_file_header::size);
+        nudb::detail::read(dis, dh);
+
+        nudb::error_code ec;
+        nudb::detail::verify<nudb::xxhasher>(kh, ec);
+        if (!ec && dh.uid != kh.uid)
+            ec = nudb::error::uid_mismatch;
+        if (ec)
+            Throw<nudb::system_error>(ec);
+        return kh;
+    }
+
+    /** Return the hash of a key and the offset of its bucket. */
+    static std::pair<std::uint64_t, std::uint64_t>
+    locate(nudb::detail::key_file_header const& kh, void const* key)
+    {
+        auto const h =
+            nudb::detail::hash<nudb::xxhasher>(key, kh.key_size, kh.salt);
+        auto const n = nudb::detail::bucket_index(h, kh.buckets, kh.modulus);
+        // Buckets follow the header block
+        return {h, (n + 1) * kh.block_size};
+    }
+
+    /** Visit the entries of a bucket which have a given hash.
+
+        Calls `f(offset, size)` with the location of each data record
+        which may hold the key, until it returns `true`.
+
+        @param bucket The bucket, of which `avail` bytes may be read.
+        @param spill Set to the offset of the next bucket to search,
+                     or zero if there is none.
+        @return `true` if `f` did.
+    */
+    template <class F>
+    static bool
+    search(
+        std::uint8_t const* bucket,
+        std::size_t avail,
+        std::uint64_t h,
+        std::uint64_t& spill,
+        F&& f)
+    {
+        if (avail < bucketHeaderSize)
+            corrupt();
+        std::size_t const count = (std::size_t{bucket[0]} << 8) | bucket[1];
+        spill = read48(bucket + 2);
+        auto const entries = bucket + bucketHeaderSize;
+        if ((avail - bucketHeaderSize) / bucketEntrySize < count)
+            corrupt();
+
+        // Entries are sorted by hash
+        std::size_t first = 0;
+        std::size_t last = count;
+        while (first < last)
+        {
+            auto const mid = first + (last - first) / 2;
+            if (read48(entries + mid * bucketEntrySize + 12) < h)
+                first = mid + 1;
+            else
+                last = mid;
+        }
+
+        for (; first < count; ++first)
+        {
+            auto const entry = entries + first * bucketEntrySize;
+            if (read48(entry + 12) != h)
+                break;
+            // Data Record: uint48 size, the key and then the value
+            if (f(read48(entry), read48(entry + 6)))
+                return true;
+        }
+        return false;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A NuDB database mapped into memory, for reading only.
+
+    nudb::store reads the key and data files with a system call per
+    lookup and locks its bucket cache. A database which will never be
+    written again can instead be mapped into memory and searched directly,
+    so a fetch needs neither system calls nor locks and the page cache
+    serves as the cache for the whole file.
+*/
+class NuDBMapping : private NuDBLayout
+{
+    boost::interprocess::mapped_region key_;
+    boost::interprocess::mapped_region dat_;
+    nudb::detail::key_file_header kh_;
+
+    static boost::interprocess::mapped_region
+    map(std::string const& path)
+    {
+        using namespace boost::interprocess;
+        file_mapping const file(path.c_str(), read_only);
+        mapped_region region(file, read_only);
+        region.advise(mapped_region::advice_random);
+        return region;
+    }
+
+    static std::uint8_t const*
+    data(boost::interprocess::mapped_region const& region)
+    {
+        return static_cast<std::uint8_t const*>(region.get_address());
+    }
+
+public:
+    NuDBMapping(std::string const& kp, std::string const& dp)
+        : key_(map(kp)), dat_(map(dp))
+    {
+        using namespace nudb::detail;
+        if (key_.get_size() < key_file_header::size ||
+            dat_.get_size() < dat_file_header::size)
+            corrupt();
+        kh_ = readHeaders(data(key_), key_.get_size(), data(dat_));
+    }
+
+    /** Return the value stored for a key, if there is one.
+        @note This may be called concurrently.
+    */
+    boost::optional<Slice>
+    find(void const* key) const
+    {
+        using namespace nudb::detail;
+        auto const [h, bucketOffset] = locate(kh_, key);
+        std::uint8_t const* bucket = data(key_) + bucketOffset;
+        std::uint8_t const* end = data(key_) + key_.get_size();
+        boost::optional<Slice> result;
+        for (;;)
+        {
+            if (bucket > end)
+                corrupt();
+            std::uint64_t spill;
+            auto const found = search(
+                bucket,
+                end - bucket,
+                h,
+                spill,
+                [&](std::uint64_t offset, std::uint64_t size) {
+                    offset += field<uint48_t>::size;
+                    if (offset + kh_.key_size + size > dat_.get_size())
+                        corrupt();
+                    auto const record = data(dat_) + offset;
+                    if (std::memcmp(record, key, kh_.key_size) != 0)
+                        return false;
+                    result.emplace(record + kh_.key_size, size);
+                    return true;
+                });
+            if (found || spill == 0)
+                return result;
+            if (spill >= dat_.get_size())
+                corrupt();
+            bucket = data(dat_) + spill;
+            end = data(dat_) + dat_.get_size();
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A NuDB database read with io_uring, for reading only.
+
+    Searches the files like NuDBMapping, but reads them instead of
+    faulting pages in, so that a group of lookups proceeds together: each
+    step of every lookup in the group, whether reading a bucket or a data
+    record, is submitted to the kernel at once. One thread then keeps as
+    many reads in flight as there are keys in the group.
+*/
+class NuDBFileReader : private NuDBLayout
+{
+    IoUring::File key_;
+    IoUring::File dat_;
+    nudb::detail::key_file_header kh_;
+
+    // The progress of one key through its bucket and spill records
+    struct Lookup
+    {
+        std::uint64_t hash;
+
+        // The pending read
+        IoUring::File const* file;
+        std::uint64_t offset;
+        bool bucket = true;
+        Buffer buffer;
+        std::shared_ptr<Buffer> record;
+
+        // The data records yet to be checked, and where to go after them
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> candidates;
+        std::size_t next = 0;
+        std::uint64_t spill = 0;
+        bool done = false;
+    };
+
+    // Set up the next read of a lookup, or finish it.
+    void
+    advance(Lookup& lookup) const
+    {
+        using namespace nudb::detail;
+        if (lookup.next < lookup.candidates.size())
+        {
+            auto const [offset, size] = lookup.candidates[lookup.next++];
+            auto const start = offset + field<uint48_t>::size;
+            if (start + kh_.key_size + size > dat_.size())
+                corrupt();
+            lookup.file = &dat_;
+            lookup.offset = start;
+            lookup.bucket = false;
+            lookup.record = std::make_shared<Buffer>(kh_.key_size + size);
+        }
+        else if (lookup.spill != 0)
+        {
+            if (lookup.spill >= dat_.size())
+                corrupt();
+            lookup.file = &dat_;
+            lookup.offset = lookup.spill;
+            lookup.bucket = true;
+            lookup.candidates.clear();
+            lookup.next = 0;
+        }
+        else
+        {
+            lookup.done = true;
+        }
+    }
+
+public:
+    NuDBFileReader(std::string const& kp, std::string const& dp)
+        : key_(kp), dat_(dp)
+    {
+        using namespace nudb::detail;
+        if (key_.size() < key_file_header::size ||
+            dat_.size() < dat_file_header::size)
+            corrupt();
+
+        std::uint8_t kh[key_file_header::size];
+        std::uint8_t dh[dat_file_header::size];
+        std::vector<IoUring::Read> reads{
+            {&key_, 0, kh, sizeof(kh)}, {&dat_, 0, dh, sizeof(dh)}};
+        IoUring::read(reads);
+        if (reads[0].result != sizeof(kh) || reads[1].result != sizeof(dh))
+            corrupt();
+        kh_ = readHeaders(kh, key_.size(), dh);
+    }
+
+    /** Return the values stored for a group of keys.
+
+        Each value found is returned in a buffer which holds the key
+        followed by the value; keys that are not present yield `nullptr`.
+
+        @note This may be called concurrently.
+    */
+    std::vector<std::shared_ptr<Buffer>>
+    find(std::vector<void const*> const& keys) const
+    {
+        std::vector<std::shared_ptr<Buffer>> results(keys.size());
+        std::vector<Lookup> lookups(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            auto& lookup = lookups[i];
+            std::tie(lookup.hash, lookup.offset) = locate(kh_, keys[i]);
+            lookup.file = &key_;
+            lookup.buffer = Buffer(kh_.block_size);
+        }
+
+        std::vector<IoUring::Read> reads;
+        std::vector<std::size_t> owners;
+        for (;;)
+        {
+            reads.clear();
+            owners.clear();
+            for (std::size_t i = 0; i < lookups.size(); ++i)
+            {
+                auto& lookup = lookups[i];
+                if (lookup.done)
+                    continue;
+                auto& buffer = lookup.bucket ? lookup.buffer : *lookup.record;
+                reads.push_back(
+                    {lookup.file, lookup.offset, buffer.data(), buffer.size()});
+                owners.push_back(i);
+            }
+            if (reads.empty())
+                return results;
+
+            IoUring::read(reads);
+
+            for (std::size_t j = 0; j < reads.size(); ++j)
+            {
+                auto const i = owners[j];
+                auto& lookup = lookups[i];
+                if (lookup.bucket)
+                {
+                    search(
+                        lookup.buffer.data(),
+                        reads[j].result,
+                        lookup.hash,
+                        lookup.spill,
+                        [&](std::uint64_t offset, std::uint64_t size) {
+                            lookup.candidates.emplace_back(offset, size);
+                            return false;
+                        });
+                }
+                else
+                {
+                    if (reads[j].result != lookup.record->size())
+                        corrupt();
+                    if (std::memcmp(
+                            lookup.record->data(), keys[i], kh_.key_size) ==
+                        0)
+                    {
+                        results[i] = std::move(lookup.record);
+                        lookup.done = true;
+                        continue;
+                    }
+                }
+                advance(lookup);
+            }
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
 class NuDBBackend : public Backend
 {
 public:
@@ -48,6 +423,29 @@ public:
     std::atomic<bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Where the compression dictionary is kept, or empty if leaf nodes
+    // are compressed without one.
+    std::string const dictionaryPath_;
+
+    // The dictionary new objects are compressed with, once there is one.
+    // Dictionaries stay registered for the life of the process, so a raw
+    // pointer is safe to hand out.
+    std::atomic<CompressionDictionary const*> dictionary_{nullptr};
+
+    // Leaf nodes collected to train a dictionary, by ledger entry type.
+    std::mutex samplesMutex_;
+    std::vector<Blob> samples_;
+    std::map<std::uint16_t, std::size_t> sampleTypes_;
+    std::size_t sampled_ = 0;
+
+    // Whether a read only database is read with io_uring rather than
+    // mapped into memory.
+    bool const ioUring_;
+
+    // Set while the database is read only: one or the other.
+    std::shared_ptr<NuDBMapping const> mapping_;
+    std::shared_ptr<NuDBFileReader const> reader_;
+
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
@@ -60,6 +458,9 @@ public:
         , name_(get<std::string>(keyValues, "path"))
         , deletePath_(false)
         , scheduler_(scheduler)
+        , dictionaryPath_(
+              get<std::string>(keyValues, "compression_dictionary"))
+        , ioUring_(get<bool>(keyValues, "io_uring", false))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -80,6 +481,9 @@ public:
         , db_(context)
         , deletePath_(false)
         , scheduler_(scheduler)
+        , dictionaryPath_(
+              get<std::string>(keyValues, "compression_dictionary"))
+        , ioUring_(get<bool>(keyValues, "io_uring", false))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -136,6 +540,16 @@ public:
         if (db_.appnum() != currentType)
             Throw<std::runtime_error>("nodestore: unknown appnum");
         db_.set_burst(burstSize_);
+
+        if (!dictionaryPath_.empty() && !dictionary_ &&
+            exists(path(dictionaryPath_)))
+        {
+            auto const dictionary =
+                CompressionDictionary::load(dictionaryPath_);
+            JLOG(j_.info()) << "Using compression dictionary "
+                            << dictionary->id() << " from " << dictionaryPath_;
+            dictionary_ = dictionary.get();
+        }
     }
 
     bool
@@ -147,6 +561,8 @@ public:
     void
     close() override
     {
+        mapping_.reset();
+        reader_.reset();
         if (db_.is_open())
         {
             nudb::error_code ec;
@@ -163,21 +579,44 @@ public:
     Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pno) override
     {
+        if (mapping_)
+            return fetchMapped(key, pno);
+        if (reader_)
+        {
+            auto const value = reader_->find({key}).front();
+            if (!value)
+            {
+                pno->reset();
+                return notFound;
+            }
+            return decode(key, *value, value, pno);
+        }
+
         Status status;
         pno->reset();
         nudb::error_code ec;
         db_.fetch(
             key,
-            [key, pno, &status](void const* data, std::size_t size) {
-                nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+            [this, key, pno, &status](void const* data, std::size_t size) {
+                // Decompress straight into the buffer the NodeObject will
+                // keep, so the payload is not copied a second time. NuDB's
+                // own buffer is only valid for the duration of the call, so
+                // an uncompressed value must still be copied once.
+                auto buffer = std::make_shared<Buffer>();
+                auto result =
+                    nodeobject_decompress(data, size, *buffer, dictionary_);
+                if (result.first != buffer->data())
+                {
+                    *buffer = Buffer(result.first, result.second);
+                    result.first = buffer->data();
+                }
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
                     status = dataCorrupt;
                     return;
                 }
-                *pno = decoded.createObject();
+                *pno = decoded.createObject(std::move(buffer));
                 status = ok;
             },
             ec);
@@ -188,27 +627,215 @@ public:
         return status;
     }
 
-    bool
-    canFetchBatch() override
+    Status
+    fetchMapped(void const* key, std::shared_ptr<NodeObject>* pno)
     {
-        return false;
+        pno->reset();
+        auto const value = mapping_->find(key);
+        if (!value)
+            return notFound;
+        return decode(key, *value, mapping_, pno);
+    }
+
+    // Decode a value read by the mapping or the reader. An uncompressed
+    // value is used in place, which `owner` keeps alive; anything else is
+    // decompressed into a buffer.
+    Status
+    decode(
+        void const* key,
+        Slice value,
+        std::shared_ptr<void const> owner,
+        std::shared_ptr<NodeObject>* pno)
+    {
+        auto buffer = std::make_shared<Buffer>();
+        auto const result = nodeobject_decompress(
+            value.data(), value.size(), *buffer, dictionary_);
+        if (result.first == buffer->data())
+            owner = std::move(buffer);
+        DecodedBlob decoded(key, result.first, result.second);
+        if (!decoded.wasOk())
+            return dataCorrupt;
+        *pno = decoded.createObject(std::move(owner));
+        return ok;
+    }
+
+    // The records the reader returns hold the key before the value.
+    Status
+    decode(
+        void const* key,
+        Buffer const& record,
+        std::shared_ptr<void const> owner,
+        std::shared_ptr<NodeObject>* pno)
+    {
+        return decode(
+            key,
+            Slice(record.data() + keyBytes_, record.size() - keyBytes_),
+            std::move(owner),
+            pno);
+    }
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch(std::vector<uint256 const*> const& hashes) override
+    {
+        if (reader_)
+        {
+            // Every key is looked up at once
+            std::vector<void const*> keys;
+            keys.reserve(hashes.size());
+            for (auto const h : hashes)
+                keys.push_back(h->data());
+            auto const values = reader_->find(keys);
+
+            std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                if (values[i])
+                    decode(keys[i], *values[i], values[i], &results[i]);
+            }
+            return {results, ok};
+        }
+
+        // NuDB has no multi-key read, but its fetch is safe to call
+        // concurrently so the cost here is one read per key at most.
+        std::vector<std::shared_ptr<NodeObject>> results;
+        results.reserve(hashes.size());
+        for (auto const h : hashes)
+        {
+            std::shared_ptr<NodeObject> nObj;
+            Status status = fetch(h->begin(), &nObj);
+            if (status != ok)
+                results.push_back({});
+            else
+                results.push_back(nObj);
+        }
+        return {results, ok};
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch(std::size_t n, void const* const* keys) override
+    /** Collect a leaf node to train the compression dictionary with.
+
+        Samples are spread across ledger entry types, so that a handful of
+        common types do not crowd the others out of the dictionary. Once
+        enough have been gathered, a dictionary is trained, saved and used
+        for every object written afterwards.
+    */
+    void
+    sample(EncodedBlob const& e)
     {
-        Throw<std::runtime_error>("pure virtual called");
-        return {};
+        // The encoded blob is 8 unused bytes, the object type and the
+        // serialized node, which starts with its hash prefix.
+        static constexpr std::size_t header = 9 + sizeof(std::uint32_t);
+        if (e.getSize() <= header + 3)
+            return;
+        auto const p = static_cast<std::uint8_t const*>(e.getData());
+        auto const prefix = (std::uint32_t{p[9]} << 24) |
+            (std::uint32_t{p[10]} << 16) | (std::uint32_t{p[11]} << 8) |
+            std::uint32_t{p[12]};
+
+        // State leaves begin with the sfLedgerEntryType field; all the
+        // transaction leaves share one bucket.
+        std::uint16_t bucket;
+        if (p[8] == hotACCOUNT_NODE &&
+            prefix == static_cast<std::uint32_t>(HashPrefix::leafNode))
+        {
+            if (p[header] != 0x11)
+                return;
+            bucket = (std::uint16_t{p[header + 1]} << 8) | p[header + 2];
+        }
+        else if (
+            p[8] == hotTRANSACTION_NODE &&
+            prefix == static_cast<std::uint32_t>(HashPrefix::txNode))
+        {
+            bucket = 0;
+        }
+        else
+        {
+            return;
+        }
+
+        std::vector<Blob> samples;
+        {
+            std::lock_guard lock(samplesMutex_);
+            if (dictionary_)
+                return;
+            auto const target = CompressionDictionary::defaultSamples;
+            if (sampleTypes_[bucket] < target / 4)
+            {
+                ++sampleTypes_[bucket];
+                samples_.emplace_back(p, p + e.getSize());
+            }
+            // Train with what there is if the rarer types never fill in.
+            if (samples_.size() < target && ++sampled_ < 4 * target)
+                return;
+            samples = std::move(samples_);
+            samples_.clear();
+            sampleTypes_.clear();
+            sampled_ = 0;
+        }
+        train(samples);
+    }
+
+    void
+    train(std::vector<Blob> const& samples)
+    {
+        // All the backends configured with the same dictionary share its
+        // file, and objects written with a dictionary can only be read
+        // with it, so never replace a dictionary another backend saved.
+        static std::mutex mutex;
+        std::lock_guard lock(mutex);
+
+        std::shared_ptr<CompressionDictionary const> dictionary;
+        try
+        {
+            if (boost::filesystem::exists(dictionaryPath_))
+            {
+                dictionary = CompressionDictionary::load(dictionaryPath_);
+                dictionary_ = dictionary.get();
+                return;
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            auto data = CompressionDictionary::train(samples);
+            if (data.empty())
+                return;
+            dictionary = std::make_shared<CompressionDictionary const>(
+                std::move(data));
+            CompressionDictionary::save(dictionaryPath_, *dictionary);
+            dictionary = CompressionDictionary::add(dictionary);
+            JLOG(j_.info())
+                << "Trained compression dictionary " << dictionary->id()
+                << " of " << dictionary->data().size() << " bytes from "
+                << samples.size() << " samples in "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count()
+                << "ms";
+        }
+        catch (std::exception const& e)
+        {
+            // Carry on without a dictionary; sampling starts over and
+            // tries again later.
+            JLOG(j_.error()) << "Unable to create compression dictionary "
+                             << dictionaryPath_ << ": " << e.what();
+            return;
+        }
+        dictionary_ = dictionary.get();
     }
 
     void
     do_insert(std::shared_ptr<NodeObject> const& no)
     {
+        // Objects written now would not be visible through the mapping.
+        if (mapping_ || reader_)
+            Throw<std::logic_error>("nodestore: NuDB backend is read only");
+
         EncodedBlob e;
         e.prepare(no);
+        if (!dictionaryPath_.empty() && !dictionary_)
+            sample(e);
         nudb::error_code ec;
         nudb::detail::buffer bf;
-        auto const result = nodeobject_compress(e.getData(), e.getSize(), bf);
+        auto const result =
+            nodeobject_compress(e.getData(), e.getSize(), bf, dictionary_);
         db_.insert(e.getKey(), result.first, result.second, ec);
         if (ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
@@ -258,7 +885,8 @@ public:
                 std::size_t size,
                 nudb::error_code&) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, dictionary_);
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -288,6 +916,23 @@ public:
         deletePath_ = true;
     }
 
+    void
+    setReadOnly() override
+    {
+        if (mapping_ || reader_ || !db_.is_open())
+            return;
+        if (ioUring_ && IoUring::available())
+        {
+            reader_ = std::make_shared<NuDBFileReader const>(
+                db_.key_path(), db_.dat_path());
+        }
+        else
+        {
+            mapping_ = std::make_shared<NuDBMapping const>(
+                db_.key_path(), db_.dat_path());
+        }
+    }
+
     void
     verify() override
     {
@@ -310,7 +955,8 @@ public:
     int
     fdRequired() const override
     {
-        return 3;
+        // The reader opens the key and data files a second time
+        return ioUring_ ? 5 : 3;
     }
 };
 
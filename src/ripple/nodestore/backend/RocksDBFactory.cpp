@@ -30,8 +30,12 @@
 #include <ripple/nodestore/impl/BatchWriter.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <boost/filesystem.hpp>
 #include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace ripple {
 namespace NodeStore {
@@ -80,9 +84,134 @@ public:
 
 //------------------------------------------------------------------------------
 
+/** One RocksDB database holding several backends as column families.
+
+    When "column_families" is set, the backends which online_delete
+    rotates through are kept as column families of a single database
+    beside them, rather than as separate databases. Dropping the archive
+    is then a DropColumnFamily, and the backends share one write ahead
+    log and one set of background threads.
+
+    Each backend also keeps an empty directory at its own path, which is
+    how online_delete tells which backends exist. A column family whose
+    directory is gone is left over from an interrupted rotation and is
+    dropped when the database is opened.
+*/
+class RocksDBShared
+{
+    rocksdb::DB* db_ = nullptr;
+    std::mutex mutex_;
+    std::map<std::string, rocksdb::ColumnFamilyHandle*> families_;
+
+public:
+    RocksDBShared(std::string const& path, rocksdb::Options const& options)
+    {
+        std::vector<std::string> names;
+        if (!rocksdb::DB::ListColumnFamilies(options, path, &names).ok())
+            names = {rocksdb::kDefaultColumnFamilyName};
+
+        std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+        for (auto const& name : names)
+            descriptors.emplace_back(
+                name, rocksdb::ColumnFamilyOptions(options));
+
+        rocksdb::DBOptions dbOptions(options);
+        dbOptions.create_if_missing = true;
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
+        auto const status = rocksdb::DB::Open(
+            dbOptions, path, descriptors, &handles, &db_);
+        if (!status.ok() || !db_)
+            Throw<std::runtime_error>(
+                std::string("Unable to open/create RocksDB: ") +
+                status.ToString());
+
+        auto const parent = boost::filesystem::path(path).parent_path();
+        for (std::size_t i = 0; i < handles.size(); ++i)
+        {
+            if (names[i] == rocksdb::kDefaultColumnFamilyName)
+                db_->DestroyColumnFamilyHandle(handles[i]);
+            else if (!boost::filesystem::exists(parent / names[i]))
+            {
+                db_->DropColumnFamily(handles[i]);
+                db_->DestroyColumnFamilyHandle(handles[i]);
+            }
+            else
+                families_.emplace(names[i], handles[i]);
+        }
+    }
+
+    ~RocksDBShared()
+    {
+        for (auto const& family : families_)
+            db_->DestroyColumnFamilyHandle(family.second);
+        delete db_;
+    }
+
+    /** Open the database at `path`, sharing it if it is already open. */
+    static std::shared_ptr<RocksDBShared>
+    open(std::string const& path, rocksdb::Options const& options)
+    {
+        static std::mutex mutex;
+        static std::map<std::string, std::weak_ptr<RocksDBShared>> open;
+
+        std::lock_guard lock(mutex);
+        auto& shared = open[path];
+        if (auto result = shared.lock())
+            return result;
+        auto result = std::make_shared<RocksDBShared>(path, options);
+        shared = result;
+        return result;
+    }
+
+    rocksdb::DB*
+    db() const
+    {
+        return db_;
+    }
+
+    /** Return a column family, creating it if there is none. */
+    rocksdb::ColumnFamilyHandle*
+    family(std::string const& name, rocksdb::Options const& options)
+    {
+        std::lock_guard lock(mutex_);
+        auto& handle = families_[name];
+        if (!handle)
+        {
+            auto const status = db_->CreateColumnFamily(
+                rocksdb::ColumnFamilyOptions(options), name, &handle);
+            if (!status.ok())
+            {
+                families_.erase(name);
+                Throw<std::runtime_error>(
+                    std::string("Unable to create RocksDB column family: ") +
+                    status.ToString());
+            }
+        }
+        return handle;
+    }
+
+    /** Drop a column family and everything in it. */
+    void
+    drop(std::string const& name)
+    {
+        std::lock_guard lock(mutex_);
+        auto const it = families_.find(name);
+        if (it == families_.end())
+            return;
+        db_->DropColumnFamily(it->second);
+        db_->DestroyColumnFamilyHandle(it->second);
+        families_.erase(it);
+    }
+};
+
+//------------------------------------------------------------------------------
+
 class RocksDBBackend : public Backend, public BatchWriter::Callback
 {
 private:
+    // Where the shared database is kept, beside the backends' directories
+    static constexpr char const* sharedName = "rocksdb_families";
+
     std::atomic<bool> m_deletePath;
 
 public:
@@ -92,6 +221,12 @@ public:
     BatchWriter m_batch;
     std::string m_name;
     std::unique_ptr<rocksdb::DB> m_db;
+    // Set when the backend is a column family of a shared database
+    std::shared_ptr<RocksDBShared> m_shared;
+    // The database and column family every operation goes to
+    rocksdb::DB* db_ = nullptr;
+    rocksdb::ColumnFamilyHandle* family_ = nullptr;
+    bool m_columnFamilies = false;
     int fdRequired_ = 2048;
     rocksdb::Options m_options;
 
@@ -105,11 +240,17 @@ public:
         , m_journal(journal)
         , m_keyBytes(keyBytes)
         , m_scheduler(scheduler)
-        , m_batch(*this, scheduler)
+        , m_batch(*this, scheduler, [&keyValues] {
+            std::size_t mb = 0;
+            get_if_exists(keyValues, "write_budget_mb", mb);
+            return megabytes(mb);
+        }())
     {
         if (!get_if_exists(keyValues, "path", m_name))
             Throw<std::runtime_error>("Missing path in RocksDBFactory backend");
 
+        get_if_exists(keyValues, "column_families", m_columnFamilies);
+
         rocksdb::BlockBasedTableOptions table_options;
         m_options.env = env;
 
@@ -210,12 +351,30 @@ public:
     void
     open(bool createIfMissing) override
     {
-        if (m_db)
+        if (db_)
         {
             assert(false);
             JLOG(m_journal.error()) << "database is already open";
             return;
         }
+
+        if (m_columnFamilies)
+        {
+            boost::filesystem::path const dir = m_name;
+            if (createIfMissing)
+                boost::filesystem::create_directories(dir);
+            else if (!boost::filesystem::exists(dir))
+                Throw<std::runtime_error>(
+                    "Unable to open RocksDB column family: " + m_name +
+                    " does not exist");
+
+            m_shared = RocksDBShared::open(
+                (dir.parent_path() / sharedName).string(), m_options);
+            family_ = m_shared->family(dir.filename().string(), m_options);
+            db_ = m_shared->db();
+            return;
+        }
+
         rocksdb::DB* db = nullptr;
         m_options.create_if_missing = createIfMissing;
         rocksdb::Status status = rocksdb::DB::Open(m_options, m_name, &db);
@@ -224,25 +383,33 @@ public:
                 std::string("Unable to open/create RocksDB: ") +
                 status.ToString());
         m_db.reset(db);
+        db_ = db;
+        family_ = db->DefaultColumnFamily();
     }
 
     bool
     isOpen() override
     {
-        return static_cast<bool>(m_db);
+        return db_ != nullptr;
     }
 
     void
     close() override
     {
-        if (m_db)
+        if (db_)
         {
+            db_ = nullptr;
+            family_ = nullptr;
+            boost::filesystem::path dir = m_name;
+            if (m_shared)
+            {
+                if (m_deletePath)
+                    m_shared->drop(dir.filename().string());
+                m_shared.reset();
+            }
             m_db.reset();
             if (m_deletePath)
-            {
-                boost::filesystem::path dir = m_name;
                 boost::filesystem::remove_all(dir);
-            }
         }
     }
 
@@ -257,7 +424,7 @@ public:
     Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pObject) override
     {
-        assert(m_db);
+        assert(db_);
         pObject->reset();
 
         Status status(ok);
@@ -265,17 +432,20 @@ public:
         rocksdb::ReadOptions const options;
         rocksdb::Slice const slice(static_cast<char const*>(key), m_keyBytes);
 
-        std::string string;
+        // The value is read into a string which the NodeObject then
+        // keeps, so the payload is never copied out of it.
+        auto value = std::make_shared<std::string>();
 
-        rocksdb::Status getStatus = m_db->Get(options, slice, &string);
+        rocksdb::Status getStatus =
+            db_->Get(options, family_, slice, value.get());
 
         if (getStatus.ok())
         {
-            DecodedBlob decoded(key, string.data(), string.size());
+            DecodedBlob decoded(key, value->data(), value->size());
 
             if (decoded.wasOk())
             {
-                *pObject = decoded.createObject();
+                *pObject = decoded.createObject(std::move(value));
             }
             else
             {
@@ -305,17 +475,55 @@ public:
         return status;
     }
 
-    bool
-    canFetchBatch() override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
-        return false;
-    }
+        assert(db_);
+
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
+        for (auto const h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        std::vector<std::string> values;
+        std::vector<rocksdb::ColumnFamilyHandle*> const families(
+            keys.size(), family_);
+        auto const statuses =
+            db_->MultiGet(rocksdb::ReadOptions(), families, keys, &values);
+        assert(statuses.size() == hashes.size());
+
+        std::vector<std::shared_ptr<NodeObject>> results;
+        results.reserve(hashes.size());
+        for (std::size_t i = 0; i < statuses.size(); ++i)
+        {
+            if (statuses[i].ok())
+            {
+                auto value =
+                    std::make_shared<std::string>(std::move(values[i]));
+                DecodedBlob decoded(
+                    hashes[i]->data(), value->data(), value->size());
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch(std::size_t n, void const* const* keys) override
-    {
-        Throw<std::runtime_error>("pure virtual called");
-        return {};
+                if (decoded.wasOk())
+                {
+                    results.push_back(decoded.createObject(std::move(value)));
+                    continue;
+                }
+
+                // Decoding failed, probably corrupted!
+                //
+                JLOG(m_journal.error())
+                    << "Corrupt NodeObject #" << *hashes[i];
+            }
+            else if (!statuses[i].IsNotFound())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString();
+            }
+
+            results.push_back({});
+        }
+
+        return {results, ok};
     }
 
     void
@@ -327,7 +535,7 @@ public:
     void
     storeBatch(Batch const& batch) override
     {
-        assert(m_db);
+        assert(db_);
         rocksdb::WriteBatch wb;
 
         EncodedBlob encoded;
@@ -337,6 +545,7 @@ public:
             encoded.prepare(e);
 
             wb.Put(
+                family_,
                 rocksdb::Slice(
                     reinterpret_cast<char const*>(encoded.getKey()),
                     m_keyBytes),
@@ -347,7 +556,7 @@ public:
 
         rocksdb::WriteOptions const options;
 
-        auto ret = m_db->Write(options, &wb);
+        auto ret = db_->Write(options, &wb);
 
         if (!ret.ok())
             Throw<std::runtime_error>("storeBatch failed: " + ret.ToString());
@@ -356,10 +565,11 @@ public:
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
-        assert(m_db);
+        assert(db_);
         rocksdb::ReadOptions const options;
 
-        std::unique_ptr<rocksdb::Iterator> it(m_db->NewIterator(options));
+        std::unique_ptr<rocksdb::Iterator> it(
+            db_->NewIterator(options, family_));
 
         for (it->SeekToFirst(); it->Valid(); it->Next())
         {
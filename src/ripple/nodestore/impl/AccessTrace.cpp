@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/AccessTrace.h>
+#include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+char const magic[] = "NSTRACE1";
+constexpr std::size_t magicSize = sizeof(magic) - 1;
+
+template <class Int>
+std::uint8_t*
+put(std::uint8_t* out, Int v)
+{
+    for (std::size_t i = 0; i < sizeof(Int); ++i)
+        *out++ = static_cast<std::uint8_t>(v >> (8 * i));
+    return out;
+}
+
+template <class Int>
+std::uint8_t const*
+get(std::uint8_t const* in, Int& v)
+{
+    v = 0;
+    for (std::size_t i = 0; i < sizeof(Int); ++i)
+        v |= static_cast<Int>(*in++) << (8 * i);
+    return in;
+}
+
+}  // namespace
+
+AccessTrace::AccessTrace(
+    boost::filesystem::path const& path,
+    std::uint32_t sampleRate)
+    : sampleRate_(std::max<std::uint32_t>(sampleRate, 1))
+{
+    boost::system::error_code ec;
+    auto const fresh = !boost::filesystem::exists(path, ec) ||
+        boost::filesystem::file_size(path, ec) == 0;
+
+    file_.open(
+        path.string(), std::ios::out | std::ios::app | std::ios::binary);
+    if (!file_)
+        Throw<std::runtime_error>(
+            "Unable to open node store access trace " + path.string());
+    if (fresh)
+        file_.write(magic, magicSize);
+}
+
+AccessTrace::~AccessTrace()
+{
+    std::lock_guard lock(mutex_);
+    file_.flush();
+}
+
+bool
+AccessTrace::sampled(uint256 const& hash, std::uint32_t sampleRate)
+{
+    // Node object keys are hashes, so any of their bits will do
+    std::uint64_t id;
+    std::memcpy(&id, hash.data(), sizeof(id));
+    return sampleRate != 0 && id % sampleRate == 0;
+}
+
+void
+AccessTrace::fetched(
+    uint256 const& hash,
+    std::uint32_t ledgerSeq,
+    std::shared_ptr<NodeObject> const& nodeObject,
+    std::chrono::microseconds latency)
+{
+    Entry entry;
+    entry.time = std::chrono::system_clock::now();
+    entry.latency = latency;
+    entry.ledgerSeq = ledgerSeq;
+    entry.op = Op::fetch;
+    entry.found = nodeObject != nullptr;
+    entry.type = nodeObject ? nodeObject->getType() : hotUNKNOWN;
+    entry.size = nodeObject
+        ? static_cast<std::uint32_t>(nodeObject->getData().size())
+        : 0;
+    entry.hash = hash;
+    write(entry);
+}
+
+void
+AccessTrace::stored(
+    NodeObject const& nodeObject,
+    std::uint32_t ledgerSeq,
+    std::chrono::microseconds latency)
+{
+    Entry entry;
+    entry.time = std::chrono::system_clock::now();
+    entry.latency = latency;
+    entry.ledgerSeq = ledgerSeq;
+    entry.op = Op::store;
+    entry.found = true;
+    entry.type = nodeObject.getType();
+    entry.size = static_cast<std::uint32_t>(nodeObject.getData().size());
+    entry.hash = nodeObject.getHash();
+    write(entry);
+}
+
+void
+AccessTrace::write(Entry const& entry)
+{
+    using namespace std::chrono;
+
+    std::array<std::uint8_t, entrySize> record;
+    auto out = record.data();
+    out = put<std::uint64_t>(
+        out,
+        duration_cast<microseconds>(entry.time.time_since_epoch()).count());
+    out = put<std::uint32_t>(
+        out,
+        static_cast<std::uint32_t>(std::min<std::int64_t>(
+            entry.latency.count(), std::numeric_limits<std::uint32_t>::max())));
+    out = put<std::uint32_t>(out, entry.ledgerSeq);
+    out = put<std::uint32_t>(out, entry.size);
+    *out++ = static_cast<std::uint8_t>(entry.type);
+    *out++ = static_cast<std::uint8_t>(entry.op);
+    *out++ = entry.found ? 1 : 0;
+    *out++ = 0;
+    std::memcpy(out, entry.hash.data(), entry.hash.size());
+
+    std::lock_guard lock(mutex_);
+    file_.write(reinterpret_cast<char const*>(record.data()), record.size());
+    size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool
+AccessTrace::readHeader(std::istream& in)
+{
+    char header[magicSize];
+    return in.read(header, magicSize) &&
+        std::memcmp(header, magic, magicSize) == 0;
+}
+
+boost::optional<AccessTrace::Entry>
+AccessTrace::read(std::istream& in)
+{
+    using namespace std::chrono;
+
+    std::array<std::uint8_t, entrySize> record;
+    if (!in.read(reinterpret_cast<char*>(record.data()), record.size()))
+        return boost::none;
+
+    Entry entry;
+    std::uint64_t time;
+    std::uint32_t latency;
+    std::uint8_t const* p = record.data();
+    p = get(p, time);
+    p = get(p, latency);
+    p = get(p, entry.ledgerSeq);
+    p = get(p, entry.size);
+    entry.time = system_clock::time_point(microseconds(time));
+    entry.latency = microseconds(latency);
+    entry.type = static_cast<NodeObjectType>(*p++);
+    entry.op = *p++ == 0 ? Op::fetch : Op::store;
+    entry.found = *p++ != 0;
+    ++p;
+    std::memcpy(entry.hash.data(), p, entry.hash.size());
+    return entry;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -18,15 +18,22 @@
 //==============================================================================
 
 #include <ripple/nodestore/impl/BatchWriter.h>
+#include <utility>
 
 namespace ripple {
 namespace NodeStore {
 
-BatchWriter::BatchWriter(Callback& callback, Scheduler& scheduler)
+BatchWriter::BatchWriter(
+    Callback& callback,
+    Scheduler& scheduler,
+    std::size_t byteLimit)
     : m_callback(callback)
     , m_scheduler(scheduler)
+    , mByteLimit(byteLimit)
     , mWriteLoad(0)
     , mWritePending(false)
+    , mWriteBytes(0)
+    , mStalled(0)
 {
     mWriteSet.reserve(batchWritePreallocationSize);
 }
@@ -43,10 +50,18 @@ BatchWriter::store(std::shared_ptr<NodeObject> const& object)
 
     // If the batch has reached its limit, we wait
     // until the batch writer is finished
-    while (mWriteSet.size() >= batchWriteLimitSize)
-        mWriteCondition.wait(sl);
+    if (full())
+    {
+        auto const before = std::chrono::steady_clock::now();
+        do
+            mWriteCondition.wait(sl);
+        while (full());
+        mStalled += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - before);
+    }
 
     mWriteSet.push_back(object);
+    mWriteBytes += object->getData().size();
 
     if (!mWritePending)
     {
@@ -61,7 +76,22 @@ BatchWriter::getWriteLoad()
 {
     std::lock_guard sl(mWriteMutex);
 
-    return std::max(mWriteLoad, static_cast<int>(mWriteSet.size()));
+    int load = mWriteSet.size();
+    if (mByteLimit != 0)
+    {
+        load = std::max<int>(
+            load,
+            static_cast<double>(mWriteBytes) / mByteLimit *
+                batchWriteLimitSize);
+    }
+    return std::max(mWriteLoad, load);
+}
+
+bool
+BatchWriter::full() const
+{
+    return mWriteSet.size() >= batchWriteLimitSize ||
+        (mByteLimit != 0 && mWriteBytes >= mByteLimit);
 }
 
 void
@@ -79,12 +109,14 @@ BatchWriter::writeBatch()
 
         set.reserve(batchWritePreallocationSize);
 
+        BatchWriteReport report;
         {
             std::lock_guard sl(mWriteMutex);
 
             mWriteSet.swap(set);
             assert(mWriteSet.empty());
             mWriteLoad = set.size();
+            mWriteBytes = 0;
 
             if (set.empty())
             {
@@ -94,9 +126,13 @@ BatchWriter::writeBatch()
                 // VFALCO NOTE Fix this function to not return from the middle
                 return;
             }
+
+            // The next batch fills while this one is written, so anyone
+            // waiting for room can go on now
+            mWriteCondition.notify_all();
+            report.stalled = std::exchange(mStalled, {});
         }
 
-        BatchWriteReport report;
         report.writeCount = set.size();
         auto const before = std::chrono::steady_clock::now();
 
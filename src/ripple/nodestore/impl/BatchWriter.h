@@ -53,8 +53,17 @@ public:
         writeBatch(Batch const& batch) = 0;
     };
 
-    /** Create a batch writer. */
-    BatchWriter(Callback& callback, Scheduler& scheduler);
+    /** Create a batch writer.
+
+        One batch fills while the previous one is written. Callers of
+        store() only wait if the filling batch reaches its limit, which is
+        batchWriteLimitSize objects or, if byteLimit is not zero, that
+        many bytes of object data, whichever comes first.
+    */
+    BatchWriter(
+        Callback& callback,
+        Scheduler& scheduler,
+        std::size_t byteLimit = 0);
 
     /** Destroy a batch writer.
 
@@ -70,7 +79,12 @@ public:
     void
     store(std::shared_ptr<NodeObject> const& object);
 
-    /** Get an estimate of the amount of writing I/O pending. */
+    /** Get an estimate of the amount of writing I/O pending.
+
+        This is the number of objects waiting to be written. With a byte
+        limit, a batch which is full by size counts as batchWriteLimitSize
+        objects, so callers see the same load whichever limit applies.
+    */
     int
     getWriteLoad();
 
@@ -82,17 +96,25 @@ private:
     void
     waitForWriting();
 
+    bool
+    full() const;
+
 private:
     using LockType = std::recursive_mutex;
     using CondvarType = std::condition_variable_any;
 
     Callback& m_callback;
     Scheduler& m_scheduler;
+    std::size_t const mByteLimit;
     LockType mWriteMutex;
     CondvarType mWriteCondition;
     int mWriteLoad;
     bool mWritePending;
     Batch mWriteSet;
+    std::size_t mWriteBytes;
+
+    // Time callers spent waiting in store() since the last report
+    std::chrono::microseconds mStalled;
 };
 
 }  // namespace NodeStore
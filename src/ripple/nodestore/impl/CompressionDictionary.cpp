@@ -0,0 +1,316 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+// Disable lz4 deprecation warning due to incompatibility with clang attributes
+#define LZ4_DISABLE_DEPRECATE_WARNINGS
+
+#include <ripple/basics/FileUtilities.h>
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/protocol/digest.h>
+#include <algorithm>
+#include <cstring>
+#include <lz4.h>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ripple {
+namespace NodeStore {
+
+struct CompressionDictionary::Stream
+{
+    LZ4_stream_t state;
+};
+
+namespace {
+
+// Training scores segments of the samples by the byte strings of this
+// length which they contain.
+constexpr std::size_t dmerSize = 8;
+
+// Training selects segments of this many bytes.
+constexpr std::size_t segmentSize = 64;
+
+std::uint64_t
+dmerAt(std::uint8_t const* p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint32_t
+dictionaryId(Slice data)
+{
+    auto const h = sha512Half(data);
+    return (std::uint32_t{h.data()[0]} << 24) |
+        (std::uint32_t{h.data()[1]} << 16) |
+        (std::uint32_t{h.data()[2]} << 8) | std::uint32_t{h.data()[3]};
+}
+
+class Registry
+{
+    std::mutex mutex_;
+    std::map<std::uint32_t, std::shared_ptr<CompressionDictionary const>>
+        dictionaries_;
+
+public:
+    std::shared_ptr<CompressionDictionary const>
+    add(std::shared_ptr<CompressionDictionary const> dictionary)
+    {
+        std::lock_guard lock(mutex_);
+        auto const [it, inserted] =
+            dictionaries_.emplace(dictionary->id(), dictionary);
+        if (!inserted && it->second->data() != dictionary->data())
+            Throw<std::runtime_error>(
+                "nodestore: compression dictionary id collision: " +
+                std::to_string(dictionary->id()));
+        return it->second;
+    }
+
+    std::shared_ptr<CompressionDictionary const>
+    find(std::uint32_t id)
+    {
+        std::lock_guard lock(mutex_);
+        auto const it = dictionaries_.find(id);
+        if (it == dictionaries_.end())
+            return {};
+        return it->second;
+    }
+};
+
+Registry&
+registry()
+{
+    static Registry r;
+    return r;
+}
+
+}  // namespace
+
+CompressionDictionary::CompressionDictionary(Blob data)
+    : data_(std::move(data))
+    , id_(dictionaryId(makeSlice(data_)))
+    , stream_(std::make_unique<Stream>())
+{
+    if (data_.empty() || data_.size() > maxSize)
+        Throw<std::runtime_error>(
+            "nodestore: bad compression dictionary size: " +
+            std::to_string(data_.size()));
+    LZ4_initStream(&stream_->state, sizeof(stream_->state));
+    LZ4_loadDict(
+        &stream_->state,
+        reinterpret_cast<char const*>(data_.data()),
+        static_cast<int>(data_.size()));
+}
+
+CompressionDictionary::~CompressionDictionary() = default;
+
+std::size_t
+CompressionDictionary::compressBound(std::size_t size)
+{
+    return LZ4_compressBound(static_cast<int>(size));
+}
+
+std::size_t
+CompressionDictionary::compress(Slice in, void* out, std::size_t outSize) const
+{
+    // The loaded stream refers to the dictionary by address, so a copy of it
+    // compresses against the same dictionary without reloading it.
+    thread_local Stream work;
+    std::memcpy(&work.state, &stream_->state, sizeof(work.state));
+    auto const n = LZ4_compress_fast_continue(
+        &work.state,
+        reinterpret_cast<char const*>(in.data()),
+        reinterpret_cast<char*>(out),
+        static_cast<int>(in.size()),
+        static_cast<int>(outSize),
+        1);
+    if (n <= 0)
+        Throw<std::runtime_error>("lz4 compress with dictionary");
+    return n;
+}
+
+void
+CompressionDictionary::decompress(Slice in, void* out, std::size_t outSize)
+    const
+{
+    if (LZ4_decompress_safe_usingDict(
+            reinterpret_cast<char const*>(in.data()),
+            reinterpret_cast<char*>(out),
+            static_cast<int>(in.size()),
+            static_cast<int>(outSize),
+            reinterpret_cast<char const*>(data_.data()),
+            static_cast<int>(data_.size())) != static_cast<int>(outSize))
+        Throw<std::runtime_error>(
+            "lz4 decompress: LZ4_decompress_safe_usingDict");
+}
+
+Blob
+CompressionDictionary::train(std::vector<Blob> const& samples, std::size_t size)
+{
+    size = std::min(size, maxSize);
+
+    // Count the number of samples each string appears in, and gather the
+    // samples into one buffer to select segments from.
+    std::unordered_map<std::uint64_t, std::uint32_t> frequency;
+    Blob all;
+    {
+        std::unordered_set<std::uint64_t> seen;
+        for (auto const& sample : samples)
+        {
+            if (sample.size() < dmerSize)
+                continue;
+            seen.clear();
+            for (std::size_t i = 0; i + dmerSize <= sample.size(); ++i)
+            {
+                auto const dmer = dmerAt(&sample[i]);
+                if (seen.insert(dmer).second)
+                    ++frequency[dmer];
+            }
+            all.insert(all.end(), sample.begin(), sample.end());
+        }
+    }
+
+    if (all.size() <= size)
+        return all;
+
+    // A string which appears in only one sample is not worth including.
+    auto const value = [&frequency](std::uint64_t dmer) -> std::uint64_t {
+        auto const it = frequency.find(dmer);
+        if (it == frequency.end() || it->second < 2)
+            return 0;
+        return it->second;
+    };
+
+    // Split the samples into one epoch per segment the dictionary can hold
+    // and pick the best segment from each, so the whole sample set is
+    // covered in a single pass. A segment's score is the total frequency of
+    // the distinct strings starting in it.
+    auto const window = segmentSize - dmerSize + 1;
+    auto const epochs = std::max<std::size_t>(size / segmentSize, 1);
+    auto const epochSize = all.size() / epochs;
+
+    Blob dictionary;
+    dictionary.reserve(size);
+    std::unordered_map<std::uint64_t, std::uint32_t> active;
+    for (std::size_t epoch = 0; epoch < epochs && dictionary.size() < size;
+         ++epoch)
+    {
+        auto const begin = epoch * epochSize;
+        auto const end = begin + epochSize;
+
+        active.clear();
+        std::uint64_t score = 0;
+        std::uint64_t bestScore = 0;
+        std::size_t best = begin;
+        for (std::size_t i = begin; i + dmerSize <= end; ++i)
+        {
+            auto const dmer = dmerAt(&all[i]);
+            if (active[dmer]++ == 0)
+                score += value(dmer);
+            if (i >= begin + window)
+            {
+                auto const old = dmerAt(&all[i - window]);
+                auto const it = active.find(old);
+                if (--it->second == 0)
+                {
+                    score -= value(old);
+                    active.erase(it);
+                }
+            }
+            if (i + 1 >= begin + window && score > bestScore)
+            {
+                bestScore = score;
+                best = i + 1 - window;
+            }
+        }
+
+        if (bestScore == 0)
+            continue;
+
+        // The strings in the chosen segment are covered now, so later
+        // epochs should prefer segments adding something new.
+        for (std::size_t i = best; i < best + window; ++i)
+        {
+            auto const it = frequency.find(dmerAt(&all[i]));
+            if (it != frequency.end())
+                it->second = 0;
+        }
+
+        auto const n = std::min(segmentSize, size - dictionary.size());
+        dictionary.insert(
+            dictionary.end(), all.begin() + best, all.begin() + best + n);
+    }
+    return dictionary;
+}
+
+std::shared_ptr<CompressionDictionary const>
+CompressionDictionary::load(std::string const& path)
+{
+    boost::system::error_code ec;
+    auto const contents = getFileContents(ec, path, maxSize + 1);
+    if (ec)
+        Throw<std::runtime_error>(
+            "nodestore: unable to read compression dictionary " + path +
+            ": " + ec.message());
+    return add(std::make_shared<CompressionDictionary const>(
+        Blob(contents.begin(), contents.end())));
+}
+
+void
+CompressionDictionary::save(
+    std::string const& path,
+    CompressionDictionary const& dictionary)
+{
+    // Write a temporary file and rename it so a crash can never leave a
+    // truncated dictionary behind.
+    auto const temp = path + ".tmp";
+    boost::system::error_code ec;
+    auto const data = dictionary.data();
+    writeFileContents(
+        ec,
+        temp,
+        std::string(reinterpret_cast<char const*>(data.data()), data.size()));
+    if (!ec)
+        boost::filesystem::rename(temp, path, ec);
+    if (ec)
+        Throw<std::runtime_error>(
+            "nodestore: unable to write compression dictionary " + path +
+            ": " + ec.message());
+}
+
+std::shared_ptr<CompressionDictionary const>
+CompressionDictionary::add(
+    std::shared_ptr<CompressionDictionary const> dictionary)
+{
+    return registry().add(std::move(dictionary));
+}
+
+std::shared_ptr<CompressionDictionary const>
+CompressionDictionary::find(std::uint32_t id)
+{
+    return registry().find(id);
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A dictionary for compressing small node objects.
+
+    Leaf nodes are typically a few hundred bytes, too short for lz4 to
+    find much repetition within a single object, yet objects of the same
+    ledger entry type share most of their structure: field headers,
+    account IDs, currency codes and so on. Compressing against a
+    dictionary of byte strings which are common across many objects lets
+    lz4 reference them from the first byte.
+
+    A dictionary is identified by a 32-bit id derived from its contents,
+    which the codec stores in front of every object it compresses. Once
+    an object has been written with a dictionary, that exact dictionary
+    is needed to read it back, so dictionaries are never modified.
+
+    Every dictionary which has been loaded or trained is registered by
+    id for the lifetime of the process, so that any backend can decode
+    an object regardless of which backend instance compressed it.
+*/
+class CompressionDictionary
+{
+public:
+    /** Largest dictionary lz4 can make use of. */
+    static constexpr std::size_t maxSize = 64 * 1024;
+
+    /** Default size of a trained dictionary. */
+    static constexpr std::size_t defaultSize = 16 * 1024;
+
+    /** Number of leaf nodes sampled to train a dictionary. */
+    static constexpr std::size_t defaultSamples = 8192;
+
+    explicit CompressionDictionary(Blob data);
+
+    CompressionDictionary(CompressionDictionary const&) = delete;
+    CompressionDictionary&
+    operator=(CompressionDictionary const&) = delete;
+
+    ~CompressionDictionary();
+
+    /** Return the id stored in the header of compressed objects. */
+    std::uint32_t
+    id() const
+    {
+        return id_;
+    }
+
+    /** Return the contents of the dictionary. */
+    Slice
+    data() const
+    {
+        return makeSlice(data_);
+    }
+
+    /** Return the largest compressed size of an input of `size` bytes. */
+    static std::size_t
+    compressBound(std::size_t size);
+
+    /** Compress `in` into `out`, which holds compressBound(in.size()) bytes.
+
+        @return The number of bytes written to `out`.
+    */
+    std::size_t
+    compress(Slice in, void* out, std::size_t outSize) const;
+
+    /** Decompress `in` into `out`, which must hold exactly `outSize` bytes.
+
+        Throws if the input is corrupt or does not decompress to exactly
+        `outSize` bytes.
+    */
+    void
+    decompress(Slice in, void* out, std::size_t outSize) const;
+
+    /** Build a dictionary from sample objects.
+
+        Chooses the segments of the samples which contain the most byte
+        strings shared with other samples, until `size` bytes have been
+        selected. The samples should be representative of the objects that
+        will be compressed.
+    */
+    static Blob
+    train(std::vector<Blob> const& samples, std::size_t size = defaultSize);
+
+    /** Read a dictionary from a file and register it.
+
+        Throws if the file cannot be read or is not a usable dictionary.
+    */
+    static std::shared_ptr<CompressionDictionary const>
+    load(std::string const& path);
+
+    /** Write a dictionary to a file, replacing any existing file. */
+    static void
+    save(std::string const& path, CompressionDictionary const& dictionary);
+
+    /** Add a dictionary to the registry.
+
+        @return The registered dictionary with the same id, which is
+                `dictionary` unless an identical one was already present.
+    */
+    static std::shared_ptr<CompressionDictionary const>
+    add(std::shared_ptr<CompressionDictionary const> dictionary);
+
+    /** Return the registered dictionary with the given id, if any. */
+    static std::shared_ptr<CompressionDictionary const>
+    find(std::uint32_t id);
+
+private:
+    struct Stream;
+
+    Blob const data_;
+    std::uint32_t const id_;
+
+    // The lz4 stream state with the dictionary already loaded. Compressing
+    // starts from a copy of it, which is far cheaper than loading the
+    // dictionary again for every object.
+    std::unique_ptr<Stream> const stream_;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -21,7 +21,12 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/nodestore/impl/IoUring.h>
 #include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/jss.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <atomic>
 
 namespace ripple {
 namespace NodeStore {
@@ -36,14 +41,25 @@ Database::Database(
     : Stoppable(name, parent.getRoot())
     , j_(journal)
     , scheduler_(scheduler)
+    , readThreadsMax_(std::max<std::size_t>(
+          readThreads,
+          get<std::size_t>(config, "read_threads_max", 4 * readThreads)))
+    , readActive_(readThreads)
+    , readResized_(std::chrono::steady_clock::now())
+    , readBatch_(
+          get<bool>(config, "io_uring", false) && IoUring::available()
+              ? readBatchSize
+              : 1)
+    , readAffinity_(getCpuSet(config, "read_affinity"))
     , earliestLedgerSeq_(
           get<std::uint32_t>(config, "earliest_seq", XRP_LEDGER_EARLIEST_SEQ))
+    , accessTracePath_(get<std::string>(config, "access_trace"))
 {
     if (earliestLedgerSeq_ < 1)
         Throw<std::runtime_error>("Invalid earliest_seq");
 
-    while (readThreads-- > 0)
-        readThreads_.emplace_back(&Database::threadEntry, this);
+    for (std::size_t i = 0; i < readActive_; ++i)
+        readThreads_.emplace_back(&Database::threadEntry, this, i);
 }
 
 Database::~Database()
@@ -58,9 +74,10 @@ Database::~Database()
 }
 
 void
-Database::waitReads()
+Database::waitReads(FetchPriority priority)
 {
     std::unique_lock<std::mutex> lock(readLock_);
+    auto const& lane = readLanes_[static_cast<int>(priority)];
     // Wake in two generations.
     // Each generation is a full pass over the space.
     // If we're in generation N and you issue a request,
@@ -70,8 +87,8 @@ Database::waitReads()
     // N+1 since the request was in the table before that pass
     // even started. So when you reach generation N+2,
     // you know the request is done.
-    std::uint64_t const wakeGen = readGen_ + 2;
-    while (!readShut_ && !read_.empty() && (readGen_ < wakeGen))
+    std::uint64_t const wakeGen = lane.gen + 2;
+    while (!readShut_ && !lane.read.empty() && (lane.gen < wakeGen))
         readGenCondVar_.wait(lock);
 }
 
@@ -89,6 +106,51 @@ Database::onChildrenStopped()
     stopped();
 }
 
+bool
+Database::startAccessTrace(std::uint32_t sampleRate)
+{
+    if (accessTracePath_.empty())
+        return false;
+
+    stopAccessTrace();
+    auto trace = std::make_shared<AccessTrace>(accessTracePath_, sampleRate);
+    std::lock_guard lock(accessTraceMutex_);
+    accessTrace_ = std::move(trace);
+    accessTraceRate_ = accessTrace_->sampleRate();
+    JLOG(j_.info()) << "Tracing one object in " << accessTrace_->sampleRate()
+                    << " to " << accessTracePath_;
+    return true;
+}
+
+void
+Database::stopAccessTrace()
+{
+    std::shared_ptr<AccessTrace> trace;
+    {
+        std::lock_guard lock(accessTraceMutex_);
+        accessTraceRate_ = 0;
+        std::swap(trace, accessTrace_);
+    }
+    if (trace)
+        JLOG(j_.info()) << "Traced " << trace->size() << " accesses";
+}
+
+Json::Value
+Database::getAccessTraceJson() const
+{
+    Json::Value ret(Json::objectValue);
+    std::lock_guard lock(accessTraceMutex_);
+    ret[jss::enabled] = accessTrace_ != nullptr;
+    if (!accessTracePath_.empty())
+        ret[jss::path] = accessTracePath_.string();
+    if (accessTrace_)
+    {
+        ret[jss::sample_rate] = accessTrace_->sampleRate();
+        ret[jss::count] = std::to_string(accessTrace_->size());
+    }
+    return ret;
+}
+
 void
 Database::stopReadThreads()
 {
@@ -100,6 +162,7 @@ Database::stopReadThreads()
         readShut_ = true;
         readCondVar_.notify_all();
         readGenCondVar_.notify_all();
+        readParkCondVar_.notify_all();
     }
 
     for (auto& e : readThreads_)
@@ -107,14 +170,90 @@ Database::stopReadThreads()
 }
 
 void
-Database::asyncFetch(uint256 const& hash, std::uint32_t ledgerSeq)
+Database::asyncFetch(
+    uint256 const& hash,
+    std::uint32_t ledgerSeq,
+    FetchPriority priority,
+    ReadCallback callback)
 {
+    auto& high = readLanes_[static_cast<int>(FetchPriority::high)];
+    auto& low = readLanes_[static_cast<int>(FetchPriority::low)];
+
     // Post a read
     std::lock_guard lock(readLock_);
-    if (read_.emplace(hash, ledgerSeq).second)
+    auto* lane = &low;
+    if (priority == FetchPriority::high)
+    {
+        // A read wanted urgently is no longer left behind the others
+        lane = &high;
+        auto const it = low.read.find(hash);
+        if (it != low.read.end())
+        {
+            high.read.emplace(hash, std::move(it->second));
+            low.read.erase(it);
+        }
+    }
+    else if (high.read.count(hash) != 0)
+    {
+        lane = &high;
+    }
+
+    auto const [it, inserted] =
+        lane->read.emplace(hash, PendingRead{ledgerSeq, {}});
+    if (callback)
+        it->second.callbacks.push_back(std::move(callback));
+    if (inserted)
         readCondVar_.notify_one();
 }
 
+void
+Database::fetchBatchAsync(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq,
+    FetchPriority priority,
+    std::function<void(std::vector<std::shared_ptr<NodeObject>>)> callback)
+{
+    struct State
+    {
+        std::vector<std::shared_ptr<NodeObject>> objects;
+        std::atomic<std::size_t> remaining;
+        std::function<void(std::vector<std::shared_ptr<NodeObject>>)>
+            callback;
+    };
+
+    // One count is held until every read is posted, so that reads which
+    // finish quickly can't call back with the others still to come.
+    auto state = std::make_shared<State>();
+    state->objects.resize(hashes.size());
+    state->remaining = hashes.size() + 1;
+    state->callback = std::move(callback);
+    auto const done = [](State& s) {
+        if (--s.remaining == 0)
+            s.callback(std::move(s.objects));
+    };
+
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        if (asyncFetch(hashes[i], ledgerSeq, state->objects[i], priority))
+        {
+            done(*state);
+            continue;
+        }
+
+        // The read has been posted. If a read thread already took it, this
+        // posts it again, and the second read finds the object cached.
+        asyncFetch(
+            hashes[i],
+            ledgerSeq,
+            priority,
+            [state, i, done](std::shared_ptr<NodeObject> nodeObject) {
+                state->objects[i] = std::move(nodeObject);
+                done(*state);
+            });
+    }
+    done(*state);
+}
+
 void
 Database::importInternal(Backend& dstBackend, Database& srcDB)
 {
@@ -161,7 +300,15 @@ Database::fetchNodeObject(
     FetchType fetchType)
 {
     FetchReport fetchReport(fetchType);
+    return fetchAndReport(hash, ledgerSeq, fetchReport);
+}
 
+std::shared_ptr<NodeObject>
+Database::fetchAndReport(
+    uint256 const& hash,
+    std::uint32_t ledgerSeq,
+    FetchReport& fetchReport)
+{
     using namespace std::chrono;
     auto const begin{steady_clock::now()};
 
@@ -175,17 +322,79 @@ Database::fetchNodeObject(
         ++fetchTotalCount_;
 
     fetchReport.elapsed =
-        duration_cast<milliseconds>(steady_clock::now() - begin);
+        duration_cast<microseconds>(steady_clock::now() - begin);
+    traceFetch(hash, ledgerSeq, nodeObject, fetchReport.elapsed);
     scheduler_.onFetch(fetchReport);
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq)
+{
+    FetchReport fetchReport(FetchType::synchronous);
+    return fetchBatchAndReport(hashes, ledgerSeq, fetchReport);
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatchAndReport(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq,
+    FetchReport& fetchReport)
+{
+    using namespace std::chrono;
+    auto const begin{steady_clock::now()};
+
+    auto results{fetchBatch(hashes, ledgerSeq, fetchReport)};
+    for (auto const& nodeObject : results)
+    {
+        if (nodeObject)
+        {
+            ++fetchHitCount_;
+            fetchSz_ += nodeObject->getData().size();
+        }
+    }
+    fetchTotalCount_ += fetchReport.diskCount;
+
+    fetchReport.elapsed =
+        duration_cast<microseconds>(steady_clock::now() - begin);
+    for (std::size_t i = 0; i < results.size(); ++i)
+        traceFetch(hashes[i], ledgerSeq, results[i], fetchReport.elapsed);
+    scheduler_.onFetch(fetchReport);
+    return results;
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq,
+    FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+    for (auto const& hash : hashes)
+    {
+        FetchReport report(fetchReport.fetchType);
+        results.push_back(fetchNodeObject(hash, ledgerSeq, report));
+        if (report.wentToDisk)
+        {
+            fetchReport.wentToDisk = true;
+            ++fetchReport.diskCount;
+        }
+        if (report.wasFound)
+            fetchReport.wasFound = true;
+    }
+    return results;
+}
+
 bool
 Database::storeLedger(
     Ledger const& srcLedger,
     std::shared_ptr<Backend> dstBackend,
     std::shared_ptr<TaggedCache<uint256, NodeObject>> dstPCache,
-    std::shared_ptr<KeyCache<uint256>> dstNCache)
+    std::shared_ptr<KeyCache<uint256>> dstNCache,
+    std::function<void(NodeObject const&)> const& onStore)
 {
     auto fail = [&](std::string const& msg) {
         JLOG(j_.error()) << "Source ledger sequence " << srcLedger.info().seq
@@ -213,6 +422,8 @@ Database::storeLedger(
             dstPCache->canonicalize_replace_cache(
                 nodeObject->getHash(), nodeObject);
             dstNCache->erase(nodeObject->getHash());
+            if (onStore)
+                onStore(*nodeObject);
             sz += nodeObject->getData().size();
         }
 
@@ -288,43 +499,187 @@ Database::storeLedger(
     return true;
 }
 
+std::pair<uint256, Database::PendingRead>
+Database::nextRead()
+{
+    auto& high = readLanes_[static_cast<int>(FetchPriority::high)];
+    auto& low = readLanes_[static_cast<int>(FetchPriority::low)];
+
+    // Low priority reads get an occasional turn so they are never starved
+    auto* lane = &high;
+    if (high.read.empty() ||
+        (!low.read.empty() && ++readHighRun_ > readHighBurst))
+    {
+        lane = &low;
+        readHighRun_ = 0;
+    }
+
+    // Read in key order to make the back end more efficient
+    auto it = lane->read.lower_bound(lane->lastHash);
+    if (it == lane->read.end())
+    {
+        it = lane->read.begin();
+        // A generation has completed
+        ++lane->gen;
+        readGenCondVar_.notify_all();
+    }
+    auto result = std::move(*it);
+    lane->read.erase(it);
+    lane->lastHash = result.first;
+    return result;
+}
+
+void
+Database::resizeReads()
+{
+    using namespace std::chrono;
+
+    auto const now = steady_clock::now();
+    if (now - readResized_ < readResizeInterval || readLatencyFloor_ == 0us)
+        return;
+
+    auto const pending = readLanes_[0].read.size() + readLanes_[1].read.size();
+    if (readActive_ < readThreadsMax_ &&
+        pending > readActive_ * readQueuePerThread &&
+        readLatency_ <= 2 * readLatencyFloor_)
+    {
+        // The queue is growing while the backend answers about as quickly
+        // as it does when lightly loaded, so it can take more at once.
+        ++readActive_;
+        readResized_ = now;
+        if (readThreads_.size() < readActive_)
+        {
+            readThreads_.emplace_back(
+                &Database::threadEntry, this, readThreads_.size());
+        }
+        else
+        {
+            readParkCondVar_.notify_all();
+        }
+        JLOG(j_.debug()) << "async read threads increased to " << readActive_
+                         << ", " << pending << " reads pending";
+    }
+    else if (readActive_ > 1 && readLatency_ > 4 * readLatencyFloor_)
+    {
+        // The backend is saturated. More concurrent reads would only wait
+        // inside it, and in the meantime delay the synchronous reads.
+        --readActive_;
+        readResized_ = now;
+        JLOG(j_.debug()) << "async read threads reduced to " << readActive_
+                         << ", read latency " << readLatency_.count() << "us";
+    }
+}
+
 // Entry point for async read threads
 void
-Database::threadEntry()
+Database::threadEntry(std::size_t index)
 {
-    beast::setCurrentThreadName("prefetch");
+    using namespace std::chrono;
+
+    beast::setCurrentThreadName("prefetch " + std::to_string(index));
+    setCurrentThreadAffinity(readAffinity_);
+    boost::optional<microseconds> latency;
     while (true)
     {
-        uint256 lastHash;
-        std::uint32_t lastSeq;
+        std::vector<std::pair<uint256, PendingRead>> next;
         {
             std::unique_lock<std::mutex> lock(readLock_);
-            while (!readShut_ && read_.empty())
+            if (latency)
+            {
+                readLatency_ = readLatency_ == 0us
+                    ? *latency
+                    : (15 * readLatency_ + *latency) / 16;
+
+                // Let the floor drift up slowly, so that it follows the
+                // backend if it becomes slower for good.
+                readLatencyFloor_ = readLatencyFloor_ == 0us
+                    ? readLatency_
+                    : std::min(
+                          readLatency_,
+                          readLatencyFloor_ + readLatencyFloor_ / 1024 + 1us);
+            }
+
+            auto const empty = [this] {
+                return readLanes_[0].read.empty() &&
+                    readLanes_[1].read.empty();
+            };
+            while (!readShut_ && (index >= readActive_ || empty()))
             {
+                if (index >= readActive_)
+                {
+                    // Pass on any wakeup meant for a serving thread
+                    readCondVar_.notify_one();
+                    readParkCondVar_.wait(lock);
+                    continue;
+                }
+
                 // All work is done
                 readGenCondVar_.notify_all();
-                readCondVar_.wait(lock);
+
+                // The last serving thread stops after being idle for a
+                // while, leaving fewer threads to start the next burst.
+                if (readCondVar_.wait_for(lock, readIdleTimeout) ==
+                        std::cv_status::timeout &&
+                    empty() && index + 1 == readActive_ && readActive_ > 1)
+                {
+                    --readActive_;
+                }
             }
             if (readShut_)
                 break;
 
-            // Read in key order to make the back end more efficient
-            auto it = read_.lower_bound(readLastHash_);
-            if (it == read_.end())
+            next.clear();
+            do
             {
-                it = read_.begin();
-                // A generation has completed
-                ++readGen_;
-                readGenCondVar_.notify_all();
-            }
-            lastHash = it->first;
-            lastSeq = it->second;
-            read_.erase(it);
-            readLastHash_ = lastHash;
+                next.push_back(nextRead());
+            } while (next.size() < readBatch_ && !empty());
+            resizeReads();
         }
 
-        // Perform the read
-        fetchNodeObject(lastHash, lastSeq, FetchType::async);
+        // Perform the reads
+        auto const begin = steady_clock::now();
+        bool wentToDisk = false;
+        if (next.size() == 1)
+        {
+            FetchReport fetchReport(FetchType::async);
+            auto nodeObject = fetchAndReport(
+                next[0].first, next[0].second.ledgerSeq, fetchReport);
+            wentToDisk = fetchReport.wentToDisk;
+            for (auto const& callback : next[0].second.callbacks)
+                callback(nodeObject);
+        }
+        else
+        {
+            // The shard store finds objects by ledger, so fetch the reads
+            // of each ledger together.
+            std::stable_sort(
+                next.begin(), next.end(), [](auto const& a, auto const& b) {
+                    return a.second.ledgerSeq < b.second.ledgerSeq;
+                });
+            std::vector<uint256> hashes;
+            for (auto it = next.begin(); it != next.end();)
+            {
+                auto const first = it;
+                auto const ledgerSeq = it->second.ledgerSeq;
+                hashes.clear();
+                for (; it != next.end() && it->second.ledgerSeq == ledgerSeq;
+                     ++it)
+                    hashes.push_back(it->first);
+
+                FetchReport fetchReport(FetchType::async);
+                auto const nodeObjects =
+                    fetchBatchAndReport(hashes, ledgerSeq, fetchReport);
+                wentToDisk = wentToDisk || fetchReport.wentToDisk;
+                for (std::size_t i = 0; i < nodeObjects.size(); ++i)
+                {
+                    for (auto const& callback : first[i].second.callbacks)
+                        callback(nodeObjects[i]);
+                }
+            }
+        }
+        latency.reset();
+        if (wentToDisk)
+            latency = duration_cast<microseconds>(steady_clock::now() - begin);
     }
 }
 
@@ -29,20 +29,27 @@ DatabaseNodeImp::store(
     NodeObjectType type,
     Blob&& data,
     uint256 const& hash,
-    std::uint32_t)
+    std::uint32_t ledgerSeq)
 {
     auto nObj = NodeObject::createObject(type, std::move(data), hash);
     pCache_->canonicalize_replace_cache(hash, nObj);
+    auto const begin = std::chrono::steady_clock::now();
     backend_->store(nObj);
     nCache_->erase(hash);
     storeStats(1, nObj->getData().size());
+    traceStore(
+        *nObj,
+        ledgerSeq,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin));
 }
 
 bool
 DatabaseNodeImp::asyncFetch(
     uint256 const& hash,
     std::uint32_t ledgerSeq,
-    std::shared_ptr<NodeObject>& nodeObject)
+    std::shared_ptr<NodeObject>& nodeObject,
+    FetchPriority priority)
 {
     // See if the object is in cache
     nodeObject = pCache_->fetch(hash);
@@ -50,7 +57,7 @@ DatabaseNodeImp::asyncFetch(
         return true;
 
     // Otherwise post a read
-    Database::asyncFetch(hash, ledgerSeq);
+    Database::asyncFetch(hash, ledgerSeq, priority);
     return false;
 }
 
@@ -134,5 +141,75 @@ DatabaseNodeImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseNodeImp::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t,
+    FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+
+    // Collect the objects which are in neither cache
+    std::vector<uint256 const*> cacheMisses;
+    std::vector<std::size_t> indexes;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        results[i] = pCache_->fetch(hashes[i]);
+        if (!results[i] && !nCache_->touch_if_exists(hashes[i]))
+        {
+            cacheMisses.push_back(&hashes[i]);
+            indexes.push_back(i);
+        }
+    }
+
+    if (cacheMisses.empty())
+        return results;
+
+    // Try the backend
+    fetchReport.wentToDisk = true;
+    fetchReport.diskCount += cacheMisses.size();
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status> fetched;
+    try
+    {
+        fetched = backend_->fetchBatch(cacheMisses);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "Exception, " << e.what();
+        Rethrow();
+    }
+
+    auto& [nodeObjects, status] = fetched;
+    if (status != ok)
+        JLOG(j_.warn()) << "Batch fetch status=" << status;
+    assert(nodeObjects.size() == cacheMisses.size());
+
+    for (std::size_t i = 0; i < cacheMisses.size(); ++i)
+    {
+        auto const& hash = *cacheMisses[i];
+        auto& nodeObject = nodeObjects[i];
+        if (!nodeObject)
+        {
+            // Just in case a write occurred
+            nodeObject = pCache_->fetch(hash);
+            if (!nodeObject)
+                // We give up
+                nCache_->insert(hash);
+        }
+        else
+        {
+            fetchReport.wasFound = true;
+
+            // Ensure all threads get the same object
+            pCache_->canonicalize_replace_client(hash, nodeObject);
+        }
+
+        results[indexes[i]] = std::move(nodeObject);
+    }
+
+    return results;
+}
+
 }  // namespace NodeStore
 }  // namespace ripple
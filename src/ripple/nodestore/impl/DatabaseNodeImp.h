@@ -92,7 +92,8 @@ public:
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
-        std::shared_ptr<NodeObject>& nodeObject) override;
+        std::shared_ptr<NodeObject>& nodeObject,
+        FetchPriority priority) override;
 
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override
@@ -117,6 +118,12 @@ public:
     void
     tune(int size, std::chrono::seconds age) override;
 
+    TaggedCache<uint256, NodeObject>*
+    getObjectCache() override
+    {
+        return pCache_.get();
+    }
+
     void
     sweep() override;
 
@@ -136,6 +143,12 @@ private:
         std::uint32_t,
         FetchReport& fetchReport) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(
+        std::vector<uint256> const& hashes,
+        std::uint32_t,
+        FetchReport& fetchReport) override;
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
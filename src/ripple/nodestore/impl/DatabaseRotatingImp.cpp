@@ -32,7 +32,8 @@ DatabaseRotatingImp::DatabaseRotatingImp(
     std::shared_ptr<Backend> writableBackend,
     std::shared_ptr<Backend> archiveBackend,
     Section const& config,
-    beast::Journal j)
+    beast::Journal j,
+    std::shared_ptr<Backend> coldBackend)
     : DatabaseRotating(name, parent, scheduler, readThreads, config, j)
     , pCache_(std::make_shared<TaggedCache<uint256, NodeObject>>(
           name,
@@ -47,11 +48,19 @@ DatabaseRotatingImp::DatabaseRotatingImp(
           cacheTargetAge))
     , writableBackend_(std::move(writableBackend))
     , archiveBackend_(std::move(archiveBackend))
+    , coldBackend_(std::move(coldBackend))
+    , filterBytes_([&config] {
+        std::size_t mb = 0;
+        get_if_exists(config, "lookup_filter_mb", mb);
+        return mb * 1024 * 1024;
+    }())
 {
     if (writableBackend_)
         fdRequired_ += writableBackend_->fdRequired();
     if (archiveBackend_)
         fdRequired_ += archiveBackend_->fdRequired();
+    if (coldBackend_)
+        fdRequired_ += coldBackend_->fdRequired();
     setParent(parent);
 }
 
@@ -60,12 +69,72 @@ DatabaseRotatingImp::rotateWithLock(
     std::function<std::unique_ptr<NodeStore::Backend>(
         std::string const& writableBackendName)> const& f)
 {
+    if (coldBackend_)
+    {
+        // Only the caller rotates, so the archive can't change while it is
+        // copied. Nothing else writes to it, and readers are not held up.
+        auto const archive = [&] {
+            std::lock_guard lock(mutex_);
+            return archiveBackend_;
+        }();
+        copyToCold(*archive);
+    }
+
     std::lock_guard lock(mutex_);
 
     auto newBackend = f(writableBackend_->getName());
     archiveBackend_->setDeletePath();
     archiveBackend_ = std::move(writableBackend_);
     writableBackend_ = std::move(newBackend);
+
+    // The new backend starts out empty, so its filter is complete
+    archiveFilter_ = std::move(writableFilter_);
+    if (filterBytes_ != 0)
+        writableFilter_ = std::make_shared<KeyFilter>(filterBytes_);
+    if (archiveFilter_)
+    {
+        JLOG(j_.debug()) << "Archive filter holds " << archiveFilter_->size()
+                         << " keys in " << archiveFilter_->bytes()
+                         << " bytes";
+    }
+}
+
+auto
+DatabaseRotatingImp::backends() const -> Backends
+{
+    std::lock_guard lock(mutex_);
+    return {writableBackend_, archiveBackend_, writableFilter_, archiveFilter_};
+}
+
+void
+DatabaseRotatingImp::copyToCold(Backend& archive)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    std::uint64_t count = 0;
+    Batch batch;
+    batch.reserve(batchWritePreallocationSize);
+    archive.for_each([&](std::shared_ptr<NodeObject> nodeObject) {
+        batch.emplace_back(std::move(nodeObject));
+        if (batch.size() >= batchWritePreallocationSize)
+        {
+            coldBackend_->storeBatch(batch);
+            count += batch.size();
+            batch.clear();
+        }
+    });
+    if (!batch.empty())
+    {
+        coldBackend_->storeBatch(batch);
+        count += batch.size();
+    }
+
+    JLOG(j_.info()) << "Copied " << count << " nodes from "
+                    << archive.getName() << " to " << coldBackend_->getName()
+                    << " in "
+                    << std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::steady_clock::now() - begin)
+                           .count()
+                    << " seconds";
 }
 
 std::string
@@ -87,6 +156,8 @@ DatabaseRotatingImp::import(Database& source)
 {
     auto const backend = [&] {
         std::lock_guard lock(mutex_);
+        // Imported objects bypass the filter
+        writableFilter_.reset();
         return writableBackend_;
     }();
 
@@ -96,12 +167,22 @@ DatabaseRotatingImp::import(Database& source)
 bool
 DatabaseRotatingImp::storeLedger(std::shared_ptr<Ledger const> const& srcLedger)
 {
-    auto const backend = [&] {
+    auto const [backend, filter] = [&] {
         std::lock_guard lock(mutex_);
-        return writableBackend_;
+        return std::make_pair(writableBackend_, writableFilter_);
     }();
 
-    return Database::storeLedger(*srcLedger, backend, pCache_, nCache_);
+    if (!filter)
+        return Database::storeLedger(*srcLedger, backend, pCache_, nCache_);
+
+    return Database::storeLedger(
+        *srcLedger,
+        backend,
+        pCache_,
+        nCache_,
+        [&filter = filter](NodeObject const& nodeObject) {
+            filter->insert(nodeObject.getHash());
+        });
 }
 
 void
@@ -109,26 +190,38 @@ DatabaseRotatingImp::store(
     NodeObjectType type,
     Blob&& data,
     uint256 const& hash,
-    std::uint32_t)
+    std::uint32_t ledgerSeq)
 {
     auto nObj = NodeObject::createObject(type, std::move(data), hash);
     pCache_->canonicalize_replace_cache(hash, nObj);
 
-    auto const backend = [&] {
+    auto const [backend, filter] = [&] {
         std::lock_guard lock(mutex_);
-        return writableBackend_;
+        return std::make_pair(writableBackend_, writableFilter_);
     }();
+
+    // Add the key before writing, so that a reader who has been told the key
+    // is absent will find the object in the positive cache instead
+    if (filter)
+        filter->insert(hash);
+    auto const begin = std::chrono::steady_clock::now();
     backend->store(nObj);
 
     nCache_->erase(hash);
     storeStats(1, nObj->getData().size());
+    traceStore(
+        *nObj,
+        ledgerSeq,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin));
 }
 
 bool
 DatabaseRotatingImp::asyncFetch(
     uint256 const& hash,
     std::uint32_t ledgerSeq,
-    std::shared_ptr<NodeObject>& nodeObject)
+    std::shared_ptr<NodeObject>& nodeObject,
+    FetchPriority priority)
 {
     // See if the object is in cache
     nodeObject = pCache_->fetch(hash);
@@ -136,7 +229,7 @@ DatabaseRotatingImp::asyncFetch(
         return true;
 
     // Otherwise post a read
-    Database::asyncFetch(hash, ledgerSeq);
+    Database::asyncFetch(hash, ledgerSeq, priority);
     return false;
 }
 
@@ -199,29 +292,40 @@ DatabaseRotatingImp::fetchNodeObject(
     auto nodeObject{pCache_->fetch(hash)};
     if (!nodeObject && !nCache_->touch_if_exists(hash))
     {
-        auto [writable, archive] = [&] {
-            std::lock_guard lock(mutex_);
-            return std::make_pair(writableBackend_, archiveBackend_);
-        }();
+        auto b = backends();
 
         fetchReport.wentToDisk = true;
 
         // Try to fetch from the writable backend
-        nodeObject = fetch(writable);
-        if (!nodeObject)
+        if (mayContain(b.writableFilter, hash))
+            nodeObject = fetch(b.writable);
+        if (!nodeObject && mayContain(b.archiveFilter, hash))
         {
             // Otherwise try to fetch from the archive backend
-            nodeObject = fetch(archive);
+            nodeObject = fetch(b.archive);
             if (nodeObject)
             {
-                {
-                    // Refresh the writable backend pointer
-                    std::lock_guard lock(mutex_);
-                    writable = writableBackend_;
-                }
+                // Refresh the writable backend pointer
+                b = backends();
 
                 // Update writable backend with data from the archive backend
-                writable->store(nodeObject);
+                if (b.writableFilter)
+                    b.writableFilter->insert(hash);
+                b.writable->store(nodeObject);
+                nCache_->erase(hash);
+            }
+        }
+        if (!nodeObject && coldBackend_)
+        {
+            // Last try the cold backend, bringing what is found back to
+            // the writable backend so the next read is fast
+            nodeObject = fetch(coldBackend_);
+            if (nodeObject)
+            {
+                b = backends();
+                if (b.writableFilter)
+                    b.writableFilter->insert(hash);
+                b.writable->store(nodeObject);
                 nCache_->erase(hash);
             }
         }
@@ -249,6 +353,167 @@ DatabaseRotatingImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t,
+    FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+
+    // Collect the objects which are in neither cache
+    std::vector<uint256 const*> cacheMisses;
+    std::vector<std::size_t> indexes;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        results[i] = pCache_->fetch(hashes[i]);
+        if (!results[i] && !nCache_->touch_if_exists(hashes[i]))
+        {
+            cacheMisses.push_back(&hashes[i]);
+            indexes.push_back(i);
+        }
+    }
+
+    if (cacheMisses.empty())
+        return results;
+
+    auto fetch = [&](std::shared_ptr<Backend> const& backend,
+                     std::vector<uint256 const*> const& keys) {
+        std::pair<std::vector<std::shared_ptr<NodeObject>>, Status> fetched;
+        try
+        {
+            fetched = backend->fetchBatch(keys);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.fatal()) << "Exception, " << e.what();
+            Rethrow();
+        }
+
+        if (fetched.second != ok)
+            JLOG(j_.warn()) << "Batch fetch status=" << fetched.second;
+        assert(fetched.first.size() == keys.size());
+        return std::move(fetched.first);
+    };
+
+    auto b = backends();
+
+    fetchReport.wentToDisk = true;
+    fetchReport.diskCount += cacheMisses.size();
+
+    // Try to fetch from the writable backend the keys it may hold
+    std::vector<std::shared_ptr<NodeObject>> nodeObjects(cacheMisses.size());
+    {
+        std::vector<uint256 const*> keys;
+        std::vector<std::size_t> keyIndexes;
+        for (std::size_t i = 0; i < cacheMisses.size(); ++i)
+        {
+            if (mayContain(b.writableFilter, *cacheMisses[i]))
+            {
+                keys.push_back(cacheMisses[i]);
+                keyIndexes.push_back(i);
+            }
+        }
+
+        if (!keys.empty())
+        {
+            auto fetched = fetch(b.writable, keys);
+            for (std::size_t i = 0; i < fetched.size(); ++i)
+                nodeObjects[keyIndexes[i]] = std::move(fetched[i]);
+        }
+    }
+
+    // Otherwise try to fetch from the archive backend
+    std::vector<uint256 const*> archiveKeys;
+    std::vector<std::size_t> archiveIndexes;
+    for (std::size_t i = 0; i < nodeObjects.size(); ++i)
+    {
+        if (!nodeObjects[i] && mayContain(b.archiveFilter, *cacheMisses[i]))
+        {
+            archiveKeys.push_back(cacheMisses[i]);
+            archiveIndexes.push_back(i);
+        }
+    }
+
+    if (!archiveKeys.empty())
+    {
+        auto archived = fetch(b.archive, archiveKeys);
+
+        // Refresh the writable backend pointer
+        b = backends();
+
+        for (std::size_t i = 0; i < archived.size(); ++i)
+        {
+            if (archived[i])
+            {
+                // Update writable backend with data from the archive backend
+                if (b.writableFilter)
+                    b.writableFilter->insert(*archiveKeys[i]);
+                b.writable->store(archived[i]);
+                nCache_->erase(*archiveKeys[i]);
+                nodeObjects[archiveIndexes[i]] = std::move(archived[i]);
+            }
+        }
+    }
+
+    // Last try the cold backend for whatever is still missing
+    if (coldBackend_)
+    {
+        std::vector<uint256 const*> coldKeys;
+        std::vector<std::size_t> coldIndexes;
+        for (std::size_t i = 0; i < nodeObjects.size(); ++i)
+        {
+            if (!nodeObjects[i])
+            {
+                coldKeys.push_back(cacheMisses[i]);
+                coldIndexes.push_back(i);
+            }
+        }
+
+        if (!coldKeys.empty())
+        {
+            auto cold = fetch(coldBackend_, coldKeys);
+            b = backends();
+            for (std::size_t i = 0; i < cold.size(); ++i)
+            {
+                if (cold[i])
+                {
+                    if (b.writableFilter)
+                        b.writableFilter->insert(*coldKeys[i]);
+                    b.writable->store(cold[i]);
+                    nCache_->erase(*coldKeys[i]);
+                    nodeObjects[coldIndexes[i]] = std::move(cold[i]);
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < cacheMisses.size(); ++i)
+    {
+        auto const& hash = *cacheMisses[i];
+        auto& nodeObject = nodeObjects[i];
+        if (!nodeObject)
+        {
+            // Just in case a write occurred
+            nodeObject = pCache_->fetch(hash);
+            if (!nodeObject)
+                // We give up
+                nCache_->insert(hash);
+        }
+        else
+        {
+            fetchReport.wasFound = true;
+
+            // Ensure all threads get the same object
+            pCache_->canonicalize_replace_client(hash, nodeObject);
+        }
+
+        results[indexes[i]] = std::move(nodeObject);
+    }
+
+    return results;
+}
+
 void
 DatabaseRotatingImp::for_each(
     std::function<void(std::shared_ptr<NodeObject>)> f)
@@ -263,6 +528,10 @@ DatabaseRotatingImp::for_each(
 
     // Iterate the archive backend
     archive->for_each(f);
+
+    // Iterate the cold backend, which may repeat objects seen above
+    if (coldBackend_)
+        coldBackend_->for_each(f);
 }
 
 }  // namespace NodeStore
@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_DATABASEROTATINGIMP_H_INCLUDED
 
 #include <ripple/nodestore/DatabaseRotating.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -41,7 +42,8 @@ public:
         std::shared_ptr<Backend> writableBackend,
         std::shared_ptr<Backend> archiveBackend,
         Section const& config,
-        beast::Journal j);
+        beast::Journal j,
+        std::shared_ptr<Backend> coldBackend = nullptr);
 
     ~DatabaseRotatingImp() override
     {
@@ -71,7 +73,8 @@ public:
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
-        std::shared_ptr<NodeObject>& nodeObject) override;
+        std::shared_ptr<NodeObject>& nodeObject,
+        FetchPriority priority) override;
 
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override;
@@ -93,6 +96,12 @@ public:
     void
     tune(int size, std::chrono::seconds age) override;
 
+    TaggedCache<uint256, NodeObject>*
+    getObjectCache() override
+    {
+        return pCache_.get();
+    }
+
     void
     sweep() override;
 
@@ -111,14 +120,58 @@ private:
 
     std::shared_ptr<Backend> writableBackend_;
     std::shared_ptr<Backend> archiveBackend_;
+
+    // Optional slower backend which keeps what each rotation would delete.
+    // It is searched last, and never rotated.
+    std::shared_ptr<Backend> const coldBackend_;
+
+    // Size in bytes of the filter kept for each backend, or zero if the
+    // backends are not filtered
+    std::size_t const filterBytes_;
+
+    // The keys stored in each backend. A backend only has a filter if it
+    // was created by a rotation, so that every key written to it passed
+    // through this object; otherwise it must always be searched.
+    std::shared_ptr<KeyFilter> writableFilter_;
+    std::shared_ptr<KeyFilter> archiveFilter_;
+
     mutable std::mutex mutex_;
 
+    // The backends and their filters, as of the moment of the call
+    struct Backends
+    {
+        std::shared_ptr<Backend> writable;
+        std::shared_ptr<Backend> archive;
+        std::shared_ptr<KeyFilter> writableFilter;
+        std::shared_ptr<KeyFilter> archiveFilter;
+    };
+
+    Backends
+    backends() const;
+
+    // Copy everything in the archive backend to the cold backend
+    void
+    copyToCold(Backend& archive);
+
+    // Whether a backend with the given filter may hold `hash`
+    static bool
+    mayContain(std::shared_ptr<KeyFilter> const& filter, uint256 const& hash)
+    {
+        return !filter || filter->mayContain(hash);
+    }
+
     std::shared_ptr<NodeObject>
     fetchNodeObject(
         uint256 const& hash,
         std::uint32_t,
         FetchReport& fetchReport) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(
+        std::vector<uint256> const& hashes,
+        std::uint32_t,
+        FetchReport& fetchReport) override;
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
 };
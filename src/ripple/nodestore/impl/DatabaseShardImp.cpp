@@ -23,8 +23,10 @@
 #include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/random.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/DatabaseShardImp.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/predicates.h>
@@ -32,6 +34,8 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <thread>
+
 #if BOOST_OS_LINUX
 #include <sys/statvfs.h>
 #endif
@@ -60,6 +64,13 @@ DatabaseShardImp::DatabaseShardImp(
     , avgShardFileSz_(ledgersPerShard_ * kilobytes(192ull))
     , openFinalLimit_(
           app.config().getValueFor(SizedItem::openFinalLimit, boost::none))
+    , finalCache_(std::make_unique<PCache>(
+          name,
+          app.config().getValueFor(SizedItem::nodeCacheSize, boost::none),
+          std::chrono::seconds{
+              app.config().getValueFor(SizedItem::nodeCacheAge, boost::none)},
+          stopwatch(),
+          j))
 {
 }
 
@@ -117,6 +128,36 @@ DatabaseShardImp::init()
             ctx_ = std::make_unique<nudb::context>();
             ctx_->start();
 
+            if (!basePath_.empty())
+            {
+                if (exists(basePath_) && !is_directory(basePath_))
+                {
+                    JLOG(j_.error()) << basePath_ << " must be a directory";
+                    return false;
+                }
+
+                auto const factory{Manager::instance().find(backendName_)};
+                if (!factory)
+                {
+                    JLOG(j_.error())
+                        << "failed to find factory for " << backendName_;
+                    return false;
+                }
+
+                Section section{
+                    app_.config().section(ConfigSection::shardDatabase())};
+                section.set("path", basePath_.string());
+                base_ = factory->createInstance(
+                    NodeObject::keyBytes,
+                    section,
+                    megabytes(app_.config().getValueFor(
+                        SizedItem::burstSize, boost::none)),
+                    scheduler_,
+                    *ctx_,
+                    j_);
+                base_->open(true);
+            }
+
             // Find shards
             std::uint32_t openFinals{0};
             for (auto const& path : paths)
@@ -161,7 +202,7 @@ DatabaseShardImp::init()
 
                     auto shard{std::make_shared<Shard>(
                         app_, *this, shardIndex, shardDir.parent_path(), j_)};
-                    if (!shard->init(scheduler_, *ctx_))
+                    if (!shard->init(scheduler_, *ctx_, base_))
                     {
                         // Remove corrupted or legacy shard
                         shard->removeOnDestroy();
@@ -280,7 +321,7 @@ DatabaseShardImp::prepareLedger(std::uint32_t validLedgerSeq)
             j_);
     }();
 
-    if (!shard->init(scheduler_, *ctx_))
+    if (!shard->init(scheduler_, *ctx_, base_))
         return boost::none;
 
     auto const ledgerSeq{shard->prepare()};
@@ -510,17 +551,32 @@ DatabaseShardImp::importShard(
     auto shard{std::make_unique<Shard>(
         app_, *this, shardIndex, dstDir.parent_path(), j_)};
 
-    if (!shard->init(scheduler_, *ctx_) || shard->getState() != Shard::complete)
+    // A shard which is not yet complete may be imported when no other is
+    // being acquired. Its ledgers are usable at once, and the rest are
+    // acquired from the network.
+    if (!shard->init(scheduler_, *ctx_, base_) ||
+        (shard->getState() != Shard::complete &&
+         shard->getState() != Shard::acquire))
     {
         shard.reset();
         renameDir(dstDir, srcDir);
         return fail("failed to import", std::lock_guard(mutex_));
     }
+    auto const state{shard->getState()};
 
     auto const [it, inserted] = [&]() {
         std::lock_guard lock(mutex_);
+        if (state == Shard::acquire && acquireIndex_ != 0)
+            return std::make_pair(shards_.end(), false);
+
         preparedIndexes_.erase(shardIndex);
-        return shards_.emplace(shardIndex, std::move(shard));
+        auto result = shards_.emplace(shardIndex, std::move(shard));
+        if (result.second && state == Shard::acquire)
+        {
+            acquireIndex_ = shardIndex;
+            updateStatus(lock);
+        }
+        return result;
     }();
 
     if (!inserted)
@@ -530,12 +586,160 @@ DatabaseShardImp::importShard(
         return fail("failed to import", std::lock_guard(mutex_));
     }
 
+    if (state == Shard::acquire)
+    {
+        JLOG(j_.info()) << "shard " << shardIndex
+                        << " imported incomplete, acquiring the rest";
+        setFileStats();
+        return true;
+    }
+
     finalizeShard(it->second, true, expectedHash);
     return true;
 }
 
+bool
+DatabaseShardImp::exportShard(
+    std::uint32_t shardIndex,
+    boost::filesystem::path const& dstDir)
+{
+    std::shared_ptr<Shard> shard;
+    {
+        std::lock_guard lock(mutex_);
+        assert(init_);
+
+        auto const it{shards_.find(shardIndex)};
+        if (it == shards_.end() || it->second->getState() != Shard::final)
+        {
+            JLOG(j_.error())
+                << "shard " << shardIndex << " is not a final shard";
+            return false;
+        }
+        shard = it->second;
+    }
+
+    try
+    {
+        if (boost::filesystem::exists(dstDir))
+        {
+            JLOG(j_.error()) << "shard " << shardIndex << " export directory "
+                             << dstDir << " already exists";
+            return false;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.error()) << "shard " << shardIndex
+                         << ". Exception caught in function " << __func__
+                         << ". Error: " << e.what();
+        return false;
+    }
+
+    taskQueue_->addTask(
+        [this, wptr = std::weak_ptr<Shard>(shard), shardIndex, dstDir]() {
+            if (isStopping())
+                return;
+
+            auto shard{wptr.lock()};
+            if (!shard)
+            {
+                JLOG(j_.debug()) << "Shard removed before being exported";
+                return;
+            }
+
+            if (shard->exportTo(dstDir, scheduler_, *ctx_))
+            {
+                JLOG(j_.info())
+                    << "shard " << shardIndex << " exported to " << dstDir;
+            }
+        });
+    return true;
+}
+
 std::shared_ptr<Ledger>
 DatabaseShardImp::fetchLedger(uint256 const& hash, std::uint32_t ledgerSeq)
+{
+    auto ledger{loadLedger(hash, ledgerSeq)};
+    if (ledger)
+        notePrefetch(ledgerSeq);
+    return ledger;
+}
+
+void
+DatabaseShardImp::forEachAccountShard(
+    AccountID const& account,
+    std::uint32_t minSeq,
+    std::uint32_t maxSeq,
+    bool forward,
+    std::function<bool(DatabaseCon&, std::uint32_t, std::uint32_t)> const&
+        callback)
+{
+    if (minSeq > maxSeq)
+        return;
+
+    auto const first{seqToShardIndex(std::max(minSeq, earliestLedgerSeq()))};
+    auto const last{seqToShardIndex(maxSeq)};
+    std::vector<std::shared_ptr<Shard>> shards;
+    {
+        std::lock_guard lock(mutex_);
+        assert(init_);
+
+        for (auto const& [shardIndex, shard] : shards_)
+        {
+            if (shardIndex >= first && shardIndex <= last &&
+                shard->getState() == Shard::final)
+            {
+                shards.push_back(shard);
+            }
+        }
+    }
+
+    std::sort(
+        shards.begin(),
+        shards.end(),
+        [forward](auto const& lhs, auto const& rhs) {
+            return forward ? lhs->index() < rhs->index()
+                           : lhs->index() > rhs->index();
+        });
+
+    for (auto const& shard : shards)
+    {
+        if (!shard->mayContainAccount(account))
+            continue;
+
+        auto const shardIndex{shard->index()};
+        bool more{true};
+        if (!shard->callForTransactionSQL([&](DatabaseCon& db) {
+                more = callback(
+                    db, firstLedgerSeq(shardIndex), lastLedgerSeq(shardIndex));
+            }))
+        {
+            JLOG(j_.warn())
+                << "shard " << shardIndex << " transactions unavailable";
+        }
+        if (!more)
+            return;
+    }
+}
+
+std::uint32_t
+DatabaseShardImp::firstContiguousSeq(std::uint32_t seq)
+{
+    std::lock_guard lock(mutex_);
+    assert(init_);
+
+    while (seq > earliestLedgerSeq())
+    {
+        auto const it{shards_.find(seqToShardIndex(seq - 1))};
+        if (it == shards_.end() || it->second->getState() != Shard::final)
+            break;
+        seq = firstLedgerSeq(it->first);
+    }
+    return seq;
+}
+
+std::shared_ptr<Ledger>
+DatabaseShardImp::loadLedger(uint256 const& hash, std::uint32_t ledgerSeq)
 {
     auto const shardIndex{seqToShardIndex(ledgerSeq)};
     {
@@ -574,7 +778,7 @@ DatabaseShardImp::fetchLedger(uint256 const& hash, std::uint32_t ledgerSeq)
     };
 
     auto ledger{std::make_shared<Ledger>(
-        deserializePrefixedHeader(makeSlice(nodeObject->getData())),
+        deserializePrefixedHeader(nodeObject->getData()),
         app_.config(),
         *app_.getShardFamily())};
 
@@ -707,6 +911,9 @@ DatabaseShardImp::onChildrenStopped()
         for (auto const& e : shards_)
             shards.push_back(e.second);
         shards_.clear();
+
+        // The base store is closed once the last shard using it is gone
+        base_.reset();
     }
 
     // All shards should be expired at this point
@@ -798,14 +1005,145 @@ DatabaseShardImp::import(Database& source)
 
         auto numHistShards = this->numHistoricalShards(lock);
 
-        // Import the shards
+        // Shards whose ledgers are being copied from the node store
+        struct Import
+        {
+            std::uint32_t shardIndex;
+            std::unique_ptr<Shard> shard;
+            boost::filesystem::path markerFile;
+            boost::optional<uint256> lastLedgerHash;
+        };
+        std::vector<Import> imports;
+
+        // Copy the ledgers of a shard from the node store
+        auto copyLedgers = [this](Import& import) {
+            auto& shard{import.shard};
+            std::shared_ptr<Ledger> recentStored;
+            while (auto const ledgerSeq = shard->prepare())
+            {
+                if (isStopping())
+                    return;
+
+                auto ledger{loadByIndex(*ledgerSeq, app_, false)};
+                if (!ledger || ledger->info().seq != ledgerSeq)
+                    return;
+
+                auto const result{shard->storeLedger(ledger, recentStored)};
+                storeStats(result.count, result.size);
+                if (result.error)
+                    return;
+
+                if (!shard->setLedgerStored(ledger))
+                    return;
+
+                if (!import.lastLedgerHash &&
+                    ledgerSeq == lastLedgerSeq(import.shardIndex))
+                {
+                    import.lastLedgerHash = ledger->info().hash;
+                }
+
+                recentStored = std::move(ledger);
+            }
+        };
+
+        // Copy the pending shards at once, then finalize those copied
+        auto importShards = [&]() {
+            {
+                std::vector<std::thread> threads;
+                for (std::size_t i = 1; i < imports.size(); ++i)
+                {
+                    threads.emplace_back(
+                        [&copyLedgers, &import = imports[i]]() {
+                            beast::setCurrentThreadName("ShardImport");
+                            copyLedgers(import);
+                        });
+                }
+                if (!imports.empty())
+                    copyLedgers(imports.front());
+                for (auto& thread : threads)
+                    thread.join();
+            }
+
+            for (auto& import : imports)
+            {
+                auto const shardIndex{import.shardIndex};
+                auto& shard{import.shard};
+
+                using namespace boost::filesystem;
+                bool success{false};
+                if (import.lastLedgerHash &&
+                    shard->getState() == Shard::complete)
+                {
+                    // Store shard final key
+                    Serializer s;
+                    s.add32(Shard::version);
+                    s.add32(firstLedgerSeq(shardIndex));
+                    s.add32(lastLedgerSeq(shardIndex));
+                    s.addBitString(*import.lastLedgerHash);
+                    auto const nodeObject{NodeObject::createObject(
+                        hotUNKNOWN, std::move(s.modData()), Shard::finalKey)};
+
+                    if (shard->storeNodeObject(nodeObject))
+                    {
+                        try
+                        {
+                            // The import process is complete and the
+                            // marker file is no longer required
+                            remove_all(import.markerFile);
+
+                            JLOG(j_.debug()) << "shard " << shardIndex
+                                             << " was successfully imported";
+                            finalizeShard(
+                                shards_.emplace(shardIndex, std::move(shard))
+                                    .first->second,
+                                true,
+                                boost::none);
+                            success = true;
+                        }
+                        catch (std::exception const& e)
+                        {
+                            JLOG(j_.fatal())
+                                << "shard index " << shardIndex
+                                << ". Exception caught in function "
+                                << __func__ << ". Error: " << e.what();
+                        }
+                    }
+                }
+
+                if (!success)
+                {
+                    JLOG(j_.error())
+                        << "shard " << shardIndex << " failed to import";
+                    shard->removeOnDestroy();
+
+                    // It was counted when its import began
+                    if (shardIndex < shardBoundaryIndex())
+                        --numHistShards;
+                }
+            }
+            imports.clear();
+        };
+
+        // Import the shards, several at once
         for (std::uint32_t shardIndex = earliestIndex;
-             shardIndex <= latestIndex;
+             shardIndex <= latestIndex && !isStopping();
              ++shardIndex)
         {
-            auto const pathDesignation =
+            auto pathDesignation =
                 prepareForNewShard(shardIndex, numHistShards, lock);
 
+            // Finish the pending imports first if there are enough of
+            // them or if there isn't room for them all and another
+            if (pathDesignation && !imports.empty() &&
+                (imports.size() >= importThreads_ ||
+                 !sufficientStorage(
+                     imports.size() + 1, *pathDesignation, lock)))
+            {
+                importShards();
+                pathDesignation =
+                    prepareForNewShard(shardIndex, numHistShards, lock);
+            }
+
             if (!pathDesignation)
                 break;
 
@@ -868,7 +1206,7 @@ DatabaseShardImp::import(Database& source)
             // Create the new shard
             auto shard{
                 std::make_unique<Shard>(app_, *this, shardIndex, path, j_)};
-            if (!shard->init(scheduler_, *ctx_))
+            if (!shard->init(scheduler_, *ctx_, base_))
                 continue;
 
             // Create a marker file to signify an import in progress
@@ -886,80 +1224,16 @@ DatabaseShardImp::import(Database& source)
                 ofs.close();
             }
 
-            // Copy the ledgers from node store
-            std::shared_ptr<Ledger> recentStored;
-            boost::optional<uint256> lastLedgerHash;
-
-            while (auto const ledgerSeq = shard->prepare())
-            {
-                auto ledger{loadByIndex(*ledgerSeq, app_, false)};
-                if (!ledger || ledger->info().seq != ledgerSeq)
-                    break;
-
-                auto const result{shard->storeLedger(ledger, recentStored)};
-                storeStats(result.count, result.size);
-                if (result.error)
-                    break;
-
-                if (!shard->setLedgerStored(ledger))
-                    break;
-
-                if (!lastLedgerHash && ledgerSeq == lastLedgerSeq(shardIndex))
-                    lastLedgerHash = ledger->info().hash;
-
-                recentStored = std::move(ledger);
-            }
-
-            using namespace boost::filesystem;
-            bool success{false};
-            if (lastLedgerHash && shard->getState() == Shard::complete)
-            {
-                // Store shard final key
-                Serializer s;
-                s.add32(Shard::version);
-                s.add32(firstLedgerSeq(shardIndex));
-                s.add32(lastLedgerSeq(shardIndex));
-                s.addBitString(*lastLedgerHash);
-                auto const nodeObject{NodeObject::createObject(
-                    hotUNKNOWN, std::move(s.modData()), Shard::finalKey)};
-
-                if (shard->storeNodeObject(nodeObject))
-                {
-                    try
-                    {
-                        // The import process is complete and the
-                        // marker file is no longer required
-                        remove_all(markerFile);
-
-                        JLOG(j_.debug()) << "shard " << shardIndex
-                                         << " was successfully imported";
-                        finalizeShard(
-                            shards_.emplace(shardIndex, std::move(shard))
-                                .first->second,
-                            true,
-                            boost::none);
-                        success = true;
-
-                        if (shardIndex < shardBoundaryIndex())
-                            ++numHistShards;
-                    }
-                    catch (std::exception const& e)
-                    {
-                        JLOG(j_.fatal()) << "shard index " << shardIndex
-                                         << ". Exception caught in function "
-                                         << __func__ << ". Error: " << e.what();
-                    }
-                }
-            }
+            // Count it now, so the shards imported at once stay within
+            // the limit on historical shards
+            if (shardIndex < shardBoundaryIndex())
+                ++numHistShards;
 
-            if (!success)
-            {
-                JLOG(j_.error())
-                    << "shard " << shardIndex << " failed to import";
-                shard->removeOnDestroy();
-            }
+            imports.push_back({shardIndex, std::move(shard), markerFile, {}});
         }
 
+        importShards();
+
         updateStatus(lock);
     }
 
@@ -1013,15 +1287,24 @@ DatabaseShardImp::store(
 
     auto const nodeObject{
         NodeObject::createObject(type, std::move(data), hash)};
+    auto const begin = std::chrono::steady_clock::now();
     if (shard->storeNodeObject(nodeObject))
+    {
         storeStats(1, nodeObject->getData().size());
+        traceStore(
+            *nodeObject,
+            ledgerSeq,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin));
+    }
 }
 
 bool
 DatabaseShardImp::asyncFetch(
     uint256 const& hash,
     std::uint32_t ledgerSeq,
-    std::shared_ptr<NodeObject>& nodeObject)
+    std::shared_ptr<NodeObject>& nodeObject,
+    FetchPriority priority)
 {
     std::shared_ptr<Shard> shard;
     {
@@ -1038,7 +1321,7 @@ DatabaseShardImp::asyncFetch(
         return true;
 
     // Otherwise post a read
-    Database::asyncFetch(hash, ledgerSeq);
+    Database::asyncFetch(hash, ledgerSeq, priority);
     return false;
 }
 
@@ -1115,6 +1398,8 @@ DatabaseShardImp::getCacheHitRate()
 void
 DatabaseShardImp::sweep()
 {
+    finalCache_->sweep();
+
     std::vector<std::weak_ptr<Shard>> shards;
     {
         std::lock_guard lock(mutex_);
@@ -1246,6 +1531,37 @@ DatabaseShardImp::initConfig(std::lock_guard<std::mutex> const&)
         avgShardFileSz_ = ledgersPerShard_ * kilobytes(192);
     }
 
+    get_if_exists(section, "finalize_threads", finalizeThreads_);
+    if (finalizeThreads_ == 0)
+        return fail("'finalize_threads' must be greater than zero");
+
+    get_if_exists(section, "import_threads", importThreads_);
+    if (importThreads_ == 0)
+        return fail("'import_threads' must be greater than zero");
+
+    {
+        std::uint32_t cacheMB{0};
+        get_if_exists(section, "cache_mb", cacheMB);
+        if (cacheMB != 0)
+            finalCache_->setTargetBytes(megabytes(std::size_t{cacheMB}));
+    }
+
+    get_if_exists(section, "prefetch_ledgers", prefetchLedgers_);
+
+    if (get_if_exists<path>(section, "base_path", basePath_))
+    {
+        auto const inside = [&](path const& dir) {
+            auto const rel{basePath_.lexically_relative(dir)};
+            return !rel.empty() && *rel.begin() != "..";
+        };
+        if (inside(dir_) ||
+            std::any_of(
+                historicalPaths_.begin(), historicalPaths_.end(), inside))
+        {
+            return fail("'base_path' cannot be inside a shard path");
+        }
+    }
+
     // NuDB is the default and only supported permanent storage backend
     backendName_ = get<std::string>(section, "type", "nudb");
     if (!boost::iequals(backendName_, "NuDB"))
@@ -1270,7 +1586,208 @@ DatabaseShardImp::fetchNodeObject(
         shard = it->second;
     }
 
-    return shard->fetchNodeObject(hash, fetchReport);
+    if (shard->getState() != Shard::final)
+        return shard->fetchNodeObject(hash, fetchReport);
+
+    // A cached object is returned without going to the shard, so it can
+    // be read even if the backend of the shard has been closed
+    if (auto nodeObject{finalCache_->fetch(hash)})
+        return nodeObject;
+
+    auto nodeObject{shard->fetchNodeObject(hash, fetchReport)};
+    if (nodeObject)
+        finalCache_->canonicalize_replace_client(hash, nodeObject);
+    touchFinal(shard);
+    return nodeObject;
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseShardImp::fetchBatch(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq,
+    FetchReport& fetchReport)
+{
+    auto const shardIndex{seqToShardIndex(ledgerSeq)};
+    std::shared_ptr<Shard> shard;
+    {
+        std::lock_guard lock(mutex_);
+        auto const it{shards_.find(shardIndex)};
+        if (it == shards_.end())
+            return std::vector<std::shared_ptr<NodeObject>>(hashes.size());
+        shard = it->second;
+    }
+
+    if (shard->getState() != Shard::final)
+        return shard->fetchBatch(hashes, fetchReport);
+
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+    std::vector<uint256> misses;
+    std::vector<std::size_t> indexes;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        results[i] = finalCache_->fetch(hashes[i]);
+        if (!results[i])
+        {
+            misses.push_back(hashes[i]);
+            indexes.push_back(i);
+        }
+    }
+    if (misses.empty())
+        return results;
+
+    auto nodeObjects{shard->fetchBatch(misses, fetchReport)};
+    for (std::size_t i = 0; i < misses.size(); ++i)
+    {
+        if (nodeObjects[i])
+        {
+            finalCache_->canonicalize_replace_client(misses[i], nodeObjects[i]);
+            results[indexes[i]] = std::move(nodeObjects[i]);
+        }
+    }
+    touchFinal(shard);
+    return results;
+}
+
+void
+DatabaseShardImp::touchFinal(std::shared_ptr<Shard> const& shard)
+{
+    std::lock_guard lock(openFinalsMutex_);
+    auto const index{shard->index()};
+    if (auto const it{openFinalsIndex_.find(index)};
+        it != openFinalsIndex_.end())
+    {
+        // The shard may have been removed and added again
+        it->second->second = shard;
+        openFinals_.splice(openFinals_.begin(), openFinals_, it->second);
+    }
+    else
+    {
+        openFinals_.emplace_front(index, shard);
+        openFinalsIndex_.emplace(index, openFinals_.begin());
+    }
+
+    if (openFinals_.size() <= openFinalLimit_)
+        return;
+
+    // Forget the shards which are gone or were closed by a sweep, then
+    // close the least recently read. The shard just read is never closed.
+    auto erase = [&](auto it) {
+        openFinalsIndex_.erase(it->first);
+        return openFinals_.erase(it);
+    };
+    for (auto it{std::next(openFinals_.begin())}; it != openFinals_.end();)
+    {
+        if (auto const s{it->second.lock()}; !s || !s->isOpen())
+            it = erase(it);
+        else
+            ++it;
+    }
+    for (auto it{openFinals_.end()};
+         openFinals_.size() > openFinalLimit_ &&
+         --it != openFinals_.begin();)
+    {
+        if (auto const s{it->second.lock()}; !s || s->tryClose())
+            it = erase(it);
+    }
+}
+
+void
+DatabaseShardImp::notePrefetch(std::uint32_t ledgerSeq)
+{
+    if (prefetchLedgers_ == 0)
+        return;
+
+    // A run is followed after its third ledger, and topped up once
+    // the reader is halfway through the ledgers prefetched for it
+    static constexpr std::uint32_t minRunLength{3};
+
+    std::uint32_t first;
+    std::uint32_t last;
+    std::int32_t step;
+    {
+        std::lock_guard lock(scansMutex_);
+        auto const it{std::find_if(
+            scans_.begin(), scans_.end(), [ledgerSeq](Scan const& scan) {
+                if (scan.length == 0)
+                    return false;
+                if (scan.step == 0)
+                {
+                    return ledgerSeq == scan.last + 1 ||
+                        ledgerSeq + 1 == scan.last;
+                }
+                return ledgerSeq == scan.last + scan.step;
+            })};
+        if (it == scans_.end())
+        {
+            // Start a new run in place of the oldest
+            scans_[nextScan_] = {ledgerSeq, 0, 1, ledgerSeq};
+            nextScan_ = (nextScan_ + 1) % scans_.size();
+            return;
+        }
+
+        it->step = ledgerSeq > it->last ? 1 : -1;
+        it->last = ledgerSeq;
+        if (++it->length < minRunLength || prefetching_)
+            return;
+
+        step = it->step;
+        if (step > 0)
+        {
+            if (it->ahead > ledgerSeq + prefetchLedgers_ / 2)
+                return;
+            first = std::max(it->ahead, ledgerSeq) + 1;
+            last = ledgerSeq + prefetchLedgers_;
+        }
+        else
+        {
+            auto const earliest{earliestLedgerSeq()};
+            if (it->ahead + prefetchLedgers_ / 2 < ledgerSeq ||
+                ledgerSeq <= earliest)
+            {
+                return;
+            }
+            first = std::min(it->ahead, ledgerSeq) - 1;
+            last = ledgerSeq - std::min(prefetchLedgers_, ledgerSeq - earliest);
+            if (first < last)
+                return;
+        }
+        it->ahead = last;
+        prefetching_ = true;
+    }
+
+    bool const added{app_.getJobQueue().addJob(
+        jtLEDGER_HISTORY, "ShardPrefetch", [this, first, last, step](Job&) {
+            for (auto ledgerSeq{first};; step > 0 ? ++ledgerSeq : --ledgerSeq)
+            {
+                auto const hash{app_.getLedgerMaster().getHashBySeq(ledgerSeq)};
+                if (hash.isZero())
+                    break;
+
+                auto const ledger{loadLedger(hash, ledgerSeq)};
+                if (!ledger)
+                    break;
+
+                // Readers of a run of ledgers usually want their
+                // transactions, and the transaction maps are small
+                try
+                {
+                    ledger->txMap().visitNodes(
+                        [](SHAMapTreeNode&) { return true; });
+                }
+                catch (SHAMapMissingNode const& e)
+                {
+                    JLOG(j_.warn()) << "prefetch of ledger " << ledgerSeq
+                                    << " failed: " << e.what();
+                    break;
+                }
+
+                if (ledgerSeq == last)
+                    break;
+            }
+            prefetching_ = false;
+        })};
+    if (!added)
+        prefetching_ = false;
 }
 
 boost::optional<std::uint32_t>
@@ -1359,7 +1876,7 @@ DatabaseShardImp::finalizeShard(
             return;
         }
 
-        if (!shard->finalize(writeSQLite, expectedHash))
+        if (!shard->finalize(writeSQLite, expectedHash, finalizeThreads_))
         {
             if (isStopping())
                 return;
@@ -1455,6 +1972,9 @@ DatabaseShardImp::setFileStats()
         }
     }
 
+    if (base_)
+        sumFd += base_->fdRequired();
+
     std::lock_guard lock(mutex_);
     fileSz_ = sumSz;
     fdRequired_ = sumFd;
@@ -1741,7 +2261,7 @@ DatabaseShardImp::relocateOutdatedShards(
                     std::make_shared<Shard>(app_, *this, shardIndex, dst, j_);
 
                 // Open the new shard
-                if (!shard->init(scheduler_, *ctx_))
+                if (!shard->init(scheduler_, *ctx_, base_))
                 {
                     JLOG(j_.error()) << "shard " << shardIndex
                                      << " failed to open in historical storage";
@@ -26,6 +26,9 @@
 
 #include <boost/asio/basic_waitable_timer.hpp>
 
+#include <array>
+#include <list>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -67,9 +70,25 @@ public:
     importShard(std::uint32_t shardIndex, boost::filesystem::path const& srcDir)
         override;
 
+    bool
+    exportShard(std::uint32_t shardIndex, boost::filesystem::path const& dstDir)
+        override;
+
     std::shared_ptr<Ledger>
     fetchLedger(uint256 const& hash, std::uint32_t ledgerSeq) override;
 
+    void
+    forEachAccountShard(
+        AccountID const& account,
+        std::uint32_t minSeq,
+        std::uint32_t maxSeq,
+        bool forward,
+        std::function<bool(DatabaseCon&, std::uint32_t, std::uint32_t)> const&
+            callback) override;
+
+    std::uint32_t
+    firstContiguousSeq(std::uint32_t seq) override;
+
     void
     setStored(std::shared_ptr<Ledger const> const& ledger) override;
 
@@ -150,7 +169,8 @@ public:
     asyncFetch(
         uint256 const& hash,
         std::uint32_t ledgerSeq,
-        std::shared_ptr<NodeObject>& nodeObject) override;
+        std::shared_ptr<NodeObject>& nodeObject,
+        FetchPriority priority) override;
 
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override;
@@ -164,6 +184,12 @@ public:
     void
     tune(int size, std::chrono::seconds age) override{};
 
+    TaggedCache<uint256, NodeObject>*
+    getObjectCache() override
+    {
+        return finalCache_.get();
+    }
+
     void
     sweep() override;
 
@@ -181,6 +207,11 @@ private:
     // The context shared with all shard backend databases
     std::unique_ptr<nudb::context> ctx_;
 
+    // The store shared by all shards for account state nodes, null unless
+    // a base path is configured
+    boost::filesystem::path basePath_;
+    std::shared_ptr<Backend> base_;
+
     // Queue of background tasks to be performed
     std::unique_ptr<TaskQueue> taskQueue_;
 
@@ -208,6 +239,14 @@ private:
     // Maximum number of historical shards to store.
     std::uint32_t maxHistoricalShards_{0};
 
+    // The number of threads verifying the ledgers of a shard being
+    // finalized
+    std::uint32_t finalizeThreads_{2};
+
+    // The number of shards copied from the node store at once when
+    // importing it
+    std::uint32_t importThreads_{2};
+
     // Contains historical shard paths
     std::vector<boost::filesystem::path> historicalPaths_;
 
@@ -228,6 +267,40 @@ private:
     // The limit of final shards with open databases at any time
     std::uint32_t const openFinalLimit_;
 
+    // Node objects read from final shards. Objects are addressed by their
+    // hash, so one cache serves every final shard and what it holds is
+    // kept when the backend of a shard is closed.
+    std::unique_ptr<PCache> finalCache_;
+
+    // Final shards read from, most recently read first
+    std::mutex openFinalsMutex_;
+    std::list<std::pair<std::uint32_t, std::weak_ptr<Shard>>> openFinals_;
+    std::unordered_map<
+        std::uint32_t,
+        std::list<std::pair<std::uint32_t, std::weak_ptr<Shard>>>::iterator>
+        openFinalsIndex_;
+
+    // A run of ledgers loaded one after the other
+    struct Scan
+    {
+        std::uint32_t last{0};
+        // 1 if moving forward, -1 if moving back, 0 if not yet known
+        std::int32_t step{0};
+        std::uint32_t length{0};
+        // The furthest ledger in the run which has been prefetched
+        std::uint32_t ahead{0};
+    };
+
+    // Recent runs, so that the runs of a few clients reading at once
+    // can each be followed
+    std::mutex scansMutex_;
+    std::array<Scan, 8> scans_;
+    std::size_t nextScan_{0};
+    std::atomic<bool> prefetching_{false};
+
+    // The number of ledgers prefetched ahead of a run, 0 to disable
+    std::uint32_t prefetchLedgers_{8};
+
     // File name used to mark shards being imported from node store
     static constexpr auto importMarker_ = "import";
 
@@ -252,6 +325,27 @@ private:
         std::uint32_t ledgerSeq,
         FetchReport& fetchReport) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(
+        std::vector<uint256> const& hashes,
+        std::uint32_t ledgerSeq,
+        FetchReport& fetchReport) override;
+
+    // Load a ledger header and the roots of its maps
+    std::shared_ptr<Ledger>
+    loadLedger(uint256 const& hash, std::uint32_t ledgerSeq);
+
+    // Move a final shard to the front of the shards read from, and close
+    // the least recently read if more than the limit are open
+    void
+    touchFinal(std::shared_ptr<Shard> const& shard);
+
+    // Follow the runs of ledgers being loaded. When a ledger continues a
+    // run, the next ledgers in it are loaded in the background along with
+    // their transactions, so the reader finds them cached.
+    void
+    notePrefetch(std::uint32_t ledgerSeq);
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
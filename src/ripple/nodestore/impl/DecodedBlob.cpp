@@ -88,5 +88,24 @@ DecodedBlob::createObject()
     return object;
 }
 
+std::shared_ptr<NodeObject>
+DecodedBlob::createObject(std::shared_ptr<void const> owner)
+{
+    assert(m_success);
+
+    std::shared_ptr<NodeObject> object;
+
+    if (m_success)
+    {
+        object = NodeObject::createObject(
+            m_objectType,
+            std::move(owner),
+            Slice(m_objectData, m_dataBytes),
+            uint256::fromVoid(m_key));
+    }
+
+    return object;
+}
+
 }  // namespace NodeStore
 }  // namespace ripple
@@ -52,6 +52,13 @@ public:
     std::shared_ptr<NodeObject>
     createObject();
 
+    /** Create a NodeObject which refers to this data without copying it.
+
+        @param owner Keeps alive the buffer the value was decoded from.
+    */
+    std::shared_ptr<NodeObject>
+    createObject(std::shared_ptr<void const> owner);
+
 private:
     bool m_success;
 
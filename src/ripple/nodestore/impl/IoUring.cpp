@@ -0,0 +1,347 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/impl/IoUring.h>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define RIPPLE_IO_URING_AVAILABLE 1
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#define RIPPLE_IO_URING_AVAILABLE 0
+#endif
+
+namespace ripple {
+namespace NodeStore {
+
+#if RIPPLE_IO_URING_AVAILABLE
+
+[[noreturn]] static void
+throwErrno(int error, std::string const& what)
+{
+    Throw<std::system_error>(error, std::generic_category(), what);
+}
+
+IoUring::File::File(std::string const& path)
+    : fd_(::open(path.c_str(), O_RDONLY | O_CLOEXEC))
+{
+    if (fd_ < 0)
+        throwErrno(errno, "open " + path);
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+    {
+        auto const error = errno;
+        ::close(fd_);
+        throwErrno(error, "stat " + path);
+    }
+    size_ = st.st_size;
+}
+
+IoUring::File::~File()
+{
+    ::close(fd_);
+}
+
+//------------------------------------------------------------------------------
+
+// The kernel interface, without depending on liburing. The submission and
+// completion queues are rings shared with the kernel: we produce at the
+// tail of the submission queue and consume at the head of the completion
+// queue, and the kernel does the opposite.
+class IoUring::Ring
+{
+    int fd_ = -1;
+
+    void* sqRing_ = MAP_FAILED;
+    std::size_t sqRingSize_ = 0;
+    void* cqRing_ = MAP_FAILED;
+    std::size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqesSize_ = 0;
+
+    unsigned* sqTail_;
+    unsigned sqMask_;
+    unsigned sqEntries_;
+    unsigned* sqArray_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    io_uring_cqe* cqes_;
+
+    // The most reads kept in flight by one thread.
+    static constexpr unsigned entries = 64;
+
+    template <class T>
+    static T*
+    at(void* base, std::uint32_t offset)
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+
+    static void*
+    map(int fd, std::size_t size, std::uint64_t offset)
+    {
+        auto const p = ::mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            fd,
+            offset);
+        if (p == MAP_FAILED)
+            throwErrno(errno, "io_uring mmap");
+        return p;
+    }
+
+    void
+    unmap()
+    {
+        if (sqes_ != MAP_FAILED)
+            ::munmap(sqes_, sqesSize_);
+        if (cqRing_ != MAP_FAILED)
+            ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != MAP_FAILED)
+            ::munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    // Returns the number of submissions consumed
+    unsigned
+    enter(unsigned toSubmit, unsigned minComplete)
+    {
+        for (;;)
+        {
+            auto const ret = ::syscall(
+                __NR_io_uring_enter,
+                fd_,
+                toSubmit,
+                minComplete,
+                IORING_ENTER_GETEVENTS,
+                nullptr,
+                0);
+            if (ret >= 0)
+                return static_cast<unsigned>(ret);
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                throwErrno(errno, "io_uring_enter");
+        }
+    }
+
+public:
+    Ring()
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(
+            ::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+            throwErrno(errno, "io_uring_setup");
+
+        try
+        {
+            sqRingSize_ =
+                params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize_ = params.cq_off.cqes +
+                params.cq_entries * sizeof(io_uring_cqe);
+            sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+
+            sqRing_ = map(fd_, sqRingSize_, IORING_OFF_SQ_RING);
+            cqRing_ = map(fd_, cqRingSize_, IORING_OFF_CQ_RING);
+            sqes_ = static_cast<io_uring_sqe*>(
+                map(fd_, sqesSize_, IORING_OFF_SQES));
+        }
+        catch (std::exception const&)
+        {
+            unmap();
+            throw;
+        }
+
+        sqTail_ = at<unsigned>(sqRing_, params.sq_off.tail);
+        sqMask_ = *at<unsigned>(sqRing_, params.sq_off.ring_mask);
+        sqEntries_ = params.sq_entries;
+        sqArray_ = at<unsigned>(sqRing_, params.sq_off.array);
+        cqHead_ = at<unsigned>(cqRing_, params.cq_off.head);
+        cqTail_ = at<unsigned>(cqRing_, params.cq_off.tail);
+        cqMask_ = *at<unsigned>(cqRing_, params.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cqRing_, params.cq_off.cqes);
+    }
+
+    Ring(Ring const&) = delete;
+    Ring&
+    operator=(Ring const&) = delete;
+
+    ~Ring()
+    {
+        unmap();
+    }
+
+    void
+    read(std::vector<Read>& reads)
+    {
+        // The kernel reads the vectors when the request is submitted, but
+        // keeping one per read leaves short reads free to be resubmitted.
+        std::vector<iovec> iovecs(reads.size());
+        std::vector<std::size_t> queue;
+        queue.reserve(reads.size());
+        for (std::size_t i = reads.size(); i-- > 0;)
+        {
+            reads[i].result = 0;
+            queue.push_back(i);
+        }
+
+        // After an error nothing more is submitted, but the reads already
+        // in flight must still complete before their buffers can be freed.
+        int error = 0;
+        unsigned inFlight = 0;
+        unsigned unsubmitted = 0;
+        while (!queue.empty() || inFlight > 0)
+        {
+            // Fill the submission queue. The completion queue is twice
+            // its size, so completions cannot overflow.
+            unsigned tail = *sqTail_;
+            while (!queue.empty() && inFlight < sqEntries_)
+            {
+                auto const i = queue.back();
+                queue.pop_back();
+                auto& r = reads[i];
+                iovecs[i].iov_base = static_cast<char*>(r.data) + r.result;
+                iovecs[i].iov_len = r.size - r.result;
+
+                auto const index = tail & sqMask_;
+                auto& sqe = sqes_[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = r.file->fd();
+                sqe.off = r.offset + r.result;
+                sqe.addr = reinterpret_cast<std::uintptr_t>(&iovecs[i]);
+                sqe.len = 1;
+                sqe.user_data = i;
+                sqArray_[index] = index;
+                ++tail;
+                ++inFlight;
+                ++unsubmitted;
+            }
+            __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+
+            unsubmitted -= enter(unsubmitted, 1);
+
+            // Reap whatever has completed
+            unsigned head = *cqHead_;
+            unsigned const cqTail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            for (; head != cqTail; ++head)
+            {
+                auto const& cqe = cqes_[head & cqMask_];
+                auto const i = static_cast<std::size_t>(cqe.user_data);
+                auto& r = reads[i];
+                --inFlight;
+                if (error)
+                    continue;
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR)
+                {
+                    queue.push_back(i);
+                }
+                else if (cqe.res < 0)
+                {
+                    error = -cqe.res;
+                    queue.clear();
+                }
+                else
+                {
+                    // Zero bytes means the end of the file
+                    r.result += cqe.res;
+                    if (cqe.res > 0 && r.result < r.size)
+                        queue.push_back(i);
+                }
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        }
+
+        if (error)
+            throwErrno(error, "io_uring read");
+    }
+};
+
+//------------------------------------------------------------------------------
+
+bool
+IoUring::available()
+{
+    static bool const result = [] {
+        try
+        {
+            Ring ring;
+            return true;
+        }
+        catch (std::exception const&)
+        {
+            return false;
+        }
+    }();
+    return result;
+}
+
+void
+IoUring::read(std::vector<Read>& reads)
+{
+    if (reads.empty())
+        return;
+
+    thread_local std::unique_ptr<Ring> ring;
+    if (!ring)
+        ring = std::make_unique<Ring>();
+    ring->read(reads);
+}
+
+#else
+
+IoUring::File::File(std::string const&) : fd_(-1), size_(0)
+{
+    Throw<std::runtime_error>("io_uring is not available");
+}
+
+IoUring::File::~File() = default;
+
+bool
+IoUring::available()
+{
+    return false;
+}
+
+void
+IoUring::read(std::vector<Read>&)
+{
+    Throw<std::runtime_error>("io_uring is not available");
+}
+
+#endif
+
+}  // namespace NodeStore
+}  // namespace ripple
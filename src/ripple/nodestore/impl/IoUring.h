@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_IOURING_H_INCLUDED
+#define RIPPLE_NODESTORE_IOURING_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Reads file contents many at a time using Linux io_uring.
+
+    Every read in a group is submitted to the kernel at once, so a single
+    thread keeps as many reads outstanding as the group holds, instead of
+    needing a thread blocked in a system call for each one. Fast devices
+    only reach their best throughput with many reads in flight.
+
+    Each thread gets its own ring the first time it reads, so reads may be
+    issued from any number of threads without locking.
+*/
+class IoUring
+{
+public:
+    /** A file opened for reading. */
+    class File
+    {
+        int fd_;
+        std::uint64_t size_;
+
+    public:
+        /** Open a file. Throws on failure. */
+        explicit File(std::string const& path);
+
+        File(File const&) = delete;
+        File&
+        operator=(File const&) = delete;
+
+        ~File();
+
+        int
+        fd() const
+        {
+            return fd_;
+        }
+
+        /** Return the size of the file when it was opened. */
+        std::uint64_t
+        size() const
+        {
+            return size_;
+        }
+    };
+
+    /** A request to read part of a file. */
+    struct Read
+    {
+        File const* file;
+        std::uint64_t offset;
+        void* data;
+        std::size_t size;
+
+        /** The number of bytes read, fewer than `size` at the end of the
+            file. Set on completion.
+        */
+        std::size_t result = 0;
+    };
+
+    /** Return `true` if io_uring can be used on this system. */
+    static bool
+    available();
+
+    /** Perform a group of reads and wait for all of them to complete.
+
+        Throws if any read fails.
+    */
+    static void
+    read(std::vector<Read>& reads);
+
+private:
+    class Ring;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <ripple/protocol/Serializer.h>
+#include <algorithm>
+#include <cstring>
+
+namespace ripple {
+namespace NodeStore {
+
+KeyFilter::KeyFilter(std::size_t bytes)
+    : blocks_(std::max<std::size_t>(bytes / sizeof(Block), 1))
+    , table_(new Block[blocks_]())
+{
+}
+
+auto
+KeyFilter::locate(uint256 const& key) const
+    -> std::pair<std::size_t, std::array<std::uint16_t, hashCount>>
+{
+    // Keys are hashes of the objects they name, so their bits are already
+    // well distributed and can be used as they are.
+    std::array<std::uint64_t, 4> words;
+    static_assert(sizeof(words) == uint256::bytes);
+    std::memcpy(words.data(), key.data(), sizeof(words));
+
+    static constexpr std::size_t bitsPerIndex = 9;
+    static_assert((std::size_t{1} << bitsPerIndex) == blockWords * 64);
+    static_assert(hashCount * bitsPerIndex <= 64);
+
+    std::pair<std::size_t, std::array<std::uint16_t, hashCount>> result;
+    result.first = words[0] % blocks_;
+    for (std::size_t i = 0; i < hashCount; ++i)
+        result.second[i] = static_cast<std::uint16_t>(
+            (words[1] >> (i * bitsPerIndex)) & (blockWords * 64 - 1));
+    return result;
+}
+
+void
+KeyFilter::insert(uint256 const& key)
+{
+    auto const [block, bits] = locate(key);
+    auto& words = table_[block].words;
+    for (auto const bit : bits)
+        words[bit / 64].fetch_or(
+            std::uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+    size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool
+KeyFilter::mayContain(uint256 const& key) const
+{
+    auto const [block, bits] = locate(key);
+    auto const& words = table_[block].words;
+    for (auto const bit : bits)
+    {
+        auto const mask = std::uint64_t{1} << (bit % 64);
+        if ((words[bit / 64].load(std::memory_order_relaxed) & mask) == 0)
+            return false;
+    }
+    return true;
+}
+
+Blob
+KeyFilter::toBlob() const
+{
+    Serializer s(sizeof(std::uint64_t) + bytes());
+    s.add64(size());
+    for (std::size_t i = 0; i < blocks_; ++i)
+    {
+        for (auto const& word : table_[i].words)
+            s.add64(word.load(std::memory_order_relaxed));
+    }
+    return s.getData();
+}
+
+std::unique_ptr<KeyFilter>
+KeyFilter::fromBlob(Slice data)
+{
+    if (data.size() < sizeof(std::uint64_t) + sizeof(Block) ||
+        (data.size() - sizeof(std::uint64_t)) % sizeof(Block) != 0)
+    {
+        return nullptr;
+    }
+
+    auto filter =
+        std::make_unique<KeyFilter>(data.size() - sizeof(std::uint64_t));
+    SerialIter sit(data);
+    filter->size_ = sit.get64();
+    for (std::size_t i = 0; i < filter->blocks_; ++i)
+    {
+        for (auto& word : filter->table_[i].words)
+            word.store(sit.get64(), std::memory_order_relaxed);
+    }
+    return filter;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+#define RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/base_uint.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A Bloom filter over the keys stored in a backend.
+
+    A lookup which the filter rejects is certain to miss, so the backend
+    need not be asked at all. A lookup which the filter accepts is most
+    likely, but not certainly, a hit. Keys are never removed.
+
+    The bits of each key are kept in one 64-byte block, so a test touches
+    a single cache line. Inserting and testing may be done concurrently
+    from any number of threads.
+*/
+class KeyFilter
+{
+public:
+    /** Bits set for each key. */
+    static constexpr std::size_t hashCount = 6;
+
+    /** Create an empty filter using about `bytes` bytes of memory. */
+    explicit KeyFilter(std::size_t bytes);
+
+    KeyFilter(KeyFilter const&) = delete;
+    KeyFilter&
+    operator=(KeyFilter const&) = delete;
+
+    void
+    insert(uint256 const& key);
+
+    /** Return `false` if `key` was certainly never inserted. */
+    bool
+    mayContain(uint256 const& key) const;
+
+    /** The number of keys inserted. */
+    std::size_t
+    size() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    /** The number of bytes used by the filter. */
+    std::size_t
+    bytes() const
+    {
+        return blocks_ * sizeof(Block);
+    }
+
+    /** Serialize the filter, so it can be saved and loaded again. */
+    Blob
+    toBlob() const;
+
+    /** Load a filter serialized by toBlob(). Returns nullptr if the data
+        is malformed. */
+    static std::unique_ptr<KeyFilter>
+    fromBlob(Slice data);
+
+private:
+    static constexpr std::size_t blockWords = 8;
+
+    struct alignas(64) Block
+    {
+        std::atomic<std::uint64_t> words[blockWords];
+    };
+
+    // The block a key belongs in and the bit indexes within it
+    std::pair<std::size_t, std::array<std::uint16_t, hashCount>>
+    locate(uint256 const& key) const;
+
+    std::size_t const blocks_;
+    std::unique_ptr<Block[]> const table_;
+    std::atomic<std::size_t> size_{0};
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
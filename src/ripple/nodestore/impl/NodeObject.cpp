@@ -29,7 +29,17 @@ NodeObject::NodeObject(
     Blob&& data,
     uint256 const& hash,
     PrivateAccess)
-    : mType(type), mHash(hash), mData(std::move(data))
+    : mType(type), mHash(hash), mBlob(std::move(data)), mData(makeSlice(mBlob))
+{
+}
+
+NodeObject::NodeObject(
+    NodeObjectType type,
+    std::shared_ptr<void const> owner,
+    Slice data,
+    uint256 const& hash,
+    PrivateAccess)
+    : mType(type), mHash(hash), mOwner(std::move(owner)), mData(data)
 {
 }
 
@@ -40,6 +50,17 @@ NodeObject::createObject(NodeObjectType type, Blob&& data, uint256 const& hash)
         type, std::move(data), hash, PrivateAccess());
 }
 
+std::shared_ptr<NodeObject>
+NodeObject::createObject(
+    NodeObjectType type,
+    std::shared_ptr<void const> owner,
+    Slice data,
+    uint256 const& hash)
+{
+    return std::make_shared<NodeObject>(
+        type, std::move(owner), data, hash, PrivateAccess());
+}
+
 NodeObjectType
 NodeObject::getType() const
 {
@@ -52,7 +73,7 @@ NodeObject::getHash() const
     return mHash;
 }
 
-Blob const&
+Slice
 NodeObject::getData() const
 {
     return mData;
@@ -19,7 +19,9 @@
 
 #include <ripple/app/ledger/InboundLedger.h>
 #include <ripple/app/main/DBInit.h>
+#include <ripple/basics/FileUtilities.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/Shard.h>
@@ -28,11 +30,25 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
+#include <thread>
+
 namespace ripple {
 namespace NodeStore {
 
 uint256 const Shard::finalKey{0};
 
+// The file the account filter of a final shard is saved in
+static constexpr auto accountFilterName{"account_filter"};
+
+// Account IDs are hashes, so their bits can key the filter as they are
+static uint256
+accountFilterKey(AccountID const& account)
+{
+    uint256 key;
+    std::memcpy(key.data(), account.data(), account.size());
+    return key;
+}
+
 Shard::Shard(
     Application& app,
     DatabaseShard const& db,
@@ -95,7 +111,10 @@ Shard::~Shard()
 }
 
 bool
-Shard::init(Scheduler& scheduler, nudb::context& context)
+Shard::init(
+    Scheduler& scheduler,
+    nudb::context& context,
+    std::shared_ptr<Backend> base)
 {
     Section section{app_.config().section(ConfigSection::shardDatabase())};
     std::string const type{get<std::string>(section, "type", "nudb")};
@@ -121,6 +140,7 @@ Shard::init(Scheduler& scheduler, nudb::context& context)
         scheduler,
         context,
         j_);
+    base_ = std::move(base);
 
     return open(lock);
 }
@@ -229,7 +249,7 @@ Shard::storeNodeObject(std::shared_ptr<NodeObject> const& nodeObject)
 
     try
     {
-        backend_->store(nodeObject);
+        storeBackend({nodeObject});
     }
     catch (std::exception const& e)
     {
@@ -260,7 +280,7 @@ Shard::fetchNodeObject(uint256 const& hash, FetchReport& fetchReport)
         Status status;
         try
         {
-            status = backend_->fetch(hash.data(), &nodeObject);
+            status = fetchBackend(hash, &nodeObject);
         }
         catch (std::exception const& e)
         {
@@ -311,6 +331,109 @@ Shard::fetchNodeObject(uint256 const& hash, FetchReport& fetchReport)
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Shard::fetchBatch(std::vector<uint256> const& hashes, FetchReport& fetchReport)
+{
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+    auto const scopedCount{makeBackendCount()};
+    if (!scopedCount)
+        return results;
+
+    // Collect the objects which are in neither cache
+    std::vector<uint256 const*> cacheMisses;
+    std::vector<std::size_t> indexes;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        results[i] = pCache_->fetch(hashes[i]);
+        if (!results[i] && !nCache_->touch_if_exists(hashes[i]))
+        {
+            cacheMisses.push_back(&hashes[i]);
+            indexes.push_back(i);
+        }
+    }
+
+    if (cacheMisses.empty())
+        return results;
+
+    // Try the backend
+    fetchReport.wentToDisk = true;
+    fetchReport.diskCount += cacheMisses.size();
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status> fetched;
+    try
+    {
+        fetched = backend_->fetchBatch(cacheMisses);
+
+        if (base_ && fetched.first.size() == cacheMisses.size())
+        {
+            // Look for the rest in the base store
+            std::vector<uint256 const*> baseMisses;
+            std::vector<std::size_t> baseIndexes;
+            for (std::size_t i = 0; i < cacheMisses.size(); ++i)
+            {
+                if (!fetched.first[i])
+                {
+                    baseMisses.push_back(cacheMisses[i]);
+                    baseIndexes.push_back(i);
+                }
+            }
+
+            if (!baseMisses.empty())
+            {
+                auto [baseObjects, baseStatus] = base_->fetchBatch(baseMisses);
+                if (baseObjects.size() == baseMisses.size())
+                {
+                    for (std::size_t i = 0; i < baseMisses.size(); ++i)
+                    {
+                        fetched.first[baseIndexes[i]] =
+                            std::move(baseObjects[i]);
+                    }
+                }
+                if (baseStatus != ok && baseStatus != notFound)
+                    fetched.second = baseStatus;
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "shard " << index_
+                         << ". Exception caught in function " << __func__
+                         << ". Error: " << e.what();
+        return results;
+    }
+
+    auto& [nodeObjects, status] = fetched;
+    if (status != ok)
+    {
+        JLOG(j_.warn()) << "shard " << index_ << ". Batch fetch status="
+                        << status;
+    }
+    assert(nodeObjects.size() == cacheMisses.size());
+
+    for (std::size_t i = 0; i < cacheMisses.size(); ++i)
+    {
+        auto const& hash = *cacheMisses[i];
+        auto& nodeObject = nodeObjects[i];
+        if (!nodeObject)
+        {
+            // Just in case a write occurred
+            nodeObject = pCache_->fetch(hash);
+            if (!nodeObject)
+                // We give up
+                nCache_->insert(hash);
+        }
+        else
+        {
+            // Ensure all threads get the same object
+            pCache_->canonicalize_replace_client(hash, nodeObject);
+            fetchReport.wasFound = true;
+        }
+        results[indexes[i]] = std::move(nodeObject);
+    }
+
+    return results;
+}
+
 bool
 Shard::fetchNodeObjectFromCache(
     uint256 const& hash,
@@ -378,7 +501,7 @@ Shard::storeLedger(
 
         try
         {
-            backend_->storeBatch(batch);
+            storeBackend(batch);
         }
         catch (std::exception const& e)
         {
@@ -404,22 +527,29 @@ Shard::storeLedger(
         batch.emplace_back(std::move(nodeObject));
     }
 
+    // The walk has already read each node from the source database, so
+    // the node is stored as it was read rather than fetched again
     bool error = false;
-    auto visit = [&](SHAMapTreeNode const& node) {
+    auto store = [&](SHAMapTreeNode const& node, NodeObjectType type) {
         if (!stop_)
         {
-            if (auto nodeObject = srcDB.fetchNodeObject(
-                    node.getHash().as_uint256(), srcLedger->info().seq))
-            {
-                batch.emplace_back(std::move(nodeObject));
-                if (batch.size() < batchWritePreallocationSize || storeBatch())
-                    return true;
-            }
+            Serializer s;
+            node.serializeWithPrefix(s);
+            batch.emplace_back(NodeObject::createObject(
+                type, std::move(s.modData()), node.getHash().as_uint256()));
+            if (batch.size() < batchWritePreallocationSize || storeBatch())
+                return true;
         }
 
         error = true;
         return false;
     };
+    auto visitState = [&](SHAMapTreeNode const& node) {
+        return store(node, hotACCOUNT_NODE);
+    };
+    auto visitTx = [&](SHAMapTreeNode const& node) {
+        return store(node, hotTRANSACTION_NODE);
+    };
 
     // Store the state map
     if (srcLedger->stateMap().getHash().isNonZero())
@@ -431,10 +561,10 @@ Shard::storeLedger(
         {
             auto have = next->stateMap().snapShot(false);
             srcLedger->stateMap().snapShot(false)->visitDifferences(
-                &(*have), visit);
+                &(*have), visitState);
         }
         else
-            srcLedger->stateMap().snapShot(false)->visitNodes(visit);
+            srcLedger->stateMap().snapShot(false)->visitNodes(visitState);
         if (error)
             return fail("Failed to store state map");
     }
@@ -445,7 +575,7 @@ Shard::storeLedger(
         if (!srcLedger->txMap().isValid())
             return fail("Invalid transaction map");
 
-        srcLedger->txMap().snapShot(false)->visitNodes(visit);
+        srcLedger->txMap().snapShot(false)->visitNodes(visitTx);
         if (error)
             return fail("Failed to store transaction map");
     }
@@ -571,6 +701,33 @@ Shard::getLastUse() const
     return lastAccess_;
 }
 
+bool
+Shard::mayContainAccount(AccountID const& account) const
+{
+    std::lock_guard lock(mutex_);
+    return !accountFilter_ ||
+        accountFilter_->mayContain(accountFilterKey(account));
+}
+
+bool
+Shard::callForTransactionSQL(std::function<void(DatabaseCon&)> const& callback)
+{
+    auto const scopedCount{makeBackendCount()};
+    if (!scopedCount)
+        return false;
+
+    DatabaseCon* db;
+    {
+        std::lock_guard lock(mutex_);
+        db = txSQLiteDB_.get();
+    }
+    if (!db)
+        return false;
+
+    callback(*db);
+    return true;
+}
+
 std::pair<std::uint64_t, std::uint32_t>
 Shard::getFileInfo() const
 {
@@ -597,7 +754,8 @@ Shard::isLegacy() const
 bool
 Shard::finalize(
     bool const writeSQLite,
-    boost::optional<uint256> const& expectedHash)
+    boost::optional<uint256> const& expectedHash,
+    std::uint32_t const threads)
 {
     uint256 hash{0};
     std::uint32_t ledgerSeq{0};
@@ -704,21 +862,23 @@ Shard::finalize(
 
     // Validate every ledger stored in the backend
     Config const& config{app_.config()};
-    std::shared_ptr<Ledger> ledger;
-    std::shared_ptr<Ledger const> next;
     auto const lastLedgerHash{hash};
     auto& shardFamily{*app_.getShardFamily()};
     auto const fullBelowCache{shardFamily.getFullBelowCache(lastSeq_)};
     auto const treeNodeCache{shardFamily.getTreeNodeCache(lastSeq_)};
+    auto const resetCaches = [&]() {
+        pCache_->reset();
+        nCache_->reset();
+        fullBelowCache->reset();
+        treeNodeCache->reset();
+    };
 
     // Reset caches to reduce memory usage
-    pCache_->reset();
-    nCache_->reset();
-    fullBelowCache->reset();
-    treeNodeCache->reset();
+    resetCaches();
 
-    // Start with the last ledger in the shard and walk backwards from
-    // child to parent until we reach the first ledger
+    // Start with the last ledger in the shard and walk the headers
+    // backwards from child to parent until we reach the first ledger
+    std::vector<LedgerInfo> infos(lastSeq_ - firstSeq_ + 1);
     ledgerSeq = lastSeq_;
     while (ledgerSeq >= firstSeq_)
     {
@@ -729,48 +889,154 @@ Shard::finalize(
         if (!nodeObject)
             return fail("invalid ledger");
 
-        ledger = std::make_shared<Ledger>(
-            deserializePrefixedHeader(makeSlice(nodeObject->getData())),
+        Ledger const ledger(
+            deserializePrefixedHeader(nodeObject->getData()),
             config,
             shardFamily);
-        if (ledger->info().seq != ledgerSeq)
+        if (ledger.info().seq != ledgerSeq)
             return fail("invalid ledger sequence");
-        if (ledger->info().hash != hash)
+        if (ledger.info().hash != hash)
             return fail("invalid ledger hash");
 
-        ledger->stateMap().setLedgerSeq(ledgerSeq);
-        ledger->txMap().setLedgerSeq(ledgerSeq);
+        infos[ledgerSeq - firstSeq_] = ledger.info();
+        hash = ledger.info().parentHash;
+        --ledgerSeq;
+    }
+
+    auto const failLedger = [this](
+                                LedgerInfo const& info,
+                                std::string const& msg) {
+        JLOG(j_.fatal()) << "shard " << index_ << ". " << msg
+                         << ". Ledger hash " << to_string(info.hash)
+                         << ". Ledger sequence " << info.seq;
+    };
+
+    auto const makeLedger =
+        [&](LedgerInfo const& info) -> std::shared_ptr<Ledger> {
+        auto ledger{std::make_shared<Ledger>(info, config, shardFamily)};
+        ledger->stateMap().setLedgerSeq(info.seq);
+        ledger->txMap().setLedgerSeq(info.seq);
         ledger->setImmutable(config);
         if (!ledger->stateMap().fetchRoot(
-                SHAMapHash{ledger->info().accountHash}, nullptr))
+                SHAMapHash{info.accountHash}, nullptr))
         {
-            return fail("missing root STATE node");
+            failLedger(info, "missing root STATE node");
+            return nullptr;
         }
-        if (ledger->info().txHash.isNonZero() &&
-            !ledger->txMap().fetchRoot(
-                SHAMapHash{ledger->info().txHash}, nullptr))
+        if (info.txHash.isNonZero() &&
+            !ledger->txMap().fetchRoot(SHAMapHash{info.txHash}, nullptr))
         {
-            return fail("missing root TXN node");
+            failLedger(info, "missing root TXN node");
+            return nullptr;
         }
+        return ledger;
+    };
+
+    // Verifying a ledger only visits the nodes which differ from its
+    // child, so the ledgers are split into ranges which are verified on
+    // several threads, each range from child to parent. Nodes shared by
+    // ledgers which aren't adjacent are only verified once.
+    std::uint32_t const rangeSize{32};
+    std::uint32_t const rangeCount{
+        (lastSeq_ - firstSeq_ + rangeSize) / rangeSize};
+    std::atomic<std::uint32_t> nextRange{0};
+    std::atomic<bool> failed{false};
+    VerifiedNodes verified;
+
+    auto const verifyRanges = [&]() {
+        try
+        {
+            while (!stop_ && !failed)
+            {
+                auto const range{nextRange++};
+                if (range >= rangeCount)
+                    return;
+
+                auto const last{lastSeq_ - range * rangeSize};
+                auto const count{std::min(rangeSize, last - firstSeq_ + 1)};
+
+                std::shared_ptr<Ledger const> next;
+                if (last < lastSeq_)
+                {
+                    next = makeLedger(infos[last + 1 - firstSeq_]);
+                    if (!next)
+                    {
+                        failed = true;
+                        return;
+                    }
+                }
+
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    if (stop_ || failed)
+                        return;
+
+                    auto const& info{infos[last - i - firstSeq_]};
+                    auto ledger{makeLedger(info)};
+                    if (!ledger)
+                    {
+                        failed = true;
+                        return;
+                    }
 
-        if (!verifyLedger(ledger, next))
-            return fail("failed to validate ledger");
+                    if (!verifyLedger(ledger, next, verified))
+                    {
+                        failLedger(info, "failed to validate ledger");
+                        failed = true;
+                        return;
+                    }
+
+                    if (writeSQLite)
+                    {
+                        std::lock_guard lock(mutex_);
+                        if (!storeSQLite(ledger, lock))
+                        {
+                            failLedger(
+                                info, "failed storing to SQLite databases");
+                            failed = true;
+                            return;
+                        }
+                    }
+
+                    next = std::move(ledger);
+                }
 
-        if (writeSQLite)
+                resetCaches();
+            }
+        }
+        catch (std::exception const& e)
         {
-            std::lock_guard lock(mutex_);
-            if (!storeSQLite(ledger, lock))
-                return fail("failed storing to SQLite databases");
+            JLOG(j_.fatal()) << "shard " << index_
+                             << ". Exception caught verifying ledgers"
+                             << ". Error: " << e.what();
+            failed = true;
         }
+    };
 
-        hash = ledger->info().parentHash;
-        next = std::move(ledger);
-        --ledgerSeq;
+    {
+        std::vector<std::thread> workers;
+        for (std::uint32_t i = 1; i < std::min(threads, rangeCount); ++i)
+        {
+            workers.emplace_back([&verifyRanges]() {
+                beast::setCurrentThreadName("ShardFinalize");
+                verifyRanges();
+            });
+        }
+        verifyRanges();
+        for (auto& worker : workers)
+            worker.join();
+    }
 
-        pCache_->reset();
-        nCache_->reset();
-        fullBelowCache->reset();
-        treeNodeCache->reset();
+    resetCaches();
+
+    if (stop_)
+        return false;
+
+    if (failed)
+    {
+        hash = beast::zero;
+        ledgerSeq = 0;
+        return fail("failed to validate ledgers");
     }
 
     JLOG(j_.debug()) << "shard " << index_ << " is valid";
@@ -833,6 +1099,10 @@ Shard::finalize(
         if (!initSQLite(lock))
             return fail("failed to initialize SQLite databases");
 
+        // The filter is built from the verified SQLite databases, not
+        // taken from wherever the shard came from
+        remove_all(dir_ / accountFilterName);
+        initAccountFilter(lock);
         setFileStats(lock);
         lastAccess_ = std::chrono::steady_clock::now();
     }
@@ -843,10 +1113,181 @@ Shard::finalize(
             ". Error: " + e.what());
     }
 
+    pCache_->setTargetSize(finalCacheSize);
     state_ = final;
     return true;
 }
 
+bool
+Shard::exportTo(
+    boost::filesystem::path const& dstDir,
+    Scheduler& scheduler,
+    nudb::context& context)
+{
+    using namespace boost::filesystem;
+    std::uint32_t ledgerSeq{0};
+    auto fail = [&](std::string const& msg) {
+        JLOG(j_.error()) << "shard " << index_ << " export to " << dstDir
+                         << " failed. " << msg
+                         << (ledgerSeq == 0
+                                 ? ""
+                                 : ". Ledger sequence " +
+                                  std::to_string(ledgerSeq));
+        return false;
+    };
+
+    if (state_ != final)
+        return fail("shard is not final");
+
+    auto const scopedCount{makeBackendCount()};
+    if (!scopedCount)
+        return fail("failed to lock backend");
+
+    Section section{app_.config().section(ConfigSection::shardDatabase())};
+    std::string const type{get<std::string>(section, "type", "nudb")};
+    auto const factory{Manager::instance().find(type)};
+    if (!factory)
+        return fail("failed to find factory for " + type);
+    section.set("path", dstDir.string());
+
+    std::unique_ptr<Backend> dst;
+
+    // Copy the node objects of every ledger, returning an error message
+    // if the copy is incomplete
+    auto const copyNodeObjects = [&]() -> std::string {
+        // The final key isn't the hash of its data, so can't be verified
+        std::shared_ptr<NodeObject> finalObject;
+        if (backend_->fetch(finalKey.data(), &finalObject) != Status::ok)
+            return "missing final key";
+        dst->store(finalObject);
+
+        SerialIter sIt(
+            finalObject->getData().data(), finalObject->getData().size());
+        sIt.skip(3 * sizeof(std::uint32_t));
+        auto hash{sIt.get256()};
+
+        Config const& config{app_.config()};
+        auto& shardFamily{*app_.getShardFamily()};
+        auto const fullBelowCache{shardFamily.getFullBelowCache(lastSeq_)};
+        auto const treeNodeCache{shardFamily.getTreeNodeCache(lastSeq_)};
+        VerifiedNodes copied;
+        bool missing{false};
+        auto const copy = [&](SHAMapTreeNode const& node) {
+            if (stop_)
+                return false;
+            auto const& nodeHash{node.getHash().as_uint256()};
+            if (copied.insert(nodeHash))
+            {
+                if (auto const nodeObject{verifyFetch(nodeHash)})
+                    dst->store(nodeObject);
+                else
+                    missing = true;
+            }
+            return !missing;
+        };
+
+        // Walk the ledgers from child to parent, copying the nodes of
+        // each ledger which its child doesn't share
+        std::shared_ptr<Ledger const> next;
+        for (ledgerSeq = lastSeq_; ledgerSeq >= firstSeq_; --ledgerSeq)
+        {
+            auto const nodeObject{verifyFetch(hash)};
+            if (!nodeObject)
+                return "missing ledger";
+            dst->store(nodeObject);
+
+            auto ledger{std::make_shared<Ledger>(
+                deserializePrefixedHeader(nodeObject->getData()),
+                config,
+                shardFamily)};
+            auto const& info{ledger->info()};
+            if (info.seq != ledgerSeq || info.hash != hash)
+                return "invalid ledger";
+            ledger->stateMap().setLedgerSeq(ledgerSeq);
+            ledger->txMap().setLedgerSeq(ledgerSeq);
+            ledger->setImmutable(config);
+
+            if (!ledger->stateMap().fetchRoot(
+                    SHAMapHash{info.accountHash}, nullptr))
+            {
+                return "missing root STATE node";
+            }
+            if (next)
+                ledger->stateMap().visitDifferences(&next->stateMap(), copy);
+            else
+                ledger->stateMap().visitNodes(copy);
+
+            if (!missing && info.txHash.isNonZero())
+            {
+                if (!ledger->txMap().fetchRoot(
+                        SHAMapHash{info.txHash}, nullptr))
+                {
+                    return "missing root TXN node";
+                }
+                ledger->txMap().visitNodes(copy);
+            }
+
+            if (stop_)
+                return "stopping";
+            if (missing)
+                return "missing node object";
+
+            // Reset caches to reduce memory usage
+            if (ledgerSeq % 256 == 0)
+            {
+                fullBelowCache->reset();
+                treeNodeCache->reset();
+            }
+
+            hash = info.parentHash;
+            next = std::move(ledger);
+        }
+        ledgerSeq = 0;
+        return {};
+    };
+
+    std::string error;
+    try
+    {
+        if (!create_directories(dstDir))
+            return fail("failed to create directory");
+
+        dst = factory->createInstance(
+            NodeObject::keyBytes,
+            section,
+            megabytes(
+                app_.config().getValueFor(SizedItem::burstSize, boost::none)),
+            scheduler,
+            context,
+            j_);
+        dst->open(true);
+
+        error = copyNodeObjects();
+        dst->close();
+
+        // A final shard's SQLite databases are no longer written to
+        if (error.empty())
+        {
+            copy_file(dir_ / LgrDBName, dstDir / LgrDBName);
+            copy_file(dir_ / TxDBName, dstDir / TxDBName);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        error = std::string("Exception caught in function ") + __func__ +
+            ". Error: " + e.what();
+    }
+
+    if (error.empty())
+        return true;
+
+    // Leave no partial copy behind
+    dst.reset();
+    boost::system::error_code ec;
+    remove_all(dstDir, ec);
+    return fail(error);
+}
+
 bool
 Shard::open(std::lock_guard<std::mutex> const& lock)
 {
@@ -970,6 +1411,19 @@ Shard::open(std::lock_guard<std::mutex> const& lock)
             {
                 lastAccess_ = std::chrono::steady_clock::now();
                 state_ = final;
+
+                // A final shard is immutable, let the backend serve it
+                // read only. It is still readable if the backend fails to.
+                try
+                {
+                    backend_->setReadOnly();
+                }
+                catch (std::exception const& e)
+                {
+                    JLOG(j_.warn()) << "shard " << index_
+                                    << " unable to open read only: "
+                                    << e.what();
+                }
             }
             else
                 state_ = complete;
@@ -987,12 +1441,16 @@ Shard::open(std::lock_guard<std::mutex> const& lock)
     auto const age{
         std::chrono::seconds{config.getValueFor(SizedItem::nodeCacheAge, 0)}};
     auto const name{"shard " + std::to_string(index_)};
-    pCache_ = std::make_unique<PCache>(name, size, age, stopwatch(), j_);
+    pCache_ = std::make_unique<PCache>(
+        name, state_ == final ? finalCacheSize : size, age, stopwatch(), j_);
     nCache_ = std::make_unique<NCache>(name, stopwatch(), size, age);
 
     if (!initSQLite(lock))
         return fail({});
 
+    if (state_ == final && !accountFilter_)
+        initAccountFilter(lock);
+
     setFileStats(lock);
     return true;
 }
@@ -1071,6 +1529,63 @@ Shard::initSQLite(std::lock_guard<std::mutex> const&)
     return true;
 }
 
+void
+Shard::initAccountFilter(std::lock_guard<std::mutex> const&)
+{
+    auto const path{dir_ / accountFilterName};
+    if (boost::filesystem::exists(path))
+    {
+        boost::system::error_code ec;
+        auto const data{getFileContents(ec, path)};
+        if (!ec)
+        {
+            accountFilter_ = KeyFilter::fromBlob(makeSlice(data));
+            if (accountFilter_)
+                return;
+        }
+        JLOG(j_.warn()) << "shard " << index_ << " account filter unreadable";
+    }
+
+    try
+    {
+        std::vector<AccountID> accounts;
+        {
+            auto db{txSQLiteDB_->checkoutDb()};
+            soci::rowset<std::string> rs =
+                (db->prepare
+                 << "SELECT DISTINCT Account FROM AccountTransactions;");
+            for (auto const& s : rs)
+            {
+                if (auto const account{parseBase58<AccountID>(s)})
+                    accounts.push_back(*account);
+            }
+        }
+
+        // About ten bits for each account keeps false positives near 1%
+        auto filter{std::make_unique<KeyFilter>(accounts.size() * 10 / 8)};
+        for (auto const& account : accounts)
+            filter->insert(accountFilterKey(account));
+
+        auto const blob{filter->toBlob()};
+        boost::system::error_code ec;
+        writeFileContents(ec, path, std::string(blob.begin(), blob.end()));
+        if (ec)
+        {
+            JLOG(j_.warn()) << "shard " << index_
+                            << " unable to save account filter: "
+                            << ec.message();
+        }
+        accountFilter_ = std::move(filter);
+    }
+    catch (std::exception const& e)
+    {
+        // Without a filter the shard is always searched
+        JLOG(j_.error()) << "shard " << index_
+                         << ". Exception caught in function " << __func__
+                         << ". Error: " << e.what();
+    }
+}
+
 bool
 Shard::storeSQLite(
     std::shared_ptr<Ledger const> const& ledger,
@@ -1266,10 +1781,22 @@ Shard::setFileStats(std::lock_guard<std::mutex> const&)
     }
 }
 
+bool
+Shard::VerifiedNodes::insert(uint256 const& hash)
+{
+    // Node hashes are uniformly distributed, so any byte picks a partition
+    auto& partition{partitions_[hash.data()[0] % partitionCount]};
+    std::lock_guard lock(partition.mutex);
+    if (partition.hashes.size() >= maxPartitionSize)
+        partition.hashes.clear();
+    return partition.hashes.insert(hash).second;
+}
+
 bool
 Shard::verifyLedger(
     std::shared_ptr<Ledger const> const& ledger,
-    std::shared_ptr<Ledger const> const& next) const
+    std::shared_ptr<Ledger const> const& next,
+    VerifiedNodes& verified) const
 {
     auto fail = [j = j_, index = index_, &ledger](std::string const& msg) {
         JLOG(j.error()) << "shard " << index << ". " << msg
@@ -1288,10 +1815,11 @@ Shard::verifyLedger(
         return fail("Invalid ledger account hash");
 
     bool error{false};
-    auto visit = [this, &error](SHAMapTreeNode const& node) {
+    auto visit = [this, &error, &verified](SHAMapTreeNode const& node) {
         if (stop_)
             return false;
-        if (!verifyFetch(node.getHash().as_uint256()))
+        auto const& hash{node.getHash().as_uint256()};
+        if (verified.insert(hash) && !verifyFetch(hash))
             error = true;
         return !error;
     };
@@ -1361,12 +1889,12 @@ Shard::verifyFetch(uint256 const& hash) const
 
     try
     {
-        switch (backend_->fetch(hash.data(), &nodeObject))
+        switch (fetchBackend(hash, &nodeObject))
         {
             case ok:
                 // Verify that the hash of node object matches the payload
                 if (nodeObject->getHash() !=
-                    sha512Half(makeSlice(nodeObject->getData())))
+                    sha512Half(nodeObject->getData()))
                     return fail("Node object hash does not match payload");
                 return nodeObject;
             case notFound:
@@ -1385,6 +1913,42 @@ Shard::verifyFetch(uint256 const& hash) const
     }
 }
 
+Status
+Shard::fetchBackend(
+    uint256 const& hash,
+    std::shared_ptr<NodeObject>* nodeObject) const
+{
+    auto status{backend_->fetch(hash.data(), nodeObject)};
+    if (status == notFound && base_)
+        status = base_->fetch(hash.data(), nodeObject);
+    return status;
+}
+
+void
+Shard::storeBackend(Batch const& batch)
+{
+    if (!base_)
+    {
+        backend_->storeBatch(batch);
+        return;
+    }
+
+    Batch own;
+    Batch shared;
+    for (auto const& nodeObject : batch)
+    {
+        if (nodeObject->getType() == hotACCOUNT_NODE)
+            shared.push_back(nodeObject);
+        else
+            own.push_back(nodeObject);
+    }
+
+    if (!own.empty())
+        backend_->storeBatch(own);
+    if (!shared.empty())
+        base_->storeBatch(shared);
+}
+
 Shard::Count
 Shard::makeBackendCount()
 {
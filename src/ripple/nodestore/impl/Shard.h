@@ -23,14 +23,19 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/basics/RangeSet.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/nodestore/Scheduler.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <ripple/protocol/AccountID.h>
 
 #include <boost/filesystem.hpp>
 #include <nudb/nudb.hpp>
 
+#include <array>
 #include <atomic>
+#include <mutex>
 #include <tuple>
 
 namespace ripple {
@@ -82,9 +87,14 @@ public:
 
         @param scheduler The scheduler to use for performing asynchronous tasks.
         @param context The context to use for the backend.
+        @param base The store shared by shards for account state nodes,
+        can be null.
     */
     [[nodiscard]] bool
-    init(Scheduler& scheduler, nudb::context& context);
+    init(
+        Scheduler& scheduler,
+        nudb::context& context,
+        std::shared_ptr<Backend> base);
 
     /** Returns true if the database are open.
      */
@@ -115,6 +125,12 @@ public:
     [[nodiscard]] std::shared_ptr<NodeObject>
     fetchNodeObject(uint256 const& hash, FetchReport& fetchReport);
 
+    /** Fetch a group of node objects, with a single backend request for
+        those which are not cached.
+    */
+    [[nodiscard]] std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(std::vector<uint256> const& hashes, FetchReport& fetchReport);
+
     [[nodiscard]] bool
     fetchNodeObjectFromCache(
         uint256 const& hash,
@@ -144,6 +160,23 @@ public:
     [[nodiscard]] bool
     containsLedger(std::uint32_t ledgerSeq) const;
 
+    /** Returns `false` if no transaction in the shard affects `account`.
+
+        Only a final shard knows the accounts its transactions affect, so
+        any other shard returns `true`.
+    */
+    [[nodiscard]] bool
+    mayContainAccount(AccountID const& account) const;
+
+    /** Invoke a callback on the transaction SQLite database.
+
+        The shard is kept open while the callback runs.
+
+        @return false if the shard has no transaction database.
+    */
+    bool
+    callForTransactionSQL(std::function<void(DatabaseCon&)> const& callback);
+
     void
     sweep();
 
@@ -194,11 +227,29 @@ public:
         verified backend data.
         @param referenceHash If present, this hash must match the hash
         of the last ledger in the shard.
+        @param threads The number of threads verifying ledgers.
     */
     [[nodiscard]] bool
     finalize(
         bool const writeSQLite,
-        boost::optional<uint256> const& referenceHash);
+        boost::optional<uint256> const& referenceHash,
+        std::uint32_t const threads = 1);
+
+    /** Write a self-contained copy of a final shard to a new directory.
+
+        Every node object the shard's ledgers need is copied, including
+        those kept in the shared base store, along with the SQLite
+        databases, so the copy may be imported by another server.
+
+        @param dstDir The directory to create the copy in.
+        @param scheduler The scheduler to use for the copy's backend.
+        @param context The context to use for the copy's backend.
+    */
+    [[nodiscard]] bool
+    exportTo(
+        boost::filesystem::path const& dstDir,
+        Scheduler& scheduler,
+        nudb::context& context);
 
     /** Enables removal of the shard directory on destruction.
      */
@@ -211,6 +262,11 @@ public:
     // Current shard version
     static constexpr std::uint32_t version{2};
 
+    // The target size of the positive cache of a final shard. The shard
+    // store caches objects read from final shards in a cache they share,
+    // so each keeps only a few of its own.
+    static constexpr int finalCacheSize{1024};
+
     // The finalKey is a hard coded value of zero. It is used to store
     // finalizing shard data to the backend. The data contains a version,
     // last ledger's hash, and the first and last ledger sequences.
@@ -296,6 +352,11 @@ private:
     // NuDB key/value store for node objects
     std::unique_ptr<Backend> backend_;
 
+    // The store shared by all shards for account state nodes, which are
+    // often the same in many ledgers and so in many shards. Null unless
+    // a base path is configured.
+    std::shared_ptr<Backend> base_;
+
     std::atomic<std::uint32_t> backendCount_{0};
 
     // Ledger SQLite database used for indexes
@@ -304,6 +365,11 @@ private:
     // Transaction SQLite database used for indexes
     std::unique_ptr<DatabaseCon> txSQLiteDB_;
 
+    // The accounts affected by the transactions of a final shard. It is
+    // kept while the shard is closed, so the shard need not be opened to
+    // learn it holds nothing for an account.
+    std::unique_ptr<KeyFilter> accountFilter_;
+
     // Tracking information used only when acquiring a shard from the network.
     // If the shard is final, this member will be null.
     std::unique_ptr<AcquireInfo> acquireInfo_;
@@ -332,6 +398,12 @@ private:
     [[nodiscard]] bool
     initSQLite(std::lock_guard<std::mutex> const&);
 
+    // Load the account filter of a final shard, building and saving it
+    // from the transaction SQLite database if it wasn't saved before
+    // Lock over mutex_ required
+    void
+    initAccountFilter(std::lock_guard<std::mutex> const&);
+
     // Write SQLite entries for this ledger
     // Lock over mutex_ required
     [[nodiscard]] bool
@@ -339,16 +411,51 @@ private:
         std::shared_ptr<Ledger const> const& ledger,
         std::lock_guard<std::mutex> const&);
 
+    // Fetch a node object from the backend, or from the base store if the
+    // backend doesn't have it
+    Status
+    fetchBackend(uint256 const& hash, std::shared_ptr<NodeObject>* nodeObject)
+        const;
+
+    // Store node objects in the backend, or in the base store if they
+    // are account state nodes and there is one
+    void
+    storeBackend(Batch const& batch);
+
     // Set storage and file descriptor usage stats
     // Lock over mutex_ required
     void
     setFileStats(std::lock_guard<std::mutex> const&);
 
+    // The hashes of nodes already verified while finalizing, shared by
+    // the threads verifying ledgers. Bounded, so a node may be verified
+    // again once it has been forgotten.
+    class VerifiedNodes
+    {
+    public:
+        // Returns false if the node was already verified
+        bool
+        insert(uint256 const& hash);
+
+    private:
+        static constexpr std::size_t partitionCount{16};
+        static constexpr std::size_t maxPartitionSize{65536};
+
+        struct Partition
+        {
+            std::mutex mutex;
+            hash_set<uint256> hashes;
+        };
+
+        std::array<Partition, partitionCount> partitions_;
+    };
+
     // Validate this ledger by walking its SHAMaps and verifying Merkle trees
     [[nodiscard]] bool
     verifyLedger(
         std::shared_ptr<Ledger const> const& ledger,
-        std::shared_ptr<Ledger const> const& next) const;
+        std::shared_ptr<Ledger const> const& next,
+        VerifiedNodes& verified) const;
 
     // Fetches from backend and log errors based on status codes
     [[nodiscard]] std::shared_ptr<NodeObject>
@@ -20,6 +20,9 @@
 #ifndef RIPPLE_NODESTORE_TUNING_H_INCLUDED
 #define RIPPLE_NODESTORE_TUNING_H_INCLUDED
 
+#include <chrono>
+#include <cstddef>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -35,6 +38,22 @@ enum {
 // Expiration time for cached nodes
 std::chrono::seconds constexpr cacheTargetAge = std::chrono::minutes{5};
 
+// Minimum time between changes to the number of async read threads
+std::chrono::milliseconds constexpr readResizeInterval{100};
+
+// How long an async read thread may sit idle before it stops serving
+std::chrono::seconds constexpr readIdleTimeout{10};
+
+// Queued async reads per thread beyond which another thread is added
+std::size_t constexpr readQueuePerThread = 64;
+
+// Consecutive high priority async reads before a low priority one is let in
+int constexpr readHighBurst = 16;
+
+// Most async reads a thread takes at once when the backend reads a group
+// of keys concurrently
+std::size_t constexpr readBatchSize = 32;
+
 }  // namespace NodeStore
 }  // namespace ripple
 
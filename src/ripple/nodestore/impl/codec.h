@@ -26,6 +26,7 @@
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
 #include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/varint.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <cstddef>
@@ -84,6 +85,78 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     return result;
 }
 
+/*  The payload of an object compressed with a dictionary is the id of the
+    dictionary, the uncompressed size as a varint and the lz4 block.
+
+    The dictionary passed in is used when its id matches; otherwise the
+    dictionary is looked up among all those registered.
+*/
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary)
+{
+    using namespace nudb::detail;
+    if (in_size < field<std::uint32_t>::size)
+        Throw<std::runtime_error>("lz4 dictionary decompress: short header");
+    std::uint32_t id;
+    {
+        istream is(in, in_size);
+        read<std::uint32_t>(is, id);
+    }
+    std::shared_ptr<CompressionDictionary const> found;
+    if (!dictionary || dictionary->id() != id)
+    {
+        found = CompressionDictionary::find(id);
+        if (!found)
+            Throw<std::runtime_error>(
+                "lz4 dictionary decompress: unknown dictionary " +
+                std::to_string(id));
+        dictionary = found.get();
+    }
+    std::uint8_t const* p =
+        reinterpret_cast<std::uint8_t const*>(in) + field<std::uint32_t>::size;
+    in_size -= field<std::uint32_t>::size;
+    std::pair<void const*, std::size_t> result;
+    auto const n = read_varint(p, in_size, result.second);
+    if (n == 0)
+        Throw<std::runtime_error>("lz4 dictionary decompress: n == 0");
+    void* const out = bf(result.second);
+    result.first = out;
+    dictionary->decompress(Slice(p + n, in_size - n), out, result.second);
+    return result;
+}
+
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const& dictionary)
+{
+    using namespace nudb::detail;
+    std::pair<void const*, std::size_t> result;
+    std::array<std::uint8_t, varint_traits<std::size_t>::max> vi;
+    auto const n = write_varint(vi.data(), in_size);
+    auto const hs = field<std::uint32_t>::size + n;
+    auto const out_max = CompressionDictionary::compressBound(in_size);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(bf(hs + out_max));
+    result.first = out;
+    {
+        ostream os(out, field<std::uint32_t>::size);
+        write<std::uint32_t>(os, dictionary.id());
+    }
+    std::memcpy(out + field<std::uint32_t>::size, vi.data(), n);
+    auto const out_size =
+        dictionary.compress(Slice(in, in_size), out + hs, out_max);
+    result.second = hs + out_size;
+    return result;
+}
+
 //------------------------------------------------------------------------------
 
 /*
@@ -93,11 +166,16 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = lz4 compressed with a dictionary
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary = nullptr)
 {
     using namespace nudb::detail;
 
@@ -191,6 +269,11 @@ nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
             write(os, is(512), 512);
             break;
         }
+        case 4:  // lz4 with a dictionary
+        {
+            result = lz4_dict_decompress(p, in_size, bf, dictionary);
+            break;
+        }
         default:
             Throw<std::runtime_error>(
                 "nodeobject codec: bad type=" + std::to_string(type));
@@ -206,9 +289,18 @@ zero32()
     return v.data();
 }
 
+/** Compress a node object.
+
+    Inner nodes always use their own codec. Other objects are compressed
+    with lz4, against `dictionary` if one is provided.
+*/
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -272,7 +364,7 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
     std::array<std::uint8_t, varint_traits<std::size_t>::max> vi;
 
-    constexpr std::size_t codecType = 1;
+    std::size_t const codecType = dictionary ? 4 : 1;
     auto const vn = write_varint(vi.data(), codecType);
     std::pair<void const*, std::size_t> result;
     switch (codecType)
@@ -291,6 +383,22 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
             result.second = vn + lzr.second;
             break;
         }
+        case 4:  // lz4 with a dictionary
+        {
+            std::uint8_t* p;
+            auto const lzr = NodeStore::lz4_dict_compress(
+                in,
+                in_size,
+                [&p, &vn, &bf](std::size_t n) {
+                    p = reinterpret_cast<std::uint8_t*>(bf(vn + n));
+                    return p + vn;
+                },
+                *dictionary);
+            std::memcpy(p, vi.data(), vn);
+            result.first = p;
+            result.second = vn + lzr.second;
+            break;
+        }
         default:
             Throw<std::logic_error>(
                 "nodeobject codec: unknown=" + std::to_string(codecType));
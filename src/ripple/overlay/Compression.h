@@ -22,6 +22,7 @@
 
 #include <ripple/basics/CompressionAlgorithms.h>
 #include <ripple/basics/Log.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <lz4frame.h>
 
 namespace ripple {
@@ -33,7 +34,21 @@ std::size_t constexpr headerBytesCompressed = 10;
 
 // All values other than 'none' must have the high bit. The low order four bits
 // must be 0.
-enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90 };
+enum class Algorithm : std::uint8_t {
+    None = 0x00,
+    LZ4 = 0x90,
+    // LZ4 against the dictionary the peers agreed on in the handshake
+    LZ4Dictionary = 0xA0
+};
+
+/** A dictionary shared by both ends of a link.
+
+    Small consensus messages carry little repetition of their own, but
+    have most of their structure in common with each other. The node
+    store's dictionary codec compresses them against a pre-shared
+    dictionary of the byte strings they typically contain.
+*/
+using Dictionary = NodeStore::CompressionDictionary;
 
 enum class Compressed : std::uint8_t { On, Off };
 
@@ -43,6 +58,7 @@ enum class Compressed : std::uint8_t { On, Off };
  * @param inSize Size of compressed data
  * @param decompressed Buffer to hold decompressed message
  * @param algorithm Compression algorithm type
+ * @param dictionary Dictionary for Algorithm::LZ4Dictionary
  * @return Size of decompressed data or zero if failed to decompress
  */
 template <typename InputStream>
@@ -52,13 +68,23 @@ decompress(
     std::size_t inSize,
     std::uint8_t* decompressed,
     std::size_t decompressedSize,
-    Algorithm algorithm = Algorithm::LZ4)
+    Algorithm algorithm = Algorithm::LZ4,
+    Dictionary const* dictionary = nullptr)
 {
     try
     {
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Decompress(
                 in, inSize, decompressed, decompressedSize);
+        else if (algorithm == Algorithm::LZ4Dictionary && dictionary)
+        {
+            std::vector<std::uint8_t> compressed;
+            auto const data = ripple::compression_algorithms::readContiguous(
+                in, inSize, compressed);
+            dictionary->decompress(
+                Slice(data, inSize), decompressed, decompressedSize);
+            return decompressedSize;
+        }
         else
         {
             JLOG(debugLog().warn())
@@ -80,6 +106,7 @@ decompress(
  * @param inSize Size of the data
  * @param bf Compressed buffer allocator
  * @param algorithm Compression algorithm type
+ * @param dictionary Dictionary for Algorithm::LZ4Dictionary
  * @return Size of compressed data, or zero if failed to compress
  */
 template <class BufferFactory>
@@ -88,13 +115,20 @@ compress(
     void const* in,
     std::size_t inSize,
     BufferFactory&& bf,
-    Algorithm algorithm = Algorithm::LZ4)
+    Algorithm algorithm = Algorithm::LZ4,
+    Dictionary const* dictionary = nullptr)
 {
     try
     {
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Compress(
                 in, inSize, std::forward<BufferFactory>(bf));
+        else if (algorithm == Algorithm::LZ4Dictionary && dictionary)
+        {
+            auto const outSize = Dictionary::compressBound(inSize);
+            return dictionary->compress(
+                Slice(in, inSize), bf(outSize), outSize);
+        }
         else
         {
             JLOG(debugLog().warn()) << "compress: invalid compression algorithm"
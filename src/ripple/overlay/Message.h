@@ -53,6 +53,20 @@ class Message : public std::enable_shared_from_this<Message>
     using Algorithm = compression::Algorithm;
 
 public:
+    /** How urgently a message is sent, most urgent first.
+
+        A peer's queued messages go out in this order, so consensus traffic
+        never waits behind ledger data being downloaded from us.
+    */
+    enum class Priority : std::uint8_t {
+        consensus,  // proposals, validations and other consensus traffic
+        normal,     // everything else
+        bulk        // replies carrying ledger and shard data
+    };
+
+    /** The number of priorities. */
+    static constexpr std::size_t priorities = 3;
+
     /** Constructor
      * @param message Protocol message to serialize
      * @param type Protocol message type
@@ -64,6 +78,8 @@ public:
         int type,
         boost::optional<PublicKey> const& validator = {});
 
+    ~Message();
+
     /** Retrieve the size of the packed but uncompressed message data. */
     std::size_t
     getBufferSize();
@@ -72,10 +88,15 @@ public:
      * the message is not compressible then the uncompressed buffer is returned.
      * @param compressed Request compressed (Compress::On) or
      *     uncompressed (Compress::Off) payload buffer
+     * @param dictionary If set, the dictionary negotiated with the peer.
+     *     Consensus messages are compressed with it when that helps. A
+     *     message is compressed with the first dictionary it is given.
      * @return Payload buffer
      */
     std::vector<uint8_t> const&
-    getBuffer(Compressed tryCompressed);
+    getBuffer(
+        Compressed tryCompressed,
+        compression::Dictionary const* dictionary = nullptr);
 
     /** Get the traffic category */
     std::size_t
@@ -91,12 +112,23 @@ public:
         return validatorKey_;
     }
 
+    /** Get the priority, which follows from the message type */
+    Priority
+    getPriority() const
+    {
+        return priority_;
+    }
+
 private:
     std::vector<uint8_t> buffer_;
     std::vector<uint8_t> bufferCompressed_;
+    std::vector<uint8_t> bufferDictionary_;
     std::size_t category_;
     std::once_flag once_flag_;
+    std::once_flag dictionaryOnce_;
+    std::uint32_t dictionaryId_ = 0;
     boost::optional<PublicKey> validatorKey_;
+    Priority priority_;
 
     /** Set the payload header
      * @param in Pointer to the payload
@@ -121,6 +153,13 @@ private:
     void
     compress();
 
+    /** Try to compress the payload with a dictionary.
+     * Only consensus messages, which are small and similar to each other,
+     * are compressed this way.
+     */
+    void
+    compressWithDictionary(compression::Dictionary const& dictionary);
+
     /** Get the message type from the payload header.
      * First four bytes are the compression/algorithm flag and the payload size.
      * Next two bytes are the message type
@@ -77,6 +77,18 @@ public:
         std::uint32_t crawlOptions = 0;
         boost::optional<std::uint32_t> networkID;
         bool vlEnabled = true;
+        // Large replies at least this size are decoded off the peer's
+        // strand. Zero decodes everything on the strand.
+        std::size_t parallelDecodeBytes = 0;
+        // Where the dictionary for compressing consensus messages is
+        // kept, or empty to use none.
+        std::string compressionDictionary;
+        // The kernel send buffer size for peer connections in bytes, or
+        // zero to use the system default.
+        std::size_t sendBuffer = 0;
+        // Whether to share the results of checking transaction signatures
+        // with the members of our cluster, and use theirs.
+        bool clusterVerdicts = false;
     };
 
     using PeerSequence = std::vector<std::shared_ptr<Peer>>;
@@ -114,6 +126,13 @@ public:
     virtual Json::Value
     json() = 0;
 
+    /** Return histograms of how long peer messages wait for and take to
+        be handled, by traffic category, and of peers' send queue depths
+        and write latency.
+    */
+    virtual Json::Value
+    trafficJson() const = 0;
+
     /** Returns a sequence representing the current list of peers.
         The snapshot is made at the time of the call.
     */
@@ -166,6 +185,22 @@ public:
         uint256 const& uid,
         PublicKey const& validator) = 0;
 
+    /** Relay a transaction.
+     * Peers which support it may be sent only the hash of the transaction,
+     * and request the transaction if they have not seen it.
+     * @param m the serialized transaction
+     * @param uid the id of the transaction
+     * @param toSkip the peers which have already sent us this transaction
+     * @param source the key of the transaction's signer, if any, which
+     *     peers may squelch
+     */
+    virtual void
+    relay(
+        protocol::TMTransaction& m,
+        uint256 const& uid,
+        std::set<Peer::id_t> const& toSkip,
+        boost::optional<PublicKey> const& source) = 0;
+
     /** Visit every active peer.
      *
      * The visitor must be invocable as:
@@ -37,6 +37,10 @@ static constexpr std::uint32_t csHopLimit = 3;
 
 enum class ProtocolFeature {
     ValidatorListPropagation,
+    // Transactions may be announced by hash and requested when unknown
+    TxReduceRelay,
+    // The changed state nodes of a ledger may be requested in one message
+    LedgerDelta,
 };
 
 /** Represents a peer connection in the overlay. */
@@ -64,6 +64,23 @@ epoch(TP const& t)
     return duration_cast<Unit>(t.time_since_epoch());
 }
 
+/** Return the name of a message type which selects peers, for logging */
+inline char const*
+messageName(protocol::MessageType type)
+{
+    switch (type)
+    {
+        case protocol::mtVALIDATION:
+            return "validation";
+        case protocol::mtPROPOSE_LEDGER:
+            return "proposal";
+        case protocol::mtTRANSACTION:
+            return "transaction";
+        default:
+            return "unknown";
+    }
+}
+
 /** Abstract class. Declares squelch and unsquelch handlers.
  * OverlayImpl inherits from this class. Motivation is
  * for easier unit tests to facilitate on the fly
@@ -136,8 +153,8 @@ private:
      * state.
      * @param validator Public key of the source validator
      * @param id Peer id which received the message
-     * @param type  Message type (Validation and Propose Set only,
-     *     others are ignored, future use)
+     * @param type  Message type (Validation, Propose Set, or Transaction;
+     *     used for logging)
      */
     void
     update(PublicKey const& validator, id_t id, protocol::MessageType type);
@@ -287,7 +304,7 @@ Slot<clock_type>::update(
         << static_cast<int>(peer.state) << " count " << peer.count << " last "
         << duration_cast<milliseconds>(now - peer.lastMessage).count()
         << " pool " << considered_.size() << " threshold " << reachedThreshold_
-        << " " << (type == protocol::mtVALIDATION ? "validation" : "proposal");
+        << " " << messageName(type);
 
     peer.lastMessage = now;
 
@@ -505,6 +522,8 @@ Slot<clock_type>::getPeers() const
 /** Slots is a container for validator's Slot and handles Slot update
  * when a message is received from a validator. It also handles Slot aging
  * and checks for peers which are disconnected or stopped relaying the messages.
+ * Transactions are selected the same way, with a Slot for each signing key
+ * that the transactions are relayed from.
  */
 template <typename clock_type>
 class Slots final
@@ -23,6 +23,8 @@
 #include <ripple/basics/random.h>
 #include <ripple/overlay/SquelchCommon.h>
 #include <ripple/protocol/PublicKey.h>
+#include <ripple/protocol/STTx.h>
+#include <boost/optional.hpp>
 
 #include <chrono>
 #include <functional>
@@ -115,6 +117,20 @@ Squelch<clock_type>::getSquelchDuration()
     return d;
 }
 
+/** Return the key transactions are squelched by: the signer's public key.
+ * Multi-signed transactions don't have one and are never squelched.
+ * @param tx The transaction
+ * @return The signing public key if the transaction is single-signed
+ */
+inline boost::optional<PublicKey>
+transactionSource(STTx const& tx)
+{
+    auto const signingKey = tx.getSigningPubKey();
+    if (!publicKeyType(makeSlice(signingKey)))
+        return boost::none;
+    return PublicKey(makeSlice(signingKey));
+}
+
 }  // namespace squelch
 
 }  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/make_SSLContext.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/overlay/Cluster.h>
 #include <ripple/overlay/impl/ConnectAttempt.h>
@@ -170,6 +171,13 @@ ConnectAttempt::onConnect(error_code ec)
 
     setTimer();
     stream_.set_verify_mode(boost::asio::ssl::verify_none);
+
+    // A peer we were connected to recently can skip the key exchange. The
+    // handshake's finished messages still differ, so the session signature
+    // exchanged afterwards is as fresh as it would be otherwise.
+    resumeSSLSession(
+        stream_.native_handle(),
+        beast::IPAddressConversion::from_asio(remote_endpoint_).to_string());
     stream_.async_handshake(
         boost::asio::ssl::stream_base::client,
         strand_.wrap(std::bind(
@@ -202,7 +210,9 @@ ConnectAttempt::onHandshake(error_code ec)
         return close();  // makeSharedValue logs
 
     req_ = makeRequest(
-        !overlay_.peerFinder().config().peerPrivate, app_.config().COMPRESSION);
+        !overlay_.peerFinder().config().peerPrivate,
+        app_.config().COMPRESSION,
+        overlay_.compressionDictionary());
 
     buildHandshake(
         req_,
@@ -282,7 +292,10 @@ ConnectAttempt::onShutdown(error_code ec)
 //--------------------------------------------------------------------------
 
 auto
-ConnectAttempt::makeRequest(bool crawl, bool compressionEnabled) -> request_type
+ConnectAttempt::makeRequest(
+    bool crawl,
+    bool compressionEnabled,
+    compression::Dictionary const* dictionary) -> request_type
 {
     request_type m;
     m.method(boost::beast::http::verb::get);
@@ -294,7 +307,11 @@ ConnectAttempt::makeRequest(bool crawl, bool compressionEnabled) -> request_type
     m.insert("Connect-As", "Peer");
     m.insert("Crawl", crawl ? "public" : "private");
     if (compressionEnabled)
+    {
         m.insert("X-Offer-Compression", "lz4");
+        if (dictionary)
+            offerCompressionDictionary(m, *dictionary);
+    }
     return m;
 }
 
@@ -106,7 +106,10 @@ private:
     onShutdown(error_code ec);
 
     static request_type
-    makeRequest(bool crawl, bool compressionEnabled);
+    makeRequest(
+        bool crawl,
+        bool compressionEnabled,
+        compression::Dictionary const* dictionary);
 
     void
     processResponse();
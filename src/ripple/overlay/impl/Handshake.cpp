@@ -291,4 +291,32 @@ verifyHandshake(
     return publicKey;
 }
 
+void
+offerCompressionDictionary(
+    boost::beast::http::fields& h,
+    compression::Dictionary const& dictionary)
+{
+    h.insert("X-Compression-Dictionary", std::to_string(dictionary.id()));
+}
+
+compression::Dictionary const*
+negotiateCompressionDictionary(
+    boost::beast::http::fields const& headers,
+    compression::Dictionary const* dictionary)
+{
+    if (!dictionary)
+        return nullptr;
+
+    auto const iter = headers.find("X-Compression-Dictionary");
+    if (iter == headers.end())
+        return nullptr;
+
+    std::uint32_t id;
+    if (!beast::lexicalCastChecked(id, iter->value().to_string()) ||
+        id != dictionary->id())
+        return nullptr;
+
+    return dictionary;
+}
+
 }  // namespace ripple
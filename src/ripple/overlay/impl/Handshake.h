@@ -22,6 +22,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/overlay/Compression.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/context.hpp>
@@ -82,6 +83,27 @@ verifyHandshake(
     beast::IP::Address remote,
     Application& app);
 
+/** Name our compression dictionary in the handshake. */
+void
+offerCompressionDictionary(
+    boost::beast::http::fields& h,
+    compression::Dictionary const& dictionary);
+
+/** Return the compression dictionary to use on a link.
+
+    Each side names the dictionary it has, if any, in the handshake.
+    Consensus messages are compressed with it only if both sides named
+    the same one.
+
+    @param headers The handshake headers received from the peer.
+    @param dictionary Our dictionary, if any.
+    @return The dictionary, or nullptr if the peer named another one.
+*/
+compression::Dictionary const*
+negotiateCompressionDictionary(
+    boost::beast::http::fields const& headers,
+    compression::Dictionary const* dictionary);
+
 }  // namespace ripple
 
 #endif
@@ -17,18 +17,44 @@
 */
 //==============================================================================
 
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/impl/TrafficCount.h>
 #include <cstdint>
+#include <functional>
 
 namespace ripple {
 
+static Message::Priority
+prioritize(int type)
+{
+    switch (type)
+    {
+        case protocol::mtPING:
+        case protocol::mtPROPOSE_LEDGER:
+        case protocol::mtSTATUS_CHANGE:
+        case protocol::mtHAVE_SET:
+        case protocol::mtVALIDATION:
+        case protocol::mtSQUELCH:
+            return Message::Priority::consensus;
+        case protocol::mtLEDGER_DATA:
+        case protocol::mtGET_OBJECTS:
+        case protocol::mtSHARD_INFO:
+        case protocol::mtPEER_SHARD_INFO:
+            return Message::Priority::bulk;
+        default:
+            break;
+    }
+    return Message::Priority::normal;
+}
+
 Message::Message(
     ::google::protobuf::Message const& message,
     int type,
     boost::optional<PublicKey> const& validator)
     : category_(TrafficCount::categorize(message, type, false))
     , validatorKey_(validator)
+    , priority_(prioritize(type))
 {
     using namespace ripple::compression;
 
@@ -46,6 +72,17 @@ Message::Message(
 
     if (messageBytes != 0)
         message.SerializeToArray(buffer_.data() + headerBytes, messageBytes);
+
+    MemoryUsage::allocate(
+        MemoryTag::message, sizeof(Message) + buffer_.capacity());
+}
+
+Message::~Message()
+{
+    MemoryUsage::deallocate(
+        MemoryTag::message,
+        sizeof(Message) + buffer_.capacity() + bufferCompressed_.capacity() +
+            bufferDictionary_.capacity());
 }
 
 void
@@ -68,6 +105,7 @@ Message::compress()
             case protocol::mtLEDGER_DATA:
             case protocol::mtGET_OBJECTS:
             case protocol::mtVALIDATORLIST:
+            case protocol::mtTRANSACTIONS:
                 return true;
             case protocol::mtPING:
             case protocol::mtCLUSTER:
@@ -79,6 +117,9 @@ Message::compress()
             case protocol::mtSHARD_INFO:
             case protocol::mtGET_PEER_SHARD_INFO:
             case protocol::mtPEER_SHARD_INFO:
+            case protocol::mtHAVE_TRANSACTIONS:
+            case protocol::mtGET_LEDGER_DELTA:
+            case protocol::mtTRANSACTION_VERDICTS:
                 break;
         }
         return false;
@@ -109,9 +150,57 @@ Message::compress()
         }
         else
             bufferCompressed_.resize(0);
+
+        MemoryUsage::allocate(
+            MemoryTag::message, bufferCompressed_.capacity());
     }
 }
 
+void
+Message::compressWithDictionary(compression::Dictionary const& dictionary)
+{
+    using namespace ripple::compression;
+    auto const messageBytes = buffer_.size() - headerBytes;
+    auto const type = getType(buffer_.data());
+
+    switch (type)
+    {
+        case protocol::mtVALIDATION:
+        case protocol::mtPROPOSE_LEDGER:
+        case protocol::mtTRANSACTION:
+            break;
+        default:
+            return;
+    }
+
+    auto const compressedSize = ripple::compression::compress(
+        buffer_.data() + headerBytes,
+        messageBytes,
+        [&](std::size_t inSize) {  // size of required compressed buffer
+            bufferDictionary_.resize(inSize + headerBytesCompressed);
+            return (bufferDictionary_.data() + headerBytesCompressed);
+        },
+        Algorithm::LZ4Dictionary,
+        &dictionary);
+
+    if (compressedSize != 0 &&
+        compressedSize < (messageBytes - (headerBytesCompressed - headerBytes)))
+    {
+        bufferDictionary_.resize(headerBytesCompressed + compressedSize);
+        setHeader(
+            bufferDictionary_.data(),
+            compressedSize,
+            type,
+            Algorithm::LZ4Dictionary,
+            messageBytes);
+        dictionaryId_ = dictionary.id();
+    }
+    else
+        bufferDictionary_.resize(0);
+
+    MemoryUsage::allocate(MemoryTag::message, bufferDictionary_.capacity());
+}
+
 /** Set payload header
 
     The header is a variable-sized structure that contains information about
@@ -184,11 +273,25 @@ Message::getBufferSize()
 }
 
 std::vector<uint8_t> const&
-Message::getBuffer(Compressed tryCompressed)
+Message::getBuffer(
+    Compressed tryCompressed,
+    compression::Dictionary const* dictionary)
 {
     if (tryCompressed == Compressed::Off)
         return buffer_;
 
+    if (dictionary)
+    {
+        std::call_once(
+            dictionaryOnce_,
+            &Message::compressWithDictionary,
+            this,
+            std::cref(*dictionary));
+
+        if (!bufferDictionary_.empty() && dictionaryId_ == dictionary->id())
+            return bufferDictionary_;
+    }
+
     std::call_once(once_flag_, &Message::compress, this);
 
     if (bufferCompressed_.size() > 0)
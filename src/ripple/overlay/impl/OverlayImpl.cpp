@@ -22,8 +22,10 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/misc/ValidatorSite.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/base64.h>
 #include <ripple/basics/make_SSLContext.h>
+#include <ripple/basics/random.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/DatabaseShard.h>
@@ -37,6 +39,7 @@
 #include <ripple/server/SimpleWriter.h>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/utility/in_place_factory.hpp>
 
 namespace ripple {
@@ -98,7 +101,9 @@ OverlayImpl::Timer::on_timer(error_code ec)
 
     overlay_.m_peerFinder->once_per_second();
     overlay_.sendEndpoints();
+    overlay_.sendTxQueue();
     overlay_.autoConnect();
+    overlay_.ledgerReplies_.sweep();
 
     if ((overlay_.timer_count_ % Tuning::checkIdlePeers) == 0)
         overlay_.deleteIdlePeers();
@@ -140,6 +145,12 @@ OverlayImpl::OverlayImpl(
     , next_id_(1)
     , timer_count_(0)
     , slots_(app, *this)
+    , ledgerReplies_(
+          "LedgerReplies",
+          Tuning::ledgerReplyCacheSize,
+          Tuning::ledgerReplyCacheAge,
+          stopwatch(),
+          app_.journal("TaggedCache"))
     , m_stats(
           std::bind(&OverlayImpl::collect_metrics, this),
           collector,
@@ -156,6 +167,17 @@ OverlayImpl::OverlayImpl(
           }())
 {
     beast::PropertyStream::Source::add(m_peerFinder.get());
+
+    if (!setup_.compressionDictionary.empty() &&
+        boost::filesystem::exists(setup_.compressionDictionary))
+    {
+        auto const dictionary =
+            compression::Dictionary::load(setup_.compressionDictionary);
+        JLOG(journal_.info())
+            << "Using compression dictionary " << dictionary->id() << " from "
+            << setup_.compressionDictionary;
+        dictionary_ = dictionary.get();
+    }
 }
 
 OverlayImpl::~OverlayImpl()
@@ -455,6 +477,7 @@ OverlayImpl::add_active(std::shared_ptr<PeerImp> const& peer)
         assert(result.second);
         (void)result.second;
     }
+    updateActive();
 
     list_.emplace(peer.get(), peer);
 
@@ -544,7 +567,8 @@ OverlayImpl::onPrepare()
         });
 
     // Add the ips_fixed from the rippled.cfg file
-    if (!app_.config().standalone() && !app_.config().IPS_FIXED.empty())
+    if (!app_.config().standalone() && !app_.config().reporting() &&
+        !app_.config().IPS_FIXED.empty())
     {
         m_resolver.resolve(
             app_.config().IPS_FIXED,
@@ -634,6 +658,7 @@ OverlayImpl::activate(std::shared_ptr<PeerImp> const& peer)
             std::make_tuple(peer)));
         assert(result.second);
         (void)result.second;
+        updateActive();
     }
 
     JLOG(journal_.debug()) << "activated " << peer->getRemoteAddress() << " ("
@@ -651,6 +676,20 @@ OverlayImpl::onPeerDeactivate(Peer::id_t id)
 {
     std::lock_guard lock(mutex_);
     ids_.erase(id);
+    updateActive();
+}
+
+void
+OverlayImpl::updateActive()
+{
+    auto peers = std::make_shared<std::vector<std::weak_ptr<PeerImp>>>();
+    peers->reserve(ids_.size());
+    for (auto const& e : ids_)
+        peers->push_back(e.second);
+    std::atomic_store(
+        &active_,
+        std::shared_ptr<std::vector<std::weak_ptr<PeerImp>> const>(
+            std::move(peers)));
 }
 
 void
@@ -740,6 +779,199 @@ OverlayImpl::reportTraffic(
     m_traffic.addCount(cat, isInbound, number);
 }
 
+// The insight events are created once, so are safe to use without holding
+// m_statsMutex.
+void
+OverlayImpl::reportQueued(
+    TrafficCount::category cat,
+    TrafficCount::clock_type::duration d)
+{
+    m_traffic.addQueued(cat, d);
+    m_stats.trafficGauges[cat].queued.notify(d);
+}
+
+void
+OverlayImpl::reportHandled(
+    TrafficCount::category cat,
+    TrafficCount::clock_type::duration d)
+{
+    m_traffic.addHandled(cat, d);
+    m_stats.trafficGauges[cat].handled.notify(d);
+}
+
+void
+OverlayImpl::reportSendQueueDepth(std::size_t depth)
+{
+    m_traffic.addSendQueueDepth(depth);
+    m_stats.sendQueueDepth.notify(beast::insight::Event::value_type{depth});
+}
+
+void
+OverlayImpl::reportWriteLatency(TrafficCount::clock_type::duration d)
+{
+    m_traffic.addWriteLatency(d);
+    m_stats.writeLatency.notify(d);
+}
+
+void
+OverlayImpl::checkTransaction(std::function<void(Job&)> check)
+{
+    std::lock_guard lock(txChecksMutex_);
+    txChecks_.push_back(std::move(check));
+
+    // Every job waiting to start takes a full batch, so another is only
+    // needed when the waiting ones are full
+    if (txChecks_.size() > txCheckJobs_ * Tuning::txCheckBatch)
+    {
+        ++txCheckJobs_;
+        if (!app_.getJobQueue().addJob(
+                jtTRANSACTION, "checkTransactions", [this](Job& job) {
+                    runTransactionChecks(job);
+                }))
+        {
+            // Shutting down; no job will take the checks left waiting
+            --txCheckJobs_;
+            txChecks_.clear();
+        }
+    }
+}
+
+std::size_t
+OverlayImpl::pendingTransactionChecks() const
+{
+    std::lock_guard lock(txChecksMutex_);
+    return txChecks_.size();
+}
+
+void
+OverlayImpl::runTransactionChecks(Job& job)
+{
+    std::vector<std::function<void(Job&)>> checks;
+    {
+        std::lock_guard lock(txChecksMutex_);
+        --txCheckJobs_;
+        auto const n = std::min<std::size_t>(
+            txChecks_.size(), Tuning::txCheckBatch);
+        checks.assign(
+            std::make_move_iterator(txChecks_.begin()),
+            std::make_move_iterator(txChecks_.begin() + n));
+        txChecks_.erase(txChecks_.begin(), txChecks_.begin() + n);
+    }
+
+    for (auto& check : checks)
+        check(job);
+
+    sendVerdicts();
+}
+
+void
+OverlayImpl::shareVerdict(uint256 const& txID, bool goodSignature)
+{
+    if (!setup_.clusterVerdicts || app_.cluster().size() == 0)
+        return;
+
+    std::lock_guard lock(verdictsMutex_);
+    if (goodSignature)
+        verdicts_.add_goodsignatures(txID.data(), txID.size());
+    else
+        verdicts_.add_badsignatures(txID.data(), txID.size());
+}
+
+void
+OverlayImpl::sendVerdicts()
+{
+    protocol::TMTransactionVerdicts verdicts;
+    {
+        std::lock_guard lock(verdictsMutex_);
+        if (verdicts_.goodsignatures_size() == 0 &&
+            verdicts_.badsignatures_size() == 0)
+            return;
+        verdicts.Swap(&verdicts_);
+    }
+
+    auto const m = std::make_shared<Message>(
+        verdicts, protocol::mtTRANSACTION_VERDICTS);
+    for_each([&m](std::shared_ptr<PeerImp>&& p) {
+        if (p->cluster())
+            p->send(m);
+    });
+}
+
+void
+OverlayImpl::checkSignature(
+    JobType type,
+    std::function<bool()> verify,
+    std::function<void(Job&)> accept,
+    std::function<void()> reject)
+{
+    std::lock_guard lock(sigChecksMutex_);
+    auto& checks = sigChecks_[type];
+    checks.waiting.push_back(
+        {std::move(verify), std::move(accept), std::move(reject)});
+
+    if (checks.waiting.size() > checks.jobs * Tuning::sigCheckBatch)
+    {
+        ++checks.jobs;
+        if (!app_.getJobQueue().addJob(
+                type, "checkSignatures", [this, type](Job& job) {
+                    runSignatureChecks(type, job);
+                }))
+        {
+            // Shutting down; no job will take the checks left waiting.
+            // They are dropped rather than rejected, since nothing is
+            // known to be wrong with them.
+            --checks.jobs;
+            checks.waiting.clear();
+        }
+    }
+}
+
+void
+OverlayImpl::runSignatureChecks(JobType type, Job& job)
+{
+    std::vector<SignatureCheck> checks;
+    {
+        std::lock_guard lock(sigChecksMutex_);
+        auto& pending = sigChecks_[type];
+        --pending.jobs;
+        auto const n = std::min<std::size_t>(
+            pending.waiting.size(), Tuning::sigCheckBatch);
+        checks.assign(
+            std::make_move_iterator(pending.waiting.begin()),
+            std::make_move_iterator(pending.waiting.begin() + n));
+        pending.waiting.erase(
+            pending.waiting.begin(), pending.waiting.begin() + n);
+    }
+
+    std::vector<bool> good(checks.size(), true);
+    std::size_t verified = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < checks.size(); ++i)
+    {
+        if (checks[i].verify)
+        {
+            good[i] = checks[i].verify();
+            ++verified;
+        }
+    }
+    if (verified)
+    {
+        app_.getPerfLog().signaturesVerified(
+            type,
+            verified,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
+    }
+
+    for (std::size_t i = 0; i < checks.size(); ++i)
+    {
+        if (good[i])
+            checks[i].accept(job);
+        else
+            checks[i].reject();
+    }
+}
+
 Json::Value
 OverlayImpl::crawlShards(bool pubKey, std::uint32_t hops)
 {
@@ -843,8 +1075,7 @@ OverlayImpl::lastLink(std::uint32_t id)
 std::size_t
 OverlayImpl::size() const
 {
-    std::lock_guard lock(mutex_);
-    return ids_.size();
+    return std::atomic_load(&active_)->size();
 }
 
 int
@@ -977,6 +1208,24 @@ OverlayImpl::json()
     return json;
 }
 
+Json::Value
+OverlayImpl::trafficJson() const
+{
+    Json::Value ret(Json::objectValue);
+    Json::Value& messages = (ret[jss::messages] = Json::objectValue);
+    for (auto const& i : m_traffic.getCounts())
+    {
+        if (i.queued.count() == 0 && i.handled.count() == 0)
+            continue;
+        Json::Value& item = (messages[i.name] = Json::objectValue);
+        item[jss::queued] = i.queued.json();
+        item[jss::handled] = i.handled.json();
+    }
+    ret[jss::send_queue_depth] = m_traffic.getSendQueueDepth().json();
+    ret[jss::write_latency] = m_traffic.getWriteLatency().json();
+    return ret;
+}
+
 bool
 OverlayImpl::processCrawl(http_request_type const& req, Handoff& handoff)
 {
@@ -1215,6 +1464,7 @@ void
 OverlayImpl::broadcast(protocol::TMProposeSet& m)
 {
     auto const sm = std::make_shared<Message>(m, protocol::mtPROPOSE_LEDGER);
+    sample(*sm, protocol::mtPROPOSE_LEDGER);
     for_each([&](std::shared_ptr<PeerImp>&& p) { p->send(sm); });
 }
 
@@ -1228,6 +1478,7 @@ OverlayImpl::relay(
     {
         auto const sm =
             std::make_shared<Message>(m, protocol::mtPROPOSE_LEDGER, validator);
+        sample(*sm, protocol::mtPROPOSE_LEDGER);
         for_each([&](std::shared_ptr<PeerImp>&& p) {
             if (toSkip->find(p->id()) == toSkip->end())
                 p->send(sm);
@@ -1237,10 +1488,80 @@ OverlayImpl::relay(
     return {};
 }
 
+void
+OverlayImpl::relay(
+    protocol::TMTransaction& m,
+    uint256 const& uid,
+    std::set<Peer::id_t> const& toSkip,
+    boost::optional<PublicKey> const& source)
+{
+    auto const sm =
+        std::make_shared<Message>(m, protocol::mtTRANSACTION, source);
+    sample(*sm, protocol::mtTRANSACTION);
+    auto const& config = app_.config();
+
+    // The peers which could be sent just the hash
+    std::vector<std::shared_ptr<PeerImp>> candidates;
+    std::size_t total = 0;
+    for_each([&](std::shared_ptr<PeerImp>&& p) {
+        if (toSkip.find(p->id()) != toSkip.end())
+            return;
+        ++total;
+        if (config.TX_REDUCE_RELAY_ENABLE &&
+            p->supportsFeature(ProtocolFeature::TxReduceRelay))
+            candidates.push_back(std::move(p));
+        else
+            p->send(sm);
+    });
+
+    if (candidates.empty())
+        return;
+
+    // Enough peers still get the whole transaction for it to spread across
+    // the network as quickly as before. The others request it only if they
+    // have not seen it by the time its hash is announced.
+    auto const target = std::max(
+        config.TX_REDUCE_RELAY_MIN_PEERS,
+        total * config.TX_RELAY_PERCENTAGE / 100);
+    auto const sent = total - candidates.size();
+    auto const full =
+        target > sent ? std::min(target - sent, candidates.size()) : 0;
+
+    std::shuffle(candidates.begin(), candidates.end(), default_prng());
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (i < full)
+            candidates[i]->send(sm);
+        else
+            candidates[i]->addTxQueue(uid);
+    }
+}
+
+void
+OverlayImpl::sendTxQueue()
+{
+    for_each([](std::shared_ptr<PeerImp>&& p) { p->sendTxQueue(); });
+}
+
+std::shared_ptr<Message>
+OverlayImpl::findLedgerReply(uint256 const& key)
+{
+    return ledgerReplies_.fetch(key);
+}
+
+void
+OverlayImpl::cacheLedgerReply(
+    uint256 const& key,
+    std::shared_ptr<Message> reply)
+{
+    ledgerReplies_.canonicalize_replace_client(key, reply);
+}
+
 void
 OverlayImpl::broadcast(protocol::TMValidation& m)
 {
     auto const sm = std::make_shared<Message>(m, protocol::mtVALIDATION);
+    sample(*sm, protocol::mtVALIDATION);
     for_each([sm](std::shared_ptr<PeerImp>&& p) { p->send(sm); });
 }
 
@@ -1254,6 +1575,7 @@ OverlayImpl::relay(
     {
         auto const sm =
             std::make_shared<Message>(m, protocol::mtVALIDATION, validator);
+        sample(*sm, protocol::mtVALIDATION);
         for_each([&](std::shared_ptr<PeerImp>&& p) {
             if (toSkip->find(p->id()) == toSkip->end())
                 p->send(sm);
@@ -1263,6 +1585,76 @@ OverlayImpl::relay(
     return {};
 }
 
+void
+OverlayImpl::sample(Message& m, int type)
+{
+    if (setup_.compressionDictionary.empty() || dictionary_ ||
+        !app_.config().COMPRESSION)
+        return;
+
+    auto const& buffer = m.getBuffer(compression::Compressed::Off);
+
+    std::vector<Blob> samples;
+    {
+        std::lock_guard lock(samplesMutex_);
+        if (dictionary_)
+            return;
+        // Validations and proposals far outnumber transactions on some
+        // networks; don't let either crowd the other out.
+        auto const target = compression::Dictionary::defaultSamples;
+        if (sampleTypes_[type] < target / 2)
+        {
+            ++sampleTypes_[type];
+            samples_.emplace_back(
+                buffer.begin() + compression::headerBytes, buffer.end());
+        }
+        if (samples_.size() < target && ++sampled_ < 4 * target)
+            return;
+        samples = std::move(samples_);
+        samples_.clear();
+        sampleTypes_.clear();
+        sampled_ = 0;
+    }
+    train(samples);
+}
+
+void
+OverlayImpl::train(std::vector<Blob> const& samples)
+{
+    try
+    {
+        // Another server may have saved a dictionary for us to share.
+        std::shared_ptr<compression::Dictionary const> dictionary;
+        if (boost::filesystem::exists(setup_.compressionDictionary))
+        {
+            dictionary =
+                compression::Dictionary::load(setup_.compressionDictionary);
+        }
+        else
+        {
+            auto data = compression::Dictionary::train(samples);
+            if (data.empty())
+                return;
+            dictionary = std::make_shared<compression::Dictionary const>(
+                std::move(data));
+            compression::Dictionary::save(
+                setup_.compressionDictionary, *dictionary);
+            dictionary = compression::Dictionary::add(dictionary);
+        }
+        JLOG(journal_.info())
+            << "Offering compression dictionary " << dictionary->id()
+            << " to new peers";
+        dictionary_ = dictionary.get();
+    }
+    catch (std::exception const& e)
+    {
+        // Sampling starts over and tries again later.
+        JLOG(journal_.error()) << "Unable to create compression dictionary "
+                               << setup_.compressionDictionary << ": "
+                               << e.what();
+    }
+}
+
 std::shared_ptr<Message>
 OverlayImpl::getManifestsMessage()
 {
@@ -1478,6 +1870,13 @@ setup_Overlay(BasicConfig const& config)
             if (ec || beast::IP::is_private(setup.public_ip))
                 Throw<std::runtime_error>("Configured public IP is invalid");
         }
+
+        set(setup.parallelDecodeBytes, "parallel_decode", section);
+        set(setup.compressionDictionary, "compression_dictionary", section);
+        set(setup.sendBuffer, "send_buffer", section);
+        if (setup.sendBuffer > 16 * 1024 * 1024)
+            Throw<std::runtime_error>("Configured send buffer is invalid");
+        set(setup.clusterVerdicts, "cluster_verdicts", section);
     }
 
     {
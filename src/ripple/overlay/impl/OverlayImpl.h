@@ -22,6 +22,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/basics/Resolver.h>
+#include <ripple/basics/TaggedCache.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/core/Job.h>
@@ -45,6 +46,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -110,6 +112,11 @@ private:
     TrafficCount m_traffic;
     hash_map<std::shared_ptr<PeerFinder::Slot>, std::weak_ptr<PeerImp>> m_peers;
     hash_map<Peer::id_t, std::weak_ptr<PeerImp>> ids_;
+    // The active peers, replaced as a whole under mutex_ whenever ids_
+    // changes, so they can be iterated without taking the mutex. Only read
+    // and written with std::atomic_load and std::atomic_store.
+    std::shared_ptr<std::vector<std::weak_ptr<PeerImp>> const> active_ =
+        std::make_shared<std::vector<std::weak_ptr<PeerImp>>>();
     Resolver& m_resolver;
     std::atomic<Peer::id_t> next_id_;
     int timer_count_;
@@ -135,6 +142,50 @@ private:
     // Protects the message and the sequence list of manifests
     std::mutex manifestLock_;
 
+    // Replies to ledger data requests, shared by all peers
+    TaggedCache<uint256, Message> ledgerReplies_;
+
+    // The dictionary offered to peers for consensus messages, once there
+    // is one. Dictionaries stay registered for the life of the process.
+    std::atomic<compression::Dictionary const*> dictionary_{nullptr};
+
+    // Consensus messages collected to train a dictionary, by type
+    std::mutex samplesMutex_;
+    std::vector<Blob> samples_;
+    std::map<int, std::size_t> sampleTypes_;
+    std::size_t sampled_ = 0;
+
+    // Checks of transactions received from peers waiting for a job, and
+    // the number of jobs scheduled to run them
+    std::mutex mutable txChecksMutex_;
+    std::vector<std::function<void(Job&)>> txChecks_;
+    std::size_t txCheckJobs_ = 0;
+
+    // Transaction signatures checked since the last verdicts were sent to
+    // the cluster
+    std::mutex verdictsMutex_;
+    protocol::TMTransactionVerdicts verdicts_;
+
+    // A validation or proposal from a peer whose signature is to be checked
+    struct SignatureCheck
+    {
+        std::function<bool()> verify;
+        std::function<void(Job&)> accept;
+        std::function<void()> reject;
+    };
+
+    // Signature checks waiting for a job, and the number of jobs scheduled
+    // to run them
+    struct SignatureChecks
+    {
+        std::vector<SignatureCheck> waiting;
+        std::size_t jobs = 0;
+    };
+
+    // Signature checks by the job type they run as
+    std::mutex sigChecksMutex_;
+    std::map<JobType, SignatureChecks> sigChecks_;
+
     //--------------------------------------------------------------------------
 
 public:
@@ -197,6 +248,9 @@ public:
     Json::Value
     json() override;
 
+    Json::Value
+    trafficJson() const override;
+
     PeerSequence
     getActivePeers() const override;
 
@@ -226,9 +280,39 @@ public:
         uint256 const& uid,
         PublicKey const& validator) override;
 
+    void
+    relay(
+        protocol::TMTransaction& m,
+        uint256 const& uid,
+        std::set<Peer::id_t> const& toSkip,
+        boost::optional<PublicKey> const& source) override;
+
     std::shared_ptr<Message>
     getManifestsMessage();
 
+    /** Return the dictionary offered to new peers for compressing
+        consensus messages, if any.
+    */
+    compression::Dictionary const*
+    compressionDictionary() const
+    {
+        return dictionary_.load();
+    }
+
+    /** Return a recently built reply to an identical ledger data request.
+
+        @param key Identifies the request, see PeerImp::getLedger.
+        @return The reply, or nullptr if there is none.
+    */
+    std::shared_ptr<Message>
+    findLedgerReply(uint256 const& key);
+
+    /** Keep a ledger data reply to serve identical requests from other
+        peers for a few seconds.
+    */
+    void
+    cacheLedgerReply(uint256 const& key, std::shared_ptr<Message> reply);
+
     //--------------------------------------------------------------------------
     //
     // OverlayImpl
@@ -259,25 +343,21 @@ public:
     void
     for_each(UnaryFunc&& f) const
     {
-        std::vector<std::weak_ptr<PeerImp>> wp;
-        {
-            std::lock_guard lock(mutex_);
-
-            // Iterate over a copy of the peer list because peer
-            // destruction can invalidate iterators.
-            wp.reserve(ids_.size());
-
-            for (auto& x : ids_)
-                wp.push_back(x.second);
-        }
-
-        for (auto& w : wp)
+        // The snapshot is never changed once published, so peers connecting
+        // and disconnecting meanwhile can't invalidate the iteration.
+        auto const peers = std::atomic_load(&active_);
+        for (auto& w : *peers)
         {
             if (auto p = w.lock())
                 f(std::move(p));
         }
     }
 
+    // Publish a new snapshot of the active peers. Must be called with
+    // mutex_ held, after ids_ changes.
+    void
+    updateActive();
+
     // Called when TMManifests is received from a peer
     void
     onManifests(
@@ -326,9 +406,81 @@ public:
     static std::string
     makePrefix(std::uint32_t id);
 
+    // Run the next batch of transaction checks
+    void
+    runTransactionChecks(Job& job);
+
+    // Send the verdicts shared since the last call to the cluster
+    void
+    sendVerdicts();
+
+    // Run the next batch of signature checks of a job type
+    void
+    runSignatureChecks(JobType type, Job& job);
+
     void
     reportTraffic(TrafficCount::category cat, bool isInbound, int bytes);
 
+    void
+    reportQueued(
+        TrafficCount::category cat,
+        TrafficCount::clock_type::duration d);
+
+    void
+    reportHandled(
+        TrafficCount::category cat,
+        TrafficCount::clock_type::duration d);
+
+    void
+    reportSendQueueDepth(std::size_t depth);
+
+    void
+    reportWriteLatency(TrafficCount::clock_type::duration d);
+
+    /** Check a transaction received from a peer.
+
+        Checks queued while earlier ones wait for a worker join them, up to
+        Tuning::txCheckBatch in one job. A burst of transactions is then
+        verified by a few jobs spread across the job queue's threads rather
+        than by a job for each.
+    */
+    void
+    checkTransaction(std::function<void(Job&)> check);
+
+    /** Return the number of transaction checks waiting to run. */
+    std::size_t
+    pendingTransactionChecks() const;
+
+    /** Tell the other members of our cluster whether a transaction's
+        signature is good, if configured to share verdicts.
+
+        The verdicts found by a batch of transaction checks are sent in
+        one message once the batch is done.
+    */
+    void
+    shareVerdict(uint256 const& txID, bool goodSignature);
+
+    /** Check the signature of a validation or proposal from a peer.
+
+        Like checkTransaction, checks of the same job type that queue up
+        while earlier ones wait for a worker are run together, up to
+        Tuning::sigCheckBatch in one job. The job verifies all of its
+        signatures first and reports the time taken to the PerfLog, then
+        accepts or rejects each message in the order received.
+
+        @param type The job type to verify and accept the message with.
+        @param verify Returns whether the signature is good. If empty, the
+            signature is not checked.
+        @param accept Called on the job if the signature is good.
+        @param reject Called on the job if it is not.
+    */
+    void
+    checkSignature(
+        JobType type,
+        std::function<bool()> verify,
+        std::function<void(Job&)> accept,
+        std::function<void()> reject);
+
     void
     incJqTransOverflow() override
     {
@@ -540,12 +692,26 @@ private:
     void
     sendEndpoints();
 
+    /** Announce the transaction hashes queued for each peer. */
+    void
+    sendTxQueue();
+
     /** Check if peers stopped relaying messages
      * and if slots stopped receiving messages from the validator */
     void
     deleteIdlePeers();
 
 private:
+    /** Collect a consensus message to train the compression dictionary
+        with. Once enough have been gathered, a dictionary is trained and
+        saved, and offered to peers which connect afterwards.
+    */
+    void
+    sample(Message& m, int type);
+
+    void
+    train(std::vector<Blob> const& samples);
+
     struct TrafficGauges
     {
         TrafficGauges(
@@ -555,12 +721,16 @@ private:
             , bytesOut(collector->make_gauge(name, "Bytes_Out"))
             , messagesIn(collector->make_gauge(name, "Messages_In"))
             , messagesOut(collector->make_gauge(name, "Messages_Out"))
+            , queued(collector->make_event(name, "Queued"))
+            , handled(collector->make_event(name, "Handled"))
         {
         }
         beast::insight::Gauge bytesIn;
         beast::insight::Gauge bytesOut;
         beast::insight::Gauge messagesIn;
         beast::insight::Gauge messagesOut;
+        beast::insight::Event queued;
+        beast::insight::Event handled;
     };
 
     struct Stats
@@ -572,12 +742,17 @@ private:
             std::vector<TrafficGauges>&& trafficGauges_)
             : peerDisconnects(
                   collector->make_gauge("Overlay", "Peer_Disconnects"))
+            , sendQueueDepth(
+                  collector->make_event("Overlay", "Send_Queue_Depth"))
+            , writeLatency(collector->make_event("Overlay", "Write_Latency"))
             , trafficGauges(std::move(trafficGauges_))
             , hook(collector->make_hook(handler))
         {
         }
 
         beast::insight::Gauge peerDisconnects;
+        beast::insight::Event sendQueueDepth;
+        beast::insight::Event writeLatency;
         std::vector<TrafficGauges> trafficGauges;
         beast::insight::Hook hook;
     };
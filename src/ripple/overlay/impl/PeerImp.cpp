@@ -21,12 +21,14 @@
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/InboundTransactions.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/basics/Tracer.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/basics/base64.h>
 #include <ripple/basics/random.h>
@@ -39,6 +41,7 @@
 #include <ripple/overlay/impl/Tuning.h>
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/digest.h>
+#include <ripple/shamap/HistoryFamily.h>
 
 #include <boost/algorithm/clamp.hpp>
 #include <boost/algorithm/string.hpp>
@@ -46,6 +49,8 @@
 #include <boost/beast/core/ostream.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
@@ -102,6 +107,11 @@ PeerImp::PeerImp(
     , compressionEnabled_(
           headers_["X-Offer-Compression"] == "lz4" ? Compressed::On
                                                    : Compressed::Off)
+    , dictionary_(
+          compressionEnabled_ == Compressed::On && app_.config().COMPRESSION
+              ? negotiateCompressionDictionary(
+                    headers_, overlay_.compressionDictionary())
+              : nullptr)
 {
 }
 
@@ -176,6 +186,25 @@ PeerImp::run()
             previousLedgerHash_ = *previous;
     }
 
+    // Send small messages such as proposals and validations as soon as they
+    // are written instead of holding them to be coalesced. A smaller kernel
+    // buffer also keeps less bulk data ahead of them once it is written.
+    {
+        error_code ec;
+        socket_.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+        if (ec)
+            JLOG(journal_.debug()) << "TCP_NODELAY: " << ec.message();
+        if (auto const size = overlay_.setup().sendBuffer; size != 0)
+        {
+            socket_.set_option(
+                boost::asio::socket_base::send_buffer_size(
+                    static_cast<int>(size)),
+                ec);
+            if (ec)
+                JLOG(journal_.debug()) << "SO_SNDBUF: " << ec.message();
+        }
+    }
+
     if (inbound_)
         doAccept();
     else
@@ -232,11 +261,17 @@ PeerImp::send(std::shared_ptr<Message> const& m)
     overlay_.reportTraffic(
         safe_cast<TrafficCount::category>(m->getCategory()),
         false,
-        static_cast<int>(m->getBuffer(compressionEnabled_).size()));
+        static_cast<int>(
+            m->getBuffer(compressionEnabled_, dictionary_).size()));
 
-    auto sendq_size = send_queue_.size();
+    auto sendq_size = sendQueueSize();
+    sendQueueDepth_.add(sendq_size);
+    overlay_.reportSendQueueDepth(sendq_size);
 
-    if (sendq_size < Tuning::targetSendQueue)
+    auto& queue = send_queue_[static_cast<std::size_t>(m->getPriority())];
+    auto const bulk = static_cast<std::size_t>(Message::Priority::bulk);
+    if (sendq_size - send_queue_[bulk].size() < Tuning::targetSendQueue &&
+        send_queue_[bulk].size() < Tuning::targetBulkSendQueue)
     {
         // To detect a peer that does not read from their
         // side of the connection, we expect a peer to have
@@ -252,22 +287,29 @@ PeerImp::send(std::shared_ptr<Message> const& m)
                                << " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    queue.push_back(m);
 
     if (sendq_size != 0)
         return;
 
-    boost::asio::async_write(
-        stream_,
-        boost::asio::buffer(
-            send_queue_.front()->getBuffer(compressionEnabled_)),
-        bind_executor(
-            strand_,
-            std::bind(
-                &PeerImp::onWriteMessage,
-                shared_from_this(),
-                std::placeholders::_1,
-                std::placeholders::_2)));
+    writeQueued();
+}
+
+std::size_t
+PeerImp::sendQueueSize() const
+{
+    std::size_t size = 0;
+    for (auto const& queue : send_queue_)
+        size += queue.size();
+    return size;
+}
+
+bool
+PeerImp::largeSendQueue() const
+{
+    auto const bulk = static_cast<std::size_t>(Message::Priority::bulk);
+    return sendQueueSize() >= Tuning::dropSendQueue ||
+        send_queue_[bulk].size() >= Tuning::dropBulkSendQueue;
 }
 
 void
@@ -282,6 +324,46 @@ PeerImp::charge(Resource::Charge const& fee)
     }
 }
 
+void
+PeerImp::addTxQueue(uint256 const& hash)
+{
+    std::unique_lock lock(txQueueMutex_);
+    txQueue_.insert(hash);
+    if (txQueue_.size() < Tuning::maxTxQueueSize)
+        return;
+    lock.unlock();
+
+    // Don't let the queue grow until the next timer tick
+    sendTxQueue();
+}
+
+void
+PeerImp::sendTxQueue()
+{
+    hash_set<uint256> hashes;
+    {
+        std::lock_guard lock(txQueueMutex_);
+        if (txQueue_.empty())
+            return;
+        hashes.swap(txQueue_);
+    }
+
+    protocol::TMHaveTransactions ht;
+    ht.mutable_hashes()->Reserve(hashes.size());
+    for (auto const& hash : hashes)
+        ht.add_hashes(hash.data(), hash.size());
+
+    JLOG(p_journal_.trace()) << "sendTxQueue " << hashes.size();
+    send(std::make_shared<Message>(ht, protocol::mtHAVE_TRANSACTIONS));
+}
+
+void
+PeerImp::removeTxQueue(uint256 const& hash)
+{
+    std::lock_guard lock(txQueueMutex_);
+    txQueue_.erase(hash);
+}
+
 //------------------------------------------------------------------------------
 
 bool
@@ -421,6 +503,8 @@ PeerImp::json()
         std::to_string(metrics_.recv.average_bytes());
     ret[jss::metrics][jss::avg_bps_sent] =
         std::to_string(metrics_.sent.average_bytes());
+    ret[jss::metrics][jss::send_queue_depth] = sendQueueDepth_.json();
+    ret[jss::metrics][jss::write_latency] = writeLatency_.json();
 
     return ret;
 }
@@ -432,6 +516,10 @@ PeerImp::supportsFeature(ProtocolFeature f) const
     {
         case ProtocolFeature::ValidatorListPropagation:
             return protocol_ >= make_protocol(2, 1);
+        case ProtocolFeature::TxReduceRelay:
+            return protocol_ >= make_protocol(2, 2);
+        case ProtocolFeature::LedgerDelta:
+            return protocol_ >= make_protocol(2, 3);
     }
     return false;
 }
@@ -582,12 +670,7 @@ PeerImp::gracefulClose()
     assert(socket_.is_open());
     assert(!gracefulClose_);
     gracefulClose_ = true;
-#if 0
-    // Flush messages
-    while(send_queue_.size() > 1)
-        send_queue_.pop_back();
-#endif
-    if (send_queue_.size() > 0)
+    if (sendQueueSize() > 0)
         return;
     setTimer();
     stream_.async_shutdown(bind_executor(
@@ -759,6 +842,9 @@ PeerImp::doAccept()
             app_.config().COMPRESSION)
             resp.insert("X-Offer-Compression", "lz4");
 
+        if (dictionary_)
+            offerCompressionDictionary(resp, *dictionary_);
+
         buildHandshake(
             resp,
             *sharedValue,
@@ -902,6 +988,54 @@ PeerImp::onReadMessage(error_code ec, std::size_t bytes_transferred)
                 std::placeholders::_2)));
 }
 
+void
+PeerImp::writeQueued()
+{
+    assert(sendQueueSize() != 0);
+
+    // Messages which arrived while the last write was in progress go out
+    // together. The TLS stream packs small buffers into full records, so
+    // a burst of small messages costs a few records and system calls
+    // rather than one of each per message.
+    //
+    // The more urgent queues are taken first. A write is never interrupted,
+    // but each one starts with whatever is most urgent at the time, so a
+    // proposal waits for at most one write of bulk data.
+    std::vector<boost::asio::const_buffer> buffers;
+    std::size_t bytes = 0;
+    bool full = false;
+    for (std::size_t i = 0; i < send_queue_.size() && !full; ++i)
+    {
+        assert(sendq_writing_[i] == 0);
+        for (auto const& m : send_queue_[i])
+        {
+            auto const& buffer = m->getBuffer(compressionEnabled_, dictionary_);
+            if (!buffers.empty() &&
+                bytes + buffer.size() > Tuning::maxWriteBytes)
+            {
+                full = true;
+                break;
+            }
+            buffers.emplace_back(buffer.data(), buffer.size());
+            bytes += buffer.size();
+            ++sendq_writing_[i];
+        }
+    }
+    writeStarted_ = clock_type::now();
+
+    // Timeout on writes only
+    boost::asio::async_write(
+        stream_,
+        buffers,
+        bind_executor(
+            strand_,
+            std::bind(
+                &PeerImp::onWriteMessage,
+                shared_from_this(),
+                std::placeholders::_1,
+                std::placeholders::_2)));
+}
+
 void
 PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
 {
@@ -920,24 +1054,19 @@ PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
     }
 
     metrics_.sent.add_message(bytes_transferred);
+    auto const latency = clock_type::now() - writeStarted_;
+    writeLatency_.add(latency);
+    overlay_.reportWriteLatency(latency);
 
-    assert(!send_queue_.empty());
-    send_queue_.pop();
-    if (!send_queue_.empty())
+    for (std::size_t i = 0; i < send_queue_.size(); ++i)
     {
-        // Timeout on writes only
-        return boost::asio::async_write(
-            stream_,
-            boost::asio::buffer(
-                send_queue_.front()->getBuffer(compressionEnabled_)),
-            bind_executor(
-                strand_,
-                std::bind(
-                    &PeerImp::onWriteMessage,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
+        auto& queue = send_queue_[i];
+        assert(queue.size() >= sendq_writing_[i]);
+        queue.erase(queue.begin(), queue.begin() + sendq_writing_[i]);
+        sendq_writing_[i] = 0;
     }
+    if (sendQueueSize() != 0)
+        return writeQueued();
 
     if (gracefulClose_)
     {
@@ -962,6 +1091,49 @@ PeerImp::onMessageUnknown(std::uint16_t type)
     // TODO
 }
 
+bool
+PeerImp::deferDecode(detail::MessageHeader const& header) const
+{
+    auto const threshold = overlay_.setup().parallelDecodeBytes;
+    return threshold != 0 && header.total_wire_size >= threshold &&
+        deferred_decodes_ < Tuning::maxDeferredDecodes;
+}
+
+void
+PeerImp::decodeDeferred(
+    std::function<std::function<bool(PeerImp&)>()> decode)
+{
+    ++deferred_decodes_;
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    if (!app_.getJobQueue().addJob(
+            jtPEER_DECODE, "decodePeerMessage", [weak, decode](Job&) {
+                auto dispatch = decode();
+                if (auto peer = weak.lock())
+                    post(
+                        peer->strand_,
+                        std::bind(
+                            &PeerImp::onMessageDecoded,
+                            peer,
+                            std::move(dispatch)));
+            }))
+    {
+        // Shutting down; the connection is about to close anyway
+        --deferred_decodes_;
+    }
+}
+
+void
+PeerImp::onMessageDecoded(std::function<bool(PeerImp&)> const& dispatch)
+{
+    --deferred_decodes_;
+    if (!socket_.is_open() || gracefulClose_)
+        return;
+    if (!dispatch(*this))
+        fail(
+            "onMessageDecoded",
+            make_error_code(boost::system::errc::bad_message));
+}
+
 void
 PeerImp::onMessageBegin(
     std::uint16_t type,
@@ -971,8 +1143,10 @@ PeerImp::onMessageBegin(
     load_event_ =
         app_.getJobQueue().makeLoadEvent(jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
-    overlay_.reportTraffic(
-        TrafficCount::categorize(*m, type, true), true, static_cast<int>(size));
+    msgCategory_ = TrafficCount::categorize(*m, type, true);
+    msgReceived_ = clock_type::now();
+    msgQueued_ = false;
+    overlay_.reportTraffic(msgCategory_, true, static_cast<int>(size));
 }
 
 void
@@ -982,6 +1156,28 @@ PeerImp::onMessageEnd(
 {
     load_event_.reset();
     charge(fee_);
+    if (!msgQueued_)
+        overlay_.reportHandled(msgCategory_, clock_type::now() - msgReceived_);
+}
+
+template <class Handler>
+std::function<void(Job&)>
+PeerImp::timeJob(Handler&& handler)
+{
+    msgQueued_ = true;
+    return [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+            category = msgCategory_,
+            received = msgReceived_,
+            handler = std::forward<Handler>(handler)](Job& job) {
+        auto const started = clock_type::now();
+        handler(job);
+        if (auto peer = weak.lock())
+        {
+            peer->overlay_.reportQueued(category, started - received);
+            peer->overlay_.reportHandled(
+                category, clock_type::now() - started);
+        }
+    };
 }
 
 void
@@ -990,9 +1186,9 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMManifests> const& m)
     // VFALCO What's the right job type?
     auto that = shared_from_this();
     app_.getJobQueue().addJob(
-        jtVALIDATION_ut, "receiveManifests", [this, that, m](Job&) {
-            overlay_.onManifests(m, that);
-        });
+        jtVALIDATION_ut,
+        "receiveManifests",
+        timeJob([this, that, m](Job&) { overlay_.onManifests(m, that); }));
 }
 
 void
@@ -1361,6 +1557,12 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMEndpoints> const& m)
 
 void
 PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
+{
+    handleTransaction(*m);
+}
+
+void
+PeerImp::handleTransaction(protocol::TMTransaction const& m)
 {
     if (tracking_.load() == Tracking::diverged)
         return;
@@ -1374,12 +1576,16 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
         return;
     }
 
-    SerialIter sit(makeSlice(m->rawtransaction()));
+    SerialIter sit(makeSlice(m.rawtransaction()));
 
     try
     {
         auto stx = std::make_shared<STTx const>(sit);
         uint256 txID = stx->getTransactionID();
+        perf::trace::Span span("peer.receive", txID);
+
+        // The peer has the transaction, so there's no need to announce it
+        removeTxQueue(txID);
 
         int flags;
         constexpr std::chrono::seconds tx_interval = 10s;
@@ -1391,6 +1597,23 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
             {
                 fee_ = Resource::feeInvalidSignature;
                 JLOG(p_journal_.debug()) << "Ignoring known bad tx " << txID;
+                return;
+            }
+
+            // Select the peers to receive this signer's transactions from,
+            // as for the validators' messages.
+            if (app_.config().REDUCE_RELAY_ENABLE &&
+                squelch::epoch<std::chrono::minutes>(UptimeClock::now()) >
+                    squelch::WAIT_ON_BOOTUP)
+            {
+                if (auto const source = squelch::transactionSource(*stx))
+                {
+                    auto const relayed = app_.getHashRouter().relayed(txID);
+                    if (relayed &&
+                        (stopwatch().now() - *relayed) < squelch::IDLED)
+                        overlay_.updateSlotAndSquelch(
+                            txID, *source, id_, protocol::mtTRANSACTION);
+                }
             }
 
             return;
@@ -1401,7 +1624,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
         bool checkSignature = true;
         if (cluster())
         {
-            if (!m->has_deferred() || !m->deferred())
+            if (!m.has_deferred() || !m.deferred())
             {
                 // Skip local checks if a server we trust
                 // put the transaction in its open ledger
@@ -1416,7 +1639,8 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
             }
         }
 
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) >
+        if (app_.getJobQueue().getJobCount(jtTRANSACTION) +
+                overlay_.pendingTransactionChecks() >
             app_.config().MAX_TRANSACTIONS)
         {
             overlay_.incJqTransOverflow();
@@ -1429,22 +1653,20 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMTransaction> const& m)
         }
         else
         {
-            app_.getJobQueue().addJob(
-                jtTRANSACTION,
-                "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                 flags,
-                 checkSignature,
-                 stx](Job&) {
+            overlay_.checkTransaction(
+                timeJob([weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                         flags,
+                         checkSignature,
+                         stx](Job&) {
                     if (auto peer = weak.lock())
                         peer->checkTransaction(flags, checkSignature, stx);
-                });
+                }));
         }
     }
     catch (std::exception const&)
     {
         JLOG(p_journal_.warn())
-            << "Transaction invalid: " << strHex(m->rawtransaction());
+            << "Transaction invalid: " << strHex(m.rawtransaction());
     }
 }
 
@@ -1453,10 +1675,11 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetLedger> const& m)
 {
     fee_ = Resource::feeMediumBurdenPeer;
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(jtLEDGER_REQ, "recvGetLedger", [weak, m](Job&) {
-        if (auto peer = weak.lock())
-            peer->getLedger(m);
-    });
+    app_.getJobQueue().addJob(
+        jtLEDGER_REQ, "recvGetLedger", timeJob([weak, m](Job&) {
+            if (auto peer = weak.lock())
+                peer->getLedger(m);
+        }));
 }
 
 void
@@ -1502,10 +1725,10 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMLedgerData> const& m)
         // got data for a candidate transaction set
         std::weak_ptr<PeerImp> weak = shared_from_this();
         app_.getJobQueue().addJob(
-            jtTXN_DATA, "recvPeerData", [weak, hash, m](Job&) {
+            jtTXN_DATA, "recvPeerData", timeJob([weak, hash, m](Job&) {
                 if (auto peer = weak.lock())
                     peer->app_.getInboundTransactions().gotData(hash, peer, m);
-            });
+            }));
         return;
     }
 
@@ -1516,6 +1739,26 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMLedgerData> const& m)
     }
 }
 
+void
+PeerImp::onMessage(std::shared_ptr<protocol::TMGetLedgerDelta> const& m)
+{
+    if (!supportsFeature(ProtocolFeature::LedgerDelta) ||
+        !stringIsUint256Sized(m->ledgerhash()) ||
+        !stringIsUint256Sized(m->basehash()))
+    {
+        fee_ = Resource::feeInvalidRequest;
+        return;
+    }
+
+    fee_ = Resource::feeHighBurdenPeer;
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    app_.getJobQueue().addJob(
+        jtLEDGER_REQ, "recvGetLedgerDelta", timeJob([weak, m](Job&) {
+            if (auto peer = weak.lock())
+                peer->getLedgerDelta(m);
+        }));
+}
+
 void
 PeerImp::onMessage(std::shared_ptr<protocol::TMProposeSet> const& m)
 {
@@ -1606,13 +1849,24 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMProposeSet> const& m)
             app_.timeKeeper().closeTime(),
             calcNodeID(app_.validatorManifests().getMasterKey(publicKey))});
 
+    std::function<bool()> verify;
+    if (!cluster())
+        verify = [proposal]() { return proposal.checkSign(); };
+
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(
+    overlay_.checkSignature(
         isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut,
-        "recvPropose->checkPropose",
-        [weak, m, proposal](Job& job) {
+        std::move(verify),
+        timeJob([weak, m, proposal](Job& job) {
             if (auto peer = weak.lock())
                 peer->checkPropose(job, m, proposal);
+        }),
+        [weak]() {
+            if (auto peer = weak.lock())
+            {
+                JLOG(peer->p_journal_.warn()) << "Proposal fails sig check";
+                peer->charge(Resource::feeInvalidSignature);
+            }
         });
 }
 
@@ -2059,13 +2313,25 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMValidation> const& m)
         }
         if (isTrusted || cluster() || !app_.getFeeTrack().isLoadedLocal())
         {
+            std::function<bool()> verify;
+            if (!cluster())
+                verify = [val]() { return val->isValid(); };
+
             std::weak_ptr<PeerImp> weak = shared_from_this();
-            app_.getJobQueue().addJob(
+            overlay_.checkSignature(
                 isTrusted ? jtVALIDATION_t : jtVALIDATION_ut,
-                "recvValidation->checkValidation",
-                [weak, val, m](Job&) {
+                std::move(verify),
+                timeJob([weak, val, m](Job&) {
                     if (auto peer = weak.lock())
                         peer->checkValidation(val, m);
+                }),
+                [weak]() {
+                    if (auto peer = weak.lock())
+                    {
+                        JLOG(peer->p_journal_.warn())
+                            << "Validation is invalid";
+                        peer->charge(Resource::feeInvalidRequest);
+                    }
                 });
         }
         else
@@ -2089,7 +2355,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
     if (packet.query())
     {
         // this is a query
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (largeSendQueue())
         {
             JLOG(p_journal_.debug()) << "GetObject: Large send queue";
             return;
@@ -2101,6 +2367,12 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
             return;
         }
 
+        if (packet.type() == protocol::TMGetObjectByHash::otTRANSACTIONS)
+        {
+            doTransactions(m);
+            return;
+        }
+
         fee_ = Resource::feeMediumBurdenPeer;
 
         protocol::TMGetObjectByHash reply;
@@ -2123,46 +2395,8 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
             reply.set_ledgerhash(packet.ledgerhash());
         }
 
-        // This is a very minimal implementation
-        for (int i = 0; i < packet.objects_size(); ++i)
-        {
-            auto const& obj = packet.objects(i);
-            if (obj.has_hash() && stringIsUint256Sized(obj.hash()))
-            {
-                uint256 const hash{obj.hash()};
-                // VFALCO TODO Move this someplace more sensible so we dont
-                //             need to inject the NodeStore interfaces.
-                std::uint32_t seq{obj.has_ledgerseq() ? obj.ledgerseq() : 0};
-                auto nodeObject{app_.getNodeStore().fetchNodeObject(hash, seq)};
-                if (!nodeObject)
-                {
-                    if (auto shardStore = app_.getShardStore())
-                    {
-                        if (seq >= shardStore->earliestLedgerSeq())
-                            nodeObject = shardStore->fetchNodeObject(hash, seq);
-                    }
-                }
-                if (nodeObject)
-                {
-                    protocol::TMIndexedObject& newObj = *reply.add_objects();
-                    newObj.set_hash(hash.begin(), hash.size());
-                    newObj.set_data(
-                        &nodeObject->getData().front(),
-                        nodeObject->getData().size());
-
-                    if (obj.has_nodeid())
-                        newObj.set_index(obj.nodeid());
-                    if (obj.has_ledgerseq())
-                        newObj.set_ledgerseq(obj.ledgerseq());
-
-                    // VFALCO NOTE "seq" in the message is obsolete
-                }
-            }
-        }
-
-        JLOG(p_journal_.trace()) << "GetObj: " << reply.objects_size() << " of "
-                                 << packet.objects_size();
-        send(std::make_shared<Message>(reply, protocol::mtGET_OBJECTS));
+        getObjects(
+            m, std::make_shared<protocol::TMGetObjectByHash>(std::move(reply)));
     }
     else
     {
@@ -2170,6 +2404,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
         std::uint32_t pLSeq = 0;
         bool pLDo = true;
         bool progress = false;
+        auto const history = app_.getHistoryFamily();
 
         for (int i = 0; i < packet.objects_size(); ++i)
         {
@@ -2177,6 +2412,12 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
 
             if (obj.has_hash() && stringIsUint256Sized(obj.hash()))
             {
+                // An old ledger's object an RPC request is waiting for
+                if (history &&
+                    history->gotObject(
+                        uint256{obj.hash()}, makeSlice(obj.data())))
+                    continue;
+
                 if (obj.has_ledgerseq())
                 {
                     if (obj.ledgerseq() != pLSeq)
@@ -2260,6 +2501,105 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMSquelch> const& m)
     squelch_.squelch(key, squelch, duration);
 }
 
+void
+PeerImp::onMessage(std::shared_ptr<protocol::TMTransactionVerdicts> const& m)
+{
+    if (!cluster())
+    {
+        fee_ = Resource::feeUnwantedData;
+        return;
+    }
+
+    // Validators check every transaction themselves, as they do the ones
+    // relayed by the cluster
+    if (!overlay_.setup().clusterVerdicts ||
+        !app_.getValidationPublicKey().empty())
+        return;
+
+    auto& router = app_.getHashRouter();
+    for (auto const& id : m->goodsignatures())
+    {
+        if (!stringIsUint256Sized(id))
+        {
+            fee_ = Resource::feeInvalidRequest;
+            return;
+        }
+        uint256 const txID{id};
+        router.setFlags(txID, SF_CLUSTER);
+        forceValidity(router, txID, Validity::SigGoodOnly);
+    }
+    for (auto const& id : m->badsignatures())
+    {
+        if (!stringIsUint256Sized(id))
+        {
+            fee_ = Resource::feeInvalidRequest;
+            return;
+        }
+        uint256 const txID{id};
+        router.setFlags(txID, SF_CLUSTER);
+        forceSigBad(router, txID);
+    }
+
+    JLOG(p_journal_.trace())
+        << "TransactionVerdicts: " << m->goodsignatures_size() << " good, "
+        << m->badsignatures_size() << " bad";
+}
+
+void
+PeerImp::onMessage(std::shared_ptr<protocol::TMHaveTransactions> const& m)
+{
+    if (!supportsFeature(ProtocolFeature::TxReduceRelay) ||
+        m->hashes_size() > Tuning::maxTxQueueSize)
+    {
+        fee_ = Resource::feeInvalidRequest;
+        return;
+    }
+
+    if (tracking_.load() == Tracking::diverged ||
+        app_.getOPs().isNeedNetworkLedger())
+        return;
+
+    protocol::TMGetObjectByHash tmBH;
+    tmBH.set_type(protocol::TMGetObjectByHash::otTRANSACTIONS);
+    tmBH.set_query(true);
+
+    for (auto const& h : m->hashes())
+    {
+        if (!stringIsUint256Sized(h))
+        {
+            fee_ = Resource::feeInvalidRequest;
+            return;
+        }
+        uint256 const hash{h};
+
+        // The peer has the transaction, so it won't be relayed back to it.
+        // If we had not heard of it before, ask for it.
+        removeTxQueue(hash);
+        if (app_.getHashRouter().addSuppressionPeer(hash, id_))
+            tmBH.add_objects()->set_hash(hash.data(), hash.size());
+    }
+
+    JLOG(p_journal_.trace()) << "HaveTransactions: " << m->hashes_size()
+                             << ", requesting " << tmBH.objects_size();
+
+    if (tmBH.objects_size() > 0)
+        send(std::make_shared<Message>(tmBH, protocol::mtGET_OBJECTS));
+}
+
+void
+PeerImp::onMessage(std::shared_ptr<protocol::TMTransactions> const& m)
+{
+    if (!supportsFeature(ProtocolFeature::TxReduceRelay) ||
+        m->transactions_size() > Tuning::maxTxQueueSize)
+    {
+        fee_ = Resource::feeInvalidRequest;
+        return;
+    }
+
+    for (auto const& tx : m->transactions())
+        handleTransaction(tx);
+}
+
 //--------------------------------------------------------------------------
 
 void
@@ -2286,7 +2626,8 @@ PeerImp::doFetchPack(const std::shared_ptr<protocol::TMGetObjectByHash>& packet)
     // have some queued.
     if (app_.getFeeTrack().isLoadedLocal() ||
         (app_.getLedgerMaster().getValidatedLedgerAge() > 40s) ||
-        (app_.getJobQueue().getJobCount(jtPACK) > 10))
+        (app_.getJobQueue().getJobCount(jtPACK) > 10) ||
+        app_.getJobQueue().isBehind(jtPACK))
     {
         JLOG(p_journal_.info()) << "Too busy to make fetch pack";
         return;
@@ -2312,12 +2653,61 @@ PeerImp::doFetchPack(const std::shared_ptr<protocol::TMGetObjectByHash>& packet)
         });
 }
 
+void
+PeerImp::doTransactions(
+    std::shared_ptr<protocol::TMGetObjectByHash> const& packet)
+{
+    if (!supportsFeature(ProtocolFeature::TxReduceRelay) ||
+        packet->objects_size() > Tuning::maxTxQueueSize)
+    {
+        fee_ = Resource::feeInvalidRequest;
+        return;
+    }
+
+    fee_ = Resource::feeMediumBurdenPeer;
+
+    protocol::TMTransactions reply;
+    for (auto const& obj : packet->objects())
+    {
+        if (!obj.has_hash() || !stringIsUint256Sized(obj.hash()))
+        {
+            fee_ = Resource::feeInvalidRequest;
+            return;
+        }
+
+        // Only transactions we still hold are sent; the peer learns of
+        // the others again from whoever relays them next.
+        auto const txn =
+            app_.getMasterTransaction().fetch_from_cache(uint256{obj.hash()});
+        if (!txn)
+            continue;
+
+        Serializer s;
+        txn->getSTransaction()->add(s);
+        auto& tx = *reply.add_transactions();
+        tx.set_rawtransaction(s.data(), s.size());
+        tx.set_status(
+            txn->getStatus() == INCLUDED ? protocol::tsCURRENT
+                                         : protocol::tsNEW);
+        tx.set_receivetimestamp(
+            app_.timeKeeper().now().time_since_epoch().count());
+    }
+
+    JLOG(p_journal_.trace()) << "Transactions: " << reply.transactions_size()
+                             << " of " << packet->objects_size();
+
+    if (reply.transactions_size() > 0)
+        send(std::make_shared<Message>(reply, protocol::mtTRANSACTIONS));
+}
+
 void
 PeerImp::checkTransaction(
     int flags,
     bool checkSignature,
     std::shared_ptr<STTx const> const& stx)
 {
+    perf::trace::Span span("peer.check", stx->getTransactionID());
+
     // VFALCO TODO Rewrite to not use exceptions
     try
     {
@@ -2334,12 +2724,20 @@ PeerImp::checkTransaction(
         if (checkSignature)
         {
             // Check the signature before handing off to the job queue.
-            if (auto [valid, validReason] = checkValidity(
-                    app_.getHashRouter(),
-                    *stx,
-                    app_.getLedgerMaster().getValidatedRules(),
-                    app_.config());
-                valid != Validity::Valid)
+            auto [valid, validReason] = checkValidity(
+                app_.getHashRouter(),
+                *stx,
+                app_.getLedgerMaster().getValidatedRules(),
+                app_.config());
+
+            // Tell the cluster, unless it told us or was already told
+            if (overlay_.setup().clusterVerdicts &&
+                app_.getHashRouter().setFlags(
+                    stx->getTransactionID(), SF_CLUSTER))
+                overlay_.shareVerdict(
+                    stx->getTransactionID(), valid != Validity::SigBad);
+
+            if (valid != Validity::Valid)
             {
                 if (!validReason.empty())
                 {
@@ -2399,17 +2797,17 @@ PeerImp::checkPropose(
 
     assert(packet);
 
-    if (!cluster() && !peerPos.checkSign())
-    {
-        JLOG(p_journal_.warn()) << "Proposal fails sig check";
-        charge(Resource::feeInvalidSignature);
-        return;
-    }
-
     bool relay;
 
     if (isTrusted)
+    {
+        if (packet->has_txsetsketch())
+            app_.getInboundTransactions().gotSketch(
+                peerPos.proposal().position(),
+                makeSlice(packet->txsetsketch()));
+
         relay = app_.getOPs().processTrustedProposal(peerPos);
+    }
     else
         relay = app_.config().RELAY_UNTRUSTED_PROPOSALS || cluster();
 
@@ -2439,14 +2837,8 @@ PeerImp::checkValidation(
 {
     try
     {
+        // The signature was checked by OverlayImpl::checkSignature
         // VFALCO Which functions throw?
-        if (!cluster() && !val->isValid())
-        {
-            JLOG(p_journal_.warn()) << "Validation is invalid";
-            charge(Resource::feeInvalidRequest);
-            return;
-        }
-
         if (app_.getOPs().recvValidation(val, std::to_string(id())) ||
             cluster())
         {
@@ -2529,9 +2921,157 @@ getPeerWithLedger(
     return ret;
 }
 
+// Identifies the reply to a request for nodes of a map, which depends
+// only on the ledger named in the reply, the map, the request and the
+// depth. Ledgers with the same map still get replies of their own, since
+// a reply naming the wrong ledger is dropped.
+//
+static uint256
+ledgerReplyKey(
+    SHAMap const& map,
+    protocol::TMGetLedger const& packet,
+    protocol::TMLedgerData const& reply,
+    std::uint32_t depth)
+{
+    Serializer s(128 + 40 * packet.nodeids_size());
+    s.addVL(reply.ledgerhash().data(), reply.ledgerhash().size());
+    s.add32(reply.ledgerseq());
+    s.addBitString(map.getHash().as_uint256());
+    s.add32(packet.itype());
+    s.add32(depth);
+    for (auto const& nodeID : packet.nodeids())
+        s.addVL(nodeID.data(), nodeID.size());
+    return s.getSHA512Half();
+}
+
 // VFALCO NOTE This function is way too big and cumbersome.
 void
-PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
+PeerImp::getObjects(
+    std::shared_ptr<protocol::TMGetObjectByHash> const& packet,
+    std::shared_ptr<protocol::TMGetObjectByHash> const& reply)
+{
+    std::vector<int> wanted;
+    std::vector<uint256> hashes;
+    for (int i = 0; i < packet->objects_size(); ++i)
+    {
+        auto const& obj = packet->objects(i);
+        if (obj.has_hash() && stringIsUint256Sized(obj.hash()))
+        {
+            wanted.push_back(i);
+            hashes.emplace_back(obj.hash());
+        }
+    }
+
+    // Objects which aren't cached are read by the node store's read
+    // threads, and the reply is sent once they are all done, so serving
+    // the request never waits on the disk.
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    app_.getNodeStore().fetchBatchAsync(
+        hashes,
+        0,
+        NodeStore::FetchPriority::low,
+        [weak, packet, reply, wanted = std::move(wanted)](
+            std::vector<std::shared_ptr<NodeObject>> found) {
+            if (auto peer = weak.lock())
+                peer->getShardObjects(packet, reply, wanted, std::move(found));
+        });
+}
+
+void
+PeerImp::getShardObjects(
+    std::shared_ptr<protocol::TMGetObjectByHash> const& packet,
+    std::shared_ptr<protocol::TMGetObjectByHash> const& reply,
+    std::vector<int> wanted,
+    std::vector<std::shared_ptr<NodeObject>> found)
+{
+    // Look for the objects the node store doesn't have in the shard store,
+    // which finds objects by ledger
+    std::map<std::uint32_t, std::vector<std::size_t>> missing;
+    auto shardStore = app_.getShardStore();
+    if (shardStore)
+    {
+        for (std::size_t i = 0; i < wanted.size(); ++i)
+        {
+            auto const& obj = packet->objects(wanted[i]);
+            std::uint32_t seq{obj.has_ledgerseq() ? obj.ledgerseq() : 0};
+            if (!found[i] && seq >= shardStore->earliestLedgerSeq())
+                missing[seq].push_back(i);
+        }
+    }
+
+    if (missing.empty())
+        return sendObjects(*packet, *reply, wanted, found);
+
+    struct State
+    {
+        std::vector<int> wanted;
+        std::vector<std::shared_ptr<NodeObject>> found;
+        std::atomic<std::size_t> remaining;
+    };
+    auto state = std::make_shared<State>();
+    state->wanted = std::move(wanted);
+    state->found = std::move(found);
+    state->remaining = missing.size();
+
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    for (auto& [seq, indexes] : missing)
+    {
+        std::vector<uint256> hashes;
+        hashes.reserve(indexes.size());
+        for (auto const i : indexes)
+            hashes.emplace_back(packet->objects(state->wanted[i]).hash());
+
+        shardStore->fetchBatchAsync(
+            hashes,
+            seq,
+            NodeStore::FetchPriority::low,
+            [weak, packet, reply, state, indexes = std::move(indexes)](
+                std::vector<std::shared_ptr<NodeObject>> found) {
+                for (std::size_t i = 0; i < indexes.size(); ++i)
+                    state->found[indexes[i]] = std::move(found[i]);
+                if (--state->remaining != 0)
+                    return;
+                if (auto peer = weak.lock())
+                    peer->sendObjects(
+                        *packet, *reply, state->wanted, state->found);
+            });
+    }
+}
+
+void
+PeerImp::sendObjects(
+    protocol::TMGetObjectByHash const& packet,
+    protocol::TMGetObjectByHash& reply,
+    std::vector<int> const& wanted,
+    std::vector<std::shared_ptr<NodeObject>> const& found)
+{
+    for (std::size_t i = 0; i < wanted.size(); ++i)
+    {
+        auto const& nodeObject = found[i];
+        if (!nodeObject)
+            continue;
+
+        auto const& obj = packet.objects(wanted[i]);
+        protocol::TMIndexedObject& newObj = *reply.add_objects();
+        newObj.set_hash(obj.hash());
+        newObj.set_data(
+            nodeObject->getData().data(), nodeObject->getData().size());
+
+        if (obj.has_nodeid())
+            newObj.set_index(obj.nodeid());
+        if (obj.has_ledgerseq())
+            newObj.set_ledgerseq(obj.ledgerseq());
+
+        // VFALCO NOTE "seq" in the message is obsolete
+    }
+
+    JLOG(p_journal_.trace()) << "GetObj: " << reply.objects_size() << " of "
+                             << packet.objects_size();
+    send(std::make_shared<Message>(reply, protocol::mtGET_OBJECTS));
+}
+
+void
+PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m, int reads)
 {
     protocol::TMGetLedger& packet = *m;
     std::shared_ptr<SHAMap> shared;
@@ -2539,6 +3079,7 @@ PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
     protocol::TMLedgerData reply;
     bool fatLeaves = true;
     std::shared_ptr<Ledger const> ledger;
+    NodeStore::Database* db = &app_.getNodeStore();
 
     if (packet.has_requestcookie())
         reply.set_requestcookie(packet.requestcookie());
@@ -2593,7 +3134,7 @@ PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
     }
     else
     {
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (largeSendQueue())
         {
             JLOG(p_journal_.debug()) << "GetLedger: Large send queue";
             return;
@@ -2628,7 +3169,10 @@ PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
                 {
                     auto seq = packet.ledgerseq();
                     if (seq >= shardStore->earliestLedgerSeq())
+                    {
                         ledger = shardStore->fetchLedger(ledgerhash, seq);
+                        db = shardStore;
+                    }
                 }
             }
 
@@ -2786,6 +3330,62 @@ PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
         ? (std::min(packet.querydepth(), 3u))
         : (isHighLatency() ? 2 : 1);
 
+    // When a ledger closes, many peers ask for the same nodes at about
+    // the same time. Serve them all with one reply, compressed once.
+    // Routed requests carry a cookie in the reply and are not shared.
+    boost::optional<uint256> replyKey;
+    if (!packet.has_requestcookie())
+    {
+        replyKey = ledgerReplyKey(*map, packet, reply, depth);
+        if (auto const cached = overlay_.findLedgerReply(*replyKey))
+        {
+            JLOG(p_journal_.trace()) << "GetLedger: Cached reply " << logMe;
+            send(cached);
+            return;
+        }
+    }
+
+    // Rather than hold this job while the nodes which aren't in memory are
+    // read one by one, have the node store read them all, and handle the
+    // request again once they are done. Each round reaches the nodes
+    // below those read in the last one.
+    if (reads < Tuning::maxLedgerReadRounds)
+    {
+        std::vector<uint256> pending;
+        for (int i = 0; i < packet.nodeids().size(); ++i)
+        {
+            if (auto const mn = deserializeSHAMapNodeID(packet.nodeids(i)))
+            {
+                auto const nodes = map->getNodeFatReads(*mn, depth);
+                pending.insert(pending.end(), nodes.begin(), nodes.end());
+            }
+        }
+
+        if (!pending.empty())
+        {
+            JLOG(p_journal_.trace()) << "GetLedger: Reading " << pending.size()
+                                     << " nodes for " << logMe;
+            std::weak_ptr<PeerImp> weak = shared_from_this();
+            db->fetchBatchAsync(
+                pending,
+                ledger ? ledger->info().seq : 0,
+                NodeStore::FetchPriority::low,
+                [weak, m, reads](std::vector<std::shared_ptr<NodeObject>>) {
+                    auto peer = weak.lock();
+                    if (!peer)
+                        return;
+                    peer->app_.getJobQueue().addJob(
+                        jtLEDGER_REQ,
+                        "recvGetLedger",
+                        peer->timeJob([weak, m, reads](Job&) {
+                            if (auto peer = weak.lock())
+                                peer->getLedger(m, reads + 1);
+                        }));
+                });
+            return;
+        }
+    }
+
     for (int i = 0;
          (i < packet.nodeids().size() &&
           (reply.nodes().size() < Tuning::maxReplyNodes));
@@ -2856,9 +3456,89 @@ PeerImp::getLedger(std::shared_ptr<protocol::TMGetLedger> const& m)
         << depth << ", return " << reply.nodes().size() << " nodes";
 
     auto oPacket = std::make_shared<Message>(reply, protocol::mtLEDGER_DATA);
+    if (replyKey)
+        overlay_.cacheLedgerReply(*replyKey, oPacket);
     send(oPacket);
 }
 
+void
+PeerImp::getLedgerDelta(std::shared_ptr<protocol::TMGetLedgerDelta> const& m)
+{
+    if (largeSendQueue())
+    {
+        JLOG(p_journal_.debug()) << "GetLedgerDelta: Large send queue";
+        return;
+    }
+
+    if (app_.getFeeTrack().isLoadedLocal() && !cluster())
+    {
+        JLOG(p_journal_.debug()) << "GetLedgerDelta: Too busy";
+        return;
+    }
+
+    uint256 const hash{m->ledgerhash()};
+    uint256 const baseHash{m->basehash()};
+
+    auto& ledgerMaster = app_.getLedgerMaster();
+    auto const ledger = ledgerMaster.getLedgerByHash(hash);
+    auto const base = ledger ? ledgerMaster.getLedgerByHash(baseHash) : nullptr;
+    if (!ledger || !base)
+    {
+        // The peer falls back to asking for the nodes one level at a time
+        JLOG(p_journal_.trace())
+            << "GetLedgerDelta: Don't have " << (ledger ? baseHash : hash);
+        return;
+    }
+
+    if ((ledger->info().seq != m->ledgerseq()) ||
+        ((ledger->info().parentHash != baseHash) &&
+         (base->info().parentHash != hash)))
+    {
+        charge(Resource::feeInvalidRequest);
+        JLOG(p_journal_.warn()) << "GetLedgerDelta: Ledgers not adjacent";
+        return;
+    }
+
+    if (ledger->info().seq < ledgerMaster.getEarliestFetch())
+    {
+        JLOG(p_journal_.debug()) << "GetLedgerDelta: Early ledger request";
+        return;
+    }
+
+    std::vector<std::pair<SHAMapNodeID, Blob>> nodes;
+    bool complete = false;
+    try
+    {
+        complete = ledger->stateMap().getDeltaNodes(
+            base->stateMap(), nodes, Tuning::maxReplyNodes);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(p_journal_.warn()) << "GetLedgerDelta: " << e.what();
+        return;
+    }
+
+    if (nodes.empty())
+        return;
+
+    protocol::TMLedgerData reply;
+    reply.set_ledgerhash(hash.begin(), hash.size());
+    reply.set_ledgerseq(ledger->info().seq);
+    reply.set_type(protocol::liAS_NODE);
+    for (auto const& [nodeID, rawNode] : nodes)
+    {
+        protocol::TMLedgerNode* node = reply.add_nodes();
+        node->set_nodeid(nodeID.getRawString());
+        node->set_nodedata(rawNode.data(), rawNode.size());
+    }
+
+    JLOG(p_journal_.info())
+        << "Got delta request for ledger " << ledger->info().seq << ", return "
+        << nodes.size() << (complete ? "" : " (truncated)") << " nodes";
+
+    send(std::make_shared<Message>(reply, protocol::mtLEDGER_DATA));
+}
+
 int
 PeerImp::getScore(bool haveItem) const
 {
@@ -23,7 +23,9 @@
 #include <ripple/app/consensus/RCLCxPeerPos.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/RangeSet.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/beast/utility/WrappedSink.h>
+#include <ripple/nodestore/NodeObject.h>
 #include <ripple/overlay/Squelch.h>
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/impl/ProtocolMessage.h>
@@ -38,8 +40,9 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/optional.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <array>
 #include <cstdint>
-#include <queue>
+#include <deque>
 
 namespace ripple {
 
@@ -118,6 +121,10 @@ private:
 
     squelch::Squelch<UptimeClock> squelch_;
 
+    // Transactions to announce to this peer by hash
+    std::mutex txQueueMutex_;
+    hash_set<uint256> txQueue_;
+
     // Notes on thread locking:
     //
     // During an audit it was noted that some member variables that looked
@@ -154,10 +161,26 @@ private:
     http_request_type request_;
     http_response_type response_;
     boost::beast::http::fields const& headers_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    // Messages waiting to be sent, one queue for each priority
+    std::array<std::deque<std::shared_ptr<Message>>, Message::priorities>
+        send_queue_;
+    // Messages from the front of each queue in the write in progress
+    std::array<std::size_t, Message::priorities> sendq_writing_{};
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
+    // Messages being decoded off the strand
+    std::size_t deferred_decodes_ = 0;
     std::unique_ptr<LoadEvent> load_event_;
+    // The category and arrival time of the message being handled, and
+    // whether it was handed to a job which times its handling instead
+    TrafficCount::category msgCategory_ = TrafficCount::category::unknown;
+    clock_type::time_point msgReceived_;
+    bool msgQueued_ = false;
+    // The depth of the send queue as messages join it
+    TrafficCount::Histogram sendQueueDepth_;
+    // The time taken by each write, and the start of the current one
+    TrafficCount::Histogram writeLatency_;
+    clock_type::time_point writeStarted_;
     // The highest sequence of each PublisherList that has
     // been sent to or received from this peer.
     hash_map<PublicKey, std::size_t> publisherListSequences_;
@@ -166,6 +189,8 @@ private:
     hash_map<PublicKey, ShardInfo> shardInfo_;
 
     Compressed compressionEnabled_ = Compressed::Off;
+    // The dictionary agreed on for consensus messages, if any
+    compression::Dictionary const* dictionary_ = nullptr;
 
     friend class OverlayImpl;
 
@@ -263,6 +288,18 @@ public:
     void
     send(std::shared_ptr<Message> const& m) override;
 
+    /** Queue the hash of a transaction to announce to this peer. */
+    void
+    addTxQueue(uint256 const& hash);
+
+    /** Announce the queued transaction hashes. */
+    void
+    sendTxQueue();
+
+    /** Stop announcing a transaction the peer is known to have. */
+    void
+    removeTxQueue(uint256 const& hash);
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <
         class FwdIt,
@@ -402,6 +439,12 @@ public:
         return compressionEnabled_ == Compressed::On;
     }
 
+    compression::Dictionary const*
+    compressionDictionary() const
+    {
+        return dictionary_;
+    }
+
 private:
     void
     close();
@@ -453,6 +496,23 @@ private:
     void
     onReadMessage(error_code ec, std::size_t bytes_transferred);
 
+    // The number of messages waiting to be sent, of every priority
+    std::size_t
+    sendQueueSize() const;
+
+    // Whether too much is waiting to be sent to answer queries
+    bool
+    largeSendQueue() const;
+
+    // Starts writing as many queued messages as fit in one gathered write,
+    // most urgent first
+    void
+    writeQueued();
+
+    // Called on the strand when a deferred message has been decoded
+    void
+    onMessageDecoded(std::function<bool(PeerImp&)> const& dispatch);
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage(error_code ec, std::size_t bytes_transferred);
@@ -467,6 +527,13 @@ public:
     void
     onMessageUnknown(std::uint16_t type);
 
+    /** Return `true` to decode the message on the job queue. */
+    bool
+    deferDecode(detail::MessageHeader const& header) const;
+
+    void
+    decodeDeferred(std::function<std::function<bool(PeerImp&)>()> decode);
+
     void
     onMessageBegin(
         std::uint16_t type,
@@ -501,6 +568,8 @@ public:
     void
     onMessage(std::shared_ptr<protocol::TMLedgerData> const& m);
     void
+    onMessage(std::shared_ptr<protocol::TMGetLedgerDelta> const& m);
+    void
     onMessage(std::shared_ptr<protocol::TMProposeSet> const& m);
     void
     onMessage(std::shared_ptr<protocol::TMStatusChange> const& m);
@@ -514,6 +583,12 @@ public:
     onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m);
     void
     onMessage(std::shared_ptr<protocol::TMSquelch> const& m);
+    void
+    onMessage(std::shared_ptr<protocol::TMTransactionVerdicts> const& m);
+    void
+    onMessage(std::shared_ptr<protocol::TMHaveTransactions> const& m);
+    void
+    onMessage(std::shared_ptr<protocol::TMTransactions> const& m);
 
 private:
     //--------------------------------------------------------------------------
@@ -527,12 +602,42 @@ private:
     void
     doFetchPack(const std::shared_ptr<protocol::TMGetObjectByHash>& packet);
 
+    void
+    doTransactions(std::shared_ptr<protocol::TMGetObjectByHash> const& packet);
+
+    // Look up the objects asked for by a request and send the reply.
+    void
+    getObjects(
+        std::shared_ptr<protocol::TMGetObjectByHash> const& packet,
+        std::shared_ptr<protocol::TMGetObjectByHash> const& reply);
+
+    // Look up the objects not found in the node store in the shard store.
+    // `wanted` holds the indexes of the objects in the request which are
+    // looked for and `found` the objects found so far, in the same order.
+    void
+    getShardObjects(
+        std::shared_ptr<protocol::TMGetObjectByHash> const& packet,
+        std::shared_ptr<protocol::TMGetObjectByHash> const& reply,
+        std::vector<int> wanted,
+        std::vector<std::shared_ptr<NodeObject>> found);
+
+    void
+    sendObjects(
+        protocol::TMGetObjectByHash const& packet,
+        protocol::TMGetObjectByHash& reply,
+        std::vector<int> const& wanted,
+        std::vector<std::shared_ptr<NodeObject>> const& found);
+
+    void
+    handleTransaction(protocol::TMTransaction const& m);
+
     void
     checkTransaction(
         int flags,
         bool checkSignature,
         std::shared_ptr<STTx const> const& stx);
 
+    // Process a proposal or validation once its signature is verified
     void
     checkPropose(
         Job& job,
@@ -544,8 +649,20 @@ private:
         std::shared_ptr<STValidation> const& val,
         std::shared_ptr<protocol::TMValidation> const& packet);
 
+    // `reads` counts the times the request has waited for the node store
+    void
+    getLedger(
+        std::shared_ptr<protocol::TMGetLedger> const& packet,
+        int reads = 0);
+
     void
-    getLedger(std::shared_ptr<protocol::TMGetLedger> const& packet);
+    getLedgerDelta(std::shared_ptr<protocol::TMGetLedgerDelta> const& packet);
+
+    // Wraps the job the message being handled is passed to, recording how
+    // long the job waits to start and how long it runs
+    template <class Handler>
+    std::function<void(Job&)>
+    timeJob(Handler&& handler);
 };
 
 //------------------------------------------------------------------------------
@@ -592,6 +709,11 @@ PeerImp::PeerImp(
           headers_["X-Offer-Compression"] == "lz4" && app_.config().COMPRESSION
               ? Compressed::On
               : Compressed::Off)
+    , dictionary_(
+          compressionEnabled_ == Compressed::On
+              ? negotiateCompressionDictionary(
+                    headers_, overlay_.compressionDictionary())
+              : nullptr)
 {
     read_buffer_.commit(boost::asio::buffer_copy(
         read_buffer_.prepare(boost::asio::buffer_size(buffers)), buffers));
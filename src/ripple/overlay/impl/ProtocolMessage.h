@@ -23,13 +23,17 @@
 #include <ripple/basics/ByteUtilities.h>
 #include <ripple/overlay/Compression.h>
 #include <ripple/overlay/Message.h>
+#include <ripple/overlay/impl/Tuning.h>
 #include <ripple/overlay/impl/ZeroCopyStream.h>
 #include <ripple/protocol/messages.h>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <google/protobuf/arena.h>
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -79,6 +83,14 @@ protocolMessageName(int type)
             return "get_objects";
         case protocol::mtSQUELCH:
             return "squelch";
+        case protocol::mtHAVE_TRANSACTIONS:
+            return "have_transactions";
+        case protocol::mtTRANSACTIONS:
+            return "transactions";
+        case protocol::mtGET_LEDGER_DELTA:
+            return "get_ledger_delta";
+        case protocol::mtTRANSACTION_VERDICTS:
+            return "transaction_verdicts";
         default:
             break;
     }
@@ -161,7 +173,8 @@ parseMessageHeader(
 
         hdr.algorithm = static_cast<compression::Algorithm>(*iter);
 
-        if (hdr.algorithm != compression::Algorithm::LZ4)
+        if (hdr.algorithm != compression::Algorithm::LZ4 &&
+            hdr.algorithm != compression::Algorithm::LZ4Dictionary)
         {
             ec = make_error_code(boost::system::errc::protocol_error);
             return boost::none;
@@ -212,16 +225,51 @@ parseMessageHeader(
     return boost::none;
 }
 
+/** Parse the message in the passed buffers.
+
+    @param dictionary The dictionary negotiated for the link, if any.
+    @return The message, or `nullptr` if it is malformed.
+*/
+// Replies carrying many ledger nodes or objects are parsed into an arena,
+// so that the message and its hundreds of nodes are carved out of a few
+// blocks, rather than allocated one at a time, and all freed together.
+template <class T>
+constexpr bool parseOnArena = std::is_same_v<T, protocol::TMLedgerData> ||
+    std::is_same_v<T, protocol::TMGetObjectByHash>;
+
+template <class T>
+std::shared_ptr<T>
+makeMessage()
+{
+    if constexpr (parseOnArena<T>)
+    {
+        ::google::protobuf::ArenaOptions options;
+        options.start_block_size = Tuning::arenaStartBlock;
+        options.max_block_size = Tuning::arenaMaxBlock;
+        auto const arena = std::make_shared<::google::protobuf::Arena>(options);
+
+        // The message shares ownership of the arena which holds it
+        return std::shared_ptr<T>(
+            arena, ::google::protobuf::Arena::CreateMessage<T>(arena.get()));
+    }
+    else
+    {
+        return std::make_shared<T>();
+    }
+}
+
 template <
     class T,
     class Buffers,
-    class Handler,
     class = std::enable_if_t<
         std::is_base_of<::google::protobuf::Message, T>::value>>
-bool
-invoke(MessageHeader const& header, Buffers const& buffers, Handler& handler)
+std::shared_ptr<T>
+parseMessage(
+    MessageHeader const& header,
+    Buffers const& buffers,
+    compression::Dictionary const* dictionary)
 {
-    auto const m = std::make_shared<T>();
+    auto const m = makeMessage<T>();
 
     ZeroCopyInputStream<Buffers> stream(buffers);
     stream.Skip(header.header_size);
@@ -236,18 +284,79 @@ invoke(MessageHeader const& header, Buffers const& buffers, Handler& handler)
             header.payload_wire_size,
             payload.data(),
             header.uncompressed_size,
-            header.algorithm);
+            header.algorithm,
+            dictionary);
 
         if (payloadSize == 0 || !m->ParseFromArray(payload.data(), payloadSize))
-            return false;
+            return nullptr;
     }
     else if (!m->ParseFromZeroCopyStream(&stream))
-        return false;
+        return nullptr;
+
+    return m;
+}
 
+template <class T, class Handler>
+void
+dispatchMessage(
+    MessageHeader const& header,
+    std::shared_ptr<T> const& m,
+    Handler& handler)
+{
     handler.onMessageBegin(header.message_type, m, header.payload_wire_size);
     handler.onMessage(m);
     handler.onMessageEnd(header.message_type, m);
+}
+
+template <class T, class Buffers, class Handler>
+bool
+invoke(MessageHeader const& header, Buffers const& buffers, Handler& handler)
+{
+    auto const m =
+        parseMessage<T>(header, buffers, handler.compressionDictionary());
+    if (!m)
+        return false;
 
+    dispatchMessage(header, m, handler);
+    return true;
+}
+
+/** Like invoke, but lets the handler decode the message elsewhere.
+
+    If `handler.deferDecode(header)` returns `true`, the message is copied
+    out of the buffers and passed to `handler.decodeDeferred`, which may
+    run the decoder on any thread. The decoder returns a function which
+    the handler must call on its own thread to deliver the message; that
+    function returns `false` if the message was malformed.
+*/
+template <class T, class Buffers, class Handler>
+bool
+invokeDeferrable(
+    MessageHeader const& header,
+    Buffers const& buffers,
+    Handler& handler)
+{
+    if (!handler.deferDecode(header))
+        return invoke<T>(header, buffers, handler);
+
+    auto const message =
+        std::make_shared<std::vector<std::uint8_t>>(header.total_wire_size);
+    boost::asio::buffer_copy(boost::asio::buffer(*message), buffers);
+
+    // Dictionaries stay registered for the life of the process
+    handler.decodeDeferred(
+        [header, message, dictionary = handler.compressionDictionary()]()
+            -> std::function<bool(Handler&)> {
+            std::array<boost::asio::const_buffer, 1> const buffers{
+                {boost::asio::buffer(*message)}};
+            auto const m = parseMessage<T>(header, buffers, dictionary);
+            return [header, m](Handler& h) {
+                if (!m)
+                    return false;
+                dispatchMessage(header, m, h);
+                return true;
+            };
+        });
     return true;
 }
 
@@ -308,6 +417,15 @@ invokeProtocolMessage(
         return result;
     }
 
+    // We didn't agree on a dictionary but received a message compressed
+    // with one.
+    if (header->algorithm == compression::Algorithm::LZ4Dictionary &&
+        !handler.compressionDictionary())
+    {
+        result.second = make_error_code(boost::system::errc::protocol_error);
+        return result;
+    }
+
     // We don't have the whole message yet. This isn't an error but we have
     // nothing to do.
     if (header->total_wire_size > size)
@@ -361,7 +479,7 @@ invokeProtocolMessage(
                 *header, buffers, handler);
             break;
         case protocol::mtLEDGER_DATA:
-            success = detail::invoke<protocol::TMLedgerData>(
+            success = detail::invokeDeferrable<protocol::TMLedgerData>(
                 *header, buffers, handler);
             break;
         case protocol::mtPROPOSE_LEDGER:
@@ -385,13 +503,29 @@ invokeProtocolMessage(
                 *header, buffers, handler);
             break;
         case protocol::mtGET_OBJECTS:
-            success = detail::invoke<protocol::TMGetObjectByHash>(
+            success = detail::invokeDeferrable<protocol::TMGetObjectByHash>(
                 *header, buffers, handler);
             break;
         case protocol::mtSQUELCH:
             success =
                 detail::invoke<protocol::TMSquelch>(*header, buffers, handler);
             break;
+        case protocol::mtHAVE_TRANSACTIONS:
+            success = detail::invoke<protocol::TMHaveTransactions>(
+                *header, buffers, handler);
+            break;
+        case protocol::mtTRANSACTIONS:
+            success = detail::invoke<protocol::TMTransactions>(
+                *header, buffers, handler);
+            break;
+        case protocol::mtGET_LEDGER_DELTA:
+            success = detail::invoke<protocol::TMGetLedgerDelta>(
+                *header, buffers, handler);
+            break;
+        case protocol::mtTRANSACTION_VERDICTS:
+            success = detail::invoke<protocol::TMTransactionVerdicts>(
+                *header, buffers, handler);
+            break;
         default:
             handler.onMessageUnknown(header->message_type);
             success = true;
@@ -38,7 +38,9 @@ constexpr ProtocolVersion const supportedProtocolList[]
 {
     {1, 2},
     {2, 0},
-    {2, 1}
+    {2, 1},
+    {2, 2},
+    {2, 3}
 };
 // clang-format on
 
@@ -21,6 +21,32 @@
 
 namespace ripple {
 
+std::uint64_t
+TrafficCount::Histogram::count() const
+{
+    std::uint64_t total = 0;
+    for (auto const& c : counts_)
+        total += c.load();
+    return total;
+}
+
+Json::Value
+TrafficCount::Histogram::json() const
+{
+    Json::Value ret(Json::objectValue);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (auto const c = counts_[i].load())
+        {
+            auto const key = i + 1 < size
+                ? "<" + std::to_string(std::uint64_t{1} << i)
+                : ">=" + std::to_string(std::uint64_t{1} << (i - 1));
+            ret[key] = std::to_string(c);
+        }
+    }
+    return ret;
+}
+
 TrafficCount::category
 TrafficCount::categorize(
     ::google::protobuf::Message const& message,
@@ -30,7 +56,8 @@ TrafficCount::categorize(
     if ((type == protocol::mtPING) || (type == protocol::mtSTATUS_CHANGE))
         return TrafficCount::category::base;
 
-    if (type == protocol::mtCLUSTER)
+    if ((type == protocol::mtCLUSTER) ||
+        (type == protocol::mtTRANSACTION_VERDICTS))
         return TrafficCount::category::cluster;
 
     if (type == protocol::mtMANIFESTS)
@@ -45,7 +72,9 @@ TrafficCount::categorize(
         (type == protocol::mtPEER_SHARD_INFO))
         return TrafficCount::category::shards;
 
-    if (type == protocol::mtTRANSACTION)
+    if ((type == protocol::mtTRANSACTION) ||
+        (type == protocol::mtHAVE_TRANSACTIONS) ||
+        (type == protocol::mtTRANSACTIONS))
         return TrafficCount::category::transaction;
 
     if (type == protocol::mtVALIDATORLIST)
@@ -83,6 +112,10 @@ TrafficCount::categorize(
             : TrafficCount::category::ld_share;
     }
 
+    if (type == protocol::mtGET_LEDGER_DELTA)
+        return inbound ? TrafficCount::category::gl_asn_share
+                       : TrafficCount::category::gl_asn_get;
+
     if (auto msg = dynamic_cast<protocol::TMGetLedger const*>(&message))
     {
         if (msg->itype() == protocol::liTS_CANDIDATE)
@@ -112,7 +145,8 @@ TrafficCount::categorize(
                 ? TrafficCount::category::share_hash_ledger
                 : TrafficCount::category::get_hash_ledger;
 
-        if (msg->type() == protocol::TMGetObjectByHash::otTRANSACTION)
+        if ((msg->type() == protocol::TMGetObjectByHash::otTRANSACTION) ||
+            (msg->type() == protocol::TMGetObjectByHash::otTRANSACTIONS))
             return (msg->query() == inbound)
                 ? TrafficCount::category::share_hash_tx
                 : TrafficCount::category::get_hash_tx;
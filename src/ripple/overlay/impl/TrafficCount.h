@@ -21,10 +21,12 @@
 #define RIPPLE_OVERLAY_TRAFFIC_H_INCLUDED
 
 #include <ripple/basics/safe_cast.h>
+#include <ripple/json/json_value.h>
 #include <ripple/protocol/messages.h>
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 
 namespace ripple {
@@ -32,6 +34,56 @@ namespace ripple {
 class TrafficCount
 {
 public:
+    using clock_type = std::chrono::steady_clock;
+
+    /** Counts values in a bucket for each power of two.
+
+        Bucket 0 counts zero values and bucket i counts values from
+        2^(i-1) up to 2^i. The last bucket also counts every larger value.
+        Durations are counted in microseconds.
+    */
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t size = 32;
+
+        Histogram() = default;
+
+        Histogram(Histogram const& h)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                counts_[i] = h.counts_[i].load();
+        }
+
+        void
+        add(std::uint64_t value)
+        {
+            std::size_t i = 0;
+            for (; value != 0 && i + 1 < size; value >>= 1)
+                ++i;
+            ++counts_[i];
+        }
+
+        void
+        add(clock_type::duration d)
+        {
+            using namespace std::chrono;
+            auto const us = duration_cast<microseconds>(d).count();
+            add(us > 0 ? static_cast<std::uint64_t>(us) : 0);
+        }
+
+        /** Return the number of values counted */
+        std::uint64_t
+        count() const;
+
+        /** Return the non-empty buckets, keyed by their bounds */
+        Json::Value
+        json() const;
+
+    private:
+        std::array<std::atomic<std::uint64_t>, size> counts_{};
+    };
+
     class TrafficStats
     {
     public:
@@ -42,6 +94,11 @@ public:
         std::atomic<std::uint64_t> messagesIn{0};
         std::atomic<std::uint64_t> messagesOut{0};
 
+        // From receipt of a message until the job it was handed to starts
+        Histogram queued;
+        // Handling a message, in its job or else on the peer's strand
+        Histogram handled;
+
         TrafficStats(char const* n) : name(n)
         {
         }
@@ -52,6 +109,8 @@ public:
             , bytesOut(ts.bytesOut.load())
             , messagesIn(ts.messagesIn.load())
             , messagesOut(ts.messagesOut.load())
+            , queued(ts.queued)
+            , handled(ts.handled)
         {
         }
 
@@ -104,7 +163,7 @@ public:
         gl_txn_share,
         gl_txn_get,
 
-        // TMGetLedger: account state node
+        // TMGetLedger: account state node, and TMGetLedgerDelta
         gl_asn_share,
         gl_asn_get,
 
@@ -169,6 +228,36 @@ public:
         }
     }
 
+    /** Account for the time a message waited for its job to start */
+    void
+    addQueued(category cat, clock_type::duration d)
+    {
+        assert(cat <= category::unknown);
+        counts_[cat].queued.add(d);
+    }
+
+    /** Account for the time taken to handle a message */
+    void
+    addHandled(category cat, clock_type::duration d)
+    {
+        assert(cat <= category::unknown);
+        counts_[cat].handled.add(d);
+    }
+
+    /** Account for the depth of a peer's send queue as a message joins it */
+    void
+    addSendQueueDepth(std::size_t depth)
+    {
+        sendQueueDepth_.add(depth);
+    }
+
+    /** Account for the time taken by a write to a peer */
+    void
+    addWriteLatency(clock_type::duration d)
+    {
+        writeLatency_.add(d);
+    }
+
     TrafficCount() = default;
 
     /** An up-to-date copy of all the counters
@@ -181,7 +270,24 @@ public:
         return counts_;
     }
 
+    /** The depth of peers' send queues as messages are sent to them */
+    Histogram const&
+    getSendQueueDepth() const
+    {
+        return sendQueueDepth_;
+    }
+
+    /** The time taken by writes to peers */
+    Histogram const&
+    getWriteLatency() const
+    {
+        return writeLatency_;
+    }
+
 protected:
+    Histogram sendQueueDepth_;
+    Histogram writeLatency_;
+
     std::array<TrafficStats, category::unknown + 1> counts_{{
         {"overhead"},           // category::base
         {"overhead_cluster"},   // category::cluster
@@ -46,19 +46,61 @@ enum {
     /** How many messages on a send queue before we refuse queries */
     dropSendQueue = 192,
 
+    /** How many bulk replies on a send queue before we refuse queries */
+    dropBulkSendQueue = 96,
+
     /** How many messages we consider reasonable sustained on a send queue */
     targetSendQueue = 128,
 
+    /** How many bulk replies, which can be large, we consider reasonable
+        sustained on a send queue */
+    targetBulkSendQueue = 64,
+
     /** How often to log send queue size */
     sendQueueLogFreq = 64,
 
     /** How often we check for idle peers (seconds) */
     checkIdlePeers = 4,
+
+    /** The most transaction hashes announced in one message, or
+        requested in one query */
+    maxTxQueueSize = 1000,
+
+    /** How many messages from one peer may be decoded off its strand at
+        once before the rest are decoded on the strand again */
+    maxDeferredDecodes = 4,
+
+    /** The most transactions received from peers checked by one job */
+    txCheckBatch = 64,
+
+    /** The most validation or proposal signatures verified by one job */
+    sigCheckBatch = 32,
+
+    /** How many times a ledger request waits for the node store to read
+        the nodes it needs before it reads the rest itself */
+    maxLedgerReadRounds = 4,
 };
 
 /** Size of buffer used to read from the socket. */
 std::size_t constexpr readBufferBytes = 16384;
 
+/** How many replies to ledger data requests are kept to share between
+    peers asking for the same nodes. */
+int constexpr ledgerReplyCacheSize = 256;
+
+/** How long a ledger data reply is kept. Peers acquiring a new ledger
+    ask for the same nodes within moments of each other. */
+std::chrono::seconds constexpr ledgerReplyCacheAge{5};
+
+/** Most bytes of queued messages gathered into one write. A single
+    larger message is still written on its own. */
+std::size_t constexpr maxWriteBytes = 65536;
+
+/** The sizes of the blocks allocated for the arena of one message with
+    many ledger nodes or objects. */
+std::size_t constexpr arenaStartBlock = 16384;
+std::size_t constexpr arenaMaxBlock = 262144;
+
 }  // namespace Tuning
 
 }  // namespace ripple
@@ -27,10 +27,12 @@
 #include <ripple/peerfinder/PeerfinderManager.h>
 #include <ripple/peerfinder/impl/Tuning.h>
 #include <ripple/peerfinder/impl/iosformat.h>
-#include <boost/intrusive/list.hpp>
+#include <boost/iterator/counting_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 namespace ripple {
 namespace PeerFinder {
@@ -46,17 +48,40 @@ public:
     explicit LivecacheBase() = default;
 
 protected:
-    struct Element : boost::intrusive::list_base_hook<>
+    struct Element
     {
         Element(Endpoint const& endpoint_) : endpoint(endpoint_)
         {
         }
 
         Endpoint endpoint;
+
+        // Position in the list for the endpoint's hops
+        std::size_t index = 0;
     };
 
-    using list_type = boost::intrusive::
-        make_list<Element, boost::intrusive::constant_time_size<false>>::type;
+    // The endpoints at one hops. They are kept in a random order, so they
+    // can be handed out without shuffling the whole cache first, and the
+    // next handout starts at `front`.
+    struct list_type
+    {
+        std::vector<Element*> elements;
+        std::size_t front = 0;
+
+        std::size_t
+        size() const
+        {
+            return elements.size();
+        }
+
+        void
+        swap(std::size_t i, std::size_t j)
+        {
+            std::swap(elements[i], elements[j]);
+            elements[i]->index = i;
+            elements[j]->index = j;
+        }
+    };
 
 public:
     /** A list of Endpoint at the same hops
@@ -67,93 +92,97 @@ public:
     class Hop
     {
     public:
-        // Iterator transformation to extract the endpoint from Element
+        // Iterator transformation to extract the nth endpoint from the front
         struct Transform
-#ifdef _LIBCPP_VERSION
-            : public std::unary_function<Element, Endpoint>
-#endif
         {
-#ifndef _LIBCPP_VERSION
-            using first_argument = Element;
-            using result_type = Endpoint;
-#endif
+            using result_type = Endpoint const&;
 
-            explicit Transform() = default;
+            Transform() = default;
+
+            explicit Transform(list_type const& list) : list_(&list)
+            {
+            }
 
             Endpoint const&
-            operator()(Element const& e) const
+            operator()(std::size_t n) const
             {
-                return e.endpoint;
+                auto const& v = list_->elements;
+                return v[(list_->front + n) % v.size()]->endpoint;
             }
+
+        private:
+            list_type const* list_ = nullptr;
         };
 
     public:
-        using iterator = boost::
-            transform_iterator<Transform, typename list_type::const_iterator>;
+        using iterator = boost::transform_iterator<
+            Transform,
+            boost::counting_iterator<std::size_t>>;
 
         using const_iterator = iterator;
 
-        using reverse_iterator = boost::transform_iterator<
-            Transform,
-            typename list_type::const_reverse_iterator>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
 
         using const_reverse_iterator = reverse_iterator;
 
         iterator
         begin() const
         {
-            return iterator(m_list.get().cbegin(), Transform());
+            return iterator(0, Transform(m_list.get()));
         }
 
         iterator
         cbegin() const
         {
-            return iterator(m_list.get().cbegin(), Transform());
+            return begin();
         }
 
         iterator
         end() const
         {
-            return iterator(m_list.get().cend(), Transform());
+            return iterator(m_list.get().size(), Transform(m_list.get()));
         }
 
         iterator
         cend() const
         {
-            return iterator(m_list.get().cend(), Transform());
+            return end();
         }
 
         reverse_iterator
         rbegin() const
         {
-            return reverse_iterator(m_list.get().crbegin(), Transform());
+            return reverse_iterator(end());
         }
 
         reverse_iterator
         crbegin() const
         {
-            return reverse_iterator(m_list.get().crbegin(), Transform());
+            return rbegin();
         }
 
         reverse_iterator
         rend() const
         {
-            return reverse_iterator(m_list.get().crend(), Transform());
+            return reverse_iterator(begin());
         }
 
         reverse_iterator
         crend() const
         {
-            return reverse_iterator(m_list.get().crend(), Transform());
+            return rend();
         }
 
         // move the element to the end of the container
         void
         move_back(const_iterator pos)
         {
-            auto& e(const_cast<Element&>(*pos.base()));
-            m_list.get().erase(m_list.get().iterator_to(e));
-            m_list.get().push_back(e);
+            // Put the element at the front and step past it, which leaves
+            // it last while every other element keeps its place in line.
+            auto& list = m_list.get();
+            auto const n = list.size();
+            list.swap((list.front + *pos.base()) % n, list.front);
+            list.front = (list.front + 1) % n;
         }
 
     private:
@@ -348,7 +377,10 @@ public:
             return const_reverse_iterator(m_lists.crend(), Transform<true>());
         }
 
-        /** Shuffle each hop list. */
+        /** Shuffle each hop list.
+            The lists are always in a random order, so this is only needed
+            to start over with a new one.
+        */
         void
         shuffle();
 
@@ -508,13 +540,11 @@ Livecache<Allocator>::hops_t::shuffle()
 {
     for (auto& list : m_lists)
     {
-        std::vector<std::reference_wrapper<Element>> v;
-        v.reserve(list.size());
-        std::copy(list.begin(), list.end(), std::back_inserter(v));
-        std::shuffle(v.begin(), v.end(), default_prng());
-        list.clear();
-        for (auto& e : v)
-            list.push_back(e);
+        std::shuffle(
+            list.elements.begin(), list.elements.end(), default_prng());
+        for (std::size_t i = 0; i < list.size(); ++i)
+            list.elements[i]->index = i;
+        list.front = 0;
     }
 }
 
@@ -541,8 +571,14 @@ void
 Livecache<Allocator>::hops_t::insert(Element& e)
 {
     assert(e.endpoint.hops >= 0 && e.endpoint.hops <= Tuning::maxHops + 1);
-    // This has security implications without a shuffle
-    m_lists[e.endpoint.hops].push_front(e);
+    // Handing out endpoints in a predictable order has security
+    // implications, so put the new one in a random place.
+    list_type& list(m_lists[e.endpoint.hops]);
+    auto const n = list.size();
+    e.index = n;
+    list.elements.push_back(&e);
+    if (n != 0)
+        list.swap(n, rand_int(n));
     ++m_hist[e.endpoint.hops];
 }
 
@@ -551,9 +587,7 @@ void
 Livecache<Allocator>::hops_t::reinsert(Element& e, int numHops)
 {
     assert(numHops >= 0 && numHops <= Tuning::maxHops + 1);
-    list_type& list(m_lists[e.endpoint.hops]);
-    list.erase(list.iterator_to(e));
-    --m_hist[e.endpoint.hops];
+    remove(e);
 
     e.endpoint.hops = numHops;
     insert(e);
@@ -565,7 +599,11 @@ Livecache<Allocator>::hops_t::remove(Element& e)
 {
     --m_hist[e.endpoint.hops];
     list_type& list(m_lists[e.endpoint.hops]);
-    list.erase(list.iterator_to(e));
+    // Moving the last element into the gap keeps the order random
+    list.swap(e.index, list.size() - 1);
+    list.elements.pop_back();
+    if (list.front >= list.size())
+        list.front = 0;
 }
 
 }  // namespace PeerFinder
@@ -452,7 +452,6 @@ public:
     {
         std::lock_guard _(lock_);
         RedirectHandouts h(slot);
-        livecache_.hops.shuffle();
         handout(&h, (&h) + 1, livecache_.hops.begin(), livecache_.hops.end());
         return std::move(h.list());
     }
@@ -523,8 +522,7 @@ public:
         //    Any outbound attempts are in progress
         //
         {
-            livecache_.hops.shuffle();
-            handout(
+                handout(
                 &h, (&h) + 1, livecache_.hops.rbegin(), livecache_.hops.rend());
             if (!h.list().empty())
             {
@@ -643,8 +641,7 @@ public:
             }
 
             // build sequence of endpoints by hops
-            livecache_.hops.shuffle();
-            handout(
+                handout(
                 targets.begin(),
                 targets.end(),
                 livecache_.hops.begin(),
@@ -125,7 +125,8 @@ Config::makeConfig(
 
     // if it's a private peer or we are running as standalone
     // automatic connections would defeat the purpose.
-    config.autoConnect = !cfg.standalone() && !cfg.PEER_PRIVATE;
+    config.autoConnect =
+        !cfg.standalone() && !cfg.reporting() && !cfg.PEER_PRIVATE;
     config.listeningPort = port;
     config.features = "";
     config.ipLimit = ipLimit;
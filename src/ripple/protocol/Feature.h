@@ -113,7 +113,8 @@ class FeatureCollections
         "HardenedValidations",
         "fixAmendmentMajorityCalc",  // Fix Amendment majority calculation
         "NegativeUNL",
-        "TicketBatch"};
+        "TicketBatch",
+        "FlowSortStrands"};
 
     std::vector<uint256> features;
     boost::container::flat_map<uint256, std::size_t> featureToIndex;
@@ -371,6 +372,7 @@ extern uint256 const featureHardenedValidations;
 extern uint256 const fixAmendmentMajorityCalc;
 extern uint256 const featureNegativeUNL;
 extern uint256 const featureTicketBatch;
+extern uint256 const featureFlowSortStrands;
 
 }  // namespace ripple
 
@@ -84,6 +84,9 @@ enum class HashPrefix : std::uint32_t {
 
     /** Payment Channel Claim */
     paymentChannelClaim = detail::make_hash_prefix('C', 'L', 'M'),
+
+    /** The changes a ledger made to the state map, as stored locally */
+    stateDelta = detail::make_hash_prefix('S', 'D', 'L'),
 };
 
 template <class Hasher>
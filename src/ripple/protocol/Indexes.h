@@ -29,6 +29,7 @@
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
 #include <cstdint>
+#include <vector>
 
 namespace ripple {
 
@@ -50,9 +51,19 @@ class SeqProxy;
 namespace keylet {
 
 /** AccountID root */
+/** @{ */
 Keylet
 account(AccountID const& id) noexcept;
 
+/** The roots of many accounts at once.
+
+    This is faster than calling account() for each, as the keys are
+    hashed together.
+*/
+std::vector<Keylet>
+account(std::vector<AccountID> const& ids);
+/** @} */
+
 /** The index of the amendment table */
 Keylet const&
 amendments() noexcept;
@@ -119,6 +130,14 @@ line(AccountID const& id, Issue const& issue) noexcept
 {
     return line(id, issue.account, issue.currency);
 }
+
+/** The trust lines of one account for many issues at once.
+
+    This is faster than calling line() for each, as the keys are hashed
+    together.
+*/
+std::vector<Keylet>
+line(AccountID const& id, std::vector<Issue> const& issues);
 /** @} */
 
 /** An offer from an account */
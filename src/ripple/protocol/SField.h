@@ -22,6 +22,7 @@
 
 #include <ripple/basics/safe_cast.h>
 #include <ripple/json/json_value.h>
+#include <array>
 #include <cstdint>
 #include <map>
 #include <utility>
@@ -272,8 +273,26 @@ public:
     compare(const SField& f1, const SField& f2);
 
 private:
+    // Every field whose type and value each fit in a byte, which includes
+    // every field that can be serialized, is also kept in a table indexed
+    // directly by its code so that deserializing never searches the map.
+    static constexpr int directTypes = 32;
+    static constexpr int directValues = 256;
+
     static int num;
     static std::map<int, SField const*> knownCodeToField;
+    static std::array<SField const*, directTypes * directValues>
+        directCodeToField;
+
+    static std::size_t
+    directIndex(int code)
+    {
+        auto const type = code >> 16;
+        auto const value = code & 0xffff;
+        if (type < 0 || type >= directTypes || value >= directValues)
+            return directCodeToField.size();
+        return type * directValues + value;
+    }
 };
 
 /** A field with a type known at compile time. */
@@ -25,6 +25,7 @@
 #include <functional>
 #include <initializer_list>
 #include <memory>
+#include <stdexcept>
 
 namespace ripple {
 
@@ -129,7 +130,29 @@ public:
 
     /** Retrieve the position of a named field. */
     int
-    getIndex(SField const&) const;
+    getIndex(SField const& sField) const
+    {
+        // The mapping table should be large enough for any possible field
+        //
+        if (sField.getNum() <= 0 || sField.getNum() >= indices_.size())
+            Throw<std::runtime_error>("Invalid field index for getIndex().");
+
+        return indices_[sField.getNum()];
+    }
+
+    /** Retrieve the position of a field, or -1 if it is not in the template.
+
+        Unlike getIndex(), this accepts any field, so it may be used on
+        fields which did not come from a template.
+    */
+    int
+    find(SField const& sField) const noexcept
+    {
+        auto const num = sField.getNum();
+        if (num <= 0 || static_cast<std::size_t>(num) >= indices_.size())
+            return -1;
+        return indices_[num];
+    }
 
     SOEStyle
     style(SField const& sf) const
@@ -51,6 +51,17 @@ public:
 
     STLedgerEntry(STObject const& object, uint256 const& index);
 
+    /** Create an entry from serialized data, parsing it as it is used.
+
+        Reading a simple field like sfSequence or sfBalance decodes just
+        that field, so an entry which is only looked at briefly is never
+        parsed in full. `owner` must keep `data` alive and unchanged.
+    */
+    STLedgerEntry(
+        Slice data,
+        std::shared_ptr<void const> owner,
+        uint256 const& index);
+
     STBase*
     copy(std::size_t n, void* buf) const override
     {
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/FeeUnits.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/contract.h>
@@ -33,10 +34,13 @@
 #include <ripple/protocol/impl/STVar.h>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -246,11 +250,20 @@ private:
         }
     };
 
-    using list_type = std::vector<detail::STVar>;
+    using list_type = std::vector<
+        detail::STVar,
+        TaggedAllocator<detail::STVar, MemoryTag::stobject>>;
 
     list_type v_;
     SOTemplate const* mType;
 
+    // The serialized fields of an object which hasn't been parsed yet. Once
+    // it is parsed, lazy_ is cleared but the data is kept, since readers on
+    // other threads may still be using it.
+    struct LazyData;
+    mutable std::atomic<LazyData const*> lazy_{nullptr};
+    std::shared_ptr<LazyData const> lazyData_;
+
 public:
     using iterator = boost::
         transform_iterator<Transform, STObject::list_type::const_iterator>;
@@ -261,7 +274,7 @@ public:
     };
 
     STObject(STObject&&);
-    STObject(STObject const&) = default;
+    STObject(STObject const&);
     STObject(const SOTemplate& type, SField const& name);
     STObject(
         const SOTemplate& type,
@@ -274,7 +287,7 @@ public:
     {
     }
     STObject&
-    operator=(STObject const&) = default;
+    operator=(STObject const&);
     STObject&
     operator=(STObject&& other);
 
@@ -297,24 +310,28 @@ public:
     iterator
     begin() const
     {
+        materialize();
         return iterator(v_.begin());
     }
 
     iterator
     end() const
     {
+        materialize();
         return iterator(v_.end());
     }
 
     bool
     empty() const
     {
+        materialize();
         return v_.empty();
     }
 
     void
     reserve(std::size_t n)
     {
+        materialize();
         v_.reserve(n);
     }
 
@@ -345,6 +362,7 @@ public:
     virtual bool
     isDefault() const override
     {
+        materialize();
         return v_.empty();
     }
 
@@ -384,6 +402,7 @@ public:
     std::size_t
     emplace_back(Args&&... args)
     {
+        materialize();
         v_.emplace_back(std::forward<Args>(args)...);
         return v_.size() - 1;
     }
@@ -391,6 +410,7 @@ public:
     int
     getCount() const
     {
+        materialize();
         return v_.size();
     }
 
@@ -408,21 +428,25 @@ public:
     const STBase&
     peekAtIndex(int offset) const
     {
+        materialize();
         return v_[offset].get();
     }
     STBase&
     getIndex(int offset)
     {
+        materialize();
         return v_[offset].get();
     }
     const STBase*
     peekAtPIndex(int offset) const
     {
+        materialize();
         return &v_[offset].get();
     }
     STBase*
     getPIndex(int offset)
     {
+        materialize();
         return &v_[offset].get();
     }
 
@@ -646,6 +670,42 @@ public:
         return !(*this == o);
     }
 
+protected:
+    /** The position of a field in an object's serialized form. */
+    struct LazyField
+    {
+        SField const* field;
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    /** Find the fields of a serialized object without parsing them.
+
+        @return The fields, or nothing if the data can't be scanned. Parsing
+            the data then explains what is wrong with it.
+    */
+    static boost::optional<std::vector<LazyField>>
+    scanFields(Slice data);
+
+    /** Take the fields of the object from serialized data as they are used.
+
+        A field holding a simple value is decoded straight from the data
+        when it is read, and the whole object is parsed the first time it
+        is used in any other way. Copies share the data, so an entry copied
+        only to be changed is parsed only once it is changed.
+
+        @param owner Keeps `data` alive and unchanged.
+        @param fields The fields found in `data` by scanFields.
+        @return `false`, leaving the object unchanged, if the fields don't
+            match the template. The data should then be parsed at once.
+    */
+    bool
+    setLazy(
+        SOTemplate const& type,
+        Slice data,
+        std::shared_ptr<void const> owner,
+        std::vector<LazyField> const& fields);
+
 private:
     enum WhichFields : bool {
         // These values are carefully chosen to do the right thing if passed
@@ -663,6 +723,36 @@ private:
     static std::vector<STBase const*>
     getSortedFields(STObject const& objToSort, WhichFields whichFields);
 
+    // Parse a lazily read object, if it hasn't been parsed yet. This must
+    // be done before v_ is used.
+    void
+    materialize() const
+    {
+        if (lazy_.load(std::memory_order_acquire))
+            parseLazy();
+    }
+
+    void
+    parseLazy() const;
+
+    void
+    clearLazy();
+
+    // While the object hasn't been parsed, return its data and the
+    // template index of a field in the template.
+    std::pair<LazyData const*, int>
+    findLazy(SField const& field) const;
+
+    // While the object hasn't been parsed, decode a field with a simple
+    // value straight from the data. Returns nothing otherwise.
+    boost::optional<detail::STVar>
+    peekLazy(SField const& field) const;
+
+    // Whether a field's value is still valid once the field is destroyed
+    template <class V>
+    static constexpr bool ownsValue =
+        !std::is_reference_v<V> && !std::is_same_v<std::decay_t<V>, Slice>;
+
     // Implementation for getting (most) fields that return by value.
     //
     // The remove_cv and remove_reference are necessitated by the STBitString
@@ -675,7 +765,10 @@ private:
     V
     getFieldByValue(SField const& field) const
     {
-        const STBase* rf = peekAtPField(field);
+        boost::optional<detail::STVar> lazy;
+        if constexpr (ownsValue<V>)
+            lazy = peekLazy(field);
+        const STBase* rf = lazy ? &lazy->get() : peekAtPField(field);
 
         if (!rf)
             throwFieldNotFound(field);
@@ -1004,7 +1097,10 @@ template <class T>
 typename T::value_type
 STObject::at(TypedField<T> const& f) const
 {
-    auto const b = peekAtPField(f);
+    boost::optional<detail::STVar> lazy;
+    if constexpr (ownsValue<typename T::value_type>)
+        lazy = peekLazy(f);
+    auto const b = lazy ? &lazy->get() : peekAtPField(f);
     if (!b)
         // This is a free object (no constraints)
         // with no template
@@ -1030,7 +1126,10 @@ template <class T>
 boost::optional<std::decay_t<typename T::value_type>>
 STObject::at(OptionaledField<T> const& of) const
 {
-    auto const b = peekAtPField(*of.f);
+    boost::optional<detail::STVar> lazy;
+    if constexpr (ownsValue<typename T::value_type>)
+        lazy = peekLazy(*of.f);
+    auto const b = lazy ? &lazy->get() : peekAtPField(*of.f);
     if (!b)
         return boost::none;
     auto const u = dynamic_cast<T const*>(b);
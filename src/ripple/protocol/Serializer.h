@@ -28,6 +28,7 @@
 #include <ripple/basics/safe_cast.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/SField.h>
+#include <ripple/protocol/digest.h>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -36,19 +37,27 @@
 
 namespace ripple {
 
+/** Builds the canonical binary form of protocol objects.
+
+    The storage of a Serializer comes from a small per-thread pool and is
+    returned to it afterwards, so the many short-lived Serializers created
+    while building and hashing objects usually don't allocate.
+*/
 class Serializer
 {
 private:
     // DEPRECATED
     Blob mData;
 
+    // When set, data is passed to the hasher rather than kept
+    sha512_half_hasher* hasher_ = nullptr;
+
 public:
-    explicit Serializer(int n = 256)
+    explicit Serializer(int n = 256) : mData(acquire(n))
     {
-        mData.reserve(n);
     }
 
-    Serializer(void const* data, std::size_t size)
+    Serializer(void const* data, std::size_t size) : mData(acquire(size))
     {
         mData.resize(size);
 
@@ -59,6 +68,58 @@ public:
         }
     }
 
+    /** Create a Serializer which hashes what is added to it.
+
+        Rather than keeping the data, it is passed to the hasher a
+        piece at a time, so that hashing even a large object never builds
+        its serialized form. Only the add functions may be used and the
+        positions they return are meaningless. Call flush() before taking
+        the digest.
+    */
+    explicit Serializer(sha512_half_hasher& hasher);
+
+    Serializer(Serializer const& other) : mData(acquire(other.size()))
+    {
+        mData.assign(other.mData.begin(), other.mData.end());
+    }
+
+    Serializer(Serializer&& other) noexcept
+        : mData(std::move(other.mData)), hasher_(other.hasher_)
+    {
+    }
+
+    Serializer&
+    operator=(Serializer const& other)
+    {
+        if (this != &other)
+        {
+            mData.assign(other.mData.begin(), other.mData.end());
+            hasher_ = nullptr;
+        }
+        return *this;
+    }
+
+    Serializer&
+    operator=(Serializer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release(std::move(mData));
+            mData = std::move(other.mData);
+            hasher_ = other.hasher_;
+        }
+        return *this;
+    }
+
+    ~Serializer()
+    {
+        release(std::move(mData));
+    }
+
+    /** Pass any data still buffered to the hasher. */
+    void
+    flush();
+
     Slice
     slice() const noexcept
     {
@@ -102,6 +163,8 @@ public:
     int
     addRaw(Blob const& vector);
     int
+    addRaw(Slice slice);
+    int
     addRaw(const void* ptr, int len);
     int
     addRaw(const Serializer& s);
@@ -279,6 +342,22 @@ public:
     decodeVLLength(int b1, int b2, int b3);
 
 private:
+    // Buffered data is passed to the hasher once there is this much
+    static constexpr std::size_t spillSize = 1024;
+
+    static Blob
+    acquire(std::size_t n);
+
+    static void
+    release(Blob&& buffer) noexcept;
+
+    void
+    spill()
+    {
+        if (hasher_ && mData.size() >= spillSize)
+            flush();
+    }
+
     static int
     encodeLengthLength(int length);  // length to encode length
     int
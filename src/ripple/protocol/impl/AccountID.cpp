@@ -21,6 +21,7 @@
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/digest.h>
 #include <ripple/protocol/tokens.h>
+#include <array>
 #include <cstring>
 
 namespace ripple {
@@ -28,7 +29,29 @@ namespace ripple {
 std::string
 toBase58(AccountID const& v)
 {
-    return encodeBase58Token(TokenType::AccountID, v.data(), v.size());
+    // The same accounts are encoded over and over when rendering ledgers
+    // and account histories, so each thread keeps the last few it encoded.
+    // Account IDs are hashes, so their first byte picks a slot well.
+    struct Entry
+    {
+        AccountID id;
+        std::uint8_t size = 0;
+        std::array<char, 35> text;
+    };
+    thread_local std::array<Entry, 256> cache;
+
+    auto& entry = cache[v.data()[0]];
+    if (entry.size == 0 || entry.id != v)
+    {
+        auto const s =
+            encodeBase58Token(TokenType::AccountID, v.data(), v.size());
+        if (s.size() > entry.text.size())
+            return s;
+        entry.id = v;
+        entry.size = static_cast<std::uint8_t>(s.size());
+        std::memcpy(entry.text.data(), s.data(), s.size());
+    }
+    return std::string(entry.text.data(), entry.size);
 }
 
 template <>
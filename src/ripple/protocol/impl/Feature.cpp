@@ -133,6 +133,7 @@ detail::supportedAmendments()
         "fixAmendmentMajorityCalc",
         //"NegativeUNL",      // Commented out to prevent automatic enablement
         //"TicketBatch",      // Commented out to prevent automatic enablement
+        //"FlowSortStrands",  // Commented out to prevent automatic enablement
     };
     return supported;
 }
@@ -186,7 +187,8 @@ uint256 const
     featureHardenedValidations      = *getRegisteredFeature("HardenedValidations"),
     fixAmendmentMajorityCalc        = *getRegisteredFeature("fixAmendmentMajorityCalc"),
     featureNegativeUNL              = *getRegisteredFeature("NegativeUNL"),
-    featureTicketBatch              = *getRegisteredFeature("TicketBatch");
+    featureTicketBatch              = *getRegisteredFeature("TicketBatch"),
+    featureFlowSortStrands          = *getRegisteredFeature("FlowSortStrands");
 
 // The following amendments have been active for at least two years. Their
 // pre-amendment code has been removed and the identifiers are deprecated.
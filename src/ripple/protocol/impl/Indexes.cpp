@@ -22,7 +22,9 @@
 #include <ripple/protocol/digest.h>
 #include <boost/endian/conversion.hpp>
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <tuple>
 
 namespace ripple {
 
@@ -75,6 +77,58 @@ indexHash(LedgerNameSpace space, Args const&... args)
     return sha512Half(safe_cast<std::uint16_t>(space), args...);
 }
 
+// Path finding and the RPC handlers compute the keys of the same few
+// account roots, directories and trust lines over and over, so each thread
+// remembers the keys it computed most recently. The inputs are themselves
+// hashes, so any of their bytes picks a slot evenly.
+template <class Input>
+class IndexMemo
+{
+    struct Entry
+    {
+        Input input;
+        uint256 key;
+        bool valid = false;
+    };
+
+    std::array<Entry, 64> entries_;
+
+public:
+    template <class Compute>
+    uint256 const&
+    get(Input const& input, std::uint8_t slot, Compute const& compute)
+    {
+        auto& e = entries_[slot % entries_.size()];
+        if (!e.valid || !(e.input == input))
+        {
+            e.key = compute();
+            e.input = input;
+            e.valid = true;
+        }
+        return e.key;
+    }
+};
+
+template <LedgerNameSpace Space>
+static uint256 const&
+accountIndex(AccountID const& id)
+{
+    thread_local IndexMemo<AccountID> memo;
+    return memo.get(id, *id.begin(), [&]() { return indexHash(Space, id); });
+}
+
+// Hash the inputs of a batch of index computations together.
+static std::vector<uint256>
+indexHashBatch(Serializer const& inputs, std::size_t size)
+{
+    assert(size != 0 && inputs.size() % size == 0);
+    std::vector<Slice> messages;
+    messages.reserve(inputs.size() / size);
+    for (std::size_t i = 0; i < inputs.size(); i += size)
+        messages.emplace_back(inputs.slice().data() + i, size);
+    return sha512HalfBatch(messages);
+}
+
 uint256
 getBookBase(Book const& book)
 {
@@ -133,7 +187,27 @@ namespace keylet {
 Keylet
 account(AccountID const& id) noexcept
 {
-    return {ltACCOUNT_ROOT, indexHash(LedgerNameSpace::ACCOUNT, id)};
+    return {ltACCOUNT_ROOT, accountIndex<LedgerNameSpace::ACCOUNT>(id)};
+}
+
+std::vector<Keylet>
+account(std::vector<AccountID> const& ids)
+{
+    Serializer s(ids.size() * 22);
+    for (auto const& id : ids)
+    {
+        s.add16(safe_cast<std::uint16_t>(LedgerNameSpace::ACCOUNT));
+        s.addBitString(id);
+    }
+
+    std::vector<Keylet> result;
+    result.reserve(ids.size());
+    if (!ids.empty())
+    {
+        for (auto const& key : indexHashBatch(s, 22))
+            result.emplace_back(ltACCOUNT_ROOT, key);
+    }
+    return result;
 }
 
 Keylet
@@ -210,13 +284,42 @@ line(
     // two accounts (smallest then largest)  and hash them in that order:
     auto const accounts = std::minmax(id0, id1);
 
+    thread_local IndexMemo<std::tuple<AccountID, AccountID, Currency>> memo;
     return {
         ltRIPPLE_STATE,
-        indexHash(
-            LedgerNameSpace::TRUST_LINE,
-            accounts.first,
-            accounts.second,
-            currency)};
+        memo.get(
+            {accounts.first, accounts.second, currency},
+            *id0.begin() ^ *id1.begin() ^ *currency.begin(),
+            [&]() {
+                return indexHash(
+                    LedgerNameSpace::TRUST_LINE,
+                    accounts.first,
+                    accounts.second,
+                    currency);
+            })};
+}
+
+std::vector<Keylet>
+line(AccountID const& id, std::vector<Issue> const& issues)
+{
+    Serializer s(issues.size() * 62);
+    for (auto const& issue : issues)
+    {
+        auto const accounts = std::minmax(id, issue.account);
+        s.add16(safe_cast<std::uint16_t>(LedgerNameSpace::TRUST_LINE));
+        s.addBitString(accounts.first);
+        s.addBitString(accounts.second);
+        s.addBitString(issue.currency);
+    }
+
+    std::vector<Keylet> result;
+    result.reserve(issues.size());
+    if (!issues.empty())
+    {
+        for (auto const& key : indexHashBatch(s, 62))
+            result.emplace_back(ltRIPPLE_STATE, key);
+    }
+    return result;
 }
 
 Keylet
@@ -303,7 +406,7 @@ unchecked(uint256 const& key) noexcept
 Keylet
 ownerDir(AccountID const& id) noexcept
 {
-    return {ltDIR_NODE, indexHash(LedgerNameSpace::OWNER_DIR, id)};
+    return {ltDIR_NODE, accountIndex<LedgerNameSpace::OWNER_DIR>(id)};
 }
 
 Keylet
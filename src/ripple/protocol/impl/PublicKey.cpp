@@ -24,6 +24,9 @@
 #include <ripple/protocol/impl/secp256k1.h>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <ed25519-donna/ed25519.h>
+#include <array>
+#include <cassert>
+#include <cstring>
 #include <type_traits>
 
 namespace ripple {
@@ -197,6 +200,42 @@ PublicKey::operator=(PublicKey const& other)
     return *this;
 }
 
+// Parsing a compressed secp256k1 key means recovering the y coordinate,
+// a noticeable part of the cost of a verification. The same keys sign
+// over and over, validators and busy accounts above all, so each
+// thread keeps the keys it parsed recently. The x coordinate is random,
+// so any of its bytes picks a slot well.
+static bool
+parseSecp256k1(PublicKey const& publicKey, secp256k1_pubkey& out)
+{
+    struct Entry
+    {
+        std::array<std::uint8_t, 33> key{};
+        secp256k1_pubkey parsed;
+    };
+    thread_local std::array<Entry, 256> cache;
+
+    assert(publicKey.size() == 33);
+
+    // An empty slot never matches, since every key starts with 0x02 or 0x03
+    auto& entry = cache[publicKey.data()[1]];
+    if (std::memcmp(entry.key.data(), publicKey.data(), 33) != 0)
+    {
+        if (secp256k1_ec_pubkey_parse(
+                secp256k1Context(),
+                &out,
+                reinterpret_cast<unsigned char const*>(publicKey.data()),
+                publicKey.size()) != 1)
+            return false;
+        std::memcpy(entry.key.data(), publicKey.data(), 33);
+        entry.parsed = out;
+        return true;
+    }
+
+    out = entry.parsed;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 
 boost::optional<KeyType>
@@ -231,11 +270,7 @@ verifyDigest(
         return false;
 
     secp256k1_pubkey pubkey_imp;
-    if (secp256k1_ec_pubkey_parse(
-            secp256k1Context(),
-            &pubkey_imp,
-            reinterpret_cast<unsigned char const*>(publicKey.data()),
-            publicKey.size()) != 1)
+    if (!parseSecp256k1(publicKey, pubkey_imp))
         return false;
 
     secp256k1_ecdsa_signature sig_imp;
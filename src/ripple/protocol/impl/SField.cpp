@@ -29,6 +29,9 @@ namespace ripple {
 SField::IsSigning const SField::notSigning;
 int SField::num = 0;
 std::map<int, SField const*> SField::knownCodeToField;
+// Zero initialized before any SField is constructed
+std::array<SField const*, SField::directTypes * SField::directValues>
+    SField::directCodeToField{};
 
 // Give only this translation unit permission to construct SFields
 struct SField::private_access_tag_t
@@ -303,6 +306,8 @@ SField::SField(
     , jsonName(fieldName.c_str())
 {
     knownCodeToField[fieldCode] = this;
+    if (auto const i = directIndex(fieldCode); i < directCodeToField.size())
+        directCodeToField[i] = this;
 }
 
 SField::SField(private_access_tag_t, int fc)
@@ -315,11 +320,20 @@ SField::SField(private_access_tag_t, int fc)
     , jsonName(fieldName.c_str())
 {
     knownCodeToField[fieldCode] = this;
+    if (auto const i = directIndex(fieldCode); i < directCodeToField.size())
+        directCodeToField[i] = this;
 }
 
 SField const&
 SField::getField(int code)
 {
+    if (auto const i = directIndex(code); i < directCodeToField.size())
+    {
+        if (auto const field = directCodeToField[i])
+            return *field;
+        return sfInvalid;
+    }
+
     auto it = knownCodeToField.find(code);
 
     if (it != knownCodeToField.end())
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/DecimalDigits.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
@@ -38,6 +39,11 @@ static const std::uint64_t tenTo14 = 100000000000000ull;
 static const std::uint64_t tenTo14m1 = tenTo14 - 1;
 static const std::uint64_t tenTo17 = tenTo14 * 1000;
 
+// The largest power of ten in powersOfTen which fits in a signed value
+static const int maxSignedShift = 18;
+// The largest power of ten in powersOfTen
+static const int maxShift = powersOfTen.size() - 1;
+
 //------------------------------------------------------------------------------
 static std::int64_t
 getSNValue(STAmount const& amount)
@@ -378,16 +384,20 @@ operator+(STAmount const& v1, STAmount const& v2)
     if (v2.negative())
         vv2 = -vv2;
 
+    // Dividing once by a power of ten truncates the same way as dividing
+    // by ten that many times
     while (ov1 < ov2)
     {
-        vv1 /= 10;
-        ++ov1;
+        auto const shift = std::min(ov2 - ov1, maxSignedShift);
+        vv1 /= static_cast<std::int64_t>(powersOfTen[shift]);
+        ov1 += shift;
     }
 
     while (ov2 < ov1)
     {
-        vv2 /= 10;
-        ++ov2;
+        auto const shift = std::min(ov1 - ov2, maxSignedShift);
+        vv2 /= static_cast<std::int64_t>(powersOfTen[shift]);
+        ov2 += shift;
     }
 
     // This addition cannot overflow an std::int64_t. It can overflow an
@@ -669,16 +679,20 @@ STAmount::canonicalize()
             return;
         }
 
+        // Scaling once by a power of ten gives the same result as scaling
+        // by ten that many times, including when the value overflows.
         while (mOffset < 0)
         {
-            mValue /= 10;
-            ++mOffset;
+            auto const shift = std::min(-mOffset, maxShift);
+            mValue /= powersOfTen[shift];
+            mOffset += shift;
         }
 
         while (mOffset > 0)
         {
-            mValue *= 10;
-            --mOffset;
+            auto const shift = std::min(mOffset, maxShift);
+            mValue *= powersOfTen[shift];
+            mOffset -= shift;
         }
 
         if (mValue > cMaxNativeN)
@@ -696,19 +710,23 @@ STAmount::canonicalize()
         return;
     }
 
-    while ((mValue < cMinValue) && (mOffset > cMinOffset))
+    // Scale the mantissa to 16 digits in one step
+    if ((mValue < cMinValue) && (mOffset > cMinOffset))
     {
-        mValue *= 10;
-        --mOffset;
+        auto const shift =
+            std::min(16 - decimalDigits(mValue), mOffset - cMinOffset);
+        mValue *= powersOfTen[shift];
+        mOffset -= shift;
     }
 
-    while (mValue > cMaxValue)
+    if (mValue > cMaxValue)
     {
-        if (mOffset >= cMaxOffset)
+        auto const shift = decimalDigits(mValue) - 16;
+        if (mOffset > cMaxOffset - shift)
             Throw<std::runtime_error>("value overflow");
 
-        mValue /= 10;
-        ++mOffset;
+        mValue /= powersOfTen[shift];
+        mOffset += shift;
     }
 
     if ((mOffset < cMinOffset) || (mValue < cMinValue))
@@ -1020,9 +1038,13 @@ muldiv(
     std::uint64_t multiplicand,
     std::uint64_t divisor)
 {
+#ifdef __SIZEOF_INT128__
+    auto ret = static_cast<unsigned __int128>(multiplier) * multiplicand;
+#else
     boost::multiprecision::uint128_t ret;
 
     boost::multiprecision::multiply(ret, multiplier, multiplicand);
+#endif
     ret /= divisor;
 
     if (ret > std::numeric_limits<std::uint64_t>::max())
@@ -1042,9 +1064,13 @@ muldiv_round(
     std::uint64_t divisor,
     std::uint64_t rounding)
 {
+#ifdef __SIZEOF_INT128__
+    auto ret = static_cast<unsigned __int128>(multiplier) * multiplicand;
+#else
     boost::multiprecision::uint128_t ret;
 
     boost::multiprecision::multiply(ret, multiplier, multiplicand);
+#endif
     ret += rounding;
     ret /= divisor;
 
@@ -1059,6 +1085,19 @@ muldiv_round(
     return static_cast<uint64_t>(ret);
 }
 
+// Scale a native mantissa, which must not be zero, into the range used
+// for the mantissas of other amounts
+static void
+normalizeNative(std::uint64_t& value, int& offset)
+{
+    if (value < STAmount::cMinValue)
+    {
+        auto const shift = 16 - decimalDigits(value);
+        value *= powersOfTen[shift];
+        offset -= shift;
+    }
+}
+
 STAmount
 divide(STAmount const& num, STAmount const& den, Issue const& issue)
 {
@@ -1074,23 +1113,10 @@ divide(STAmount const& num, STAmount const& den, Issue const& issue)
     int denOffset = den.exponent();
 
     if (num.native())
-    {
-        while (numVal < STAmount::cMinValue)
-        {
-            // Need to bring into range
-            numVal *= 10;
-            --numOffset;
-        }
-    }
+        normalizeNative(numVal, numOffset);
 
     if (den.native())
-    {
-        while (denVal < STAmount::cMinValue)
-        {
-            denVal *= 10;
-            --denOffset;
-        }
-    }
+        normalizeNative(denVal, denOffset);
 
     // We divide the two mantissas (each is between 10^15
     // and 10^16). To maintain precision, we multiply the
@@ -1132,22 +1158,10 @@ multiply(STAmount const& v1, STAmount const& v2, Issue const& issue)
     int offset2 = v2.exponent();
 
     if (v1.native())
-    {
-        while (value1 < STAmount::cMinValue)
-        {
-            value1 *= 10;
-            --offset1;
-        }
-    }
+        normalizeNative(value1, offset1);
 
     if (v2.native())
-    {
-        while (value2 < STAmount::cMinValue)
-        {
-            value2 *= 10;
-            --offset2;
-        }
-    }
+        normalizeNative(value2, offset2);
 
     // We multiply the two mantissas (each is between 10^15
     // and 10^16), so their product is in the 10^30 to 10^32
@@ -1171,9 +1185,10 @@ canonicalizeRound(bool native, std::uint64_t& value, int& offset)
 
             while (offset < -1)
             {
-                value /= 10;
-                ++offset;
-                ++loops;
+                auto const shift = std::min(-1 - offset, maxShift);
+                value /= powersOfTen[shift];
+                offset += shift;
+                loops += shift;
             }
 
             value += (loops >= 2) ? 9 : 10;  // add before last divide
@@ -1227,22 +1242,10 @@ mulRound(
     int offset1 = v1.exponent(), offset2 = v2.exponent();
 
     if (v1.native())
-    {
-        while (value1 < STAmount::cMinValue)
-        {
-            value1 *= 10;
-            --offset1;
-        }
-    }
+        normalizeNative(value1, offset1);
 
     if (v2.native())
-    {
-        while (value2 < STAmount::cMinValue)
-        {
-            value2 *= 10;
-            --offset2;
-        }
-    }
+        normalizeNative(value2, offset2);
 
     bool const resultNegative = v1.negative() != v2.negative();
 
@@ -1298,22 +1301,10 @@ divRound(
     int numOffset = num.exponent(), denOffset = den.exponent();
 
     if (num.native())
-    {
-        while (numVal < STAmount::cMinValue)
-        {
-            numVal *= 10;
-            --numOffset;
-        }
-    }
+        normalizeNative(numVal, numOffset);
 
     if (den.native())
-    {
-        while (denVal < STAmount::cMinValue)
-        {
-            denVal *= 10;
-            --denOffset;
-        }
-    }
+        normalizeNative(denVal, denOffset);
 
     bool const resultNegative = (num.negative() != den.negative());
 
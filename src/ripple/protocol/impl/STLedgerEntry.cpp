@@ -25,6 +25,7 @@
 #include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/jss.h>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <limits>
 
 namespace ripple {
@@ -61,6 +62,39 @@ STLedgerEntry::STLedgerEntry(SerialIter& sit, uint256 const& index)
     setSLEType();
 }
 
+STLedgerEntry::STLedgerEntry(
+    Slice data,
+    std::shared_ptr<void const> owner,
+    uint256 const& index)
+    : STObject(sfLedgerEntry), key_(index)
+{
+    if (auto const fields = scanFields(data))
+    {
+        auto const type = std::find_if(
+            fields->begin(), fields->end(), [](LazyField const& f) {
+                return *f.field == sfLedgerEntryType;
+            });
+        if (type != fields->end() && type->size == 2)
+        {
+            SerialIter sit(data.data() + type->offset, type->size);
+            auto const format = LedgerFormats::getInstance().findByType(
+                safe_cast<LedgerEntryType>(sit.get16()));
+            if (format &&
+                setLazy(
+                    format->getSOTemplate(), data, std::move(owner), *fields))
+            {
+                type_ = format->getType();
+                return;
+            }
+        }
+    }
+
+    // The data is unusual enough to need parsing, which will say why
+    SerialIter sit(data);
+    set(sit);
+    setSLEType();
+}
+
 STLedgerEntry::STLedgerEntry(STObject const& object, uint256 const& index)
     : STObject(object), key_(index)
 {
@@ -23,12 +23,143 @@
 #include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STBlob.h>
 #include <ripple/protocol/STObject.h>
+#include <boost/container/small_vector.hpp>
+#include <array>
+#include <mutex>
 
 namespace ripple {
 
+struct STObject::LazyData
+{
+    std::shared_ptr<void const> owner;
+    Slice data;
+
+    // The extent of each field in the template, by template index. A field
+    // the object doesn't have is empty.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> fields;
+};
+
+namespace {
+
+// Guards parsing lazily read objects, which can be shared between threads
+std::mutex&
+lazyMutex(void const* object)
+{
+    static std::array<std::mutex, 64> mutexes;
+    return mutexes[(reinterpret_cast<std::uintptr_t>(object) >> 4) %
+                   mutexes.size()];
+}
+
+bool
+skipObject(SerialIter& sit, int depth);
+
+// Skip over the value of a field without decoding it. Returns false if
+// the value isn't understood.
+bool
+skipField(SerialIter& sit, int type, int depth)
+{
+    switch (type)
+    {
+        case STI_UINT8:
+            sit.skip(1);
+            return true;
+        case STI_UINT16:
+            sit.skip(2);
+            return true;
+        case STI_UINT32:
+            sit.skip(4);
+            return true;
+        case STI_UINT64:
+            sit.skip(8);
+            return true;
+        case STI_HASH128:
+            sit.skip(16);
+            return true;
+        case STI_HASH160:
+            sit.skip(20);
+            return true;
+        case STI_HASH256:
+            sit.skip(32);
+            return true;
+        case STI_AMOUNT:
+            // An issued amount is followed by its currency and issuer
+            if (sit.get64() & STAmount::cNotNative)
+                sit.skip(40);
+            return true;
+        case STI_VL:
+        case STI_ACCOUNT:
+        case STI_VECTOR256:
+            sit.skip(sit.getVLDataLength());
+            return true;
+        case STI_PATHSET:
+            for (;;)
+            {
+                auto const t = sit.get8();
+                if (t == STPathElement::typeNone)
+                    return true;
+                if (t == STPathElement::typeBoundary)
+                    continue;
+                if (t & ~STPathElement::typeAll)
+                    return false;
+                if (t & STPathElement::typeAccount)
+                    sit.skip(20);
+                if (t & STPathElement::typeCurrency)
+                    sit.skip(20);
+                if (t & STPathElement::typeIssuer)
+                    sit.skip(20);
+            }
+        case STI_OBJECT:
+            return skipObject(sit, depth + 1);
+        case STI_ARRAY:
+            while (!sit.empty())
+            {
+                int t;
+                int f;
+                sit.getFieldID(t, f);
+                if (t == STI_ARRAY && f == 1)
+                    return true;
+                if (t != STI_OBJECT || !skipObject(sit, depth + 1))
+                    return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool
+skipObject(SerialIter& sit, int depth)
+{
+    if (depth > 10)
+        return false;
+    while (!sit.empty())
+    {
+        int type;
+        int field;
+        sit.getFieldID(type, field);
+        if (type == STI_OBJECT && field == 1)
+            return true;
+        if (!skipField(sit, type, depth))
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 STObject::STObject(STObject&& other)
-    : STBase(other.getFName()), v_(std::move(other.v_)), mType(other.mType)
+    : STBase(other.getFName())
+    , v_(std::move(other.v_))
+    , mType(other.mType)
+    , lazy_(other.lazy_.load())
+    , lazyData_(std::move(other.lazyData_))
 {
+    other.lazy_ = nullptr;
+}
+
+STObject::STObject(STObject const& other) : STBase(other), mType(other.mType)
+{
+    *this = other;
 }
 
 STObject::STObject(SField const& name) : STBase(name), mType(nullptr)
@@ -60,18 +191,50 @@ STObject::STObject(SerialIter& sit, SField const& name, int depth) noexcept(
     set(sit, depth);
 }
 
+STObject&
+STObject::operator=(STObject const& other)
+{
+    if (this == &other)
+        return *this;
+
+    setFName(other.getFName());
+    mType = other.mType;
+
+    // Share the data of an object which hasn't been parsed, rather than
+    // parsing it to copy the fields.
+    if (other.lazy_.load(std::memory_order_acquire))
+    {
+        std::lock_guard lock(lazyMutex(&other));
+        if (auto const lazy = other.lazy_.load(std::memory_order_relaxed))
+        {
+            v_.clear();
+            lazyData_ = other.lazyData_;
+            lazy_.store(lazy, std::memory_order_relaxed);
+            return *this;
+        }
+    }
+
+    clearLazy();
+    v_ = other.v_;
+    return *this;
+}
+
 STObject&
 STObject::operator=(STObject&& other)
 {
     setFName(other.getFName());
     mType = other.mType;
     v_ = std::move(other.v_);
+    lazy_.store(other.lazy_.load(), std::memory_order_relaxed);
+    lazyData_ = std::move(other.lazyData_);
+    other.lazy_ = nullptr;
     return *this;
 }
 
 void
 STObject::set(const SOTemplate& type)
 {
+    clearLazy();
     v_.clear();
     v_.reserve(type.size());
     mType = &type;
@@ -96,42 +259,56 @@ STObject::applyTemplate(const SOTemplate& type) noexcept(false)
         Throw<FieldErr>(text);
     };
 
+    materialize();
     mType = &type;
+
+    // Look up where each field goes in the template's index, in one pass
+    // over the object. If a field appears more than once, only the first
+    // one has a place and the rest are left over.
+    boost::container::small_vector<int, 32> where(type.size(), -1);
+    boost::container::small_vector<int, 4> leftover;
+    for (int i = 0, n = v_.size(); i < n; ++i)
+    {
+        auto const index = type.find(v_[i]->getFName());
+        if (index != -1 && where[index] == -1)
+            where[index] = i;
+        else
+            leftover.push_back(i);
+    }
+
     decltype(v_) v;
     v.reserve(type.size());
-    for (auto const& e : type)
+    auto e = type.begin();
+    for (auto const i : where)
     {
-        auto const iter =
-            std::find_if(v_.begin(), v_.end(), [&](detail::STVar const& b) {
-                return b.get().getFName() == e.sField();
-            });
-        if (iter != v_.end())
+        if (i != -1)
         {
-            if ((e.style() == soeDEFAULT) && iter->get().isDefault())
+            if ((e->style() == soeDEFAULT) && v_[i]->isDefault())
             {
                 throwFieldErr(
-                    e.sField().fieldName,
+                    e->sField().fieldName,
                     "may not be explicitly set to default.");
             }
-            v.emplace_back(std::move(*iter));
-            v_.erase(iter);
+            v.emplace_back(std::move(v_[i]));
         }
         else
         {
-            if (e.style() == soeREQUIRED)
+            if (e->style() == soeREQUIRED)
             {
-                throwFieldErr(e.sField().fieldName, "is required but missing.");
+                throwFieldErr(
+                    e->sField().fieldName, "is required but missing.");
             }
-            v.emplace_back(detail::nonPresentObject, e.sField());
+            v.emplace_back(detail::nonPresentObject, e->sField());
         }
+        ++e;
     }
-    for (auto const& e : v_)
+    for (auto const i : leftover)
     {
         // Anything left over in the object must be discardable
-        if (!e->getFName().isDiscardable())
+        if (!v_[i]->getFName().isDiscardable())
         {
             throwFieldErr(
-                e->getFName().getName(), "found in disallowed location.");
+                v_[i]->getFName().getName(), "found in disallowed location.");
         }
     }
     // Swap the template matching data in for the old data,
@@ -154,6 +331,7 @@ STObject::set(SerialIter& sit, int depth) noexcept(false)
 {
     bool reachedEndOfObject = false;
 
+    clearLazy();
     v_.clear();
 
     // Consume data in the pipe until we run out or reach the end
@@ -212,6 +390,137 @@ STObject::set(SerialIter& sit, int depth) noexcept(false)
     return reachedEndOfObject;
 }
 
+auto
+STObject::scanFields(Slice data) -> boost::optional<std::vector<LazyField>>
+{
+    std::vector<LazyField> fields;
+    try
+    {
+        SerialIter sit(data);
+        while (!sit.empty())
+        {
+            int type;
+            int field;
+            sit.getFieldID(type, field);
+            if (type == STI_OBJECT && field == 1)
+                break;
+
+            auto const& fn = SField::getField(type, field);
+            if (fn.isInvalid())
+                return {};
+
+            auto const offset = data.size() - sit.getBytesLeft();
+            if (!skipField(sit, type, 0))
+                return {};
+            auto const size = data.size() - sit.getBytesLeft() - offset;
+            fields.push_back(
+                {&fn,
+                 static_cast<std::uint32_t>(offset),
+                 static_cast<std::uint32_t>(size)});
+        }
+    }
+    catch (std::exception const&)
+    {
+        return {};
+    }
+    return fields;
+}
+
+bool
+STObject::setLazy(
+    SOTemplate const& type,
+    Slice data,
+    std::shared_ptr<void const> owner,
+    std::vector<LazyField> const& fields)
+{
+    auto lazy = std::make_shared<LazyData>();
+    lazy->owner = std::move(owner);
+    lazy->data = data;
+    lazy->fields.resize(type.size());
+
+    // Leave anything applyTemplate would reject to be found by parsing
+    for (auto const& f : fields)
+    {
+        auto const index = type.getIndex(*f.field);
+        if (index == -1)
+        {
+            if (!f.field->isDiscardable())
+                return false;
+            continue;
+        }
+        auto& extent = lazy->fields[index];
+        if (extent.second != 0)
+            return false;
+        extent = {f.offset, f.size};
+    }
+    for (std::size_t i = 0; i < type.size(); ++i)
+    {
+        auto const& e = *(type.begin() + i);
+        if (e.style() == soeREQUIRED && lazy->fields[i].second == 0)
+            return false;
+    }
+
+    v_.clear();
+    mType = &type;
+    lazyData_ = std::move(lazy);
+    lazy_.store(lazyData_.get(), std::memory_order_release);
+    return true;
+}
+
+void
+STObject::parseLazy() const
+{
+    std::lock_guard lock(lazyMutex(this));
+    auto const lazy = lazy_.load(std::memory_order_relaxed);
+    if (!lazy)
+        return;
+
+    STObject parsed(getFName());
+    SerialIter sit(lazy->data);
+    parsed.set(sit);
+    parsed.applyTemplate(*mType);  // May throw
+
+    // Other threads only look at v_ once lazy_ is cleared
+    const_cast<STObject*>(this)->v_ = std::move(parsed.v_);
+    lazy_.store(nullptr, std::memory_order_release);
+}
+
+void
+STObject::clearLazy()
+{
+    lazy_.store(nullptr, std::memory_order_relaxed);
+    lazyData_.reset();
+}
+
+std::pair<STObject::LazyData const*, int>
+STObject::findLazy(SField const& field) const
+{
+    auto const lazy = lazy_.load(std::memory_order_acquire);
+    if (!lazy)
+        return {nullptr, -1};
+    return {lazy, mType->getIndex(field)};
+}
+
+boost::optional<detail::STVar>
+STObject::peekLazy(SField const& field) const
+{
+    // Objects and arrays need their templates applied, so they are only
+    // read by parsing the whole object.
+    if (field.fieldType == STI_OBJECT || field.fieldType == STI_ARRAY)
+        return {};
+
+    auto const [lazy, index] = findLazy(field);
+    if (!lazy || index == -1)
+        return {};
+
+    auto const [offset, size] = lazy->fields[index];
+    if (size == 0)
+        return detail::STVar(detail::nonPresentObject, field);
+
+    SerialIter sit(lazy->data.data() + offset, size);
+    return detail::STVar(sit, field);
+}
+
 bool
 STObject::hasMatchingEntry(const STBase& t)
 {
@@ -237,6 +546,7 @@ STObject::getFullText() const
     else
         ret = "{";
 
+    materialize();
     for (auto const& elem : v_)
     {
         if (elem->getSType() != STI_NOTPRESENT)
@@ -259,6 +569,7 @@ STObject::getText() const
 {
     std::string ret = "{";
     bool first = false;
+    materialize();
     for (auto const& elem : v_)
     {
         if (!first)
@@ -311,19 +622,23 @@ STObject::isEquivalent(const STBase& t) const
 uint256
 STObject::getHash(HashPrefix prefix) const
 {
-    Serializer s;
+    sha512_half_hasher h;
+    Serializer s(h);
     s.add32(prefix);
     add(s, withAllFields);
-    return s.getSHA512Half();
+    s.flush();
+    return static_cast<sha512_half_hasher::result_type>(h);
 }
 
 uint256
 STObject::getSigningHash(HashPrefix prefix) const
 {
-    Serializer s;
+    sha512_half_hasher h;
+    Serializer s(h);
     s.add32(prefix);
     add(s, omitSigningFields);
-    return s.getSHA512Half();
+    s.flush();
+    return static_cast<sha512_half_hasher::result_type>(h);
 }
 
 int
@@ -332,6 +647,7 @@ STObject::getFieldIndex(SField const& field) const
     if (mType != nullptr)
         return mType->getIndex(field);
 
+    materialize();
     int i = 0;
     for (auto const& elem : v_)
     {
@@ -367,6 +683,7 @@ STObject::getField(SField const& field)
 SField const&
 STObject::getFieldSType(int index) const
 {
+    materialize();
     return v_[index]->getFName();
 }
 
@@ -400,6 +717,9 @@ STObject::getPField(SField const& field, bool createOkay)
 bool
 STObject::isFieldPresent(SField const& field) const
 {
+    if (auto const [lazy, index] = findLazy(field); lazy && index != -1)
+        return lazy->fields[index].second != 0;
+
     int index = getFieldIndex(field);
 
     if (index == -1)
@@ -453,7 +773,9 @@ STObject::isFlag(std::uint32_t f) const
 std::uint32_t
 STObject::getFlags(void) const
 {
-    const STUInt32* t = dynamic_cast<const STUInt32*>(peekAtPField(sfFlags));
+    auto const lazy = peekLazy(sfFlags);
+    const STUInt32* t = dynamic_cast<const STUInt32*>(
+        lazy ? &lazy->get() : peekAtPField(sfFlags));
 
     if (!t)
         return 0;
@@ -513,6 +835,7 @@ STObject::delField(SField const& field)
 void
 STObject::delField(int index)
 {
+    materialize();
     v_.erase(v_.begin() + index);
 }
 
@@ -603,6 +926,7 @@ STObject::getFieldArray(SField const& field) const
 void
 STObject::set(std::unique_ptr<STBase> v)
 {
+    materialize();
     auto const i = getFieldIndex(v->getFName());
     if (i != -1)
     {
@@ -699,6 +1023,7 @@ STObject::getJson(JsonOptions options) const
 {
     Json::Value ret(Json::objectValue);
 
+    materialize();
     for (auto const& elem : v_)
     {
         if (elem->getSType() != STI_NOTPRESENT)
@@ -712,6 +1037,8 @@ STObject::operator==(const STObject& obj) const
 {
     // This is not particularly efficient, and only compares data elements
     // with binary representations
+    materialize();
+    obj.materialize();
     int matches = 0;
     for (auto const& t1 : v_)
     {
@@ -779,6 +1106,7 @@ std::vector<STBase const*>
 STObject::getSortedFields(STObject const& objToSort, WhichFields whichFields)
 {
     std::vector<STBase const*> sf;
+    objToSort.materialize();
     sf.reserve(objToSort.getCount());
 
     // Choose the fields that we need to sort.
@@ -25,12 +25,94 @@
 
 namespace ripple {
 
+namespace {
+
+// Buffers kept for reuse by each thread, and the largest one kept. Most
+// Serializers hold a single small object, so a few modest buffers cover
+// nearly all of them without pinning much memory.
+constexpr std::size_t poolSize = 16;
+constexpr std::size_t maxPooledCapacity = 16 * 1024;
+
+struct BufferPool
+{
+    std::vector<Blob> buffers;
+
+    BufferPool()
+    {
+        buffers.reserve(poolSize);
+    }
+
+    ~BufferPool();
+};
+
+// Serializers destroyed while the thread exits, after its pool is, must
+// not touch the pool. A trivially destructible flag is safe to read then.
+thread_local bool poolGone = false;
+
+BufferPool::~BufferPool()
+{
+    poolGone = true;
+}
+
+std::vector<Blob>*
+bufferPool()
+{
+    if (poolGone)
+        return nullptr;
+    thread_local BufferPool pool;
+    return &pool.buffers;
+}
+
+}  // namespace
+
+Blob
+Serializer::acquire(std::size_t n)
+{
+    Blob buffer;
+    if (auto const pool = bufferPool(); pool && !pool->empty())
+    {
+        buffer = std::move(pool->back());
+        pool->pop_back();
+    }
+    buffer.reserve(n);
+    return buffer;
+}
+
+void
+Serializer::release(Blob&& buffer) noexcept
+{
+    if (buffer.capacity() == 0 || buffer.capacity() > maxPooledCapacity)
+        return;
+
+    if (auto const pool = bufferPool(); pool && pool->size() < poolSize)
+    {
+        buffer.clear();
+        pool->push_back(std::move(buffer));
+    }
+}
+
+Serializer::Serializer(sha512_half_hasher& hasher)
+    : mData(acquire(spillSize + 64)), hasher_(&hasher)
+{
+}
+
+void
+Serializer::flush()
+{
+    if (hasher_ && !mData.empty())
+    {
+        (*hasher_)(mData.data(), mData.size());
+        mData.clear();
+    }
+}
+
 int
 Serializer::add16(std::uint16_t i)
 {
     int ret = mData.size();
     mData.push_back(static_cast<unsigned char>(i >> 8));
     mData.push_back(static_cast<unsigned char>(i & 0xff));
+    spill();
     return ret;
 }
 
@@ -42,6 +124,7 @@ Serializer::add32(std::uint32_t i)
     mData.push_back(static_cast<unsigned char>((i >> 16) & 0xff));
     mData.push_back(static_cast<unsigned char>((i >> 8) & 0xff));
     mData.push_back(static_cast<unsigned char>(i & 0xff));
+    spill();
     return ret;
 }
 
@@ -68,6 +151,7 @@ Serializer::add64(std::uint64_t i)
     mData.push_back(static_cast<unsigned char>((i >> 16) & 0xff));
     mData.push_back(static_cast<unsigned char>((i >> 8) & 0xff));
     mData.push_back(static_cast<unsigned char>(i & 0xff));
+    spill();
     return ret;
 }
 
@@ -99,24 +183,34 @@ Serializer::addInteger(std::uint64_t i)
 int
 Serializer::addRaw(Blob const& vector)
 {
-    int ret = mData.size();
-    mData.insert(mData.end(), vector.begin(), vector.end());
-    return ret;
+    return addRaw(vector.data(), vector.size());
+}
+
+int
+Serializer::addRaw(Slice slice)
+{
+    return addRaw(slice.data(), slice.size());
 }
 
 int
 Serializer::addRaw(const Serializer& s)
 {
-    int ret = mData.size();
-    mData.insert(mData.end(), s.begin(), s.end());
-    return ret;
+    return addRaw(s.data(), s.size());
 }
 
 int
 Serializer::addRaw(const void* ptr, int len)
 {
     int ret = mData.size();
+    if (hasher_ && len >= 256)
+    {
+        // Large pieces are hashed where they are rather than copied
+        flush();
+        (*hasher_)(ptr, len);
+        return ret;
+    }
     mData.insert(mData.end(), (const char*)ptr, ((const char*)ptr) + len);
+    spill();
     return ret;
 }
 
@@ -151,6 +245,7 @@ Serializer::addFieldID(int type, int name)
         mData.push_back(static_cast<unsigned char>(name));
     }
 
+    spill();
     return ret;
 }
 
@@ -159,6 +254,7 @@ Serializer::add8(unsigned char byte)
 {
     int ret = mData.size();
     mData.push_back(byte);
+    spill();
     return ret;
 }
 
@@ -194,8 +290,9 @@ Serializer::addVL(Blob const& vector)
     int ret = addEncoded(vector.size());
     addRaw(vector);
     assert(
+        hasher_ ||
         mData.size() ==
-        (ret + vector.size() + encodeLengthLength(vector.size())));
+            (ret + vector.size() + encodeLengthLength(vector.size())));
     return ret;
 }
 
@@ -20,8 +20,14 @@
 #include <ripple/protocol/digest.h>
 #include <openssl/ripemd.h>
 #include <openssl/sha.h>
+#include <cstring>
 #include <type_traits>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RIPPLE_SHA512_MULTIBUFFER 1
+#include <immintrin.h>
+#endif
+
 namespace ripple {
 
 openssl_ripemd160_hasher::openssl_ripemd160_hasher()
@@ -103,4 +109,255 @@ openssl_sha256_hasher::operator result_type() noexcept
     return digest;
 }
 
+//------------------------------------------------------------------------------
+
+#ifdef RIPPLE_SHA512_MULTIBUFFER
+
+namespace {
+
+constexpr std::uint64_t sha512K[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+constexpr std::uint64_t sha512Init[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+constexpr std::size_t lanes = 4;
+constexpr std::size_t blockSize = 128;
+
+bool
+hasAVX2()
+{
+    static bool const avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+}
+
+std::uint64_t
+loadBig64(std::uint8_t const* p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return boost::endian::big_to_native(v);
+}
+
+void
+storeBig64(std::uint8_t* p, std::uint64_t v)
+{
+    v = boost::endian::native_to_big(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+__attribute__((target("avx2"))) inline __m256i
+ror(__m256i x, int n)
+{
+    return _mm256_or_si256(
+        _mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+}
+
+/** Hash up to four messages at once, one per 64-bit lane.
+
+    Full blocks are read in place; the final one or two blocks of each
+    message, which hold the padding and the length, are assembled on the
+    stack. Lanes whose message has no more blocks keep their state.
+*/
+__attribute__((target("avx2"))) void
+sha512HalfX4(Slice const* messages, std::size_t count, uint256* digests)
+{
+    std::uint8_t tail[lanes][2 * blockSize];
+    std::uint8_t const* data[lanes];
+    std::size_t full[lanes];
+    std::int64_t blocks[lanes];
+    std::int64_t maxBlocks = 0;
+
+    for (std::size_t i = 0; i < lanes; ++i)
+    {
+        std::size_t const size = (i < count) ? messages[i].size() : 0;
+        data[i] = (i < count) ? messages[i].data() : tail[i];
+        full[i] = size / blockSize;
+
+        auto const rem = size % blockSize;
+        auto const tailBlocks = (rem + 17 > blockSize) ? 2 : 1;
+
+        std::memset(tail[i], 0, sizeof(tail[i]));
+        if (rem != 0)
+            std::memcpy(tail[i], data[i] + full[i] * blockSize, rem);
+        tail[i][rem] = 0x80;
+
+        // The length in bits, as a 128-bit big-endian integer
+        auto const end = tail[i] + tailBlocks * blockSize;
+        storeBig64(end - 16, static_cast<std::uint64_t>(size) >> 61);
+        storeBig64(end - 8, static_cast<std::uint64_t>(size) << 3);
+
+        blocks[i] = (i < count) ? full[i] + tailBlocks : 0;
+        maxBlocks = std::max(maxBlocks, blocks[i]);
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i)
+        state[i] = _mm256_set1_epi64x(sha512Init[i]);
+
+    __m256i const remaining =
+        _mm256_set_epi64x(blocks[3], blocks[2], blocks[1], blocks[0]);
+
+    for (std::int64_t n = 0; n < maxBlocks; ++n)
+    {
+        std::uint8_t const* p[lanes];
+        for (std::size_t i = 0; i < lanes; ++i)
+        {
+            if (static_cast<std::size_t>(n) < full[i])
+                p[i] = data[i] + n * blockSize;
+            else if (n < blocks[i])
+                p[i] = tail[i] + (n - full[i]) * blockSize;
+            else
+                p[i] = tail[i];
+        }
+
+        __m256i w[16];
+        for (int t = 0; t < 16; ++t)
+        {
+            w[t] = _mm256_set_epi64x(
+                loadBig64(p[3] + 8 * t),
+                loadBig64(p[2] + 8 * t),
+                loadBig64(p[1] + 8 * t),
+                loadBig64(p[0] + 8 * t));
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 80; ++t)
+        {
+            __m256i wt;
+            if (t < 16)
+            {
+                wt = w[t];
+            }
+            else
+            {
+                auto const w2 = w[(t - 2) & 15];
+                auto const w15 = w[(t - 15) & 15];
+                auto const s0 = _mm256_xor_si256(
+                    _mm256_xor_si256(ror(w15, 1), ror(w15, 8)),
+                    _mm256_srli_epi64(w15, 7));
+                auto const s1 = _mm256_xor_si256(
+                    _mm256_xor_si256(ror(w2, 19), ror(w2, 61)),
+                    _mm256_srli_epi64(w2, 6));
+                wt = _mm256_add_epi64(
+                    _mm256_add_epi64(w[t & 15], s0),
+                    _mm256_add_epi64(w[(t - 7) & 15], s1));
+                w[t & 15] = wt;
+            }
+
+            auto const S1 = _mm256_xor_si256(
+                _mm256_xor_si256(ror(e, 14), ror(e, 18)), ror(e, 41));
+            auto const ch = _mm256_xor_si256(
+                _mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            auto const t1 = _mm256_add_epi64(
+                _mm256_add_epi64(_mm256_add_epi64(h, S1), ch),
+                _mm256_add_epi64(_mm256_set1_epi64x(sha512K[t]), wt));
+            auto const S0 = _mm256_xor_si256(
+                _mm256_xor_si256(ror(a, 28), ror(a, 34)), ror(a, 39));
+            auto const maj = _mm256_or_si256(
+                _mm256_and_si256(a, b),
+                _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            auto const t2 = _mm256_add_epi64(S0, maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi64(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi64(t1, t2);
+        }
+
+        // Only lanes which still had a block to process take the result
+        auto const active =
+            _mm256_cmpgt_epi64(remaining, _mm256_set1_epi64x(n));
+        __m256i const work[8] = {a, b, c, d, e, f, g, h};
+        for (int i = 0; i < 8; ++i)
+        {
+            state[i] = _mm256_blendv_epi8(
+                state[i], _mm256_add_epi64(state[i], work[i]), active);
+        }
+    }
+
+    // SHA512-Half keeps the first four words of the digest
+    alignas(32) std::uint64_t words[4][lanes];
+    for (int i = 0; i < 4; ++i)
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), state[i]);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint8_t digest[32];
+        for (int j = 0; j < 4; ++j)
+            storeBig64(digest + 8 * j, words[j][i]);
+        digests[i] = uint256::fromVoid(digest);
+    }
+}
+
+}  // namespace
+
+#endif
+
+std::vector<uint256>
+sha512HalfBatch(std::vector<Slice> const& messages)
+{
+    std::vector<uint256> digests(messages.size());
+    std::size_t i = 0;
+
+#ifdef RIPPLE_SHA512_MULTIBUFFER
+    // A single message is faster through OpenSSL than in a vector lane
+    if (hasAVX2())
+    {
+        while (messages.size() - i >= 2)
+        {
+            auto const count = std::min(lanes, messages.size() - i);
+            sha512HalfX4(&messages[i], count, &digests[i]);
+            i += count;
+        }
+    }
+#endif
+
+    for (; i < messages.size(); ++i)
+    {
+        sha512_half_hasher h;
+        h(messages[i].data(), messages[i].size());
+        digests[i] = static_cast<sha512_half_hasher::result_type>(h);
+    }
+
+    return digests;
+}
+
 }  // namespace ripple
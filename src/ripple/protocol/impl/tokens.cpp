@@ -21,7 +21,7 @@
 #include <ripple/protocol/digest.h>
 #include <ripple/protocol/tokens.h>
 #include <boost/container/small_vector.hpp>
-#include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <type_traits>
@@ -88,60 +88,87 @@ checksum(void* out, void const* message, std::size_t size)
 
 namespace detail {
 
-/* The base58 encoding & decoding routines in this namespace are taken from
- * Bitcoin but have been modified from the original.
+/* The base58 encoding & decoding routines in this namespace were originally
+ * taken from Bitcoin but have since been rewritten to work on several digits
+ * at a time.
  *
  * Copyright (c) 2014 The Bitcoin Core developers
  * Distributed under the MIT software license, see the accompanying
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.
  */
+
+// Numbers are converted in limbs of five base 58 digits, the most that fit
+// in 32 bits, or four bytes.
+static constexpr std::uint64_t b58Limb = 58ull * 58 * 58 * 58 * 58;
+static constexpr std::size_t b58LimbDigits = 5;
+
 static std::string
-encodeBase58(
-    void const* message,
-    std::size_t size,
-    void* temp,
-    std::size_t temp_size)
+encodeBase58(void const* message, std::size_t size)
 {
     auto pbegin = reinterpret_cast<unsigned char const*>(message);
     auto const pend = pbegin + size;
 
     // Skip & count leading zeroes.
-    int zeroes = 0;
+    std::size_t zeroes = 0;
     while (pbegin != pend && *pbegin == 0)
     {
         pbegin++;
         zeroes++;
     }
 
-    auto const b58begin = reinterpret_cast<unsigned char*>(temp);
-    auto const b58end = b58begin + temp_size;
-
-    std::fill(b58begin, b58end, 0);
+    // The number, least significant limb first. Four bytes need a little
+    // more than one limb.
+    boost::container::small_vector<std::uint32_t, 16> limbs;
+    limbs.reserve((pend - pbegin) / 4 * 11 / 10 + 2);
 
     while (pbegin != pend)
     {
-        int carry = *pbegin;
-        // Apply "b58 = b58 * 256 + ch".
-        for (auto iter = b58end; iter != b58begin; --iter)
+        // Take up to four bytes at a time, the fewest first
+        auto n = (pend - pbegin) % 4;
+        if (n == 0)
+            n = 4;
+        std::uint64_t const scale = std::uint64_t{1} << (8 * n);
+        std::uint64_t carry = 0;
+        while (n--)
+            carry = (carry << 8) | *pbegin++;
+
+        // Apply "limbs = limbs * scale + carry".
+        for (auto& limb : limbs)
         {
-            carry += 256 * (iter[-1]);
-            iter[-1] = carry % 58;
-            carry /= 58;
+            carry += limb * scale;
+            limb = static_cast<std::uint32_t>(carry % b58Limb);
+            carry /= b58Limb;
+        }
+        while (carry != 0)
+        {
+            limbs.push_back(static_cast<std::uint32_t>(carry % b58Limb));
+            carry /= b58Limb;
+        }
+    }
+
+    // Write the digits out most significant first.
+    boost::container::small_vector<unsigned char, 64> b58(
+        limbs.size() * b58LimbDigits);
+    auto out = b58.end();
+    for (auto limb : limbs)
+    {
+        for (std::size_t i = 0; i < b58LimbDigits; ++i)
+        {
+            *--out = limb % 58;
+            limb /= 58;
         }
-        assert(carry == 0);
-        pbegin++;
     }
 
     // Skip leading zeroes in base58 result.
-    auto iter = b58begin;
-    while (iter != b58end && *iter == 0)
+    auto iter = b58.begin();
+    while (iter != b58.end() && *iter == 0)
         ++iter;
 
     // Translate the result into a string.
     std::string str;
-    str.reserve(zeroes + (b58end - iter));
+    str.reserve(zeroes + (b58.end() - iter));
     str.assign(zeroes, alphabetForward[0]);
-    while (iter != b58end)
+    while (iter != b58.end())
         str += alphabetForward[*(iter++)];
     return str;
 }
@@ -151,9 +178,14 @@ decodeBase58(std::string const& s)
 {
     auto psz = s.c_str();
     auto remain = s.size();
+
+    auto digit = [](char c) {
+        return alphabetReverse[static_cast<unsigned char>(c)];
+    };
+
     // Skip and count leading zeroes
-    int zeroes = 0;
-    while (remain > 0 && alphabetReverse[*psz] == 0)
+    std::size_t zeroes = 0;
+    while (remain > 0 && digit(*psz) == 0)
     {
         ++zeroes;
         ++psz;
@@ -163,33 +195,54 @@ decodeBase58(std::string const& s)
     if (remain > 64)
         return {};
 
-    // Allocate enough space in big-endian base256 representation.
-    // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(remain * 733 / 1000 + 1);
+    // The number in base 2^32, least significant limb first. Five digits
+    // need a little less than one limb.
+    boost::container::small_vector<std::uint32_t, 12> limbs;
     while (remain > 0)
     {
-        auto carry = alphabetReverse[*psz];
-        if (carry == -1)
-            return {};
-        // Apply "b256 = b256 * 58 + carry".
-        for (auto iter = b256.rbegin(); iter != b256.rend(); ++iter)
+        // Take up to five digits at a time, the fewest first
+        auto n = remain % b58LimbDigits;
+        if (n == 0)
+            n = b58LimbDigits;
+        std::uint64_t scale = 1;
+        std::uint64_t carry = 0;
+        for (; n != 0; --n, ++psz, --remain)
         {
-            carry += 58 * *iter;
-            *iter = carry % 256;
-            carry /= 256;
+            auto const d = digit(*psz);
+            if (d == -1)
+                return {};
+            carry = carry * 58 + d;
+            scale *= 58;
         }
-        assert(carry == 0);
-        ++psz;
-        --remain;
+
+        // Apply "limbs = limbs * scale + carry".
+        for (auto& limb : limbs)
+        {
+            carry += limb * scale;
+            limb = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry != 0)
+            limbs.push_back(static_cast<std::uint32_t>(carry));
     }
-    // Skip leading zeroes in b256.
-    auto iter = std::find_if(
-        b256.begin(), b256.end(), [](unsigned char c) { return c != 0; });
+
     std::string result;
-    result.reserve(zeroes + (b256.end() - iter));
+    result.reserve(zeroes + limbs.size() * 4);
     result.assign(zeroes, 0x00);
-    while (iter != b256.end())
-        result.push_back(*(iter++));
+
+    // Write the bytes out most significant first, skipping leading zeroes.
+    bool leading = true;
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            auto const c = static_cast<char>((*it >> shift) & 0xff);
+            if (leading && c == 0)
+                continue;
+            leading = false;
+            result.push_back(c);
+        }
+    }
     return result;
 }
 
@@ -201,12 +254,7 @@ encodeBase58Token(TokenType type, void const* token, std::size_t size)
     // expanded token includes type + 4 byte checksum
     auto const expanded = 1 + size + 4;
 
-    // We need expanded + expanded * (log(256) / log(58)) which is
-    // bounded by expanded + expanded * (138 / 100 + 1) which works
-    // out to expanded * 3:
-    auto const bufsize = expanded * 3;
-
-    boost::container::small_vector<std::uint8_t, 1024> buf(bufsize);
+    boost::container::small_vector<std::uint8_t, 64> buf(expanded);
 
     // Lay the data out as
     //      <type><token><checksum>
@@ -215,8 +263,7 @@ encodeBase58Token(TokenType type, void const* token, std::size_t size)
         std::memcpy(buf.data() + 1, token, size);
     checksum(buf.data() + 1 + size, buf.data(), 1 + size);
 
-    return detail::encodeBase58(
-        buf.data(), expanded, buf.data() + expanded, bufsize - expanded);
+    return detail::encodeBase58(buf.data(), expanded);
 }
 
 std::string
@@ -115,10 +115,12 @@ JSS(accounts);                    // in: LedgerEntry, Subscribe,
                                   //     handlers/Ledger, Unsubscribe
 JSS(accounts_proposed);           // in: Subscribe, Unsubscribe
 JSS(action);
+JSS(acquired);               // out: NetworkOPs
 JSS(acquiring);              // out: LedgerRequest
 JSS(address);                // out: PeerImp
 JSS(affected);               // out: AcceptedLedgerTx
 JSS(age);                    // out: NetworkOPs, Peers
+JSS(allocations);            // out: GetCounts
 JSS(alternatives);           // out: PathRequest, RipplePathFind
 JSS(amendment_blocked);      // out: NetworkOPs
 JSS(amendments);             // in: AccountObjects, out: NetworkOPs
@@ -149,6 +151,10 @@ JSS(both_sides);             // in: Subscribe, Unsubscribe
 JSS(broadcast);              // out: SubmitTransaction
 JSS(build_path);             // in: TransactionSign
 JSS(build_version);          // out: NetworkOPs
+JSS(bytes);                  // out: GetCounts
+JSS(bytes_in);               // out: get_counts
+JSS(bytes_out);              // out: get_counts
+JSS(cache_budget);           // out: GetCounts
 JSS(cancel_after);           // out: AccountChannels
 JSS(can_delete);             // out: CanDelete
 JSS(channel_id);             // out: AccountChannels
@@ -177,6 +183,7 @@ JSS(converge_time);          // out: NetworkOPs
 JSS(converge_time_s);        // out: NetworkOPs
 JSS(count);                  // in: AccountTx*, ValidatorList
 JSS(counters);               // in/out: retrieve counters
+JSS(created);                // out: LedgerDiff
 JSS(currency);               // in: paths/PathRequest, STAmount
                              // out: STPathSet, STAmount,
                              //      AccountLines
@@ -189,7 +196,10 @@ JSS(date);                    // out: tx/Transaction, NetworkOPs
 JSS(dbKBLedger);              // out: getCounts
 JSS(dbKBTotal);               // out: getCounts
 JSS(dbKBTransaction);         // out: getCounts
+JSS(dbReadsLedger);           // out: getCounts
+JSS(dbReadsTransaction);      // out: getCounts
 JSS(debug_signing);           // in: TransactionSign
+JSS(deleted);                 // out: LedgerDiff
 JSS(deletion_blockers_only);  // in: AccountObjects
 JSS(delivered_amount);        // out: insertDeliveredAmount
 JSS(deposit_authorized);      // out: deposit_authorized
@@ -209,9 +219,12 @@ JSS(dir_index);               // out: DirectoryEntryIterator
 JSS(dir_root);                // out: DirectoryEntryIterator
 JSS(directory);               // in: LedgerEntry
 JSS(domain);                  // out: ValidatorInfo, Manifest
+JSS(dropped);                 // out: CpuProfile
 JSS(drops);                   // out: TxQ
+JSS(duration);                // in: CpuProfile
 JSS(duration_us);             // out: NetworkOPs
 JSS(enabled);                 // out: AmendmentTable
+JSS(end_marker);              // in: LedgerData
 JSS(engine_result);           // out: NetworkOPs, TransactionSign, Submit
 JSS(engine_result_code);      // out: NetworkOPs, TransactionSign, Submit
 JSS(engine_result_message);   // out: NetworkOPs, TransactionSign, Submit
@@ -246,6 +259,7 @@ JSS(fix_txns);              // in: LedgerCleaner
 JSS(flags);                 // out: AccountOffers,
                             //      NetworkOPs
 JSS(forward);               // in: AccountTx
+JSS(frequency);             // in: CpuProfile
 JSS(freeze);                // out: AccountLines
 JSS(freeze_peer);           // out: AccountLines
 JSS(frozen_balances);       // out: GatewayBalances
@@ -253,6 +267,7 @@ JSS(full);                  // in: LedgerClearer, handlers/Ledger
 JSS(full_reply);            // out: PathFind
 JSS(fullbelow_size);        // out: GetCounts
 JSS(good);                  // out: RPCVersion
+JSS(handled);               // out: GetCounts
 JSS(hash);                  // out: NetworkOPs, InboundLedger,
                             //      LedgerToJson, STTx; field
 JSS(hashes);                // in: AccountObjects
@@ -262,12 +277,15 @@ JSS(have_transactions);     // out: InboundLedger
 JSS(highest_sequence);      // out: AccountInfo
 JSS(highest_ticket);        // out: AccountInfo
 JSS(historical_perminute);  // historical_perminute.
+JSS(history_fill);          // out: NetworkOPs
+JSS(hits);                  // out: GetCounts
 JSS(hostid);                // out: NetworkOPs
 JSS(hotwallet);             // in: GatewayBalances
 JSS(id);                    // websocket.
 JSS(ident);                 // in: AccountCurrencies, AccountInfo,
                             //     OwnerInfo
 JSS(inLedger);              // out: tx/Transaction
+JSS(in_flight);             // out: NetworkOPs
 JSS(inbound);               // out: PeerImp
 JSS(index);                 // in: LedgerEntry, DownloadShard
                             // out: STLedgerEntry,
@@ -335,6 +353,7 @@ JSS(load_factor_server);          // out: NetworkOPs
 JSS(load_fee);                    // out: LoadFeeTrackImp, NetworkOPs
 JSS(local);                       // out: resource/Logic.h
 JSS(local_txs);                   // out: GetCounts
+JSS(log_dropped);                 // out: GetCounts
 JSS(local_static_keys);           // out: ValidatorList
 JSS(lowest_sequence);             // out: AccountInfo
 JSS(lowest_ticket);               // out: AccountInfo
@@ -356,7 +375,9 @@ JSS(max_spend_drops);             // out: AccountInfo
 JSS(max_spend_drops_total);       // out: AccountInfo
 JSS(median_fee);                  // out: TxQ
 JSS(median_level);                // out: TxQ
+JSS(memory);                      // out: GetCounts
 JSS(message);                     // error.
+JSS(messages);                    // out: GetCounts
 JSS(meta);                        // out: NetworkOPs, AccountTx*, Tx
 JSS(metaData);
 JSS(metadata);  // out: TransactionEntry
@@ -367,7 +388,10 @@ JSS(min_count);                  // in: GetCounts
 JSS(min_ledger);                 // in: LedgerCleaner
 JSS(minimum_fee);                // out: TxQ
 JSS(minimum_level);              // out: TxQ
+JSS(misses);                     // out: GetCounts
+JSS(missing);                    // out: NetworkOPs
 JSS(missingCommand);             // error
+JSS(modified);                   // out: LedgerDiff
 JSS(name);                       // out: AmendmentTableImpl, PeerImp
 JSS(needed_state_hashes);        // out: InboundLedger
 JSS(needed_transaction_hashes);  // out: InboundLedger
@@ -395,12 +419,16 @@ JSS(open_ledger_fee);            // out: TxQ
 JSS(open_ledger_level);          // out: TxQ
 JSS(owner);                      // in: LedgerEntry, out: NetworkOPs
 JSS(owner_funds);                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS(p50_us);                     // out: get_counts
+JSS(p999_us);                    // out: get_counts
+JSS(p99_us);                     // out: get_counts
 JSS(params);                     // RPC
 JSS(parent_close_time);          // out: LedgerToJson
 JSS(parent_hash);                // out: LedgerToJson
 JSS(partition);                  // in: LogLevel
 JSS(passphrase);                 // in: WalletPropose
 JSS(password);                   // in: Subscribe
+JSS(path);                       // out: NodeStoreTrace
 JSS(paths);                      // in: RipplePathFind
 JSS(paths_canonical);            // out: RipplePathFind
 JSS(paths_computed);             // out: PathRequest, RipplePathFind
@@ -437,6 +465,7 @@ JSS(queue_data);                  // out: AccountInfo
 JSS(queued);                      // out: SubmitTransaction
 JSS(queued_duration_us);
 JSS(random);                // out: Random
+JSS(ranges);                // out: NetworkOPs
 JSS(raw_meta);              // out: AcceptedLedgerTx
 JSS(receive_currencies);    // out: AccountCurrencies
 JSS(reference_level);       // out: TxQ
@@ -452,6 +481,7 @@ JSS(reserve_inc);           // out: NetworkOPs
 JSS(reserve_inc_xrp);       // out: NetworkOPs
 JSS(response);              // websocket
 JSS(result);                // RPC
+JSS(results);               // out: SubmitMultiple
 JSS(ripple_lines);          // out: NetworkOPs
 JSS(ripple_state);          // in: LedgerEntr
 JSS(ripplerpc);             // ripple RPC version
@@ -459,6 +489,8 @@ JSS(role);                  // out: Ping.cpp
 JSS(rpc);
 JSS(rt_accounts);  // in: Subscribe, Unsubscribe
 JSS(running_duration_us);
+JSS(sample_rate);               // in/out: NodeStoreTrace
+JSS(samples);                   // out: CpuProfile
 JSS(search_depth);              // in: RipplePathFind
 JSS(searched_all);              // out: Tx
 JSS(secret);                    // in: TransactionSign,
@@ -468,6 +500,7 @@ JSS(seed);                      //
 JSS(seed_hex);                  // in: WalletPropose, TransactionSign
 JSS(send_currencies);           // out: AccountCurrencies
 JSS(send_max);                  // in: PathRequest, RipplePathFind
+JSS(send_queue_depth);          // out: Peers, GetCounts
 JSS(seq);                       // in: LedgerEntry;
                                 // out: NetworkOPs, RPCSub, AccountOffers,
                                 //      ValidatorList, ValidatorInfo, Manifest
@@ -492,6 +525,8 @@ JSS(source_account);            // in: PathRequest, RipplePathFind
 JSS(source_amount);             // in: PathRequest, RipplePathFind
 JSS(source_currencies);         // in: PathRequest, RipplePathFind
 JSS(source_tag);                // out: AccountChannels
+JSS(stack);                     // out: CpuProfile
+JSS(stacks);                    // out: CpuProfile
 JSS(stand_alone);               // out: NetworkOPs
 JSS(start);                     // in: TxHistory
 JSS(started);
@@ -513,6 +548,7 @@ JSS(taker_gets);          // in: Subscribe, Unsubscribe, BookOffers
 JSS(taker_gets_funded);   // out: NetworkOPs
 JSS(taker_pays);          // in: Subscribe, Unsubscribe, BookOffers
 JSS(taker_pays_funded);   // out: NetworkOPs
+JSS(target_bytes);        // out: GetCounts
 JSS(threshold);           // in: Blacklist
 JSS(ticket);              // in: AccountObjects
 JSS(ticket_count);        // out: AccountInfo
@@ -520,7 +556,7 @@ JSS(ticket_seq);          // in: LedgerEntry
 JSS(time);
 JSS(timeouts);                // out: InboundLedger
 JSS(track);                   // out: PeerImp
-JSS(traffic);                 // out: Overlay
+JSS(traffic);                 // out: Overlay, GetCounts
 JSS(total);                   // out: counters
 JSS(totalCoins);              // out: LedgerToJson
 JSS(total_bytes_recv);        // out: Peers
@@ -533,16 +569,20 @@ JSS(transaction_hash);        // out: RCLCxPeerPos, LedgerToJson
 JSS(transactions);            // out: LedgerToJson,
                               // in: AccountTx*, Unsubscribe
 JSS(transitions);             // out: NetworkOPs
+JSS(treenode_cache_bytes);    // out: GetCounts
 JSS(treenode_cache_size);     // out: GetCounts
+JSS(treenode_partition_hit_rate);  // out: GetCounts
 JSS(treenode_track_size);     // out: GetCounts
 JSS(trusted);                 // out: UnlList
 JSS(trusted_validator_keys);  // out: ValidatorList
 JSS(tx);                      // out: STTx, AccountTx*
 JSS(tx_blob);                 // in/out: Submit,
                               // in: TransactionSign, AccountTx*
+JSS(tx_blobs);                // in: SubmitMultiple
 JSS(tx_hash);                 // in: TransactionEntry
 JSS(tx_json);                 // in/out: TransactionSign
                               // out: TransactionEntry
+JSS(tx_partition_hit_rate);   // out: GetCounts
 JSS(tx_signing_hash);         // out: TransactionSign
 JSS(tx_unsigned);             // out: TransactionSign
 JSS(txn_count);               // out: NetworkOPs
@@ -576,12 +616,17 @@ JSS(validation_seed);         // out: ValidationCreate, ValidationSeed
 JSS(validations);             // out: AmendmentTableImpl
 JSS(validator_sites);         // out: ValidatorSites
 JSS(value);                   // out: STAmount
+JSS(verified);                // out: perf/PerfLog
+JSS(verify_duration_us);      // out: perf/PerfLog
 JSS(version);                 // out: RPCVersion
 JSS(vetoed);                  // out: AmendmentTableImpl
 JSS(vote);                    // in: Feature
+JSS(wait_us);                 // out: getCounts
+JSS(waits);                   // out: getCounts
 JSS(warning);                 // rpc:
 JSS(warnings);                // out: server_info, server_state
 JSS(workers);
+JSS(write_latency);  // out: Peers, GetCounts
 JSS(write_load);   // out: GetCounts
 JSS(NegativeUNL);  // out: ValidatorList; ledger type
 #undef JSS
@@ -25,7 +25,9 @@
 #include <ripple/beast/core/List.h>
 #include <ripple/resource/impl/Key.h>
 #include <ripple/resource/impl/Tuning.h>
+#include <atomic>
 #include <cassert>
+#include <mutex>
 
 namespace ripple {
 namespace Resource {
@@ -67,11 +69,19 @@ struct Entry : public beast::List<Entry>::Node
         return key->kind == kindUnlimited;
     }
 
+    // Balance not including remote contributions
+    int
+    localBalance(clock_type::time_point const now)
+    {
+        std::lock_guard _(balanceLock);
+        return local_balance.value(now);
+    }
+
     // Balance including remote contributions
     int
     balance(clock_type::time_point const now)
     {
-        return local_balance.value(now) + remote_balance;
+        return localBalance(now) + remote_balance;
     }
 
     // Add a charge and return normalized balance
@@ -79,20 +89,38 @@ struct Entry : public beast::List<Entry>::Node
     int
     add(int charge, clock_type::time_point const now)
     {
+        std::lock_guard _(balanceLock);
         return local_balance.add(charge, now) + remote_balance;
     }
 
+    // Returns `true` if no warning was given yet at this time, and
+    // remembers that one was.
+    bool
+    setWarned(clock_type::time_point const now)
+    {
+        std::lock_guard _(balanceLock);
+        if (lastWarningTime == now)
+            return false;
+        lastWarningTime = now;
+        return true;
+    }
+
     // Back pointer to the map key (bit of a hack here)
     Key const* key;
 
     // Number of Consumer references
     int refcount;
 
+    // Charges only need the entry itself, so they take this lock rather
+    // than the lock of the table holding the entry. It protects
+    // local_balance and lastWarningTime.
+    std::mutex balanceLock;
+
     // Exponentially decaying balance of resource consumption
     DecayingSample<decayWindowSeconds, clock_type> local_balance;
 
     // Normalized balance contribution from imports
-    int remote_balance;
+    std::atomic<int> remote_balance;
 
     // Time of the last warning
     clock_type::time_point lastWarningTime;
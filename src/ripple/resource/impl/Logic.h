@@ -31,6 +31,7 @@
 #include <ripple/resource/Fees.h>
 #include <ripple/resource/Gossip.h>
 #include <ripple/resource/impl/Import.h>
+#include <array>
 #include <cassert>
 #include <mutex>
 
@@ -57,34 +58,94 @@ private:
         beast::insight::Meter drop;
     };
 
-    Stats m_stats;
-    Stopwatch& m_clock;
-    beast::Journal m_journal;
+    // Every peer connection and every client request looks up an entry,
+    // so the entries are split by key between shards with their own locks.
+    struct Shard
+    {
+        std::mutex lock;
+
+        // Table of the entries in this shard
+        Table table;
+
+        // Because the following are intrusive lists, a given Entry may be in
+        // at most list at a given instant.  The Entry must be removed from
+        // one list before placing it in another.
+
+        // List of all active inbound entries
+        EntryIntrusiveList inbound;
 
-    std::recursive_mutex lock_;
+        // List of all active outbound entries
+        EntryIntrusiveList outbound;
 
-    // Table of all entries
-    Table table_;
+        // List of all active admin entries
+        EntryIntrusiveList admin;
 
-    // Because the following are intrusive lists, a given Entry may be in
-    // at most list at a given instant.  The Entry must be removed from
-    // one list before placing it in another.
+        // List of all inactve entries
+        EntryIntrusiveList inactive;
+
+        EntryIntrusiveList&
+        active(Kind kind)
+        {
+            switch (kind)
+            {
+                case kindInbound:
+                    return inbound;
+                case kindOutbound:
+                    return outbound;
+                case kindUnlimited:
+                    return admin;
+                default:
+                    assert(false);
+                    return inbound;
+            }
+        }
+    };
 
-    // List of all active inbound entries
-    EntryIntrusiveList inbound_;
+    static constexpr std::size_t shardCount = 16;
 
-    // List of all active outbound entries
-    EntryIntrusiveList outbound_;
+    Stats m_stats;
+    Stopwatch& m_clock;
+    beast::Journal m_journal;
 
-    // List of all active admin entries
-    EntryIntrusiveList admin_;
+    std::array<Shard, shardCount> shards_;
 
-    // List of all inactve entries
-    EntryIntrusiveList inactive_;
+    // Protects the import table. May be held while taking a shard lock,
+    // but not the other way around.
+    std::mutex importLock_;
 
     // All imported gossip data
     Imports importTable_;
 
+    Shard&
+    shardFor(Key const& key)
+    {
+        return shards_[Key::hasher{}(key) % shardCount];
+    }
+
+    // Find or create the entry for a key and take a reference to it
+    Consumer
+    newEndpoint(Key const& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard _(shard.lock);
+        auto [resultIt, resultInserted] = shard.table.emplace(
+            std::piecewise_construct,
+            std::make_tuple(key),              // Key
+            std::make_tuple(m_clock.now()));  // Entry
+
+        Entry& entry = resultIt->second;
+        entry.key = &resultIt->first;
+        ++entry.refcount;
+        if (entry.refcount == 1)
+        {
+            if (!resultInserted)
+                shard.inactive.erase(shard.inactive.iterator_to(entry));
+            shard.active(key.kind).push_back(entry);
+        }
+
+        return Consumer(*this, entry);
+    }
+
     //--------------------------------------------------------------------------
 public:
     Logic(
@@ -103,65 +164,24 @@ public:
         // destroyed before the consumer table.
         //
         importTable_.clear();
-        table_.clear();
+        for (auto& shard : shards_)
+            shard.table.clear();
     }
 
     Consumer
     newInboundEndpoint(beast::IP::Endpoint const& address)
     {
-        Entry* entry(nullptr);
-
-        {
-            std::lock_guard _(lock_);
-            auto [resultIt, resultInserted] = table_.emplace(
-                std::piecewise_construct,
-                std::make_tuple(kindInbound, address.at_port(0)),  // Key
-                std::make_tuple(m_clock.now()));                   // Entry
-
-            entry = &resultIt->second;
-            entry->key = &resultIt->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (!resultInserted)
-                {
-                    inactive_.erase(inactive_.iterator_to(*entry));
-                }
-                inbound_.push_back(*entry);
-            }
-        }
-
-        JLOG(m_journal.debug()) << "New inbound endpoint " << *entry;
-
-        return Consumer(*this, *entry);
+        auto consumer = newEndpoint(Key(kindInbound, address.at_port(0)));
+        JLOG(m_journal.debug()) << "New inbound endpoint " << consumer.entry();
+        return consumer;
     }
 
     Consumer
     newOutboundEndpoint(beast::IP::Endpoint const& address)
     {
-        Entry* entry(nullptr);
-
-        {
-            std::lock_guard _(lock_);
-            auto [resultIt, resultInserted] = table_.emplace(
-                std::piecewise_construct,
-                std::make_tuple(kindOutbound, address),  // Key
-                std::make_tuple(m_clock.now()));         // Entry
-
-            entry = &resultIt->second;
-            entry->key = &resultIt->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (!resultInserted)
-                    inactive_.erase(inactive_.iterator_to(*entry));
-                outbound_.push_back(*entry);
-            }
-        }
-
-        JLOG(m_journal.debug()) << "New outbound endpoint " << *entry;
-
-        return Consumer(*this, *entry);
+        auto consumer = newEndpoint(Key(kindOutbound, address));
+        JLOG(m_journal.debug()) << "New outbound endpoint " << consumer.entry();
+        return consumer;
     }
 
     /**
@@ -172,29 +192,10 @@ public:
     Consumer
     newUnlimitedEndpoint(beast::IP::Endpoint const& address)
     {
-        Entry* entry(nullptr);
-
-        {
-            std::lock_guard _(lock_);
-            auto [resultIt, resultInserted] = table_.emplace(
-                std::piecewise_construct,
-                std::make_tuple(kindUnlimited, address.at_port(1)),  // Key
-                std::make_tuple(m_clock.now()));                     // Entry
-
-            entry = &resultIt->second;
-            entry->key = &resultIt->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (!resultInserted)
-                    inactive_.erase(inactive_.iterator_to(*entry));
-                admin_.push_back(*entry);
-            }
-        }
-
-        JLOG(m_journal.debug()) << "New unlimited endpoint " << *entry;
-
-        return Consumer(*this, *entry);
+        auto consumer = newEndpoint(Key(kindUnlimited, address.at_port(1)));
+        JLOG(m_journal.debug())
+            << "New unlimited endpoint " << consumer.entry();
+        return consumer;
     }
 
     Json::Value
@@ -210,43 +211,29 @@ public:
         clock_type::time_point const now(m_clock.now());
 
         Json::Value ret(Json::objectValue);
-        std::lock_guard _(lock_);
 
-        for (auto& inboundEntry : inbound_)
-        {
-            int localBalance = inboundEntry.local_balance.value(now);
-            if ((localBalance + inboundEntry.remote_balance) >= threshold)
-            {
-                Json::Value& entry =
-                    (ret[inboundEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = inboundEntry.remote_balance;
-                entry[jss::type] = "inbound";
-            }
-        }
-        for (auto& outboundEntry : outbound_)
-        {
-            int localBalance = outboundEntry.local_balance.value(now);
-            if ((localBalance + outboundEntry.remote_balance) >= threshold)
+        auto add = [&](EntryIntrusiveList& list, char const* type) {
+            for (auto& listEntry : list)
             {
-                Json::Value& entry =
-                    (ret[outboundEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = outboundEntry.remote_balance;
-                entry[jss::type] = "outbound";
+                int localBalance = listEntry.localBalance(now);
+                int remoteBalance = listEntry.remote_balance;
+                if ((localBalance + remoteBalance) >= threshold)
+                {
+                    Json::Value& entry =
+                        (ret[listEntry.to_string()] = Json::objectValue);
+                    entry[jss::local] = localBalance;
+                    entry[jss::remote] = remoteBalance;
+                    entry[jss::type] = type;
+                }
             }
-        }
-        for (auto& adminEntry : admin_)
+        };
+
+        for (auto& shard : shards_)
         {
-            int localBalance = adminEntry.local_balance.value(now);
-            if ((localBalance + adminEntry.remote_balance) >= threshold)
-            {
-                Json::Value& entry =
-                    (ret[adminEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = adminEntry.remote_balance;
-                entry[jss::type] = "admin";
-            }
+            std::lock_guard _(shard.lock);
+            add(shard.inbound, "inbound");
+            add(shard.outbound, "outbound");
+            add(shard.admin, "admin");
         }
 
         return ret;
@@ -258,18 +245,20 @@ public:
         clock_type::time_point const now(m_clock.now());
 
         Gossip gossip;
-        std::lock_guard _(lock_);
 
-        gossip.items.reserve(inbound_.size());
-
-        for (auto& inboundEntry : inbound_)
+        for (auto& shard : shards_)
         {
-            Gossip::Item item;
-            item.balance = inboundEntry.local_balance.value(now);
-            if (item.balance >= minimumGossipBalance)
+            std::lock_guard _(shard.lock);
+
+            for (auto& inboundEntry : shard.inbound)
             {
-                item.address = inboundEntry.key->address;
-                gossip.items.push_back(item);
+                Gossip::Item item;
+                item.balance = inboundEntry.localBalance(now);
+                if (item.balance >= minimumGossipBalance)
+                {
+                    item.address = inboundEntry.key->address;
+                    gossip.items.push_back(item);
+                }
             }
         }
 
@@ -283,7 +272,7 @@ public:
     {
         auto const elapsed = m_clock.now();
         {
-            std::lock_guard _(lock_);
+            std::lock_guard _(importLock_);
             auto [resultIt, resultInserted] = importTable_.emplace(
                 std::piecewise_construct,
                 std::make_tuple(origin),  // Key
@@ -341,25 +330,30 @@ public:
     void
     periodicActivity()
     {
-        std::lock_guard _(lock_);
-
         auto const elapsed = m_clock.now();
 
-        for (auto iter(inactive_.begin()); iter != inactive_.end();)
+        for (auto& shard : shards_)
         {
-            if (iter->whenExpires <= elapsed)
-            {
-                JLOG(m_journal.debug()) << "Expired " << *iter;
-                auto table_iter = table_.find(*iter->key);
-                ++iter;
-                erase(table_iter);
-            }
-            else
+            std::lock_guard _(shard.lock);
+
+            for (auto iter(shard.inactive.begin());
+                 iter != shard.inactive.end();)
             {
-                break;
+                if (iter->whenExpires <= elapsed)
+                {
+                    JLOG(m_journal.debug()) << "Expired " << *iter;
+                    auto table_iter = shard.table.find(*iter->key);
+                    ++iter;
+                    erase(shard, table_iter);
+                }
+                else
+                {
+                    break;
+                }
             }
         }
 
+        std::lock_guard _(importLock_);
         auto iter = importTable_.begin();
         while (iter != importTable_.end())
         {
@@ -396,47 +390,36 @@ public:
         return Disposition::ok;
     }
 
+    // The caller must hold the shard's lock
     void
-    erase(Table::iterator iter)
+    erase(Shard& shard, Table::iterator iter)
     {
-        std::lock_guard _(lock_);
         Entry& entry(iter->second);
         assert(entry.refcount == 0);
-        inactive_.erase(inactive_.iterator_to(entry));
-        table_.erase(iter);
+        shard.inactive.erase(shard.inactive.iterator_to(entry));
+        shard.table.erase(iter);
     }
 
     void
     acquire(Entry& entry)
     {
-        std::lock_guard _(lock_);
+        auto& shard = shardFor(*entry.key);
+        std::lock_guard _(shard.lock);
         ++entry.refcount;
     }
 
     void
     release(Entry& entry)
     {
-        std::lock_guard _(lock_);
+        auto& shard = shardFor(*entry.key);
+        std::lock_guard _(shard.lock);
         if (--entry.refcount == 0)
         {
             JLOG(m_journal.debug()) << "Inactive " << entry;
 
-            switch (entry.key->kind)
-            {
-                case kindInbound:
-                    inbound_.erase(inbound_.iterator_to(entry));
-                    break;
-                case kindOutbound:
-                    outbound_.erase(outbound_.iterator_to(entry));
-                    break;
-                case kindUnlimited:
-                    admin_.erase(admin_.iterator_to(entry));
-                    break;
-                default:
-                    assert(false);
-                    break;
-            }
-            inactive_.push_back(entry);
+            auto& active = shard.active(entry.key->kind);
+            active.erase(active.iterator_to(entry));
+            shard.inactive.push_back(entry);
             entry.whenExpires = m_clock.now() + secondsUntilExpiration;
         }
     }
@@ -444,7 +427,6 @@ public:
     Disposition
     charge(Entry& entry, Charge const& fee)
     {
-        std::lock_guard _(lock_);
         clock_type::time_point const now(m_clock.now());
         int const balance(entry.add(fee.cost(), now));
         JLOG(m_journal.trace()) << "Charging " << entry << " for " << fee;
@@ -457,15 +439,13 @@ public:
         if (entry.isUnlimited())
             return false;
 
-        std::lock_guard _(lock_);
         bool notify(false);
         auto const elapsed = m_clock.now();
-        if (entry.balance(m_clock.now()) >= warningThreshold &&
-            elapsed != entry.lastWarningTime)
+        if (entry.balance(elapsed) >= warningThreshold &&
+            entry.setWarned(elapsed))
         {
             charge(entry, feeWarning);
             notify = true;
-            entry.lastWarningTime = elapsed;
         }
         if (notify)
         {
@@ -481,7 +461,6 @@ public:
         if (entry.isUnlimited())
             return false;
 
-        std::lock_guard _(lock_);
         bool drop(false);
         clock_type::time_point const now(m_clock.now());
         int const balance(entry.balance(now));
@@ -504,7 +483,6 @@ public:
     int
     balance(Entry& entry)
     {
-        std::lock_guard _(lock_);
         return entry.balance(m_clock.now());
     }
 
@@ -524,7 +502,7 @@ public:
             item["name"] = entry.to_string();
             item["balance"] = entry.balance(now);
             if (entry.remote_balance != 0)
-                item["remote_balance"] = entry.remote_balance;
+                item["remote_balance"] = entry.remote_balance.load();
         }
     }
 
@@ -533,27 +511,19 @@ public:
     {
         clock_type::time_point const now(m_clock.now());
 
-        std::lock_guard _(lock_);
-
-        {
-            beast::PropertyStream::Set s("inbound", map);
-            writeList(now, s, inbound_);
-        }
-
-        {
-            beast::PropertyStream::Set s("outbound", map);
-            writeList(now, s, outbound_);
-        }
-
-        {
-            beast::PropertyStream::Set s("admin", map);
-            writeList(now, s, admin_);
-        }
+        auto write = [&](char const* name, auto list) {
+            beast::PropertyStream::Set s(name, map);
+            for (auto& shard : shards_)
+            {
+                std::lock_guard _(shard.lock);
+                writeList(now, s, shard.*list);
+            }
+        };
 
-        {
-            beast::PropertyStream::Set s("inactive", map);
-            writeList(now, s, inactive_);
-        }
+        write("inbound", &Shard::inbound);
+        write("outbound", &Shard::outbound);
+        write("admin", &Shard::admin);
+        write("inactive", &Shard::inactive);
     }
 };
 
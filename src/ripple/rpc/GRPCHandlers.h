@@ -23,6 +23,7 @@
 #include <ripple/rpc/Context.h>
 #include <grpcpp/grpcpp.h>
 #include <org/xrpl/rpc/v1/xrp_ledger.pb.h>
+#include <functional>
 
 namespace ripple {
 
@@ -45,6 +46,10 @@ std::pair<org::xrpl::rpc::v1::SubmitTransactionResponse, grpc::Status>
 doSubmitGrpc(
     RPC::GRPCContext<org::xrpl::rpc::v1::SubmitTransactionRequest>& context);
 
+std::pair<org::xrpl::rpc::v1::SubmitTransactionsResponse, grpc::Status>
+doSubmitMultipleGrpc(
+    RPC::GRPCContext<org::xrpl::rpc::v1::SubmitTransactionsRequest>& context);
+
 // NOTE, this only supports Payment transactions at this time
 std::pair<org::xrpl::rpc::v1::GetTransactionResponse, grpc::Status>
 doTxGrpc(RPC::GRPCContext<org::xrpl::rpc::v1::GetTransactionRequest>& context);
@@ -56,6 +61,20 @@ doAccountTxGrpc(
     RPC::GRPCContext<org::xrpl::rpc::v1::GetAccountTransactionHistoryRequest>&
         context);
 
+std::pair<org::xrpl::rpc::v1::GetLedgerResponse, grpc::Status>
+doLedgerGrpc(RPC::GRPCContext<org::xrpl::rpc::v1::GetLedgerRequest>& context);
+
+/*
+ * This handler streams its response. It calls `write` with each response
+ * message, which returns false if the client has gone away. The returned
+ * status finishes the call.
+ */
+grpc::Status
+doLedgerDataGrpc(
+    RPC::GRPCContext<org::xrpl::rpc::v1::GetLedgerDataRequest>& context,
+    std::function<bool(org::xrpl::rpc::v1::GetLedgerDataResponse const&)> const&
+        write);
+
 }  // namespace ripple
 
 #endif
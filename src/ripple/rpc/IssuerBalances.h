@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_ISSUERBALANCES_H_INCLUDED
+#define RIPPLE_RPC_ISSUERBALANCES_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ripple {
+
+class ReadView;
+
+namespace RPC {
+
+/** The totals of the trust lines of issuers, kept from ledger to ledger.
+
+    Summing an issuer's obligations means reading every trust line in its
+    owner directory, which takes seconds for the largest issuers, while
+    only a few of those lines change in each ledger. The totals of an
+    issuer are kept with the closed ledger they were taken from; asked
+    about the ledger which follows it, only the trust lines named by the
+    metadata of that ledger's transactions are read again.
+
+    Adding and taking away amounts rounds differently than summing them in
+    directory order, so the totals are taken afresh every so often.
+*/
+class IssuerBalances
+{
+public:
+    /** A trust line with a balance which isn't an ordinary obligation:
+        an asset of the issuer, or an obligation it has frozen. */
+    struct Line
+    {
+        AccountID peer;
+
+        /** The balance, as the issuer's side of the line sees it. */
+        STAmount balance;
+    };
+
+    struct Totals
+    {
+        /** The sum of the ordinary obligations in each currency, and the
+            number of trust lines holding them. */
+        std::map<Currency, std::pair<STAmount, std::size_t>> obligations;
+
+        /** The other trust lines with a balance, by key. */
+        std::map<uint256, Line> others;
+    };
+
+    /** Create a cache.
+
+        @param maxIssuers The most issuers totals are kept for.
+    */
+    explicit IssuerBalances(std::size_t maxIssuers);
+
+    IssuerBalances(IssuerBalances const&) = delete;
+    IssuerBalances&
+    operator=(IssuerBalances const&) = delete;
+
+    /** Return the totals of the trust lines of an issuer in a ledger. */
+    std::shared_ptr<Totals const>
+    get(std::shared_ptr<ReadView const> const& ledger, AccountID const& issuer);
+
+    /** Add a trust line to the totals of an issuer, or take it away.
+
+        Lines which don't belong to the issuer or have no balance are
+        ignored.
+    */
+    static void
+    tally(
+        Totals& totals,
+        AccountID const& issuer,
+        std::shared_ptr<SLE const> const& sle,
+        bool add);
+
+    /** The number of ledgers totals are carried forward before they are
+        taken afresh. */
+    static constexpr std::uint32_t maxUpdates = 256;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<ReadView const> ledger;
+        std::shared_ptr<Totals const> totals;
+        std::uint32_t updates = 0;
+    };
+
+    // Read every trust line of the issuer
+    static std::shared_ptr<Totals const>
+    walk(ReadView const& ledger, AccountID const& issuer);
+
+    // Carry totals forward to the ledger which follows theirs. Returns
+    // nothing if that ledger's transactions have no metadata.
+    static std::shared_ptr<Totals const>
+    advance(
+        Entry const& entry,
+        ReadView const& ledger,
+        AccountID const& issuer);
+
+    std::size_t const maxIssuers_;
+
+    std::mutex mutex_;
+    hash_map<AccountID, Entry> entries_;
+};
+
+}  // namespace RPC
+}  // namespace ripple
+
+#endif
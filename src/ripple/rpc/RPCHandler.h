@@ -24,6 +24,11 @@
 #include <ripple/net/InfoSub.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Status.h>
+#include <functional>
+
+namespace Json {
+class Object;
+}
 
 namespace ripple {
 namespace RPC {
@@ -34,6 +39,16 @@ struct JsonContext;
 Status
 doCommand(RPC::JsonContext&, Json::Value&);
 
+/** Prepare an RPC command whose result can be written a piece at a time.
+
+    @return A function which executes the command, writing its result into
+        an object, or an empty function if the command must be executed with
+        doCommand instead. That includes any request with an error, so that
+        the error is reported in the usual way.
+*/
+std::function<Status(Json::Object&)>
+prepareCommand(RPC::JsonContext&);
+
 Role
 roleRequired(unsigned int version, std::string const& method);
 
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+#define RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/json/json_value.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ripple {
+namespace RPC {
+
+/** Results of read-only commands against the last validated ledger.
+
+    Clients often poll the same command about the same account or book,
+    asking for the validated ledger, many times before it changes. The
+    result only depends on the command, its parameters and that ledger, so
+    it can be computed once and copied for the other requests.
+
+    Each entry is tied to the hash of the ledger it was computed from.
+    When a lookup names a different ledger every entry is dropped, so the
+    cache never holds results for more than one ledger.
+*/
+class ResponseCache
+{
+public:
+    /** Create a cache.
+
+        @param maxSize The most results kept. Zero disables the cache.
+    */
+    explicit ResponseCache(std::size_t maxSize);
+
+    ResponseCache(ResponseCache const&) = delete;
+    ResponseCache&
+    operator=(ResponseCache const&) = delete;
+
+    bool
+    enabled() const
+    {
+        return maxSize_ != 0;
+    }
+
+    /** Return the result cached for a request against a ledger, if any. */
+    std::shared_ptr<Json::Value const>
+    fetch(uint256 const& ledger, std::string const& key);
+
+    /** Remember the result of a request against a ledger.
+
+        Nothing is stored if the cache is full, or if a lookup has named
+        another ledger since the result was computed.
+    */
+    void
+    insert(uint256 const& ledger, std::string key, Json::Value const& result);
+
+    std::size_t
+    size() const;
+
+    std::uint64_t
+    hits() const;
+
+private:
+    // Must be called with the mutex held
+    void
+    advance(uint256 const& ledger);
+
+    std::size_t const maxSize_;
+
+    mutable std::mutex mutex_;
+    uint256 ledger_;
+    std::unordered_map<std::string, std::shared_ptr<Json::Value const>>
+        entries_;
+    std::uint64_t hits_ = 0;
+};
+
+}  // namespace RPC
+}  // namespace ripple
+
+#endif
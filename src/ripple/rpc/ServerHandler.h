@@ -45,6 +45,7 @@ make_ServerHandler(
     Application& app,
     Stoppable& parent,
     boost::asio::io_service&,
+    boost::asio::io_service& peer_io_service,
     JobQueue&,
     NetworkOPs&,
     Resource::Manager&,
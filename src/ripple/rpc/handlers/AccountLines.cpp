@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/paths/RippleState.h>
 #include <ripple/ledger/ReadView.h>
@@ -72,12 +73,21 @@ addLine(Json::Value& jsonLines, RippleState const& line)
         jPeer[jss::freeze_peer] = true;
 }
 
+void
+addBinaryLine(Json::Value& jsonLines, RippleState const& line)
+{
+    Json::Value& jPeer(jsonLines.append(Json::objectValue));
+    jPeer[jss::data] = serializeHex(line.sle());
+    jPeer[jss::index] = to_string(line.key());
+}
+
 // {
 //   account: <account>|<account_public_key>
 //   ledger_hash : <ledger>
 //   ledger_index : <ledger_index>
 //   limit: integer                 // optional
 //   marker: opaque                 // optional, resume previous query
+//   binary: boolean                // optional, lines as serialized entries
 // }
 Json::Value
 doAccountLines(RPC::JsonContext& context)
@@ -124,6 +134,10 @@ doAccountLines(RPC::JsonContext& context)
     if (auto err = readLimitField(limit, RPC::Tuning::accountLines, context))
         return *err;
 
+    bool const binary =
+        params.isMember(jss::binary) && params[jss::binary].asBool();
+    auto const add = binary ? &addBinaryLine : &addLine;
+
     Json::Value& jsonLines(result[jss::lines] = Json::arrayValue);
     VisitData visitData = {{}, accountID, hasPeer, raPeerAccount};
     unsigned int reserve(limit);
@@ -159,7 +173,7 @@ doAccountLines(RPC::JsonContext& context)
         if (line == nullptr)
             return rpcError(rpcINVALID_PARAMS);
 
-        addLine(jsonLines, *line);
+        add(jsonLines, *line);
         visitData.items.reserve(reserve);
     }
     else
@@ -206,7 +220,7 @@ doAccountLines(RPC::JsonContext& context)
     result[jss::account] = context.app.accountIDCache().toBase58(accountID);
 
     for (auto const& item : visitData.items)
-        addLine(jsonLines, *item.get());
+        add(jsonLines, *item.get());
 
     context.loadType = Resource::feeMediumBurdenRPC;
     return result;
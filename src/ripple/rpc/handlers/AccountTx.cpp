@@ -21,9 +21,11 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/json_value.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/net/RPCErr.h>
+#include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/protocol/jss.h>
@@ -32,6 +34,7 @@
 #include <ripple/rpc/DeliveredAmount.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/impl/GRPCHelpers.h>
+#include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 
 #include <grpcpp/grpcpp.h>
@@ -219,6 +222,10 @@ getLedgerRange(
         return rpcNOT_SYNCED;
     }
 
+    // Older ledgers held in final shards can be searched too
+    if (auto const shardStore = context.app.getShardStore())
+        uValidatedMin = shardStore->firstContiguousSeq(uValidatedMin);
+
     std::uint32_t uLedgerMin = uValidatedMin;
     std::uint32_t uLedgerMax = uValidatedMax;
     // Does request specify a ledger or ledger range?
@@ -512,22 +519,11 @@ populateJsonResponse(
     return response;
 }
 
-// {
-//   account: account,
-//   ledger_index_min: ledger_index  // optional, defaults to earliest
-//   ledger_index_max: ledger_index, // optional, defaults to latest
-//   binary: boolean,                // optional, defaults to false
-//   forward: boolean,               // optional, defaults to false
-//   limit: integer,                 // optional
-//   marker: object {ledger: ledger_index, seq: txn_sequence} // optional,
-//   resume previous query
-// }
-Json::Value
-doAccountTxJson(RPC::JsonContext& context)
+// Parses the JSON arguments, or returns the error to report
+static std::optional<Json::Value>
+parseJsonArgs(RPC::JsonContext const& context, AccountTxArgs& args)
 {
     auto& params = context.params;
-    AccountTxArgs args;
-    Json::Value response;
 
     args.limit = params.isMember(jss::limit) ? params[jss::limit].asUInt() : 0;
     args.binary = params.isMember(jss::binary) && params[jss::binary].asBool();
@@ -561,6 +557,7 @@ doAccountTxJson(RPC::JsonContext& context)
             !token[jss::ledger].isConvertibleTo(Json::ValueType::uintValue) ||
             !token[jss::seq].isConvertibleTo(Json::ValueType::uintValue))
         {
+            Json::Value response;
             RPC::Status status{
                 rpcINVALID_PARAMS,
                 "invalid marker. Provide ledger index via ledger field, and "
@@ -571,10 +568,87 @@ doAccountTxJson(RPC::JsonContext& context)
         args.marker = {token[jss::ledger].asUInt(), token[jss::seq].asUInt()};
     }
 
+    return {};
+}
+
+// {
+//   account: account,
+//   ledger_index_min: ledger_index  // optional, defaults to earliest
+//   ledger_index_max: ledger_index, // optional, defaults to latest
+//   binary: boolean,                // optional, defaults to false
+//   forward: boolean,               // optional, defaults to false
+//   limit: integer,                 // optional
+//   marker: object {ledger: ledger_index, seq: txn_sequence} // optional,
+//   resume previous query
+// }
+Json::Value
+doAccountTxJson(RPC::JsonContext& context)
+{
+    AccountTxArgs args;
+    if (auto error = parseJsonArgs(context, args))
+        return std::move(*error);
+
     auto res = doAccountTxHelp(context, args);
     return populateJsonResponse(res, args, context);
 }
 
+// Binary results are written straight from the stored blobs, without
+// building a Json::Value for the page. The fields are written in the
+// order populateJsonResponse's Json::Value would have sorted them, so
+// the reply is identical.
+RPC::Status
+prepareAccountTxJson(
+    RPC::JsonContext& context,
+    RPC::Handler::ObjectWriter& writer)
+{
+    AccountTxArgs args;
+    if (parseJsonArgs(context, args))
+        return rpcINVALID_PARAMS;
+
+    // JSON results need the parsed transactions and metadata anyway
+    if (!args.binary)
+        return rpcNOT_SUPPORTED;
+
+    // Read the page now: the writer may suspend the coroutine, which must
+    // not happen while a database session is checked out.
+    auto res = std::make_shared<std::pair<AccountTxResult, RPC::Status>>(
+        doAccountTxHelp(context, args));
+    if (res->second)
+        return res->second;
+
+    writer = [res, account = context.params[jss::account].asString()](
+                 Json::Object& response) {
+        AccountTxResult const& result = res->first;
+        response[jss::account] = account;
+        response[jss::ledger_index_max] = result.ledgerRange.max;
+        response[jss::ledger_index_min] = result.ledgerRange.min;
+        response[jss::limit] = result.limit;
+
+        if (result.marker)
+        {
+            auto marker = Json::addObject(response, jss::marker);
+            marker[jss::ledger] = result.marker->ledgerSeq;
+            marker[jss::seq] = result.marker->txnSeq;
+        }
+
+        {
+            auto txns = Json::setArray(response, jss::transactions);
+            for (auto const& [txn, meta, ledgerIndex] :
+                 std::get<TxnsDataBinary>(result.transactions))
+            {
+                auto jvObj = Json::appendObject(txns);
+                jvObj[jss::ledger_index] = ledgerIndex;
+                jvObj[jss::meta] = strHex(meta);
+                jvObj[jss::tx_blob] = strHex(txn);
+                jvObj[jss::validated] = true;
+            }
+        }
+
+        response[jss::validated] = true;
+    };
+    return {};
+}
+
 std::pair<
     org::xrpl::rpc::v1::GetAccountTransactionHistoryResponse,
     grpc::Status>
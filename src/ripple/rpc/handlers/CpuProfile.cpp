@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/CpuProfile.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/Context.h>
+#include <optional>
+
+namespace ripple {
+
+namespace {
+
+// The value of an optional field from 1 to `most`, or nothing if invalid
+std::optional<unsigned>
+readField(
+    Json::Value const& params,
+    Json::StaticString const& name,
+    unsigned value,
+    unsigned most)
+{
+    if (!params.isMember(name))
+        return value;
+    auto const& field = params[name];
+    if (!(field.isUInt() || field.isInt()) ||
+        !field.isConvertibleTo(Json::uintValue) || field.asUInt() == 0 ||
+        field.asUInt() > most)
+        return {};
+    return field.asUInt();
+}
+
+}  // namespace
+
+// {
+//   duration: <number>   // optional, seconds to profile for, default 5
+//   frequency: <number>  // optional, samples per second of processor
+//                        // time, default 100
+// }
+//
+// Blocks the calling thread while the profile runs.
+Json::Value
+doCpuProfile(RPC::JsonContext& context)
+{
+    auto const& params = context.params;
+
+    auto const duration = readField(params, jss::duration, 5, 20);
+    if (!duration)
+        return RPC::invalid_field_error(jss::duration);
+    auto const frequency = readField(params, jss::frequency, 100, 1000);
+    if (!frequency)
+        return RPC::invalid_field_error(jss::frequency);
+
+    auto const profile =
+        runCpuProfile(std::chrono::seconds{*duration}, *frequency);
+    if (!profile)
+        return RPC::make_error(
+            rpcNOT_ENABLED,
+            "Profiling is not supported, or a profile is already running.");
+
+    Json::Value ret(Json::objectValue);
+    ret[jss::duration] = *duration;
+    ret[jss::frequency] = *frequency;
+    ret[jss::samples] = static_cast<Json::UInt>(profile->samples);
+    ret[jss::dropped] = static_cast<Json::UInt>(profile->dropped);
+    auto& stacks = (ret[jss::stacks] = Json::arrayValue);
+    for (auto const& stack : profile->stacks)
+    {
+        Json::Value entry(Json::objectValue);
+        entry[jss::stack] = stack.frames;
+        entry[jss::count] = static_cast<Json::UInt>(stack.count);
+        stacks.append(std::move(entry));
+    }
+    return ret;
+}
+
+}  // namespace ripple
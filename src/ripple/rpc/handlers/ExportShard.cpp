@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <ripple/net/RPCErr.h>
+#include <ripple/nodestore/DatabaseShard.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/impl/Handler.h>
+
+namespace ripple {
+
+/** RPC command that writes a self-contained copy of a final shard.
+    {
+      index: <integer>,
+      path: <string>
+    }
+
+    example:
+    {
+      "command": "export_shard",
+      "index": 5,
+      "path": "/tmp/shards/5"
+    }
+
+    The copy is written in the background. Once complete the directory
+    may be packed into an archive for other servers to download_shard.
+*/
+Json::Value
+doExportShard(RPC::JsonContext& context)
+{
+    if (context.role != Role::ADMIN)
+        return rpcError(rpcNO_PERMISSION);
+
+    // The shard store must be configured
+    auto shardStore{context.app.getShardStore()};
+    if (!shardStore)
+        return rpcError(rpcNOT_ENABLED);
+
+    auto const& params{context.params};
+    if (!params.isMember(jss::index))
+        return RPC::missing_field_error(jss::index);
+    auto const& jv{params[jss::index]};
+    if (!(jv.isUInt() || (jv.isInt() && jv.asInt() >= 0)))
+    {
+        return RPC::expected_field_error(
+            std::string(jss::index), "an unsigned integer");
+    }
+
+    if (!params.isMember(jss::path))
+        return RPC::missing_field_error(jss::path);
+    if (!params[jss::path].isString() || params[jss::path].asString().empty())
+        return RPC::expected_field_error(std::string(jss::path), "a path");
+
+    auto const shardIndex{jv.asUInt()};
+    if (!shardStore->exportShard(shardIndex, params[jss::path].asString()))
+    {
+        return RPC::make_param_error(
+            "Shard " + std::to_string(shardIndex) +
+            " is not complete or the path exists");
+    }
+
+    return RPC::makeObjectValue(
+        "Exporting shard " + std::to_string(shardIndex));
+}
+
+}  // namespace ripple
@@ -26,6 +26,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/IssuerBalances.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 
 namespace ripple {
@@ -140,53 +141,53 @@ doGatewayBalances(RPC::JsonContext& context)
     std::map<AccountID, std::vector<STAmount>> assets;
     std::map<AccountID, std::vector<STAmount>> frozenBalances;
 
-    // Traverse the cold wallet's trust lines
-    {
-        forEachItem(
-            *ledger, accountID, [&](std::shared_ptr<SLE const> const& sle) {
-                auto rs = RippleState::makeItem(accountID, sle);
-
-                if (!rs)
-                    return;
+    // The totals of the cold wallet's trust lines, carried forward from
+    // the previous ledger when possible
+    auto const totals = context.app.getIssuerBalances().get(ledger, accountID);
 
-                int balSign = rs->getBalance().signum();
-                if (balSign == 0)
-                    return;
+    // Here, a negative balance means the cold wallet owes (normal)
+    // A positive balance means the cold wallet has an asset (unusual)
+    for (auto const& [currency, obligation] : totals->obligations)
+    {
+        auto sum = obligation.first;
+        auto count = obligation.second;
 
-                auto const& peer = rs->getAccountIDPeer();
+        // Obligations to the specified hot wallets aren't counted
+        for (auto const& hotWallet : hotWallets)
+        {
+            auto const rs = RippleState::makeItem(
+                accountID,
+                ledger->read(keylet::line(accountID, hotWallet, currency)));
+            if (rs && rs->getBalance().signum() < 0 && !rs->getFreeze())
+            {
+                hotBalances[hotWallet].push_back(-rs->getBalance());
+                sum += rs->getBalance();
+                --count;
+            }
+        }
 
-                // Here, a negative balance means the cold wallet owes (normal)
-                // A positive balance means the cold wallet has an asset
-                // (unusual)
+        if (count != 0)
+            sums.emplace(currency, sum);
+    }
 
-                if (hotWallets.count(peer) > 0)
-                {
-                    // This is a specified hot wallet
-                    hotBalances[peer].push_back(-rs->getBalance());
-                }
-                else if (balSign > 0)
-                {
-                    // This is a gateway asset
-                    assets[peer].push_back(rs->getBalance());
-                }
-                else if (rs->getFreeze())
-                {
-                    // An obligation the gateway has frozen
-                    frozenBalances[peer].push_back(-rs->getBalance());
-                }
-                else
-                {
-                    // normal negative balance, obligation to customer
-                    auto& bal = sums[rs->getBalance().getCurrency()];
-                    if (bal == beast::zero)
-                    {
-                        // This is needed to set the currency code correctly
-                        bal = -rs->getBalance();
-                    }
-                    else
-                        bal -= rs->getBalance();
-                }
-            });
+    for (auto const& [key, line] : totals->others)
+    {
+        (void)key;
+        if (hotWallets.count(line.peer) > 0)
+        {
+            // This is a specified hot wallet
+            hotBalances[line.peer].push_back(-line.balance);
+        }
+        else if (line.balance.signum() > 0)
+        {
+            // This is a gateway asset
+            assets[line.peer].push_back(line.balance);
+        }
+        else
+        {
+            // An obligation the gateway has frozen
+            frozenBalances[line.peer].push_back(-line.balance);
+        }
     }
 
     if (!sums.empty())
@@ -20,8 +20,11 @@
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/CacheBudget.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
@@ -29,6 +32,7 @@
 #include <ripple/net/RPCErr.h>
 #include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/DatabaseShard.h>
+#include <ripple/overlay/Overlay.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
@@ -61,6 +65,26 @@ textTime(
         text += "s";
 }
 
+static Json::Value
+readStats(DatabaseCon const& db)
+{
+    auto const stats = db.readStats();
+    Json::Value ret(Json::objectValue);
+    ret[jss::count] = std::to_string(stats.count);
+    ret[jss::waits] = std::to_string(stats.waits);
+    ret[jss::wait_us] = std::to_string(stats.waitTime.count());
+    return ret;
+}
+
+static Json::Value
+partitionHitRates(std::vector<float> const& rates)
+{
+    Json::Value ret(Json::arrayValue);
+    for (auto const rate : rates)
+        ret.append(rate);
+    return ret;
+}
+
 Json::Value
 getCountsJson(Application& app, int minObjectCount)
 {
@@ -88,12 +112,18 @@ getCountsJson(Application& app, int minObjectCount)
     if (dbKB > 0)
         ret[jss::dbKBTransaction] = dbKB;
 
+    ret[jss::dbReadsLedger] = readStats(app.getLedgerDB());
+    ret[jss::dbReadsTransaction] = readStats(app.getTxnDB());
+
     {
         std::size_t c = app.getOPs().getLocalTxCount();
         if (c > 0)
             ret[jss::local_txs] = static_cast<Json::UInt>(c);
     }
 
+    if (auto const dropped = app.logs().dropped())
+        ret[jss::log_dropped] = std::to_string(dropped);
+
     ret[jss::write_load] = app.getNodeStore().getWriteLoad();
 
     ret[jss::historical_perminute] =
@@ -109,6 +139,36 @@ getCountsJson(Application& app, int minObjectCount)
         app.getNodeFamily().getTreeNodeCache(0)->getCacheSize();
     ret[jss::treenode_track_size] =
         app.getNodeFamily().getTreeNodeCache(0)->getTrackSize();
+    ret[jss::treenode_cache_bytes] = std::to_string(
+        app.getNodeFamily().getTreeNodeCache(0)->getCacheBytes());
+    ret[jss::treenode_partition_hit_rate] = partitionHitRates(
+        app.getNodeFamily().getTreeNodeCache(0)->getPartitionHitRates());
+    ret[jss::tx_partition_hit_rate] = partitionHitRates(
+        app.getMasterTransaction().getCache().getPartitionHitRates());
+
+    if (auto const budget = app.getCacheBudget())
+    {
+        Json::Value& jv = (ret[jss::cache_budget] = Json::objectValue);
+        jv[jss::bytes] = std::to_string(budget->bytes());
+        for (auto const& cache : budget->report())
+        {
+            Json::Value& entry = (jv[cache.name] = Json::objectValue);
+            entry[jss::bytes] = std::to_string(cache.bytes);
+            entry[jss::target_bytes] = std::to_string(cache.targetBytes);
+            entry[jss::hits] = std::to_string(cache.hits);
+            entry[jss::misses] = std::to_string(cache.misses);
+        }
+    }
+
+    {
+        Json::Value& jv = (ret[jss::memory] = Json::objectValue);
+        for (auto const& entry : MemoryUsage::report())
+        {
+            Json::Value& tag = (jv[entry.name] = Json::objectValue);
+            tag[jss::bytes] = std::to_string(entry.bytes);
+            tag[jss::allocations] = std::to_string(entry.allocations);
+        }
+    }
 
     std::string uptime;
     auto s = UptimeClock::now();
@@ -126,6 +186,7 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::node_written_bytes] =
         std::to_string(app.getNodeStore().getStoreSize());
     ret[jss::node_read_bytes] = app.getNodeStore().getFetchSize();
+    ret[jss::traffic] = app.overlay().trafficJson();
 
     if (auto shardStore = app.getShardStore())
     {
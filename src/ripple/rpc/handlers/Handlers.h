@@ -42,6 +42,8 @@ Json::Value
 doAccountTxOld(RPC::JsonContext&);
 Json::Value
 doAccountTxJson(RPC::JsonContext&);
+RPC::Status
+prepareAccountTxJson(RPC::JsonContext&, RPC::Handler::ObjectWriter&);
 Json::Value
 doBookOffers(RPC::JsonContext&);
 Json::Value
@@ -57,10 +59,14 @@ doConnect(RPC::JsonContext&);
 Json::Value
 doConsensusInfo(RPC::JsonContext&);
 Json::Value
+doCpuProfile(RPC::JsonContext&);
+Json::Value
 doDepositAuthorized(RPC::JsonContext&);
 Json::Value
 doDownloadShard(RPC::JsonContext&);
 Json::Value
+doExportShard(RPC::JsonContext&);
+Json::Value
 doFeature(RPC::JsonContext&);
 Json::Value
 doFee(RPC::JsonContext&);
@@ -81,6 +87,8 @@ doLedgerCurrent(RPC::JsonContext&);
 Json::Value
 doLedgerData(RPC::JsonContext&);
 Json::Value
+doLedgerDiff(RPC::JsonContext&);
+Json::Value
 doLedgerEntry(RPC::JsonContext&);
 Json::Value
 doLedgerHeader(RPC::JsonContext&);
@@ -93,6 +101,8 @@ doLogRotate(RPC::JsonContext&);
 Json::Value
 doManifest(RPC::JsonContext&);
 Json::Value
+doNodeStoreTrace(RPC::JsonContext&);
+Json::Value
 doNoRippleCheck(RPC::JsonContext&);
 Json::Value
 doOwnerInfo(RPC::JsonContext&);
@@ -135,6 +145,8 @@ doSubmit(RPC::JsonContext&);
 Json::Value
 doSubmitMultiSigned(RPC::JsonContext&);
 Json::Value
+doSubmitMultiple(RPC::JsonContext&);
+Json::Value
 doSubscribe(RPC::JsonContext&);
 Json::Value
 doTransactionEntry(RPC::JsonContext&);
@@ -17,15 +17,18 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/LedgerFormats.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/Tuning.h>
+#include <optional>
 
 namespace ripple {
 
@@ -33,6 +36,7 @@ namespace ripple {
 //   Inputs:
 //     limit:        integer, maximum number of entries
 //     marker:       opaque, resume point
+//     end_marker:   hex key, last key to return // optional
 //     binary:       boolean, format
 //     type:         string // optional, defaults to all ledger node types
 //   Outputs:
@@ -59,6 +63,17 @@ doLedgerData(RPC::JsonContext& context)
             return RPC::expected_field_error(jss::marker, "valid");
     }
 
+    // The keys are hashes, so clients can split the key space into equal
+    // ranges and fetch each one in parallel, following the markers of each
+    // range until it is done.
+    std::optional<ReadView::key_type> endMarker;
+    if (params.isMember(jss::end_marker))
+    {
+        Json::Value const& jEnd = params[jss::end_marker];
+        if (!jEnd.isString() || !endMarker.emplace().parseHex(jEnd.asString()))
+            return RPC::expected_field_error(jss::end_marker, "valid");
+    }
+
     bool const isBinary = params[jss::binary].asBool();
 
     int limit = -1;
@@ -97,7 +112,12 @@ doLedgerData(RPC::JsonContext& context)
     auto e = lpLedger->sles.end();
     for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
     {
-        auto sle = lpLedger->read(keylet::unchecked((*i)->key()));
+        // The iterator already holds the object, so there is no need to
+        // look it up again from the root of the map.
+        auto const& sle = *i;
+        if (endMarker && sle->key() > *endMarker)
+            break;
+
         if (limit-- <= 0)
         {
             // Stop processing before the current key.
@@ -126,4 +146,87 @@ doLedgerData(RPC::JsonContext& context)
     return jvResult;
 }
 
+grpc::Status
+doLedgerDataGrpc(
+    RPC::GRPCContext<org::xrpl::rpc::v1::GetLedgerDataRequest>& context,
+    std::function<bool(org::xrpl::rpc::v1::GetLedgerDataResponse const&)> const&
+        write)
+{
+    org::xrpl::rpc::v1::GetLedgerDataRequest& request = context.params;
+
+    // A download should read one fixed ledger, so default to a validated one
+    if (!request.has_ledger())
+        request.mutable_ledger()->set_shortcut(
+            org::xrpl::rpc::v1::LedgerSpecifier::SHORTCUT_VALIDATED);
+
+    std::shared_ptr<ReadView const> view;
+    auto lgrStatus = RPC::ledgerFromRequest(view, context);
+    if (lgrStatus || !view)
+    {
+        if (lgrStatus.toErrorCode() == rpcINVALID_PARAMS)
+            return {grpc::StatusCode::INVALID_ARGUMENT, lgrStatus.message()};
+        return {grpc::StatusCode::NOT_FOUND, lgrStatus.message()};
+    }
+
+    // Closed ledgers are walked directly, which avoids building each object
+    auto const ledger = std::dynamic_pointer_cast<Ledger const>(view);
+    if (!ledger)
+        return {grpc::StatusCode::INVALID_ARGUMENT, "ledger is not closed"};
+
+    uint256 marker;
+    if (!request.marker().empty())
+    {
+        if (request.marker().size() != uint256::bytes)
+            return {grpc::StatusCode::INVALID_ARGUMENT, "invalid marker"};
+        marker = uint256::fromVoid(request.marker().data());
+    }
+
+    std::optional<uint256> endMarker;
+    if (!request.end_marker().empty())
+    {
+        if (request.end_marker().size() != uint256::bytes)
+            return {grpc::StatusCode::INVALID_ARGUMENT, "invalid end_marker"};
+        endMarker = uint256::fromVoid(request.end_marker().data());
+    }
+
+    int limit = RPC::Tuning::binaryPageLength;
+    if (request.limit() != 0 && request.limit() < limit)
+        limit = request.limit();
+
+    org::xrpl::rpc::v1::GetLedgerDataResponse response;
+    response.set_ledger_index(ledger->info().seq);
+    response.set_ledger_hash(
+        ledger->info().hash.data(), ledger->info().hash.size());
+
+    // The map is walked once for the whole stream. Each write waits until
+    // the client has taken the previous response.
+    bool sent = false;
+    auto const& stateMap = ledger->stateMap();
+    auto const end = stateMap.end();
+    for (auto it = stateMap.upper_bound(marker); it != end; ++it)
+    {
+        auto const& item = *it;
+        if (endMarker && item.key() > *endMarker)
+            break;
+
+        auto object = response.add_ledger_objects();
+        object->set_key(item.key().data(), item.key().size());
+        object->set_data(item.data(), item.size());
+
+        if (response.ledger_objects_size() == limit)
+        {
+            if (!write(response))
+                return {grpc::StatusCode::CANCELLED, "client went away"};
+            response.clear_ledger_objects();
+            sent = true;
+        }
+    }
+
+    // Always send something, so the client learns which ledger was read
+    if ((response.ledger_objects_size() != 0 || !sent) && !write(response))
+        return {grpc::StatusCode::CANCELLED, "client went away"};
+
+    return grpc::Status::OK;
+}
+
 }  // namespace ripple
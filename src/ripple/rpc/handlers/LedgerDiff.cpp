@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/net/RPCErr.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
+
+namespace ripple {
+
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+// }
+//
+// Returns the keys of the ledger entries which the ledger created,
+// modified and deleted, each sorted.
+Json::Value
+doLedgerDiff(RPC::JsonContext& context)
+{
+    std::shared_ptr<ReadView const> lpLedger;
+    auto jvResult = RPC::lookupLedger(lpLedger, context);
+
+    if (!lpLedger)
+        return jvResult;
+
+    // The open ledger is still changing
+    auto const ledger = std::dynamic_pointer_cast<Ledger const>(lpLedger);
+    if (!ledger)
+        return rpcError(rpcLGR_NOT_VALIDATED);
+
+    auto const delta = getStateDelta(context.app, ledger);
+    if (!delta)
+        return rpcError(rpcLGR_NOT_FOUND);
+
+    auto& created = (jvResult[jss::created] = Json::arrayValue);
+    auto& modified = (jvResult[jss::modified] = Json::arrayValue);
+    auto& deleted = (jvResult[jss::deleted] = Json::arrayValue);
+    for (auto const& [key, change] : *delta)
+    {
+        switch (change)
+        {
+            case StateChange::created:
+                created.append(to_string(key));
+                break;
+            case StateChange::modified:
+                modified.append(to_string(key));
+                break;
+            case StateChange::deleted:
+                deleted.append(to_string(key));
+                break;
+        }
+    }
+
+    return jvResult;
+}
+
+}  // namespace ripple
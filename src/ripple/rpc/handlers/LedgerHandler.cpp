@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
@@ -24,6 +25,7 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/GRPCHandlers.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/handlers/LedgerHandler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
@@ -98,4 +100,80 @@ LedgerHandler::check()
 }
 
 }  // namespace RPC
+
+std::pair<org::xrpl::rpc::v1::GetLedgerResponse, grpc::Status>
+doLedgerGrpc(RPC::GRPCContext<org::xrpl::rpc::v1::GetLedgerRequest>& context)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest& request = context.params;
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    if (!request.has_ledger())
+        request.mutable_ledger()->set_shortcut(
+            org::xrpl::rpc::v1::LedgerSpecifier::SHORTCUT_VALIDATED);
+
+    std::shared_ptr<ReadView const> view;
+    auto lgrStatus = RPC::ledgerFromRequest(view, context);
+    if (lgrStatus || !view)
+    {
+        if (lgrStatus.toErrorCode() == rpcINVALID_PARAMS)
+            return {
+                response,
+                {grpc::StatusCode::INVALID_ARGUMENT, lgrStatus.message()}};
+        return {response, {grpc::StatusCode::NOT_FOUND, lgrStatus.message()}};
+    }
+
+    auto const ledger = std::dynamic_pointer_cast<Ledger const>(view);
+    if (!ledger)
+        return {
+            response,
+            {grpc::StatusCode::INVALID_ARGUMENT, "ledger is not closed"}};
+
+    Serializer header;
+    addRaw(ledger->info(), header);
+    response.set_ledger_header(header.data(), header.size());
+    response.set_ledger_hash(
+        ledger->info().hash.data(), ledger->info().hash.size());
+    response.set_validated(
+        RPC::isValidated(context.ledgerMaster, *ledger, context.app));
+
+    if (request.transactions())
+    {
+        // Each item holds the transaction and its metadata
+        for (auto const& item : ledger->txMap())
+        {
+            SerialIter sit(item.slice());
+            auto const txn = sit.getVL();
+            auto const meta = sit.getVL();
+            auto entry = response.add_transactions();
+            entry->set_transaction_blob(txn.data(), txn.size());
+            entry->set_metadata_blob(meta.data(), meta.size());
+        }
+    }
+
+    if (request.get_objects())
+    {
+        auto const delta = getStateDelta(context.app, ledger);
+        if (!delta)
+            return {
+                response,
+                {grpc::StatusCode::NOT_FOUND, "ledger changes unknown"}};
+
+        for (auto const& [key, change] : *delta)
+        {
+            auto object = response.add_ledger_objects();
+            object->set_key(key.data(), key.size());
+            if (change == StateChange::deleted)
+                continue;
+            auto const& item = ledger->stateMap().peekItem(key);
+            if (!item)
+                return {
+                    response,
+                    {grpc::StatusCode::INTERNAL, "changed object missing"}};
+            object->set_data(item->data(), item->size());
+        }
+    }
+
+    return {response, grpc::Status::OK};
+}
+
 }  // namespace ripple
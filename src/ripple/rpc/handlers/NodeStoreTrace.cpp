@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <ripple/json/json_value.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/Context.h>
+
+namespace ripple {
+
+// {
+//   enabled: <bool>        // optional, starts or stops the trace
+//   sample_rate: <number>  // optional, objects per object traced
+// }
+Json::Value
+doNodeStoreTrace(RPC::JsonContext& context)
+{
+    auto& db = context.app.getNodeStore();
+    auto const& params = context.params;
+
+    if (params.isMember(jss::enabled))
+    {
+        if (!params[jss::enabled].isBool())
+            return RPC::invalid_field_error(jss::enabled);
+
+        if (params[jss::enabled].asBool())
+        {
+            std::uint32_t sampleRate = 100;
+            if (params.isMember(jss::sample_rate))
+            {
+                auto const& rate = params[jss::sample_rate];
+                if (!(rate.isUInt() || rate.isInt()) ||
+                    !rate.isConvertibleTo(Json::uintValue) ||
+                    rate.asUInt() == 0)
+                    return RPC::invalid_field_error(jss::sample_rate);
+                sampleRate = rate.asUInt();
+            }
+
+            try
+            {
+                if (!db.startAccessTrace(sampleRate))
+                    return RPC::make_error(
+                        rpcNOT_ENABLED,
+                        "No access_trace file is configured in [node_db].");
+            }
+            catch (std::exception const& e)
+            {
+                return RPC::make_error(rpcINTERNAL, e.what());
+            }
+        }
+        else
+        {
+            db.stopAccessTrace();
+        }
+    }
+
+    return db.getAccessTraceJson();
+}
+
+}  // namespace ripple
@@ -29,6 +29,8 @@
 #include <ripple/rpc/impl/GRPCHelpers.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/TransactionSign.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <atomic>
 
 namespace ripple {
 
@@ -40,6 +42,171 @@ getFailHard(RPC::JsonContext const& context)
         context.params["fail_hard"].asBool());
 }
 
+static Json::Value
+invalidTransaction(std::string const& exception)
+{
+    Json::Value jvResult;
+    jvResult[jss::error] = "invalidTransaction";
+    jvResult[jss::error_exception] = exception;
+    return jvResult;
+}
+
+// Parses a signed transaction. On failure, says why in `error`.
+static std::shared_ptr<STTx const>
+parseTransaction(Slice blob, std::string& error)
+{
+    SerialIter sitTrans(blob);
+
+    try
+    {
+        return std::make_shared<STTx const>(std::ref(sitTrans));
+    }
+    catch (std::exception& e)
+    {
+        error = e.what();
+    }
+    return {};
+}
+
+// Runs the local checks on a parsed transaction. Returns the transaction
+// to submit, or says why it fails them in `reason`.
+static std::shared_ptr<Transaction>
+prepareTransaction(
+    RPC::Context& context,
+    std::shared_ptr<STTx const> const& stpTrans,
+    std::string& reason)
+{
+    if (!context.app.checkSigs())
+        forceValidity(
+            context.app.getHashRouter(),
+            stpTrans->getTransactionID(),
+            Validity::SigGoodOnly);
+    auto const [validity, why] = checkValidity(
+        context.app.getHashRouter(),
+        *stpTrans,
+        context.ledgerMaster.getCurrentLedger()->rules(),
+        context.app.config());
+    if (validity != Validity::Valid)
+    {
+        reason = why;
+        return {};
+    }
+
+    auto tpTrans = std::make_shared<Transaction>(stpTrans, reason, context.app);
+    if (tpTrans->getStatus() != NEW)
+        return {};
+
+    return tpTrans;
+}
+
+// Checks the signatures of many transactions on several job queue threads
+// while the coroutine waits. The hash router keeps the results, so the
+// checks made as each transaction is prepared find them already done.
+static void
+checkSignatures(
+    RPC::Context& context,
+    std::vector<std::shared_ptr<STTx const>> const& transactions)
+{
+    auto const batch = RPC::Tuning::submitSigCheckBatch;
+    if (!context.coro || !context.app.checkSigs() ||
+        transactions.size() <= batch)
+        return;
+
+    auto& app = context.app;
+    auto const rules = context.ledgerMaster.getCurrentLedger()->rules();
+
+    // One count for each job and one for this coroutine. Whoever takes
+    // the count to zero after the coroutine has dropped its own resumes it.
+    auto const remaining = std::make_shared<std::atomic<std::size_t>>(1);
+    for (std::size_t first = 0; first < transactions.size(); first += batch)
+    {
+        auto const last = std::min(first + batch, transactions.size());
+        ++*remaining;
+        if (!app.getJobQueue().addJob(
+                jtCLIENT,
+                "submitSignatures",
+                [&app, &transactions, rules, first, last, remaining,
+                 coro = context.coro](Job&) {
+                    for (auto i = first; i < last; ++i)
+                    {
+                        if (transactions[i])
+                            checkValidity(
+                                app.getHashRouter(),
+                                *transactions[i],
+                                rules,
+                                app.config());
+                    }
+                    if (--*remaining == 0 && !coro->post())
+                        coro->resume();
+                }))
+        {
+            // The job queue is stopping; the checks will be made inline
+            --*remaining;
+        }
+    }
+
+    if (--*remaining != 0)
+        context.coro->yield();
+}
+
+// The reply for a transaction which was submitted.
+static Json::Value
+submitResult(Transaction& transaction)
+{
+    Json::Value jvResult;
+    try
+    {
+        jvResult[jss::tx_json] = transaction.getJson(JsonOptions::none);
+        jvResult[jss::tx_blob] =
+            strHex(transaction.getSTransaction()->getSerializer().peekData());
+
+        if (temUNCERTAIN != transaction.getResult())
+        {
+            std::string sToken;
+            std::string sHuman;
+
+            transResultInfo(transaction.getResult(), sToken, sHuman);
+
+            jvResult[jss::engine_result] = sToken;
+            jvResult[jss::engine_result_code] = transaction.getResult();
+            jvResult[jss::engine_result_message] = sHuman;
+
+            auto const submitResult = transaction.getSubmitResult();
+
+            jvResult[jss::accepted] = submitResult.any();
+            jvResult[jss::applied] = submitResult.applied;
+            jvResult[jss::broadcast] = submitResult.broadcast;
+            jvResult[jss::queued] = submitResult.queued;
+            jvResult[jss::kept] = submitResult.kept;
+
+            if (auto currentLedgerState = transaction.getCurrentLedgerState())
+            {
+                jvResult[jss::account_sequence_next] =
+                    safe_cast<Json::Value::UInt>(
+                        currentLedgerState->accountSeqNext);
+                jvResult[jss::account_sequence_available] =
+                    safe_cast<Json::Value::UInt>(
+                        currentLedgerState->accountSeqAvail);
+                jvResult[jss::open_ledger_cost] =
+                    to_string(currentLedgerState->minFeeRequired);
+                jvResult[jss::validated_ledger_index] =
+                    safe_cast<Json::Value::UInt>(
+                        currentLedgerState->validatedLedger);
+            }
+        }
+
+        return jvResult;
+    }
+    catch (std::exception& e)
+    {
+        jvResult = Json::Value();
+        jvResult[jss::error] = "internalJson";
+        jvResult[jss::error_exception] = e.what();
+
+        return jvResult;
+    }
+}
+
 // {
 //   tx_json: <object>,
 //   secret: <secret>
@@ -74,58 +241,21 @@ doSubmit(RPC::JsonContext& context)
         return ret;
     }
 
-    Json::Value jvResult;
-
     auto ret = strUnHex(context.params[jss::tx_blob].asString());
 
     if (!ret || !ret->size())
         return rpcError(rpcINVALID_PARAMS);
 
-    SerialIter sitTrans(makeSlice(*ret));
-
-    std::shared_ptr<STTx const> stpTrans;
-
-    try
-    {
-        stpTrans = std::make_shared<STTx const>(std::ref(sitTrans));
-    }
-    catch (std::exception& e)
-    {
-        jvResult[jss::error] = "invalidTransaction";
-        jvResult[jss::error_exception] = e.what();
-
-        return jvResult;
-    }
-
-    {
-        if (!context.app.checkSigs())
-            forceValidity(
-                context.app.getHashRouter(),
-                stpTrans->getTransactionID(),
-                Validity::SigGoodOnly);
-        auto [validity, reason] = checkValidity(
-            context.app.getHashRouter(),
-            *stpTrans,
-            context.ledgerMaster.getCurrentLedger()->rules(),
-            context.app.config());
-        if (validity != Validity::Valid)
-        {
-            jvResult[jss::error] = "invalidTransaction";
-            jvResult[jss::error_exception] = "fails local checks: " + reason;
-
-            return jvResult;
-        }
-    }
-
     std::string reason;
-    auto tpTrans = std::make_shared<Transaction>(stpTrans, reason, context.app);
-    if (tpTrans->getStatus() != NEW)
-    {
-        jvResult[jss::error] = "invalidTransaction";
-        jvResult[jss::error_exception] = "fails local checks: " + reason;
+    auto const stpTrans = parseTransaction(makeSlice(*ret), reason);
+    if (!stpTrans)
+        return invalidTransaction(reason);
 
-        return jvResult;
-    }
+    auto tpTrans = prepareTransaction(context, stpTrans, reason);
+    if (!tpTrans)
+        return invalidTransaction("fails local checks: " + reason);
+
+    Json::Value jvResult;
 
     try
     {
@@ -142,56 +272,81 @@ doSubmit(RPC::JsonContext& context)
         return jvResult;
     }
 
-    try
-    {
-        jvResult[jss::tx_json] = tpTrans->getJson(JsonOptions::none);
-        jvResult[jss::tx_blob] =
-            strHex(tpTrans->getSTransaction()->getSerializer().peekData());
+    return submitResult(*tpTrans);
+}
 
-        if (temUNCERTAIN != tpTrans->getResult())
-        {
-            std::string sToken;
-            std::string sHuman;
+// {
+//   tx_blobs: [<hex>, ...],
+//   fail_hard: <bool>
+// }
+Json::Value
+doSubmitMultiple(RPC::JsonContext& context)
+{
+    context.loadType = Resource::feeHighBurdenRPC;
 
-            transResultInfo(tpTrans->getResult(), sToken, sHuman);
+    auto const& blobs = context.params[jss::tx_blobs];
+    if (!blobs.isArray())
+        return RPC::missing_field_error(jss::tx_blobs);
+    if (blobs.size() == 0 || blobs.size() > RPC::Tuning::maxSubmitMultiple)
+        return RPC::invalid_field_error(jss::tx_blobs);
 
-            jvResult[jss::engine_result] = sToken;
-            jvResult[jss::engine_result_code] = tpTrans->getResult();
-            jvResult[jss::engine_result_message] = sHuman;
+    std::vector<Json::Value> results(blobs.size());
+    std::vector<std::shared_ptr<STTx const>> parsed(blobs.size());
+    for (Json::UInt i = 0; i < blobs.size(); ++i)
+    {
+        auto const blob =
+            blobs[i].isString() ? strUnHex(blobs[i].asString()) : boost::none;
+        if (!blob || blob->empty())
+            return RPC::invalid_field_error(jss::tx_blobs);
+        std::string error;
+        parsed[i] = parseTransaction(makeSlice(*blob), error);
+        if (!parsed[i])
+            results[i] = invalidTransaction(error);
+    }
 
-            auto const submitResult = tpTrans->getSubmitResult();
+    checkSignatures(context, parsed);
 
-            jvResult[jss::accepted] = submitResult.any();
-            jvResult[jss::applied] = submitResult.applied;
-            jvResult[jss::broadcast] = submitResult.broadcast;
-            jvResult[jss::queued] = submitResult.queued;
-            jvResult[jss::kept] = submitResult.kept;
+    std::vector<std::shared_ptr<Transaction>> transactions;
+    std::vector<Json::UInt> positions;
+    for (Json::UInt i = 0; i < blobs.size(); ++i)
+    {
+        if (!parsed[i])
+            continue;
 
-            if (auto currentLedgerState = tpTrans->getCurrentLedgerState())
-            {
-                jvResult[jss::account_sequence_next] =
-                    safe_cast<Json::Value::UInt>(
-                        currentLedgerState->accountSeqNext);
-                jvResult[jss::account_sequence_available] =
-                    safe_cast<Json::Value::UInt>(
-                        currentLedgerState->accountSeqAvail);
-                jvResult[jss::open_ledger_cost] =
-                    to_string(currentLedgerState->minFeeRequired);
-                jvResult[jss::validated_ledger_index] =
-                    safe_cast<Json::Value::UInt>(
-                        currentLedgerState->validatedLedger);
-            }
+        std::string reason;
+        if (auto tpTrans = prepareTransaction(context, parsed[i], reason))
+        {
+            transactions.push_back(std::move(tpTrans));
+            positions.push_back(i);
+        }
+        else
+        {
+            results[i] = invalidTransaction("fails local checks: " + reason);
         }
+    }
 
-        return jvResult;
+    try
+    {
+        context.netOps.processTransactionSet(
+            transactions, isUnlimited(context.role), getFailHard(context));
     }
     catch (std::exception& e)
     {
-        jvResult[jss::error] = "internalJson";
+        Json::Value jvResult;
+        jvResult[jss::error] = "internalSubmit";
         jvResult[jss::error_exception] = e.what();
 
         return jvResult;
     }
+
+    for (std::size_t i = 0; i < transactions.size(); ++i)
+        results[positions[i]] = submitResult(*transactions[i]);
+
+    Json::Value jvResult;
+    auto& jvResults = jvResult[jss::results] = Json::arrayValue;
+    for (auto& result : results)
+        jvResults.append(std::move(result));
+    return jvResult;
 }
 
 std::pair<org::xrpl::rpc::v1::SubmitTransactionResponse, grpc::Status>
@@ -292,4 +447,93 @@ doSubmitGrpc(
     return {result, status};
 }
 
+std::pair<org::xrpl::rpc::v1::SubmitTransactionsResponse, grpc::Status>
+doSubmitMultipleGrpc(
+    RPC::GRPCContext<org::xrpl::rpc::v1::SubmitTransactionsRequest>& context)
+{
+    org::xrpl::rpc::v1::SubmitTransactionsResponse result;
+    auto const& request = context.params;
+    auto const count =
+        static_cast<std::size_t>(request.signed_transactions_size());
+
+    if (count == 0 || count > RPC::Tuning::maxSubmitMultiple)
+    {
+        grpc::Status errorStatus{
+            grpc::StatusCode::INVALID_ARGUMENT,
+            "invalid number of transactions"};
+        return {result, errorStatus};
+    }
+
+    std::vector<std::shared_ptr<STTx const>> parsed(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto const& tx = request.signed_transactions(i);
+        auto& item = *result.add_results();
+        std::string error;
+        parsed[i] = parseTransaction(makeSlice(tx), error);
+        if (!parsed[i])
+            item.set_error("invalid transaction: " + error);
+    }
+
+    checkSignatures(context, parsed);
+
+    std::vector<std::shared_ptr<Transaction>> transactions;
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!parsed[i])
+            continue;
+
+        std::string reason;
+        if (auto tpTrans = prepareTransaction(context, parsed[i], reason))
+        {
+            transactions.push_back(std::move(tpTrans));
+            positions.push_back(i);
+        }
+        else
+        {
+            result.mutable_results(i)->set_error(
+                "invalid transaction: " + reason);
+        }
+    }
+
+    try
+    {
+        context.netOps.processTransactionSet(
+            transactions,
+            isUnlimited(context.role),
+            NetworkOPs::doFailHard(request.fail_hard()));
+    }
+    catch (std::exception& e)
+    {
+        grpc::Status errorStatus{
+            grpc::StatusCode::INTERNAL,
+            "submit failed: " + std::string(e.what())};
+        return {result, errorStatus};
+    }
+
+    for (std::size_t i = 0; i < transactions.size(); ++i)
+    {
+        auto& tpTrans = transactions[i];
+        auto& item = *result.mutable_results(positions[i]);
+        uint256 const hash = tpTrans->getID();
+        item.set_hash(hash.data(), hash.size());
+
+        if (temUNCERTAIN != tpTrans->getResult())
+        {
+            RPC::convert(*item.mutable_engine_result(), tpTrans->getResult());
+
+            std::string sToken;
+            std::string sHuman;
+
+            transResultInfo(tpTrans->getResult(), sToken, sHuman);
+
+            item.mutable_engine_result()->set_result(sToken);
+            item.set_engine_result_code(TERtoInt(tpTrans->getResult()));
+            item.set_engine_result_message(sHuman);
+        }
+    }
+    return {result, grpc::Status::OK};
+}
+
 }  // namespace ripple
@@ -131,7 +131,11 @@ doTxHelp(RPC::Context& context, TxArgs const& args)
 
     if (ledger && meta)
     {
-        result.meta = meta;
+        // Binary callers get the metadata as stored, not as JSON
+        if (args.binary)
+            result.meta = meta->getAsObject().getSerializer().getData();
+        else
+            result.meta = meta;
         result.validated = isValidated(
             context.ledgerMaster, ledger->info().seq, ledger->info().hash);
     }
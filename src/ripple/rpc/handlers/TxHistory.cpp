@@ -59,7 +59,7 @@ doTxHistory(RPC::JsonContext& context)
         startIndex);
 
     {
-        auto db = context.app.getTxnDB().checkoutDb();
+        auto db = context.app.getTxnDB().checkoutReadDb();
 
         boost::optional<std::uint64_t> ledgerSeq;
         boost::optional<std::string> status;
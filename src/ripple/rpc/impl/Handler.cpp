@@ -57,6 +57,22 @@ handle(JsonContext& context, Object& object)
     return status;
 };
 
+template <class HandlerImpl>
+Status
+prepare(JsonContext& context, Handler::ObjectWriter& writer)
+{
+    auto handler = std::make_shared<HandlerImpl>(context);
+
+    auto status = handler->check();
+    if (!status)
+    {
+        writer = [handler](Json::Object& object) {
+            handler->writeResult(object);
+        };
+    }
+    return status;
+}
+
 Handler const handlerArray[]{
     // Some handlers not specified here are added to the table via addHandler()
     // Request-response methods
@@ -69,7 +85,11 @@ Handler const handlerArray[]{
     {"account_channels", byRef(&doAccountChannels), Role::USER, NO_CONDITION},
     {"account_objects", byRef(&doAccountObjects), Role::USER, NO_CONDITION},
     {"account_offers", byRef(&doAccountOffers), Role::USER, NO_CONDITION},
-    {"account_tx", byRef(&doAccountTxJson), Role::USER, NO_CONDITION},
+    {"account_tx",
+     byRef(&doAccountTxJson),
+     Role::USER,
+     NO_CONDITION,
+     &prepareAccountTxJson},
     {"blacklist", byRef(&doBlackList), Role::ADMIN, NO_CONDITION},
     {"book_offers", byRef(&doBookOffers), Role::USER, NO_CONDITION},
     {"can_delete", byRef(&doCanDelete), Role::ADMIN, NO_CONDITION},
@@ -77,11 +97,13 @@ Handler const handlerArray[]{
     {"channel_verify", byRef(&doChannelVerify), Role::USER, NO_CONDITION},
     {"connect", byRef(&doConnect), Role::ADMIN, NO_CONDITION},
     {"consensus_info", byRef(&doConsensusInfo), Role::ADMIN, NO_CONDITION},
+    {"cpu_profile", byRef(&doCpuProfile), Role::ADMIN, NO_CONDITION},
     {"deposit_authorized",
      byRef(&doDepositAuthorized),
      Role::USER,
      NO_CONDITION},
     {"download_shard", byRef(&doDownloadShard), Role::ADMIN, NO_CONDITION},
+    {"export_shard", byRef(&doExportShard), Role::ADMIN, NO_CONDITION},
     {"gateway_balances", byRef(&doGatewayBalances), Role::USER, NO_CONDITION},
     {"get_counts", byRef(&doGetCounts), Role::ADMIN, NO_CONDITION},
     {"feature", byRef(&doFeature), Role::ADMIN, NO_CONDITION},
@@ -101,12 +123,14 @@ Handler const handlerArray[]{
      Role::USER,
      NEEDS_CURRENT_LEDGER},
     {"ledger_data", byRef(&doLedgerData), Role::USER, NO_CONDITION},
+    {"ledger_diff", byRef(&doLedgerDiff), Role::USER, NO_CONDITION},
     {"ledger_entry", byRef(&doLedgerEntry), Role::USER, NO_CONDITION},
     {"ledger_header", byRef(&doLedgerHeader), Role::USER, NO_CONDITION},
     {"ledger_request", byRef(&doLedgerRequest), Role::ADMIN, NO_CONDITION},
     {"log_level", byRef(&doLogLevel), Role::ADMIN, NO_CONDITION},
     {"logrotate", byRef(&doLogRotate), Role::ADMIN, NO_CONDITION},
     {"manifest", byRef(&doManifest), Role::USER, NO_CONDITION},
+    {"node_store_trace", byRef(&doNodeStoreTrace), Role::ADMIN, NO_CONDITION},
     {"noripple_check", byRef(&doNoRippleCheck), Role::USER, NO_CONDITION},
     {"owner_info", byRef(&doOwnerInfo), Role::USER, NEEDS_CURRENT_LEDGER},
     {"peers", byRef(&doPeers), Role::ADMIN, NO_CONDITION},
@@ -136,6 +160,10 @@ Handler const handlerArray[]{
      byRef(&doSubmitMultiSigned),
      Role::USER,
      NEEDS_CURRENT_LEDGER},
+    {"submit_multiple",
+     byRef(&doSubmitMultiple),
+     Role::USER,
+     NEEDS_CURRENT_LEDGER},
     {"server_info", byRef(&doServerInfo), Role::USER, NO_CONDITION},
     {"server_state", byRef(&doServerState), Role::USER, NO_CONDITION},
     {"crawl_shards", byRef(&doCrawlShards), Role::ADMIN, NO_CONDITION},
@@ -238,6 +266,7 @@ private:
         h.valueMethod_ = &handle<Json::Value, HandlerImpl>;
         h.role_ = HandlerImpl::role();
         h.condition_ = HandlerImpl::condition();
+        h.objectMethod_ = &prepare<HandlerImpl>;
 
         innerTable[HandlerImpl::name()] = h;
     }
@@ -48,10 +48,18 @@ struct Handler
     template <class JsonValue>
     using Method = std::function<Status(JsonContext&, JsonValue&)>;
 
+    /** Writes a result into an object a piece at a time. */
+    using ObjectWriter = std::function<void(Json::Object&)>;
+
     const char* name_;
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+
+    /** Checks a request and, if it is valid, sets a writer for its result.
+        Only handlers which can stream their result have one.
+    */
+    Method<ObjectWriter> objectMethod_ = {};
 };
 
 Handler const*
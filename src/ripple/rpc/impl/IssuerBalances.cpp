@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/RippleState.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/ledger/View.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/rpc/IssuerBalances.h>
+
+namespace ripple {
+namespace RPC {
+
+IssuerBalances::IssuerBalances(std::size_t maxIssuers) : maxIssuers_(maxIssuers)
+{
+}
+
+void
+IssuerBalances::tally(
+    Totals& totals,
+    AccountID const& issuer,
+    std::shared_ptr<SLE const> const& sle,
+    bool add)
+{
+    auto const rs = RippleState::makeItem(issuer, sle);
+    if (!rs || rs->getAccountID() != issuer)
+        return;
+
+    auto const& balance = rs->getBalance();
+    if (balance.signum() == 0)
+        return;
+
+    // A negative balance is owed by the issuer
+    if (balance.signum() < 0 && !rs->getFreeze())
+    {
+        auto const currency = balance.getCurrency();
+        auto& [sum, count] = totals.obligations[currency];
+        if (add)
+        {
+            // Assigning the first amount sets the currency of the sum
+            if (count++ == 0)
+                sum = -balance;
+            else
+                sum -= balance;
+        }
+        else if (--count == 0)
+            totals.obligations.erase(currency);
+        else
+            sum += balance;
+    }
+    else if (add)
+        totals.others[sle->key()] = {rs->getAccountIDPeer(), balance};
+    else
+        totals.others.erase(sle->key());
+}
+
+std::shared_ptr<IssuerBalances::Totals const>
+IssuerBalances::walk(ReadView const& ledger, AccountID const& issuer)
+{
+    auto totals = std::make_shared<Totals>();
+    forEachItem(ledger, issuer, [&](std::shared_ptr<SLE const> const& sle) {
+        tally(*totals, issuer, sle, true);
+    });
+    return totals;
+}
+
+std::shared_ptr<IssuerBalances::Totals const>
+IssuerBalances::advance(
+    Entry const& entry,
+    ReadView const& ledger,
+    AccountID const& issuer)
+{
+    hash_set<uint256> keys;
+    for (auto const& [tx, meta] : ledger.txs)
+    {
+        (void)tx;
+        if (!meta)
+            return {};
+        for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+        {
+            if (node.getFieldU16(sfLedgerEntryType) == ltRIPPLE_STATE)
+                keys.insert(node.getFieldH256(sfLedgerIndex));
+        }
+    }
+
+    auto totals = std::make_shared<Totals>(*entry.totals);
+    for (auto const& key : keys)
+    {
+        if (auto const sle = entry.ledger->read(keylet::unchecked(key)))
+            tally(*totals, issuer, sle, false);
+        if (auto const sle = ledger.read(keylet::unchecked(key)))
+            tally(*totals, issuer, sle, true);
+    }
+    return totals;
+}
+
+auto
+IssuerBalances::get(
+    std::shared_ptr<ReadView const> const& ledger,
+    AccountID const& issuer) -> std::shared_ptr<Totals const>
+{
+    // The open ledger changes without its sequence changing
+    if (ledger->open() || maxIssuers_ == 0)
+        return walk(*ledger, issuer);
+
+    auto const& info = ledger->info();
+    Entry entry;
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = entries_.find(issuer); it != entries_.end())
+            entry = it->second;
+    }
+
+    std::shared_ptr<Totals const> totals;
+    std::uint32_t updates = 0;
+    if (entry.ledger)
+    {
+        auto const& prev = entry.ledger->info();
+        if (prev.hash == info.hash)
+            return entry.totals;
+
+        if (info.seq == prev.seq + 1 && info.parentHash == prev.hash &&
+            entry.updates < maxUpdates)
+        {
+            totals = advance(entry, *ledger, issuer);
+            updates = entry.updates + 1;
+        }
+    }
+    if (!totals)
+        totals = walk(*ledger, issuer);
+
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(issuer);
+    if (it == entries_.end())
+    {
+        // Make room by forgetting an issuer. Which one doesn't matter
+        // much, as an issuer asked about often is soon added again.
+        if (entries_.size() >= maxIssuers_)
+            entries_.erase(entries_.begin());
+        it = entries_.emplace(issuer, Entry{}).first;
+    }
+    else if (it->second.ledger && it->second.ledger->info().seq > info.seq)
+    {
+        // Keep the totals of the newer ledger
+        return totals;
+    }
+    it->second = {ledger, totals, updates};
+    return totals;
+}
+
+}  // namespace RPC
+}  // namespace ripple
@@ -38,7 +38,8 @@ LegacyPathFind::LegacyPathFind(bool isAdmin, Application& app) : m_isOk(false)
 
     auto const& jobCount = app.getJobQueue().getJobCountGE(jtCLIENT);
     if (jobCount > Tuning::maxPathfindJobCount ||
-        app.getFeeTrack().isLoadedLocal())
+        app.getFeeTrack().isLoadedLocal() ||
+        app.getJobQueue().isBehind(jtCLIENT))
         return;
 
     while (true)
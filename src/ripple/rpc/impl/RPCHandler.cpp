@@ -32,11 +32,13 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/RPCHandler.h>
+#include <ripple/rpc/ResponseCache.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <atomic>
 #include <chrono>
+#include <unordered_set>
 
 namespace ripple {
 namespace RPC {
@@ -136,6 +138,12 @@ fillHandler(JsonContext& context, Handler const*& result)
             JLOG(context.j.debug()) << "Too busy for command: " << jc;
             return rpcTOO_BUSY;
         }
+
+        if (context.app.getJobQueue().isBehind(jtCLIENT))
+        {
+            JLOG(context.j.debug()) << "Too busy for command: running late";
+            return rpcTOO_BUSY;
+        }
     }
 
     if (!context.params.isMember(jss::command) &&
@@ -207,6 +215,75 @@ callMethod(
     }
 }
 
+// Whether the result of a request only depends on its parameters and the
+// validated ledger, so that it may be answered from the ResponseCache.
+bool
+isCacheable(JsonContext const& context, std::string const& name)
+{
+    static std::unordered_set<std::string> const methods{
+        "account_currencies",
+        "account_info",
+        "account_lines",
+        "account_objects",
+        "account_offers",
+        "book_offers",
+        "ledger_entry"};
+
+    auto const& params = context.params;
+    return methods.count(name) && !params.isMember(jss::ledger_hash) &&
+        params.isMember(jss::ledger_index) &&
+        params[jss::ledger_index] == "validated";
+}
+
+// The parameters which affect the result of a request, in a canonical form.
+std::string
+cacheKey(JsonContext const& context, std::string const& name)
+{
+    Json::Value params = context.params;
+    for (auto const field :
+         {jss::api_version,
+          jss::command,
+          jss::id,
+          jss::jsonrpc,
+          jss::method,
+          jss::ripplerpc})
+        params.removeMember(field.c_str());
+
+    // Members of a Json::Value are kept sorted, so equal parameters are
+    // written the same way whatever order the client sent them in.
+    return name + ' ' + std::to_string(context.apiVersion) +
+        (isUnlimited(context.role) ? " unlimited " : " ") + to_string(params);
+}
+
+Status
+callValueMethod(
+    JsonContext& context,
+    Handler const& handler,
+    Json::Value& result)
+{
+    auto const method = handler.valueMethod_;
+    if (!context.headers.user.empty() || !context.headers.forwardedFor.empty())
+    {
+        JLOG(context.j.debug())
+            << "start command: " << handler.name_
+            << ", user: " << context.headers.user
+            << ", forwarded for: " << context.headers.forwardedFor;
+
+        auto ret = callMethod(context, method, handler.name_, result);
+
+        JLOG(context.j.debug())
+            << "finish command: " << handler.name_
+            << ", user: " << context.headers.user
+            << ", forwarded for: " << context.headers.forwardedFor;
+
+        return ret;
+    }
+    else
+    {
+        return callMethod(context, method, handler.name_, result);
+    }
+}
+
 }  // namespace
 
 Status
@@ -219,32 +296,68 @@ doCommand(RPC::JsonContext& context, Json::Value& result)
         return error;
     }
 
-    if (auto method = handler->valueMethod_)
+    if (!handler->valueMethod_)
+        return rpcUNKNOWN_COMMAND;
+
+    auto& cache = context.app.getResponseCache();
+    if (!cache.enabled() || !isCacheable(context, handler->name_))
+        return callValueMethod(context, *handler, result);
+
+    auto const validated = context.ledgerMaster.getValidatedLedger();
+    if (!validated)
+        return callValueMethod(context, *handler, result);
+
+    auto const& hash = validated->info().hash;
+    auto key = cacheKey(context, handler->name_);
+    if (auto const cached = cache.fetch(hash, key))
     {
-        if (!context.headers.user.empty() ||
-            !context.headers.forwardedFor.empty())
-        {
-            JLOG(context.j.debug())
-                << "start command: " << handler->name_
-                << ", user: " << context.headers.user
-                << ", forwarded for: " << context.headers.forwardedFor;
+        result = *cached;
+        return rpcSUCCESS;
+    }
 
-            auto ret = callMethod(context, method, handler->name_, result);
+    auto const ret = callValueMethod(context, *handler, result);
 
-            JLOG(context.j.debug())
-                << "finish command: " << handler->name_
-                << ", user: " << context.headers.user
-                << ", forwarded for: " << context.headers.forwardedFor;
+    // The validated ledger may have changed before the command looked it
+    // up, so only keep results which were read from the expected ledger.
+    if (!ret && !result.isMember(jss::error) &&
+        result.isMember(jss::ledger_hash) &&
+        result[jss::ledger_hash] == to_string(hash))
+    {
+        cache.insert(hash, std::move(key), result);
+    }
+    return ret;
+}
 
-            return ret;
-        }
-        else
-        {
-            return callMethod(context, method, handler->name_, result);
-        }
+std::function<Status(Json::Object&)>
+prepareCommand(RPC::JsonContext& context)
+{
+    Handler const* handler = nullptr;
+    if (fillHandler(context, handler) || !handler->objectMethod_)
+        return {};
+
+    Handler::ObjectWriter writer;
+    try
+    {
+        if (handler->objectMethod_(context, writer))
+            return {};
+    }
+    catch (std::exception const&)
+    {
+        // doCommand reports the error
+        return {};
     }
 
-    return rpcUNKNOWN_COMMAND;
+    return [&context, name = handler->name_, writer = std::move(writer)](
+               Json::Object& result) {
+        return callMethod(
+            context,
+            [&writer](JsonContext&, Json::Object& object) {
+                writer(object);
+                return Status();
+            },
+            name,
+            result);
+    };
 }
 
 Role
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/ledger/View.h>
@@ -27,6 +28,7 @@
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/DeliveredAmount.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/shamap/HistoryFamily.h>
 #include <boost/algorithm/string/case_conv.hpp>
 
 #include <ripple/rpc/impl/GRPCHelpers.h>
@@ -96,7 +98,8 @@ getAccountObjects(
     uint256 dirIndex,
     uint256 const& entryIndex,
     std::uint32_t const limit,
-    Json::Value& jvResult)
+    Json::Value& jvResult,
+    bool binary)
 {
     auto const root = keylet::ownerDir(account);
     auto found = false;
@@ -142,7 +145,14 @@ getAccountObjects(
             if (!typeFilter.has_value() ||
                 typeMatchesFilter(typeFilter.value(), sleNode->getType()))
             {
-                jvObjects.append(sleNode->getJson(JsonOptions::none));
+                if (binary)
+                {
+                    Json::Value& entry = jvObjects.append(Json::objectValue);
+                    entry[jss::data] = serializeHex(*sleNode);
+                    entry[jss::index] = to_string(sleNode->key());
+                }
+                else
+                    jvObjects.append(sleNode->getJson(JsonOptions::none));
 
                 if (++i == limit)
                 {
@@ -245,15 +255,13 @@ ledgerFromRequest(T& ledger, JsonContext& context)
 }
 }  // namespace
 
-template <class T>
+template <class T, class R>
 Status
-ledgerFromRequest(
-    T& ledger,
-    GRPCContext<org::xrpl::rpc::v1::GetAccountInfoRequest>& context)
+ledgerFromRequest(T& ledger, GRPCContext<R>& context)
 {
     ledger.reset();
 
-    org::xrpl::rpc::v1::GetAccountInfoRequest& request = context.params;
+    R& request = context.params;
 
     using LedgerCase = org::xrpl::rpc::v1::LedgerSpecifier::LedgerCase;
     LedgerCase ledgerCase = request.ledger().ledger_case();
@@ -297,12 +305,22 @@ ledgerFromRequest(
     return Status::OK;
 }
 
-// explicit instantiation of above function
+// explicit instantiations of above function
 template Status
 ledgerFromRequest<>(
     std::shared_ptr<ReadView const>&,
     GRPCContext<org::xrpl::rpc::v1::GetAccountInfoRequest>&);
 
+template Status
+ledgerFromRequest<>(
+    std::shared_ptr<ReadView const>&,
+    GRPCContext<org::xrpl::rpc::v1::GetLedgerDataRequest>&);
+
+template Status
+ledgerFromRequest<>(
+    std::shared_ptr<ReadView const>&,
+    GRPCContext<org::xrpl::rpc::v1::GetLedgerRequest>&);
+
 Status
 getLedger(
     std::shared_ptr<ReadView const>& ledger,
@@ -329,6 +347,14 @@ getLedger(T& ledger, uint32_t ledgerIndex, Context& context)
         }
     }
 
+    if (ledger == nullptr &&
+        ledgerIndex < context.ledgerMaster.getValidLedgerIndex())
+    {
+        // The ledger may be older than the ones kept
+        if (auto const history = context.app.getHistoryFamily())
+            ledger = history->getLedger(ledgerIndex);
+    }
+
     if (ledger == nullptr)
         return {rpcLGR_NOT_FOUND, "ledgerNotFound"};
 
@@ -79,6 +79,7 @@ accountFromStringWithCode(
     @param entryIndex Begin gathering objects from this directory node.
     @param limit Maximum number of objects to find.
     @param jvResult A JSON result that holds the request objects.
+    @param binary Return each object serialized, as hex, with its index.
 */
 bool
 getAccountObjects(
@@ -88,7 +89,8 @@ getAccountObjects(
     uint256 dirIndex,
     uint256 const& entryIndex,
     std::uint32_t const limit,
-    Json::Value& jvResult);
+    Json::Value& jvResult,
+    bool binary = false);
 
 /** Get ledger by hash
     If there is no error in the return value, the ledger pointer will have
@@ -137,11 +139,9 @@ lookupLedger(
     JsonContext&,
     Json::Value& result);
 
-template <class T>
+template <class T, class R>
 Status
-ledgerFromRequest(
-    T& ledger,
-    GRPCContext<org::xrpl::rpc::v1::GetAccountInfoRequest>& context);
+ledgerFromRequest(T& ledger, GRPCContext<R>& context);
 
 bool
 isValidated(
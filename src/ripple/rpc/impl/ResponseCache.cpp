@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/ResponseCache.h>
+
+namespace ripple {
+namespace RPC {
+
+ResponseCache::ResponseCache(std::size_t maxSize) : maxSize_(maxSize)
+{
+}
+
+void
+ResponseCache::advance(uint256 const& ledger)
+{
+    if (ledger == ledger_)
+        return;
+    ledger_ = ledger;
+    entries_.clear();
+}
+
+std::shared_ptr<Json::Value const>
+ResponseCache::fetch(uint256 const& ledger, std::string const& key)
+{
+    std::lock_guard lock(mutex_);
+    advance(ledger);
+    auto const it = entries_.find(key);
+    if (it == entries_.end())
+        return {};
+    ++hits_;
+    return it->second;
+}
+
+void
+ResponseCache::insert(
+    uint256 const& ledger,
+    std::string key,
+    Json::Value const& result)
+{
+    auto copy = std::make_shared<Json::Value const>(result);
+    std::lock_guard lock(mutex_);
+    if (ledger != ledger_ || entries_.size() >= maxSize_)
+        return;
+    entries_.emplace(std::move(key), std::move(copy));
+}
+
+std::size_t
+ResponseCache::size() const
+{
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+std::uint64_t
+ResponseCache::hits() const
+{
+    std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+}  // namespace RPC
+}  // namespace ripple
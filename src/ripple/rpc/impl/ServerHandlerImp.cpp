@@ -18,14 +18,17 @@
 //==============================================================================
 
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/base64.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/make_SSLContext.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/beast/rfc2616.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
 #include <ripple/net/RPCErr.h>
@@ -37,6 +40,7 @@
 #include <ripple/rpc/ServerHandler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/ServerHandlerImp.h>
+#include <ripple/rpc/impl/StreamedReply.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/json_body.h>
 #include <ripple/server/Server.h>
@@ -105,6 +109,7 @@ ServerHandlerImp::ServerHandlerImp(
     Application& app,
     Stoppable& parent,
     boost::asio::io_service& io_service,
+    boost::asio::io_service& peer_io_service,
     JobQueue& jobQueue,
     NetworkOPs& networkOPs,
     Resource::Manager& resourceManager,
@@ -114,13 +119,18 @@ ServerHandlerImp::ServerHandlerImp(
     , m_resourceManager(resourceManager)
     , m_journal(app_.journal("Server"))
     , m_networkOPs(networkOPs)
-    , m_server(make_Server(*this, io_service, app_.journal("Server")))
+    , m_server(make_Server(
+          *this,
+          io_service,
+          peer_io_service,
+          app_.journal("Server")))
     , m_jobQueue(jobQueue)
 {
     auto const& group(cm.group("rpc"));
     rpc_requests_ = group->make_counter("requests");
     rpc_size_ = group->make_event("size");
     rpc_time_ = group->make_event("time");
+    rpc_latency_ = group->make_histogram("latency");
 }
 
 ServerHandlerImp::~ServerHandlerImp()
@@ -161,9 +171,45 @@ ServerHandlerImp::onAccept(
         return false;
     }
 
+    // Turn clients away before anything is spent on them. Peers are
+    // admitted by the overlay, which applies its own limits.
+    if (session.port().protocol.count("peer") == 0 &&
+        tooBusy(
+            session.port(), beast::IPAddressConversion::from_asio(endpoint)))
+    {
+        JLOG(m_journal.trace())
+            << session.port().name << " is busy; dropping " << endpoint;
+        return false;
+    }
+
     return true;
 }
 
+bool
+ServerHandlerImp::tooBusy(
+    Port const& port,
+    beast::IP::Endpoint const& remote)
+{
+    // Administrators must be able to reach a struggling server
+    if (ipAllowed(remote.address(), port.admin_ip))
+        return false;
+
+    auto const jobs = m_jobQueue.getJobCountGE(jtCLIENT);
+    if (jobs > RPC::Tuning::maxJobQueueClients || m_jobQueue.isBehind(jtCLIENT))
+        return true;
+    if (app_.getFeeTrack().isLoadedLocal() &&
+        jobs > RPC::Tuning::maxJobQueueClients / 2)
+        return true;
+
+    // A secure gateway speaks for many clients, which are charged one by
+    // one once their requests are read.
+    if (ipAllowed(remote.address(), port.secure_gateway_ip))
+        return false;
+
+    return m_resourceManager.newInboundEndpoint(remote).disposition() ==
+        Resource::drop;
+}
+
 Handoff
 ServerHandlerImp::onHandoff(
     Session& session,
@@ -218,8 +264,16 @@ ServerHandlerImp::onHandoff(
     }
 
     if (bundle && p.count("peer") > 0)
+    {
+        // A reporting server has no peers
+        if (app_.config().reporting() &&
+            request.find(http::field::upgrade) != request.end())
+            return statusRequestResponse(
+                request, http::status::service_unavailable);
+
         return app_.overlay().onHandoff(
             std::move(bundle), std::move(request), remote_address);
+    }
 
     if (is_ws && isStatusRequest(request))
         return statusResponse(request);
@@ -284,6 +338,17 @@ ServerHandlerImp::onRequest(Session& session)
         return;
     }
 
+    if (tooBusy(session.port(), session.remoteAddress().at_port(0)))
+    {
+        HTTPReply(
+            503,
+            "Server is overloaded",
+            makeOutput(session),
+            app_.journal("RPC"));
+        session.close(true);
+        return;
+    }
+
     std::shared_ptr<Session> detachedSession = session.detach();
     auto const postResult = m_jobQueue.postCoro(
         jtCLIENT,
@@ -309,15 +374,7 @@ ServerHandlerImp::onWSMessage(
     std::shared_ptr<WSSession> session,
     std::vector<boost::asio::const_buffer> const& buffers)
 {
-    Json::Value jv;
-    auto const size = boost::asio::buffer_size(buffers);
-    if (size > RPC::Tuning::maxRequestSize ||
-        !Json::Reader{}.parse(jv, buffers) || !jv.isObject())
-    {
-        Json::Value jvResult(Json::objectValue);
-        jvResult[jss::type] = jss::error;
-        jvResult[jss::error] = "jsonInvalid";
-        jvResult[jss::value] = buffers_to_string(buffers);
+    auto const sendError = [&](Json::Value const& jvResult) {
         boost::beast::multi_buffer sb;
         Json::stream(jvResult, [&sb](auto const p, auto const n) {
             sb.commit(boost::asio::buffer_copy(
@@ -327,6 +384,30 @@ ServerHandlerImp::onWSMessage(
         session->send(
             std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb)));
         session->complete();
+    };
+
+    // Refuse the message before parsing it if it can't be served soon
+    if (tooBusy(
+            session->port(),
+            beast::IPAddressConversion::from_asio(session->remote_endpoint())))
+    {
+        Json::Value jvResult(Json::objectValue);
+        jvResult[jss::type] = jss::error;
+        jvResult[jss::error] = "tooBusy";
+        sendError(jvResult);
+        return;
+    }
+
+    Json::Value jv;
+    auto const size = boost::asio::buffer_size(buffers);
+    if (size > RPC::Tuning::maxRequestSize ||
+        !Json::Reader{}.parse(jv, buffers) || !jv.isObject())
+    {
+        Json::Value jvResult(Json::objectValue);
+        jvResult[jss::type] = jss::error;
+        jvResult[jss::error] = "jsonInvalid";
+        jvResult[jss::value] = buffers_to_string(buffers);
+        sendError(jvResult);
         return;
     }
 
@@ -335,11 +416,15 @@ ServerHandlerImp::onWSMessage(
     auto const postResult = m_jobQueue.postCoro(
         jtCLIENT,
         "WS-Client",
-        [this, session, jv = std::move(jv)](
+        [this, session, size, jv = std::move(jv)](
             std::shared_ptr<JobQueue::Coro> const& coro) {
             auto const jr = this->processSession(session, coro, jv);
             auto const s = to_string(jr);
             auto const n = s.length();
+            auto const& method = jv.isMember(jss::command) ? jv[jss::command]
+                                                           : jv[jss::method];
+            if (method.isString())
+                app_.getPerfLog().rpcBytes(method.asString(), size, n);
             boost::beast::multi_buffer sb(n);
             sb.commit(boost::asio::buffer_copy(
                 sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
@@ -513,7 +598,7 @@ ServerHandlerImp::processSession(
     std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
-    processRequest(
+    auto const streamed = processRequest(
         session->port(),
         buffers_to_string(session->request().body().data()),
         session->remoteAddress().at_port(0),
@@ -525,7 +610,12 @@ ServerHandlerImp::processSession(
             if (iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        // Chunked transfer encoding needs HTTP/1.1
+        session->request().version() >= 11 ? session : nullptr);
+
+    if (streamed)
+        return;
 
     if (beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
@@ -549,7 +639,7 @@ Json::Int constexpr server_overloaded = -32604;
 Json::Int constexpr forbidden = -32605;
 Json::Int constexpr wrong_version = -32606;
 
-void
+bool
 ServerHandlerImp::processRequest(
     Port const& port,
     std::string const& request,
@@ -557,7 +647,8 @@ ServerHandlerImp::processRequest(
     Output&& output,
     std::shared_ptr<JobQueue::Coro> coro,
     boost::string_view forwardedFor,
-    boost::string_view user)
+    boost::string_view user,
+    std::shared_ptr<Session> const& session)
 {
     auto rpcJ = app_.journal("RPC");
 
@@ -573,7 +664,7 @@ ServerHandlerImp::processRequest(
                 "Unable to parse request: " + reader.getFormatedErrorMessages(),
                 output,
                 rpcJ);
-            return;
+            return false;
         }
     }
 
@@ -585,7 +676,7 @@ ServerHandlerImp::processRequest(
         if (!jsonOrig.isMember(jss::params) || !jsonOrig[jss::params].isArray())
         {
             HTTPReply(400, "Malformed batch request", output, rpcJ);
-            return;
+            return false;
         }
         size = jsonOrig[jss::params].size();
     }
@@ -627,7 +718,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, jss::invalid_API_version.c_str(), output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r(Json::objectValue);
             r[jss::request] = jsonRPC;
@@ -675,7 +766,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(503, "Server is overloaded", output, rpcJ);
-                    return;
+                    return false;
                 }
                 Json::Value r = jsonRPC;
                 r[jss::error] =
@@ -691,7 +782,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(403, "Forbidden", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(forbidden, "Forbidden");
@@ -705,7 +796,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "Null method", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "Null method");
@@ -720,7 +811,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is not string", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -736,7 +827,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is empty", output, rpcJ);
-                return;
+                return false;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -762,7 +853,7 @@ ServerHandlerImp::processRequest(
             {
                 usage.charge(Resource::feeInvalidRPC);
                 HTTPReply(400, "params unparseable", output, rpcJ);
-                return;
+                return false;
             }
             else
             {
@@ -771,7 +862,7 @@ ServerHandlerImp::processRequest(
                 {
                     usage.charge(Resource::feeInvalidRPC);
                     HTTPReply(400, "params unparseable", output, rpcJ);
-                    return;
+                    return false;
                 }
             }
         }
@@ -789,7 +880,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(400, "ripplerpc is not a string", output, rpcJ);
-                    return;
+                    return false;
                 }
 
                 Json::Value r = jsonRPC;
@@ -833,6 +924,58 @@ ServerHandlerImp::processRequest(
              apiVersion},
             params,
             {user, forwardedFor}};
+        if (!batch && session)
+        {
+            if (auto command = RPC::prepareCommand(context))
+            {
+                auto reply = std::make_shared<RPC::StreamedReply>(
+                    coro,
+                    HTTPStreamedReplyHeader(),
+                    RPC::Tuning::streamQueueLimit);
+                session->write(
+                    reply->writer(),
+                    beast::rfc2616::is_keep_alive(session->request()));
+
+                {
+                    Json::Writer writer(reply->output());
+                    Json::Object::Root root(writer);
+                    {
+                        auto result = Json::addObject(root, jss::result);
+                        auto const status = command(result);
+                        usage.charge(loadType);
+                        if (usage.warn())
+                            result[jss::warning] = jss::load;
+                        result[jss::status] =
+                            status ? jss::error : jss::success;
+                    }
+
+                    if (params.isMember(jss::jsonrpc))
+                        root[jss::jsonrpc] = params[jss::jsonrpc];
+                    if (params.isMember(jss::ripplerpc))
+                        root[jss::ripplerpc] = params[jss::ripplerpc];
+                    if (params.isMember(jss::id))
+                        root[jss::id] = params[jss::id];
+                }
+                reply->output()("\n");
+                reply->finish();
+
+                auto const elapsed =
+                    std::chrono::high_resolution_clock::now() - start;
+                rpc_time_.notify(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        elapsed));
+                rpc_latency_.notify(elapsed);
+                ++rpc_requests_;
+                rpc_size_.notify(
+                    beast::insight::Event::value_type{reply->size()});
+                app_.getPerfLog().rpcBytes(
+                    strMethod, request.size(), reply->size());
+                JLOG(m_journal.debug())
+                    << "Streamed reply: " << reply->size() << " bytes";
+                return true;
+            }
+        }
+
         Json::Value result;
         RPC::doCommand(context, result);
         usage.charge(loadType);
@@ -904,10 +1047,18 @@ ServerHandlerImp::processRequest(
     }
     auto response = to_string(reply);
 
-    rpc_time_.notify(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::high_resolution_clock::now() - start));
+    auto const elapsed = std::chrono::high_resolution_clock::now() - start;
+    rpc_time_.notify(
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed));
+    rpc_latency_.notify(elapsed);
     ++rpc_requests_;
     rpc_size_.notify(beast::insight::Event::value_type{response.size()});
+    if (!batch && jsonOrig.isMember(jss::method) &&
+        jsonOrig[jss::method].isString())
+    {
+        app_.getPerfLog().rpcBytes(
+            jsonOrig[jss::method].asString(), request.size(), response.size());
+    }
 
     response += '\n';
 
@@ -921,6 +1072,7 @@ ServerHandlerImp::processRequest(
     }
 
     HTTPReply(200, response, output, rpcJ);
+    return false;
 }
 
 //------------------------------------------------------------------------------
@@ -1156,13 +1308,21 @@ make_ServerHandler(
     Application& app,
     Stoppable& parent,
     boost::asio::io_service& io_service,
+    boost::asio::io_service& peer_io_service,
     JobQueue& jobQueue,
     NetworkOPs& networkOPs,
     Resource::Manager& resourceManager,
     CollectorManager& cm)
 {
     return std::make_unique<ServerHandlerImp>(
-        app, parent, io_service, jobQueue, networkOPs, resourceManager, cm);
+        app,
+        parent,
+        io_service,
+        peer_io_service,
+        jobQueue,
+        networkOPs,
+        resourceManager,
+        cm);
 }
 
 }  // namespace ripple
@@ -98,6 +98,7 @@ private:
     beast::insight::Counter rpc_requests_;
     beast::insight::Event rpc_size_;
     beast::insight::Event rpc_time_;
+    beast::insight::Histogram rpc_latency_;
     std::mutex countlock_;
     std::map<std::reference_wrapper<Port const>, int> count_;
 
@@ -106,6 +107,7 @@ public:
         Application& app,
         Stoppable& parent,
         boost::asio::io_service& io_service,
+        boost::asio::io_service& peer_io_service,
         JobQueue& jobQueue,
         NetworkOPs& networkOPs,
         Resource::Manager& resourceManager,
@@ -173,6 +175,11 @@ public:
     onStopped(Server&);
 
 private:
+    // Whether a client should be turned away without doing any work for
+    // it, because the server or the client's budget is overloaded.
+    bool
+    tooBusy(Port const& port, beast::IP::Endpoint const& remote);
+
     Json::Value
     processSession(
         std::shared_ptr<WSSession> const& session,
@@ -184,7 +191,10 @@ private:
         std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
-    void
+    // If `session` is set, a result which can be written a piece at a time
+    // is streamed to it, instead of being written to the output. Returns
+    // true if the reply was streamed; the session then ends the reply itself.
+    bool
     processRequest(
         Port const& port,
         std::string const& request,
@@ -192,7 +202,8 @@ private:
         Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
         boost::string_view forwardedFor,
-        boost::string_view user);
+        boost::string_view user,
+        std::shared_ptr<Session> const& session = {});
 
     Handoff
     statusResponse(http_request_type const& request) const;
@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/StreamedReply.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace ripple {
+namespace RPC {
+
+class StreamedReply::SessionWriter : public Writer
+{
+public:
+    explicit SessionWriter(std::shared_ptr<StreamedReply> reply)
+        : reply_(std::move(reply))
+    {
+    }
+
+    ~SessionWriter() override
+    {
+        // The session is done with the reply, whether or not it was sent
+        reply_->abandon();
+    }
+
+    bool
+    complete() override
+    {
+        return reply_->sent();
+    }
+
+    void
+    consume(std::size_t bytes) override
+    {
+        reply_->consume(bytes);
+    }
+
+    bool
+    prepare(std::size_t, std::function<void(void)> resume) override
+    {
+        return reply_->prepare(std::move(resume));
+    }
+
+    std::vector<boost::asio::const_buffer>
+    data() override
+    {
+        return reply_->data();
+    }
+
+private:
+    std::shared_ptr<StreamedReply> const reply_;
+};
+
+StreamedReply::StreamedReply(
+    std::shared_ptr<JobQueue::Coro> coro,
+    std::string header,
+    std::size_t limit)
+    : coro_(std::move(coro)), limit_(limit)
+{
+    header += "Transfer-Encoding: chunked\r\n\r\n";
+    queued_ = header.size();
+    queue_.push_back(std::move(header));
+}
+
+std::shared_ptr<Writer>
+StreamedReply::writer()
+{
+    return std::make_shared<SessionWriter>(shared_from_this());
+}
+
+Json::Output
+StreamedReply::output()
+{
+    return [this](boost::beast::string_view const& data) { write(data); };
+}
+
+void
+StreamedReply::finish()
+{
+    flush(true);
+}
+
+void
+StreamedReply::write(boost::beast::string_view data)
+{
+    if (abandoned_)
+        return;
+
+    pending_.append(data.data(), data.size());
+    size_ += data.size();
+    if (pending_.size() >= Tuning::streamChunkSize)
+        flush(false);
+}
+
+void
+StreamedReply::flush(bool last)
+{
+    std::string chunk;
+    if (!pending_.empty())
+    {
+        char size[20];
+        auto const n =
+            std::snprintf(size, sizeof(size), "%zx\r\n", pending_.size());
+        chunk.reserve(n + pending_.size() + 7);
+        chunk.append(size, n);
+        chunk += pending_;
+        chunk += "\r\n";
+        pending_.clear();
+    }
+    if (last)
+        chunk += "0\r\n\r\n";
+    if (chunk.empty())
+        return;
+
+    std::function<void(void)> resume;
+    bool wait = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (abandoned_)
+            return;
+        queued_ += chunk.size();
+        queue_.push_back(std::move(chunk));
+        finished_ = last;
+        std::swap(resume, resume_);
+        if (!last && queued_ > limit_)
+            wait = waiting_ = true;
+    }
+
+    // Let the session know there is more to send
+    if (resume)
+        resume();
+
+    // The session resumes the coroutine once it has caught up
+    if (wait)
+        coro_->yield();
+}
+
+bool
+StreamedReply::sent() const
+{
+    std::lock_guard lock(mutex_);
+    return finished_ && queue_.empty();
+}
+
+bool
+StreamedReply::prepare(std::function<void(void)> resume)
+{
+    std::lock_guard lock(mutex_);
+    if (!queue_.empty() || finished_)
+        return true;
+    resume_ = std::move(resume);
+    return false;
+}
+
+std::vector<boost::asio::const_buffer>
+StreamedReply::data()
+{
+    std::lock_guard lock(mutex_);
+    std::vector<boost::asio::const_buffer> result;
+    result.reserve(queue_.size());
+    auto offset = offset_;
+    for (auto const& chunk : queue_)
+    {
+        result.emplace_back(chunk.data() + offset, chunk.size() - offset);
+        offset = 0;
+    }
+    return result;
+}
+
+void
+StreamedReply::consume(std::size_t bytes)
+{
+    bool wake = false;
+    {
+        std::lock_guard lock(mutex_);
+        queued_ -= bytes;
+        while (bytes != 0)
+        {
+            auto const n = std::min(bytes, queue_.front().size() - offset_);
+            offset_ += n;
+            bytes -= n;
+            if (offset_ == queue_.front().size())
+            {
+                queue_.pop_front();
+                offset_ = 0;
+            }
+        }
+        if (waiting_ && queued_ <= limit_ / 2)
+        {
+            waiting_ = false;
+            wake = true;
+        }
+    }
+
+    if (wake)
+        this->wake();
+}
+
+void
+StreamedReply::abandon()
+{
+    bool wake = false;
+    {
+        std::lock_guard lock(mutex_);
+        abandoned_ = true;
+        queue_.clear();
+        queued_ = 0;
+        offset_ = 0;
+        resume_ = nullptr;
+        std::swap(wake, waiting_);
+    }
+
+    if (wake)
+        this->wake();
+}
+
+void
+StreamedReply::wake()
+{
+    if (!coro_->post())
+    {
+        // The job queue is stopping, so nothing will run the coroutine.
+        // Let it finish here, discarding the rest of the reply, or the
+        // application would hang on shutdown.
+        abandoned_ = true;
+        coro_->resume();
+    }
+}
+
+}  // namespace RPC
+}  // namespace ripple
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_STREAMEDREPLY_H_INCLUDED
+#define RIPPLE_RPC_STREAMEDREPLY_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/Output.h>
+#include <ripple/server/Writer.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace RPC {
+
+/** An HTTP reply sent with chunked transfer encoding as it is written.
+
+    The body is written by an RPC coroutine and pulled by the session
+    through writer() as the socket accepts it. Whenever more than `limit`
+    bytes are waiting to be sent the coroutine is suspended until the
+    session catches up, so the memory used stays bounded no matter how
+    large the reply is.
+
+    If the session goes away before the reply is sent, the rest of the
+    body is discarded.
+*/
+class StreamedReply : public std::enable_shared_from_this<StreamedReply>
+{
+public:
+    /** Create a reply.
+
+        @param coro The coroutine writing the body.
+        @param header The status line and header fields, without a
+            terminating empty line. The transfer encoding is added.
+    */
+    StreamedReply(
+        std::shared_ptr<JobQueue::Coro> coro,
+        std::string header,
+        std::size_t limit);
+
+    /** The Writer to give to the session. May only be called once. */
+    std::shared_ptr<Writer>
+    writer();
+
+    /** Return an Output which adds to the body.
+
+        The Output may only be used by the coroutine, and not after
+        finish() is called.
+    */
+    Json::Output
+    output();
+
+    /** Send the rest of the body and end the reply. */
+    void
+    finish();
+
+    /** The number of bytes of body written so far. */
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+private:
+    class SessionWriter;
+
+    void
+    write(boost::beast::string_view data);
+
+    void
+    flush(bool last);
+
+    // Called by the SessionWriter on the session's strand
+    bool
+    sent() const;
+
+    bool
+    prepare(std::function<void(void)> resume);
+
+    std::vector<boost::asio::const_buffer>
+    data();
+
+    void
+    consume(std::size_t bytes);
+
+    void
+    abandon();
+
+    void
+    wake();
+
+    std::shared_ptr<JobQueue::Coro> const coro_;
+    std::size_t const limit_;
+
+    // Only touched by the coroutine
+    std::string pending_;
+    std::size_t size_ = 0;
+
+    mutable std::mutex mutex_;
+    std::deque<std::string> queue_;
+    std::size_t queued_ = 0;
+    std::size_t offset_ = 0;
+    std::function<void(void)> resume_;
+    bool finished_ = false;
+    bool waiting_ = false;
+    std::atomic<bool> abandoned_{false};
+};
+
+}  // namespace RPC
+}  // namespace ripple
+
+#endif
@@ -59,6 +59,15 @@ static int constexpr maxJobQueueClients = 500;
 auto constexpr maxValidatedLedgerAge = std::chrono::minutes{2};
 static int constexpr maxRequestSize = 1000000;
 
+/** The most transactions submit_multiple accepts in one request. */
+static std::size_t constexpr maxSubmitMultiple = 1000;
+
+/** The most signatures of a submit_multiple request checked by one job. */
+static std::size_t constexpr submitSigCheckBatch = 32;
+
+/** The most issuers gateway_balances keeps trust line totals for. */
+static std::size_t constexpr maxIssuerBalances = 64;
+
 /** Maximum number of pages in one response from a binary LedgerData request. */
 static int constexpr binaryPageLength = 2048;
 
@@ -71,6 +80,13 @@ inline int constexpr pageLength(bool isBinary)
     return isBinary ? binaryPageLength : jsonPageLength;
 }
 
+/** The size of each chunk of a streamed reply. */
+static std::size_t constexpr streamChunkSize = 64 * 1024;
+
+/** The most bytes of a streamed reply waiting to be sent before the handler
+    writing it is suspended. */
+static std::size_t constexpr streamQueueLimit = 1024 * 1024;
+
 /** Maximum number of source currencies allowed in a path find request. */
 static int constexpr max_src_cur = 18;
 
@@ -39,6 +39,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -58,24 +59,14 @@ protected:
         // Size of our read/write buffer
         bufferSize = 4 * 1024,
 
+        // Largest write buffer kept for the next response
+        maxBufferSize = 64 * 1024,
+
         // Max seconds without completing a message
         timeoutSeconds = 30,
         timeoutSecondsLocal = 3  // used for localhost clients
     };
 
-    struct buffer
-    {
-        buffer(void const* ptr, std::size_t len)
-            : data(new char[len]), bytes(len), used(0)
-        {
-            memcpy(data.get(), ptr, len);
-        }
-
-        std::unique_ptr<char[]> data;
-        std::size_t bytes;
-        std::size_t used;
-    };
-
     Port const& port_;
     Handler& handler_;
     boost::asio::executor_work_guard<boost::asio::executor> work_;
@@ -88,8 +79,11 @@ protected:
 
     boost::asio::streambuf read_buf_;
     http_request_type message_;
-    std::vector<buffer> wq_;
-    std::vector<buffer> wq2_;
+    // Data written and not yet sent is gathered into wq_, and swapped into
+    // wq2_ while it is being sent. Both keep their storage, so responses
+    // on a persistent connection don't allocate once it is warmed up.
+    std::string wq_;
+    std::string wq2_;
     std::mutex mutex_;
     bool graceful_ = false;
     bool complete_ = false;
@@ -330,19 +324,16 @@ BaseHTTPPeer<Handler, Impl>::on_write(
     {
         std::lock_guard lock(mutex_);
         wq2_.clear();
-        wq2_.reserve(wq_.size());
+        if (wq2_.capacity() > maxBufferSize)
+            wq2_.shrink_to_fit();
         std::swap(wq2_, wq_);
     }
     if (!wq2_.empty())
     {
-        std::vector<boost::asio::const_buffer> v;
-        v.reserve(wq2_.size());
-        for (auto const& b : wq2_)
-            v.emplace_back(b.data.get(), b.bytes);
         start_timer();
         return boost::asio::async_write(
             impl().stream_,
-            v,
+            boost::asio::buffer(wq2_),
             bind_executor(
                 strand_,
                 std::bind(
@@ -405,6 +396,9 @@ BaseHTTPPeer<Handler, Impl>::do_writer(
     if (!keep_alive)
         return do_close();
 
+    // Read the next request into an empty message, as complete() does
+    message_ = {};
+
     boost::asio::spawn(
         strand_,
         std::bind(
@@ -424,8 +418,8 @@ BaseHTTPPeer<Handler, Impl>::write(void const* buf, std::size_t bytes)
         return;
     if ([&] {
             std::lock_guard lock(mutex_);
-            wq_.emplace_back(buf, bytes);
-            return wq_.size() == 1 && wq2_.size() == 0;
+            wq_.append(static_cast<char const*>(buf), bytes);
+            return wq_.size() == bytes && wq2_.empty();
         }())
     {
         if (!strand_.running_in_this_thread())
@@ -53,6 +53,8 @@ private:
     boost::beast::multi_buffer wb_;
     std::list<std::shared_ptr<WSMsg>> wq_;
     bool do_close_ = false;
+    // Set while Nagle's algorithm is turned back on to batch queued messages
+    bool corked_ = false;
     boost::beast::websocket::close_reason cr_;
     waitable_timer timer_;
     bool close_on_timer_ = false;
@@ -130,6 +132,9 @@ protected:
     void
     on_write_fin(error_code const& ec);
 
+    void
+    cork(bool batch);
+
     void
     do_read();
 
@@ -188,6 +193,9 @@ BaseWSPeer<Handler, Impl>::run()
         return post(
             strand_, std::bind(&BaseWSPeer::run, impl().shared_from_this()));
     impl().ws_.set_option(port().pmd_options);
+    // Compressed messages are sent a write buffer at a time, so a larger
+    // buffer sends a large message in fewer frames and writes.
+    impl().ws_.write_buffer_bytes(16384);
     // Must manage the control callback memory outside of the `control_callback`
     // function
     control_callback_ = std::bind(
@@ -347,6 +355,7 @@ BaseWSPeer<Handler, Impl>::on_write_fin(error_code const& ec)
     if (ec)
         return fail(ec, "write_fin");
     wq_.pop_front();
+    cork(!wq_.empty());
     if (do_close_)
         impl().ws_.async_close(
             cr_,
@@ -360,6 +369,30 @@ BaseWSPeer<Handler, Impl>::on_write_fin(error_code const& ec)
         on_write({});
 }
 
+// While messages are waiting to be sent, let the socket gather them into
+// full segments instead of sending one small segment per frame. Turning
+// no_delay back on once the queue drains sends whatever is left at once.
+template <class Handler, class Impl>
+void
+BaseWSPeer<Handler, Impl>::cork(bool batch)
+{
+    if (batch == corked_)
+        return;
+    auto& socket = ripple::get_lowest_layer(impl().ws_).socket();
+    error_code ec;
+    if (batch)
+    {
+        // Sockets which don't disable Nagle's algorithm batch already
+        boost::asio::ip::tcp::no_delay option;
+        socket.get_option(option, ec);
+        if (ec || !option.value())
+            return;
+    }
+    socket.set_option(boost::asio::ip::tcp::no_delay{!batch}, ec);
+    if (!ec)
+        corked_ = batch;
+}
+
 template <class Handler, class Impl>
 void
 BaseWSPeer<Handler, Impl>::do_read()
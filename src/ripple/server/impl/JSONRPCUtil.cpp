@@ -141,4 +141,15 @@ HTTPReply(
     output("\r\n");
 }
 
+std::string
+HTTPStreamedReplyHeader()
+{
+    return "HTTP/1.1 200 OK\r\n" + getHTTPHeaderTimestamp() +
+        "Connection: Keep-Alive\r\n"
+        "Content-Type: application/json; charset=UTF-8\r\n"
+        "Server: " +
+        systemName() + "-json-rpc/" + BuildInfo::getFullVersionString() +
+        "\r\n";
+}
+
 }  // namespace ripple
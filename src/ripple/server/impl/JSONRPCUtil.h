@@ -32,6 +32,12 @@ HTTPReply(
     Json::Output const&,
     beast::Journal j);
 
+/** The status line and header fields of a successful reply whose length is
+    not known when it starts, without a terminating empty line.
+*/
+std::string
+HTTPStreamedReplyHeader();
+
 }  // namespace ripple
 
 #endif
@@ -83,6 +83,7 @@ private:
     Handler& handler_;
     beast::Journal const j_;
     boost::asio::io_service& io_service_;
+    boost::asio::io_service& peer_io_service_;
     boost::asio::io_service::strand strand_;
     boost::optional<boost::asio::io_service::work> work_;
 
@@ -100,6 +101,14 @@ public:
         boost::asio::io_service& io_service,
         beast::Journal journal);
 
+    /** Create a server whose ports accepting only peers use their own
+        io_service. */
+    ServerImpl(
+        Handler& handler,
+        boost::asio::io_service& io_service,
+        boost::asio::io_service& peer_io_service,
+        beast::Journal journal);
+
     ~ServerImpl();
 
     beast::Journal
@@ -139,9 +148,20 @@ ServerImpl<Handler>::ServerImpl(
     Handler& handler,
     boost::asio::io_service& io_service,
     beast::Journal journal)
+    : ServerImpl(handler, io_service, io_service, journal)
+{
+}
+
+template <class Handler>
+ServerImpl<Handler>::ServerImpl(
+    Handler& handler,
+    boost::asio::io_service& io_service,
+    boost::asio::io_service& peer_io_service,
+    beast::Journal journal)
     : handler_(handler)
     , j_(journal)
     , io_service_(io_service)
+    , peer_io_service_(peer_io_service)
     , strand_(io_service_)
     , work_(io_service_)
 {
@@ -168,8 +188,11 @@ ServerImpl<Handler>::ports(std::vector<Port> const& ports)
     for (auto const& port : ports)
     {
         ports_.push_back(port);
-        if (auto sp = ios_.emplace<Door<Handler>>(
-                handler_, io_service_, ports_.back(), j_))
+        auto& ios = port.protocol.size() == 1 && port.protocol.count("peer")
+            ? peer_io_service_
+            : io_service_;
+        if (auto sp =
+                ios_.emplace<Door<Handler>>(handler_, ios, ports_.back(), j_))
         {
             list_.push_back(sp);
             eps.push_back(sp->get_endpoint());
@@ -81,6 +81,21 @@ public:
     virtual void
     missingNode(uint256 const& refHash, std::uint32_t refNum) = 0;
 
+    /** Fetch a node which is not in the database from elsewhere.
+
+        Called when a backed SHAMap doesn't find a node in the database,
+        before the node is treated as missing.
+
+        @param hash The hash of the node
+        @param ledgerSeq The sequence of the ledger the node is part of
+        @return The node, or nullptr if it couldn't be fetched
+    */
+    virtual std::shared_ptr<NodeObject>
+    fetchMissing(uint256 const& hash, std::uint32_t ledgerSeq)
+    {
+        return {};
+    }
+
     virtual void
     reset() = 0;
 };
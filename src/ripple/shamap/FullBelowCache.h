@@ -20,10 +20,15 @@
 #ifndef RIPPLE_SHAMAP_FULLBELOWCACHE_H_INCLUDED
 #define RIPPLE_SHAMAP_FULLBELOWCACHE_H_INCLUDED
 
-#include <ripple/basics/KeyCache.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/base_uint.h>
+#include <ripple/basics/hardened_hash.h>
+#include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Insight.h>
+#include <array>
 #include <atomic>
+#include <mutex>
 #include <string>
 
 namespace ripple {
@@ -32,19 +37,32 @@ namespace detail {
 
 /** Remembers which tree keys have all descendants resident.
     This optimizes the process of acquiring a complete tree.
+
+    Every inner node a sync traverses which is not already marked full
+    below is looked up here, from several threads at once, so the keys
+    are split between shards which each have their own lock. Keys are
+    hashes, so the first byte of a key spreads them evenly.
 */
 template <class Key>
 class BasicFullBelowCache
 {
+public:
+    using clock_type = beast::abstract_clock<std::chrono::steady_clock>;
+
 private:
-    using CacheType = KeyCache<Key>;
+    static constexpr std::size_t shardCount = 16;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        hardened_hash_map<Key, clock_type::time_point> map;
+    };
 
 public:
     enum { defaultCacheTargetSize = 0 };
 
     using key_type = Key;
-    using size_type = typename CacheType::size_type;
-    using clock_type = typename CacheType::clock_type;
+    using size_type = std::size_t;
 
     /** Construct the cache.
 
@@ -60,7 +78,13 @@ public:
             beast::insight::NullCollector::New(),
         std::size_t target_size = defaultCacheTargetSize,
         std::chrono::seconds expiration = std::chrono::minutes{2})
-        : m_cache(name, clock, collector, target_size, expiration), m_gen(1)
+        : m_clock(clock)
+        , m_target_size(target_size)
+        , m_target_age(expiration)
+        , m_size(collector->make_gauge(name, "size"))
+        , m_hit_rate(collector->make_gauge(name, "hit_rate"))
+        , m_gen(1)
+        , m_hook(collector->make_hook([this] { collect_metrics(); }))
     {
     }
 
@@ -68,7 +92,7 @@ public:
     clock_type&
     clock()
     {
-        return m_cache.clock();
+        return m_clock;
     }
 
     /** Return the number of elements in the cache.
@@ -78,7 +102,13 @@ public:
     size_type
     size() const
     {
-        return m_cache.size();
+        size_type total = 0;
+        for (auto& shard : m_shards)
+        {
+            std::lock_guard lock(shard.mutex);
+            total += shard.map.size();
+        }
+        return total;
     }
 
     /** Remove expired cache items.
@@ -88,7 +118,34 @@ public:
     void
     sweep()
     {
-        m_cache.sweep();
+        auto const now = m_clock.now();
+        auto when_expire = now - m_target_age;
+
+        // Over the target size, entries expire sooner in proportion
+        auto const total = size();
+        if (m_target_size != 0 && total > m_target_size)
+        {
+            when_expire = now - m_target_age * m_target_size / total;
+            if (when_expire > now - std::chrono::seconds(1))
+                when_expire = now - std::chrono::seconds(1);
+        }
+
+        for (auto& shard : m_shards)
+        {
+            std::lock_guard lock(shard.mutex);
+            for (auto it = shard.map.begin(); it != shard.map.end();)
+            {
+                if (it->second > now)
+                {
+                    it->second = now;
+                    ++it;
+                }
+                else if (it->second <= when_expire)
+                    it = shard.map.erase(it);
+                else
+                    ++it;
+            }
+        }
     }
 
     /** Refresh the last access time of an item, if it exists.
@@ -100,7 +157,17 @@ public:
     bool
     touch_if_exists(key_type const& key)
     {
-        return m_cache.touch_if_exists(key);
+        auto& shard = shardFor(key);
+        std::lock_guard lock(shard.mutex);
+        auto const it = shard.map.find(key);
+        if (it == shard.map.end())
+        {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        it->second = m_clock.now();
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
     }
 
     /** Insert a key into the cache.
@@ -113,7 +180,10 @@ public:
     void
     insert(key_type const& key)
     {
-        m_cache.insert(key);
+        auto const now = m_clock.now();
+        auto& shard = shardFor(key);
+        std::lock_guard lock(shard.mutex);
+        shard.map[key] = now;
     }
 
     /** generation determines whether cached entry is valid */
@@ -126,20 +196,58 @@ public:
     void
     clear()
     {
-        m_cache.clear();
+        clearShards();
         ++m_gen;
     }
 
     void
     reset()
     {
-        m_cache.clear();
+        clearShards();
+        m_hits = 0;
+        m_misses = 0;
         m_gen = 1;
     }
 
 private:
-    KeyCache<Key> m_cache;
+    Shard&
+    shardFor(key_type const& key) const
+    {
+        return m_shards[*key.cbegin() % shardCount];
+    }
+
+    void
+    clearShards()
+    {
+        for (auto& shard : m_shards)
+        {
+            std::lock_guard lock(shard.mutex);
+            shard.map.clear();
+        }
+    }
+
+    void
+    collect_metrics()
+    {
+        m_size.set(size());
+
+        auto const hits = m_hits.load(std::memory_order_relaxed);
+        auto const total = hits + m_misses.load(std::memory_order_relaxed);
+        m_hit_rate.set(total == 0 ? 0 : (hits * 100) / total);
+    }
+
+    std::array<Shard, shardCount> mutable m_shards;
+    clock_type& m_clock;
+    size_type const m_target_size;
+    clock_type::duration const m_target_age;
+    std::atomic<std::uint64_t> m_hits{0};
+    std::atomic<std::uint64_t> m_misses{0};
+    beast::insight::Gauge m_size;
+    beast::insight::Gauge m_hit_rate;
     std::atomic<std::uint32_t> m_gen;
+
+    // Last, so that it is gone before what it reports on
+    beast::insight::Hook m_hook;
 };
 
 }  // namespace detail
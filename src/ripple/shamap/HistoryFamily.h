@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SHAMAP_HISTORYFAMILY_H_INCLUDED
+#define RIPPLE_SHAMAP_HISTORYFAMILY_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/CollectorManager.h>
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/messages.h>
+#include <ripple/shamap/Family.h>
+#include <condition_variable>
+#include <mutex>
+
+namespace ripple {
+
+class Application;
+
+/** The family of old ledgers read through from peers.
+
+    When the server is asked about a ledger older than the ones it keeps,
+    the ledger is built in this family instead of failing. Every node the
+    server doesn't have is fetched from peers which have the ledger, when
+    it's first read, and kept only in the family's own tree node cache.
+    Nothing is written to the node store.
+
+    The hash of the ledger comes from the skip lists of the last validated
+    ledger, and the header and nodes are checked against their hashes.
+*/
+class HistoryFamily : public Family
+{
+public:
+    HistoryFamily() = delete;
+    HistoryFamily(HistoryFamily const&) = delete;
+    HistoryFamily(HistoryFamily&&) = delete;
+
+    HistoryFamily&
+    operator=(HistoryFamily const&) = delete;
+
+    HistoryFamily&
+    operator=(HistoryFamily&&) = delete;
+
+    HistoryFamily(Application& app, CollectorManager& cm);
+
+    NodeStore::Database&
+    db() override
+    {
+        return db_;
+    }
+
+    NodeStore::Database const&
+    db() const override
+    {
+        return db_;
+    }
+
+    beast::Journal const&
+    journal() override
+    {
+        return j_;
+    }
+
+    bool
+    isShardBacked() const override
+    {
+        return false;
+    }
+
+    std::shared_ptr<FullBelowCache> getFullBelowCache(std::uint32_t) override
+    {
+        return fbCache_;
+    }
+
+    std::shared_ptr<TreeNodeCache> getTreeNodeCache(std::uint32_t) override
+    {
+        return tnCache_;
+    }
+
+    void
+    sweep() override;
+
+    void
+    reset() override;
+
+    // Nodes are fetched one at a time as they are read, never by
+    // acquiring the whole ledger
+    void
+    missingNode(std::uint32_t) override
+    {
+    }
+
+    void
+    missingNode(uint256 const&, std::uint32_t) override
+    {
+    }
+
+    std::shared_ptr<NodeObject>
+    fetchMissing(uint256 const& hash, std::uint32_t ledgerSeq) override;
+
+    /** Return a validated ledger older than those the server has.
+
+        Blocks while the header and the nodes needed to find it are
+        fetched from peers. Nodes read from the ledger later are fetched
+        the same way. No more than historyMaxActive jobs wait on peers at
+        once; beyond that, fetches fail at once and the read throws
+        SHAMapMissingNode.
+
+        @return The ledger, or nullptr if it couldn't be fetched.
+    */
+    std::shared_ptr<Ledger const>
+    getLedger(LedgerIndex seq);
+
+    /** Take an object a peer sent.
+
+        @return Whether the object was one asked for.
+    */
+    bool
+    gotObject(uint256 const& hash, Slice data);
+
+private:
+    struct Request
+    {
+        std::shared_ptr<Blob const> data;
+        std::size_t waiters = 0;
+    };
+
+    // The ledger with a hash found from a validated ledger
+    std::shared_ptr<Ledger const>
+    getLedger(uint256 const& hash, LedgerIndex seq);
+
+    // Fetch an object of a ledger from peers, waiting for the reply
+    std::shared_ptr<Blob const>
+    fetch(
+        uint256 const& hash,
+        LedgerIndex seq,
+        protocol::TMGetObjectByHash::ObjectType type);
+
+    Application& app_;
+    NodeStore::Database& db_;
+    beast::Journal const j_;
+
+    std::shared_ptr<FullBelowCache> fbCache_;
+    std::shared_ptr<TreeNodeCache> tnCache_;
+    TaggedCache<uint256, Ledger const> ledgers_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    hash_map<uint256, Request> requests_;
+
+    // The number of jobs waiting on peers for an object
+    std::size_t active_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
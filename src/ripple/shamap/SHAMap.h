@@ -33,6 +33,7 @@
 #include <ripple/shamap/SHAMapMissingNode.h>
 #include <ripple/shamap/SHAMapTreeNode.h>
 #include <ripple/shamap/TreeNodeCache.h>
+#include <atomic>
 #include <cassert>
 #include <stack>
 #include <vector>
@@ -124,6 +125,15 @@ public:
         std::shared_ptr<SHAMapItem const>>;
     using Delta = std::map<uint256, DeltaItem>;
 
+    /** A node hashed by flushDirty, waiting to be written. */
+    struct PendingNode
+    {
+        NodeObjectType type;
+        Blob data;
+        uint256 hash;
+    };
+    using PendingNodes = std::vector<PendingNode>;
+
     SHAMap(SHAMap const&) = delete;
     SHAMap&
     operator=(SHAMap const&) = delete;
@@ -202,6 +212,32 @@ public:
     bool
     addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item);
 
+    /** A change to one item, for applyChanges */
+    struct Change
+    {
+        uint256 key;
+
+        /** The new item, or null to delete the item */
+        std::shared_ptr<SHAMapItem const> item;
+
+        /** If set the item must not already exist, otherwise it must */
+        bool insert = false;
+    };
+
+    /** Make a set of changes in one pass over the tree.
+
+        The changes must be sorted by key, with no key appearing twice.
+        Each inner node on the path to a changed item is visited and
+        unshared once, however many of the changes are below it, rather
+        than once per change.
+
+        @return false if any of the changes could not be made, because an
+            inserted item already exists or an updated or deleted one does
+            not. The others are made regardless.
+    */
+    bool
+    applyChanges(SHAMapNodeType type, std::vector<Change> const& changes);
+
     // Save a copy if you need to extend the life
     // of the SHAMapItem beyond this SHAMap
     std::shared_ptr<SHAMapItem const> const&
@@ -213,6 +249,16 @@ public:
     const_iterator
     upper_bound(uint256 const& id) const;
 
+    /** Find the first item after the given one, starting from the part of
+        the path to `hint` which also leads towards `id`.
+
+        Stepping through the map with each result as the next hint visits
+        only a few nodes each step, rather than walking down from the
+        root every time. The hint must be an iterator of this map.
+    */
+    const_iterator
+    upper_bound(uint256 const& id, const_iterator hint) const;
+
     /**  Visit every node in this SHAMap
 
          @param function called with every node visited.
@@ -221,6 +267,23 @@ public:
     void
     visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const;
 
+    /**  Visit every node in this SHAMap using several threads
+
+         The non-empty branches of the root are handed out one at a time
+         to the workers, each of which walks its subtree depth first and
+         prefetches the children of every inner node it reaches in a
+         single batch. Nodes are visited in no particular order and the
+         function is invoked concurrently, so it must be thread safe.
+
+         @param function called with every node visited.
+         If function returns false, all workers stop.
+         @param threads The number of threads to use.
+    */
+    void
+    visitNodesParallel(
+        std::function<bool(SHAMapTreeNode&)> const& function,
+        unsigned int threads) const;
+
     /**  Visit every node in this SHAMap that
          is not present in the specified SHAMap
 
@@ -251,10 +314,14 @@ public:
 
         @param maxNodes The maximum number of found nodes to return
         @param filter The filter to use when retrieving nodes
+        @param priority The priority of the reads from the node store
         @param return The nodes known to be missing
     */
     std::vector<std::pair<SHAMapNodeID, uint256>>
-    getMissingNodes(int maxNodes, SHAMapSyncFilter* filter);
+    getMissingNodes(
+        int maxNodes,
+        SHAMapSyncFilter* filter,
+        NodeStore::FetchPriority priority = NodeStore::FetchPriority::high);
 
     bool
     getNodeFat(
@@ -264,6 +331,18 @@ public:
         bool fatLeaves,
         std::uint32_t depth) const;
 
+    /** Find the nodes getNodeFat would have to read from the node store.
+
+        Their reads are posted, so that once they are done getNodeFat can
+        serve the request without waiting on the node store. The nodes
+        below a node being read aren't known yet, so after the reads this
+        may find more.
+
+        @return The hashes of the nodes being read
+    */
+    std::vector<uint256>
+    getNodeFatReads(SHAMapNodeID const& wanted, std::uint32_t depth) const;
+
     /** Serializes the root in a format appropriate for sending over the wire */
     void
     serializeRoot(Serializer& s) const;
@@ -296,6 +375,24 @@ public:
     bool
     compare(SHAMap const& otherMap, Delta& differences, int maxCount) const;
 
+    /** Serialize the nodes of this map which are not in another map.
+
+        Branches whose hash matches the same branch of `otherMap` are
+        skipped, so for adjacent ledgers only the nodes changed between
+        them are returned. Each node follows its parent, the order in
+        which addKnownNode accepts them.
+
+        @param otherMap The map to compare with, which must be immutable
+        @param nodes The IDs and wire format of the nodes found
+        @param maxNodes The maximum number of nodes to return
+        @return `false` if there were more than `maxNodes` nodes
+    */
+    bool
+    getDeltaNodes(
+        SHAMap const& otherMap,
+        std::vector<std::pair<SHAMapNodeID, Blob>>& nodes,
+        std::size_t maxNodes) const;
+
     /** Convert any modified nodes to shared. */
     int
     unshare();
@@ -304,8 +401,36 @@ public:
     int
     flushDirty(NodeObjectType t);
 
+    /** Convert modified nodes to shared, leaving the writes for later.
+
+        The nodes are hashed and shared exactly as by flushDirty, but
+        rather than being written they are appended to `pending`. Until
+        they are passed to storePending, they can only be reached through
+        this map.
+    */
+    int
+    flushDirty(NodeObjectType t, PendingNodes& pending);
+
+    /** Write nodes left by flushDirty to the nodestore.
+
+        The serialized nodes are moved into the nodestore, not copied.
+    */
+    void
+    storePending(PendingNodes&& pending) const;
+
     void
     walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
+
+    /** Like walkMap, but walks the branches of the root on several threads.
+        The order of the missing nodes reported is unspecified. Subtrees
+        in the full below cache are skipped, and those found complete are
+        added to it.
+    */
+    void
+    walkMapParallel(
+        std::vector<SHAMapMissingNode>& missingNodes,
+        int maxMissing,
+        unsigned int threads) const;
     bool
     deepCompare(SHAMap& other) const;  // Intended for debug/test only
 
@@ -318,8 +443,9 @@ public:
     invariants() const;
 
 private:
-    using SharedPtrNodeStack =
-        std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
+    using SharedPtrNodeStack = std::stack<
+        std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>,
+        std::vector<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>>;
     using DeltaRef = std::pair<
         std::shared_ptr<SHAMapItem const> const&,
         std::shared_ptr<SHAMapItem const> const&>;
@@ -350,9 +476,22 @@ private:
         uint256 const& target,
         std::shared_ptr<SHAMapTreeNode> terminal);
 
+    /** Make the changes in [first, last) below a node, returning what
+        replaces it: null if nothing is left below it, or a leaf if only
+        one item is and the node is not the root. */
+    std::shared_ptr<SHAMapTreeNode>
+    applyChanges(
+        SHAMapNodeType type,
+        std::shared_ptr<SHAMapTreeNode> node,
+        SHAMapNodeID const& nodeID,
+        Change const* first,
+        Change const* last,
+        bool& ok);
+
     /** Walk towards the specified id, returning the node.  Caller must check
         if the return is nullptr, and if not, if the node->peekItem()->key() ==
-       id */
+       id. If the stack is not empty the walk starts from the inner node on
+       top of it, which must lie on the path to id, instead of the root. */
     SHAMapLeafNode*
     walkTowardsKey(uint256 const& id, SharedPtrNodeStack* stack = nullptr)
         const;
@@ -370,9 +509,35 @@ private:
     std::shared_ptr<Node>
     preFlushNode(std::shared_ptr<Node> node) const;
 
-    /** write and canonicalize modified node */
+    /** write and canonicalize modified node
+
+        If `pending` is set, the node is added to it instead of written.
+    */
     std::shared_ptr<SHAMapTreeNode>
-    writeNode(NodeObjectType t, std::shared_ptr<SHAMapTreeNode> node) const;
+    writeNode(
+        NodeObjectType t,
+        std::shared_ptr<SHAMapTreeNode> node,
+        PendingNodes* pending) const;
+
+    /** Modified children of an inner node, by branch */
+    using DirtyChildren =
+        std::vector<std::pair<int, std::shared_ptr<SHAMapTreeNode>>>;
+
+    /** Hash the modified children of an inner node together, make them
+        shareable, write them if requested and hook them back up.
+
+        Any inner node among the children must already have had its own
+        children flushed.
+
+        @return the number of children flushed.
+     */
+    int
+    flushChildren(
+        SHAMapInnerNode& node,
+        DirtyChildren& children,
+        bool doWrite,
+        NodeObjectType t,
+        PendingNodes* pending) const;
 
     SHAMapLeafNode*
     firstBelow(
@@ -397,6 +562,7 @@ private:
         SHAMapInnerNode* parent,
         int branch,
         SHAMapSyncFilter* filter,
+        NodeStore::FetchPriority priority,
         bool& pending) const;
 
     std::pair<SHAMapTreeNode*, SHAMapNodeID>
@@ -411,6 +577,32 @@ private:
     std::shared_ptr<SHAMapTreeNode>
     descendNoStore(std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
+    /** Bring the children of an inner node which are not in memory into
+        the node store cache with a single batch fetch. */
+    void
+    prefetchChildren(SHAMapInnerNode& node) const;
+
+    /** Visit the nodes below an inner node.
+        @param prefetch Prefetch the children of each inner node reached.
+        @return false if the function returned false or another worker
+                asked to stop.
+    */
+    bool
+    visitSubTree(
+        std::shared_ptr<SHAMapInnerNode> node,
+        std::function<bool(SHAMapTreeNode&)> const& function,
+        std::atomic<bool> const& stop,
+        bool prefetch) const;
+
+    /** Invoke work with each non-empty branch of the root, distributing
+        the branches across up to `threads` threads. An exception thrown
+        by any worker is rethrown on the calling thread.
+    */
+    void
+    forEachRootBranch(
+        unsigned int threads,
+        std::function<void(int branch)> const& work) const;
+
     /** If there is only one leaf below this node, get its contents */
     std::shared_ptr<SHAMapItem const> const&
     onlyBelow(SHAMapTreeNode*) const;
@@ -432,7 +624,7 @@ private:
         Delta& differences,
         int& maxCount) const;
     int
-    walkSubTree(bool doWrite, NodeObjectType t);
+    walkSubTree(bool doWrite, NodeObjectType t, PendingNodes* pending);
 
     // Structure to track information about call to
     // getMissingNodes while it's in progress
@@ -446,8 +638,12 @@ private:
         // basic parameters
         int max_;
         SHAMapSyncFilter* filter_;
+        NodeStore::FetchPriority const priority_;
         int const maxDefer_;
-        std::uint32_t generation_;
+
+        // Looked up once, since a family may find it in a locked map
+        std::shared_ptr<FullBelowCache> const fullBelow_;
+        std::uint32_t const generation_;
 
         // nodes we have discovered to be missing
         std::vector<std::pair<SHAMapNodeID, uint256>> missingNodes_;
@@ -476,15 +672,23 @@ private:
         // reads
         std::map<SHAMapInnerNode*, SHAMapNodeID> resumes_;
 
+        // how many reads of the children of nodes which arrived from
+        // deferred reads may be started ahead of the traversal
+        int lookahead_;
+
         MissingNodes(
             int max,
             SHAMapSyncFilter* filter,
+            NodeStore::FetchPriority priority,
             int maxDefer,
-            std::uint32_t generation)
+            std::shared_ptr<FullBelowCache> fullBelow)
             : max_(max)
             , filter_(filter)
+            , priority_(priority)
             , maxDefer_(maxDefer)
-            , generation_(generation)
+            , fullBelow_(std::move(fullBelow))
+            , generation_(fullBelow_->getGeneration())
+            , lookahead_(maxDefer)
         {
             missingNodes_.reserve(max);
             deferredReads_.reserve(maxDefer);
@@ -496,6 +700,12 @@ private:
     gmn_ProcessNodes(MissingNodes&, MissingNodes::StackEntry& node);
     void
     gmn_ProcessDeferredReads(MissingNodes&);
+    void
+    gmn_Lookahead(
+        MissingNodes&,
+        std::vector<SHAMapInnerNode*> const& nodes,
+        int hits,
+        std::size_t count);
 };
 
 inline void
@@ -567,8 +777,11 @@ public:
     const_iterator() = delete;
 
     const_iterator(const_iterator const& other) = default;
+    const_iterator(const_iterator&& other) = default;
     const_iterator&
     operator=(const_iterator const& other) = default;
+    const_iterator&
+    operator=(const_iterator&& other) = default;
 
     ~const_iterator() = default;
 
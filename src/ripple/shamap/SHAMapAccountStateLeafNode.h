@@ -21,6 +21,7 @@
 #define RIPPLE_SHAMAP_SHAMAPACCOUNTSTATELEAFNODE_H_INCLUDED
 
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/HugePages.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/digest.h>
 #include <ripple/shamap/SHAMapItem.h>
@@ -54,8 +55,7 @@ public:
     std::shared_ptr<SHAMapTreeNode>
     clone(std::uint32_t cowid) const final override
     {
-        return std::make_shared<SHAMapAccountStateLeafNode>(
-            item_, cowid, hash_);
+        return make_pooled<SHAMapAccountStateLeafNode>(item_, cowid, hash_);
     }
 
     SHAMapNodeType
@@ -68,13 +68,13 @@ public:
     updateHash() final override
     {
         hash_ = SHAMapHash{sha512Half(
-            HashPrefix::leafNode, makeSlice(item_->peekData()), item_->key())};
+            HashPrefix::leafNode, item_->slice(), item_->key())};
     }
 
     void
     serializeForWire(Serializer& s) const final override
     {
-        s.addRaw(item_->peekData());
+        s.addRaw(item_->slice());
         s.addBitString(item_->key());
         s.add8(wireTypeAccountState);
     }
@@ -83,7 +83,7 @@ public:
     serializeWithPrefix(Serializer& s) const final override
     {
         s.add32(HashPrefix::leafNode);
-        s.addRaw(item_->peekData());
+        s.addRaw(item_->slice());
         s.addBitString(item_->key());
     }
 };
@@ -27,6 +27,7 @@
 #include <ripple/shamap/SHAMapTreeNode.h>
 #include <ripple/shamap/impl/TaggedPointer.h>
 
+#include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <memory>
@@ -53,7 +54,8 @@ private:
     std::uint32_t fullBelowGen_ = 0;
     std::uint16_t isBranch_ = 0;
 
-    static std::mutex childLock;
+    /** A bitlock for the children of this node, with one bit per child */
+    mutable std::atomic<std::uint16_t> lock_ = 0;
 
     /** Convert arrays stored in `hashesAndChildren_` so they can store the
         requested number of children.
@@ -172,6 +174,12 @@ public:
     void
     updateHashDeep();
 
+    /** Refresh the hashes of the children this node holds, without
+        recalculating the hash of this node.
+     */
+    void
+    updateChildHashes();
+
     void
     serializeForWire(Serializer&) const override;
 
@@ -184,6 +192,9 @@ public:
     void
     invariants(bool is_root = false) const override;
 
+    std::size_t
+    footprint() const override;
+
     static std::shared_ptr<SHAMapTreeNode>
     makeFullInner(Slice data, SHAMapHash const& hash, bool hashValid);
 
@@ -28,20 +28,44 @@
 #include <ripple/protocol/Serializer.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 
 namespace ripple {
 
-// an item stored in a SHAMap
+/** An item stored in a SHAMap.
+
+    A ledger's state map holds millions of items, so the data is kept in a
+    buffer of exactly its size. Data built in a Serializer is copied rather
+    than taken over, since a Serializer's buffer is usually much larger
+    than what was written to it.
+*/
 class SHAMapItem : public CountedObject<SHAMapItem>
 {
 private:
     uint256 tag_;
-    Blob data_;
+    std::unique_ptr<std::uint8_t[]> data_;
+    std::uint32_t size_;
+
+    // The bytes accounted for while the item lives
+    std::size_t
+    footprint() const;
+
+    void
+    assign(Slice data);
 
 public:
+    SHAMapItem(uint256 const& tag, Slice data);
     SHAMapItem(uint256 const& tag, Blob const& data);
     SHAMapItem(uint256 const& tag, Serializer const& s);
-    SHAMapItem(uint256 const& tag, Serializer&& s);
+    SHAMapItem(SHAMapItem const& other);
+    SHAMapItem(SHAMapItem&& other) noexcept;
+    ~SHAMapItem();
+
+    SHAMapItem&
+    operator=(SHAMapItem const& other);
+    SHAMapItem&
+    operator=(SHAMapItem&& other) noexcept;
 
     Slice
     slice() const;
@@ -49,9 +73,6 @@ public:
     uint256 const&
     key() const;
 
-    Blob const&
-    peekData() const;
-
     std::size_t
     size() const;
     void const*
@@ -63,19 +84,19 @@ public:
 inline Slice
 SHAMapItem::slice() const
 {
-    return {data_.data(), data_.size()};
+    return {data_.get(), size_};
 }
 
 inline std::size_t
 SHAMapItem::size() const
 {
-    return data_.size();
+    return size_;
 }
 
 inline void const*
 SHAMapItem::data() const
 {
-    return data_.data();
+    return data_.get();
 }
 
 inline uint256 const&
@@ -84,12 +105,6 @@ SHAMapItem::key() const
     return tag_;
 }
 
-inline Blob const&
-SHAMapItem::peekData() const
-{
-    return data_;
-}
-
 }  // namespace ripple
 
 #endif
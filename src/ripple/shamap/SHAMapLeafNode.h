@@ -41,6 +41,8 @@ protected:
         SHAMapHash const& hash);
 
 public:
+    ~SHAMapLeafNode();
+
     SHAMapLeafNode(const SHAMapLeafNode&) = delete;
     SHAMapLeafNode&
     operator=(const SHAMapLeafNode&) = delete;
@@ -60,6 +62,12 @@ public:
     void
     invariants(bool is_root = false) const final override;
 
+    std::size_t
+    footprint() const final override
+    {
+        return sizeof(*this) + sizeof(SHAMapItem) + item_->size();
+    }
+
 public:
     std::shared_ptr<SHAMapItem const> const&
     peekItem() const;
@@ -147,6 +147,10 @@ deserializeSHAMapNodeID(std::string const& s)
 [[nodiscard]] unsigned int
 selectBranch(SHAMapNodeID const& id, uint256 const& hash);
 
+/** Returns true if the given hash would be below the node */
+[[nodiscard]] bool
+isBelow(SHAMapNodeID const& id, uint256 const& hash);
+
 }  // namespace ripple
 
 #endif
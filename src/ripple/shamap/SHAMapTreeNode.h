@@ -30,6 +30,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -218,6 +219,14 @@ public:
     virtual void
     updateHash() = 0;
 
+    /** Recalculate the hashes of several nodes.
+
+        The result is the same as calling updateHash() on each node, but the
+        nodes are hashed together with sha512HalfBatch.
+     */
+    static void
+    updateHashes(std::vector<SHAMapTreeNode*> const& nodes);
+
     /** Return the hash of this node. */
     SHAMapHash const&
     getHash() const
@@ -251,6 +260,10 @@ public:
     virtual void
     invariants(bool is_root = false) const = 0;
 
+    /** Estimate the memory held by this node, in bytes. */
+    virtual std::size_t
+    footprint() const = 0;
+
     static std::shared_ptr<SHAMapTreeNode>
     makeFromPrefix(Slice rawNode, SHAMapHash const& hash);
 
@@ -268,6 +281,16 @@ private:
     makeTransactionWithMeta(Slice data, SHAMapHash const& hash, bool hashValid);
 };
 
+template <>
+struct CacheFootprint<SHAMapTreeNode>
+{
+    static std::size_t
+    bytes(SHAMapTreeNode const& node)
+    {
+        return node.footprint();
+    }
+};
+
 }  // namespace ripple
 
 #endif
@@ -21,6 +21,7 @@
 #define RIPPLE_SHAMAP_SHAMAPTXLEAFNODE_H_INCLUDED
 
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/HugePages.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/digest.h>
 #include <ripple/shamap/SHAMapItem.h>
@@ -53,7 +54,7 @@ public:
     std::shared_ptr<SHAMapTreeNode>
     clone(std::uint32_t cowid) const final override
     {
-        return std::make_shared<SHAMapTxLeafNode>(item_, cowid, hash_);
+        return make_pooled<SHAMapTxLeafNode>(item_, cowid, hash_);
     }
 
     SHAMapNodeType
@@ -66,13 +67,13 @@ public:
     updateHash() final override
     {
         hash_ = SHAMapHash{sha512Half(
-            HashPrefix::transactionID, makeSlice(item_->peekData()))};
+            HashPrefix::transactionID, item_->slice())};
     }
 
     void
     serializeForWire(Serializer& s) const final override
     {
-        s.addRaw(item_->peekData());
+        s.addRaw(item_->slice());
         s.add8(wireTypeTransaction);
     }
 
@@ -80,7 +81,7 @@ public:
     serializeWithPrefix(Serializer& s) const final override
     {
         s.add32(HashPrefix::transactionID);
-        s.addRaw(item_->peekData());
+        s.addRaw(item_->slice());
     }
 };
 
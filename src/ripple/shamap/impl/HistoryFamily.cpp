@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/main/Tuning.h>
+#include <ripple/ledger/View.h>
+#include <ripple/overlay/Message.h>
+#include <ripple/overlay/Overlay.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/HistoryFamily.h>
+#include <ripple/shamap/SHAMapMissingNode.h>
+#include <algorithm>
+
+namespace ripple {
+
+HistoryFamily::HistoryFamily(Application& app, CollectorManager& cm)
+    : app_(app)
+    , db_(app.getNodeStore())
+    , j_(app.journal("HistoryFamily"))
+    , fbCache_(std::make_shared<FullBelowCache>(
+          "History family full below cache",
+          stopwatch(),
+          cm.collector(),
+          fullBelowTargetSize,
+          fullBelowExpiration))
+    , tnCache_(std::make_shared<TreeNodeCache>(
+          "History family tree node cache",
+          app.config().LEDGER_FETCH_RPC_HISTORY_CACHE,
+          historyCacheAge,
+          stopwatch(),
+          j_))
+    , ledgers_(
+          "HistoryLedgers",
+          historyLedgerCacheSize,
+          historyCacheAge,
+          stopwatch(),
+          j_)
+{
+}
+
+void
+HistoryFamily::sweep()
+{
+    fbCache_->sweep();
+    tnCache_->sweep();
+    ledgers_.sweep();
+}
+
+void
+HistoryFamily::reset()
+{
+    fbCache_->reset();
+    tnCache_->reset();
+    ledgers_.reset();
+}
+
+std::shared_ptr<NodeObject>
+HistoryFamily::fetchMissing(uint256 const& hash, std::uint32_t ledgerSeq)
+{
+    auto const data =
+        fetch(hash, ledgerSeq, protocol::TMGetObjectByHash::otSTATE_NODE);
+    if (!data)
+        return {};
+    return NodeObject::createObject(hotUNKNOWN, data, makeSlice(*data), hash);
+}
+
+std::shared_ptr<Ledger const>
+HistoryFamily::getLedger(LedgerIndex seq)
+{
+    auto& ledgerMaster = app_.getLedgerMaster();
+    auto const valid = ledgerMaster.getValidatedLedger();
+    if (!valid || seq == 0 || seq >= valid->info().seq)
+        return {};
+
+    std::shared_ptr<Ledger const> ledger;
+    try
+    {
+        auto hash = hashOfSeq(*valid, seq, j_);
+        if (!hash)
+        {
+            // The hashes of older ledgers are kept in the skip list of
+            // every 256th ledger, which may have to be read through too
+            auto const refSeq = getCandidateLedger(seq);
+            if (auto const refHash = hashOfSeq(*valid, refSeq, j_))
+            {
+                auto ref = ledgerMaster.getLedgerByHash(*refHash);
+                if (!ref)
+                    ref = getLedger(*refHash, refSeq);
+                if (ref)
+                    hash = hashOfSeq(*ref, seq, j_);
+            }
+        }
+
+        if (hash)
+            ledger = getLedger(*hash, seq);
+    }
+    catch (SHAMapMissingNode const& e)
+    {
+        JLOG(j_.info()) << "Unable to read ledger " << seq << ": "
+                        << e.what();
+    }
+
+    return ledger;
+}
+
+std::shared_ptr<Ledger const>
+HistoryFamily::getLedger(uint256 const& hash, LedgerIndex seq)
+{
+    if (auto ledger = ledgers_.fetch(hash))
+        return ledger;
+
+    std::shared_ptr<Blob const> data;
+    if (auto const obj = db_.fetchNodeObject(hash, seq))
+    {
+        auto const header = obj->getData();
+        data = std::make_shared<Blob const>(header.begin(), header.end());
+    }
+    else
+        data = fetch(hash, seq, protocol::TMGetObjectByHash::otLEDGER);
+    if (!data)
+        return {};
+
+    auto ledger = std::make_shared<Ledger>(
+        deserializePrefixedHeader(makeSlice(*data)), app_.config(), *this);
+    auto const& info = ledger->info();
+    if (info.hash != hash || info.seq != seq)
+    {
+        JLOG(j_.warn()) << "Bad header for ledger " << seq;
+        return {};
+    }
+
+    ledger->stateMap().setLedgerSeq(seq);
+    ledger->txMap().setLedgerSeq(seq);
+    if (!ledger->stateMap().fetchRoot(SHAMapHash{info.accountHash}, nullptr))
+        return {};
+    if (info.txHash.isNonZero() &&
+        !ledger->txMap().fetchRoot(SHAMapHash{info.txHash}, nullptr))
+        return {};
+    ledger->setImmutable(app_.config());
+    ledger->setValidated();
+
+    JLOG(j_.debug()) << "Reading through ledger " << seq;
+
+    std::shared_ptr<Ledger const> result = std::move(ledger);
+    ledgers_.canonicalize_replace_client(hash, result);
+    return result;
+}
+
+std::shared_ptr<Blob const>
+HistoryFamily::fetch(
+    uint256 const& hash,
+    LedgerIndex seq,
+    protocol::TMGetObjectByHash::ObjectType type)
+{
+    std::unique_lock lock(mutex_);
+
+    // Every fetch keeps a job waiting on peers for a while, whether it's
+    // for the header or for a node read later by the request
+    if (active_ >= historyMaxActive)
+    {
+        JLOG(j_.debug()) << "Too busy to fetch " << hash << " of " << seq;
+        return {};
+    }
+    ++active_;
+
+    auto& request = requests_[hash];
+    if (request.waiters++ == 0)
+    {
+        // Ask the peers which have the ledger for the object. Those seen
+        // at the same time wait for the same reply.
+        auto peers = app_.overlay().getActivePeers();
+        peers.erase(
+            std::remove_if(
+                peers.begin(),
+                peers.end(),
+                [seq](auto const& peer) {
+                    return !peer->hasRange(seq, seq);
+                }),
+            peers.end());
+        std::sort(
+            peers.begin(), peers.end(), [](auto const& a, auto const& b) {
+                return a->getScore(true) > b->getScore(true);
+            });
+        if (peers.size() > historyFetchPeers)
+            peers.resize(historyFetchPeers);
+
+        if (peers.empty())
+        {
+            JLOG(j_.debug()) << "No peer has ledger " << seq;
+            requests_.erase(hash);
+            --active_;
+            return {};
+        }
+
+        protocol::TMGetObjectByHash tmBH;
+        tmBH.set_query(true);
+        tmBH.set_type(type);
+        tmBH.set_seq(seq);
+        auto const obj = tmBH.add_objects();
+        obj->set_hash(hash.data(), hash.size());
+        obj->set_ledgerseq(seq);
+        auto const packet =
+            std::make_shared<Message>(tmBH, protocol::mtGET_OBJECTS);
+        for (auto const& peer : peers)
+            peer->send(packet);
+    }
+
+    cv_.wait_for(lock, historyFetchTimeout, [&request] {
+        return request.data != nullptr;
+    });
+
+    auto data = request.data;
+    if (--request.waiters == 0)
+        requests_.erase(hash);
+    --active_;
+    if (!data)
+        JLOG(j_.debug()) << "Timed out fetching " << hash << " of " << seq;
+    return data;
+}
+
+bool
+HistoryFamily::gotObject(uint256 const& hash, Slice data)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto const it = requests_.find(hash);
+        if (it == requests_.end())
+            return false;
+        if (it->second.data)
+            return true;
+    }
+
+    if (sha512Half(data) != hash)
+    {
+        JLOG(j_.warn()) << "Bad data for " << hash;
+        return true;
+    }
+
+    auto blob = std::make_shared<Blob const>(data.begin(), data.end());
+    {
+        std::lock_guard lock(mutex_);
+        auto const it = requests_.find(hash);
+        if (it == requests_.end())
+            return true;
+        it->second.data = std::move(blob);
+    }
+    cv_.notify_all();
+    return true;
+}
+
+}  // namespace ripple
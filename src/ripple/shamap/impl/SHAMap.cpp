@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/HugePages.h>
 #include <ripple/basics/contract.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapAccountStateLeafNode.h>
@@ -24,6 +25,10 @@
 #include <ripple/shamap/SHAMapSyncFilter.h>
 #include <ripple/shamap/SHAMapTxLeafNode.h>
 #include <ripple/shamap/SHAMapTxPlusMetaLeafNode.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace ripple {
 
@@ -34,15 +39,13 @@ makeTypedLeaf(
     std::uint32_t owner)
 {
     if (type == SHAMapNodeType::tnTRANSACTION_NM)
-        return std::make_shared<SHAMapTxLeafNode>(std::move(item), owner);
+        return make_pooled<SHAMapTxLeafNode>(std::move(item), owner);
 
     if (type == SHAMapNodeType::tnTRANSACTION_MD)
-        return std::make_shared<SHAMapTxPlusMetaLeafNode>(
-            std::move(item), owner);
+        return make_pooled<SHAMapTxPlusMetaLeafNode>(std::move(item), owner);
 
     if (type == SHAMapNodeType::tnACCOUNT_STATE)
-        return std::make_shared<SHAMapAccountStateLeafNode>(
-            std::move(item), owner);
+        return make_pooled<SHAMapAccountStateLeafNode>(std::move(item), owner);
 
     LogicError(
         "Attempt to create leaf node of unknown type " +
@@ -53,7 +56,7 @@ makeTypedLeaf(
 SHAMap::SHAMap(SHAMapType t, Family& f)
     : f_(f), journal_(f.journal()), state_(SHAMapState::Modifying), type_(t)
 {
-    root_ = std::make_shared<SHAMapInnerNode>(cowid_);
+    root_ = make_pooled<SHAMapInnerNode>(cowid_);
 }
 
 // The `hash` parameter is unused. It is part of the interface so it's clear
@@ -63,7 +66,7 @@ SHAMap::SHAMap(SHAMapType t, Family& f)
 SHAMap::SHAMap(SHAMapType t, uint256 const& hash, Family& f)
     : f_(f), journal_(f.journal()), state_(SHAMapState::Synching), type_(t)
 {
-    root_ = std::make_shared<SHAMapInnerNode>(cowid_);
+    root_ = make_pooled<SHAMapInnerNode>(cowid_);
 }
 
 std::shared_ptr<SHAMap>
@@ -127,10 +130,16 @@ SHAMap::dirtyUp(
 SHAMapLeafNode*
 SHAMap::walkTowardsKey(uint256 const& id, SharedPtrNodeStack* stack) const
 {
-    assert(stack == nullptr || stack->empty());
     auto inNode = root_;
     SHAMapNodeID nodeID;
 
+    if (stack != nullptr && !stack->empty())
+    {
+        std::tie(inNode, nodeID) = stack->top();
+        stack->pop();
+        assert(inNode->isInner() && isBelow(nodeID, id));
+    }
+
     while (inNode->isInner())
     {
         if (stack != nullptr)
@@ -166,13 +175,17 @@ SHAMap::fetchNodeFromDB(SHAMapHash const& hash) const
 
     if (backed_)
     {
-        if (auto nodeObject =
-                f_.db().fetchNodeObject(hash.as_uint256(), ledgerSeq_))
+        auto nodeObject =
+            f_.db().fetchNodeObject(hash.as_uint256(), ledgerSeq_);
+        if (!nodeObject)
+            nodeObject = f_.fetchMissing(hash.as_uint256(), ledgerSeq_);
+
+        if (nodeObject)
         {
             try
             {
                 node = SHAMapTreeNode::makeFromPrefix(
-                    makeSlice(nodeObject->getData()), hash);
+                    nodeObject->getData(), hash);
                 if (node)
                     canonicalize(hash, node);
             }
@@ -340,6 +353,74 @@ SHAMap::descendNoStore(
     return ret;
 }
 
+void
+SHAMap::prefetchChildren(SHAMapInnerNode& node) const
+{
+    if (!backed_)
+        return;
+
+    std::vector<uint256> hashes;
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        if (node.isEmptyBranch(branch) || node.getChild(branch))
+            continue;
+
+        auto const& childHash = node.getChildHash(branch);
+        if (!cacheLookup(childHash))
+            hashes.push_back(childHash.as_uint256());
+    }
+
+    // A single child gains nothing from a batch
+    if (hashes.size() > 1)
+        f_.db().fetchBatch(hashes, ledgerSeq_);
+}
+
+void
+SHAMap::forEachRootBranch(
+    unsigned int threads,
+    std::function<void(int branch)> const& work) const
+{
+    assert(root_ && root_->isInner());
+    auto const& root = static_cast<SHAMapInnerNode&>(*root_);
+
+    // Workers take the next unclaimed branch when they finish one, so a
+    // thread which drew a small subtree moves on to help with the rest.
+    std::atomic<int> next{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        try
+        {
+            for (int branch = next++; branch < branchFactor; branch = next++)
+            {
+                if (!root.isEmptyBranch(branch))
+                    work(branch);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            if (!error)
+                error = std::current_exception();
+            next = branchFactor;
+        }
+    };
+
+    threads = std::clamp(threads, 1u, branchFactor);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 std::pair<SHAMapTreeNode*, SHAMapNodeID>
 SHAMap::descend(
     SHAMapInnerNode* parent,
@@ -374,6 +455,7 @@ SHAMap::descendAsync(
     SHAMapInnerNode* parent,
     int branch,
     SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority,
     bool& pending) const
 {
     pending = false;
@@ -393,7 +475,8 @@ SHAMap::descendAsync(
         if (!ptr && backed_)
         {
             std::shared_ptr<NodeObject> obj;
-            if (!f_.db().asyncFetch(hash.as_uint256(), ledgerSeq_, obj))
+            if (!f_.db().asyncFetch(
+                    hash.as_uint256(), ledgerSeq_, obj, priority))
             {
                 pending = true;
                 return nullptr;
@@ -402,7 +485,7 @@ SHAMap::descendAsync(
                 return nullptr;
 
             ptr =
-                SHAMapTreeNode::makeFromPrefix(makeSlice(obj->getData()), hash);
+                SHAMapTreeNode::makeFromPrefix(obj->getData(), hash);
             if (ptr && backed_)
                 canonicalize(hash, ptr);
         }
@@ -578,9 +661,21 @@ SHAMap::peekItem(uint256 const& id, SHAMapHash& hash) const
 SHAMap::const_iterator
 SHAMap::upper_bound(uint256 const& id) const
 {
+    return upper_bound(id, end());
+}
+
+SHAMap::const_iterator
+SHAMap::upper_bound(uint256 const& id, const_iterator hint) const
+{
+    assert(hint.map_ == this);
+
     // Get a const_iterator to the next item in the tree after a given item
-    // item need not be in tree
-    SharedPtrNodeStack stack;
+    // item need not be in tree. Keep the nodes of the hint which lead
+    // towards the item, and walk down from the deepest of them.
+    SharedPtrNodeStack stack = std::move(hint.stack_);
+    while (!stack.empty() &&
+           (stack.top().first->isLeaf() || !isBelow(stack.top().second, id)))
+        stack.pop();
     walkTowardsKey(id, &stack);
     while (!stack.empty())
     {
@@ -741,7 +836,7 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
         std::shared_ptr<SHAMapItem const> otherItem = leaf->peekItem();
         assert(otherItem && (tag != otherItem->key()));
 
-        node = std::make_shared<SHAMapInnerNode>(node->cowid());
+        node = make_pooled<SHAMapInnerNode>(node->cowid());
 
         unsigned int b1, b2;
 
@@ -753,7 +848,7 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
             // we need a new inner node, since both go on same branch at this
             // level
             nodeID = nodeID.getChildNodeID(b1);
-            node = std::make_shared<SHAMapInnerNode>(cowid_);
+            node = make_pooled<SHAMapInnerNode>(cowid_);
         }
 
         // we can add the two leaf nodes here
@@ -768,10 +863,170 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
     return true;
 }
 
+bool
+SHAMap::applyChanges(SHAMapNodeType type, std::vector<Change> const& changes)
+{
+    assert(state_ != SHAMapState::Immutable);
+    assert(type != SHAMapNodeType::tnINNER);
+    assert(std::is_sorted(
+        changes.begin(), changes.end(), [](auto const& a, auto const& b) {
+            return a.key < b.key;
+        }));
+
+    if (changes.empty())
+        return true;
+
+    bool ok = true;
+    auto const first = changes.data();
+    applyChanges(
+        type, root_, SHAMapNodeID{}, first, first + changes.size(), ok);
+    return ok;
+}
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMap::applyChanges(
+    SHAMapNodeType type,
+    std::shared_ptr<SHAMapTreeNode> node,
+    SHAMapNodeID const& nodeID,
+    Change const* first,
+    Change const* last,
+    bool& ok)
+{
+    assert(first != last);
+
+    std::shared_ptr<SHAMapInnerNode> inner;
+
+    // A change already made, to leave out below
+    Change const* done = nullptr;
+
+    if (!node)
+    {
+        // Nothing here yet, so only inserts can be made
+        auto const inserts = std::count_if(
+            first, last, [](auto const& c) { return c.insert && c.item; });
+        if (inserts != last - first)
+            ok = false;
+        if (inserts == 0)
+            return nullptr;
+        if (inserts == 1)
+        {
+            auto const it = std::find_if(
+                first, last, [](auto const& c) { return c.insert && c.item; });
+            return makeTypedLeaf(type, it->item, cowid_);
+        }
+        inner = make_pooled<SHAMapInnerNode>(cowid_);
+    }
+    else if (node->isLeaf())
+    {
+        auto leaf = std::static_pointer_cast<SHAMapLeafNode>(node);
+        auto const& key = leaf->peekItem()->key();
+
+        // The change to this leaf's item, if there is one
+        auto const mine = std::lower_bound(
+            first, last, key, [](auto const& c, uint256 const& k) {
+                return c.key < k;
+            });
+        bool const changed = mine != last && mine->key == key;
+
+        if (changed)
+        {
+            if (mine->insert)
+            {
+                ok = false;
+            }
+            else if (!mine->item)
+            {
+                leaf.reset();
+            }
+            else if (leaf->getType() != type)
+            {
+                JLOG(journal_.fatal())
+                    << "SHAMap::applyChanges: cross-type change!";
+                ok = false;
+            }
+            else
+            {
+                leaf = unshareNode(std::move(leaf), nodeID);
+                leaf->setItem(mine->item);
+            }
+        }
+
+        if (last - first == (changed ? 1 : 0))
+            return leaf;
+
+        // Anything else must be an insert, so to insert it split this leaf
+        // into an inner node
+        inner = make_pooled<SHAMapInnerNode>(cowid_);
+        if (leaf)
+            inner->setChild(selectBranch(nodeID, key), leaf);
+        if (changed)
+            done = mine;
+    }
+    else
+    {
+        inner = unshareNode(
+            std::static_pointer_cast<SHAMapInnerNode>(std::move(node)),
+            nodeID);
+    }
+
+    // The changes are sorted, so those below each branch are together
+    while (first != last)
+    {
+        if (first == done)
+        {
+            ++first;
+            continue;
+        }
+
+        auto const branch = selectBranch(nodeID, first->key);
+        auto end = first + 1;
+        while (end != last && end != done &&
+               selectBranch(nodeID, end->key) == branch)
+            ++end;
+
+        std::shared_ptr<SHAMapTreeNode> child;
+        if (!inner->isEmptyBranch(branch))
+            child = descendThrow(inner, branch);
+        inner->setChild(
+            branch,
+            applyChanges(
+                type,
+                std::move(child),
+                nodeID.getChildNodeID(branch),
+                first,
+                end,
+                ok));
+        first = end;
+    }
+
+    if (nodeID.isRoot())
+        return inner;
+
+    // Every child is now empty, a leaf, or an inner node with at least two
+    // items below it, so only a lone leaf needs pulling up.
+    auto const count = inner->getBranchCount();
+    if (count == 0)
+        return nullptr;
+    if (count == 1)
+    {
+        for (int i = 0; i < branchFactor; ++i)
+        {
+            if (!inner->isEmptyBranch(i))
+            {
+                auto child = descendThrow(inner, i);
+                if (child->isLeaf())
+                    return child;
+                break;
+            }
+        }
+    }
+    return inner;
+}
+
 bool
 SHAMap::addItem(SHAMapNodeType type, SHAMapItem&& i)
 {
-    return addGiveItem(type, std::make_shared<SHAMapItem const>(std::move(i)));
+    return addGiveItem(type, make_pooled<SHAMapItem const>(std::move(i)));
 }
 
 SHAMapHash
@@ -873,7 +1128,10 @@ SHAMap::fetchRoot(SHAMapHash const& hash, SHAMapSyncFilter* filter)
           first call SHAMapTreeNode::unshare().
  */
 std::shared_ptr<SHAMapTreeNode>
-SHAMap::writeNode(NodeObjectType t, std::shared_ptr<SHAMapTreeNode> node) const
+SHAMap::writeNode(
+    NodeObjectType t,
+    std::shared_ptr<SHAMapTreeNode> node,
+    PendingNodes* pending) const
 {
     assert(node->cowid() == 0);
     assert(backed_);
@@ -882,11 +1140,56 @@ SHAMap::writeNode(NodeObjectType t, std::shared_ptr<SHAMapTreeNode> node) const
 
     Serializer s;
     node->serializeWithPrefix(s);
-    f_.db().store(
-        t, std::move(s.modData()), node->getHash().as_uint256(), ledgerSeq_);
+    if (pending)
+        pending->push_back(
+            {t, std::move(s.modData()), node->getHash().as_uint256()});
+    else
+        f_.db().store(
+            t,
+            std::move(s.modData()),
+            node->getHash().as_uint256(),
+            ledgerSeq_);
     return node;
 }
 
+int
+SHAMap::flushChildren(
+    SHAMapInnerNode& node,
+    DirtyChildren& children,
+    bool doWrite,
+    NodeObjectType t,
+    PendingNodes* pending) const
+{
+    if (children.empty())
+        return 0;
+
+    std::vector<SHAMapTreeNode*> nodes;
+    nodes.reserve(children.size());
+    for (auto& [branch, child] : children)
+    {
+        if (child->isInner())
+            static_cast<SHAMapInnerNode&>(*child).updateChildHashes();
+        nodes.push_back(child.get());
+    }
+
+    SHAMapTreeNode::updateHashes(nodes);
+
+    for (auto& [branch, child] : children)
+    {
+        // This node can now be shared
+        child->unshare();
+
+        if (doWrite)
+            child = writeNode(t, std::move(child), pending);
+
+        node.shareChild(branch, child);
+    }
+
+    auto const flushed = static_cast<int>(children.size());
+    children.clear();
+    return flushed;
+}
+
 // We can't modify an inner node someone else might have a
 // pointer to because flushing modifies inner nodes -- it
 // makes them point to canonical/shared nodes.
@@ -911,18 +1214,31 @@ int
 SHAMap::unshare()
 {
     // Don't share nodes with parent map
-    return walkSubTree(false, hotUNKNOWN);
+    return walkSubTree(false, hotUNKNOWN, nullptr);
 }
 
 int
 SHAMap::flushDirty(NodeObjectType t)
 {
     // We only write back if this map is backed.
-    return walkSubTree(backed_, t);
+    return walkSubTree(backed_, t, nullptr);
+}
+
+int
+SHAMap::flushDirty(NodeObjectType t, PendingNodes& pending)
+{
+    return walkSubTree(backed_, t, &pending);
+}
+
+void
+SHAMap::storePending(PendingNodes&& pending) const
+{
+    for (auto& node : pending)
+        f_.db().store(node.type, std::move(node.data), node.hash, ledgerSeq_);
 }
 
 int
-SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
+SHAMap::walkSubTree(bool doWrite, NodeObjectType t, PendingNodes* pending)
 {
     assert(!doWrite || backed_);
 
@@ -938,7 +1254,7 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         root_->unshare();
 
         if (doWrite)
-            root_ = writeNode(t, std::move(root_));
+            root_ = writeNode(t, std::move(root_), pending);
 
         return 1;
     }
@@ -947,19 +1263,29 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
 
     if (node->isEmpty())
     {  // replace empty root with a new empty root
-        root_ = std::make_shared<SHAMapInnerNode>(0);
+        root_ = make_pooled<SHAMapInnerNode>(0);
         return 1;
     }
 
-    // Stack of {parent,index,child} pointers representing
-    // inner nodes we are in the process of flushing
-    using StackEntry = std::pair<std::shared_ptr<SHAMapInnerNode>, int>;
+    // Stack of {parent,index,dirty children} representing inner
+    // nodes we are in the process of flushing
+    struct StackEntry
+    {
+        std::shared_ptr<SHAMapInnerNode> node;
+        int branch;
+        DirtyChildren dirty;
+    };
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
     node = preFlushNode(std::move(node));
 
     int pos = 0;
 
+    // The children of the current node which need to be flushed. They are
+    // hashed together once all of them are known, and inner nodes wait
+    // for their parent so that siblings are hashed in the same batch.
+    DirtyChildren dirty;
+
     // We can't flush an inner node until we flush its children
     while (1)
     {
@@ -986,7 +1312,8 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
                     {
                         // save our place and work on this node
 
-                        stack.emplace(std::move(node), branch);
+                        stack.push({std::move(node), branch, std::move(dirty)});
+                        dirty.clear();
                         // The semantics of this changes when we move to c++-20
                         // Right now no move will occur; With c++-20 child will
                         // be moved from.
@@ -996,50 +1323,46 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
                     }
                     else
                     {
-                        // flush this leaf
-                        ++flushed;
-
+                        // flush this leaf with its siblings
                         assert(node->cowid() == cowid_);
-                        child->updateHash();
-                        child->unshare();
-
-                        if (doWrite)
-                            child = writeNode(t, std::move(child));
-
-                        node->shareChild(branch, child);
+                        dirty.emplace_back(branch, std::move(child));
                     }
                 }
             }
         }
 
-        // update the hash of this inner node
-        node->updateHashDeep();
-
-        // This inner node can now be shared
-        node->unshare();
-
-        if (doWrite)
-            node = std::static_pointer_cast<SHAMapInnerNode>(
-                writeNode(t, std::move(node)));
-
-        ++flushed;
+        // All of this node's children are ready to be hashed
+        flushed += flushChildren(*node, dirty, doWrite, t, pending);
 
         if (stack.empty())
             break;
 
-        auto parent = std::move(stack.top().first);
-        pos = stack.top().second;
+        // Hand this inner node to its parent, which flushes it
+        // once the parent's remaining children are done
+        auto entry = std::move(stack.top());
         stack.pop();
 
-        // Hook this inner node to its parent
-        assert(parent->cowid() == cowid_);
-        parent->shareChild(pos, node);
+        assert(entry.node->cowid() == cowid_);
+        dirty = std::move(entry.dirty);
+        dirty.emplace_back(entry.branch, std::move(node));
 
         // Continue with parent's next child, if any
-        node = std::move(parent);
-        ++pos;
+        node = std::move(entry.node);
+        pos = entry.branch + 1;
     }
 
+    // update the hash of the root
+    node->updateHashDeep();
+
+    // The root can now be shared
+    node->unshare();
+
+    if (doWrite)
+        node = std::static_pointer_cast<SHAMapInnerNode>(
+            writeNode(t, std::move(node), pending));
+
+    ++flushed;
+
     // Last inner node is the new root_
     root_ = std::move(node);
 
@@ -19,6 +19,8 @@
 
 #include <ripple/basics/contract.h>
 #include <ripple/shamap/SHAMap.h>
+#include <functional>
+#include <mutex>
 
 namespace ripple {
 
@@ -78,7 +80,7 @@ SHAMap::walkBranch(
                 if (--maxCount <= 0)
                     return false;
             }
-            else if (item->peekData() != otherMapItem->peekData())
+            else if (item->slice() != otherMapItem->slice())
             {
                 // non-matching items with same tag
                 if (isFirstMap)
@@ -156,8 +158,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
             auto other = static_cast<SHAMapLeafNode*>(otherNode);
             if (ours->peekItem()->key() == other->peekItem()->key())
             {
-                if (ours->peekItem()->peekData() !=
-                    other->peekItem()->peekData())
+                if (ours->peekItem()->slice() != other->peekItem()->slice())
                 {
                     differences.insert(std::make_pair(
                         ours->peekItem()->key(),
@@ -245,6 +246,68 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
     return true;
 }
 
+bool
+SHAMap::getDeltaNodes(
+    SHAMap const& otherMap,
+    std::vector<std::pair<SHAMapNodeID, Blob>>& nodes,
+    std::size_t maxNodes) const
+{
+    // Walk our tree from the root, descending only into branches which
+    // differ from the other tree. Popping each node before pushing its
+    // children puts every node after its parent.
+
+    assert(isValid() && otherMap.isValid());
+
+    if (getHash() == otherMap.getHash())
+        return true;
+
+    using StackEntry =
+        std::tuple<SHAMapTreeNode*, SHAMapNodeID, SHAMapTreeNode*>;
+    std::stack<StackEntry, std::vector<StackEntry>> nodeStack;
+    nodeStack.emplace(root_.get(), SHAMapNodeID{}, otherMap.root_.get());
+
+    while (!nodeStack.empty())
+    {
+        auto [ourNode, nodeID, otherNode] = nodeStack.top();
+        nodeStack.pop();
+
+        if (nodes.size() >= maxNodes)
+            return false;
+
+        Serializer s;
+        ourNode->serializeForWire(s);
+        nodes.emplace_back(nodeID, std::move(s.modData()));
+
+        if (!ourNode->isInner())
+            continue;
+
+        auto ours = static_cast<SHAMapInnerNode*>(ourNode);
+        auto other = (otherNode && otherNode->isInner())
+            ? static_cast<SHAMapInnerNode*>(otherNode)
+            : nullptr;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            if (ours->isEmptyBranch(i))
+                continue;
+
+            bool const otherHas = other && !other->isEmptyBranch(i);
+            if (otherHas && ours->getChildHash(i) == other->getChildHash(i))
+                continue;
+
+            auto const child = descendThrow(ours, i);
+            nodeStack.emplace(
+                child,
+                nodeID.getChildNodeID(i),
+                (otherHas && child->isInner())
+                    ? otherMap.descendThrow(other, i)
+                    : nullptr);
+        }
+    }
+
+    return true;
+}
+
 void
 SHAMap::walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
     const
@@ -287,4 +350,83 @@ SHAMap::walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
     }
 }
 
+void
+SHAMap::walkMapParallel(
+    std::vector<SHAMapMissingNode>& missingNodes,
+    int maxMissing,
+    unsigned int threads) const
+{
+    if (!root_->isInner())  // root_ is only node, and we have it
+        return;
+
+    auto const root = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    prefetchChildren(*root);
+
+    // Subtrees found complete are remembered in the full below cache, so
+    // walking the next ledger skips the parts it shares with this one.
+    auto const fullBelow =
+        backed_ ? f_.getFullBelowCache(ledgerSeq_) : nullptr;
+
+    std::atomic<int> remaining{maxMissing};
+    std::mutex mutex;
+
+    forEachRootBranch(threads, [&](int branch) {
+        std::vector<SHAMapMissingNode> missing;
+
+        // Walk the subtree at a branch of an inner node. Returns true if
+        // nothing in it is missing.
+        std::function<bool(SHAMapInnerNode&, int)> walk =
+            [&](SHAMapInnerNode& node, int i) {
+                auto const& childHash = node.getChildHash(i);
+                if (fullBelow &&
+                    fullBelow->touch_if_exists(childHash.as_uint256()))
+                    return true;
+
+                std::shared_ptr<SHAMapTreeNode> child = node.getChild(i);
+                if (!child && backed_)
+                    child = fetchNodeNT(childHash);
+
+                if (!child)
+                {
+                    missing.emplace_back(type_, childHash);
+                    --remaining;
+                    return false;
+                }
+
+                if (!child->isInner())
+                    return true;
+
+                auto& inner = static_cast<SHAMapInnerNode&>(*child);
+                prefetchChildren(inner);
+
+                bool complete = true;
+                for (int j = 0; j < 16; ++j)
+                {
+                    if (remaining <= 0)
+                        return false;
+                    if (!inner.isEmptyBranch(j) && !walk(inner, j))
+                        complete = false;
+                }
+
+                if (complete && fullBelow)
+                    fullBelow->insert(childHash.as_uint256());
+                return complete;
+            };
+
+        if (remaining > 0)
+            walk(*root, branch);
+
+        if (!missing.empty())
+        {
+            std::lock_guard lock(mutex);
+            for (auto& m : missing)
+            {
+                if (missingNodes.size() >= static_cast<std::size_t>(maxMissing))
+                    break;
+                missingNodes.push_back(std::move(m));
+            }
+        }
+    });
+}
+
 }  // namespace ripple
@@ -20,10 +20,13 @@
 #include <ripple/shamap/SHAMapInnerNode.h>
 
 #include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/HugePages.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
+#include <ripple/basics/spinlock.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/digest.h>
@@ -40,16 +43,18 @@
 
 namespace ripple {
 
-std::mutex SHAMapInnerNode::childLock;
-
 SHAMapInnerNode::SHAMapInnerNode(
     std::uint32_t cowid,
     std::uint8_t numAllocatedChildren)
     : SHAMapTreeNode(cowid), hashesAndChildren_(numAllocatedChildren)
 {
+    MemoryUsage::allocate(MemoryTag::shamap, sizeof(SHAMapInnerNode));
 }
 
-SHAMapInnerNode::~SHAMapInnerNode() = default;
+SHAMapInnerNode::~SHAMapInnerNode()
+{
+    MemoryUsage::deallocate(MemoryTag::shamap, sizeof(SHAMapInnerNode));
+}
 
 template <class F>
 void
@@ -83,7 +88,7 @@ SHAMapInnerNode::clone(std::uint32_t cowid) const
 {
     auto const branchCount = getBranchCount();
     auto const thisIsSparse = !hashesAndChildren_.isDense();
-    auto p = std::make_shared<SHAMapInnerNode>(cowid, branchCount);
+    auto p = make_pooled<SHAMapInnerNode>(cowid, branchCount);
     p->hash_ = hash_;
     p->isBranch_ = isBranch_;
     p->fullBelowGen_ = fullBelowGen_;
@@ -108,7 +113,9 @@ SHAMapInnerNode::clone(std::uint32_t cowid) const
             cloneHashes[branchNum] = thisHashes[indexNum];
         });
     }
-    std::lock_guard lock(childLock);
+    spinlock sl(lock_);
+    std::lock_guard lock(sl);
+
     if (thisIsSparse)
     {
         int cloneChildIndex = 0;
@@ -135,7 +142,7 @@ SHAMapInnerNode::makeFullInner(
     if (data.size() != 512)
         Throw<std::runtime_error>("Invalid FI node");
 
-    auto ret = std::make_shared<SHAMapInnerNode>(0, branchFactor);
+    auto ret = make_pooled<SHAMapInnerNode>(0, branchFactor);
 
     Serializer s(data.data(), data.size());
 
@@ -164,7 +171,7 @@ SHAMapInnerNode::makeCompressedInner(Slice data)
 
     int len = s.getLength();
 
-    auto ret = std::make_shared<SHAMapInnerNode>(0, branchFactor);
+    auto ret = make_pooled<SHAMapInnerNode>(0, branchFactor);
 
     auto retHashes = ret->hashesAndChildren_.getHashes();
     for (int i = 0; i < (len / 33); ++i)
@@ -207,6 +214,13 @@ SHAMapInnerNode::updateHash()
 
 void
 SHAMapInnerNode::updateHashDeep()
+{
+    updateChildHashes();
+    updateHash();
+}
+
+void
+SHAMapInnerNode::updateChildHashes()
 {
     SHAMapHash* hashes;
     std::shared_ptr<SHAMapTreeNode>* children;
@@ -217,7 +231,6 @@ SHAMapInnerNode::updateHashDeep()
         if (children[indexNum] != nullptr)
             hashes[indexNum] = children[indexNum]->getHash();
     });
-    updateHash();
 }
 
 void
@@ -266,6 +279,14 @@ SHAMapInnerNode::getBranchCount() const
     return popcnt16(isBranch_);
 }
 
+std::size_t
+SHAMapInnerNode::footprint() const
+{
+    return sizeof(*this) +
+        hashesAndChildren_.capacity() *
+        (sizeof(SHAMapHash) + sizeof(std::shared_ptr<SHAMapTreeNode>));
+}
+
 std::string
 SHAMapInnerNode::getString(const SHAMapNodeID& id) const
 {
@@ -335,8 +356,11 @@ SHAMapInnerNode::getChildPointer(int branch)
     assert(branch >= 0 && branch < branchFactor);
     assert(!isEmptyBranch(branch));
 
-    std::lock_guard lock(childLock);
-    return hashesAndChildren_.getChildren()[*getChildIndex(branch)].get();
+    auto const index = *getChildIndex(branch);
+
+    packed_spinlock sl(lock_, index);
+    std::lock_guard lock(sl);
+    return hashesAndChildren_.getChildren()[index].get();
 }
 
 std::shared_ptr<SHAMapTreeNode>
@@ -345,8 +369,11 @@ SHAMapInnerNode::getChild(int branch)
     assert(branch >= 0 && branch < branchFactor);
     assert(!isEmptyBranch(branch));
 
-    std::lock_guard lock(childLock);
-    return hashesAndChildren_.getChildren()[*getChildIndex(branch)];
+    auto const index = *getChildIndex(branch);
+
+    packed_spinlock sl(lock_, index);
+    std::lock_guard lock(sl);
+    return hashesAndChildren_.getChildren()[index];
 }
 
 SHAMapHash const&
@@ -371,7 +398,9 @@ SHAMapInnerNode::canonicalizeChild(
     auto [_, hashes, children] = hashesAndChildren_.getHashesAndChildren();
     assert(node->getHash() == hashes[childIndex]);
 
-    std::lock_guard lock(childLock);
+    packed_spinlock sl(lock_, childIndex);
+    std::lock_guard lock(sl);
+
     if (children[childIndex])
     {
         // There is already a node hooked up, return it
@@ -17,26 +17,96 @@
 */
 //==============================================================================
 
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/shamap/SHAMapItem.h>
+#include <cstring>
 
 namespace ripple {
 
-class SHAMap;
+SHAMapItem::SHAMapItem(uint256 const& tag, Slice data) : tag_(tag)
+{
+    assign(data);
+    MemoryUsage::allocate(MemoryTag::shamap, footprint());
+}
 
 SHAMapItem::SHAMapItem(uint256 const& tag, Blob const& data)
-    : tag_(tag), data_(data)
+    : SHAMapItem(tag, makeSlice(data))
+{
+}
+
+SHAMapItem::SHAMapItem(uint256 const& tag, Serializer const& data)
+    : SHAMapItem(tag, data.slice())
+{
+}
+
+SHAMapItem::SHAMapItem(SHAMapItem const& other)
+    : CountedObject<SHAMapItem>(other), tag_(other.tag_)
+{
+    assign(other.slice());
+    MemoryUsage::allocate(MemoryTag::shamap, footprint());
+}
+
+SHAMapItem::SHAMapItem(SHAMapItem&& other) noexcept
+    : CountedObject<SHAMapItem>(other)
+    , tag_(other.tag_)
+    , data_(std::move(other.data_))
+    , size_(other.size_)
+{
+    // The data changes hands, so only the empty item is new
+    other.size_ = 0;
+    MemoryUsage::allocate(MemoryTag::shamap, other.footprint());
+}
+
+SHAMapItem::~SHAMapItem()
+{
+    MemoryUsage::deallocate(MemoryTag::shamap, footprint());
+}
+
+SHAMapItem&
+SHAMapItem::operator=(SHAMapItem const& other)
+{
+    if (this != &other)
+    {
+        MemoryUsage::deallocate(MemoryTag::shamap, footprint());
+        tag_ = other.tag_;
+        assign(other.slice());
+        MemoryUsage::allocate(MemoryTag::shamap, footprint());
+    }
+    return *this;
+}
+
+SHAMapItem&
+SHAMapItem::operator=(SHAMapItem&& other) noexcept
 {
+    if (this != &other)
+    {
+        // Our data is released and other's changes hands
+        MemoryUsage::deallocate(MemoryTag::shamap, size_);
+        tag_ = other.tag_;
+        data_ = std::move(other.data_);
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+    return *this;
 }
 
-SHAMapItem::SHAMapItem(uint256 const& tag, const Serializer& data)
-    : tag_(tag), data_(data.peekData())
+void
+SHAMapItem::assign(Slice data)
 {
+    data_.reset();
+    size_ = static_cast<std::uint32_t>(data.size());
+    if (size_ != 0)
+    {
+        data_.reset(new std::uint8_t[size_]);
+        std::memcpy(data_.get(), data.data(), size_);
+    }
 }
 
-SHAMapItem::SHAMapItem(uint256 const& tag, Serializer&& data)
-    : tag_(tag), data_(std::move(data.modData()))
+std::size_t
+SHAMapItem::footprint() const
 {
+    return sizeof(SHAMapItem) + size_;
 }
 
 }  // namespace ripple
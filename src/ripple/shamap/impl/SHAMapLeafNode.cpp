@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/shamap/SHAMapLeafNode.h>
@@ -28,7 +29,8 @@ SHAMapLeafNode::SHAMapLeafNode(
     std::uint32_t cowid)
     : SHAMapTreeNode(cowid), item_(std::move(item))
 {
-    assert(item_->peekData().size() >= 12);
+    assert(item_->size() >= 12);
+    MemoryUsage::allocate(MemoryTag::shamap, sizeof(SHAMapLeafNode));
 }
 
 SHAMapLeafNode::SHAMapLeafNode(
@@ -37,7 +39,13 @@ SHAMapLeafNode::SHAMapLeafNode(
     SHAMapHash const& hash)
     : SHAMapTreeNode(cowid, hash), item_(std::move(item))
 {
-    assert(item_->peekData().size() >= 12);
+    assert(item_->size() >= 12);
+    MemoryUsage::allocate(MemoryTag::shamap, sizeof(SHAMapLeafNode));
+}
+
+SHAMapLeafNode::~SHAMapLeafNode()
+{
+    MemoryUsage::deallocate(MemoryTag::shamap, sizeof(SHAMapLeafNode));
 }
 
 std::shared_ptr<SHAMapItem const> const&
@@ -132,4 +132,10 @@ selectBranch(SHAMapNodeID const& id, uint256 const& hash)
     return branch;
 }
 
+[[nodiscard]] bool
+isBelow(SHAMapNodeID const& id, uint256 const& hash)
+{
+    return (hash & depthMask(id.getDepth())) == id.getNodeID();
+}
+
 }  // namespace ripple
@@ -46,10 +46,58 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     if (!root_->isInner())
         return;
 
+    std::atomic<bool> const stop{false};
+    visitSubTree(
+        std::static_pointer_cast<SHAMapInnerNode>(root_),
+        function,
+        stop,
+        false);
+}
+
+void
+SHAMap::visitNodesParallel(
+    std::function<bool(SHAMapTreeNode&)> const& function,
+    unsigned int threads) const
+{
+    if (!root_)
+        return;
+
+    if (!function(*root_) || !root_->isInner())
+        return;
+
+    auto const root = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    prefetchChildren(*root);
+
+    std::atomic<bool> stop{false};
+    forEachRootBranch(threads, [&](int branch) {
+        if (stop)
+            return;
+
+        auto child = descendNoStore(root, branch);
+        if (!function(*child) ||
+            (child->isInner() &&
+             !visitSubTree(
+                 std::static_pointer_cast<SHAMapInnerNode>(std::move(child)),
+                 function,
+                 stop,
+                 true)))
+            stop = true;
+    });
+}
+
+bool
+SHAMap::visitSubTree(
+    std::shared_ptr<SHAMapInnerNode> node,
+    std::function<bool(SHAMapTreeNode&)> const& function,
+    std::atomic<bool> const& stop,
+    bool prefetch) const
+{
     using StackEntry = std::pair<int, std::shared_ptr<SHAMapInnerNode>>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
-    auto node = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    if (prefetch)
+        prefetchChildren(*node);
+
     int pos = 0;
 
     while (1)
@@ -61,8 +109,8 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
             {
                 std::shared_ptr<SHAMapTreeNode> child =
                     descendNoStore(node, pos);
-                if (!function(*child))
-                    return;
+                if (!function(*child) || stop)
+                    return false;
 
                 if (child->isLeaf())
                     ++pos;
@@ -81,6 +129,8 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
                     // descend to the child's first position
                     node = std::static_pointer_cast<SHAMapInnerNode>(child);
                     pos = 0;
+                    if (prefetch)
+                        prefetchChildren(*node);
                 }
             }
             else
@@ -95,6 +145,8 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
         std::tie(pos, node) = stack.top();
         stack.pop();
     }
+
+    return true;
 }
 
 void
@@ -191,14 +243,21 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
             // we already know this child node is missing
             fullBelow = false;
         }
+        else if (auto const child = node->getChildPointer(branch); child &&
+                 (child->isLeaf() ||
+                  static_cast<SHAMapInnerNode*>(child)->isFullBelow(
+                      mn.generation_)))
+        {
+            // A resident child which is complete needs no cache lookup
+        }
         else if (
             !backed_ ||
-            !f_.getFullBelowCache(ledgerSeq_)
-                 ->touch_if_exists(childHash.as_uint256()))
+            !mn.fullBelow_->touch_if_exists(childHash.as_uint256()))
         {
             SHAMapNodeID childID = nodeID.getChildNodeID(branch);
             bool pending = false;
-            auto d = descendAsync(node, branch, mn.filter_, pending);
+            auto d = descendAsync(
+                node, branch, mn.filter_, mn.priority_, pending);
 
             if (!d)
             {
@@ -239,10 +298,7 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
     {  // No partial node encountered below this node
         node->setFullBelowGen(mn.generation_);
         if (backed_)
-        {
-            f_.getFullBelowCache(ledgerSeq_)
-                ->insert(node->getHash().as_uint256());
-        }
+            mn.fullBelow_->insert(node->getHash().as_uint256());
     }
 
     node = nullptr;
@@ -255,7 +311,7 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
 {
     // Wait for our deferred reads to finish
     auto const before = std::chrono::steady_clock::now();
-    f_.db().waitReads();
+    f_.db().waitReads(mn.priority_);
     auto const after = std::chrono::steady_clock::now();
 
     auto const elapsed =
@@ -264,6 +320,7 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
 
     // Process all deferred reads
     int hits = 0;
+    std::vector<SHAMapInnerNode*> arrived;
     for (auto const& deferredNode : mn.deferredReads_)
     {
         auto parent = std::get<0>(deferredNode);
@@ -278,6 +335,9 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
             if (backed_)
                 canonicalize(nodeHash, nodePtr);
             nodePtr = parent->canonicalizeChild(branch, std::move(nodePtr));
+            if (nodePtr->isInner())
+                arrived.push_back(
+                    static_cast<SHAMapInnerNode*>(nodePtr.get()));
 
             // When we finish this stack, we need to restart
             // with the parent of this node
@@ -293,6 +353,8 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
     }
     mn.deferredReads_.clear();
 
+    gmn_Lookahead(mn, arrived, hits, count);
+
     auto const process_time =
         std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - after);
@@ -307,12 +369,63 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
     }
 }
 
+// Start reading the children of inner nodes which just arrived from deferred
+// reads, before the traversal gets to them. Otherwise each level of the tree
+// costs a full round of reads and waiting. By the time the traversal looks
+// at these children their reads have usually finished, and their results
+// are in the node store's caches.
+void
+SHAMap::gmn_Lookahead(
+    MissingNodes& mn,
+    std::vector<SHAMapInnerNode*> const& nodes,
+    int hits,
+    std::size_t count)
+{
+    // Reading ahead only pays while most reads find their nodes. Near the
+    // edge of what is stored locally most children are missing, and each
+    // wasted read delays the ones the traversal is waiting for.
+    if (count != 0)
+    {
+        if (static_cast<std::size_t>(hits) * 4 < count)
+            mn.lookahead_ /= 2;
+        else if (static_cast<std::size_t>(hits) == count)
+            mn.lookahead_ = std::min(mn.maxDefer_, mn.lookahead_ * 2 + 1);
+    }
+
+    int budget = mn.lookahead_;
+    for (auto node : nodes)
+    {
+        for (int branch = 0; branch < branchFactor && budget > 0; ++branch)
+        {
+            if (node->isEmptyBranch(branch) ||
+                node->getChildPointer(branch) != nullptr)
+                continue;
+
+            auto const& childHash = node->getChildHash(branch);
+            if (mn.missingHashes_.count(childHash) != 0 ||
+                mn.fullBelow_->touch_if_exists(childHash.as_uint256()))
+                continue;
+
+            bool pending = false;
+            descendAsync(node, branch, mn.filter_, mn.priority_, pending);
+            if (pending)
+                --budget;
+        }
+
+        if (budget <= 0)
+            break;
+    }
+}
+
 /** Get a list of node IDs and hashes for nodes that are part of this SHAMap
     but not available locally.  The filter can hold alternate sources of
     nodes that are not permanently stored locally
 */
 std::vector<std::pair<SHAMapNodeID, uint256>>
-SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
+SHAMap::getMissingNodes(
+    int max,
+    SHAMapSyncFilter* filter,
+    NodeStore::FetchPriority priority)
 {
     assert(root_->getHash().isNonZero());
     assert(max > 0);
@@ -320,8 +433,9 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
     MissingNodes mn(
         max,
         filter,
+        priority,
         f_.db().getDesiredAsyncReadCount(ledgerSeq_),
-        f_.getFullBelowCache(ledgerSeq_)->getGeneration());
+        f_.getFullBelowCache(ledgerSeq_));
 
     if (!root_->isInner() ||
         std::static_pointer_cast<SHAMapInnerNode>(root_)->isFullBelow(
@@ -519,6 +633,77 @@ SHAMap::getNodeFat(
     return true;
 }
 
+std::vector<uint256>
+SHAMap::getNodeFatReads(SHAMapNodeID const& wanted, std::uint32_t depth)
+    const
+{
+    // Walks the nodes getNodeFat would visit, without waiting for any
+    std::vector<uint256> reads;
+    if (!backed_)
+        return reads;
+
+    auto const descend = [&](SHAMapInnerNode* inner, int branch) {
+        bool pending = false;
+        auto const child = descendAsync(
+            inner, branch, nullptr, NodeStore::FetchPriority::low, pending);
+        if (pending)
+            reads.push_back(inner->getChildHash(branch).as_uint256());
+        return child;
+    };
+
+    SHAMapTreeNode* node = root_.get();
+    SHAMapNodeID nodeID;
+
+    while (node && node->isInner() && (nodeID.getDepth() < wanted.getDepth()))
+    {
+        int branch = selectBranch(nodeID, wanted.getNodeID());
+        auto inner = static_cast<SHAMapInnerNode*>(node);
+        if (inner->isEmptyBranch(branch))
+            return reads;
+
+        node = descend(inner, branch);
+        nodeID = nodeID.getChildNodeID(branch);
+    }
+
+    if (node == nullptr || wanted != nodeID)
+        return reads;
+
+    std::stack<std::tuple<SHAMapTreeNode*, SHAMapNodeID, int>> stack;
+    stack.emplace(node, nodeID, depth);
+
+    while (!stack.empty())
+    {
+        std::tie(node, nodeID, depth) = stack.top();
+        stack.pop();
+
+        if (!node->isInner())
+            continue;
+
+        auto inner = static_cast<SHAMapInnerNode*>(node);
+        int bc = inner->getBranchCount();
+        if ((depth == 0) && (bc != 1))
+            continue;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            if (inner->isEmptyBranch(i))
+                continue;
+
+            auto const childNode = descend(inner, i);
+            if (childNode && childNode->isInner() &&
+                ((depth > 1) || (bc == 1)))
+            {
+                stack.emplace(
+                    childNode,
+                    nodeID.getChildNodeID(i),
+                    (bc > 1) ? (depth - 1) : depth);
+            }
+        }
+    }
+
+    return reads;
+}
+
 void
 SHAMap::serializeRoot(Serializer& s) const
 {
@@ -581,7 +766,8 @@ SHAMap::addKnownNode(
         return SHAMapAddNode::duplicate();
     }
 
-    auto const generation = f_.getFullBelowCache(ledgerSeq_)->getGeneration();
+    auto const fullBelowCache = f_.getFullBelowCache(ledgerSeq_);
+    auto const generation = fullBelowCache->getGeneration();
     auto newNode = SHAMapTreeNode::makeFromWire(rawNode);
     SHAMapNodeID iNodeID;
     auto iNode = root_.get();
@@ -600,8 +786,7 @@ SHAMap::addKnownNode(
         }
 
         auto childHash = inner->getChildHash(branch);
-        if (f_.getFullBelowCache(ledgerSeq_)
-                ->touch_if_exists(childHash.as_uint256()))
+        if (fullBelowCache->touch_if_exists(childHash.as_uint256()))
         {
             return SHAMapAddNode::duplicate();
         }
@@ -696,7 +881,7 @@ SHAMap::deepCompare(SHAMap& other) const
                 static_cast<SHAMapLeafNode*>(otherNode)->peekItem();
             if (nodePeek->key() != otherNodePeek->key())
                 return false;
-            if (nodePeek->peekData() != otherNodePeek->peekData())
+            if (nodePeek->slice() != otherNodePeek->slice())
                 return false;
         }
         else if (node->isInner())
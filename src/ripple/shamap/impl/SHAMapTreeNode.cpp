@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/HugePages.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/contract.h>
@@ -42,16 +43,13 @@ SHAMapTreeNode::makeTransaction(
     SHAMapHash const& hash,
     bool hashValid)
 {
-    // FIXME: using a Serializer results in a copy; avoid it?
-    Serializer s(data.begin(), data.size());
-
-    auto item = std::make_shared<SHAMapItem const>(
-        sha512Half(HashPrefix::transactionID, data), s);
+    auto item = make_pooled<SHAMapItem const>(
+        sha512Half(HashPrefix::transactionID, data), data);
 
     if (hashValid)
-        return std::make_shared<SHAMapTxLeafNode>(std::move(item), 0, hash);
+        return make_pooled<SHAMapTxLeafNode>(std::move(item), 0, hash);
 
-    return std::make_shared<SHAMapTxLeafNode>(std::move(item), 0);
+    return make_pooled<SHAMapTxLeafNode>(std::move(item), 0);
 }
 
 std::shared_ptr<SHAMapTreeNode>
@@ -74,13 +72,12 @@ SHAMapTreeNode::makeTransactionWithMeta(
 
     s.chop(tag.bytes);
 
-    auto item = std::make_shared<SHAMapItem const>(tag, s.peekData());
+    auto item = make_pooled<SHAMapItem const>(tag, s.peekData());
 
     if (hashValid)
-        return std::make_shared<SHAMapTxPlusMetaLeafNode>(
-            std::move(item), 0, hash);
+        return make_pooled<SHAMapTxPlusMetaLeafNode>(std::move(item), 0, hash);
 
-    return std::make_shared<SHAMapTxPlusMetaLeafNode>(std::move(item), 0);
+    return make_pooled<SHAMapTxPlusMetaLeafNode>(std::move(item), 0);
 }
 
 std::shared_ptr<SHAMapTreeNode>
@@ -106,13 +103,13 @@ SHAMapTreeNode::makeAccountState(
     if (tag.isZero())
         Throw<std::runtime_error>("Invalid AS node");
 
-    auto item = std::make_shared<SHAMapItem const>(tag, s.peekData());
+    auto item = make_pooled<SHAMapItem const>(tag, s.peekData());
 
     if (hashValid)
-        return std::make_shared<SHAMapAccountStateLeafNode>(
+        return make_pooled<SHAMapAccountStateLeafNode>(
             std::move(item), 0, hash);
 
-    return std::make_shared<SHAMapAccountStateLeafNode>(std::move(item), 0);
+    return make_pooled<SHAMapAccountStateLeafNode>(std::move(item), 0);
 }
 
 std::shared_ptr<SHAMapTreeNode>
@@ -183,6 +180,49 @@ SHAMapTreeNode::makeFromPrefix(Slice rawNode, SHAMapHash const& hash)
         ")");
 }
 
+void
+SHAMapTreeNode::updateHashes(std::vector<SHAMapTreeNode*> const& nodes)
+{
+    if (nodes.size() == 1)
+    {
+        nodes.front()->updateHash();
+        return;
+    }
+
+    // Serialize every node into one buffer, then hash them all at once.
+    // An empty inner node has a zero hash and cannot be serialized.
+    Serializer s;
+    std::vector<SHAMapTreeNode*> hashed;
+    std::vector<std::size_t> offsets;
+    hashed.reserve(nodes.size());
+    offsets.reserve(nodes.size() + 1);
+
+    for (auto node : nodes)
+    {
+        if (node->isInner() &&
+            static_cast<SHAMapInnerNode const*>(node)->isEmpty())
+        {
+            node->updateHash();
+            continue;
+        }
+
+        offsets.push_back(s.getDataLength());
+        node->serializeWithPrefix(s);
+        hashed.push_back(node);
+    }
+    offsets.push_back(s.getDataLength());
+
+    auto const data = static_cast<std::uint8_t const*>(s.data());
+    std::vector<Slice> messages;
+    messages.reserve(hashed.size());
+    for (std::size_t i = 0; i < hashed.size(); ++i)
+        messages.emplace_back(data + offsets[i], offsets[i + 1] - offsets[i]);
+
+    auto const digests = sha512HalfBatch(messages);
+    for (std::size_t i = 0; i < hashed.size(); ++i)
+        hashed[i]->hash_ = SHAMapHash{digests[i]};
+}
+
 std::string
 SHAMapTreeNode::getString(const SHAMapNodeID& id) const
 {
@@ -19,6 +19,8 @@
 
 #include <ripple/shamap/impl/TaggedPointer.h>
 
+#include <ripple/basics/HugePages.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/shamap/SHAMapInnerNode.h>
 
 #include <array>
@@ -112,7 +114,7 @@ std::array<std::function<void*()>, boundaries.size()> initAllocateArrayFuns(
         boost::singleton_pool<
             boost::fast_pool_allocator_tag,
             arrayChunkSizeBytes[I],
-            boost::default_user_allocator_new_delete,
+            HugePageUserAllocator,
             std::mutex,
             chunksPerBlock[I],
             chunksPerBlock[I]>::malloc...,
@@ -129,7 +131,7 @@ std::array<std::function<void(void*)>, boundaries.size()> initFreeArrayFuns(
         static_cast<void (*)(void*)>(boost::singleton_pool<
                                      boost::fast_pool_allocator_tag,
                                      arrayChunkSizeBytes[I],
-                                     boost::default_user_allocator_new_delete,
+                                     HugePageUserAllocator,
                                      std::mutex,
                                      chunksPerBlock[I],
                                      chunksPerBlock[I]>::free)...,
@@ -146,7 +148,7 @@ std::array<std::function<bool(void*)>, boundaries.size()> initIsFromArrayFuns(
         boost::singleton_pool<
             boost::fast_pool_allocator_tag,
             arrayChunkSizeBytes[I],
-            boost::default_user_allocator_new_delete,
+            HugePageUserAllocator,
             std::mutex,
             chunksPerBlock[I],
             chunksPerBlock[I]>::is_from...,
@@ -161,7 +163,9 @@ std::array<std::function<bool(void*)>, boundaries.size()> const
 allocateArrays(std::uint8_t numChildren)
 {
     auto const i = boundariesIndex(numChildren);
-    return {i, allocateArrayFuns[i]()};
+    auto p = allocateArrayFuns[i]();
+    MemoryUsage::allocate(MemoryTag::shamap, arrayChunkSizeBytes[i]);
+    return {i, p};
 }
 
 // This function takes an untagged pointer
@@ -169,6 +173,8 @@ inline void
 deallocateArrays(std::uint8_t boundaryIndex, void* p)
 {
     assert(isFromArrayFuns[boundaryIndex](p));
+    MemoryUsage::deallocate(
+        MemoryTag::shamap, arrayChunkSizeBytes[boundaryIndex]);
     freeArrayFuns[boundaryIndex](p);
 }
 #else
@@ -178,9 +184,11 @@ std::array<std::pmr::synchronized_pool_resource, boundaries.size()>
     initPmrArrayFuns(std::index_sequence<I...>)
 {
     return std::array<std::pmr::synchronized_pool_resource, boundaries.size()>{
-        std::pmr::synchronized_pool_resource{std::pmr::pool_options{
-            /* max_blocks_per_chunk */ chunksPerBlock[I],
-            /* largest_required_pool_block */ chunksPerBlock[I]}}...,
+        std::pmr::synchronized_pool_resource{
+            std::pmr::pool_options{
+                /* max_blocks_per_chunk */ chunksPerBlock[I],
+                /* largest_required_pool_block */ chunksPerBlock[I]},
+            hugePageResource()}...,
     };
 }
 std::array<std::pmr::synchronized_pool_resource, boundaries.size()>
@@ -192,13 +200,17 @@ std::array<std::pmr::synchronized_pool_resource, boundaries.size()>
 allocateArrays(std::uint8_t numChildren)
 {
     auto const i = boundariesIndex(numChildren);
-    return {i, pmrArrayFuns[i].allocate(arrayChunkSizeBytes[i])};
+    auto p = pmrArrayFuns[i].allocate(arrayChunkSizeBytes[i]);
+    MemoryUsage::allocate(MemoryTag::shamap, arrayChunkSizeBytes[i]);
+    return {i, p};
 }
 
 // This function takes an untagged pointer
 inline void
 deallocateArrays(std::uint8_t boundaryIndex, void* p)
 {
+    MemoryUsage::deallocate(
+        MemoryTag::shamap, arrayChunkSizeBytes[boundaryIndex]);
     return pmrArrayFuns[boundaryIndex].deallocate(
         p, arrayChunkSizeBytes[boundaryIndex]);
 }
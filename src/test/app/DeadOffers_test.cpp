@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/DeadOffers.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class DeadOffers_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase("dead offers");
+
+        using namespace jtx;
+        Env env{*this};
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.trust(USD(1000), alice, bob, carol);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(100)));
+        env(pay(gw, carol, USD(100)));
+        env.close();
+
+        auto const funded = keylet::offer(alice, env.seq(alice));
+        env(offer(alice, XRP(10), USD(10)));
+
+        // bob gives away what his offer sells
+        auto const unfunded = keylet::offer(bob, env.seq(bob));
+        env(offer(bob, XRP(10), USD(10)));
+        env(pay(bob, gw, USD(100)));
+
+        // carol's offer expires before the next ledger closes
+        auto const expiration =
+            env.current()->info().parentCloseTime.time_since_epoch().count();
+        auto const expired = keylet::offer(carol, env.seq(carol));
+        env(offer(carol, XRP(10), USD(10)),
+            json(sfExpiration.fieldName, expiration + 1));
+
+        // An issuer needs no funds to sell its own IOUs
+        auto const issuer = keylet::offer(gw, env.seq(gw));
+        env(offer(gw, XRP(10), USD(10)));
+        env.close();
+        env.close();
+
+        DeadOffers deadOffers(env.closed(), env.journal);
+        auto dead = [&](Keylet const& k) {
+            auto const sle = env.closed()->read(k);
+            if (!BEAST_EXPECT(sle))
+                return false;
+            // Ask twice, so the second answer comes from the cache
+            auto const result = deadOffers.dead(*sle);
+            BEAST_EXPECT(deadOffers.dead(*sle) == result);
+            return result;
+        };
+
+        BEAST_EXPECT(!dead(funded));
+        BEAST_EXPECT(dead(unfunded));
+        BEAST_EXPECT(dead(expired));
+        BEAST_EXPECT(!dead(issuer));
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(DeadOffers, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -1375,6 +1375,114 @@ struct Flow_test : public beast::unit_test::suite
         env.require(balance(alice, XRP(9000) - drops(20)));
     }
 
+    void
+    testSortStrands(FeatureBitset features)
+    {
+        testcase("Sort strands");
+        using namespace jtx;
+
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        auto const carol = Account("carol");
+        auto const dan = Account("dan");
+        auto const erin = Account("erin");
+
+        // The book from XRP to USD is worse than going through EUR, so the
+        // payment takes the EUR strand whether or not strands are sorted.
+        Env env(*this, features);
+        env.fund(XRP(10000), alice, bob, carol, dan, erin, gw);
+        env.trust(USD(1000), bob, carol, erin);
+        env.trust(EUR(1000), dan, erin);
+        env(pay(gw, carol, USD(100)));
+        env(pay(gw, dan, EUR(100)));
+        env(pay(gw, erin, USD(100)));
+        env(offer(carol, XRP(200), USD(100)));
+        env(offer(dan, XRP(100), EUR(100)));
+        env(offer(erin, EUR(100), USD(100)));
+        env.close();
+
+        env(pay(alice, bob, USD(50)),
+            path(~USD),
+            path(~EUR, ~USD),
+            sendmax(XRP(200)));
+        env.close();
+
+        env.require(balance(bob, USD(50)));
+        env.require(balance(alice, XRP(10000) - XRP(50) - drops(10)));
+        BEAST_EXPECT(isOffer(env, carol, XRP(200), USD(100)));
+        BEAST_EXPECT(isOffer(env, dan, XRP(50), EUR(50)));
+        BEAST_EXPECT(isOffer(env, erin, EUR(50), USD(50)));
+    }
+
+    void
+    testDeepBook(FeatureBitset features)
+    {
+        testcase(
+            std::string("Deep book, strands ") +
+            (features[featureFlowSortStrands] ? "sorted" : "unsorted"));
+        using namespace jtx;
+
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        std::vector<IOU> const currencies{
+            gw["EUR"], gw["GBP"], gw["JPY"], gw["CNY"]};
+        auto const USD = gw["USD"];
+
+        // Many market makers, each with offers in every book, so the
+        // payment has a strand through each currency and crosses deep
+        // into the books.
+        Env env(*this, features);
+        env.fund(XRP(100000), alice, bob, gw);
+        env.trust(USD(100000), bob);
+        std::vector<Account> makers;
+        for (int i = 0; i < 50; ++i)
+        {
+            makers.emplace_back("maker" + std::to_string(i));
+            auto const& maker = makers.back();
+            env.fund(XRP(100000), maker);
+            env.trust(USD(100000), maker);
+            env(pay(gw, maker, USD(10000)));
+            for (auto const& iou : currencies)
+            {
+                env.trust(iou(100000), maker);
+                env(pay(gw, maker, iou(10000)));
+            }
+        }
+        env.close();
+
+        for (std::size_t i = 0; i < makers.size(); ++i)
+        {
+            auto const& maker = makers[i];
+            for (auto const& iou : currencies)
+            {
+                env(offer(maker, XRP(100 + i), iou(100)));
+                env(offer(maker, iou(100 + i), USD(100)));
+            }
+            env(offer(maker, XRP(205 + i), USD(100)));
+        }
+        env.close();
+
+        using namespace std::chrono;
+        auto const start = steady_clock::now();
+        env(pay(alice, bob, USD(20000)),
+            path(~USD),
+            path(~currencies[0], ~USD),
+            path(~currencies[1], ~USD),
+            path(~currencies[2], ~USD),
+            path(~currencies[3], ~USD),
+            sendmax(XRP(100000)),
+            txflags(tfPartialPayment));
+        auto const elapsed = steady_clock::now() - start;
+        log << "Deep book payment took "
+            << duration_cast<microseconds>(elapsed).count() << "us"
+            << std::endl;
+        env.require(balance(bob, USD(20000)));
+    }
+
     void
     testWithFeats(FeatureBitset features)
     {
@@ -1411,6 +1519,8 @@ struct Flow_test : public beast::unit_test::suite
         testWithFeats(sa - featureFlowCross);
         testWithFeats(sa);
         testEmptyStrand(sa);
+        testSortStrands(sa);
+        testSortStrands(sa | featureFlowSortStrands);
     }
 };
 
@@ -1431,6 +1541,9 @@ struct Flow_manual_test : public Flow_test
 
         testEmptyStrand(all - f1513);
         testEmptyStrand(all);
+
+        testDeepBook(all);
+        testDeepBook(all | featureFlowSortStrands);
     }
 };
 
@@ -20,6 +20,9 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -223,6 +226,19 @@ class HashRouter_test : public beast::unit_test::suite
         // Confirm that peers list is empty.
         peers = router.shouldRelay(key1);
         BEAST_EXPECT(peers && peers->size() == 0);
+
+        // Many peers, some more than once, in any order
+        ++stopwatch;
+        std::set<HashRouter::PeerShortID> expected;
+        for (HashRouter::PeerShortID i = 0; i < 40; ++i)
+        {
+            auto const peer = (i * 7) % 20 + 1;
+            router.addSuppressionPeer(key1, peer);
+            expected.insert(peer);
+        }
+        router.addSuppressionPeer(key1, 0);
+        peers = router.shouldRelay(key1);
+        BEAST_EXPECT(peers && *peers == expected);
     }
 
     void
@@ -277,6 +293,49 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testPreflight()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2);
+        uint256 const key1(1);
+        uint256 const key2(2);
+        std::unordered_set<uint256, beast::uhash<>> const presets;
+        Rules const rules(presets);
+        auto const result =
+            std::make_pair(NotTEC{temMALFORMED}, TxConsequences{temMALFORMED});
+
+        BEAST_EXPECT(!router.getPreflight(key1, rules, tapNONE));
+        router.setPreflight(key1, rules, tapNONE, result);
+        auto const found = router.getPreflight(key1, rules, tapNONE);
+        BEAST_EXPECT(found && found->first == temMALFORMED);
+
+        // The flags and the transaction must match
+        BEAST_EXPECT(!router.getPreflight(key1, rules, tapRETRY));
+        BEAST_EXPECT(!router.getPreflight(key2, rules, tapNONE));
+
+        // Each set of flags is remembered separately, and remembering
+        // the same flags again replaces the earlier result
+        router.setPreflight(
+            key1,
+            rules,
+            tapRETRY,
+            {NotTEC{temBAD_FEE}, TxConsequences{temBAD_FEE}});
+        router.setPreflight(key1, rules, tapNONE, result);
+        BEAST_EXPECT(
+            router.getPreflight(key1, rules, tapRETRY)->first == temBAD_FEE);
+        BEAST_EXPECT(
+            router.getPreflight(key1, rules, tapNONE)->first == temMALFORMED);
+
+        // The results expire with the entry
+        ++stopwatch;
+        ++stopwatch;
+        ++stopwatch;
+        router.addSuppression(key2);
+        BEAST_EXPECT(!router.getPreflight(key1, rules, tapNONE));
+    }
+
 public:
     void
     run() override
@@ -288,10 +347,64 @@ public:
         testRelay();
         testRecover();
         testProcess();
+        testPreflight();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
 
+// Measures how the table holds up with many peer threads relaying messages
+// at once. Each message is offered by several peers, as it would be on a
+// well connected server, and relayed by the first.
+class HashRouterPerf_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 300s, 2);
+
+        std::size_t const threads =
+            std::max(2u, std::thread::hardware_concurrency());
+        std::uint32_t const messages = 200000;
+        std::uint32_t const peersPerMessage = 4;
+
+        auto const start = steady_clock::now();
+        std::vector<std::thread> workers;
+        std::atomic<std::uint32_t> relays{0};
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (std::uint32_t i = 0; i < messages; ++i)
+                {
+                    // Peers see the messages at different times
+                    auto const n = (i + t * 997) % messages;
+                    auto const key = sha512Half(n % (messages / 2));
+                    int flags = 0;
+                    router.addSuppressionPeer(key, t % peersPerMessage, flags);
+                    if (router.shouldRelay(key))
+                        ++relays;
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        auto const elapsed = steady_clock::now() - start;
+
+        auto const operations = 2 * threads * messages;
+        BEAST_EXPECT(relays == messages / 2);
+        log << threads << " threads made " << operations
+            << " calls in " << duration_cast<milliseconds>(elapsed).count()
+            << "ms ("
+            << duration_cast<nanoseconds>(elapsed).count() / operations
+            << "ns each)" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterPerf, app, ripple);
+
 }  // namespace test
 }  // namespace ripple
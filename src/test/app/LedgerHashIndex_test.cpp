@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+
+namespace ripple {
+namespace test {
+
+class LedgerHashIndex_test : public beast::unit_test::suite
+{
+    static uint256
+    makeHash(LedgerIndex seq)
+    {
+        return sha512Half(seq);
+    }
+
+    void
+    testInsert()
+    {
+        testcase("insert");
+
+        LedgerHashIndex index(4);
+        BEAST_EXPECT(!index.get(1));
+
+        for (LedgerIndex seq = 1000; seq < 1100; ++seq)
+            index.insert(seq, makeHash(seq));
+        BEAST_EXPECT(index.size() == 100);
+        BEAST_EXPECT(index.get(1000) == makeHash(1000));
+        BEAST_EXPECT(index.get(1099) == makeHash(1099));
+        BEAST_EXPECT(!index.get(999));
+        BEAST_EXPECT(!index.get(1100));
+
+        // Replacing a hash doesn't count it again
+        index.insert(1050, makeHash(0));
+        BEAST_EXPECT(index.size() == 100);
+        BEAST_EXPECT(index.get(1050) == makeHash(0));
+
+        // Chunks in between may be left empty
+        LedgerIndex const far = 3 * LedgerHashIndex::chunkSize + 7;
+        index.insert(far, makeHash(far));
+        BEAST_EXPECT(index.size() == 101);
+        BEAST_EXPECT(index.get(far) == makeHash(far));
+        BEAST_EXPECT(!index.get(2 * LedgerHashIndex::chunkSize));
+    }
+
+    void
+    testLimit()
+    {
+        testcase("limit");
+
+        auto constexpr chunkSize = LedgerHashIndex::chunkSize;
+        LedgerHashIndex index(2);
+
+        index.insert(chunkSize + 1, makeHash(1));
+        index.insert(2 * chunkSize + 1, makeHash(2));
+        BEAST_EXPECT(index.size() == 2);
+
+        // A chunk older than the ones kept is not started
+        index.insert(1, makeHash(0));
+        BEAST_EXPECT(!index.get(1));
+        BEAST_EXPECT(index.size() == 2);
+
+        // A newer chunk pushes out the oldest
+        index.insert(3 * chunkSize + 1, makeHash(3));
+        BEAST_EXPECT(index.size() == 2);
+        BEAST_EXPECT(!index.get(chunkSize + 1));
+        BEAST_EXPECT(index.get(2 * chunkSize + 1) == makeHash(2));
+        BEAST_EXPECT(index.get(3 * chunkSize + 1) == makeHash(3));
+
+        // So does one further ahead than all of them
+        index.insert(10 * chunkSize, makeHash(10));
+        BEAST_EXPECT(index.size() == 1);
+        BEAST_EXPECT(!index.get(3 * chunkSize + 1));
+        BEAST_EXPECT(index.get(10 * chunkSize) == makeHash(10));
+
+        // An older chunk within the limit may still be added
+        index.insert(9 * chunkSize, makeHash(9));
+        BEAST_EXPECT(index.size() == 2);
+        BEAST_EXPECT(index.get(9 * chunkSize) == makeHash(9));
+    }
+
+public:
+    void
+    run() override
+    {
+        testInsert();
+        testLimit();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerHashIndex, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/temp_dir.h>
 #include <ripple/protocol/SField.h>
@@ -24,6 +25,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <fstream>
+#include <thread>
 #include <test/jtx.h>
 #include <test/jtx/Env.h>
 
@@ -220,6 +222,38 @@ class LedgerLoad_test : public beast::unit_test::suite
             jrb[jss::ledger][jss::accountState].size());
     }
 
+    void
+    testLazyLoad(SetupData const& sd)
+    {
+        testcase("Lazy load");
+        using namespace test::jtx;
+        using namespace std::chrono_literals;
+
+        // Start without reading the nodes of the ledger. No ledger is
+        // closed, so the network never validates one.
+        Env env(
+            *this,
+            envconfig(
+                [](std::unique_ptr<Config> cfg, std::string const& dbPath) {
+                    cfg = ledgerConfig(
+                        std::move(cfg), dbPath, "latest", Config::LOAD);
+                    cfg->LAZY_LEDGER_LOAD = true;
+                    return cfg;
+                },
+                sd.dbPath));
+
+        // The background check still finishes
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        for (int i = 0; i < 100 && !ledgerMaster.isLedgerCleanerIdle(); ++i)
+            std::this_thread::sleep_for(100ms);
+        BEAST_EXPECT(ledgerMaster.isLedgerCleanerIdle());
+
+        auto jrb = env.rpc("ledger", "current", "full")[jss::result];
+        BEAST_EXPECT(
+            sd.ledger[jss::ledger][jss::accountState].size() ==
+            jrb[jss::ledger][jss::accountState].size());
+    }
+
 public:
     void
     run() override
@@ -233,6 +267,7 @@ public:
         testLoadByHash(sd);
         testLoadLatest(sd);
         testLoadIndex(sd);
+        testLazyLoad(sd);
     }
 };
 
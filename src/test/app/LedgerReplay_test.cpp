@@ -20,7 +20,9 @@
 #include <ripple/app/ledger/BuildLedger.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/ledger/ReplayBenchmark.h>
 #include <test/jtx.h>
+#include <sstream>
 
 namespace ripple {
 namespace test {
@@ -28,7 +30,7 @@ namespace test {
 struct LedgerReplay_test : public beast::unit_test::suite
 {
     void
-    run() override
+    testReplay()
     {
         testcase("Replay ledger");
 
@@ -55,6 +57,55 @@ struct LedgerReplay_test : public beast::unit_test::suite
 
         BEAST_EXPECT(replayed->info().hash == lastClosed->info().hash);
     }
+
+    void
+    testBenchmark()
+    {
+        testcase("Replay benchmark");
+
+        using namespace jtx;
+
+        BEAST_EXPECT(!parseLedgerRange(""));
+        BEAST_EXPECT(!parseLedgerRange("5"));
+        BEAST_EXPECT(!parseLedgerRange("1-5"));
+        BEAST_EXPECT(!parseLedgerRange("6-5"));
+        BEAST_EXPECT(!parseLedgerRange("2-x"));
+        auto const range = parseLedgerRange("2-5");
+        BEAST_EXPECT(range && range->first == 2 && range->second == 5);
+
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+
+        Env env(*this);
+        auto const first = env.closed()->info().seq + 1;
+        env.fund(XRP(100000), alice, bob);
+        env.close();
+        env(pay(alice, bob, XRP(100)));
+        env(noop(bob));
+        env.close();
+        env(pay(bob, alice, XRP(10)));
+        env.close();
+        auto const last = env.closed()->info().seq;
+
+        std::stringstream report;
+        BEAST_EXPECT(replayBenchmark(env.app(), first, last, report));
+        auto const text = report.str();
+        BEAST_EXPECT(text.find("HASH MISMATCH") == std::string::npos);
+        BEAST_EXPECT(text.find("Payment") != std::string::npos);
+        BEAST_EXPECT(text.find("AccountSet") != std::string::npos);
+
+        // A ledger which doesn't exist yet can't be replayed
+        report.str("");
+        BEAST_EXPECT(!replayBenchmark(env.app(), first, last + 5, report));
+        BEAST_EXPECT(report.str().find("not found") != std::string::npos);
+    }
+
+    void
+    run() override
+    {
+        testReplay();
+        testBenchmark();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(LedgerReplay, app, ripple);
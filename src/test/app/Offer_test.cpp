@@ -985,6 +985,54 @@ public:
             balance("eve", reserve(env, 1) + xrpOffer), owners("eve", 1));
     }
 
+    void
+    testStaleOfferNotCrossed(FeatureBitset features)
+    {
+        testcase("Stale Offers Kept When Not Crossing");
+
+        // An offer which can't cross the best offer in the book leaves the
+        // book alone, even when that offer is unfunded. One which can cross
+        // it removes it.
+        using namespace jtx;
+
+        auto const gw = Account{"gateway"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const carol{"carol"};
+
+        Env env{*this, features};
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.trust(USD(1000), alice, bob, carol);
+        env.trust(EUR(1000), alice, bob, carol);
+        env(pay(gw, carol, USD(100)));
+        env(pay(gw, bob, EUR(100)));
+        env.close();
+
+        env(offer(carol, XRP(100), USD(100)));
+        env(offer(carol, EUR(100), XRP(100)));
+        env(pay(carol, gw, USD(100)));
+        env.close();
+
+        // Worse than carol's unfunded offer, directly and bridged
+        env(offer(bob, USD(10), XRP(5)));
+        env(offer(bob, USD(10), EUR(5)));
+        env.close();
+        BEAST_EXPECT(isOffer(env, carol, XRP(100), USD(100)));
+        BEAST_EXPECT(isOffer(env, bob, USD(10), XRP(5)));
+        BEAST_EXPECT(isOffer(env, bob, USD(10), EUR(5)));
+        env.require(owners(bob, 4));
+
+        // Good enough to cross it
+        env(offer(alice, USD(10), XRP(20)));
+        env.close();
+        BEAST_EXPECT(!isOffer(env, carol, XRP(100), USD(100)));
+        BEAST_EXPECT(isOffer(env, carol, EUR(100), XRP(100)));
+        BEAST_EXPECT(isOffer(env, alice, USD(10), XRP(20)));
+    }
+
     void
     testSelfCross(bool use_partner, FeatureBitset features)
     {
@@ -5419,6 +5467,7 @@ public:
         testMalformed(features);
         testExpiration(features);
         testUnfundedCross(features);
+        testStaleOfferNotCrossed(features);
         testSelfCross(false, features);
         testSelfCross(true, features);
         testNegativeBalance(features);
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Publishing runs on the job queue, so bring the books up to date
+    // with the last closed ledger directly. Doing it twice is harmless.
+    static void
+    publish(jtx::Env& env)
+    {
+        env.app().getOrderBookDB().setup(env.closed());
+    }
+
+    void
+    testIncremental()
+    {
+        testcase("books follow the ledgers");
+        using namespace jtx;
+
+        Env env{*this};
+        auto& db = env.app().getOrderBookDB();
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(trust(alice, EUR(1000)));
+        env(pay(gw, alice, USD(500)));
+        env(pay(gw, alice, EUR(500)));
+        env.close();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Two qualities in the XRP to USD book, and a USD to XRP book
+        auto const first = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        auto const second = env.seq(alice);
+        env(offer(alice, XRP(100), USD(20)));
+        auto const third = env.seq(alice);
+        env(offer(alice, USD(10), XRP(100)));
+        env.close();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // The book stays while any quality is left
+        env(offer_cancel(alice, first));
+        env.close();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        env(offer_cancel(alice, second));
+        env(offer_cancel(alice, third));
+        env.close();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Books between two issued currencies
+        env(offer(alice, EUR(10), USD(10)));
+        env.close();
+        publish(env);
+        auto const books = db.getBooksByTakerPays(EUR.issue());
+        if (BEAST_EXPECT(books.size() == 1))
+            BEAST_EXPECT(books[0]->book() == Book(EUR.issue(), USD.issue()));
+    }
+
+    void
+    testRebuild()
+    {
+        testcase("rebuild after a gap");
+        using namespace jtx;
+
+        Env env{*this};
+        auto& db = env.app().getOrderBookDB();
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env(trust(alice, USD(1000)));
+        env(pay(gw, alice, USD(500)));
+        env.close();
+        publish(env);
+
+        auto const seq = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        env.close();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // After a gap in the published ledgers the books are rebuilt from
+        // the whole ledger
+        env(offer_cancel(alice, seq));
+        env.close();
+        db.invalidate();
+        publish(env);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testRebuild();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/PathRequests.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
@@ -25,6 +26,7 @@
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/TxFlags.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/Context.h>
@@ -35,6 +37,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
 #include <thread>
 
 namespace ripple {
@@ -1303,6 +1306,130 @@ public:
         BEAST_EXPECT(same(st, stpath(M1, G2), stpath(IPE(G2["HKD"]), G2)));
     }
 
+    void
+    parallel_search()
+    {
+        testcase("parallel search");
+        using namespace jtx;
+
+        // Searching the source currencies in parallel finds the same
+        // alternatives, in the same order, as searching them one at a time.
+        auto search = [this](std::size_t threads) {
+            Env env(*this, envconfig([threads](std::unique_ptr<Config> cfg) {
+                cfg->PATH_SEARCH_THREADS = threads;
+                return cfg;
+            }));
+            auto const gw = Account("gateway");
+            auto const USD = gw["USD"];
+            auto const EUR = gw["EUR"];
+            auto const JPY = gw["JPY"];
+            env.fund(XRP(10000), "alice", "bob", "carol", gw);
+            env.trust(USD(1000), "alice", "bob", "carol");
+            env.trust(EUR(1000), "alice", "carol");
+            env.trust(JPY(1000), "alice", "carol");
+            env(pay(gw, "alice", EUR(100)));
+            env(pay(gw, "alice", JPY(100)));
+            env(pay(gw, "carol", USD(100)));
+            env(offer("carol", EUR(50), USD(50)));
+            env(offer("carol", JPY(50), USD(50)));
+            env(offer("carol", XRP(50), USD(50)));
+            env.close();
+
+            auto const result = find_paths_request(
+                env, "alice", "bob", Account("bob")["USD"](10));
+            return result[jss::alternatives];
+        };
+
+        auto const serial = search(1);
+        BEAST_EXPECT(serial.size() == 3);
+        BEAST_EXPECT(search(4) == serial);
+    }
+
+    void
+    shared_search()
+    {
+        testcase("shared search");
+        using namespace jtx;
+
+        Env env(*this);
+        env.fund(XRP(10000), "alice", "bob");
+        env.close();
+
+        auto& requests = env.app().getPathRequests();
+        auto const cache = requests.getLineCache(env.closed(), true);
+
+        int searches = 0;
+        auto const search = [&searches]() {
+            ++searches;
+            return std::shared_ptr<Pathfinder>{};
+        };
+        auto const key = sha512Half(std::uint32_t{1});
+
+        // The second request for the same payment reuses the search
+        requests.getPathfinder(cache, key, search);
+        requests.getPathfinder(cache, key, search);
+        BEAST_EXPECT(searches == 1);
+        requests.getPathfinder(cache, sha512Half(std::uint32_t{2}), search);
+        BEAST_EXPECT(searches == 2);
+
+        // Searches on other caches are not shared
+        auto const other = std::make_shared<RippleLineCache>(env.closed());
+        requests.getPathfinder(other, key, search);
+        requests.getPathfinder(other, key, search);
+        BEAST_EXPECT(searches == 4);
+
+        // Replacing the cache forgets the searches
+        env.close();
+        auto const next = requests.getLineCache(env.closed(), true);
+        BEAST_EXPECT(next != cache);
+        requests.getPathfinder(next, key, search);
+        BEAST_EXPECT(searches == 5);
+        requests.getPathfinder(cache, key, search);
+        BEAST_EXPECT(searches == 6);
+    }
+
+    void
+    deadline_search()
+    {
+        testcase("deadline search");
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        // With a deadline, a subscription gets the paths found at each
+        // level before the full reply
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg->PATH_SEARCH_DEADLINE = 1min;
+            return cfg;
+        }));
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(1000), "alice", "bob");
+        env(pay(gw, "alice", USD(100)));
+        env.close();
+
+        auto wsc = makeWSClient(env.app().config());
+        Json::Value params;
+        params[jss::subcommand] = "create";
+        params[jss::source_account] = Account("alice").human();
+        params[jss::destination_account] = Account("bob").human();
+        params[jss::destination_amount] =
+            Account("bob")["USD"](10).value().getJson(JsonOptions::none);
+        auto const jv = wsc->invoke("path_find", params);
+        BEAST_EXPECT(jv[jss::status] == "success");
+
+        BEAST_EXPECT(wsc->findMsg(5s, [](auto const& msg) {
+            return msg[jss::type] == "path_find" &&
+                !msg[jss::full_reply].asBool() &&
+                msg[jss::alternatives].size() == 1;
+        }));
+        BEAST_EXPECT(wsc->findMsg(5s, [](auto const& msg) {
+            return msg[jss::type] == "path_find" &&
+                msg[jss::full_reply].asBool() &&
+                msg[jss::alternatives].size() == 1;
+        }));
+    }
+
     void
     run() override
     {
@@ -1325,6 +1452,9 @@ public:
         trust_auto_clear_trust_normal_clear();
         trust_auto_clear_trust_auto_clear();
         xrp_to_xrp();
+        parallel_search();
+        shared_search();
+        deadline_search();
 
         // The following path_find_NN tests are data driven tests
         // that were originally implemented in js/coffee and migrated
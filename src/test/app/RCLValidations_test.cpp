@@ -55,6 +55,62 @@ class RCLValidations_test : public beast::unit_test::suite
         BEAST_EXPECT(!rcv.trusted());
     }
 
+    void
+    testCompactForm()
+    {
+        testcase("Compact retained form");
+        auto keys = randomKeyPair(KeyType::secp256k1);
+        auto const nodeID = calcNodeID(keys.first);
+        auto const ledgerHash = sha512Half(std::uint32_t{123456});
+        auto v = std::make_shared<STValidation>(
+            NetClock::time_point{NetClock::duration{1000}},
+            keys.first,
+            keys.second,
+            nodeID,
+            [&](STValidation& v) {
+                v.setFieldH256(sfLedgerHash, ledgerHash);
+                v.setFieldU32(sfLedgerSequence, 123456);
+                v.setFieldU64(sfCookie, 42);
+                v.setFieldU32(sfLoadFee, 512);
+                v.setFlag(vfFullValidation);
+            });
+        v->setSeen(NetClock::time_point{NetClock::duration{1001}});
+        v->setUntrusted();
+
+        auto const check = [&](RCLValidation const& rcv) {
+            BEAST_EXPECT(rcv.ledgerID() == ledgerHash);
+            BEAST_EXPECT(rcv.seq() == 123456);
+            BEAST_EXPECT(rcv.signTime() == v->getSignTime());
+            BEAST_EXPECT(rcv.seenTime() == v->getSeenTime());
+            BEAST_EXPECT(rcv.key() == keys.first);
+            BEAST_EXPECT(rcv.nodeID() == nodeID);
+            BEAST_EXPECT(rcv.full());
+            BEAST_EXPECT(rcv.loadFee() == 512u);
+            BEAST_EXPECT(rcv.cookie() == 42);
+        };
+
+        // An untrusted validation doesn't keep the STValidation, but the
+        // same one can be rebuilt
+        RCLValidation rcv{v};
+        check(rcv);
+        BEAST_EXPECT(rcv.unwrap() != v);
+        BEAST_EXPECT(rcv.unwrap()->getSerialized() == v->getSerialized());
+
+        // Once trusted, it is kept
+        rcv.setTrusted();
+        check(rcv);
+        auto const trusted = rcv.unwrap();
+        BEAST_EXPECT(trusted->isTrusted());
+        BEAST_EXPECT(trusted->getNodeID() == nodeID);
+        BEAST_EXPECT(trusted->getSeenTime() == v->getSeenTime());
+        BEAST_EXPECT(trusted->getSerialized() == v->getSerialized());
+        BEAST_EXPECT(rcv.unwrap() == trusted);
+
+        rcv.setUntrusted();
+        check(rcv);
+        BEAST_EXPECT(!rcv.unwrap()->isTrusted());
+    }
+
     void
     testRCLValidatedLedger()
     {
@@ -323,6 +379,7 @@ public:
     run() override
     {
         testChangeTrusted();
+        testCompactForm();
         testRCLValidatedLedger();
         testLedgerTrieRCLValidatedLedger();
     }
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/RecoveryCheckpoint.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/protocol/digest.h>
+
+namespace ripple {
+namespace test {
+
+class RecoveryCheckpoint_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase("save and load");
+
+        beast::temp_dir dir;
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir.path();
+        DatabaseCon walletDB(
+            setup, WalletDBName, std::array<char const*, 0>(), WalletDBInit);
+
+        // Nothing stored yet
+        BEAST_EXPECT(!getRecoveryCheckpoint(walletDB));
+
+        RecoveryCheckpoint cp;
+        cp.minSeq = 32570;
+        cp.maxSeq = 61234567;
+        cp.maxHash = sha512Half(cp.maxSeq);
+        setRecoveryCheckpoint(walletDB, cp);
+
+        auto loaded = getRecoveryCheckpoint(walletDB);
+        if (!BEAST_EXPECT(loaded))
+            return;
+        BEAST_EXPECT(loaded->minSeq == cp.minSeq);
+        BEAST_EXPECT(loaded->maxSeq == cp.maxSeq);
+        BEAST_EXPECT(loaded->maxHash == cp.maxHash);
+        BEAST_EXPECT(!loaded->clean);
+
+        // A new checkpoint replaces the old one
+        cp.maxSeq += 256;
+        cp.maxHash = sha512Half(cp.maxSeq);
+        cp.clean = true;
+        setRecoveryCheckpoint(walletDB, cp);
+
+        loaded = getRecoveryCheckpoint(walletDB);
+        if (!BEAST_EXPECT(loaded))
+            return;
+        BEAST_EXPECT(loaded->maxSeq == cp.maxSeq);
+        BEAST_EXPECT(loaded->maxHash == cp.maxHash);
+        BEAST_EXPECT(loaded->clean);
+
+        auto db = walletDB.checkoutDb();
+        int count = 0;
+        *db << "SELECT COUNT(*) FROM RecoveryCheckpoint;", soci::into(count);
+        BEAST_EXPECT(count == 1);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RecoveryCheckpoint, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
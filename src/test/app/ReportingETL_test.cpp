@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/reporting/ReportingETL.h>
+#include <ripple/core/ConfigSections.h>
+#include <test/jtx.h>
+#include <test/rpc/GRPCTestClientBase.h>
+
+namespace ripple {
+namespace test {
+
+class ReportingETL_test : public beast::unit_test::suite
+{
+    class GetLedgerClient : public GRPCTestClientBase
+    {
+    public:
+        org::xrpl::rpc::v1::GetLedgerRequest request;
+        org::xrpl::rpc::v1::GetLedgerResponse reply;
+
+        explicit GetLedgerClient(std::string const& port)
+            : GRPCTestClientBase(port)
+        {
+        }
+
+        void
+        GetLedger()
+        {
+            status = stub_->GetLedger(&context, request, &reply);
+        }
+    };
+
+    void
+    testConfig()
+    {
+        testcase("config");
+
+        std::string const text =
+            "[" SECTION_REPORTING "]\n"
+            "source_ip = 127.0.0.1\n"
+            "source_grpc_port = 50051\n";
+        {
+            Config c;
+            c.loadFromString(text);
+            BEAST_EXPECT(c.reporting());
+        }
+        {
+            Config c;
+            c.loadFromString("");
+            BEAST_EXPECT(!c.reporting());
+        }
+        {
+            // Stand-alone mode has no source to follow
+            Config c;
+            c.setupControl(true, true, true);
+            c.loadFromString(text);
+            BEAST_EXPECT(!c.reporting());
+        }
+    }
+
+    void
+    testBuild()
+    {
+        testcase("build reported ledgers");
+
+        using namespace jtx;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+
+        Account const gw{"gateway"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), gw, alice, bob);
+        env.close();
+        env.trust(USD(1000), alice, bob);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(100), USD(10)));
+        env.close();
+        env(offer(bob, USD(10), XRP(100)));
+        env(noop(bob));
+        env.close();
+
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        auto const last = env.closed()->info().seq;
+        for (auto seq = last - 2; seq <= last; ++seq)
+        {
+            auto const ledger = ledgerMaster.getLedgerBySeq(seq);
+            auto const parent = ledgerMaster.getLedgerBySeq(seq - 1);
+            if (!BEAST_EXPECT(ledger && parent))
+                return;
+
+            GetLedgerClient client(grpcPort);
+            client.request.mutable_ledger()->set_sequence(seq);
+            client.request.set_transactions(true);
+            client.request.set_get_objects(true);
+            client.GetLedger();
+            if (!BEAST_EXPECT(client.status.ok()))
+                return;
+
+            auto const& reply = client.reply;
+            BEAST_EXPECT(reply.validated());
+            BEAST_EXPECT(
+                uint256::fromVoid(reply.ledger_hash().data()) ==
+                ledger->info().hash);
+            BEAST_EXPECT(
+                reply.transactions_size() ==
+                std::distance(ledger->txs.begin(), ledger->txs.end()));
+            auto const delta = getStateDelta(env.app(), ledger);
+            if (!BEAST_EXPECT(delta))
+                return;
+            BEAST_EXPECT(reply.ledger_objects_size() == int(delta->size()));
+
+            auto const built =
+                buildReportedLedger(parent, reply, env.app().config());
+            BEAST_EXPECT(built->info().hash == ledger->info().hash);
+            BEAST_EXPECT(
+                built->info().accountHash == ledger->info().accountHash);
+            BEAST_EXPECT(built->info().txHash == ledger->info().txHash);
+
+            // A report missing a change builds a different ledger
+            auto partial = reply;
+            partial.mutable_ledger_objects()->RemoveLast();
+            try
+            {
+                buildReportedLedger(parent, partial, env.app().config());
+                fail("partial report accepted");
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+
+            // A ledger only builds on its parent
+            try
+            {
+                buildReportedLedger(ledger, reply, env.app().config());
+                fail("report built on the wrong parent");
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+        }
+
+        {
+            // Only closed ledgers can be reported
+            GetLedgerClient client(grpcPort);
+            client.request.mutable_ledger()->set_shortcut(
+                org::xrpl::rpc::v1::LedgerSpecifier::SHORTCUT_CURRENT);
+            client.GetLedger();
+            BEAST_EXPECT(
+                client.status.error_code() ==
+                grpc::StatusCode::INVALID_ARGUMENT);
+        }
+        {
+            GetLedgerClient client(grpcPort);
+            client.request.mutable_ledger()->set_sequence(last + 10);
+            client.GetLedger();
+            BEAST_EXPECT(
+                client.status.error_code() == grpc::StatusCode::NOT_FOUND);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testConfig();
+        testBuild();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ReportingETL, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    // Whether the cached lines match the lines in the ledger, in order
+    bool
+    current(
+        std::vector<RippleState::pointer> const& lines,
+        AccountID const& account,
+        ReadView const& ledger)
+    {
+        auto const expected = getRippleStateItems(account, ledger);
+        if (lines.size() != expected.size())
+            return false;
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            if (lines[i]->key() != expected[i]->key() ||
+                lines[i]->getBalance() != expected[i]->getBalance() ||
+                lines[i]->getLimit() != expected[i]->getLimit())
+                return false;
+        }
+        return true;
+    }
+
+    void
+    testCarryOver()
+    {
+        testcase("carry over");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        auto const carol = Account("carol");
+        env.fund(XRP(10000), alice, bob, carol, gw);
+        env.trust(USD(100), alice, bob);
+        env.close();
+
+        auto const first = std::make_shared<RippleLineCache>(env.closed());
+        BEAST_EXPECT(first->getRippleLines(gw).size() == 2);
+        auto const& aliceLines = first->getRippleLines(alice);
+        BEAST_EXPECT(first->getRippleLines(bob).size() == 1);
+        BEAST_EXPECT(first->size() == 3);
+
+        // Change bob's line and add one for carol, leaving alice's alone
+        env(pay(gw, bob, USD(10)));
+        env.trust(USD(100), carol);
+        env.close();
+
+        auto const second =
+            std::make_shared<RippleLineCache>(env.closed(), first);
+        BEAST_EXPECT(second->size() == 3);
+        BEAST_EXPECT(&second->getRippleLines(alice) == &aliceLines);
+        BEAST_EXPECT(current(second->getRippleLines(gw), gw, *env.closed()));
+        BEAST_EXPECT(current(second->getRippleLines(bob), bob, *env.closed()));
+        BEAST_EXPECT(second->getRippleLines(gw).size() == 3);
+        BEAST_EXPECT(second->size() == 3);
+
+        // Accounts nobody asked for while the ledger was current are
+        // dropped
+        env.close();
+        auto const third =
+            std::make_shared<RippleLineCache>(env.closed(), second);
+        BEAST_EXPECT(third->size() == 3);
+        BEAST_EXPECT(current(third->getRippleLines(gw), gw, *env.closed()));
+
+        env.close();
+        auto const fourth =
+            std::make_shared<RippleLineCache>(env.closed(), third);
+        BEAST_EXPECT(fourth->size() == 1);
+    }
+
+    void
+    testNotParent()
+    {
+        testcase("not the parent ledger");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        env.fund(XRP(10000), alice, gw);
+        env.trust(gw["USD"](100), alice);
+        env.close();
+
+        auto const first = std::make_shared<RippleLineCache>(env.closed());
+        BEAST_EXPECT(first->getRippleLines(gw).size() == 1);
+
+        // Skipping a ledger starts over
+        env.close();
+        env.close();
+        auto const later =
+            std::make_shared<RippleLineCache>(env.closed(), first);
+        BEAST_EXPECT(later->size() == 0);
+
+        // So does an open ledger, whose transactions have no metadata
+        auto const closed = std::make_shared<RippleLineCache>(env.closed());
+        BEAST_EXPECT(closed->getRippleLines(gw).size() == 1);
+        env(pay(gw, alice, gw["USD"](10)));
+        auto const open =
+            std::make_shared<RippleLineCache>(env.current(), closed);
+        BEAST_EXPECT(open->size() == 0);
+    }
+
+    void
+    testLinks()
+    {
+        testcase("links");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        env.fund(XRP(10000), alice, bob, gw);
+        env.trust(gw["USD"](100), alice, bob);
+        env.trust(gw["EUR"](100), alice);
+        env(trust(gw, alice["EUR"](50), tfSetNoRipple));
+        env(pay(gw, alice, gw["USD"](10)));
+        env.close();
+
+        auto const first = std::make_shared<RippleLineCache>(env.closed());
+        auto const& gwLinks = first->getAccountLinks(gw);
+        BEAST_EXPECT(gwLinks.exists());
+        BEAST_EXPECT(gwLinks.links(gw["USD"].currency).size() == 2);
+        BEAST_EXPECT(gwLinks.links(gw["EUR"].currency).size() == 1);
+        BEAST_EXPECT(gwLinks.links(gw["JPY"].currency).empty());
+
+        // The gateway owes alice USD, and can issue EUR to her
+        auto const usd = gwLinks.find(alice, gw["USD"].currency);
+        if (BEAST_EXPECT(usd))
+        {
+            BEAST_EXPECT(!(usd->flags & AccountLinks::positive));
+            BEAST_EXPECT(usd->flags & AccountLinks::peerCredit);
+        }
+        auto const eur = gwLinks.find(alice, gw["EUR"].currency);
+        if (BEAST_EXPECT(eur))
+        {
+            BEAST_EXPECT(eur->flags & AccountLinks::noRipple);
+            BEAST_EXPECT(eur->hasCredit(false));
+        }
+        auto const& aliceLinks = first->getAccountLinks(alice);
+        auto const back = aliceLinks.find(gw, gw["USD"].currency);
+        if (BEAST_EXPECT(back))
+        {
+            BEAST_EXPECT(back->flags & AccountLinks::positive);
+            BEAST_EXPECT(back->hasCredit(true));
+        }
+        BEAST_EXPECT(!first->getAccountLinks(Account("dan")).exists());
+
+        // Links are kept until the account or its lines change
+        env(fset(gw, asfDisallowXRP));
+        env.close();
+        auto const second =
+            std::make_shared<RippleLineCache>(env.closed(), first);
+        BEAST_EXPECT(&second->getAccountLinks(alice) == &aliceLinks);
+        BEAST_EXPECT(!(gwLinks.accountFlags() & lsfDisallowXRP));
+        auto const& changed = second->getAccountLinks(gw);
+        BEAST_EXPECT(&changed != &gwLinks);
+        BEAST_EXPECT(changed.accountFlags() & lsfDisallowXRP);
+    }
+
+public:
+    void
+    run() override
+    {
+        testCarryOver();
+        testNotParent();
+        testLinks();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
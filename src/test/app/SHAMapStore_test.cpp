@@ -164,6 +164,13 @@ class SHAMapStore_test : public beast::unit_test::suite
             soci::into(actualRows);
 
         BEAST_EXPECT(actualRows == rows);
+
+        // The compact index holds the same rows
+        *db << "SELECT count(*) AS rows "
+               "FROM AccountTxIndex;",
+            soci::into(actualRows);
+
+        BEAST_EXPECT(actualRows == rows);
     }
 
     int
@@ -368,6 +375,38 @@ public:
         BEAST_EXPECT(lastRotated != store.getLastRotated());
     }
 
+    void
+    testPacedCopy()
+    {
+        testcase("online_delete with copy_rate");
+        using namespace jtx;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg = onlineDelete(std::move(cfg));
+            cfg->section(ConfigSection::nodeDatabase()).set("copy_rate", "500");
+            return cfg;
+        }));
+        auto& store = env.app().getSHAMapStore();
+
+        auto ledgerSeq = waitForReady(env);
+        auto const lastRotated = ledgerSeq - 1;
+
+        // A paced copy still rotates, only more slowly
+        for (; ledgerSeq < lastRotated + deleteInterval + 1; ++ledgerSeq)
+        {
+            env.close();
+
+            auto ledger = env.rpc("ledger", "validated");
+            BEAST_EXPECT(
+                goodLedger(env, ledger, std::to_string(ledgerSeq), true));
+        }
+
+        store.rendezvous();
+
+        ledgerCheck(env, ledgerSeq - lastRotated, lastRotated);
+        BEAST_EXPECT(lastRotated != store.getLastRotated());
+    }
+
     void
     testCanDelete()
     {
@@ -544,6 +583,7 @@ public:
     {
         testClear();
         testAutomatic();
+        testPacedCopy();
         testCanDelete();
     }
 };
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/SignerListCache.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STArray.h>
+#include <test/unit_test/SuiteJournal.h>
+
+namespace ripple {
+namespace test {
+
+class SignerListCache_test : public beast::unit_test::suite
+{
+    static AccountID
+    account(std::uint8_t n)
+    {
+        AccountID id;
+        id.data()[0] = n;
+        return id;
+    }
+
+    static std::shared_ptr<SLE const>
+    makeSignerList(std::uint32_t quorum, std::uint8_t count)
+    {
+        auto sle = std::make_shared<SLE>(keylet::signers(account(0)));
+        sle->setFieldU32(sfSignerQuorum, quorum);
+        STArray entries(sfSignerEntries);
+        for (std::uint8_t i = 1; i <= count; ++i)
+        {
+            STObject entry(sfSignerEntry);
+            entry.setAccountID(sfAccount, account(i));
+            entry.setFieldU16(sfSignerWeight, 1);
+            entries.push_back(std::move(entry));
+        }
+        sle->setFieldArray(sfSignerEntries, entries);
+        return sle;
+    }
+
+public:
+    void
+    run() override
+    {
+        SuiteJournal journal("SignerListCache_test", *this);
+        TestStopwatch clock;
+        SignerListCache cache(clock, journal);
+
+        auto const sle = makeSignerList(3, 5);
+        auto const [list, ter] = cache.fetch(sle, journal);
+        if (!BEAST_EXPECT(ter == tesSUCCESS && list))
+            return;
+        BEAST_EXPECT(list->quorum == 3);
+        BEAST_EXPECT(list->signers.size() == 5);
+        BEAST_EXPECT(list->signers.front().account == account(1));
+
+        // The same SLE gives the same list
+        BEAST_EXPECT(cache.fetch(sle, journal).first == list);
+
+        // A changed SLE with the same key is parsed again
+        auto const changed = makeSignerList(2, 4);
+        auto const [again, ter2] = cache.fetch(changed, journal);
+        if (!BEAST_EXPECT(ter2 == tesSUCCESS && again))
+            return;
+        BEAST_EXPECT(again != list);
+        BEAST_EXPECT(again->quorum == 2);
+        BEAST_EXPECT(again->signers.size() == 4);
+        BEAST_EXPECT(cache.fetch(changed, journal).first == again);
+
+        // A malformed list is reported and not kept
+        auto const bad = std::make_shared<SLE>(keylet::signers(account(0)));
+        STArray entries(sfSignerEntries);
+        entries.push_back(STObject(sfMemo));
+        bad->setFieldArray(sfSignerEntries, entries);
+        BEAST_EXPECT(cache.fetch(bad, journal).second == temMALFORMED);
+        BEAST_EXPECT(cache.fetch(changed, journal).first == again);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SignerListCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
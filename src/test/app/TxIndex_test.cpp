@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TxIndex.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class TxIndex_test : public beast::unit_test::suite
+{
+    void
+    testStore()
+    {
+        testcase("store");
+
+        Section section;
+        section.set("type", "memory");
+        section.set("path", "TxIndex_test");
+        NodeStore::DummyScheduler scheduler;
+        beast::Journal const j{beast::Journal::getNullSink()};
+        TxIndex index(section, 1, scheduler, j);
+
+        std::vector<std::pair<uint256, std::uint32_t>> txns;
+        for (std::uint32_t i = 0; i < 20; ++i)
+            txns.emplace_back(sha512Half(i), i);
+        index.insert(7, txns);
+        index.insert(8, {});
+
+        for (auto const& [id, txnIndex] : txns)
+        {
+            auto const location = index.fetch(id);
+            if (!BEAST_EXPECT(location))
+                continue;
+            BEAST_EXPECT(location->ledgerSeq == 7);
+            BEAST_EXPECT(location->txnIndex == txnIndex);
+        }
+        BEAST_EXPECT(!index.fetch(sha512Half(std::uint32_t{100})));
+    }
+
+    void
+    testLedgers()
+    {
+        testcase("validated ledgers");
+
+        using namespace test::jtx;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            auto& section = cfg->section(SECTION_TX_INDEX);
+            section.set("type", "memory");
+            section.set("path", "TxIndex_test_ledgers");
+            return cfg;
+        }));
+
+        auto const txIndex = env.app().getTxIndex();
+        if (!BEAST_EXPECT(txIndex))
+            return;
+
+        env.fund(XRP(1000), "alice", "bob");
+        env.close();
+        env(pay("alice", "bob", XRP(10)));
+        auto const id = env.tx()->getTransactionID();
+        env.close();
+        auto const seq = env.closed()->info().seq;
+
+        // Validated ledgers may be saved in the background
+        auto location = txIndex->fetch(id);
+        for (int i = 0; !location && i < 100; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            location = txIndex->fetch(id);
+        }
+        if (!BEAST_EXPECT(location))
+            return;
+        BEAST_EXPECT(location->ledgerSeq == seq);
+
+        auto const json = env.rpc("tx", to_string(id));
+        BEAST_EXPECT(json[jss::result][jss::validated] == true);
+        BEAST_EXPECT(json[jss::result][jss::ledger_index] == seq);
+    }
+
+public:
+    void
+    run() override
+    {
+        testStore();
+        testLedgers();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxIndex, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/TxQ.h>
@@ -4644,6 +4645,85 @@ public:
         }
     }
 
+    void
+    testQueuePerformance()
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+        testcase("queue performance");
+
+        // The queue limit is the expected ledger size times the number
+        // of ledgers in the queue. Fill it to 90% so every transaction
+        // is held rather than rejected for a full queue.
+        std::size_t const txnsPerLedger = 100;
+        std::size_t const ledgersInQueue = 20;
+        std::size_t const txnsPerAccount = 9;
+        std::size_t const accountCount =
+            txnsPerLedger * ledgersInQueue * 9 / 10 / txnsPerAccount;
+
+        Env env(
+            *this,
+            makeConfig(
+                {{"minimum_txn_in_ledger_standalone",
+                  std::to_string(txnsPerLedger)},
+                 {"ledgers_in_queue", std::to_string(ledgersInQueue)},
+                 {"maximum_txn_per_account",
+                  std::to_string(txnsPerAccount)}}));
+
+        std::vector<Account> accounts;
+        accounts.reserve(accountCount);
+        for (std::size_t i = 0; i < accountCount; ++i)
+        {
+            accounts.emplace_back("acct" + std::to_string(i));
+            env.fund(XRP(100000), noripple(accounts.back()));
+            if (i % 40 == 39)
+                env.close();
+        }
+        env.close();
+
+        // Escalate the open ledger fee so that base fee transactions
+        // are queued.
+        fillQueue(env, env.master);
+
+        std::vector<std::shared_ptr<STTx const>> txns;
+        txns.reserve(accountCount * txnsPerAccount);
+        for (std::size_t i = 0; i < txnsPerAccount; ++i)
+        {
+            for (auto const& account : accounts)
+                txns.push_back(
+                    env.jt(noop(account), seq(env.seq(account) + i)).stx);
+        }
+
+        auto& txq = env.app().getTxQ();
+        std::size_t queued = 0;
+        auto const start = steady_clock::now();
+        env.app().openLedger().modify([&](OpenView& view, beast::Journal j) {
+            for (auto const& tx : txns)
+            {
+                if (txq.apply(env.app(), view, tx, tapNONE, j).first ==
+                    terQUEUED)
+                    ++queued;
+            }
+            return false;
+        });
+        auto const applied = steady_clock::now() - start;
+
+        BEAST_EXPECT(queued == txns.size());
+        BEAST_EXPECT(txq.getMetrics(*env.current()).txCount == txns.size());
+
+        auto const closeStart = steady_clock::now();
+        env.close();
+        auto const closed = steady_clock::now() - closeStart;
+
+        log << "Queued " << queued << " transactions in "
+            << duration_cast<milliseconds>(applied).count() << "ms ("
+            << duration_cast<microseconds>(applied).count() /
+                std::max<std::size_t>(queued, 1)
+            << "us each); close took "
+            << duration_cast<milliseconds>(closed).count() << "ms"
+            << std::endl;
+    }
+
     void
     run() override
     {
@@ -4696,8 +4776,18 @@ class TxQ2_test : public TxQ1_test
     }
 };
 
+class TxQPerf_test : public TxQ1_test
+{
+    void
+    run() override
+    {
+        testQueuePerformance();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ1, app, ripple, 1);
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ2, app, ripple, 1);
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQPerf, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/consensus/TxSetSketch.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <algorithm>
+
+namespace ripple {
+namespace test {
+
+class TxSetSketch_test : public beast::unit_test::suite
+{
+    static uint256
+    makeID(std::uint32_t i)
+    {
+        return sha512Half(i);
+    }
+
+    void
+    testWire()
+    {
+        testcase("wire format");
+
+        TxSetSketch sketch;
+        for (std::uint32_t i = 0; i < 300; ++i)
+            sketch.insert(makeID(i));
+        BEAST_EXPECT(sketch.size() == 300);
+
+        auto const wire = sketch.toWire();
+        BEAST_EXPECT(wire.size() == TxSetSketch::wireSize);
+
+        auto const copy = TxSetSketch::fromWire(makeSlice(wire));
+        if (!BEAST_EXPECT(copy))
+            return;
+        BEAST_EXPECT(copy->size() == 300);
+        BEAST_EXPECT(copy->toWire() == wire);
+
+        auto const diff = copy->difference(sketch);
+        if (BEAST_EXPECT(diff))
+        {
+            BEAST_EXPECT(diff->added.empty());
+            BEAST_EXPECT(diff->removed.empty());
+        }
+
+        Blob shortWire(wire.begin(), wire.end() - 1);
+        BEAST_EXPECT(!TxSetSketch::fromWire(makeSlice(shortWire)));
+        BEAST_EXPECT(!TxSetSketch::fromWire(Slice{}));
+    }
+
+    void
+    testDifference()
+    {
+        testcase("difference");
+
+        // Two sets of 400 sharing all but a handful of transactions
+        TxSetSketch mine;
+        TxSetSketch theirs;
+        std::vector<uint256> added;
+        std::vector<uint256> removed;
+
+        for (std::uint32_t i = 0; i < 400; ++i)
+        {
+            auto const id = makeID(i);
+            if (i % 97 == 0)
+            {
+                mine.insert(id);
+                removed.push_back(id);
+            }
+            else if (i % 89 == 0)
+            {
+                theirs.insert(id);
+                added.push_back(id);
+            }
+            else
+            {
+                mine.insert(id);
+                theirs.insert(id);
+            }
+        }
+
+        auto diff = theirs.difference(mine);
+        if (!BEAST_EXPECT(diff))
+            return;
+
+        std::sort(added.begin(), added.end());
+        std::sort(removed.begin(), removed.end());
+        std::sort(diff->added.begin(), diff->added.end());
+        std::sort(diff->removed.begin(), diff->removed.end());
+        BEAST_EXPECT(diff->added == added);
+        BEAST_EXPECT(diff->removed == removed);
+
+        // Swapping the sets swaps the result
+        auto reverse = mine.difference(theirs);
+        if (!BEAST_EXPECT(reverse))
+            return;
+        BEAST_EXPECT(reverse->added.size() == removed.size());
+        BEAST_EXPECT(reverse->removed.size() == added.size());
+    }
+
+    void
+    testOverflow()
+    {
+        testcase("too many differences");
+
+        TxSetSketch mine;
+        TxSetSketch theirs;
+        for (std::uint32_t i = 0; i < 500; ++i)
+            mine.insert(makeID(i));
+        for (std::uint32_t i = 250; i < 750; ++i)
+            theirs.insert(makeID(i));
+
+        BEAST_EXPECT(!theirs.difference(mine));
+    }
+
+public:
+    void
+    run() override
+    {
+        testWire();
+        testDifference();
+        testOverflow();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxSetSketch, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,417 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/MemoryUsage.h>
+#include <ripple/beast/insight/HistogramBuckets.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/jss.h>
+#include <boost/algorithm/string.hpp>
+#include <test/jtx.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+/** Measures how fast transactions are applied and ledgers are built.
+
+    A set of funded accounts, each with a USD trust line to a gateway and
+    a signer list, submits a random mix of transactions for a number of
+    ledgers. The transactions for each ledger are first signed, then
+    applied one at a time to the open ledger, then built into a ledger
+    from the parent as consensus would, and finally the ledger is closed.
+
+    For each kind of transaction this reports how many were applied and
+    how many succeeded, and the median and 99th percentile time taken to
+    apply one in microseconds. For each phase it reports the time taken
+    per transaction and the allocations made per transaction by the
+    subsystems MemoryUsage accounts for. The time not spent in apply while
+    modifying the open ledger is reported as its own phase, and its
+    allocations are counted with those of apply.
+
+    Arguments are separated by semicolons:
+
+        accounts=<count>    Funded accounts, 1000 by default
+        ledgers=<count>     Ledgers measured, 10 by default
+        txs=<count>         Transactions per ledger, 1000 by default
+        payment=<weight>    XRP payments
+        offer=<weight>      Offers to buy USD for XRP, about half crossing
+        path=<weight>       USD payments paid for in XRP through a book
+        escrow=<weight>     XRP escrows
+        multisign=<weight>  XRP payments signed by two signers
+
+    The weights default to 40, 20, 15, 10 and 15.
+*/
+class TxThroughput_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+    using Histogram = beast::insight::HistogramBuckets;
+
+    enum class Kind { payment, offer, path, escrow, multisign };
+    static constexpr std::size_t kindCount = 5;
+
+    static constexpr char const* kindNames[kindCount] =
+        {"payment", "offer", "path", "escrow", "multisign"};
+
+    enum class Phase { sign, apply, open, build, close };
+    static constexpr std::size_t phaseCount = 5;
+
+    static constexpr char const* phaseNames[phaseCount] =
+        {"sign", "apply", "open ledger", "build", "close"};
+
+    struct KindStats
+    {
+        std::size_t count = 0;
+        std::size_t applied = 0;
+        std::size_t succeeded = 0;
+        Histogram latency;
+    };
+
+    struct PhaseStats
+    {
+        clock_type::duration time{};
+        std::uint64_t allocations = 0;
+    };
+
+    struct Setup
+    {
+        std::size_t accounts = 1000;
+        std::size_t ledgers = 10;
+        std::size_t txs = 1000;
+        std::vector<double> weights{40, 20, 15, 10, 15};
+    };
+
+    // The allocations made so far by the subsystems MemoryUsage tracks
+    static std::uint64_t
+    allocations()
+    {
+        std::uint64_t result = 0;
+        for (auto const& e : MemoryUsage::report())
+            result += e.allocations;
+        return result;
+    }
+
+    static double
+    micros(clock_type::duration d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    Setup
+    parseArgs()
+    {
+        Setup setup;
+        std::vector<std::string> args;
+        boost::split(args, arg(), boost::algorithm::is_any_of(";"));
+        for (auto const& a : args)
+        {
+            if (a.empty())
+                continue;
+            auto const eq = a.find('=');
+            if (eq == std::string::npos)
+                Throw<std::runtime_error>("Malformed argument: " + a);
+            auto const key = a.substr(0, eq);
+            auto const value = a.substr(eq + 1);
+            if (key == "accounts")
+                setup.accounts = std::max<std::size_t>(2, std::stoul(value));
+            else if (key == "ledgers")
+                setup.ledgers = std::stoul(value);
+            else if (key == "txs")
+                setup.txs = std::stoul(value);
+            else
+            {
+                auto const kind = std::find_if(
+                    std::begin(kindNames),
+                    std::end(kindNames),
+                    [&](char const* name) { return key == name; });
+                if (kind == std::end(kindNames))
+                    Throw<std::runtime_error>("Unknown argument: " + a);
+                setup.weights[kind - std::begin(kindNames)] = std::stod(value);
+            }
+        }
+        return setup;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        testcase("TxThroughput", beast::unit_test::abort_on_fail);
+        auto const setup = parseArgs();
+
+        Env env(*this);
+        auto const base = env.current()->fees().base.drops();
+        Account const gw("gateway");
+        Account const market("market");
+        Account const signer1("signer1");
+        Account const signer2("signer2");
+        auto const USD = gw["USD"];
+
+        // A market maker selling USD for XRP gives offers something to
+        // cross and cross-currency payments a path
+        env.fund(XRP(100000), gw, market);
+        env.trust(USD(1e10), market);
+        env(pay(gw, market, USD(1e9)));
+        env(offer(market, XRP(1e9), USD(1e9)));
+        env.close();
+
+        std::vector<Account> accounts;
+        accounts.reserve(setup.accounts);
+        for (std::size_t i = 0; i < setup.accounts; ++i)
+        {
+            accounts.emplace_back("account" + std::to_string(i));
+            auto const& a = accounts.back();
+            env.memoize(a);
+            env(pay(env.master, a, XRP(1000000)));
+            env(trust(a, USD(1e9)));
+            env(signers(a, 2, {{signer1, 1}, {signer2, 1}}));
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+
+        beast::xor_shift_engine gen(1);
+        std::discrete_distribution<int> pick(
+            setup.weights.begin(), setup.weights.end());
+        std::uniform_int_distribution<std::size_t> who(
+            0, accounts.size() - 1);
+        std::uniform_int_distribution<std::uint64_t> price(900000, 1100000);
+
+        auto const make = [&](Kind kind,
+                              Account const& from,
+                              Account const& to,
+                              std::uint32_t sequence) {
+            switch (kind)
+            {
+                case Kind::payment:
+                    return env.jt(
+                        pay(from, to, drops(1000 + gen() % 1000)),
+                        jtx::seq(sequence),
+                        fee(base));
+                case Kind::offer:
+                    // Crosses the market maker's offer at 1 XRP or more
+                    return env.jt(
+                        jtx::offer(from, USD(1), drops(price(gen))),
+                        jtx::seq(sequence),
+                        fee(base));
+                case Kind::path:
+                    return env.jt(
+                        pay(from, to, USD(1)),
+                        sendmax(XRP(2)),
+                        jtx::path(~USD),
+                        jtx::seq(sequence),
+                        fee(base));
+                case Kind::escrow: {
+                    Json::Value jv;
+                    jv[jss::TransactionType] = jss::EscrowCreate;
+                    jv[jss::Flags] = tfUniversal;
+                    jv[jss::Account] = from.human();
+                    jv[jss::Destination] = to.human();
+                    jv[jss::Amount] = XRP(1).value().getJson(JsonOptions::none);
+                    jv[sfFinishAfter.jsonName] = static_cast<std::uint32_t>(
+                        (env.now() + 1h).time_since_epoch().count());
+                    return env.jt(jv, jtx::seq(sequence), fee(base));
+                }
+                case Kind::multisign:
+                    break;
+            }
+            return env.jt(
+                pay(from, to, drops(1000 + gen() % 1000)),
+                msig(signer1, signer2),
+                jtx::seq(sequence),
+                fee(3 * base));
+        };
+
+        std::array<KindStats, kindCount> kinds;
+        std::array<PhaseStats, phaseCount> phases;
+        auto const phase = [&](Phase p) -> PhaseStats& {
+            return phases[static_cast<std::size_t>(p)];
+        };
+        std::vector<clock_type::duration> closeTimes;
+        std::size_t total = 0;
+
+        for (std::size_t ledger = 0; ledger < setup.ledgers; ++ledger)
+        {
+            // Sign
+            std::vector<std::pair<Kind, JTx>> txs;
+            txs.reserve(setup.txs);
+            hash_map<AccountID, std::uint32_t> sequences;
+            auto allocated = allocations();
+            auto start = clock_type::now();
+            for (std::size_t i = 0; i < setup.txs; ++i)
+            {
+                auto const kind = static_cast<Kind>(pick(gen));
+                auto const from = who(gen);
+                auto to = who(gen);
+                if (to == from)
+                    to = (to + 1) % accounts.size();
+
+                auto [iter, inserted] =
+                    sequences.emplace(accounts[from].id(), 0);
+                if (inserted)
+                    iter->second = env.seq(accounts[from]);
+                txs.emplace_back(
+                    kind,
+                    make(kind, accounts[from], accounts[to], iter->second++));
+            }
+            phase(Phase::sign).time += clock_type::now() - start;
+            phase(Phase::sign).allocations += allocations() - allocated;
+
+            // Apply each transaction to the open ledger
+            clock_type::duration applying{};
+            allocated = allocations();
+            start = clock_type::now();
+            for (auto const& [kind, jt] : txs)
+            {
+                auto& stats = kinds[static_cast<std::size_t>(kind)];
+                ++stats.count;
+                env.app().openLedger().modify(
+                    [&, &jt = jt](OpenView& view, beast::Journal j) {
+                        auto const applyStart = clock_type::now();
+                        auto const [ter, applied] =
+                            ripple::apply(env.app(), view, *jt.stx, tapNONE, j);
+                        auto const took = clock_type::now() - applyStart;
+                        applying += took;
+                        stats.latency.insert(
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(took)
+                                .count());
+                        if (applied)
+                            ++stats.applied;
+                        if (ter == tesSUCCESS)
+                            ++stats.succeeded;
+                        return applied;
+                    });
+            }
+            auto const modifying = clock_type::now() - start;
+            phase(Phase::apply).time += applying;
+            phase(Phase::apply).allocations += allocations() - allocated;
+            phase(Phase::open).time += modifying - applying;
+
+            // Build the ledger from the parent, as consensus does
+            auto const parent = env.app().getLedgerMaster().getClosedLedger();
+            CanonicalTXSet set(parent->info().hash);
+            for (auto const& item : env.current()->txs)
+                set.insert(item.first);
+            std::set<TxID> failed;
+            allocated = allocations();
+            start = clock_type::now();
+            auto const built = buildLedger(
+                parent,
+                parent->info().closeTime + parent->info().closeTimeResolution,
+                true,
+                parent->info().closeTimeResolution,
+                env.app(),
+                set,
+                failed,
+                env.journal);
+            phase(Phase::build).time += clock_type::now() - start;
+            phase(Phase::build).allocations += allocations() - allocated;
+            BEAST_EXPECT(built);
+
+            // Close, which builds the ledger again and opens the next one
+            allocated = allocations();
+            start = clock_type::now();
+            env.close();
+            closeTimes.push_back(clock_type::now() - start);
+            phase(Phase::close).time += closeTimes.back();
+            phase(Phase::close).allocations += allocations() - allocated;
+
+            total += txs.size();
+        }
+
+        if (total == 0)
+        {
+            pass();
+            return;
+        }
+
+        log << setup.accounts << " accounts, " << setup.ledgers
+            << " ledgers of " << setup.txs << " transactions" << std::endl;
+
+        log << "Kind          count  applied  success  apply50  apply99"
+            << std::endl;
+        for (std::size_t k = 0; k < kindCount; ++k)
+        {
+            auto& stats = kinds[k];
+            if (stats.count == 0)
+                continue;
+            auto const counts = stats.latency.collect();
+            auto const quantile = [&](double q) {
+                return Histogram::percentile(
+                           counts, Histogram::total(counts), q) /
+                    1000.0;
+            };
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << std::left
+               << std::setw(10) << kindNames[k] << std::right << std::setw(9)
+               << stats.count << std::setw(9) << stats.applied
+               << std::setw(9) << stats.succeeded << std::setw(9)
+               << quantile(0.5) << std::setw(9) << quantile(0.99);
+            log << ss.str() << std::endl;
+        }
+
+        log << "Phase         us/tx  allocs/tx" << std::endl;
+        for (std::size_t p = 0; p < phaseCount; ++p)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << std::left
+               << std::setw(12) << phaseNames[p] << std::right
+               << std::setw(7) << micros(phases[p].time) / total;
+            if (p == static_cast<std::size_t>(Phase::open))
+                ss << std::setw(11) << "-";
+            else
+                ss << std::setw(11)
+                   << double(phases[p].allocations) / total;
+            log << ss.str() << std::endl;
+        }
+
+        std::sort(closeTimes.begin(), closeTimes.end());
+        auto const endToEnd = phase(Phase::apply).time +
+            phase(Phase::open).time + phase(Phase::close).time;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << "Close: median "
+           << micros(closeTimes[closeTimes.size() / 2]) / 1000
+           << " ms, longest " << micros(closeTimes.back()) / 1000
+           << " ms; " << total / (micros(endToEnd) / 1e6)
+           << " transactions per second applied and closed";
+        log << ss.str() << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TxThroughput, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
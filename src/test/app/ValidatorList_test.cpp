@@ -616,6 +616,22 @@ private:
             trustedKeys->applyList(manifest2, blob3, sig3, version, siteUri)
                 .disposition);
 
+        // a list sent again gets the same result as the first time
+        {
+            auto const again = trustedKeys->applyList(
+                manifest2, blob3, sig3, version, siteUri);
+            BEAST_EXPECT(again.disposition == ListDisposition::same_sequence);
+            BEAST_EXPECT(
+                again.publisherKey && *again.publisherKey == publisherPublic);
+            BEAST_EXPECT(again.sequence && *again.sequence == sequence3);
+        }
+
+        // a list signed with the old publisher key is no longer valid
+        BEAST_EXPECT(
+            ListDisposition::invalid ==
+            trustedKeys->applyList(manifest1, blob2, sig2, version, siteUri)
+                .disposition);
+
         auto const sequence4 = 4;
         auto const blob4 =
             makeList(list1, sequence4, expiration.time_since_epoch().count());
@@ -647,6 +663,12 @@ private:
             BEAST_EXPECT(!trustedKeys->listed(val.masterPublic));
             BEAST_EXPECT(!trustedKeys->listed(val.signingPublic));
         }
+
+        // a list verified before the revocation is not accepted again
+        BEAST_EXPECT(
+            ListDisposition::untrusted ==
+            trustedKeys->applyList(manifest2, blob3, sig3, version, siteUri)
+                .disposition);
     }
 
     void
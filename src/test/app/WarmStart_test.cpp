@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/WarmStart.h>
+#include <ripple/basics/FileUtilities.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/shamap/Family.h>
+#include <ripple/shamap/TreeNodeCache.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class WarmStart_test : public beast::unit_test::suite
+{
+    void
+    testSaveAndLoad()
+    {
+        testcase("save and load");
+
+        using namespace jtx;
+        beast::temp_dir dir;
+        boost::filesystem::path const file =
+            boost::filesystem::path(dir.path()) / "warm_start";
+
+        Env env(*this);
+        env.fund(XRP(10000), "alice", "bob", "carol");
+        env.close();
+        env(pay("alice", "bob", XRP(100)));
+        env.close();
+
+        auto const cached =
+            env.app().getNodeFamily().getTreeNodeCache(0)->getCacheSize();
+        BEAST_EXPECT(cached > 0);
+
+        // Nothing to load yet
+        BEAST_EXPECT(loadWarmStart(env.app(), file) == 0);
+
+        // At most the requested number of keys are saved
+        BEAST_EXPECT(saveWarmStart(env.app(), file, 4));
+        boost::system::error_code ec;
+        BEAST_EXPECT(getFileContents(ec, file).size() == 4 * uint256::bytes);
+
+        BEAST_EXPECT(saveWarmStart(env.app(), file, 1000000));
+        auto const contents = getFileContents(ec, file);
+        BEAST_EXPECT(!ec);
+        BEAST_EXPECT(contents.size() % uint256::bytes == 0);
+        BEAST_EXPECT(contents.size() > 4 * uint256::bytes);
+        BEAST_EXPECT(!boost::filesystem::exists(file.string() + ".tmp"));
+
+        // Every saved node is queued to be read, unless the read completed
+        // at once because the node store already had it cached
+        auto const queued = loadWarmStart(env.app(), file);
+        BEAST_EXPECT(queued <= contents.size() / uint256::bytes);
+        env.app().getNodeStore().waitReads();
+
+        // A truncated file is ignored
+        writeFileContents(ec, file, contents.substr(0, contents.size() - 1));
+        BEAST_EXPECT(!ec);
+        BEAST_EXPECT(loadWarmStart(env.app(), file) == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testSaveAndLoad();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(WarmStart, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/Feature.h>
@@ -32,20 +33,22 @@ public:
     {
         testcase("Require Fully Canonicial Signature");
         testFullyCanonicalSigs();
+        testcase("Signature Verdicts");
+        testSignatureVerdicts();
     }
 
+    // A payment w/out a fully-canonical signature
+    static constexpr char const* non_fully_canonical_tx =
+        "12000022000000002400000001201B00497D9C6140000000000F6950684000000"
+        "00000000C732103767C7B2C13AD90050A4263745E4BAB2B975417FA22E87780E1"
+        "506DDAF21139BE74483046022100E95670988A34C4DB0FA73A8BFD6383872AF43"
+        "8C147A62BC8387406298C3EADC1022100A7DC80508ED5A4750705C702A81CBF9D"
+        "2C2DC3AFEDBED37BBCCD97BC8C40E08F8114E25A26437D923EEF4D6D815DF9336"
+        "8B62E6440848314BB85996936E4F595287774684DC2AC6266024BEF";
+
     void
     testFullyCanonicalSigs()
     {
-        // Construct a payments w/out a fully-canonical tx
-        const std::string non_fully_canonical_tx =
-            "12000022000000002400000001201B00497D9C6140000000000F6950684000000"
-            "00000000C732103767C7B2C13AD90050A4263745E4BAB2B975417FA22E87780E1"
-            "506DDAF21139BE74483046022100E95670988A34C4DB0FA73A8BFD6383872AF43"
-            "8C147A62BC8387406298C3EADC1022100A7DC80508ED5A4750705C702A81CBF9D"
-            "2C2DC3AFEDBED37BBCCD97BC8C40E08F8114E25A26437D923EEF4D6D815DF9336"
-            "8B62E6440848314BB85996936E4F595287774684DC2AC6266024BEF";
-
         auto ret = strUnHex(non_fully_canonical_tx);
         SerialIter sitTrans(makeSlice(*ret));
         STTx const tx = *std::make_shared<STTx const>(std::ref(sitTrans));
@@ -83,6 +86,60 @@ public:
 
         pass();
     }
+
+    void
+    testSignatureVerdicts()
+    {
+        // The verdicts of our cluster are taken in place of checking the
+        // signature ourselves
+        auto ret = strUnHex(non_fully_canonical_tx);
+        SerialIter sitTrans(makeSlice(*ret));
+        STTx const tx{sitTrans};
+        auto const id = tx.getTransactionID();
+
+        {
+            // A signature we'd accept, which the cluster found bad
+            test::jtx::Env env(
+                *this,
+                test::jtx::supported_amendments() -
+                    featureRequireFullyCanonicalSig);
+            auto& router = env.app().getHashRouter();
+
+            BEAST_EXPECT(router.setFlags(id, SF_CLUSTER));
+            forceSigBad(router, id);
+            BEAST_EXPECT(
+                checkValidity(
+                    router, tx, env.current()->rules(), env.app().config())
+                    .first == Validity::SigBad);
+
+            // A verdict is only shared once
+            BEAST_EXPECT(!router.setFlags(id, SF_CLUSTER));
+        }
+
+        {
+            // A signature we'd reject, which the cluster found good
+            test::jtx::Env env(*this, test::jtx::supported_amendments());
+            auto& router = env.app().getHashRouter();
+
+            forceValidity(router, id, Validity::SigGoodOnly);
+            BEAST_EXPECT(
+                checkValidity(
+                    router, tx, env.current()->rules(), env.app().config())
+                    .first == Validity::Valid);
+        }
+
+        {
+            // With no verdict the signature is checked as before
+            test::jtx::Env env(*this, test::jtx::supported_amendments());
+            auto& router = env.app().getHashRouter();
+
+            BEAST_EXPECT(
+                checkValidity(
+                    router, tx, env.current()->rules(), env.app().config())
+                    .first == Validity::SigBad);
+            BEAST_EXPECT(!(router.getFlags(id) & SF_CLUSTER));
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(Apply, app, ripple);
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/CacheBudget.h>
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/SuiteJournal.h>
+
+namespace ripple {
+
+class CacheBudget_test : public beast::unit_test::suite
+{
+    using Cache = TaggedCache<int, Blob>;
+
+    // Insert blobs of `size` bytes until the cache holds `bytes`
+    static void
+    fill(Cache& cache, std::size_t bytes, std::size_t size)
+    {
+        for (int i = 0; cache.getCacheBytes() < bytes; ++i)
+            cache.insert(i, Blob(size));
+    }
+
+    static void
+    miss(Cache& cache, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            cache.fetch(-1 - i);
+    }
+
+    void
+    testShares()
+    {
+        testcase("shares");
+
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("CacheBudget_test", *this);
+        TestStopwatch clock;
+
+        Cache small("small", 0, 1min, clock, journal);
+        Cache large("large", 0, 1min, clock, journal);
+
+        std::size_t const total = 1024 * 1024;
+        CacheBudget budget(total, journal);
+        budget.add("small", small);
+        budget.add("large", large);
+        BEAST_EXPECT(small.getTargetBytes() == total / 2);
+        BEAST_EXPECT(large.getTargetBytes() == total / 2);
+
+        // A cache of small objects and a cache of large ones are held to
+        // the same memory
+        fill(small, total / 2, 16);
+        fill(large, total / 2, 16 * 1024);
+        BEAST_EXPECT(small.getCacheSize() > 50 * large.getCacheSize());
+
+        // Memory moves to the cache which is full and missing
+        miss(small, 1000);
+        miss(large, 10);
+        budget.rebalance();
+        auto const step = total / CacheBudget::stepDivisor;
+        BEAST_EXPECT(small.getTargetBytes() == total / 2 + step);
+        BEAST_EXPECT(large.getTargetBytes() == total / 2 - step);
+
+        // Only the misses since the last rebalance count
+        budget.rebalance();
+        BEAST_EXPECT(small.getTargetBytes() == total / 2 + step);
+
+        // But never below the floor of the cache giving it up
+        auto const floor = total / 2 / CacheBudget::floorDivisor;
+        for (std::size_t i = 0; i < 2 * CacheBudget::stepDivisor; ++i)
+        {
+            fill(small, small.getTargetBytes(), 16);
+            miss(small, 1000);
+            budget.rebalance();
+        }
+        BEAST_EXPECT(large.getTargetBytes() == floor);
+        BEAST_EXPECT(small.getTargetBytes() == total - floor);
+
+        auto const report = budget.report();
+        if (BEAST_EXPECT(report.size() == 2))
+        {
+            BEAST_EXPECT(report[0].name == "small");
+            BEAST_EXPECT(report[0].targetBytes == total - floor);
+            BEAST_EXPECT(report[0].bytes == small.getCacheBytes());
+            BEAST_EXPECT(report[1].misses == 10);
+        }
+    }
+
+    void
+    testFull()
+    {
+        testcase("full");
+
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("CacheBudget_test", *this);
+        TestStopwatch clock;
+
+        Cache first("first", 0, 1min, clock, journal);
+        Cache second("second", 0, 1min, clock, journal);
+
+        std::size_t const total = 1024 * 1024;
+        CacheBudget budget(total, journal);
+        budget.add("first", first);
+        budget.add("second", second);
+
+        // A cache with room left gains nothing however much it misses
+        auto const share = total / 2;
+        fill(first, share / 2, 16);
+        fill(second, share, 16);
+        miss(first, 1000);
+        budget.rebalance();
+        BEAST_EXPECT(first.getTargetBytes() == share);
+        BEAST_EXPECT(second.getTargetBytes() == share);
+
+        // It counts as full once it holds all but a tenth of its share
+        fill(first, share - share / CacheBudget::fullDivisor, 16);
+        miss(first, 1000);
+        budget.rebalance();
+        auto const step = total / CacheBudget::stepDivisor;
+        BEAST_EXPECT(first.getTargetBytes() == share + step);
+        BEAST_EXPECT(second.getTargetBytes() == share - step);
+    }
+
+    void
+    testAdjust()
+    {
+        testcase("adjust");
+
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("CacheBudget_test", *this);
+        TestStopwatch clock;
+
+        Cache first("first", 0, 1min, clock, journal);
+        Cache second("second", 0, 1min, clock, journal);
+
+        std::size_t const total = 1024 * 1024;
+        CacheBudget budget(total, journal);
+        budget.add("first", first);
+        budget.add("second", second);
+
+        // Nothing to grow into
+        budget.adjust(false);
+        BEAST_EXPECT(budget.bytes() == total);
+
+        // Each cache gives up the same fraction of its share
+        budget.adjust(true);
+        BEAST_EXPECT(budget.bytes() == total - total / 4);
+        BEAST_EXPECT(first.getTargetBytes() == (total - total / 4) / 2);
+        BEAST_EXPECT(second.getTargetBytes() == (total - total / 4) / 2);
+
+        for (int i = 0; i < 20; ++i)
+            budget.adjust(true);
+        BEAST_EXPECT(budget.bytes() == total / 4);
+
+        // And takes memory back a step at a time
+        budget.adjust(false);
+        BEAST_EXPECT(budget.bytes() == total / 4 + total / 20);
+        for (int i = 0; i < 20; ++i)
+            budget.adjust(false);
+        BEAST_EXPECT(budget.bytes() == total);
+        BEAST_EXPECT(
+            first.getTargetBytes() + second.getTargetBytes() <= total);
+    }
+
+public:
+    void
+    run() override
+    {
+        testShares();
+        testFull();
+        testAdjust();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CacheBudget, basics, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/CpuProfile.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace ripple {
+
+class CpuProfile_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase("sampling");
+
+        using namespace std::chrono_literals;
+        std::atomic<bool> stop{false};
+        std::atomic<bool> started{false};
+        std::atomic<std::uint64_t> sink{0};
+        std::thread busy([&] {
+            setCpuProfileTag("CpuProfile_test");
+            started = true;
+            std::uint64_t x = 0;
+            while (!stop)
+                sink = ++x * 7;
+            setCpuProfileTag(nullptr);
+        });
+        while (!started)
+            std::this_thread::yield();
+
+        std::optional<CpuProfile> concurrent;
+        std::thread second([&] {
+            std::this_thread::sleep_for(50ms);
+            concurrent = runCpuProfile(10ms, 100);
+        });
+        auto const profile = runCpuProfile(300ms, 200);
+        second.join();
+        stop = true;
+        busy.join();
+
+        if (!profile)
+        {
+            // Only supported on Linux
+            pass();
+            return;
+        }
+
+        // Only one profile runs at a time
+        BEAST_EXPECT(!concurrent);
+
+        BEAST_EXPECT(profile->samples > 0);
+        BEAST_EXPECT(profile->dropped == 0);
+        std::uint64_t total = 0;
+        std::uint64_t tagged = 0;
+        for (auto const& stack : profile->stacks)
+        {
+            total += stack.count;
+            if (stack.frames.find(";CpuProfile_test;") != std::string::npos)
+                tagged += stack.count;
+        }
+        BEAST_EXPECT(total == profile->samples);
+
+        // The busy thread used nearly all of the processor time
+        BEAST_EXPECT(tagged * 2 > total);
+
+        // Stacks are sorted by count
+        BEAST_EXPECT(std::is_sorted(
+            profile->stacks.begin(),
+            profile->stacks.end(),
+            [](auto const& a, auto const& b) { return a.count > b.count; }));
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CpuProfile, basics, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/HugePages.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/predef.h>
+#include <cstring>
+
+namespace ripple {
+
+class HugePages_test : public beast::unit_test::suite
+{
+    struct Node
+    {
+        explicit Node(int v) : value(v)
+        {
+        }
+
+        int value;
+        char padding[60];
+    };
+
+    void
+    testParse()
+    {
+        testcase("parse");
+
+        BEAST_EXPECT(parseHugePageMode("none") == HugePageMode::none);
+        BEAST_EXPECT(
+            parseHugePageMode("transparent") == HugePageMode::transparent);
+        BEAST_EXPECT(parseHugePageMode("hugetlb") == HugePageMode::hugetlb);
+        BEAST_EXPECT(!parseHugePageMode(""));
+        BEAST_EXPECT(!parseHugePageMode("on"));
+    }
+
+    void
+    testMode(HugePageMode mode)
+    {
+        setHugePageMode(mode);
+#if BOOST_OS_LINUX
+        BEAST_EXPECT(hugePageMode() == mode);
+#else
+        BEAST_EXPECT(hugePageMode() == HugePageMode::none);
+#endif
+
+        // Blocks are usable and aligned, and freed ones are reused
+        auto const a = static_cast<char*>(allocateHugePages(100000));
+        auto const b = static_cast<char*>(allocateHugePages(100000));
+        BEAST_EXPECT(a && b && a != b);
+        BEAST_EXPECT(
+            reinterpret_cast<std::uintptr_t>(a) %
+                alignof(std::max_align_t) ==
+            0);
+        std::memset(a, 1, 100000);
+        std::memset(b, 2, 100000);
+        BEAST_EXPECT(a[99999] == 1 && b[0] == 2);
+        deallocateHugePages(a);
+        auto const c = static_cast<char*>(allocateHugePages(100000));
+        if (mode != HugePageMode::none)
+            BEAST_EXPECT(c == a);
+        deallocateHugePages(b);
+        deallocateHugePages(c);
+        deallocateHugePages(nullptr);
+
+        std::vector<std::shared_ptr<Node const>> nodes;
+        for (int i = 0; i < 20000; ++i)
+            nodes.push_back(make_pooled<Node const>(i));
+        bool good = true;
+        for (int i = 0; i < 20000; ++i)
+            good = good && nodes[i]->value == i;
+        BEAST_EXPECT(good);
+    }
+
+    void
+    testModes()
+    {
+        testcase("allocate");
+
+        // A block allocated in one mode may be freed in another
+        setHugePageMode(HugePageMode::transparent);
+        auto const p = allocateHugePages(64);
+        testMode(HugePageMode::none);
+        testMode(HugePageMode::transparent);
+        testMode(HugePageMode::hugetlb);
+        deallocateHugePages(p);
+
+        setHugePageMode(HugePageMode::none);
+    }
+
+public:
+    void
+    run() override
+    {
+        testParse();
+        testModes();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HugePages, basics, ripple);
+
+}  // namespace ripple
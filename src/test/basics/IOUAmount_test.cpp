@@ -166,6 +166,31 @@ public:
         BEAST_EXPECT(to_string(IOUAmount(-2, -20)) == "-2000000000000000e-35");
     }
 
+    void
+    testAddition()
+    {
+        testcase("IOU addition");
+
+        // The smaller amount is truncated to the exponent of the larger
+        auto const big = IOUAmount(1234567890123456, 0);
+        BEAST_EXPECT(
+            big + IOUAmount(9876543210987654, -3) ==
+            IOUAmount(1244444433334443, 0));
+        BEAST_EXPECT(
+            big + IOUAmount(-9876543210987654, -3) ==
+            IOUAmount(1224691346912469, 0));
+        BEAST_EXPECT(
+            IOUAmount(9876543210987654, -3) + big ==
+            IOUAmount(1244444433334443, 0));
+
+        // Amounts too small to change the larger one are dropped
+        for (int exponent : {-16, -17, -18, -19, -40, -96})
+        {
+            BEAST_EXPECT(big + IOUAmount(9999999999999999, exponent) == big);
+            BEAST_EXPECT(IOUAmount(-9999999999999999, exponent) + big == big);
+        }
+    }
+
     void
     testMulRatio()
     {
@@ -263,6 +288,7 @@ run() override
     testBeastZero();
     testComparisons();
     testToString();
+    testAddition();
     testMulRatio();
 }
 }
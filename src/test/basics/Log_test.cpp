@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/FileUtilities.h>
+#include <ripple/basics/Log.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/FileDirGuard.h>
+#include <boost/algorithm/string.hpp>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class Log_test : public beast::unit_test::suite
+{
+    // The lines of a log file
+    static std::vector<std::string>
+    lines(boost::filesystem::path const& path)
+    {
+        boost::system::error_code ec;
+        auto const contents = getFileContents(ec, path);
+        std::vector<std::string> result;
+        if (!ec && !contents.empty())
+            boost::split(result, contents, boost::is_any_of("\n"));
+        if (!result.empty() && result.back().empty())
+            result.pop_back();
+        return result;
+    }
+
+    void
+    testAsync()
+    {
+        testcase("async");
+
+        using namespace test::detail;
+        FileDirGuard file(*this, "log_test", "debug.log", "");
+
+        std::size_t const threads = 4;
+        std::size_t const perThread = 250;
+        std::uint64_t dropped = 0;
+        {
+            Logs logs(beast::severities::kTrace);
+            logs.silent(true);
+            BEAST_EXPECT(logs.open(file.file()));
+            logs.async(threads * perThread);
+
+            auto j = logs.journal("Test");
+            std::vector<std::thread> writers;
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                writers.emplace_back([&j, i, perThread]() {
+                    for (std::size_t n = 0; n < perThread; ++n)
+                        JLOG(j.debug()) << "thread " << i << " line " << n;
+                });
+            }
+            for (auto& writer : writers)
+                writer.join();
+            dropped = logs.dropped();
+        }
+
+        // Nothing is lost while the queue has room, and what was queued is
+        // written before the logs go away
+        BEAST_EXPECT(dropped == 0);
+        auto const written = lines(file.file());
+        BEAST_EXPECT(written.size() == threads * perThread);
+        for (auto const& line : written)
+            BEAST_EXPECT(line.find("Test:DBG thread ") != std::string::npos);
+    }
+
+    void
+    testDropped()
+    {
+        testcase("dropped");
+
+        using namespace test::detail;
+        FileDirGuard file(*this, "log_test", "debug.log", "");
+
+        std::size_t const count = 10000;
+        std::uint64_t dropped = 0;
+        {
+            Logs logs(beast::severities::kTrace);
+            logs.silent(true);
+            BEAST_EXPECT(logs.open(file.file()));
+            logs.async(1);
+
+            auto j = logs.journal("Test");
+            for (std::size_t n = 0; n < count; ++n)
+                JLOG(j.debug()) << "line " << n;
+            dropped = logs.dropped();
+        }
+
+        // Every message was either written or counted, and the count is
+        // reported in the log itself
+        auto const written = lines(file.file());
+        std::size_t messages = 0;
+        std::uint64_t reported = 0;
+        for (auto const& line : written)
+        {
+            if (line.find("Test:DBG line ") != std::string::npos)
+            {
+                ++messages;
+                continue;
+            }
+            auto const pos = line.find("Logs:WRN ");
+            if (BEAST_EXPECT(pos != std::string::npos))
+                reported += std::stoull(line.substr(pos + 9));
+        }
+        BEAST_EXPECT(messages + dropped == count);
+        BEAST_EXPECT(reported <= dropped);
+    }
+
+public:
+    void
+    run() override
+    {
+        testAsync();
+        testDropped();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Log, basics, ripple);
+
+}  // namespace ripple
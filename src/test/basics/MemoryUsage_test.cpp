@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/MemoryUsage.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_value.h>
+#include <vector>
+
+namespace ripple {
+
+class MemoryUsage_test : public beast::unit_test::suite
+{
+    static MemoryUsage::Entry
+    usage(MemoryTag tag)
+    {
+        return MemoryUsage::report()[static_cast<std::size_t>(tag)];
+    }
+
+    void
+    testAllocator()
+    {
+        testcase("allocator");
+
+        auto const before = usage(MemoryTag::message);
+        {
+            std::vector<char, TaggedAllocator<char, MemoryTag::message>> v;
+            v.reserve(1000);
+            auto const during = usage(MemoryTag::message);
+            BEAST_EXPECT(during.bytes == before.bytes + 1000);
+            BEAST_EXPECT(during.allocations == before.allocations + 1);
+        }
+        auto const after = usage(MemoryTag::message);
+        BEAST_EXPECT(after.bytes == before.bytes);
+        BEAST_EXPECT(after.allocations == before.allocations + 1);
+    }
+
+    void
+    testTags()
+    {
+        testcase("tags");
+
+        auto const report = MemoryUsage::report();
+        BEAST_EXPECT(report.size() == MemoryUsage::tagCount);
+        BEAST_EXPECT(std::string(report[0].name) == "shamap");
+        BEAST_EXPECT(
+            std::string(MemoryUsage::name(MemoryTag::json)) == "json");
+
+        // Json values are accounted for when they allocate
+        auto const before = usage(MemoryTag::json);
+        {
+            Json::Value v(Json::objectValue);
+            v["key"] = std::string(100, 'x');
+            BEAST_EXPECT(usage(MemoryTag::json).bytes > before.bytes);
+        }
+        BEAST_EXPECT(usage(MemoryTag::json).bytes == before.bytes);
+    }
+
+public:
+    void
+    run() override
+    {
+        testAllocator();
+        testTags();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(MemoryUsage, basics, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/PartitionedTaggedCache.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/clock/manual_clock.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+
+namespace ripple {
+
+class PartitionedTaggedCache_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("PartitionedTaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        using Key = int;
+        using Value = std::string;
+        using Cache = PartitionedTaggedCache<Key, Value>;
+
+        Cache c(
+            "test",
+            100,
+            1s,
+            clock,
+            journal,
+            beast::insight::NullCollector::New(),
+            8);
+
+        BEAST_EXPECT(c.partitions() == 8);
+        BEAST_EXPECT(c.getTargetSize() == 8 * 13);
+        BEAST_EXPECT(c.getTargetAge() == 1s);
+
+        // Fill the cache then age everything out
+        {
+            for (int i = 0; i < 1000; ++i)
+                c.insert(i, std::to_string(i));
+            BEAST_EXPECT(c.getCacheSize() == 1000);
+            BEAST_EXPECT(c.getTrackSize() == 1000);
+
+            auto keys = c.getKeys();
+            std::sort(keys.begin(), keys.end());
+            BEAST_EXPECT(keys.size() == 1000);
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                BEAST_EXPECT(keys[i] == static_cast<int>(i));
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                std::string s;
+                BEAST_EXPECT(c.retrieve(i, s));
+                BEAST_EXPECT(s == std::to_string(i));
+            }
+
+            auto const rates = c.getPartitionHitRates();
+            BEAST_EXPECT(rates.size() == 8);
+            // Every partition should have seen some of the keys
+            for (auto const rate : rates)
+                BEAST_EXPECT(rate > 0);
+            BEAST_EXPECT(c.getHitRate() > 0);
+
+            ++clock;
+            c.sweep();
+            BEAST_EXPECT(c.getCacheSize() == 0);
+            BEAST_EXPECT(c.getTrackSize() == 0);
+        }
+
+        // A strong pointer keeps an entry tracked across a sweep, and
+        // canonicalizing returns the original object.
+        {
+            c.insert(1, "one");
+            auto const p1 = c.fetch(1);
+            BEAST_EXPECT(p1 != nullptr);
+            ++clock;
+            c.sweep();
+            BEAST_EXPECT(c.getCacheSize() == 0);
+            BEAST_EXPECT(c.getTrackSize() == 1);
+
+            auto p2 = std::make_shared<Value>("one");
+            BEAST_EXPECT(c.canonicalize_replace_client(1, p2));
+            BEAST_EXPECT(p1.get() == p2.get());
+            BEAST_EXPECT(c.getCacheSize() == 1);
+        }
+
+        // Deleting and resetting
+        {
+            BEAST_EXPECT(c.del(1, false));
+            BEAST_EXPECT(c.getCacheSize() == 0);
+            BEAST_EXPECT(!c.refreshIfPresent(1));
+
+            c.insert(2, "two");
+            BEAST_EXPECT(c.refreshIfPresent(2));
+            c.reset();
+            BEAST_EXPECT(c.getCacheSize() == 0);
+            BEAST_EXPECT(c.getTrackSize() == 0);
+        }
+
+        // Changing the target size is spread across the partitions
+        {
+            c.setTargetSize(16);
+            BEAST_EXPECT(c.getTargetSize() == 16);
+            c.setTargetAge(2s);
+            BEAST_EXPECT(c.getTargetAge() == 2s);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PartitionedTaggedCache, common, ripple);
+
+}  // namespace ripple
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/basics/PerfLog.h>
+#include <ripple/basics/impl/PerfLogImp.h>
 #include <ripple/basics/random.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/json/json_reader.h>
@@ -1062,6 +1063,120 @@ public:
         }
     }
 
+    void
+    testSignatures()
+    {
+        // Signatures verified are reported with the counters of their job.
+        using namespace std::chrono;
+
+        PerfLogParent parent{j_};
+        auto perfLog{getPerfLog(parent, WithFile::no)};
+        parent.doStart();
+
+        auto const& jobTypes = JobTypes::instance();
+        auto const name = jobTypes.get(jtVALIDATION_t).name();
+
+        {
+            auto const counters = perfLog->countersJson();
+            BEAST_EXPECT(!counters[jss::job_queue].isMember(name));
+        }
+
+        perfLog->signaturesVerified(jtVALIDATION_t, 3, microseconds{40});
+        perfLog->signaturesVerified(jtVALIDATION_t, 5, microseconds{60});
+
+        {
+            auto const counters = perfLog->countersJson();
+            Json::Value const& job{counters[jss::job_queue][name]};
+            BEAST_EXPECT(jsonToUint64(job[jss::started]) == 0);
+            BEAST_EXPECT(jsonToUint64(job[jss::verified]) == 8);
+            BEAST_EXPECT(jsonToUint64(job[jss::verify_duration_us]) == 100);
+        }
+
+        parent.doStop();
+    }
+
+    void
+    testHistogram()
+    {
+        testcase("latency histogram");
+        using namespace std::chrono;
+
+        perf::LatencyHistogram h;
+        BEAST_EXPECT(h.size() == 0);
+        BEAST_EXPECT(h.quantile(0.5) == microseconds{0});
+
+        // Each quantile is reported as the top of its bucket, which is
+        // never more than a quarter above the true value.
+        for (int i = 1; i <= 1000; ++i)
+            h.add(microseconds{i});
+        BEAST_EXPECT(h.size() == 1000);
+        BEAST_EXPECT(h.quantile(0.5) == microseconds{511});
+        BEAST_EXPECT(h.quantile(0.99) == microseconds{1023});
+        BEAST_EXPECT(h.quantile(1.0) == microseconds{1023});
+        BEAST_EXPECT(h.quantile(0.001) == microseconds{1});
+
+        // Small durations are counted exactly, and huge ones all land in
+        // the last bucket.
+        perf::LatencyHistogram small;
+        small.add(microseconds{0});
+        small.add(microseconds{3});
+        BEAST_EXPECT(small.quantile(0.5) == microseconds{0});
+        BEAST_EXPECT(small.quantile(1.0) == microseconds{3});
+        small.add(hours{24 * 365});
+        BEAST_EXPECT(small.quantile(1.0) > hours{1});
+
+        h += small;
+        BEAST_EXPECT(h.size() == 1003);
+        BEAST_EXPECT(h.quantile(1.0) > hours{1});
+    }
+
+    void
+    testLatency()
+    {
+        testcase("RPC latency and sizes");
+        using namespace std::chrono;
+
+        PerfLogParent parent{j_};
+        auto perfLog{getPerfLog(parent, WithFile::no)};
+        parent.doStart();
+
+        std::string const method = "account_objects";
+        for (std::uint64_t id = 0; id < 20; ++id)
+        {
+            perfLog->rpcStart(method, id);
+            std::this_thread::sleep_for(milliseconds(id < 18 ? 1 : 10));
+            perfLog->rpcFinish(method, id);
+        }
+        perfLog->rpcBytes(method, 100, 2000);
+        perfLog->rpcBytes(method, 50, 1000);
+        // Sizes of unknown methods are ignored.
+        perfLog->rpcBytes("no_such_method", 1, 1);
+
+        auto const rpc = perfLog->countersJson()[jss::rpc];
+        BEAST_EXPECT(!rpc.isMember("no_such_method"));
+
+        Json::Value const& counter{rpc[method]};
+        auto const p50 = jsonToUint64(counter[jss::p50_us]);
+        auto const p99 = jsonToUint64(counter[jss::p99_us]);
+        auto const p999 = jsonToUint64(counter[jss::p999_us]);
+        BEAST_EXPECT(p50 >= 1000);
+        BEAST_EXPECT(p99 >= 10000);
+        BEAST_EXPECT(p50 <= p99 && p99 <= p999);
+        BEAST_EXPECT(jsonToUint64(counter[jss::bytes_in]) == 150);
+        BEAST_EXPECT(jsonToUint64(counter[jss::bytes_out]) == 3000);
+
+        Json::Value const& total{rpc[jss::total]};
+        BEAST_EXPECT(jsonToUint64(total[jss::p999_us]) == p999);
+        BEAST_EXPECT(jsonToUint64(total[jss::bytes_out]) == 3000);
+
+        // Methods which have not been called report no quantiles.
+        BEAST_EXPECT(
+            !rpc.isMember("book_offers") ||
+            !rpc["book_offers"].isMember(jss::p50_us));
+
+        parent.doStop();
+    }
+
     void
     testRotate(WithFile withFile)
     {
@@ -1131,6 +1246,9 @@ public:
         testJobs(WithFile::yes);
         testInvalidID(WithFile::no);
         testInvalidID(WithFile::yes);
+        testSignatures();
+        testHistogram();
+        testLatency();
         testRotate(WithFile::no);
         testRotate(WithFile::yes);
     }
@@ -147,6 +147,61 @@ public:
             BEAST_EXPECT(c.getCacheSize() == 0);
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
+
+        // Bound a cache by bytes rather than entries, and make sure the
+        // oldest objects are aged out first once it is over its target.
+        {
+            Cache b("bytes", 0, 10s, clock, journal);
+            BEAST_EXPECT(b.getCacheBytes() == 0);
+            BEAST_EXPECT(!b.insert(0, "zero"));
+            auto const each = b.getCacheBytes();
+            BEAST_EXPECT(each >= sizeof(Value));
+
+            for (Key i = 1; i < 5; ++i)
+                BEAST_EXPECT(!b.insert(i, "old"));
+            clock.advance(3s);
+            for (Key i = 5; i < 10; ++i)
+                BEAST_EXPECT(!b.insert(i, "new"));
+            BEAST_EXPECT(b.getCacheBytes() == 10 * each);
+
+            // Under the target nothing younger than the target age goes
+            clock.advance(3s);
+            b.setTargetBytes(20 * each);
+            b.sweep();
+            BEAST_EXPECT(b.getCacheSize() == 10);
+
+            // Twice over the target, objects are kept half as long
+            b.setTargetBytes(5 * each);
+            b.sweep();
+            BEAST_EXPECT(b.getCacheSize() == 5);
+            BEAST_EXPECT(b.getCacheBytes() == 5 * each);
+            BEAST_EXPECT(!b.fetch(0));
+            BEAST_EXPECT(b.fetch(9));
+
+            BEAST_EXPECT(b.del(9, false));
+            BEAST_EXPECT(b.getCacheBytes() == 4 * each);
+            b.clear();
+            BEAST_EXPECT(b.getCacheBytes() == 0);
+        }
+
+        // Abandoning the cache empties it but keeps the objects alive
+        {
+            Cache a("abandon", 10, 1s, clock, journal);
+            auto const value = std::make_shared<Value>("kept");
+            auto copy = value;
+            a.canonicalize_replace_client(1, copy);
+            std::weak_ptr<Value> const weak = value;
+
+            a.abandon();
+            BEAST_EXPECT(a.getCacheSize() == 0);
+            BEAST_EXPECT(a.getTrackSize() == 0);
+            BEAST_EXPECT(a.getCacheBytes() == 0);
+            BEAST_EXPECT(!a.fetch(1));
+
+            copy.reset();
+            BEAST_EXPECT(value.use_count() == 2);
+            BEAST_EXPECT(!weak.expired());
+        }
     }
 };
 
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/ThreadAffinity.h>
+#include <ripple/beast/unit_test.h>
+#include <thread>
+
+namespace ripple {
+
+class ThreadAffinity_test : public beast::unit_test::suite
+{
+    void
+    testParse()
+    {
+        testcase("parse");
+
+        BEAST_EXPECT((parseCpuSet("3") == CpuSet{3}));
+        BEAST_EXPECT((parseCpuSet("0-3") == CpuSet{0, 1, 2, 3}));
+        BEAST_EXPECT((parseCpuSet("8-9, 2 ,4 - 5") == CpuSet{2, 4, 5, 8, 9}));
+
+        // Overlapping ranges are merged
+        BEAST_EXPECT((parseCpuSet("1-3,2-4") == CpuSet{1, 2, 3, 4}));
+
+        BEAST_EXPECT(!parseCpuSet(""));
+        BEAST_EXPECT(!parseCpuSet("1,"));
+        BEAST_EXPECT(!parseCpuSet("3-1"));
+        BEAST_EXPECT(!parseCpuSet("-1"));
+        BEAST_EXPECT(!parseCpuSet("1-"));
+        BEAST_EXPECT(!parseCpuSet("a"));
+        BEAST_EXPECT(!parseCpuSet("0-100000"));
+    }
+
+    void
+    testConfig()
+    {
+        testcase("config");
+
+        Section section("thread_affinity");
+        section.set("io", "0-1");
+        section.set("job_queue", "2-x");
+
+        BEAST_EXPECT((getCpuSet(section, "io") == CpuSet{0, 1}));
+        BEAST_EXPECT(getCpuSet(section, "missing").empty());
+        try
+        {
+            getCpuSet(section, "job_queue");
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testApply()
+    {
+        testcase("apply");
+
+        // An empty set leaves the thread alone, and pinning to the first
+        // processor always succeeds where pinning is supported.
+        BEAST_EXPECT(setCurrentThreadAffinity({}));
+        std::thread t([this] { BEAST_EXPECT(setCurrentThreadAffinity({0})); });
+        t.join();
+    }
+
+public:
+    void
+    run() override
+    {
+        testParse();
+        testConfig();
+        testApply();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ThreadAffinity, basics, ripple);
+
+}  // namespace ripple
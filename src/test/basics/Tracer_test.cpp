@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Tracer.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <sstream>
+#include <thread>
+
+namespace ripple {
+namespace perf {
+namespace trace {
+
+class Tracer_test : public beast::unit_test::suite
+{
+    static uint256
+    makeID(std::uint64_t id)
+    {
+        uint256 txID;
+        std::memcpy(txID.data(), &id, sizeof(id));
+        return txID;
+    }
+
+    void
+    testSampling()
+    {
+        testcase("sampling");
+
+        collect();
+        setSampleRate(0);
+        {
+            Span span("disabled", makeID(0));
+        }
+        BEAST_EXPECT(collect().empty());
+
+        setSampleRate(2);
+        for (std::uint64_t i = 0; i < 10; ++i)
+        {
+            Span first("first", makeID(i));
+            Span second("second", makeID(i));
+        }
+
+        // Another thread's spans are collected too
+        std::thread([] { Span span("thread", makeID(10)); }).join();
+
+        auto const records = collect();
+        BEAST_EXPECT(records.size() == 11);
+        for (auto const& rec : records)
+        {
+            BEAST_EXPECT(rec.id % 2 == 0);
+            BEAST_EXPECT(rec.duration.count() >= 0);
+        }
+        if (BEAST_EXPECT(!records.empty()))
+        {
+            BEAST_EXPECT(std::string(records.back().name) == "thread");
+            BEAST_EXPECT(records.back().id == 10);
+        }
+
+        // Collecting removes the spans
+        BEAST_EXPECT(collect().empty());
+        setSampleRate(0);
+    }
+
+    void
+    testOverflow()
+    {
+        testcase("overflow");
+
+        setSampleRate(1);
+        for (std::uint64_t i = 0; i < 5000; ++i)
+            Span span("span", makeID(i));
+        setSampleRate(0);
+
+        // Only the newest spans are kept
+        auto const records = collect();
+        BEAST_EXPECT(records.size() == 4096);
+        if (BEAST_EXPECT(!records.empty()))
+        {
+            BEAST_EXPECT(records.front().id == 5000 - 4096);
+            BEAST_EXPECT(records.back().id == 4999);
+        }
+    }
+
+    void
+    testEvents()
+    {
+        testcase("events");
+
+        setSampleRate(1);
+        {
+            Span span("outer", makeID(7));
+            Span inner("inner", makeID(7));
+        }
+        setSampleRate(0);
+
+        std::ostringstream os;
+        os << "[\n";
+        writeEvents(os, collect());
+        auto text = os.str();
+        BEAST_EXPECT(text.size() > 3);
+        text.resize(text.size() - 2);
+        text += "]";
+
+        Json::Value events;
+        Json::Reader reader;
+        if (!BEAST_EXPECT(reader.parse(text, events)))
+            return;
+        BEAST_EXPECT(events.isArray() && events.size() == 4);
+        for (auto const& event : events)
+        {
+            BEAST_EXPECT(event["cat"] == "tx");
+            BEAST_EXPECT(event["id"] == "0x0000000000000007");
+            BEAST_EXPECT(event["ph"] == "b" || event["ph"] == "e");
+            BEAST_EXPECT(event["ts"].isDouble());
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testSampling();
+        testOverflow();
+        testEvents();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Tracer, basics, ripple);
+
+}  // namespace trace
+}  // namespace perf
+}  // namespace ripple
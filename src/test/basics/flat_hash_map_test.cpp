@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/flat_hash_map.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace ripple {
+
+class flat_hash_map_test : public beast::unit_test::suite
+{
+    using map_type = flat_hash_map<uint256, std::string>;
+
+    static uint256
+    makeKey(std::uint64_t i)
+    {
+        uint256 key;
+        beast::xor_shift_engine rng(i + 1);
+        for (auto& b : key)
+            b = static_cast<std::uint8_t>(rng());
+        return key;
+    }
+
+    void
+    testBasics()
+    {
+        testcase("basics");
+
+        map_type m;
+        BEAST_EXPECT(m.empty());
+        BEAST_EXPECT(m.begin() == m.end());
+        BEAST_EXPECT(m.find(makeKey(1)) == m.end());
+        BEAST_EXPECT(m.erase(makeKey(1)) == 0);
+
+        auto const [it, inserted] = m.emplace(makeKey(1), "one");
+        BEAST_EXPECT(inserted);
+        BEAST_EXPECT(it->first == makeKey(1) && it->second == "one");
+        BEAST_EXPECT(!m.emplace(makeKey(1), "uno").second);
+        BEAST_EXPECT(m.at(makeKey(1)) == "one");
+        BEAST_EXPECT(m.insert(std::make_pair(makeKey(2), "two")).second);
+        BEAST_EXPECT(m.try_emplace(makeKey(3), 5, 'x').second);
+        m[makeKey(4)] = "four";
+        BEAST_EXPECT(m.size() == 4);
+        BEAST_EXPECT(m.count(makeKey(3)) == 1);
+        BEAST_EXPECT(m[makeKey(3)] == "xxxxx");
+
+        try
+        {
+            m.at(makeKey(5));
+            fail();
+        }
+        catch (std::out_of_range const&)
+        {
+            pass();
+        }
+
+        BEAST_EXPECT(m.erase(makeKey(2)) == 1);
+        BEAST_EXPECT(m.count(makeKey(2)) == 0);
+        BEAST_EXPECT(m.size() == 3);
+
+        std::size_t n = 0;
+        for (auto const& v : m)
+        {
+            BEAST_EXPECT(v.first != makeKey(2));
+            ++n;
+        }
+        BEAST_EXPECT(n == 3);
+
+        m.clear();
+        BEAST_EXPECT(m.empty());
+        BEAST_EXPECT(m.begin() == m.end());
+        BEAST_EXPECT(m.count(makeKey(1)) == 0);
+    }
+
+    void
+    testGrowth()
+    {
+        testcase("growth");
+
+        map_type m;
+        for (std::uint64_t i = 0; i < 10000; ++i)
+        {
+            m.emplace(makeKey(i), std::to_string(i));
+            auto const capacity = m.capacity();
+            BEAST_EXPECT((capacity & (capacity - 1)) == 0);
+            BEAST_EXPECT(m.size() <= capacity - capacity / 8);
+        }
+        BEAST_EXPECT(m.size() == 10000);
+
+        bool found = true;
+        for (std::uint64_t i = 0; i < 10000; ++i)
+        {
+            auto const it = m.find(makeKey(i));
+            found = found && it != m.end() && it->second == std::to_string(i);
+        }
+        BEAST_EXPECT(found);
+
+        // Reserving makes room without moving the elements again
+        map_type r;
+        r.reserve(1000);
+        auto const capacity = r.capacity();
+        for (std::uint64_t i = 0; i < 1000; ++i)
+            r.emplace(makeKey(i), "");
+        BEAST_EXPECT(r.capacity() == capacity);
+
+        // Deleted slots are reclaimed rather than growing the map
+        map_type c;
+        for (std::uint64_t i = 0; i < 100000; ++i)
+        {
+            c.emplace(makeKey(i), "");
+            if (i >= 10)
+                c.erase(makeKey(i - 10));
+        }
+        BEAST_EXPECT(c.size() == 10);
+        BEAST_EXPECT(c.capacity() <= 32);
+    }
+
+    void
+    testEraseIterating()
+    {
+        testcase("erase while iterating");
+
+        flat_hash_map<uint256, std::uint64_t> m;
+        for (std::uint64_t i = 0; i < 1000; ++i)
+            m.emplace(makeKey(i), i);
+
+        std::size_t visited = 0;
+        for (auto it = m.begin(); it != m.end();)
+        {
+            ++visited;
+            if (it->second % 3 == 0)
+                it = m.erase(it);
+            else
+                ++it;
+        }
+        BEAST_EXPECT(visited == 1000);
+        BEAST_EXPECT(m.size() == 666);
+
+        bool good = true;
+        for (std::uint64_t i = 0; i < 1000; ++i)
+            good = good && m.count(makeKey(i)) == (i % 3 == 0 ? 0 : 1);
+        BEAST_EXPECT(good);
+    }
+
+    void
+    testRandom()
+    {
+        testcase("compared with std::unordered_map");
+
+        // Few keys, so elements are erased and inserted again often
+        beast::xor_shift_engine rng(42);
+        flat_hash_map<uint256, std::shared_ptr<int>> m;
+        std::unordered_map<uint256, int, hardened_hash<>> expected;
+
+        bool good = true;
+        for (int i = 0; i < 200000; ++i)
+        {
+            auto const key = makeKey(rng() % 3000);
+            switch (rng() % 4)
+            {
+                case 0:
+                case 1: {
+                    auto const inserted = m.emplace(
+                                               key, std::make_shared<int>(i))
+                                              .second;
+                    good = good && inserted == expected.emplace(key, i).second;
+                    break;
+                }
+                case 2:
+                    good = good && m.erase(key) == expected.erase(key);
+                    break;
+                default: {
+                    auto const it = m.find(key);
+                    auto const e = expected.find(key);
+                    good = good && (it == m.end()) == (e == expected.end()) &&
+                        (it == m.end() || *it->second == e->second);
+                }
+            }
+        }
+        BEAST_EXPECT(good);
+
+        auto const same = [&expected](auto const& map) {
+            if (map.size() != expected.size())
+                return false;
+            for (auto const& [key, value] : map)
+            {
+                auto const e = expected.find(key);
+                if (e == expected.end() || e->second != *value)
+                    return false;
+            }
+            return true;
+        };
+        BEAST_EXPECT(same(m));
+
+        auto copy = m;
+        BEAST_EXPECT(same(copy));
+        auto moved = std::move(copy);
+        BEAST_EXPECT(same(moved));
+        BEAST_EXPECT(copy.empty());
+        copy = moved;
+        BEAST_EXPECT(same(copy));
+        moved.clear();
+        moved.swap(copy);
+        BEAST_EXPECT(same(moved) && copy.empty());
+    }
+
+    void
+    testUniformHash()
+    {
+        testcase("uniform_hash");
+
+        uniform_hash const h1;
+        uniform_hash const h2;
+        auto const key = makeKey(7);
+        BEAST_EXPECT(h1(key) == h1(key));
+        // The seeds differ, so the hashes almost surely do too
+        BEAST_EXPECT(h1(key) != h2(key));
+
+        // Every byte of the key counts
+        for (std::size_t i = 0; i < key.size(); ++i)
+        {
+            auto other = key;
+            other.data()[i] ^= 1;
+            BEAST_EXPECT(h1(other) != h1(key));
+        }
+
+        flat_hash_map<uint160, int> m;
+        m.emplace(uint160(1), 1);
+        BEAST_EXPECT(m.count(uint160(1)) == 1);
+        BEAST_EXPECT(m.count(uint160(2)) == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBasics();
+        testGrowth();
+        testEraseIterating();
+        testRandom();
+        testUniformHash();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(flat_hash_map, basics, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/make_SSLContext.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <thread>
+
+namespace ripple {
+
+class make_SSLContext_test : public beast::unit_test::suite
+{
+    using socket_type = boost::asio::ip::tcp::socket;
+    using stream_type = boost::asio::ssl::stream<socket_type&>;
+
+    void
+    testResumption()
+    {
+        testcase("session resumption");
+
+        using namespace boost::asio;
+        io_context ios;
+        auto const serverContext = make_SSLContext("");
+        auto const clientContext = make_SSLContext("");
+
+        ip::tcp::acceptor acceptor(
+            ios, ip::tcp::endpoint(ip::address_v4::loopback(), 0));
+        auto const endpoint = acceptor.local_endpoint();
+
+        // The server sends a byte after each handshake, so that the client
+        // reads any session tickets sent with it
+        std::thread server([&] {
+            for (int i = 0; i < 3; ++i)
+            {
+                socket_type socket(ios);
+                acceptor.accept(socket);
+                stream_type stream(socket, *serverContext);
+                boost::system::error_code ec;
+                stream.handshake(ssl::stream_base::server, ec);
+                if (!ec)
+                    write(stream, buffer("x", 1), ec);
+                stream.shutdown(ec);
+            }
+        });
+
+        // Returns whether the session was resumed
+        auto connect = [&](std::string const& name) {
+            socket_type socket(ios);
+            socket.connect(endpoint);
+            stream_type stream(socket, *clientContext);
+            resumeSSLSession(stream.native_handle(), name);
+            stream.handshake(ssl::stream_base::client);
+            char c;
+            read(stream, buffer(&c, 1));
+            bool const resumed = SSL_session_reused(stream.native_handle());
+            boost::system::error_code ec;
+            stream.shutdown(ec);
+            return resumed;
+        };
+
+        BEAST_EXPECT(!connect("server"));
+        BEAST_EXPECT(connect("server"));
+        // A session is only offered to the server it was made with
+        BEAST_EXPECT(!connect("another server"));
+
+        server.join();
+    }
+
+public:
+    void
+    run() override
+    {
+        testResumption();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(make_SSLContext, basics, ripple);
+
+}  // namespace ripple
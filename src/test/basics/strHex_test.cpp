@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/strHex.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <chrono>
+#include <random>
+
+namespace ripple {
+
+namespace {
+
+Blob
+randomBlob(beast::xor_shift_engine& engine, std::size_t size)
+{
+    Blob blob(size);
+    std::uniform_int_distribution<int> dist(0, 255);
+    for (auto& b : blob)
+        b = static_cast<unsigned char>(dist(engine));
+    return blob;
+}
+
+// One nibble at a time, as the conversions used to be done
+std::string
+slowHex(Blob const& blob)
+{
+    std::string result;
+    boost::algorithm::hex(blob.begin(), blob.end(), std::back_inserter(result));
+    return result;
+}
+
+}  // namespace
+
+class strHex_test : public beast::unit_test::suite
+{
+    void
+    testEncode()
+    {
+        testcase("encode");
+
+        beast::xor_shift_engine engine(42);
+
+        // Every length up to a few vectors' worth, so that each
+        // combination of vector and scalar steps is taken
+        bool same = true;
+        for (std::size_t size = 0; size < 200; ++size)
+        {
+            auto const blob = randomBlob(engine, size);
+            auto const expected = slowHex(blob);
+            same = same && strHex(blob) == expected &&
+                strHex(blob.data(), blob.data() + blob.size()) == expected &&
+                sqlBlobLiteral(blob) == "X'" + expected + "'";
+        }
+        BEAST_EXPECT(same);
+
+        Blob all(256);
+        for (int i = 0; i < 256; ++i)
+            all[i] = static_cast<unsigned char>(i);
+        BEAST_EXPECT(strHex(all) == slowHex(all));
+
+        auto const hash = randomBlob(engine, uint256::size());
+        auto const u = uint256::fromVoid(hash.data());
+        BEAST_EXPECT(to_string(u) == slowHex(hash));
+    }
+
+    void
+    testDecode()
+    {
+        testcase("decode");
+
+        beast::xor_shift_engine engine(7);
+
+        bool same = true;
+        for (std::size_t size = 0; size < 200; ++size)
+        {
+            auto const blob = randomBlob(engine, size);
+            auto hex = slowHex(blob);
+            same = same && strUnHex(hex) == blob;
+
+            // Lower case digits are accepted too
+            for (auto& c : hex)
+                c = std::tolower(c);
+            same = same && strUnHex(hex) == blob;
+        }
+        BEAST_EXPECT(same);
+
+        // A bad character anywhere is found, whichever step reads it
+        auto const blob = randomBlob(engine, 100);
+        auto const hex = slowHex(blob);
+        bool rejected = true;
+        for (std::size_t i = 0; i < hex.size(); ++i)
+        {
+            for (char bad : {'G', 'g', '/', ':', '@', '`', ' ', '\x80'})
+            {
+                auto copy = hex;
+                copy[i] = bad;
+                rejected = rejected && !strUnHex(copy);
+            }
+        }
+        BEAST_EXPECT(rejected);
+
+        // An odd number of digits starts with a byte of one digit
+        BEAST_EXPECT(strUnHex("ABC") == Blob({0x0A, 0xBC}));
+        BEAST_EXPECT(!strUnHex("GBC"));
+        BEAST_EXPECT(strUnHex("") == Blob());
+
+        uint256 u;
+        auto const s = std::string(64, 'f');
+        BEAST_EXPECT(u.parseHex(s) && to_string(u) == std::string(64, 'F'));
+        BEAST_EXPECT(!u.parseHex(std::string(63, 'f') + "x"));
+    }
+
+public:
+    void
+    run() override
+    {
+        testEncode();
+        testDecode();
+    }
+};
+
+class strHexBenchmark_test : public beast::unit_test::suite
+{
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t bytes, F&& f)
+    {
+        using namespace std::chrono;
+        std::size_t const rounds = (64 << 20) / bytes;
+        auto const start = steady_clock::now();
+        for (std::size_t i = 0; i < rounds; ++i)
+            f();
+        auto const elapsed =
+            duration_cast<duration<double>>(steady_clock::now() - start);
+        log << name << " " << bytes << " bytes: "
+            << (rounds * bytes) / elapsed.count() / (1 << 20) << " MB/s"
+            << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        beast::xor_shift_engine engine(1);
+        for (std::size_t size : {32, 1024, 1 << 20})
+        {
+            auto const blob = randomBlob(engine, size);
+            auto const hex = strHex(blob);
+            std::size_t sink = 0;
+            measure("slow encode", size, [&] { sink += slowHex(blob).size(); });
+            measure("encode", size, [&] { sink += strHex(blob).size(); });
+            measure("decode", size, [&] { sink += strUnHex(hex)->size(); });
+            BEAST_EXPECT(sink != 0);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(strHex, ripple_basics, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(strHexBenchmark, ripple_basics, ripple);
+
+}  // namespace ripple
@@ -1455,6 +1455,16 @@ aged_associative_container_test_base::testChronological()
         //      c.touch (c.rbegin());
         //      c.touch (c.crbegin());
     }
+
+    // Expire a limited number of the oldest items at a time
+    using namespace std::chrono_literals;
+    ++clock;
+    c.touch(c.find(Traits::extract(v.back())));
+    BEAST_EXPECT(expire(c, 1s, 2) == 2);
+    BEAST_EXPECT(c.size() == v.size() - 2);
+    BEAST_EXPECT(expire(c, 1s, 100) == v.size() - 3);
+    BEAST_EXPECT(c.size() == 1);
+    BEAST_EXPECT(expire(c, 1s, 100) == 0);
 }
 
 //------------------------------------------------------------------------------
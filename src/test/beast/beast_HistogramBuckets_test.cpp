@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/insight/HistogramBuckets.h>
+#include <ripple/beast/unit_test.h>
+
+namespace beast {
+namespace insight {
+
+class HistogramBuckets_test : public unit_test::suite
+{
+public:
+    void
+    testBuckets()
+    {
+        testcase("buckets");
+
+        // Small values are exact
+        for (std::uint64_t v = 0; v < 4; ++v)
+        {
+            BEAST_EXPECT(HistogramBuckets::bucket(v) == v);
+            BEAST_EXPECT(HistogramBuckets::highest(v) == v);
+        }
+
+        // Every value lies in a bucket no wider than a quarter of it, and
+        // buckets are contiguous and ordered
+        std::size_t last = 3;
+        for (std::uint64_t v = 4; v < 100000; ++v)
+        {
+            auto const b = HistogramBuckets::bucket(v);
+            BEAST_EXPECT(b == last || b == last + 1);
+            BEAST_EXPECT(HistogramBuckets::highest(b) >= v);
+            BEAST_EXPECT(HistogramBuckets::highest(b) - v <= v / 4);
+            BEAST_EXPECT(HistogramBuckets::highest(b - 1) < v);
+            last = b;
+        }
+
+        BEAST_EXPECT(
+            HistogramBuckets::bucket(std::uint64_t{1} << 40) ==
+            HistogramBuckets::size - 1);
+        BEAST_EXPECT(
+            HistogramBuckets::bucket(~std::uint64_t{0}) ==
+            HistogramBuckets::size - 1);
+    }
+
+    void
+    testPercentiles()
+    {
+        testcase("percentiles");
+
+        HistogramBuckets h;
+        for (std::uint64_t v = 1; v <= 1000; ++v)
+            h.insert(v);
+
+        auto const counts = h.collect();
+        auto const total = HistogramBuckets::total(counts);
+        BEAST_EXPECT(total == 1000);
+
+        auto const near = [&](double p, std::uint64_t expected) {
+            auto const v = HistogramBuckets::percentile(counts, total, p);
+            return v >= expected && v - expected <= expected / 4;
+        };
+        BEAST_EXPECT(near(0.50, 500));
+        BEAST_EXPECT(near(0.90, 900));
+        BEAST_EXPECT(near(0.99, 990));
+        BEAST_EXPECT(near(1.0, 1000));
+
+        // Collecting resets the counts
+        BEAST_EXPECT(HistogramBuckets::total(h.collect()) == 0);
+        BEAST_EXPECT(HistogramBuckets::percentile(h.collect(), 0, 0.5) == 0);
+    }
+
+    void
+    run() override
+    {
+        testBuckets();
+        testPercentiles();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HistogramBuckets, insight, beast);
+
+}  // namespace insight
+}  // namespace beast
@@ -0,0 +1,288 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <test/csf.h>
+#include <test/csf/random.h>
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+/** Benchmarks the timing and message cost of consensus in simulation.
+
+    Each run simulates a network of validators which all trust and connect
+    to each other, with a given link latency profile and transaction rate,
+    and appends one row of results to ConsensusBenchmark.csv. Comparing the
+    rows from before and after a change to the consensus timing parameters
+    or to relaying shows what the change costs or saves.
+
+    The optional argument is the simulated duration of each run in seconds,
+    at least 30 and 60 by default.
+*/
+class ConsensusBenchmark_test : public beast::unit_test::suite
+{
+    /** Collects round timing, close time agreement and message counts */
+    struct RoundCollector
+    {
+        using Hist = csf::Histogram<csf::SimTime::duration>;
+
+        // Time from a peer starting a round until it accepts a ledger
+        Hist roundTime;
+
+        // When each peer started its current round
+        hash_map<csf::PeerID, csf::SimTime> started;
+
+        // Distinct ledgers accepted, and those whose close time was
+        // agreed on
+        hash_set<csf::Ledger::ID> ledgers;
+        std::size_t closeAgree = 0;
+
+        // Messages relayed between peers
+        std::size_t proposals = 0;
+        std::size_t validations = 0;
+        std::size_t txs = 0;
+        std::size_t txSets = 0;
+        std::size_t other = 0;
+
+        template <class E>
+        void
+        on(csf::PeerID, csf::SimTime, E const&)
+        {
+        }
+
+        void
+        on(csf::PeerID who, csf::SimTime when, csf::StartRound const&)
+        {
+            started[who] = when;
+        }
+
+        void
+        on(csf::PeerID who, csf::SimTime when, csf::AcceptLedger const& e)
+        {
+            if (auto it = started.find(who); it != started.end())
+            {
+                roundTime.insert(when - it->second);
+                started.erase(it);
+            }
+            if (ledgers.insert(e.ledger.id()).second && e.ledger.closeAgree())
+                ++closeAgree;
+        }
+
+        template <class M>
+        void
+        on(csf::PeerID, csf::SimTime, csf::Relay<M> const&)
+        {
+            if constexpr (std::is_same_v<M, csf::Proposal>)
+                ++proposals;
+            else if constexpr (std::is_same_v<M, csf::Validation>)
+                ++validations;
+            else if constexpr (std::is_same_v<M, csf::Tx>)
+                ++txs;
+            else if constexpr (std::is_same_v<M, csf::TxSet>)
+                ++txSets;
+            else
+                ++other;
+        }
+
+        std::size_t
+        messages() const
+        {
+            return proposals + validations + txs + txSets + other;
+        }
+    };
+
+    enum class Latency { fixed, uniform, lognormal };
+
+    static char const*
+    to_string(Latency latency)
+    {
+        switch (latency)
+        {
+            case Latency::fixed:
+                return "fixed";
+            case Latency::uniform:
+                return "uniform";
+            case Latency::lognormal:
+                return "lognormal";
+        }
+        return "unknown";
+    }
+
+    // Connect every pair of peers, with link delays drawn according to the
+    // latency profile and averaging about `mean`
+    static void
+    connect(
+        csf::PeerGroup& peers,
+        Latency latency,
+        std::chrono::milliseconds mean,
+        std::mt19937_64& rng)
+    {
+        using namespace std::chrono;
+
+        auto const m = static_cast<double>(mean.count());
+        std::uniform_real_distribution<> uniform{m / 2, 3 * m / 2};
+        // A median of 3/4 of the mean with a long tail.
+        std::lognormal_distribution<> lognormal{std::log(0.75 * m), 0.75};
+
+        for (auto i = peers.begin(); i != peers.end(); ++i)
+        {
+            for (auto j = std::next(i); j != peers.end(); ++j)
+            {
+                double delay = m;
+                if (latency == Latency::uniform)
+                    delay = uniform(rng);
+                else if (latency == Latency::lognormal)
+                    delay = lognormal(rng);
+                (*i)->connect(**j, milliseconds(std::llround(delay)));
+                (*j)->connect(**i, milliseconds(std::llround(delay)));
+            }
+        }
+    }
+
+    static double
+    toMs(csf::SimTime::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    void
+    simulate(
+        std::ostream& csv,
+        std::size_t numPeers,
+        Latency latency,
+        std::size_t txPerSec,
+        std::chrono::seconds duration)
+    {
+        using namespace csf;
+        using namespace std::chrono;
+
+        std::chrono::milliseconds const meanDelay{200};
+
+        Sim sim;
+        PeerGroup peers = sim.createGroup(numPeers);
+        peers.trust(peers);
+        connect(peers, latency, meanDelay, sim.rng);
+
+        TxCollector txCollector;
+        LedgerCollector ledgerCollector;
+        RoundCollector roundCollector;
+        auto colls =
+            makeCollectors(txCollector, ledgerCollector, roundCollector);
+        sim.collectors.add(colls);
+
+        // Initial round to set prior state
+        sim.run(1);
+
+        SimDuration const simDuration = duration;
+        SimDuration const quiet = 10s;
+        Rate const rate{txPerSec, 1000ms};
+
+        auto peerSelector = makeSelector(
+            peers.begin(),
+            peers.end(),
+            std::vector<double>(numPeers, 1.),
+            sim.rng);
+        auto txSubmitter = makeSubmitter(
+            ConstantDistribution{rate.inv()},
+            sim.scheduler.now() + quiet,
+            sim.scheduler.now() + simDuration - quiet,
+            peerSelector,
+            sim.scheduler,
+            sim.rng);
+
+        sim.run(simDuration);
+
+        auto const& rounds = roundCollector.roundTime;
+        auto const ledgers = roundCollector.ledgers.size();
+        auto const agreePct = ledgers == 0
+            ? 0.0
+            : 100.0 * roundCollector.closeAgree / ledgers;
+        auto const perLedger = ledgers == 0
+            ? 0.0
+            : static_cast<double>(roundCollector.messages()) / ledgers;
+
+        csv << numPeers << "," << to_string(latency) << ","
+            << meanDelay.count() << "," << txPerSec << ","
+            << duration_cast<milliseconds>(simDuration).count() << ","
+            << sim.branches() << "," << (sim.synchronized() ? 1 : 0) << ","
+            << ledgers << "," << ledgerCollector.fullyValidated << ","
+            << toMs(rounds.avg()) << "," << toMs(rounds.percentile(0.5f))
+            << "," << toMs(rounds.percentile(0.9f)) << ","
+            << toMs(rounds.percentile(1.0f)) << "," << agreePct << ","
+            << txCollector.submitted << "," << txCollector.validated << ","
+            << toMs(txCollector.submitToValidate.avg()) << ","
+            << roundCollector.proposals << "," << roundCollector.validations
+            << "," << roundCollector.txs << "," << roundCollector.txSets
+            << "," << roundCollector.other << "," << perLedger << std::endl;
+
+        log << "peers " << numPeers << ", " << to_string(latency)
+            << " latency, " << txPerSec << " tx/s: " << ledgers
+            << " ledgers, round " << toMs(rounds.avg()) << " ms avg, "
+            << roundCollector.messages() << " messages" << std::endl;
+
+        BEAST_EXPECT(sim.branches() == 1);
+    }
+
+    void
+    run() override
+    {
+        std::chrono::seconds duration{60};
+        if (!arg().empty())
+        {
+            std::stringstream argStream(arg());
+            int seconds = 0;
+            if (argStream >> seconds && seconds >= 30)
+                duration = std::chrono::seconds(seconds);
+        }
+
+        std::string const fileName = "ConsensusBenchmark.csv";
+        bool const header = !std::ifstream(fileName).good();
+        std::ofstream csv(fileName, std::ofstream::app);
+        if (header)
+            csv << "peers,latency,mean_delay_ms,tx_per_sec,duration_ms,"
+                   "branches,synchronized,ledgers,fully_validated,"
+                   "round_avg_ms,round_p50_ms,round_p90_ms,round_max_ms,"
+                   "close_agree_pct,tx_submitted,tx_validated,"
+                   "submit_to_validate_avg_ms,proposals,validations,txs,"
+                   "tx_sets,other_messages,messages_per_ledger"
+                << std::endl;
+
+        for (std::size_t const numPeers : {5, 10, 20, 35})
+        {
+            for (auto const latency :
+                 {Latency::fixed, Latency::uniform, Latency::lognormal})
+            {
+                for (std::size_t const txPerSec : {10, 100, 500})
+                    simulate(csv, numPeers, latency, txPerSec, duration);
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ConsensusBenchmark, consensus, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -115,6 +115,38 @@ public:
             checkConsensus(0, 0, 0, 0, 3s, 10s, p, true, journal_));
     }
 
+    void
+    testCheckEarlyConsensus()
+    {
+        ConsensusParms p{};
+
+        // Disabled by default
+        BEAST_EXPECT(!checkEarlyConsensus(4, 4, 4, p, true, journal_));
+
+        p.ledgerEARLY_CONSENSUS_PCT = 90;
+
+        // Everyone agrees
+        BEAST_EXPECT(checkEarlyConsensus(4, 4, 4, p, true, journal_));
+        BEAST_EXPECT(checkEarlyConsensus(4, 4, 4, p, false, journal_));
+
+        // Not everyone has proposed yet
+        BEAST_EXPECT(!checkEarlyConsensus(10, 8, 8, p, true, journal_));
+        BEAST_EXPECT(checkEarlyConsensus(10, 9, 9, p, true, journal_));
+
+        // Too many disagree
+        BEAST_EXPECT(!checkEarlyConsensus(10, 10, 8, p, false, journal_));
+
+        // More proposers than last round
+        BEAST_EXPECT(!checkEarlyConsensus(4, 10, 4, p, true, journal_));
+
+        // Nothing to go by
+        BEAST_EXPECT(!checkEarlyConsensus(0, 0, 0, p, true, journal_));
+
+        // Never below the normal threshold
+        p.ledgerEARLY_CONSENSUS_PCT = 10;
+        BEAST_EXPECT(!checkEarlyConsensus(10, 10, 5, p, true, journal_));
+    }
+
     void
     testStandalone()
     {
@@ -176,6 +208,63 @@ public:
         }
     }
 
+    void
+    testEarlyConsensus()
+    {
+        using namespace csf;
+        using namespace std::chrono;
+
+        // Run a few rounds where every peer sees every transaction at once
+        auto const roundTimes = [this](std::size_t earlyPct) {
+            ConsensusParms const parms{};
+            Sim sim;
+            PeerGroup peers = sim.createGroup(5);
+            for (Peer* p : peers)
+                p->consensusParms.ledgerEARLY_CONSENSUS_PCT = earlyPct;
+
+            peers.trustAndConnect(
+                peers,
+                date::round<milliseconds>(0.2 * parms.ledgerGRANULARITY));
+
+            std::vector<milliseconds> times;
+            for (std::uint32_t round = 0; round < 3; ++round)
+            {
+                for (Peer* p : peers)
+                    p->submit(Tx(
+                        round * peers.size() +
+                        static_cast<std::uint32_t>(p->id)));
+                sim.run(1);
+                if (!BEAST_EXPECT(sim.synchronized()))
+                    return times;
+                for (Peer const* peer : peers)
+                {
+                    BEAST_EXPECT(peer->prevProposers == peers.size() - 1);
+                    // Ledgers hold every transaction applied so far
+                    BEAST_EXPECT(
+                        peer->lastClosedLedger.txs().size() ==
+                        (round + 1) * peers.size());
+                }
+                times.push_back(peers[0]->prevRoundTime);
+            }
+            return times;
+        };
+
+        ConsensusParms const parms{};
+
+        // Every round waits without the fast path
+        for (auto const t : roundTimes(0))
+            BEAST_EXPECT(t >= parms.ledgerMIN_CONSENSUS);
+
+        // The first round has no proposers to go by, later rounds end early
+        auto const times = roundTimes(80);
+        if (BEAST_EXPECT(times.size() == 3))
+        {
+            BEAST_EXPECT(times[0] >= parms.ledgerMIN_CONSENSUS);
+            BEAST_EXPECT(times[1] < parms.ledgerMIN_CONSENSUS);
+            BEAST_EXPECT(times[2] < parms.ledgerMIN_CONSENSUS);
+        }
+    }
+
     void
     testSlowPeers()
     {
@@ -1060,9 +1149,11 @@ public:
     {
         testShouldCloseLedger();
         testCheckConsensus();
+        testCheckEarlyConsensus();
 
         testStandalone();
         testPeersAgree();
+        testEarlyConsensus();
         testSlowPeers();
         testCloseTimeDisagree();
         testWrongLCL();
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/SystemMemory.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/ConfigSections.h>
@@ -1139,6 +1140,179 @@ r.ripple.com 51235
         BEAST_EXPECT(!testDiverged("901"));
     }
 
+    void
+    testLedgerFetch()
+    {
+        testcase("ledger_fetch: striped peers");
+
+        auto testStriped =
+            [](std::string value) -> std::optional<std::size_t> {
+            try
+            {
+                Config c;
+                c.loadFromString("[ledger_fetch]\nstriped_peers=" + value);
+                return c.LEDGER_FETCH_STRIPED_PEERS;
+            }
+            catch (std::exception&)
+            {
+                return {};
+            }
+        };
+
+        // Default
+        BEAST_EXPECT(Config{}.LEDGER_FETCH_STRIPED_PEERS == 0);
+
+        // Failures
+        BEAST_EXPECT(!testStriped("none"));
+        BEAST_EXPECT(!testStriped("1"));
+        BEAST_EXPECT(!testStriped("33"));
+
+        // In bounds
+        BEAST_EXPECT(testStriped("0") == 0);
+        BEAST_EXPECT(testStriped("2") == 2);
+        BEAST_EXPECT(testStriped("32") == 32);
+
+        testcase("ledger_fetch: history ranges");
+
+        auto testHistory = [](std::string value)
+            -> std::optional<std::pair<std::size_t, std::size_t>> {
+            try
+            {
+                Config c;
+                c.loadFromString("[ledger_fetch]\n" + value);
+                return std::make_pair(
+                    c.LEDGER_FETCH_HISTORY_RANGES,
+                    c.LEDGER_FETCH_HISTORY_WRITE_LOAD);
+            }
+            catch (std::exception&)
+            {
+                return {};
+            }
+        };
+
+        // Defaults
+        BEAST_EXPECT(Config{}.LEDGER_FETCH_HISTORY_RANGES == 1);
+        BEAST_EXPECT(Config{}.LEDGER_FETCH_HISTORY_WRITE_LOAD == 4096);
+
+        // Failures
+        BEAST_EXPECT(!testHistory("history_ranges=0"));
+        BEAST_EXPECT(!testHistory("history_ranges=17"));
+        BEAST_EXPECT(!testHistory("history_write_load=0"));
+
+        // In bounds
+        using Sizes = std::pair<std::size_t, std::size_t>;
+        BEAST_EXPECT(
+            testHistory("history_ranges=8\nhistory_write_load=1000") ==
+            Sizes(8, 1000));
+        BEAST_EXPECT(testHistory("history_ranges=16") == Sizes(16, 4096));
+
+        testcase("ledger_fetch: replay");
+
+        BEAST_EXPECT(Config{}.LEDGER_FETCH_REPLAY);
+        {
+            Config c;
+            c.loadFromString("[ledger_fetch]\nreplay=0");
+            BEAST_EXPECT(!c.LEDGER_FETCH_REPLAY);
+        }
+        {
+            Config c;
+            c.loadFromString("[ledger_fetch]\nreplay=1");
+            BEAST_EXPECT(c.LEDGER_FETCH_REPLAY);
+        }
+
+        testcase("ledger_fetch: rpc history");
+
+        BEAST_EXPECT(!Config{}.LEDGER_FETCH_RPC_HISTORY);
+        BEAST_EXPECT(Config{}.LEDGER_FETCH_RPC_HISTORY_CACHE == 16384);
+        {
+            Config c;
+            c.loadFromString(
+                "[ledger_fetch]\nrpc_history=1\nrpc_history_cache=1000");
+            BEAST_EXPECT(c.LEDGER_FETCH_RPC_HISTORY);
+            BEAST_EXPECT(c.LEDGER_FETCH_RPC_HISTORY_CACHE == 1000);
+        }
+        try
+        {
+            Config c;
+            c.loadFromString("[ledger_fetch]\nrpc_history_cache=0");
+            fail();
+        }
+        catch (std::exception const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testTransactionBatch()
+    {
+        testcase("transaction_batch");
+
+        // Defaults
+        {
+            Config c;
+            BEAST_EXPECT(c.TX_BATCH_MAX_SIZE == 256);
+            BEAST_EXPECT(c.TX_BATCH_INTERVAL.count() == 0);
+        }
+
+        {
+            Config c;
+            c.loadFromString("[transaction_batch]\nmax_size=0\ninterval=20");
+            BEAST_EXPECT(c.TX_BATCH_MAX_SIZE == 0);
+            BEAST_EXPECT(c.TX_BATCH_INTERVAL.count() == 20);
+        }
+
+        // Interval above the upper bound
+        try
+        {
+            Config c;
+            c.loadFromString("[transaction_batch]\ninterval=1001");
+            fail();
+        }
+        catch (std::runtime_error&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testNodeSizeAuto()
+    {
+        testcase("node_size: auto");
+
+        std::uint64_t const gb = 1024 * 1024 * 1024;
+        BEAST_EXPECT(Config::autoNodeSize(4 * gb, 2) == 0);
+        BEAST_EXPECT(Config::autoNodeSize(8 * gb, 2) == 1);
+        BEAST_EXPECT(Config::autoNodeSize(16 * gb, 4) == 2);
+        BEAST_EXPECT(Config::autoNodeSize(32 * gb, 8) == 3);
+        BEAST_EXPECT(Config::autoNodeSize(64 * gb, 16) == 4);
+
+        // Too few processors hold back a machine with plenty of memory
+        BEAST_EXPECT(Config::autoNodeSize(64 * gb, 4) == 2);
+        BEAST_EXPECT(Config::autoNodeSize(64 * gb, 1) == 0);
+
+        BEAST_EXPECT(Config::autoCacheBudget(32 * gb) == 4096);
+
+        auto const memory = parseMeminfo(
+            "MemTotal:       32780144 kB\n"
+            "MemFree:         1234567 kB\n"
+            "MemAvailable:   20000000 kB\n");
+        if (BEAST_EXPECT(memory))
+        {
+            BEAST_EXPECT(memory->total == 32780144ull * 1024);
+            BEAST_EXPECT(memory->available == 20000000ull * 1024);
+        }
+        BEAST_EXPECT(!parseMeminfo("MemTotal:       32780144 kB\n"));
+        BEAST_EXPECT(!parseMeminfo("MemTotal: x\nMemAvailable: 1 kB\n"));
+
+        {
+            Config c;
+            c.loadFromString("[node_size]\nauto\n[cache_budget]\n1000\n");
+            BEAST_EXPECT(c.NODE_SIZE <= 4);
+            BEAST_EXPECT(c.CACHE_BUDGET_MB == 1000);
+        }
+    }
+
     void
     run() override
     {
@@ -1154,6 +1328,9 @@ r.ripple.com 51235
         testGetters();
         testAmendment();
         testOverlay();
+        testLedgerFetch();
+        testTransactionBatch();
+        testNodeSizeAuto();
     }
 };
 
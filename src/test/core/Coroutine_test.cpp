@@ -18,9 +18,12 @@
 //==============================================================================
 
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/impl/CoroStack.h>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 #include <test/jtx.h>
 
 namespace ripple {
@@ -159,12 +162,56 @@ public:
         BEAST_EXPECT(*lv == -1);
     }
 
+    void
+    stack_reuse()
+    {
+        testcase("stack reuse");
+
+        using stack = boost::coroutines::stack_context;
+        CoroStackAllocator alloc;
+        auto const size = megabytes(1);
+
+        // A freed stack is handed to the next coroutine
+        std::vector<stack> stacks(CoroStackAllocator::maxFree);
+        for (auto& each : stacks)
+            alloc.allocate(each, size);
+        for (auto& each : stacks)
+            alloc.deallocate(each);
+        BEAST_EXPECT(
+            CoroStackAllocator::freeCount() == CoroStackAllocator::maxFree);
+
+        stack s;
+        alloc.allocate(s, size);
+        BEAST_EXPECT(s.sp == stacks.back().sp);
+        auto const guard = boost::coroutines::stack_traits::page_size();
+        BEAST_EXPECT(s.size > guard);
+        BEAST_EXPECT(
+            CoroStackAllocator::freeCount() == CoroStackAllocator::maxFree - 1);
+
+        // The stack is usable all the way down to its guard page
+        std::fill_n(
+            static_cast<char*>(s.sp) - s.size + guard, s.size - guard, '\xff');
+        alloc.deallocate(s);
+
+        // Stacks beyond the limit are released
+        for (auto& each : stacks)
+            alloc.allocate(each, size);
+        stack extra;
+        alloc.allocate(extra, size);
+        for (auto& each : stacks)
+            alloc.deallocate(each);
+        alloc.deallocate(extra);
+        BEAST_EXPECT(
+            CoroStackAllocator::freeCount() == CoroStackAllocator::maxFree);
+    }
+
     void
     run() override
     {
         correct_order();
         incorrect_order();
         thread_specific_storage();
+        stack_reuse();
     }
 };
 
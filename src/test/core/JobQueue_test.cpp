@@ -20,6 +20,9 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
 #include <test/jtx/Env.h>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -154,12 +157,148 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testPriority()
+    {
+        // A standalone Env has a single worker thread, so once it is busy
+        // every job added after waits in the queue.
+        jtx::Env env{*this};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "JobBlock", [&](Job&) {
+            started = true;
+            while (!release)
+                ;
+        }));
+        while (!started)
+            ;
+
+        std::mutex mutex;
+        std::vector<std::string> order;
+        auto add = [&](JobType type, std::string const& name) {
+            BEAST_EXPECT(jQueue.addJob(type, name, [&, name](Job&) {
+                std::lock_guard lock(mutex);
+                order.push_back(name);
+            }));
+        };
+        add(jtPACK, "pack");
+        add(jtCLIENT, "client1");
+        add(jtADMIN, "admin");
+        add(jtCLIENT, "client2");
+
+        release = true;
+        jQueue.rendezvous();
+
+        // Higher priority types first, and in order within a type
+        std::vector<std::string> const expected{
+            "admin", "client1", "client2", "pack"};
+        BEAST_EXPECT(order == expected);
+    }
+
+    void
+    testDeadlines()
+    {
+        using namespace std::chrono_literals;
+        jtx::Env env{*this};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        jQueue.setDeadlines(true);
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "JobBlock", [&](Job&) {
+            started = true;
+            while (!release)
+                ;
+        }));
+        while (!started)
+            ;
+
+        std::mutex mutex;
+        std::vector<std::string> order;
+        auto add = [&](JobType type, std::string const& name) {
+            BEAST_EXPECT(jQueue.addJob(type, name, [&, name](Job&) {
+                std::lock_guard lock(mutex);
+                order.push_back(name);
+            }));
+        };
+
+        // A local transaction has a 100ms target, while administration
+        // jobs have none but a higher priority.
+        add(jtTRANSACTION_l, "local");
+        BEAST_EXPECT(!jQueue.isBehind(jtPACK));
+        std::this_thread::sleep_for(150ms);
+        add(jtADMIN, "admin");
+
+        BEAST_EXPECT(jQueue.isBehind(jtPACK));
+        BEAST_EXPECT(!jQueue.isBehind(jtTRANSACTION_l));
+        BEAST_EXPECT(!jQueue.isBehind(jtADMIN));
+
+        release = true;
+        jQueue.rendezvous();
+
+        std::vector<std::string> const expected{"local", "admin"};
+        BEAST_EXPECT(order == expected);
+        BEAST_EXPECT(!jQueue.isBehind(jtPACK));
+    }
+
+    void
+    testConsensusLane()
+    {
+        jtx::Env env{*this};
+
+        JobQueue& jQueue = env.app().getJobQueue();
+        jQueue.rendezvous();
+        jQueue.setConsensusThreadCount(1);
+
+        // Occupy the only shared worker thread
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        BEAST_EXPECT(jQueue.addJob(jtCLIENT, "JobBlock", [&](Job&) {
+            started = true;
+            while (!release)
+                ;
+        }));
+        while (!started)
+            ;
+
+        // Trusted proposals and validations still run
+        std::atomic<int> consensus{0};
+        BEAST_EXPECT(jQueue.addJob(
+            jtPROPOSAL_t, "proposal", [&](Job&) { ++consensus; }));
+        BEAST_EXPECT(jQueue.addJob(
+            jtVALIDATION_t, "validation", [&](Job&) { ++consensus; }));
+        while (consensus != 2)
+            ;
+
+        // Other work waits for the shared thread
+        std::atomic<bool> untrusted{false};
+        BEAST_EXPECT(jQueue.addJob(
+            jtPROPOSAL_ut, "untrusted", [&](Job&) { untrusted = true; }));
+        BEAST_EXPECT(jQueue.getJobCount(jtPROPOSAL_ut) == 1);
+
+        release = true;
+        jQueue.rendezvous();
+        BEAST_EXPECT(untrusted);
+
+        auto const json = jQueue.getJson();
+        BEAST_EXPECT(json["consensus"]["threads"] == 1);
+        BEAST_EXPECT(json["consensus"]["jobs"] == "2");
+
+        jQueue.setConsensusThreadCount(0);
+    }
+
 public:
     void
     run() override
     {
         testAddJob();
         testPostCoro();
+        testPriority();
+        testDeadlines();
+        testConsensusLane();
     }
 };
 
@@ -20,6 +20,7 @@
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/ConfigSections.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -355,12 +356,68 @@ public:
             bfs::remove(dbPath);
     }
     void
+    testSQLiteReadSessions()
+    {
+        testcase("readSessions");
+        DatabaseCon::Setup setup;
+        setup.dataDir = getDatabasePath();
+        setup.readSessions = 2;
+        std::array<char const*, 1> const pragma{{"PRAGMA journal_mode=wal;"}};
+        std::array<char const*, 1> const init{
+            {"CREATE TABLE IF NOT EXISTS Seqs (Seq BIGINT UNSIGNED);"}};
+        std::string const dbName = "SociReadTestDB";
+        {
+            DatabaseCon con(setup, dbName, pragma, init);
+            {
+                auto db = con.checkoutDb();
+                *db << "INSERT INTO Seqs VALUES (1);";
+            }
+            {
+                // Readers see what was written, but can't write
+                auto db = con.checkoutReadDb();
+                boost::optional<std::uint64_t> seq;
+                *db << "SELECT MAX(Seq) FROM Seqs;", soci::into(seq);
+                BEAST_EXPECT(seq && *seq == 1);
+
+                bool failed = false;
+                try
+                {
+                    *db << "INSERT INTO Seqs VALUES (2);";
+                }
+                catch (std::exception const&)
+                {
+                    failed = true;
+                }
+                BEAST_EXPECT(failed);
+            }
+            {
+                // Each check out starts looking from the next session
+                auto a = con.checkoutReadDb();
+                auto b = con.checkoutReadDb();
+                BEAST_EXPECT(a.get() != b.get());
+                BEAST_EXPECT(a.get() != &con.getSession());
+            }
+
+            auto const stats = con.readStats();
+            BEAST_EXPECT(stats.count == 3);
+            BEAST_EXPECT(stats.waits == 0);
+        }
+        namespace bfs = boost::filesystem;
+        for (auto const suffix : {"", "-wal", "-shm"})
+        {
+            auto const dbPath = getDatabasePath() / (dbName + suffix);
+            if (bfs::is_regular_file(dbPath))
+                bfs::remove(dbPath);
+        }
+    }
+    void
     testSQLite()
     {
         testSQLiteFileNames();
         testSQLiteSession();
         testSQLiteSelect();
         testSQLiteDeleteWithSubselect();
+        testSQLiteReadSessions();
     }
     void
     run() override
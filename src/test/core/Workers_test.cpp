@@ -54,6 +54,12 @@ class PerfLogTest : public PerfLog
     {
     }
 
+    void
+    rpcBytes(std::string const& method, std::size_t in, std::size_t out)
+        override
+    {
+    }
+
     void
     jobQueue(JobType const type) override
     {
@@ -74,6 +80,14 @@ class PerfLogTest : public PerfLog
     {
     }
 
+    void
+    signaturesVerified(
+        JobType const type,
+        std::size_t count,
+        std::chrono::microseconds dur) override
+    {
+    }
+
     Json::Value
     countersJson() const override
     {
@@ -95,6 +109,12 @@ class PerfLogTest : public PerfLog
     rotate() override
     {
     }
+
+    void
+    setCollector(
+        std::shared_ptr<beast::insight::Collector> const& collector) override
+    {
+    }
 };
 
 }  // namespace perf
@@ -25,7 +25,9 @@
 #include <ripple/json/json_writer.h>
 
 #include <algorithm>
+#include <array>
 #include <regex>
+#include <thread>
 
 namespace ripple {
 
@@ -604,6 +606,52 @@ struct json_value_test : beast::unit_test::suite
         pass();
     }
 
+    void
+    test_parse_strings()
+    {
+        {
+            Json::Value j;
+            Json::Reader r;
+            BEAST_EXPECT(r.parse(
+                R"({"plain":"abc","esc":"a\"b\\c\/d\n","u":"x\u00e9y",)"
+                R"("tail\\":"\t","":""})",
+                j));
+            BEAST_EXPECT(j["plain"] == "abc");
+            BEAST_EXPECT(j["esc"] == "a\"b\\c/d\n");
+            BEAST_EXPECT(j["u"] == "x\xc3\xa9y");
+            BEAST_EXPECT(j["tail\\"] == "\t");
+            BEAST_EXPECT(j[""] == "");
+            BEAST_EXPECT(j.size() == 5);
+        }
+        {
+            // Unterminated, including by an escaped quote
+            Json::Value j;
+            Json::Reader r;
+            BEAST_EXPECT(!r.parse(R"({"a":"abc)", j));
+            BEAST_EXPECT(!r.parse(R"({"a":"abc\"})", j));
+            BEAST_EXPECT(!r.parse(R"({"a":"\q"})", j));
+        }
+        {
+            Json::Value j;
+            Json::Reader r;
+            BEAST_EXPECT(!r.parse(R"({"a":1,"b":2,"a":3})", j));
+            BEAST_EXPECT(
+                r.getFormatedErrorMessages().find("'a' appears twice") !=
+                std::string::npos);
+        }
+        {
+            std::string const first = R"({"method":"sub)";
+            std::string const second = R"(mit","params":[{"a\u0041":1}]})";
+            std::array<boost::asio::const_buffer, 2> const buffers{
+                boost::asio::buffer(first), boost::asio::buffer(second)};
+            Json::Value j;
+            Json::Reader r;
+            BEAST_EXPECT(r.parse(j, buffers));
+            BEAST_EXPECT(j["method"] == "submit");
+            BEAST_EXPECT(j["params"][0u]["aA"] == 1);
+        }
+    }
+
     void
     test_edge_cases()
     {
@@ -844,6 +892,62 @@ struct json_value_test : beast::unit_test::suite
         }
     }
 
+    void
+    test_fast_writer()
+    {
+        testcase("fast writer");
+
+        static Json::StaticString const staticKey("static");
+        auto streamed = [](Json::Value const& v) {
+            std::string s;
+            Json::stream(v, [&s](void const* data, std::size_t n) {
+                s.append(static_cast<char const*>(data), n);
+            });
+            return s;
+        };
+
+        Json::Value v;
+        v[staticKey] = Json::Value::minInt;
+        v["dynamic"] = Json::Value::maxUInt;
+        v["escaped \"key\""] = "tab\tquote\"slash\\bell\x07/";
+        v["real"] = 0.5;
+        v["sparse"][2u] = true;
+        v["sparse"][4u] = "x";
+        v["empty"] = Json::Value(Json::objectValue);
+
+        std::string const expected =
+            "{\"dynamic\":4294967295,\"empty\":{},"
+            "\"escaped \\\"key\\\"\":"
+            "\"tab\\tquote\\\"slash\\\\bell\\u0007/\","
+            "\"real\":0.5,"
+            "\"sparse\":[null,null,true,null,\"x\"],"
+            "\"static\":-2147483648}";
+
+        // Writing twice uses the remembered form of the static key
+        BEAST_EXPECT(Json::FastWriter().write(v) == expected);
+        BEAST_EXPECT(Json::FastWriter().write(v) == expected);
+        BEAST_EXPECT(streamed(v) == expected + "\n");
+
+        // The output round trips
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(expected, parsed));
+        BEAST_EXPECT(Json::FastWriter().write(parsed) == expected);
+
+        // Large values are streamed in several pieces, which add up to
+        // the whole document
+        Json::Value big(Json::arrayValue);
+        for (int i = 0; i < 2000; ++i)
+            big.append(v);
+        std::size_t pieces = 0;
+        std::string s;
+        Json::stream(big, [&](void const* data, std::size_t n) {
+            ++pieces;
+            s.append(static_cast<char const*>(data), n);
+        });
+        BEAST_EXPECT(pieces > 2);
+        BEAST_EXPECT(s == Json::FastWriter().write(big) + "\n");
+    }
+
     void
     test_conversions()
     {
@@ -1372,6 +1476,46 @@ struct json_value_test : beast::unit_test::suite
         }
     }
 
+    void
+    test_pool()
+    {
+        testcase("pool");
+
+        // Strings of every length up to and past the largest pooled block
+        {
+            Json::Value a(Json::arrayValue);
+            for (unsigned i = 0; i < 300; ++i)
+                a.append(std::string(i, 'x'));
+            Json::Value const b = a;
+            for (unsigned i = 0; i < 300; ++i)
+                BEAST_EXPECT(b[i].asString() == std::string(i, 'x'));
+        }
+
+        // Values built on one thread and destroyed on another
+        {
+            std::vector<Json::Value> values(16);
+            std::thread builder([&values]() {
+                for (auto& v : values)
+                {
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        auto const key = std::to_string(i);
+                        v[key]["hash"] = key + " is a member name";
+                        v[key]["index"] = i;
+                    }
+                }
+            });
+            builder.join();
+
+            Json::Value copy = values.back();
+            values.clear();
+            BEAST_EXPECT(copy.size() == 100);
+            BEAST_EXPECT(copy["42"]["index"] == 42);
+            BEAST_EXPECT(
+                copy["42"]["hash"].asString() == "42 is a member name");
+        }
+    }
+
     void
     run() override
     {
@@ -1380,17 +1524,20 @@ struct json_value_test : beast::unit_test::suite
         test_compare();
         test_bool();
         test_bad_json();
+        test_parse_strings();
         test_edge_cases();
         test_copy();
         test_move();
         test_comparisons();
         test_compact();
+        test_fast_writer();
         test_conversions();
         test_access();
         test_removeMember();
         test_iterator();
         test_nest_limits();
         test_leak();
+        test_pool();
     }
 };
 
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/impl/ApplyContext.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+/** Times the invariant checks made after each transaction.
+
+    The checks run over the entries a transaction modified, so this times
+    them for a view holding a number of modified account roots, trust
+    lines and offers. This is a manual suite since the numbers are only
+    meaningful when compared between builds on the same machine.
+*/
+class InvariantsPerf_test : public beast::unit_test::suite
+{
+    static constexpr int rounds = 20000;
+
+    void
+    time(std::size_t accounts)
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env{*this};
+        Account const gw{"gateway"};
+        env.fund(XRP(100000), gw);
+        std::vector<Account> holders;
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            holders.emplace_back("holder" + std::to_string(i));
+            env.fund(XRP(10000), holders.back());
+        }
+        env.close();
+        std::vector<Keylet> offers;
+        for (auto const& holder : holders)
+        {
+            env(trust(holder, gw["USD"](1000)));
+            offers.push_back(keylet::offer(holder.id(), env.seq(holder)));
+            env(offer(holder, XRP(10), gw["USD"](1)));
+        }
+        env.close();
+
+        // Touch the account root, trust line and offer of every holder, as
+        // a transaction crossing many offers would
+        OpenView ov{*env.current()};
+        STTx const tx{ttACCOUNT_SET, [](STObject&) {}};
+        ApplyContext ac{
+            env.app(),
+            ov,
+            tx,
+            tesSUCCESS,
+            safe_cast<FeeUnit64>(env.current()->fees().units),
+            tapNONE,
+            env.journal};
+        for (std::size_t i = 0; i < holders.size(); ++i)
+        {
+            auto const& id = holders[i].id();
+            auto const line = keylet::line(id, gw.id(), gw["USD"].currency);
+            for (auto const& k : {keylet::account(id), line, offers[i]})
+            {
+                if (auto const sle = ac.view().peek(k))
+                    ac.view().update(sle);
+                else
+                    fail("missing ledger entry");
+            }
+        }
+
+        bool ok = true;
+        auto const start = steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+            ok &= ac.checkInvariants(tesSUCCESS, XRPAmount{}) == tesSUCCESS;
+        auto const elapsed = steady_clock::now() - start;
+        BEAST_EXPECT(ok);
+
+        log << ac.size() << " modified entries: "
+            << duration_cast<nanoseconds>(elapsed).count() / rounds
+            << " ns per transaction" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        for (std::size_t accounts : {1, 8, 64})
+            time(accounts);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(InvariantsPerf, ledger, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -49,10 +49,39 @@ struct PendingSaves_test : public beast::unit_test::suite
         BEAST_EXPECT(!ps.pending(0));
     }
 
+    void
+    testQueue()
+    {
+        PendingSaves ps;
+        using Queued = PendingSaves::Queued;
+
+        // Nothing queued, so nothing to write
+        BEAST_EXPECT(ps.dequeue().empty());
+
+        // The first ledger queued starts draining, the rest do not
+        BEAST_EXPECT(ps.enqueue(nullptr) == Queued::start);
+        for (std::size_t i = 1; i < PendingSaves::maxQueued; ++i)
+            BEAST_EXPECT(ps.enqueue(nullptr) == Queued::added);
+        BEAST_EXPECT(ps.enqueue(nullptr) == Queued::full);
+
+        // Ledgers come out in batches until the queue is empty
+        std::size_t total = 0;
+        for (auto batch = ps.dequeue(); !batch.empty(); batch = ps.dequeue())
+        {
+            BEAST_EXPECT(batch.size() <= PendingSaves::maxBatch);
+            total += batch.size();
+        }
+        BEAST_EXPECT(total == PendingSaves::maxQueued);
+
+        // Once drained, the next ledger starts draining again
+        BEAST_EXPECT(ps.enqueue(nullptr) == Queued::start);
+    }
+
     void
     run() override
     {
         testSaves();
+        testQueue();
     }
 };
 
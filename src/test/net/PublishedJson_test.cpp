@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/net/InfoSub.h>
+#include <ripple/server/WSSession.h>
+
+namespace ripple {
+namespace test {
+
+class PublishedJson_test : public beast::unit_test::suite
+{
+    // Write a message out in pieces of at most `bytes`
+    static std::string
+    drain(WSMsg& msg, std::size_t bytes)
+    {
+        std::string out;
+        for (;;)
+        {
+            auto const [done, buffers] = msg.prepare(bytes, [] {});
+            for (auto const& b : buffers)
+                out.append(static_cast<char const*>(b.data()), b.size());
+            if (done)
+                return out;
+        }
+    }
+
+    void
+    testText()
+    {
+        testcase("text");
+
+        Json::Value jv(Json::objectValue);
+        jv["type"] = "transaction";
+        jv["ledger_index"] = 42;
+        jv["validated"] = true;
+
+        PublishedJson const msg(jv);
+        BEAST_EXPECT(&msg.json() == &jv);
+
+        // Serialized once, and the same copy is handed out afterwards
+        auto const text = msg.text();
+        BEAST_EXPECT(text);
+        BEAST_EXPECT(msg.text().get() == text.get());
+
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(*text, parsed));
+        BEAST_EXPECT(parsed == jv);
+
+        // One line, as each subscriber's own copy was written
+        BEAST_EXPECT(text->find('\n') == text->size() - 1);
+    }
+
+    void
+    testSharedMessage()
+    {
+        testcase("shared message");
+
+        auto const text =
+            std::make_shared<std::string const>("{\"type\":\"ledgerClosed\"}");
+
+        // Each session writes the whole text, in the pieces it asks for
+        SharedWSMsg whole(text);
+        SharedWSMsg pieces(text);
+        SharedWSMsg bytes(text);
+        BEAST_EXPECT(drain(whole, 4096) == *text);
+        BEAST_EXPECT(drain(pieces, 5) == *text);
+        BEAST_EXPECT(drain(bytes, 1) == *text);
+
+        SharedWSMsg empty(std::make_shared<std::string const>());
+        BEAST_EXPECT(drain(empty, 16).empty());
+    }
+
+public:
+    void
+    run() override
+    {
+        testText();
+        testSharedMessage();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PublishedJson, net, ripple);
+
+}  // namespace test
+}  // namespace ripple
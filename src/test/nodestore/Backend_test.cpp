@@ -20,6 +20,7 @@
 #include <ripple/beast/utility/temp_dir.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/IoUring.h>
 #include <ripple/unity/rocksdb.h>
 #include <algorithm>
 #include <test/nodestore/TestBase.h>
@@ -37,16 +38,19 @@ public:
     testBackend(
         std::string const& type,
         std::uint64_t const seedValue,
-        int numObjsToTest = 2000)
+        int numObjsToTest = 2000,
+        bool ioUring = false)
     {
         DummyScheduler scheduler;
 
-        testcase("Backend type=" + type);
+        testcase("Backend type=" + type + (ioUring ? " io_uring" : ""));
 
         Section params;
         beast::temp_dir tempDir;
         params.set("type", type);
         params.set("path", tempDir.path());
+        if (ioUring)
+            params.set("io_uring", "1");
 
         beast::xor_shift_engine rng(seedValue);
 
@@ -79,6 +83,24 @@ public:
                 fetchCopyOfBatch(*backend, &copy, batch);
                 BEAST_EXPECT(areBatchesEqual(batch, copy));
             }
+
+            {
+                // Read it back in with a single batch fetch
+                Batch copy;
+                fetchBatchCopyOfBatch(*backend, &copy, batch);
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
+
+            {
+                // Objects which were never stored are returned as null
+                auto const missing = createPredictableBatch(8, rng());
+                Batch copy;
+                fetchBatchCopyOfBatch(*backend, &copy, missing);
+                BEAST_EXPECT(std::all_of(
+                    copy.begin(), copy.end(), [](auto const& object) {
+                        return object == nullptr;
+                    }));
+            }
         }
 
         {
@@ -95,7 +117,114 @@ public:
             std::sort(copy.begin(), copy.end(), LessThan{});
             BEAST_EXPECT(areBatchesEqual(batch, copy));
         }
+
+        {
+            // Re-open the backend read only
+            std::unique_ptr<Backend> backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+            backend->setReadOnly();
+
+            {
+                Batch copy;
+                fetchCopyOfBatch(*backend, &copy, batch);
+                std::sort(copy.begin(), copy.end(), LessThan{});
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
+
+            {
+                Batch copy;
+                fetchBatchCopyOfBatch(*backend, &copy, batch);
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
+
+            auto const missing = createPredictableBatch(8, rng());
+            for (auto const& object : missing)
+            {
+                std::shared_ptr<NodeObject> result;
+                BEAST_EXPECT(
+                    backend->fetch(object->getHash().data(), &result) ==
+                    notFound);
+                BEAST_EXPECT(!result);
+            }
+
+            if (type == "nudb")
+            {
+                try
+                {
+                    backend->store(missing.front());
+                    fail();
+                }
+                catch (std::logic_error const&)
+                {
+                    pass();
+                }
+            }
+        }
+    }
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+    void
+    testColumnFamilies(std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase("Backend type=rocksdb column_families");
+
+        beast::temp_dir tempDir;
+        auto const makeParams = [&](std::string const& name) {
+            Section params;
+            params.set("type", "rocksdb");
+            params.set("path", tempDir.file(name));
+            params.set("column_families", "1");
+            return params;
+        };
+
+        beast::xor_shift_engine rng(seedValue);
+        auto const batch1 = createPredictableBatch(500, rng());
+        auto batch2 = createPredictableBatch(500, rng());
+
+        test::SuiteJournal journal("Backend_test", *this);
+
+        {
+            // Two backends in one database
+            auto backend1 = Manager::instance().make_Backend(
+                makeParams("rippledb.1"), megabytes(4), scheduler, journal);
+            auto backend2 = Manager::instance().make_Backend(
+                makeParams("rippledb.2"), megabytes(4), scheduler, journal);
+            backend1->open();
+            backend2->open();
+
+            storeBatch(*backend1, batch1);
+            storeBatch(*backend2, batch2);
+
+            // Each only holds what was stored in it
+            Batch copy;
+            fetchBatchCopyOfBatch(*backend2, &copy, batch1);
+            BEAST_EXPECT(std::all_of(
+                copy.begin(), copy.end(), [](auto const& object) {
+                    return object == nullptr;
+                }));
+
+            // Dropping one leaves the other alone
+            backend1->setDeletePath();
+        }
+
+        BEAST_EXPECT(!boost::filesystem::exists(tempDir.file("rippledb.1")));
+
+        {
+            auto backend2 = Manager::instance().make_Backend(
+                makeParams("rippledb.2"), megabytes(4), scheduler, journal);
+            backend2->open();
+
+            Batch copy;
+            fetchCopyOfBatch(*backend2, &copy, batch2);
+            std::sort(batch2.begin(), batch2.end(), LessThan{});
+            std::sort(copy.begin(), copy.end(), LessThan{});
+            BEAST_EXPECT(areBatchesEqual(batch2, copy));
+        }
     }
+#endif
 
     //--------------------------------------------------------------------------
 
@@ -105,9 +234,12 @@ public:
         std::uint64_t const seedValue = 50;
 
         testBackend("nudb", seedValue);
+        if (IoUring::available())
+            testBackend("nudb", seedValue, 2000, true);
 
 #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend("rocksdb", seedValue);
+        testColumnFamilies(seedValue);
 #endif
 
 #ifdef RIPPLE_ENABLE_SQLITE_BACKEND_TESTS
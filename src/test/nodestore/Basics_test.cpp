@@ -17,6 +17,9 @@
 */
 //==============================================================================
 
+#include <ripple/basics/Buffer.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/nodestore/AccessTrace.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
@@ -73,7 +76,91 @@ public:
 
                 BEAST_EXPECT(isSame(batch[i], object));
             }
+
+            // Decoding in place refers to the buffer instead of copying it
+            auto const buffer =
+                std::make_shared<Buffer>(encoded.getData(), encoded.getSize());
+            DecodedBlob inPlace(
+                encoded.getKey(), buffer->data(), buffer->size());
+
+            BEAST_EXPECT(inPlace.wasOk());
+
+            if (inPlace.wasOk())
+            {
+                auto const object = inPlace.createObject(buffer);
+
+                BEAST_EXPECT(isSame(batch[i], object));
+                BEAST_EXPECT(object->getData().data() == buffer->data() + 9);
+            }
+        }
+    }
+
+    // Checks that an access trace reads back as it was written
+    void
+    testAccessTrace(std::uint64_t const seedValue)
+    {
+        testcase("access trace");
+
+        auto batch = createPredictableBatch(numObjectsToTest, seedValue);
+
+        beast::temp_dir tempDir;
+        auto const path = tempDir.file("trace");
+        {
+            AccessTrace trace(path, 1);
+            for (int i = 0; i < batch.size(); ++i)
+            {
+                trace.stored(*batch[i], i, std::chrono::microseconds(i));
+                trace.fetched(
+                    batch[i]->getHash(),
+                    i,
+                    i % 2 ? batch[i] : nullptr,
+                    std::chrono::microseconds(2 * i));
+            }
+            BEAST_EXPECT(trace.size() == 2 * batch.size());
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!BEAST_EXPECT(AccessTrace::readHeader(file)))
+            return;
+        for (int i = 0; i < batch.size(); ++i)
+        {
+            auto const& object = *batch[i];
+            auto const size = object.getData().size();
+            for (auto const op :
+                 {AccessTrace::Op::store, AccessTrace::Op::fetch})
+            {
+                auto const found = op == AccessTrace::Op::store || i % 2;
+                auto const entry = AccessTrace::read(file);
+                if (!BEAST_EXPECT(entry))
+                    return;
+                BEAST_EXPECT(entry->op == op);
+                BEAST_EXPECT(entry->found == found);
+                BEAST_EXPECT(
+                    entry->latency.count() ==
+                    (op == AccessTrace::Op::store ? i : 2 * i));
+                BEAST_EXPECT(entry->ledgerSeq == i);
+                BEAST_EXPECT(entry->hash == object.getHash());
+                BEAST_EXPECT(
+                    entry->type == (found ? object.getType() : hotUNKNOWN));
+                BEAST_EXPECT(entry->size == (found ? size : 0));
+            }
         }
+        BEAST_EXPECT(!AccessTrace::read(file));
+
+        // Sampling is by hash, so it picks the same objects every time
+        std::size_t sampled = 0;
+        for (auto const& object : batch)
+        {
+            auto const& hash = object->getHash();
+            BEAST_EXPECT(!AccessTrace::sampled(hash, 0));
+            BEAST_EXPECT(AccessTrace::sampled(hash, 1));
+            if (AccessTrace::sampled(hash, 2))
+                ++sampled;
+            BEAST_EXPECT(
+                AccessTrace::sampled(hash, 4) <=
+                AccessTrace::sampled(hash, 2));
+        }
+        BEAST_EXPECT(sampled > 0 && sampled < batch.size());
     }
 
     void
@@ -84,6 +171,8 @@ public:
         testBatches(seedValue);
 
         testBlobs(seedValue);
+
+        testAccessTrace(seedValue);
     }
 };
 
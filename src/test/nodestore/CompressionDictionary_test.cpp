@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <cstring>
+#include <random>
+
+namespace ripple {
+namespace NodeStore {
+namespace tests {
+
+class CompressionDictionary_test : public beast::unit_test::suite
+{
+    // Builds blobs laid out like encoded state leaves: the same structure
+    // throughout, with a few random fields which are unique to each one.
+    static std::vector<Blob>
+    makeLeaves(std::size_t count, std::uint64_t seed)
+    {
+        beast::xor_shift_engine rng(seed);
+        std::uniform_int_distribution<int> byte(0, 255);
+
+        static std::uint8_t const fixed[] = {
+            0x11, 0x00, 0x61, 0x22, 0x00, 0x00, 0x00, 0x00, 0x24, 0x00,
+            0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x62, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x81,
+            0x14};
+
+        std::vector<Blob> leaves;
+        leaves.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Blob leaf(9, 0);
+            leaf[8] = hotACCOUNT_NODE;
+            leaf.insert(leaf.end(), {'M', 'L', 'N', 0});
+            for (int j = 0; j < 3; ++j)
+            {
+                leaf.insert(leaf.end(), std::begin(fixed), std::end(fixed));
+                for (int k = 0; k < 20; ++k)
+                    leaf.push_back(byte(rng));
+            }
+            for (int k = 0; k < 32; ++k)
+                leaf.push_back(byte(rng));
+            leaves.push_back(std::move(leaf));
+        }
+        return leaves;
+    }
+
+    static Blob
+    roundTrip(Blob const& in, CompressionDictionary const* dictionary)
+    {
+        Buffer compressed;
+        auto const c =
+            nodeobject_compress(in.data(), in.size(), compressed, dictionary);
+        Buffer decompressed;
+        auto const d = nodeobject_decompress(c.first, c.second, decompressed);
+        auto const p = static_cast<std::uint8_t const*>(d.first);
+        return Blob(p, p + d.second);
+    }
+
+public:
+    void
+    testTrain()
+    {
+        testcase("train");
+
+        auto const samples = makeLeaves(2000, 1);
+        auto const data = CompressionDictionary::train(samples, 4096);
+        BEAST_EXPECT(!data.empty());
+        BEAST_EXPECT(data.size() <= 4096);
+
+        // Too few samples to fill the dictionary: use them all.
+        auto const few = makeLeaves(2, 2);
+        BEAST_EXPECT(
+            CompressionDictionary::train(few, 4096).size() ==
+            few[0].size() + few[1].size());
+
+        // Nothing but unique strings: there is nothing worth keeping.
+        beast::xor_shift_engine rng(3);
+        std::vector<Blob> noise(100);
+        for (auto& blob : noise)
+        {
+            blob.resize(500);
+            for (auto& b : blob)
+                b = static_cast<std::uint8_t>(rng());
+        }
+        BEAST_EXPECT(CompressionDictionary::train(noise, 4096).empty());
+    }
+
+    void
+    testCodec()
+    {
+        testcase("codec");
+
+        auto const dictionary = CompressionDictionary::add(
+            std::make_shared<CompressionDictionary const>(
+                CompressionDictionary::train(makeLeaves(2000, 4), 4096)));
+
+        std::size_t plain = 0;
+        std::size_t trained = 0;
+        for (auto const& leaf : makeLeaves(200, 5))
+        {
+            Buffer bf;
+            plain += nodeobject_compress(leaf.data(), leaf.size(), bf).second;
+            auto const c = nodeobject_compress(
+                leaf.data(), leaf.size(), bf, dictionary.get());
+            trained += c.second;
+
+            // The codec type and the dictionary id lead the header.
+            auto const p = static_cast<std::uint8_t const*>(c.first);
+            BEAST_EXPECT(p[0] == 4);
+            BEAST_EXPECT(
+                ((std::uint32_t{p[1]} << 24) | (std::uint32_t{p[2]} << 16) |
+                 (std::uint32_t{p[3]} << 8) | p[4]) == dictionary->id());
+
+            BEAST_EXPECT(roundTrip(leaf, dictionary.get()) == leaf);
+        }
+        log << "lz4: " << plain << " bytes, with dictionary: " << trained
+            << " bytes" << std::endl;
+        BEAST_EXPECT(trained < plain);
+
+        // Inner nodes keep their own codec.
+        Blob inner(525, 0);
+        inner[9] = 'M';
+        inner[10] = 'I';
+        inner[11] = 'N';
+        inner[100] = 1;
+        {
+            Buffer bf;
+            auto const c = nodeobject_compress(
+                inner.data(), inner.size(), bf, dictionary.get());
+            BEAST_EXPECT(static_cast<std::uint8_t const*>(c.first)[0] == 2);
+            BEAST_EXPECT(roundTrip(inner, dictionary.get()) == inner);
+        }
+
+        // An object compressed with a dictionary nobody has registered
+        // cannot be read back.
+        CompressionDictionary const unregistered(Blob(1024, 0x42));
+        auto const leaf = makeLeaves(1, 6).front();
+        Buffer bf;
+        auto const c = nodeobject_compress(
+            leaf.data(), leaf.size(), bf, &unregistered);
+        Buffer out;
+        try
+        {
+            nodeobject_decompress(c.first, c.second, out);
+            fail();
+        }
+        catch (std::exception const&)
+        {
+            pass();
+        }
+        auto const d =
+            nodeobject_decompress(c.first, c.second, out, &unregistered);
+        BEAST_EXPECT(
+            d.second == leaf.size() &&
+            std::memcmp(d.first, leaf.data(), leaf.size()) == 0);
+    }
+
+    void
+    run() override
+    {
+        testTrain();
+        testCodec();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CompressionDictionary, NodeStore, ripple);
+
+}  // namespace tests
+}  // namespace NodeStore
+}  // namespace ripple
@@ -21,11 +21,13 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DatabaseRotatingImp.h>
 #include <test/jtx.h>
 #include <test/jtx/CheckMessageLogs.h>
 #include <test/jtx/envconfig.h>
 #include <test/nodestore/TestBase.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <future>
 
 namespace ripple {
 namespace NodeStore {
@@ -571,6 +573,46 @@ public:
                 fetchCopyOfBatch(*db, &copy, batch);
                 BEAST_EXPECT(areBatchesEqual(batch, copy));
             }
+
+            {
+                // Read it back in with a single batch fetch
+                Batch copy;
+                fetchBatchCopyOfBatch(*db, &copy, batch);
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
+
+            {
+                // Read it back in without waiting, with the cache cleared
+                // so most of it comes from the read threads. A missing
+                // key is found missing.
+                db->tune(0, std::chrono::seconds{0});
+                db->sweep();
+
+                std::vector<uint256> hashes;
+                for (auto const& object : batch)
+                    hashes.push_back(object->getHash());
+                auto const missing = createPredictableBatch(1, rng());
+                hashes.push_back(missing.front()->getHash());
+
+                std::promise<Batch> promise;
+                auto future = promise.get_future();
+                db->fetchBatchAsync(
+                    hashes, 0, FetchPriority::low, [&promise](Batch objects) {
+                        promise.set_value(std::move(objects));
+                    });
+                if (BEAST_EXPECT(
+                        future.wait_for(std::chrono::seconds{30}) ==
+                        std::future_status::ready))
+                {
+                    auto copy = future.get();
+                    if (BEAST_EXPECT(copy.size() == hashes.size()))
+                    {
+                        BEAST_EXPECT(!copy.back());
+                        copy.pop_back();
+                        BEAST_EXPECT(areBatchesEqual(batch, copy));
+                    }
+                }
+            }
         }
 
         if (testPersistence)
@@ -675,6 +717,100 @@ public:
         }
     }
 
+    void
+    testColdBackend(std::int64_t const seedValue)
+    {
+        testcase("cold backend");
+
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+        beast::temp_dir node_db;
+
+        Section config;
+        config.set("type", "nudb");
+
+        int generation = 0;
+        auto makeBackend = [&] {
+            Section params(config);
+            params.set(
+                "path", node_db.path() + "/" + std::to_string(generation++));
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal_);
+            backend->open(true);
+            return backend;
+        };
+
+        std::shared_ptr<Backend> cold = makeBackend();
+        DatabaseRotatingImp rotating(
+            "test",
+            scheduler,
+            1,
+            parent,
+            makeBackend(),
+            makeBackend(),
+            config,
+            journal_,
+            cold);
+        Database& db = rotating;
+        auto rotate = [&] {
+            rotating.rotateWithLock(
+                [&](std::string const&) { return makeBackend(); });
+        };
+        auto clearCaches = [&] {
+            rotating.tune(0, std::chrono::seconds{0});
+            rotating.sweep();
+        };
+
+        auto const batch = createPredictableBatch(numObjectsToTest, seedValue);
+        storeBatch(db, batch);
+
+        // Two rotations push the batch out of both rotating backends
+        rotate();
+        {
+            // The first rotation deleted an empty archive
+            std::shared_ptr<NodeObject> nodeObject;
+            BEAST_EXPECT(
+                cold->fetch(batch.front()->getHash().data(), &nodeObject) ==
+                notFound);
+        }
+        rotate();
+        {
+            Batch copied;
+            cold->for_each([&](std::shared_ptr<NodeObject> nodeObject) {
+                copied.push_back(std::move(nodeObject));
+            });
+            BEAST_EXPECT(copied.size() == batch.size());
+        }
+
+        // But everything is still found, one at a time or in a batch
+        clearCaches();
+        {
+            Batch fetched;
+            for (auto const& object : batch)
+            {
+                if (auto nodeObject = db.fetchNodeObject(object->getHash()))
+                    fetched.push_back(std::move(nodeObject));
+            }
+            BEAST_EXPECT(areBatchesEqual(batch, fetched));
+        }
+
+        // Found objects were written back to the writable backend, and
+        // are still found after the next rotation
+        rotate();
+        clearCaches();
+        {
+            std::vector<uint256> hashes;
+            for (auto const& object : batch)
+                hashes.push_back(object->getHash());
+            auto const fetched = db.fetchBatch(hashes);
+            BEAST_EXPECT(areBatchesEqual(batch, fetched));
+        }
+
+        // A missing key is still missing
+        auto const missing = createPredictableBatch(1, seedValue + 1);
+        BEAST_EXPECT(!db.fetchNodeObject(missing.front()->getHash()));
+    }
+
     //--------------------------------------------------------------------------
 
     void
@@ -707,6 +843,8 @@ public:
             testImport("sqlite", "sqlite", seedValue);
 #endif
         }
+
+        testColdBackend(seedValue);
     }
 };
 
@@ -0,0 +1,318 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/core/Stoppable.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <ripple/protocol/digest.h>
+#include <test/nodestore/TestBase.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+
+namespace ripple {
+namespace NodeStore {
+
+class KeyFilter_test : public TestBase
+{
+    test::SuiteJournal journal_;
+
+    // Forwards to another backend, counting the keys it is asked for
+    class CountingBackend : public Backend
+    {
+        std::unique_ptr<Backend> backend_;
+
+    public:
+        std::atomic<std::size_t> fetches{0};
+
+        explicit CountingBackend(std::unique_ptr<Backend> backend)
+            : backend_(std::move(backend))
+        {
+        }
+
+        std::string
+        getName() override
+        {
+            return backend_->getName();
+        }
+
+        void
+        open(bool createIfMissing) override
+        {
+            backend_->open(createIfMissing);
+        }
+
+        bool
+        isOpen() override
+        {
+            return backend_->isOpen();
+        }
+
+        void
+        close() override
+        {
+            backend_->close();
+        }
+
+        Status
+        fetch(void const* key, std::shared_ptr<NodeObject>* pObject) override
+        {
+            ++fetches;
+            return backend_->fetch(key, pObject);
+        }
+
+        std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+        fetchBatch(std::vector<uint256 const*> const& hashes) override
+        {
+            fetches += hashes.size();
+            return backend_->fetchBatch(hashes);
+        }
+
+        void
+        store(std::shared_ptr<NodeObject> const& object) override
+        {
+            backend_->store(object);
+        }
+
+        void
+        storeBatch(Batch const& batch) override
+        {
+            backend_->storeBatch(batch);
+        }
+
+        void
+        for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
+        {
+            backend_->for_each(f);
+        }
+
+        int
+        getWriteLoad() override
+        {
+            return backend_->getWriteLoad();
+        }
+
+        void
+        setDeletePath() override
+        {
+            backend_->setDeletePath();
+        }
+
+        void
+        verify() override
+        {
+            backend_->verify();
+        }
+
+        int
+        fdRequired() const override
+        {
+            return backend_->fdRequired();
+        }
+    };
+
+    void
+    testFilter()
+    {
+        testcase("filter");
+
+        KeyFilter filter(64 * 1024);
+        BEAST_EXPECT(filter.bytes() == 64 * 1024);
+        BEAST_EXPECT(!filter.mayContain(sha512Half(0)));
+
+        // About 20 bits per key
+        std::uint32_t const count = 25000;
+        for (std::uint32_t i = 0; i < count; ++i)
+            filter.insert(sha512Half(i));
+        BEAST_EXPECT(filter.size() == count);
+
+        // Every key inserted is found
+        bool all = true;
+        for (std::uint32_t i = 0; i < count; ++i)
+            all = all && filter.mayContain(sha512Half(i));
+        BEAST_EXPECT(all);
+
+        // Few keys which were not inserted are
+        std::size_t false_positives = 0;
+        for (std::uint32_t i = count; i < 2 * count; ++i)
+        {
+            if (filter.mayContain(sha512Half(i)))
+                ++false_positives;
+        }
+        BEAST_EXPECT(false_positives < count / 100);
+
+        // A tiny filter still works, if poorly
+        KeyFilter tiny(0);
+        tiny.insert(sha512Half(1));
+        BEAST_EXPECT(tiny.mayContain(sha512Half(1)));
+    }
+
+    void
+    testBlob()
+    {
+        testcase("serialization");
+
+        KeyFilter filter(4096);
+        for (std::uint32_t i = 0; i < 500; ++i)
+            filter.insert(sha512Half(i));
+
+        auto const blob = filter.toBlob();
+        auto const copy = KeyFilter::fromBlob(makeSlice(blob));
+        if (!BEAST_EXPECT(copy))
+            return;
+        BEAST_EXPECT(copy->bytes() == filter.bytes());
+        BEAST_EXPECT(copy->size() == filter.size());
+        BEAST_EXPECT(copy->toBlob() == blob);
+
+        bool same = true;
+        for (std::uint32_t i = 0; i < 1000; ++i)
+        {
+            same = same &&
+                copy->mayContain(sha512Half(i)) ==
+                    filter.mayContain(sha512Half(i));
+        }
+        BEAST_EXPECT(same);
+
+        Blob shortBlob(blob.begin(), blob.end() - 1);
+        BEAST_EXPECT(!KeyFilter::fromBlob(makeSlice(shortBlob)));
+        BEAST_EXPECT(!KeyFilter::fromBlob(Slice{}));
+    }
+
+    void
+    testRotating()
+    {
+        testcase("rotating database");
+
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+        beast::temp_dir node_db;
+
+        Section config;
+        config.set("type", "nudb");
+        config.set("lookup_filter_mb", "1");
+
+        int generation = 0;
+        auto makeBackend = [&] {
+            Section params(config);
+            params.set(
+                "path", node_db.path() + "/" + std::to_string(generation++));
+            auto backend = std::make_unique<CountingBackend>(
+                Manager::instance().make_Backend(
+                    params, megabytes(4), scheduler, journal_));
+            backend->open(true);
+            return backend;
+        };
+
+        auto first = makeBackend();
+        auto second = makeBackend();
+        CountingBackend const& archived = *first;
+        CountingBackend const& writable = *second;
+        DatabaseRotatingImp rotating(
+            "test",
+            scheduler,
+            1,
+            parent,
+            std::move(second),
+            std::move(first),
+            config,
+            journal_);
+        Database& db = rotating;
+
+        CountingBackend* third = nullptr;
+        CountingBackend* fourth = nullptr;
+        auto rotate = [&](CountingBackend*& created) {
+            rotating.rotateWithLock([&](std::string const&) {
+                auto backend = makeBackend();
+                created = backend.get();
+                return backend;
+            });
+        };
+
+        // Keys which are never stored
+        auto const missing = createPredictableBatch(3, 3);
+        auto missingHash = [&](int i) { return missing[i]->getHash(); };
+
+        // Backends opened at startup have no filter, so both are searched
+        storeBatch(db, createPredictableBatch(100, 1));
+        BEAST_EXPECT(!db.fetchNodeObject(missingHash(0)));
+        BEAST_EXPECT(writable.fetches == 1);
+        BEAST_EXPECT(archived.fetches == 1);
+
+        // The new writable backend is skipped, the old one is still searched
+        rotate(third);
+        storeBatch(db, createPredictableBatch(100, 2));
+        BEAST_EXPECT(!db.fetchNodeObject(missingHash(1)));
+        BEAST_EXPECT(third->fetches == 0);
+        BEAST_EXPECT(writable.fetches == 2);
+
+        // Now both backends were created by rotation; neither is searched
+        rotate(fourth);
+        BEAST_EXPECT(!db.fetchNodeObject(missingHash(2)));
+        BEAST_EXPECT(third->fetches == 0);
+        BEAST_EXPECT(fourth->fetches == 0);
+
+        // Everything stored in the archive is still found there
+        auto clearCaches = [&] {
+            rotating.tune(0, std::chrono::seconds{0});
+            rotating.sweep();
+        };
+        auto const stored = createPredictableBatch(100, 2);
+        std::vector<uint256> hashes;
+        for (auto const& object : stored)
+            hashes.push_back(object->getHash());
+        clearCaches();
+        {
+            auto const fetched = db.fetchBatch(hashes);
+            BEAST_EXPECT(std::all_of(
+                fetched.begin(), fetched.end(), [](auto const& object) {
+                    return static_cast<bool>(object);
+                }));
+            BEAST_EXPECT(third->fetches == stored.size());
+        }
+
+        // And was copied to the writable backend, where it is found next
+        clearCaches();
+        auto const nodeObject = db.fetchNodeObject(hashes.front());
+        BEAST_EXPECT(nodeObject && isSame(nodeObject, stored.front()));
+        BEAST_EXPECT(fourth->fetches == 1);
+        BEAST_EXPECT(third->fetches == stored.size());
+    }
+
+public:
+    KeyFilter_test() : journal_("KeyFilter_test", *this)
+    {
+    }
+
+    void
+    run() override
+    {
+        testFilter();
+        testBlob();
+        testRotating();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(KeyFilter, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -175,6 +175,21 @@ public:
         }
     }
 
+    // Get a copy of a batch in a backend with a single batch fetch
+    void
+    fetchBatchCopyOfBatch(Backend& backend, Batch* pCopy, Batch const& batch)
+    {
+        std::vector<uint256 const*> hashes;
+        hashes.reserve(batch.size());
+        for (auto const& object : batch)
+            hashes.push_back(&object->getHash());
+
+        auto [objects, status] = backend.fetchBatch(hashes);
+        BEAST_EXPECT(status == ok);
+        BEAST_EXPECT(objects.size() == batch.size());
+        *pCopy = std::move(objects);
+    }
+
     void
     fetchMissing(Backend& backend, Batch const& batch)
     {
@@ -197,7 +212,7 @@ public:
         {
             std::shared_ptr<NodeObject> const object(batch[i]);
 
-            Blob data(object->getData());
+            Blob data(object->getData().begin(), object->getData().end());
 
             db.store(
                 object->getType(),
@@ -223,6 +238,18 @@ public:
                 pCopy->push_back(object);
         }
     }
+
+    // Fetch all the hashes in one batch, with a single batch fetch.
+    static void
+    fetchBatchCopyOfBatch(Database& db, Batch* pCopy, Batch const& batch)
+    {
+        std::vector<uint256> hashes;
+        hashes.reserve(batch.size());
+        for (auto const& object : batch)
+            hashes.push_back(object->getHash());
+
+        *pCopy = db.fetchBatch(hashes, 0);
+    }
 };
 
 }  // namespace NodeStore
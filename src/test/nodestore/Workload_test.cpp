@@ -0,0 +1,438 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/contract.h>
+#include <ripple/beast/hash/uhash.h>
+#include <ripple/beast/insight/HistogramBuckets.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/nodestore/AccessTrace.h>
+#include <ripple/nodestore/DatabaseShard.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/unity/rocksdb.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <test/unit_test/SuiteJournal.h>
+#include <thread>
+#include <unordered_set>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Replays a node store access pattern against backends.
+
+    The workload is either an access trace captured from a server with
+    the access_trace setting of [node_db], or a synthetic one with a
+    similar shape: objects of a few hundred bytes, mostly state and
+    transaction tree nodes, with most fetches for recently written
+    objects and some for objects which don't exist. Objects a trace
+    fetches before it stores them were already in the server's database,
+    so they are written before the replay starts.
+
+    For each backend this reports throughput, the median and 99th
+    percentile latency of fetches and stores in microseconds, the size on
+    disk relative to the data stored and, where the system reports it, the
+    bytes written to storage relative to the data stored.
+
+    Arguments are separated by semicolons. Each one is a backend
+    configuration, like those of [node_db], or one of
+
+        trace=<path>    Replay a captured trace
+        ops=<count>     Operations in a synthetic workload
+        threads=<count> Threads replaying the workload
+
+    The backend type "shard" stores each ledger's objects in the NuDB
+    backend of the shard holding the ledger, as the shard store does.
+*/
+class Workload_test : public beast::unit_test::suite
+{
+    using Entry = AccessTrace::Entry;
+    using Op = AccessTrace::Op;
+    using clock_type = std::chrono::steady_clock;
+    using Histogram = beast::insight::HistogramBuckets;
+
+    // The ledgers a synthetic workload's existing objects belong to
+    static constexpr std::uint32_t firstLedger = 60000000;
+    static constexpr std::uint32_t historyLedgers =
+        4 * DatabaseShard::ledgersPerShardDefault;
+
+    static std::vector<Entry>
+    synthesize(std::size_t count)
+    {
+        beast::xor_shift_engine gen(1);
+        std::lognormal_distribution<double> size(std::log(300.0), 0.6);
+        std::discrete_distribution<int> type({5, 70, 25});
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        NodeObjectType const types[] = {
+            hotLEDGER, hotACCOUNT_NODE, hotTRANSACTION_NODE};
+
+        auto const makeEntry = [&](Op op, std::uint32_t ledgerSeq) {
+            Entry e{};
+            e.op = op;
+            e.found = true;
+            e.ledgerSeq = ledgerSeq;
+            e.type = types[type(gen)];
+            for (auto& b : e.hash)
+                b = static_cast<std::uint8_t>(gen());
+            e.size = static_cast<std::uint32_t>(
+                std::clamp(size(gen), 40.0, 16384.0));
+            return e;
+        };
+
+        // Objects already in the database, oldest first
+        std::vector<Entry> known;
+        known.reserve(count);
+        for (std::size_t i = 0; i < count / 2; ++i)
+            known.push_back(makeEntry(
+                Op::fetch,
+                firstLedger +
+                    static_cast<std::uint32_t>(i * historyLedgers / count)));
+
+        std::vector<Entry> result;
+        result.reserve(count);
+        auto ledgerSeq = firstLedger + historyLedgers;
+        while (result.size() < count)
+        {
+            auto const p = unit(gen);
+            if (p < 0.25)
+            {
+                // Each ledger writes a couple of hundred objects
+                if (gen() % 200 == 0)
+                    ++ledgerSeq;
+                known.push_back(makeEntry(Op::store, ledgerSeq));
+                result.push_back(known.back());
+            }
+            else if (p < 0.30)
+            {
+                // Fetches for objects which don't exist
+                auto e = makeEntry(Op::fetch, ledgerSeq);
+                e.type = hotUNKNOWN;
+                e.size = 0;
+                e.found = false;
+                result.push_back(e);
+            }
+            else
+            {
+                // Most fetches are for recent objects
+                auto const back = static_cast<std::size_t>(
+                    known.size() * std::pow(unit(gen), 4));
+                auto e = known[known.size() - 1 - back];
+                e.op = Op::fetch;
+                result.push_back(e);
+            }
+        }
+        return result;
+    }
+
+    std::vector<Entry>
+    load(std::string const& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            Throw<std::runtime_error>("Unable to open trace " + path);
+        if (!AccessTrace::readHeader(file))
+            Throw<std::runtime_error>(path + " is not an access trace");
+
+        std::vector<Entry> result;
+        while (auto const e = AccessTrace::read(file))
+            result.push_back(*e);
+        return result;
+    }
+
+    // Object contents are derived from the hash, about a third of them
+    // zeros so they compress about as well as serialized ledger data.
+    static std::shared_ptr<NodeObject>
+    makeObject(Entry const& e)
+    {
+        beast::xor_shift_engine gen(beast::uhash<>{}(e.hash));
+        Blob data(e.size);
+        auto const random = e.size - e.size / 3;
+        for (std::size_t i = 0; i < random; ++i)
+            data[i] = static_cast<std::uint8_t>(gen());
+        return NodeObject::createObject(e.type, std::move(data), e.hash);
+    }
+
+    // One backend, or one per shard
+    class Store
+    {
+    public:
+        Store(
+            Section const& config,
+            boost::filesystem::path const& path,
+            beast::Journal journal)
+            : config_(config), path_(path), journal_(journal)
+        {
+            sharded_ = get(config_, "type", std::string()) == "shard";
+            if (sharded_)
+                config_.set("type", "nudb");
+        }
+
+        void
+        store(std::uint32_t ledgerSeq, std::shared_ptr<NodeObject> obj)
+        {
+            backend(ledgerSeq, true)->store(obj);
+        }
+
+        bool
+        fetch(std::uint32_t ledgerSeq, uint256 const& hash)
+        {
+            std::shared_ptr<NodeObject> obj;
+            if (auto backend = this->backend(ledgerSeq, false))
+                return backend->fetch(hash.data(), &obj) == ok;
+            return false;
+        }
+
+        void
+        close()
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& [index, backend] : backends_)
+                backend->close();
+        }
+
+    private:
+        std::shared_ptr<Backend>
+        backend(std::uint32_t ledgerSeq, bool create)
+        {
+            auto const index = sharded_
+                ? ledgerSeq / DatabaseShard::ledgersPerShardDefault
+                : 0;
+
+            std::lock_guard lock(mutex_);
+            if (auto iter = backends_.find(index); iter != backends_.end())
+                return iter->second;
+            if (!create)
+                return nullptr;
+
+            auto config = config_;
+            auto const path = path_ / std::to_string(index);
+            boost::filesystem::create_directories(path);
+            config.set("path", path.string());
+            std::shared_ptr<Backend> backend = make_Backend(
+                config, megabytes(4), scheduler_, journal_);
+            backend->open();
+            backends_.emplace(index, backend);
+            return backend;
+        }
+
+        Section config_;
+        boost::filesystem::path const path_;
+        beast::Journal const journal_;
+        bool sharded_;
+        DummyScheduler scheduler_;
+        std::mutex mutex_;
+        std::map<std::uint32_t, std::shared_ptr<Backend>> backends_;
+    };
+
+    // Bytes this process has caused to be written to storage, if known
+    static boost::optional<std::uint64_t>
+    bytesWritten()
+    {
+        std::ifstream io("/proc/self/io");
+        std::string name;
+        std::uint64_t value;
+        while (io >> name >> value)
+        {
+            if (name == "write_bytes:")
+                return value;
+        }
+        return boost::none;
+    }
+
+    static std::uint64_t
+    diskSize(boost::filesystem::path const& path)
+    {
+        std::uint64_t size = 0;
+        for (auto const& entry :
+             boost::filesystem::recursive_directory_iterator(path))
+        {
+            if (boost::filesystem::is_regular_file(entry.status()))
+                size += boost::filesystem::file_size(entry.path());
+        }
+        return size;
+    }
+
+    void
+    replay(
+        Section const& config,
+        std::vector<Entry> const& entries,
+        std::size_t threads,
+        beast::Journal journal)
+    {
+        beast::temp_dir dir;
+        Store store(config, dir.path(), journal);
+        auto const writtenBefore = bytesWritten();
+
+        // Write the objects which existed before the trace began
+        std::uint64_t logical = 0;
+        {
+            std::unordered_set<uint256, beast::uhash<>> known;
+            for (auto const& e : entries)
+            {
+                if (!known.insert(e.hash).second)
+                    continue;
+                if (e.op == Op::fetch && e.found)
+                {
+                    store.store(e.ledgerSeq, makeObject(e));
+                    logical += e.size;
+                }
+            }
+        }
+
+        Histogram fetchLatency;
+        Histogram storeLatency;
+        std::atomic<std::uint64_t> stored{0};
+        auto const body = [&](std::size_t first) {
+            std::uint64_t bytes = 0;
+            for (auto i = first; i < entries.size(); i += threads)
+            {
+                auto const& e = entries[i];
+                if (e.op == Op::store)
+                {
+                    auto obj = makeObject(e);
+                    auto const start = clock_type::now();
+                    store.store(e.ledgerSeq, std::move(obj));
+                    storeLatency.insert(
+                        (clock_type::now() - start).count());
+                    bytes += e.size;
+                }
+                else
+                {
+                    auto const start = clock_type::now();
+                    store.fetch(e.ledgerSeq, e.hash);
+                    fetchLatency.insert(
+                        (clock_type::now() - start).count());
+                }
+            }
+            stored += bytes;
+        };
+
+        auto const start = clock_type::now();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+            workers.emplace_back(body, t);
+        for (auto& w : workers)
+            w.join();
+        auto const elapsed =
+            std::chrono::duration<double>(clock_type::now() - start);
+
+        store.close();
+        logical += stored;
+        auto const writtenAfter = bytesWritten();
+
+        auto const fetches = fetchLatency.collect();
+        auto const stores = storeLatency.collect();
+        auto const quantile = [](Histogram::Counts const& counts, double q) {
+            auto const ns = Histogram::percentile(
+                counts, Histogram::total(counts), q);
+            return ns / 1000.0;
+        };
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << std::left << std::setw(8)
+           << get(config, "type", std::string()) << std::right
+           << std::setw(11) << entries.size() / elapsed.count()
+           << std::setw(9) << quantile(fetches, 0.5) << std::setw(9)
+           << quantile(fetches, 0.99) << std::setw(9)
+           << quantile(stores, 0.5) << std::setw(9)
+           << quantile(stores, 0.99) << std::setprecision(2)
+           << std::setw(8)
+           << (logical ? double(diskSize(dir.path())) / logical : 0.0);
+        if (writtenBefore && writtenAfter && logical)
+            ss << std::setw(8)
+               << double(*writtenAfter - *writtenBefore) / logical;
+        else
+            ss << std::setw(8) << "n/a";
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::string const defaultArgs =
+            "type=nudb;type=shard"
+#if RIPPLE_ROCKSDB_AVAILABLE
+            ";type=rocksdb,open_files=2000,filter_bits=12,cache_mb=256,"
+            "file_size_mb=8,file_size_mult=2"
+#endif
+            ;
+
+        std::vector<std::string> args;
+        auto const argString = arg().empty() ? defaultArgs : arg();
+        boost::split(args, argString, boost::algorithm::is_any_of(";"));
+
+        std::string trace;
+        std::size_t ops = 1000000;
+        std::size_t threads = 4;
+        std::vector<Section> configs;
+        for (auto const& a : args)
+        {
+            if (a.empty())
+                continue;
+            if (boost::starts_with(a, "trace="))
+                trace = a.substr(6);
+            else if (boost::starts_with(a, "ops="))
+                ops = std::stoul(a.substr(4));
+            else if (boost::starts_with(a, "threads="))
+                threads = std::max<std::size_t>(1, std::stoul(a.substr(8)));
+            else
+            {
+                Section config;
+                std::vector<std::string> lines;
+                boost::split(lines, a, boost::algorithm::is_any_of(","));
+                config.append(lines);
+                configs.push_back(config);
+            }
+        }
+
+        testcase("Workload", beast::unit_test::abort_on_fail);
+        auto const entries = trace.empty() ? synthesize(ops) : load(trace);
+        log << entries.size() << " operations"
+            << (trace.empty() ? " (synthetic)" : " from " + trace) << ", "
+            << threads << " threads" << std::endl;
+        log << "Backend     ops/sec  fetch50  fetch99  store50  store99"
+               "   space   write"
+            << std::endl;
+
+        test::SuiteJournal journal("Workload_test", *this);
+        for (auto const& config : configs)
+            replay(config, entries, threads, journal);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Workload, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
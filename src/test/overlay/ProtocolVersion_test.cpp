@@ -90,6 +90,15 @@ public:
             BEAST_EXPECT(
                 negotiateProtocolVersion("RTXP/1.2, XRPL/2.0, XRPL/999.999") ==
                 make_protocol(2, 0));
+            BEAST_EXPECT(
+                negotiateProtocolVersion("XRPL/2.0, XRPL/2.1") ==
+                make_protocol(2, 1));
+            BEAST_EXPECT(
+                negotiateProtocolVersion("XRPL/2.1, XRPL/2.2") ==
+                make_protocol(2, 2));
+            BEAST_EXPECT(
+                negotiateProtocolVersion("XRPL/2.2, XRPL/2.3") ==
+                make_protocol(2, 3));
             BEAST_EXPECT(
                 negotiateProtocolVersion("XRPL/999.999, WebSocket/1.0") ==
                 boost::none);
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/overlay/impl/TrafficCount.h>
+#include <limits>
+
+namespace ripple {
+
+class TrafficCount_test : public beast::unit_test::suite
+{
+public:
+    void
+    testHistogram()
+    {
+        testcase("Histogram");
+
+        using namespace std::chrono_literals;
+        TrafficCount::Histogram h;
+        BEAST_EXPECT(h.count() == 0);
+        BEAST_EXPECT(h.json().size() == 0);
+
+        h.add(std::uint64_t{0});
+        h.add(std::uint64_t{1});
+        h.add(std::uint64_t{2});
+        h.add(std::uint64_t{3});
+        h.add(std::uint64_t{1024});
+        h.add(std::numeric_limits<std::uint64_t>::max());
+        BEAST_EXPECT(h.count() == 6);
+
+        auto const json = h.json();
+        BEAST_EXPECT(json.size() == 5);
+        BEAST_EXPECT(json["<1"] == "1");
+        BEAST_EXPECT(json["<2"] == "1");
+        BEAST_EXPECT(json["<4"] == "2");
+        BEAST_EXPECT(json["<2048"] == "1");
+        BEAST_EXPECT(json[">=1073741824"] == "1");
+
+        // Durations are counted in microseconds
+        TrafficCount::Histogram d;
+        d.add(TrafficCount::clock_type::duration{3ms});
+        BEAST_EXPECT(d.json()["<4096"] == "1");
+
+        // Copies keep the counts
+        TrafficCount::Histogram const copy{h};
+        BEAST_EXPECT(copy.count() == h.count());
+    }
+
+    void
+    testLatency()
+    {
+        testcase("Latency");
+
+        using namespace std::chrono_literals;
+        TrafficCount traffic;
+        traffic.addQueued(TrafficCount::category::validation, 5ms);
+        traffic.addHandled(TrafficCount::category::validation, 1ms);
+        traffic.addHandled(TrafficCount::category::validation, 2ms);
+        traffic.addSendQueueDepth(7);
+        traffic.addWriteLatency(10ms);
+
+        auto const& stats =
+            traffic.getCounts()[TrafficCount::category::validation];
+        BEAST_EXPECT(stats.queued.count() == 1);
+        BEAST_EXPECT(stats.handled.count() == 2);
+        BEAST_EXPECT(
+            traffic.getCounts()[TrafficCount::category::proposal]
+                .handled.count() == 0);
+        BEAST_EXPECT(traffic.getSendQueueDepth().json()["<8"] == "1");
+        BEAST_EXPECT(traffic.getWriteLatency().count() == 1);
+    }
+
+    void
+    testCategorize()
+    {
+        testcase("Categorize");
+
+        protocol::TMTransactionVerdicts verdicts;
+        BEAST_EXPECT(
+            TrafficCount::categorize(
+                verdicts, protocol::mtTRANSACTION_VERDICTS, true) ==
+            TrafficCount::category::cluster);
+        BEAST_EXPECT(
+            TrafficCount::categorize(
+                verdicts, protocol::mtTRANSACTION_VERDICTS, false) ==
+            TrafficCount::category::cluster);
+
+        protocol::TMCluster cluster;
+        BEAST_EXPECT(
+            TrafficCount::categorize(cluster, protocol::mtCLUSTER, true) ==
+            TrafficCount::category::cluster);
+    }
+
+    void
+    run() override
+    {
+        testHistogram();
+        testLatency();
+        testCategorize();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TrafficCount, overlay, ripple);
+
+}  // namespace ripple
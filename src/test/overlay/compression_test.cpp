@@ -38,6 +38,8 @@
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/endian/conversion.hpp>
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <ripple.pb.h>
 #include <test/jtx/Account.h>
 #include <test/jtx/Env.h>
@@ -420,10 +422,239 @@ public:
             "TMValidatorList");
     }
 
+    // Collects the messages passed to it, deferring their decoding when
+    // asked to.
+    struct Handler
+    {
+        bool defer = true;
+        compression::Dictionary const* dictionary = nullptr;
+        std::vector<std::function<std::function<bool(Handler&)>()>> decoders;
+        std::shared_ptr<::google::protobuf::Message> last;
+        std::shared_ptr<protocol::TMLedgerData> ledgerData;
+        int begun = 0;
+        int ended = 0;
+
+        bool
+        compressionEnabled() const
+        {
+            return true;
+        }
+
+        compression::Dictionary const*
+        compressionDictionary() const
+        {
+            return dictionary;
+        }
+
+        bool
+        deferDecode(ripple::detail::MessageHeader const&) const
+        {
+            return defer;
+        }
+
+        void
+        decodeDeferred(std::function<std::function<bool(Handler&)>()> decode)
+        {
+            decoders.push_back(std::move(decode));
+        }
+
+        void
+        onMessageUnknown(std::uint16_t)
+        {
+        }
+
+        void
+        onMessageBegin(
+            std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const& m,
+            std::size_t)
+        {
+            last = m;
+            ++begun;
+        }
+
+        void
+        onMessageEnd(
+            std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&)
+        {
+            ++ended;
+        }
+
+        template <class T>
+        void
+        onMessage(std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessage(std::shared_ptr<protocol::TMLedgerData> const& m)
+        {
+            ledgerData = m;
+        }
+    };
+
+    void
+    testDeferredDecode()
+    {
+        testcase("Deferred decode");
+
+        auto logs = std::make_unique<Logs>(beast::severities::kInfo);
+        auto const proto = buildLedgerData(1000, *logs);
+        Message m(*proto, protocol::mtLEDGER_DATA);
+
+        for (auto const compressed : {Compressed::Off, Compressed::On})
+        {
+            // The message must survive its read buffer being reused
+            auto buffer = m.getBuffer(compressed);
+            std::array<boost::asio::const_buffer, 1> const buffers{
+                {boost::asio::buffer(buffer)}};
+
+            Handler handler;
+            std::size_t hint = 0;
+            auto const [consumed, ec] =
+                invokeProtocolMessage(buffers, handler, hint);
+            BEAST_EXPECT(!ec);
+            BEAST_EXPECT(consumed == buffer.size());
+            BEAST_EXPECT(handler.decoders.size() == 1);
+            BEAST_EXPECT(!handler.ledgerData && handler.begun == 0);
+            if (handler.decoders.size() != 1)
+                continue;
+
+            std::fill(buffer.begin(), buffer.end(), 0);
+            auto const dispatch = handler.decoders.front()();
+            BEAST_EXPECT(handler.begun == 0);
+            BEAST_EXPECT(dispatch(handler));
+            BEAST_EXPECT(handler.begun == 1 && handler.ended == 1);
+            BEAST_EXPECT(
+                handler.ledgerData &&
+                handler.ledgerData->SerializeAsString() ==
+                    proto->SerializeAsString());
+
+            // Ledger data is parsed into an arena the message keeps alive
+            BEAST_EXPECT(
+                handler.ledgerData &&
+                handler.ledgerData->GetArena() != nullptr);
+        }
+
+        {
+            // Messages the handler keeps are decoded immediately
+            auto const& buffer = m.getBuffer(Compressed::On);
+            std::array<boost::asio::const_buffer, 1> const buffers{
+                {boost::asio::buffer(buffer)}};
+
+            Handler handler;
+            handler.defer = false;
+            std::size_t hint = 0;
+            auto const [consumed, ec] =
+                invokeProtocolMessage(buffers, handler, hint);
+            BEAST_EXPECT(!ec && consumed == buffer.size());
+            BEAST_EXPECT(handler.decoders.empty());
+            BEAST_EXPECT(handler.ledgerData && handler.ended == 1);
+        }
+
+        {
+            // A malformed message is reported when it is dispatched
+            std::vector<std::uint8_t> buffer(ripple::compression::headerBytes);
+            buffer.resize(buffer.size() + 16, 0xff);
+            buffer[3] = 16;
+            buffer[5] = protocol::mtLEDGER_DATA;
+            std::array<boost::asio::const_buffer, 1> const buffers{
+                {boost::asio::buffer(buffer)}};
+
+            Handler handler;
+            std::size_t hint = 0;
+            auto const [consumed, ec] =
+                invokeProtocolMessage(buffers, handler, hint);
+            BEAST_EXPECT(!ec && consumed == buffer.size());
+            BEAST_EXPECT(handler.decoders.size() == 1);
+            if (handler.decoders.size() == 1)
+            {
+                BEAST_EXPECT(!handler.decoders.front()()(handler));
+                BEAST_EXPECT(!handler.ledgerData && handler.begun == 0);
+            }
+        }
+    }
+
+    void
+    testDictionary()
+    {
+        testcase("Dictionary compression");
+
+        // Validations which differ only in a few bytes, like those of one
+        // validator from ledger to ledger
+        auto const makeValidation = [](std::uint32_t seq) {
+            protocol::TMValidation validation;
+            Serializer s;
+            s.add32(seq);
+            s.addBitString(sha512Half(seq));
+            s.addRaw("a validation for ledger sequence", 32);
+            s.addBitString(sha512Half(std::string("validator")));
+            s.addBitString(sha512Half(seq + 1));
+            validation.set_validation(s.data(), s.size());
+            return validation;
+        };
+
+        std::vector<Blob> samples;
+        for (std::uint32_t seq = 0; seq < 256; ++seq)
+        {
+            auto const payload = makeValidation(seq).SerializeAsString();
+            samples.emplace_back(payload.begin(), payload.end());
+        }
+        auto const dictionary = compression::Dictionary::add(
+            std::make_shared<compression::Dictionary const>(
+                compression::Dictionary::train(samples)));
+
+        auto const validation = makeValidation(1000);
+        Message m(validation, protocol::mtVALIDATION);
+        auto const plain = m.getBuffer(Compressed::Off);
+
+        // Without a dictionary validations are not compressed
+        BEAST_EXPECT(m.getBuffer(Compressed::On) == plain);
+
+        auto const& buffer = m.getBuffer(Compressed::On, dictionary.get());
+        BEAST_EXPECT(buffer.size() < plain.size());
+        BEAST_EXPECT(
+            static_cast<Algorithm>(buffer[0] & 0xF0) ==
+            Algorithm::LZ4Dictionary);
+
+        // Other peers are sent the same buffer
+        BEAST_EXPECT(
+            &m.getBuffer(Compressed::On, dictionary.get()) == &buffer);
+
+        std::array<boost::asio::const_buffer, 1> const buffers{
+            {boost::asio::buffer(buffer)}};
+
+        {
+            Handler handler;
+            handler.dictionary = dictionary.get();
+            std::size_t hint = 0;
+            auto const [consumed, ec] =
+                invokeProtocolMessage(buffers, handler, hint);
+            BEAST_EXPECT(!ec && consumed == buffer.size());
+            BEAST_EXPECT(
+                handler.last &&
+                handler.last->SerializeAsString() ==
+                    validation.SerializeAsString());
+        }
+
+        {
+            // A peer which did not agree on a dictionary can't send one
+            Handler handler;
+            std::size_t hint = 0;
+            auto const [consumed, ec] =
+                invokeProtocolMessage(buffers, handler, hint);
+            BEAST_EXPECT(ec == boost::system::errc::protocol_error);
+            BEAST_EXPECT(!handler.last);
+        }
+    }
+
     void
     run() override
     {
         testProtocol();
+        testDeferredDecode();
+        testDictionary();
     }
 };
 
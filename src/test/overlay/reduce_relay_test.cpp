@@ -1366,6 +1366,37 @@ squelched=1
         });
     }
 
+    /** Transactions from the same signer select peers like the messages
+     * from a validator do.
+     */
+    void
+    testTransactionSource(bool log)
+    {
+        doTest("Transaction Source", log, [&](bool log) {
+            network_.reset();
+            auto const source = randomKeyPair(KeyType::ed25519).first;
+            std::uint16_t squelched = 0;
+            for (int m = 0; m <= squelch::MAX_MESSAGE_THRESHOLD + 1; ++m)
+            {
+                for (Peer::id_t id = 0; id < MAX_PEERS; ++id)
+                    network_.overlay().updateSlotAndSquelch(
+                        uint256(m),
+                        source,
+                        id,
+                        [&](PublicKey const& key, PeerWPtr, std::uint32_t) {
+                            BEAST_EXPECT(key == source);
+                            ++squelched;
+                        },
+                        protocol::mtTRANSACTION);
+            }
+            BEAST_EXPECT(
+                squelched == MAX_PEERS - squelch::MAX_SELECTED_PEERS);
+            BEAST_EXPECT(
+                network_.overlay().inState(
+                    source, squelch::PeerState::Squelched) == squelched);
+        });
+    }
+
     jtx::Env env_;
     Network network_;
 
@@ -1387,6 +1418,7 @@ public:
         testSelectedPeerDisconnects(log);
         testSelectedPeerStopsRelaying(log);
         testInternalHashRouter(log);
+        testTransactionSource(log);
     }
 };
 
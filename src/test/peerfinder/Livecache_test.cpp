@@ -21,10 +21,12 @@
 #include <ripple/basics/safe_cast.h>
 #include <ripple/beast/clock/manual_clock.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/peerfinder/impl/Handouts.h>
 #include <ripple/peerfinder/impl/Livecache.h>
 #include <boost/algorithm/string.hpp>
 #include <test/beast/IPEndpointCommon.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <set>
 
 namespace ripple {
 namespace PeerFinder {
@@ -226,6 +228,48 @@ public:
         BEAST_EXPECT(!all_match);
     }
 
+    void
+    testHandout()
+    {
+        testcase("Handout");
+        Livecache<> c(clock_, journal_);
+        for (auto i = 0; i < 100; ++i)
+            add(beast::IP::randomEP(true), c, 1 + i % Tuning::maxHops);
+        auto const size = c.size();
+
+        struct Target
+        {
+            std::vector<Endpoint> list;
+
+            bool
+            full() const
+            {
+                return list.size() >= 10;
+            }
+
+            bool
+            try_insert(Endpoint const& ep)
+            {
+                list.push_back(ep);
+                return true;
+            }
+        };
+
+        // Endpoints handed out go to the back of the line, so repeated
+        // handouts work through the whole cache before repeating any.
+        std::set<beast::IP::Endpoint> seen;
+        for (std::size_t i = 0; i * 10 < size; ++i)
+        {
+            Target t;
+            handout(&t, &t + 1, c.hops.begin(), c.hops.end());
+            BEAST_EXPECT(t.list.size() == 10);
+            for (auto const& ep : t.list)
+                seen.insert(ep.address);
+        }
+        BEAST_EXPECT(seen.size() == size);
+        BEAST_EXPECT(c.size() == size);
+    }
+
     void
     run() override
     {
@@ -234,6 +278,7 @@ public:
         testExpire();
         testHistogram();
         testShuffle();
+        testHandout();
     }
 };
 
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/digest.h>
+
+namespace ripple {
+
+class Indexes_test : public beast::unit_test::suite
+{
+    static AccountID
+    makeAccount(std::uint32_t i)
+    {
+        AccountID id;
+        auto const digest = sha512Half(i);
+        std::copy(digest.begin(), digest.begin() + id.size(), id.begin());
+        return id;
+    }
+
+    void
+    testMemo()
+    {
+        testcase("remembered keys");
+
+        // Keys come out the same whether or not they were remembered, and
+        // however many other keys share their slot
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (std::uint32_t i = 0; i < 200; ++i)
+            {
+                auto const id = makeAccount(i);
+                auto const other = makeAccount(i + 1000);
+                BEAST_EXPECT(
+                    keylet::account(id).key ==
+                    sha512Half(std::uint16_t('a'), id));
+                BEAST_EXPECT(
+                    keylet::ownerDir(id).key ==
+                    sha512Half(std::uint16_t('O'), id));
+
+                auto const line = keylet::line(id, other, Currency(i));
+                BEAST_EXPECT(line.type == ltRIPPLE_STATE);
+                BEAST_EXPECT(
+                    line.key == keylet::line(other, id, Currency(i)).key);
+                auto const accounts = std::minmax(id, other);
+                BEAST_EXPECT(
+                    line.key ==
+                    sha512Half(
+                        std::uint16_t('r'),
+                        accounts.first,
+                        accounts.second,
+                        Currency(i)));
+            }
+        }
+    }
+
+    void
+    testBatch()
+    {
+        testcase("batches");
+
+        BEAST_EXPECT(keylet::account(std::vector<AccountID>{}).empty());
+        BEAST_EXPECT(
+            keylet::line(makeAccount(0), std::vector<Issue>{}).empty());
+
+        std::vector<AccountID> ids;
+        std::vector<Issue> issues;
+        for (std::uint32_t i = 0; i < 11; ++i)
+        {
+            ids.push_back(makeAccount(i));
+            issues.emplace_back(Currency(i + 1), makeAccount(i + 100));
+        }
+
+        auto const roots = keylet::account(ids);
+        if (BEAST_EXPECT(roots.size() == ids.size()))
+        {
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                BEAST_EXPECT(roots[i].type == ltACCOUNT_ROOT);
+                BEAST_EXPECT(roots[i].key == keylet::account(ids[i]).key);
+            }
+        }
+
+        auto const lines = keylet::line(ids[0], issues);
+        if (BEAST_EXPECT(lines.size() == issues.size()))
+        {
+            for (std::size_t i = 0; i < issues.size(); ++i)
+            {
+                BEAST_EXPECT(lines[i].type == ltRIPPLE_STATE);
+                BEAST_EXPECT(
+                    lines[i].key == keylet::line(ids[0], issues[i]).key);
+            }
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testMemo();
+        testBatch();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Indexes, protocol, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/IOUAmount.h>
+#include <ripple/basics/random.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/STAmount.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace ripple {
+
+// Times the amount arithmetic used when computing qualities and stepping
+// through offers. This is a manual suite since the numbers are only
+// meaningful when compared between builds on the same machine.
+class STAmountPerf_test : public beast::unit_test::suite
+{
+    static constexpr std::size_t count = 4096;
+    static constexpr int rounds = 256;
+
+    void
+    time(std::string const& name, std::function<void(std::size_t)> const& f)
+    {
+        using namespace std::chrono;
+        auto const start = steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                f(i);
+        }
+        auto const elapsed = steady_clock::now() - start;
+        log << name << ": "
+            << duration_cast<nanoseconds>(elapsed).count() / (count * rounds)
+            << " ns" << std::endl;
+        pass();
+    }
+
+public:
+    void
+    run() override
+    {
+        Issue const usd{Currency(0x5553440000000000), AccountID(0x4985601)};
+
+        std::vector<STAmount> ious;
+        std::vector<STAmount> drops;
+        std::vector<std::pair<std::uint64_t, int>> raw;
+        std::vector<IOUAmount> values;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ious.emplace_back(
+                usd,
+                rand_int(STAmount::cMinValue, STAmount::cMaxValue),
+                rand_int(-20, 10));
+            drops.emplace_back(rand_int<std::uint64_t>(1, 100000000000));
+            raw.emplace_back(
+                rand_int<std::uint64_t>() >> rand_int(63), rand_int(-30, 20));
+            values.emplace_back(
+                rand_int<std::int64_t>(-1000000000000000, 1000000000000000),
+                rand_int(-30, 20));
+        }
+
+        STAmount sink;
+        IOUAmount sum;
+        auto next = [](std::size_t i) { return (i * 7 + 1) % count; };
+
+        time("canonicalize IOU", [&](std::size_t i) {
+            sink = STAmount(usd, raw[i].first, raw[i].second);
+        });
+        time("canonicalize XRP", [&](std::size_t i) {
+            sink = STAmount(
+                xrpIssue(), raw[i].first % 100000, raw[i].second % 8);
+        });
+        time("mulRound IOU * IOU", [&](std::size_t i) {
+            sink = mulRound(ious[i], ious[next(i)], usd, true);
+        });
+        time("mulRound XRP * IOU", [&](std::size_t i) {
+            sink = mulRound(drops[i], ious[i], usd, false);
+        });
+        time("divRound IOU / IOU", [&](std::size_t i) {
+            sink = divRound(ious[i], ious[next(i)], usd, true);
+        });
+        time("divRound XRP / IOU", [&](std::size_t i) {
+            sink = divRound(drops[i], ious[i], usd, false);
+        });
+        time("IOU addition", [&](std::size_t i) {
+            sum = values[i] + values[next(i)];
+        });
+
+        BEAST_EXPECT(sink.issue() == sink.issue());
+        BEAST_EXPECT(sum == sum);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STAmountPerf, protocol, ripple);
+
+}  // namespace ripple
@@ -673,6 +673,102 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void
+    testNormalization()
+    {
+        testcase("normalization");
+
+        // Amounts are normalized by scaling by a power of ten at once, so
+        // check them against scaling by ten one step at a time.
+        auto check = [this](std::uint64_t value, int offset) {
+            // Native amounts
+            {
+                auto v = value;
+                auto o = offset;
+                while (o < 0)
+                {
+                    v /= 10;
+                    ++o;
+                }
+                while (o > 0)
+                {
+                    v *= 10;
+                    --o;
+                }
+                bool const valid = v <= STAmount::cMaxNativeN;
+                try
+                {
+                    STAmount const amount(xrpIssue(), value, offset);
+                    BEAST_EXPECT(valid);
+                    BEAST_EXPECT(amount.mantissa() == v);
+                    BEAST_EXPECT(amount.exponent() == 0);
+                }
+                catch (std::runtime_error const&)
+                {
+                    BEAST_EXPECT(!valid);
+                }
+            }
+
+            // Other amounts
+            {
+                auto v = value;
+                auto o = offset;
+                bool valid = true;
+                while (v < STAmount::cMinValue && o > STAmount::cMinOffset)
+                {
+                    v *= 10;
+                    --o;
+                }
+                while (v > STAmount::cMaxValue && valid)
+                {
+                    valid = o < STAmount::cMaxOffset;
+                    v /= 10;
+                    ++o;
+                }
+                if (o < STAmount::cMinOffset || v < STAmount::cMinValue)
+                {
+                    v = 0;
+                    o = -100;
+                }
+                valid = valid && o <= STAmount::cMaxOffset;
+                try
+                {
+                    STAmount const amount(noIssue(), value, offset);
+                    BEAST_EXPECT(valid);
+                    BEAST_EXPECT(amount.mantissa() == v);
+                    BEAST_EXPECT(amount.exponent() == o);
+                }
+                catch (std::runtime_error const&)
+                {
+                    BEAST_EXPECT(!valid);
+                }
+            }
+        };
+
+        std::uint64_t power = 1;
+        for (int digits = 1; digits <= 20; ++digits)
+        {
+            for (int offset : {-120, -97, -96, -20, -1, 0, 1, 19, 78, 80, 81})
+            {
+                check(power, offset);
+                check(power - 1, offset);
+                check(power + 1, offset);
+                check(power * 9 + (power - 1), offset);
+            }
+            if (digits < 20)
+                power *= 10;
+        }
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            check(
+                rand_int<std::uint64_t>() >> rand_int(63),
+                rand_int(-110, 100));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void
     run() override
     {
@@ -680,6 +776,7 @@ public:
         testNativeCurrency();
         testCustomCurrency();
         testArithmetic();
+        testNormalization();
         testUnderflow();
         testRounding();
         testConvertXRP();
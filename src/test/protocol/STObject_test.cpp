@@ -261,6 +261,17 @@ public:
             testInvalid(STI_UINT32, 255);
             testInvalid(STI_VECTOR256, 255);
             testInvalid(STI_OBJECT, 255);
+            testInvalid(STI_UINT32, 256);
+            testInvalid(STI_UINT32, 0xffff);
+        }
+        {
+            // Look up fields by code.
+            BEAST_EXPECT(SField::getField(STI_UINT32, 2) == sfFlags);
+            BEAST_EXPECT(SField::getField(STI_ACCOUNT, 1) == sfAccount);
+            BEAST_EXPECT(
+                SField::getField(sfLedgerEntry.fieldCode) == sfLedgerEntry);
+            BEAST_EXPECT(SField::getField(-1) == sfInvalid);
+            BEAST_EXPECT(SField::getField(0) == sfGeneric);
         }
         {
             // Try to put sfInvalid in an SOTemplate.
@@ -704,6 +715,175 @@ testMalformed()
     }
 }
 
+void
+testLazy()
+{
+    testcase("lazy ledger entries");
+
+    auto const alice = AccountID(0x1234);
+    auto const gw = AccountID(0x5678);
+
+    auto const serialize = [](STObject const& object) {
+        Serializer s;
+        object.add(s);
+        return std::make_shared<Blob const>(s.begin(), s.end());
+    };
+    auto const lazy = [](std::shared_ptr<Blob const> const& data,
+                         uint256 const& key) {
+        return std::make_shared<SLE const>(makeSlice(*data), data, key);
+    };
+
+    {
+        SLE root(keylet::account(alice));
+        root.setAccountID(sfAccount, alice);
+        root.setFieldAmount(sfBalance, STAmount(1000000));
+        root.setFieldU32(sfSequence, 7);
+        root.setFieldU32(sfOwnerCount, 2);
+        root.setFieldU32(sfFlags, lsfRequireDestTag);
+        root.setFieldH256(sfPreviousTxnID, uint256(3));
+        root.setFieldU32(sfPreviousTxnLgrSeq, 9);
+        auto const data = serialize(root);
+        auto const sle = lazy(data, root.key());
+
+        BEAST_EXPECT(sle->getType() == ltACCOUNT_ROOT);
+        BEAST_EXPECT(sle->getFieldU32(sfSequence) == 7);
+        BEAST_EXPECT((*sle)[sfOwnerCount] == 2);
+        BEAST_EXPECT((*sle)[sfBalance] == STAmount(1000000));
+        BEAST_EXPECT(sle->getAccountID(sfAccount) == alice);
+        BEAST_EXPECT(sle->isFlag(lsfRequireDestTag));
+        BEAST_EXPECT(sle->isFieldPresent(sfPreviousTxnID));
+        BEAST_EXPECT(!sle->isFieldPresent(sfRegularKey));
+        BEAST_EXPECT(!(*sle)[~sfRegularKey]);
+        BEAST_EXPECT(!(*sle)[~sfTransferRate]);
+        BEAST_EXPECT((*sle)[~sfSequence] == 7u);
+        BEAST_EXPECT(sle->getFieldU32(sfTransferRate) == 0);
+
+        // Copying shares the data, and changing the copy leaves the
+        // original alone
+        auto copy = std::make_shared<SLE>(*sle);
+        BEAST_EXPECT(copy->getFieldU32(sfSequence) == 7);
+        copy->setFieldU32(sfSequence, 8);
+        (*copy)[sfBalance] = STAmount(500);
+        BEAST_EXPECT(copy->getFieldU32(sfSequence) == 8);
+        BEAST_EXPECT((*copy)[sfBalance] == STAmount(500));
+        BEAST_EXPECT(sle->getFieldU32(sfSequence) == 7);
+
+        // Parsed in full, it is the same as the original
+        BEAST_EXPECT(sle->getCount() == root.getCount());
+        BEAST_EXPECT(*sle == root);
+        BEAST_EXPECT(*serialize(*sle) == *data);
+        BEAST_EXPECT(
+            sle->getJson(JsonOptions::none) == root.getJson(JsonOptions::none));
+        BEAST_EXPECT(sle->getFieldU32(sfSequence) == 7);
+    }
+
+    {
+        // Entries with vectors and arrays of objects
+        SLE dir(keylet::ownerDir(gw));
+        dir.setAccountID(sfOwner, gw);
+        dir.setFieldH256(sfRootIndex, dir.key());
+        STVector256 indexes;
+        for (int i = 0; i < 40; ++i)
+            indexes.push_back(uint256(i));
+        dir.setFieldV256(sfIndexes, indexes);
+        auto const dirData = serialize(dir);
+        auto const lazyDir = lazy(dirData, dir.key());
+        BEAST_EXPECT(lazyDir->getAccountID(sfOwner) == gw);
+        BEAST_EXPECT(lazyDir->getFieldV256(sfIndexes).size() == 40);
+        BEAST_EXPECT(*lazyDir == dir);
+
+        SLE signers(keylet::signers(alice));
+        signers.setFieldU32(sfSignerQuorum, 2);
+        signers.setFieldU32(sfSignerListID, 0);
+        STArray entries(sfSignerEntries);
+        for (auto const& account : {alice, gw})
+        {
+            entries.push_back(STObject(sfSignerEntry));
+            entries.back().setAccountID(sfAccount, account);
+            entries.back().setFieldU16(sfSignerWeight, 1);
+        }
+        signers.setFieldArray(sfSignerEntries, entries);
+        auto const signersData = serialize(signers);
+        auto const lazySigners = lazy(signersData, signers.key());
+        BEAST_EXPECT(lazySigners->getFieldU32(sfSignerQuorum) == 2);
+        BEAST_EXPECT(lazySigners->isFieldPresent(sfSignerEntries));
+        auto const& array = lazySigners->getFieldArray(sfSignerEntries);
+        BEAST_EXPECT(array.size() == 2);
+        BEAST_EXPECT(array[1].getAccountID(sfAccount) == gw);
+        BEAST_EXPECT(*lazySigners == signers);
+    }
+
+    {
+        // Data which doesn't fit the template is parsed at once, and
+        // rejected just as it always was
+        SLE root(keylet::account(alice));
+        root.setAccountID(sfAccount, alice);
+        root.setFieldAmount(sfBalance, STAmount(1));
+        root.setFieldU32(sfSequence, 1);
+        root.makeFieldAbsent(sfOwnerCount);
+        auto const data = serialize(root);
+        try
+        {
+            lazy(data, root.key());
+            fail();
+        }
+        catch (std::exception const&)
+        {
+            pass();
+        }
+    }
+}
+
+void
+testHashing()
+{
+    testcase("hashing");
+
+    // Hashing streams the serialized form rather than building it, and
+    // must give the same digest whatever the sizes of the pieces
+    auto const check = [this](STObject const& object) {
+        Serializer s;
+        s.add32(HashPrefix::ledgerMaster);
+        object.add(s);
+        BEAST_EXPECT(
+            object.getHash(HashPrefix::ledgerMaster) == s.getSHA512Half());
+
+        Serializer signing;
+        signing.add32(HashPrefix::txSign);
+        object.addWithoutSigningFields(signing);
+        BEAST_EXPECT(
+            object.getSigningHash(HashPrefix::txSign) ==
+            signing.getSHA512Half());
+    };
+
+    STObject small(sfGeneric);
+    small.setFieldU32(sfSequence, 7);
+    check(small);
+
+    STObject large(sfGeneric);
+    large.setFieldU32(sfSequence, 7);
+    large.setFieldVL(sfSigningPubKey, Blob(33, 2));
+    large.setFieldVL(sfTxnSignature, Blob(72, 3));
+    large.setFieldVL(sfMemoData, Blob(300, 4));
+    STVector256 indexes;
+    for (int i = 0; i < 100; ++i)
+        indexes.push_back(uint256(i));
+    large.setFieldV256(sfIndexes, indexes);
+    check(large);
+
+    // Copies and moves of pooled Serializers keep their contents
+    Serializer a;
+    a.add32(1234);
+    Serializer b(a);
+    BEAST_EXPECT(b == a);
+    Serializer c(std::move(b));
+    BEAST_EXPECT(c == a);
+    b = c;
+    BEAST_EXPECT(b.getDataLength() == 4);
+    c = Serializer();
+    BEAST_EXPECT(c.getDataLength() == 0);
+}
+
 void
 run() override
 {
@@ -716,6 +896,8 @@ run() override
     testParseJSONArrayWithInvalidChildrenObjects();
     testParseJSONEdgeCases();
     testMalformed();
+    testLazy();
+    testHashing();
 }
 }
 ;
@@ -153,6 +153,7 @@ public:
     {
         testcase("secp256k1 digest");
 
+        boost::optional<PublicKey> otherKey;
         for (std::size_t i = 0; i < 32; i++)
         {
             auto const [pk, sk] = randomKeyPair(KeyType::secp256k1);
@@ -170,6 +171,10 @@ public:
                 BEAST_EXPECT(sig.size() != 0);
                 BEAST_EXPECT(verifyDigest(pk, digest, sig, true));
 
+                // Wrong key:
+                if (otherKey)
+                    BEAST_EXPECT(!verifyDigest(*otherKey, digest, sig, true));
+
                 // Wrong digest:
                 BEAST_EXPECT(!verifyDigest(pk, ~digest, sig, true));
 
@@ -183,6 +188,7 @@ public:
                 // Wrong digest and signature:
                 BEAST_EXPECT(!verifyDigest(pk, ~digest, sig, true));
             }
+            otherKey = pk;
         }
     }
 
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <vector>
+
+namespace ripple {
+
+class digest_test : public beast::unit_test::suite
+{
+    static uint256
+    expected(Slice const& s)
+    {
+        sha512_half_hasher h;
+        h(s.data(), s.size());
+        return static_cast<sha512_half_hasher::result_type>(h);
+    }
+
+    void
+    testBatch()
+    {
+        testcase("sha512HalfBatch");
+
+        BEAST_EXPECT(sha512HalfBatch({}).empty());
+
+        std::vector<std::uint8_t> data(1024);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::uint8_t>(i * 7 + 3);
+
+        // Lengths around the padding and block boundaries, including the
+        // 516 byte inner node encoding
+        std::vector<std::size_t> const sizes = {
+            0, 1, 32, 111, 112, 113, 127, 128, 129, 239, 240, 255, 256, 516};
+
+        // Every batch size, so that each lane and the leftover path are
+        // exercised, with lengths that differ between lanes
+        for (std::size_t count = 1; count <= 9; ++count)
+        {
+            for (std::size_t first = 0; first < sizes.size(); ++first)
+            {
+                std::vector<Slice> messages;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    auto const size = sizes[(first + i * 5) % sizes.size()];
+                    messages.emplace_back(data.data() + i, size);
+                }
+
+                auto const digests = sha512HalfBatch(messages);
+                BEAST_EXPECT(digests.size() == count);
+                for (std::size_t i = 0; i < count; ++i)
+                    BEAST_EXPECT(digests[i] == expected(messages[i]));
+            }
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testBatch();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(digest, protocol, ripple);
+
+}  // namespace ripple
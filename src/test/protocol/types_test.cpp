@@ -32,10 +32,46 @@ struct types_test : public beast::unit_test::suite
             BEAST_EXPECT(toBase58(*parseBase58<AccountID>(s)) == s);
     }
 
+    void
+    testBase58()
+    {
+        // Leading zero bytes are encoded as leading zero digits
+        BEAST_EXPECT(toBase58(AccountID{}) == "rrrrrrrrrrrrrrrrrrrrrhoLvTp");
+        BEAST_EXPECT(
+            toBase58(AccountID{1}) == "rrrrrrrrrrrrrrrrrrrrBZbvji");
+        BEAST_EXPECT(parseBase58<AccountID>("rrrrrrrrrrrrrrrrrrrrrhoLvTp"));
+
+        // Encoding reuses recently encoded accounts, so encode accounts
+        // which share a cache slot, more than once
+        for (std::uint32_t i = 0; i < 1000; ++i)
+        {
+            AccountID id{i * 2654435761u};
+            *id.begin() = static_cast<std::uint8_t>(i % 3);
+            for (int j = 0; j < 2; ++j)
+            {
+                auto const s = toBase58(id);
+                auto const parsed = parseBase58<AccountID>(s);
+                if (!BEAST_EXPECT(parsed && *parsed == id))
+                    return;
+            }
+        }
+
+        // Characters outside the alphabet, and a changed digit which
+        // fails the checksum
+        for (auto const bad :
+             {"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyT0",
+              "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTl",
+              "rHb9CJAWyB4rj91VRWn96Dkuk\xff"
+              "bwdtyTh",
+              "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTi"})
+            BEAST_EXPECT(!parseBase58<AccountID>(bad));
+    }
+
     void
     run() override
     {
         testAccountID();
+        testBase58();
     }
 };
 
@@ -17,12 +17,17 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerToJson.h>
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/TxFlags.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
 
+#include <set>
+
 namespace ripple {
 
 namespace RPC {
@@ -1139,6 +1144,60 @@ public:
         BEAST_EXPECT(linesEnd.isMember(jss::id) && linesEnd[jss::id] == 5);
     }
 
+    void
+    testAccountLinesBinary()
+    {
+        testcase("account_lines binary");
+
+        using namespace test::jtx;
+        Env env(*this);
+
+        Account const alice{"alice"};
+        Account const gw{"gw"};
+        env.fund(XRP(10000), alice, gw);
+        env(trust(alice, gw["USD"](100)));
+        env(trust(alice, gw["EUR"](100)));
+        env(trust(alice, gw["CNY"](100)));
+        env.close();
+
+        Json::Value params;
+        params[jss::account] = alice.human();
+        params[jss::binary] = true;
+        params[jss::limit] = 2;
+        auto lines = env.rpc("json", "account_lines", to_string(params));
+        auto const& first = lines[jss::result];
+        if (!BEAST_EXPECT(first[jss::lines].size() == 2))
+            return;
+        if (!BEAST_EXPECT(first.isMember(jss::marker)))
+            return;
+
+        std::set<std::string> indexes;
+        auto const check = [&](Json::Value const& line) {
+            uint256 index;
+            BEAST_EXPECT(index.parseHex(line[jss::index].asString()));
+            auto const data = strUnHex(line[jss::data].asString());
+            if (!BEAST_EXPECT(data))
+                return;
+            SerialIter sit(makeSlice(*data));
+            STLedgerEntry const sle(sit, index);
+            BEAST_EXPECT(sle.getType() == ltRIPPLE_STATE);
+            BEAST_EXPECT(
+                serializeHex(*env.closed()->read(keylet::unchecked(index))) ==
+                line[jss::data].asString());
+            indexes.insert(line[jss::index].asString());
+        };
+        for (auto const& line : first[jss::lines])
+            check(line);
+
+        params[jss::marker] = first[jss::marker];
+        lines = env.rpc("json", "account_lines", to_string(params));
+        auto const& second = lines[jss::result];
+        BEAST_EXPECT(!second.isMember(jss::marker));
+        for (auto const& line : second[jss::lines])
+            check(line);
+        BEAST_EXPECT(indexes.size() == 3);
+    }
+
     void
     run() override
     {
@@ -1146,6 +1205,7 @@ public:
         testAccountLineDelete();
         testAccountLines2();
         testAccountLineDelete2();
+        testAccountLinesBinary();
     }
 };
 
@@ -1709,6 +1709,62 @@ public:
             (asAdmin ? RPC::Tuning::bookOffers.rdefault : 0u));
     }
 
+    void
+    testBookOfferSnapshot()
+    {
+        testcase("BookOffer Snapshot");
+        using namespace jtx;
+        Env env{*this};
+        Account gw{"gw"};
+        Account alice{"alice"};
+        auto USD = gw["USD"];
+        env.fund(XRP(10000), gw, alice);
+        env.trust(USD(100), alice);
+        env(pay(gw, alice, USD(15)));
+        env.close();
+
+        // Alice can only fund her offers in part
+        env(offer(alice, XRP(100), USD(10)));
+        env(offer(alice, XRP(100), USD(10)));
+        env(offer(gw, XRP(300), USD(10)));
+        env.close();
+
+        Json::Value jvParams;
+        jvParams[jss::limit] = 3;
+        jvParams[jss::ledger_index] = "validated";
+        jvParams[jss::taker_pays][jss::currency] = "XRP";
+        jvParams[jss::taker_gets][jss::currency] = "USD";
+        jvParams[jss::taker_gets][jss::issuer] = gw.human();
+        auto jrr =
+            env.rpc("json", "book_offers", to_string(jvParams))[jss::result];
+        auto const first = jrr[jss::offers];
+        if (!BEAST_EXPECT(first.isArray() && first.size() == 3))
+            return;
+        BEAST_EXPECT(first[0u][jss::Account] == alice.human());
+        BEAST_EXPECT(first[0u][jss::owner_funds] == "15");
+        BEAST_EXPECT(first[1u][jss::taker_gets_funded][jss::value] == "5");
+        BEAST_EXPECT(!first[1u].isMember(jss::owner_funds));
+        BEAST_EXPECT(first[2u][jss::Account] == gw.human());
+
+        // Reading the book again from the same ledger gives the same offers
+        jrr = env.rpc("json", "book_offers", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(jrr[jss::offers] == first);
+
+        jvParams[jss::limit] = 2;
+        jrr = env.rpc("json", "book_offers", to_string(jvParams))[jss::result];
+        if (BEAST_EXPECT(jrr[jss::offers].size() == 2))
+        {
+            BEAST_EXPECT(jrr[jss::offers][0u] == first[0u]);
+            BEAST_EXPECT(jrr[jss::offers][1u] == first[1u]);
+        }
+
+        // The open ledger is read directly, and holds the same book
+        jvParams[jss::limit] = 3;
+        jvParams[jss::ledger_index] = "current";
+        jrr = env.rpc("json", "book_offers", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(jrr[jss::offers] == first);
+    }
+
     void
     run() override
     {
@@ -1726,6 +1782,7 @@ public:
         testBookOfferErrors();
         testBookOfferLimits(true);
         testBookOfferLimits(false);
+        testBookOfferSnapshot();
     }
 };
 
@@ -29,6 +29,8 @@
 #include <test/jtx/Env.h>
 #include <test/jtx/envconfig.h>
 #include <test/rpc/GRPCTestClientBase.h>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -125,11 +127,46 @@ class Fee_test : public beast::unit_test::suite
         BEAST_EXPECT(fee.open_ledger_fee().drops() == openLedgerFee.drops());
     }
 
+    void
+    testFeeGrpcThreads()
+    {
+        testcase("Test Fee Grpc on several threads");
+
+        using namespace test::jtx;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        (*config)["port_grpc"].set("threads", "4");
+        (*config)["port_grpc"].set("inline", "1");
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+        env.close();
+
+        auto const seq = env.current()->info().seq;
+
+        // Calls from several clients at once are answered on whichever
+        // thread picks them up, without going through the JobQueue
+        std::vector<std::pair<bool, org::xrpl::rpc::v1::GetFeeResponse>>
+            results(8);
+        std::vector<std::thread> clients;
+        for (auto& result : results)
+            clients.emplace_back([&result, &grpcPort, this]() {
+                result = grpcGetFee(grpcPort);
+            });
+        for (auto& client : clients)
+            client.join();
+
+        for (auto const& result : results)
+        {
+            BEAST_EXPECT(result.first);
+            BEAST_EXPECT(result.second.ledger_current_index() == seq);
+        }
+    }
+
 public:
     void
     run() override
     {
         testFeeGrpc();
+        testFeeGrpcThreads();
     }
 };
 
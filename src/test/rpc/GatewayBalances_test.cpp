@@ -148,6 +148,78 @@ public:
         }
     }
 
+    void
+    testCarriedForward()
+    {
+        testcase("totals carried forward");
+
+        using namespace jtx;
+        Env env(*this);
+
+        Account const gw{"gw"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        Account const hw{"hw"};
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        env.fund(XRP(10000), gw, alice, bob, hw);
+        env(trust(alice, USD(1000)));
+        env(trust(bob, USD(1000)));
+        env(trust(hw, USD(1000)));
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(200)));
+        env(pay(gw, hw, USD(300)));
+        env.close();
+
+        auto const query = [&](std::string const& ledger) {
+            Json::Value params;
+            params[jss::account] = gw.human();
+            params[jss::hotwallet] = hw.human();
+            params[jss::ledger_index] = ledger;
+            return env.rpc("json", "gateway_balances", to_string(params))
+                [jss::result];
+        };
+
+        auto const expectSame = [&]() {
+            // The closed ledger's totals are carried forward, while the
+            // open ledger, holding no transactions, is walked afresh
+            auto const carried = query("closed");
+            auto const walked = query("current");
+            BEAST_EXPECT(carried[jss::obligations] == walked[jss::obligations]);
+            BEAST_EXPECT(carried[jss::balances] == walked[jss::balances]);
+            BEAST_EXPECT(carried[jss::assets] == walked[jss::assets]);
+            BEAST_EXPECT(
+                carried[jss::frozen_balances] == walked[jss::frozen_balances]);
+            return carried;
+        };
+
+        auto result = expectSame();
+        BEAST_EXPECT(result[jss::obligations]["USD"] == "300");
+
+        // Change, add and freeze lines
+        env(pay(alice, bob, USD(50)));
+        env(trust(alice, EUR(1000)));
+        env(pay(gw, alice, EUR(10)));
+        env(trust(gw, bob["USD"](0), tfSetFreeze));
+        env.close();
+
+        result = expectSame();
+        BEAST_EXPECT(result[jss::obligations]["USD"] == "50");
+        BEAST_EXPECT(result[jss::obligations]["EUR"] == "10");
+        BEAST_EXPECT(
+            result[jss::frozen_balances][bob.human()][0u][jss::value] ==
+            "250");
+
+        // Empty a line
+        env(pay(alice, gw, USD(50)));
+        env.close();
+
+        result = expectSame();
+        BEAST_EXPECT(!result[jss::obligations].isMember("USD"));
+        BEAST_EXPECT(
+            result[jss::balances][hw.human()][0u][jss::value] == "300");
+    }
+
     void
     run() override
     {
@@ -155,6 +227,7 @@ public:
         auto const sa = supported_amendments();
         testGWB(sa - featureFlowCross);
         testGWB(sa);
+        testCarriedForward();
     }
 };
 
@@ -21,6 +21,9 @@
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
+#include <test/rpc/GRPCTestClientBase.h>
+#include <optional>
+#include <vector>
 
 namespace ripple {
 
@@ -491,6 +494,204 @@ public:
         }
     }
 
+    class GetLedgerDataClient : public test::GRPCTestClientBase
+    {
+    public:
+        org::xrpl::rpc::v1::GetLedgerDataRequest request;
+        std::vector<org::xrpl::rpc::v1::GetLedgerDataResponse> replies;
+
+        explicit GetLedgerDataClient(std::string const& port)
+            : GRPCTestClientBase(port)
+        {
+        }
+
+        void
+        GetLedgerData()
+        {
+            auto reader = stub_->GetLedgerData(&context, request);
+            org::xrpl::rpc::v1::GetLedgerDataResponse reply;
+            while (reader->Read(&reply))
+                replies.push_back(reply);
+            status = reader->Finish();
+        }
+
+        std::vector<uint256>
+        keys() const
+        {
+            std::vector<uint256> result;
+            for (auto const& reply : replies)
+            {
+                for (auto const& object : reply.ledger_objects())
+                    result.push_back(uint256::fromVoid(object.key().data()));
+            }
+            return result;
+        }
+    };
+
+    void
+    testGrpc()
+    {
+        testcase("gRPC stream");
+
+        using namespace test::jtx;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+        Account const gw{"gateway"};
+        env.fund(XRP(100000), gw);
+        for (auto i = 0; i < 20; ++i)
+            env.fund(XRP(1000), Account{"bob" + std::to_string(i)});
+        env.close();
+
+        auto const ledger = env.closed();
+        std::vector<uint256> keys;
+        for (auto const& sle : ledger->sles)
+            keys.push_back(sle->key());
+
+        {
+            // Everything, in batches
+            GetLedgerDataClient client(grpcPort);
+            client.request.mutable_ledger()->set_sequence(ledger->info().seq);
+            client.request.set_limit(7);
+            client.GetLedgerData();
+            if (!BEAST_EXPECT(client.status.ok()))
+                return;
+            BEAST_EXPECT(client.replies.size() == (keys.size() + 6) / 7);
+            BEAST_EXPECT(client.keys() == keys);
+            for (auto const& reply : client.replies)
+            {
+                BEAST_EXPECT(reply.ledger_index() == ledger->info().seq);
+                BEAST_EXPECT(
+                    uint256::fromVoid(reply.ledger_hash().data()) ==
+                    ledger->info().hash);
+                for (auto const& object : reply.ledger_objects())
+                {
+                    auto const key = uint256::fromVoid(object.key().data());
+                    SerialIter sit(object.data().data(), object.data().size());
+                    STLedgerEntry const sle(sit, key);
+                    BEAST_EXPECT(*ledger->read(keylet::unchecked(key)) == sle);
+                }
+            }
+        }
+        {
+            // Two partitions cover the ledger exactly
+            auto const middle = keys[keys.size() / 2];
+
+            GetLedgerDataClient low(grpcPort);
+            low.request.set_end_marker(middle.data(), middle.size());
+            low.GetLedgerData();
+            BEAST_EXPECT(low.status.ok());
+
+            GetLedgerDataClient high(grpcPort);
+            high.request.set_marker(middle.data(), middle.size());
+            high.GetLedgerData();
+            BEAST_EXPECT(high.status.ok());
+
+            auto const lowKeys = low.keys();
+            auto const highKeys = high.keys();
+            BEAST_EXPECT(lowKeys.size() == keys.size() / 2 + 1);
+            BEAST_EXPECT(lowKeys.back() == middle);
+            BEAST_EXPECT(lowKeys.size() + highKeys.size() == keys.size());
+            BEAST_EXPECT(std::equal(
+                highKeys.begin(),
+                highKeys.end(),
+                keys.begin() + lowKeys.size()));
+        }
+        {
+            // Nothing past the last key, but the ledger is still reported
+            GetLedgerDataClient client(grpcPort);
+            client.request.set_marker(keys.back().data(), keys.back().size());
+            client.GetLedgerData();
+            BEAST_EXPECT(client.status.ok());
+            BEAST_EXPECT(client.replies.size() == 1);
+            BEAST_EXPECT(client.keys().empty());
+        }
+        {
+            GetLedgerDataClient client(grpcPort);
+            client.request.set_marker("short");
+            client.GetLedgerData();
+            BEAST_EXPECT(
+                client.status.error_code() ==
+                grpc::StatusCode::INVALID_ARGUMENT);
+        }
+        {
+            // The open ledger is not a fixed snapshot to download
+            GetLedgerDataClient client(grpcPort);
+            client.request.mutable_ledger()->set_shortcut(
+                org::xrpl::rpc::v1::LedgerSpecifier::SHORTCUT_CURRENT);
+            client.GetLedgerData();
+            BEAST_EXPECT(
+                client.status.error_code() ==
+                grpc::StatusCode::INVALID_ARGUMENT);
+        }
+    }
+
+    void
+    testEndMarker()
+    {
+        testcase("end marker");
+
+        using namespace test::jtx;
+        Env env{*this, envconfig(no_admin)};
+        for (auto i = 0; i < 20; ++i)
+            env.fund(XRP(1000), Account{"bob" + std::to_string(i)});
+        env.close();
+
+        auto const fetch = [&](std::optional<std::string> marker,
+                               std::optional<std::string> endMarker) {
+            std::vector<std::string> keys;
+            while (true)
+            {
+                Json::Value jvParams;
+                jvParams[jss::ledger_index] = "closed";
+                jvParams[jss::binary] = true;
+                jvParams[jss::limit] = 3;
+                if (marker)
+                    jvParams[jss::marker] = *marker;
+                if (endMarker)
+                    jvParams[jss::end_marker] = *endMarker;
+                auto const jrr = env.rpc(
+                    "json",
+                    "ledger_data",
+                    boost::lexical_cast<std::string>(jvParams))[jss::result];
+                for (auto const& entry : jrr[jss::state])
+                    keys.push_back(entry[jss::index].asString());
+                if (!jrr.isMember(jss::marker))
+                    return keys;
+                marker = jrr[jss::marker].asString();
+            }
+        };
+
+        auto const all = fetch(std::nullopt, std::nullopt);
+        if (!BEAST_EXPECT(all.size() > 20))
+            return;
+
+        // Split the keys into two ranges and fetch them separately
+        auto const& mid = all[all.size() / 2];
+        auto const first = fetch(std::nullopt, mid);
+        auto const second = fetch(mid, std::nullopt);
+        BEAST_EXPECT(first.size() == all.size() / 2 + 1);
+        BEAST_EXPECT(first.back() == mid);
+
+        auto joined = first;
+        joined.insert(joined.end(), second.begin(), second.end());
+        BEAST_EXPECT(joined == all);
+
+        {
+            // invalid end marker
+            Json::Value jvParams;
+            jvParams[jss::end_marker] = "NOT_A_MARKER";
+            auto const jrr = env.rpc(
+                "json",
+                "ledger_data",
+                boost::lexical_cast<std::string>(jvParams))[jss::result];
+            BEAST_EXPECT(jrr[jss::error] == "invalidParams");
+            BEAST_EXPECT(
+                jrr[jss::error_message] ==
+                "Invalid field 'end_marker', not valid.");
+        }
+    }
+
     void
     run() override
     {
@@ -499,8 +700,10 @@ public:
         testCurrentLedgerBinary();
         testBadInput();
         testMarkerFollow();
+        testEndMarker();
         testLedgerHeader();
         testLedgerType();
+        testGrpc();
     }
 };
 
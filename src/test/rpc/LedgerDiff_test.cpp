@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+#include <algorithm>
+
+namespace ripple {
+
+class LedgerDiff_test : public beast::unit_test::suite
+{
+    static bool
+    contains(Json::Value const& keys, uint256 const& key)
+    {
+        auto const s = to_string(key);
+        for (auto const& k : keys)
+        {
+            if (k.asString() == s)
+                return true;
+        }
+        return false;
+    }
+
+    static Json::Value
+    ledgerDiff(test::jtx::Env& env, std::uint32_t seq)
+    {
+        return env.rpc("ledger_diff", std::to_string(seq))[jss::result];
+    }
+
+    void
+    testChanges()
+    {
+        testcase("changes");
+
+        using namespace test::jtx;
+        Env env{*this};
+        Account const alice{"alice"};
+        Account const gw{"gw"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), alice, gw);
+        env.close();
+        {
+            auto const jrr = ledgerDiff(env, env.closed()->seq());
+            BEAST_EXPECT(jrr[jss::status] == "success");
+            auto const& created = jrr[jss::created];
+            auto const& modified = jrr[jss::modified];
+            BEAST_EXPECT(contains(created, keylet::account(alice).key));
+            BEAST_EXPECT(contains(created, keylet::account(gw).key));
+            BEAST_EXPECT(contains(modified, keylet::account(env.master).key));
+            BEAST_EXPECT(jrr[jss::deleted].size() == 0);
+        }
+
+        auto const offerSeq = env.seq(alice);
+        env(offer(alice, USD(10), XRP(10)));
+        env.close();
+        auto const offer = keylet::offer(alice, offerSeq).key;
+        {
+            auto const jrr = ledgerDiff(env, env.closed()->seq());
+            BEAST_EXPECT(contains(jrr[jss::created], offer));
+            BEAST_EXPECT(
+                contains(jrr[jss::created], keylet::ownerDir(alice).key));
+            BEAST_EXPECT(
+                contains(jrr[jss::modified], keylet::account(alice).key));
+        }
+
+        env(offer_cancel(alice, offerSeq));
+        env.close();
+        {
+            auto const jrr = ledgerDiff(env, env.closed()->seq());
+            BEAST_EXPECT(contains(jrr[jss::deleted], offer));
+            BEAST_EXPECT(!contains(jrr[jss::created], offer));
+            BEAST_EXPECT(!contains(jrr[jss::modified], offer));
+        }
+    }
+
+    void
+    testRediscover()
+    {
+        testcase("changes found again");
+
+        using namespace test::jtx;
+        Env env{*this};
+        Account const alice{"alice"};
+        env.fund(XRP(10000), alice);
+        env.close();
+        env(noop(alice));
+        env.close();
+
+        auto const ledger =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        if (!BEAST_EXPECT(ledger))
+            return;
+        auto const built = ledger->stateDelta();
+        if (!BEAST_EXPECT(built))
+            return;
+        BEAST_EXPECT(std::is_sorted(built->begin(), built->end()));
+
+        // Forgotten, the changes are loaded or worked out from the parent
+        ledger->setStateDelta(nullptr);
+        auto const found = getStateDelta(env.app(), ledger);
+        if (BEAST_EXPECT(found))
+            BEAST_EXPECT(*found == *built);
+    }
+
+    void
+    testErrors()
+    {
+        testcase("errors");
+
+        using namespace test::jtx;
+        Env env{*this};
+        env.close();
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = "current";
+        auto const jrr = env.rpc(
+            "json", "ledger_diff", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(jrr[jss::error] == "lgrNotValidated");
+
+        auto const missing = ledgerDiff(env, 1000);
+        BEAST_EXPECT(missing[jss::error] == "lgrNotFound");
+    }
+
+public:
+    void
+    run() override
+    {
+        testChanges();
+        testRediscover();
+        testErrors();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerDiff, app, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/ResponseCache.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class ResponseCache_test : public beast::unit_test::suite
+{
+    void
+    testDisabled()
+    {
+        testcase("disabled by default");
+        using namespace jtx;
+
+        Env env{*this};
+        auto const& cache = env.app().getResponseCache();
+        BEAST_EXPECT(!cache.enabled());
+
+        Account const alice{"alice"};
+        env.fund(XRP(1000), alice);
+        env.close();
+
+        Json::Value params;
+        params[jss::account] = alice.human();
+        params[jss::ledger_index] = "validated";
+        env.rpc("json", "account_info", to_string(params));
+        BEAST_EXPECT(cache.size() == 0);
+    }
+
+    void
+    testValidated()
+    {
+        testcase("validated ledger");
+        using namespace jtx;
+
+        Env env{*this, envconfig([](std::unique_ptr<Config> cfg) {
+                    cfg->RPC_CACHE_SIZE = 16;
+                    return cfg;
+                })};
+        auto const& cache = env.app().getResponseCache();
+        BEAST_EXPECT(cache.enabled());
+
+        Account const alice{"alice"};
+        env.fund(XRP(1000), alice);
+        env.close();
+
+        auto const balance = [](Json::Value const& reply) {
+            return reply[jss::result][jss::account_data][sfBalance.jsonName];
+        };
+
+        Json::Value params;
+        params[jss::account] = alice.human();
+        params[jss::ledger_index] = "validated";
+        auto const first = env.rpc("json", "account_info", to_string(params));
+        BEAST_EXPECT(balance(first) == XRP(1000).value().getText());
+        BEAST_EXPECT(cache.size() == 1);
+        BEAST_EXPECT(cache.hits() == 0);
+
+        // The same parameters in another order are answered from the cache
+        auto const second = env.rpc(
+            "json",
+            "account_info",
+            "{\"ledger_index\": \"validated\", \"account\": \"" +
+                alice.human() + "\"}");
+        BEAST_EXPECT(cache.hits() == 1);
+        BEAST_EXPECT(second[jss::result] == first[jss::result]);
+
+        // Other ledgers are not cached
+        Json::Value current;
+        current[jss::account] = alice.human();
+        current[jss::ledger_index] = "current";
+        env.rpc("json", "account_info", to_string(current));
+        BEAST_EXPECT(cache.size() == 1);
+        BEAST_EXPECT(cache.hits() == 1);
+
+        // Nor are errors
+        Json::Value missing;
+        missing[jss::account] = Account{"bob"}.human();
+        missing[jss::ledger_index] = "validated";
+        env.rpc("json", "account_info", to_string(missing));
+        BEAST_EXPECT(cache.size() == 1);
+
+        // A new validated ledger drops every result
+        env(pay(env.master, alice, XRP(500)));
+        env.close();
+        auto const third = env.rpc("json", "account_info", to_string(params));
+        BEAST_EXPECT(balance(third) == XRP(1500).value().getText());
+        BEAST_EXPECT(cache.size() == 1);
+        BEAST_EXPECT(cache.hits() == 1);
+    }
+
+    void
+    testLimit()
+    {
+        testcase("size limit");
+
+        RPC::ResponseCache cache(2);
+        uint256 const ledger{1};
+        Json::Value result;
+        result[jss::validated] = true;
+
+        BEAST_EXPECT(!cache.fetch(ledger, "a"));
+        cache.insert(ledger, "a", result);
+        cache.insert(ledger, "b", result);
+        cache.insert(ledger, "c", result);
+        BEAST_EXPECT(cache.size() == 2);
+        BEAST_EXPECT(cache.fetch(ledger, "a"));
+        BEAST_EXPECT(!cache.fetch(ledger, "c"));
+
+        // Results computed from a ledger the cache has moved past are
+        // dropped
+        uint256 const next{2};
+        BEAST_EXPECT(!cache.fetch(next, "a"));
+        BEAST_EXPECT(cache.size() == 0);
+        cache.insert(ledger, "a", result);
+        BEAST_EXPECT(cache.size() == 0);
+        cache.insert(next, "a", result);
+        if (auto const hit = cache.fetch(next, "a"); BEAST_EXPECT(hit))
+            BEAST_EXPECT(*hit == result);
+    }
+
+public:
+    void
+    run() override
+    {
+        testDisabled();
+        testValidated();
+        testLimit();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ResponseCache, rpc, ripple);
+
+}  // namespace test
+}  // namespace ripple
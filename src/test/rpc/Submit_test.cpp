@@ -52,6 +52,24 @@ public:
         }
     };
 
+    class SubmitMultipleClient : public GRPCTestClientBase
+    {
+    public:
+        org::xrpl::rpc::v1::SubmitTransactionsRequest request;
+        org::xrpl::rpc::v1::SubmitTransactionsResponse reply;
+
+        explicit SubmitMultipleClient(std::string const& port)
+            : GRPCTestClientBase(port)
+        {
+        }
+
+        void
+        SubmitTransactions()
+        {
+            status = stub_->SubmitTransactions(&context, request, &reply);
+        }
+    };
+
     struct TestData
     {
         std::string xrpTxBlob;
@@ -260,6 +278,104 @@ public:
         }
     }
 
+    void
+    testSubmitMultiple()
+    {
+        testcase("Submit multiple");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        env.fund(XRP(TestData::fund), alice, bob);
+        env.close();
+
+        // Enough transactions for their signatures to be checked by
+        // several jobs
+        Json::Value params;
+        auto& blobs = params[jss::tx_blobs] = Json::arrayValue;
+        auto const first = env.seq(alice);
+        Json::UInt const count = 70;
+        for (Json::UInt i = 0; i < count; ++i)
+        {
+            auto const jt = env.jt(pay(alice, bob, XRP(1)), seq(first + i));
+            blobs.append(strHex(jt.stx->getSerializer().slice()));
+        }
+
+        // A blob which does not parse, and a repeated transaction which
+        // shares the result of the first
+        auto bad = blobs[0u].asString();
+        std::reverse(bad.begin(), bad.end());
+        blobs.append(bad);
+        blobs.append(blobs[0u]);
+
+        auto const jr = env.rpc(
+            "json", "submit_multiple", to_string(params))[jss::result];
+        auto const& results = jr[jss::results];
+        if (!BEAST_EXPECT(results.size() == count + 2))
+            return;
+        for (Json::UInt i = 0; i < count; ++i)
+            BEAST_EXPECT(results[i][jss::engine_result] == "tesSUCCESS");
+        BEAST_EXPECT(results[count][jss::error] == "invalidTransaction");
+        BEAST_EXPECT(results[count + 1][jss::engine_result] == "tesSUCCESS");
+
+        env.close();
+        BEAST_EXPECT(env.seq(alice) == first + count);
+        BEAST_EXPECT(env.balance(bob) == XRP(TestData::fund + count));
+
+        // Malformed requests
+        {
+            auto const jr =
+                env.rpc("json", "submit_multiple", "{}")[jss::result];
+            BEAST_EXPECT(jr[jss::error] == "invalidParams");
+        }
+        {
+            Json::Value params;
+            params[jss::tx_blobs] = Json::arrayValue;
+            auto const jr = env.rpc(
+                "json", "submit_multiple", to_string(params))[jss::result];
+            BEAST_EXPECT(jr[jss::error] == "invalidParams");
+        }
+    }
+
+    void
+    testSubmitMultipleGrpc()
+    {
+        testcase("Submit multiple over gRPC");
+
+        using namespace jtx;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        env.fund(XRP(TestData::fund), "alice", "bob");
+        env.trust(bob["USD"](TestData::fund), alice);
+        env.close();
+
+        SubmitMultipleClient client(grpcPort);
+        client.request.add_signed_transactions(testData.xrpTxBlob);
+        client.request.add_signed_transactions("deadbeef");
+        client.request.add_signed_transactions(testData.usdTxBlob);
+        client.SubmitTransactions();
+        if (!BEAST_EXPECT(client.status.ok()))
+            return;
+        if (!BEAST_EXPECT(client.reply.results_size() == 3))
+            return;
+
+        auto const& xrp = client.reply.results(0);
+        BEAST_EXPECT(xrp.error().empty());
+        BEAST_EXPECT(xrp.engine_result().result() == "tesSUCCESS");
+        BEAST_EXPECT(xrp.hash() == testData.xrpTxHash);
+
+        BEAST_EXPECT(!client.reply.results(1).error().empty());
+        BEAST_EXPECT(client.reply.results(1).hash().empty());
+
+        auto const& usd = client.reply.results(2);
+        BEAST_EXPECT(usd.engine_result().result() == "tesSUCCESS");
+        BEAST_EXPECT(usd.hash() == testData.usdTxHash);
+    }
+
     void
     run() override
     {
@@ -267,6 +383,8 @@ public:
         testSubmitGoodBlobGrpc();
         testSubmitErrorBlobGrpc();
         testSubmitInsufficientFundsGrpc();
+        testSubmitMultiple();
+        testSubmitMultipleGrpc();
     }
 };
 
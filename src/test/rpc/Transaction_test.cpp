@@ -268,11 +268,41 @@ class Transaction_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testBinaryMeta()
+    {
+        testcase("Binary metadata");
+
+        using namespace test::jtx;
+
+        Env env(*this);
+        env.fund(XRP(1000), "alice", "bob");
+        env(pay("alice", "bob", XRP(10)));
+        auto const id = env.tx()->getTransactionID();
+        env.close();
+
+        auto const stored = env.closed()->txRead(id).second;
+        if (!BEAST_EXPECT(stored))
+            return;
+
+        auto const binary = env.rpc("tx", to_string(id), "binary");
+        BEAST_EXPECT(binary[jss::result][jss::status] == jss::success);
+        BEAST_EXPECT(
+            binary[jss::result][jss::meta] ==
+            strHex(stored->getSerializer().peekData()));
+
+        auto const json = env.rpc("tx", to_string(id));
+        BEAST_EXPECT(
+            json[jss::result][jss::meta][sfTransactionResult.jsonName] ==
+            "tesSUCCESS");
+    }
+
 public:
     void
     run() override
     {
         testRangeRequest();
+        testBinaryMeta();
     }
 };
 
@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/insight/HistogramBuckets.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/jss.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/optional.hpp>
+#include <boost/predef.h>
+#include <test/jtx.h>
+#include <test/jtx/JSONRPCClient.h>
+#include <test/jtx/WSClient.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !BOOST_OS_WINDOWS
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace ripple {
+namespace test {
+
+/** Measures the latency and cost of RPC requests under load.
+
+    A number of clients, some using JSON-RPC over HTTP and the rest
+    WebSocket, each send a random mix of requests to the server as fast as
+    it answers them. This reports the requests answered per second, the
+    median, 90th and 99th percentile and longest latency of each command
+    in microseconds, and the CPU time the server used per request: the
+    CPU time of the whole process less that of the client threads.
+
+    Then a number of WebSocket clients subscribe to the ledger and
+    transaction streams while ledgers with a few payments in each are
+    closed, and this reports how long after each close started the
+    subscribers were told of it, and how many messages were delivered.
+
+    Arguments are separated by semicolons:
+
+        clients=<count>      Clients sending requests, 16 by default
+        ws=<count>           Of those, clients using WebSocket, half by
+                             default
+        requests=<count>     Requests sent by each client, 1000 by default
+        subscribers=<count>  Subscribed clients, 50 by default
+        closes=<count>       Ledgers closed for the subscribers, 10 by
+                             default
+        server_info=<weight>, account_info=<weight>, book_offers=<weight>,
+        ledger=<weight>, fee=<weight>
+                             The mix of requests, by default 30, 30, 20,
+                             10 and 10
+*/
+class ServerLoad_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+    using Histogram = beast::insight::HistogramBuckets;
+
+    static constexpr std::size_t commandCount = 5;
+
+    static constexpr char const* commandNames[commandCount] =
+        {"server_info", "account_info", "book_offers", "ledger", "fee"};
+
+    struct Setup
+    {
+        std::size_t clients = 16;
+        boost::optional<std::size_t> wsClients;
+        std::size_t requests = 1000;
+        std::size_t subscribers = 50;
+        std::size_t closes = 10;
+        std::vector<double> weights{30, 30, 20, 10, 10};
+    };
+
+    // The CPU time used by the process
+    static boost::optional<std::chrono::nanoseconds>
+    processTime()
+    {
+#if BOOST_OS_WINDOWS
+        return boost::none;
+#else
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return boost::none;
+        using namespace std::chrono;
+        return nanoseconds(
+            seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+            microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec));
+#endif
+    }
+
+    // The CPU time used by the calling thread
+    static boost::optional<std::chrono::nanoseconds>
+    threadTime()
+    {
+#if BOOST_OS_WINDOWS
+        return boost::none;
+#else
+        timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+            return boost::none;
+        using namespace std::chrono;
+        return nanoseconds(seconds(ts.tv_sec) + nanoseconds(ts.tv_nsec));
+#endif
+    }
+
+    static std::string
+    describe(Histogram& latency)
+    {
+        auto const counts = latency.collect();
+        auto const total = Histogram::total(counts);
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << std::setw(9) << total;
+        for (auto const q : {0.5, 0.9, 0.99, 1.0})
+            ss << std::setw(10)
+               << Histogram::percentile(counts, total, q) / 1000.0;
+        return ss.str();
+    }
+
+    Setup
+    parseArgs()
+    {
+        Setup setup;
+        std::vector<std::string> args;
+        boost::split(args, arg(), boost::algorithm::is_any_of(";"));
+        for (auto const& a : args)
+        {
+            if (a.empty())
+                continue;
+            auto const eq = a.find('=');
+            if (eq == std::string::npos)
+                Throw<std::runtime_error>("Malformed argument: " + a);
+            auto const key = a.substr(0, eq);
+            auto const value = a.substr(eq + 1);
+            if (key == "clients")
+                setup.clients = std::stoul(value);
+            else if (key == "ws")
+                setup.wsClients = std::stoul(value);
+            else if (key == "requests")
+                setup.requests = std::stoul(value);
+            else if (key == "subscribers")
+                setup.subscribers = std::stoul(value);
+            else if (key == "closes")
+                setup.closes = std::stoul(value);
+            else
+            {
+                auto const command = std::find_if(
+                    std::begin(commandNames),
+                    std::end(commandNames),
+                    [&](char const* name) { return key == name; });
+                if (command == std::end(commandNames))
+                    Throw<std::runtime_error>("Unknown argument: " + a);
+                setup.weights[command - std::begin(commandNames)] =
+                    std::stod(value);
+            }
+        }
+        return setup;
+    }
+
+    void
+    testRequests(
+        jtx::Env& env,
+        Setup const& setup,
+        std::vector<jtx::Account> const& accounts,
+        jtx::IOU const& USD)
+    {
+        if (setup.clients == 0 || setup.requests == 0)
+            return;
+
+        auto const wsClients = std::min(
+            setup.wsClients.value_or(setup.clients / 2), setup.clients);
+        std::vector<std::unique_ptr<AbstractClient>> clients;
+        for (std::size_t i = 0; i < setup.clients; ++i)
+        {
+            if (i < wsClients)
+                clients.push_back(makeWSClient(env.app().config()));
+            else
+                clients.push_back(makeJSONRPCClient(env.app().config()));
+        }
+
+        auto const makeParams = [&](std::size_t command,
+                                    beast::xor_shift_engine& gen) {
+            Json::Value params(Json::objectValue);
+            switch (command)
+            {
+                case 1:
+                    params[jss::account] =
+                        accounts[gen() % accounts.size()].human();
+                    break;
+                case 2:
+                    params[jss::taker_pays][jss::currency] = "XRP";
+                    params[jss::taker_gets][jss::currency] = "USD";
+                    params[jss::taker_gets][jss::issuer] =
+                        USD.account.human();
+                    break;
+                case 3:
+                    params[jss::ledger_index] = "closed";
+                    params[jss::transactions] = true;
+                    params[jss::expand] = true;
+                    break;
+                default:
+                    break;
+            }
+            return params;
+        };
+
+        std::array<Histogram, commandCount> latency;
+        std::atomic<std::size_t> failures{0};
+        std::atomic<std::int64_t> clientTime{0};
+        std::atomic<bool> cpuKnown{true};
+
+        auto const body = [&](std::size_t index) {
+            auto const startTime = threadTime();
+            beast::xor_shift_engine gen(index + 1);
+            std::discrete_distribution<std::size_t> pick(
+                setup.weights.begin(), setup.weights.end());
+            auto& client = *clients[index];
+            for (std::size_t i = 0; i < setup.requests; ++i)
+            {
+                auto const command = pick(gen);
+                auto const params = makeParams(command, gen);
+                auto const start = clock_type::now();
+                auto const jv = client.invoke(commandNames[command], params);
+                latency[command].insert(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        clock_type::now() - start)
+                        .count());
+                if (!jv.isMember(jss::result) ||
+                    jv[jss::result][jss::status] != jss::success)
+                    ++failures;
+            }
+            auto const endTime = threadTime();
+            if (startTime && endTime)
+                clientTime += (*endTime - *startTime).count();
+            else
+                cpuKnown = false;
+        };
+
+        auto const processBefore = processTime();
+        auto const start = clock_type::now();
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < clients.size(); ++i)
+            threads.emplace_back(body, i);
+        for (auto& t : threads)
+            t.join();
+        auto const elapsed =
+            std::chrono::duration<double>(clock_type::now() - start);
+        auto const processAfter = processTime();
+
+        auto const total = setup.clients * setup.requests;
+        log << setup.clients << " clients (" << wsClients << " WebSocket), "
+            << total << " requests, " << failures << " failed" << std::endl;
+        log << "Command          count     p50us     p90us     p99us"
+               "     maxus"
+            << std::endl;
+        for (std::size_t c = 0; c < commandCount; ++c)
+        {
+            std::stringstream ss;
+            ss << std::left << std::setw(13) << commandNames[c]
+               << describe(latency[c]);
+            log << ss.str() << std::endl;
+        }
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << total / elapsed.count()
+           << " requests per second";
+        if (cpuKnown && processBefore && processAfter)
+        {
+            auto const serverTime = (*processAfter - *processBefore).count() -
+                clientTime.load();
+            ss << ", " << std::max<std::int64_t>(serverTime, 0) / 1000.0 / total
+               << " us of server CPU per request";
+        }
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(failures == 0);
+    }
+
+    void
+    testSubscriptions(
+        jtx::Env& env,
+        Setup const& setup,
+        std::vector<jtx::Account> const& accounts)
+    {
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        if (setup.subscribers == 0 || setup.closes == 0)
+            return;
+
+        std::vector<std::unique_ptr<WSClient>> subscribers;
+        for (std::size_t i = 0; i < setup.subscribers; ++i)
+        {
+            subscribers.push_back(makeWSClient(env.app().config()));
+            Json::Value params;
+            params[jss::streams] = Json::arrayValue;
+            params[jss::streams].append(jss::ledger);
+            params[jss::streams].append(jss::transactions);
+            auto const jv = subscribers.back()->invoke("subscribe", params);
+            BEAST_EXPECT(jv[jss::status] == jss::success);
+        }
+
+        // When each subscriber learned of each ledger, and how many
+        // transactions it was told of
+        struct Seen
+        {
+            std::map<std::uint32_t, clock_type::time_point> ledgers;
+            std::size_t transactions = 0;
+        };
+        std::vector<Seen> seen(subscribers.size());
+
+        auto const body = [&](std::size_t index) {
+            auto& client = *subscribers[index];
+            auto& result = seen[index];
+            while (result.ledgers.size() < setup.closes)
+            {
+                auto const jv = client.getMsg(10s);
+                if (!jv)
+                    break;
+                if ((*jv)[jss::type] == "ledgerClosed")
+                    result.ledgers.emplace(
+                        (*jv)[jss::ledger_index].asUInt(), clock_type::now());
+                else if ((*jv)[jss::type] == jss::transaction)
+                    ++result.transactions;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < subscribers.size(); ++i)
+            threads.emplace_back(body, i);
+
+        std::map<std::uint32_t, clock_type::time_point> closed;
+        std::size_t sent = 0;
+        for (std::size_t i = 0; i < setup.closes; ++i)
+        {
+            for (std::size_t j = 0; j < 10; ++j, ++sent)
+                env(pay(
+                    accounts[sent % accounts.size()],
+                    accounts[(sent + 1) % accounts.size()],
+                    XRP(1)));
+            closed.emplace(env.current()->info().seq, clock_type::now());
+            env.close();
+        }
+        for (auto& t : threads)
+            t.join();
+
+        Histogram fanout;
+        std::size_t missed = 0;
+        std::size_t transactions = 0;
+        for (auto const& s : seen)
+        {
+            for (auto const& [seq, when] : closed)
+            {
+                auto const iter = s.ledgers.find(seq);
+                if (iter == s.ledgers.end())
+                {
+                    ++missed;
+                    continue;
+                }
+                fanout.insert(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        iter->second - when)
+                        .count());
+            }
+            transactions += s.transactions;
+        }
+
+        log << setup.subscribers << " subscribers, " << setup.closes
+            << " ledgers of " << 10 << " transactions, " << transactions
+            << " of " << sent * setup.subscribers
+            << " transactions delivered, " << missed << " ledgers missed"
+            << std::endl;
+        log << "Stream           count     p50us     p90us     p99us"
+               "     maxus"
+            << std::endl;
+        std::stringstream ss;
+        ss << std::left << std::setw(13) << "ledger" << describe(fanout);
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(missed == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+
+        testcase("ServerLoad", beast::unit_test::abort_on_fail);
+        auto const setup = parseArgs();
+
+        Env env(*this);
+        Account const gw("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+
+        // Enough accounts and offers that the replies aren't trivial
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            accounts.emplace_back("account" + std::to_string(i));
+            env.fund(XRP(100000), accounts.back());
+            env.trust(USD(100000), accounts.back());
+            env(pay(gw, accounts.back(), USD(1000)));
+            env(offer(accounts.back(), XRP(100 + i), USD(100)));
+        }
+        env.close();
+
+        testRequests(env, setup, accounts, USD);
+        testSubscriptions(env, setup, accounts);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ServerLoad, server, ripple);
+
+}  // namespace test
+}  // namespace ripple
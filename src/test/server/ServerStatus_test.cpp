@@ -1204,6 +1204,88 @@ class ServerStatus_test : public beast::unit_test::suite,
         BEAST_EXPECT(std::regex_search(resp.body(), body));
     }
 
+    void
+    testStreamedReply(boost::asio::yield_context& yield)
+    {
+        testcase("Streamed RPC reply");
+
+        using namespace test::jtx;
+        Env env{*this};
+        env.fund(XRP(10000), "alice", "bob");
+        env.close();
+
+        auto const port =
+            env.app().config()["port_rpc"].get<std::uint16_t>("port");
+        auto const ip = env.app().config()["port_rpc"].get<std::string>("ip");
+
+        auto check = [&](unsigned version,
+                         Json::Value const& params,
+                         char const* method = "ledger") {
+            Json::Value jv;
+            jv[jss::method] = method;
+            jv[jss::params] = Json::arrayValue;
+            jv[jss::params].append(params);
+            jv[jss::id] = 5;
+            auto req = makeHTTPRequest(*ip, *port, to_string(jv), {});
+            req.version(version);
+
+            boost::beast::http::response<boost::beast::http::string_body> resp;
+            boost::system::error_code ec;
+            doRequest(yield, std::move(req), *ip, *port, false, resp, ec);
+            BEAST_EXPECT(!ec);
+            BEAST_EXPECT(resp.result() == boost::beast::http::status::ok);
+
+            Json::Value reply;
+            BEAST_EXPECT(Json::Reader{}.parse(resp.body(), reply));
+            BEAST_EXPECT(reply[jss::id] == 5);
+            return std::make_pair(resp.chunked(), reply[jss::result]);
+        };
+
+        Json::Value params;
+        params[jss::ledger_index] = "closed";
+        params[jss::full] = true;
+
+        // HTTP/1.1 clients get the result as it is written
+        auto const [chunked, result] = check(11, params);
+        BEAST_EXPECT(chunked);
+        BEAST_EXPECT(result[jss::status] == jss::success);
+        BEAST_EXPECT(result[jss::ledger][jss::accountState].size() >= 3);
+        BEAST_EXPECT(result[jss::ledger][jss::transactions].isArray());
+
+        // HTTP/1.0 clients get the same result all at once
+        auto const [chunked10, result10] = check(10, params);
+        BEAST_EXPECT(!chunked10);
+        BEAST_EXPECT(result10 == result);
+
+        // Errors are reported the usual way
+        params[jss::ledger_index] = "nonsense";
+        auto const [chunkedError, error] = check(11, params);
+        BEAST_EXPECT(!chunkedError);
+        BEAST_EXPECT(error[jss::status] == jss::error);
+        BEAST_EXPECT(error.isMember(jss::request));
+
+        // Binary account_tx pages are written from the stored blobs
+        env(pay("alice", "bob", XRP(5)));
+        env.close();
+        Json::Value txParams;
+        txParams[jss::account] = Account("alice").human();
+        txParams[jss::binary] = true;
+        txParams[jss::limit] = 1;
+        auto const [chunkedTx, txs] = check(11, txParams, "account_tx");
+        BEAST_EXPECT(chunkedTx);
+        BEAST_EXPECT(txs[jss::status] == jss::success);
+        BEAST_EXPECT(txs[jss::transactions].size() == 1);
+        BEAST_EXPECT(txs[jss::transactions][0u][jss::tx_blob].isString());
+        BEAST_EXPECT(txs.isMember(jss::marker));
+        BEAST_EXPECT(check(10, txParams, "account_tx").second == txs);
+
+        // JSON pages are built as before
+        txParams[jss::binary] = false;
+        auto const [chunkedJson, json] = check(11, txParams, "account_tx");
+        BEAST_EXPECT(!chunkedJson);
+        BEAST_EXPECT(json[jss::transactions][0u].isMember(jss::tx));
+    }
+
 public:
     void
     run() override
@@ -1240,6 +1322,7 @@ public:
             testWSRequests(yield);
             testRPCRequests(yield);
             testStatusNotOkay(yield);
+            testStreamedReply(yield);
         });
     }
 };
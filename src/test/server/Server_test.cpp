@@ -280,6 +280,46 @@ public:
         s.shutdown(socket::shutdown_both, ec);
     }
 
+    void
+    test_pipeline(boost::asio::ip::tcp::endpoint const& ep)
+    {
+        boost::asio::io_service ios;
+        using socket = boost::asio::ip::tcp::socket;
+        socket s(ios);
+
+        if (!connect(s, ep))
+            return;
+
+        // Send every request before reading any of the responses
+        std::string requests;
+        for (int i = 0; i < 3; ++i)
+            requests +=
+                "GET / HTTP/1.1\r\n"
+                "Connection: Keep-Alive\r\n"
+                "\r\n";
+        requests +=
+            "GET / HTTP/1.1\r\n"
+            "Connection: close\r\n"
+            "\r\n";
+        if (!write(s, requests))
+            return;
+
+        std::string const hello = "Hello, world!\n";
+        std::string got(4 * hello.size(), '\0');
+        try
+        {
+            boost::asio::read(s, boost::asio::buffer(&got[0], got.size()));
+            BEAST_EXPECT(got == hello + hello + hello + hello);
+        }
+        catch (std::exception const& e)
+        {
+            fail(e.what());
+        }
+
+        boost::system::error_code ec;
+        s.shutdown(socket::shutdown_both, ec);
+    }
+
     void
     basicTests()
     {
@@ -299,6 +339,7 @@ public:
         log << "server listening on port " << eps[0].port() << std::endl;
         test_request(eps[0]);
         test_keepalive(eps[0]);
+        test_pipeline(eps[0]);
         // s->close();
         s = nullptr;
         pass();
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/FullBelowCache.h>
+
+namespace ripple {
+namespace tests {
+
+class FullBelowCache_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch clock;
+        clock.set(0);
+
+        // Keys land in every shard; each is found and ages out
+        {
+            FullBelowCache c(
+                "test", clock, beast::insight::NullCollector::New(), 0, 2s);
+
+            std::vector<uint256> keys;
+            for (std::uint32_t i = 0; i < 256; ++i)
+                keys.push_back(sha512Half(i));
+            for (auto const& key : keys)
+                c.insert(key);
+            c.insert(keys.front());
+            BEAST_EXPECT(c.size() == keys.size());
+
+            bool found = true;
+            for (auto const& key : keys)
+                found = c.touch_if_exists(key) && found;
+            BEAST_EXPECT(found);
+            BEAST_EXPECT(!c.touch_if_exists(sha512Half(1000)));
+
+            ++clock;
+            c.sweep();
+            BEAST_EXPECT(c.size() == keys.size());
+            BEAST_EXPECT(c.touch_if_exists(keys.back()));
+            ++clock;
+            c.sweep();
+            BEAST_EXPECT(c.size() == 1);
+            BEAST_EXPECT(c.touch_if_exists(keys.back()));
+            BEAST_EXPECT(!c.touch_if_exists(keys.front()));
+        }
+
+        // Clearing moves to a new generation, resetting goes back
+        {
+            FullBelowCache c("test", clock);
+            BEAST_EXPECT(c.getGeneration() == 1);
+
+            c.insert(sha512Half(1));
+            c.clear();
+            BEAST_EXPECT(c.size() == 0);
+            BEAST_EXPECT(c.getGeneration() == 2);
+
+            c.insert(sha512Half(1));
+            c.reset();
+            BEAST_EXPECT(c.size() == 0);
+            BEAST_EXPECT(c.getGeneration() == 1);
+        }
+
+        // Over the target size, entries expire sooner
+        {
+            FullBelowCache c(
+                "test", clock, beast::insight::NullCollector::New(), 2, 3s);
+
+            c.insert(sha512Half(1));
+            ++clock;
+            c.insert(sha512Half(2));
+            ++clock;
+            c.insert(sha512Half(3));
+            ++clock;
+            BEAST_EXPECT(c.size() == 3);
+            c.sweep();
+            BEAST_EXPECT(c.size() < 3);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FullBelowCache, shamap, ripple);
+
+}  // namespace tests
+}  // namespace ripple
@@ -85,6 +85,80 @@ public:
         return true;
     }
 
+    void
+    testDelta(beast::Journal journal)
+    {
+        testcase("delta");
+
+        TestNodeFamily f(journal);
+        SHAMap parent(SHAMapType::FREE, f);
+
+        std::vector<uint256> keys;
+        for (int i = 0; i < 2000; ++i)
+        {
+            auto item = makeRandomAS();
+            keys.push_back(item->key());
+            parent.addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(*item));
+        }
+        parent.flushDirty(hotACCOUNT_NODE);
+
+        auto child = parent.snapShot(true);
+        for (int i = 0; i < 20; ++i)
+            child->addItem(
+                SHAMapNodeType::tnACCOUNT_STATE, std::move(*makeRandomAS()));
+        for (int i = 0; i < 10; ++i)
+            BEAST_EXPECT(child->delItem(keys[i * 100]));
+        child->setImmutable();
+        parent.setImmutable();
+
+        std::vector<std::pair<SHAMapNodeID, Blob>> nodes;
+        BEAST_EXPECT(child->getDeltaNodes(parent, nodes, 100000));
+        BEAST_EXPECT(!nodes.empty() && nodes.front().first.isRoot());
+
+        std::size_t total = 0;
+        child->visitNodes([&total](auto const&) {
+            ++total;
+            return true;
+        });
+        BEAST_EXPECT(nodes.size() < total / 4);
+
+        {
+            std::vector<std::pair<SHAMapNodeID, Blob>> partial;
+            BEAST_EXPECT(
+                !child->getDeltaNodes(parent, partial, nodes.size() - 1));
+            BEAST_EXPECT(partial.size() == nodes.size() - 1);
+        }
+
+        {
+            std::vector<std::pair<SHAMapNodeID, Blob>> none;
+            BEAST_EXPECT(parent.getDeltaNodes(parent, none, 100000));
+            BEAST_EXPECT(none.empty());
+        }
+
+        // A map with the parent's nodes in its store only needs the delta
+        SHAMap destination(SHAMapType::FREE, f);
+        destination.setSynching();
+        BEAST_EXPECT(destination
+                         .addRootNode(
+                             child->getHash(),
+                             makeSlice(nodes.front().second),
+                             nullptr)
+                         .isGood());
+
+        bool useful = true;
+        for (std::size_t i = 1; i < nodes.size(); ++i)
+            useful = useful &&
+                destination
+                    .addKnownNode(
+                        nodes[i].first, makeSlice(nodes[i].second), nullptr)
+                    .isUseful();
+        BEAST_EXPECT(useful);
+
+        BEAST_EXPECT(destination.getMissingNodes(2048, nullptr).empty());
+        destination.clearSynching();
+        BEAST_EXPECT(child->deepCompare(destination));
+    }
+
     void
     run() override
     {
@@ -199,6 +273,8 @@ public:
 
         log << "Checking destination invariants..." << std::endl;
         destination.invariants();
+
+        testDelta(journal);
     }
 };
 
@@ -18,12 +18,17 @@
 //==============================================================================
 
 #include <ripple/basics/Blob.h>
+#include <ripple/basics/MemoryUsage.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/shamap/SHAMap.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 namespace ripple {
 namespace tests {
@@ -128,6 +133,174 @@ public:
 
         run(true, journal);
         run(false, journal);
+        testItems();
+        testApplyChanges(journal);
+        testUpperBoundHint(journal);
+    }
+
+    void
+    testUpperBoundHint(beast::Journal const& journal)
+    {
+        testcase("upper_bound with hint");
+
+        tests::TestNodeFamily tf{journal};
+        SHAMap map{SHAMapType::FREE, tf};
+        map.setUnbacked();
+        for (int k = 0; k < 1000; ++k)
+            map.addItem(
+                SHAMapNodeType::tnTRANSACTION_NM,
+                SHAMapItem{sha512Half(k), IntToVUC(k)});
+
+        // Stepping through the map with each result as the next hint
+        {
+            std::size_t count = 0;
+            uint256 key;
+            auto hint = map.end();
+            while (true)
+            {
+                auto const next = map.upper_bound(key, hint);
+                BEAST_EXPECT(next == map.upper_bound(key));
+                if (next == map.end())
+                    break;
+                BEAST_EXPECT(next->key() > key);
+                key = next->key();
+                hint = next;
+                ++count;
+            }
+            BEAST_EXPECT(count == 1000);
+        }
+
+        // Any hint gives the same result, including keys not in the map
+        for (int k = 0; k < 200; ++k)
+        {
+            auto const hint = map.upper_bound(sha512Half(k + 5000));
+            for (auto const& key : {sha512Half(k), sha512Half(k + 7000)})
+                BEAST_EXPECT(
+                    map.upper_bound(key, hint) == map.upper_bound(key));
+        }
+    }
+
+    void
+    testApplyChanges(beast::Journal const& journal)
+    {
+        testcase("apply changes");
+
+        auto const type = SHAMapNodeType::tnTRANSACTION_NM;
+        auto const item = [](int k, int v) {
+            return std::make_shared<SHAMapItem const>(
+                sha512Half(k), IntToVUC(v));
+        };
+
+        tests::TestNodeFamily tf{journal};
+        SHAMap base{SHAMapType::FREE, tf};
+        base.setUnbacked();
+        for (int k = 0; k < 1000; ++k)
+            base.addGiveItem(type, item(k, k));
+
+        // Delete a third of the items, update a third and add as many new
+        // ones, both one at a time and all at once
+        auto const single = base.snapShot(true);
+        auto const batch = base.snapShot(true);
+        std::vector<SHAMap::Change> changes;
+        for (int k = 0; k < 1500; ++k)
+        {
+            auto const key = sha512Half(k);
+            if (k >= 1000)
+            {
+                BEAST_EXPECT(single->addGiveItem(type, item(k, k)));
+                changes.push_back({key, item(k, k), true});
+            }
+            else if (k % 3 == 0)
+            {
+                BEAST_EXPECT(single->delItem(key));
+                changes.push_back({key, nullptr});
+            }
+            else if (k % 3 == 1)
+            {
+                BEAST_EXPECT(single->updateGiveItem(type, item(k, k + 1)));
+                changes.push_back({key, item(k, k + 1)});
+            }
+        }
+        std::sort(changes.begin(), changes.end(), [](auto& a, auto& b) {
+            return a.key < b.key;
+        });
+
+        BEAST_EXPECT(batch->applyChanges(type, changes));
+        batch->invariants();
+        BEAST_EXPECT(batch->getHash() == single->getHash());
+        BEAST_EXPECT(base.getHash() != batch->getHash());
+        BEAST_EXPECT(
+            std::distance(batch->begin(), batch->end()) ==
+            std::distance(single->begin(), single->end()));
+
+        // Changes which can't be made are reported, and the rest are made
+        {
+            std::vector<SHAMap::Change> bad;
+            bad.push_back({sha512Half(2000), item(2000, 0), true});
+            bad.push_back({sha512Half(2001), nullptr});
+            bad.push_back({sha512Half(1), item(1, 0), true});
+            std::sort(bad.begin(), bad.end(), [](auto& a, auto& b) {
+                return a.key < b.key;
+            });
+            BEAST_EXPECT(!batch->applyChanges(type, bad));
+            batch->invariants();
+            BEAST_EXPECT(batch->hasItem(sha512Half(2000)));
+            BEAST_EXPECT(
+                batch->peekItem(sha512Half(1))->slice() ==
+                makeSlice(IntToVUC(2)));
+        }
+
+        // Deleting everything leaves an empty map
+        {
+            std::vector<SHAMap::Change> all;
+            for (auto const& i : *batch)
+                all.push_back({i.key(), nullptr});
+            BEAST_EXPECT(batch->applyChanges(type, all));
+            batch->invariants();
+            BEAST_EXPECT(batch->begin() == batch->end());
+            BEAST_EXPECT(batch->getHash().isZero());
+        }
+    }
+
+    void
+    testItems()
+    {
+        testcase("items");
+
+        auto const held = [] {
+            return MemoryUsage::report()[static_cast<std::size_t>(
+                                             MemoryTag::shamap)]
+                .bytes;
+        };
+
+        uint256 const key = sha512Half(1);
+        std::int64_t const size = sizeof(SHAMapItem) + 32;
+        auto const before = held();
+        {
+            // The item holds what was written, not the Serializer's buffer
+            Serializer s(4096);
+            s.addRaw(IntToVUC(7));
+            SHAMapItem item(key, std::move(s));
+            BEAST_EXPECT(item.key() == key);
+            BEAST_EXPECT(item.slice() == makeSlice(IntToVUC(7)));
+            BEAST_EXPECT(held() - before == size);
+
+            SHAMapItem copy(item);
+            BEAST_EXPECT(copy.slice() == item.slice());
+            BEAST_EXPECT(copy.data() != item.data());
+            BEAST_EXPECT(held() - before == 2 * size);
+
+            SHAMapItem moved(std::move(copy));
+            BEAST_EXPECT(moved.slice() == item.slice());
+            BEAST_EXPECT(copy.size() == 0);
+            BEAST_EXPECT(held() - before == 3 * size - 32);
+
+            copy = item;
+            moved = SHAMapItem(key, IntToVUC(8));
+            BEAST_EXPECT(moved.slice() == makeSlice(IntToVUC(8)));
+            BEAST_EXPECT(held() - before == 3 * size);
+        }
+        BEAST_EXPECT(held() == before);
     }
 
     void
@@ -350,6 +523,104 @@ public:
                 --h;
             }
         }
+
+        if (backed)
+            testcase("parallel visit backed");
+        else
+            testcase("parallel visit unbacked");
+
+        {
+            tests::TestNodeFamily tf{journal};
+            SHAMap map{SHAMapType::FREE, tf};
+            if (!backed)
+                map.setUnbacked();
+            for (int k = 0; k < 1000; ++k)
+            {
+                map.addItem(
+                    SHAMapNodeType::tnTRANSACTION_NM,
+                    SHAMapItem{sha512Half(k), IntToVUC(k)});
+            }
+            auto const snap = map.snapShot(false);
+
+            std::vector<uint256> serial;
+            snap->visitNodes([&](SHAMapTreeNode& node) {
+                serial.push_back(node.getHash().as_uint256());
+                return true;
+            });
+            std::sort(serial.begin(), serial.end());
+
+            for (unsigned int threads : {1u, 4u, 32u})
+            {
+                std::mutex mutex;
+                std::vector<uint256> parallel;
+                snap->visitNodesParallel(
+                    [&](SHAMapTreeNode& node) {
+                        std::lock_guard lock(mutex);
+                        parallel.push_back(node.getHash().as_uint256());
+                        return true;
+                    },
+                    threads);
+                std::sort(parallel.begin(), parallel.end());
+                BEAST_EXPECT(serial == parallel);
+
+                std::vector<SHAMapMissingNode> missing;
+                snap->walkMapParallel(missing, 32, threads);
+                BEAST_EXPECT(missing.empty());
+            }
+
+            // A complete walk remembers which subtrees are full below
+            BEAST_EXPECT(
+                (tf.getFullBelowCache(0)->size() != 0) == backed);
+
+            // Stopping early visits fewer nodes
+            std::atomic<int> visited{0};
+            snap->visitNodesParallel(
+                [&](SHAMapTreeNode&) { return ++visited < 10; }, 4);
+            BEAST_EXPECT(visited < static_cast<int>(serial.size()));
+        }
+
+        if (!backed)
+            return;
+
+        testcase("deferred flush");
+
+        {
+            tests::TestNodeFamily direct{journal};
+            tests::TestNodeFamily deferred{journal};
+            SHAMap map1{SHAMapType::FREE, direct};
+            SHAMap map2{SHAMapType::FREE, deferred};
+            for (int k = 0; k < 500; ++k)
+            {
+                auto const key = sha512Half(k);
+                map1.addItem(
+                    SHAMapNodeType::tnTRANSACTION_NM,
+                    SHAMapItem{key, IntToVUC(k)});
+                map2.addItem(
+                    SHAMapNodeType::tnTRANSACTION_NM,
+                    SHAMapItem{key, IntToVUC(k)});
+            }
+
+            SHAMap::PendingNodes pending;
+            auto const flushed1 = map1.flushDirty(hotTRANSACTION_NODE);
+            auto const flushed2 = map2.flushDirty(hotTRANSACTION_NODE, pending);
+            BEAST_EXPECT(flushed1 == flushed2);
+            BEAST_EXPECT(pending.size() == static_cast<std::size_t>(flushed2));
+            BEAST_EXPECT(map1.getHash() == map2.getHash());
+
+            // Nothing more to flush
+            BEAST_EXPECT(map2.flushDirty(hotTRANSACTION_NODE) == 0);
+
+            auto const root = map2.getHash().as_uint256();
+            BEAST_EXPECT(direct.db().fetchNodeObject(root));
+            BEAST_EXPECT(!deferred.db().fetchNodeObject(root));
+
+            std::vector<uint256> hashes;
+            for (auto const& node : pending)
+                hashes.push_back(node.hash);
+            map2.storePending(std::move(pending));
+            for (auto const& hash : hashes)
+                BEAST_EXPECT(deferred.db().fetchNodeObject(hash));
+        }
     }
 };
 